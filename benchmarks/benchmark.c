@@ -0,0 +1,742 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h> /* atoi */
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include <sail-manip/sail-manip.h>
+
+#include "test-images.h"
+
+/*
+ * Benchmark options and output.
+ */
+
+struct benchmark_options {
+
+    unsigned iterations;
+    const char *filter;
+    unsigned large_width;
+    unsigned large_height;
+    unsigned conversion_size;
+    bool skip_conversions;
+    bool conversion_stats;
+};
+
+struct benchmark_output {
+
+    FILE *json;
+    bool first_result;
+    unsigned results_count;
+};
+
+/* Runs the benchmark once. */
+typedef sail_status_t (*benchmark_func_t)(void *context);
+
+/* Describes the measured operation. */
+struct benchmark_case {
+
+    const char *group;
+    const char *backend;
+    const char *codec;
+    const char *input;
+    unsigned width;
+    unsigned height;
+    enum SailPixelFormat pixel_format;
+    enum SailPixelFormat output_pixel_format;
+    size_t bytes;
+};
+
+static void print_json_string(FILE *json, const char *str) {
+
+    fputc('"', json);
+
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') {
+            fputc('\\', json);
+            fputc(*str, json);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(json, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, json);
+        }
+    }
+
+    fputc('"', json);
+}
+
+static const char* file_name(const char *path) {
+
+    const char *name = path;
+
+    for (const char *c = path; *c != '\0'; c++) {
+        if (*c == '/' || *c == '\\') {
+            name = c + 1;
+        }
+    }
+
+    return name;
+}
+
+/*
+ * Runs the benchmark once to warm up and then the specified number of times. Prints the timings
+ * to stdout and to the JSON output. Failed benchmarks are reported to stderr and skipped.
+ */
+static void run_benchmark(const struct benchmark_options *options, struct benchmark_output *output,
+                            const struct benchmark_case *benchmark_case, benchmark_func_t func, void *context) {
+
+    char name[512];
+
+    if (benchmark_case->output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
+        snprintf(name, sizeof(name), "%s/%s/%s->%s", benchmark_case->group, benchmark_case->backend,
+                    sail_pixel_format_to_string(benchmark_case->pixel_format),
+                    sail_pixel_format_to_string(benchmark_case->output_pixel_format));
+    } else {
+        snprintf(name, sizeof(name), "%s/%s/%s/%s", benchmark_case->group, benchmark_case->backend,
+                    benchmark_case->codec, benchmark_case->input);
+    }
+
+    if (options->filter != NULL && strstr(name, options->filter) == NULL) {
+        return;
+    }
+
+    if (func(context) != SAIL_OK) {
+        fprintf(stderr, "Skipped: %s\n", name);
+        return;
+    }
+
+    uint64_t min_ns = UINT64_MAX;
+    uint64_t max_ns = 0;
+    uint64_t total_ns = 0;
+
+    for (unsigned i = 0; i < options->iterations; i++) {
+        const uint64_t start_ns = sail_now_ns();
+
+        if (func(context) != SAIL_OK) {
+            fprintf(stderr, "Failed: %s\n", name);
+            return;
+        }
+
+        const uint64_t elapsed_ns = sail_now_ns() - start_ns;
+
+        min_ns    = (elapsed_ns < min_ns) ? elapsed_ns : min_ns;
+        max_ns    = (elapsed_ns > max_ns) ? elapsed_ns : max_ns;
+        total_ns += elapsed_ns;
+    }
+
+    const uint64_t mean_ns = total_ns / options->iterations;
+
+    printf("%-80s %12.1f us %12.1f us\n", name, min_ns / 1000.0, mean_ns / 1000.0);
+
+    output->results_count++;
+
+    if (output->json == NULL) {
+        return;
+    }
+
+    fprintf(output->json, "%s\n    {\n", output->first_result ? "" : ",");
+    output->first_result = false;
+
+    fprintf(output->json, "      \"name\": ");
+    print_json_string(output->json, name);
+    fprintf(output->json, ",\n      \"group\": ");
+    print_json_string(output->json, benchmark_case->group);
+    fprintf(output->json, ",\n      \"backend\": ");
+    print_json_string(output->json, benchmark_case->backend);
+    fprintf(output->json, ",\n      \"codec\": ");
+    print_json_string(output->json, benchmark_case->codec);
+    fprintf(output->json, ",\n      \"input\": ");
+    print_json_string(output->json, benchmark_case->input);
+    fprintf(output->json, ",\n      \"width\": %u,\n      \"height\": %u", benchmark_case->width, benchmark_case->height);
+    fprintf(output->json, ",\n      \"pixel_format\": ");
+    print_json_string(output->json, sail_pixel_format_to_string(benchmark_case->pixel_format));
+    fprintf(output->json, ",\n      \"output_pixel_format\": ");
+    print_json_string(output->json, sail_pixel_format_to_string(benchmark_case->output_pixel_format));
+    fprintf(output->json, ",\n      \"bytes\": %zu", benchmark_case->bytes);
+    fprintf(output->json, ",\n      \"iterations\": %u", options->iterations);
+    fprintf(output->json, ",\n      \"min_ns\": %llu,\n      \"mean_ns\": %llu,\n      \"max_ns\": %llu\n    }",
+            (unsigned long long)min_ns, (unsigned long long)mean_ns, (unsigned long long)max_ns);
+}
+
+/*
+ * Benchmarked operations.
+ */
+
+struct load_context {
+
+    const char *path;
+    const void *data;
+    size_t data_size;
+    const struct sail_codec_info *codec_info;
+    const struct sail_load_options *probe_options;
+};
+
+/* Loads the first frame with the optional load options. Returns it if 'image' is not NULL. */
+static sail_status_t load_from_io(struct sail_io *io, const struct sail_codec_info *codec_info,
+                                  const struct sail_load_options *load_options, struct sail_image **image) {
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(load_options == NULL
+                            ? sail_start_loading_from_io(io, codec_info, &state)
+                            : sail_start_loading_from_io_with_options(io, codec_info, load_options, &state),
+                        /* cleanup */ sail_stop_loading(state));
+
+    struct sail_image *image_local;
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, &image_local),
+                        /* cleanup */ sail_stop_loading(state));
+
+    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    if (image == NULL) {
+        sail_destroy_image(image_local);
+    } else {
+        *image = image_local;
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t benchmark_probe_file(void *context) {
+
+    const struct load_context *load_context = context;
+
+    struct sail_image *image;
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_probe_file(load_context->path, &image, &codec_info));
+
+    sail_destroy_image(image);
+
+    return SAIL_OK;
+}
+
+static sail_status_t benchmark_probe_memory(void *context) {
+
+    const struct load_context *load_context = context;
+
+    /* Probe with the known codec as not all the formats have magic numbers. */
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_memory(load_context->data, load_context->data_size, &io));
+
+    SAIL_TRY_OR_CLEANUP(load_from_io(io, load_context->codec_info, load_context->probe_options, NULL),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+static sail_status_t benchmark_load_file(void *context) {
+
+    const struct load_context *load_context = context;
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_file(load_context->path, &io));
+
+    SAIL_TRY_OR_CLEANUP(load_from_io(io, load_context->codec_info, NULL, NULL),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+static sail_status_t benchmark_load_mmap(void *context) {
+
+    const struct load_context *load_context = context;
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_mmap_file(load_context->path, &io));
+
+    SAIL_TRY_OR_CLEANUP(load_from_io(io, load_context->codec_info, NULL, NULL),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+static sail_status_t benchmark_load_memory(void *context) {
+
+    const struct load_context *load_context = context;
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_memory(load_context->data, load_context->data_size, &io));
+
+    SAIL_TRY_OR_CLEANUP(load_from_io(io, load_context->codec_info, NULL, NULL),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+struct save_context {
+
+    const struct sail_image *image;
+    const struct sail_codec_info *codec_info;
+};
+
+static sail_status_t benchmark_save_memory(void *context) {
+
+    const struct save_context *save_context = context;
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_saving_into_growable_memory(save_context->codec_info, &state),
+                        /* cleanup */ sail_stop_saving(state));
+
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, save_context->image),
+                        /* cleanup */ sail_stop_saving(state));
+
+    void *buffer;
+    size_t buffer_size;
+    SAIL_TRY(sail_stop_saving_into_growable_memory(state, &buffer, &buffer_size));
+
+    sail_free(buffer);
+
+    return SAIL_OK;
+}
+
+struct conversion_context {
+
+    const struct sail_image *image;
+    enum SailPixelFormat output_pixel_format;
+};
+
+static sail_status_t benchmark_convert(void *context) {
+
+    const struct conversion_context *conversion_context = context;
+
+    struct sail_image *image_output;
+    SAIL_TRY(sail_convert_image(conversion_context->image, conversion_context->output_pixel_format, &image_output));
+
+    sail_destroy_image(image_output);
+
+    return SAIL_OK;
+}
+
+/*
+ * Benchmark groups.
+ */
+
+/* Saves the image into memory with the codec, converting it first if needed. Returns the encoded data. */
+static sail_status_t save_with_codec(const struct benchmark_options *options, struct benchmark_output *output,
+                                     const struct sail_image *image, const struct sail_codec_info *codec_info,
+                                     const char *input, void **data, size_t *data_size) {
+
+    struct sail_image *image_for_saving;
+    SAIL_TRY(sail_convert_image_for_saving(image, codec_info->save_features, &image_for_saving));
+
+    struct save_context save_context = { image_for_saving, codec_info };
+
+    const struct benchmark_case benchmark_case = {
+        "save", "memory", codec_info->name, input, image_for_saving->width, image_for_saving->height,
+        image_for_saving->pixel_format, SAIL_PIXEL_FORMAT_UNKNOWN,
+        (size_t)image_for_saving->height * image_for_saving->bytes_per_line
+    };
+
+    run_benchmark(options, output, &benchmark_case, benchmark_save_memory, &save_context);
+
+    if (data != NULL) {
+        void *state = NULL;
+        SAIL_TRY_OR_CLEANUP(sail_start_saving_into_growable_memory(codec_info, &state),
+                            /* cleanup */ sail_stop_saving(state),
+                                          sail_destroy_image(image_for_saving));
+        SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, image_for_saving),
+                            /* cleanup */ sail_stop_saving(state),
+                                          sail_destroy_image(image_for_saving));
+        SAIL_TRY_OR_CLEANUP(sail_stop_saving_into_growable_memory(state, data, data_size),
+                            /* cleanup */ sail_destroy_image(image_for_saving));
+    }
+
+    sail_destroy_image(image_for_saving);
+
+    return SAIL_OK;
+}
+
+/* Benchmarks probing, loading with every I/O backend, and saving the specified file. */
+static void benchmark_file(const struct benchmark_options *options, struct benchmark_output *output, const char *path) {
+
+    struct load_context load_context = { path, NULL, 0, NULL, NULL };
+
+    if (sail_codec_info_from_path(path, &load_context.codec_info) != SAIL_OK) {
+        fprintf(stderr, "Skipped: %s (no codec)\n", path);
+        return;
+    }
+
+    struct sail_load_options *probe_options;
+
+    if (sail_alloc_load_options_from_features(load_context.codec_info->load_features, &probe_options) != SAIL_OK) {
+        return;
+    }
+
+    probe_options->options |= SAIL_OPTION_PROBE;
+    load_context.probe_options = probe_options;
+
+    void *data;
+    size_t data_size;
+
+    if (sail_alloc_data_from_file_contents(path, &data, &data_size) != SAIL_OK) {
+        fprintf(stderr, "Skipped: %s (cannot read)\n", path);
+        sail_destroy_load_options(probe_options);
+        return;
+    }
+
+    load_context.data      = data;
+    load_context.data_size = data_size;
+
+    struct sail_image *image = NULL;
+    struct sail_io *io;
+
+    if (sail_alloc_io_read_memory(data, data_size, &io) == SAIL_OK) {
+        load_from_io(io, load_context.codec_info, NULL, &image);
+        sail_destroy_io(io);
+    }
+
+    if (image == NULL) {
+        fprintf(stderr, "Skipped: %s (cannot load)\n", path);
+        sail_free(data);
+        sail_destroy_load_options(probe_options);
+        return;
+    }
+
+    const char *input = file_name(path);
+    const char *codec = load_context.codec_info->name;
+
+    struct benchmark_case benchmark_case = {
+        "probe", "file", codec, input, image->width, image->height, image->pixel_format, SAIL_PIXEL_FORMAT_UNKNOWN, data_size
+    };
+
+    run_benchmark(options, output, &benchmark_case, benchmark_probe_file, &load_context);
+    benchmark_case.backend = "memory";
+    run_benchmark(options, output, &benchmark_case, benchmark_probe_memory, &load_context);
+
+    benchmark_case.group   = "load";
+    benchmark_case.backend = "file";
+    run_benchmark(options, output, &benchmark_case, benchmark_load_file, &load_context);
+    benchmark_case.backend = "mmap";
+    run_benchmark(options, output, &benchmark_case, benchmark_load_mmap, &load_context);
+    benchmark_case.backend = "memory";
+    run_benchmark(options, output, &benchmark_case, benchmark_load_memory, &load_context);
+
+    if (load_context.codec_info->save_features->pixel_formats_length > 0) {
+        if (save_with_codec(options, output, image, load_context.codec_info, input, NULL, NULL) != SAIL_OK) {
+            fprintf(stderr, "Skipped: save/memory/%s/%s\n", codec, input);
+        }
+    }
+
+    sail_destroy_image(image);
+    sail_free(data);
+    sail_destroy_load_options(probe_options);
+}
+
+/* Creates an image of the specified pixel format filled with pseudo-random pixels. */
+static sail_status_t create_image(enum SailPixelFormat pixel_format, unsigned width, unsigned height, struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->pixel_format   = pixel_format;
+    image_local->bytes_per_line = sail_bytes_per_line(width, pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_image_pixels(image_local, false),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    uint32_t seed = 0x12345678;
+    unsigned char *pixels = image_local->pixels;
+    const size_t pixels_size = (size_t)height * image_local->bytes_per_line;
+
+    for (size_t i = 0; i < pixels_size; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        pixels[i] = (unsigned char)seed;
+    }
+
+    if (sail_is_indexed(pixel_format)) {
+        const unsigned bits_per_pixel = sail_bits_per_pixel(pixel_format);
+        const unsigned color_count = (bits_per_pixel >= 8) ? 256 : (1U << bits_per_pixel);
+
+        SAIL_TRY_OR_CLEANUP(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, color_count, &image_local->palette),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        /* Keep 8-bit indexes and larger within the palette. */
+        memset(image_local->palette->data, 0x80, (size_t)color_count * 3);
+
+        if (bits_per_pixel > 8) {
+            memset(pixels, 0, pixels_size);
+        }
+    }
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+/* Benchmarks saving and loading a large generated image with every codec that can save. */
+static void benchmark_generated(const struct benchmark_options *options, struct benchmark_output *output) {
+
+    struct sail_image *image;
+
+    if (create_image(SAIL_PIXEL_FORMAT_BPP24_RGB, options->large_width, options->large_height, &image) != SAIL_OK) {
+        fprintf(stderr, "Skipped: generated images\n");
+        return;
+    }
+
+    char input[64];
+    snprintf(input, sizeof(input), "generated-%ux%u", options->large_width, options->large_height);
+
+    for (const struct sail_codec_bundle_node *node = sail_codec_bundle_list(); node != NULL; node = node->next) {
+        const struct sail_codec_info *codec_info = node->codec_bundle->codec_info;
+
+        if (codec_info->save_features->pixel_formats_length == 0) {
+            continue;
+        }
+
+        void *data = NULL;
+        size_t data_size;
+
+        if (save_with_codec(options, output, image, codec_info, input, &data, &data_size) != SAIL_OK) {
+            fprintf(stderr, "Skipped: save/memory/%s/%s\n", codec_info->name, input);
+            continue;
+        }
+
+        struct load_context load_context = { NULL, data, data_size, codec_info, NULL };
+
+        const struct benchmark_case benchmark_case = {
+            "load", "memory", codec_info->name, input, image->width, image->height, image->pixel_format,
+            SAIL_PIXEL_FORMAT_UNKNOWN, data_size
+        };
+
+        run_benchmark(options, output, &benchmark_case, benchmark_load_memory, &load_context);
+
+        sail_free(data);
+    }
+
+    sail_destroy_image(image);
+}
+
+/* Benchmarks every supported conversion pair. */
+static void benchmark_conversions(const struct benchmark_options *options, struct benchmark_output *output) {
+
+    for (int input_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN + 1;
+            input_pixel_format <= SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED;
+            input_pixel_format++) {
+
+        struct sail_image *image = NULL;
+
+        for (int output_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN + 1;
+                output_pixel_format <= SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED;
+                output_pixel_format++) {
+
+            if (input_pixel_format == output_pixel_format
+                    || !sail_can_convert((enum SailPixelFormat)input_pixel_format, (enum SailPixelFormat)output_pixel_format)) {
+                continue;
+            }
+
+            if (image == NULL && create_image((enum SailPixelFormat)input_pixel_format,
+                                                options->conversion_size, options->conversion_size, &image) != SAIL_OK) {
+                fprintf(stderr, "Skipped: conversions from %s\n", sail_pixel_format_to_string((enum SailPixelFormat)input_pixel_format));
+                break;
+            }
+
+            struct conversion_context conversion_context = { image, (enum SailPixelFormat)output_pixel_format };
+
+            const struct benchmark_case benchmark_case = {
+                "convert", "sail-manip", "", "generated", image->width, image->height,
+                image->pixel_format, (enum SailPixelFormat)output_pixel_format,
+                (size_t)image->height * image->bytes_per_line
+            };
+
+            run_benchmark(options, output, &benchmark_case, benchmark_convert, &conversion_context);
+        }
+
+        sail_destroy_image(image);
+    }
+}
+
+/* Prints the conversion stats collected while benchmarking conversions. */
+static void print_conversion_stats(void) {
+
+    size_t count;
+
+    if (sail_conversion_stats(NULL, 0, &count) != SAIL_OK || count == 0) {
+        return;
+    }
+
+    struct sail_conversion_stats *stats = malloc(sizeof(struct sail_conversion_stats) * count);
+
+    if (stats == NULL || sail_conversion_stats(stats, count, &count) != SAIL_OK) {
+        free(stats);
+        return;
+    }
+
+    printf("\n%-60s %-10s %-8s %10s %12s\n", "Conversion", "Kernel", "ISA", "Calls", "Mpixels/s");
+
+    for (size_t i = 0; i < count; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "%s -> %s", sail_pixel_format_to_string(stats[i].input_pixel_format),
+                 sail_pixel_format_to_string(stats[i].output_pixel_format));
+
+        const double mpixels = (stats[i].nanoseconds == 0) ? 0 : (double)stats[i].pixels * 1000 / (double)stats[i].nanoseconds;
+
+        printf("%-60s %-10s %-8s %10llu %12.1f\n", name, sail_conversion_kernel_to_string(stats[i].kernel),
+               sail_instruction_set_to_string(stats[i].instruction_set), (unsigned long long)stats[i].calls, mpixels);
+    }
+
+    free(stats);
+}
+
+static void help(const char *app) {
+
+    fprintf(stderr, "SAIL benchmarks.\n\n");
+    fprintf(stderr, "Usage: %s [options] [PATH...]\n", app);
+    fprintf(stderr, "Benchmarks probing, loading, and saving the specified files or the test images,\n");
+    fprintf(stderr, "saving and loading large generated images, and pixel format conversions.\n\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "    -i, --iterations <N>      - Number of measured runs per benchmark. Default: 5.\n");
+    fprintf(stderr, "    -f, --filter <STRING>     - Run only the benchmarks whose names contain the string.\n");
+    fprintf(stderr, "    -l, --large <WxH>         - Size of the generated images. Default: 2048x2048.\n");
+    fprintf(stderr, "    -c, --conversion-size <N> - Size of the images to convert. Default: 256.\n");
+    fprintf(stderr, "    --no-conversions          - Skip the conversion benchmarks.\n");
+    fprintf(stderr, "    --conversion-stats        - Print the kernels and instruction sets used by the conversions.\n");
+    fprintf(stderr, "    -j, --json <PATH>         - Write the results in JSON to the file.\n");
+    fprintf(stderr, "    -h, --help                - Print this help.\n");
+}
+
+int main(int argc, char *argv[]) {
+
+    struct benchmark_options options = { 5, NULL, 2048, 2048, 256, false, false };
+    const char *json_path = NULL;
+    const char **paths = NULL;
+    int paths_count = 0;
+
+    if (argc > 1) {
+        paths = malloc(sizeof(const char *) * (size_t)argc);
+
+        if (paths == NULL) {
+            return 1;
+        }
+    }
+
+    for (int i = 1; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            help(argv[0]);
+            free(paths);
+            return 0;
+        } else if ((strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--iterations") == 0) && has_value) {
+            const int iterations = atoi(argv[++i]);
+            options.iterations = (iterations > 0) ? (unsigned)iterations : 1;
+        } else if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--filter") == 0) && has_value) {
+            options.filter = argv[++i];
+        } else if ((strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--large") == 0) && has_value) {
+            if (sscanf(argv[++i], "%ux%u", &options.large_width, &options.large_height) != 2
+                    || options.large_width == 0 || options.large_height == 0) {
+                fprintf(stderr, "Error: Invalid size '%s'.\n", argv[i]);
+                free(paths);
+                return 1;
+            }
+        } else if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--conversion-size") == 0) && has_value) {
+            const int conversion_size = atoi(argv[++i]);
+            options.conversion_size = (conversion_size > 0) ? (unsigned)conversion_size : 1;
+        } else if (strcmp(argv[i], "--no-conversions") == 0) {
+            options.skip_conversions = true;
+        } else if (strcmp(argv[i], "--conversion-stats") == 0) {
+            options.conversion_stats = true;
+        } else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--json") == 0) && has_value) {
+            json_path = argv[++i];
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Error: Invalid arguments. Run with -h to see command arguments.\n");
+            free(paths);
+            return 1;
+        } else {
+            paths[paths_count++] = argv[i];
+        }
+    }
+
+    struct benchmark_output output = { NULL, true, 0 };
+
+    if (json_path != NULL) {
+        output.json = fopen(json_path, "w");
+
+        if (output.json == NULL) {
+            fprintf(stderr, "Error: Cannot open '%s' for writing.\n", json_path);
+            free(paths);
+            return 1;
+        }
+
+        fprintf(output.json, "{\n  \"sail_version\": \"%s\",\n  \"iterations\": %u,\n  \"results\": [",
+                SAIL_VERSION_STRING, options.iterations);
+    }
+
+    sail_set_log_barrier(SAIL_LOG_LEVEL_ERROR);
+
+    printf("%-80s %15s %15s\n", "Benchmark", "Min", "Mean");
+
+    if (paths_count > 0) {
+        for (int i = 0; i < paths_count; i++) {
+            benchmark_file(&options, &output, paths[i]);
+        }
+    } else {
+        for (const char * const *path = SAIL_TEST_IMAGES; *path != NULL; path++) {
+            benchmark_file(&options, &output, *path);
+        }
+    }
+
+    benchmark_generated(&options, &output);
+
+    if (!options.skip_conversions) {
+        sail_set_conversion_stats_enabled(options.conversion_stats);
+
+        benchmark_conversions(&options, &output);
+
+        if (options.conversion_stats) {
+            print_conversion_stats();
+            sail_set_conversion_stats_enabled(false);
+        }
+    }
+
+    if (output.json != NULL) {
+        fprintf(output.json, "\n  ]\n}\n");
+        fclose(output.json);
+    }
+
+    printf("%u benchmarks completed\n", output.results_count);
+
+    free(paths);
+
+    sail_finish();
+
+    return 0;
+}
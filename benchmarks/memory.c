@@ -0,0 +1,369 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Benchmark options and output.
+ */
+
+struct memory_options {
+
+    unsigned width;
+    unsigned height;
+    const char *filter;
+    const char *temp_dir;
+};
+
+struct memory_output {
+
+    FILE *json;
+    bool first_result;
+    unsigned results_count;
+};
+
+static void print_json_string(FILE *json, const char *str) {
+
+    fputc('"', json);
+
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') {
+            fputc('\\', json);
+            fputc(*str, json);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(json, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, json);
+        }
+    }
+
+    fputc('"', json);
+}
+
+/* Starts measuring the high-water mark of the next step. Returns the bytes currently allocated. */
+static uint64_t begin_step(void) {
+
+    sail_reset_memory_peak();
+
+    struct sail_memory_stats memory_stats;
+    (void)sail_memory_stats(&memory_stats);
+
+    return memory_stats.current_bytes;
+}
+
+/*
+ * Prints the peak heap usage of the step above the baseline and its ratio to the raw pixels size
+ * to stdout and to the JSON output.
+ */
+static void end_step(struct memory_output *output, const char *codec, const char *step,
+                     uint64_t baseline, size_t pixels_size, sail_status_t status) {
+
+    if (status != SAIL_OK) {
+        fprintf(stderr, "Failed: %s/%s (error %d)\n", codec, step, status);
+        return;
+    }
+
+    struct sail_memory_stats memory_stats;
+    (void)sail_memory_stats(&memory_stats);
+
+    const uint64_t peak_bytes = memory_stats.peak_bytes - baseline;
+    const double ratio = (double)peak_bytes / (double)pixels_size;
+
+    printf("%-10s %-16s %16.1f MiB %10.2f\n", codec, step, peak_bytes / 1048576.0, ratio);
+
+    output->results_count++;
+
+    if (output->json == NULL) {
+        return;
+    }
+
+    fprintf(output->json, "%s\n    {\n", output->first_result ? "" : ",");
+    output->first_result = false;
+
+    fprintf(output->json, "      \"codec\": ");
+    print_json_string(output->json, codec);
+    fprintf(output->json, ",\n      \"step\": ");
+    print_json_string(output->json, step);
+    fprintf(output->json, ",\n      \"pixels_bytes\": %zu", pixels_size);
+    fprintf(output->json, ",\n      \"peak_bytes\": %llu", (unsigned long long)peak_bytes);
+    fprintf(output->json, ",\n      \"ratio\": %.3f\n    }", ratio);
+}
+
+/* Creates an image filled with pseudo-random pixels. */
+static sail_status_t create_image(unsigned width, unsigned height, struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image_local->bytes_per_line = sail_bytes_per_line(width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_image_pixels(image_local, false),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    uint32_t seed = 0x12345678;
+    unsigned char *pixels = image_local->pixels;
+    const size_t pixels_size = (size_t)height * image_local->bytes_per_line;
+
+    for (size_t i = 0; i < pixels_size; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        pixels[i] = (unsigned char)seed;
+    }
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+/*
+ * Steps.
+ */
+
+static sail_status_t save_step(const struct sail_image *image, const struct sail_codec_info *codec_info, const char *path) {
+
+    const struct sail_image *image_for_saving = image;
+    struct sail_image *image_converted = NULL;
+
+    if (sail_closest_pixel_format_from_save_features(image->pixel_format, codec_info->save_features) != image->pixel_format) {
+        SAIL_TRY(sail_convert_image_for_saving(image, codec_info->save_features, &image_converted));
+        image_for_saving = image_converted;
+    }
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_saving_into_file(path, codec_info, &state),
+                        /* cleanup */ sail_stop_saving(state),
+                                      sail_destroy_image(image_converted));
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, image_for_saving),
+                        /* cleanup */ sail_stop_saving(state),
+                                      sail_destroy_image(image_converted));
+    SAIL_TRY_OR_CLEANUP(sail_stop_saving(state),
+                        /* cleanup */ sail_destroy_image(image_converted));
+
+    sail_destroy_image(image_converted);
+
+    return SAIL_OK;
+}
+
+static sail_status_t load_step(const char *path, const struct sail_codec_info *codec_info, bool mmap, struct sail_image **image) {
+
+    struct sail_io *io;
+    SAIL_TRY(mmap ? sail_alloc_io_read_mmap_file(path, &io) : sail_alloc_io_read_file(path, &io));
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_io(io, codec_info, &state),
+                        /* cleanup */ sail_stop_loading(state),
+                                      sail_destroy_io(io));
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, image),
+                        /* cleanup */ sail_stop_loading(state),
+                                      sail_destroy_io(io));
+    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
+                        /* cleanup */ sail_destroy_image(*image),
+                                      sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+/* Measures saving and loading the image with the codec, and converting and mirroring the loaded image. */
+static void benchmark_codec(const struct memory_options *options, struct memory_output *output,
+                            const struct sail_image *image, const struct sail_codec_info *codec_info) {
+
+    const size_t pixels_size = (size_t)image->height * image->bytes_per_line;
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/sail-benchmark-memory.%s", options->temp_dir,
+                codec_info->extension_node->string);
+
+    uint64_t baseline = begin_step();
+    sail_status_t status = save_step(image, codec_info, path);
+    end_step(output, codec_info->name, "save", baseline, pixels_size, status);
+
+    if (status != SAIL_OK) {
+        remove(path);
+        return;
+    }
+
+    struct sail_image *image_loaded = NULL;
+
+    baseline = begin_step();
+    status = load_step(path, codec_info, true, &image_loaded);
+    end_step(output, codec_info->name, "load-mmap", baseline, pixels_size, status);
+    sail_destroy_image(image_loaded);
+    image_loaded = NULL;
+
+    baseline = begin_step();
+    status = load_step(path, codec_info, false, &image_loaded);
+    end_step(output, codec_info->name, "load", baseline, pixels_size, status);
+
+    remove(path);
+
+    if (status != SAIL_OK) {
+        return;
+    }
+
+    /*
+     * The loaded image is the baseline of the following steps. sail_update_image() converts
+     * in place into the same or smaller pixel formats only.
+     */
+    struct sail_image *image_converted;
+
+    baseline = begin_step();
+    status = sail_convert_image(image_loaded, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_converted);
+    end_step(output, codec_info->name, "convert-rgba", baseline, pixels_size, status);
+
+    if (status == SAIL_OK) {
+        sail_destroy_image(image_converted);
+    }
+
+    baseline = begin_step();
+    status = sail_update_image(image_loaded, SAIL_PIXEL_FORMAT_BPP24_BGR);
+    end_step(output, codec_info->name, "update-bgr", baseline, pixels_size, status);
+
+    baseline = begin_step();
+    status = sail_update_image(image_loaded, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+    end_step(output, codec_info->name, "update-gray", baseline, pixels_size, status);
+
+    baseline = begin_step();
+    status = sail_mirror_horizontally(image_loaded);
+    end_step(output, codec_info->name, "mirror", baseline, pixels_size, status);
+
+    sail_destroy_image(image_loaded);
+}
+
+static void help(const char *app) {
+
+    fprintf(stderr, "SAIL memory high-water benchmarks.\n\n");
+    fprintf(stderr, "Usage: %s [options]\n", app);
+    fprintf(stderr, "Saves a large generated image with every codec that can save into a temporary file, loads it\n");
+    fprintf(stderr, "back with the file and memory-mapped file I/O, converts and mirrors it, and prints the peak\n");
+    fprintf(stderr, "heap usage of every step and its ratio to the raw pixels size. Only the memory allocated\n");
+    fprintf(stderr, "with the SAIL allocator is counted.\n\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "    -l, --large <WxH>         - Size of the generated image. Default: 15000x10040.\n");
+    fprintf(stderr, "    -f, --filter <STRING>     - Benchmark only the codecs whose names contain the string.\n");
+    fprintf(stderr, "    -t, --temp <DIR>          - Directory for the temporary files. Default: current directory.\n");
+    fprintf(stderr, "    -j, --json <PATH>         - Write the results in JSON to the file.\n");
+    fprintf(stderr, "    -h, --help                - Print this help.\n");
+}
+
+int main(int argc, char *argv[]) {
+
+    /* Track every allocation. Must be enabled before any allocations. */
+    if (sail_set_memory_tracking(true) != SAIL_OK) {
+        fprintf(stderr, "Error: Failed to enable the memory tracking.\n");
+        return 1;
+    }
+
+    struct memory_options options = { 15000, 10040, NULL, "." };
+    const char *json_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            help(argv[0]);
+            return 0;
+        } else if ((strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--large") == 0) && has_value) {
+            if (sscanf(argv[++i], "%ux%u", &options.width, &options.height) != 2
+                    || options.width == 0 || options.height == 0) {
+                fprintf(stderr, "Error: Invalid size '%s'.\n", argv[i]);
+                return 1;
+            }
+        } else if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--filter") == 0) && has_value) {
+            options.filter = argv[++i];
+        } else if ((strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--temp") == 0) && has_value) {
+            options.temp_dir = argv[++i];
+        } else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--json") == 0) && has_value) {
+            json_path = argv[++i];
+        } else {
+            fprintf(stderr, "Error: Invalid arguments. Run with -h to see command arguments.\n");
+            return 1;
+        }
+    }
+
+    struct memory_output output = { NULL, true, 0 };
+
+    if (json_path != NULL) {
+        output.json = fopen(json_path, "w");
+
+        if (output.json == NULL) {
+            fprintf(stderr, "Error: Cannot open '%s' for writing.\n", json_path);
+            return 1;
+        }
+
+        fprintf(output.json, "{\n  \"sail_version\": \"%s\",\n  \"width\": %u,\n  \"height\": %u,\n  \"results\": [",
+                SAIL_VERSION_STRING, options.width, options.height);
+    }
+
+    sail_set_log_barrier(SAIL_LOG_LEVEL_ERROR);
+
+    struct sail_image *image;
+
+    if (create_image(options.width, options.height, &image) != SAIL_OK) {
+        fprintf(stderr, "Error: Failed to create a %ux%u image.\n", options.width, options.height);
+        return 1;
+    }
+
+    printf("%-10s %-16s %20s %10s\n", "Codec", "Step", "Peak", "Ratio");
+
+    for (const struct sail_codec_bundle_node *node = sail_codec_bundle_list(); node != NULL; node = node->next) {
+        const struct sail_codec_info *codec_info = node->codec_bundle->codec_info;
+
+        if (codec_info->save_features->pixel_formats_length == 0 || codec_info->extension_node == NULL) {
+            continue;
+        }
+
+        if (options.filter != NULL && strstr(codec_info->name, options.filter) == NULL) {
+            continue;
+        }
+
+        benchmark_codec(&options, &output, image, codec_info);
+    }
+
+    sail_destroy_image(image);
+
+    if (output.json != NULL) {
+        fprintf(output.json, "\n  ]\n}\n");
+        fclose(output.json);
+    }
+
+    printf("%u steps measured\n", output.results_count);
+
+    sail_finish();
+
+    return 0;
+}
@@ -0,0 +1,426 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h> /* atoi, qsort, strtoull */
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "test-images.h"
+
+#ifdef _WIN32
+    #define popen  _popen
+    #define pclose _pclose
+#endif
+
+/*
+ * Stages measured in the child processes by their tracing spans.
+ */
+
+static const char * const STAGE_NAMES[] = {
+    "init_context",
+    "enumerate_codecs",
+    "parse_codec_info",
+    "preload_codecs",
+    "detect_codec",
+    "load_codec",
+    "open_codec_library",
+    "resolve_codec_symbols",
+};
+
+#define STAGES_COUNT (sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]))
+
+/* Must be enough for the nested spans. */
+#define MAX_OPEN_SPANS 16
+
+/* Time and number of the spans of every stage in one process. */
+struct startup_sample {
+
+    uint64_t total_ns;
+    uint64_t stage_ns[STAGES_COUNT];
+    unsigned stage_calls[STAGES_COUNT];
+};
+
+struct open_span {
+
+    size_t stage;
+    uint64_t start_ns;
+};
+
+struct startup_tracer {
+
+    struct open_span spans[MAX_OPEN_SPANS];
+    unsigned open_spans;
+    struct startup_sample *sample;
+};
+
+static void *begin_span(const char *name, const struct sail_trace_attributes *attributes, void *user_data) {
+
+    (void)attributes;
+
+    struct startup_tracer *tracer = user_data;
+
+    if (tracer->open_spans == MAX_OPEN_SPANS) {
+        return NULL;
+    }
+
+    struct open_span *span = &tracer->spans[tracer->open_spans++];
+    span->stage = STAGES_COUNT;
+
+    for (size_t i = 0; i < STAGES_COUNT; i++) {
+        if (strcmp(name, STAGE_NAMES[i]) == 0) {
+            span->stage = i;
+            break;
+        }
+    }
+
+    span->start_ns = sail_now_ns();
+
+    return span;
+}
+
+static void end_span(void *span, const struct sail_trace_attributes *attributes, sail_status_t status, void *user_data) {
+
+    (void)attributes;
+    (void)status;
+
+    const uint64_t end_ns = sail_now_ns();
+    struct startup_tracer *tracer = user_data;
+    const struct open_span *span_local = span;
+
+    if (span_local == NULL) {
+        return;
+    }
+
+    if (span_local->stage < STAGES_COUNT) {
+        tracer->sample->stage_ns[span_local->stage] += end_ns - span_local->start_ns;
+        tracer->sample->stage_calls[span_local->stage]++;
+    }
+
+    tracer->open_spans--;
+}
+
+/*
+ * Child process: loads the image once in a fresh process and prints the sample
+ * to stdout as a single line of numbers.
+ */
+static int run_child(const char *path, bool preload, uint64_t start_ns) {
+
+    struct startup_sample sample = { 0 };
+    struct startup_tracer tracer = { .open_spans = 0, .sample = &sample };
+
+    sail_set_log_barrier(SAIL_LOG_LEVEL_ERROR);
+    sail_set_tracer(begin_span, end_span, &tracer);
+
+    if (preload && sail_init_with_flags(SAIL_FLAG_PRELOAD_CODECS) != SAIL_OK) {
+        return 1;
+    }
+
+    struct sail_image *image;
+
+    if (sail_load_from_file(path, &image) != SAIL_OK) {
+        return 1;
+    }
+
+    sample.total_ns = sail_now_ns() - start_ns;
+
+    sail_set_tracer(NULL, NULL, NULL);
+    sail_destroy_image(image);
+
+    printf("%llu", (unsigned long long)sample.total_ns);
+
+    for (size_t i = 0; i < STAGES_COUNT; i++) {
+        printf(" %llu %u", (unsigned long long)sample.stage_ns[i], sample.stage_calls[i]);
+    }
+
+    printf("\n");
+
+    sail_finish();
+
+    return 0;
+}
+
+/*
+ * Parent process.
+ */
+
+static void print_json_string(FILE *json, const char *str) {
+
+    fputc('"', json);
+
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') {
+            fputc('\\', json);
+            fputc(*str, json);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(json, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, json);
+        }
+    }
+
+    fputc('"', json);
+}
+
+static int compare_times(const void *a, const void *b) {
+
+    const uint64_t time_a = *(const uint64_t *)a;
+    const uint64_t time_b = *(const uint64_t *)b;
+
+    return (time_a > time_b) - (time_a < time_b);
+}
+
+/* Runs the benchmark in a new process and parses its sample. */
+static sail_status_t run_process(const char *app, const char *path, bool preload, struct startup_sample *sample) {
+
+    char command[4096];
+    const int written = snprintf(command, sizeof(command), "\"%s\" --child %s\"%s\"", app, preload ? "--preload " : "", path);
+
+    if (written < 0 || (size_t)written >= sizeof(command)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    FILE *pipe = popen(command, "r");
+
+    if (pipe == NULL) {
+        SAIL_LOG_ERROR("Failed to run '%s'", command);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    char line[1024];
+    const bool have_line = fgets(line, sizeof(line), pipe) != NULL;
+    const int exit_code = pclose(pipe);
+
+    if (!have_line || exit_code != 0) {
+        SAIL_LOG_ERROR("The child process failed to load '%s'", path);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    }
+
+    char *cursor = line;
+    sample->total_ns = strtoull(cursor, &cursor, 10);
+
+    for (size_t i = 0; i < STAGES_COUNT; i++) {
+        sample->stage_ns[i]    = strtoull(cursor, &cursor, 10);
+        sample->stage_calls[i] = (unsigned)strtoul(cursor, &cursor, 10);
+    }
+
+    return SAIL_OK;
+}
+
+/* Returns the minimum, median, and maximum of the times. Sorts the times. */
+static void summarize(uint64_t *times, unsigned count, uint64_t *min_ns, uint64_t *median_ns, uint64_t *max_ns) {
+
+    qsort(times, count, sizeof(uint64_t), compare_times);
+
+    *min_ns    = times[0];
+    *median_ns = times[count / 2];
+    *max_ns    = times[count - 1];
+}
+
+static void print_stage(FILE *json, bool first, const char *name, unsigned calls, uint64_t *times, unsigned count) {
+
+    uint64_t min_ns, median_ns, max_ns;
+    summarize(times, count, &min_ns, &median_ns, &max_ns);
+
+    printf("%-26s %8u %12.1f %12.1f %12.1f\n", name, calls, median_ns / 1000.0, min_ns / 1000.0, max_ns / 1000.0);
+
+    if (json == NULL) {
+        return;
+    }
+
+    fprintf(json, "%s\n    {\n      \"stage\": ", first ? "" : ",");
+    print_json_string(json, name);
+    fprintf(json, ",\n      \"calls\": %u", calls);
+    fprintf(json, ",\n      \"median_ns\": %llu", (unsigned long long)median_ns);
+    fprintf(json, ",\n      \"min_ns\": %llu", (unsigned long long)min_ns);
+    fprintf(json, ",\n      \"max_ns\": %llu\n    }", (unsigned long long)max_ns);
+}
+
+/* Returns the first test image that can be loaded. Initializes the parent context, which is not measured. */
+static const char* default_path(void) {
+
+    for (const char * const *path = SAIL_TEST_IMAGES; *path != NULL; path++) {
+        struct sail_image *image;
+
+        if (sail_load_from_file(*path, &image) == SAIL_OK) {
+            sail_destroy_image(image);
+            return *path;
+        }
+    }
+
+    return NULL;
+}
+
+/* Returns true if the built-in codecs are combined into the SAIL library, i.e. have no paths. */
+static bool codecs_combined(void) {
+
+    const struct sail_codec_bundle_node *node = sail_codec_bundle_list();
+
+    return node != NULL && node->codec_bundle->codec_info->path == NULL;
+}
+
+static void help(const char *app) {
+
+    fprintf(stderr, "SAIL cold start benchmarks.\n\n");
+    fprintf(stderr, "Usage: %s [options] [PATH]\n", app);
+    fprintf(stderr, "Loads the specified file or a test image in a fresh process the specified number of times\n");
+    fprintf(stderr, "and prints the time to the first decoded image from the process start, and the time of\n");
+    fprintf(stderr, "the context initialization stages and the codec loading. Stages are nested: parsing codec\n");
+    fprintf(stderr, "info files is a part of the enumeration, opening libraries and resolving symbols are parts\n");
+    fprintf(stderr, "of loading codecs, and all of them are parts of the context initialization when preloading.\n\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "    -n, --runs <N>            - Number of processes to run. Default: 20.\n");
+    fprintf(stderr, "    -p, --preload             - Preload all the codecs with SAIL_FLAG_PRELOAD_CODECS.\n");
+    fprintf(stderr, "    -j, --json <PATH>         - Write the results in JSON to the file.\n");
+    fprintf(stderr, "    -h, --help                - Print this help.\n");
+}
+
+int main(int argc, char *argv[]) {
+
+    /* The earliest time point the process can measure portably. */
+    const uint64_t start_ns = sail_now_ns();
+
+    unsigned runs = 20;
+    bool preload = false;
+    bool child = false;
+    const char *json_path = NULL;
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            help(argv[0]);
+            return 0;
+        } else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--runs") == 0) && has_value) {
+            const int value = atoi(argv[++i]);
+            runs = (value > 0) ? (unsigned)value : 1;
+        } else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--preload") == 0) {
+            preload = true;
+        } else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--json") == 0) && has_value) {
+            json_path = argv[++i];
+        } else if (strcmp(argv[i], "--child") == 0) {
+            child = true;
+        } else if (argv[i][0] == '-' || path != NULL) {
+            fprintf(stderr, "Error: Invalid arguments. Run with -h to see command arguments.\n");
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    if (child) {
+        return (path == NULL) ? 1 : run_child(path, preload, start_ns);
+    }
+
+    sail_set_log_barrier(SAIL_LOG_LEVEL_ERROR);
+
+    if (path == NULL) {
+        path = default_path();
+
+        if (path == NULL) {
+            fprintf(stderr, "Error: No test image can be loaded.\n");
+            return 1;
+        }
+    }
+
+    void *ptr;
+
+    if (sail_malloc(sizeof(struct startup_sample) * runs, &ptr) != SAIL_OK) {
+        return 1;
+    }
+
+    struct startup_sample *samples = ptr;
+
+    if (sail_malloc(sizeof(uint64_t) * runs, &ptr) != SAIL_OK) {
+        sail_free(samples);
+        return 1;
+    }
+
+    uint64_t *times = ptr;
+
+    for (unsigned run = 0; run < runs; run++) {
+        if (run_process(argv[0], path, preload, &samples[run]) != SAIL_OK) {
+            fprintf(stderr, "Error: Failed to run the benchmark process.\n");
+            sail_free(times);
+            sail_free(samples);
+            return 1;
+        }
+    }
+
+    FILE *json = NULL;
+
+    if (json_path != NULL) {
+        json = fopen(json_path, "w");
+
+        if (json == NULL) {
+            fprintf(stderr, "Error: Cannot open '%s' for writing.\n", json_path);
+            sail_free(times);
+            sail_free(samples);
+            return 1;
+        }
+
+        fprintf(json, "{\n  \"sail_version\": \"%s\",\n  \"input\": ", SAIL_VERSION_STRING);
+        print_json_string(json, path);
+        fprintf(json, ",\n  \"codecs\": \"%s\",\n  \"preload\": %s,\n  \"runs\": %u,\n  \"stages\": [",
+                codecs_combined() ? "combined" : "shared", preload ? "true" : "false", runs);
+    }
+
+    printf("Input:   %s\n", path);
+    printf("Codecs:  %s\n", codecs_combined() ? "combined into the SAIL library" : "shared libraries");
+    printf("Preload: %s\n", preload ? "yes" : "no");
+    printf("Runs:    %u\n\n", runs);
+
+    printf("%-26s %8s %15s %15s %15s\n", "Stage", "Calls", "Median", "Min", "Max");
+
+    for (unsigned run = 0; run < runs; run++) {
+        times[run] = samples[run].total_ns;
+    }
+
+    print_stage(json, true, "first_decode", 1, times, runs);
+
+    for (size_t i = 0; i < STAGES_COUNT; i++) {
+        for (unsigned run = 0; run < runs; run++) {
+            times[run] = samples[run].stage_ns[i];
+        }
+
+        print_stage(json, false, STAGE_NAMES[i], samples[0].stage_calls[i], times, runs);
+    }
+
+    if (json != NULL) {
+        fprintf(json, "\n  ]\n}\n");
+        fclose(json);
+    }
+
+    sail_free(times);
+    sail_free(samples);
+
+    sail_finish();
+
+    return 0;
+}
@@ -0,0 +1,519 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h> /* atoi, qsort */
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include <sail-manip/sail-manip.h>
+
+#include "test-images.h"
+
+/*
+ * Benchmark options and output.
+ */
+
+struct threads_options {
+
+    unsigned max_threads;
+    unsigned loads;
+    unsigned large_width;
+    unsigned large_height;
+};
+
+struct threads_output {
+
+    FILE *json;
+    bool first_result;
+};
+
+/* Encoded image loaded concurrently. */
+struct threads_input {
+
+    const char *name;
+    void *data;
+    size_t data_size;
+};
+
+/* Latencies and stats of the loads of one task. */
+struct task_result {
+
+    uint64_t *latencies;
+    struct sail_stats stats;
+    unsigned thread;
+    sail_status_t status;
+};
+
+struct task_context {
+
+    const struct threads_input *input;
+    unsigned loads;
+    struct task_result *results;
+};
+
+static void print_json_string(FILE *json, const char *str) {
+
+    fputc('"', json);
+
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') {
+            fputc('\\', json);
+            fputc(*str, json);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(json, "\\u%04x", (unsigned char)*str);
+        } else {
+            fputc(*str, json);
+        }
+    }
+
+    fputc('"', json);
+}
+
+static const char* file_name(const char *path) {
+
+    const char *name = path;
+
+    for (const char *c = path; *c != '\0'; c++) {
+        if (*c == '/' || *c == '\\') {
+            name = c + 1;
+        }
+    }
+
+    return name;
+}
+
+static int compare_latencies(const void *a, const void *b) {
+
+    const uint64_t latency_a = *(const uint64_t *)a;
+    const uint64_t latency_b = *(const uint64_t *)b;
+
+    return (latency_a > latency_b) - (latency_a < latency_b);
+}
+
+/* Returns the percentile of the sorted latencies. */
+static uint64_t percentile(const uint64_t *latencies, size_t count, unsigned percent) {
+
+    const size_t index = (count * percent + 99) / 100;
+
+    return latencies[(index == 0) ? 0 : index - 1];
+}
+
+/*
+ * Loads the image from memory the specified number of times like sail_load_from_memory() does,
+ * but with the stats to measure the codec detection and initialization.
+ */
+static void load_task(void *user_data, unsigned task, unsigned thread) {
+
+    const struct task_context *task_context = user_data;
+    struct task_result *result = &task_context->results[task];
+
+    result->thread = thread;
+
+    struct sail_load_options *load_options;
+    result->status = sail_alloc_load_options(&load_options);
+
+    if (result->status != SAIL_OK) {
+        return;
+    }
+
+    load_options->stats = &result->stats;
+
+    for (unsigned i = 0; i < task_context->loads; i++) {
+        const uint64_t start_ns = sail_now_ns();
+
+        void *state = NULL;
+        result->status = sail_start_loading_from_memory_with_options(task_context->input->data,
+                                                                     task_context->input->data_size,
+                                                                     NULL, load_options, &state);
+
+        struct sail_image *image = NULL;
+
+        if (result->status == SAIL_OK) {
+            result->status = sail_load_next_frame(state, &image);
+        }
+
+        const sail_status_t stop_status = sail_stop_loading(state);
+        sail_destroy_image(image);
+
+        if (result->status == SAIL_OK) {
+            result->status = stop_status;
+        }
+
+        if (result->status != SAIL_OK) {
+            break;
+        }
+
+        result->latencies[i] = sail_now_ns() - start_ns;
+    }
+
+    sail_destroy_load_options(load_options);
+}
+
+/*
+ * Loads the input concurrently in the specified number of threads. If 'report' is true, prints
+ * the throughput, the latency percentiles, and the mean codec detection and initialization time
+ * to stdout and to the JSON output.
+ */
+static sail_status_t run_threads(const struct threads_options *options, struct threads_output *output,
+                                 const struct threads_input *input, unsigned threads, bool report) {
+
+    const size_t loads_count = (size_t)threads * options->loads;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(uint64_t) * loads_count, &ptr));
+    uint64_t *latencies = ptr;
+
+    SAIL_TRY_OR_CLEANUP(sail_calloc(threads, sizeof(struct task_result), &ptr),
+                        /* cleanup */ sail_free(latencies));
+    struct task_result *results = ptr;
+
+    for (unsigned i = 0; i < threads; i++) {
+        results[i].latencies = latencies + (size_t)i * options->loads;
+    }
+
+    const struct task_context task_context = { input, options->loads, results };
+
+    sail_set_thread_pool_size(threads);
+
+    const uint64_t start_ns = sail_now_ns();
+    sail_thread_pool_run(threads, load_task, (void *)&task_context);
+    const uint64_t elapsed_ns = sail_now_ns() - start_ns;
+
+    struct sail_stats stats = { 0 };
+    unsigned threads_used = 0;
+
+    for (unsigned i = 0; i < threads; i++) {
+        if (results[i].status != SAIL_OK) {
+            const sail_status_t status = results[i].status;
+            sail_free(results);
+            sail_free(latencies);
+            SAIL_LOG_AND_RETURN(status);
+        }
+
+        sail_add_stats(&stats, &results[i].stats);
+
+        /* Count the distinct threads the tasks ran in. */
+        bool seen = false;
+
+        for (unsigned j = 0; j < i; j++) {
+            if (results[j].thread == results[i].thread) {
+                seen = true;
+                break;
+            }
+        }
+
+        threads_used += seen ? 0 : 1;
+    }
+
+    qsort(latencies, loads_count, sizeof(uint64_t), compare_latencies);
+
+    const double throughput = (double)loads_count * 1e9 / (double)(elapsed_ns == 0 ? 1 : elapsed_ns);
+    const uint64_t p50_ns = percentile(latencies, loads_count, 50);
+    const uint64_t p99_ns = percentile(latencies, loads_count, 99);
+    const uint64_t setup_ns = (stats.detection_ns + stats.init_ns) / loads_count;
+
+    sail_free(results);
+    sail_free(latencies);
+
+    if (!report) {
+        return SAIL_OK;
+    }
+
+    printf("%-40s %8u %8u %14.1f %12.1f %12.1f %12.1f\n", input->name, threads, threads_used,
+            throughput, p50_ns / 1000.0, p99_ns / 1000.0, setup_ns / 1000.0);
+
+    if (output->json == NULL) {
+        return SAIL_OK;
+    }
+
+    fprintf(output->json, "%s\n    {\n", output->first_result ? "" : ",");
+    output->first_result = false;
+
+    fprintf(output->json, "      \"input\": ");
+    print_json_string(output->json, input->name);
+    fprintf(output->json, ",\n      \"bytes\": %zu", input->data_size);
+    fprintf(output->json, ",\n      \"threads\": %u,\n      \"threads_used\": %u", threads, threads_used);
+    fprintf(output->json, ",\n      \"loads\": %zu", loads_count);
+    fprintf(output->json, ",\n      \"elapsed_ns\": %llu", (unsigned long long)elapsed_ns);
+    fprintf(output->json, ",\n      \"loads_per_second\": %.1f", throughput);
+    fprintf(output->json, ",\n      \"p50_ns\": %llu,\n      \"p99_ns\": %llu", (unsigned long long)p50_ns, (unsigned long long)p99_ns);
+    fprintf(output->json, ",\n      \"mean_setup_ns\": %llu\n    }", (unsigned long long)setup_ns);
+
+    return SAIL_OK;
+}
+
+/*
+ * Inputs.
+ */
+
+/* Reads the first file that can be loaded from memory with the codec detected by its magic number. */
+static sail_status_t read_small_input(const char *path, struct threads_input *input) {
+
+    const char * const default_paths[] = { path, NULL };
+    const char * const *paths = (path == NULL) ? SAIL_TEST_IMAGES : default_paths;
+
+    for (; *paths != NULL; paths++) {
+        void *data;
+        size_t data_size;
+
+        if (sail_alloc_data_from_file_contents(*paths, &data, &data_size) != SAIL_OK) {
+            continue;
+        }
+
+        struct sail_image *image;
+
+        if (sail_load_from_memory(data, data_size, &image) == SAIL_OK) {
+            sail_destroy_image(image);
+
+            input->name      = file_name(*paths);
+            input->data      = data;
+            input->data_size = data_size;
+
+            return SAIL_OK;
+        }
+
+        sail_free(data);
+    }
+
+    SAIL_LOG_ERROR("No loadable input image found");
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_FILE_NOT_FOUND);
+}
+
+/* Creates an image filled with pseudo-random pixels. */
+static sail_status_t create_image(unsigned width, unsigned height, struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image_local->bytes_per_line = sail_bytes_per_line(width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_image_pixels(image_local, false),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    uint32_t seed = 0x12345678;
+    unsigned char *pixels = image_local->pixels;
+    const size_t pixels_size = (size_t)height * image_local->bytes_per_line;
+
+    for (size_t i = 0; i < pixels_size; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        pixels[i] = (unsigned char)seed;
+    }
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+/* Saves the image into memory with the codec and checks it can be loaded back with the detected codec. */
+static sail_status_t save_with_codec(const struct sail_image *image, const struct sail_codec_info *codec_info,
+                                     void **data, size_t *data_size) {
+
+    struct sail_image *image_for_saving;
+    SAIL_TRY(sail_convert_image_for_saving(image, codec_info->save_features, &image_for_saving));
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_saving_into_growable_memory(codec_info, &state),
+                        /* cleanup */ sail_stop_saving(state),
+                                      sail_destroy_image(image_for_saving));
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, image_for_saving),
+                        /* cleanup */ sail_stop_saving(state),
+                                      sail_destroy_image(image_for_saving));
+    SAIL_TRY_OR_CLEANUP(sail_stop_saving_into_growable_memory(state, data, data_size),
+                        /* cleanup */ sail_destroy_image(image_for_saving));
+
+    sail_destroy_image(image_for_saving);
+
+    struct sail_image *image_loaded;
+    SAIL_TRY_OR_CLEANUP(sail_load_from_memory(*data, *data_size, &image_loaded),
+                        /* cleanup */ sail_free(*data));
+
+    sail_destroy_image(image_loaded);
+
+    return SAIL_OK;
+}
+
+/* Encodes a large generated image with PNG or with the first codec that can save it. */
+static sail_status_t create_large_input(const struct threads_options *options, char *name, size_t name_size,
+                                        struct threads_input *input) {
+
+    struct sail_image *image;
+    SAIL_TRY(create_image(options->large_width, options->large_height, &image));
+
+    const struct sail_codec_info *codec_info;
+
+    if (sail_codec_info_from_extension("png", &codec_info) == SAIL_OK
+            && save_with_codec(image, codec_info, &input->data, &input->data_size) == SAIL_OK) {
+        snprintf(name, name_size, "generated-%ux%u.%s", image->width, image->height, codec_info->name);
+        input->name = name;
+        sail_destroy_image(image);
+        return SAIL_OK;
+    }
+
+    for (const struct sail_codec_bundle_node *node = sail_codec_bundle_list(); node != NULL; node = node->next) {
+        codec_info = node->codec_bundle->codec_info;
+
+        if (codec_info->save_features->pixel_formats_length == 0) {
+            continue;
+        }
+
+        if (save_with_codec(image, codec_info, &input->data, &input->data_size) == SAIL_OK) {
+            snprintf(name, name_size, "generated-%ux%u.%s", image->width, image->height, codec_info->name);
+            input->name = name;
+            sail_destroy_image(image);
+            return SAIL_OK;
+        }
+    }
+
+    sail_destroy_image(image);
+
+    SAIL_LOG_ERROR("No codec can save the generated input image");
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
+}
+
+static void benchmark_input(const struct threads_options *options, struct threads_output *output,
+                            const struct threads_input *input) {
+
+    /* Warm up the codec and the pool. */
+    if (run_threads(options, output, input, 1, false) != SAIL_OK) {
+        fprintf(stderr, "Skipped: %s\n", input->name);
+        return;
+    }
+
+    for (unsigned threads = 1; threads <= options->max_threads; threads *= 2) {
+        if (run_threads(options, output, input, threads, true) != SAIL_OK) {
+            fprintf(stderr, "Failed: %s in %u threads\n", input->name, threads);
+            return;
+        }
+    }
+}
+
+static void help(const char *app) {
+
+    fprintf(stderr, "SAIL multi-threaded loading benchmarks.\n\n");
+    fprintf(stderr, "Usage: %s [options] [PATH]\n", app);
+    fprintf(stderr, "Loads a small image (the specified file or a test image) and a large generated image\n");
+    fprintf(stderr, "from memory concurrently in 1, 2, 4, ... threads and prints the throughput and the\n");
+    fprintf(stderr, "latency percentiles. The setup time is the mean time spent detecting and initializing\n");
+    fprintf(stderr, "the codec per load including waiting for the context and codec locks.\n\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "    -t, --threads <N>         - Maximum number of threads. Default: 128.\n");
+    fprintf(stderr, "    -n, --loads <N>           - Number of loads per thread. Default: 16.\n");
+    fprintf(stderr, "    -l, --large <WxH>         - Size of the generated image. Default: 1024x1024.\n");
+    fprintf(stderr, "    -j, --json <PATH>         - Write the results in JSON to the file.\n");
+    fprintf(stderr, "    -h, --help                - Print this help.\n");
+}
+
+int main(int argc, char *argv[]) {
+
+    struct threads_options options = { 128, 16, 1024, 1024 };
+    const char *json_path = NULL;
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            help(argv[0]);
+            return 0;
+        } else if ((strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0) && has_value) {
+            const int max_threads = atoi(argv[++i]);
+            options.max_threads = (max_threads > 0) ? (unsigned)max_threads : 1;
+        } else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--loads") == 0) && has_value) {
+            const int loads = atoi(argv[++i]);
+            options.loads = (loads > 0) ? (unsigned)loads : 1;
+        } else if ((strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--large") == 0) && has_value) {
+            if (sscanf(argv[++i], "%ux%u", &options.large_width, &options.large_height) != 2
+                    || options.large_width == 0 || options.large_height == 0) {
+                fprintf(stderr, "Error: Invalid size '%s'.\n", argv[i]);
+                return 1;
+            }
+        } else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--json") == 0) && has_value) {
+            json_path = argv[++i];
+        } else if (argv[i][0] == '-' || path != NULL) {
+            fprintf(stderr, "Error: Invalid arguments. Run with -h to see command arguments.\n");
+            return 1;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    struct threads_output output = { NULL, true };
+
+    if (json_path != NULL) {
+        output.json = fopen(json_path, "w");
+
+        if (output.json == NULL) {
+            fprintf(stderr, "Error: Cannot open '%s' for writing.\n", json_path);
+            return 1;
+        }
+
+        fprintf(output.json, "{\n  \"sail_version\": \"%s\",\n  \"loads_per_thread\": %u,\n  \"results\": [",
+                SAIL_VERSION_STRING, options.loads);
+    }
+
+    sail_set_log_barrier(SAIL_LOG_LEVEL_ERROR);
+
+    printf("%-40s %8s %8s %14s %15s %15s %15s\n", "Input", "Threads", "Used", "Loads/s", "p50", "p99", "Setup");
+
+    struct threads_input small_input;
+
+    if (read_small_input(path, &small_input) == SAIL_OK) {
+        benchmark_input(&options, &output, &small_input);
+        sail_free(small_input.data);
+    } else {
+        fprintf(stderr, "Skipped: small image\n");
+    }
+
+    char large_name[64];
+    struct threads_input large_input;
+
+    if (create_large_input(&options, large_name, sizeof(large_name), &large_input) == SAIL_OK) {
+        benchmark_input(&options, &output, &large_input);
+        sail_free(large_input.data);
+    } else {
+        fprintf(stderr, "Skipped: large image\n");
+    }
+
+    if (output.json != NULL) {
+        fprintf(output.json, "\n  ]\n}\n");
+        fclose(output.json);
+    }
+
+    /* Restore the default pool size. */
+    sail_set_thread_pool_size(0);
+
+    sail_finish();
+
+    return 0;
+}
@@ -26,6 +26,8 @@ macro(sail_codec)
         sail_enable_asan(TARGET ${SAIL_CODEC_TARGET})
     endif()
 
+    sail_enable_pgo(TARGET ${SAIL_CODEC_TARGET})
+
     # Disable a "lib" prefix on Unix
     #
     set_target_properties(${SAIL_CODEC_TARGET} PROPERTIES PREFIX "")
@@ -76,6 +78,41 @@ macro(sail_codec)
                    ${CMAKE_CURRENT_BINARY_DIR}/sail-codec-${SAIL_CODEC_NAME}.codec.info
                    @ONLY)
 
+    # Export all the codec functions as a single table, so libsail resolves one symbol.
+    # Codecs with the SEEK, RESET, and PUSH load features implement the optional functions.
+    #
+    if (NOT SAIL_COMBINE_CODECS)
+        file(READ ${CMAKE_CURRENT_BINARY_DIR}/sail-codec-${SAIL_CODEC_NAME}.codec.info SAIL_CODEC_INFO_CONTENTS)
+
+        if (SAIL_CODEC_INFO_CONTENTS MATCHES "\\[load-features\\]\nfeatures=[^\n]*SEEK")
+            set(SAIL_CODEC_LOAD_SEEK_FRAME "SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_seek_frame_v8)")
+        else()
+            set(SAIL_CODEC_LOAD_SEEK_FRAME "NULL")
+        endif()
+
+        if (SAIL_CODEC_INFO_CONTENTS MATCHES "\\[load-features\\]\nfeatures=[^\n]*RESET")
+            set(SAIL_CODEC_LOAD_RESET "SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_reset_v8)")
+        else()
+            set(SAIL_CODEC_LOAD_RESET "NULL")
+        endif()
+
+        if (SAIL_CODEC_INFO_CONTENTS MATCHES "\\[load-features\\]\nfeatures=[^\n]*PUSH")
+            set(SAIL_CODEC_LOAD_PUSH_INIT            "SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_push_init_v8)")
+            set(SAIL_CODEC_LOAD_PUSH_SEEK_NEXT_FRAME "SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_push_seek_next_frame_v8)")
+            set(SAIL_CODEC_LOAD_PUSH_FRAME           "SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_push_frame_v8)")
+        else()
+            set(SAIL_CODEC_LOAD_PUSH_INIT            "NULL")
+            set(SAIL_CODEC_LOAD_PUSH_SEEK_NEXT_FRAME "NULL")
+            set(SAIL_CODEC_LOAD_PUSH_FRAME           "NULL")
+        endif()
+
+        configure_file(${PROJECT_SOURCE_DIR}/src/sail-codecs/codec_layout.c.in
+                       ${CMAKE_CURRENT_BINARY_DIR}/sail-codec-${SAIL_CODEC_NAME}-layout.c
+                       @ONLY)
+
+        target_sources(${SAIL_CODEC_TARGET} PRIVATE ${CMAKE_CURRENT_BINARY_DIR}/sail-codec-${SAIL_CODEC_NAME}-layout.c)
+    endif()
+
     # Installation
     #
     if (NOT SAIL_COMBINE_CODECS)
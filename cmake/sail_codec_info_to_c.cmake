@@ -0,0 +1,208 @@
+# Intended to be included by SAIL. Converts the specified generated .codec.info file
+# into constant C data, so combined codecs are registered without parsing their info
+# at startup.
+#
+# Appends the data definitions to the variable named by DEFINITIONS and sets the variable
+# named by SYMBOL to the name of the resulting sail_codec_info object.
+#
+function(sail_codec_info_to_c)
+    cmake_parse_arguments(SAIL_INFO "" "CODEC;PATH;DEFINITIONS;SYMBOL" "" ${ARGN})
+
+    set(PREFIX "sail_codec_info_${SAIL_INFO_CODEC}")
+
+    # Lists are separated with semicolons in both CMake and codec info files, so parse
+    # the lines with a temporary separator.
+    #
+    file(READ ${SAIL_INFO_PATH} CONTENTS)
+    string(ASCII 1 SEPARATOR)
+    string(REPLACE ";" "${SEPARATOR}" CONTENTS "${CONTENTS}")
+    string(REPLACE "\n" ";" LINES "${CONTENTS}")
+
+    set(SECTION "")
+
+    foreach (LINE IN LISTS LINES)
+        string(STRIP "${LINE}" LINE)
+
+        if (LINE STREQUAL "" OR LINE MATCHES "^#")
+            continue()
+        endif()
+
+        if (LINE MATCHES "^\\[(.+)\\]$")
+            set(SECTION ${CMAKE_MATCH_1})
+        elseif (LINE MATCHES "^([^=]+)=(.*)$")
+            string(STRIP "${CMAKE_MATCH_1}" KEY)
+            string(STRIP "${CMAKE_MATCH_2}" VALUE)
+            string(REPLACE "${SEPARATOR}" ";" VALUE "${VALUE}")
+            list(REMOVE_ITEM VALUE "")
+
+            # Empty values are ignored like in the codec info parser
+            #
+            if (NOT VALUE STREQUAL "")
+                set(INFO_${SECTION}_${KEY} "${VALUE}")
+            endif()
+        endif()
+    endforeach()
+
+    set(DATA "")
+
+    # Simple C strings like "1.0.0"
+    #
+    macro(sail_c_string VALUE OUTPUT)
+        string(REPLACE "\\" "\\\\" ${OUTPUT} "${VALUE}")
+        string(REPLACE "\"" "\\\"" ${OUTPUT} "${${OUTPUT}}")
+        set(${OUTPUT} "(char *)\"${${OUTPUT}}\"")
+    endmacro()
+
+    # Static chains of string nodes
+    #
+    macro(sail_c_string_nodes NAME VALUES LOWER OUTPUT)
+        set(VALUES_LIST "${VALUES}")
+        list(LENGTH VALUES_LIST VALUES_LENGTH)
+
+        if (VALUES_LENGTH EQUAL 0)
+            set(${OUTPUT} "NULL")
+        else()
+            string(APPEND DATA "static struct sail_string_node ${PREFIX}_${NAME}[] = {\n")
+            set(INDEX 0)
+
+            foreach (NODE_VALUE IN LISTS VALUES_LIST)
+                math(EXPR INDEX "${INDEX} + 1")
+
+                if (${LOWER})
+                    string(TOLOWER "${NODE_VALUE}" NODE_VALUE)
+                endif()
+
+                sail_c_string("${NODE_VALUE}" NODE_STRING)
+
+                if (INDEX EQUAL VALUES_LENGTH)
+                    string(APPEND DATA "    { ${NODE_STRING}, NULL },\n")
+                else()
+                    string(APPEND DATA "    { ${NODE_STRING}, &${PREFIX}_${NAME}[${INDEX}] },\n")
+                endif()
+            endforeach()
+
+            string(APPEND DATA "};\n\n")
+            set(${OUTPUT} "${PREFIX}_${NAME}")
+        endif()
+    endmacro()
+
+    # Or-ed enum values like SAIL_CODEC_FEATURE_STATIC | SAIL_CODEC_FEATURE_META_DATA
+    #
+    macro(sail_c_flags ENUM_PREFIX VALUES OUTPUT)
+        set(${OUTPUT} "")
+
+        foreach (FLAG IN LISTS ${VALUES})
+            string(REPLACE "-" "_" FLAG "${FLAG}")
+
+            if (${OUTPUT} STREQUAL "")
+                set(${OUTPUT} "${ENUM_PREFIX}${FLAG}")
+            else()
+                set(${OUTPUT} "${${OUTPUT}} | ${ENUM_PREFIX}${FLAG}")
+            endif()
+        endforeach()
+
+        if (${OUTPUT} STREQUAL "")
+            set(${OUTPUT} "0")
+        endif()
+    endmacro()
+
+    # Static arrays of enum values
+    #
+    macro(sail_c_enums NAME TYPE ENUM_PREFIX VALUES OUTPUT OUTPUT_LENGTH)
+        list(LENGTH ${VALUES} ${OUTPUT_LENGTH})
+
+        if (${OUTPUT_LENGTH} EQUAL 0)
+            set(${OUTPUT} "NULL")
+        else()
+            string(APPEND DATA "static enum ${TYPE} ${PREFIX}_${NAME}[] = {\n")
+
+            foreach (ENUM_VALUE IN LISTS ${VALUES})
+                string(REPLACE "-" "_" ENUM_VALUE "${ENUM_VALUE}")
+                string(APPEND DATA "    ${ENUM_PREFIX}${ENUM_VALUE},\n")
+            endforeach()
+
+            string(APPEND DATA "};\n\n")
+            set(${OUTPUT} "${PREFIX}_${NAME}")
+        endif()
+    endmacro()
+
+    sail_c_string_nodes(magic_numbers "${INFO_codec_magic-numbers}" TRUE  MAGIC_NUMBERS)
+    sail_c_string_nodes(extensions    "${INFO_codec_extensions}"    TRUE  EXTENSIONS)
+    sail_c_string_nodes(mime_types    "${INFO_codec_mime-types}"    TRUE  MIME_TYPES)
+    sail_c_string_nodes(load_tuning   "${INFO_load-features_tuning}" FALSE LOAD_TUNING)
+    sail_c_string_nodes(save_tuning   "${INFO_save-features_tuning}" FALSE SAVE_TUNING)
+
+    sail_c_flags(SAIL_CODEC_FEATURE_ INFO_load-features_features LOAD_FEATURES)
+    sail_c_flags(SAIL_CODEC_FEATURE_ INFO_save-features_features SAVE_FEATURES)
+
+    sail_c_enums(pixel_formats SailPixelFormat SAIL_PIXEL_FORMAT_ INFO_save-features_pixel-formats PIXEL_FORMATS PIXEL_FORMATS_LENGTH)
+    sail_c_enums(compressions  SailCompression SAIL_COMPRESSION_  INFO_save-features_compressions  COMPRESSIONS  COMPRESSIONS_LENGTH)
+
+    if (DEFINED INFO_save-features_default-compression)
+        string(REPLACE "-" "_" DEFAULT_COMPRESSION "SAIL_COMPRESSION_${INFO_save-features_default-compression}")
+    else()
+        set(DEFAULT_COMPRESSION "SAIL_COMPRESSION_UNKNOWN")
+    endif()
+
+    set(COMPRESSION_LEVEL "NULL")
+
+    foreach (LEVEL_KEY min max default step)
+        if (DEFINED INFO_save-features_compression-level-${LEVEL_KEY})
+            set(COMPRESSION_LEVEL "&${PREFIX}_compression_level")
+        endif()
+    endforeach()
+
+    if (NOT COMPRESSION_LEVEL STREQUAL "NULL")
+        foreach (LEVEL_KEY min max default step)
+            if (DEFINED INFO_save-features_compression-level-${LEVEL_KEY})
+                set(LEVEL_${LEVEL_KEY} "${INFO_save-features_compression-level-${LEVEL_KEY}}")
+            else()
+                set(LEVEL_${LEVEL_KEY} "0")
+            endif()
+        endforeach()
+
+        string(APPEND DATA "static struct sail_compression_level ${PREFIX}_compression_level = {
+    .min_level     = ${LEVEL_min},
+    .max_level     = ${LEVEL_max},
+    .default_level = ${LEVEL_default},
+    .step          = ${LEVEL_step},
+};\n\n")
+    endif()
+
+    sail_c_string("${INFO_codec_version}"     VERSION)
+    sail_c_string("${INFO_codec_name}"        NAME)
+    sail_c_string("${INFO_codec_description}" DESCRIPTION)
+
+    string(APPEND DATA "static struct sail_load_features ${PREFIX}_load_features = {
+    .features = ${LOAD_FEATURES},
+    .tuning   = ${LOAD_TUNING},
+};
+
+static struct sail_save_features ${PREFIX}_save_features = {
+    .pixel_formats        = ${PIXEL_FORMATS},
+    .pixel_formats_length = ${PIXEL_FORMATS_LENGTH},
+    .features             = ${SAVE_FEATURES},
+    .compressions         = ${COMPRESSIONS},
+    .compressions_length  = ${COMPRESSIONS_LENGTH},
+    .default_compression  = ${DEFAULT_COMPRESSION},
+    .compression_level    = ${COMPRESSION_LEVEL},
+    .tuning               = ${SAVE_TUNING},
+};
+
+static struct sail_codec_info ${PREFIX} = {
+    .path              = NULL,
+    .layout            = ${INFO_codec_layout},
+    .priority          = SAIL_CODEC_PRIORITY_${INFO_codec_priority},
+    .version           = ${VERSION},
+    .name              = ${NAME},
+    .description       = ${DESCRIPTION},
+    .magic_number_node = ${MAGIC_NUMBERS},
+    .extension_node    = ${EXTENSIONS},
+    .mime_type_node    = ${MIME_TYPES},
+    .load_features     = &${PREFIX}_load_features,
+    .save_features     = &${PREFIX}_save_features,
+};\n\n")
+
+    set(${SAIL_INFO_DEFINITIONS} "${${SAIL_INFO_DEFINITIONS}}${DATA}" PARENT_SCOPE)
+    set(${SAIL_INFO_SYMBOL} "${PREFIX}" PARENT_SCOPE)
+endfunction()
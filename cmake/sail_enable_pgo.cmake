@@ -0,0 +1,72 @@
+# Intended to be included by SAIL libraries and codecs. Instruments the target to gather
+# a profile with SAIL_PGO=GENERATE or optimizes it with the gathered profile with SAIL_PGO=USE.
+#
+macro(sail_enable_pgo)
+    cmake_parse_arguments(SAIL_PGO_ARGS "" "TARGET" "" ${ARGN})
+
+    if (SAIL_PGO STREQUAL "GENERATE")
+        target_compile_options(${SAIL_PGO_ARGS_TARGET} PRIVATE ${SAIL_PGO_GENERATE_FLAGS})
+
+        # Instrumented code needs the profiling runtime
+        #
+        get_target_property(SAIL_PGO_TARGET_TYPE ${SAIL_PGO_ARGS_TARGET} TYPE)
+
+        if (NOT SAIL_PGO_TARGET_TYPE STREQUAL "OBJECT_LIBRARY")
+            target_link_libraries(${SAIL_PGO_ARGS_TARGET} PRIVATE ${SAIL_PGO_GENERATE_FLAGS})
+        endif()
+    elseif (SAIL_PGO STREQUAL "USE")
+        target_compile_options(${SAIL_PGO_ARGS_TARGET} PRIVATE ${SAIL_PGO_USE_FLAGS})
+    endif()
+endmacro()
+
+# Validates SAIL_PGO and sets SAIL_PGO_GENERATE_FLAGS and SAIL_PGO_USE_FLAGS for the current compiler.
+#
+macro(sail_check_pgo)
+    string(TOUPPER "${SAIL_PGO}" SAIL_PGO)
+
+    if (SAIL_PGO STREQUAL "" OR SAIL_PGO STREQUAL "OFF")
+        set(SAIL_PGO "OFF")
+        set(SAIL_PGO_DISPLAY "OFF" CACHE INTERNAL "")
+    elseif (NOT SAIL_PGO STREQUAL "GENERATE" AND NOT SAIL_PGO STREQUAL "USE")
+        message(FATAL_ERROR "Invalid SAIL_PGO value '${SAIL_PGO}'. Possible values: OFF, GENERATE, USE.")
+    elseif (CMAKE_C_COMPILER_ID STREQUAL "GNU")
+        # Codecs and conversions run in OpenMP threads, so update the counters atomically
+        #
+        set(SAIL_PGO_GENERATE_FLAGS "-fprofile-generate=${SAIL_PGO_PROFILE_DIR}" "-fprofile-update=atomic")
+        set(SAIL_PGO_USE_FLAGS      "-fprofile-use=${SAIL_PGO_PROFILE_DIR}" "-fprofile-correction")
+
+        # Name the profile files relative to the build directory, so a profile gathered
+        # in one build directory can be used in another one
+        #
+        if (CMAKE_C_COMPILER_VERSION VERSION_GREATER_EQUAL 11)
+            list(APPEND SAIL_PGO_GENERATE_FLAGS "-fprofile-prefix-path=${PROJECT_BINARY_DIR}")
+            list(APPEND SAIL_PGO_USE_FLAGS      "-fprofile-prefix-path=${PROJECT_BINARY_DIR}")
+        endif()
+
+        # Code not run by the training workload is still optimized as usual
+        #
+        if (CMAKE_C_COMPILER_VERSION VERSION_GREATER_EQUAL 10)
+            list(APPEND SAIL_PGO_USE_FLAGS "-fprofile-partial-training" "-Wno-missing-profile")
+        endif()
+
+        set(SAIL_PGO_DISPLAY "${SAIL_PGO} (${SAIL_PGO_PROFILE_DIR})" CACHE INTERNAL "")
+    elseif (CMAKE_C_COMPILER_ID MATCHES "Clang")
+        get_filename_component(SAIL_C_COMPILER_DIR "${CMAKE_C_COMPILER}" DIRECTORY)
+        find_program(SAIL_LLVM_PROFDATA NAMES llvm-profdata
+                                        HINTS "${SAIL_C_COMPILER_DIR}"
+                                        DOC "llvm-profdata to merge the raw profiles gathered with SAIL_PGO=GENERATE.")
+
+        set(SAIL_PGO_GENERATE_FLAGS "-fprofile-generate=${SAIL_PGO_PROFILE_DIR}")
+        set(SAIL_PGO_USE_FLAGS      "-fprofile-use=${SAIL_PGO_PROFILE_DIR}/sail.profdata"
+                                    "-Wno-profile-instr-unprofiled" "-Wno-profile-instr-out-of-date")
+
+        if (SAIL_PGO STREQUAL "USE" AND NOT EXISTS "${SAIL_PGO_PROFILE_DIR}/sail.profdata")
+            message(FATAL_ERROR "${SAIL_PGO_PROFILE_DIR}/sail.profdata doesn't exist. Build the sail-pgo-profile target "
+                                "with SAIL_PGO=GENERATE first.")
+        endif()
+
+        set(SAIL_PGO_DISPLAY "${SAIL_PGO} (${SAIL_PGO_PROFILE_DIR})" CACHE INTERNAL "")
+    else()
+        message(FATAL_ERROR "SAIL_PGO is supported with GCC and Clang only.")
+    endif()
+endmacro()
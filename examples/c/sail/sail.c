@@ -23,10 +23,17 @@
     SOFTWARE.
 */
 
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h> /* atoi */
 #include <string.h>
 
+#ifdef _WIN32
+    #include <windows.h> /* FindFirstFile */
+#else
+    #include <dirent.h> /* opendir */
+#endif
+
 #include <sail/sail.h>
 
 #include <sail-manip/sail-manip.h>
@@ -35,42 +42,40 @@ static void print_invalid_argument(void) {
     fprintf(stderr, "Error: Invalid arguments. Run with -h to see command arguments.\n");
 }
 
+/* Converts every frame to the best pixel format for saving. */
+static sail_status_t convert_for_saving(struct sail_image *image, struct sail_image **image_output, void *user_data) {
+
+    const struct sail_save_features *save_features = user_data;
+
+    /* Skip the conversion and its whole image copy if the codec accepts the pixel format as is. */
+    if (sail_closest_pixel_format_from_save_features(image->pixel_format, save_features) == image->pixel_format) {
+        *image_output = image;
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(sail_convert_image_for_saving(image, save_features, image_output));
+
+    return SAIL_OK;
+}
+
 static sail_status_t convert_impl(const char *input, const char *output, int compression) {
 
     SAIL_CHECK_PTR(input);
     SAIL_CHECK_PTR(output);
 
+    const struct sail_codec_info *codec_info_input;
     const struct sail_codec_info *codec_info;
-    void *state;
-
-    struct sail_image *image;
 
-    /* Load the image. */
     SAIL_LOG_INFO("Input file: %s", input);
 
-    SAIL_TRY(sail_codec_info_from_path(input, &codec_info));
-    SAIL_LOG_INFO("Input codec: %s", codec_info->description);
-
-    SAIL_TRY(sail_start_loading_from_file(input, codec_info, &state));
-
-    SAIL_TRY(sail_load_next_frame(state, &image));
-    SAIL_TRY(sail_stop_loading(state));
+    SAIL_TRY(sail_codec_info_from_path(input, &codec_info_input));
+    SAIL_LOG_INFO("Input codec: %s", codec_info_input->description);
 
-    /* Save the image. */
     SAIL_LOG_INFO("Output file: %s", output);
 
     SAIL_TRY(sail_codec_info_from_path(output, &codec_info));
     SAIL_LOG_INFO("Output codec: %s", codec_info->description);
 
-    /* Convert to the best pixel format for saving. */
-    {
-        struct sail_image *image_converted;
-        SAIL_TRY(sail_convert_image_for_saving(image, codec_info->save_features, &image_converted));
-
-        sail_destroy_image(image);
-        image = image_converted;
-    }
-
     struct sail_save_options *save_options;
     SAIL_TRY(sail_alloc_save_options_from_features(codec_info->save_features, &save_options));
 
@@ -78,14 +83,27 @@ static sail_status_t convert_impl(const char *input, const char *output, int com
     SAIL_LOG_INFO("Compression: %d%s", compression, compression == -1 ? " (default)" : "");
     save_options->compression_level = compression;
 
-    SAIL_TRY(sail_start_saving_into_file_with_options(output, codec_info, save_options, &state));
-    SAIL_TRY(sail_write_next_frame(state, image));
-    SAIL_TRY(sail_stop_saving(state));
+    struct sail_io *io_input;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io_read_file(input, &io_input),
+                        /* cleanup */ sail_destroy_save_options(save_options));
+
+    struct sail_io *io_output;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io_read_write_file(output, &io_output),
+                        /* cleanup */ sail_destroy_io(io_input),
+                                      sail_destroy_save_options(save_options));
+
+    /* Load the next frame while the previous one is converted and saved. */
+    SAIL_TRY_OR_CLEANUP(sail_transcode(io_input, codec_info_input, io_output, codec_info, NULL, save_options,
+                                       convert_for_saving, (void *)codec_info->save_features),
+                        /* cleanup */ sail_destroy_io(io_output),
+                                      sail_destroy_io(io_input),
+                                      sail_destroy_save_options(save_options));
 
     /* Clean up. */
-    sail_destroy_save_options(save_options);
+    sail_destroy_io(io_output);
+    sail_destroy_io(io_input);
 
-    sail_destroy_image(image);
+    sail_destroy_save_options(save_options);
 
     return SAIL_OK;
 }
@@ -124,6 +142,437 @@ static sail_status_t convert(int argc, char *argv[]) {
     return SAIL_OK;
 }
 
+struct batch_list {
+
+    char **paths;
+    size_t length;
+    size_t capacity;
+};
+
+/* Status and file sizes of one converted file. */
+struct batch_result {
+
+    sail_status_t status;
+    size_t input_size;
+    size_t output_size;
+};
+
+/* Loading states of different input codecs reused by a batch job. */
+#define BATCH_STATES_MAX 4
+
+struct batch_codec_state {
+
+    const struct sail_codec_info *codec_info;
+    void *state;
+};
+
+struct batch_context {
+
+    const struct batch_list *inputs;
+    const char *output_dir;
+    const char *format;
+    const struct sail_codec_info *codec_info;
+    const struct sail_load_options *load_options;
+    const struct sail_save_options *save_options;
+    struct batch_result *results;
+    /* BATCH_STATES_MAX loading states per thread of the pool. */
+    struct batch_codec_state *codec_states;
+};
+
+static sail_status_t batch_list_add(struct batch_list *list, const char *path) {
+
+    if (list->length == list->capacity) {
+        const size_t capacity = (list->capacity == 0) ? 16 : list->capacity * 2;
+
+        void *ptr = list->paths;
+        SAIL_TRY(sail_realloc(sizeof(char *) * capacity, &ptr));
+
+        list->paths    = ptr;
+        list->capacity = capacity;
+    }
+
+    SAIL_TRY(sail_strdup(path, &list->paths[list->length]));
+    list->length++;
+
+    return SAIL_OK;
+}
+
+static void batch_list_destroy(struct batch_list *list) {
+
+    for (size_t i = 0; i < list->length; i++) {
+        sail_free(list->paths[i]);
+    }
+
+    sail_free(list->paths);
+}
+
+/* Adds the files from the directory that have a known extension. Subdirectories are skipped. */
+static sail_status_t batch_list_add_dir(struct batch_list *list, const char *dir_path) {
+
+#ifdef _WIN32
+    char *mask;
+    SAIL_TRY(sail_concat(&mask, 2, dir_path, "\\*"));
+
+    WIN32_FIND_DATAA data;
+    HANDLE hFind = FindFirstFileA(mask, &data);
+    sail_free(mask);
+
+    if (hFind == INVALID_HANDLE_VALUE) {
+        fprintf(stderr, "Error: Failed to list files in '%s'.\n", dir_path);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    do {
+        const char *name = data.cFileName;
+#else
+    DIR *d = opendir(dir_path);
+
+    if (d == NULL) {
+        fprintf(stderr, "Error: Failed to list files in '%s'.\n", dir_path);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    struct dirent *dir;
+
+    while ((dir = readdir(d)) != NULL) {
+        const char *name = dir->d_name;
+#endif
+        char *full_path;
+
+#ifdef _WIN32
+        SAIL_TRY_OR_CLEANUP(sail_concat(&full_path, 3, dir_path, "\\", name),
+                            /* cleanup */ FindClose(hFind));
+#else
+        SAIL_TRY_OR_CLEANUP(sail_concat(&full_path, 3, dir_path, "/", name),
+                            /* cleanup */ closedir(d));
+#endif
+
+        const struct sail_codec_info *codec_info;
+        sail_status_t status = SAIL_OK;
+
+        if (sail_is_file(full_path) && sail_codec_info_from_path(full_path, &codec_info) == SAIL_OK) {
+            status = batch_list_add(list, full_path);
+        }
+
+        sail_free(full_path);
+
+        if (status != SAIL_OK) {
+#ifdef _WIN32
+            FindClose(hFind);
+#else
+            closedir(d);
+#endif
+            SAIL_LOG_AND_RETURN(status);
+        }
+#ifdef _WIN32
+    } while (FindNextFileA(hFind, &data));
+
+    FindClose(hFind);
+#else
+    }
+
+    closedir(d);
+#endif
+
+    return SAIL_OK;
+}
+
+/* Builds "<output dir>/<input name without extension>.<format>". */
+static sail_status_t build_output_path(const char *output_dir, const char *input, const char *format, char **output) {
+
+    const char *name = input;
+
+    for (const char *c = input; *c != '\0'; c++) {
+        if (*c == '/' || *c == '\\') {
+            name = c + 1;
+        }
+    }
+
+    const char *dot = strrchr(name, '.');
+
+    char *stem;
+    SAIL_TRY(sail_strdup_length(name, (dot == NULL || dot == name) ? strlen(name) : (size_t)(dot - name), &stem));
+
+#ifdef _WIN32
+    SAIL_TRY_OR_CLEANUP(sail_concat(output, 5, output_dir, "\\", stem, ".", format),
+                        /* cleanup */ sail_free(stem));
+#else
+    SAIL_TRY_OR_CLEANUP(sail_concat(output, 5, output_dir, "/", stem, ".", format),
+                        /* cleanup */ sail_free(stem));
+#endif
+
+    sail_free(stem);
+
+    return SAIL_OK;
+}
+
+/* Starts loading the file with the reused state of the same codec, or with a new state. */
+static sail_status_t batch_start_loading(const struct batch_context *batch_context,
+                                         struct batch_codec_state codec_states[BATCH_STATES_MAX],
+                                         unsigned task, const char *input, void **state) {
+
+    /* Fall back to the magic number detection for unknown extensions. */
+    const struct sail_codec_info *codec_info;
+
+    if (sail_codec_info_from_path(input, &codec_info) != SAIL_OK) {
+        SAIL_TRY(sail_codec_info_by_magic_number_from_path(input, &codec_info));
+    }
+
+    struct batch_codec_state *codec_state = NULL;
+
+    for (unsigned i = 0; i < BATCH_STATES_MAX; i++) {
+        if (codec_states[i].state != NULL && codec_states[i].codec_info == codec_info) {
+            codec_state = &codec_states[i];
+
+            SAIL_TRY_OR_CLEANUP(sail_restart_loading_from_file(codec_state->state, input),
+                                /* cleanup */ sail_stop_loading(codec_state->state),
+                                              codec_state->state = NULL);
+
+            *state = codec_state->state;
+
+            return SAIL_OK;
+        }
+    }
+
+    /* Take a free slot or replace a state in round robin. */
+    for (unsigned i = 0; i < BATCH_STATES_MAX && codec_state == NULL; i++) {
+        if (codec_states[i].state == NULL) {
+            codec_state = &codec_states[i];
+        }
+    }
+
+    if (codec_state == NULL) {
+        codec_state = &codec_states[task % BATCH_STATES_MAX];
+
+        sail_stop_loading(codec_state->state);
+        codec_state->state = NULL;
+    }
+
+    SAIL_TRY(sail_start_loading_from_file_with_options(input, codec_info, batch_context->load_options, &codec_state->state));
+
+    codec_state->codec_info = codec_info;
+    *state = codec_state->state;
+
+    return SAIL_OK;
+}
+
+static sail_status_t batch_convert_one(const struct batch_context *batch_context,
+                                       struct batch_codec_state codec_states[BATCH_STATES_MAX],
+                                       unsigned task, const char *input, const char *output) {
+
+    void *load_state;
+    SAIL_TRY(batch_start_loading(batch_context, codec_states, task, input, &load_state));
+
+    const struct sail_codec_info *codec_info = batch_context->codec_info;
+
+    void *save_state;
+    SAIL_TRY(sail_start_saving_into_file_with_options(output, codec_info, batch_context->save_options, &save_state));
+
+    /* Single-frame codecs save only the first frame like sail_transcode(). */
+    const bool single_frame = (codec_info->save_features->features
+                                & (SAIL_CODEC_FEATURE_ANIMATED | SAIL_CODEC_FEATURE_MULTI_PAGED)) == 0;
+
+    struct sail_image *image;
+    sail_status_t status;
+
+    while ((status = sail_load_next_frame(load_state, &image)) == SAIL_OK) {
+        struct sail_image *image_for_saving;
+        status = convert_for_saving(image, &image_for_saving, (void *)codec_info->save_features);
+
+        if (status == SAIL_OK) {
+            status = sail_write_next_frame(save_state, image_for_saving);
+
+            if (image_for_saving != image) {
+                sail_destroy_image(image_for_saving);
+            }
+        }
+
+        sail_destroy_image(image);
+
+        if (status != SAIL_OK || single_frame) {
+            break;
+        }
+    }
+
+    status = (status == SAIL_ERROR_NO_MORE_FRAMES) ? SAIL_OK : status;
+
+    const sail_status_t stop_status = sail_stop_saving(save_state);
+    status = (status == SAIL_OK) ? stop_status : status;
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
+
+/* Converts one input file. Runs in the thread pool. */
+static void batch_convert_task(void *user_data, unsigned task, unsigned thread) {
+
+    const struct batch_context *batch_context = user_data;
+    struct batch_codec_state *codec_states = &batch_context->codec_states[(size_t)thread * BATCH_STATES_MAX];
+    const char *input = batch_context->inputs->paths[task];
+    struct batch_result *result = &batch_context->results[task];
+
+    char *output;
+    sail_status_t status = build_output_path(batch_context->output_dir, input, batch_context->format, &output);
+
+    if (status == SAIL_OK) {
+        status = batch_convert_one(batch_context, codec_states, task, input, output);
+
+        if (status == SAIL_OK) {
+            (void)sail_file_size(input, &result->input_size);
+            (void)sail_file_size(output, &result->output_size);
+        }
+
+        sail_free(output);
+    }
+
+    result->status = status;
+}
+
+static sail_status_t batch_convert_impl(const struct batch_list *inputs, const char *output_dir, const char *format,
+                                        unsigned jobs, size_t max_memory, int compression) {
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_extension(format, &codec_info));
+    SAIL_LOG_INFO("Output codec: %s", codec_info->description);
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options(&load_options));
+
+    /* Every job may hold a frame, so split the memory budget between them. */
+    load_options->limits.max_bytes = max_memory / jobs;
+
+    struct sail_save_options *save_options;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_save_options_from_features(codec_info->save_features, &save_options),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+    save_options->compression_level = compression;
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_calloc(inputs->length, sizeof(struct batch_result), &ptr),
+                        /* cleanup */ sail_destroy_save_options(save_options),
+                                      sail_destroy_load_options(load_options));
+
+    struct batch_result *results = ptr;
+
+    sail_set_thread_pool_size(jobs);
+
+    /* Every thread reuses its loading states, and so the decoders, for the files of the same input format. */
+    const unsigned threads = sail_thread_pool_size();
+
+    SAIL_TRY_OR_CLEANUP(sail_calloc((size_t)threads * BATCH_STATES_MAX, sizeof(struct batch_codec_state), &ptr),
+                        /* cleanup */ sail_free(results),
+                                      sail_destroy_save_options(save_options),
+                                      sail_destroy_load_options(load_options));
+
+    struct batch_codec_state *codec_states = ptr;
+
+    const struct batch_context batch_context = {
+        inputs, output_dir, format, codec_info, load_options, save_options, results, codec_states
+    };
+
+    const uint64_t start_ns = sail_now_ns();
+    sail_thread_pool_run((unsigned)inputs->length, batch_convert_task, (void *)&batch_context);
+
+    for (size_t i = 0; i < (size_t)threads * BATCH_STATES_MAX; i++) {
+        sail_stop_loading(codec_states[i].state);
+    }
+
+    const uint64_t elapsed_ns = sail_now_ns() - start_ns;
+
+    sail_free(codec_states);
+
+    size_t converted = 0;
+    uint64_t input_bytes = 0;
+    uint64_t output_bytes = 0;
+
+    for (size_t i = 0; i < inputs->length; i++) {
+        if (results[i].status == SAIL_OK) {
+            converted++;
+            input_bytes  += results[i].input_size;
+            output_bytes += results[i].output_size;
+        } else {
+            fprintf(stderr, "Failed: %s (error %d)\n", inputs->paths[i], results[i].status);
+        }
+    }
+
+    const double seconds = (double)(elapsed_ns == 0 ? 1 : elapsed_ns) / 1e9;
+
+    printf("Converted %zu of %zu images in %.3f s with %u jobs\n", converted, inputs->length, seconds, jobs);
+    printf("Throughput: %.1f images/s, %.1f MB/s read, %.1f MB/s written\n",
+            converted / seconds, input_bytes / seconds / 1e6, output_bytes / seconds / 1e6);
+
+    sail_free(results);
+    sail_destroy_save_options(save_options);
+    sail_destroy_load_options(load_options);
+
+    if (converted != inputs->length) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t batch_convert(int argc, char *argv[]) {
+
+    const char *output_dir = NULL;
+    const char *format = NULL;
+    unsigned jobs = 0;
+    size_t max_memory = 0;
+    int compression = -1;
+
+    struct batch_list inputs = { NULL, 0, 0 };
+
+    for (int i = 2; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+        sail_status_t status = SAIL_OK;
+
+        if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && has_value) {
+            const int value = atoi(argv[++i]);
+            jobs = (value > 0) ? (unsigned)value : 0;
+        } else if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--format") == 0) && has_value) {
+            format = argv[++i];
+        } else if ((strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--max-memory") == 0) && has_value) {
+            const int value = atoi(argv[++i]);
+            max_memory = (value > 0) ? (size_t)value * 1024 * 1024 : 0;
+        } else if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--compression") == 0) && has_value) {
+            compression = atoi(argv[++i]);
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Error: Unrecognized option '%s'.\n", argv[i]);
+            status = SAIL_ERROR_INVALID_ARGUMENT;
+        } else if (output_dir == NULL) {
+            output_dir = argv[i];
+        } else if (sail_is_dir(argv[i])) {
+            status = batch_list_add_dir(&inputs, argv[i]);
+        } else {
+            status = batch_list_add(&inputs, argv[i]);
+        }
+
+        if (status != SAIL_OK) {
+            batch_list_destroy(&inputs);
+            SAIL_LOG_AND_RETURN(status);
+        }
+    }
+
+    if (format == NULL || output_dir == NULL || inputs.length == 0 || !sail_is_dir(output_dir)) {
+        print_invalid_argument();
+        batch_list_destroy(&inputs);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    /* 0 jobs: as many as processors. */
+    if (jobs == 0) {
+        sail_set_thread_pool_size(0);
+        jobs = sail_thread_pool_size();
+    }
+
+    SAIL_TRY_OR_CLEANUP(batch_convert_impl(&inputs, output_dir, format, jobs, max_memory, compression),
+                        /* cleanup */ batch_list_destroy(&inputs));
+
+    batch_list_destroy(&inputs);
+
+    return SAIL_OK;
+}
+
 static bool special_properties_printf_callback(const char *key, const struct sail_variant *value) {
 
     printf("  %s : ", key);
@@ -267,6 +716,370 @@ static sail_status_t decode(int argc, char *argv[]) {
     return SAIL_OK;
 }
 
+/* Loads all the frames from the I/O stream. Returns the first frame if 'first_frame' is not NULL. */
+static sail_status_t load_frames_from_io(struct sail_io *io, const struct sail_codec_info *codec_info,
+                                         const struct sail_load_options *load_options,
+                                         struct sail_image **first_frame, unsigned *frames) {
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_io_with_options(io, codec_info, load_options, &state),
+                        /* cleanup */ sail_stop_loading(state));
+
+    struct sail_image *first_frame_local = NULL;
+    struct sail_image *image;
+    sail_status_t status;
+    unsigned frames_local = 0;
+
+    while ((status = sail_load_next_frame(state, &image)) == SAIL_OK) {
+        if (frames_local++ == 0 && first_frame != NULL) {
+            first_frame_local = image;
+        } else {
+            sail_destroy_image(image);
+        }
+    }
+
+    if (status != SAIL_ERROR_NO_MORE_FRAMES) {
+        sail_stop_loading(state);
+        sail_destroy_image(first_frame_local);
+        SAIL_LOG_AND_RETURN(status);
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
+                        /* cleanup */ sail_destroy_image(first_frame_local));
+
+    if (first_frame != NULL) {
+        *first_frame = first_frame_local;
+    }
+    if (frames != NULL) {
+        *frames = frames_local;
+    }
+
+    return SAIL_OK;
+}
+
+/* Loads the file with the file or memory-mapped file I/O and returns the best time of the iterations. */
+static sail_status_t time_load(const char *path, bool mmap, const struct sail_codec_info *codec_info,
+                               const struct sail_load_options *load_options, unsigned iterations,
+                               uint64_t *best_ns, struct sail_image **first_frame, unsigned *frames) {
+
+    *best_ns = UINT64_MAX;
+
+    for (unsigned i = 0; i < iterations; i++) {
+        const uint64_t start_ns = sail_now_ns();
+
+        struct sail_io *io;
+        SAIL_TRY(mmap ? sail_alloc_io_read_mmap_file(path, &io) : sail_alloc_io_read_file(path, &io));
+
+        /* Return the first frame of the last iteration. */
+        SAIL_TRY_OR_CLEANUP(load_frames_from_io(io, codec_info, load_options,
+                                                (i + 1 == iterations) ? first_frame : NULL, frames),
+                            /* cleanup */ sail_destroy_io(io));
+
+        sail_destroy_io(io);
+
+        const uint64_t elapsed_ns = sail_now_ns() - start_ns;
+        *best_ns = (elapsed_ns < *best_ns) ? elapsed_ns : *best_ns;
+    }
+
+    return SAIL_OK;
+}
+
+static void print_stage(const char *name, uint64_t total_ns, unsigned iterations) {
+
+    printf("  %-13s : %10.3f ms\n", name, (double)total_ns / iterations / 1e6);
+}
+
+static sail_status_t bench_impl(const char *path, unsigned iterations, const char *format) {
+
+    SAIL_CHECK_PTR(path);
+
+    const struct sail_codec_info *codec_info_input;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info_input));
+
+    const struct sail_codec_info *codec_info_output = codec_info_input;
+
+    if (format != NULL) {
+        SAIL_TRY(sail_codec_info_from_extension(format, &codec_info_output));
+    }
+
+    printf("File          : %s\n", path);
+    printf("Input codec   : %s [%s]\n", codec_info_input->name, codec_info_input->description);
+    printf("Output codec  : %s [%s]\n", codec_info_output->name, codec_info_output->description);
+    printf("Iterations    : %u\n", iterations);
+
+    struct sail_stats load_stats = { 0 };
+    struct sail_stats save_stats = { 0 };
+    uint64_t conversion_ns = 0;
+    unsigned frames = 0;
+    bool can_save = codec_info_output->save_features->pixel_formats_length > 0;
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info_input->load_features, &load_options));
+    load_options->stats = &load_stats;
+
+    struct sail_save_options *save_options = NULL;
+
+    if (can_save) {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_save_options_from_features(codec_info_output->save_features, &save_options),
+                            /* cleanup */ sail_destroy_load_options(load_options));
+        save_options->stats = &save_stats;
+    }
+
+    sail_status_t status = SAIL_OK;
+
+    for (unsigned i = 0; i < iterations && status == SAIL_OK; i++) {
+        /* Detect the codec every time to measure the detection. */
+        void *state = NULL;
+        status = sail_start_loading_from_file_with_options(path, NULL, load_options, &state);
+
+        struct sail_image *image = NULL;
+
+        if (status == SAIL_OK) {
+            struct sail_image *frame;
+            frames = 0;
+
+            while ((status = sail_load_next_frame(state, &frame)) == SAIL_OK) {
+                if (frames++ == 0) {
+                    image = frame;
+                } else {
+                    sail_destroy_image(frame);
+                }
+            }
+
+            status = (status == SAIL_ERROR_NO_MORE_FRAMES) ? SAIL_OK : status;
+        }
+
+        const sail_status_t stop_status = sail_stop_loading(state);
+        status = (status == SAIL_OK) ? stop_status : status;
+
+        /* Convert and encode the first frame into memory. */
+        if (status == SAIL_OK && image != NULL && can_save) {
+            const uint64_t start_ns = sail_now_ns();
+
+            struct sail_image *image_for_saving;
+            status = convert_for_saving(image, &image_for_saving, (void *)codec_info_output->save_features);
+
+            conversion_ns += sail_now_ns() - start_ns;
+
+            if (status == SAIL_OK) {
+                void *save_state = NULL;
+                status = sail_start_saving_into_growable_memory_with_options(codec_info_output, save_options, &save_state);
+
+                if (status == SAIL_OK) {
+                    status = sail_write_next_frame(save_state, image_for_saving);
+                }
+
+                void *buffer = NULL;
+                size_t buffer_size;
+                const sail_status_t save_stop_status = sail_stop_saving_into_growable_memory(save_state, &buffer, &buffer_size);
+                status = (status == SAIL_OK) ? save_stop_status : status;
+
+                sail_free(buffer);
+
+                if (image_for_saving != image) {
+                    sail_destroy_image(image_for_saving);
+                }
+            }
+        }
+
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_save_options(save_options);
+    sail_destroy_load_options(load_options);
+
+    if (status != SAIL_OK) {
+        fprintf(stderr, "Error: Benchmark failed with error %d.\n", status);
+        SAIL_LOG_AND_RETURN(status);
+    }
+
+    printf("Frames        : %u\n", frames);
+    printf("Mean time per iteration:\n");
+    print_stage("Detection", load_stats.detection_ns, iterations);
+    print_stage("Init", load_stats.init_ns, iterations);
+    print_stage("Headers", load_stats.seek_ns, iterations);
+    print_stage("Decode", load_stats.frames_ns, iterations);
+    print_stage("Finish", load_stats.finish_ns, iterations);
+
+    if (can_save) {
+        print_stage("Conversion", conversion_ns, iterations);
+        print_stage("Encode", save_stats.init_ns + save_stats.seek_ns + save_stats.frames_ns + save_stats.finish_ns, iterations);
+    } else {
+        printf("  %-13s : %s\n", "Encode", "not supported by the output codec");
+    }
+
+    printf("I/O           : %llu reads, %llu bytes read\n",
+            (unsigned long long)(load_stats.read_calls / iterations), (unsigned long long)(load_stats.bytes_read / iterations));
+    printf("Allocations   : %llu, %llu bytes\n",
+            (unsigned long long)((load_stats.allocations + save_stats.allocations) / iterations),
+            (unsigned long long)((load_stats.allocated_bytes + save_stats.allocated_bytes) / iterations));
+
+    struct sail_memory_stats memory_stats;
+
+    if (sail_memory_stats(&memory_stats) == SAIL_OK) {
+        printf("Peak memory   : %llu bytes\n", (unsigned long long)memory_stats.peak_bytes);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t bench(int argc, char *argv[]) {
+
+    if (argc < 3) {
+        print_invalid_argument();
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    unsigned iterations = 10;
+    const char *format = NULL;
+
+    for (int i = 3; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+
+        if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--iterations") == 0) && has_value) {
+            const int value = atoi(argv[++i]);
+            iterations = (value > 0) ? (unsigned)value : 1;
+        } else if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--format") == 0) && has_value) {
+            format = argv[++i];
+        } else {
+            fprintf(stderr, "Error: Unrecognized option '%s'.\n", argv[i]);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
+    SAIL_TRY(bench_impl(argv[2], iterations, format));
+
+    return SAIL_OK;
+}
+
+static sail_status_t profile_impl(const char *path, unsigned iterations, unsigned target_size) {
+
+    SAIL_CHECK_PTR(path);
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
+
+    printf("File          : %s\n", path);
+    printf("Codec         : %s [%s]\n", codec_info->name, codec_info->description);
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info->load_features, &load_options));
+
+    uint64_t full_ns;
+    struct sail_image *image;
+    unsigned frames;
+    SAIL_TRY_OR_CLEANUP(time_load(path, false, codec_info, load_options, iterations, &full_ns, &image, &frames),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+
+    const unsigned width = image->width;
+    const unsigned height = image->height;
+    sail_destroy_image(image);
+
+    printf("Size          : %ux%u, %u frame(s)\n", width, height, frames);
+    printf("Load time     : %.3f ms\n", full_ns / 1e6);
+    printf("Suggestions:\n");
+
+    const int features = codec_info->load_features->features;
+    unsigned suggestions = 0;
+    uint64_t elapsed_ns;
+
+    /* Scaled decoding for thumbnails. */
+    const unsigned min_size = (width < height) ? width : height;
+
+    if (target_size > 0 && min_size / 2 >= target_size) {
+        unsigned scale = 1;
+
+        while (scale < 8 && min_size / (scale * 2) >= target_size) {
+            scale *= 2;
+        }
+
+        if (features & SAIL_CODEC_FEATURE_SCALING) {
+            load_options->scale_denominator = scale;
+
+            if (time_load(path, false, codec_info, load_options, iterations, &elapsed_ns, NULL, NULL) == SAIL_OK) {
+                printf("  %s: scaled decode (scale_denominator = %u) would be %.1fx faster for target %upx\n",
+                        codec_info->name, scale, (double)full_ns / (elapsed_ns == 0 ? 1 : elapsed_ns), target_size);
+                suggestions++;
+            }
+
+            load_options->scale_denominator = 0;
+        } else {
+            printf("  %s: no native scaled decode, scale the loaded image down for target %upx\n",
+                    codec_info->name, target_size);
+            suggestions++;
+        }
+    }
+
+    /* Skip meta data and ICC profiles if they're not needed. */
+    const int meta_data_options = SAIL_OPTION_META_DATA | SAIL_OPTION_ICCP;
+
+    if (load_options->options & meta_data_options) {
+        load_options->options &= ~meta_data_options;
+
+        if (time_load(path, false, codec_info, load_options, iterations, &elapsed_ns, NULL, NULL) == SAIL_OK
+                && elapsed_ns * 10 < full_ns * 9) {
+            printf("  %s: loading without meta data and ICC profiles would be %.1fx faster\n",
+                    codec_info->name, (double)full_ns / (elapsed_ns == 0 ? 1 : elapsed_ns));
+            suggestions++;
+        }
+
+        load_options->options |= meta_data_options;
+    }
+
+    /* Memory-mapped I/O. */
+    if (time_load(path, true, codec_info, load_options, iterations, &elapsed_ns, NULL, NULL) == SAIL_OK
+            && elapsed_ns * 10 < full_ns * 9) {
+        printf("  %s: loading from a memory-mapped file would be %.1fx faster\n",
+                codec_info->name, (double)full_ns / (elapsed_ns == 0 ? 1 : elapsed_ns));
+        suggestions++;
+    }
+
+    /* Parallel frames. */
+    if (frames > 1 && (features & SAIL_CODEC_FEATURE_PARALLEL)) {
+        printf("  %s: %u independent frames, load them in parallel with sail_load_frames_from_memory()\n",
+                codec_info->name, frames);
+        suggestions++;
+    }
+
+    if (suggestions == 0) {
+        printf("  None\n");
+    }
+
+    sail_destroy_load_options(load_options);
+
+    return SAIL_OK;
+}
+
+static sail_status_t profile(int argc, char *argv[]) {
+
+    if (argc < 3) {
+        print_invalid_argument();
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    unsigned iterations = 5;
+    unsigned target_size = 256;
+
+    for (int i = 3; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+
+        if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--iterations") == 0) && has_value) {
+            const int value = atoi(argv[++i]);
+            iterations = (value > 0) ? (unsigned)value : 1;
+        } else if ((strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--target") == 0) && has_value) {
+            const int value = atoi(argv[++i]);
+            target_size = (value > 0) ? (unsigned)value : 0;
+        } else {
+            fprintf(stderr, "Error: Unrecognized option '%s'.\n", argv[i]);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
+    SAIL_TRY(profile_impl(argv[2], iterations, target_size));
+
+    return SAIL_OK;
+}
+
 static sail_status_t list_impl(bool verbose) {
 
     const struct sail_codec_bundle_node *codec_bundle_node = sail_codec_bundle_list();
@@ -330,10 +1143,22 @@ static void help(const char *app) {
     fprintf(stderr, "    list [-v] - List supported codecs.\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "    convert <INPUT PATH> <OUTPUT PATH> [-c | --compression <value>] - Convert one image format to another.\n");
+    fprintf(stderr, "    batch-convert <OUTPUT DIR> <INPUT PATH | INPUT DIR>... -f | --format <extension> [-j | --jobs <N>]\n");
+    fprintf(stderr, "                  [-m | --max-memory <MiB>] [-c | --compression <value>]\n");
+    fprintf(stderr, "                  - Convert the files and the images in the directories into the output directory\n");
+    fprintf(stderr, "                    in N parallel jobs (default: number of processors) and print the throughput.\n");
+    fprintf(stderr, "                    Images that need more than MiB/N pixel memory per job are rejected.\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "    probe <PATH> - Retrieve information of the very first image frame found in the file.\n");
     fprintf(stderr, "                   In most cases probing doesn't decode the image data.\n");
     fprintf(stderr, "    decode <PATH> - Decode the whole file and print information of all its frames.\n");
+    fprintf(stderr, "    bench <PATH> [-n | --iterations <N>] [-f | --format <extension>]\n");
+    fprintf(stderr, "                  - Load the file, convert and encode its first frame into memory N times (default: 10)\n");
+    fprintf(stderr, "                    and print the mean time of every stage and the peak memory usage. The image is encoded\n");
+    fprintf(stderr, "                    with the input codec or the codec of the specified extension.\n");
+    fprintf(stderr, "    profile <PATH> [-n | --iterations <N>] [-t | --target <size>]\n");
+    fprintf(stderr, "                  - Measure the load options that speed up loading the file and print tuning\n");
+    fprintf(stderr, "                    suggestions. The target size in pixels (default: 256) is used to suggest scaled decode.\n");
 }
 
 int main(int argc, char *argv[]) {
@@ -354,16 +1179,27 @@ int main(int argc, char *argv[]) {
         return 0;
     }
 
+    /* Track the peak memory usage. Must be enabled before any allocations. */
+    if (strcmp(argv[1], "bench") == 0) {
+        SAIL_TRY(sail_set_memory_tracking(true));
+    }
+
     sail_set_log_barrier(SAIL_LOG_LEVEL_WARNING);
 
     if (strcmp(argv[1], "convert") == 0) {
         SAIL_TRY(convert(argc, argv));
+    } else if (strcmp(argv[1], "batch-convert") == 0) {
+        SAIL_TRY(batch_convert(argc, argv));
     } else if (strcmp(argv[1], "list") == 0) {
         SAIL_TRY(list(argc, argv));
     } else if (strcmp(argv[1], "probe") == 0) {
         SAIL_TRY(probe(argc, argv));
     } else if (strcmp(argv[1], "decode") == 0) {
         SAIL_TRY(decode(argc, argv));
+    } else if (strcmp(argv[1], "bench") == 0) {
+        SAIL_TRY(bench(argc, argv));
+    } else if (strcmp(argv[1], "profile") == 0) {
+        SAIL_TRY(profile(argc, argv));
     } else {
         print_invalid_argument();
         SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
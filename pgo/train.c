@@ -0,0 +1,386 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h> /* atoi */
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include <sail-manip/sail-manip.h>
+
+#include "test-images.h"
+
+/*
+ * Training workload for profile-guided optimization. It runs the code paths applications spend
+ * their time in: loading dominates, then converting the loaded images for display, saving,
+ * and scaling. Every conversion pair runs once so no conversion kernel is left without a profile.
+ */
+
+struct train_stats {
+
+    unsigned operations;
+    unsigned failures;
+};
+
+static void count(struct train_stats *stats, sail_status_t status) {
+
+    stats->operations++;
+
+    if (status != SAIL_OK) {
+        stats->failures++;
+    }
+}
+
+/* Pixel formats most images get converted to for displaying or processing. */
+static const enum SailPixelFormat DISPLAY_PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP32_RGBA,
+    SAIL_PIXEL_FORMAT_BPP32_BGRA,
+    SAIL_PIXEL_FORMAT_BPP24_RGB,
+};
+
+static sail_status_t load_all_frames_from_memory(const void *data, size_t data_size, const struct sail_codec_info *codec_info) {
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_memory(data, data_size, codec_info, &state),
+                        /* cleanup */ sail_stop_loading(state));
+
+    struct sail_image *image;
+    sail_status_t status;
+
+    while ((status = sail_load_next_frame(state, &image)) == SAIL_OK) {
+        sail_destroy_image(image);
+    }
+
+    SAIL_TRY(sail_stop_loading(state));
+
+    if (status != SAIL_ERROR_NO_MORE_FRAMES) {
+        SAIL_LOG_AND_RETURN(status);
+    }
+
+    return SAIL_OK;
+}
+
+/* Saves the image into memory with the codec, converting it first if needed. Returns the encoded data. */
+static sail_status_t save_into_memory(const struct sail_image *image, const struct sail_codec_info *codec_info,
+                                      void **data, size_t *data_size) {
+
+    struct sail_image *image_for_saving;
+    SAIL_TRY(sail_convert_image_for_saving(image, codec_info->save_features, &image_for_saving));
+
+    void *state = NULL;
+    SAIL_TRY_OR_CLEANUP(sail_start_saving_into_growable_memory(codec_info, &state),
+                        /* cleanup */ sail_stop_saving(state),
+                                      sail_destroy_image(image_for_saving));
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, image_for_saving),
+                        /* cleanup */ sail_stop_saving(state),
+                                      sail_destroy_image(image_for_saving));
+    SAIL_TRY_OR_CLEANUP(sail_stop_saving_into_growable_memory(state, data, data_size),
+                        /* cleanup */ sail_destroy_image(image_for_saving));
+
+    sail_destroy_image(image_for_saving);
+
+    return SAIL_OK;
+}
+
+static void convert_and_scale(const struct sail_image *image, struct train_stats *stats) {
+
+    for (size_t i = 0; i < sizeof(DISPLAY_PIXEL_FORMATS) / sizeof(DISPLAY_PIXEL_FORMATS[0]); i++) {
+        if (!sail_can_convert(image->pixel_format, DISPLAY_PIXEL_FORMATS[i])) {
+            continue;
+        }
+
+        struct sail_image *image_output;
+        const sail_status_t status = sail_convert_image(image, DISPLAY_PIXEL_FORMATS[i], &image_output);
+        count(stats, status);
+
+        if (status != SAIL_OK) {
+            continue;
+        }
+
+        /* Thumbnails. */
+        if (DISPLAY_PIXEL_FORMATS[i] == SAIL_PIXEL_FORMAT_BPP32_RGBA) {
+            struct sail_image *image_scaled;
+            const sail_status_t scale_status = sail_scale_image(image_output, (image->width + 1) / 2, (image->height + 1) / 2,
+                                                                SAIL_SCALE_FILTER_BILINEAR, &image_scaled);
+            count(stats, scale_status);
+
+            if (scale_status == SAIL_OK) {
+                sail_destroy_image(image_scaled);
+            }
+        }
+
+        sail_destroy_image(image_output);
+    }
+}
+
+/* Probes, loads, converts, and saves the file. */
+static void train_file(const char *path, struct train_stats *stats) {
+
+    const struct sail_codec_info *codec_info;
+
+    if (sail_codec_info_from_path(path, &codec_info) != SAIL_OK) {
+        return;
+    }
+
+    void *data;
+    size_t data_size;
+
+    if (sail_alloc_data_from_file_contents(path, &data, &data_size) != SAIL_OK) {
+        count(stats, SAIL_ERROR_OPEN_FILE);
+        return;
+    }
+
+    struct sail_image *image;
+    const struct sail_codec_info *probed_codec_info;
+
+    sail_status_t status = sail_probe_file(path, &image, &probed_codec_info);
+    count(stats, status);
+
+    if (status == SAIL_OK) {
+        sail_destroy_image(image);
+    }
+
+    /* Loading is what applications do the most. */
+    for (unsigned i = 0; i < 4; i++) {
+        count(stats, load_all_frames_from_memory(data, data_size, codec_info));
+    }
+
+    status = sail_load_from_file(path, &image);
+    count(stats, status);
+
+    if (status == SAIL_OK) {
+        convert_and_scale(image, stats);
+
+        if (codec_info->save_features->pixel_formats_length > 0) {
+            void *saved_data;
+            size_t saved_data_size;
+
+            status = save_into_memory(image, codec_info, &saved_data, &saved_data_size);
+            count(stats, status);
+
+            if (status == SAIL_OK) {
+                sail_free(saved_data);
+            }
+        }
+
+        sail_destroy_image(image);
+    }
+
+    sail_free(data);
+}
+
+/* Creates an image of the specified pixel format filled with a smooth pattern compressing like photos. */
+static sail_status_t create_image(enum SailPixelFormat pixel_format, unsigned width, unsigned height, struct sail_image **image) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->pixel_format   = pixel_format;
+    image_local->bytes_per_line = sail_bytes_per_line(width, pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_image_pixels(image_local, false),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    for (unsigned row = 0; row < height; row++) {
+        unsigned char *scan = sail_scan_line(image_local, row);
+
+        for (unsigned i = 0; i < image_local->bytes_per_line; i++) {
+            scan[i] = (unsigned char)((i * 3 + row * 2 + ((i ^ row) & 0x7)) & 0xFF);
+        }
+    }
+
+    if (sail_is_indexed(pixel_format)) {
+        const unsigned bits_per_pixel = sail_bits_per_pixel(pixel_format);
+        const unsigned color_count = (bits_per_pixel >= 8) ? 256 : (1U << bits_per_pixel);
+
+        SAIL_TRY_OR_CLEANUP(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, color_count, &image_local->palette),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        for (unsigned i = 0; i < color_count * 3; i++) {
+            ((unsigned char *)image_local->palette->data)[i] = (unsigned char)(i * 7);
+        }
+
+        /* Keep 8-bit indexes and larger within the palette. */
+        if (bits_per_pixel > 8) {
+            memset(image_local->pixels, 0, (size_t)height * image_local->bytes_per_line);
+        }
+    }
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+/* Saves and loads a generated photo-sized image with every codec that can save. */
+static void train_generated(unsigned size, struct train_stats *stats) {
+
+    struct sail_image *image;
+
+    if (create_image(SAIL_PIXEL_FORMAT_BPP24_RGB, size, size, &image) != SAIL_OK) {
+        count(stats, SAIL_ERROR_MEMORY_ALLOCATION);
+        return;
+    }
+
+    for (const struct sail_codec_bundle_node *node = sail_codec_bundle_list(); node != NULL; node = node->next) {
+        const struct sail_codec_info *codec_info = node->codec_bundle->codec_info;
+
+        if (codec_info->save_features->pixel_formats_length == 0) {
+            continue;
+        }
+
+        void *data;
+        size_t data_size;
+        const sail_status_t status = save_into_memory(image, codec_info, &data, &data_size);
+        count(stats, status);
+
+        if (status != SAIL_OK) {
+            continue;
+        }
+
+        count(stats, load_all_frames_from_memory(data, data_size, codec_info));
+
+        sail_free(data);
+    }
+
+    sail_destroy_image(image);
+}
+
+/* Converts a small image between every supported pair of pixel formats once. */
+static void train_conversions(struct train_stats *stats) {
+
+    for (int input_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN + 1;
+            input_pixel_format <= SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED;
+            input_pixel_format++) {
+
+        struct sail_image *image = NULL;
+
+        for (int output_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN + 1;
+                output_pixel_format <= SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED;
+                output_pixel_format++) {
+
+            if (!sail_can_convert((enum SailPixelFormat)input_pixel_format, (enum SailPixelFormat)output_pixel_format)) {
+                continue;
+            }
+
+            if (image == NULL && create_image((enum SailPixelFormat)input_pixel_format, 67, 33, &image) != SAIL_OK) {
+                count(stats, SAIL_ERROR_MEMORY_ALLOCATION);
+                break;
+            }
+
+            struct sail_image *image_output;
+            const sail_status_t status = sail_convert_image(image, (enum SailPixelFormat)output_pixel_format, &image_output);
+            count(stats, status);
+
+            if (status == SAIL_OK) {
+                sail_destroy_image(image_output);
+            }
+        }
+
+        sail_destroy_image(image);
+    }
+}
+
+static void help(const char *app) {
+
+    fprintf(stderr, "SAIL profile-guided optimization training workload.\n\n");
+    fprintf(stderr, "Usage: %s [options] [PATH...]\n", app);
+    fprintf(stderr, "Loads, converts, scales, and saves the specified files or the test images, saves and loads\n");
+    fprintf(stderr, "a generated image with every codec, and runs every pixel format conversion.\n\n");
+    fprintf(stderr, "Options:\n");
+    fprintf(stderr, "    -r, --rounds <N> - Number of rounds over the images. Default: 3.\n");
+    fprintf(stderr, "    -s, --size <N>   - Size of the generated image. Default: 1024.\n");
+    fprintf(stderr, "    -h, --help       - Print this help.\n");
+}
+
+int main(int argc, char *argv[]) {
+
+    unsigned rounds = 3;
+    unsigned size = 1024;
+    const char **paths = NULL;
+    int paths_count = 0;
+
+    if (argc > 1) {
+        paths = malloc(sizeof(const char *) * (size_t)argc);
+
+        if (paths == NULL) {
+            return 1;
+        }
+    }
+
+    for (int i = 1; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            help(argv[0]);
+            free(paths);
+            return 0;
+        } else if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--rounds") == 0) && has_value) {
+            const int value = atoi(argv[++i]);
+            rounds = (value > 0) ? (unsigned)value : 1;
+        } else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--size") == 0) && has_value) {
+            const int value = atoi(argv[++i]);
+            size = (value > 0) ? (unsigned)value : 1;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Error: Invalid arguments. Run with -h to see command arguments.\n");
+            free(paths);
+            return 1;
+        } else {
+            paths[paths_count++] = argv[i];
+        }
+    }
+
+    /* Error paths are trained as well, so don't flood the output. */
+    sail_set_log_barrier(SAIL_LOG_LEVEL_SILENCE);
+
+    struct train_stats stats = { 0, 0 };
+
+    for (unsigned round = 0; round < rounds; round++) {
+        if (paths_count > 0) {
+            for (int i = 0; i < paths_count; i++) {
+                train_file(paths[i], &stats);
+            }
+        } else {
+            for (const char * const *path = SAIL_TEST_IMAGES; *path != NULL; path++) {
+                train_file(*path, &stats);
+            }
+        }
+    }
+
+    train_generated(size, &stats);
+    train_conversions(&stats);
+
+    printf("%u operations completed, %u failed\n", stats.operations, stats.failures);
+
+    free(paths);
+
+    sail_finish();
+
+    return 0;
+}
@@ -126,6 +126,39 @@ public:
      */
     virtual sail_status_t eof(bool *result) = 0;
 
+    /*
+     * Assigns a pointer to the contiguous data of the underlying I/O object from the current
+     * position until the end and its size. Doesn't change the current position. The pointer
+     * remains valid until the I/O object is closed. Used only when features() include
+     * SAIL_IO_FEATURE_MAPPED. The default implementation returns SAIL_ERROR_NOT_IMPLEMENTED,
+     * and codecs read the data with tolerant_read() or strict_read() then.
+     *
+     * Returns SAIL_OK on success.
+     */
+    virtual sail_status_t map(const void **data, std::size_t *size)
+    {
+        (void)data;
+        (void)size;
+
+        return SAIL_ERROR_NOT_IMPLEMENTED;
+    }
+
+    /*
+     * Hints the underlying I/O object that the specified range is going to be read soon.
+     * Zero length means the data until the end of the stream. Doesn't change the current position.
+     * Used only when features() include SAIL_IO_FEATURE_EXPENSIVE_SEEK. Implement it to prefetch
+     * the range, for example, with a single HTTP range request. The default implementation does nothing.
+     *
+     * Returns SAIL_OK on success.
+     */
+    virtual sail_status_t will_need(std::size_t offset, std::size_t length)
+    {
+        (void)offset;
+        (void)length;
+
+        return SAIL_OK;
+    }
+
     /*
      * Finds and returns a first codec info object that can theoretically read the underlying
      * I/O stream into a valid image.
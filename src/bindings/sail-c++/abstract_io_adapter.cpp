@@ -23,6 +23,12 @@
     SOFTWARE.
 */
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <typeinfo>
+#include <vector>
+
 #include <sail/sail.h>
 
 #include <sail-c++/sail-c++.h>
@@ -115,31 +121,323 @@ static sail_status_t wrapped_eof(void *stream, bool *result) {
     return SAIL_OK;
 }
 
+static sail_status_t wrapped_map(void *stream, const void **data, size_t *size) {
+
+    sail::abstract_io &abstract_io = *reinterpret_cast<sail::abstract_io *&>(stream);
+
+    SAIL_TRY(abstract_io.map(data, size));
+
+    return SAIL_OK;
+}
+
+static sail_status_t wrapped_will_need(void *stream, size_t offset, size_t length) {
+
+    sail::abstract_io &abstract_io = *reinterpret_cast<sail::abstract_io *&>(stream);
+
+    SAIL_TRY(abstract_io.will_need(offset, length));
+
+    return SAIL_OK;
+}
+
+/*
+ * Buffered reads. The stream is the adapter itself. Small reads are served from a block buffer,
+ * and the virtual methods are called only to refill it.
+ */
+
+class buffered_reader_private
+{
+public:
+    explicit buffered_reader_private(sail::abstract_io &other_abstract_io)
+        : abstract_io(other_abstract_io)
+        , pos(0)
+        , length(0)
+    {
+    }
+
+    std::size_t available() const
+    {
+        return length - pos;
+    }
+
+    /* Positions the abstract I/O stream at the first unread byte and drops the buffer. */
+    sail_status_t drop()
+    {
+        const std::size_t unread = available();
+
+        pos    = 0;
+        length = 0;
+
+        if (unread > 0) {
+            SAIL_TRY(abstract_io.seek(-static_cast<long>(unread), SEEK_CUR));
+        }
+
+        return SAIL_OK;
+    }
+
+    sail_status_t refill()
+    {
+        if (buffer.empty()) {
+            buffer.resize(BUFFER_CAPACITY);
+        }
+
+        pos    = 0;
+        length = 0;
+
+        std::size_t read_size;
+        SAIL_TRY(abstract_io.tolerant_read(buffer.data(), buffer.size(), &read_size));
+
+        length = read_size;
+
+        return SAIL_OK;
+    }
+
+    static const std::size_t BUFFER_CAPACITY = 16 * 1024;
+
+    sail::abstract_io &abstract_io;
+    std::vector<unsigned char> buffer;
+    std::size_t pos;
+    std::size_t length;
+};
+
+static sail_status_t buffered_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
+
+    buffered_reader_private *reader = reinterpret_cast<buffered_reader_private *>(stream);
+
+    unsigned char *out = reinterpret_cast<unsigned char *>(buf);
+    std::size_t total = 0;
+
+    while (size_to_read > 0) {
+        if (reader->available() == 0) {
+            /* Large reads bypass the buffer. */
+            if (size_to_read >= buffered_reader_private::BUFFER_CAPACITY) {
+                std::size_t direct_size = 0;
+                const sail_status_t status = reader->abstract_io.tolerant_read(out, size_to_read, &direct_size);
+
+                if (status != SAIL_OK && (status != SAIL_ERROR_EOF || total == 0)) {
+                    return status;
+                }
+
+                total += direct_size;
+                break;
+            }
+
+            const sail_status_t status = reader->refill();
+
+            if (status == SAIL_ERROR_EOF || (status == SAIL_OK && reader->length == 0)) {
+                if (total == 0) {
+                    return status;
+                }
+
+                break;
+            }
+
+            SAIL_TRY(status);
+        }
+
+        const std::size_t chunk = (std::min)(size_to_read, reader->available());
+
+        std::memcpy(out, reader->buffer.data() + reader->pos, chunk);
+
+        reader->pos  += chunk;
+        out          += chunk;
+        total        += chunk;
+        size_to_read -= chunk;
+    }
+
+    *read_size = total;
+
+    return SAIL_OK;
+}
+
+static sail_status_t buffered_strict_read(void *stream, void *buf, size_t size_to_read) {
+
+    size_t read_size;
+    const sail_status_t status = buffered_tolerant_read(stream, buf, size_to_read, &read_size);
+
+    if (status == SAIL_ERROR_EOF || (status == SAIL_OK && read_size != size_to_read)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
+
+static sail_status_t buffered_tolerant_write(void *stream, const void *buf, size_t size_to_write, size_t *written_size) {
+
+    buffered_reader_private *reader = reinterpret_cast<buffered_reader_private *>(stream);
+
+    SAIL_TRY(reader->drop());
+    SAIL_TRY(reader->abstract_io.tolerant_write(buf, size_to_write, written_size));
+
+    return SAIL_OK;
+}
+
+static sail_status_t buffered_strict_write(void *stream, const void *buf, size_t size_to_write) {
+
+    buffered_reader_private *reader = reinterpret_cast<buffered_reader_private *>(stream);
+
+    SAIL_TRY(reader->drop());
+    SAIL_TRY(reader->abstract_io.strict_write(buf, size_to_write));
+
+    return SAIL_OK;
+}
+
+static sail_status_t buffered_seek(void *stream, long offset, int whence) {
+
+    buffered_reader_private *reader = reinterpret_cast<buffered_reader_private *>(stream);
+
+    /* Seeks within the buffered data don't touch the stream. */
+    if (whence == SEEK_CUR) {
+        if (offset >= 0 && static_cast<std::size_t>(offset) <= reader->available()) {
+            reader->pos += static_cast<std::size_t>(offset);
+            return SAIL_OK;
+        }
+
+        if (offset < 0 && static_cast<std::size_t>(-offset) <= reader->pos) {
+            reader->pos -= static_cast<std::size_t>(-offset);
+            return SAIL_OK;
+        }
+
+        /* The stream is positioned right after the buffered data. */
+        offset -= static_cast<long>(reader->available());
+    }
+
+    reader->pos    = 0;
+    reader->length = 0;
+
+    SAIL_TRY(reader->abstract_io.seek(offset, whence));
+
+    return SAIL_OK;
+}
+
+static sail_status_t buffered_tell(void *stream, size_t *offset) {
+
+    buffered_reader_private *reader = reinterpret_cast<buffered_reader_private *>(stream);
+
+    std::size_t stream_offset;
+    SAIL_TRY(reader->abstract_io.tell(&stream_offset));
+
+    *offset = stream_offset - reader->available();
+
+    return SAIL_OK;
+}
+
+static sail_status_t buffered_flush(void *stream) {
+
+    buffered_reader_private *reader = reinterpret_cast<buffered_reader_private *>(stream);
+
+    SAIL_TRY(reader->abstract_io.flush());
+
+    return SAIL_OK;
+}
+
+static sail_status_t buffered_close(void *stream) {
+
+    buffered_reader_private *reader = reinterpret_cast<buffered_reader_private *>(stream);
+
+    reader->pos    = 0;
+    reader->length = 0;
+
+    SAIL_TRY(reader->abstract_io.close());
+
+    return SAIL_OK;
+}
+
+static sail_status_t buffered_eof(void *stream, bool *result) {
+
+    buffered_reader_private *reader = reinterpret_cast<buffered_reader_private *>(stream);
+
+    if (reader->available() > 0) {
+        *result = false;
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(reader->abstract_io.eof(result));
+
+    return SAIL_OK;
+}
+
+static sail_status_t buffered_will_need(void *stream, size_t offset, size_t length) {
+
+    buffered_reader_private *reader = reinterpret_cast<buffered_reader_private *>(stream);
+
+    SAIL_TRY(reader->abstract_io.will_need(offset, length));
+
+    return SAIL_OK;
+}
+
 class SAIL_HIDDEN abstract_io_adapter::pimpl
 {
 public:
-    explicit pimpl(sail::abstract_io &other_abstract_io)
+    pimpl(sail::abstract_io &other_abstract_io, bool buffered_reads)
         : abstract_io(other_abstract_io)
     {
-        sail_io.features       = abstract_io.features();
-        sail_io.stream         = &abstract_io;
-        sail_io.tolerant_read  = wrapped_tolerant_read;
-        sail_io.strict_read    = wrapped_strict_read;
-        sail_io.tolerant_write = wrapped_tolerant_write;
-        sail_io.strict_write   = wrapped_strict_write;
-        sail_io.seek           = wrapped_seek;
-        sail_io.tell           = wrapped_tell;
-        sail_io.flush          = wrapped_flush;
-        sail_io.close          = wrapped_close;
-        sail_io.eof            = wrapped_eof;
+        /*
+         * The built-in file and memory streams wrap C I/O objects. Call them directly
+         * without the virtual dispatch. Subclasses may override the methods, so the exact
+         * type is checked.
+         */
+        if (typeid(abstract_io) == typeid(sail::io_file) || typeid(abstract_io) == typeid(sail::io_memory)) {
+            sail_io = *static_cast<sail::io_base &>(abstract_io).d->sail_io_wrapper;
+            return;
+        }
+
+        const int features = abstract_io.features();
+
+        /* Mapped streams are read in place, so buffering would only add copying. */
+        if (buffered_reads && (features & SAIL_IO_FEATURE_MAPPED) == 0) {
+            buffered_reader.reset(new buffered_reader_private(abstract_io));
+
+            sail_io.features              = features & ~SAIL_IO_FEATURE_VECTORED;
+            sail_io.stream                = buffered_reader.get();
+            sail_io.tolerant_read         = buffered_tolerant_read;
+            sail_io.strict_read           = buffered_strict_read;
+            sail_io.tolerant_write        = buffered_tolerant_write;
+            sail_io.strict_write          = buffered_strict_write;
+            sail_io.seek                  = buffered_seek;
+            sail_io.tell                  = buffered_tell;
+            sail_io.flush                 = buffered_flush;
+            sail_io.close                 = buffered_close;
+            sail_io.eof                   = buffered_eof;
+            sail_io.map                   = nullptr;
+            sail_io.strict_write_vectored = nullptr;
+            sail_io.will_need             = buffered_will_need;
+            return;
+        }
+
+        /* Vectored writes are emulated with separate writes. */
+        sail_io.features              = features & ~SAIL_IO_FEATURE_VECTORED;
+        sail_io.stream                = &abstract_io;
+        sail_io.tolerant_read         = wrapped_tolerant_read;
+        sail_io.strict_read           = wrapped_strict_read;
+        sail_io.tolerant_write        = wrapped_tolerant_write;
+        sail_io.strict_write          = wrapped_strict_write;
+        sail_io.seek                  = wrapped_seek;
+        sail_io.tell                  = wrapped_tell;
+        sail_io.flush                 = wrapped_flush;
+        sail_io.close                 = wrapped_close;
+        sail_io.eof                   = wrapped_eof;
+        sail_io.map                   = wrapped_map;
+        sail_io.strict_write_vectored = nullptr;
+        sail_io.will_need             = wrapped_will_need;
+    }
+
+    ~pimpl()
+    {
+        /* Leave the stream at the first byte not consumed by the C functions. */
+        if (buffered_reader) {
+            buffered_reader->drop();
+        }
     }
 
     sail::abstract_io &abstract_io;
+    std::unique_ptr<buffered_reader_private> buffered_reader;
     struct sail_io sail_io;
 };
 
-abstract_io_adapter::abstract_io_adapter(sail::abstract_io &abstract_io)
-    : d(new pimpl(abstract_io))
+abstract_io_adapter::abstract_io_adapter(sail::abstract_io &abstract_io, bool buffered_reads)
+    : d(new pimpl(abstract_io, buffered_reads))
 {
 }
 
@@ -46,8 +46,12 @@ class SAIL_HIDDEN abstract_io_adapter
 public:
     /*
      * Constructs a new I/O wrapper with the specified abstract I/O stream to wrap.
+     *
+     * The built-in file and memory streams are passed to C functions directly. Other streams
+     * are called through their virtual methods. If buffered_reads is true, reads from non-mapped
+     * streams are batched into a block buffer, and the stream is called only to refill it.
      */
-    explicit abstract_io_adapter(sail::abstract_io &abstract_io);
+    explicit abstract_io_adapter(sail::abstract_io &abstract_io, bool buffered_reads = false);
 
     /*
      * Destroys the I/O wrapper.
@@ -23,6 +23,10 @@
     SOFTWARE.
 */
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 #include <sail/sail.h>
 
 #include <sail-c++/sail-c++.h>
@@ -37,6 +41,32 @@ public:
         : sail_codec_info_c(nullptr)
     {}
 
+    explicit pimpl(const sail_codec_info *ci)
+        : sail_codec_info_c(ci)
+        , version(ci->version)
+        , name(ci->name)
+        , description(ci->description)
+        , load_features(ci->load_features)
+        , save_features(ci->save_features)
+    {
+        for (const sail_string_node *magic_number_node = ci->magic_number_node; magic_number_node != nullptr; magic_number_node = magic_number_node->next) {
+            magic_numbers.push_back(magic_number_node->string);
+        }
+
+        for (const sail_string_node *extension_node = ci->extension_node; extension_node != nullptr; extension_node = extension_node->next) {
+            extensions.push_back(extension_node->string);
+        }
+
+        for (const sail_string_node *mime_type_node = ci->mime_type_node; mime_type_node != nullptr; mime_type_node = mime_type_node->next) {
+            mime_types.push_back(mime_type_node->string);
+        }
+    }
+
+    // Immutable codec info objects shared by all the handles of the same codec in the current context
+    static std::mutex shared_mutex;
+    static const sail_codec_bundle_node *shared_codec_bundle_list;
+    static std::unordered_map<const sail_codec_info *, std::shared_ptr<pimpl>> shared;
+
     const sail_codec_info *sail_codec_info_c;
 
     std::string version;
@@ -49,29 +79,24 @@ public:
     sail::save_features save_features;
 };
 
+std::mutex codec_info::pimpl::shared_mutex;
+const sail_codec_bundle_node *codec_info::pimpl::shared_codec_bundle_list = nullptr;
+std::unordered_map<const sail_codec_info *, std::shared_ptr<codec_info::pimpl>> codec_info::pimpl::shared;
+
 codec_info::codec_info()
     : d(new pimpl)
 {
 }
 
+// The data is never modified after construction, so copies share it
 codec_info::codec_info(const codec_info &ci)
-    : codec_info()
+    : d(ci.d)
 {
-    *this = ci;
 }
 
 codec_info& codec_info::operator=(const codec_info &ci)
 {
-    d->sail_codec_info_c = ci.d->sail_codec_info_c;
-
-    d->version       = ci.version();
-    d->name          = ci.name();
-    d->description   = ci.description();
-    d->magic_numbers = ci.magic_numbers();
-    d->extensions    = ci.extensions();
-    d->mime_types    = ci.mime_types();
-    d->load_features = ci.load_features();
-    d->save_features = ci.save_features();
+    d = ci.d;
 
     return *this;
 }
@@ -222,35 +247,23 @@ codec_info::codec_info(const sail_codec_info *ci)
         return;
     }
 
-    d->sail_codec_info_c = ci;
+    const sail_codec_bundle_node *codec_bundle_list = sail_codec_bundle_list();
 
-    std::vector<std::string> magic_numbers;
-    std::vector<std::string> extensions;
-    std::vector<std::string> mime_types;
+    std::lock_guard<std::mutex> lock(pimpl::shared_mutex);
 
-    // magic numbers
-    for (const sail_string_node *magic_number_node = ci->magic_number_node; magic_number_node != nullptr; magic_number_node = magic_number_node->next) {
-        magic_numbers.push_back(magic_number_node->string);
+    // The context has been re-initialized with sail_finish() and sail_init() bypassing context::finish()
+    if (codec_bundle_list != pimpl::shared_codec_bundle_list) {
+        pimpl::shared.clear();
+        pimpl::shared_codec_bundle_list = codec_bundle_list;
     }
 
-    // extensions
-    for (const sail_string_node *extension_node = ci->extension_node; extension_node != nullptr; extension_node = extension_node->next) {
-        extensions.push_back(extension_node->string);
-    }
+    std::shared_ptr<pimpl> &shared = pimpl::shared[ci];
 
-    // mime types
-    for (const sail_string_node *mime_type_node = ci->mime_type_node; mime_type_node != nullptr; mime_type_node = mime_type_node->next) {
-        mime_types.push_back(mime_type_node->string);
+    if (shared == nullptr) {
+        shared = std::make_shared<pimpl>(ci);
     }
 
-    d->version       = ci->version;
-    d->name          = ci->name;
-    d->description   = ci->description;
-    d->magic_numbers = magic_numbers;
-    d->extensions    = extensions;
-    d->mime_types    = mime_types;
-    d->load_features = sail::load_features(ci->load_features);
-    d->save_features = sail::save_features(ci->save_features);
+    d = shared;
 }
 
 const sail_codec_info* codec_info::sail_codec_info_c() const
@@ -258,4 +271,12 @@ const sail_codec_info* codec_info::sail_codec_info_c() const
     return d->sail_codec_info_c;
 }
 
+void codec_info::drop_shared_codec_infos()
+{
+    std::lock_guard<std::mutex> lock(pimpl::shared_mutex);
+
+    pimpl::shared.clear();
+    pimpl::shared_codec_bundle_list = nullptr;
+}
+
 }
@@ -48,6 +48,7 @@ class save_features;
  */
 class SAIL_EXPORT codec_info
 {
+    friend class context;
     friend class image_input;
     friend class image_output;
 
@@ -59,7 +60,7 @@ public:
     codec_info();
 
     /*
-     * Copies the codec info object.
+     * Copies the codec info object. Copies are cheap as they share the same immutable data.
      */
     codec_info(const codec_info &ci);
 
@@ -240,16 +241,21 @@ public:
 
 private:
     /*
-     * Makes a deep copy of the specified codec info and stores the pointer for further use.
-     * When the SAIL context gets uninitialized, the pointer becomes dangling.
+     * Shares the immutable copy of the specified codec info created on first use and stores
+     * the pointer for further use. When the SAIL context gets uninitialized, the pointer becomes dangling.
      */
     explicit codec_info(const sail_codec_info *ci);
 
     const sail_codec_info* sail_codec_info_c() const;
 
+    /*
+     * Destroys the shared copies of the codec info objects. Called when the SAIL context gets uninitialized.
+     */
+    static void drop_shared_codec_infos();
+
 private:
     class pimpl;
-    std::unique_ptr<pimpl> d;
+    std::shared_ptr<pimpl> d;
 };
 
 }
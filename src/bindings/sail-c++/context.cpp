@@ -44,6 +44,31 @@ sail_status_t context::init(int flags)
     return SAIL_OK;
 }
 
+sail_status_t context::preload(const std::vector<std::string> &names)
+{
+    SAIL_TRY(preload(names, nullptr));
+
+    return SAIL_OK;
+}
+
+sail_status_t context::preload(const std::vector<std::string> &names, std::vector<std::uint64_t> *load_times)
+{
+    std::vector<const char *> c_names;
+    c_names.reserve(names.size());
+
+    for (const std::string &name : names) {
+        c_names.push_back(name.c_str());
+    }
+
+    if (load_times != nullptr) {
+        load_times->assign(names.size(), 0);
+    }
+
+    SAIL_TRY(sail_preload_codecs(c_names.data(), c_names.size(), load_times == nullptr ? nullptr : load_times->data()));
+
+    return SAIL_OK;
+}
+
 sail_status_t context::unload_codecs()
 {
     SAIL_TRY(sail_unload_codecs());
@@ -53,6 +78,8 @@ sail_status_t context::unload_codecs()
 
 void context::finish()
 {
+    codec_info::drop_shared_codec_infos();
+
     sail_finish();
 }
 
@@ -26,6 +26,10 @@
 #ifndef SAIL_CONTEXT_CPP_H
 #define SAIL_CONTEXT_CPP_H
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
@@ -102,6 +106,26 @@ public:
      */
     static sail_status_t init(int flags);
 
+    /*
+     * Loads the codecs with the specified names like "JPEG" or "PNG" into the global static context,
+     * so the first loading or saving operation of these formats doesn't pay for loading them from disk.
+     * The global static context is initialized if it doesn't exist yet. Names are case-insensitive.
+     * Already loaded codecs are skipped.
+     *
+     * All the specified codecs are tried even if some of them fail to load.
+     *
+     * Returns SAIL_OK on success or the error code of the first codec that failed to load.
+     */
+    static sail_status_t preload(const std::vector<std::string> &names);
+
+    /*
+     * Loads the codecs with the specified names like preload(names) and stores the number of milliseconds
+     * spent on loading every codec into 'load_times', or 0 if the codec failed to load.
+     *
+     * Returns SAIL_OK on success or the error code of the first codec that failed to load.
+     */
+    static sail_status_t preload(const std::vector<std::string> &names, std::vector<std::uint64_t> *load_times);
+
     /*
      * Unloads all the loaded codecs from the global static context to release memory occupied by them.
      * Use this method if you want to release some memory but do not want to deinitialize SAIL
@@ -80,6 +80,9 @@ conversion_options& conversion_options::operator=(const conversion_options &co)
     set_options(co.options());
     set_background(co.background48());
     set_background(co.background24());
+    set_luma_coefficients(co.luma_coefficients());
+    set_parallel_pixels_threshold(co.parallel_pixels_threshold());
+    set_parallel_chunk_size(co.parallel_chunk_size());
 
     return *this;
 }
@@ -115,6 +118,21 @@ sail_rgb24_t conversion_options::background24() const
     return d->conversion_options->background24;
 }
 
+SailLumaCoefficients conversion_options::luma_coefficients() const
+{
+    return d->conversion_options->luma_coefficients;
+}
+
+unsigned conversion_options::parallel_pixels_threshold() const
+{
+    return d->conversion_options->parallel_pixels_threshold;
+}
+
+unsigned conversion_options::parallel_chunk_size() const
+{
+    return d->conversion_options->parallel_chunk_size;
+}
+
 void conversion_options::set_options(int options)
 {
     d->conversion_options->options = options;
@@ -142,6 +160,21 @@ void conversion_options::set_background(const sail_rgb24_t &rgb24)
     };
 }
 
+void conversion_options::set_luma_coefficients(SailLumaCoefficients luma_coefficients)
+{
+    d->conversion_options->luma_coefficients = luma_coefficients;
+}
+
+void conversion_options::set_parallel_pixels_threshold(unsigned parallel_pixels_threshold)
+{
+    d->conversion_options->parallel_pixels_threshold = parallel_pixels_threshold;
+}
+
+void conversion_options::set_parallel_chunk_size(unsigned parallel_chunk_size)
+{
+    d->conversion_options->parallel_chunk_size = parallel_chunk_size;
+}
+
 sail_status_t conversion_options::to_sail_conversion_options(sail_conversion_options **conversion_options) const
 {
     SAIL_CHECK_PTR(conversion_options);
@@ -108,6 +108,23 @@ public:
      */
     sail_rgb24_t background24() const;
 
+    /*
+     * Returns the luma coefficients to convert color pixels to grayscale.
+     */
+    SailLumaCoefficients luma_coefficients() const;
+
+    /*
+     * Returns the number of pixels starting from which images are converted in multiple threads.
+     * If zero, the default threshold is used.
+     */
+    unsigned parallel_pixels_threshold() const;
+
+    /*
+     * Returns the approximate number of bytes converted by a thread at once.
+     * If zero, the default chunk size is used.
+     */
+    unsigned parallel_chunk_size() const;
+
     /*
      * Sets new or-ed SailConversionOption-s. If zero, SAIL_CONVERSION_OPTION_DROP_ALPHA is assumed.
      */
@@ -125,6 +142,23 @@ public:
      */
     void set_background(const sail_rgb24_t &rgb24);
 
+    /*
+     * Sets new luma coefficients to convert color pixels to grayscale.
+     */
+    void set_luma_coefficients(SailLumaCoefficients luma_coefficients);
+
+    /*
+     * Sets a new number of pixels starting from which images are converted in multiple threads.
+     * If zero, the default threshold is used.
+     */
+    void set_parallel_pixels_threshold(unsigned parallel_pixels_threshold);
+
+    /*
+     * Sets a new approximate number of bytes converted by a thread at once.
+     * If zero, the default chunk size is used.
+     */
+    void set_parallel_chunk_size(unsigned parallel_chunk_size);
+
 private:
     sail_status_t to_sail_conversion_options(sail_conversion_options **conversion_options) const;
 
@@ -0,0 +1,165 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <utility>
+
+#include <sail/sail.h>
+
+#include <sail-c++/sail-c++.h>
+
+namespace sail
+{
+
+frame_range::frame_range(sail::image_input &input)
+    : m_input(input)
+    , m_status(SAIL_OK)
+    , m_started(false)
+{
+}
+
+frame_range::frame_range(frame_range &&other) noexcept
+    : m_input(other.m_input)
+    , m_frame(std::move(other.m_frame))
+    , m_status(other.m_status)
+    , m_started(other.m_started)
+{
+}
+
+frame_range::iterator frame_range::begin()
+{
+    if (!m_started) {
+        m_started = true;
+        advance();
+    }
+
+    return iterator(this);
+}
+
+frame_range::iterator frame_range::end()
+{
+    return iterator(nullptr);
+}
+
+sail_status_t frame_range::status() const
+{
+    return m_status == SAIL_ERROR_NO_MORE_FRAMES ? SAIL_OK : m_status;
+}
+
+void frame_range::advance()
+{
+    if (m_status != SAIL_OK) {
+        return;
+    }
+
+    m_status = m_input.next_recycled_frame(&m_frame);
+}
+
+prefetch_frame_range::prefetch_frame_range(sail::image_input &input)
+    : m_input(input)
+    , m_current(0)
+    , m_status(SAIL_OK)
+    , m_started(false)
+{
+}
+
+prefetch_frame_range::prefetch_frame_range(prefetch_frame_range &&other) noexcept
+    : m_input(other.m_input)
+    , m_current(other.m_current)
+    , m_status(other.m_status)
+    , m_started(other.m_started)
+{
+    m_frames[0] = std::move(other.m_frames[0]);
+    m_frames[1] = std::move(other.m_frames[1]);
+}
+
+prefetch_frame_range::~prefetch_frame_range()
+{
+    /* The pool thread still uses the range. */
+    if (m_prefetched.valid()) {
+        m_prefetched.wait();
+    }
+}
+
+prefetch_frame_range::iterator prefetch_frame_range::begin()
+{
+    if (!m_started) {
+        m_started = true;
+        prefetch();
+        advance();
+    }
+
+    return iterator(this);
+}
+
+prefetch_frame_range::iterator prefetch_frame_range::end()
+{
+    return iterator(nullptr);
+}
+
+sail_status_t prefetch_frame_range::status() const
+{
+    return m_status == SAIL_ERROR_NO_MORE_FRAMES ? SAIL_OK : m_status;
+}
+
+void prefetch_frame_range::advance()
+{
+    if (m_status != SAIL_OK) {
+        return;
+    }
+
+    m_status = m_prefetched.get();
+
+    if (m_status == SAIL_OK) {
+        m_current = 1 - m_current;
+        prefetch();
+    }
+}
+
+void prefetch_frame_range::prefetch()
+{
+    m_promise    = std::promise<sail_status_t>();
+    m_prefetched = m_promise.get_future();
+
+    /* Load in the calling thread if the task cannot be queued. */
+    if (sail_thread_pool_submit(prefetch_task, this) != SAIL_OK) {
+        prefetch_task(this, 0, 0);
+    }
+}
+
+void prefetch_frame_range::prefetch_task(void *user_data, unsigned task, unsigned thread)
+{
+    (void)task;
+    (void)thread;
+
+    prefetch_frame_range *range = static_cast<prefetch_frame_range *>(user_data);
+
+    /* Keeps the shared state alive while it's being set, as the caller reuses the member promise right after that. */
+    std::promise<sail_status_t> promise = std::move(range->m_promise);
+
+    /* The caller doesn't touch the other frame until the future is ready. */
+    promise.set_value(range->m_input.next_recycled_frame(&range->m_frames[1 - range->m_current]));
+}
+
+}
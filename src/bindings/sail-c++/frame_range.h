@@ -0,0 +1,249 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_FRAME_RANGE_CPP_H
+#define SAIL_FRAME_RANGE_CPP_H
+
+#include <cstddef> /* std::ptrdiff_t */
+#include <future>
+#include <iterator>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#include <sail-c++/image.h>
+
+namespace sail
+{
+
+class image_input;
+
+/*
+ * Input range of the frames loaded by image_input. Use it in range-based for loops:
+ *
+ *     sail::image_input input(path);
+ *     sail::frame_range frames = input.frames();
+ *
+ *     for (sail::image &frame : frames) {
+ *         ...
+ *     }
+ *
+ *     if (frames.status() != SAIL_OK) {
+ *         ...
+ *     }
+ *
+ * All the frames are loaded into the same image object. When the frame is not shared with other
+ * images, its pixels are given back to the loading state before loading the next frame, so
+ * animations with identical frame sizes are loaded without allocating pixels for every frame.
+ * Copy the frame to keep it.
+ *
+ * The range is single-pass, and it must not outlive the image input.
+ */
+class SAIL_EXPORT frame_range
+{
+public:
+    class iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef sail::image value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef sail::image* pointer;
+        typedef sail::image& reference;
+
+        /*
+         * Returns the current frame.
+         */
+        sail::image& operator*() const { return m_range->m_frame; }
+        sail::image* operator->() const { return &m_range->m_frame; }
+
+        /*
+         * Loads the next frame.
+         */
+        iterator& operator++() { m_range->advance(); return *this; }
+
+        /*
+         * Returns true if both iterators reached the end of the range or point to the same range.
+         */
+        bool operator==(const iterator &other) const { return at_end() == other.at_end(); }
+        bool operator!=(const iterator &other) const { return !(*this == other); }
+
+    private:
+        friend class frame_range;
+
+        explicit iterator(frame_range *range) : m_range(range) {}
+
+        bool at_end() const { return m_range == nullptr || m_range->m_status != SAIL_OK; }
+
+        frame_range *m_range;
+    };
+
+    frame_range(frame_range &&other) noexcept;
+    frame_range& operator=(frame_range &&other) = delete;
+
+    frame_range(const frame_range &other) = delete;
+    frame_range& operator=(const frame_range &other) = delete;
+
+    /*
+     * Loads the first frame and returns the iterator pointing to it.
+     */
+    iterator begin();
+
+    /*
+     * Returns the iterator past the last frame.
+     */
+    iterator end();
+
+    /*
+     * Returns the status that stopped the iteration. Returns SAIL_OK if all the frames
+     * were loaded, or the iteration is not finished yet.
+     */
+    sail_status_t status() const;
+
+private:
+    friend class image_input;
+
+    explicit frame_range(sail::image_input &input);
+
+    void advance();
+
+    sail::image_input &m_input;
+    sail::image m_frame;
+    sail_status_t m_status;
+    bool m_started;
+};
+
+/*
+ * Input range of the frames loaded by image_input that decodes the next frame on the thread pool
+ * while the current one is being used. Decoding runs on the same threads as sail_load_async().
+ * Use it like frame_range:
+ *
+ *     sail::image_input input(path);
+ *     sail::prefetch_frame_range frames = input.prefetched_frames();
+ *
+ *     for (sail::image &frame : frames) {
+ *         ...
+ *     }
+ *
+ * The frames are loaded into two image objects in turn, and their pixels are recycled like
+ * in frame_range. So the current frame stays valid only until the iterator is incremented.
+ * Copy the frame to keep it. When the thread pool has no threads, the frames are loaded
+ * in the calling thread.
+ *
+ * The range is single-pass, and it must not outlive the image input. The image input must not
+ * be used while the range exists. Destroying the range waits for the frame being decoded.
+ */
+class SAIL_EXPORT prefetch_frame_range
+{
+public:
+    class iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef sail::image value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef sail::image* pointer;
+        typedef sail::image& reference;
+
+        /*
+         * Returns the current frame.
+         */
+        sail::image& operator*() const { return m_range->m_frames[m_range->m_current]; }
+        sail::image* operator->() const { return &m_range->m_frames[m_range->m_current]; }
+
+        /*
+         * Waits for the next frame and starts decoding the one after it.
+         */
+        iterator& operator++() { m_range->advance(); return *this; }
+
+        /*
+         * Returns true if both iterators reached the end of the range or point to the same range.
+         */
+        bool operator==(const iterator &other) const { return at_end() == other.at_end(); }
+        bool operator!=(const iterator &other) const { return !(*this == other); }
+
+    private:
+        friend class prefetch_frame_range;
+
+        explicit iterator(prefetch_frame_range *range) : m_range(range) {}
+
+        bool at_end() const { return m_range == nullptr || m_range->m_status != SAIL_OK; }
+
+        prefetch_frame_range *m_range;
+    };
+
+    /*
+     * Moves the range. Only ranges not started with begin() can be moved.
+     */
+    prefetch_frame_range(prefetch_frame_range &&other) noexcept;
+    prefetch_frame_range& operator=(prefetch_frame_range &&other) = delete;
+
+    prefetch_frame_range(const prefetch_frame_range &other) = delete;
+    prefetch_frame_range& operator=(const prefetch_frame_range &other) = delete;
+
+    /*
+     * Waits for the frame being decoded.
+     */
+    ~prefetch_frame_range();
+
+    /*
+     * Loads the first frame, starts decoding the second one, and returns the iterator
+     * pointing to the first frame.
+     */
+    iterator begin();
+
+    /*
+     * Returns the iterator past the last frame.
+     */
+    iterator end();
+
+    /*
+     * Returns the status that stopped the iteration. Returns SAIL_OK if all the frames
+     * were loaded, or the iteration is not finished yet.
+     */
+    sail_status_t status() const;
+
+private:
+    friend class image_input;
+
+    explicit prefetch_frame_range(sail::image_input &input);
+
+    void advance();
+    void prefetch();
+
+    static void prefetch_task(void *user_data, unsigned task, unsigned thread);
+
+    sail::image_input &m_input;
+    sail::image m_frames[2];
+    unsigned m_current;
+    std::promise<sail_status_t> m_promise;
+    std::future<sail_status_t> m_prefetched;
+    sail_status_t m_status;
+    bool m_started;
+};
+
+}
+
+#endif
@@ -64,6 +64,12 @@ iccp::iccp(const arbitrary_data &data)
     set_data(data);
 }
 
+iccp::iccp(arbitrary_data &&data)
+    : iccp()
+{
+    set_data(std::move(data));
+}
+
 iccp::iccp(const sail::iccp &ic)
     : iccp()
 {
@@ -119,6 +125,11 @@ void iccp::set_data(const arbitrary_data &data)
     set_data(data.data(), data.size());
 }
 
+void iccp::set_data(arbitrary_data &&data) noexcept
+{
+    d->data = std::move(data);
+}
+
 iccp::iccp(const sail_iccp *ic)
     : iccp()
 {
@@ -144,10 +155,13 @@ sail_status_t iccp::to_sail_iccp(sail_iccp **iccp) const
 
 void iccp::copy(const void *data, std::size_t data_size)
 {
-    d->data.resize(data_size);
+    // Assign instead of resize() + memcpy() to avoid zero-filling the profile first
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
 
     if (data_size > 0) {
-        memcpy(d->data.data(), data, data_size);
+        d->data.assign(bytes, bytes + data_size);
+    } else {
+        d->data.clear();
     }
 }
 
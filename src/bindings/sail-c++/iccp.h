@@ -62,6 +62,11 @@ public:
      */
     explicit iccp(const arbitrary_data &data);
 
+    /*
+     * Constructs a new ICC profile from the binary data. The data is moved.
+     */
+    explicit iccp(arbitrary_data &&data);
+
     /*
      * Copies the ICC profile.
      */
@@ -107,6 +112,11 @@ public:
      */
     void set_data(const arbitrary_data &data);
 
+    /*
+     * Sets new ICC profile binary data. The data is moved.
+     */
+    void set_data(arbitrary_data &&data) noexcept;
+
 private:
     /*
      * Makes a deep copy of the specified ICC profile.
@@ -25,6 +25,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <stdexcept>
 #include <utility> // std::move
 
@@ -51,22 +52,98 @@ public:
 
     ~pimpl()
     {
-        if (shallow_pixels) {
-            sail_image->pixels = nullptr;
-        }
+        // Pixels are freed by shared_pixels
+        sail_image->pixels = nullptr;
 
         sail_destroy_image(sail_image);
     }
 
     void reset_pixels()
     {
-        if (!shallow_pixels) {
-            sail_free(sail_image->pixels);
+        shared_pixels.reset();
+
+        sail_image->pixels                  = nullptr;
+        sail_image->pixels_alignment        = 0;
+        sail_image->pixels_file_backed_size = 0;
+        pixels_size                         = 0;
+        shallow_pixels                      = false;
+    }
+
+    // Frees the pixels unless they were released to a loading state with release_pixels()
+    struct pixels_deleter
+    {
+        void operator()(void *ptr) const
+        {
+            if (released) {
+                return;
+            } else if (file_backed) {
+                sail_free_file_backed_memory(ptr, size);
+            } else if (pixels_alignment > 0) {
+                sail_aligned_free(ptr);
+            } else {
+                sail_free(ptr);
+            }
         }
 
-        sail_image->pixels = nullptr;
-        pixels_size        = 0;
-        shallow_pixels     = false;
+        unsigned pixels_alignment;
+        std::size_t size;
+        bool file_backed;
+        bool released;
+    };
+
+    // Takes the ownership of the pixels allocated with sail_malloc(), sail_aligned_malloc(),
+    // or sail_alloc_file_backed_memory()
+    void adopt_pixels(void *pixels, unsigned pixels_alignment, std::size_t size, bool file_backed = false)
+    {
+        reset_pixels();
+
+        shared_pixels = std::shared_ptr<void>(pixels, pixels_deleter{ pixels_alignment, size, file_backed, false });
+
+        sail_image->pixels                  = pixels;
+        sail_image->pixels_alignment        = pixels_alignment;
+        sail_image->pixels_file_backed_size = file_backed ? size : 0;
+        pixels_size                         = size;
+    }
+
+    // Gives up the ownership of the pixels not shared with other images. Returns nullptr
+    // if the pixels are shared, shallow, or file-backed
+    void* release_pixels()
+    {
+        if (shallow_pixels || shared_pixels == nullptr || shared_pixels.use_count() != 1
+                || sail_image->pixels_file_backed_size > 0) {
+            return nullptr;
+        }
+
+        pixels_deleter *deleter = std::get_deleter<pixels_deleter>(shared_pixels);
+
+        if (deleter == nullptr) {
+            return nullptr;
+        }
+
+        void *pixels = shared_pixels.get();
+        deleter->released = true;
+
+        reset_pixels();
+
+        return pixels;
+    }
+
+    // Copies the pixels shared with other images before modifying them
+    void detach_pixels()
+    {
+        if (shared_pixels == nullptr || shared_pixels.use_count() == 1) {
+            return;
+        }
+
+        const bool file_backed = sail_image->pixels_file_backed_size > 0;
+
+        void *pixels;
+        SAIL_TRY_OR_EXECUTE(file_backed ? sail_alloc_file_backed_memory(pixels_size, &pixels) : sail_malloc(pixels_size, &pixels),
+                            /* on error */ throw std::bad_alloc());
+
+        memcpy(pixels, sail_image->pixels, pixels_size);
+
+        adopt_pixels(pixels, 0, pixels_size, file_backed);
     }
 
     struct sail_image *sail_image;
@@ -77,6 +154,7 @@ public:
     sail::source_image source_image;
     std::size_t pixels_size;
     bool shallow_pixels;
+    std::shared_ptr<void> shared_pixels;
 };
 
 image::image()
@@ -97,10 +175,13 @@ image::image(SailPixelFormat pixel_format, unsigned width, unsigned height)
     set_pixel_format(pixel_format);
     set_bytes_per_line_auto();
 
-    d->pixels_size = static_cast<std::size_t>(height) * bytes_per_line();
+    const std::size_t pixels_size = static_cast<std::size_t>(height) * bytes_per_line();
 
-    SAIL_TRY_OR_EXECUTE(sail_malloc(d->pixels_size, &d->sail_image->pixels),
+    void *pixels;
+    SAIL_TRY_OR_EXECUTE(sail_malloc(pixels_size, &pixels),
                         /* on error */ throw std::bad_alloc());
+
+    d->adopt_pixels(pixels, 0, pixels_size);
 }
 
 image::image(SailPixelFormat pixel_format, unsigned width, unsigned height, unsigned bytes_per_line)
@@ -110,10 +191,13 @@ image::image(SailPixelFormat pixel_format, unsigned width, unsigned height, unsi
     set_pixel_format(pixel_format);
     set_bytes_per_line(bytes_per_line);
 
-    d->pixels_size = static_cast<std::size_t>(height) * bytes_per_line;
+    const std::size_t pixels_size = static_cast<std::size_t>(height) * bytes_per_line;
 
-    SAIL_TRY_OR_EXECUTE(sail_malloc(d->pixels_size, &d->sail_image->pixels),
+    void *pixels;
+    SAIL_TRY_OR_EXECUTE(sail_malloc(pixels_size, &pixels),
                         /* on error */ throw std::bad_alloc());
+
+    d->adopt_pixels(pixels, 0, pixels_size);
 }
 
 image::image(void *pixels, SailPixelFormat pixel_format, unsigned width, unsigned height)
@@ -142,6 +226,10 @@ image::image(const image &img)
 
 image& image::operator=(const sail::image &image)
 {
+    if (this == &image) {
+        return *this;
+    }
+
     set_dimensions(image.width(), image.height());
     set_bytes_per_line(image.bytes_per_line());
     set_resolution(image.resolution());
@@ -152,7 +240,19 @@ image& image::operator=(const sail::image &image)
     set_meta_data(image.meta_data());
     set_iccp(image.iccp());
     set_source_image(image.source_image());
-    set_pixels(image.pixels(), image.pixels_size());
+
+    if (image.d->shared_pixels != nullptr) {
+        d->reset_pixels();
+
+        d->shared_pixels                = image.d->shared_pixels;
+        d->sail_image->pixels           = image.d->sail_image->pixels;
+        d->sail_image->pixels_alignment = image.d->sail_image->pixels_alignment;
+        d->pixels_size                  = image.d->pixels_size;
+
+        d->sail_image->pixels_file_backed_size = image.d->sail_image->pixels_file_backed_size;
+    } else {
+        set_pixels(image.pixels(), image.pixels_size());
+    }
 
     return *this;
 }
@@ -261,6 +361,8 @@ const sail::source_image& image::source_image() const
 
 void* image::pixels()
 {
+    d->detach_pixels();
+
     return d->sail_image->pixels;
 }
 
@@ -412,16 +514,28 @@ sail_status_t image::convert(SailPixelFormat pixel_format, const conversion_opti
         sail_img->palette->pixel_format = d->palette.pixel_format();
     }
 
+    // Update owned pixels in place when the output fits into them to avoid doubling the peak memory usage
+    if (!d->shallow_pixels && sail_greater_equal_bits_per_pixel(sail_img->pixel_format, pixel_format)) {
+        d->detach_pixels();
+        sail_img->pixels = d->sail_image->pixels;
+
+        SAIL_TRY(sail_update_image_with_options(sail_img, pixel_format, sail_conversion_options));
+
+        d->sail_image->bytes_per_line = sail_img->bytes_per_line;
+        d->sail_image->pixel_format   = sail_img->pixel_format;
+
+        return SAIL_OK;
+    }
+
     sail_image *sail_image_output = nullptr;
     SAIL_TRY(sail_convert_image_with_options(sail_img, pixel_format, sail_conversion_options, &sail_image_output));
 
-    d->reset_pixels();
+    d->adopt_pixels(sail_image_output->pixels, sail_image_output->pixels_alignment,
+                    static_cast<std::size_t>(sail_image_output->height) * sail_image_output->bytes_per_line,
+                    sail_image_output->pixels_file_backed_size > 0);
 
     d->sail_image->bytes_per_line = sail_image_output->bytes_per_line;
     d->sail_image->pixel_format   = sail_image_output->pixel_format;
-    d->sail_image->pixels         = sail_image_output->pixels;
-    d->pixels_size                = static_cast<std::size_t>(sail_image_output->height) * sail_image_output->bytes_per_line;
-    d->shallow_pixels             = false;
 
     sail_image_output->pixels = nullptr;
     sail_destroy_image(sail_image_output);
@@ -473,27 +587,23 @@ sail_status_t image::convert_to(SailPixelFormat pixel_format, const conversion_o
         SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
     }
 
-    sail_conversion_options *sail_conversion_options = nullptr;
+    image_view_private view;
+    SAIL_TRY(view.init(*this));
 
-    sail_image *sail_img;
-    SAIL_TRY(to_sail_image(&sail_img));
+    sail_conversion_options *sail_conversion_options = nullptr;
 
     SAIL_AT_SCOPE_EXIT(
-        sail_img->pixels = nullptr;
-        sail_destroy_image(sail_img);
-
         sail_destroy_conversion_options(sail_conversion_options);
     );
 
     SAIL_TRY(options.to_sail_conversion_options(&sail_conversion_options));
 
     sail_image *sail_image_output = nullptr;
-    SAIL_TRY(sail_convert_image_with_options(sail_img, pixel_format, sail_conversion_options, &sail_image_output));
-
-    *image = sail::image(sail_image_output);
+    SAIL_TRY(sail_convert_image_with_options(view.c_image(), pixel_format, sail_conversion_options, &sail_image_output));
 
-    sail_image_output->pixels = nullptr;
+    const sail_status_t status = image->adopt_sail_image(sail_image_output);
     sail_destroy_image(sail_image_output);
+    SAIL_TRY(status);
 
     return SAIL_OK;
 }
@@ -574,13 +684,138 @@ SailPixelFormat image::closest_pixel_format(const sail::save_features &save_feat
     return sail_closest_pixel_format(d->sail_image->pixel_format, save_features.pixel_formats().data(), save_features.pixel_formats().size());
 }
 
+image image::view(unsigned x, unsigned y, unsigned width, unsigned height)
+{
+    if (!is_valid()) {
+        SAIL_LOG_ERROR("Cannot make a view of an invalid image");
+        return image{};
+    }
+
+    if (width == 0 || height == 0 || x >= this->width() || y >= this->height()
+            || width > this->width() - x || height > this->height() - y) {
+        SAIL_LOG_ERROR("View %ux%u at %u,%u doesn't fit into the %ux%u image", width, height, x, y, this->width(), this->height());
+        return image{};
+    }
+
+    const unsigned bits_per_pixel = image::bits_per_pixel(pixel_format());
+
+    if ((static_cast<std::size_t>(x) * bits_per_pixel) % 8 != 0) {
+        SAIL_LOG_ERROR("View left edge %u of a %u-bit image doesn't start on a byte boundary", x, bits_per_pixel);
+        return image{};
+    }
+
+    // Detaches shared pixels, so the view never modifies pixels of other images
+    void *top_left = reinterpret_cast<char *>(scan_line(y)) + static_cast<std::size_t>(x) * bits_per_pixel / 8;
+
+    image view_image;
+
+    view_image.set_dimensions(width, height);
+    view_image.set_bytes_per_line(bytes_per_line());
+    view_image.set_pixel_format(pixel_format());
+    view_image.set_resolution(resolution());
+    view_image.set_gamma(gamma());
+    view_image.set_delay(delay());
+    view_image.set_palette(palette());
+    view_image.set_meta_data(meta_data());
+    view_image.set_iccp(iccp());
+    view_image.set_source_image(source_image());
+
+    // The last row of the view ends before the end of the source row
+    view_image.set_shallow_pixels(top_left, static_cast<std::size_t>(height - 1) * bytes_per_line()
+                                                + image::bytes_per_line(width, pixel_format()));
+
+    return view_image;
+}
+
 sail_status_t image::mirror(SailOrientation orientation)
 {
+    d->detach_pixels();
+
     SAIL_TRY(sail_mirror(d->sail_image, orientation));
 
     return SAIL_OK;
 }
 
+sail_status_t image::scale(unsigned width, unsigned height, SailScaleFilter filter)
+{
+    image img;
+    SAIL_TRY(scale_to(width, height, filter, &img));
+
+    *this = std::move(img);
+
+    return SAIL_OK;
+}
+
+sail_status_t image::scale_to(unsigned width, unsigned height, SailScaleFilter filter, sail::image *image) const
+{
+    SAIL_CHECK_PTR(image);
+
+    if (!is_valid()) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    image_view_private view;
+    SAIL_TRY(view.init(*this));
+
+    sail_image *sail_image_output = nullptr;
+    SAIL_TRY(sail_scale_image(view.c_image(), width, height, filter, &sail_image_output));
+
+    const sail_status_t status = image->adopt_sail_image(sail_image_output);
+    sail_destroy_image(sail_image_output);
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
+
+image image::scale_to(unsigned width, unsigned height, SailScaleFilter filter) const
+{
+    image img;
+    SAIL_TRY_OR_EXECUTE(scale_to(width, height, filter, &img),
+                        /* on error */ return img);
+
+    return img;
+}
+
+sail_status_t image::quantize(unsigned colors, SailDither dither)
+{
+    image img;
+    SAIL_TRY(quantize_to(colors, dither, &img));
+
+    *this = std::move(img);
+
+    return SAIL_OK;
+}
+
+sail_status_t image::quantize_to(unsigned colors, SailDither dither, sail::image *image) const
+{
+    SAIL_CHECK_PTR(image);
+
+    if (!is_valid()) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    image_view_private view;
+    SAIL_TRY(view.init(*this));
+
+    sail_image *sail_image_output = nullptr;
+    SAIL_TRY(sail_quantize_image(view.c_image(), colors, dither, &sail_image_output));
+
+    const sail_status_t status = image->adopt_sail_image(sail_image_output);
+    sail_destroy_image(sail_image_output);
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
+
+image image::quantize_to(unsigned colors, SailDither dither) const
+{
+    image img;
+    SAIL_TRY_OR_EXECUTE(quantize_to(colors, dither, &img),
+                        /* on error */ return img);
+
+    return img;
+}
+
 bool image::can_convert(SailPixelFormat input_pixel_format, SailPixelFormat output_pixel_format)
 {
     return sail_can_convert(input_pixel_format, output_pixel_format);
@@ -682,9 +917,9 @@ image::image(const sail_image *sail_image)
     set_gamma(sail_image->gamma);
     set_delay(sail_image->delay);
     set_palette(sail::palette(sail_image->palette));
-    set_meta_data(meta_data);
+    set_meta_data(std::move(meta_data));
     set_iccp(sail::iccp(sail_image->iccp));
-    set_source_image(sail::source_image(sail_image->source_image));
+    d->source_image = sail::source_image(sail_image->source_image);
 
     if (sail_image->pixels != nullptr) {
         SAIL_TRY_OR_EXECUTE(transfer_pixels_pointer(sail_image),
@@ -692,88 +927,102 @@ image::image(const sail_image *sail_image)
     }
 }
 
-sail_status_t image::transfer_pixels_pointer(const sail_image *sail_image)
+sail_status_t image::adopt_sail_image(sail_image *sail_image)
 {
     SAIL_CHECK_PTR(sail_image);
 
-    sail_free(d->sail_image->pixels);
-
-    d->sail_image->pixels = nullptr;
-    d->pixels_size        = 0;
-    d->shallow_pixels     = false;
+    *this = sail::image();
 
-    if (sail_image->pixels == nullptr) {
-        return SAIL_OK;
-    }
+    set_dimensions(sail_image->width, sail_image->height);
+    set_bytes_per_line(sail_image->bytes_per_line);
+    set_resolution(sail::resolution(sail_image->resolution));
+    set_pixel_format(sail_image->pixel_format);
+    set_gamma(sail_image->gamma);
+    set_delay(sail_image->delay);
+    d->source_image = sail::source_image(sail_image->source_image);
 
-    d->sail_image->pixels = sail_image->pixels;
-    d->pixels_size        = static_cast<std::size_t>(sail_image->height) * sail_image->bytes_per_line;
+    // Free every C payload right after converting it so the peak memory usage
+    // doesn't hold the meta data, the palette, and the ICC profile twice
+    while (sail_image->meta_data_node != nullptr) {
+        sail_meta_data_node *node = sail_image->meta_data_node;
 
-    return SAIL_OK;
-}
+        d->meta_data.push_back(sail::meta_data(node->meta_data));
 
-sail_status_t image::to_sail_image(sail_image **image) const
-{
-    SAIL_CHECK_PTR(image);
+        sail_image->meta_data_node = node->next;
+        node->next = nullptr;
+        sail_destroy_meta_data_node(node);
+    }
 
-    sail_image *image_local = nullptr;
+    if (sail_image->palette != nullptr) {
+        set_palette(sail::palette(sail_image->palette));
+        sail_destroy_palette(sail_image->palette);
+        sail_image->palette = nullptr;
+    }
 
-    SAIL_AT_SCOPE_EXIT(
-        // Pixels are shallow copied
-        if (image_local != nullptr) {
-            image_local->pixels = nullptr;
-        }
+    if (sail_image->iccp != nullptr) {
+        set_iccp(sail::iccp(sail_image->iccp));
+        sail_destroy_iccp(sail_image->iccp);
+        sail_image->iccp = nullptr;
+    }
 
-        sail_destroy_image(image_local);
-    );
+    SAIL_TRY(transfer_pixels_pointer(sail_image));
+    sail_image->pixels = nullptr;
 
-    SAIL_TRY(sail_alloc_image(&image_local));
+    return SAIL_OK;
+}
 
-    // Pixels are shallow copied
-    image_local->pixels         = d->sail_image->pixels;
-    image_local->width          = d->sail_image->width;
-    image_local->height         = d->sail_image->height;
-    image_local->bytes_per_line = d->sail_image->bytes_per_line;
+sail_status_t image::recycle_pixels(void *state)
+{
+    const unsigned height         = d->sail_image->height;
+    const unsigned bytes_per_line = d->sail_image->bytes_per_line;
+    const unsigned alignment      = d->sail_image->pixels_alignment;
 
-    // Resulting meta entries
-    sail_meta_data_node **last_meta_data_node = &image_local->meta_data_node;
+    /* The loading state matches the recycled buffers by size. */
+    if (d->pixels_size != static_cast<std::size_t>(height) * bytes_per_line) {
+        return SAIL_OK;
+    }
 
-    for (const sail::meta_data &meta_data : d->meta_data) {
-        sail_meta_data_node *meta_data_node;
+    sail_image *recycled_image;
+    SAIL_TRY(sail_alloc_image(&recycled_image));
 
-        SAIL_TRY(sail_alloc_meta_data_node(&meta_data_node));
-        SAIL_TRY_OR_CLEANUP(meta_data.to_sail_meta_data(&meta_data_node->meta_data),
-                            /* cleanup */ sail_destroy_meta_data_node(meta_data_node));
+    recycled_image->pixels = d->release_pixels();
 
-        *last_meta_data_node = meta_data_node;
-        last_meta_data_node = &meta_data_node->next;
+    if (recycled_image->pixels == nullptr) {
+        sail_destroy_image(recycled_image);
+        return SAIL_OK;
     }
 
-    if (d->resolution.is_valid()) {
-        SAIL_TRY(d->resolution.to_sail_resolution(&image_local->resolution));
-    }
+    recycled_image->pixels_alignment = alignment;
+    recycled_image->height           = height;
+    recycled_image->bytes_per_line   = bytes_per_line;
 
-    image_local->pixel_format = d->sail_image->pixel_format;
-    image_local->delay        = d->sail_image->delay;
+    SAIL_TRY(sail_recycle_image(state, recycled_image));
 
-    if (d->palette.is_valid()) {
-        SAIL_TRY(d->palette.to_sail_palette(&image_local->palette));
-    }
+    return SAIL_OK;
+}
 
-    if (d->iccp.is_valid()) {
-        SAIL_TRY(d->iccp.to_sail_iccp(&image_local->iccp));
-    }
+sail_status_t image::transfer_pixels_pointer(const sail_image *sail_image)
+{
+    SAIL_CHECK_PTR(sail_image);
+
+    d->reset_pixels();
 
-    if (d->source_image.is_valid()) {
-        SAIL_TRY(d->source_image.to_sail_source_image(&image_local->source_image));
+    if (sail_image->pixels == nullptr) {
+        return SAIL_OK;
     }
 
-    *image = image_local;
-    image_local = nullptr;
+    d->adopt_pixels(sail_image->pixels, sail_image->pixels_alignment,
+                    static_cast<std::size_t>(sail_image->height) * sail_image->bytes_per_line,
+                    sail_image->pixels_file_backed_size > 0);
 
     return SAIL_OK;
 }
 
+const sail_image* image::c_image() const
+{
+    return d->sail_image;
+}
+
 void image::set_dimensions(unsigned width, unsigned height)
 {
     d->sail_image->width = width;
@@ -804,18 +1053,17 @@ void image::set_pixels(const void *pixels)
 
 void image::set_pixels(const void *pixels, std::size_t pixels_size)
 {
-    d->reset_pixels();
-
     if (pixels == nullptr || pixels_size == 0) {
+        d->reset_pixels();
         return;
     }
 
-    SAIL_TRY_OR_EXECUTE(sail_malloc(pixels_size, &d->sail_image->pixels),
+    void *pixels_copy;
+    SAIL_TRY_OR_EXECUTE(sail_malloc(pixels_size, &pixels_copy),
                         /* on error */ return);
 
-    memcpy(d->sail_image->pixels, pixels, pixels_size);
-    d->pixels_size    = pixels_size;
-    d->shallow_pixels = false;
+    memcpy(pixels_copy, pixels, pixels_size);
+    d->adopt_pixels(pixels_copy, 0, pixels_size);
 }
 
 void image::set_shallow_pixels(void *pixels)
@@ -35,8 +35,11 @@
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
+#include <sail-manip/manip_common.h>
+
 #include <sail-c++/iccp.h>
 #include <sail-c++/palette.h>
+#include <sail-c++/pixel_view.h>
 #include <sail-c++/source_image.h>
 #include <sail-c++/resolution.h>
 
@@ -56,6 +59,7 @@ class SAIL_EXPORT image
 {
     friend class image_input;
     friend class image_output;
+    friend class image_view_private;
 
 public:
     /*
@@ -96,12 +100,14 @@ public:
     image(void *pixels, SailPixelFormat pixel_format, unsigned width, unsigned height, unsigned bytes_per_line);
 
     /*
-     * Makes a deep copy of the image.
+     * Copies the image. Pixels owned by the source image are shared with the copy and
+     * copied on write, i.e. when one of the images accesses them with the non-constant pixels(),
+     * scan_line(), or mirror(). Shallow pixels are deep copied.
      */
     image(const image &img);
 
     /*
-     * Makes a deep copy of the image.
+     * Copies the image. See the copy constructor.
      */
     image& operator=(const sail::image &image);
 
@@ -259,6 +265,7 @@ public:
     /*
      * Returns the editable pixel data if any. The channels are interleaved per pixel.
      * The pixels are organized row by row, left to right, top to bottom.
+     * If the pixels are shared with copies of the image, they are copied first.
      *
      * LOAD: Set by SAIL to valid pixel data.
      * SAVE: Must be set by a caller to valid pixel data.
@@ -275,7 +282,8 @@ public:
     const void* pixels() const;
 
     /*
-     * Returns a pointer to the pixels scan line with index i.
+     * Returns a pointer to the pixels scan line with index i. If the pixels are shared
+     * with copies of the image, they are copied first.
      */
     void* scan_line(unsigned i);
 
@@ -363,15 +371,17 @@ public:
      * Converts the image to the specified pixel format. Use can_convert() to quickly check if the conversion
      * can actually be done.
      *
-     * Updates the image pixel format and bytes per line.
+     * Updates the image pixel format and bytes per line. Pixels owned by the image are converted
+     * in place when the output pixel format doesn't occupy more bits than the input one.
+     * If the in-place conversion fails, the pixels may be left partially converted.
      *
      * Drops the input alpha channel if the output alpha channel doesn't exist. For example,
      * when converting RGBA pixels to RGB. If you need to control this behavior,
      * use the overloaded method with conversion_options.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -383,11 +393,13 @@ public:
      * Converts the image to the specified pixel format using the specified conversion options.
      * Use can_convert() to quickly check if the conversion can actually be done.
      *
-     * Updates the image pixel format and bytes per line.
+     * Updates the image pixel format and bytes per line. Pixels owned by the image are converted
+     * in place when the output pixel format doesn't occupy more bits than the input one.
+     * If the in-place conversion fails, the pixels may be left partially converted.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -399,15 +411,17 @@ public:
      * Converts the image to the best pixel format for saving. Use can_convert()
      * to quickly check if the conversion can actually be done.
      *
-     * Updates the image pixel format and bytes per line.
+     * Updates the image pixel format and bytes per line. Pixels owned by the image are converted
+     * in place when the output pixel format doesn't occupy more bits than the input one.
+     * If the in-place conversion fails, the pixels may be left partially converted.
      *
      * Drops the input alpha channel if the output alpha channel doesn't exist. For example,
      * when converting RGBA pixels to RGB. If you need to control this behavior,
      * use the overloaded method with conversion_options.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -419,11 +433,13 @@ public:
      * Converts the image to the best pixel format for saving using the specified conversion options.
      * Use can_convert() to quickly check if the conversion can actually be done.
      *
-     * Updates the image pixel format and bytes per line.
+     * Updates the image pixel format and bytes per line. Pixels owned by the image are converted
+     * in place when the output pixel format doesn't occupy more bits than the input one.
+     * If the in-place conversion fails, the pixels may be left partially converted.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -439,9 +455,9 @@ public:
      * when converting RGBA pixels to RGB. If you need to control this behavior,
      * use the overloaded method with conversion_options.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -454,9 +470,9 @@ public:
      * and assigns the resulting image to the 'image' argument.
      * Use can_convert() to quickly check if the conversion can actually be done.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -472,9 +488,9 @@ public:
      * when converting RGBA pixels to RGB. If you need to control this behavior,
      * use the overloaded method with conversion_options.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -487,9 +503,9 @@ public:
      * and assigns the resulting image to the 'image' argument.
      * Use can_convert() to quickly check if the conversion can actually be done.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -505,9 +521,9 @@ public:
      * when converting RGBA pixels to RGB. If you need to control this behavior,
      * use the overloaded method with conversion_options.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -520,9 +536,9 @@ public:
      * and returns the resulting image.
      * Use can_convert() to quickly check if the conversion can actually be done.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -538,9 +554,9 @@ public:
      * when converting RGBA pixels to RGB. If you need to control this behavior,
      * use the overloaded method with conversion_options.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -553,9 +569,9 @@ public:
      * and returns the resulting image.
      * Use can_convert() to quickly check if the conversion can actually be done.
      *
-     * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
-     * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
-     * instructions (like AVX or SSE) are used.
+     * Common conversions between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+     * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other conversions
+     * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
      *
      * The image ICC profile is not involved in the conversion procedure.
      *
@@ -581,6 +597,42 @@ public:
      */
     SailPixelFormat closest_pixel_format(const sail::save_features &save_features) const;
 
+    /*
+     * Returns a view of the specified rectangle of the image without copying pixels. The view
+     * has shallow pixels pointing into this image and the bytes per line of this image. The palette,
+     * meta data, and other properties are copied. Modifying the view pixels modifies this image.
+     *
+     * The rectangle must lie within the image, and x multiplied by the bits per pixel must be
+     * a multiple of 8. If the pixels are shared with other images, they are copied first as with
+     * the non-constant pixels(). This image must outlive the view and must not replace its pixels
+     * while the view is in use. Copying the view deep copies its pixels. See also sail_image_view().
+     *
+     * Returns an invalid image on error.
+     */
+    image view(unsigned x, unsigned y, unsigned width, unsigned height);
+
+    /*
+     * Returns a typed view of the pixels. No pixels are copied except the pixels shared
+     * with copies of the image as with the non-constant pixels(). Use pixel_view::subview()
+     * to access a rectangle of the image.
+     *
+     * The size of T must match the bits per pixel of the image. For example, sail_rgba32_t
+     * fits BPP32-RGBA, BPP32-BGRA and other 32-bit formats. The view must not be used
+     * after the pixels are replaced.
+     *
+     * Returns an invalid view if the image is invalid or T doesn't match the pixel format.
+     */
+    template<typename T>
+    pixel_view<T> view();
+
+    /*
+     * Returns a typed read-only view of the pixels. See the non-constant view<T>().
+     *
+     * Returns an invalid view if the image is invalid or T doesn't match the pixel format.
+     */
+    template<typename T>
+    pixel_view<const T> view() const;
+
     /*
      * Mirrors the image horizontally or vertically.
      *
@@ -592,6 +644,55 @@ public:
      */
     sail_status_t mirror(SailOrientation orientation);
 
+    /*
+     * Scales the image to the specified size with the specified filter. See sail_scale_image()
+     * for the supported pixel formats.
+     *
+     * Returns SAIL_OK on success.
+     */
+    sail_status_t scale(unsigned width, unsigned height, SailScaleFilter filter);
+
+    /*
+     * Scales the image to the specified size with the specified filter and assigns the resulting image
+     * to the 'image' argument. See sail_scale_image() for the supported pixel formats.
+     *
+     * Returns SAIL_OK on success.
+     */
+    sail_status_t scale_to(unsigned width, unsigned height, SailScaleFilter filter, sail::image *image) const;
+
+    /*
+     * Scales the image to the specified size with the specified filter and returns the resulting image.
+     * See sail_scale_image() for the supported pixel formats.
+     *
+     * Returns an invalid image on error.
+     */
+    image scale_to(unsigned width, unsigned height, SailScaleFilter filter) const;
+
+    /*
+     * Quantizes the image to a palette of up to the specified number of colors with the specified
+     * dithering method. The image gets the SAIL_PIXEL_FORMAT_BPP8_INDEXED pixel format and a new palette.
+     * See sail_quantize_image().
+     *
+     * Returns SAIL_OK on success.
+     */
+    sail_status_t quantize(unsigned colors, SailDither dither);
+
+    /*
+     * Quantizes the image to a palette of up to the specified number of colors with the specified
+     * dithering method and assigns the resulting image to the 'image' argument. See sail_quantize_image().
+     *
+     * Returns SAIL_OK on success.
+     */
+    sail_status_t quantize_to(unsigned colors, SailDither dither, sail::image *image) const;
+
+    /*
+     * Quantizes the image to a palette of up to the specified number of colors with the specified
+     * dithering method and returns the resulting image. See sail_quantize_image().
+     *
+     * Returns an invalid image on error.
+     */
+    image quantize_to(unsigned colors, SailDither dither) const;
+
     /*
      * Returns true if the conversion or updating functions can convert or update from the input
      * pixel format to the output pixel format.
@@ -723,9 +824,25 @@ private:
      */
     image(const sail_image *sail_image);
 
+    /*
+     * Replaces the image with the specified image. Transfers the pixels and converts the meta data,
+     * the palette, and the ICC profile freeing them in the sail_image object one by one to avoid
+     * holding them twice. The caller must destroy the sail_image object afterwards.
+     */
+    sail_status_t adopt_sail_image(sail_image *sail_image);
+
+    /*
+     * Gives the pixels not shared with other images back to the specified loading state
+     * to reuse them in the next frame. See sail_recycle_image(). Keeps the pixels if they're shared.
+     */
+    sail_status_t recycle_pixels(void *state);
+
     sail_status_t transfer_pixels_pointer(const sail_image *sail_image);
 
-    sail_status_t to_sail_image(sail_image **image) const;
+    /*
+     * Returns the underlying C image holding the pixels and the scalar properties only.
+     */
+    const sail_image* c_image() const;
 
     void set_dimensions(unsigned width, unsigned height);
     void set_pixel_format(SailPixelFormat pixel_format);
@@ -742,6 +859,26 @@ private:
     std::unique_ptr<pimpl> d;
 };
 
+template<typename T>
+pixel_view<T> image::view()
+{
+    if (!is_valid() || bits_per_pixel(pixel_format()) != sizeof(T) * 8) {
+        return pixel_view<T>();
+    }
+
+    return pixel_view<T>(static_cast<T *>(pixels()), width(), height(), bytes_per_line());
+}
+
+template<typename T>
+pixel_view<const T> image::view() const
+{
+    if (!is_valid() || bits_per_pixel(pixel_format()) != sizeof(T) * 8) {
+        return pixel_view<const T>();
+    }
+
+    return pixel_view<const T>(static_cast<const T *>(pixels()), width(), height(), bytes_per_line());
+}
+
 }
 
 #endif
@@ -0,0 +1,357 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <atomic>
+#include <exception>
+#include <future>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sail/sail.h>
+
+#include <sail-c++/sail-c++.h>
+
+namespace sail
+{
+
+namespace
+{
+
+struct cache_entry
+{
+    std::string key;
+    std::shared_ptr<const sail::image> image;
+    std::size_t size;
+    /* The cache clock value of the last use. */
+    std::uint64_t used;
+};
+
+typedef std::shared_future<std::shared_ptr<const sail::image>> image_future;
+
+struct cache_shard
+{
+    std::mutex mutex;
+
+    /* The most recently used entries go first. */
+    std::list<cache_entry> lru;
+    std::unordered_map<std::string, std::list<cache_entry>::iterator> index;
+
+    /* Keys being loaded and their results for the threads waiting for them. */
+    std::unordered_map<std::string, image_future> loading;
+};
+
+}
+
+class SAIL_HIDDEN image_cache::pimpl
+{
+public:
+    pimpl(std::size_t other_byte_budget, unsigned shards_count)
+        : byte_budget(other_byte_budget)
+        , bytes(0)
+        , use_clock(0)
+        , hits(0)
+        , misses(0)
+        , shared_loads(0)
+        , evictions(0)
+    {
+        if (shards_count == 0) {
+            shards_count = 1;
+        }
+
+        shards.reserve(shards_count);
+
+        for (unsigned i = 0; i < shards_count; i++) {
+            shards.push_back(std::unique_ptr<cache_shard>(new cache_shard));
+        }
+    }
+
+    cache_shard& shard_for(const std::string &key)
+    {
+        return *shards[std::hash<std::string>()(key) % shards.size()];
+    }
+
+    // Must be called with the shard locked
+    void touch_locked(cache_shard &shard, std::list<cache_entry>::iterator it)
+    {
+        shard.lru.splice(shard.lru.begin(), shard.lru, it);
+        it->used = ++use_clock;
+    }
+
+    // Must be called with the shard locked. Call trim() after unlocking the shard
+    void insert_locked(cache_shard &shard, const std::string &key, std::shared_ptr<const sail::image> image)
+    {
+        erase_locked(shard, key);
+
+        const std::size_t size = image->pixels_size();
+
+        if (size > byte_budget) {
+            return;
+        }
+
+        shard.lru.push_front(cache_entry{ key, std::move(image), size, ++use_clock });
+        shard.index[key] = shard.lru.begin();
+        bytes += size;
+    }
+
+    // Must be called with the shard locked
+    void erase_locked(cache_shard &shard, const std::string &key)
+    {
+        const auto it = shard.index.find(key);
+
+        if (it == shard.index.end()) {
+            return;
+        }
+
+        bytes -= it->second->size;
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+    }
+
+    // Evicts the least recently used images of all the shards until the cache fits into the byte budget.
+    // Locks one shard at a time, so it must be called with no shard locked
+    void trim()
+    {
+        while (bytes > byte_budget) {
+            cache_shard *oldest_shard = nullptr;
+            std::uint64_t oldest_used = 0;
+
+            for (const std::unique_ptr<cache_shard> &shard : shards) {
+                std::lock_guard<std::mutex> lock(shard->mutex);
+
+                if (!shard->lru.empty() && (oldest_shard == nullptr || shard->lru.back().used < oldest_used)) {
+                    oldest_shard = shard.get();
+                    oldest_used  = shard->lru.back().used;
+                }
+            }
+
+            if (oldest_shard == nullptr) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(oldest_shard->mutex);
+
+            // Another thread could trim the cache or use the image meanwhile
+            if (bytes > byte_budget && !oldest_shard->lru.empty()) {
+                const cache_entry &last = oldest_shard->lru.back();
+
+                bytes -= last.size;
+                oldest_shard->index.erase(last.key);
+                oldest_shard->lru.pop_back();
+
+                evictions++;
+            }
+        }
+    }
+
+    const std::size_t byte_budget;
+    std::vector<std::unique_ptr<cache_shard>> shards;
+
+    /* The total size of the cached images of all the shards. */
+    std::atomic<std::size_t> bytes;
+    std::atomic<std::uint64_t> use_clock;
+
+    std::atomic<std::uint64_t> hits;
+    std::atomic<std::uint64_t> misses;
+    std::atomic<std::uint64_t> shared_loads;
+    std::atomic<std::uint64_t> evictions;
+};
+
+image_cache::image_cache(std::size_t byte_budget, unsigned shards)
+    : d(new pimpl(byte_budget, shards))
+{
+}
+
+image_cache::~image_cache()
+{
+}
+
+std::shared_ptr<const sail::image> image_cache::load(const std::string &path)
+{
+    return load(path, [&path](sail::image *image) {
+        sail::image_input input(path);
+
+        SAIL_TRY(input.next_frame(image));
+
+        return SAIL_OK;
+    });
+}
+
+std::shared_ptr<const sail::image> image_cache::load(const std::string &key, const loader_t &loader)
+{
+    cache_shard &shard = d->shard_for(key);
+
+    std::promise<std::shared_ptr<const sail::image>> promise;
+
+    {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+
+        const auto it = shard.index.find(key);
+
+        if (it != shard.index.end()) {
+            d->touch_locked(shard, it->second);
+            d->hits++;
+
+            return it->second->image;
+        }
+
+        const auto loading = shard.loading.find(key);
+
+        if (loading != shard.loading.end()) {
+            const image_future future = loading->second;
+            d->shared_loads++;
+
+            lock.unlock();
+
+            return future.get();
+        }
+
+        d->misses++;
+        shard.loading.emplace(key, promise.get_future().share());
+    }
+
+    std::shared_ptr<const sail::image> result;
+
+    try {
+        std::shared_ptr<sail::image> image(new sail::image);
+
+        if (loader(image.get()) == SAIL_OK && image->is_valid()) {
+            result = std::move(image);
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.loading.erase(key);
+        }
+
+        promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        shard.loading.erase(key);
+
+        if (result) {
+            d->insert_locked(shard, key, result);
+        }
+    }
+
+    d->trim();
+
+    promise.set_value(result);
+
+    return result;
+}
+
+std::shared_ptr<const sail::image> image_cache::find(const std::string &key)
+{
+    cache_shard &shard = d->shard_for(key);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    const auto it = shard.index.find(key);
+
+    if (it == shard.index.end()) {
+        d->misses++;
+        return nullptr;
+    }
+
+    d->touch_locked(shard, it->second);
+    d->hits++;
+
+    return it->second->image;
+}
+
+void image_cache::insert(const std::string &key, std::shared_ptr<const sail::image> image)
+{
+    if (!image) {
+        erase(key);
+        return;
+    }
+
+    cache_shard &shard = d->shard_for(key);
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        d->insert_locked(shard, key, std::move(image));
+    }
+
+    d->trim();
+}
+
+void image_cache::erase(const std::string &key)
+{
+    cache_shard &shard = d->shard_for(key);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    d->erase_locked(shard, key);
+}
+
+void image_cache::clear()
+{
+    for (const std::unique_ptr<cache_shard> &shard : d->shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        for (const cache_entry &entry : shard->lru) {
+            d->bytes -= entry.size;
+        }
+
+        shard->lru.clear();
+        shard->index.clear();
+    }
+}
+
+std::size_t image_cache::byte_budget() const
+{
+    return d->byte_budget;
+}
+
+image_cache::statistics image_cache::stats() const
+{
+    statistics result;
+
+    result.hits         = d->hits;
+    result.misses       = d->misses;
+    result.shared_loads = d->shared_loads;
+    result.evictions    = d->evictions;
+    result.images       = 0;
+    result.bytes        = d->bytes;
+
+    for (const std::unique_ptr<cache_shard> &shard : d->shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        result.images += shard->lru.size();
+    }
+
+    return result;
+}
+
+}
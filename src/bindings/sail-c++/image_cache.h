@@ -0,0 +1,159 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_IMAGE_CACHE_CPP_H
+#define SAIL_IMAGE_CACHE_CPP_H
+
+#include <cstddef> /* std::size_t */
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+namespace sail
+{
+
+class image;
+
+/*
+ * Thread-safe LRU cache of loaded images shared between threads.
+ *
+ * The cache is split into shards selected by the key hash. Every shard has its own lock,
+ * so threads loading different keys rarely wait for each other. The byte budget is shared
+ * by all the shards, and the least recently used images of any shard are evicted to fit
+ * into it. The size of an image is the size of its pixels.
+ *
+ * Concurrent loads of the same missing key are deduplicated: the first thread loads
+ * the image, and the other threads wait for its result.
+ *
+ * Cached images are immutable and shared. Copy an image to modify it. The copy shares
+ * the pixels until they're modified.
+ */
+class SAIL_EXPORT image_cache
+{
+public:
+    /*
+     * Cache statistics.
+     */
+    struct statistics
+    {
+        /* The number of lookups served from the cache. */
+        std::uint64_t hits;
+
+        /* The number of lookups that loaded the image. */
+        std::uint64_t misses;
+
+        /* The number of lookups that waited for the same key being loaded by another thread. */
+        std::uint64_t shared_loads;
+
+        /* The number of images evicted to fit into the byte budget. */
+        std::uint64_t evictions;
+
+        /* The number of cached images. */
+        std::size_t images;
+
+        /* The total size of the cached images in bytes. */
+        std::size_t bytes;
+    };
+
+    /*
+     * Loads an image into the specified image object. Returns SAIL_OK on success.
+     */
+    typedef std::function<sail_status_t(sail::image *image)> loader_t;
+
+    /*
+     * Constructs a new image cache with the specified byte budget split across
+     * the specified number of shards. A zero number of shards is treated as one shard.
+     */
+    explicit image_cache(std::size_t byte_budget, unsigned shards = 16);
+
+    /*
+     * Destroys the image cache. The images still referenced by the caller stay valid.
+     */
+    ~image_cache();
+
+    image_cache(const image_cache &other) = delete;
+    image_cache& operator=(const image_cache &other) = delete;
+
+    /*
+     * Returns the first frame of the specified image file. The path is used as the key.
+     * Loads and caches the image on a miss.
+     *
+     * Returns nullptr on error.
+     */
+    std::shared_ptr<const sail::image> load(const std::string &path);
+
+    /*
+     * Returns the image cached with the specified key. On a miss, loads it with the specified
+     * loader and caches it. Compose the key from a path or a content hash and the load or scale
+     * options applied by the loader, so different options produce different keys.
+     *
+     * Failed loads are not cached. Images larger than the byte budget are returned but not cached.
+     *
+     * Returns nullptr on error.
+     */
+    std::shared_ptr<const sail::image> load(const std::string &key, const loader_t &loader);
+
+    /*
+     * Returns the image cached with the specified key without loading it, or nullptr.
+     */
+    std::shared_ptr<const sail::image> find(const std::string &key);
+
+    /*
+     * Caches the image with the specified key. Replaces the image previously cached with the key.
+     */
+    void insert(const std::string &key, std::shared_ptr<const sail::image> image);
+
+    /*
+     * Removes the image cached with the specified key.
+     */
+    void erase(const std::string &key);
+
+    /*
+     * Removes all the cached images. Images being loaded are cached when they're loaded.
+     */
+    void clear();
+
+    /*
+     * Returns the byte budget.
+     */
+    std::size_t byte_budget() const;
+
+    /*
+     * Returns the cache statistics.
+     */
+    statistics stats() const;
+
+private:
+    class pimpl;
+    const std::unique_ptr<pimpl> d;
+};
+
+}
+
+#endif
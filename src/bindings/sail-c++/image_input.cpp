@@ -23,7 +23,11 @@
     SOFTWARE.
 */
 
+#include <functional>
+#include <future>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include <sail/sail.h>
 
@@ -38,7 +42,18 @@ public:
     pimpl(sail::abstract_io *abstract_io_ext)
         : abstract_io(abstract_io_ext)
         , abstract_io_ref(*abstract_io)
-        , abstract_io_adapter(new sail::abstract_io_adapter(abstract_io_ref))
+        , abstract_io_adapter(new sail::abstract_io_adapter(abstract_io_ref, true))
+        , state(nullptr)
+        , override_codec_info(false)
+        , override_load_options(false)
+    {
+    }
+
+    pimpl(std::shared_ptr<const void> buffer, std::size_t buffer_size)
+        : shared_buffer(std::move(buffer))
+        , abstract_io(new io_memory(shared_buffer.get(), buffer_size))
+        , abstract_io_ref(*abstract_io)
+        , abstract_io_adapter(new sail::abstract_io_adapter(abstract_io_ref, true))
         , state(nullptr)
         , override_codec_info(false)
         , override_load_options(false)
@@ -48,7 +63,7 @@ public:
     pimpl(sail::abstract_io &abstract_io_ext)
         : abstract_io()
         , abstract_io_ref(abstract_io_ext)
-        , abstract_io_adapter(new sail::abstract_io_adapter(abstract_io_ref))
+        , abstract_io_adapter(new sail::abstract_io_adapter(abstract_io_ref, true))
         , state(nullptr)
         , override_codec_info(false)
         , override_load_options(false)
@@ -56,8 +71,15 @@ public:
     }
 
     sail_status_t start();
+    sail_status_t start_async(sail_load_async_callback_t callback, void *user_data);
+
+    SailPixelFormat requested_pixel_format() const;
 
 private:
+    sail::codec_info detect_codec_info();
+
+    /* Declared first to outlive the I/O object that reads from it. */
+    const std::shared_ptr<const void> shared_buffer;
     const std::unique_ptr<sail::abstract_io> abstract_io;
     sail::abstract_io &abstract_io_ref;
 
@@ -71,13 +93,37 @@ public:
     sail::load_options load_options;
 };
 
-sail_status_t image_input::pimpl::start()
+sail::codec_info image_input::pimpl::detect_codec_info()
 {
     if (!override_codec_info) {
         codec_info = abstract_io_ref.codec_info();
     }
 
-    const sail_codec_info *sail_codec_info = codec_info.sail_codec_info_c();
+    return codec_info;
+}
+
+sail_status_t image_input::pimpl::start()
+{
+    const sail_codec_info *sail_codec_info = detect_codec_info().sail_codec_info_c();
+
+    sail_load_options *sail_load_options = nullptr;
+
+    SAIL_AT_SCOPE_EXIT(
+        sail_destroy_load_options(sail_load_options);
+    );
+
+    if (override_load_options) {
+        SAIL_TRY(load_options.to_sail_load_options(&sail_load_options));
+    }
+
+    SAIL_TRY(sail_start_loading_from_io_with_shared_options(&abstract_io_adapter->sail_io_c(), sail_codec_info, sail_load_options, &state));
+
+    return SAIL_OK;
+}
+
+sail_status_t image_input::pimpl::start_async(sail_load_async_callback_t callback, void *user_data)
+{
+    const sail_codec_info *sail_codec_info = detect_codec_info().sail_codec_info_c();
 
     sail_load_options *sail_load_options = nullptr;
 
@@ -89,11 +135,57 @@ sail_status_t image_input::pimpl::start()
         SAIL_TRY(load_options.to_sail_load_options(&sail_load_options));
     }
 
-    SAIL_TRY(sail_start_loading_from_io_with_options(&abstract_io_adapter->sail_io_c(), sail_codec_info, sail_load_options, &state));
+    /* The load options are deep copied. */
+    SAIL_TRY(sail_load_async(&abstract_io_adapter->sail_io_c(), sail_codec_info, sail_load_options, callback, user_data));
 
     return SAIL_OK;
 }
 
+SailPixelFormat image_input::pimpl::requested_pixel_format() const
+{
+    return override_load_options ? load_options.output_pixel_format() : SAIL_PIXEL_FORMAT_UNKNOWN;
+}
+
+/* Converts frames the codec couldn't decode into the requested pixel format. */
+static sail_status_t convert_to_requested_pixel_format(sail::image *image, SailPixelFormat pixel_format)
+{
+    if (pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN
+            && image->is_valid()
+            && image->pixel_format() != pixel_format
+            && image->can_convert(pixel_format)) {
+        SAIL_TRY(image->convert(pixel_format));
+    }
+
+    return SAIL_OK;
+}
+
+struct SAIL_HIDDEN load_async_context
+{
+    std::function<void(sail_status_t, sail::image)> callback;
+    SailPixelFormat pixel_format;
+};
+
+void image_input::load_async_callback(sail_status_t status, sail_image *sail_image, void *user_data)
+{
+    const std::unique_ptr<load_async_context> context(static_cast<load_async_context *>(user_data));
+
+    SAIL_AT_SCOPE_EXIT(
+        sail_destroy_image(sail_image);
+    );
+
+    sail::image image;
+
+    if (status == SAIL_OK) {
+        status = image.adopt_sail_image(sail_image);
+    }
+
+    if (status == SAIL_OK) {
+        status = convert_to_requested_pixel_format(&image, context->pixel_format);
+    }
+
+    context->callback(status, (status == SAIL_OK) ? std::move(image) : sail::image{});
+}
+
 image_input::image_input(const std::string &path)
     : d(new pimpl(new io_file(path)))
 {
@@ -109,6 +201,21 @@ image_input::image_input(const sail::arbitrary_data &arbitrary_data)
 {
 }
 
+image_input::image_input(std::shared_ptr<const void> buffer, std::size_t buffer_size)
+    : d(new pimpl(std::move(buffer), buffer_size))
+{
+}
+
+image_input::image_input(std::shared_ptr<const sail::arbitrary_data> arbitrary_data)
+    : d(nullptr)
+{
+    const void *data = arbitrary_data ? arbitrary_data->data() : nullptr;
+    const std::size_t data_size = arbitrary_data ? arbitrary_data->size() : 0;
+
+    /* Share ownership of the vector while pointing to its data. */
+    d.reset(new pimpl(std::shared_ptr<const void>(std::move(arbitrary_data), data), data_size));
+}
+
 image_input::image_input(sail::abstract_io &abstract_io)
     : d(new pimpl(abstract_io))
 {
@@ -121,12 +228,12 @@ image_input::~image_input()
     }
 }
 
-image_input::image_input(image_input &&other)
+image_input::image_input(image_input &&other) noexcept
 {
     *this = std::move(other);
 }
 
-image_input& image_input::operator=(image_input &&other)
+image_input& image_input::operator=(image_input &&other) noexcept
 {
     d = std::move(other.d);
     other.d = {};
@@ -150,6 +257,14 @@ image_input& image_input::with(const sail::load_options &load_options)
     return *this;
 }
 
+image_input& image_input::with(sail::load_options &&load_options) noexcept
+{
+    d->override_load_options = true;
+    d->load_options          = std::move(load_options);
+
+    return *this;
+}
+
 sail_status_t image_input::next_frame(sail::image *image)
 {
     if (d->state == nullptr) {
@@ -164,8 +279,9 @@ sail_status_t image_input::next_frame(sail::image *image)
 
     SAIL_TRY(sail_load_next_frame(d->state, &sail_image));
 
-    *image = sail::image(sail_image);
-    sail_image->pixels = nullptr;
+    SAIL_TRY(image->adopt_sail_image(sail_image));
+
+    SAIL_TRY(convert_to_requested_pixel_format(image, d->requested_pixel_format()));
 
     return SAIL_OK;
 }
@@ -180,6 +296,61 @@ image image_input::next_frame()
     return image;
 }
 
+sail_status_t image_input::load_async(std::function<void(sail_status_t, sail::image)> callback)
+{
+    if (!callback) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NULL_PTR);
+    }
+
+    if (d->state != nullptr) {
+        SAIL_LOG_ERROR("The image input is already loading frames");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    }
+
+    std::unique_ptr<load_async_context> context(new load_async_context{ std::move(callback), d->requested_pixel_format() });
+
+    SAIL_TRY(d->start_async(load_async_callback, context.get()));
+
+    /* Owned by the callback now. */
+    context.release();
+
+    return SAIL_OK;
+}
+
+std::future<sail::image> image_input::load_async()
+{
+    const std::shared_ptr<std::promise<sail::image>> promise = std::make_shared<std::promise<sail::image>>();
+    std::future<sail::image> future = promise->get_future();
+
+    SAIL_TRY_OR_EXECUTE(load_async([promise](sail_status_t, sail::image image) { promise->set_value(std::move(image)); }),
+                        /* on error */ promise->set_value(sail::image{}));
+
+    return future;
+}
+
+sail::frame_range image_input::frames()
+{
+    return sail::frame_range(*this);
+}
+
+sail::prefetch_frame_range image_input::prefetched_frames()
+{
+    return sail::prefetch_frame_range(*this);
+}
+
+sail_status_t image_input::next_recycled_frame(sail::image *image)
+{
+    if (d->state == nullptr) {
+        SAIL_TRY(d->start());
+    }
+
+    SAIL_TRY(image->recycle_pixels(d->state));
+
+    SAIL_TRY(next_frame(image));
+
+    return SAIL_OK;
+}
+
 sail_status_t image_input::finish()
 {
     sail_status_t saved_status = SAIL_OK;
@@ -206,4 +377,39 @@ std::tuple<image, codec_info> image_input::probe()
     return std::tuple<image, codec_info>{ image(sail_image), codec_info(sail_codec_info) };
 }
 
+std::vector<std::tuple<image, codec_info>> image_input::probe(const std::vector<std::string> &paths, unsigned threads)
+{
+    std::vector<const char *> sail_paths;
+    sail_paths.reserve(paths.size());
+
+    for (const std::string &path : paths) {
+        sail_paths.push_back(path.c_str());
+    }
+
+    std::vector<sail_image *> sail_images(paths.size(), nullptr);
+    std::vector<const sail_codec_info *> sail_codec_infos(paths.size(), nullptr);
+
+    SAIL_AT_SCOPE_EXIT(
+        for (sail_image *sail_image : sail_images) {
+            sail_destroy_image(sail_image);
+        }
+    );
+
+    /* Failed files are reported as invalid images. */
+    sail_probe_files(sail_paths.data(), sail_paths.size(), sail_images.data(), sail_codec_infos.data(), threads);
+
+    std::vector<std::tuple<image, codec_info>> result;
+    result.reserve(paths.size());
+
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        if (sail_images[i] == nullptr) {
+            result.emplace_back(image{}, codec_info{});
+        } else {
+            result.emplace_back(image(sail_images[i]), codec_info(sail_codec_infos[i]));
+        }
+    }
+
+    return result;
+}
+
 }
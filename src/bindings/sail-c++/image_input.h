@@ -27,14 +27,18 @@
 #define SAIL_IMAGE_INPUT_CPP_H
 
 #include <cstddef> /* std::size_t */
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
 #include <sail-c++/arbitrary_data.h>
+#include <sail-c++/frame_range.h>
 #include <sail-c++/image.h>
 
 namespace sail
@@ -65,6 +69,22 @@ public:
      */
     explicit image_input(const sail::arbitrary_data &arbitrary_data);
 
+    /*
+     * Constructs a new image input from the specified shared memory buffer without copying it.
+     * The image input keeps a reference to the buffer until it's destroyed, so the caller
+     * may release its own references while the image is being loaded.
+     *
+     * Any shared pointer converts to std::shared_ptr<const void>, including the ones
+     * with custom deleters for the network or mapped buffers.
+     */
+    image_input(std::shared_ptr<const void> buffer, std::size_t buffer_size);
+
+    /*
+     * Constructs a new image input from the specified shared memory buffer without copying it.
+     * The image input keeps a reference to the buffer until it's destroyed.
+     */
+    explicit image_input(std::shared_ptr<const sail::arbitrary_data> arbitrary_data);
+
     /*
      * Constructs a new image input from the specified I/O source.
      */
@@ -78,12 +98,12 @@ public:
     /*
      * Moves the image input.
      */
-    image_input(image_input &&other);
+    image_input(image_input &&other) noexcept;
 
     /*
      * Moves the image input.
      */
-    image_input& operator=(image_input &&other);
+    image_input& operator=(image_input &&other) noexcept;
 
     /*
      * Overrides the automatically detected codec info used to load the image.
@@ -95,8 +115,15 @@ public:
      */
     image_input& with(const sail::load_options &load_options);
 
+    /*
+     * Overrides the load options used to load the image.
+     */
+    image_input& with(sail::load_options &&load_options) noexcept;
+
     /*
      * Continues loading the image. Assigns the loaded image to the 'image' argument.
+     * When the load options request an output pixel format the codec cannot decode into,
+     * the image is converted into it if possible.
      *
      * Returns SAIL_OK on success.
      * Returns SAIL_ERROR_NO_MORE_FRAMES when no more frames are available.
@@ -110,6 +137,38 @@ public:
      */
     image next_frame();
 
+    /*
+     * Loads the first frame on the thread pool and returns immediately. See sail_load_async().
+     * When the method returns SAIL_OK, the callback is called exactly once from a thread pool thread
+     * with the loaded image, or with the error and an invalid image. Resuming a coroutine from
+     * the callback makes the load awaitable. The callback must not throw.
+     *
+     * The image input must stay alive and must not be used until the callback is called.
+     *
+     * Returns SAIL_OK on success.
+     * Returns SAIL_ERROR_CONFLICTING_OPERATION when the image input is already loading frames.
+     */
+    sail_status_t load_async(std::function<void(sail_status_t, sail::image)> callback);
+
+    /*
+     * Loads the first frame on the thread pool and returns the future of the image.
+     * The future holds an invalid image on error. The image input must stay alive
+     * and must not be used until the future is ready.
+     */
+    std::future<sail::image> load_async();
+
+    /*
+     * Returns the range of the remaining frames that reuses one frame object and its pixels.
+     * See frame_range.
+     */
+    sail::frame_range frames();
+
+    /*
+     * Returns the range of the remaining frames that decodes the next frame on the thread pool
+     * while the current one is being used. See prefetch_frame_range.
+     */
+    sail::prefetch_frame_range prefetched_frames();
+
     /*
      * Finishes loading and closes the I/O stream. Call to finish() is optional.
      *
@@ -127,7 +186,30 @@ public:
      */
     std::tuple<image, codec_info> probe();
 
+    /*
+     * Probes the specified image files in parallel and returns their properties without pixels
+     * and the corresponding codec infos in the same order. The files are distributed across
+     * the specified number of threads. If 'threads' is 0, the number of online processors is used.
+     * See sail_probe_files().
+     *
+     * Returns invalid images and codec infos for the files that failed to probe.
+     */
+    static std::vector<std::tuple<image, codec_info>> probe(const std::vector<std::string> &paths, unsigned threads = 0);
+
 private:
+    friend class frame_range;
+    friend class prefetch_frame_range;
+
+    /*
+     * Gives the pixels of the image back to the loading state, and continues loading into it.
+     */
+    sail_status_t next_recycled_frame(sail::image *image);
+
+    /*
+     * Completion callback of sail_load_async().
+     */
+    static void load_async_callback(sail_status_t status, sail_image *sail_image, void *user_data);
+
     class pimpl;
     std::unique_ptr<pimpl> d;
 };
@@ -23,6 +23,12 @@
     SOFTWARE.
 */
 
+#include <algorithm>
+#include <cstdio> /* seek whence */
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
 
 #include <sail/sail.h>
@@ -32,6 +38,164 @@
 namespace sail
 {
 
+/*
+ * Writes directly into arbitrary data growing it on demand. The data
+ * holds exactly the written bytes, so no staging buffer is needed.
+ */
+class SAIL_HIDDEN io_arbitrary_data : public sail::abstract_io
+{
+public:
+    explicit io_arbitrary_data(sail::arbitrary_data &other_arbitrary_data)
+        : arbitrary_data(other_arbitrary_data)
+        , pos(0)
+    {
+        arbitrary_data.clear();
+    }
+
+    int features() const override
+    {
+        return SAIL_IO_FEATURE_SEEKABLE;
+    }
+
+    sail_status_t tolerant_read(void *buf, std::size_t size_to_read, std::size_t *read_size) override
+    {
+        SAIL_CHECK_PTR(buf);
+        SAIL_CHECK_PTR(read_size);
+
+        *read_size = 0;
+
+        if (pos >= arbitrary_data.size()) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_EOF);
+        }
+
+        const std::size_t actual_size_to_read = std::min(size_to_read, arbitrary_data.size() - pos);
+
+        std::memcpy(buf, arbitrary_data.data() + pos, actual_size_to_read);
+        pos += actual_size_to_read;
+
+        *read_size = actual_size_to_read;
+
+        return SAIL_OK;
+    }
+
+    sail_status_t strict_read(void *buf, std::size_t size_to_read) override
+    {
+        std::size_t read_size;
+        SAIL_TRY(tolerant_read(buf, size_to_read, &read_size));
+
+        if (read_size != size_to_read) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+        }
+
+        return SAIL_OK;
+    }
+
+    sail_status_t tolerant_write(const void *buf, std::size_t size_to_write, std::size_t *written_size) override
+    {
+        SAIL_CHECK_PTR(buf);
+        SAIL_CHECK_PTR(written_size);
+
+        /* std::vector grows its capacity geometrically. */
+        if (pos + size_to_write > arbitrary_data.size()) {
+            SAIL_TRY_OR_EXECUTE(resize(pos + size_to_write),
+                                /* on error */ *written_size = 0; return __sail_status);
+        }
+
+        std::memcpy(arbitrary_data.data() + pos, buf, size_to_write);
+        pos += size_to_write;
+
+        *written_size = size_to_write;
+
+        return SAIL_OK;
+    }
+
+    sail_status_t strict_write(const void *buf, std::size_t size_to_write) override
+    {
+        std::size_t written_size;
+        SAIL_TRY(tolerant_write(buf, size_to_write, &written_size));
+
+        if (written_size != size_to_write) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_WRITE_IO);
+        }
+
+        return SAIL_OK;
+    }
+
+    sail_status_t seek(long offset, int whence) override
+    {
+        long base;
+
+        switch (whence) {
+            case SEEK_SET: base = 0;                                       break;
+            case SEEK_CUR: base = static_cast<long>(pos);                  break;
+            case SEEK_END: base = static_cast<long>(arbitrary_data.size()); break;
+
+            default: {
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_SEEK_WHENCE);
+            }
+        }
+
+        if (base + offset < 0) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+        }
+
+        /* Seeking past the end is allowed, the data grows on the next write. */
+        pos = static_cast<std::size_t>(base + offset);
+
+        return SAIL_OK;
+    }
+
+    sail_status_t tell(std::size_t *offset) override
+    {
+        SAIL_CHECK_PTR(offset);
+
+        *offset = pos;
+
+        return SAIL_OK;
+    }
+
+    sail_status_t flush() override
+    {
+        return SAIL_OK;
+    }
+
+    sail_status_t close() override
+    {
+        return SAIL_OK;
+    }
+
+    sail_status_t eof(bool *result) override
+    {
+        SAIL_CHECK_PTR(result);
+
+        *result = pos >= arbitrary_data.size();
+
+        return SAIL_OK;
+    }
+
+    sail::codec_info codec_info() override
+    {
+        return sail::codec_info::from_magic_number(*this);
+    }
+
+private:
+    sail_status_t resize(std::size_t size)
+    {
+        try {
+            arbitrary_data.resize(size);
+        } catch (const std::exception &e) {
+            SAIL_LOG_ERROR("%s", e.what());
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+        }
+
+        return SAIL_OK;
+    }
+
+private:
+    sail::arbitrary_data &arbitrary_data;
+    std::size_t pos;
+};
+
 class SAIL_HIDDEN image_output::pimpl
 {
 public:
@@ -56,6 +220,7 @@ public:
     }
 
     sail_status_t start();
+    sail_status_t start_async(const sail_image *image, sail_save_async_callback_t callback, void *user_data);
 
 private:
     const std::unique_ptr<sail::abstract_io> abstract_io;
@@ -84,11 +249,45 @@ sail_status_t image_output::pimpl::start()
         SAIL_TRY(save_options.to_sail_save_options(&sail_save_options));
     }
 
-    SAIL_TRY(sail_start_saving_into_io_with_options(&abstract_io_adapter->sail_io_c(), sail_codec_info, sail_save_options, &state));
+    SAIL_TRY(sail_start_saving_into_io_with_shared_options(&abstract_io_adapter->sail_io_c(), sail_codec_info, sail_save_options, &state));
 
     return SAIL_OK;
 }
 
+sail_status_t image_output::pimpl::start_async(const sail_image *image, sail_save_async_callback_t callback, void *user_data)
+{
+    const sail_codec_info *sail_codec_info = codec_info.sail_codec_info_c();
+
+    sail_save_options *sail_save_options = nullptr;
+
+    SAIL_AT_SCOPE_EXIT(
+        sail_destroy_save_options(sail_save_options);
+    );
+
+    if (override_save_options) {
+        SAIL_TRY(save_options.to_sail_save_options(&sail_save_options));
+    }
+
+    /* The save options are deep copied. */
+    SAIL_TRY(sail_save_async(&abstract_io_adapter->sail_io_c(), sail_codec_info, sail_save_options, image, callback, user_data));
+
+    return SAIL_OK;
+}
+
+/* The borrowed view must live until the image is saved. */
+struct SAIL_HIDDEN save_async_context
+{
+    std::function<void(sail_status_t)> callback;
+    image_view_private view;
+};
+
+static void save_async_callback(sail_status_t status, void *user_data)
+{
+    const std::unique_ptr<save_async_context> context(static_cast<save_async_context *>(user_data));
+
+    context->callback(status);
+}
+
 image_output::image_output(const std::string &path)
     : d(new pimpl(new io_file(path, io_file::Operation::ReadWrite), sail::codec_info::from_path(path)))
 {
@@ -100,7 +299,7 @@ image_output::image_output(void *buffer, std::size_t buffer_size, const sail::co
 }
 
 image_output::image_output(sail::arbitrary_data *arbitrary_data, const sail::codec_info &codec_info)
-    : image_output(arbitrary_data->data(), arbitrary_data->size(), codec_info)
+    : d(new pimpl(new io_arbitrary_data(*arbitrary_data), codec_info))
 {
 }
 
@@ -116,12 +315,12 @@ image_output::~image_output()
     }
 }
 
-image_output::image_output(image_output &&other)
+image_output::image_output(image_output &&other) noexcept
 {
     *this = std::move(other);
 }
 
-image_output& image_output::operator=(image_output &&other)
+image_output& image_output::operator=(image_output &&other) noexcept
 {
     d = std::move(other.d);
     other.d = {};
@@ -144,25 +343,63 @@ image_output& image_output::with(const sail::save_options &save_options)
     return *this;
 }
 
+image_output& image_output::with(sail::save_options &&save_options) noexcept
+{
+    d->override_save_options = true;
+    d->save_options          = std::move(save_options);
+
+    return *this;
+}
+
 sail_status_t image_output::next_frame(const sail::image &image)
 {
     if (d->state == nullptr) {
         SAIL_TRY(d->start());
     }
 
-    sail_image *sail_image = nullptr;
-    SAIL_TRY(image.to_sail_image(&sail_image));
+    image_view_private view;
+    SAIL_TRY(view.init(image));
 
-    SAIL_AT_SCOPE_EXIT(
-        sail_image->pixels = nullptr;
-        sail_destroy_image(sail_image);
-    );
+    SAIL_TRY(sail_write_next_frame(d->state, view.c_image()));
 
-    SAIL_TRY(sail_write_next_frame(d->state, sail_image));
+    return SAIL_OK;
+}
+
+sail_status_t image_output::save_async(const sail::image &image, std::function<void(sail_status_t)> callback)
+{
+    if (!callback) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NULL_PTR);
+    }
+
+    if (d->state != nullptr) {
+        SAIL_LOG_ERROR("The image output is already saving frames");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    }
+
+    std::unique_ptr<save_async_context> context(new save_async_context);
+    context->callback = std::move(callback);
+
+    SAIL_TRY(context->view.init(image));
+
+    SAIL_TRY(d->start_async(context->view.c_image(), save_async_callback, context.get()));
+
+    /* Owned by the callback now. */
+    context.release();
 
     return SAIL_OK;
 }
 
+std::future<sail_status_t> image_output::save_async(const sail::image &image)
+{
+    const std::shared_ptr<std::promise<sail_status_t>> promise = std::make_shared<std::promise<sail_status_t>>();
+    std::future<sail_status_t> future = promise->get_future();
+
+    SAIL_TRY_OR_EXECUTE(save_async(image, [promise](sail_status_t status) { promise->set_value(status); }),
+                        /* on error */ promise->set_value(__sail_status));
+
+    return future;
+}
+
 sail_status_t image_output::finish()
 {
     sail_status_t saved_status = SAIL_OK;
@@ -27,6 +27,8 @@
 #define SAIL_IMAGE_OUTPUT_CPP_H
 
 #include <cstddef> /* std::size_t */
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
 
@@ -61,7 +63,9 @@ public:
     image_output(void *buffer, std::size_t buffer_size, const sail::codec_info &codec_info);
 
     /*
-     * Constructs a new image output to the specified memory buffer.
+     * Constructs a new image output to the specified arbitrary data. The data is cleared
+     * and grows on demand while saving, so it doesn't need to be preallocated. After finish()
+     * it holds exactly the saved bytes. The data must outlive the image output.
      */
     image_output(sail::arbitrary_data *arbitrary_data, const sail::codec_info &codec_info);
 
@@ -78,12 +82,12 @@ public:
     /*
      * Moves the image output.
      */
-    image_output(image_output &&other);
+    image_output(image_output &&other) noexcept;
 
     /*
      * Moves the image output.
      */
-    image_output& operator=(image_output &&other);
+    image_output& operator=(image_output &&other) noexcept;
 
     /*
      * Overrides the automatically detected codec info used to save the image.
@@ -95,6 +99,11 @@ public:
      */
     image_output& with(const sail::save_options &save_options);
 
+    /*
+     * Overrides the save options used to save the image.
+     */
+    image_output& with(sail::save_options &&save_options) noexcept;
+
     /*
      * Continues saving into the I/O target.
      *
@@ -105,6 +114,25 @@ public:
      */
     sail_status_t next_frame(const sail::image &image);
 
+    /*
+     * Saves the image as a single frame on the thread pool and returns immediately. See sail_save_async().
+     * When the method returns SAIL_OK, the callback is called exactly once from a thread pool thread
+     * with the saving status. Resuming a coroutine from the callback makes the save awaitable.
+     * The callback must not throw.
+     *
+     * The image output and the image must stay alive and must not be used until the callback is called.
+     *
+     * Returns SAIL_OK on success.
+     * Returns SAIL_ERROR_CONFLICTING_OPERATION when the image output is already saving frames.
+     */
+    sail_status_t save_async(const sail::image &image, std::function<void(sail_status_t)> callback);
+
+    /*
+     * Saves the image as a single frame on the thread pool and returns the future of the saving status.
+     * The image output and the image must stay alive and must not be used until the future is ready.
+     */
+    std::future<sail_status_t> save_async(const sail::image &image);
+
     /*
      * Finishes saving and closes the I/O stream. Call to finish() is recommended
      * if you want to ensure the I/O stream is flushed and closed successfully.
@@ -0,0 +1,121 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <sail-c++/sail-c++.h>
+
+namespace sail
+{
+
+image_view_private::image_view_private()
+    : c_image_{}
+    , resolution{}
+    , palette{}
+    , iccp{}
+{
+}
+
+image_view_private::~image_view_private()
+{
+    // Everything except the source image is borrowed from sail::image
+    sail_destroy_source_image(c_image_.source_image);
+}
+
+sail_status_t image_view_private::init(const sail::image &image)
+{
+    const sail_image *source = image.c_image();
+
+    c_image_ = sail_image{};
+
+    // Pixels are shallow copied
+    c_image_.pixels         = source->pixels;
+    c_image_.width          = source->width;
+    c_image_.height         = source->height;
+    c_image_.bytes_per_line = source->bytes_per_line;
+    c_image_.pixel_format   = source->pixel_format;
+    c_image_.gamma          = source->gamma;
+    c_image_.delay          = source->delay;
+
+    // Tells sail-manip to allocate the resulting pixels in file-backed memory too
+    c_image_.pixels_file_backed_size = source->pixels_file_backed_size;
+
+    // Meta data entries point to the keys and the values stored in sail::meta_data
+    const std::vector<sail::meta_data> &image_meta_data = image.meta_data();
+
+    meta_data_nodes.resize(image_meta_data.size());
+    meta_data.resize(image_meta_data.size());
+    variants.resize(image_meta_data.size());
+
+    for (std::size_t i = 0; i < image_meta_data.size(); i++) {
+        image_meta_data[i].value().to_sail_variant_view(&variants[i]);
+
+        meta_data[i].key         = image_meta_data[i].key();
+        meta_data[i].key_unknown = meta_data[i].key == SAIL_META_DATA_UNKNOWN
+                                    ? const_cast<char *>(image_meta_data[i].key_unknown().c_str())
+                                    : nullptr;
+        meta_data[i].value       = &variants[i];
+
+        meta_data_nodes[i].meta_data = &meta_data[i];
+        meta_data_nodes[i].next      = (i + 1 < image_meta_data.size()) ? &meta_data_nodes[i + 1] : nullptr;
+    }
+
+    c_image_.meta_data_node = meta_data_nodes.empty() ? nullptr : &meta_data_nodes[0];
+
+    if (image.resolution().is_valid()) {
+        resolution.unit = image.resolution().unit();
+        resolution.x    = image.resolution().x();
+        resolution.y    = image.resolution().y();
+
+        c_image_.resolution = &resolution;
+    }
+
+    if (image.palette().is_valid()) {
+        palette.pixel_format = image.palette().pixel_format();
+        palette.data         = const_cast<void *>(reinterpret_cast<const void *>(image.palette().data().data()));
+        palette.color_count  = image.palette().color_count();
+
+        c_image_.palette = &palette;
+    }
+
+    if (image.iccp().is_valid()) {
+        iccp.data = const_cast<void *>(reinterpret_cast<const void *>(image.iccp().data().data()));
+        iccp.size = image.iccp().data().size();
+
+        c_image_.iccp = &iccp;
+    }
+
+    // The source image is small and owns a hash map, so it's copied
+    if (image.source_image().is_valid()) {
+        SAIL_TRY(image.source_image().to_sail_source_image(&c_image_.source_image));
+    }
+
+    return SAIL_OK;
+}
+
+const sail_image* image_view_private::c_image() const
+{
+    return &c_image_;
+}
+
+}
@@ -0,0 +1,79 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_IMAGE_VIEW_PRIVATE_CPP_H
+#define SAIL_IMAGE_VIEW_PRIVATE_CPP_H
+
+#include <vector>
+
+#include <sail-common/export.h>
+#include <sail-common/iccp.h>
+#include <sail-common/image.h>
+#include <sail-common/meta_data.h>
+#include <sail-common/meta_data_node.h>
+#include <sail-common/palette.h>
+#include <sail-common/resolution.h>
+#include <sail-common/status.h>
+#include <sail-common/variant.h>
+
+namespace sail
+{
+
+class image;
+
+/*
+ * Borrowed C view of sail::image passed to the C functions that only read images.
+ * Unlike image::to_sail_image(), it shares the pixels, the palette, the ICC profile,
+ * and the meta data buffers with the image instead of allocating a new sail_image.
+ *
+ * The view must not outlive the image, and the image must not be modified while
+ * the view is in use.
+ */
+class SAIL_HIDDEN image_view_private
+{
+public:
+    image_view_private();
+    ~image_view_private();
+
+    image_view_private(const image_view_private &) = delete;
+    image_view_private& operator=(const image_view_private &) = delete;
+
+    sail_status_t init(const sail::image &image);
+
+    const sail_image* c_image() const;
+
+private:
+    sail_image c_image_;
+    sail_resolution resolution;
+    sail_palette palette;
+    sail_iccp iccp;
+    std::vector<sail_meta_data_node> meta_data_nodes;
+    std::vector<sail_meta_data> meta_data;
+    std::vector<sail_variant> variants;
+};
+
+}
+
+#endif
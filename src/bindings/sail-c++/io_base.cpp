@@ -105,4 +105,22 @@ sail_status_t io_base::eof(bool *result)
     return SAIL_OK;
 }
 
+sail_status_t io_base::map(const void **data, std::size_t *size)
+{
+    if (d->sail_io_wrapper->map == nullptr) {
+        return SAIL_ERROR_NOT_IMPLEMENTED;
+    }
+
+    SAIL_TRY(d->sail_io_wrapper->map(d->sail_io_wrapper->stream, data, size));
+
+    return SAIL_OK;
+}
+
+sail_status_t io_base::will_need(std::size_t offset, std::size_t length)
+{
+    SAIL_TRY(sail_io_will_need(d->sail_io_wrapper.get(), offset, length));
+
+    return SAIL_OK;
+}
+
 }
@@ -140,9 +140,28 @@ public:
      */
     sail_status_t eof(bool *result) override;
 
+    /*
+     * Assigns a pointer to the contiguous data of the underlying I/O object from the current
+     * position until the end and its size. Doesn't change the current position.
+     *
+     * Returns SAIL_OK on success.
+     * Returns SAIL_ERROR_NOT_IMPLEMENTED if the underlying I/O object cannot be mapped.
+     */
+    sail_status_t map(const void **data, std::size_t *size) override;
+
+    /*
+     * Hints the underlying I/O object that the specified range is going to be read soon.
+     *
+     * Returns SAIL_OK on success.
+     */
+    sail_status_t will_need(std::size_t offset, std::size_t length) override;
+
 protected:
     class pimpl;
     const std::unique_ptr<pimpl> d;
+
+private:
+    friend class abstract_io_adapter;
 };
 
 }
@@ -47,8 +47,45 @@ public:
         sail_destroy_load_options(sail_load_options);
     }
 
+    /*
+     * Returns the C load options safe to modify. They're shared with copies of this object
+     * and with loading operations, so detach them first.
+     */
+    struct sail_load_options* writable_sail_load_options()
+    {
+        SAIL_TRY_OR_EXECUTE(sail_detach_load_options(&sail_load_options),
+                            /* on error */ throw std::bad_alloc());
+
+        return sail_load_options;
+    }
+
+    /* Converts the tuning into the C load options if it has changed since the last conversion. */
+    sail_status_t sync_tuning()
+    {
+        if (tuning == synced_tuning) {
+            return SAIL_OK;
+        }
+
+        SAIL_TRY(sail_detach_load_options(&sail_load_options));
+
+        sail_destroy_hash_map(sail_load_options->tuning);
+        sail_load_options->tuning = nullptr;
+        synced_tuning.clear();
+
+        if (!tuning.empty()) {
+            SAIL_TRY(sail_alloc_hash_map(&sail_load_options->tuning));
+            SAIL_TRY(utils_private::cpp_tuning_to_sail_tuning(tuning, sail_load_options->tuning));
+        }
+
+        synced_tuning = tuning;
+
+        return SAIL_OK;
+    }
+
     struct sail_load_options *sail_load_options;
     sail::tuning tuning;
+    /* The tuning stored in sail_load_options. */
+    sail::tuning synced_tuning;
 };
 
 load_options::load_options(int options)
@@ -70,8 +107,19 @@ load_options::load_options(const load_options &ro)
 
 load_options& load_options::operator=(const sail::load_options &load_options)
 {
-    set_options(load_options.options());
-    set_tuning(load_options.tuning());
+    if (this == &load_options) {
+        return *this;
+    }
+
+    struct sail_load_options *sail_load_options;
+    SAIL_TRY_OR_EXECUTE(sail_share_load_options(load_options.d->sail_load_options, &sail_load_options),
+                        /* on error */ throw std::bad_alloc());
+
+    sail_destroy_load_options(d->sail_load_options);
+
+    d->sail_load_options = sail_load_options;
+    d->tuning            = load_options.d->tuning;
+    d->synced_tuning     = load_options.d->synced_tuning;
 
     return *this;
 }
@@ -107,9 +155,69 @@ const sail::tuning& load_options::tuning() const
     return d->tuning;
 }
 
+std::uint64_t load_options::meta_data_keys() const
+{
+    return d->sail_load_options->meta_data_keys;
+}
+
+unsigned load_options::row_alignment() const
+{
+    return d->sail_load_options->row_alignment;
+}
+
+unsigned load_options::pixels_alignment() const
+{
+    return d->sail_load_options->pixels_alignment;
+}
+
+std::size_t load_options::file_backed_pixels_threshold() const
+{
+    return d->sail_load_options->file_backed_pixels_threshold;
+}
+
+unsigned load_options::scale_denominator() const
+{
+    return d->sail_load_options->scale_denominator;
+}
+
+SailPixelFormat load_options::output_pixel_format() const
+{
+    return d->sail_load_options->output_pixel_format;
+}
+
 void load_options::set_options(int options)
 {
-    d->sail_load_options->options = options;
+    d->writable_sail_load_options()->options = options;
+}
+
+void load_options::set_meta_data_keys(std::uint64_t meta_data_keys)
+{
+    d->writable_sail_load_options()->meta_data_keys = meta_data_keys;
+}
+
+void load_options::set_row_alignment(unsigned row_alignment)
+{
+    d->writable_sail_load_options()->row_alignment = row_alignment;
+}
+
+void load_options::set_pixels_alignment(unsigned pixels_alignment)
+{
+    d->writable_sail_load_options()->pixels_alignment = pixels_alignment;
+}
+
+void load_options::set_file_backed_pixels_threshold(std::size_t file_backed_pixels_threshold)
+{
+    d->writable_sail_load_options()->file_backed_pixels_threshold = file_backed_pixels_threshold;
+}
+
+void load_options::set_scale_denominator(unsigned scale_denominator)
+{
+    d->writable_sail_load_options()->scale_denominator = scale_denominator;
+}
+
+void load_options::set_output_pixel_format(SailPixelFormat output_pixel_format)
+{
+    d->writable_sail_load_options()->output_pixel_format = output_pixel_format;
 }
 
 void load_options::set_tuning(const sail::tuning &tuning)
@@ -117,6 +225,11 @@ void load_options::set_tuning(const sail::tuning &tuning)
     d->tuning = tuning;
 }
 
+void load_options::set_tuning(sail::tuning &&tuning) noexcept
+{
+    d->tuning = std::move(tuning);
+}
+
 load_options::load_options(const sail_load_options *ro)
     : load_options()
 {
@@ -126,6 +239,12 @@ load_options::load_options(const sail_load_options *ro)
     }
 
     set_options(ro->options);
+    set_meta_data_keys(ro->meta_data_keys);
+    set_row_alignment(ro->row_alignment);
+    set_pixels_alignment(ro->pixels_alignment);
+    set_file_backed_pixels_threshold(ro->file_backed_pixels_threshold);
+    set_scale_denominator(ro->scale_denominator);
+    set_output_pixel_format(ro->output_pixel_format);
     set_tuning(utils_private::c_tuning_to_cpp_tuning(ro->tuning));
 }
 
@@ -133,19 +252,8 @@ sail_status_t load_options::to_sail_load_options(sail_load_options **load_option
 {
     SAIL_CHECK_PTR(load_options);
 
-    sail_load_options *load_options_local;
-
-    SAIL_TRY(sail_alloc_load_options(&load_options_local));
-
-    load_options_local->options = d->sail_load_options->options;
-
-    SAIL_TRY_OR_CLEANUP(sail_alloc_hash_map(&load_options_local->tuning),
-                        /* cleanup */ sail_destroy_load_options(load_options_local));
-
-    SAIL_TRY_OR_CLEANUP(utils_private::cpp_tuning_to_sail_tuning(d->tuning, load_options_local->tuning),
-                        /* cleanup */ sail_destroy_load_options(load_options_local));
-
-    *load_options = load_options_local;
+    SAIL_TRY(d->sync_tuning());
+    SAIL_TRY(sail_share_load_options(d->sail_load_options, load_options));
 
     return SAIL_OK;
 }
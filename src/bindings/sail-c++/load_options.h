@@ -26,10 +26,14 @@
 #ifndef SAIL_LOAD_OPTIONS_CPP_H
 #define SAIL_LOAD_OPTIONS_CPP_H
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+#include <sail-common/common.h>
 #include <sail-common/export.h>
+#include <sail-common/load_options.h>
 #include <sail-common/status.h>
 
 #include <sail-c++/tuning.h>
@@ -116,16 +120,89 @@ public:
      */
     const sail::tuning& tuning() const;
 
+    /*
+     * Returns the or-ed SAIL_META_DATA_KEY_BIT() bits of the meta data keys to load.
+     * 0 means all keys. See sail_load_options.meta_data_keys.
+     */
+    std::uint64_t meta_data_keys() const;
+
+    /*
+     * Returns the alignment of every row of pixels in bytes. 0 means tightly packed rows.
+     */
+    unsigned row_alignment() const;
+
+    /*
+     * Returns the alignment of the pixels buffer in bytes. 0 means no specific alignment.
+     */
+    unsigned pixels_alignment() const;
+
+    /*
+     * Returns the minimum size of the pixels buffer in bytes to allocate it in file-backed memory.
+     * 0 means pixels are never file-backed. See sail_load_options.file_backed_pixels_threshold.
+     */
+    std::size_t file_backed_pixels_threshold() const;
+
+    /*
+     * Returns the hint to load images at a reduced resolution. See sail_load_options.scale_denominator.
+     */
+    unsigned scale_denominator() const;
+
+    /*
+     * Returns the pixel format to decode frames into. See sail_load_options.output_pixel_format.
+     */
+    SailPixelFormat output_pixel_format() const;
+
     /*
      * Sets new or-ed manipulation options for loading operations. See SailOption.
      */
     void set_options(int options);
 
+    /*
+     * Sets new or-ed SAIL_META_DATA_KEY_BIT() bits of the meta data keys to load with SAIL_OPTION_META_DATA.
+     * 0 means all keys. See sail_load_options.meta_data_keys.
+     */
+    void set_meta_data_keys(std::uint64_t meta_data_keys);
+
+    /*
+     * Sets a new alignment of every row of pixels in bytes. Must be 0 or a power of two.
+     * See sail_load_options.row_alignment.
+     */
+    void set_row_alignment(unsigned row_alignment);
+
+    /*
+     * Sets a new alignment of the pixels buffer in bytes. Must be 0 or a power of two.
+     * See sail_load_options.pixels_alignment.
+     */
+    void set_pixels_alignment(unsigned pixels_alignment);
+
+    /*
+     * Sets a new minimum size of the pixels buffer in bytes to allocate it in file-backed memory.
+     * See sail_load_options.file_backed_pixels_threshold.
+     */
+    void set_file_backed_pixels_threshold(std::size_t file_backed_pixels_threshold);
+
+    /*
+     * Sets a new hint to load images at a reduced resolution, for example, 8 to load JPEG thumbnails
+     * 8 times faster. See sail_load_options.scale_denominator.
+     */
+    void set_scale_denominator(unsigned scale_denominator);
+
+    /*
+     * Sets a new pixel format to decode frames into. image_input converts frames into it
+     * when the codec cannot decode into it natively. See sail_load_options.output_pixel_format.
+     */
+    void set_output_pixel_format(SailPixelFormat output_pixel_format);
+
     /*
      * Sets new codec tuning.
      */
     void set_tuning(const sail::tuning &tuning);
 
+    /*
+     * Sets new codec tuning.
+     */
+    void set_tuning(sail::tuning &&tuning) noexcept;
+
 private:
     /*
      * Makes a deep copy of the specified load options and stores the pointer for further use.
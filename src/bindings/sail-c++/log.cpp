@@ -38,6 +38,11 @@ void set_barrier(SailLogLevel max_level)
     sail_set_log_barrier(max_level);
 }
 
+bool is_enabled(SailLogLevel level)
+{
+    return sail_log_is_enabled(level);
+}
+
 }
 
 }
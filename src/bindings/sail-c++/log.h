@@ -47,6 +47,11 @@ namespace log
  */
 SAIL_EXPORT void set_barrier(SailLogLevel max_level);
 
+/*
+ * Returns true if the messages of the specified log level pass the log barrier.
+ */
+SAIL_EXPORT bool is_enabled(SailLogLevel level);
+
 }
 
 }
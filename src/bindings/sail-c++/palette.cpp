@@ -174,8 +174,8 @@ sail_status_t palette::copy(SailPixelFormat pixel_format, const void *data, unsi
 
     const unsigned palette_size = sail_bytes_per_line(color_count, pixel_format);
 
-    d->data.resize(palette_size);
-    memcpy(d->data.data(), data, palette_size);
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    d->data.assign(bytes, bytes + palette_size);
 
     d->sail_palette->pixel_format = pixel_format;
     d->sail_palette->color_count  = color_count;
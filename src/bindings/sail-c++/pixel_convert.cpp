@@ -0,0 +1,98 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <limits>
+
+#include <sail/sail.h>
+
+#include <sail-manip/sail-manip.h>
+
+#include <sail-c++/sail-c++.h>
+
+namespace sail
+{
+
+sail_status_t convert(const void *input_pixels, SailPixelFormat input_pixel_format, std::size_t input_bytes_per_line,
+                      void *output_pixels, SailPixelFormat output_pixel_format, std::size_t output_bytes_per_line,
+                      unsigned width, unsigned height)
+{
+    SAIL_CHECK_PTR(input_pixels);
+    SAIL_CHECK_PTR(output_pixels);
+
+    if (width == 0 || height == 0) {
+        SAIL_LOG_ERROR("Cannot convert %ux%u pixels", width, height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (input_bytes_per_line > std::numeric_limits<unsigned>::max() || output_bytes_per_line > std::numeric_limits<unsigned>::max()) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (input_bytes_per_line < sail_bytes_per_line(width, input_pixel_format)
+            || output_bytes_per_line < sail_bytes_per_line(width, output_pixel_format)) {
+        SAIL_LOG_ERROR("Bytes per line are too small for %u pixels", width);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    sail_conversion_plan *plan = nullptr;
+    sail_image *image          = nullptr;
+    sail_image *image_output   = nullptr;
+
+    SAIL_AT_SCOPE_EXIT(
+        // Pixels are borrowed
+        if (image != nullptr) {
+            image->pixels = nullptr;
+        }
+        if (image_output != nullptr) {
+            image_output->pixels = nullptr;
+        }
+
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+        sail_destroy_conversion_plan(plan);
+    );
+
+    SAIL_TRY(sail_create_conversion_plan(input_pixel_format, output_pixel_format, nullptr, &plan));
+
+    SAIL_TRY(sail_alloc_image(&image));
+    image->pixels         = const_cast<void *>(input_pixels);
+    image->width          = width;
+    image->height         = height;
+    image->bytes_per_line = static_cast<unsigned>(input_bytes_per_line);
+    image->pixel_format   = input_pixel_format;
+
+    SAIL_TRY(sail_alloc_image(&image_output));
+    image_output->pixels         = output_pixels;
+    image_output->width          = width;
+    image_output->height         = height;
+    image_output->bytes_per_line = static_cast<unsigned>(output_bytes_per_line);
+    image_output->pixel_format   = output_pixel_format;
+
+    SAIL_TRY(sail_execute_conversion_plan(plan, image, image_output));
+
+    return SAIL_OK;
+}
+
+}
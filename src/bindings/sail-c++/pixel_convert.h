@@ -0,0 +1,199 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_PIXEL_CONVERT_CPP_H
+#define SAIL_PIXEL_CONVERT_CPP_H
+
+#include <cstddef> /* std::size_t */
+#include <cstdint>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/pixel.h>
+#include <sail-common/status.h>
+
+#include <sail-c++/pixel_view.h>
+
+namespace sail
+{
+
+/*
+ * Compile-time description of a pixel format: the pixel type, the component type,
+ * and the component indices. An index is -1 if the component doesn't exist.
+ * Only the RGB family formats with 8-bit and 16-bit components are described.
+ */
+template<SailPixelFormat PixelFormat>
+struct pixel_format_traits;
+
+template<typename Type, typename Component, int R, int G, int B, int A, int X>
+struct pixel_format_traits_base
+{
+    using type      = Type;
+    using component = Component;
+
+    static constexpr int r = R;
+    static constexpr int g = G;
+    static constexpr int b = B;
+    static constexpr int a = A;
+    static constexpr int x = X;
+};
+
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP24_RGB>  : pixel_format_traits_base<sail_rgb24_t,  std::uint8_t,  0, 1, 2, -1, -1> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP24_BGR>  : pixel_format_traits_base<sail_bgr24_t,  std::uint8_t,  2, 1, 0, -1, -1> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP48_RGB>  : pixel_format_traits_base<sail_rgb48_t,  std::uint16_t, 0, 1, 2, -1, -1> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP48_BGR>  : pixel_format_traits_base<sail_bgr48_t,  std::uint16_t, 2, 1, 0, -1, -1> {};
+
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP32_RGBX> : pixel_format_traits_base<sail_rgbx32_t, std::uint8_t,  0, 1, 2, -1,  3> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP32_BGRX> : pixel_format_traits_base<sail_bgrx32_t, std::uint8_t,  2, 1, 0, -1,  3> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP32_XRGB> : pixel_format_traits_base<sail_xrgb32_t, std::uint8_t,  1, 2, 3, -1,  0> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP32_XBGR> : pixel_format_traits_base<sail_xbgr32_t, std::uint8_t,  3, 2, 1, -1,  0> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP32_RGBA> : pixel_format_traits_base<sail_rgba32_t, std::uint8_t,  0, 1, 2,  3, -1> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP32_BGRA> : pixel_format_traits_base<sail_bgra32_t, std::uint8_t,  2, 1, 0,  3, -1> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP32_ARGB> : pixel_format_traits_base<sail_argb32_t, std::uint8_t,  1, 2, 3,  0, -1> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP32_ABGR> : pixel_format_traits_base<sail_abgr32_t, std::uint8_t,  3, 2, 1,  0, -1> {};
+
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP64_RGBX> : pixel_format_traits_base<sail_rgbx64_t, std::uint16_t, 0, 1, 2, -1,  3> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP64_BGRX> : pixel_format_traits_base<sail_bgrx64_t, std::uint16_t, 2, 1, 0, -1,  3> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP64_XRGB> : pixel_format_traits_base<sail_xrgb64_t, std::uint16_t, 1, 2, 3, -1,  0> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP64_XBGR> : pixel_format_traits_base<sail_xbgr64_t, std::uint16_t, 3, 2, 1, -1,  0> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP64_RGBA> : pixel_format_traits_base<sail_rgba64_t, std::uint16_t, 0, 1, 2,  3, -1> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP64_BGRA> : pixel_format_traits_base<sail_bgra64_t, std::uint16_t, 2, 1, 0,  3, -1> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP64_ARGB> : pixel_format_traits_base<sail_argb64_t, std::uint16_t, 1, 2, 3,  0, -1> {};
+template<> struct pixel_format_traits<SAIL_PIXEL_FORMAT_BPP64_ABGR> : pixel_format_traits_base<sail_abgr64_t, std::uint16_t, 3, 2, 1,  0, -1> {};
+
+namespace pixel_convert_private
+{
+
+// Same rounding as sail-manip
+inline std::uint8_t  convert_component(std::uint8_t  v, std::uint8_t)  { return v; }
+inline std::uint16_t convert_component(std::uint8_t  v, std::uint16_t) { return static_cast<std::uint16_t>(v * 257); }
+inline std::uint8_t  convert_component(std::uint16_t v, std::uint8_t)  { return static_cast<std::uint8_t>((static_cast<std::uint32_t>(v) * 255 + 32895) >> 16); }
+inline std::uint16_t convert_component(std::uint16_t v, std::uint16_t) { return v; }
+
+template<typename From, typename To>
+inline void convert_row(const typename From::type *input, typename To::type *output, unsigned width)
+{
+    using input_component  = typename From::component;
+    using output_component = typename To::component;
+
+    constexpr unsigned input_components  = sizeof(typename From::type) / sizeof(input_component);
+    constexpr unsigned output_components = sizeof(typename To::type) / sizeof(output_component);
+
+    constexpr output_component max_value = static_cast<output_component>(~output_component(0));
+
+    const input_component *in = reinterpret_cast<const input_component *>(input);
+    output_component *out     = reinterpret_cast<output_component *>(output);
+
+    // The indices are compile-time constants, so the loop has no branches per pixel
+    for (unsigned i = 0; i < width; i++, in += input_components, out += output_components) {
+        out[To::r] = convert_component(in[From::r], output_component());
+        out[To::g] = convert_component(in[From::g], output_component());
+        out[To::b] = convert_component(in[From::b], output_component());
+
+        if (To::a >= 0) {
+            out[To::a >= 0 ? To::a : 0] = (From::a >= 0) ? convert_component(in[From::a >= 0 ? From::a : 0], output_component()) : max_value;
+        }
+        if (To::x >= 0) {
+            out[To::x >= 0 ? To::x : 0] = max_value;
+        }
+    }
+}
+
+}
+
+/*
+ * Converts the pixels of the input view into the pixels of the output view with the pixel formats
+ * known at compile time. The views must have the same dimensions. The conversion is specialized
+ * for every pair of pixel formats, so the inner loop is a fixed shuffle or widening that compilers
+ * vectorize. Drops the input alpha channel if the output alpha channel doesn't exist. Fills
+ * the output alpha and X channels with the maximum value if the input alpha channel doesn't exist.
+ * The results match sail_convert_image() without options.
+ *
+ * Only the RGB family formats from pixel_format_traits are supported. Other formats fail to compile.
+ * Use the runtime convert() below for them.
+ *
+ * For example:
+ *
+ *     sail::convert<SAIL_PIXEL_FORMAT_BPP32_BGRA, SAIL_PIXEL_FORMAT_BPP24_RGB>(
+ *         source.view<sail_bgra32_t>(), target.view<sail_rgb24_t>());
+ *
+ * Returns SAIL_OK on success.
+ */
+template<SailPixelFormat From, SailPixelFormat To>
+sail_status_t convert(pixel_view<const typename pixel_format_traits<From>::type> input,
+                      pixel_view<typename pixel_format_traits<To>::type> output)
+{
+    if (!input.is_valid() || !output.is_valid()) {
+        return SAIL_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (input.width() != output.width() || input.height() != output.height()) {
+        return SAIL_ERROR_INVALID_ARGUMENT;
+    }
+
+    for (unsigned y = 0; y < input.height(); y++) {
+        pixel_convert_private::convert_row<pixel_format_traits<From>, pixel_format_traits<To>>(input[y].data(), output[y].data(), input.width());
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Converts the pixels between the pixel formats known at runtime only with sail-manip. Supports
+ * the same pixel formats as sail_convert_image(). The pixel buffers must have the same dimensions
+ * and must not overlap.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t convert(const void *input_pixels, SailPixelFormat input_pixel_format, std::size_t input_bytes_per_line,
+                                  void *output_pixels, SailPixelFormat output_pixel_format, std::size_t output_bytes_per_line,
+                                  unsigned width, unsigned height);
+
+/*
+ * Converts the pixels of the typed views between the pixel formats known at runtime only.
+ * See the untyped convert() above.
+ *
+ * Returns SAIL_OK on success.
+ */
+template<typename InputType, typename OutputType>
+sail_status_t convert(pixel_view<const InputType> input, SailPixelFormat input_pixel_format,
+                      pixel_view<OutputType> output, SailPixelFormat output_pixel_format)
+{
+    if (!input.is_valid() || !output.is_valid()) {
+        return SAIL_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (input.width() != output.width() || input.height() != output.height()) {
+        return SAIL_ERROR_INVALID_ARGUMENT;
+    }
+
+    return convert(input[0].data(), input_pixel_format, input.bytes_per_line(),
+                   output[0].data(), output_pixel_format, output.bytes_per_line(),
+                   input.width(), input.height());
+}
+
+}
+
+#endif
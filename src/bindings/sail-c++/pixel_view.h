@@ -0,0 +1,182 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_PIXEL_VIEW_CPP_H
+#define SAIL_PIXEL_VIEW_CPP_H
+
+#include <cstddef> /* std::size_t */
+#include <type_traits>
+
+namespace sail
+{
+
+/*
+ * Typed view of image pixels organized row by row with the specified bytes per line.
+ * The view doesn't own the pixels and has no runtime dispatch on the pixel format,
+ * so loops over rows and pixels are compiled for the pixel type T only:
+ *
+ *     for (sail::pixel_view<sail_rgba32_t>::row row : image.view<sail_rgba32_t>()) {
+ *         for (sail_rgba32_t &pixel : row) {
+ *             pixel.component4 = 255;
+ *         }
+ *     }
+ *
+ * T is typically one of the pixel types from sail-common/pixel.h, or its const variant
+ * for read-only access.
+ */
+template<typename T>
+class pixel_view
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Pixel type must be trivially copyable");
+
+public:
+    /*
+     * Contiguous pixels of a single row.
+     */
+    class row
+    {
+    public:
+        row(T *data, unsigned width) noexcept
+            : m_data(data)
+            , m_width(width)
+        {
+        }
+
+        T* data() const noexcept { return m_data; }
+        unsigned size() const noexcept { return m_width; }
+
+        T* begin() const noexcept { return m_data; }
+        T* end() const noexcept { return m_data + m_width; }
+
+        T& operator[](unsigned x) const noexcept { return m_data[x]; }
+
+    private:
+        T *m_data;
+        unsigned m_width;
+    };
+
+    /*
+     * Forward iterator over the rows.
+     */
+    class iterator
+    {
+    public:
+        iterator(const pixel_view *view, unsigned y) noexcept
+            : m_view(view)
+            , m_y(y)
+        {
+        }
+
+        row operator*() const noexcept { return (*m_view)[m_y]; }
+
+        iterator& operator++() noexcept { ++m_y; return *this; }
+
+        bool operator==(const iterator &other) const noexcept { return m_y == other.m_y; }
+        bool operator!=(const iterator &other) const noexcept { return m_y != other.m_y; }
+
+    private:
+        const pixel_view *m_view;
+        unsigned m_y;
+    };
+
+    /*
+     * Constructs an invalid view.
+     */
+    pixel_view() noexcept
+        : pixel_view(nullptr, 0, 0, 0)
+    {
+    }
+
+    /*
+     * Constructs a new view of the pixels. The pixels must be aligned for the type T,
+     * and bytes_per_line must be a multiple of the T alignment.
+     */
+    pixel_view(T *pixels, unsigned width, unsigned height, std::size_t bytes_per_line) noexcept
+        : m_pixels(pixels)
+        , m_width(width)
+        , m_height(height)
+        , m_bytes_per_line(bytes_per_line)
+    {
+    }
+
+    /*
+     * Converts a view to a read-only view.
+     */
+    operator pixel_view<const T>() const noexcept
+    {
+        return pixel_view<const T>(m_pixels, m_width, m_height, m_bytes_per_line);
+    }
+
+    /*
+     * Returns true if the view has pixels.
+     */
+    bool is_valid() const noexcept { return m_pixels != nullptr && m_width > 0 && m_height > 0; }
+
+    unsigned width() const noexcept { return m_width; }
+    unsigned height() const noexcept { return m_height; }
+    std::size_t bytes_per_line() const noexcept { return m_bytes_per_line; }
+
+    /*
+     * Returns the row with index y.
+     */
+    row operator[](unsigned y) const noexcept
+    {
+        using byte = typename std::conditional<std::is_const<T>::value, const unsigned char, unsigned char>::type;
+
+        return row(reinterpret_cast<T *>(reinterpret_cast<byte *>(m_pixels) + y * m_bytes_per_line), m_width);
+    }
+
+    /*
+     * Returns the pixel at the specified position.
+     */
+    T& at(unsigned x, unsigned y) const noexcept { return (*this)[y][x]; }
+
+    iterator begin() const noexcept { return iterator(this, 0); }
+    iterator end() const noexcept { return iterator(this, m_height); }
+
+    /*
+     * Returns a view of the specified rectangle sharing the pixels with this view.
+     * Returns an invalid view if the rectangle doesn't lie within this view.
+     */
+    pixel_view subview(unsigned x, unsigned y, unsigned width, unsigned height) const noexcept
+    {
+        if (!is_valid() || width == 0 || height == 0 || x >= m_width || y >= m_height
+                || width > m_width - x || height > m_height - y) {
+            return pixel_view();
+        }
+
+        return pixel_view((*this)[y].data() + x, width, height, m_bytes_per_line);
+    }
+
+private:
+    T *m_pixels;
+    unsigned m_width;
+    unsigned m_height;
+    std::size_t m_bytes_per_line;
+};
+
+}
+
+#endif
@@ -37,6 +37,7 @@
 
 #ifdef SAIL_BUILD
     #include <sail-c++/abstract_io_adapter.h>
+    #include <sail-c++/image_view_private.h>
     #include <sail-c++/io_base_private.h>
     #include <sail-c++/utils_private.h>
 #endif
@@ -48,8 +49,10 @@
 #include <sail-c++/compression_level.h>
 #include <sail-c++/context.h>
 #include <sail-c++/conversion_options.h>
+#include <sail-c++/frame_range.h>
 #include <sail-c++/iccp.h>
 #include <sail-c++/image.h>
+#include <sail-c++/image_cache.h>
 #include <sail-c++/image_input.h>
 #include <sail-c++/image_output.h>
 #include <sail-c++/io_base.h>
@@ -61,6 +64,8 @@
 #include <sail-c++/meta_data.h>
 #include <sail-c++/ostream.h>
 #include <sail-c++/palette.h>
+#include <sail-c++/pixel_convert.h>
+#include <sail-c++/pixel_view.h>
 #include <sail-c++/resolution.h>
 #include <sail-c++/save_features.h>
 #include <sail-c++/save_options.h>
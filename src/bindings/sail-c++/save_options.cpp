@@ -47,8 +47,45 @@ public:
         sail_destroy_save_options(sail_save_options);
     }
 
+    /*
+     * Returns the C save options safe to modify. They're shared with copies of this object
+     * and with saving operations, so detach them first.
+     */
+    struct sail_save_options* writable_sail_save_options()
+    {
+        SAIL_TRY_OR_EXECUTE(sail_detach_save_options(&sail_save_options),
+                            /* on error */ throw std::bad_alloc());
+
+        return sail_save_options;
+    }
+
+    /* Converts the tuning into the C save options if it has changed since the last conversion. */
+    sail_status_t sync_tuning()
+    {
+        if (tuning == synced_tuning) {
+            return SAIL_OK;
+        }
+
+        SAIL_TRY(sail_detach_save_options(&sail_save_options));
+
+        sail_destroy_hash_map(sail_save_options->tuning);
+        sail_save_options->tuning = nullptr;
+        synced_tuning.clear();
+
+        if (!tuning.empty()) {
+            SAIL_TRY(sail_alloc_hash_map(&sail_save_options->tuning));
+            SAIL_TRY(utils_private::cpp_tuning_to_sail_tuning(tuning, sail_save_options->tuning));
+        }
+
+        synced_tuning = tuning;
+
+        return SAIL_OK;
+    }
+
     struct sail_save_options *sail_save_options;
     sail::tuning tuning;
+    /* The tuning stored in sail_save_options. */
+    sail::tuning synced_tuning;
 };
 
 save_options::save_options()
@@ -70,10 +107,19 @@ save_options::save_options(const save_options &wo)
 
 save_options& save_options::operator=(const sail::save_options &save_options)
 {
-    set_options(save_options.options());
-    set_compression(save_options.compression());
-    set_compression_level(save_options.compression_level());
-    set_tuning(save_options.tuning());
+    if (this == &save_options) {
+        return *this;
+    }
+
+    struct sail_save_options *sail_save_options;
+    SAIL_TRY_OR_EXECUTE(sail_share_save_options(save_options.d->sail_save_options, &sail_save_options),
+                        /* on error */ throw std::bad_alloc());
+
+    sail_destroy_save_options(d->sail_save_options);
+
+    d->sail_save_options = sail_save_options;
+    d->tuning            = save_options.d->tuning;
+    d->synced_tuning     = save_options.d->synced_tuning;
 
     return *this;
 }
@@ -109,6 +155,16 @@ double save_options::compression_level() const
     return d->sail_save_options->compression_level;
 }
 
+size_t save_options::target_size() const
+{
+    return d->sail_save_options->target_size;
+}
+
+double save_options::target_quality() const
+{
+    return d->sail_save_options->target_quality;
+}
+
 sail::tuning& save_options::tuning()
 {
     return d->tuning;
@@ -121,17 +177,27 @@ const sail::tuning& save_options::tuning() const
 
 void save_options::set_options(int options)
 {
-    d->sail_save_options->options = options;
+    d->writable_sail_save_options()->options = options;
 }
 
 void save_options::set_compression(SailCompression compression)
 {
-    d->sail_save_options->compression = compression;
+    d->writable_sail_save_options()->compression = compression;
 }
 
 void save_options::set_compression_level(double compression_level)
 {
-    d->sail_save_options->compression_level = compression_level;
+    d->writable_sail_save_options()->compression_level = compression_level;
+}
+
+void save_options::set_target_size(size_t target_size)
+{
+    d->writable_sail_save_options()->target_size = target_size;
+}
+
+void save_options::set_target_quality(double target_quality)
+{
+    d->writable_sail_save_options()->target_quality = target_quality;
 }
 
 void save_options::set_tuning(const sail::tuning &tuning)
@@ -139,6 +205,11 @@ void save_options::set_tuning(const sail::tuning &tuning)
     d->tuning = tuning;
 }
 
+void save_options::set_tuning(sail::tuning &&tuning) noexcept
+{
+    d->tuning = std::move(tuning);
+}
+
 save_options::save_options(const sail_save_options *wo)
     : save_options()
 {
@@ -150,6 +221,8 @@ save_options::save_options(const sail_save_options *wo)
     set_options(wo->options);
     set_compression(wo->compression);
     set_compression_level(wo->compression_level);
+    set_target_size(wo->target_size);
+    set_target_quality(wo->target_quality);
     set_tuning(utils_private::c_tuning_to_cpp_tuning(wo->tuning));
 }
 
@@ -157,21 +230,8 @@ sail_status_t save_options::to_sail_save_options(sail_save_options **save_option
 {
     SAIL_CHECK_PTR(save_options);
 
-    sail_save_options *save_options_local;
-
-    SAIL_TRY(sail_alloc_save_options(&save_options_local));
-
-    save_options_local->options           = d->sail_save_options->options;
-    save_options_local->compression       = d->sail_save_options->compression;
-    save_options_local->compression_level = d->sail_save_options->compression_level;
-
-    SAIL_TRY_OR_CLEANUP(sail_alloc_hash_map(&save_options_local->tuning),
-                        /* cleanup */ sail_destroy_save_options(save_options_local));
-
-    SAIL_TRY_OR_CLEANUP(utils_private::cpp_tuning_to_sail_tuning(d->tuning, save_options_local->tuning),
-                        /* cleanup */ sail_destroy_save_options(save_options_local));
-
-    *save_options = save_options_local;
+    SAIL_TRY(d->sync_tuning());
+    SAIL_TRY(sail_share_save_options(d->sail_save_options, save_options));
 
     return SAIL_OK;
 }
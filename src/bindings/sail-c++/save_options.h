@@ -26,6 +26,7 @@
 #ifndef SAIL_SAVE_OPTIONS_CPP_H
 #define SAIL_SAVE_OPTIONS_CPP_H
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -110,6 +111,18 @@ public:
      */
     double compression_level() const;
 
+    /*
+     * Returns the maximum size of the encoded frame in bytes, or 0 if it's not limited.
+     * See sail_save_options.target_size.
+     */
+    size_t target_size() const;
+
+    /*
+     * Returns the minimum quality of the encoded frame as PSNR in dB, or 0 if it's not requested.
+     * See sail_save_options.target_quality.
+     */
+    double target_quality() const;
+
     /*
      * Returns modifiable codec tuning.
      */
@@ -135,11 +148,26 @@ public:
      */
     void set_compression_level(double compression_level);
 
+    /*
+     * Sets a new maximum size of the encoded frame in bytes. 0 disables the limit.
+     */
+    void set_target_size(size_t target_size);
+
+    /*
+     * Sets a new minimum quality of the encoded frame as PSNR in dB. 0 disables the target.
+     */
+    void set_target_quality(double target_quality);
+
     /*
      * Sets a new codec tuning.
      */
     void set_tuning(const sail::tuning &tuning);
 
+    /*
+     * Sets new codec tuning.
+     */
+    void set_tuning(sail::tuning &&tuning) noexcept;
+
 private:
     /*
      * Makes a deep copy of the specified save options and stores the pointer for further use.
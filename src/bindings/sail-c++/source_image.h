@@ -46,6 +46,7 @@ namespace sail
 class SAIL_EXPORT source_image
 {
     friend class image;
+    friend class image_view_private;
 
 public:
     /*
@@ -231,6 +231,22 @@ SAIL_EXPORT void variant::set_value<>(const sail::arbitrary_data &value)
     d->v_arbitrary_data = value;
 }
 
+void variant::set_value(std::string &&value) noexcept
+{
+    d->destroy_value();
+
+    d->type = SAIL_VARIANT_TYPE_STRING;
+    new (&d->v_string) std::string(std::move(value));
+}
+
+void variant::set_value(sail::arbitrary_data &&value) noexcept
+{
+    d->destroy_value();
+
+    d->type = SAIL_VARIANT_TYPE_DATA;
+    new (&d->v_arbitrary_data) arbitrary_data(std::move(value));
+}
+
 template<typename T>
 variant::variant(const T &value)
     : variant()
@@ -238,6 +254,18 @@ variant::variant(const T &value)
     set_value(value);
 }
 
+variant::variant(std::string &&value)
+    : variant()
+{
+    set_value(std::move(value));
+}
+
+variant::variant(sail::arbitrary_data &&value)
+    : variant()
+{
+    set_value(std::move(value));
+}
+
 void variant::clear()
 {
     d->destroy_value();
@@ -290,12 +318,18 @@ SAIL_EXPORT variant::variant(const sail_variant_type_workaround_alias_const &var
         case SAIL_VARIANT_TYPE_UNSIGNED_LONG:  set_value(sail_variant_to_unsigned_long(variant));       break;
         case SAIL_VARIANT_TYPE_FLOAT:          set_value(sail_variant_to_float(variant));               break;
         case SAIL_VARIANT_TYPE_DOUBLE:         set_value(sail_variant_to_double(variant));              break;
-        case SAIL_VARIANT_TYPE_STRING:         set_value(std::string(sail_variant_to_string(variant))); break;
+        // Construct strings and data in place to copy the payload only once
+        case SAIL_VARIANT_TYPE_STRING: {
+            d->destroy_value();
+            d->type = SAIL_VARIANT_TYPE_STRING;
+            new (&d->v_string) std::string(sail_variant_to_string(variant));
+            break;
+        }
         case SAIL_VARIANT_TYPE_DATA: {
-            const void *data = sail_variant_to_data(variant);
-            sail::arbitrary_data arbitrary_data(variant->size);
-            memcpy(arbitrary_data.data(), data, variant->size);
-            set_value(arbitrary_data);
+            const unsigned char *data = static_cast<const unsigned char *>(sail_variant_to_data(variant));
+            d->destroy_value();
+            d->type = SAIL_VARIANT_TYPE_DATA;
+            new (&d->v_arbitrary_data) arbitrary_data(data, data + variant->size);
             break;
         }
         case SAIL_VARIANT_TYPE_INVALID: break;
@@ -510,6 +544,40 @@ sail_status_t variant::to_sail_variant(sail_variant **variant) const
     return SAIL_OK;
 }
 
+void variant::to_sail_variant_view(sail_variant *variant) const
+{
+    variant->type = d->type;
+
+    switch (d->type) {
+        case SAIL_VARIANT_TYPE_BOOL:           variant->value = &d->v_bool;           variant->size = sizeof(d->v_bool);           break;
+        case SAIL_VARIANT_TYPE_CHAR:           variant->value = &d->v_char;           variant->size = sizeof(d->v_char);           break;
+        case SAIL_VARIANT_TYPE_UNSIGNED_CHAR:  variant->value = &d->v_unsigned_char;  variant->size = sizeof(d->v_unsigned_char);  break;
+        case SAIL_VARIANT_TYPE_SHORT:          variant->value = &d->v_short;          variant->size = sizeof(d->v_short);          break;
+        case SAIL_VARIANT_TYPE_UNSIGNED_SHORT: variant->value = &d->v_unsigned_short; variant->size = sizeof(d->v_unsigned_short); break;
+        case SAIL_VARIANT_TYPE_INT:            variant->value = &d->v_int;            variant->size = sizeof(d->v_int);            break;
+        case SAIL_VARIANT_TYPE_UNSIGNED_INT:   variant->value = &d->v_unsigned_int;   variant->size = sizeof(d->v_unsigned_int);   break;
+        case SAIL_VARIANT_TYPE_LONG:           variant->value = &d->v_long;           variant->size = sizeof(d->v_long);           break;
+        case SAIL_VARIANT_TYPE_UNSIGNED_LONG:  variant->value = &d->v_unsigned_long;  variant->size = sizeof(d->v_unsigned_long);  break;
+        case SAIL_VARIANT_TYPE_FLOAT:          variant->value = &d->v_float;          variant->size = sizeof(d->v_float);          break;
+        case SAIL_VARIANT_TYPE_DOUBLE:         variant->value = &d->v_double;         variant->size = sizeof(d->v_double);         break;
+        case SAIL_VARIANT_TYPE_STRING: {
+            variant->value = const_cast<char *>(d->v_string.c_str());
+            variant->size  = d->v_string.size() + 1;
+            break;
+        }
+        case SAIL_VARIANT_TYPE_DATA: {
+            variant->value = d->v_arbitrary_data.data();
+            variant->size  = d->v_arbitrary_data.size();
+            break;
+        }
+        case SAIL_VARIANT_TYPE_INVALID: {
+            variant->value = nullptr;
+            variant->size  = 0;
+            break;
+        }
+    }
+}
+
 bool operator==(const sail::variant &a, const sail::variant &b) {
 
     if (!a.is_valid() || !b.is_valid() || a.d->type != b.d->type) {
@@ -27,6 +27,7 @@
 #define SAIL_VARIANT_CPP_H
 
 #include <memory>
+#include <string>
 
 #include <sail-common/export.h>
 #include <sail-common/status.h>
@@ -56,6 +57,7 @@ namespace sail
  */
 class SAIL_EXPORT variant
 {
+    friend class image_view_private;
     friend class meta_data;
     friend class utils_private;
     friend SAIL_EXPORT bool operator==(const sail::variant &a, const sail::variant &b);
@@ -72,6 +74,16 @@ public:
     template<typename T>
     variant(const T &value);
 
+    /*
+     * Constructs a new variant from the string. The string is moved.
+     */
+    variant(std::string &&value);
+
+    /*
+     * Constructs a new variant from the data. The data is moved.
+     */
+    variant(sail::arbitrary_data &&value);
+
     /*
      * Copies the variant.
      */
@@ -121,6 +133,16 @@ public:
     template<typename T>
     void set_value(const T &value);
 
+    /*
+     * Sets a new string value. The string is moved.
+     */
+    void set_value(std::string &&value) noexcept;
+
+    /*
+     * Sets a new data value. The data is moved.
+     */
+    void set_value(sail::arbitrary_data &&value) noexcept;
+
     /*
      * Resets the variant to the invalid state and deletes the stored value.
      */
@@ -129,6 +151,9 @@ public:
 private:
     sail_status_t to_sail_variant(sail_variant **variant) const;
 
+    // Points the specified variant to the stored value without copying it
+    void to_sail_variant_view(sail_variant *variant) const;
+
     class pimpl;
     std::unique_ptr<pimpl> d;
 };
@@ -27,6 +27,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <avif/avif.h>
 
@@ -35,6 +36,13 @@
 #include "helpers.h"
 #include "io.h"
 
+/*
+ * Quality is (100 - compression level) like in JPEG.
+ */
+static const double COMPRESSION_MIN     = 0;
+static const double COMPRESSION_MAX     = 100;
+static const double COMPRESSION_DEFAULT = 40;
+
 /*
  * Codec-specific state.
  */
@@ -46,6 +54,20 @@ struct avif_state {
     struct avifDecoder *avif_decoder;
     struct avifRGBImage rgb_image;
     struct sail_avif_context avif_context;
+    const void *mapped_data;
+    size_t mapped_size;
+
+    bool frame_probed;
+    bool premultiply_alpha;
+
+    /* Planar pixel format of the current frame to copy the YUV planes into, or SAIL_PIXEL_FORMAT_UNKNOWN. */
+    enum SailPixelFormat planar_pixel_format;
+
+    /* Saving. */
+    struct avifEncoder *avif_encoder;
+    struct avifImage *avif_image;
+    enum avifPixelFormat yuv_format;
+    bool frame_added;
 };
 
 static sail_status_t alloc_avif_state(struct sail_io *io,
@@ -55,24 +77,41 @@ static sail_status_t alloc_avif_state(struct sail_io *io,
 
     void *ptr;
 
-    /* avifIO */
-    SAIL_TRY(sail_malloc(sizeof(struct avifIO), &ptr));
-    struct avifIO *avif_io = ptr;
-
-    *avif_io = (struct avifIO) {
-        .destroy    = NULL,
-        .read       = avif_private_read_proc,
-        .write      = NULL,
-        .sizeHint   = 0,
-        .persistent = AVIF_FALSE,
-        .data       = NULL,
-    };
+    /*
+     * Memory and mmap'ed I/O objects are handed to the libavif memory reader, so it reads the data
+     * in place without calling back into SAIL. The mapped data outlive the decoder.
+     */
+    const void *mapped_data = NULL;
+    size_t mapped_size = 0;
 
-    /* buffer */
+    if (load_options != NULL && (io->features & SAIL_IO_FEATURE_MAPPED) && io->map != NULL) {
+        if (io->map(io->stream, &mapped_data, &mapped_size) != SAIL_OK) {
+            mapped_data = NULL;
+        }
+    }
+
+    struct avifIO *avif_io = NULL;
+    void *buffer = NULL;
     const size_t buffer_size = 8*1024;
-    void *buffer;
-    SAIL_TRY_OR_CLEANUP(sail_malloc(buffer_size, &buffer),
-                        /* on error */ sail_free(avif_io));
+
+    if (load_options != NULL && mapped_data == NULL) {
+        /* avifIO */
+        SAIL_TRY(sail_malloc(sizeof(struct avifIO), &ptr));
+        avif_io = ptr;
+
+        *avif_io = (struct avifIO) {
+            .destroy    = NULL,
+            .read       = avif_private_read_proc,
+            .write      = NULL,
+            .sizeHint   = 0,
+            .persistent = AVIF_FALSE,
+            .data       = NULL,
+        };
+
+        /* buffer */
+        SAIL_TRY_OR_CLEANUP(sail_malloc(buffer_size, &buffer),
+                            /* on error */ sail_free(avif_io));
+    }
 
     /* avif_state */
     SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct avif_state), &ptr),
@@ -83,21 +122,39 @@ static sail_status_t alloc_avif_state(struct sail_io *io,
         .load_options = load_options,
         .save_options = save_options,
         .avif_io      = avif_io,
-        .avif_decoder = avifDecoderCreate(),
+        .avif_decoder = (load_options != NULL) ? avifDecoderCreate() : NULL,
         .avif_context = (struct sail_avif_context) {
             .io          = io,
             .buffer      = buffer,
-            .buffer_size = buffer_size,
-        }
+            .buffer_size = (buffer == NULL) ? 0 : buffer_size,
+        },
+        .mapped_data       = mapped_data,
+        .mapped_size       = mapped_size,
+        .frame_probed      = false,
+        .premultiply_alpha = false,
+
+        .planar_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN,
+
+        .avif_encoder      = NULL,
+        .avif_image        = NULL,
+        .yuv_format        = AVIF_PIXEL_FORMAT_YUV420,
+        .frame_added       = false,
     };
 
+    if ((*avif_state)->avif_decoder == NULL) {
+        return SAIL_OK;
+    }
+
 #if AVIF_VERSION_MAJOR > 0 || AVIF_VERSION_MINOR >= 9
     (*avif_state)->avif_decoder->strictFlags = AVIF_STRICT_DISABLED;
 #endif
 
-    avifDecoderSetIO((*avif_state)->avif_decoder, (*avif_state)->avif_io);
+    /* Mapped data are set up with avifDecoderSetIOMemory() in sail_codec_load_init_v8_avif(). */
+    if (avif_io != NULL) {
+        avifDecoderSetIO((*avif_state)->avif_decoder, (*avif_state)->avif_io);
 
-    (*avif_state)->avif_io->data = &(*avif_state)->avif_context;
+        (*avif_state)->avif_io->data = &(*avif_state)->avif_context;
+    }
 
     return SAIL_OK;
 }
@@ -108,7 +165,17 @@ static void destroy_avif_state(struct avif_state *avif_state) {
         return;
     }
 
-    avifDecoderDestroy(avif_state->avif_decoder);
+    if (avif_state->avif_decoder != NULL) {
+        avifDecoderDestroy(avif_state->avif_decoder);
+    }
+
+    if (avif_state->avif_encoder != NULL) {
+        avifEncoderDestroy(avif_state->avif_encoder);
+    }
+
+    if (avif_state->avif_image != NULL) {
+        avifImageDestroy(avif_state->avif_image);
+    }
 
     sail_free(avif_state->avif_context.buffer);
 
@@ -130,10 +197,37 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_avif(struct sail_io *io, const
     SAIL_TRY(alloc_avif_state(io, load_options, NULL, &avif_state));
     *state = avif_state;
 
-    avif_state->avif_decoder->ignoreExif = avif_state->avif_decoder->ignoreXMP = (avif_state->load_options->options & SAIL_OPTION_META_DATA) == 0;
+    avif_state->avif_decoder->ignoreExif = !sail_load_meta_data_key(avif_state->load_options, SAIL_META_DATA_EXIF);
+    avif_state->avif_decoder->ignoreXMP  = !sail_load_meta_data_key(avif_state->load_options, SAIL_META_DATA_XMP);
+
+    /* Handle tuning. Decode in as many threads as the SAIL thread pool has by default. */
+    struct avif_private_load_tuning load_tuning = {
+        .premultiply_alpha = false,
+        .threads           = sail_thread_pool_size(),
+        .codec_choice      = AVIF_CODEC_CHOICE_AUTO,
+    };
+
+    if (avif_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(avif_state->load_options->tuning, avif_private_tuning_key_value_callback, &load_tuning);
+    }
+
+    avif_state->premultiply_alpha         = load_tuning.premultiply_alpha;
+    avif_state->avif_decoder->maxThreads  = (int)load_tuning.threads;
+    avif_state->avif_decoder->codecChoice = load_tuning.codec_choice;
 
     /* Initialize AVIF. */
-    avifResult avif_result = avifDecoderParse(avif_state->avif_decoder);
+    avifResult avif_result;
+
+    if (avif_state->mapped_data != NULL) {
+        avif_result = avifDecoderSetIOMemory(avif_state->avif_decoder, avif_state->mapped_data, avif_state->mapped_size);
+
+        if (avif_result != AVIF_RESULT_OK) {
+            SAIL_LOG_ERROR("AVIF: %s", avifResultToString(avif_result));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    }
+
+    avif_result = avifDecoderParse(avif_state->avif_decoder);
 
     if (avif_result != AVIF_RESULT_OK) {
         SAIL_LOG_ERROR("AVIF: %s", avifResultToString(avif_result));
@@ -147,37 +241,86 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_avif(void *state, s
 
     struct avif_state *avif_state = state;
 
-    avifResult avif_result = avifDecoderNextImage(avif_state->avif_decoder);
-    if (avif_result == AVIF_RESULT_NO_IMAGES_REMAINING) {
-        return SAIL_ERROR_NO_MORE_FRAMES;
-    }
+    const bool probe = avif_state->load_options->options & SAIL_OPTION_PROBE;
 
-    if (avif_result != AVIF_RESULT_OK) {
-        SAIL_LOG_ERROR("AVIF: %s", avifResultToString(avif_result));
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    if (probe) {
+        /* The image properties are known after parsing, so don't decode the frame. */
+        if (avif_state->frame_probed) {
+            return SAIL_ERROR_NO_MORE_FRAMES;
+        }
+
+        avif_state->frame_probed = true;
+    } else {
+        avifResult avif_result = avifDecoderNextImage(avif_state->avif_decoder);
+        if (avif_result == AVIF_RESULT_NO_IMAGES_REMAINING) {
+            return SAIL_ERROR_NO_MORE_FRAMES;
+        }
+
+        if (avif_result != AVIF_RESULT_OK) {
+            SAIL_LOG_ERROR("AVIF: %s", avifResultToString(avif_result));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
     }
 
     const struct avifImage *avif_image = avif_state->avif_decoder->image;
 
+#if AVIF_VERSION_MAJOR > 0 || AVIF_VERSION_MINOR >= 9
+    const bool has_alpha = probe ? avif_state->avif_decoder->alphaPresent : avif_image->alphaPlane != NULL;
+#else
+    const bool has_alpha = avif_image->alphaPlane != NULL;
+#endif
+
     struct sail_image *image_local;
     SAIL_TRY(sail_alloc_image(&image_local));
 
     avifRGBImageSetDefaults(&avif_state->rgb_image, avif_image);
     avif_state->rgb_image.depth = avif_private_round_depth(avif_state->rgb_image.depth);
 
+#if AVIF_VERSION_MAJOR > 0 || AVIF_VERSION_MINOR >= 9
+    /* libavif premultiplies while converting from YUV, which is cheaper than a separate pass. */
+    avif_state->rgb_image.alphaPremultiplied = (avif_state->premultiply_alpha && has_alpha) ? AVIF_TRUE : AVIF_FALSE;
+    const bool premultiplied = avif_state->rgb_image.alphaPremultiplied;
+#else
+    const bool premultiplied = false;
+#endif
+
     if (avif_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
         SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&image_local->source_image),
                             /* cleanup */ sail_destroy_image(image_local));
 
         image_local->source_image->pixel_format =
-            avif_private_sail_pixel_format(avif_image->yuvFormat, avif_image->depth, avif_image->alphaPlane != NULL);
+            avif_private_sail_pixel_format(avif_image->yuvFormat, avif_image->depth, has_alpha);
         image_local->source_image->chroma_subsampling = avif_private_sail_chroma_subsampling(avif_image->yuvFormat);
         image_local->source_image->compression = SAIL_COMPRESSION_AV1;
     }
 
     image_local->width          = avif_image->width;
     image_local->height         = avif_image->height;
-    image_local->pixel_format   = avif_private_rgb_sail_pixel_format(avif_state->rgb_image.format, avif_state->rgb_image.depth);
+    /* Copy the decoded YUV planes as is instead of converting them into RGB when they match the requested planar pixel format. */
+    avif_state->planar_pixel_format = sail_load_planar_output(avif_state->load_options)
+                                        ? avif_private_planar_pixel_format(avif_image, has_alpha, avif_state->load_options->output_pixel_format)
+                                        : SAIL_PIXEL_FORMAT_UNKNOWN;
+
+    image_local->pixel_format   = (avif_state->planar_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN)
+                                    ? avif_state->planar_pixel_format
+                                    : avif_private_rgb_sail_pixel_format(avif_state->rgb_image.format, avif_state->rgb_image.depth, premultiplied);
+
+#if AVIF_VERSION_MAJOR >= 1
+    /* libavif converts high bit depth samples into the requested half precision pixel format without clamping HDR values. */
+    const enum SailPixelFormat output_pixel_format = avif_state->load_options->output_pixel_format;
+
+    if (avif_state->planar_pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN && avif_image->depth > 8
+            && (output_pixel_format == SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF
+                || (output_pixel_format == SAIL_PIXEL_FORMAT_BPP48_RGB_HALF && !has_alpha))) {
+        avif_state->rgb_image.format             = (output_pixel_format == SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF) ? AVIF_RGB_FORMAT_RGBA : AVIF_RGB_FORMAT_RGB;
+        avif_state->rgb_image.depth              = 16;
+        avif_state->rgb_image.isFloat            = AVIF_TRUE;
+        avif_state->rgb_image.alphaPremultiplied = AVIF_FALSE;
+
+        image_local->pixel_format = output_pixel_format;
+    }
+#endif
+
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
     image_local->delay          = (int)(avif_state->avif_decoder->imageTiming.duration * 1000);
 
@@ -210,11 +353,52 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_avif(void *state, s
     return SAIL_OK;
 }
 
+/* Copies the 8-bit YUV planes of the decoded frame into the image planes. */
+static sail_status_t copy_yuv_planes(const struct avifImage *avif_image, const struct sail_image *image) {
+
+    void *planes[4];
+    unsigned strides[4];
+    unsigned planes_count;
+    SAIL_TRY(sail_image_planes(image, planes, strides, &planes_count));
+
+    const bool subsampled        = image->pixel_format != SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444;
+    const unsigned chroma_width  = subsampled ? image->width / 2 : image->width;
+    const unsigned chroma_height = subsampled ? image->height / 2 : image->height;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        memcpy((uint8_t *)planes[0] + (size_t)row * strides[0],
+               avif_image->yuvPlanes[AVIF_CHAN_Y] + (size_t)row * avif_image->yuvRowBytes[AVIF_CHAN_Y], image->width);
+    }
+
+    for (unsigned row = 0; row < chroma_height; row++) {
+        const uint8_t *u = avif_image->yuvPlanes[AVIF_CHAN_U] + (size_t)row * avif_image->yuvRowBytes[AVIF_CHAN_U];
+        const uint8_t *v = avif_image->yuvPlanes[AVIF_CHAN_V] + (size_t)row * avif_image->yuvRowBytes[AVIF_CHAN_V];
+        uint8_t *cb = (uint8_t *)planes[1] + (size_t)row * strides[1];
+
+        if (image->pixel_format == SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12) {
+            for (unsigned x = 0; x < chroma_width; x++) {
+                cb[x * 2]     = u[x];
+                cb[x * 2 + 1] = v[x];
+            }
+        } else {
+            memcpy(cb, u, chroma_width);
+            memcpy((uint8_t *)planes[2] + (size_t)row * strides[2], v, chroma_width);
+        }
+    }
+
+    return SAIL_OK;
+}
+
 SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_avif(void *state, struct sail_image *image) {
 
     struct avif_state *avif_state = state;
     const struct avifImage *avif_image = avif_state->avif_decoder->image;
 
+    if (avif_state->planar_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
+        SAIL_TRY(copy_yuv_planes(avif_image, image));
+        return SAIL_OK;
+    }
+
     avif_state->rgb_image.pixels = image->pixels;
     avif_state->rgb_image.rowBytes = image->bytes_per_line;
 
@@ -245,32 +429,178 @@ SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_avif(void **state) {
 
 SAIL_EXPORT sail_status_t sail_codec_save_init_v8_avif(struct sail_io *io, const struct sail_save_options *save_options, void **state) {
 
-    (void)io;
-    (void)save_options;
-    (void)state;
+    *state = NULL;
+
+    /* Allocate a new state. */
+    struct avif_state *avif_state;
+    SAIL_TRY(alloc_avif_state(io, NULL, save_options, &avif_state));
+    *state = avif_state;
+
+    if (avif_state->save_options->compression != SAIL_COMPRESSION_AV1) {
+        SAIL_LOG_ERROR("AVIF: Only AV1 compression is allowed for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    avif_state->avif_encoder = avifEncoderCreate();
+
+    if (avif_state->avif_encoder == NULL) {
+        SAIL_LOG_ERROR("AVIF: Failed to create an encoder");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    /* Handle tuning. Encode in as many threads as the SAIL thread pool has by default. */
+    struct avif_private_save_tuning save_tuning = {
+        .speed          = -1,
+        .threads        = sail_thread_pool_size(),
+        .tile_rows_log2 = -1,
+        .tile_cols_log2 = -1,
+        .yuv_format     = AVIF_PIXEL_FORMAT_YUV420,
+    };
+
+    if (avif_state->save_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(avif_state->save_options->tuning, avif_private_save_tuning_key_value_callback, &save_tuning);
+    }
+
+    struct avifEncoder *avif_encoder = avif_state->avif_encoder;
+
+    avif_encoder->maxThreads = (int)save_tuning.threads;
+    avif_encoder->timescale  = 1000;
+
+    if (save_tuning.speed >= 0) {
+        avif_encoder->speed = save_tuning.speed;
+    }
+    if (save_tuning.tile_rows_log2 >= 0) {
+        avif_encoder->tileRowsLog2 = save_tuning.tile_rows_log2;
+    }
+    if (save_tuning.tile_cols_log2 >= 0) {
+        avif_encoder->tileColsLog2 = save_tuning.tile_cols_log2;
+    }
+
+    avif_state->yuv_format = save_tuning.yuv_format;
+
+    /* Compute image quality. */
+    const double compression = (avif_state->save_options->compression_level < COMPRESSION_MIN ||
+                                avif_state->save_options->compression_level > COMPRESSION_MAX)
+                                ? COMPRESSION_DEFAULT
+                                : avif_state->save_options->compression_level;
+
+#if AVIF_VERSION_MAJOR >= 1
+    avif_encoder->quality      = (int)(COMPRESSION_MAX - compression);
+    avif_encoder->qualityAlpha = avif_encoder->quality;
+#else
+    /* Older libavif versions accept quantizers only. */
+    const int quantizer = (int)(compression * AVIF_QUANTIZER_WORST_QUALITY / COMPRESSION_MAX);
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    avif_encoder->minQuantizer      = avif_encoder->maxQuantizer      = quantizer;
+    avif_encoder->minQuantizerAlpha = avif_encoder->maxQuantizerAlpha = quantizer;
+#endif
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_avif(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct avif_state *avif_state = state;
+
+    enum avifRGBFormat rgb_format;
+    uint32_t rgb_depth;
+
+    if (!avif_private_sail_pixel_format_to_rgb_format(image->pixel_format, &rgb_format, &rgb_depth)) {
+        SAIL_LOG_ERROR("AVIF: %s pixel format is not currently supported for saving", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    if (avif_state->avif_image != NULL) {
+        avifImageDestroy(avif_state->avif_image);
+    }
+
+    /* AV1 supports up to 12 bits per sample, so 16-bit pixels are encoded with 12 bits. */
+    avif_state->avif_image = avifImageCreate(image->width, image->height, (rgb_depth == 8) ? 8 : 12, avif_state->yuv_format);
+
+    if (avif_state->avif_image == NULL) {
+        SAIL_LOG_ERROR("AVIF: Failed to create an image");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    /* ICC profiles and meta data are stored once per file, so take them from the first frame. */
+    if (!avif_state->frame_added) {
+        if (avif_state->save_options->options & SAIL_OPTION_ICCP && image->iccp != NULL) {
+            SAIL_TRY(avif_private_write_iccp(image->iccp, avif_state->avif_image));
+        }
+
+        if (avif_state->save_options->options & SAIL_OPTION_META_DATA && image->meta_data_node != NULL) {
+            SAIL_TRY(avif_private_write_meta_data(image->meta_data_node, avif_state->avif_image));
+        }
+    }
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_avif(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct avif_state *avif_state = state;
+
+    enum avifRGBFormat rgb_format;
+    uint32_t rgb_depth;
+    avif_private_sail_pixel_format_to_rgb_format(image->pixel_format, &rgb_format, &rgb_depth);
+
+    /* Convert the rows in place, libavif uses libyuv for that when it's built with it. */
+    struct avifRGBImage rgb_image;
+    avifRGBImageSetDefaults(&rgb_image, avif_state->avif_image);
+
+    rgb_image.format   = rgb_format;
+    rgb_image.depth    = rgb_depth;
+    rgb_image.pixels   = image->pixels;
+    rgb_image.rowBytes = image->bytes_per_line;
+
+    avifResult avif_result = avifImageRGBToYUV(avif_state->avif_image, &rgb_image);
+
+    if (avif_result != AVIF_RESULT_OK) {
+        SAIL_LOG_ERROR("AVIF: %s", avifResultToString(avif_result));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Fall back to 100 ms. when the delay is <= 0. Single frames are saved as still images. */
+    const uint64_t duration = (image->delay <= 0) ? 100 : (uint64_t)image->delay;
+
+    avif_result = avifEncoderAddImage(avif_state->avif_encoder, avif_state->avif_image, duration, AVIF_ADD_IMAGE_FLAG_NONE);
+
+    if (avif_result != AVIF_RESULT_OK) {
+        SAIL_LOG_ERROR("AVIF: %s", avifResultToString(avif_result));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    avif_state->frame_added = true;
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_avif(void **state) {
 
-    (void)state;
+    struct avif_state *avif_state = *state;
+
+    *state = NULL;
+
+    if (avif_state->frame_added) {
+        avifRWData output = AVIF_DATA_EMPTY;
+
+        const avifResult avif_result = avifEncoderFinish(avif_state->avif_encoder, &output);
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+        if (avif_result != AVIF_RESULT_OK) {
+            SAIL_LOG_ERROR("AVIF: %s", avifResultToString(avif_result));
+            avifRWDataFree(&output);
+            destroy_avif_state(avif_state);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        SAIL_TRY_OR_CLEANUP(avif_state->avif_context.io->strict_write(avif_state->avif_context.io->stream, output.data, output.size),
+                            /* cleanup */ avifRWDataFree(&output),
+                                          destroy_avif_state(avif_state));
+
+        avifRWDataFree(&output);
+    }
+
+    destroy_avif_state(avif_state);
+
+    return SAIL_OK;
 }
@@ -23,6 +23,8 @@
     SOFTWARE.
 */
 
+#include <string.h>
+
 #include <sail-common/sail-common.h>
 
 #include "helpers.h"
@@ -67,16 +69,50 @@ enum SailChromaSubsampling avif_private_sail_chroma_subsampling(enum avifPixelFo
     }
 }
 
-enum SailPixelFormat avif_private_rgb_sail_pixel_format(enum avifRGBFormat rgb_pixel_format, uint32_t depth) {
+enum SailPixelFormat avif_private_planar_pixel_format(const struct avifImage *avif_image, bool has_alpha,
+                                                      enum SailPixelFormat pixel_format) {
+
+    if (avif_image->depth != 8 || has_alpha || avif_image->yuvRange != AVIF_RANGE_FULL) {
+        return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+
+    /* libavif decodes unspecified matrix coefficients as BT.601 too. */
+    switch (avif_image->matrixCoefficients) {
+        case AVIF_MATRIX_COEFFICIENTS_BT470BG:
+        case AVIF_MATRIX_COEFFICIENTS_BT601:
+        case AVIF_MATRIX_COEFFICIENTS_UNSPECIFIED: {
+            break;
+        }
+        default: {
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+    }
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420:
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12: {
+            return (avif_image->yuvFormat == AVIF_PIXEL_FORMAT_YUV420 && avif_image->width % 2 == 0 && avif_image->height % 2 == 0)
+                    ? pixel_format : SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444: {
+            return (avif_image->yuvFormat == AVIF_PIXEL_FORMAT_YUV444) ? pixel_format : SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+        default: {
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+    }
+}
+
+enum SailPixelFormat avif_private_rgb_sail_pixel_format(enum avifRGBFormat rgb_pixel_format, uint32_t depth, bool premultiplied) {
 
     switch (depth) {
         case 8: {
             switch (rgb_pixel_format) {
                 case AVIF_RGB_FORMAT_RGB:  return SAIL_PIXEL_FORMAT_BPP24_RGB;
-                case AVIF_RGB_FORMAT_RGBA: return SAIL_PIXEL_FORMAT_BPP32_RGBA;
+                case AVIF_RGB_FORMAT_RGBA: return premultiplied ? SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED : SAIL_PIXEL_FORMAT_BPP32_RGBA;
                 case AVIF_RGB_FORMAT_ARGB: return SAIL_PIXEL_FORMAT_BPP32_ARGB;
                 case AVIF_RGB_FORMAT_BGR:  return SAIL_PIXEL_FORMAT_BPP24_BGR;
-                case AVIF_RGB_FORMAT_BGRA: return SAIL_PIXEL_FORMAT_BPP32_BGRA;
+                case AVIF_RGB_FORMAT_BGRA: return premultiplied ? SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED : SAIL_PIXEL_FORMAT_BPP32_BGRA;
                 case AVIF_RGB_FORMAT_ABGR: return SAIL_PIXEL_FORMAT_BPP32_ABGR;
 
                 default: return SAIL_PIXEL_FORMAT_UNKNOWN;
@@ -85,10 +121,10 @@ enum SailPixelFormat avif_private_rgb_sail_pixel_format(enum avifRGBFormat rgb_p
         case 16: {
             switch (rgb_pixel_format) {
                 case AVIF_RGB_FORMAT_RGB:  return SAIL_PIXEL_FORMAT_BPP48_RGB;
-                case AVIF_RGB_FORMAT_RGBA: return SAIL_PIXEL_FORMAT_BPP64_RGBA;
+                case AVIF_RGB_FORMAT_RGBA: return premultiplied ? SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED : SAIL_PIXEL_FORMAT_BPP64_RGBA;
                 case AVIF_RGB_FORMAT_ARGB: return SAIL_PIXEL_FORMAT_BPP64_ARGB;
                 case AVIF_RGB_FORMAT_BGR:  return SAIL_PIXEL_FORMAT_BPP48_BGR;
-                case AVIF_RGB_FORMAT_BGRA: return SAIL_PIXEL_FORMAT_BPP64_BGRA;
+                case AVIF_RGB_FORMAT_BGRA: return premultiplied ? SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED : SAIL_PIXEL_FORMAT_BPP64_BGRA;
                 case AVIF_RGB_FORMAT_ABGR: return SAIL_PIXEL_FORMAT_BPP64_ABGR;
 
                 default: return SAIL_PIXEL_FORMAT_UNKNOWN;
@@ -141,3 +177,200 @@ sail_status_t avif_private_fetch_meta_data(enum SailMetaData key, const struct a
 
     return SAIL_OK;
 }
+
+bool avif_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    struct avif_private_load_tuning *load_tuning = user_data;
+
+    if (strcmp(key, "avif-premultiply-alpha") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_BOOL) {
+            load_tuning->premultiply_alpha = sail_variant_to_bool(value);
+            SAIL_LOG_TRACE("AVIF: Premultiply alpha: %s", load_tuning->premultiply_alpha ? "yes" : "no");
+        }
+    } else if (strcmp(key, "avif-threads") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned threads = sail_variant_to_unsigned_int(value);
+
+            if (threads > 0) {
+                SAIL_LOG_TRACE("AVIF: Decoding in %u threads", threads);
+                load_tuning->threads = threads;
+            }
+        }
+    } else if (strcmp(key, "avif-codec") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_STRING) {
+            const char *str_value = sail_variant_to_string(value);
+            const avifCodecChoice codec_choice = avifCodecChoiceFromName(str_value);
+
+            /* avifCodecName() returns NULL for codecs libavif is not built with. */
+            if (codec_choice != AVIF_CODEC_CHOICE_AUTO && avifCodecName(codec_choice, AVIF_CODEC_FLAG_CAN_DECODE) != NULL) {
+                SAIL_LOG_TRACE("AVIF: Decoding with %s", str_value);
+                load_tuning->codec_choice = codec_choice;
+            } else {
+                SAIL_LOG_WARNING("AVIF: Decoder '%s' is not available", str_value);
+            }
+        }
+    }
+
+    return true;
+}
+
+static int tile_log2_from_variant(const struct sail_variant *value) {
+
+    if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+        const unsigned tile_log2 = sail_variant_to_unsigned_int(value);
+
+        /* AV1 allows at most 64 tile rows or columns. */
+        if (tile_log2 <= 6) {
+            return (int)tile_log2;
+        }
+
+        SAIL_LOG_WARNING("AVIF: Tiles log2 %u is out of range [0; 6]", tile_log2);
+    }
+
+    return -1;
+}
+
+bool avif_private_save_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    struct avif_private_save_tuning *save_tuning = user_data;
+
+    if (strcmp(key, "avif-speed") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned speed = sail_variant_to_unsigned_int(value);
+
+            if (speed <= AVIF_SPEED_FASTEST) {
+                SAIL_LOG_TRACE("AVIF: Speed: %u", speed);
+                save_tuning->speed = (int)speed;
+            } else {
+                SAIL_LOG_WARNING("AVIF: Speed %u is out of range [%d; %d]", speed, AVIF_SPEED_SLOWEST, AVIF_SPEED_FASTEST);
+            }
+        }
+    } else if (strcmp(key, "avif-threads") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned threads = sail_variant_to_unsigned_int(value);
+
+            if (threads > 0) {
+                SAIL_LOG_TRACE("AVIF: Encoding in %u threads", threads);
+                save_tuning->threads = threads;
+            }
+        }
+    } else if (strcmp(key, "avif-tile-rows-log2") == 0) {
+        save_tuning->tile_rows_log2 = tile_log2_from_variant(value);
+    } else if (strcmp(key, "avif-tile-cols-log2") == 0) {
+        save_tuning->tile_cols_log2 = tile_log2_from_variant(value);
+    } else if (strcmp(key, "avif-chroma-subsampling") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_STRING) {
+            const char *str_value = sail_variant_to_string(value);
+
+            switch (sail_chroma_subsampling_from_string(str_value)) {
+                case SAIL_CHROMA_SUBSAMPLING_444: save_tuning->yuv_format = AVIF_PIXEL_FORMAT_YUV444; break;
+                case SAIL_CHROMA_SUBSAMPLING_422: save_tuning->yuv_format = AVIF_PIXEL_FORMAT_YUV422; break;
+                case SAIL_CHROMA_SUBSAMPLING_420: save_tuning->yuv_format = AVIF_PIXEL_FORMAT_YUV420; break;
+                case SAIL_CHROMA_SUBSAMPLING_400: save_tuning->yuv_format = AVIF_PIXEL_FORMAT_YUV400; break;
+
+                default: {
+                    SAIL_LOG_WARNING("AVIF: Unsupported chroma subsampling '%s'", str_value);
+                    return true;
+                }
+            }
+
+            SAIL_LOG_TRACE("AVIF: Chroma subsampling: %s", str_value);
+        }
+    }
+
+    return true;
+}
+
+bool avif_private_sail_pixel_format_to_rgb_format(enum SailPixelFormat pixel_format, enum avifRGBFormat *rgb_format, uint32_t *depth) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:  *rgb_format = AVIF_RGB_FORMAT_RGB;  *depth = 8;  return true;
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:  *rgb_format = AVIF_RGB_FORMAT_BGR;  *depth = 8;  return true;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: *rgb_format = AVIF_RGB_FORMAT_RGBA; *depth = 8;  return true;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: *rgb_format = AVIF_RGB_FORMAT_BGRA; *depth = 8;  return true;
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB: *rgb_format = AVIF_RGB_FORMAT_ARGB; *depth = 8;  return true;
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: *rgb_format = AVIF_RGB_FORMAT_ABGR; *depth = 8;  return true;
+        case SAIL_PIXEL_FORMAT_BPP48_RGB:  *rgb_format = AVIF_RGB_FORMAT_RGB;  *depth = 16; return true;
+        case SAIL_PIXEL_FORMAT_BPP48_BGR:  *rgb_format = AVIF_RGB_FORMAT_BGR;  *depth = 16; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA: *rgb_format = AVIF_RGB_FORMAT_RGBA; *depth = 16; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA: *rgb_format = AVIF_RGB_FORMAT_BGRA; *depth = 16; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB: *rgb_format = AVIF_RGB_FORMAT_ARGB; *depth = 16; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR: *rgb_format = AVIF_RGB_FORMAT_ABGR; *depth = 16; return true;
+
+        default: {
+            return false;
+        }
+    }
+}
+
+sail_status_t avif_private_write_iccp(const struct sail_iccp *iccp, struct avifImage *avif_image) {
+
+    SAIL_CHECK_PTR(iccp);
+    SAIL_CHECK_PTR(avif_image);
+
+#if AVIF_VERSION_MAJOR >= 1
+    const avifResult avif_result = avifImageSetProfileICC(avif_image, iccp->data, iccp->size);
+
+    if (avif_result != AVIF_RESULT_OK) {
+        SAIL_LOG_ERROR("AVIF: %s", avifResultToString(avif_result));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+#else
+    avifImageSetProfileICC(avif_image, iccp->data, iccp->size);
+#endif
+
+    return SAIL_OK;
+}
+
+sail_status_t avif_private_write_meta_data(const struct sail_meta_data_node *meta_data_node, struct avifImage *avif_image) {
+
+    SAIL_CHECK_PTR(avif_image);
+
+    for (; meta_data_node != NULL; meta_data_node = meta_data_node->next) {
+        const struct sail_meta_data *meta_data = meta_data_node->meta_data;
+        const struct sail_variant *value = meta_data->value;
+
+        /* XMP is loaded as data, but it's a string usually. */
+        const uint8_t *data;
+        size_t data_size;
+
+        if (value->type == SAIL_VARIANT_TYPE_DATA) {
+            data      = sail_variant_to_data(value);
+            data_size = value->size;
+        } else if (value->type == SAIL_VARIANT_TYPE_STRING) {
+            data      = (const uint8_t *)sail_variant_to_string(value);
+            data_size = strlen(sail_variant_to_string(value));
+        } else {
+            continue;
+        }
+
+#if AVIF_VERSION_MAJOR >= 1
+        avifResult avif_result = AVIF_RESULT_OK;
+#endif
+
+        switch (meta_data->key) {
+#if AVIF_VERSION_MAJOR >= 1
+            case SAIL_META_DATA_EXIF: avif_result = avifImageSetMetadataExif(avif_image, data, data_size); break;
+            case SAIL_META_DATA_XMP:  avif_result = avifImageSetMetadataXMP(avif_image, data, data_size);  break;
+#else
+            case SAIL_META_DATA_EXIF: avifImageSetMetadataExif(avif_image, data, data_size); break;
+            case SAIL_META_DATA_XMP:  avifImageSetMetadataXMP(avif_image, data, data_size);  break;
+#endif
+
+            default: {
+                SAIL_LOG_WARNING("AVIF: Ignoring unsupported meta data key '%s'",
+                                    meta_data->key == SAIL_META_DATA_UNKNOWN ? meta_data->key_unknown : sail_meta_data_to_string(meta_data->key));
+                break;
+            }
+        }
+
+#if AVIF_VERSION_MAJOR >= 1
+        if (avif_result != AVIF_RESULT_OK) {
+            SAIL_LOG_ERROR("AVIF: %s", avifResultToString(avif_result));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+#endif
+    }
+
+    return SAIL_OK;
+}
@@ -35,18 +35,54 @@
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
+struct sail_iccp;
 struct sail_meta_data_node;
+struct sail_variant;
+
+/* Load tuning. */
+struct avif_private_load_tuning {
+    bool premultiply_alpha;
+    unsigned threads;
+    avifCodecChoice codec_choice;
+};
+
+/* Save tuning. Negative values mean the option is not set. */
+struct avif_private_save_tuning {
+    int speed;
+    unsigned threads;
+    int tile_rows_log2;
+    int tile_cols_log2;
+    enum avifPixelFormat yuv_format;
+};
 
 SAIL_HIDDEN enum SailPixelFormat avif_private_sail_pixel_format(enum avifPixelFormat avif_pixel_format, uint32_t depth, bool has_alpha);
 
 SAIL_HIDDEN enum SailChromaSubsampling avif_private_sail_chroma_subsampling(enum avifPixelFormat avif_pixel_format);
 
-SAIL_HIDDEN enum SailPixelFormat avif_private_rgb_sail_pixel_format(enum avifRGBFormat rgb_pixel_format, uint32_t depth);
+SAIL_HIDDEN enum SailPixelFormat avif_private_rgb_sail_pixel_format(enum avifRGBFormat rgb_pixel_format, uint32_t depth, bool premultiplied);
 
 SAIL_HIDDEN uint32_t avif_private_round_depth(uint32_t depth);
 
+/*
+ * Returns the planar pixel format to copy the YUV planes of the image into, or SAIL_PIXEL_FORMAT_UNKNOWN
+ * if the planes don't hold the same values as the requested planar pixel format, i.e. 8-bit full range
+ * BT.601 YCbCr without alpha of the same chroma subsampling.
+ */
+SAIL_HIDDEN enum SailPixelFormat avif_private_planar_pixel_format(const struct avifImage *avif_image, bool has_alpha,
+                                                                  enum SailPixelFormat pixel_format);
+
 SAIL_HIDDEN sail_status_t avif_private_fetch_iccp(const struct avifRWData *avif_iccp, struct sail_iccp **iccp);
 
 SAIL_HIDDEN sail_status_t avif_private_fetch_meta_data(enum SailMetaData key, const struct avifRWData *avif_rw_data, struct sail_meta_data_node **meta_data_node);
 
+SAIL_HIDDEN bool avif_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+SAIL_HIDDEN bool avif_private_save_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+SAIL_HIDDEN bool avif_private_sail_pixel_format_to_rgb_format(enum SailPixelFormat pixel_format, enum avifRGBFormat *rgb_format, uint32_t *depth);
+
+SAIL_HIDDEN sail_status_t avif_private_write_iccp(const struct sail_iccp *iccp, struct avifImage *avif_image);
+
+SAIL_HIDDEN sail_status_t avif_private_write_meta_data(const struct sail_meta_data_node *meta_data_node, struct avifImage *avif_image);
+
 #endif
@@ -0,0 +1,774 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "animation.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SAIL_ANIMATION_SSE2
+
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define SAIL_ANIMATION_NEON
+
+    #include <arm_neon.h>
+#endif
+
+struct animation_canvas {
+
+    enum SailPixelFormat pixel_format;
+    unsigned width;
+    unsigned height;
+    unsigned bytes_per_pixel;
+    unsigned bytes_per_line;
+    uint8_t *pixels;
+    bool own_pixels;
+    uint8_t background[8];
+
+    /* The canvas composites only the first frame, right into the image pixels when possible. */
+    bool first_frame_only;
+
+    /* NULL for pixel formats without alpha. */
+    animation_blend_row_t blend_row;
+
+    unsigned frames;
+    struct animation_frame frame;
+    struct animation_rect dirty;
+
+    /* Canvas area under the current frame saved for SAIL_ANIMATION_DISPOSE_PREVIOUS. */
+    uint8_t *previous;
+    size_t previous_size;
+
+    /* Decoded pixels of the current frame blended with SAIL_ANIMATION_BLEND_OVER. */
+    uint8_t *frame_pixels;
+    size_t frame_pixels_size;
+};
+
+/*
+ * Private functions.
+ */
+
+/*
+ * Portable blending kernels. SIMD kernels process the bulk of a row and finish its tail with them.
+ * Straight alpha is blended as out = (src * src_a + dst * dst_a * (1 - src_a)) / out_a.
+ */
+
+static void blend_over_straight8(uint8_t *dst, const uint8_t *src, unsigned width, unsigned components, unsigned alpha_index) {
+
+    for (unsigned column = 0; column < width; column++, dst += components, src += components) {
+        const unsigned src_a = src[alpha_index];
+
+        if (src_a == 255) {
+            memcpy(dst, src, components);
+            continue;
+        } else if (src_a == 0) {
+            continue;
+        }
+
+        const unsigned src_weight = src_a * 255;
+        const unsigned dst_weight = dst[alpha_index] * (255 - src_a);
+        const unsigned out_weight = src_weight + dst_weight;
+
+        for (unsigned i = 0; i < components; i++) {
+            if (i != alpha_index) {
+                dst[i] = (uint8_t)((src[i] * src_weight + dst[i] * dst_weight + out_weight / 2) / out_weight);
+            }
+        }
+
+        dst[alpha_index] = (uint8_t)((out_weight + 127) / 255);
+    }
+}
+
+static void blend_over_straight16(uint8_t *dst_raw, const uint8_t *src_raw, unsigned width, unsigned components, unsigned alpha_index) {
+
+    uint16_t *dst = (uint16_t *)dst_raw;
+    const uint16_t *src = (const uint16_t *)src_raw;
+
+    for (unsigned column = 0; column < width; column++, dst += components, src += components) {
+        const uint64_t src_a = src[alpha_index];
+
+        if (src_a == 65535) {
+            memcpy(dst, src, components * sizeof(uint16_t));
+            continue;
+        } else if (src_a == 0) {
+            continue;
+        }
+
+        const uint64_t src_weight = src_a * 65535;
+        const uint64_t dst_weight = dst[alpha_index] * (65535 - src_a);
+        const uint64_t out_weight = src_weight + dst_weight;
+
+        for (unsigned i = 0; i < components; i++) {
+            if (i != alpha_index) {
+                dst[i] = (uint16_t)((src[i] * src_weight + dst[i] * dst_weight + out_weight / 2) / out_weight);
+            }
+        }
+
+        dst[alpha_index] = (uint16_t)((out_weight + 32767) / 65535);
+    }
+}
+
+/* Premultiplied colors are blended with the same formula as alpha: out = src + dst * (1 - src_a). */
+static void blend_over_premultiplied8(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++, dst += 4, src += 4) {
+        const unsigned src_a_inverted = 255 - src[3];
+
+        for (unsigned i = 0; i < 4; i++) {
+            const unsigned value = src[i] + (dst[i] * src_a_inverted + 127) / 255;
+            dst[i] = (uint8_t)(value > 255 ? 255 : value);
+        }
+    }
+}
+
+static void blend_over_premultiplied16(uint8_t *dst_raw, const uint8_t *src_raw, unsigned width) {
+
+    uint16_t *dst = (uint16_t *)dst_raw;
+    const uint16_t *src = (const uint16_t *)src_raw;
+
+    for (unsigned column = 0; column < width; column++, dst += 4, src += 4) {
+        const uint32_t src_a_inverted = 65535 - src[3];
+
+        for (unsigned i = 0; i < 4; i++) {
+            const uint32_t value = src[i] + (dst[i] * src_a_inverted + 32767) / 65535;
+            dst[i] = (uint16_t)(value > 65535 ? 65535 : value);
+        }
+    }
+}
+
+/*
+ * SIMD kernels.
+ *
+ * Straight alpha needs a division by the output alpha, so the SIMD kernels only skip or copy
+ * groups of fully transparent or fully opaque pixels, typical for GIF and APNG frames, and blend
+ * other groups with the portable kernel. Premultiplied alpha is blended fully in SIMD.
+ * Premultiplied kernels divide by 255 with rounding exactly as the portable kernel does.
+ */
+
+#ifdef SAIL_ANIMATION_SSE2
+static void blend_over_straight_rgba32_sse2(uint8_t *dst, const uint8_t *src, unsigned width, unsigned alpha_index) {
+
+    const __m128i alpha_mask = _mm_set1_epi32(alpha_index == 0 ? 0xFF : (int)0xFF000000);
+    const __m128i zero = _mm_setzero_si128();
+
+    unsigned column = 0;
+
+    for (; column + 4 <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(src + column * 4));
+        const __m128i alpha  = _mm_and_si128(pixels, alpha_mask);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alpha_mask)) == 0xFFFF) {
+            _mm_storeu_si128((__m128i *)(dst + column * 4), pixels);
+        } else if (_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero)) != 0xFFFF) {
+            blend_over_straight8(dst + column * 4, src + column * 4, 4, 4, alpha_index);
+        }
+    }
+
+    blend_over_straight8(dst + column * 4, src + column * 4, width - column, 4, alpha_index);
+}
+
+static inline __m128i divide_by_255_sse2(__m128i value) {
+
+    const __m128i rounded = _mm_add_epi16(value, _mm_set1_epi16(128));
+
+    return _mm_srli_epi16(_mm_add_epi16(rounded, _mm_srli_epi16(rounded, 8)), 8);
+}
+
+static inline __m128i inverted_alpha_sse2(__m128i pixels) {
+
+    const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+    return _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+}
+
+static void blend_over_premultiplied_rgba32_sse2(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    const __m128i zero = _mm_setzero_si128();
+
+    unsigned column = 0;
+
+    for (; column + 4 <= width; column += 4) {
+        const __m128i src_pixels = _mm_loadu_si128((const __m128i *)(src + column * 4));
+        const __m128i dst_pixels = _mm_loadu_si128((const __m128i *)(dst + column * 4));
+
+        const __m128i src1 = _mm_unpacklo_epi8(src_pixels, zero);
+        const __m128i src2 = _mm_unpackhi_epi8(src_pixels, zero);
+
+        const __m128i dst1 = divide_by_255_sse2(_mm_mullo_epi16(_mm_unpacklo_epi8(dst_pixels, zero), inverted_alpha_sse2(src1)));
+        const __m128i dst2 = divide_by_255_sse2(_mm_mullo_epi16(_mm_unpackhi_epi8(dst_pixels, zero), inverted_alpha_sse2(src2)));
+
+        _mm_storeu_si128((__m128i *)(dst + column * 4), _mm_adds_epu8(src_pixels, _mm_packus_epi16(dst1, dst2)));
+    }
+
+    blend_over_premultiplied8(dst + column * 4, src + column * 4, width - column);
+}
+#endif
+
+#ifdef SAIL_ANIMATION_NEON
+static void blend_over_straight_rgba32_neon(uint8_t *dst, const uint8_t *src, unsigned width, unsigned alpha_index) {
+
+    const uint32x4_t alpha_mask = vdupq_n_u32(alpha_index == 0 ? 0xFF : 0xFF000000);
+
+    unsigned column = 0;
+
+    for (; column + 4 <= width; column += 4) {
+        const uint8x16_t pixels = vld1q_u8(src + column * 4);
+        const uint32x4_t alpha  = vandq_u32(vreinterpretq_u32_u8(pixels), alpha_mask);
+
+        if (vminvq_u32(vceqq_u32(alpha, alpha_mask)) == 0xFFFFFFFF) {
+            vst1q_u8(dst + column * 4, pixels);
+        } else if (vmaxvq_u32(alpha) != 0) {
+            blend_over_straight8(dst + column * 4, src + column * 4, 4, 4, alpha_index);
+        }
+    }
+
+    blend_over_straight8(dst + column * 4, src + column * 4, width - column, 4, alpha_index);
+}
+
+static inline uint8x16_t multiply_divide_by_255_neon(uint8x16_t value, uint8x16_t factor) {
+
+    const uint16x8_t value1 = vmull_u8(vget_low_u8(value), vget_low_u8(factor));
+    const uint16x8_t value2 = vmull_high_u8(value, factor);
+
+    return vcombine_u8(vraddhn_u16(value1, vrshrq_n_u16(value1, 8)), vraddhn_u16(value2, vrshrq_n_u16(value2, 8)));
+}
+
+static void blend_over_premultiplied_rgba32_neon(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t src_pixels = vld4q_u8(src + column * 4);
+        uint8x16x4_t dst_pixels = vld4q_u8(dst + column * 4);
+
+        const uint8x16_t src_a_inverted = vmvnq_u8(src_pixels.val[3]);
+
+        for (unsigned i = 0; i < 4; i++) {
+            dst_pixels.val[i] = vqaddq_u8(src_pixels.val[i], multiply_divide_by_255_neon(dst_pixels.val[i], src_a_inverted));
+        }
+
+        vst4q_u8(dst + column * 4, dst_pixels);
+    }
+
+    blend_over_premultiplied8(dst + column * 4, src + column * 4, width - column);
+}
+#endif
+
+static void blend_over_straight_rgba32(uint8_t *dst, const uint8_t *src, unsigned width, unsigned alpha_index) {
+
+#if defined(SAIL_ANIMATION_SSE2)
+    blend_over_straight_rgba32_sse2(dst, src, width, alpha_index);
+#elif defined(SAIL_ANIMATION_NEON)
+    blend_over_straight_rgba32_neon(dst, src, width, alpha_index);
+#else
+    blend_over_straight8(dst, src, width, 4, alpha_index);
+#endif
+}
+
+/*
+ * Blending kernels selected by pixel format.
+ */
+
+static void blend_over_ga16(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    blend_over_straight8(dst, src, width, 2, 1);
+}
+
+static void blend_over_ga32(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    blend_over_straight16(dst, src, width, 2, 1);
+}
+
+static void blend_over_rgba32(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    blend_over_straight_rgba32(dst, src, width, 3);
+}
+
+static void blend_over_rgba32_portable(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    blend_over_straight8(dst, src, width, 4, 3);
+}
+
+static void blend_over_argb32(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    blend_over_straight_rgba32(dst, src, width, 0);
+}
+
+static void blend_over_argb32_portable(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    blend_over_straight8(dst, src, width, 4, 0);
+}
+
+static void blend_over_rgba64(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    blend_over_straight16(dst, src, width, 4, 3);
+}
+
+static void blend_over_argb64(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    blend_over_straight16(dst, src, width, 4, 0);
+}
+
+static void blend_over_rgba32_premultiplied(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+#if defined(SAIL_ANIMATION_SSE2)
+    blend_over_premultiplied_rgba32_sse2(dst, src, width);
+#elif defined(SAIL_ANIMATION_NEON)
+    blend_over_premultiplied_rgba32_neon(dst, src, width);
+#else
+    blend_over_premultiplied8(dst, src, width);
+#endif
+}
+
+static void blend_over_rgba64_premultiplied(uint8_t *dst, const uint8_t *src, unsigned width) {
+
+    blend_over_premultiplied16(dst, src, width);
+}
+
+static animation_blend_row_t blend_row_for_pixel_format(enum SailPixelFormat pixel_format, bool portable) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA: {
+            return blend_over_ga16;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: {
+            return blend_over_ga32;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: {
+            return portable ? blend_over_rgba32_portable : blend_over_rgba32;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: {
+            return portable ? blend_over_argb32_portable : blend_over_argb32;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA: {
+            return blend_over_rgba64;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR: {
+            return blend_over_argb64;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED: {
+            return portable ? blend_over_premultiplied8 : blend_over_rgba32_premultiplied;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: {
+            return blend_over_rgba64_premultiplied;
+        }
+        default: {
+            return NULL;
+        }
+    }
+}
+
+static uint8_t* canvas_pixel(const struct animation_canvas *canvas, unsigned x, unsigned y) {
+
+    return canvas->pixels + (size_t)y * canvas->bytes_per_line + (size_t)x * canvas->bytes_per_pixel;
+}
+
+static void fill_rect(struct animation_canvas *canvas, const struct animation_rect *rect) {
+
+    if (rect->width == 0 || rect->height == 0) {
+        return;
+    }
+
+    uint8_t *first_row = canvas_pixel(canvas, rect->x, rect->y);
+
+    for (unsigned column = 0; column < rect->width; column++) {
+        memcpy(first_row + (size_t)column * canvas->bytes_per_pixel, canvas->background, canvas->bytes_per_pixel);
+    }
+
+    const size_t row_length = (size_t)rect->width * canvas->bytes_per_pixel;
+
+    for (unsigned row = 1; row < rect->height; row++) {
+        memcpy(first_row + (size_t)row * canvas->bytes_per_line, first_row, row_length);
+    }
+}
+
+/* Copies the canvas area to or from a buffer with packed rows. */
+static void copy_rect(struct animation_canvas *canvas, const struct animation_rect *rect, uint8_t *buffer, bool to_canvas) {
+
+    const size_t row_length = (size_t)rect->width * canvas->bytes_per_pixel;
+
+    for (unsigned row = 0; row < rect->height; row++) {
+        uint8_t *canvas_row = canvas_pixel(canvas, rect->x, rect->y + row);
+        uint8_t *buffer_row = buffer + row * row_length;
+
+        if (to_canvas) {
+            memcpy(canvas_row, buffer_row, row_length);
+        } else {
+            memcpy(buffer_row, canvas_row, row_length);
+        }
+    }
+}
+
+static bool rect_is_empty(const struct animation_rect *rect) {
+
+    return rect->width == 0 || rect->height == 0;
+}
+
+static void unite_rects(struct animation_rect *rect, const struct animation_rect *other) {
+
+    if (rect_is_empty(other)) {
+        return;
+    }
+
+    if (rect_is_empty(rect)) {
+        *rect = *other;
+        return;
+    }
+
+    const unsigned right  = SAIL_MAX(rect->x + rect->width, other->x + other->width);
+    const unsigned bottom = SAIL_MAX(rect->y + rect->height, other->y + other->height);
+
+    rect->x      = SAIL_MIN(rect->x, other->x);
+    rect->y      = SAIL_MIN(rect->y, other->y);
+    rect->width  = right - rect->x;
+    rect->height = bottom - rect->y;
+}
+
+/* Grows the buffer to hold the packed pixels of the rect. Buffers only grow, so they're reused by next frames. */
+static sail_status_t reserve_rect_buffer(const struct animation_canvas *canvas, const struct animation_rect *rect,
+                                         uint8_t **buffer, size_t *buffer_size) {
+
+    const size_t size = SAIL_MAX((size_t)rect->width * rect->height, 1) * canvas->bytes_per_pixel;
+
+    if (size <= *buffer_size && *buffer != NULL) {
+        return SAIL_OK;
+    }
+
+    void *ptr = *buffer;
+    SAIL_TRY(sail_realloc(size, &ptr));
+
+    *buffer      = ptr;
+    *buffer_size = size;
+
+    return SAIL_OK;
+}
+
+static bool blends_frame_buffer(const struct animation_canvas *canvas) {
+
+    return canvas->frame.blend == SAIL_ANIMATION_BLEND_OVER && canvas->blend_row != NULL;
+}
+
+static sail_status_t store_unsigned_property(struct sail_hash_map *special_properties, const char *key, unsigned value) {
+
+    struct sail_variant *variant;
+    SAIL_TRY(sail_alloc_variant(&variant));
+
+    sail_set_variant_unsigned_int(variant, value);
+
+    SAIL_TRY_OR_CLEANUP(sail_put_hash_map(special_properties, key, variant),
+                        /* cleanup */ sail_destroy_variant(variant));
+
+    sail_destroy_variant(variant);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t animation_private_alloc_canvas(unsigned width, unsigned height, enum SailPixelFormat pixel_format,
+                                              const void *background, bool first_frame_only, struct animation_canvas **canvas) {
+
+    SAIL_CHECK_PTR(canvas);
+
+    if (width == 0 || height == 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    const unsigned bits_per_pixel = sail_bits_per_pixel(pixel_format);
+
+    if (bits_per_pixel == 0 || bits_per_pixel % 8 != 0 || bits_per_pixel > 64) {
+        SAIL_LOG_ERROR("ANIMATION: %s pixel format is not supported for compositing", sail_pixel_format_to_string(pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct animation_canvas), &ptr));
+    struct animation_canvas *canvas_local = ptr;
+
+    *canvas_local = (struct animation_canvas) {
+        .pixel_format    = pixel_format,
+        .width           = width,
+        .height          = height,
+        .bytes_per_pixel = bits_per_pixel / 8,
+        .bytes_per_line  = sail_bytes_per_line(width, pixel_format),
+        .pixels          = NULL,
+        .own_pixels      = false,
+        .background      = { 0 },
+        .first_frame_only = first_frame_only,
+        .blend_row       = blend_row_for_pixel_format(pixel_format, /* portable */ false),
+        .frames          = 0,
+        .frame           = { { 0, 0, 0, 0 }, SAIL_ANIMATION_DISPOSE_NONE, SAIL_ANIMATION_BLEND_SOURCE },
+        .dirty           = { 0, 0, 0, 0 },
+        .previous          = NULL,
+        .previous_size     = 0,
+        .frame_pixels      = NULL,
+        .frame_pixels_size = 0,
+    };
+
+    if (background != NULL) {
+        memcpy(canvas_local->background, background, canvas_local->bytes_per_pixel);
+    }
+
+    /* First frame canvases get their pixels in animation_private_bind_pixels(). */
+    if (!first_frame_only) {
+        SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)canvas_local->bytes_per_line * height, &ptr),
+                            /* cleanup */ animation_private_destroy_canvas(canvas_local));
+        canvas_local->pixels     = ptr;
+        canvas_local->own_pixels = true;
+
+        const struct animation_rect whole_canvas = { 0, 0, width, height };
+        fill_rect(canvas_local, &whole_canvas);
+    }
+
+    *canvas = canvas_local;
+
+    return SAIL_OK;
+}
+
+void animation_private_destroy_canvas(struct animation_canvas *canvas) {
+
+    if (canvas == NULL) {
+        return;
+    }
+
+    if (canvas->own_pixels) {
+        sail_free(canvas->pixels);
+    }
+
+    sail_free(canvas->previous);
+    sail_free(canvas->frame_pixels);
+
+    sail_free(canvas);
+}
+
+sail_status_t animation_private_start_frame(struct animation_canvas *canvas, const struct animation_frame *frame) {
+
+    SAIL_CHECK_PTR(canvas);
+    SAIL_CHECK_PTR(frame);
+
+    if (canvas->first_frame_only && canvas->frames > 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    if (frame->rect.x > canvas->width || frame->rect.width > canvas->width - frame->rect.x ||
+            frame->rect.y > canvas->height || frame->rect.height > canvas->height - frame->rect.y) {
+        SAIL_LOG_ERROR("ANIMATION: Frame %u,%u %ux%u doesn't fit into the canvas %ux%u",
+                        frame->rect.x, frame->rect.y, frame->rect.width, frame->rect.height,
+                        canvas->width, canvas->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    struct animation_rect dirty = { 0, 0, 0, 0 };
+
+    if (canvas->frames == 0) {
+        dirty = (struct animation_rect) { 0, 0, canvas->width, canvas->height };
+    } else {
+        switch (canvas->frame.dispose) {
+            case SAIL_ANIMATION_DISPOSE_NONE: {
+                break;
+            }
+            case SAIL_ANIMATION_DISPOSE_BACKGROUND: {
+                fill_rect(canvas, &canvas->frame.rect);
+                dirty = canvas->frame.rect;
+                break;
+            }
+            case SAIL_ANIMATION_DISPOSE_PREVIOUS: {
+                copy_rect(canvas, &canvas->frame.rect, canvas->previous, /* to canvas */ true);
+                dirty = canvas->frame.rect;
+                break;
+            }
+        }
+    }
+
+    /*
+     * Only the frame area is saved and decoded into, so small frames need small buffers.
+     * No next frame follows the first frame to restore the area for.
+     */
+    if (frame->dispose == SAIL_ANIMATION_DISPOSE_PREVIOUS && !canvas->first_frame_only) {
+        SAIL_TRY(reserve_rect_buffer(canvas, &frame->rect, &canvas->previous, &canvas->previous_size));
+
+        copy_rect(canvas, &frame->rect, canvas->previous, /* to canvas */ false);
+    }
+
+    canvas->frame = *frame;
+    canvas->frames++;
+
+    if (blends_frame_buffer(canvas)) {
+        SAIL_TRY(reserve_rect_buffer(canvas, &frame->rect, &canvas->frame_pixels, &canvas->frame_pixels_size));
+    }
+
+    /* Frames must be at least 1x1, so return the whole canvas when nothing has changed. */
+    unite_rects(&dirty, &frame->rect);
+
+    if (rect_is_empty(&dirty)) {
+        dirty = (struct animation_rect) { 0, 0, canvas->width, canvas->height };
+    }
+
+    canvas->dirty = dirty;
+
+    return SAIL_OK;
+}
+
+sail_status_t animation_private_bind_pixels(struct animation_canvas *canvas, const struct sail_load_options *load_options,
+                                            const struct sail_image *image) {
+
+    SAIL_CHECK_PTR(canvas);
+    SAIL_CHECK_PTR(load_options);
+    SAIL_CHECK_PTR(image);
+
+    if (canvas->pixels != NULL) {
+        return SAIL_OK;
+    }
+
+    /* Row callbacks get rows one by one, and cropped frames are smaller than the canvas, so they need own pixels. */
+    if (load_options->row_callback == NULL && image->pixels != NULL &&
+            image->width == canvas->width && image->height == canvas->height && image->pixel_format == canvas->pixel_format) {
+        canvas->pixels         = image->pixels;
+        canvas->bytes_per_line = image->bytes_per_line;
+    } else {
+        void *ptr;
+        SAIL_TRY(sail_malloc((size_t)canvas->bytes_per_line * canvas->height, &ptr));
+        canvas->pixels     = ptr;
+        canvas->own_pixels = true;
+    }
+
+    const struct animation_rect whole_canvas = { 0, 0, canvas->width, canvas->height };
+    fill_rect(canvas, &whole_canvas);
+
+    return SAIL_OK;
+}
+
+sail_status_t animation_private_frame_pixels(struct animation_canvas *canvas, void **pixels, unsigned *bytes_per_line) {
+
+    SAIL_CHECK_PTR(canvas);
+    SAIL_CHECK_PTR(pixels);
+    SAIL_CHECK_PTR(bytes_per_line);
+
+    if (blends_frame_buffer(canvas)) {
+        *pixels         = canvas->frame_pixels;
+        *bytes_per_line = canvas->frame.rect.width * canvas->bytes_per_pixel;
+    } else {
+        *pixels         = canvas_pixel(canvas, canvas->frame.rect.x, canvas->frame.rect.y);
+        *bytes_per_line = canvas->bytes_per_line;
+    }
+
+    return SAIL_OK;
+}
+
+void animation_private_finish_frame(struct animation_canvas *canvas) {
+
+    if (!blends_frame_buffer(canvas)) {
+        return;
+    }
+
+    const struct animation_rect *rect = &canvas->frame.rect;
+    const size_t row_length = (size_t)rect->width * canvas->bytes_per_pixel;
+
+    for (unsigned row = 0; row < rect->height; row++) {
+        canvas->blend_row(canvas_pixel(canvas, rect->x, rect->y + row), canvas->frame_pixels + row * row_length, rect->width);
+    }
+}
+
+animation_blend_row_t animation_private_blend_row(enum SailPixelFormat pixel_format, bool portable) {
+
+    return blend_row_for_pixel_format(pixel_format, portable);
+}
+
+bool animation_private_first_frame_only(const struct sail_load_options *load_options) {
+
+    return load_options->options & SAIL_OPTION_FIRST_FRAME_ONLY;
+}
+
+bool animation_private_dirty_only(const struct sail_load_options *load_options) {
+
+    const int options = load_options->options;
+
+    return (options & SAIL_OPTION_DIRTY_RECTANGLES) && (options & SAIL_OPTION_SOURCE_IMAGE) && !(options & SAIL_OPTION_PROBE);
+}
+
+sail_status_t animation_private_setup_image(const struct animation_canvas *canvas, bool dirty_only, struct sail_image *image) {
+
+    SAIL_CHECK_PTR(canvas);
+    SAIL_CHECK_PTR(image);
+
+    const struct animation_rect rect = dirty_only ? canvas->dirty : (struct animation_rect) { 0, 0, canvas->width, canvas->height };
+
+    image->width          = rect.width;
+    image->height         = rect.height;
+    image->pixel_format   = canvas->pixel_format;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    if (dirty_only && image->source_image != NULL) {
+        if (image->source_image->special_properties == NULL) {
+            SAIL_TRY(sail_alloc_hash_map(&image->source_image->special_properties));
+        }
+
+        struct sail_hash_map *special_properties = image->source_image->special_properties;
+
+        SAIL_TRY(store_unsigned_property(special_properties, "animation-frame-x",       rect.x));
+        SAIL_TRY(store_unsigned_property(special_properties, "animation-frame-y",       rect.y));
+        SAIL_TRY(store_unsigned_property(special_properties, "animation-canvas-width",  canvas->width));
+        SAIL_TRY(store_unsigned_property(special_properties, "animation-canvas-height", canvas->height));
+    }
+
+    return SAIL_OK;
+}
+
+void animation_private_copy_row(const struct animation_canvas *canvas, bool dirty_only, unsigned row, void *scan) {
+
+    const uint8_t *canvas_row = dirty_only ? canvas_pixel(canvas, canvas->dirty.x, canvas->dirty.y + row) : canvas_pixel(canvas, 0, row);
+
+    /* Canvases bound to the image pixels already hold the row. */
+    if (canvas_row == scan) {
+        return;
+    }
+
+    memcpy(scan, canvas_row, (size_t)(dirty_only ? canvas->dirty.width : canvas->width) * canvas->bytes_per_pixel);
+}
+
+void animation_private_copy_to_image(const struct animation_canvas *canvas, bool dirty_only, struct sail_image *image) {
+
+    if (canvas->pixels == image->pixels) {
+        return;
+    }
+
+    for (unsigned row = 0; row < image->height; row++) {
+        animation_private_copy_row(canvas, dirty_only, row, sail_scan_line(image, row));
+    }
+}
@@ -0,0 +1,205 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ANIMATION_COMMON_H
+#define SAIL_ANIMATION_COMMON_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_image;
+struct sail_load_options;
+
+/*
+ * Shared compositing of animation frames into a full canvas. GIF, APNG, and WebP animations
+ * consist of sub-frames placed on a canvas and combined with the previous canvas contents.
+ *
+ * Typical usage: animation_private_alloc_canvas()   ->
+ *                animation_private_start_frame()    ->
+ *                animation_private_setup_image()    ->
+ *                animation_private_bind_pixels()    ->
+ *                animation_private_frame_pixels()   ->
+ *                decode the sub-frame               ->
+ *                animation_private_finish_frame()   ->
+ *                animation_private_copy_to_image()  ->
+ *                animation_private_start_frame()    ->
+ *                ...
+ *                animation_private_destroy_canvas().
+ */
+
+/* What happens to the frame area before the next frame is composited. */
+enum SailAnimationDispose {
+
+    /* Leave the frame pixels on the canvas. */
+    SAIL_ANIMATION_DISPOSE_NONE,
+
+    /* Fill the frame area with the background pixel. */
+    SAIL_ANIMATION_DISPOSE_BACKGROUND,
+
+    /* Restore the frame area to the canvas contents before the frame. */
+    SAIL_ANIMATION_DISPOSE_PREVIOUS,
+};
+
+/* How the frame pixels are combined with the canvas. */
+enum SailAnimationBlend {
+
+    /* Replace the canvas pixels including alpha. */
+    SAIL_ANIMATION_BLEND_SOURCE,
+
+    /*
+     * Alpha-blend the frame pixels over the canvas pixels. Pixel formats without alpha
+     * are composited as with SAIL_ANIMATION_BLEND_SOURCE.
+     */
+    SAIL_ANIMATION_BLEND_OVER,
+};
+
+struct animation_rect {
+
+    unsigned x;
+    unsigned y;
+    unsigned width;
+    unsigned height;
+};
+
+struct animation_frame {
+
+    /* Frame area on the canvas. */
+    struct animation_rect rect;
+
+    enum SailAnimationDispose dispose;
+    enum SailAnimationBlend blend;
+};
+
+struct animation_canvas;
+
+/* Blends 'width' frame pixels over the canvas pixels with SAIL_ANIMATION_BLEND_OVER. */
+typedef void (*animation_blend_row_t)(uint8_t *dst, const uint8_t *src, unsigned width);
+
+/*
+ * Allocates a canvas of the specified size and pixel format filled with the background pixel.
+ * The background pixel must have the size of a canvas pixel. The canvas is transparent black
+ * when the background pixel is NULL. Pixel formats below 8 bits per pixel are not supported.
+ *
+ * A canvas allocated with 'first_frame_only' composites only the first frame. It allocates
+ * no pixels until animation_private_bind_pixels(), and no buffers to dispose the frame.
+ * Starting the second frame fails with SAIL_ERROR_NO_MORE_FRAMES.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t animation_private_alloc_canvas(unsigned width, unsigned height, enum SailPixelFormat pixel_format,
+                                                          const void *background, bool first_frame_only,
+                                                          struct animation_canvas **canvas);
+
+/*
+ * Destroys the specified canvas. Does nothing if the canvas is NULL.
+ */
+SAIL_HIDDEN void animation_private_destroy_canvas(struct animation_canvas *canvas);
+
+/*
+ * Applies the dispose operation of the previous frame and starts compositing the next frame.
+ *
+ * Computes the dirty rectangle of the next frame: the whole canvas for the first frame,
+ * and the union of the disposed area of the previous frame and the area of the next frame
+ * for other frames.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t animation_private_start_frame(struct animation_canvas *canvas, const struct animation_frame *frame);
+
+/*
+ * Binds the pixels of a first frame canvas to the pixels of the image to load the frame into,
+ * and fills them with the background pixel. The frame is composited right into the image then,
+ * and copying the canvas into the image does nothing. Allocates own pixels instead when the image
+ * doesn't hold the whole canvas, for example, with a row callback. Does nothing for other canvases.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t animation_private_bind_pixels(struct animation_canvas *canvas, const struct sail_load_options *load_options,
+                                                         const struct sail_image *image);
+
+/*
+ * Returns the buffer to decode the pixels of the current frame into, and its bytes per line.
+ * The buffer starts with the top left frame pixel. Frames composited with SAIL_ANIMATION_BLEND_SOURCE
+ * are decoded right into the canvas, other frames are decoded into a temporary buffer blended
+ * in animation_private_finish_frame(). The buffer contents from the previous decoding passes
+ * are preserved, so interlaced frames can be decoded into it pass by pass.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t animation_private_frame_pixels(struct animation_canvas *canvas, void **pixels, unsigned *bytes_per_line);
+
+/*
+ * Composites the decoded pixels of the current frame into the canvas.
+ */
+SAIL_HIDDEN void animation_private_finish_frame(struct animation_canvas *canvas);
+
+/*
+ * Returns the kernel used to blend frames of the specified pixel format, or NULL for pixel formats
+ * without alpha. Returns the portable kernel instead of the SIMD one when 'portable' is true.
+ * SIMD kernels produce exactly the same output as the portable ones.
+ */
+SAIL_HIDDEN animation_blend_row_t animation_private_blend_row(enum SailPixelFormat pixel_format, bool portable);
+
+/*
+ * Returns true if the load options request the first frame only. See SAIL_OPTION_FIRST_FRAME_ONLY.
+ */
+SAIL_HIDDEN bool animation_private_first_frame_only(const struct sail_load_options *load_options);
+
+/*
+ * Returns true if the load options request dirty rectangles instead of full canvas frames.
+ * See SAIL_OPTION_DIRTY_RECTANGLES.
+ */
+SAIL_HIDDEN bool animation_private_dirty_only(const struct sail_load_options *load_options);
+
+/*
+ * Sets the dimensions and the pixel format of the image to load the current frame into.
+ * The image gets the canvas dimensions, or the dirty rectangle dimensions when 'dirty_only'
+ * is true. In the latter case, the dirty rectangle position and the canvas dimensions
+ * are also stored in the special properties of the source image if it exists:
+ *
+ *   - "animation-frame-x"       (unsigned int)
+ *   - "animation-frame-y"       (unsigned int)
+ *   - "animation-canvas-width"  (unsigned int)
+ *   - "animation-canvas-height" (unsigned int)
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t animation_private_setup_image(const struct animation_canvas *canvas, bool dirty_only, struct sail_image *image);
+
+/*
+ * Copies the specified row of the canvas or the dirty rectangle into the scan line.
+ */
+SAIL_HIDDEN void animation_private_copy_row(const struct animation_canvas *canvas, bool dirty_only, unsigned row, void *scan);
+
+/*
+ * Copies the canvas or the dirty rectangle into the image pixels row by row.
+ */
+SAIL_HIDDEN void animation_private_copy_to_image(const struct animation_canvas *canvas, bool dirty_only, struct sail_image *image);
+
+#endif
@@ -23,6 +23,7 @@
     SOFTWARE.
 */
 
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -31,6 +32,9 @@
 
 #include <sail-common/sail-common.h>
 
+#include "common/rle/rle.h"
+#include "common/row_cursor/row_cursor.h"
+
 #include "bmp.h"
 #include "helpers.h"
 
@@ -59,6 +63,7 @@ static const char SAIL_PROFILE_LINKED[4]   = { 'L', 'I', 'N', 'K' };
 static const char SAIL_PROFILE_EMBEDDED[4] = { 'M', 'B', 'E', 'D' };
 
 /* Sizes of DIB header structs. */
+#define SAIL_BITMAP_DIB_FILE_HEADER_SIZE 14
 #define SAIL_BITMAP_DIB_HEADER_V2_SIZE 12
 #define SAIL_BITMAP_DIB_HEADER_V3_SIZE 40
 #define SAIL_BITMAP_DIB_HEADER_V4_SIZE 108
@@ -73,6 +78,7 @@ struct bmp_state {
     const struct sail_save_options *save_options;
 
     int bmp_load_options;
+    int bmp_write_options;
 
     enum SailPixelFormat source_pixel_format;
 
@@ -95,6 +101,12 @@ struct bmp_state {
     /* Number of bytes to pad scan lines to 4-byte boundary. */
     unsigned pad_bytes;
     bool flipped;
+
+    /* Offset of the first written header to update the sizes of RLE-encoded images. */
+    size_t headers_offset;
+    size_t bitmap_offset;
+    /* Scan line with 4-bit indexes unpacked into bytes. */
+    unsigned char *unpacked_row;
 };
 
 static sail_status_t alloc_bmp_state(struct bmp_state **bmp_state) {
@@ -110,12 +122,16 @@ static sail_status_t alloc_bmp_state(struct bmp_state **bmp_state) {
     (*bmp_state)->load_options     = NULL;
     (*bmp_state)->save_options     = NULL;
     (*bmp_state)->bmp_load_options = 0;
+    (*bmp_state)->bmp_write_options = 0;
     (*bmp_state)->iccp             = NULL;
     (*bmp_state)->palette          = NULL;
     (*bmp_state)->palette_count    = 0;
     (*bmp_state)->bytes_in_row     = 0;
     (*bmp_state)->pad_bytes        = 0;
     (*bmp_state)->flipped          = false;
+    (*bmp_state)->headers_offset   = 0;
+    (*bmp_state)->bitmap_offset    = 0;
+    (*bmp_state)->unpacked_row     = NULL;
 
     return SAIL_OK;
 }
@@ -129,6 +145,7 @@ static void destroy_bmp_state(struct bmp_state *bmp_state) {
     sail_destroy_iccp(bmp_state->iccp);
 
     sail_free(bmp_state->palette);
+    sail_free(bmp_state->unpacked_row);
 
     sail_free(bmp_state);
 }
@@ -386,26 +403,31 @@ sail_status_t bmp_private_read_seek_next_frame(void *state, struct sail_io *io,
     return SAIL_OK;
 }
 
-sail_status_t bmp_private_read_frame(void *state, struct sail_io *io, struct sail_image *image) {
-
-    struct bmp_state *bmp_state = state;
+/* Passes rows to the row callback of the load options unless they're NULL. */
+static sail_status_t read_frame(struct bmp_state *bmp_state, const struct sail_load_options *load_options,
+                                struct sail_buffered_reader *reader, struct sail_image *image) {
 
     /* RLE-encoded images don't need to skip pad bytes. */
     bool skip_pad_bytes = true;
 
-    for (unsigned i = image->height; i > 0; i--) {
-        unsigned char *scan = sail_scan_line(image, bmp_state->flipped ? (i - 1) : (image->height - i));
+    /* Bottom-up rows are decoded straight into their final scan lines. */
+    struct row_cursor cursor;
+    row_cursor_private_init(&cursor, image, 1, bmp_state->flipped, false);
+
+    for (unsigned i = 0; i < image->height; i++) {
+        const unsigned row = row_cursor_private_destination_row(&cursor, i);
+        unsigned char *scan = sail_scan_line_to_load(load_options, image, row);
 
         for (unsigned pixel_index = 0; pixel_index < image->width;) {
             if (bmp_state->version >= SAIL_BMP_V3 && bmp_state->v3.compression == SAIL_BI_RLE4) {
                 skip_pad_bytes = false;
 
                 uint8_t marker;
-                SAIL_TRY(io->strict_read(io->stream, &marker, sizeof(marker)));
+                SAIL_TRY(sail_buffered_reader_read_byte(reader, &marker));
 
                 if (marker == SAIL_BMP_UNENCODED_RUN_MARKER) {
                     uint8_t count_or_marker;
-                    SAIL_TRY(io->strict_read(io->stream, &count_or_marker, sizeof(count_or_marker)));
+                    SAIL_TRY(sail_buffered_reader_read_byte(reader, &count_or_marker));
 
                     if (count_or_marker == SAIL_BMP_END_OF_SCAN_LINE_MARKER) {
                         /* Jump to the end of scan line. +1 to avoid reading end-of-scan-line marker twice below. */
@@ -417,67 +439,63 @@ sail_status_t bmp_private_read_frame(void *state, struct sail_io *io, struct sai
                         SAIL_LOG_ERROR("BMP: Delta marker is not supported");
                         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
                     } else {
-                        bool read_byte = true;
-                        uint8_t byte = 0;
-                        uint8_t index;
-
-                        for (uint8_t k = 0; k < count_or_marker; k++) {
-                            if (read_byte) {
-                                SAIL_TRY(io->strict_read(io->stream, &byte, sizeof(byte)));
-                                index = (byte >> 4) & 0xf;
-                                read_byte = false;
-                            } else {
-                                index = byte & 0xf;
-                                read_byte = true;
-                            }
-
-                            *scan++ = index;
-                        }
+                        /* Pixels past the scan line are dropped. */
+                        const unsigned count = SAIL_MIN(count_or_marker, image->width - pixel_index);
 
                         /* Odd number of bytes is accompanied with an additional byte. */
-                        uint8_t number_of_unencoded_bytes = (count_or_marker + 1) / 2;
+                        const unsigned number_of_unencoded_bytes = (count_or_marker + 1) / 2;
+
+                        uint8_t packed[128];
+                        SAIL_TRY(sail_buffered_reader_strict_read(reader, packed, number_of_unencoded_bytes));
+
+                        for (unsigned k = 0; k < count; k++) {
+                            *scan++ = (k % 2 == 0) ? (packed[k / 2] >> 4) : (packed[k / 2] & 0xf);
+                        }
+
                         if ((number_of_unencoded_bytes % 2) != 0) {
-                            SAIL_TRY(io->seek(io->stream, 1, SEEK_CUR));
+                            SAIL_TRY(sail_buffered_reader_skip(reader, 1));
                         }
 
-                        pixel_index += count_or_marker;
+                        pixel_index += count;
                     }
                 } else {
                     /* Normal RLE: count + value. */
-                    bool high_4_bits = true;
-                    uint8_t index;
+                    /* Pixels past the scan line are dropped. */
+                    const unsigned count = SAIL_MIN(marker, image->width - pixel_index);
 
                     uint8_t byte;
-                    SAIL_TRY(io->strict_read(io->stream, &byte, sizeof(byte)));
-
-                    for (uint8_t k = 0; k < marker; k++) {
-                        if (high_4_bits) {
-                            index = (byte >> 4) & 0xf;
-                            high_4_bits = false;
-                        } else {
-                            index = byte & 0xf;
-                            high_4_bits = true;
-                        }
+                    SAIL_TRY(sail_buffered_reader_read_byte(reader, &byte));
+
+                    /* The run alternates the high and the low 4 bits. */
+                    const uint8_t pattern[2] = { (uint8_t)((byte >> 4) & 0xf), (uint8_t)(byte & 0xf) };
 
-                        *scan++ = index;
+                    if (pattern[0] == pattern[1]) {
+                        memset(scan, pattern[0], count);
+                    } else {
+                        rle_private_fill(scan, pattern, 2, count / 2);
+
+                        if ((count % 2) != 0) {
+                            scan[count - 1] = pattern[0];
+                        }
                     }
 
-                    pixel_index += marker;
+                    scan += count;
+                    pixel_index += count;
                 }
 
                 /* Read a possible end-of-scan-line marker at the end of line. */
                 if (pixel_index == image->width) {
-                    SAIL_TRY(bmp_private_skip_end_of_scan_line(io));
+                    SAIL_TRY(bmp_private_skip_end_of_scan_line(reader));
                 }
             } else if (bmp_state->version >= SAIL_BMP_V3 && bmp_state->v3.compression == SAIL_BI_RLE8) {
                 skip_pad_bytes = false;
 
                 uint8_t marker;
-                SAIL_TRY(io->strict_read(io->stream, &marker, sizeof(marker)));
+                SAIL_TRY(sail_buffered_reader_read_byte(reader, &marker));
 
                 if (marker == SAIL_BMP_UNENCODED_RUN_MARKER) {
                     uint8_t count_or_marker;
-                    SAIL_TRY(io->strict_read(io->stream, &count_or_marker, sizeof(count_or_marker)));
+                    SAIL_TRY(sail_buffered_reader_read_byte(reader, &count_or_marker));
 
                     if (count_or_marker == SAIL_BMP_END_OF_SCAN_LINE_MARKER) {
                         /* Jump to the end of scan line. +1 to avoid reading end-of-scan-line marker twice below. */
@@ -489,49 +507,110 @@ sail_status_t bmp_private_read_frame(void *state, struct sail_io *io, struct sai
                         SAIL_LOG_ERROR("BMP: Delta marker is not supported");
                         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
                     } else {
-                        for (uint8_t k = 0; k < count_or_marker; k++) {
-                            uint8_t index;
-                            SAIL_TRY(io->strict_read(io->stream, &index, sizeof(index)));
+                        /* Pixels past the scan line are dropped. */
+                        const unsigned count = SAIL_MIN(count_or_marker, image->width - pixel_index);
 
-                            *scan++ = index;
-                        }
+                        SAIL_TRY(sail_buffered_reader_strict_read(reader, scan, count));
+                        scan += count;
 
                         /* Odd number of pixels is accompanied with an additional byte. */
-                        if ((count_or_marker % 2) != 0) {
-                            SAIL_TRY(io->seek(io->stream, 1, SEEK_CUR));
-                        }
+                        SAIL_TRY(sail_buffered_reader_skip(reader, (count_or_marker - count) + (count_or_marker % 2)));
 
-                        pixel_index += count_or_marker;
+                        pixel_index += count;
                     }
                 } else {
                     /* Normal RLE: count + value. */
-                    uint8_t index;
-                    SAIL_TRY(io->strict_read(io->stream, &index, sizeof(index)));
+                    /* Pixels past the scan line are dropped. */
+                    const unsigned count = SAIL_MIN(marker, image->width - pixel_index);
 
-                    for (uint8_t k = 0; k < marker; k++) {
-                        *scan++ = index;
-                    }
+                    uint8_t index;
+                    SAIL_TRY(sail_buffered_reader_read_byte(reader, &index));
 
-                    pixel_index += marker;
+                    memset(scan, index, count);
+                    scan += count;
+                    pixel_index += count;
                 }
 
                 /* Read a possible end-of-scan-line marker at the end of line. */
                 if (pixel_index == image->width) {
-                    SAIL_TRY(bmp_private_skip_end_of_scan_line(io));
+                    SAIL_TRY(bmp_private_skip_end_of_scan_line(reader));
                 }
             } else {
                 /* Read a whole scan line. */
-                SAIL_TRY(io->strict_read(io->stream, scan, bmp_state->bytes_in_row));
+                SAIL_TRY(sail_buffered_reader_strict_read(reader, scan, bmp_state->bytes_in_row));
                 pixel_index += image->width;
             }
         }
 
         /* Skip pad bytes. */
         if (skip_pad_bytes) {
-            SAIL_TRY(io->seek(io->stream, bmp_state->pad_bytes, SEEK_CUR));
+            SAIL_TRY(sail_buffered_reader_skip(reader, bmp_state->pad_bytes));
         }
+
+        SAIL_TRY(sail_scan_line_loaded(load_options, image, row));
+    }
+
+    return SAIL_OK;
+}
+
+/* Seeks to the bottom-up rows of an uncompressed frame and passes them to the row callback from top to bottom. */
+static sail_status_t read_flipped_frame_rows(struct bmp_state *bmp_state, struct sail_io *io, struct sail_image *image) {
+
+    size_t data_offset;
+    SAIL_TRY(io->tell(io->stream, &data_offset));
+
+    const size_t stride = (size_t)bmp_state->bytes_in_row + bmp_state->pad_bytes;
+
+    if (image->height > 0 && stride > 0 && (size_t)(LONG_MAX - data_offset) / stride < image->height) {
+        SAIL_LOG_ERROR("BMP: Bitmap data is too large to seek in");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    for (unsigned row = 0; row < image->height; row++) {
+        unsigned char *scan = sail_scan_line_to_load(bmp_state->load_options, image, row);
+
+        SAIL_TRY(io->seek(io->stream, (long)(data_offset + (size_t)(image->height - 1 - row) * stride), SEEK_SET));
+        SAIL_TRY(io->strict_read(io->stream, scan, bmp_state->bytes_in_row));
+
+        SAIL_TRY(sail_scan_line_loaded(bmp_state->load_options, image, row));
     }
 
+    /* Leave the stream past the bitmap data like reading it sequentially does. */
+    SAIL_TRY(io->seek(io->stream, (long)(data_offset + (size_t)image->height * stride), SEEK_SET));
+
+    return SAIL_OK;
+}
+
+sail_status_t bmp_private_read_frame(void *state, struct sail_io *io, struct sail_image *image) {
+
+    struct bmp_state *bmp_state = state;
+
+    if (bmp_state->flipped && bmp_state->load_options->row_callback != NULL) {
+        const bool rle = bmp_state->version >= SAIL_BMP_V3
+                            && (bmp_state->v3.compression == SAIL_BI_RLE4 || bmp_state->v3.compression == SAIL_BI_RLE8);
+
+        /*
+         * Bottom-up rows are read row by row only by seeking to them. Otherwise, SAIL decodes
+         * the whole frame. Don't log an error, it's not an error.
+         */
+        if (rle || (io->features & SAIL_IO_FEATURE_SEEKABLE) == 0) {
+            return SAIL_ERROR_NOT_IMPLEMENTED;
+        }
+
+        SAIL_TRY(read_flipped_frame_rows(bmp_state, io, image));
+
+        return SAIL_OK;
+    }
+
+    /* RLE markers and indexes are read by single bytes. */
+    struct sail_buffered_reader reader;
+    SAIL_TRY(sail_init_buffered_reader(io, 0, &reader));
+
+    SAIL_TRY_OR_CLEANUP(read_frame(bmp_state, bmp_state->load_options, &reader, image),
+                        /* cleanup */ sail_finish_buffered_reader(&reader));
+
+    SAIL_TRY(sail_finish_buffered_reader(&reader));
+
     return SAIL_OK;
 }
 
@@ -547,3 +626,231 @@ sail_status_t bmp_private_read_finish(void **state, struct sail_io *io) {
 
     return SAIL_OK;
 }
+
+/*
+ * Encoding functions.
+ */
+
+sail_status_t bmp_private_write_init(struct sail_io *io, const struct sail_save_options *save_options, void **state, int bmp_write_options) {
+
+    (void)io;
+
+    /* Allocate a new state. */
+    struct bmp_state *bmp_state;
+    SAIL_TRY(alloc_bmp_state(&bmp_state));
+    *state = bmp_state;
+
+    /* Shallow copy save options. */
+    bmp_state->save_options = save_options;
+
+    bmp_state->bmp_write_options = bmp_write_options;
+
+    if (save_options->compression != SAIL_COMPRESSION_NONE && save_options->compression != SAIL_COMPRESSION_RLE) {
+        SAIL_LOG_ERROR("BMP: Only NONE and RLE compressions are allowed for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    return SAIL_OK;
+}
+
+/* Converts the image resolution to pixels per meter. Unknown units are saved as 0. */
+static int32_t pixels_per_meter(const struct sail_resolution *resolution, double value) {
+
+    switch (resolution->unit) {
+        case SAIL_RESOLUTION_UNIT_MICROMETER: return (int32_t)(value * 1000000 + 0.5);
+        case SAIL_RESOLUTION_UNIT_CENTIMETER: return (int32_t)(value * 100 + 0.5);
+        case SAIL_RESOLUTION_UNIT_METER:      return (int32_t)(value + 0.5);
+        case SAIL_RESOLUTION_UNIT_INCH:       return (int32_t)(value / 0.0254 + 0.5);
+
+        default: {
+            return 0;
+        }
+    }
+}
+
+sail_status_t bmp_private_write_seek_next_frame(void *state, struct sail_io *io, const struct sail_image *image) {
+
+    struct bmp_state *bmp_state = state;
+
+    uint16_t bit_count;
+    SAIL_TRY(bmp_private_pixel_format_to_bit_count(image->pixel_format, &bit_count));
+
+    const bool rle = bmp_state->save_options->compression == SAIL_COMPRESSION_RLE;
+
+    if (rle && bit_count != 4 && bit_count != 8) {
+        SAIL_LOG_ERROR("BMP: RLE compression is supported only for BPP4-INDEXED and BPP8-INDEXED pixel formats");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    const unsigned palette_count = (bit_count <= 8) ? (image->palette == NULL ? 0 : image->palette->color_count) : 0;
+
+    SAIL_TRY(bmp_private_bytes_in_row(image->width, bit_count, &bmp_state->bytes_in_row));
+    bmp_state->pad_bytes = bmp_private_pad_bytes(bmp_state->bytes_in_row);
+
+    if (bit_count == 4 && rle) {
+        void *ptr;
+        SAIL_TRY(sail_malloc(image->width, &ptr));
+        bmp_state->unpacked_row = ptr;
+    }
+
+    const size_t file_header_size = (bmp_state->bmp_write_options & SAIL_WRITE_BMP_FILE_HEADER) ? SAIL_BITMAP_DIB_FILE_HEADER_SIZE : 0;
+    const size_t bitmap_offset = file_header_size + SAIL_BITMAP_DIB_HEADER_V3_SIZE + (size_t)palette_count * 4;
+
+    /* RLE-encoded bitmap size is updated after encoding. */
+    const size_t bitmap_size = rle ? 0 : (size_t)(bmp_state->bytes_in_row + bmp_state->pad_bytes) * image->height;
+
+    if (bitmap_offset + bitmap_size > UINT32_MAX) {
+        SAIL_LOG_ERROR("BMP: Image is too large");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    SAIL_TRY(io->tell(io->stream, &bmp_state->headers_offset));
+    bmp_state->bitmap_offset = bmp_state->headers_offset + bitmap_offset;
+
+    if (bmp_state->bmp_write_options & SAIL_WRITE_BMP_FILE_HEADER) {
+        bmp_state->dib_file_header = (struct SailBmpDibFileHeader) {
+            .type      = SAIL_DIB_IDENTIFIER,
+            .size      = (uint32_t)(bitmap_offset + bitmap_size),
+            .reserved1 = 0,
+            .reserved2 = 0,
+            .offset    = (uint32_t)bitmap_offset,
+        };
+
+        SAIL_TRY(bmp_private_write_dib_file_header(io, &bmp_state->dib_file_header));
+    }
+
+    /* Bottom-up V3 bitmap. */
+    bmp_state->version = SAIL_BMP_V3;
+    bmp_state->flipped = true;
+
+    bmp_state->v2 = (struct SailBmpDibHeaderV2) {
+        .size      = SAIL_BITMAP_DIB_HEADER_V3_SIZE,
+        .width     = (int32_t)image->width,
+        .height    = (int32_t)image->height,
+        .planes    = 1,
+        .bit_count = bit_count,
+    };
+
+    bmp_state->v3 = (struct SailBmpDibHeaderV3) {
+        .compression        = rle ? (bit_count == 4 ? SAIL_BI_RLE4 : SAIL_BI_RLE8) : SAIL_BI_RGB,
+        .bitmap_size        = (uint32_t)bitmap_size,
+        .x_pixels_per_meter = (image->resolution == NULL) ? 0 : pixels_per_meter(image->resolution, image->resolution->x),
+        .y_pixels_per_meter = (image->resolution == NULL) ? 0 : pixels_per_meter(image->resolution, image->resolution->y),
+        .colors_used        = palette_count,
+        .colors_important   = 0,
+    };
+
+    SAIL_TRY(bmp_private_write_v2(io, &bmp_state->v2));
+    SAIL_TRY(bmp_private_write_v3(io, &bmp_state->v3));
+
+    if (bit_count <= 8) {
+        SAIL_TRY(bmp_private_write_palette(io, image->palette, 1U << bit_count));
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_frame(struct bmp_state *bmp_state, struct sail_buffered_writer *writer, const struct sail_image *image) {
+
+    static const uint8_t pad[4] = { 0, 0, 0, 0 };
+
+    for (unsigned i = image->height; i > 0; i--) {
+        const unsigned char *scan = sail_scan_line(image, i - 1);
+
+        if (bmp_state->v3.compression == SAIL_BI_RLE8) {
+            SAIL_TRY(bmp_private_write_rle8_row(writer, scan, image->width));
+        } else if (bmp_state->v3.compression == SAIL_BI_RLE4) {
+            for (unsigned x = 0; x < image->width; x++) {
+                bmp_state->unpacked_row[x] = (x % 2 == 0) ? (scan[x / 2] >> 4) : (scan[x / 2] & 0xf);
+            }
+
+            SAIL_TRY(bmp_private_write_rle4_row(writer, bmp_state->unpacked_row, image->width));
+        } else {
+            SAIL_TRY(sail_buffered_writer_strict_write(writer, scan, bmp_state->bytes_in_row));
+            SAIL_TRY(sail_buffered_writer_strict_write(writer, pad, bmp_state->pad_bytes));
+            continue;
+        }
+
+        /* The last scan line is terminated with the end-of-rle-data marker. */
+        const uint8_t markers[2] = {
+            SAIL_BMP_UNENCODED_RUN_MARKER,
+            (i == 1) ? SAIL_BMP_END_OF_RLE_DATA_MARKER : SAIL_BMP_END_OF_SCAN_LINE_MARKER
+        };
+
+        SAIL_TRY(sail_buffered_writer_strict_write(writer, markers, sizeof(markers)));
+    }
+
+    return SAIL_OK;
+}
+
+/* Updates the file and bitmap sizes in the already written headers. */
+static sail_status_t update_rle_sizes(struct bmp_state *bmp_state, struct sail_io *io) {
+
+    size_t end_offset;
+    SAIL_TRY(io->tell(io->stream, &end_offset));
+
+    if (end_offset - bmp_state->headers_offset > UINT32_MAX) {
+        SAIL_LOG_ERROR("BMP: Image is too large");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    /* Non-seekable streams keep zero sizes. */
+    if ((io->features & SAIL_IO_FEATURE_SEEKABLE) == 0) {
+        return SAIL_OK;
+    }
+
+    size_t dib_header_offset = bmp_state->headers_offset;
+
+    if (bmp_state->bmp_write_options & SAIL_WRITE_BMP_FILE_HEADER) {
+        const uint32_t file_size = (uint32_t)(end_offset - bmp_state->headers_offset);
+
+        SAIL_TRY(io->seek(io->stream, (long)(bmp_state->headers_offset + sizeof(bmp_state->dib_file_header.type)), SEEK_SET));
+        SAIL_TRY(io->strict_write(io->stream, &file_size, sizeof(file_size)));
+
+        dib_header_offset += SAIL_BITMAP_DIB_FILE_HEADER_SIZE;
+    }
+
+    /* The bitmap size follows the V2 fields and the compression. */
+    const uint32_t bitmap_size = (uint32_t)(end_offset - bmp_state->bitmap_offset);
+    const size_t bitmap_size_offset = dib_header_offset + 16 + sizeof(bmp_state->v3.compression);
+
+    SAIL_TRY(io->seek(io->stream, (long)bitmap_size_offset, SEEK_SET));
+    SAIL_TRY(io->strict_write(io->stream, &bitmap_size, sizeof(bitmap_size)));
+
+    SAIL_TRY(io->seek(io->stream, (long)end_offset, SEEK_SET));
+
+    return SAIL_OK;
+}
+
+sail_status_t bmp_private_write_frame(void *state, struct sail_io *io, const struct sail_image *image) {
+
+    struct bmp_state *bmp_state = state;
+
+    /* Scan lines are written bottom-up and coalesced into large blocks. */
+    struct sail_buffered_writer writer;
+    SAIL_TRY(sail_init_buffered_writer(io, 0, &writer));
+
+    SAIL_TRY_OR_CLEANUP(write_frame(bmp_state, &writer, image),
+                        /* cleanup */ sail_finish_buffered_writer(&writer));
+
+    SAIL_TRY(sail_finish_buffered_writer(&writer));
+
+    if (bmp_state->v3.compression != SAIL_BI_RGB) {
+        SAIL_TRY(update_rle_sizes(bmp_state, io));
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t bmp_private_write_finish(void **state, struct sail_io *io) {
+
+    (void)io;
+
+    struct bmp_state *bmp_state = *state;
+
+    *state = NULL;
+
+    destroy_bmp_state(bmp_state);
+
+    return SAIL_OK;
+}
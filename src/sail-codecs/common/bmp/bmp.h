@@ -32,6 +32,7 @@
 struct sail_image;
 struct sail_io;
 struct sail_load_options;
+struct sail_save_options;
 
 enum SailBmpReadOptions {
 
@@ -48,6 +49,20 @@ enum SailBmpReadOptions {
     SAIL_READ_BMP_FILE_HEADER = 1 << 0,
 };
 
+enum SailBmpWriteOptions {
+
+    /*
+     * No specific BMP flags. This will:
+     *   1. Skip the BMP file header
+     */
+    SAIL_NO_BMP_WRITE_FLAGS = 0,
+
+    /*
+     * Write BMP file header.
+     */
+    SAIL_WRITE_BMP_FILE_HEADER = 1 << 0,
+};
+
 SAIL_HIDDEN sail_status_t bmp_private_read_init(struct sail_io *io, const struct sail_load_options *load_options, void **state, int bmp_load_options);
 
 SAIL_HIDDEN sail_status_t bmp_private_read_seek_next_frame(void *state, struct sail_io *io, struct sail_image **image);
@@ -56,4 +71,12 @@ SAIL_HIDDEN sail_status_t bmp_private_read_frame(void *state, struct sail_io *io
 
 SAIL_HIDDEN sail_status_t bmp_private_read_finish(void **state, struct sail_io *io);
 
+SAIL_HIDDEN sail_status_t bmp_private_write_init(struct sail_io *io, const struct sail_save_options *save_options, void **state, int bmp_write_options);
+
+SAIL_HIDDEN sail_status_t bmp_private_write_seek_next_frame(void *state, struct sail_io *io, const struct sail_image *image);
+
+SAIL_HIDDEN sail_status_t bmp_private_write_frame(void *state, struct sail_io *io, const struct sail_image *image);
+
+SAIL_HIDDEN sail_status_t bmp_private_write_finish(void **state, struct sail_io *io);
+
 #endif
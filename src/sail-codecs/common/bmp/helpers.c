@@ -27,8 +27,16 @@
 
 #include <sail-common/sail-common.h>
 
+#include "common/rle/rle.h"
+
 #include "helpers.h"
 
+/* Maximum number of pixels in a single RLE packet. */
+static const unsigned SAIL_BMP_RLE_MAX_COUNT = 255;
+
+/* Absolute runs of 1 or 2 pixels would collide with the escape markers. */
+static const unsigned SAIL_BMP_RLE_MIN_ABSOLUTE_COUNT = 3;
+
 sail_status_t bmp_private_read_ddb_file_header(struct sail_io *io, struct SailBmpDdbFileHeader *ddb_file_header) {
 
     SAIL_TRY(io->strict_read(io->stream, &ddb_file_header->type, sizeof(ddb_file_header->type)));
@@ -146,19 +154,17 @@ sail_status_t bmp_private_fetch_iccp(struct sail_io *io, long offset_of_data, ui
     return SAIL_OK;
 }
 
-sail_status_t bmp_private_skip_end_of_scan_line(struct sail_io *io) {
+sail_status_t bmp_private_skip_end_of_scan_line(struct sail_buffered_reader *reader) {
 
-    uint8_t marker;
-    SAIL_TRY(io->strict_read(io->stream, &marker, sizeof(marker)));
+    uint8_t markers[2];
+    SAIL_TRY(sail_buffered_reader_peek(reader, markers, 1));
 
-    if (marker == SAIL_BMP_UNENCODED_RUN_MARKER) {
-        SAIL_TRY(io->strict_read(io->stream, &marker, sizeof(marker)));
+    if (markers[0] == SAIL_BMP_UNENCODED_RUN_MARKER) {
+        SAIL_TRY(sail_buffered_reader_peek(reader, markers, 2));
 
-        if (marker != SAIL_BMP_END_OF_SCAN_LINE_MARKER) {
-            SAIL_TRY(io->seek(io->stream, -2, SEEK_CUR));
+        if (markers[1] == SAIL_BMP_END_OF_SCAN_LINE_MARKER) {
+            SAIL_TRY(sail_buffered_reader_skip(reader, 2));
         }
-    } else {
-        SAIL_TRY(io->seek(io->stream, -1, SEEK_CUR));
     }
 
     return SAIL_OK;
@@ -229,3 +235,178 @@ sail_status_t bmp_private_fill_system_palette(unsigned bit_count, sail_rgb24_t *
 
     SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_BIT_DEPTH);
 }
+
+sail_status_t bmp_private_write_dib_file_header(struct sail_io *io, const struct SailBmpDibFileHeader *fh) {
+
+    SAIL_TRY(io->strict_write(io->stream, &fh->type,      sizeof(fh->type)));
+    SAIL_TRY(io->strict_write(io->stream, &fh->size,      sizeof(fh->size)));
+    SAIL_TRY(io->strict_write(io->stream, &fh->reserved1, sizeof(fh->reserved1)));
+    SAIL_TRY(io->strict_write(io->stream, &fh->reserved2, sizeof(fh->reserved2)));
+    SAIL_TRY(io->strict_write(io->stream, &fh->offset,    sizeof(fh->offset)));
+
+    return SAIL_OK;
+}
+
+sail_status_t bmp_private_write_v2(struct sail_io *io, const struct SailBmpDibHeaderV2 *v2) {
+
+    SAIL_TRY(io->strict_write(io->stream, &v2->size,      sizeof(v2->size)));
+    SAIL_TRY(io->strict_write(io->stream, &v2->width,     sizeof(v2->width)));
+    SAIL_TRY(io->strict_write(io->stream, &v2->height,    sizeof(v2->height)));
+    SAIL_TRY(io->strict_write(io->stream, &v2->planes,    sizeof(v2->planes)));
+    SAIL_TRY(io->strict_write(io->stream, &v2->bit_count, sizeof(v2->bit_count)));
+
+    return SAIL_OK;
+}
+
+sail_status_t bmp_private_write_v3(struct sail_io *io, const struct SailBmpDibHeaderV3 *v3) {
+
+    SAIL_TRY(io->strict_write(io->stream, &v3->compression,        sizeof(v3->compression)));
+    SAIL_TRY(io->strict_write(io->stream, &v3->bitmap_size,        sizeof(v3->bitmap_size)));
+    SAIL_TRY(io->strict_write(io->stream, &v3->x_pixels_per_meter, sizeof(v3->x_pixels_per_meter)));
+    SAIL_TRY(io->strict_write(io->stream, &v3->y_pixels_per_meter, sizeof(v3->y_pixels_per_meter)));
+    SAIL_TRY(io->strict_write(io->stream, &v3->colors_used,        sizeof(v3->colors_used)));
+    SAIL_TRY(io->strict_write(io->stream, &v3->colors_important,   sizeof(v3->colors_important)));
+
+    return SAIL_OK;
+}
+
+sail_status_t bmp_private_pixel_format_to_bit_count(enum SailPixelFormat pixel_format, uint16_t *bit_count) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP1_INDEXED: *bit_count = 1;  return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP4_INDEXED: *bit_count = 4;  return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP8_INDEXED: *bit_count = 8;  return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP16_BGR555: *bit_count = 16; return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:    *bit_count = 24; return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA:   *bit_count = 32; return SAIL_OK;
+
+        default: {
+            SAIL_LOG_ERROR("BMP: %s pixel format is not currently supported for saving", sail_pixel_format_to_string(pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+    }
+}
+
+sail_status_t bmp_private_write_palette(struct sail_io *io, const struct sail_palette *palette, unsigned max_colors) {
+
+    if (palette == NULL || palette->data == NULL || palette->color_count == 0) {
+        SAIL_LOG_ERROR("BMP: Indexed image has no palette");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MISSING_PALETTE);
+    }
+
+    unsigned channels;
+
+    switch (palette->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:  { channels = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: { channels = 4; break; }
+        default: {
+            SAIL_LOG_ERROR("BMP: %s palette pixel format is not currently supported for saving",
+                            sail_pixel_format_to_string(palette->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+    }
+
+    if (palette->color_count > max_colors) {
+        SAIL_LOG_ERROR("BMP: Palette has %u colors, but the pixel format allows only %u", palette->color_count, max_colors);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    /* BMP stores BGRX quads. */
+    unsigned char quads[256 * 4];
+    const unsigned char *entry = palette->data;
+
+    for (unsigned i = 0; i < palette->color_count; i++, entry += channels) {
+        quads[i * 4 + 0] = entry[2];
+        quads[i * 4 + 1] = entry[1];
+        quads[i * 4 + 2] = entry[0];
+        quads[i * 4 + 3] = 0;
+    }
+
+    SAIL_TRY(io->strict_write(io->stream, quads, (size_t)palette->color_count * 4));
+
+    return SAIL_OK;
+}
+
+/* Writes an absolute run marker, the packed pixels, and the pad byte to align the run to 16 bits. */
+static sail_status_t write_absolute_run(struct sail_buffered_writer *writer, const unsigned char *packed, unsigned count, unsigned packed_size) {
+
+    const uint8_t markers[2] = { SAIL_BMP_UNENCODED_RUN_MARKER, (uint8_t)count };
+    const uint8_t pad = 0;
+
+    SAIL_TRY(sail_buffered_writer_strict_write(writer, markers, sizeof(markers)));
+    SAIL_TRY(sail_buffered_writer_strict_write(writer, packed, packed_size));
+
+    if ((packed_size % 2) != 0) {
+        SAIL_TRY(sail_buffered_writer_strict_write(writer, &pad, sizeof(pad)));
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t bmp_private_write_rle8_row(struct sail_buffered_writer *writer, const unsigned char *indexes, unsigned width) {
+
+    for (unsigned x = 0; x < width;) {
+        const unsigned left = SAIL_MIN(width - x, SAIL_BMP_RLE_MAX_COUNT);
+        const unsigned run  = rle_private_run_length(indexes + x, 1, left);
+
+        if (run < SAIL_BMP_RLE_MIN_ABSOLUTE_COUNT) {
+            const unsigned literal = rle_private_literal_length(indexes + x, 1, left, SAIL_BMP_RLE_MIN_ABSOLUTE_COUNT);
+
+            if (literal >= SAIL_BMP_RLE_MIN_ABSOLUTE_COUNT) {
+                SAIL_TRY(write_absolute_run(writer, indexes + x, literal, literal));
+                x += literal;
+                continue;
+            }
+        }
+
+        /* Encoded run: count + index. */
+        const uint8_t packet[2] = { (uint8_t)run, indexes[x] };
+        SAIL_TRY(sail_buffered_writer_strict_write(writer, packet, sizeof(packet)));
+        x += run;
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t bmp_private_write_rle4_row(struct sail_buffered_writer *writer, const unsigned char *indexes, unsigned width) {
+
+    for (unsigned x = 0; x < width;) {
+        const unsigned left = SAIL_MIN(width - x, SAIL_BMP_RLE_MAX_COUNT);
+        const unsigned run  = rle_private_run_length(indexes + x, 1, left);
+
+        if (run >= SAIL_BMP_RLE_MIN_ABSOLUTE_COUNT) {
+            /* Encoded run of a single index: count + the index in both nibbles. */
+            const uint8_t packet[2] = { (uint8_t)run, (uint8_t)((indexes[x] << 4) | indexes[x]) };
+            SAIL_TRY(sail_buffered_writer_strict_write(writer, packet, sizeof(packet)));
+            x += run;
+            continue;
+        }
+
+        const unsigned literal = rle_private_literal_length(indexes + x, 1, left, SAIL_BMP_RLE_MIN_ABSOLUTE_COUNT);
+
+        if (literal >= SAIL_BMP_RLE_MIN_ABSOLUTE_COUNT) {
+            unsigned char packed[(255 + 1) / 2];
+            const unsigned packed_size = (literal + 1) / 2;
+
+            for (unsigned i = 0; i < packed_size; i++) {
+                const unsigned char high = indexes[x + i * 2];
+                const unsigned char low  = (i * 2 + 1 < literal) ? indexes[x + i * 2 + 1] : 0;
+
+                packed[i] = (unsigned char)((high << 4) | low);
+            }
+
+            SAIL_TRY(write_absolute_run(writer, packed, literal, packed_size));
+            x += literal;
+        } else {
+            /* One or two pixels: encoded run that alternates the two nibbles. */
+            const unsigned count = SAIL_MIN(width - x, 2U);
+            const unsigned char low = (count == 2) ? indexes[x + 1] : 0;
+
+            const uint8_t packet[2] = { (uint8_t)count, (uint8_t)((indexes[x] << 4) | low) };
+            SAIL_TRY(sail_buffered_writer_strict_write(writer, packet, sizeof(packet)));
+            x += count;
+        }
+    }
+
+    return SAIL_OK;
+}
@@ -33,8 +33,11 @@
 #include <sail-common/pixel.h>
 #include <sail-common/status.h>
 
+struct sail_buffered_reader;
+struct sail_buffered_writer;
 struct sail_iccp;
 struct sail_io;
+struct sail_palette;
 
 /* RLE markers. */
 enum
@@ -157,7 +160,7 @@ SAIL_HIDDEN sail_status_t bmp_private_bit_count_to_pixel_format(uint16_t bit_cou
 
 SAIL_HIDDEN sail_status_t bmp_private_fetch_iccp(struct sail_io *io, long offset_of_data, uint32_t profile_size, struct sail_iccp **iccp);
 
-SAIL_HIDDEN sail_status_t bmp_private_skip_end_of_scan_line(struct sail_io *io);
+SAIL_HIDDEN sail_status_t bmp_private_skip_end_of_scan_line(struct sail_buffered_reader *reader);
 
 SAIL_HIDDEN sail_status_t bmp_private_bytes_in_row(unsigned width, unsigned bit_count, unsigned *bytes_in_row);
 
@@ -165,4 +168,18 @@ SAIL_HIDDEN unsigned bmp_private_pad_bytes(unsigned bytes_in_row);
 
 SAIL_HIDDEN sail_status_t bmp_private_fill_system_palette(unsigned bit_count, sail_rgb24_t **palette, unsigned *palette_count);
 
+SAIL_HIDDEN sail_status_t bmp_private_write_dib_file_header(struct sail_io *io, const struct SailBmpDibFileHeader *fh);
+
+SAIL_HIDDEN sail_status_t bmp_private_write_v2(struct sail_io *io, const struct SailBmpDibHeaderV2 *v2);
+
+SAIL_HIDDEN sail_status_t bmp_private_write_v3(struct sail_io *io, const struct SailBmpDibHeaderV3 *v3);
+
+SAIL_HIDDEN sail_status_t bmp_private_pixel_format_to_bit_count(enum SailPixelFormat pixel_format, uint16_t *bit_count);
+
+SAIL_HIDDEN sail_status_t bmp_private_write_palette(struct sail_io *io, const struct sail_palette *palette, unsigned max_colors);
+
+SAIL_HIDDEN sail_status_t bmp_private_write_rle8_row(struct sail_buffered_writer *writer, const unsigned char *indexes, unsigned width);
+
+SAIL_HIDDEN sail_status_t bmp_private_write_rle4_row(struct sail_buffered_writer *writer, const unsigned char *indexes, unsigned width);
+
 #endif
@@ -0,0 +1,131 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rle.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SAIL_RLE_SSE2
+
+    #include <emmintrin.h>
+#endif
+
+/* Returns the number of leading bytes equal in both buffers. */
+static size_t equal_prefix(const unsigned char *a, const unsigned char *b, size_t size) {
+
+    size_t i = 0;
+
+#ifdef SAIL_RLE_SSE2
+    for (; i + 16 <= size; i += 16) {
+        const __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF) {
+            break;
+        }
+    }
+#endif
+
+    for (; i + 8 <= size; i += 8) {
+        uint64_t wa;
+        uint64_t wb;
+        memcpy(&wa, a + i, sizeof(wa));
+        memcpy(&wb, b + i, sizeof(wb));
+
+        if (wa != wb) {
+            break;
+        }
+    }
+
+    /* Locate the exact mismatch. */
+    for (; i < size && a[i] == b[i]; i++) {
+    }
+
+    return i;
+}
+
+unsigned rle_private_run_length(const unsigned char *pixels, unsigned pixel_size, unsigned max_pixels) {
+
+    if (max_pixels <= 1) {
+        return max_pixels;
+    }
+
+    /* Pixels [0, N) are identical when bytes [0, N-1) equal bytes [1, N) shifted by one pixel. */
+    const size_t equal = equal_prefix(pixels, pixels + pixel_size, (size_t)(max_pixels - 1) * pixel_size);
+
+    return 1 + (unsigned)(equal / pixel_size);
+}
+
+unsigned rle_private_literal_length(const unsigned char *pixels, unsigned pixel_size, unsigned max_pixels, unsigned min_run) {
+
+    unsigned length = 0;
+
+    while (length < max_pixels) {
+        const unsigned left = max_pixels - length;
+
+        if (left < min_run) {
+            return max_pixels;
+        }
+
+        const unsigned run = rle_private_run_length(pixels + (size_t)length * pixel_size, pixel_size, min_run);
+
+        if (run >= min_run) {
+            break;
+        }
+
+        /* The pixels of a short run can't start a long run. */
+        length += run;
+    }
+
+    return length;
+}
+
+void rle_private_fill(unsigned char *target, const unsigned char *pixel, unsigned pixel_size, unsigned count) {
+
+    if (count == 0) {
+        return;
+    }
+
+    if (pixel_size == 1) {
+        memset(target, pixel[0], count);
+        return;
+    }
+
+    const size_t total = (size_t)count * pixel_size;
+    size_t filled = pixel_size;
+
+    memcpy(target, pixel, pixel_size);
+
+    /* Copy the already filled part, so the number of calls is logarithmic. */
+    while (filled < total) {
+        const size_t chunk = (filled <= total - filled) ? filled : (total - filled);
+
+        memcpy(target + filled, target, chunk);
+        filled += chunk;
+    }
+}
@@ -0,0 +1,56 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_RLE_COMMON_H
+#define SAIL_RLE_COMMON_H
+
+#include <sail-common/export.h>
+
+/*
+ * Shared run detection for RLE encoders and run filling for RLE decoders. BMP, TGA, and PCX
+ * encoders split scan lines into runs of identical pixels and literal spans between them.
+ * Pixels are compared by 16 or 8 bytes at a time, so long runs and long literal spans are
+ * scanned quickly.
+ */
+
+/*
+ * Returns the number of identical pixels of 'pixel_size' bytes starting at 'pixels',
+ * but not more than 'max_pixels'. Returns at least 1 if 'max_pixels' is not 0.
+ */
+SAIL_HIDDEN unsigned rle_private_run_length(const unsigned char *pixels, unsigned pixel_size, unsigned max_pixels);
+
+/*
+ * Returns the number of pixels starting at 'pixels' before the next run of at least 'min_run'
+ * identical pixels, but not more than 'max_pixels'. Returns 0 if such a run starts at 'pixels'.
+ */
+SAIL_HIDDEN unsigned rle_private_literal_length(const unsigned char *pixels, unsigned pixel_size, unsigned max_pixels, unsigned min_run);
+
+/*
+ * Fills 'count' pixels of 'pixel_size' bytes at 'target' with the specified pixel.
+ * Single-byte pixels are filled with memset(), wider pixels with doubling memcpy() calls.
+ */
+SAIL_HIDDEN void rle_private_fill(unsigned char *target, const unsigned char *pixel, unsigned pixel_size, unsigned count);
+
+#endif
@@ -0,0 +1,98 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stddef.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "row_cursor.h"
+
+void row_cursor_private_init(struct row_cursor *cursor, const struct sail_image *image,
+                             unsigned pixel_size, bool flipped_v, bool flipped_h) {
+
+    cursor->pixels         = image->pixels;
+    cursor->width          = image->width;
+    cursor->height         = image->height;
+    cursor->bytes_per_line = image->bytes_per_line;
+    cursor->pixel_size     = pixel_size;
+    cursor->flipped_v      = flipped_v;
+    cursor->flipped_h      = flipped_h;
+    cursor->row            = 0;
+    cursor->column         = 0;
+}
+
+unsigned row_cursor_private_destination_row(const struct row_cursor *cursor, unsigned row) {
+
+    return cursor->flipped_v ? cursor->height - 1 - row : row;
+}
+
+unsigned char* row_cursor_private_next(struct row_cursor *cursor, unsigned max_pixels, unsigned *pixels) {
+
+    if (cursor->row >= cursor->height) {
+        *pixels = 0;
+        return NULL;
+    }
+
+    const unsigned count = SAIL_MIN(max_pixels, cursor->width - cursor->column);
+
+    /* Right-to-left pixels fill the row from its end. */
+    const unsigned column = cursor->flipped_h ? cursor->width - cursor->column - count : cursor->column;
+
+    unsigned char *span = cursor->pixels
+                            + (size_t)row_cursor_private_destination_row(cursor, cursor->row) * cursor->bytes_per_line
+                            + (size_t)column * cursor->pixel_size;
+
+    cursor->column += count;
+
+    if (cursor->column == cursor->width) {
+        cursor->row++;
+        cursor->column = 0;
+    }
+
+    *pixels = count;
+
+    return span;
+}
+
+void row_cursor_private_reverse(const struct row_cursor *cursor, unsigned char *span, unsigned pixels) {
+
+    if (!cursor->flipped_h || pixels < 2) {
+        return;
+    }
+
+    const unsigned pixel_size = cursor->pixel_size;
+
+    unsigned char *left  = span;
+    unsigned char *right = span + (size_t)(pixels - 1) * pixel_size;
+
+    for (; left < right; left += pixel_size, right -= pixel_size) {
+        unsigned char pixel[8];
+
+        memcpy(pixel, left,  pixel_size);
+        memcpy(left,  right, pixel_size);
+        memcpy(right, pixel, pixel_size);
+    }
+}
@@ -0,0 +1,74 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ROW_CURSOR_COMMON_H
+#define SAIL_ROW_CURSOR_COMMON_H
+
+#include <stdbool.h>
+
+#include <sail-common/export.h>
+
+struct sail_image;
+
+/*
+ * Maps pixels of bottom-up and right-to-left encoded images to their final positions, so decoders
+ * write every row straight into its destination scan line and don't mirror the whole frame
+ * afterwards. Rows and pixels are consumed in the file order.
+ */
+struct row_cursor {
+    unsigned char *pixels;
+    unsigned width;
+    unsigned height;
+    unsigned bytes_per_line;
+    unsigned pixel_size;
+    bool flipped_v; /* Rows are stored bottom-up. */
+    bool flipped_h; /* Pixels are stored right-to-left. */
+
+    unsigned row;    /* Current row in the file order. */
+    unsigned column; /* Number of pixels of the current row already consumed. */
+};
+
+/*
+ * Initializes the cursor to consume pixels of up to 8 bytes of the image pixels
+ * starting with the first row in the file order.
+ */
+SAIL_HIDDEN void row_cursor_private_init(struct row_cursor *cursor, const struct sail_image *image,
+                                         unsigned pixel_size, bool flipped_v, bool flipped_h);
+
+/* Returns the destination row of the row in the file order. */
+SAIL_HIDDEN unsigned row_cursor_private_destination_row(const struct row_cursor *cursor, unsigned row);
+
+/*
+ * Returns the destination of the next 'max_pixels' pixels in the file order or less if the current row
+ * ends earlier, and saves their number into 'pixels'. The destination is the leftmost pixel,
+ * so right-to-left pixels written in the file order must be reversed with row_cursor_private_reverse().
+ * Moves to the next row when the current one is consumed. Returns NULL when all the rows are consumed.
+ */
+SAIL_HIDDEN unsigned char* row_cursor_private_next(struct row_cursor *cursor, unsigned max_pixels, unsigned *pixels);
+
+/* Reverses the order of the pixels returned by row_cursor_private_next() for right-to-left images. */
+SAIL_HIDDEN void row_cursor_private_reverse(const struct row_cursor *cursor, unsigned char *span, unsigned pixels);
+
+#endif
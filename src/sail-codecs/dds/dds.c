@@ -0,0 +1,359 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <sail-common/sail-common.h>
+
+#include "helpers.h"
+
+/* DDS_HEADER flags and capabilities checked when loading. */
+#define DDSD_MIPMAPCOUNT 0x20000
+#define DDSCAPS2_CUBEMAP 0x200
+#define DDSCAPS2_VOLUME  0x200000
+
+#define DDS_DIMENSION_TEXTURE2D       3
+#define DDS_RESOURCE_MISC_TEXTURECUBE 0x4
+
+/*
+ * Codec-specific state.
+ */
+struct dds_state {
+    struct sail_io *io;
+    const struct sail_load_options *load_options;
+    const struct sail_save_options *save_options;
+
+    unsigned frame_number;
+
+    struct dds_private_header header;
+    enum SailPixelFormat pixel_format;
+    unsigned width;
+    unsigned height;
+
+    /* Number of mip levels in the file when loading, or written so far when saving. */
+    unsigned mip_levels;
+    /* Offset of the first mip level when loading, or of the header when saving. */
+    size_t offset;
+};
+
+static sail_status_t alloc_dds_state(struct sail_io *io,
+                                        const struct sail_load_options *load_options,
+                                        const struct sail_save_options *save_options,
+                                        struct dds_state **dds_state) {
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct dds_state), &ptr));
+    *dds_state = ptr;
+
+    **dds_state = (struct dds_state) {
+        .io           = io,
+        .load_options = load_options,
+        .save_options = save_options,
+
+        .frame_number = 0,
+        .pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN,
+        .width        = 0,
+        .height       = 0,
+        .mip_levels   = 0,
+        .offset       = 0,
+    };
+
+    return SAIL_OK;
+}
+
+static void destroy_dds_state(struct dds_state *dds_state) {
+
+    if (dds_state == NULL) {
+        return;
+    }
+
+    sail_free(dds_state);
+}
+
+/* Returns the dimension of the mip level. Every level is half the size of the previous one. */
+static unsigned mip_dimension(unsigned dimension, unsigned level) {
+
+    const unsigned value = (level < 32) ? dimension >> level : 0;
+
+    return (value > 0) ? value : 1;
+}
+
+/* Returns the number of levels in the full mip chain. */
+static unsigned full_mip_chain_length(unsigned width, unsigned height) {
+
+    unsigned levels = 1;
+
+    while (width > 1 || height > 1) {
+        width  = (width > 1)  ? width / 2  : 1;
+        height = (height > 1) ? height / 2 : 1;
+        levels++;
+    }
+
+    return levels;
+}
+
+/*
+ * Decoding functions.
+ */
+
+SAIL_EXPORT sail_status_t sail_codec_load_init_v8_dds(struct sail_io *io, const struct sail_load_options *load_options, void **state) {
+
+    *state = NULL;
+
+    /* Allocate a new state. */
+    struct dds_state *dds_state;
+    SAIL_TRY(alloc_dds_state(io, load_options, NULL, &dds_state));
+    *state = dds_state;
+
+    struct dds_private_header *header = &dds_state->header;
+    SAIL_TRY(dds_private_read_header(dds_state->io, header));
+
+    if ((header->caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) || (header->has_dx10 &&
+            (header->resource_dimension != DDS_DIMENSION_TEXTURE2D || (header->misc_flag & DDS_RESOURCE_MISC_TEXTURECUBE) || header->array_size > 1))) {
+        SAIL_LOG_ERROR("DDS: Only 2D textures are supported, but not cube maps, volumes, and arrays");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
+    }
+
+    dds_state->pixel_format = dds_private_sail_pixel_format(header);
+
+    if (dds_state->pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN) {
+        if (header->has_dx10) {
+            SAIL_LOG_ERROR("DDS: DXGI format %u is not supported", header->dxgi_format);
+        } else {
+            SAIL_LOG_ERROR("DDS: Pixel format with flags 0x%X, FourCC 0x%X, and %u bits per pixel is not supported",
+                            header->pixel_format.flags, header->pixel_format.four_cc, header->pixel_format.rgb_bit_count);
+        }
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    if (sail_is_block_compressed(dds_state->pixel_format) && (header->width % 4 != 0 || header->height % 4 != 0)) {
+        SAIL_LOG_ERROR("DDS: Block-compressed textures must have dimensions multiple of 4, but the texture is %ux%u", header->width, header->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    const unsigned full_mip_levels = full_mip_chain_length(header->width, header->height);
+
+    dds_state->width      = header->width;
+    dds_state->height     = header->height;
+    dds_state->mip_levels = ((header->flags & DDSD_MIPMAPCOUNT) && header->mip_map_count > 0) ? header->mip_map_count : 1;
+    dds_state->mip_levels = (dds_state->mip_levels > full_mip_levels) ? full_mip_levels : dds_state->mip_levels;
+
+    SAIL_TRY(dds_state->io->tell(dds_state->io->stream, &dds_state->offset));
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_dds(void *state, struct sail_image **image) {
+
+    struct dds_state *dds_state = state;
+
+    if (dds_state->frame_number >= dds_state->mip_levels) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    const unsigned width  = mip_dimension(dds_state->width,  dds_state->frame_number);
+    const unsigned height = mip_dimension(dds_state->height, dds_state->frame_number);
+
+    /* Block-compressed frames consist of whole blocks, so smaller mip levels are not exposed. */
+    if (sail_is_block_compressed(dds_state->pixel_format) && (width % 4 != 0 || height % 4 != 0)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    size_t offset = dds_state->offset;
+
+    for (unsigned level = 0; level < dds_state->frame_number; level++) {
+        offset += dds_private_level_size(dds_state->pixel_format,
+                                         mip_dimension(dds_state->width,  level),
+                                         mip_dimension(dds_state->height, level));
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    if (dds_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&image_local->source_image),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        image_local->source_image->pixel_format = dds_state->pixel_format;
+        image_local->source_image->compression  = SAIL_COMPRESSION_NONE;
+    }
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->pixel_format   = dds_state->pixel_format;
+    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_io_will_need(dds_state->io, offset, (size_t)image_local->bytes_per_line * image_local->height),
+                        /* cleanup */ sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(dds_state->io->seek(dds_state->io->stream, (long)offset, SEEK_SET),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    dds_state->frame_number++;
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_seek_frame_v8_dds(void *state, unsigned frame) {
+
+    struct dds_state *dds_state = state;
+
+    /* The offsets of mip levels follow from their sizes, so seek to any of them directly. */
+    if (frame >= dds_state->mip_levels) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    dds_state->frame_number = frame;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_dds(void *state, struct sail_image *image) {
+
+    struct dds_state *dds_state = state;
+
+    SAIL_TRY(dds_state->io->strict_read(dds_state->io->stream, image->pixels, (size_t)image->bytes_per_line * image->height));
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_dds(void **state) {
+
+    struct dds_state *dds_state = *state;
+
+    *state = NULL;
+
+    destroy_dds_state(dds_state);
+
+    return SAIL_OK;
+}
+
+/*
+ * Encoding functions.
+ */
+
+SAIL_EXPORT sail_status_t sail_codec_save_init_v8_dds(struct sail_io *io, const struct sail_save_options *save_options, void **state) {
+
+    *state = NULL;
+
+    struct dds_state *dds_state;
+    SAIL_TRY(alloc_dds_state(io, NULL, save_options, &dds_state));
+    *state = dds_state;
+
+    /* Sanity check. */
+    if (dds_state->save_options->compression != SAIL_COMPRESSION_NONE) {
+        SAIL_LOG_ERROR("DDS: Only NONE compression is allowed for saving, block-compressed pixel formats are saved as is");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_dds(void *state, const struct sail_image *image) {
+
+    struct dds_state *dds_state = state;
+
+    /* The first frame is the texture, and the next frames are its mip levels. */
+    if (dds_state->frame_number == 0) {
+        if (!dds_private_supported_pixel_format(image->pixel_format)) {
+            SAIL_LOG_ERROR("DDS: %s pixel format is not currently supported for saving", sail_pixel_format_to_string(image->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+
+        dds_state->pixel_format = image->pixel_format;
+        dds_state->width        = image->width;
+        dds_state->height       = image->height;
+
+        SAIL_TRY(dds_state->io->tell(dds_state->io->stream, &dds_state->offset));
+        SAIL_TRY(dds_private_write_header(dds_state->io, image->pixel_format, image->width, image->height, 1));
+    } else {
+        if (dds_state->frame_number >= full_mip_chain_length(dds_state->width, dds_state->height)) {
+            SAIL_LOG_ERROR("DDS: The mip chain of %u levels is complete", dds_state->frame_number);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+        }
+
+        const unsigned width  = mip_dimension(dds_state->width,  dds_state->frame_number);
+        const unsigned height = mip_dimension(dds_state->height, dds_state->frame_number);
+
+        if (image->pixel_format != dds_state->pixel_format) {
+            SAIL_LOG_ERROR("DDS: Mip level %u must have %s pixel format", dds_state->frame_number, sail_pixel_format_to_string(dds_state->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+        if (image->width != width || image->height != height) {
+            SAIL_LOG_ERROR("DDS: Mip level %u must be %ux%u, but the frame is %ux%u", dds_state->frame_number, width, height, image->width, image->height);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+        }
+    }
+
+    dds_state->frame_number++;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_dds(void *state, const struct sail_image *image) {
+
+    struct dds_state *dds_state = state;
+
+    /* Mip levels are tightly packed. */
+    const unsigned bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        SAIL_TRY(dds_state->io->strict_write(dds_state->io->stream, sail_scan_line(image, row), bytes_per_line));
+    }
+
+    dds_state->mip_levels++;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_dds(void **state) {
+
+    struct dds_state *dds_state = *state;
+
+    /* Subsequent calls to finish() will expectedly fail in the above line. */
+    *state = NULL;
+
+    /* Update the number of mip levels in the header. */
+    if (dds_state->mip_levels > 1) {
+        size_t end_offset;
+        SAIL_TRY_OR_CLEANUP(dds_state->io->tell(dds_state->io->stream, &end_offset),
+                            /* cleanup */ destroy_dds_state(dds_state));
+        SAIL_TRY_OR_CLEANUP(dds_state->io->seek(dds_state->io->stream, (long)dds_state->offset, SEEK_SET),
+                            /* cleanup */ destroy_dds_state(dds_state));
+        SAIL_TRY_OR_CLEANUP(dds_private_write_header(dds_state->io, dds_state->pixel_format, dds_state->width, dds_state->height, dds_state->mip_levels),
+                            /* cleanup */ destroy_dds_state(dds_state));
+        SAIL_TRY_OR_CLEANUP(dds_state->io->seek(dds_state->io->stream, (long)end_offset, SEEK_SET),
+                            /* cleanup */ destroy_dds_state(dds_state));
+    }
+
+    destroy_dds_state(dds_state);
+
+    return SAIL_OK;
+}
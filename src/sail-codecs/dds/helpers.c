@@ -0,0 +1,353 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "helpers.h"
+
+#define DDS_FOURCC(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+#define DDS_MAGIC DDS_FOURCC('D', 'D', 'S', ' ')
+
+/* DDS_HEADER flags. */
+#define DDSD_CAPS        0x1
+#define DDSD_HEIGHT      0x2
+#define DDSD_WIDTH       0x4
+#define DDSD_PITCH       0x8
+#define DDSD_PIXELFORMAT 0x1000
+#define DDSD_MIPMAPCOUNT 0x20000
+#define DDSD_LINEARSIZE  0x80000
+
+/* DDS_PIXELFORMAT flags. */
+#define DDPF_ALPHAPIXELS 0x1
+#define DDPF_FOURCC      0x4
+#define DDPF_RGB         0x40
+#define DDPF_LUMINANCE   0x20000
+
+/* DDS_HEADER capabilities. */
+#define DDSCAPS_COMPLEX 0x8
+#define DDSCAPS_TEXTURE 0x1000
+#define DDSCAPS_MIPMAP  0x400000
+
+#define DDS_DIMENSION_TEXTURE2D 3
+
+/* DXGI_FORMAT values of the supported pixel formats. */
+enum DxgiFormat {
+    DXGI_FORMAT_R16G16B16A16_UNORM  = 11,
+    DXGI_FORMAT_R8G8B8A8_UNORM      = 28,
+    DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29,
+    DXGI_FORMAT_R8_UNORM            = 61,
+    DXGI_FORMAT_BC1_UNORM           = 71,
+    DXGI_FORMAT_BC1_UNORM_SRGB      = 72,
+    DXGI_FORMAT_BC2_UNORM           = 74,
+    DXGI_FORMAT_BC2_UNORM_SRGB      = 75,
+    DXGI_FORMAT_BC3_UNORM           = 77,
+    DXGI_FORMAT_BC3_UNORM_SRGB      = 78,
+    DXGI_FORMAT_BC4_UNORM           = 80,
+    DXGI_FORMAT_BC5_UNORM           = 83,
+    DXGI_FORMAT_B8G8R8A8_UNORM      = 87,
+    DXGI_FORMAT_B8G8R8X8_UNORM      = 88,
+    DXGI_FORMAT_B8G8R8A8_UNORM_SRGB = 91,
+    DXGI_FORMAT_B8G8R8X8_UNORM_SRGB = 93,
+    DXGI_FORMAT_BC7_UNORM           = 98,
+    DXGI_FORMAT_BC7_UNORM_SRGB      = 99,
+};
+
+static uint32_t read_le32(const unsigned char *bytes) {
+
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+static void write_le32(unsigned char *bytes, uint32_t v) {
+
+    bytes[0] = (unsigned char)v;
+    bytes[1] = (unsigned char)(v >> 8);
+    bytes[2] = (unsigned char)(v >> 16);
+    bytes[3] = (unsigned char)(v >> 24);
+}
+
+/* Fills the legacy pixel format, or returns false if the pixel format needs the DX10 header. */
+static bool legacy_pixel_format(enum SailPixelFormat pixel_format, struct dds_private_pixel_format *dds_pixel_format) {
+
+    memset(dds_pixel_format, 0, sizeof(*dds_pixel_format));
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP4_BC1: dds_pixel_format->flags = DDPF_FOURCC; dds_pixel_format->four_cc = DDS_FOURCC('D', 'X', 'T', '1'); break;
+        case SAIL_PIXEL_FORMAT_BPP8_BC2: dds_pixel_format->flags = DDPF_FOURCC; dds_pixel_format->four_cc = DDS_FOURCC('D', 'X', 'T', '3'); break;
+        case SAIL_PIXEL_FORMAT_BPP8_BC3: dds_pixel_format->flags = DDPF_FOURCC; dds_pixel_format->four_cc = DDS_FOURCC('D', 'X', 'T', '5'); break;
+        case SAIL_PIXEL_FORMAT_BPP4_BC4: dds_pixel_format->flags = DDPF_FOURCC; dds_pixel_format->four_cc = DDS_FOURCC('A', 'T', 'I', '1'); break;
+        case SAIL_PIXEL_FORMAT_BPP8_BC5: dds_pixel_format->flags = DDPF_FOURCC; dds_pixel_format->four_cc = DDS_FOURCC('A', 'T', 'I', '2'); break;
+
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: {
+            dds_pixel_format->flags         = DDPF_LUMINANCE;
+            dds_pixel_format->rgb_bit_count = 8;
+            dds_pixel_format->r_mask        = 0xFF;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_BGR: {
+            dds_pixel_format->flags         = DDPF_RGB;
+            dds_pixel_format->rgb_bit_count = 24;
+            dds_pixel_format->r_mask        = 0xFF0000;
+            dds_pixel_format->g_mask        = 0xFF00;
+            dds_pixel_format->b_mask        = 0xFF;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: {
+            dds_pixel_format->flags         = DDPF_RGB | DDPF_ALPHAPIXELS;
+            dds_pixel_format->rgb_bit_count = 32;
+            dds_pixel_format->r_mask        = 0xFF0000;
+            dds_pixel_format->g_mask        = 0xFF00;
+            dds_pixel_format->b_mask        = 0xFF;
+            dds_pixel_format->a_mask        = 0xFF000000;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: {
+            dds_pixel_format->flags         = DDPF_RGB | DDPF_ALPHAPIXELS;
+            dds_pixel_format->rgb_bit_count = 32;
+            dds_pixel_format->r_mask        = 0xFF;
+            dds_pixel_format->g_mask        = 0xFF00;
+            dds_pixel_format->b_mask        = 0xFF0000;
+            dds_pixel_format->a_mask        = 0xFF000000;
+            break;
+        }
+
+        default: {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static enum SailPixelFormat dxgi_to_sail_pixel_format(uint32_t dxgi_format) {
+
+    switch (dxgi_format) {
+        case DXGI_FORMAT_R16G16B16A16_UNORM:  return SAIL_PIXEL_FORMAT_BPP64_RGBA;
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB: return SAIL_PIXEL_FORMAT_BPP32_RGBA;
+        case DXGI_FORMAT_R8_UNORM:            return SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:      return SAIL_PIXEL_FORMAT_BPP4_BC1;
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:      return SAIL_PIXEL_FORMAT_BPP8_BC2;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:      return SAIL_PIXEL_FORMAT_BPP8_BC3;
+        case DXGI_FORMAT_BC4_UNORM:           return SAIL_PIXEL_FORMAT_BPP4_BC4;
+        case DXGI_FORMAT_BC5_UNORM:           return SAIL_PIXEL_FORMAT_BPP8_BC5;
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB: return SAIL_PIXEL_FORMAT_BPP32_BGRA;
+        case DXGI_FORMAT_B8G8R8X8_UNORM:
+        case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB: return SAIL_PIXEL_FORMAT_BPP32_BGRX;
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:      return SAIL_PIXEL_FORMAT_BPP8_BC7;
+
+        default: return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t dds_private_read_header(struct sail_io *io, struct dds_private_header *header) {
+
+    unsigned char bytes[DDS_MAGIC_SIZE + DDS_HEADER_SIZE];
+    SAIL_TRY(io->strict_read(io->stream, bytes, sizeof(bytes)));
+
+    if (read_le32(bytes) != DDS_MAGIC || read_le32(bytes + 4) != DDS_HEADER_SIZE) {
+        SAIL_LOG_ERROR("DDS: Invalid magic number or header size");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    const unsigned char *ptr = bytes + DDS_MAGIC_SIZE;
+
+    *header = (struct dds_private_header) {
+        .flags         = read_le32(ptr + 4),
+        .height        = read_le32(ptr + 8),
+        .width         = read_le32(ptr + 12),
+        .depth         = read_le32(ptr + 20),
+        .mip_map_count = read_le32(ptr + 24),
+        .pixel_format  = {
+            .flags         = read_le32(ptr + 76),
+            .four_cc       = read_le32(ptr + 80),
+            .rgb_bit_count = read_le32(ptr + 84),
+            .r_mask        = read_le32(ptr + 88),
+            .g_mask        = read_le32(ptr + 92),
+            .b_mask        = read_le32(ptr + 96),
+            .a_mask        = read_le32(ptr + 100),
+        },
+        .caps          = read_le32(ptr + 104),
+        .caps2         = read_le32(ptr + 108),
+
+        .has_dx10      = false,
+    };
+
+    if (header->width == 0 || header->height == 0) {
+        SAIL_LOG_ERROR("DDS: Image dimensions %ux%u are invalid", header->width, header->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    if ((header->pixel_format.flags & DDPF_FOURCC) && header->pixel_format.four_cc == DDS_FOURCC('D', 'X', '1', '0')) {
+        unsigned char bytes_dx10[DDS_HEADER_DX10_SIZE];
+        SAIL_TRY(io->strict_read(io->stream, bytes_dx10, sizeof(bytes_dx10)));
+
+        header->has_dx10           = true;
+        header->dxgi_format        = read_le32(bytes_dx10);
+        header->resource_dimension = read_le32(bytes_dx10 + 4);
+        header->misc_flag          = read_le32(bytes_dx10 + 8);
+        header->array_size         = read_le32(bytes_dx10 + 12);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t dds_private_write_header(struct sail_io *io, enum SailPixelFormat pixel_format,
+                                       unsigned width, unsigned height, unsigned mip_levels) {
+
+    struct dds_private_pixel_format dds_pixel_format;
+    const bool has_dx10 = !legacy_pixel_format(pixel_format, &dds_pixel_format);
+
+    if (has_dx10) {
+        dds_pixel_format.flags   = DDPF_FOURCC;
+        dds_pixel_format.four_cc = DDS_FOURCC('D', 'X', '1', '0');
+    }
+
+    const bool compressed = sail_is_block_compressed(pixel_format);
+
+    uint32_t flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | (compressed ? DDSD_LINEARSIZE : DDSD_PITCH);
+    uint32_t caps  = DDSCAPS_TEXTURE;
+
+    if (mip_levels > 1) {
+        flags |= DDSD_MIPMAPCOUNT;
+        caps  |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+    }
+
+    unsigned char bytes[DDS_MAGIC_SIZE + DDS_HEADER_SIZE + DDS_HEADER_DX10_SIZE];
+    memset(bytes, 0, sizeof(bytes));
+
+    unsigned char *ptr = bytes + DDS_MAGIC_SIZE;
+
+    write_le32(bytes,      DDS_MAGIC);
+    write_le32(ptr,        DDS_HEADER_SIZE);
+    write_le32(ptr + 4,    flags);
+    write_le32(ptr + 8,    height);
+    write_le32(ptr + 12,   width);
+    write_le32(ptr + 16,   compressed ? (uint32_t)dds_private_level_size(pixel_format, width, height)
+                                      : sail_bytes_per_line(width, pixel_format));
+    write_le32(ptr + 24,   mip_levels);
+    write_le32(ptr + 72,   32);
+    write_le32(ptr + 76,   dds_pixel_format.flags);
+    write_le32(ptr + 80,   dds_pixel_format.four_cc);
+    write_le32(ptr + 84,   dds_pixel_format.rgb_bit_count);
+    write_le32(ptr + 88,   dds_pixel_format.r_mask);
+    write_le32(ptr + 92,   dds_pixel_format.g_mask);
+    write_le32(ptr + 96,   dds_pixel_format.b_mask);
+    write_le32(ptr + 100,  dds_pixel_format.a_mask);
+    write_le32(ptr + 104,  caps);
+
+    if (has_dx10) {
+        unsigned char *ptr_dx10 = ptr + DDS_HEADER_SIZE;
+
+        write_le32(ptr_dx10,      DXGI_FORMAT_BC7_UNORM);
+        write_le32(ptr_dx10 + 4,  DDS_DIMENSION_TEXTURE2D);
+        write_le32(ptr_dx10 + 12, 1);
+    }
+
+    SAIL_TRY(io->strict_write(io->stream, bytes, has_dx10 ? sizeof(bytes) : sizeof(bytes) - DDS_HEADER_DX10_SIZE));
+
+    return SAIL_OK;
+}
+
+enum SailPixelFormat dds_private_sail_pixel_format(const struct dds_private_header *header) {
+
+    if (header->has_dx10) {
+        return dxgi_to_sail_pixel_format(header->dxgi_format);
+    }
+
+    const struct dds_private_pixel_format *pf = &header->pixel_format;
+
+    if (pf->flags & DDPF_FOURCC) {
+        switch (pf->four_cc) {
+            case DDS_FOURCC('D', 'X', 'T', '1'): return SAIL_PIXEL_FORMAT_BPP4_BC1;
+            case DDS_FOURCC('D', 'X', 'T', '2'):
+            case DDS_FOURCC('D', 'X', 'T', '3'): return SAIL_PIXEL_FORMAT_BPP8_BC2;
+            case DDS_FOURCC('D', 'X', 'T', '4'):
+            case DDS_FOURCC('D', 'X', 'T', '5'): return SAIL_PIXEL_FORMAT_BPP8_BC3;
+            case DDS_FOURCC('A', 'T', 'I', '1'):
+            case DDS_FOURCC('B', 'C', '4', 'U'): return SAIL_PIXEL_FORMAT_BPP4_BC4;
+            case DDS_FOURCC('A', 'T', 'I', '2'):
+            case DDS_FOURCC('B', 'C', '5', 'U'): return SAIL_PIXEL_FORMAT_BPP8_BC5;
+
+            default: return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+    }
+
+    const bool alpha = (pf->flags & DDPF_ALPHAPIXELS) && pf->a_mask != 0;
+
+    if (pf->flags & DDPF_RGB) {
+        if (pf->rgb_bit_count == 32 && pf->r_mask == 0xFF0000 && pf->g_mask == 0xFF00 && pf->b_mask == 0xFF) {
+            return (alpha && pf->a_mask == 0xFF000000) ? SAIL_PIXEL_FORMAT_BPP32_BGRA : SAIL_PIXEL_FORMAT_BPP32_BGRX;
+        }
+        if (pf->rgb_bit_count == 32 && pf->r_mask == 0xFF && pf->g_mask == 0xFF00 && pf->b_mask == 0xFF0000) {
+            return (alpha && pf->a_mask == 0xFF000000) ? SAIL_PIXEL_FORMAT_BPP32_RGBA : SAIL_PIXEL_FORMAT_BPP32_RGBX;
+        }
+        if (pf->rgb_bit_count == 24 && pf->r_mask == 0xFF0000 && pf->g_mask == 0xFF00 && pf->b_mask == 0xFF) {
+            return SAIL_PIXEL_FORMAT_BPP24_BGR;
+        }
+        if (pf->rgb_bit_count == 24 && pf->r_mask == 0xFF && pf->g_mask == 0xFF00 && pf->b_mask == 0xFF0000) {
+            return SAIL_PIXEL_FORMAT_BPP24_RGB;
+        }
+    } else if (pf->flags & DDPF_LUMINANCE) {
+        if (pf->rgb_bit_count == 8 && pf->r_mask == 0xFF) {
+            return SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
+        }
+        if (pf->rgb_bit_count == 16 && pf->r_mask == 0xFF && alpha && pf->a_mask == 0xFF00) {
+            return SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA;
+        }
+    }
+
+    return SAIL_PIXEL_FORMAT_UNKNOWN;
+}
+
+bool dds_private_supported_pixel_format(enum SailPixelFormat pixel_format) {
+
+    struct dds_private_pixel_format dds_pixel_format;
+
+    return legacy_pixel_format(pixel_format, &dds_pixel_format) || pixel_format == SAIL_PIXEL_FORMAT_BPP8_BC7;
+}
+
+size_t dds_private_level_size(enum SailPixelFormat pixel_format, unsigned width, unsigned height) {
+
+    if (sail_is_block_compressed(pixel_format)) {
+        return (size_t)((width + 3) / 4) * ((height + 3) / 4) * sail_bits_per_pixel(pixel_format) * 2;
+    }
+
+    return (size_t)sail_bytes_per_line(width, pixel_format) * height;
+}
@@ -0,0 +1,88 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_DDS_HELPERS_H
+#define SAIL_DDS_HELPERS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_io;
+
+/* "DDS " magic number, 124 bytes of the header, and 20 bytes of the optional DX10 header. */
+#define DDS_MAGIC_SIZE       4
+#define DDS_HEADER_SIZE      124
+#define DDS_HEADER_DX10_SIZE 20
+
+struct dds_private_pixel_format {
+    uint32_t flags;
+    uint32_t four_cc;
+    uint32_t rgb_bit_count;
+    uint32_t r_mask;
+    uint32_t g_mask;
+    uint32_t b_mask;
+    uint32_t a_mask;
+};
+
+/* Fields of DDS_HEADER and DDS_HEADER_DXT10 used by the codec. */
+struct dds_private_header {
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t depth;
+    uint32_t mip_map_count;
+    struct dds_private_pixel_format pixel_format;
+    uint32_t caps;
+    uint32_t caps2;
+
+    bool has_dx10;
+    uint32_t dxgi_format;
+    uint32_t resource_dimension;
+    uint32_t misc_flag;
+    uint32_t array_size;
+};
+
+/* Reads the magic number, the header, and the DX10 header if any. */
+SAIL_HIDDEN sail_status_t dds_private_read_header(struct sail_io *io, struct dds_private_header *header);
+
+/* Writes the magic number and the header of the texture with the specified number of mip levels. */
+SAIL_HIDDEN sail_status_t dds_private_write_header(struct sail_io *io, enum SailPixelFormat pixel_format,
+                                                   unsigned width, unsigned height, unsigned mip_levels);
+
+/* Returns the pixel format of the texture, or SAIL_PIXEL_FORMAT_UNKNOWN if it's not supported. */
+SAIL_HIDDEN enum SailPixelFormat dds_private_sail_pixel_format(const struct dds_private_header *header);
+
+/* Returns true if the pixel format can be written. */
+SAIL_HIDDEN bool dds_private_supported_pixel_format(enum SailPixelFormat pixel_format);
+
+/* Returns the size of the mip level in bytes. Partial 4x4 blocks of small levels take whole blocks. */
+SAIL_HIDDEN size_t dds_private_level_size(enum SailPixelFormat pixel_format, unsigned width, unsigned height);
+
+#endif
@@ -33,6 +33,8 @@
 
 #include <sail-common/sail-common.h>
 
+#include "common/animation/animation.h"
+
 #include "helpers.h"
 #include "io.h"
 
@@ -48,23 +50,22 @@ struct gif_state {
     const struct sail_save_options *save_options;
 
     GifFileType *gif;
-    const ColorMapObject *map;
+    uint32_t palette[256]; /* RGBA pixels of the current color map. */
     unsigned char *buf;
     int transparency_index;
-    int first_frame_height;
     int disposal;
-    int prev_disposal;
     int current_image;
-    unsigned row;
-    unsigned column;
+    bool dirty_only;
+    struct animation_canvas *canvas;
+    unsigned char background[4]; /* RGBA */
+
+    /* Saving. */
+    bool optimize;
     unsigned width;
     unsigned height;
-    unsigned prev_row;
-    unsigned prev_column;
-    unsigned prev_width;
-    unsigned prev_height;
-    unsigned char **first_frame;
-    unsigned char background[4]; /* RGBA */
+    unsigned char *previous_rgba;
+    unsigned char *current_rgba;
+    struct gif_private_frame pending_frame;
 };
 
 static sail_status_t alloc_gif_state(struct sail_io *io,
@@ -82,21 +83,19 @@ static sail_status_t alloc_gif_state(struct sail_io *io,
         .save_options = save_options,
 
         .gif                = NULL,
-        .map                = NULL,
         .buf                = NULL,
         .transparency_index = -1,
         .disposal           = DISPOSAL_UNSPECIFIED,
-        .prev_disposal      = DISPOSAL_UNSPECIFIED,
         .current_image      = -1,
-        .row                = 0,
-        .column             = 0,
-        .width              = 0,
-        .height             = 0,
-        .prev_row           = 0,
-        .prev_column        = 0,
-        .prev_width         = 0,
-        .prev_height        = 0,
-        .first_frame        = NULL,
+        .dirty_only         = false,
+        .canvas             = NULL,
+
+        .optimize      = true,
+        .width         = 0,
+        .height        = 0,
+        .previous_rgba = NULL,
+        .current_rgba  = NULL,
+        .pending_frame = { .pixels = NULL, .map = NULL },
     };
 
     return SAIL_OK;
@@ -110,13 +109,12 @@ static void destroy_gif_state(struct gif_state *gif_state) {
 
     sail_free(gif_state->buf);
 
-    if (gif_state->first_frame != NULL) {
-        for(int i = 0; i < gif_state->first_frame_height; i++) {
-            sail_free(gif_state->first_frame[i]);
-        }
+    animation_private_destroy_canvas(gif_state->canvas);
 
-        sail_free(gif_state->first_frame);
-    }
+    sail_free(gif_state->previous_rgba);
+    sail_free(gif_state->current_rgba);
+    sail_free(gif_state->pending_frame.pixels);
+    GifFreeMapObject(gif_state->pending_frame.map);
 
     sail_free(gif_state);
 }
@@ -158,15 +156,14 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_gif(struct sail_io *io, const
     SAIL_TRY(sail_malloc(gif_state->gif->SWidth * sizeof(GifPixelType), &ptr));
     gif_state->buf = ptr;
 
-    gif_state->first_frame_height = gif_state->gif->SHeight;
-
-    SAIL_TRY(sail_malloc(gif_state->first_frame_height * sizeof(unsigned char *), &ptr));
-    gif_state->first_frame = ptr;
+    /* Frames are composited into a transparent canvas. */
+    SAIL_TRY(sail_check_load_limits(load_options, gif_state->gif->SWidth, gif_state->gif->SHeight,
+                                    (size_t)gif_state->gif->SWidth * gif_state->gif->SHeight * 4));
+    SAIL_TRY(animation_private_alloc_canvas(gif_state->gif->SWidth, gif_state->gif->SHeight, SAIL_PIXEL_FORMAT_BPP32_RGBA,
+                                            /* background */ NULL, animation_private_first_frame_only(load_options),
+                                            &gif_state->canvas));
 
-    for (int i = 0; i < gif_state->first_frame_height; i++) {
-        SAIL_TRY(sail_calloc(gif_state->gif->SWidth, 4, &ptr)); /* 4 = RGBA */
-        gif_state->first_frame[i] = ptr;
-    }
+    gif_state->dirty_only = animation_private_dirty_only(load_options);
 
     return SAIL_OK;
 }
@@ -188,15 +185,9 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_gif(void *state, st
 
     gif_state->current_image++;
 
-    gif_state->prev_disposal      = gif_state->disposal;
     gif_state->disposal           = DISPOSAL_UNSPECIFIED;
     gif_state->transparency_index = -1;
 
-    gif_state->prev_row    = gif_state->row;
-    gif_state->prev_column = gif_state->column;
-    gif_state->prev_width  = gif_state->width;
-    gif_state->prev_height = gif_state->height;
-
     struct sail_meta_data_node **last_meta_data_node = &image_local->meta_data_node;
 
     /* Loop through records. */
@@ -216,20 +207,6 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_gif(void *state, st
                     sail_destroy_image(image_local);
                     SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
                 }
-
-                image_local->width = gif_state->gif->SWidth;
-                image_local->height = gif_state->gif->SHeight;
-
-                gif_state->row    = gif_state->gif->Image.Top;
-                gif_state->column = gif_state->gif->Image.Left;
-                gif_state->width  = gif_state->gif->Image.Width;
-                gif_state->height = gif_state->gif->Image.Height;
-
-                if (gif_state->column + gif_state->width > (unsigned)gif_state->gif->SWidth ||
-                        gif_state->row + gif_state->height > (unsigned)gif_state->gif->SHeight) {
-                    sail_destroy_image(image_local);
-                    SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
-                }
                 break;
             }
 
@@ -269,7 +246,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_gif(void *state, st
                     }
 
                     case COMMENT_EXT_FUNC_CODE: {
-                        if (gif_state->load_options->options & SAIL_OPTION_META_DATA) {
+                        if (sail_load_meta_data_key(gif_state->load_options, SAIL_META_DATA_COMMENT)) {
                             SAIL_TRY_OR_CLEANUP(gif_private_fetch_comment(extension, last_meta_data_node),
                                                 /* cleanup*/ sail_destroy_image(image_local));
                             last_meta_data_node = &(*last_meta_data_node)->next;
@@ -310,21 +287,36 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_gif(void *state, st
         }
 
         if (record == IMAGE_DESC_RECORD_TYPE) {
-            gif_state->map = (gif_state->gif->Image.ColorMap != NULL) ? gif_state->gif->Image.ColorMap : gif_state->gif->SColorMap;
+            const ColorMapObject *map = (gif_state->gif->Image.ColorMap != NULL) ? gif_state->gif->Image.ColorMap : gif_state->gif->SColorMap;
 
-            if (gif_state->map == NULL) {
+            if (map == NULL) {
                 sail_destroy_image(image_local);
                 SAIL_LOG_AND_RETURN(SAIL_ERROR_MISSING_PALETTE);
             }
 
+            gif_private_build_palette(map, gif_state->palette);
+
             if (gif_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
                 if (gif_state->gif->Image.Interlace) {
                     image_local->source_image->interlaced = true;
                 }
             }
 
-            image_local->pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA;
-            image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+            /*
+             * Frames are decoded right into the canvas. Transparent pixels are skipped
+             * to keep the canvas pixels underneath, so no blending is needed.
+             */
+            const struct animation_frame frame = {
+                .rect    = { (unsigned)gif_state->gif->Image.Left, (unsigned)gif_state->gif->Image.Top,
+                             (unsigned)gif_state->gif->Image.Width, (unsigned)gif_state->gif->Image.Height },
+                .dispose = gif_private_animation_dispose(gif_state->disposal),
+                .blend   = SAIL_ANIMATION_BLEND_SOURCE,
+            };
+
+            SAIL_TRY_OR_CLEANUP(animation_private_start_frame(gif_state->canvas, &frame),
+                                /* cleanup */ sail_destroy_image(image_local));
+            SAIL_TRY_OR_CLEANUP(animation_private_setup_image(gif_state->canvas, gif_state->dirty_only, image_local),
+                                /* cleanup */ sail_destroy_image(image_local));
 
             break;
         }
@@ -339,90 +331,44 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_gif(void *state, struct sail_
 
     struct gif_state *gif_state = state;
 
-    const int passes = gif_state->gif->Image.Interlace ? 4 : 1;
-    const int last_pass = passes - 1;
-    unsigned next_interlaced_row = 0;
+    SAIL_TRY(animation_private_bind_pixels(gif_state->canvas, gif_state->load_options, image));
 
-    for (int current_pass = 0; current_pass < passes; current_pass++) {
-        /* Apply disposal method on the previous frame. */
-        if (gif_state->current_image > 0 && current_pass == 0) {
-           for (unsigned cc = gif_state->prev_row; cc < gif_state->prev_row+gif_state->prev_height; cc++) {
-                unsigned char *scan = (unsigned char *)image->pixels + image->width*4*cc;
-
-                if (gif_state->prev_disposal == DISPOSE_BACKGROUND) {
-                    /*
-                     * Spec:
-                     *     2 - Restore to background color. The area used by the
-                     *         graphic must be restored to the background color.
-                     *
-                     * The meaning of the background color is not quite clear here. My idea was that
-                     * it's the color specified by the background color index in the global color map.
-                     * However, other decoders like XnView treat "background" as a transparent color here.
-                     * Let's do the same.
-                     */
-                    memset(gif_state->first_frame[cc] + gif_state->prev_column*4, 0, gif_state->prev_width*4); /* 4 = RGBA */
-                }
+    void *frame_pixels;
+    unsigned frame_bytes_per_line;
+    SAIL_TRY(animation_private_frame_pixels(gif_state->canvas, &frame_pixels, &frame_bytes_per_line));
 
-                memcpy(scan, gif_state->first_frame[cc], image->width * 4);
-            }
-        }
+    const unsigned width  = gif_state->gif->Image.Width;
+    const unsigned height = gif_state->gif->Image.Height;
 
-        /* Read lines. */
-        for (unsigned cc = 0; cc < image->height; cc++) {
-            unsigned char *scan = (unsigned char *)image->pixels + image->width*4*cc;
+    const bool interlaced = gif_state->gif->Image.Interlace;
+    const int passes = interlaced ? 4 : 1;
 
-            if (cc < gif_state->row || cc >= gif_state->row + gif_state->height) {
-                if (current_pass == 0) {
-                    memcpy(scan, gif_state->first_frame[cc], image->width * 4);
-                }
-
-                continue;
-            }
-
-            /* In interlaced mode we skip some lines. */
-            bool do_read = false;
+    for (int current_pass = 0; current_pass < passes; current_pass++) {
+        /* In interlaced mode we skip some lines. */
+        const unsigned first_row = interlaced ? InterlacedOffset[current_pass] : 0;
+        const unsigned row_step  = interlaced ? InterlacedJumps[current_pass] : 1;
 
-            if (gif_state->gif->Image.Interlace) {
-                if (cc == gif_state->row) {
-                    next_interlaced_row = InterlacedOffset[current_pass] + gif_state->row;
-                }
+        for (unsigned row = first_row; row < height; row += row_step) {
+            SAIL_TRY(sail_check_cancellation(gif_state->load_options->cancellation));
 
-                if (cc == next_interlaced_row) {
-                    do_read = true;
-                    next_interlaced_row += InterlacedJumps[current_pass];
-                }
-            } else {
-                do_read = true;
+            if (DGifGetLine(gif_state->gif, gif_state->buf, width) == GIF_ERROR) {
+                SAIL_LOG_ERROR("GIF: %s", GifErrorString(gif_state->gif->Error));
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
             }
 
-            if (do_read) {
-                if (DGifGetLine(gif_state->gif, gif_state->buf, gif_state->width) == GIF_ERROR) {
-                    SAIL_LOG_ERROR("GIF: %s", GifErrorString(gif_state->gif->Error));
-                    SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-                }
-
-                memcpy(scan, gif_state->first_frame[cc], image->width * 4);
-
-                for (unsigned i = 0; i < gif_state->width; i++) {
-                    if (gif_state->buf[i] == gif_state->transparency_index) {
-                        continue;
-                    }
-
-                    unsigned char *pixel = scan + (gif_state->column + i)*4;
+            unsigned char *pixel = (unsigned char *)frame_pixels + (size_t)row * frame_bytes_per_line;
 
-                    *(pixel+0) = gif_state->map->Colors[gif_state->buf[i]].Red;
-                    *(pixel+1) = gif_state->map->Colors[gif_state->buf[i]].Green;
-                    *(pixel+2) = gif_state->map->Colors[gif_state->buf[i]].Blue;
-                    *(pixel+3) = 255;
-                } // for
-            }
-
-            if (current_pass == last_pass) {
-                memcpy(gif_state->first_frame[cc], scan, image->width * 4);
+            for (unsigned i = 0; i < width; i++, pixel += 4) {
+                if (gif_state->buf[i] != gif_state->transparency_index) {
+                    memcpy(pixel, &gif_state->palette[gif_state->buf[i]], 4);
+                }
             }
         }
     }
 
+    animation_private_finish_frame(gif_state->canvas);
+    animation_private_copy_to_image(gif_state->canvas, gif_state->dirty_only, image);
+
     return SAIL_OK;
 }
 
@@ -447,32 +393,250 @@ SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_gif(void **state) {
 
 SAIL_EXPORT sail_status_t sail_codec_save_init_v8_gif(struct sail_io *io, const struct sail_save_options *save_options, void **state) {
 
-    (void)io;
-    (void)save_options;
-    (void)state;
+    *state = NULL;
+
+    /* Allocate a new state. */
+    struct gif_state *gif_state;
+    SAIL_TRY(alloc_gif_state(io, NULL, save_options, &gif_state));
+    *state = gif_state;
+
+    if (gif_state->save_options->compression != SAIL_COMPRESSION_LZW) {
+        SAIL_LOG_ERROR("GIF: Only LZW compression is allowed for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    /* Handle tuning. */
+    if (gif_state->save_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(gif_state->save_options->tuning, gif_private_tuning_key_value_callback, &gif_state->optimize);
+    }
+
+    /* Initialize GIF. */
+    int error_code;
+    gif_state->gif = EGifOpen(gif_state->io, my_write_proc, &error_code);
+
+    if (gif_state->gif == NULL) {
+        SAIL_LOG_ERROR("GIF: Failed to initialize. GIFLIB error code: %d", error_code);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Graphics control extensions require GIF89a. */
+    EGifSetGifVersion(gif_state->gif, true);
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_gif(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct gif_state *gif_state = state;
+
+    switch (image->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP1_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP2_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP4_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP8_INDEXED: {
+            break;
+        }
+        default: {
+            SAIL_LOG_ERROR("GIF: %s pixel format is not currently supported for saving", sail_pixel_format_to_string(image->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+    }
+
+    if (gif_state->previous_rgba != NULL) {
+        if (image->width != gif_state->width || image->height != gif_state->height) {
+            SAIL_LOG_ERROR("GIF: All frames must have the same dimensions");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+        }
+
+        return SAIL_OK;
+    }
+
+    if (image->width > UINT16_MAX || image->height > UINT16_MAX) {
+        SAIL_LOG_ERROR("GIF: Image dimensions must not exceed %u pixels", UINT16_MAX);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    gif_state->width  = image->width;
+    gif_state->height = image->height;
+
+    /* The canvas starts transparent. */
+    void *ptr;
+    SAIL_TRY(sail_calloc((size_t)image->width * image->height, 4, &ptr));
+    gif_state->previous_rgba = ptr;
+
+    SAIL_TRY(sail_malloc((size_t)image->width * image->height * 4, &ptr));
+    gif_state->current_rgba = ptr;
+
+    /* Every frame has a local color map, so no global one. */
+    if (EGifPutScreenDesc(gif_state->gif, (int)image->width, (int)image->height,
+                            /* color resolution */ 8, /* background */ 0, /* color map */ NULL) == GIF_ERROR) {
+        SAIL_LOG_ERROR("GIF: %s", GifErrorString(gif_state->gif->Error));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if (image->delay > 0) {
+        SAIL_TRY(gif_private_write_loop_extension(gif_state->gif));
+    }
+
+    if (gif_state->save_options->options & SAIL_OPTION_META_DATA) {
+        SAIL_TRY(gif_private_write_comments(gif_state->gif, image->meta_data_node));
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Returns true if the frame has transparent pixels over opaque pixels of the canvas.
+ * They can be shown only by clearing the canvas before drawing the frame.
+ */
+static bool needs_clear_canvas(const unsigned char *previous_rgba, const unsigned char *current_rgba, size_t pixels) {
+
+    for (size_t i = 0; i < pixels; i++, previous_rgba += 4, current_rgba += 4) {
+        if (current_rgba[3] == 0 && previous_rgba[3] != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Replaces the pixels unchanged since the previous frame with the transparent color
+ * and crops the frame to the changed pixels.
+ */
+static void optimize_frame(const unsigned char *previous_rgba, const unsigned char *current_rgba,
+                            unsigned width, unsigned height, struct gif_private_frame *frame) {
+
+    unsigned left = width, top = height, right = 0, bottom = 0;
+    bool changed = false;
+
+    GifPixelType *pixels = frame->pixels;
+
+    for (unsigned row = 0; row < height; row++) {
+        for (unsigned column = 0; column < width; column++, previous_rgba += 4, current_rgba += 4, pixels++) {
+            const bool unchanged = (current_rgba[3] == 0 && previous_rgba[3] == 0) || memcmp(current_rgba, previous_rgba, 4) == 0;
+
+            if (unchanged) {
+                if (frame->transparency_index != NO_TRANSPARENT_COLOR) {
+                    *pixels = (GifPixelType)frame->transparency_index;
+                }
+                continue;
+            }
+
+            changed = true;
+
+            left   = SAIL_MIN(left, column);
+            top    = SAIL_MIN(top, row);
+            right  = SAIL_MAX(right, column);
+            bottom = SAIL_MAX(bottom, row);
+        }
+    }
+
+    /* Frames must have at least one pixel. */
+    if (!changed) {
+        left = top = right = bottom = 0;
+    }
+
+    frame->left   = left;
+    frame->top    = top;
+    frame->width  = right - left + 1;
+    frame->height = bottom - top + 1;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_gif(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct gif_state *gif_state = state;
+
+    const size_t pixels_count = (size_t)gif_state->width * gif_state->height;
+
+    struct gif_private_frame frame = {
+        .pixels = NULL,
+        .map    = NULL,
+        .delay  = (image->delay > 0) ? (unsigned)SAIL_MIN((image->delay + 5) / 10, UINT16_MAX) : 0,
+        .left   = 0,
+        .top    = 0,
+        .width  = gif_state->width,
+        .height = gif_state->height,
+    };
+
+    unsigned char palette_rgba[256 * 4];
+    SAIL_TRY(gif_private_build_color_map(image->palette, gif_state->optimize, palette_rgba, &frame.map, &frame.transparency_index));
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_count, &ptr),
+                        /* cleanup */ GifFreeMapObject(frame.map));
+    frame.pixels = ptr;
+
+    gif_private_convert_pixels(image, palette_rgba, frame.transparency_index, frame.pixels, gif_state->current_rgba);
+
+    /*
+     * The disposal method of the pending frame is chosen by looking at this frame. Keeping
+     * the pending frame on the canvas allows optimizing this frame unless this frame makes
+     * opaque pixels transparent. In this case the pending frame is written in full
+     * and cleared to the transparent background.
+     */
+    bool can_optimize = false;
+
+    if (gif_state->pending_frame.pixels != NULL) {
+        int disposal = DISPOSE_DO_NOT;
+
+        if (needs_clear_canvas(gif_state->previous_rgba, gif_state->current_rgba, pixels_count)) {
+            disposal = DISPOSE_BACKGROUND;
+
+            gif_state->pending_frame.left   = 0;
+            gif_state->pending_frame.top    = 0;
+            gif_state->pending_frame.width  = gif_state->width;
+            gif_state->pending_frame.height = gif_state->height;
+        } else {
+            can_optimize = gif_state->optimize;
+        }
+
+        SAIL_TRY_OR_CLEANUP(gif_private_write_frame(gif_state->gif, &gif_state->pending_frame, disposal, gif_state->width),
+                            /* cleanup */ sail_free(frame.pixels),
+                                          GifFreeMapObject(frame.map));
+
+        sail_free(gif_state->pending_frame.pixels);
+        GifFreeMapObject(gif_state->pending_frame.map);
+    }
+
+    if (can_optimize) {
+        optimize_frame(gif_state->previous_rgba, gif_state->current_rgba, gif_state->width, gif_state->height, &frame);
+    }
+
+    gif_state->pending_frame = frame;
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    /* Either way, the canvas now matches this frame. */
+    unsigned char *rgba = gif_state->previous_rgba;
+    gif_state->previous_rgba = gif_state->current_rgba;
+    gif_state->current_rgba = rgba;
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_gif(void **state) {
 
-    (void)state;
+    struct gif_state *gif_state = *state;
+
+    *state = NULL;
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    sail_status_t status = SAIL_OK;
+
+    if (gif_state->pending_frame.pixels != NULL) {
+        status = gif_private_write_frame(gif_state->gif, &gif_state->pending_frame, DISPOSE_DO_NOT, gif_state->width);
+    }
+
+    if (gif_state->gif != NULL) {
+        int error_code;
+
+        if (EGifCloseFile(gif_state->gif, &error_code) == GIF_ERROR && status == SAIL_OK) {
+            SAIL_LOG_ERROR("GIF: %s", GifErrorString(error_code));
+            status = SAIL_ERROR_UNDERLYING_CODEC;
+        }
+    }
+
+    destroy_gif_state(gif_state);
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
 }
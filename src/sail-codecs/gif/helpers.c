@@ -23,6 +23,7 @@
     SOFTWARE.
 */
 
+#include <stdbool.h>
 #include <string.h>
 
 #include <gif_lib.h>
@@ -74,3 +75,231 @@ sail_status_t gif_private_fetch_application(const GifByteType *extension, struct
 
     return SAIL_OK;
 }
+
+enum SailAnimationDispose gif_private_animation_dispose(int disposal) {
+
+    switch (disposal) {
+        /*
+         * Spec:
+         *     2 - Restore to background color. The area used by the
+         *         graphic must be restored to the background color.
+         *
+         * The meaning of the background color is not quite clear here. My idea was that
+         * it's the color specified by the background color index in the global color map.
+         * However, other decoders like XnView treat "background" as a transparent color here.
+         * Let's do the same. The canvas background is transparent.
+         */
+        case DISPOSE_BACKGROUND: {
+            return SAIL_ANIMATION_DISPOSE_BACKGROUND;
+        }
+        case DISPOSE_PREVIOUS: {
+            return SAIL_ANIMATION_DISPOSE_PREVIOUS;
+        }
+        default: {
+            return SAIL_ANIMATION_DISPOSE_NONE;
+        }
+    }
+}
+
+void gif_private_build_palette(const ColorMapObject *map, uint32_t palette[256]) {
+
+    const unsigned color_count = SAIL_MIN((unsigned)map->ColorCount, 256U);
+
+    for (unsigned i = 0; i < 256; i++) {
+        unsigned char rgba[4] = { 0, 0, 0, 255 };
+
+        if (i < color_count) {
+            rgba[0] = map->Colors[i].Red;
+            rgba[1] = map->Colors[i].Green;
+            rgba[2] = map->Colors[i].Blue;
+        }
+
+        memcpy(&palette[i], rgba, sizeof(rgba));
+    }
+}
+
+bool gif_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    bool *optimize = user_data;
+
+    if (strcmp(key, "gif-optimize") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_BOOL) {
+            *optimize = sail_variant_to_bool(value);
+            SAIL_LOG_TRACE("GIF: optimize=%s", *optimize ? "yes" : "no");
+        } else {
+            SAIL_LOG_WARNING("GIF: 'gif-optimize' must be a bool");
+        }
+    }
+
+    return true;
+}
+
+sail_status_t gif_private_build_color_map(const struct sail_palette *palette, bool reserve_transparency,
+                                            unsigned char palette_rgba[256 * 4], ColorMapObject **map, int *transparency_index) {
+
+    if (palette == NULL || palette->data == NULL || palette->color_count == 0) {
+        SAIL_LOG_ERROR("GIF: Indexed image has no palette");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MISSING_PALETTE);
+    }
+
+    unsigned channels;
+
+    switch (palette->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:  { channels = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: { channels = 4; break; }
+        default: {
+            SAIL_LOG_ERROR("GIF: %s palette pixel format is not currently supported for saving",
+                            sail_pixel_format_to_string(palette->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+    }
+
+    unsigned color_count = SAIL_MIN(palette->color_count, 256U);
+
+    memset(palette_rgba, 0, 256 * 4);
+    *transparency_index = NO_TRANSPARENT_COLOR;
+
+    GifColorType colors[256];
+    memset(colors, 0, sizeof(colors));
+
+    const unsigned char *entry = palette->data;
+
+    for (unsigned i = 0; i < color_count; i++, entry += channels) {
+        unsigned char *rgba = palette_rgba + i * 4;
+
+        colors[i].Red   = rgba[0] = entry[0];
+        colors[i].Green = rgba[1] = entry[1];
+        colors[i].Blue  = rgba[2] = entry[2];
+        rgba[3] = (channels == 4) ? entry[3] : 255;
+
+        /* GIF has 1-bit transparency. The first translucent entry becomes the transparent color. */
+        if (rgba[3] < 128 && *transparency_index == NO_TRANSPARENT_COLOR) {
+            *transparency_index = (int)i;
+        }
+    }
+
+    /* Unchanged pixels of optimized frames need a transparent color. */
+    if (reserve_transparency && *transparency_index == NO_TRANSPARENT_COLOR && color_count < 256) {
+        *transparency_index = (int)color_count++;
+    }
+
+    /* Color maps must have a power of two number of colors. */
+    int map_color_count = 2;
+    while ((unsigned)map_color_count < color_count) {
+        map_color_count <<= 1;
+    }
+
+    *map = GifMakeMapObject(map_color_count, colors);
+
+    if (*map == NULL) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    return SAIL_OK;
+}
+
+void gif_private_convert_pixels(const struct sail_image *image, const unsigned char palette_rgba[256 * 4], int transparency_index,
+                                GifPixelType *pixels, unsigned char *rgba) {
+
+    const unsigned bits_per_index = sail_bits_per_pixel(image->pixel_format);
+    const unsigned index_mask = (1U << bits_per_index) - 1;
+    const unsigned indexes_per_byte = 8 / bits_per_index;
+    const unsigned color_count = SAIL_MIN(image->palette->color_count, 256U);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const unsigned char *scan = (const unsigned char *)image->pixels + (size_t)row * image->bytes_per_line;
+
+        for (unsigned column = 0; column < image->width; column++, pixels++, rgba += 4) {
+            const unsigned byte = scan[column / indexes_per_byte];
+            const unsigned index = (byte >> (8 - bits_per_index * (column % indexes_per_byte + 1))) & index_mask;
+
+            /* Out-of-range indexes produce black pixels like sail_convert_image() does. */
+            if (index >= color_count) {
+                *pixels = (GifPixelType)index;
+                rgba[0] = rgba[1] = rgba[2] = 0;
+                rgba[3] = 255;
+            } else if (palette_rgba[index * 4 + 3] < 128) {
+                *pixels = (GifPixelType)transparency_index;
+                memset(rgba, 0, 4);
+            } else {
+                *pixels = (GifPixelType)index;
+                memcpy(rgba, palette_rgba + index * 4, 3);
+                rgba[3] = 255;
+            }
+        }
+    }
+}
+
+sail_status_t gif_private_write_loop_extension(GifFileType *gif) {
+
+    /* Loop forever. */
+    static const GifByteType loop[3] = { 1, 0, 0 };
+
+    if (EGifPutExtensionLeader(gif, APPLICATION_EXT_FUNC_CODE) == GIF_ERROR ||
+            EGifPutExtensionBlock(gif, 11, "NETSCAPE2.0") == GIF_ERROR ||
+            EGifPutExtensionBlock(gif, sizeof(loop), loop) == GIF_ERROR ||
+            EGifPutExtensionTrailer(gif) == GIF_ERROR) {
+        SAIL_LOG_ERROR("GIF: %s", GifErrorString(gif->Error));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t gif_private_write_comments(GifFileType *gif, const struct sail_meta_data_node *meta_data_node) {
+
+    for (; meta_data_node != NULL; meta_data_node = meta_data_node->next) {
+        const struct sail_meta_data *meta_data = meta_data_node->meta_data;
+
+        if (meta_data->key != SAIL_META_DATA_COMMENT) {
+            SAIL_LOG_WARNING("GIF: Ignoring unsupported meta data key '%s'", sail_meta_data_to_string(meta_data->key));
+            continue;
+        }
+
+        if (meta_data->value->type != SAIL_VARIANT_TYPE_STRING) {
+            SAIL_LOG_WARNING("GIF: Comment must have STRING type");
+            continue;
+        }
+
+        if (EGifPutComment(gif, sail_variant_to_string(meta_data->value)) == GIF_ERROR) {
+            SAIL_LOG_ERROR("GIF: %s", GifErrorString(gif->Error));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t gif_private_write_frame(GifFileType *gif, const struct gif_private_frame *frame, int disposal, unsigned width) {
+
+    const bool transparent = frame->transparency_index != NO_TRANSPARENT_COLOR;
+
+    const GifByteType control[4] = {
+        (GifByteType)((disposal << 2) | (transparent ? 1 : 0)),
+        (GifByteType)(frame->delay & 0xff),
+        (GifByteType)(frame->delay >> 8),
+        (GifByteType)(transparent ? frame->transparency_index : 0),
+    };
+
+    if (EGifPutExtension(gif, GRAPHICS_EXT_FUNC_CODE, sizeof(control), control) == GIF_ERROR) {
+        SAIL_LOG_ERROR("GIF: %s", GifErrorString(gif->Error));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if (EGifPutImageDesc(gif, (int)frame->left, (int)frame->top, (int)frame->width, (int)frame->height,
+                            /* interlace */ false, frame->map) == GIF_ERROR) {
+        SAIL_LOG_ERROR("GIF: %s", GifErrorString(gif->Error));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    for (unsigned row = 0; row < frame->height; row++) {
+        GifPixelType *scan = frame->pixels + (size_t)(frame->top + row) * width + frame->left;
+
+        if (EGifPutLine(gif, scan, (int)frame->width) == GIF_ERROR) {
+            SAIL_LOG_ERROR("GIF: %s", GifErrorString(gif->Error));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    }
+
+    return SAIL_OK;
+}
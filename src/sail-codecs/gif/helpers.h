@@ -26,16 +26,60 @@
 #ifndef SAIL_GIF_HELPERS_H
 #define SAIL_GIF_HELPERS_H
 
+#include <stdint.h>
+
 #include <gif_lib.h>
 
 #include <sail-common/common.h>
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
+#include "common/animation/animation.h"
+
+struct sail_image;
 struct sail_meta_data_node;
+struct sail_palette;
+struct sail_variant;
+
+/*
+ * A frame waiting to be written. Its disposal method depends on the next frame.
+ */
+struct gif_private_frame {
+    GifPixelType *pixels; /* width * height indexes. */
+    ColorMapObject *map;
+    int transparency_index;
+    unsigned delay; /* In 1/100 of seconds. */
+
+    /* The rectangle to write. */
+    unsigned left;
+    unsigned top;
+    unsigned width;
+    unsigned height;
+};
 
 SAIL_HIDDEN sail_status_t gif_private_fetch_comment(const GifByteType *extension, struct sail_meta_data_node **meta_data_node);
 
 SAIL_HIDDEN sail_status_t gif_private_fetch_application(const GifByteType *extension, struct sail_meta_data_node **meta_data_node);
 
+SAIL_HIDDEN enum SailAnimationDispose gif_private_animation_dispose(int disposal);
+
+/*
+ * Expands the color map into 256 opaque RGBA pixels. Indexes missing in the color map are opaque black.
+ */
+SAIL_HIDDEN void gif_private_build_palette(const ColorMapObject *map, uint32_t palette[256]);
+
+SAIL_HIDDEN bool gif_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+SAIL_HIDDEN sail_status_t gif_private_build_color_map(const struct sail_palette *palette, bool reserve_transparency,
+                                                        unsigned char palette_rgba[256 * 4], ColorMapObject **map, int *transparency_index);
+
+SAIL_HIDDEN void gif_private_convert_pixels(const struct sail_image *image, const unsigned char palette_rgba[256 * 4], int transparency_index,
+                                            GifPixelType *pixels, unsigned char *rgba);
+
+SAIL_HIDDEN sail_status_t gif_private_write_loop_extension(GifFileType *gif);
+
+SAIL_HIDDEN sail_status_t gif_private_write_comments(GifFileType *gif, const struct sail_meta_data_node *meta_data_node);
+
+SAIL_HIDDEN sail_status_t gif_private_write_frame(GifFileType *gif, const struct gif_private_frame *frame, int disposal, unsigned width);
+
 #endif
@@ -0,0 +1,346 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <setjmp.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <png.h>
+
+#include <sail-common/sail-common.h>
+
+#include "embedded_png.h"
+
+/*
+ * Codec-specific state.
+ */
+struct ico_png_state {
+    const struct sail_load_options *load_options;
+
+    /* The sub-range of the I/O object occupied by the PNG image. */
+    struct sail_io *io;
+    size_t remaining;
+
+    png_structp png_ptr;
+    png_infop info_ptr;
+    bool libpng_error;
+
+    unsigned width;
+    unsigned height;
+    int bit_depth;
+    int color_type;
+    int interlace_type;
+
+    png_bytep *row_pointers;
+};
+
+/*
+ * Private functions.
+ */
+
+static void my_read_fn(png_structp png_ptr, png_bytep bytes, png_size_t bytes_size) {
+
+    if (png_ptr == NULL) {
+        return;
+    }
+
+    struct ico_png_state *png_state = png_get_io_ptr(png_ptr);
+
+    if (bytes_size > png_state->remaining) {
+        png_error(png_ptr, "Image data exceeds the directory entry size");
+    }
+
+    if (png_state->io->strict_read(png_state->io->stream, bytes, bytes_size) != SAIL_OK) {
+        png_error(png_ptr, "Failed to read from the I/O stream");
+    }
+
+    png_state->remaining -= bytes_size;
+}
+
+static void my_error_fn(png_structp png_ptr, png_const_charp text) {
+
+    (void)png_ptr;
+
+    SAIL_LOG_ERROR("ICO: PNG: %s", text);
+}
+
+static void my_warning_fn(png_structp png_ptr, png_const_charp text) {
+
+    (void)png_ptr;
+
+    SAIL_LOG_WARNING("ICO: PNG: %s", text);
+}
+
+static void* my_malloc_fn(png_structp png_ptr, png_size_t size) {
+
+    (void)png_ptr;
+
+    return sail_malloc_std_signature(size);
+}
+
+static void my_free_fn(png_structp png_ptr, void *ptr) {
+
+    (void)png_ptr;
+
+    sail_free(ptr);
+}
+
+static enum SailPixelFormat png_color_type_to_pixel_format(int color_type, int bit_depth) {
+
+    switch (color_type) {
+        case PNG_COLOR_TYPE_GRAY: {
+            switch (bit_depth) {
+                case 1:  return SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE;
+                case 2:  return SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE;
+                case 4:  return SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE;
+                case 8:  return SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
+                case 16: return SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE;
+            }
+            break;
+        }
+        case PNG_COLOR_TYPE_GRAY_ALPHA: {
+            switch (bit_depth) {
+                case 8:  return SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA;
+                case 16: return SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA;
+            }
+            break;
+        }
+        case PNG_COLOR_TYPE_PALETTE: {
+            switch (bit_depth) {
+                case 1: return SAIL_PIXEL_FORMAT_BPP1_INDEXED;
+                case 2: return SAIL_PIXEL_FORMAT_BPP2_INDEXED;
+                case 4: return SAIL_PIXEL_FORMAT_BPP4_INDEXED;
+                case 8: return SAIL_PIXEL_FORMAT_BPP8_INDEXED;
+            }
+            break;
+        }
+        case PNG_COLOR_TYPE_RGB: {
+            switch (bit_depth) {
+                case 8:  return SAIL_PIXEL_FORMAT_BPP24_RGB;
+                case 16: return SAIL_PIXEL_FORMAT_BPP48_RGB;
+            }
+            break;
+        }
+        case PNG_COLOR_TYPE_RGB_ALPHA: {
+            switch (bit_depth) {
+                case 8:  return SAIL_PIXEL_FORMAT_BPP32_RGBA;
+                case 16: return SAIL_PIXEL_FORMAT_BPP64_RGBA;
+            }
+            break;
+        }
+    }
+
+    return SAIL_PIXEL_FORMAT_UNKNOWN;
+}
+
+/* Sets up libpng transformations to decode any PNG image into 8-bit RGBA. */
+static void set_rgba_transformations(png_structp png_ptr, png_infop info_ptr, int color_type, int bit_depth) {
+
+    if (color_type == PNG_COLOR_TYPE_PALETTE) {
+        png_set_palette_to_rgb(png_ptr);
+    }
+
+    if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8) {
+        png_set_expand_gray_1_2_4_to_8(png_ptr);
+    }
+
+    const bool has_trns = png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS) != 0;
+
+    if (has_trns) {
+        png_set_tRNS_to_alpha(png_ptr);
+    }
+
+    if (bit_depth == 16) {
+        png_set_strip_16(png_ptr);
+    }
+
+    if (color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA) {
+        png_set_gray_to_rgb(png_ptr);
+    }
+
+    if ((color_type & PNG_COLOR_MASK_ALPHA) == 0 && !has_trns) {
+        png_set_add_alpha(png_ptr, 0xFF, PNG_FILLER_AFTER);
+    }
+}
+
+static void destroy_ico_png_state(struct ico_png_state *png_state) {
+
+    if (png_state == NULL) {
+        return;
+    }
+
+    if (png_state->png_ptr != NULL) {
+        png_destroy_read_struct(&png_state->png_ptr, &png_state->info_ptr, NULL);
+    }
+
+    sail_free(png_state->row_pointers);
+
+    sail_free(png_state);
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t ico_private_png_read_init(struct sail_io *io, size_t size, const struct sail_load_options *load_options, void **state) {
+
+    *state = NULL;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct ico_png_state), &ptr));
+    struct ico_png_state *png_state = ptr;
+
+    *png_state = (struct ico_png_state) {
+        .load_options = load_options,
+
+        .io        = io,
+        .remaining = size,
+
+        .png_ptr      = NULL,
+        .info_ptr     = NULL,
+        .libpng_error = false,
+
+        .row_pointers = NULL,
+    };
+
+    *state = png_state;
+
+    if ((png_state->png_ptr = png_create_read_struct_2(PNG_LIBPNG_VER_STRING, NULL, my_error_fn, my_warning_fn, NULL, my_malloc_fn, my_free_fn)) == NULL) {
+        png_state->libpng_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if ((png_state->info_ptr = png_create_info_struct(png_state->png_ptr)) == NULL) {
+        png_state->libpng_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if (setjmp(png_jmpbuf(png_state->png_ptr))) {
+        png_state->libpng_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    png_set_read_fn(png_state->png_ptr, png_state, my_read_fn);
+
+    png_read_info(png_state->png_ptr, png_state->info_ptr);
+
+    png_uint_32 width;
+    png_uint_32 height;
+
+    png_get_IHDR(png_state->png_ptr,
+                    png_state->info_ptr,
+                    &width,
+                    &height,
+                    &png_state->bit_depth,
+                    &png_state->color_type,
+                    &png_state->interlace_type,
+                    /* compression type */ NULL,
+                    /* filter method */ NULL);
+
+    png_state->width  = width;
+    png_state->height = height;
+
+    set_rgba_transformations(png_state->png_ptr, png_state->info_ptr, png_state->color_type, png_state->bit_depth);
+
+    if (png_state->interlace_type == PNG_INTERLACE_ADAM7) {
+        png_set_interlace_handling(png_state->png_ptr);
+    }
+
+    png_read_update_info(png_state->png_ptr, png_state->info_ptr);
+
+    if (png_get_rowbytes(png_state->png_ptr, png_state->info_ptr) != (size_t)png_state->width * 4) {
+        SAIL_LOG_ERROR("ICO: Failed to set up decoding PNG into BPP32-RGBA");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t ico_private_png_read_seek_next_frame(void *state, struct sail_image **image) {
+
+    struct ico_png_state *png_state = state;
+
+    if (png_state->libpng_error) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    if (png_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&image_local->source_image),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        image_local->source_image->pixel_format = png_color_type_to_pixel_format(png_state->color_type, png_state->bit_depth);
+        image_local->source_image->compression  = SAIL_COMPRESSION_DEFLATE;
+        image_local->source_image->interlaced   = png_state->interlace_type == PNG_INTERLACE_ADAM7;
+    }
+
+    image_local->width          = png_state->width;
+    image_local->height         = png_state->height;
+    image_local->pixel_format   = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t ico_private_png_read_frame(void *state, struct sail_image *image) {
+
+    struct ico_png_state *png_state = state;
+
+    if (png_state->libpng_error) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(png_bytep) * image->height, &ptr));
+    png_state->row_pointers = ptr;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        png_state->row_pointers[row] = sail_scan_line(image, row);
+    }
+
+    if (setjmp(png_jmpbuf(png_state->png_ptr))) {
+        png_state->libpng_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Deinterlaces Adam7 images with the interlace handling set up above. */
+    png_read_image(png_state->png_ptr, png_state->row_pointers);
+
+    return SAIL_OK;
+}
+
+void ico_private_png_read_finish(void **state) {
+
+    struct ico_png_state *png_state = *state;
+
+    *state = NULL;
+
+    destroy_ico_png_state(png_state);
+}
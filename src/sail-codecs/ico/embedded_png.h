@@ -0,0 +1,52 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ICO_EMBEDDED_PNG_H
+#define SAIL_ICO_EMBEDDED_PNG_H
+
+#include <stddef.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_image;
+struct sail_io;
+struct sail_load_options;
+
+/*
+ * Decodes a PNG image embedded into an ICO or CUR file with libpng.
+ *
+ * The image is read from the current position of the I/O object, and at most 'size' bytes
+ * are consumed. Pixels are always decoded into BPP32-RGBA.
+ */
+SAIL_HIDDEN sail_status_t ico_private_png_read_init(struct sail_io *io, size_t size, const struct sail_load_options *load_options, void **state);
+
+SAIL_HIDDEN sail_status_t ico_private_png_read_seek_next_frame(void *state, struct sail_image **image);
+
+SAIL_HIDDEN sail_status_t ico_private_png_read_frame(void *state, struct sail_image *image);
+
+SAIL_HIDDEN void ico_private_png_read_finish(void **state);
+
+#endif
@@ -52,6 +52,14 @@ sail_status_t ico_private_read_dir_entry(struct sail_io *io, struct SailIcoDirEn
     return SAIL_OK;
 }
 
+unsigned ico_private_dir_entry_size(const struct SailIcoDirEntry *dir_entry) {
+
+    const unsigned width  = (dir_entry->width  == 0) ? 256 : dir_entry->width;
+    const unsigned height = (dir_entry->height == 0) ? 256 : dir_entry->height;
+
+    return (width > height) ? width : height;
+}
+
 sail_status_t ico_private_probe_image_type(struct sail_io *io, enum SailIcoImageType *ico_image_type) {
 
     size_t saved_offset;
@@ -63,6 +63,9 @@ SAIL_HIDDEN sail_status_t ico_private_read_header(struct sail_io *io, struct Sai
 
 SAIL_HIDDEN sail_status_t ico_private_read_dir_entry(struct sail_io *io, struct SailIcoDirEntry *dir_entry);
 
+/* Returns the larger dimension of the image in the directory entry. 0 in the entry means 256. */
+SAIL_HIDDEN unsigned ico_private_dir_entry_size(const struct SailIcoDirEntry *dir_entry);
+
 SAIL_HIDDEN sail_status_t ico_private_probe_image_type(struct sail_io *io, enum SailIcoImageType *ico_image_type);
 
 SAIL_HIDDEN sail_status_t ico_private_store_cur_hotspot(const struct SailIcoDirEntry *ico_dir_entry, struct sail_hash_map *special_properties);
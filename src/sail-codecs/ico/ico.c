@@ -23,6 +23,7 @@
     SOFTWARE.
 */
 
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -35,9 +36,22 @@
 
 #include "helpers.h"
 
+#ifdef SAIL_ICO_PNG
+    #include "embedded_png.h"
+#endif
+
 #define SAIL_ICO_TYPE_ICO 1
 #define SAIL_ICO_TYPE_CUR 2
 
+/* Passed to "ico-size" to select the largest image. */
+#define SAIL_ICO_SIZE_LARGEST UINT_MAX
+
+/* Directory entry that can be loaded. */
+struct ico_frame {
+    unsigned entry;
+    enum SailIcoImageType type;
+};
+
 /*
  * Codec-specific state.
  */
@@ -48,9 +62,16 @@ struct ico_state {
 
     struct SailIcoHeader ico_header;
     struct SailIcoDirEntry *ico_dir_entries;
+
+    struct ico_frame *frames;
+    unsigned frames_count;
     unsigned current_frame;
 
+    /* Requested image size, 0 to load all images. */
+    unsigned tuning_size;
+
     void *common_bmp_state;
+    void *png_state;
 };
 
 static sail_status_t alloc_ico_state(struct sail_io *io,
@@ -68,8 +89,12 @@ static sail_status_t alloc_ico_state(struct sail_io *io,
         .save_options = save_options,
 
         .ico_dir_entries  = NULL,
+        .frames           = NULL,
+        .frames_count     = 0,
         .current_frame    = 0,
+        .tuning_size      = 0,
         .common_bmp_state = NULL,
+        .png_state        = NULL,
     };
 
     return SAIL_OK;
@@ -82,10 +107,117 @@ static void destroy_ico_state(struct ico_state *ico_state) {
     }
 
     sail_free(ico_state->ico_dir_entries);
+    sail_free(ico_state->frames);
 
     sail_free(ico_state);
 }
 
+static bool ico_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    unsigned *tuning_size = user_data;
+
+    if (strcmp(key, "ico-size") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            *tuning_size = sail_variant_to_unsigned_int(value);
+        } else if (value->type == SAIL_VARIANT_TYPE_STRING && strcmp(sail_variant_to_string(value), "largest") == 0) {
+            *tuning_size = SAIL_ICO_SIZE_LARGEST;
+        } else {
+            SAIL_LOG_WARNING("ICO: 'ico-size' must be an unsigned integer or \"largest\"");
+        }
+    }
+
+    return true;
+}
+
+/* Returns true if the image type can be decoded. */
+static bool image_type_supported(enum SailIcoImageType ico_image_type) {
+
+    switch (ico_image_type) {
+        case SAIL_ICO_IMAGE_BMP: return true;
+#ifdef SAIL_ICO_PNG
+        case SAIL_ICO_IMAGE_PNG: return true;
+#endif
+        default: return false;
+    }
+}
+
+/*
+ * Returns true if the first directory entry fits the requested size better than the second one.
+ * Entries not smaller than the requested size win over smaller ones. Then the closest size wins,
+ * then the deeper bit depth.
+ */
+static bool entry_fits_better(const struct SailIcoDirEntry *first, const struct SailIcoDirEntry *second, unsigned size, bool cur) {
+
+    const unsigned first_size  = ico_private_dir_entry_size(first);
+    const unsigned second_size = ico_private_dir_entry_size(second);
+
+    if (first_size != second_size) {
+        const bool first_fits  = first_size >= size;
+        const bool second_fits = second_size >= size;
+
+        if (first_fits != second_fits) {
+            return first_fits;
+        }
+
+        return first_fits ? (first_size < second_size) : (first_size > second_size);
+    }
+
+    /* CUR stores the hotspot instead of the bit depth. */
+    return !cur && first->bit_count > second->bit_count;
+}
+
+/* Keeps the single frame that fits the requested size best. */
+static void select_frame(struct ico_state *ico_state) {
+
+    const bool cur = ico_state->ico_header.type == SAIL_ICO_TYPE_CUR;
+    unsigned best = 0;
+
+    for (unsigned i = 1; i < ico_state->frames_count; i++) {
+        if (entry_fits_better(&ico_state->ico_dir_entries[ico_state->frames[i].entry],
+                                &ico_state->ico_dir_entries[ico_state->frames[best].entry],
+                                ico_state->tuning_size,
+                                cur)) {
+            best = i;
+        }
+    }
+
+    SAIL_LOG_TRACE("ICO: Selected image #%u of size %u",
+                    ico_state->frames[best].entry, ico_private_dir_entry_size(&ico_state->ico_dir_entries[ico_state->frames[best].entry]));
+
+    ico_state->frames[0]     = ico_state->frames[best];
+    ico_state->frames_count = 1;
+}
+
+/* Finishes the frame sought but not loaded. */
+static sail_status_t finish_frame(struct ico_state *ico_state) {
+
+    if (ico_state->common_bmp_state != NULL) {
+        SAIL_TRY(bmp_private_read_finish(&ico_state->common_bmp_state, ico_state->io));
+    }
+
+#ifdef SAIL_ICO_PNG
+    ico_private_png_read_finish(&ico_state->png_state);
+#endif
+
+    return SAIL_OK;
+}
+
+static sail_status_t store_cur_hotspot(const struct ico_state *ico_state, const struct SailIcoDirEntry *ico_dir_entry, struct sail_image *image) {
+
+    if (ico_state->ico_header.type != SAIL_ICO_TYPE_CUR) {
+        return SAIL_OK;
+    }
+
+    if (image->source_image == NULL) {
+        SAIL_TRY(sail_alloc_source_image(&image->source_image));
+    }
+
+    SAIL_TRY(sail_alloc_hash_map(&image->source_image->special_properties));
+    SAIL_TRY(ico_private_store_cur_hotspot(ico_dir_entry, image->source_image->special_properties));
+
+    return SAIL_OK;
+}
+
 /*
  * Decoding functions.
  */
@@ -124,6 +256,32 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_ico(struct sail_io *io, const
         SAIL_TRY(ico_private_read_dir_entry(ico_state->io, &ico_state->ico_dir_entries[i]));
     }
 
+    /* Collect the images that can be decoded. */
+    SAIL_TRY(sail_malloc(sizeof(struct ico_frame) * ico_state->ico_header.images_count, &ptr));
+    ico_state->frames = ptr;
+
+    for (unsigned i = 0; i < ico_state->ico_header.images_count; i++) {
+        SAIL_TRY(ico_state->io->seek(ico_state->io->stream, (long)ico_state->ico_dir_entries[i].image_offset, SEEK_SET));
+
+        enum SailIcoImageType ico_image_type;
+        SAIL_TRY(ico_private_probe_image_type(ico_state->io, &ico_image_type));
+
+        if (image_type_supported(ico_image_type)) {
+            ico_state->frames[ico_state->frames_count++] = (struct ico_frame) { .entry = i, .type = ico_image_type };
+        } else {
+            SAIL_LOG_DEBUG("ICO: Skipping unsupported image #%u", i);
+        }
+    }
+
+    /* Handle tuning. */
+    if (ico_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(ico_state->load_options->tuning, ico_tuning_key_value_callback, &ico_state->tuning_size);
+    }
+
+    if (ico_state->tuning_size > 0 && ico_state->frames_count > 0) {
+        select_frame(ico_state);
+    }
+
     return SAIL_OK;
 }
 
@@ -131,61 +289,81 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_ico(void *state, st
 
     struct ico_state *ico_state = state;
 
-    /* Skip non-BMP images. */
-    enum SailIcoImageType ico_image_type;
+    if (ico_state->current_frame >= ico_state->frames_count) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
 
-    do {
-        if (ico_state->current_frame >= ico_state->ico_header.images_count) {
-            SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
-        }
+    const struct ico_frame *ico_frame = &ico_state->frames[ico_state->current_frame++];
+    const struct SailIcoDirEntry *ico_dir_entry = &ico_state->ico_dir_entries[ico_frame->entry];
 
-        SAIL_TRY(ico_state->io->seek(ico_state->io->stream, (long)ico_state->ico_dir_entries[ico_state->current_frame++].image_offset, SEEK_SET));
+    SAIL_TRY(sail_io_will_need(ico_state->io, ico_dir_entry->image_offset, ico_dir_entry->image_size));
+    SAIL_TRY(ico_state->io->seek(ico_state->io->stream, (long)ico_dir_entry->image_offset, SEEK_SET));
 
-        /* Check the image is not PNG. */
-        SAIL_TRY(ico_private_probe_image_type(ico_state->io, &ico_image_type));
-    } while (ico_image_type != SAIL_ICO_IMAGE_BMP);
-
-    /* Continue to loading BMP. */
     struct sail_image *image_local;
 
-    SAIL_TRY(bmp_private_read_init(ico_state->io, ico_state->load_options, &ico_state->common_bmp_state, SAIL_NO_BMP_FLAGS));
-    SAIL_TRY(bmp_private_read_seek_next_frame(ico_state->common_bmp_state, ico_state->io, &image_local));
-
-    /* Store CUR hotspot. */
-    if (ico_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
-        if (ico_state->load_options->options & SAIL_OPTION_META_DATA) {
-            if (ico_state->ico_header.type == SAIL_ICO_TYPE_CUR) {
-                if (image_local->source_image == NULL) {
-                    SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&image_local->source_image),
-                                        /* cleanup */ sail_destroy_image(image_local));
-                }
-
-                SAIL_TRY_OR_CLEANUP(sail_alloc_hash_map(&image_local->source_image->special_properties),
-                                    /* cleanup */ sail_destroy_image(image_local));
-                SAIL_TRY_OR_CLEANUP(ico_private_store_cur_hotspot(&ico_state->ico_dir_entries[ico_state->current_frame - 1],
-                                                                    image_local->source_image->special_properties),
-                                    /* cleanup */ sail_destroy_image(image_local));
-            }
+    switch (ico_frame->type) {
+#ifdef SAIL_ICO_PNG
+        case SAIL_ICO_IMAGE_PNG: {
+            SAIL_TRY(ico_private_png_read_init(ico_state->io, ico_dir_entry->image_size, ico_state->load_options, &ico_state->png_state));
+            SAIL_TRY(ico_private_png_read_seek_next_frame(ico_state->png_state, &image_local));
+            break;
+        }
+#endif
+        default: {
+            SAIL_TRY(bmp_private_read_init(ico_state->io, ico_state->load_options, &ico_state->common_bmp_state, SAIL_NO_BMP_FLAGS));
+            SAIL_TRY(bmp_private_read_seek_next_frame(ico_state->common_bmp_state, ico_state->io, &image_local));
+
+            /*
+             * The contained image is twice the height declared in the directory.
+             * The second half is a mask. We need just the image.
+             */
+            image_local->height /= 2;
+            break;
         }
     }
 
-    /*
-     * The contained image is twice the height declared in the directory.
-     * The second half is a mask. We need just the image.
-     */
-    image_local->height /= 2;
+    /* Store CUR hotspot. */
+    if ((ico_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) && (ico_state->load_options->options & SAIL_OPTION_META_DATA)) {
+        SAIL_TRY_OR_CLEANUP(store_cur_hotspot(ico_state, ico_dir_entry, image_local),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
 
     *image = image_local;
 
     return SAIL_OK;
 }
 
+SAIL_EXPORT sail_status_t sail_codec_load_seek_frame_v8_ico(void *state, unsigned frame) {
+
+    struct ico_state *ico_state = state;
+
+    /* Drop the frame sought but not loaded. */
+    SAIL_TRY(finish_frame(ico_state));
+
+    if (frame >= ico_state->frames_count) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    ico_state->current_frame = frame;
+
+    return SAIL_OK;
+}
+
 SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_ico(void *state, struct sail_image *image) {
 
     struct ico_state *ico_state = state;
 
+#ifdef SAIL_ICO_PNG
+    if (ico_state->png_state != NULL) {
+        SAIL_TRY(ico_private_png_read_frame(ico_state->png_state, image));
+        SAIL_TRY(finish_frame(ico_state));
+
+        return SAIL_OK;
+    }
+#endif
+
     SAIL_TRY(bmp_private_read_frame(ico_state->common_bmp_state, ico_state->io, image));
-    SAIL_TRY(bmp_private_read_finish(&ico_state->common_bmp_state, ico_state->io));
+    SAIL_TRY(finish_frame(ico_state));
 
     return SAIL_OK;
 }
@@ -196,10 +374,8 @@ SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_ico(void **state) {
 
     *state = NULL;
 
-    if (ico_state->common_bmp_state != NULL) {
-        SAIL_TRY_OR_CLEANUP(bmp_private_read_finish(&ico_state->common_bmp_state, ico_state->io),
-                            /* cleanup */ destroy_ico_state(ico_state));
-    }
+    SAIL_TRY_OR_CLEANUP(finish_frame(ico_state),
+                        /* cleanup */ destroy_ico_state(ico_state));
 
     destroy_ico_state(ico_state);
 
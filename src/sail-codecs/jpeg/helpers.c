@@ -24,6 +24,7 @@
 */
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -63,6 +64,11 @@ enum SailPixelFormat jpeg_private_color_space_to_pixel_format(J_COLOR_SPACE colo
         case JCS_EXT_BGRA:  return SAIL_PIXEL_FORMAT_BPP32_BGRA;
         case JCS_EXT_ABGR:  return SAIL_PIXEL_FORMAT_BPP32_ABGR;
         case JCS_EXT_ARGB:  return SAIL_PIXEL_FORMAT_BPP32_ARGB;
+
+        case JCS_EXT_RGBX:  return SAIL_PIXEL_FORMAT_BPP32_RGBX;
+        case JCS_EXT_BGRX:  return SAIL_PIXEL_FORMAT_BPP32_BGRX;
+        case JCS_EXT_XBGR:  return SAIL_PIXEL_FORMAT_BPP32_XBGR;
+        case JCS_EXT_XRGB:  return SAIL_PIXEL_FORMAT_BPP32_XRGB;
 #endif
 
         case JCS_YCbCr:     return SAIL_PIXEL_FORMAT_BPP24_YCBCR;
@@ -86,6 +92,11 @@ J_COLOR_SPACE jpeg_private_pixel_format_to_color_space(enum SailPixelFormat pixe
         case SAIL_PIXEL_FORMAT_BPP32_BGRA:      return JCS_EXT_BGRA;
         case SAIL_PIXEL_FORMAT_BPP32_ABGR:      return JCS_EXT_ABGR;
         case SAIL_PIXEL_FORMAT_BPP32_ARGB:      return JCS_EXT_ARGB;
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX:      return JCS_EXT_RGBX;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX:      return JCS_EXT_BGRX;
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR:      return JCS_EXT_XBGR;
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB:      return JCS_EXT_XRGB;
 #endif
 
         case SAIL_PIXEL_FORMAT_BPP24_YCBCR:     return JCS_YCbCr;
@@ -96,21 +107,79 @@ J_COLOR_SPACE jpeg_private_pixel_format_to_color_space(enum SailPixelFormat pixe
     }
 }
 
-sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decompress_context, struct sail_meta_data_node **last_meta_data_node) {
+static const char EXIF_SIGNATURE[] = "Exif\0";
+static const char XMP_SIGNATURE[]  = "http://ns.adobe.com/xap/1.0/";
+
+/* Signature lengths including the terminating null characters. */
+#define EXIF_SIGNATURE_LENGTH sizeof(EXIF_SIGNATURE)
+#define XMP_SIGNATURE_LENGTH  sizeof(XMP_SIGNATURE)
+
+static bool marker_has_signature(jpeg_saved_marker_ptr marker, const char *signature, size_t length) {
+
+    return marker->data_length >= length && memcmp(marker->data, signature, length) == 0;
+}
+
+static sail_status_t alloc_meta_data_node_from_marker(jpeg_saved_marker_ptr marker, struct sail_meta_data_node **meta_data_node) {
+
+    struct sail_meta_data_node *meta_data_node_local;
+    SAIL_TRY(sail_alloc_meta_data_node(&meta_data_node_local));
+
+    sail_status_t status;
+
+    if (marker->marker == JPEG_COM) {
+        status = sail_alloc_meta_data_and_value_from_known_key(SAIL_META_DATA_COMMENT, &meta_data_node_local->meta_data);
+
+        if (status == SAIL_OK) {
+            status = sail_set_variant_substring(meta_data_node_local->meta_data->value, (const char *)marker->data, marker->data_length);
+        }
+    } else if (marker_has_signature(marker, XMP_SIGNATURE, XMP_SIGNATURE_LENGTH)) {
+        status = sail_alloc_meta_data_and_value_from_known_key(SAIL_META_DATA_XMP, &meta_data_node_local->meta_data);
+
+        if (status == SAIL_OK) {
+            status = sail_set_variant_substring(meta_data_node_local->meta_data->value,
+                                                (const char *)marker->data + XMP_SIGNATURE_LENGTH,
+                                                marker->data_length - XMP_SIGNATURE_LENGTH);
+        }
+    } else {
+        /* EXIF is kept with its "Exif\0\0" header. */
+        status = sail_alloc_meta_data_and_value_from_known_key(SAIL_META_DATA_EXIF, &meta_data_node_local->meta_data);
+
+        if (status == SAIL_OK) {
+            status = sail_set_variant_data(meta_data_node_local->meta_data->value, marker->data, marker->data_length);
+        }
+    }
+
+    SAIL_TRY_OR_CLEANUP(status,
+                        /* cleanup */ sail_destroy_meta_data_node(meta_data_node_local));
+
+    *meta_data_node = meta_data_node_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decompress_context, const struct sail_load_options *load_options,
+                                           struct sail_meta_data_node **last_meta_data_node) {
 
     SAIL_CHECK_PTR(last_meta_data_node);
 
     jpeg_saved_marker_ptr it = decompress_context->marker_list;
 
     while(it != NULL) {
-        if(it->marker == JPEG_COM) {
-            struct sail_meta_data_node *meta_data_node;
-            SAIL_TRY(sail_alloc_meta_data_node(&meta_data_node));
+        enum SailMetaData key = SAIL_META_DATA_UNKNOWN;
+
+        if (it->marker == JPEG_COM) {
+            key = SAIL_META_DATA_COMMENT;
+        } else if (it->marker == JPEG_APP0 + 1) {
+            if (marker_has_signature(it, EXIF_SIGNATURE, EXIF_SIGNATURE_LENGTH)) {
+                key = SAIL_META_DATA_EXIF;
+            } else if (marker_has_signature(it, XMP_SIGNATURE, XMP_SIGNATURE_LENGTH)) {
+                key = SAIL_META_DATA_XMP;
+            }
+        }
 
-            SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_and_value_from_known_key(SAIL_META_DATA_COMMENT, &meta_data_node->meta_data),
-                                /* cleanup */ sail_destroy_meta_data_node(meta_data_node));
-            SAIL_TRY_OR_CLEANUP(sail_set_variant_substring(meta_data_node->meta_data->value, (const char *)it->data, it->data_length),
-                                /* cleanup */ sail_destroy_meta_data_node(meta_data_node));
+        if (key != SAIL_META_DATA_UNKNOWN && sail_load_meta_data_key(load_options, key)) {
+            struct sail_meta_data_node *meta_data_node;
+            SAIL_TRY(alloc_meta_data_node_from_marker(it, &meta_data_node));
 
             *last_meta_data_node = meta_data_node;
             last_meta_data_node = &meta_data_node->next;
@@ -122,16 +191,55 @@ sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decomp
     return SAIL_OK;
 }
 
+/* Writes an APP1 marker with the signature unless the data already starts with it. */
+static void write_app1_marker(struct jpeg_compress_struct *compress_context,
+                                const char *signature, size_t signature_length,
+                                const void *data, size_t data_size) {
+
+    const JOCTET *data_ptr = data;
+    const bool has_signature = data_size >= signature_length && memcmp(data_ptr, signature, signature_length) == 0;
+
+    if (has_signature) {
+        data_ptr  += signature_length;
+        data_size -= signature_length;
+    }
+
+    /* Marker length is 16-bit. */
+    if (signature_length + data_size > 65533) {
+        SAIL_LOG_WARNING("JPEG: Skipping too large APP1 marker of %zu bytes", signature_length + data_size);
+        return;
+    }
+
+    jpeg_write_m_header(compress_context, JPEG_APP0 + 1, (unsigned)(signature_length + data_size));
+
+    for (size_t i = 0; i < signature_length; i++) {
+        jpeg_write_m_byte(compress_context, (unsigned char)signature[i]);
+    }
+    for (size_t i = 0; i < data_size; i++) {
+        jpeg_write_m_byte(compress_context, data_ptr[i]);
+    }
+}
+
 sail_status_t jpeg_private_write_meta_data(struct jpeg_compress_struct *compress_context, const struct sail_meta_data_node *meta_data_node) {
 
     while (meta_data_node != NULL) {
-        if (meta_data_node->meta_data->value->type == SAIL_VARIANT_TYPE_STRING) {
+        const struct sail_meta_data *meta_data = meta_data_node->meta_data;
+
+        if (meta_data->key == SAIL_META_DATA_EXIF && meta_data->value->type == SAIL_VARIANT_TYPE_DATA) {
+            write_app1_marker(compress_context,
+                                EXIF_SIGNATURE, EXIF_SIGNATURE_LENGTH,
+                                sail_variant_to_data(meta_data->value), meta_data->value->size);
+        } else if (meta_data->key == SAIL_META_DATA_XMP && meta_data->value->type == SAIL_VARIANT_TYPE_STRING) {
+            write_app1_marker(compress_context,
+                                XMP_SIGNATURE, XMP_SIGNATURE_LENGTH,
+                                sail_variant_to_string(meta_data->value), meta_data->value->size - 1);
+        } else if (meta_data->value->type == SAIL_VARIANT_TYPE_STRING) {
             jpeg_write_marker(compress_context,
                                 JPEG_COM,
-                                (JOCTET *)sail_variant_to_string(meta_data_node->meta_data->value),
-                                (unsigned)meta_data_node->meta_data->value->size - 1);
+                                (JOCTET *)sail_variant_to_string(meta_data->value),
+                                (unsigned)meta_data->value->size - 1);
         } else {
-            SAIL_LOG_WARNING("JPEG: Ignoring unsupported binary key '%s'", sail_meta_data_to_string(meta_data_node->meta_data->key));
+            SAIL_LOG_WARNING("JPEG: Ignoring unsupported binary key '%s'", sail_meta_data_to_string(meta_data->key));
         }
 
         meta_data_node = meta_data_node->next;
@@ -140,6 +248,26 @@ sail_status_t jpeg_private_write_meta_data(struct jpeg_compress_struct *compress
     return SAIL_OK;
 }
 
+sail_status_t jpeg_private_write_markers(struct jpeg_compress_struct *compress_context, const struct sail_save_options *save_options,
+                                         const struct sail_image *image) {
+
+    /* Save meta data. */
+    if (save_options->options & SAIL_OPTION_META_DATA && image->meta_data_node != NULL) {
+        SAIL_TRY(jpeg_private_write_meta_data(compress_context, image->meta_data_node));
+        SAIL_LOG_TRACE("JPEG: Meta data has been written");
+    }
+
+    /* Save ICC profile. */
+#ifdef SAIL_HAVE_JPEG_ICCP
+    if (save_options->options & SAIL_OPTION_ICCP && image->iccp != NULL) {
+        jpeg_write_icc_profile(compress_context, image->iccp->data, (unsigned)image->iccp->size);
+        SAIL_LOG_TRACE("JPEG: ICC profile has been written");
+    }
+#endif
+
+    return SAIL_OK;
+}
+
 #ifdef SAIL_HAVE_JPEG_ICCP
 sail_status_t jpeg_private_fetch_iccp(struct jpeg_decompress_struct *decompress_context, struct sail_iccp **iccp) {
 
@@ -254,3 +382,339 @@ bool jpeg_private_tuning_key_value_callback(const char *key, const struct sail_v
 
     return true;
 }
+
+bool jpeg_private_load_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    struct jpeg_decompress_struct *decompress_context = user_data;
+
+    if (strcmp(key, "jpeg-dct-method") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_STRING) {
+            const char *str_value = sail_variant_to_string(value);
+
+            if (strcmp(str_value, "slow") == 0 || strcmp(str_value, "int") == 0) {
+                SAIL_LOG_TRACE("JPEG: Applying SLOW DCT method");
+                decompress_context->dct_method = JDCT_ISLOW;
+            } else if (strcmp(str_value, "fast") == 0) {
+                SAIL_LOG_TRACE("JPEG: Applying FAST DCT method");
+                decompress_context->dct_method = JDCT_IFAST;
+            } else if (strcmp(str_value, "float") == 0) {
+                SAIL_LOG_TRACE("JPEG: Applying FLOAT DCT method");
+                decompress_context->dct_method = JDCT_FLOAT;
+            }
+        }
+    } else if (strcmp(key, "jpeg-fancy-upsampling") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_BOOL) {
+            decompress_context->do_fancy_upsampling = sail_variant_to_bool(value);
+            SAIL_LOG_TRACE("JPEG: Fancy upsampling: %s", decompress_context->do_fancy_upsampling ? "yes" : "no");
+        }
+    } else if (strcmp(key, "jpeg-block-smoothing") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_BOOL) {
+            decompress_context->do_block_smoothing = sail_variant_to_bool(value);
+            SAIL_LOG_TRACE("JPEG: Block smoothing: %s", decompress_context->do_block_smoothing ? "yes" : "no");
+        }
+    } else if (strcmp(key, "jpeg-two-pass-quantize") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_BOOL) {
+            decompress_context->two_pass_quantize = sail_variant_to_bool(value);
+            SAIL_LOG_TRACE("JPEG: Two-pass quantization: %s", decompress_context->two_pass_quantize ? "yes" : "no");
+        }
+    }
+
+    return true;
+}
+
+unsigned jpeg_private_scale_denominator(unsigned scale_denominator) {
+
+    if (scale_denominator >= 8) {
+        return 8;
+    } else if (scale_denominator >= 4) {
+        return 4;
+    } else if (scale_denominator >= 2) {
+        return 2;
+    } else {
+        return 1;
+    }
+}
+
+J_COLOR_SPACE jpeg_private_output_color_space(J_COLOR_SPACE jpeg_color_space, enum SailPixelFormat pixel_format) {
+
+    const J_COLOR_SPACE out_color_space = jpeg_private_pixel_format_to_color_space(pixel_format);
+
+    if (out_color_space == jpeg_color_space) {
+        return out_color_space;
+    }
+
+    switch (out_color_space) {
+        case JCS_GRAYSCALE: {
+#ifdef SAIL_HAVE_JPEG_JCS_EXT
+            /* libjpeg-turbo converts RGB to grayscale while decoding. */
+            return (jpeg_color_space == JCS_YCbCr || jpeg_color_space == JCS_RGB) ? out_color_space : JCS_UNKNOWN;
+#else
+            return (jpeg_color_space == JCS_YCbCr) ? out_color_space : JCS_UNKNOWN;
+#endif
+        }
+        case JCS_RGB:
+#ifdef SAIL_HAVE_JPEG_JCS_EXT
+        case JCS_RGB565:
+        case JCS_EXT_BGR:
+        case JCS_EXT_RGBA:
+        case JCS_EXT_BGRA:
+        case JCS_EXT_ABGR:
+        case JCS_EXT_ARGB:
+        case JCS_EXT_RGBX:
+        case JCS_EXT_BGRX:
+        case JCS_EXT_XBGR:
+        case JCS_EXT_XRGB:
+#endif
+        {
+            return (jpeg_color_space == JCS_YCbCr || jpeg_color_space == JCS_GRAYSCALE || jpeg_color_space == JCS_RGB)
+                    ? out_color_space : JCS_UNKNOWN;
+        }
+        case JCS_CMYK: {
+            return (jpeg_color_space == JCS_YCCK) ? out_color_space : JCS_UNKNOWN;
+        }
+        default: {
+            return JCS_UNKNOWN;
+        }
+    }
+}
+
+J_COLOR_SPACE jpeg_private_jpeg_color_space(J_COLOR_SPACE in_color_space) {
+
+    switch (in_color_space) {
+#ifdef SAIL_HAVE_JPEG_JCS_EXT
+        case JCS_EXT_RGB:
+        case JCS_EXT_BGR:
+        case JCS_EXT_RGBA:
+        case JCS_EXT_BGRA:
+        case JCS_EXT_ABGR:
+        case JCS_EXT_ARGB:
+        case JCS_EXT_RGBX:
+        case JCS_EXT_BGRX:
+        case JCS_EXT_XBGR:
+        case JCS_EXT_XRGB: {
+            return JCS_RGB;
+        }
+#endif
+        default: {
+            return in_color_space;
+        }
+    }
+}
+
+enum SailPixelFormat jpeg_private_planar_pixel_format(const struct jpeg_decompress_struct *decompress_context,
+                                                      enum SailPixelFormat pixel_format) {
+
+    if (decompress_context->jpeg_color_space != JCS_YCbCr || decompress_context->num_components != 3) {
+        return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+
+    const jpeg_component_info *luma = &decompress_context->comp_info[0];
+
+    for (int i = 1; i < 3; i++) {
+        if (decompress_context->comp_info[i].h_samp_factor != 1 || decompress_context->comp_info[i].v_samp_factor != 1) {
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+    }
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420:
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12: {
+            return (luma->h_samp_factor == 2 && luma->v_samp_factor == 2
+                        && decompress_context->image_width % 2 == 0 && decompress_context->image_height % 2 == 0)
+                    ? pixel_format : SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444: {
+            return (luma->h_samp_factor == 1 && luma->v_samp_factor == 1) ? pixel_format : SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+        default: {
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+    }
+}
+
+unsigned jpeg_private_scan_lines_per_call(const struct jpeg_decompress_struct *decompress_context) {
+
+#if JPEG_LIB_VERSION >= 70
+    const unsigned imcu_row_height = decompress_context->max_v_samp_factor * decompress_context->min_DCT_v_scaled_size;
+#else
+    const unsigned imcu_row_height = decompress_context->max_v_samp_factor * decompress_context->min_DCT_scaled_size;
+#endif
+
+    return SAIL_MAX(SAIL_MAX(imcu_row_height, (unsigned)decompress_context->rec_outbuf_height), 1);
+}
+
+static unsigned read_exif_uint16(const JOCTET *data, bool big_endian) {
+
+    return big_endian ? ((unsigned)data[0] << 8) | data[1] : ((unsigned)data[1] << 8) | data[0];
+}
+
+static unsigned long read_exif_uint32(const JOCTET *data, bool big_endian) {
+
+    return big_endian
+        ? ((unsigned long)data[0] << 24) | ((unsigned long)data[1] << 16) | ((unsigned long)data[2] << 8) | data[3]
+        : ((unsigned long)data[3] << 24) | ((unsigned long)data[2] << 16) | ((unsigned long)data[1] << 8) | data[0];
+}
+
+/* Returns the orientation tag value from the first IFD of the EXIF marker, or 0 if there is none. */
+static unsigned exif_orientation_tag(jpeg_saved_marker_ptr marker) {
+
+    if (marker->marker != JPEG_APP0 + 1 || !marker_has_signature(marker, EXIF_SIGNATURE, EXIF_SIGNATURE_LENGTH)
+            || marker->data_length < EXIF_SIGNATURE_LENGTH + 8) {
+        return 0;
+    }
+
+    const JOCTET *tiff = marker->data + EXIF_SIGNATURE_LENGTH;
+    const unsigned long tiff_length = marker->data_length - EXIF_SIGNATURE_LENGTH;
+    bool big_endian;
+
+    if (memcmp(tiff, "MM", 2) == 0) {
+        big_endian = true;
+    } else if (memcmp(tiff, "II", 2) == 0) {
+        big_endian = false;
+    } else {
+        return 0;
+    }
+
+    if (read_exif_uint16(tiff + 2, big_endian) != 42) {
+        return 0;
+    }
+
+    const unsigned long ifd = read_exif_uint32(tiff + 4, big_endian);
+
+    if (ifd > tiff_length - 2) {
+        return 0;
+    }
+
+    const unsigned entries = read_exif_uint16(tiff + ifd, big_endian);
+
+    for (unsigned i = 0; i < entries; i++) {
+        const unsigned long entry = ifd + 2 + i * 12UL;
+
+        if (entry + 12 > tiff_length) {
+            break;
+        }
+
+        /* SHORT */
+        if (read_exif_uint16(tiff + entry, big_endian) == 0x0112) {
+            return read_exif_uint16(tiff + entry + 2, big_endian) == 3 ? read_exif_uint16(tiff + entry + 8, big_endian) : 0;
+        }
+    }
+
+    return 0;
+}
+
+enum SailOrientation jpeg_private_exif_orientation(const struct jpeg_decompress_struct *decompress_context) {
+
+    for (jpeg_saved_marker_ptr marker = decompress_context->marker_list; marker != NULL; marker = marker->next) {
+        /* Orientation that displays the image correctly. */
+        switch (exif_orientation_tag(marker)) {
+            case 0:  continue;
+            case 2:  return SAIL_ORIENTATION_MIRRORED_HORIZONTALLY;
+            case 3:  return SAIL_ORIENTATION_ROTATED_180;
+            case 4:  return SAIL_ORIENTATION_MIRRORED_VERTICALLY;
+            case 5:  return SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270;
+            case 6:  return SAIL_ORIENTATION_ROTATED_90;
+            case 7:  return SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90;
+            case 8:  return SAIL_ORIENTATION_ROTATED_270;
+            default: return SAIL_ORIENTATION_NORMAL;
+        }
+    }
+
+    return SAIL_ORIENTATION_NORMAL;
+}
+
+bool jpeg_private_orientation_transposes(enum SailOrientation orientation) {
+
+    switch (orientation) {
+        case SAIL_ORIENTATION_ROTATED_90:
+        case SAIL_ORIENTATION_ROTATED_270:
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90:
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+void jpeg_private_oriented_roi_to_stored(const struct sail_roi *roi, unsigned width, unsigned height,
+                                         enum SailOrientation orientation, struct sail_roi *stored_roi) {
+
+    const unsigned right  = width  - roi->x - roi->width;
+    const unsigned bottom = height - roi->y - roi->height;
+
+    /* 'width' and 'height' are the oriented dimensions, so transposed stored edges come from the other axis. */
+    switch (orientation) {
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY:            *stored_roi = (struct sail_roi) { right,  roi->y, roi->width,  roi->height }; break;
+        case SAIL_ORIENTATION_MIRRORED_VERTICALLY:              *stored_roi = (struct sail_roi) { roi->x, bottom, roi->width,  roi->height }; break;
+        case SAIL_ORIENTATION_ROTATED_180:                      *stored_roi = (struct sail_roi) { right,  bottom, roi->width,  roi->height }; break;
+        case SAIL_ORIENTATION_ROTATED_90:                       *stored_roi = (struct sail_roi) { roi->y, right,  roi->height, roi->width  }; break;
+        case SAIL_ORIENTATION_ROTATED_270:                      *stored_roi = (struct sail_roi) { bottom, roi->x, roi->height, roi->width  }; break;
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90: *stored_roi = (struct sail_roi) { bottom, right,  roi->height, roi->width  }; break;
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270: *stored_roi = (struct sail_roi) { roi->y, roi->x, roi->height, roi->width }; break;
+        default:                                                *stored_roi = *roi; break;
+    }
+}
+
+void jpeg_private_write_oriented_row(const unsigned char *scan_line, unsigned width, unsigned height, unsigned row,
+                                     unsigned bytes_per_pixel, enum SailOrientation orientation,
+                                     unsigned char *pixels, size_t bytes_per_line) {
+
+    const ptrdiff_t pixel   = bytes_per_pixel;
+    const ptrdiff_t stride  = (ptrdiff_t)bytes_per_line;
+    const ptrdiff_t x_last  = (ptrdiff_t)width - 1;
+    const ptrdiff_t y       = row;
+    const ptrdiff_t flipped = (ptrdiff_t)height - 1 - row;
+
+    /* Position of the first pixel of the row and the step to the next one in the oriented frame. */
+    ptrdiff_t start;
+    ptrdiff_t step;
+
+    switch (orientation) {
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY:             start = y * stride + x_last * pixel;       step = -pixel;  break;
+        case SAIL_ORIENTATION_MIRRORED_VERTICALLY:               start = flipped * stride;                  step = pixel;   break;
+        case SAIL_ORIENTATION_ROTATED_180:                       start = flipped * stride + x_last * pixel; step = -pixel;  break;
+        case SAIL_ORIENTATION_ROTATED_90:                        start = flipped * pixel;                   step = stride;  break;
+        case SAIL_ORIENTATION_ROTATED_270:                       start = y * pixel + x_last * stride;       step = -stride; break;
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90:  start = flipped * pixel + x_last * stride; step = -stride; break;
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270: start = y * pixel;                         step = stride;  break;
+        default:                                                 start = y * stride;                        step = pixel;   break;
+    }
+
+    unsigned char *out = pixels + start;
+
+    if (step == pixel) {
+        memcpy(out, scan_line, (size_t)width * bytes_per_pixel);
+        return;
+    }
+
+    switch (bytes_per_pixel) {
+        case 1: {
+            for (unsigned x = 0; x < width; x++, out += step) {
+                out[0] = scan_line[x];
+            }
+            break;
+        }
+        case 3: {
+            for (unsigned x = 0; x < width; x++, out += step, scan_line += 3) {
+                out[0] = scan_line[0];
+                out[1] = scan_line[1];
+                out[2] = scan_line[2];
+            }
+            break;
+        }
+        case 4: {
+            for (unsigned x = 0; x < width; x++, out += step, scan_line += 4) {
+                memcpy(out, scan_line, 4);
+            }
+            break;
+        }
+        default: {
+            for (unsigned x = 0; x < width; x++, out += step, scan_line += bytes_per_pixel) {
+                memcpy(out, scan_line, bytes_per_pixel);
+            }
+            break;
+        }
+    }
+}
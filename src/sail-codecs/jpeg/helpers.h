@@ -35,8 +35,12 @@
 #include <sail-common/common.h>
 #include <sail-common/export.h>
 
+struct sail_image;
+struct sail_load_options;
 struct sail_meta_data_node;
 struct sail_resolution;
+struct sail_save_options;
+struct sail_roi;
 
 struct jpeg_private_my_error_context {
     struct jpeg_error_mgr jpeg_error_mgr;
@@ -51,10 +55,16 @@ SAIL_HIDDEN enum SailPixelFormat jpeg_private_color_space_to_pixel_format(J_COLO
 
 SAIL_HIDDEN J_COLOR_SPACE jpeg_private_pixel_format_to_color_space(enum SailPixelFormat pixel_format);
 
-SAIL_HIDDEN sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decompress_context, struct sail_meta_data_node **last_meta_data_node);
+/* Fetches the meta data keys selected in the load options. */
+SAIL_HIDDEN sail_status_t jpeg_private_fetch_meta_data(struct jpeg_decompress_struct *decompress_context, const struct sail_load_options *load_options,
+                                                       struct sail_meta_data_node **last_meta_data_node);
 
 SAIL_HIDDEN sail_status_t jpeg_private_write_meta_data(struct jpeg_compress_struct *compress_context, const struct sail_meta_data_node *meta_data_node);
 
+/* Writes the meta data and the ICC profile selected in the save options. Must be called right after jpeg_start_compress(). */
+SAIL_HIDDEN sail_status_t jpeg_private_write_markers(struct jpeg_compress_struct *compress_context, const struct sail_save_options *save_options,
+                                                     const struct sail_image *image);
+
 #ifdef SAIL_HAVE_JPEG_ICCP
 SAIL_HIDDEN sail_status_t jpeg_private_fetch_iccp(struct jpeg_decompress_struct *decompress_context, struct sail_iccp **iccp);
 #endif
@@ -65,4 +75,59 @@ SAIL_HIDDEN sail_status_t jpeg_private_write_resolution(struct jpeg_compress_str
 
 SAIL_HIDDEN bool jpeg_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
 
+/* Applies load tuning to the decompress context passed in the user data. */
+SAIL_HIDDEN bool jpeg_private_load_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+/* Rounds the requested scale denominator down to 1, 2, 4, or 8. */
+SAIL_HIDDEN unsigned jpeg_private_scale_denominator(unsigned scale_denominator);
+
+/*
+ * Returns the output color space to decode the JPEG color space into the requested pixel format,
+ * or JCS_UNKNOWN if libjpeg cannot convert between them.
+ */
+SAIL_HIDDEN J_COLOR_SPACE jpeg_private_output_color_space(J_COLOR_SPACE jpeg_color_space, enum SailPixelFormat pixel_format);
+
+/*
+ * Returns the planar pixel format to decode raw YCbCr samples into, or SAIL_PIXEL_FORMAT_UNKNOWN
+ * if the JPEG sampling factors or dimensions don't match the requested planar pixel format.
+ */
+SAIL_HIDDEN enum SailPixelFormat jpeg_private_planar_pixel_format(const struct jpeg_decompress_struct *decompress_context,
+                                                                  enum SailPixelFormat pixel_format);
+
+/*
+ * Returns the JPEG color space to save pixels of the specified input color space into. Extended RGB
+ * layouts are converted into RGB by libjpeg row by row, and their alpha or padding channel is dropped.
+ */
+SAIL_HIDDEN J_COLOR_SPACE jpeg_private_jpeg_color_space(J_COLOR_SPACE in_color_space);
+
+/*
+ * Returns the number of scan lines to pass into jpeg_read_scanlines() to decode a whole iMCU row
+ * per call. Must be called after jpeg_start_decompress().
+ */
+SAIL_HIDDEN unsigned jpeg_private_scan_lines_per_call(const struct jpeg_decompress_struct *decompress_context);
+
+/*
+ * Returns the orientation that displays the image correctly from the EXIF orientation tag of the saved
+ * APP1 markers, or SAIL_ORIENTATION_NORMAL if there is none.
+ */
+SAIL_HIDDEN enum SailOrientation jpeg_private_exif_orientation(const struct jpeg_decompress_struct *decompress_context);
+
+/* Returns true if the orientation swaps the image dimensions. */
+SAIL_HIDDEN bool jpeg_private_orientation_transposes(enum SailOrientation orientation);
+
+/*
+ * Maps the region of interest in the oriented frame of the specified oriented dimensions to the region
+ * of the stored frame.
+ */
+SAIL_HIDDEN void jpeg_private_oriented_roi_to_stored(const struct sail_roi *roi, unsigned width, unsigned height,
+                                                     enum SailOrientation orientation, struct sail_roi *stored_roi);
+
+/*
+ * Writes the decoded row of the stored frame of the specified dimensions to its place
+ * in the oriented frame pixels.
+ */
+SAIL_HIDDEN void jpeg_private_write_oriented_row(const unsigned char *scan_line, unsigned width, unsigned height, unsigned row,
+                                                 unsigned bytes_per_pixel, enum SailOrientation orientation,
+                                                 unsigned char *pixels, size_t bytes_per_line);
+
 #endif
@@ -33,7 +33,8 @@
  * Most of this file was copied from libjpeg-turbo 2.0.4 and adapted to SAIL.
  */
 
-#define OUTPUT_BUF_SIZE  4096   /* choose an efficiently fwrite'able size */
+/* Larger blocks mean fewer writes into the underlying I/O stream. */
+#define OUTPUT_BUF_SIZE  (64 * 1024)
 
 /*
  * Initialize destination --- called by jpeg_start_compress
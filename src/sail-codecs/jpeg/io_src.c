@@ -205,3 +205,104 @@ void jpeg_private_sail_io_src(j_decompress_ptr cinfo, struct sail_io *io) {
     src->pub.bytes_in_buffer   = 0;    /* forces fill_input_buffer on first read */
     src->pub.next_input_byte   = NULL; /* until buffer loaded */
 }
+
+/*
+ * Push data source. libjpeg suspends when fill_input_buffer() returns FALSE,
+ * and backs up to a restart point to rescan the data when it's offered again.
+ */
+
+static void init_push_source(j_decompress_ptr cinfo)
+{
+    (void)cinfo;
+}
+
+static boolean fill_push_input_buffer(j_decompress_ptr cinfo)
+{
+    struct sail_jpeg_push_source_mgr *src = (struct sail_jpeg_push_source_mgr *)cinfo->src;
+
+    if (!src->end) {
+        return FALSE;
+    }
+
+    WARNMS(cinfo, JWRN_JPEG_EOF);
+    /* Insert a fake EOI marker */
+    src->eoi[0] = (JOCTET)0xFF;
+    src->eoi[1] = (JOCTET)JPEG_EOI;
+
+    src->pub.next_input_byte = src->eoi;
+    src->pub.bytes_in_buffer = 2;
+    src->eoi_inserted = TRUE;
+
+    return TRUE;
+}
+
+/*
+ * skip_input_data is not allowed to suspend, so the bytes that are not offered
+ * yet are skipped when they're offered.
+ */
+static void skip_push_input_data(j_decompress_ptr cinfo, long num_bytes)
+{
+    struct sail_jpeg_push_source_mgr *src = (struct sail_jpeg_push_source_mgr *)cinfo->src;
+
+    if (num_bytes <= 0) {
+        return;
+    }
+
+    if ((size_t)num_bytes <= src->pub.bytes_in_buffer) {
+        src->pub.next_input_byte += (size_t)num_bytes;
+        src->pub.bytes_in_buffer -= (size_t)num_bytes;
+        return;
+    }
+
+    src->skip_bytes += (size_t)num_bytes - src->pub.bytes_in_buffer;
+
+    src->pub.next_input_byte += src->pub.bytes_in_buffer;
+    src->pub.bytes_in_buffer = 0;
+}
+
+void jpeg_private_push_src(j_decompress_ptr cinfo) {
+
+    if (cinfo->src == NULL) {
+        cinfo->src = cinfo->mem->alloc_small((j_common_ptr)cinfo,
+                                                JPOOL_PERMANENT,
+                                                sizeof(struct sail_jpeg_push_source_mgr));
+    } else if (cinfo->src->init_source != init_push_source) {
+        ERREXIT(cinfo, JERR_BUFFER_SIZE);
+    }
+
+    struct sail_jpeg_push_source_mgr *src = (struct sail_jpeg_push_source_mgr *)cinfo->src;
+
+    src->pub.init_source       = init_push_source;
+    src->pub.fill_input_buffer = fill_push_input_buffer;
+    src->pub.skip_input_data   = skip_push_input_data;
+    src->pub.resync_to_restart = jpeg_resync_to_restart; /* use default method */
+    src->pub.term_source       = term_source;
+    src->pub.bytes_in_buffer   = 0;
+    src->pub.next_input_byte   = NULL;
+    src->offered_size          = 0;
+    src->skip_bytes            = 0;
+    src->end                   = FALSE;
+    src->eoi_inserted          = FALSE;
+}
+
+void jpeg_private_push_src_offer(j_decompress_ptr cinfo, const void *data, size_t size, bool end) {
+
+    struct sail_jpeg_push_source_mgr *src = (struct sail_jpeg_push_source_mgr *)cinfo->src;
+
+    const size_t skip = (src->skip_bytes < size) ? src->skip_bytes : size;
+
+    src->skip_bytes -= skip;
+
+    src->pub.next_input_byte = (const JOCTET *)data + skip;
+    src->pub.bytes_in_buffer = size - skip;
+    src->offered_size        = size;
+    src->end                 = end;
+    src->eoi_inserted        = FALSE;
+}
+
+size_t jpeg_private_push_src_consumed(j_decompress_ptr cinfo) {
+
+    const struct sail_jpeg_push_source_mgr *src = (const struct sail_jpeg_push_source_mgr *)cinfo->src;
+
+    return src->eoi_inserted ? src->offered_size : src->offered_size - src->pub.bytes_in_buffer;
+}
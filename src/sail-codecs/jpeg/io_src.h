@@ -26,6 +26,8 @@
 #ifndef SAIL_JPEG_IO_SRC_H
 #define SAIL_JPEG_IO_SRC_H
 
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
 #include <stdio.h>
 
 #include <jpeglib.h>
@@ -47,4 +49,29 @@ struct sail_jpeg_source_mgr {
 
 SAIL_HIDDEN void jpeg_private_sail_io_src(j_decompress_ptr cinfo, struct sail_io *io);
 
+/*
+ * Suspending data source over the data offered by the caller. libjpeg suspends when it needs
+ * more data than offered, unless the end of the data is reached.
+ */
+struct sail_jpeg_push_source_mgr {
+    struct jpeg_source_mgr pub;   /* public fields */
+
+    size_t offered_size;          /* size of the offered data */
+    size_t skip_bytes;            /* bytes to skip in the data offered next */
+    boolean end;                  /* no more data will be offered */
+    boolean eoi_inserted;         /* the offered data has been replaced with a fake EOI marker */
+    JOCTET eoi[2];                /* the fake EOI marker */
+};
+
+SAIL_HIDDEN void jpeg_private_push_src(j_decompress_ptr cinfo);
+
+/*
+ * Offers the data to the push data source. The data must start with the first byte
+ * not consumed from the previous offer.
+ */
+SAIL_HIDDEN void jpeg_private_push_src_offer(j_decompress_ptr cinfo, const void *data, size_t size, bool end);
+
+/* Returns the number of bytes of the offered data libjpeg doesn't need anymore. */
+SAIL_HIDDEN size_t jpeg_private_push_src_consumed(j_decompress_ptr cinfo);
+
 #endif
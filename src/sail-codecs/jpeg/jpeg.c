@@ -36,6 +36,10 @@
 #include "helpers.h"
 #include "io_dest.h"
 #include "io_src.h"
+#include "target.h"
+#ifdef SAIL_HAVE_NVJPEG
+#include "nvjpeg_decoder.h"
+#endif
 
 /*
  * Codec-specific data types.
@@ -45,6 +49,9 @@ static const double COMPRESSION_MIN     = 0;
 static const double COMPRESSION_MAX     = 100;
 static const double COMPRESSION_DEFAULT = 15;
 
+/* Upper limit of scan lines passed into libjpeg per call. Covers iMCU rows of all sampling factors and scales. */
+#define MAX_SCAN_LINES_PER_CALL 64
+
 /*
  * Codec-specific state.
  */
@@ -60,6 +67,41 @@ struct jpeg_state {
     bool frame_loaded;
     bool frame_saved;
     bool started_compress;
+
+    /* Stream to save into, and the trial encodes for save_options->target_size and target_quality. */
+    struct sail_io *io;
+    struct jpeg_private_target *target;
+
+    /* Progressive frame decoded in multiple output passes for load_options->pass_callback. */
+    bool buffered_image;
+
+    /* Incremental loading. The header is read and the decompressor is set up. */
+    bool push_header_read;
+
+    /* Region of interest cropped by libjpeg-turbo and the offset of the region in the cropped scan lines. */
+    struct sail_roi roi;
+    unsigned crop_offset;
+    unsigned char *crop_scanline;
+
+    /* EXIF orientation of the frame, and the orientation applied while decoding with SAIL_OPTION_AUTO_ORIENT. */
+    enum SailOrientation exif_orientation;
+    enum SailOrientation orientation;
+    unsigned char *oriented_scan_lines;
+    unsigned char *oriented_frame;
+
+    /* Planar pixel format of the raw YCbCr samples decoded for load_options->output_pixel_format, and their scratch rows. */
+    enum SailPixelFormat planar_pixel_format;
+    unsigned char *raw_data;
+
+#ifdef SAIL_HAVE_NVJPEG
+    /* GPU decoder created on the first suitable frame and kept over load_reset(). */
+    struct jpeg_private_nvjpeg *nvjpeg;
+    bool nvjpeg_unavailable;
+
+    /* The whole JPEG stream of a mapped I/O object for nvJPEG. */
+    const void *mapped_data;
+    size_t mapped_data_size;
+#endif
 };
 
 static sail_status_t alloc_jpeg_state(const struct sail_load_options *load_options,
@@ -80,6 +122,28 @@ static sail_status_t alloc_jpeg_state(const struct sail_load_options *load_optio
         .frame_loaded       = false,
         .frame_saved        = false,
         .started_compress   = false,
+        .io                 = NULL,
+        .target             = NULL,
+        .buffered_image     = false,
+        .push_header_read   = false,
+
+        .crop_offset   = 0,
+        .crop_scanline = NULL,
+
+        .exif_orientation    = SAIL_ORIENTATION_NORMAL,
+        .orientation         = SAIL_ORIENTATION_NORMAL,
+        .oriented_scan_lines = NULL,
+        .oriented_frame      = NULL,
+
+        .planar_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN,
+        .raw_data            = NULL,
+
+#ifdef SAIL_HAVE_NVJPEG
+        .nvjpeg             = NULL,
+        .nvjpeg_unavailable = false,
+        .mapped_data        = NULL,
+        .mapped_data_size   = 0,
+#endif
     };
 
     return SAIL_OK;
@@ -93,22 +157,201 @@ static void destroy_jpeg_state(struct jpeg_state *jpeg_state) {
 
     sail_free(jpeg_state->decompress_context);
     sail_free(jpeg_state->compress_context);
+    sail_free(jpeg_state->crop_scanline);
+    sail_free(jpeg_state->oriented_scan_lines);
+    sail_free(jpeg_state->oriented_frame);
+    sail_free(jpeg_state->raw_data);
+
+    jpeg_private_destroy_target(jpeg_state->target);
+
+#ifdef SAIL_HAVE_NVJPEG
+    jpeg_private_destroy_nvjpeg(jpeg_state->nvjpeg);
+#endif
 
     sail_free(jpeg_state);
 }
 
+/* Decodes whole iMCU rows right into the image pixels. */
+static sail_status_t read_scan_lines(struct jpeg_decompress_struct *decompress_context, const struct sail_image *image) {
+
+    const unsigned lines_per_call = SAIL_MIN(jpeg_private_scan_lines_per_call(decompress_context), MAX_SCAN_LINES_PER_CALL);
+    JSAMPROW samprows[MAX_SCAN_LINES_PER_CALL];
+
+    for (unsigned row = 0; row < image->height;) {
+        const unsigned lines = SAIL_MIN(lines_per_call, image->height - row);
+
+        for (unsigned i = 0; i < lines; i++) {
+            samprows[i] = (JSAMPROW)sail_scan_line(image, row + i);
+        }
+
+        const JDIMENSION lines_read = jpeg_read_scanlines(decompress_context, samprows, lines);
+
+        if (lines_read == 0) {
+            SAIL_LOG_ERROR("JPEG: Failed to read scan lines");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        row += lines_read;
+    }
+
+    return SAIL_OK;
+}
+
 /*
- * Decoding functions.
+ * Decodes the frame and writes every row to its place in the oriented frame. The row callback
+ * receives the rows when the whole oriented frame is decoded.
  */
+static sail_status_t read_oriented_scan_lines(struct jpeg_state *jpeg_state, const struct sail_image *image) {
 
-SAIL_EXPORT sail_status_t sail_codec_load_init_v8_jpeg(struct sail_io *io, const struct sail_load_options *load_options, void **state) {
+    struct jpeg_decompress_struct *decompress_context = jpeg_state->decompress_context;
 
-    *state = NULL;
+    const unsigned bytes_per_pixel = decompress_context->output_components;
+    const bool transposed          = jpeg_private_orientation_transposes(jpeg_state->orientation);
 
-    /* Allocate a new state. */
-    struct jpeg_state *jpeg_state;
-    SAIL_TRY(alloc_jpeg_state(load_options, NULL, &jpeg_state));
-    *state = jpeg_state;
+    /* Dimensions of the stored frame. */
+    const unsigned width  = transposed ? image->height : image->width;
+    const unsigned height = transposed ? image->width  : image->height;
+
+    unsigned char *pixels = image->pixels;
+    size_t bytes_per_line = image->bytes_per_line;
+
+    if (jpeg_state->load_options->row_callback != NULL) {
+        bytes_per_line = (size_t)image->width * bytes_per_pixel;
+
+        void *ptr;
+        SAIL_TRY(sail_malloc(bytes_per_line * image->height, &ptr));
+        jpeg_state->oriented_frame = ptr;
+        pixels = jpeg_state->oriented_frame;
+    }
+
+    /* Scan lines cropped by libjpeg-turbo may be wider than the region. */
+    const size_t scan_line_size   = (size_t)decompress_context->output_width * bytes_per_pixel;
+    const unsigned lines_per_call = SAIL_MIN(jpeg_private_scan_lines_per_call(decompress_context), MAX_SCAN_LINES_PER_CALL);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(scan_line_size * lines_per_call, &ptr));
+    jpeg_state->oriented_scan_lines = ptr;
+
+    JSAMPROW samprows[MAX_SCAN_LINES_PER_CALL];
+
+    for (unsigned i = 0; i < lines_per_call; i++) {
+        samprows[i] = (JSAMPROW)(jpeg_state->oriented_scan_lines + i * scan_line_size);
+    }
+
+    for (unsigned row = 0; row < height;) {
+        const JDIMENSION lines_read = jpeg_read_scanlines(decompress_context, samprows, SAIL_MIN(lines_per_call, height - row));
+
+        if (lines_read == 0) {
+            SAIL_LOG_ERROR("JPEG: Failed to read scan lines");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        for (unsigned i = 0; i < lines_read; i++) {
+            jpeg_private_write_oriented_row((const unsigned char *)samprows[i] + (size_t)jpeg_state->crop_offset * bytes_per_pixel,
+                                            width, height, row + i, bytes_per_pixel, jpeg_state->orientation,
+                                            pixels, bytes_per_line);
+        }
+
+        row += lines_read;
+    }
+
+    sail_free(jpeg_state->oriented_scan_lines);
+    jpeg_state->oriented_scan_lines = NULL;
+
+    if (jpeg_state->oriented_frame != NULL) {
+        for (unsigned row = 0; row < image->height; row++) {
+            memcpy(sail_scan_line_to_load(jpeg_state->load_options, image, row), pixels + row * bytes_per_line, bytes_per_line);
+            SAIL_TRY(sail_scan_line_loaded(jpeg_state->load_options, image, row));
+        }
+
+        sail_free(jpeg_state->oriented_frame);
+        jpeg_state->oriented_frame = NULL;
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Decodes the raw YCbCr samples iMCU row by iMCU row and copies them into the image planes.
+ * libjpeg outputs whole blocks, so the samples are decoded into scratch rows that cover them.
+ */
+static sail_status_t read_raw_data(struct jpeg_state *jpeg_state, const struct sail_image *image) {
+
+    struct jpeg_decompress_struct *decompress_context = jpeg_state->decompress_context;
+
+    void *planes[4];
+    unsigned strides[4];
+    unsigned planes_count;
+    SAIL_TRY(sail_image_planes(image, planes, strides, &planes_count));
+
+    /* Luma is sampled 1x1 or 2x2, and chroma is always sampled 1x1. See jpeg_private_planar_pixel_format(). */
+    const unsigned luma_rows     = decompress_context->max_v_samp_factor * DCTSIZE;
+    const unsigned luma_width    = decompress_context->comp_info[0].width_in_blocks * DCTSIZE;
+    const unsigned chroma_width  = decompress_context->comp_info[1].width_in_blocks * DCTSIZE;
+    const bool subsampled        = image->pixel_format != SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444;
+    const unsigned chroma_height = subsampled ? image->height / 2 : image->height;
+    const unsigned plane_width   = subsampled ? image->width / 2 : image->width;
+
+    const size_t luma_size   = (size_t)luma_width * luma_rows;
+    const size_t chroma_size = (size_t)chroma_width * DCTSIZE;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(luma_size + chroma_size * 2, &ptr));
+    jpeg_state->raw_data = ptr;
+
+    JSAMPROW y_rows[2 * DCTSIZE];
+    JSAMPROW cb_rows[DCTSIZE];
+    JSAMPROW cr_rows[DCTSIZE];
+    JSAMPARRAY components[3] = { y_rows, cb_rows, cr_rows };
+
+    for (unsigned i = 0; i < luma_rows; i++) {
+        y_rows[i] = jpeg_state->raw_data + i * luma_width;
+    }
+    for (unsigned i = 0; i < DCTSIZE; i++) {
+        cb_rows[i] = jpeg_state->raw_data + luma_size + i * chroma_width;
+        cr_rows[i] = jpeg_state->raw_data + luma_size + chroma_size + i * chroma_width;
+    }
+
+    const bool interleaved = image->pixel_format == SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12;
+
+    for (unsigned row = 0; row < image->height; row += luma_rows) {
+        if (jpeg_read_raw_data(decompress_context, components, luma_rows) == 0) {
+            SAIL_LOG_ERROR("JPEG: Failed to read raw data");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        const unsigned lines = SAIL_MIN(luma_rows, image->height - row);
+
+        for (unsigned i = 0; i < lines; i++) {
+            memcpy((unsigned char *)planes[0] + (size_t)(row + i) * strides[0], y_rows[i], image->width);
+        }
+
+        const unsigned chroma_row   = subsampled ? row / 2 : row;
+        const unsigned chroma_lines = SAIL_MIN(DCTSIZE, chroma_height - chroma_row);
+
+        for (unsigned i = 0; i < chroma_lines; i++) {
+            unsigned char *cb = (unsigned char *)planes[1] + (size_t)(chroma_row + i) * strides[1];
+
+            if (interleaved) {
+                for (unsigned x = 0; x < plane_width; x++) {
+                    cb[x * 2]     = cb_rows[i][x];
+                    cb[x * 2 + 1] = cr_rows[i][x];
+                }
+            } else {
+                memcpy(cb, cb_rows[i], plane_width);
+                memcpy((unsigned char *)planes[2] + (size_t)(chroma_row + i) * strides[2], cr_rows[i], plane_width);
+            }
+        }
+    }
+
+    sail_free(jpeg_state->raw_data);
+    jpeg_state->raw_data = NULL;
+
+    return SAIL_OK;
+}
+
+/* Creates the decompress context, and selects the markers to save. */
+static sail_status_t create_decompress(struct jpeg_state *jpeg_state) {
 
     /* Create decompress context. */
     void *ptr;
@@ -125,18 +368,35 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_jpeg(struct sail_io *io, const
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    /* JPEG setup. */
+    /* JPEG setup. Saved markers survive resets. */
     jpeg_create_decompress(jpeg_state->decompress_context);
-    jpeg_private_sail_io_src(jpeg_state->decompress_context, io);
 
-    if (jpeg_state->load_options->options & SAIL_OPTION_META_DATA) {
+    /* Markers of the meta data keys that are not selected are skipped without copying. */
+    if (sail_load_meta_data_key(jpeg_state->load_options, SAIL_META_DATA_COMMENT)) {
         jpeg_save_markers(jpeg_state->decompress_context, JPEG_COM, 0xffff);
     }
+    /* EXIF and XMP. EXIF is also needed for the orientation. */
+    if (sail_load_meta_data_key(jpeg_state->load_options, SAIL_META_DATA_EXIF)
+            || sail_load_meta_data_key(jpeg_state->load_options, SAIL_META_DATA_XMP)
+            || (jpeg_state->load_options->options & (SAIL_OPTION_SOURCE_IMAGE | SAIL_OPTION_AUTO_ORIENT))) {
+        jpeg_save_markers(jpeg_state->decompress_context, JPEG_APP0 + 1, 0xffff);
+    }
     if (jpeg_state->load_options->options & SAIL_OPTION_ICCP) {
         jpeg_save_markers(jpeg_state->decompress_context, JPEG_APP0 + 2, 0xFFFF);
     }
 
-    jpeg_read_header(jpeg_state->decompress_context, true);
+    return SAIL_OK;
+}
+
+/*
+ * Sets up the decompression parameters after the header is read: orientation, output color space,
+ * tuning, scaling, and planar output.
+ */
+static void set_up_decompress(struct jpeg_state *jpeg_state) {
+
+    jpeg_state->exif_orientation = jpeg_private_exif_orientation(jpeg_state->decompress_context);
+    jpeg_state->orientation      = (jpeg_state->load_options->options & SAIL_OPTION_AUTO_ORIENT)
+                                        ? jpeg_state->exif_orientation : SAIL_ORIENTATION_NORMAL;
 
     /* Handle the requested color space. */
     if (jpeg_state->decompress_context->jpeg_color_space == JCS_YCbCr) {
@@ -145,30 +405,108 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_jpeg(struct sail_io *io, const
         jpeg_state->decompress_context->out_color_space = jpeg_state->decompress_context->jpeg_color_space;
     }
 
+    /* Let libjpeg convert pixels into the requested output pixel format while decoding. */
+    if (jpeg_state->load_options->output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN
+            && !sail_is_planar(jpeg_state->load_options->output_pixel_format)) {
+        const J_COLOR_SPACE out_color_space =
+            jpeg_private_output_color_space(jpeg_state->decompress_context->jpeg_color_space,
+                                            jpeg_state->load_options->output_pixel_format);
+
+        if (out_color_space != JCS_UNKNOWN) {
+            jpeg_state->decompress_context->out_color_space = out_color_space;
+        } else {
+            SAIL_LOG_DEBUG("JPEG: Cannot decode into %s, falling back to the native pixel format",
+                            sail_pixel_format_to_string(jpeg_state->load_options->output_pixel_format));
+        }
+    }
+
     /* We don't want colormapped output. */
     jpeg_state->decompress_context->quantize_colors = false;
 
-    /* Launch decompression! */
-    jpeg_start_decompress(jpeg_state->decompress_context);
+    /* Handle tuning. */
+    if (jpeg_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(jpeg_state->load_options->tuning, jpeg_private_load_tuning_key_value_callback, jpeg_state->decompress_context);
+    }
 
-    return SAIL_OK;
-}
+    /* DCT scaling. libjpeg supports 1/2, 1/4, and 1/8 for any JPEG. */
+    const unsigned scale_denominator = jpeg_private_scale_denominator(jpeg_state->load_options->scale_denominator);
 
-SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpeg(void *state, struct sail_image **image) {
+    if (scale_denominator > 1) {
+        jpeg_state->decompress_context->scale_num   = 1;
+        jpeg_state->decompress_context->scale_denom = scale_denominator;
+    }
 
-    struct jpeg_state *jpeg_state = state;
+    /* Output the stored YCbCr samples without upsampling and color conversion into the requested planar pixel format. */
+    jpeg_state->planar_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN;
 
-    if (jpeg_state->frame_loaded) {
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    if (sail_load_planar_output(jpeg_state->load_options)) {
+        if (scale_denominator == 1 && jpeg_state->orientation == SAIL_ORIENTATION_NORMAL) {
+            jpeg_state->planar_pixel_format = jpeg_private_planar_pixel_format(jpeg_state->decompress_context,
+                                                                               jpeg_state->load_options->output_pixel_format);
+        }
+
+        if (jpeg_state->planar_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
+            jpeg_state->decompress_context->out_color_space = JCS_YCbCr;
+            jpeg_state->decompress_context->raw_data_out    = true;
+        } else {
+            SAIL_LOG_DEBUG("JPEG: Cannot decode into %s, falling back to the native pixel format",
+                            sail_pixel_format_to_string(jpeg_state->load_options->output_pixel_format));
+        }
     }
+}
 
-    jpeg_state->frame_loaded = true;
+/* Reads the header of a new image from the I/O object and starts decompressing it. */
+static sail_status_t start_decompress(struct jpeg_state *jpeg_state, struct sail_io *io) {
 
     if (setjmp(jpeg_state->error_context.setjmp_buffer) != 0) {
         jpeg_state->libjpeg_error = true;
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+#ifdef SAIL_HAVE_NVJPEG
+    jpeg_state->mapped_data      = NULL;
+    jpeg_state->mapped_data_size = 0;
+
+    /* nvJPEG needs the whole stream in memory. */
+    if ((io->features & SAIL_IO_FEATURE_MAPPED) && io->map != NULL) {
+        if (io->map(io->stream, &jpeg_state->mapped_data, &jpeg_state->mapped_data_size) != SAIL_OK) {
+            jpeg_state->mapped_data      = NULL;
+            jpeg_state->mapped_data_size = 0;
+        }
+    }
+#endif
+
+    jpeg_private_sail_io_src(jpeg_state->decompress_context, io);
+
+    jpeg_read_header(jpeg_state->decompress_context, true);
+
+    set_up_decompress(jpeg_state);
+
+    if (jpeg_state->load_options->options & SAIL_OPTION_PROBE) {
+        /* Output dimensions are all we need. */
+        jpeg_calc_output_dimensions(jpeg_state->decompress_context);
+    } else {
+        /* Refine progressive frames pass by pass. */
+        if (jpeg_state->load_options->pass_callback != NULL
+                && jpeg_state->load_options->row_callback == NULL
+                && !sail_roi_is_set(&jpeg_state->load_options->roi)
+                && jpeg_state->orientation == SAIL_ORIENTATION_NORMAL
+                && jpeg_state->planar_pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN
+                && jpeg_has_multiple_scans(jpeg_state->decompress_context)) {
+            jpeg_state->decompress_context->buffered_image = true;
+            jpeg_state->buffered_image = true;
+        }
+
+        /* Launch decompression! */
+        jpeg_start_decompress(jpeg_state->decompress_context);
+    }
+
+    return SAIL_OK;
+}
+
+/* Builds the frame from the decompressor state after jpeg_start_decompress(). */
+static sail_status_t build_image(struct jpeg_state *jpeg_state, struct sail_image **image) {
+
     struct sail_image *image_local;
     SAIL_TRY(sail_alloc_image(&image_local));
 
@@ -178,17 +516,58 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpeg(void *state, s
 
         image_local->source_image->pixel_format = jpeg_private_color_space_to_pixel_format(jpeg_state->decompress_context->jpeg_color_space);
         image_local->source_image->compression  = SAIL_COMPRESSION_JPEG;
+
+        /* Frames oriented while decoding are displayed as is. */
+        if (jpeg_state->orientation == SAIL_ORIENTATION_NORMAL) {
+            image_local->source_image->orientation = jpeg_state->exif_orientation;
+        }
     }
 
+    const bool transposed = jpeg_private_orientation_transposes(jpeg_state->orientation);
+
     /* Image properties. */
-    image_local->width          = jpeg_state->decompress_context->output_width;
-    image_local->height         = jpeg_state->decompress_context->output_height;
-    image_local->pixel_format   = jpeg_private_color_space_to_pixel_format(jpeg_state->decompress_context->out_color_space);
+    image_local->width          = transposed ? jpeg_state->decompress_context->output_height : jpeg_state->decompress_context->output_width;
+    image_local->height         = transposed ? jpeg_state->decompress_context->output_width  : jpeg_state->decompress_context->output_height;
+    image_local->pixel_format   = (jpeg_state->planar_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN)
+                                    ? jpeg_state->planar_pixel_format
+                                    : jpeg_private_color_space_to_pixel_format(jpeg_state->decompress_context->out_color_space);
+
+#ifdef SAIL_HAVE_JPEG_CROP
+    if (sail_roi_is_set(&jpeg_state->load_options->roi) && !(jpeg_state->load_options->options & SAIL_OPTION_PROBE)) {
+        /* The region is in the oriented frame, and libjpeg-turbo crops the stored frame. */
+        struct sail_roi oriented_roi;
+        SAIL_TRY_OR_CLEANUP(sail_clip_roi(&jpeg_state->load_options->roi, image_local->width, image_local->height, &oriented_roi),
+                            /* cleanup */ sail_destroy_image(image_local));
+        jpeg_private_oriented_roi_to_stored(&oriented_roi, image_local->width, image_local->height, jpeg_state->orientation, &jpeg_state->roi);
+
+        /* libjpeg-turbo aligns the horizontal offset to the iMCU boundary, so the cropped scan lines may start earlier. */
+        JDIMENSION x_offset = jpeg_state->roi.x;
+        JDIMENSION width    = jpeg_state->roi.width;
+        jpeg_crop_scanline(jpeg_state->decompress_context, &x_offset, &width);
+
+        jpeg_state->crop_offset = jpeg_state->roi.x - x_offset;
+
+        if (jpeg_state->crop_offset > 0 || width != jpeg_state->roi.width) {
+            void *ptr;
+            SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)width * jpeg_state->decompress_context->output_components, &ptr),
+                                /* cleanup */ sail_destroy_image(image_local));
+            jpeg_state->crop_scanline = ptr;
+        }
+
+        if (jpeg_state->roi.y > 0) {
+            (void)jpeg_skip_scanlines(jpeg_state->decompress_context, jpeg_state->roi.y);
+        }
+
+        image_local->width  = oriented_roi.width;
+        image_local->height = oriented_roi.height;
+    }
+#endif
+
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
     /* Read meta data. */
     if (jpeg_state->load_options->options & SAIL_OPTION_META_DATA) {
-        SAIL_TRY_OR_CLEANUP(jpeg_private_fetch_meta_data(jpeg_state->decompress_context, &image_local->meta_data_node),
+        SAIL_TRY_OR_CLEANUP(jpeg_private_fetch_meta_data(jpeg_state->decompress_context, jpeg_state->load_options, &image_local->meta_data_node),
                             /* cleanup */ sail_destroy_image(image_local));
     }
 
@@ -196,6 +575,12 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpeg(void *state, s
     SAIL_TRY_OR_CLEANUP(jpeg_private_fetch_resolution(jpeg_state->decompress_context, &image_local->resolution),
                             /* cleanup */ sail_destroy_image(image_local));
 
+    if (transposed && image_local->resolution != NULL) {
+        const double x = image_local->resolution->x;
+        image_local->resolution->x = image_local->resolution->y;
+        image_local->resolution->y = x;
+    }
+
     /* Fetch ICC profile. */
 #ifdef SAIL_HAVE_JPEG_ICCP
     if (jpeg_state->load_options->options & SAIL_OPTION_ICCP) {
@@ -209,6 +594,125 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpeg(void *state, s
     return SAIL_OK;
 }
 
+/* Stores the decoding diagnostics. See SAIL_OPTION_DIAGNOSTICS. */
+static sail_status_t store_diagnostics(const struct jpeg_state *jpeg_state, struct sail_image *image, bool gpu) {
+
+    const struct jpeg_decompress_struct *decompress_context = jpeg_state->decompress_context;
+    const char *dct_method;
+
+    switch (decompress_context->dct_method) {
+        case JDCT_IFAST: dct_method = "fast";  break;
+        case JDCT_FLOAT: dct_method = "float"; break;
+        default:         dct_method = "slow";  break;
+    }
+
+    SAIL_TRY(sail_put_load_diagnostic_unsigned_long(jpeg_state->load_options, image, "jpeg-scale-denom",
+                                                    decompress_context->scale_denom / decompress_context->scale_num));
+    SAIL_TRY(sail_put_load_diagnostic_string(jpeg_state->load_options, image, "jpeg-dct-method", dct_method));
+    SAIL_TRY(sail_put_load_diagnostic_bool(jpeg_state->load_options, image, "jpeg-progressive", decompress_context->progressive_mode));
+    SAIL_TRY(sail_put_load_diagnostic_bool(jpeg_state->load_options, image, "jpeg-nvjpeg", gpu));
+
+    return SAIL_OK;
+}
+
+/*
+ * Decoding functions.
+ */
+
+#ifdef SAIL_HAVE_NVJPEG
+/* Decodes the frame on the GPU when nvJPEG can produce the exact frame libjpeg would. */
+static sail_status_t decode_with_nvjpeg(struct jpeg_state *jpeg_state, struct sail_image *image) {
+
+    if (jpeg_state->mapped_data == NULL
+            || jpeg_state->nvjpeg_unavailable
+            || jpeg_state->buffered_image
+            || jpeg_state->load_options->row_callback != NULL
+            || sail_roi_is_set(&jpeg_state->load_options->roi)
+            || jpeg_state->orientation != SAIL_ORIENTATION_NORMAL
+            || jpeg_state->planar_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN
+            || jpeg_state->decompress_context->scale_denom > jpeg_state->decompress_context->scale_num) {
+        return SAIL_ERROR_NOT_IMPLEMENTED;
+    }
+
+    if (jpeg_state->nvjpeg == NULL) {
+        SAIL_TRY_OR_EXECUTE(jpeg_private_alloc_nvjpeg(&jpeg_state->nvjpeg),
+                            /* on error */ jpeg_state->nvjpeg_unavailable = true;
+                                           return SAIL_ERROR_NOT_IMPLEMENTED);
+    }
+
+    SAIL_TRY(jpeg_private_nvjpeg_decode(jpeg_state->nvjpeg, jpeg_state->mapped_data, jpeg_state->mapped_data_size, image));
+
+    return SAIL_OK;
+}
+#endif
+
+SAIL_EXPORT sail_status_t sail_codec_load_init_v8_jpeg(struct sail_io *io, const struct sail_load_options *load_options, void **state) {
+
+    *state = NULL;
+
+    /* Allocate a new state. */
+    struct jpeg_state *jpeg_state;
+    SAIL_TRY(alloc_jpeg_state(load_options, NULL, &jpeg_state));
+    *state = jpeg_state;
+
+    SAIL_TRY(create_decompress(jpeg_state));
+    SAIL_TRY(start_decompress(jpeg_state, io));
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_reset_v8_jpeg(void *state, struct sail_io *io) {
+
+    struct jpeg_state *jpeg_state = state;
+
+    if (setjmp(jpeg_state->error_context.setjmp_buffer) != 0) {
+        jpeg_state->libjpeg_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Return the decompress context into the initial state, keeping its memory and settings. */
+    jpeg_abort_decompress(jpeg_state->decompress_context);
+
+    sail_free(jpeg_state->crop_scanline);
+    sail_free(jpeg_state->oriented_scan_lines);
+    sail_free(jpeg_state->oriented_frame);
+    sail_free(jpeg_state->raw_data);
+
+    jpeg_state->libjpeg_error  = false;
+    jpeg_state->frame_loaded   = false;
+    jpeg_state->buffered_image = false;
+    jpeg_state->crop_offset    = 0;
+    jpeg_state->crop_scanline  = NULL;
+
+    jpeg_state->oriented_scan_lines = NULL;
+    jpeg_state->oriented_frame      = NULL;
+    jpeg_state->raw_data            = NULL;
+
+    SAIL_TRY(start_decompress(jpeg_state, io));
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpeg(void *state, struct sail_image **image) {
+
+    struct jpeg_state *jpeg_state = state;
+
+    if (jpeg_state->frame_loaded) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    jpeg_state->frame_loaded = true;
+
+    if (setjmp(jpeg_state->error_context.setjmp_buffer) != 0) {
+        jpeg_state->libjpeg_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    SAIL_TRY(build_image(jpeg_state, image));
+
+    return SAIL_OK;
+}
+
 SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_jpeg(void *state, struct sail_image *image) {
 
     struct jpeg_state *jpeg_state = state;
@@ -222,16 +726,209 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_jpeg(void *state, struct sail
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+#ifdef SAIL_HAVE_NVJPEG
+    /* Unsupported streams and GPU failures fall back to libjpeg. */
+    if (decode_with_nvjpeg(jpeg_state, image) == SAIL_OK) {
+        SAIL_TRY(store_diagnostics(jpeg_state, image, /* gpu */ true));
+        return SAIL_OK;
+    }
+#endif
+
+    SAIL_TRY(store_diagnostics(jpeg_state, image, /* gpu */ false));
+
+    /* Output every pass into the image pixels, and let the caller render or stop at coarse passes. */
+    if (jpeg_state->buffered_image) {
+        struct jpeg_decompress_struct *decompress_context = jpeg_state->decompress_context;
+
+        for (unsigned pass = 1;; pass++) {
+            jpeg_start_output(decompress_context, decompress_context->input_scan_number);
+            SAIL_TRY(read_scan_lines(decompress_context, image));
+            jpeg_finish_output(decompress_context);
+
+            /* The last pass must show the last scan. */
+            if (jpeg_input_complete(decompress_context) && decompress_context->output_scan_number >= decompress_context->input_scan_number) {
+                break;
+            }
+
+            bool stop = false;
+            SAIL_TRY(jpeg_state->load_options->pass_callback(image, pass, &stop, jpeg_state->load_options->pass_callback_user_data));
+
+            if (stop) {
+                SAIL_LOG_TRACE("JPEG: Stopped at pass #%u", pass);
+                break;
+            }
+        }
+
+        return SAIL_OK;
+    }
+
+    if (jpeg_state->planar_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
+        return read_raw_data(jpeg_state, image);
+    }
+
+    if (jpeg_state->orientation != SAIL_ORIENTATION_NORMAL) {
+        return read_oriented_scan_lines(jpeg_state, image);
+    }
+
+    /* Decode whole iMCU rows right into the image pixels when rows are not redirected. */
+    if (jpeg_state->crop_scanline == NULL && jpeg_state->load_options->row_callback == NULL) {
+        return read_scan_lines(jpeg_state->decompress_context, image);
+    }
+
     for (unsigned row = 0; row < image->height; row++) {
-        unsigned char *scanline = sail_scan_line(image, row);
+        unsigned char *scanline = sail_scan_line_to_load(jpeg_state->load_options, image, row);
+
+        if (jpeg_state->crop_scanline != NULL) {
+            JSAMPROW samprow = (JSAMPROW)jpeg_state->crop_scanline;
+            (void)jpeg_read_scanlines(jpeg_state->decompress_context, &samprow, 1);
+
+            const unsigned components = jpeg_state->decompress_context->output_components;
+            memcpy(scanline, jpeg_state->crop_scanline + (size_t)jpeg_state->crop_offset * components, (size_t)image->width * components);
+        } else {
+            JSAMPROW samprow = (JSAMPROW)scanline;
+            (void)jpeg_read_scanlines(jpeg_state->decompress_context, &samprow, 1);
+        }
+
+        SAIL_TRY(sail_scan_line_loaded(jpeg_state->load_options, image, row));
+    }
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_push_init_v8_jpeg(const struct sail_load_options *load_options, void **state) {
+
+    *state = NULL;
+
+    struct jpeg_state *jpeg_state;
+    SAIL_TRY(alloc_jpeg_state(load_options, NULL, &jpeg_state));
+    *state = jpeg_state;
+
+    /* These need the whole frame, or several output passes. */
+    if ((jpeg_state->load_options->options & SAIL_OPTION_AUTO_ORIENT)
+            || sail_roi_is_set(&jpeg_state->load_options->roi)
+            || jpeg_state->load_options->pass_callback != NULL
+            || sail_load_planar_output(jpeg_state->load_options)) {
+        return SAIL_ERROR_NOT_IMPLEMENTED;
+    }
+
+    SAIL_TRY(create_decompress(jpeg_state));
+
+    if (setjmp(jpeg_state->error_context.setjmp_buffer) != 0) {
+        jpeg_state->libjpeg_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    jpeg_private_push_src(jpeg_state->decompress_context);
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_push_seek_next_frame_v8_jpeg(void *state, const void *data, size_t size, bool end,
+                                                                       size_t *consumed, struct sail_image **image) {
+
+    struct jpeg_state *jpeg_state = state;
+
+    *consumed = 0;
+
+    if (jpeg_state->frame_loaded) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
 
-        JSAMPROW samprow = (JSAMPROW)scanline;
-        (void)jpeg_read_scanlines(jpeg_state->decompress_context, &samprow, 1);
+    if (jpeg_state->libjpeg_error) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    if (setjmp(jpeg_state->error_context.setjmp_buffer) != 0) {
+        jpeg_state->libjpeg_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    struct jpeg_decompress_struct *decompress_context = jpeg_state->decompress_context;
+
+    jpeg_private_push_src_offer(decompress_context, data, size, end);
+
+    if (!jpeg_state->push_header_read) {
+        if (jpeg_read_header(decompress_context, true) == JPEG_SUSPENDED) {
+            *consumed = jpeg_private_push_src_consumed(decompress_context);
+            return SAIL_ERROR_NEED_MORE_DATA;
+        }
+
+        set_up_decompress(jpeg_state);
+        jpeg_state->push_header_read = true;
+    }
+
+    /* Progressive frames are buffered by libjpeg until all their scans are read. */
+    if (!jpeg_start_decompress(decompress_context)) {
+        *consumed = jpeg_private_push_src_consumed(decompress_context);
+        return SAIL_ERROR_NEED_MORE_DATA;
+    }
+
+    *consumed = jpeg_private_push_src_consumed(decompress_context);
+
+    jpeg_state->frame_loaded = true;
+
+    SAIL_TRY(build_image(jpeg_state, image));
+
     return SAIL_OK;
 }
 
+SAIL_EXPORT sail_status_t sail_codec_load_push_frame_v8_jpeg(void *state, const void *data, size_t size, bool end,
+                                                             size_t *consumed, struct sail_image *image,
+                                                             unsigned *first_row, unsigned *rows_count) {
+
+    struct jpeg_state *jpeg_state = state;
+
+    *consumed   = 0;
+    *first_row  = 0;
+    *rows_count = 0;
+
+    if (jpeg_state->libjpeg_error) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if (setjmp(jpeg_state->error_context.setjmp_buffer) != 0) {
+        jpeg_state->libjpeg_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    struct jpeg_decompress_struct *decompress_context = jpeg_state->decompress_context;
+
+    jpeg_private_push_src_offer(decompress_context, data, size, end);
+
+    const unsigned start_row      = decompress_context->output_scanline;
+    const unsigned lines_per_call = SAIL_MIN(jpeg_private_scan_lines_per_call(decompress_context), MAX_SCAN_LINES_PER_CALL);
+    JSAMPROW samprows[MAX_SCAN_LINES_PER_CALL];
+
+    /* Decode until libjpeg suspends. */
+    while (decompress_context->output_scanline < image->height) {
+        const unsigned row   = decompress_context->output_scanline;
+        const unsigned lines = SAIL_MIN(lines_per_call, image->height - row);
+
+        for (unsigned i = 0; i < lines; i++) {
+            samprows[i] = (JSAMPROW)sail_scan_line(image, row + i);
+        }
+
+        if (jpeg_read_scanlines(decompress_context, samprows, lines) == 0) {
+            break;
+        }
+    }
+
+    *consumed   = jpeg_private_push_src_consumed(decompress_context);
+    *first_row  = start_row;
+    *rows_count = decompress_context->output_scanline - start_row;
+
+    if (decompress_context->output_scanline == image->height) {
+        return SAIL_OK;
+    }
+
+    if (end) {
+        SAIL_LOG_ERROR("JPEG: Failed to read scan lines");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_ERROR_NEED_MORE_DATA;
+}
+
 SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_jpeg(void **state) {
 
     struct jpeg_state *jpeg_state = *state;
@@ -265,6 +962,8 @@ SAIL_EXPORT sail_status_t sail_codec_save_init_v8_jpeg(struct sail_io *io, const
     SAIL_TRY(alloc_jpeg_state(NULL, save_options, &jpeg_state));
     *state = jpeg_state;
 
+    jpeg_state->io = io;
+
     /* Create compress context. */
     void *ptr;
     SAIL_TRY(sail_malloc(sizeof(struct jpeg_compress_struct), &ptr));
@@ -325,7 +1024,7 @@ SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_jpeg(void *state, c
     jpeg_state->compress_context->input_gamma      = image->gamma;
 
     jpeg_set_defaults(jpeg_state->compress_context);
-    jpeg_set_colorspace(jpeg_state->compress_context, color_space);
+    jpeg_set_colorspace(jpeg_state->compress_context, jpeg_private_jpeg_color_space(color_space));
 
     /* Save resolution. */
     SAIL_TRY(jpeg_private_write_resolution(jpeg_state->compress_context, image->resolution));
@@ -342,23 +1041,23 @@ SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_jpeg(void *state, c
         sail_traverse_hash_map_with_user_data(jpeg_state->save_options->tuning, jpeg_private_tuning_key_value_callback, jpeg_state->compress_context);
     }
 
+    /* Trial encodes are started in save_frame(). */
+    if (jpeg_private_target_requested(jpeg_state->save_options)) {
+        if (!jpeg_private_target_supported(jpeg_state->compress_context, image->pixel_format)) {
+            SAIL_LOG_ERROR("JPEG: Target size and quality are not supported for %s pixel format", sail_pixel_format_to_string(image->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+
+        SAIL_TRY(jpeg_private_alloc_target(&jpeg_state->target));
+
+        return SAIL_OK;
+    }
+
     /* Start compression. */
     jpeg_start_compress(jpeg_state->compress_context, true);
     jpeg_state->started_compress = true;
 
-    /* Save meta data. */
-    if (jpeg_state->save_options->options & SAIL_OPTION_META_DATA && image->meta_data_node != NULL) {
-        SAIL_TRY(jpeg_private_write_meta_data(jpeg_state->compress_context, image->meta_data_node));
-        SAIL_LOG_TRACE("JPEG: Meta data has been written");
-    }
-
-    /* Save ICC profile. */
-#ifdef SAIL_HAVE_JPEG_ICCP
-    if (jpeg_state->save_options->options & SAIL_OPTION_ICCP && image->iccp != NULL) {
-        jpeg_write_icc_profile(jpeg_state->compress_context, image->iccp->data, (unsigned)image->iccp->size);
-        SAIL_LOG_TRACE("JPEG: ICC profile has been written");
-    }
-#endif
+    SAIL_TRY(jpeg_private_write_markers(jpeg_state->compress_context, jpeg_state->save_options, image));
 
     return SAIL_OK;
 }
@@ -376,8 +1075,45 @@ SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_jpeg(void *state, const struc
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    if (jpeg_state->target != NULL) {
+        SAIL_TRY(jpeg_private_save_with_target(jpeg_state->target,
+                                               jpeg_state->compress_context,
+                                               &jpeg_state->error_context,
+                                               jpeg_state->save_options,
+                                               image,
+                                               jpeg_state->io));
+        return SAIL_OK;
+    }
+
+    /* Pass batches of rows to save on per-call overhead when rows are not redirected. */
+    if (jpeg_state->save_options->row_callback == NULL) {
+        JSAMPROW samprows[MAX_SCAN_LINES_PER_CALL];
+
+        for (unsigned row = 0; row < image->height;) {
+            const unsigned lines = SAIL_MIN(MAX_SCAN_LINES_PER_CALL, image->height - row);
+
+            for (unsigned i = 0; i < lines; i++) {
+                samprows[i] = (JSAMPROW)sail_scan_line(image, row + i);
+            }
+
+            const JDIMENSION lines_written = jpeg_write_scanlines(jpeg_state->compress_context, samprows, lines);
+
+            if (lines_written == 0) {
+                SAIL_LOG_ERROR("JPEG: Failed to write scan lines");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+
+            row += lines_written;
+        }
+
+        return SAIL_OK;
+    }
+
     for (unsigned row = 0; row < image->height; row++) {
-        JSAMPROW samprow = (JSAMPROW)sail_scan_line(image, row);
+        const void *scan_line;
+        SAIL_TRY(sail_scan_line_to_save(jpeg_state->save_options, image, row, &scan_line));
+
+        JSAMPROW samprow = (JSAMPROW)scan_line;
         jpeg_write_scanlines(jpeg_state->compress_context, &samprow, 1);
     }
 
@@ -392,6 +1128,8 @@ SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_jpeg(void **state) {
     *state = NULL;
 
     if (setjmp(jpeg_state->error_context.setjmp_buffer) != 0) {
+        /* Finishing a cancelled frame fails, but the compressor must still be released. */
+        jpeg_destroy_compress(jpeg_state->compress_context);
         destroy_jpeg_state(jpeg_state);
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
@@ -0,0 +1,175 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stddef.h>
+
+#include <cuda_runtime_api.h>
+#include <nvjpeg.h>
+
+#include <sail-common/sail-common.h>
+
+#include "nvjpeg_decoder.h"
+
+struct jpeg_private_nvjpeg {
+
+    nvjpegHandle_t handle;
+    nvjpegJpegState_t jpeg_state;
+
+    /* Decoded pixels on the device. Grows to the largest image. */
+    void *device_buffer;
+    size_t device_buffer_size;
+};
+
+/*
+ * Public functions.
+ */
+
+sail_status_t jpeg_private_alloc_nvjpeg(struct jpeg_private_nvjpeg **nvjpeg) {
+
+    int devices = 0;
+
+    if (cudaGetDeviceCount(&devices) != cudaSuccess || devices == 0) {
+        SAIL_LOG_DEBUG("JPEG: No CUDA devices found, nvJPEG is disabled");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct jpeg_private_nvjpeg), &ptr));
+    struct jpeg_private_nvjpeg *nvjpeg_local = ptr;
+
+    *nvjpeg_local = (struct jpeg_private_nvjpeg) {
+        .handle             = NULL,
+        .jpeg_state         = NULL,
+        .device_buffer      = NULL,
+        .device_buffer_size = 0,
+    };
+
+    if (nvjpegCreateSimple(&nvjpeg_local->handle) != NVJPEG_STATUS_SUCCESS) {
+        SAIL_LOG_ERROR("JPEG: Failed to create nvJPEG handle");
+        jpeg_private_destroy_nvjpeg(nvjpeg_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if (nvjpegJpegStateCreate(nvjpeg_local->handle, &nvjpeg_local->jpeg_state) != NVJPEG_STATUS_SUCCESS) {
+        SAIL_LOG_ERROR("JPEG: Failed to create nvJPEG state");
+        jpeg_private_destroy_nvjpeg(nvjpeg_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    *nvjpeg = nvjpeg_local;
+
+    return SAIL_OK;
+}
+
+void jpeg_private_destroy_nvjpeg(struct jpeg_private_nvjpeg *nvjpeg) {
+
+    if (nvjpeg == NULL) {
+        return;
+    }
+
+    if (nvjpeg->device_buffer != NULL) {
+        cudaFree(nvjpeg->device_buffer);
+    }
+    if (nvjpeg->jpeg_state != NULL) {
+        nvjpegJpegStateDestroy(nvjpeg->jpeg_state);
+    }
+    if (nvjpeg->handle != NULL) {
+        nvjpegDestroy(nvjpeg->handle);
+    }
+
+    sail_free(nvjpeg);
+}
+
+sail_status_t jpeg_private_nvjpeg_decode(struct jpeg_private_nvjpeg *nvjpeg,
+                                         const void *data, size_t data_size,
+                                         struct sail_image *image) {
+
+    SAIL_CHECK_PTR(nvjpeg);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(image);
+
+    nvjpegOutputFormat_t output_format;
+    unsigned components;
+
+    switch (image->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: output_format = NVJPEG_OUTPUT_Y;    components = 1; break;
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:      output_format = NVJPEG_OUTPUT_RGBI; components = 3; break;
+
+        default: {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+        }
+    }
+
+    int stream_components;
+    nvjpegChromaSubsampling_t subsampling;
+    int widths[NVJPEG_MAX_COMPONENT];
+    int heights[NVJPEG_MAX_COMPONENT];
+
+    if (nvjpegGetImageInfo(nvjpeg->handle, data, data_size, &stream_components, &subsampling, widths, heights) != NVJPEG_STATUS_SUCCESS
+            || subsampling == NVJPEG_CSS_UNKNOWN
+            || (unsigned)widths[0] != image->width || (unsigned)heights[0] != image->height) {
+        SAIL_LOG_DEBUG("JPEG: nvJPEG doesn't support the image");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    }
+
+    const size_t pitch = (size_t)image->width * components;
+    const size_t device_buffer_size = pitch * image->height;
+
+    if (device_buffer_size > nvjpeg->device_buffer_size) {
+        if (nvjpeg->device_buffer != NULL) {
+            cudaFree(nvjpeg->device_buffer);
+            nvjpeg->device_buffer      = NULL;
+            nvjpeg->device_buffer_size = 0;
+        }
+
+        if (cudaMalloc(&nvjpeg->device_buffer, device_buffer_size) != cudaSuccess) {
+            nvjpeg->device_buffer = NULL;
+            SAIL_LOG_ERROR("JPEG: Failed to allocate %zu bytes of device memory", device_buffer_size);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+        }
+
+        nvjpeg->device_buffer_size = device_buffer_size;
+    }
+
+    nvjpegImage_t output = { 0 };
+    output.channel[0] = nvjpeg->device_buffer;
+    output.pitch[0]   = pitch;
+
+    if (nvjpegDecode(nvjpeg->handle, nvjpeg->jpeg_state, data, data_size, output_format, &output, NULL) != NVJPEG_STATUS_SUCCESS) {
+        SAIL_LOG_DEBUG("JPEG: nvJPEG failed to decode the image");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    }
+
+    /* Synchronous, so it also waits for the decoder. */
+    if (cudaMemcpy2D(image->pixels, image->bytes_per_line,
+                     nvjpeg->device_buffer, pitch,
+                     pitch, image->height,
+                     cudaMemcpyDeviceToHost) != cudaSuccess) {
+        SAIL_LOG_ERROR("JPEG: Failed to copy decoded pixels from the device");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
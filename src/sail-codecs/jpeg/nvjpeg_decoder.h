@@ -0,0 +1,59 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_JPEG_NVJPEG_DECODER_H
+#define SAIL_JPEG_NVJPEG_DECODER_H
+
+#include <stddef.h> /* size_t */
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_image;
+
+/* nvJPEG handle, decoder state, and device buffer reused between images. */
+struct jpeg_private_nvjpeg;
+
+/*
+ * Creates a new nvJPEG decoder on the current CUDA device.
+ *
+ * Returns SAIL_ERROR_UNDERLYING_CODEC if there are no CUDA devices or nvJPEG fails to initialize.
+ */
+SAIL_HIDDEN sail_status_t jpeg_private_alloc_nvjpeg(struct jpeg_private_nvjpeg **nvjpeg);
+
+SAIL_HIDDEN void jpeg_private_destroy_nvjpeg(struct jpeg_private_nvjpeg *nvjpeg);
+
+/*
+ * Decodes the whole JPEG stream on the GPU into the image pixels. The image must have
+ * the stream dimensions and the BPP24-RGB or BPP8-GRAYSCALE pixel format.
+ *
+ * Returns SAIL_ERROR_NOT_IMPLEMENTED if nvJPEG doesn't support the stream or the pixel format,
+ * so the caller can decode it with libjpeg instead.
+ */
+SAIL_HIDDEN sail_status_t jpeg_private_nvjpeg_decode(struct jpeg_private_nvjpeg *nvjpeg,
+                                                     const void *data, size_t data_size,
+                                                     struct sail_image *image);
+
+#endif
@@ -0,0 +1,697 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <jerror.h>
+
+#include <sail-common/sail-common.h>
+
+#include "helpers.h"
+#include "target.h"
+
+/* Quality range of the search. */
+#define QUALITY_MIN 1
+#define QUALITY_MAX 100
+
+/* The search stops when the trial is within 5% below the target size, or within 0.5 dB above the target quality. */
+#define SIZE_TOLERANCE 0.05
+#define PSNR_TOLERANCE 0.5
+
+/* PSNR reported for lossless trials. */
+#define PSNR_MAX 99.0
+
+/* Initial capacity of the trial buffers. They grow twice when full. */
+#define INITIAL_BUFFER_SIZE (64 * 1024)
+
+#define TARGET_COMPONENTS_MAX 3
+
+enum sample_source {
+    SAMPLE_SOURCE_GRAYSCALE,
+    SAMPLE_SOURCE_RGB,
+    SAMPLE_SOURCE_YCBCR,
+};
+
+/* Byte layout of the pixels to save. */
+struct pixel_layout {
+    enum sample_source source;
+    unsigned bytes_per_pixel;
+    unsigned offsets[3];
+};
+
+/* Samples of one component downsampled and padded to whole MCUs. */
+struct target_plane {
+    JSAMPLE *samples;
+    JDIMENSION width;
+    JDIMENSION height;
+
+    /* Size of the samples covering the image without the padding. */
+    JDIMENSION real_width;
+    JDIMENSION real_height;
+
+    int v_samp_factor;
+};
+
+struct memory_buffer {
+    JOCTET *data;
+    size_t size;
+    size_t capacity;
+};
+
+struct memory_destination {
+    struct jpeg_destination_mgr pub;
+
+    struct memory_buffer *buffer;
+};
+
+struct jpeg_private_target {
+    int components;
+    int max_v_samp_factor;
+    JDIMENSION imcu_rows;
+    struct target_plane planes[TARGET_COMPONENTS_MAX];
+
+    /* The best trial found so far, and the current trial. */
+    struct memory_buffer best;
+    struct memory_buffer trial;
+    struct memory_destination destination;
+
+    /* Decoder of the trials to measure their PSNR, and its scratch rows of one iMCU row. */
+    struct jpeg_decompress_struct *decompress_context;
+    struct jpeg_source_mgr source;
+    JSAMPLE *decoded;
+};
+
+/*
+ * Private functions.
+ */
+
+static bool pixel_layout(enum SailPixelFormat pixel_format, struct pixel_layout *layout) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: *layout = (struct pixel_layout) { SAMPLE_SOURCE_GRAYSCALE, 1, { 0, 0, 0 } }; return true;
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:      *layout = (struct pixel_layout) { SAMPLE_SOURCE_RGB,       3, { 0, 1, 2 } }; return true;
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:      *layout = (struct pixel_layout) { SAMPLE_SOURCE_RGB,       3, { 2, 1, 0 } }; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX:     *layout = (struct pixel_layout) { SAMPLE_SOURCE_RGB,       4, { 0, 1, 2 } }; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX:     *layout = (struct pixel_layout) { SAMPLE_SOURCE_RGB,       4, { 2, 1, 0 } }; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR:
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR:     *layout = (struct pixel_layout) { SAMPLE_SOURCE_RGB,       4, { 3, 2, 1 } }; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB:     *layout = (struct pixel_layout) { SAMPLE_SOURCE_RGB,       4, { 1, 2, 3 } }; return true;
+        case SAIL_PIXEL_FORMAT_BPP24_YCBCR:    *layout = (struct pixel_layout) { SAMPLE_SOURCE_YCBCR,     3, { 0, 1, 2 } }; return true;
+
+        default: {
+            return false;
+        }
+    }
+}
+
+static bool source_converts_to(enum sample_source source, J_COLOR_SPACE jpeg_color_space) {
+
+    switch (jpeg_color_space) {
+        case JCS_GRAYSCALE: return true;
+        case JCS_YCbCr:     return source != SAMPLE_SOURCE_GRAYSCALE;
+        case JCS_RGB:       return source == SAMPLE_SOURCE_RGB;
+        default:            return false;
+    }
+}
+
+/* JFIF conversion with the same fixed-point coefficients as libjpeg. */
+static inline JSAMPLE rgb_to_y(int r, int g, int b) {
+
+    return (JSAMPLE)((19595 * r + 38470 * g + 7471 * b + 32768) >> 16);
+}
+
+static inline JSAMPLE rgb_to_cb(int r, int g, int b) {
+
+    return (JSAMPLE)((-11059 * r - 21709 * g + 32768 * b + (128 << 16) + 32767) >> 16);
+}
+
+static inline JSAMPLE rgb_to_cr(int r, int g, int b) {
+
+    return (JSAMPLE)((32768 * r - 27439 * g - 5329 * b + (128 << 16) + 32767) >> 16);
+}
+
+/* Converts a row of pixels into full resolution samples of the JPEG color space. */
+static void convert_row(const struct pixel_layout *layout, J_COLOR_SPACE jpeg_color_space,
+                        const unsigned char *pixels, unsigned width, JSAMPLE *samples[TARGET_COMPONENTS_MAX]) {
+
+    for (unsigned x = 0; x < width; x++, pixels += layout->bytes_per_pixel) {
+        const int c0 = pixels[layout->offsets[0]];
+        const int c1 = pixels[layout->offsets[1]];
+        const int c2 = pixels[layout->offsets[2]];
+
+        if (jpeg_color_space == JCS_GRAYSCALE) {
+            samples[0][x] = (layout->source == SAMPLE_SOURCE_RGB) ? rgb_to_y(c0, c1, c2) : (JSAMPLE)c0;
+        } else if (jpeg_color_space == JCS_YCbCr && layout->source == SAMPLE_SOURCE_RGB) {
+            samples[0][x] = rgb_to_y(c0, c1, c2);
+            samples[1][x] = rgb_to_cb(c0, c1, c2);
+            samples[2][x] = rgb_to_cr(c0, c1, c2);
+        } else {
+            samples[0][x] = (JSAMPLE)c0;
+            samples[1][x] = (JSAMPLE)c1;
+            samples[2][x] = (JSAMPLE)c2;
+        }
+    }
+}
+
+/* Box-filters the full resolution samples in place. Every output sample is written behind the samples still to read. */
+static void downsample_plane(JSAMPLE *samples, JDIMENSION full_width, JDIMENSION width, JDIMENSION height,
+                             unsigned factor_h, unsigned factor_v) {
+
+    const unsigned count = factor_h * factor_v;
+
+    for (JDIMENSION y = 0; y < height; y++) {
+        for (JDIMENSION x = 0; x < width; x++) {
+            unsigned sum = 0;
+
+            for (unsigned j = 0; j < factor_v; j++) {
+                const JSAMPLE *row = samples + (size_t)(y * factor_v + j) * full_width + x * factor_h;
+
+                for (unsigned i = 0; i < factor_h; i++) {
+                    sum += row[i];
+                }
+            }
+
+            samples[(size_t)y * width + x] = (JSAMPLE)((sum + count / 2) / count);
+        }
+    }
+}
+
+static void free_planes(struct jpeg_private_target *target) {
+
+    for (int c = 0; c < TARGET_COMPONENTS_MAX; c++) {
+        sail_free(target->planes[c].samples);
+        target->planes[c].samples = NULL;
+    }
+}
+
+/* Converts and downsamples the frame once. Every trial encodes the same samples. */
+static sail_status_t load_samples(struct jpeg_private_target *target, const struct jpeg_compress_struct *compress_context,
+                                  const struct sail_save_options *save_options, const struct sail_image *image) {
+
+    struct pixel_layout layout;
+    pixel_layout(image->pixel_format, &layout);
+
+    free_planes(target);
+    sail_free(target->decoded);
+    target->decoded = NULL;
+
+    target->components = compress_context->num_components;
+
+    int max_h_samp_factor = 1;
+    target->max_v_samp_factor = 1;
+
+    for (int c = 0; c < target->components; c++) {
+        max_h_samp_factor         = SAIL_MAX(max_h_samp_factor, compress_context->comp_info[c].h_samp_factor);
+        target->max_v_samp_factor = SAIL_MAX(target->max_v_samp_factor, compress_context->comp_info[c].v_samp_factor);
+    }
+
+    const JDIMENSION mcu_width  = (JDIMENSION)max_h_samp_factor * DCTSIZE;
+    const JDIMENSION mcu_height = (JDIMENSION)target->max_v_samp_factor * DCTSIZE;
+
+    target->imcu_rows = (image->height + mcu_height - 1) / mcu_height;
+
+    const JDIMENSION full_width  = (image->width + mcu_width - 1) / mcu_width * mcu_width;
+    const JDIMENSION full_height = target->imcu_rows * mcu_height;
+
+    JSAMPLE *rows[TARGET_COMPONENTS_MAX];
+
+    for (int c = 0; c < target->components; c++) {
+        void *ptr;
+        SAIL_TRY(sail_malloc((size_t)full_width * full_height, &ptr));
+        target->planes[c].samples = ptr;
+    }
+
+    /* Full resolution samples with the right and bottom edges replicated into the padding. */
+    for (unsigned row = 0; row < full_height; row++) {
+        for (int c = 0; c < target->components; c++) {
+            rows[c] = target->planes[c].samples + (size_t)row * full_width;
+        }
+
+        if (row >= image->height) {
+            for (int c = 0; c < target->components; c++) {
+                memcpy(rows[c], rows[c] - full_width, full_width);
+            }
+
+            continue;
+        }
+
+        const void *scan_line;
+        SAIL_TRY(sail_scan_line_to_save(save_options, image, row, &scan_line));
+
+        convert_row(&layout, compress_context->jpeg_color_space, scan_line, image->width, rows);
+
+        for (int c = 0; c < target->components; c++) {
+            memset(rows[c] + image->width, rows[c][image->width - 1], full_width - image->width);
+        }
+    }
+
+    for (int c = 0; c < target->components; c++) {
+        const jpeg_component_info *component = &compress_context->comp_info[c];
+        struct target_plane *plane = &target->planes[c];
+
+        const unsigned factor_h = (unsigned)(max_h_samp_factor / component->h_samp_factor);
+        const unsigned factor_v = (unsigned)(target->max_v_samp_factor / component->v_samp_factor);
+
+        plane->width         = full_width / factor_h;
+        plane->height        = full_height / factor_v;
+        plane->real_width    = (image->width + factor_h - 1) / factor_h;
+        plane->real_height   = (image->height + factor_v - 1) / factor_v;
+        plane->v_samp_factor = component->v_samp_factor;
+
+        if (factor_h > 1 || factor_v > 1) {
+            downsample_plane(plane->samples, full_width, plane->width, plane->height, factor_h, factor_v);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static void grow_buffer(j_common_ptr cinfo, struct memory_buffer *buffer) {
+
+    const size_t capacity = (buffer->capacity == 0) ? INITIAL_BUFFER_SIZE : buffer->capacity * 2;
+
+    void *ptr = buffer->data;
+    if (sail_realloc(capacity, &ptr) != SAIL_OK) {
+        ERREXIT1(cinfo, JERR_OUT_OF_MEMORY, 0);
+    }
+
+    buffer->data     = ptr;
+    buffer->capacity = capacity;
+}
+
+static void init_memory_destination(j_compress_ptr cinfo) {
+
+    struct memory_destination *dest = (struct memory_destination *)cinfo->dest;
+
+    if (dest->buffer->capacity == 0) {
+        grow_buffer((j_common_ptr)cinfo, dest->buffer);
+    }
+
+    dest->buffer->size = 0;
+
+    dest->pub.next_output_byte = dest->buffer->data;
+    dest->pub.free_in_buffer   = dest->buffer->capacity;
+}
+
+static boolean empty_memory_output_buffer(j_compress_ptr cinfo) {
+
+    struct memory_destination *dest = (struct memory_destination *)cinfo->dest;
+
+    /* libjpeg calls this only when the buffer is full. */
+    const size_t used = dest->buffer->capacity;
+    grow_buffer((j_common_ptr)cinfo, dest->buffer);
+
+    dest->pub.next_output_byte = dest->buffer->data + used;
+    dest->pub.free_in_buffer   = dest->buffer->capacity - used;
+
+    return TRUE;
+}
+
+static void term_memory_destination(j_compress_ptr cinfo) {
+
+    struct memory_destination *dest = (struct memory_destination *)cinfo->dest;
+
+    dest->buffer->size = dest->buffer->capacity - dest->pub.free_in_buffer;
+}
+
+static void init_memory_source(j_decompress_ptr cinfo) {
+
+    (void)cinfo;
+}
+
+/* The trials are complete streams, so reaching their end is an error. Insert a fake EOI marker like libjpeg does. */
+static boolean fill_memory_input_buffer(j_decompress_ptr cinfo) {
+
+    static const JOCTET EOI_MARKER[2] = { 0xFF, JPEG_EOI };
+
+    cinfo->src->next_input_byte = EOI_MARKER;
+    cinfo->src->bytes_in_buffer = sizeof(EOI_MARKER);
+
+    return TRUE;
+}
+
+static void skip_memory_input_data(j_decompress_ptr cinfo, long num_bytes) {
+
+    if (num_bytes <= 0) {
+        return;
+    }
+
+    if ((size_t)num_bytes > cinfo->src->bytes_in_buffer) {
+        fill_memory_input_buffer(cinfo);
+    } else {
+        cinfo->src->next_input_byte += num_bytes;
+        cinfo->src->bytes_in_buffer -= (size_t)num_bytes;
+    }
+}
+
+static void term_memory_source(j_decompress_ptr cinfo) {
+
+    (void)cinfo;
+}
+
+/* Encodes the cached samples with the quality into the trial buffer. */
+static sail_status_t encode_trial(struct jpeg_private_target *target, struct jpeg_compress_struct *compress_context,
+                                  const struct sail_save_options *save_options, const struct sail_image *image, int quality) {
+
+    JSAMPROW rows[TARGET_COMPONENTS_MAX][MAX_SAMP_FACTOR * DCTSIZE];
+    JSAMPARRAY planes[TARGET_COMPONENTS_MAX];
+
+    for (int c = 0; c < target->components; c++) {
+        planes[c] = rows[c];
+    }
+
+    compress_context->dest = &target->destination.pub;
+    compress_context->raw_data_in = TRUE;
+
+    jpeg_set_quality(compress_context, quality, TRUE);
+    jpeg_start_compress(compress_context, TRUE);
+
+    /* Markers count in the size of the trial. */
+    SAIL_TRY(jpeg_private_write_markers(compress_context, save_options, image));
+
+    for (JDIMENSION imcu_row = 0; imcu_row < target->imcu_rows; imcu_row++) {
+        for (int c = 0; c < target->components; c++) {
+            const struct target_plane *plane = &target->planes[c];
+            const JDIMENSION plane_rows = (JDIMENSION)plane->v_samp_factor * DCTSIZE;
+
+            for (JDIMENSION i = 0; i < plane_rows; i++) {
+                rows[c][i] = plane->samples + (size_t)(imcu_row * plane_rows + i) * plane->width;
+            }
+        }
+
+        jpeg_write_raw_data(compress_context, planes, (JDIMENSION)target->max_v_samp_factor * DCTSIZE);
+    }
+
+    jpeg_finish_compress(compress_context);
+
+    SAIL_LOG_TRACE("JPEG: Trial with quality %d has %zu bytes", quality, target->trial.size);
+
+    return SAIL_OK;
+}
+
+/* Decodes the trial buffer and compares its samples with the cached samples. */
+static sail_status_t measure_trial_psnr(struct jpeg_private_target *target, struct jpeg_private_my_error_context *error_context, double *psnr) {
+
+    if (target->decompress_context == NULL) {
+        void *ptr;
+        SAIL_TRY(sail_malloc(sizeof(struct jpeg_decompress_struct), &ptr));
+        target->decompress_context = ptr;
+
+        target->decompress_context->err = &error_context->jpeg_error_mgr;
+        jpeg_create_decompress(target->decompress_context);
+        target->decompress_context->src = &target->source;
+    }
+
+    JSAMPROW rows[TARGET_COMPONENTS_MAX][MAX_SAMP_FACTOR * DCTSIZE];
+    JSAMPARRAY planes[TARGET_COMPONENTS_MAX];
+
+    if (target->decoded == NULL) {
+        size_t decoded_size = 0;
+
+        for (int c = 0; c < target->components; c++) {
+            decoded_size += (size_t)target->planes[c].width * target->planes[c].v_samp_factor * DCTSIZE;
+        }
+
+        void *ptr;
+        SAIL_TRY(sail_malloc(decoded_size, &ptr));
+        target->decoded = ptr;
+    }
+
+    JSAMPLE *decoded = target->decoded;
+
+    for (int c = 0; c < target->components; c++) {
+        const struct target_plane *plane = &target->planes[c];
+        const JDIMENSION plane_rows = (JDIMENSION)plane->v_samp_factor * DCTSIZE;
+
+        for (JDIMENSION i = 0; i < plane_rows; i++, decoded += plane->width) {
+            rows[c][i] = decoded;
+        }
+
+        planes[c] = rows[c];
+    }
+
+    target->source.next_input_byte = target->trial.data;
+    target->source.bytes_in_buffer = target->trial.size;
+
+    struct jpeg_decompress_struct *decompress_context = target->decompress_context;
+
+    jpeg_read_header(decompress_context, TRUE);
+    decompress_context->raw_data_out = TRUE;
+    jpeg_start_decompress(decompress_context);
+
+    double squared_error = 0;
+    size_t samples = 0;
+
+    for (JDIMENSION imcu_row = 0; imcu_row < target->imcu_rows; imcu_row++) {
+        jpeg_read_raw_data(decompress_context, planes, (JDIMENSION)target->max_v_samp_factor * DCTSIZE);
+
+        for (int c = 0; c < target->components; c++) {
+            const struct target_plane *plane = &target->planes[c];
+            const JDIMENSION plane_rows = (JDIMENSION)plane->v_samp_factor * DCTSIZE;
+
+            for (JDIMENSION i = 0; i < plane_rows; i++) {
+                const JDIMENSION y = imcu_row * plane_rows + i;
+
+                if (y >= plane->real_height) {
+                    break;
+                }
+
+                const JSAMPLE *original = plane->samples + (size_t)y * plane->width;
+                uint64_t row_error = 0;
+
+                for (JDIMENSION x = 0; x < plane->real_width; x++) {
+                    const int difference = (int)original[x] - (int)rows[c][i][x];
+                    row_error += (uint64_t)(difference * difference);
+                }
+
+                squared_error += (double)row_error;
+                samples += plane->real_width;
+            }
+        }
+    }
+
+    jpeg_finish_decompress(decompress_context);
+
+    if (squared_error == 0) {
+        *psnr = PSNR_MAX;
+    } else {
+        *psnr = SAIL_MIN(PSNR_MAX, 10 * log10(255.0 * 255.0 * (double)samples / squared_error));
+    }
+
+    SAIL_LOG_TRACE("JPEG: Trial has PSNR %.2f dB", *psnr);
+
+    return SAIL_OK;
+}
+
+/* Makes the current trial the best one. The old best buffer is reused for the next trial. */
+static void keep_trial(struct jpeg_private_target *target) {
+
+    const struct memory_buffer best = target->best;
+
+    target->best  = target->trial;
+    target->trial = best;
+}
+
+/*
+ * Public functions.
+ */
+
+bool jpeg_private_target_requested(const struct sail_save_options *save_options) {
+
+    return save_options->target_size > 0 || save_options->target_quality > 0;
+}
+
+bool jpeg_private_target_supported(const struct jpeg_compress_struct *compress_context, enum SailPixelFormat pixel_format) {
+
+    struct pixel_layout layout;
+
+    if (!pixel_layout(pixel_format, &layout) || !source_converts_to(layout.source, compress_context->jpeg_color_space)) {
+        return false;
+    }
+
+    if (compress_context->num_components > TARGET_COMPONENTS_MAX) {
+        return false;
+    }
+
+    int max_h_samp_factor = 1;
+    int max_v_samp_factor = 1;
+
+    for (int c = 0; c < compress_context->num_components; c++) {
+        max_h_samp_factor = SAIL_MAX(max_h_samp_factor, compress_context->comp_info[c].h_samp_factor);
+        max_v_samp_factor = SAIL_MAX(max_v_samp_factor, compress_context->comp_info[c].v_samp_factor);
+    }
+
+    /* The box filter downsamples by whole factors only. */
+    for (int c = 0; c < compress_context->num_components; c++) {
+        if (max_h_samp_factor % compress_context->comp_info[c].h_samp_factor != 0 ||
+                max_v_samp_factor % compress_context->comp_info[c].v_samp_factor != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+sail_status_t jpeg_private_alloc_target(struct jpeg_private_target **target) {
+
+    SAIL_CHECK_PTR(target);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct jpeg_private_target), &ptr));
+    *target = ptr;
+
+    memset(*target, 0, sizeof(struct jpeg_private_target));
+
+    (*target)->destination.pub.init_destination    = init_memory_destination;
+    (*target)->destination.pub.empty_output_buffer = empty_memory_output_buffer;
+    (*target)->destination.pub.term_destination    = term_memory_destination;
+    (*target)->destination.buffer                  = &(*target)->trial;
+
+    (*target)->source.init_source       = init_memory_source;
+    (*target)->source.fill_input_buffer = fill_memory_input_buffer;
+    (*target)->source.skip_input_data   = skip_memory_input_data;
+    (*target)->source.resync_to_restart = jpeg_resync_to_restart;
+    (*target)->source.term_source       = term_memory_source;
+
+    return SAIL_OK;
+}
+
+void jpeg_private_destroy_target(struct jpeg_private_target *target) {
+
+    if (target == NULL) {
+        return;
+    }
+
+    if (target->decompress_context != NULL) {
+        jpeg_destroy_decompress(target->decompress_context);
+        sail_free(target->decompress_context);
+    }
+
+    free_planes(target);
+    sail_free(target->decoded);
+    sail_free(target->best.data);
+    sail_free(target->trial.data);
+
+    sail_free(target);
+}
+
+sail_status_t jpeg_private_save_with_target(struct jpeg_private_target *target,
+                                            struct jpeg_compress_struct *compress_context,
+                                            struct jpeg_private_my_error_context *error_context,
+                                            const struct sail_save_options *save_options,
+                                            const struct sail_image *image,
+                                            struct sail_io *io) {
+
+    SAIL_TRY(load_samples(target, compress_context, save_options, image));
+
+    int low = QUALITY_MIN;
+    int high = QUALITY_MAX;
+    int best_quality = 0;
+
+    /* The highest quality that fits into the target size. */
+    if (save_options->target_size > 0) {
+        const size_t target_size = save_options->target_size;
+
+        while (low <= high) {
+            SAIL_TRY(sail_check_cancellation(save_options->cancellation));
+
+            const int quality = low + (high - low) / 2;
+            SAIL_TRY(encode_trial(target, compress_context, save_options, image, quality));
+
+            if (target->trial.size <= target_size) {
+                const bool close_enough = (double)target->trial.size >= (double)target_size * (1 - SIZE_TOLERANCE);
+
+                keep_trial(target);
+                best_quality = quality;
+                low = quality + 1;
+
+                if (close_enough) {
+                    break;
+                }
+            } else {
+                high = quality - 1;
+            }
+        }
+
+        /* The last trial had the lowest quality. */
+        if (best_quality == 0) {
+            SAIL_LOG_WARNING("JPEG: The lowest quality of %zu bytes doesn't fit into the target size of %zu bytes",
+                             target->trial.size, target_size);
+            keep_trial(target);
+            best_quality = QUALITY_MIN;
+        }
+
+        low = QUALITY_MIN;
+        high = best_quality;
+    }
+
+    /* The lowest quality that reaches the target PSNR. */
+    if (save_options->target_quality > 0) {
+        bool found = false;
+
+        while (low <= high) {
+            SAIL_TRY(sail_check_cancellation(save_options->cancellation));
+
+            const int quality = low + (high - low) / 2;
+            SAIL_TRY(encode_trial(target, compress_context, save_options, image, quality));
+
+            double psnr;
+            SAIL_TRY(measure_trial_psnr(target, error_context, &psnr));
+
+            if (psnr >= save_options->target_quality) {
+                keep_trial(target);
+                best_quality = quality;
+                found = true;
+                high = quality - 1;
+
+                if (psnr <= save_options->target_quality + PSNR_TOLERANCE) {
+                    break;
+                }
+            } else {
+                low = quality + 1;
+            }
+        }
+
+        /* The last trial had the highest allowed quality. */
+        if (!found) {
+            SAIL_LOG_WARNING("JPEG: The target quality of %.2f dB is not reachable", save_options->target_quality);
+            keep_trial(target);
+            best_quality = high;
+        }
+    }
+
+    SAIL_LOG_TRACE("JPEG: Saving the trial with quality %d of %zu bytes", best_quality, target->best.size);
+
+    SAIL_TRY(io->strict_write(io->stream, target->best.data, target->best.size));
+    SAIL_TRY(io->flush(io->stream));
+
+    return SAIL_OK;
+}
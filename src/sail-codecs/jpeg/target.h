@@ -0,0 +1,71 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_JPEG_TARGET_H
+#define SAIL_JPEG_TARGET_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <jpeglib.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+
+struct sail_image;
+struct sail_io;
+struct sail_save_options;
+
+struct jpeg_private_my_error_context;
+
+/*
+ * Trial encodes made to reach save_options->target_size or save_options->target_quality.
+ * The buffers live in the codec state, so a libjpeg error jumping out of a trial doesn't leak them.
+ */
+struct jpeg_private_target;
+
+/* Returns true if the save options ask for a target size or quality. */
+SAIL_HIDDEN bool jpeg_private_target_requested(const struct sail_save_options *save_options);
+
+/* Returns true if the frame set up in the compress context can be encoded from raw downsampled samples. */
+SAIL_HIDDEN bool jpeg_private_target_supported(const struct jpeg_compress_struct *compress_context, enum SailPixelFormat pixel_format);
+
+SAIL_HIDDEN sail_status_t jpeg_private_alloc_target(struct jpeg_private_target **target);
+
+SAIL_HIDDEN void jpeg_private_destroy_target(struct jpeg_private_target *target);
+
+/*
+ * Searches for the JPEG quality matching the targets of the save options with in-memory trial encodes,
+ * and writes the best trial into the I/O stream. The compress context must be set up, but not started.
+ * libjpeg errors jump to the setjmp buffer of the error context.
+ */
+SAIL_HIDDEN sail_status_t jpeg_private_save_with_target(struct jpeg_private_target *target,
+                                                        struct jpeg_compress_struct *compress_context,
+                                                        struct jpeg_private_my_error_context *error_context,
+                                                        const struct sail_save_options *save_options,
+                                                        const struct sail_image *image,
+                                                        struct sail_io *io);
+
+#endif
@@ -41,7 +41,7 @@ struct jpeg2000_state {
     const struct sail_save_options *save_options;
 
     bool frame_loaded;
-    void *image_data;
+    void *allocated_image_data;
     jas_stream_t *jas_stream;
     jas_image_t *jas_image;
 
@@ -68,13 +68,13 @@ static sail_status_t alloc_jpeg2000_state(const struct sail_load_options *load_o
         .load_options = load_options,
         .save_options = save_options,
 
-        .frame_loaded    = false,
-        .image_data      = NULL,
-        .jas_stream      = NULL,
-        .jas_image       = NULL,
-        .number_channels = 0,
-        .matrix          = { NULL, NULL, NULL, NULL },
-        .shift           = 0,
+        .frame_loaded         = false,
+        .allocated_image_data = NULL,
+        .jas_stream           = NULL,
+        .jas_image            = NULL,
+        .number_channels      = 0,
+        .matrix               = { NULL, NULL, NULL, NULL },
+        .shift                = 0,
     };
 
     return SAIL_OK;
@@ -102,7 +102,7 @@ static void destroy_jpeg2000_state(struct jpeg2000_state *jpeg2000_state) {
 
     jas_cleanup();
 
-    sail_free(jpeg2000_state->image_data);
+    sail_free(jpeg2000_state->allocated_image_data);
 
     sail_free(jpeg2000_state);
 }
@@ -121,11 +121,15 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_jpeg2000(struct sail_io *io, c
     *state = jpeg2000_state;
 
     /* Read the entire image to use the JasPer memory API. */
+    const void *image_data;
     size_t image_size;
-    SAIL_TRY(sail_alloc_data_from_io_contents(io, &jpeg2000_state->image_data, &image_size));
+    SAIL_TRY(sail_borrow_or_alloc_data_from_io_contents(io, &image_data, &image_size, &jpeg2000_state->allocated_image_data));
 
-    /* TODO This function may generate a warning on old versions of Jasper: conversion from size_t to int. */
-    jpeg2000_state->jas_stream = jas_stream_memopen(jpeg2000_state->image_data, image_size);
+    /*
+     * JasPer doesn't write into the buffer of a stream opened for reading.
+     * TODO This function may generate a warning on old versions of Jasper: conversion from size_t to int.
+     */
+    jpeg2000_state->jas_stream = jas_stream_memopen((char *)image_data, image_size);
 
     if (jpeg2000_state->jas_stream == NULL) {
         SAIL_LOG_ERROR("JPEG2000: Failed to open the specified file");
@@ -0,0 +1,396 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <openjpeg.h>
+
+#include <sail-common/sail-common.h>
+
+#include "openjpeg_helpers.h"
+
+/*
+ * Codec-specific state.
+ */
+struct jpeg2000_state {
+    struct sail_io *io;
+    const struct sail_load_options *load_options;
+    const struct sail_save_options *save_options;
+
+    bool frame_loaded;
+    opj_stream_t *opj_stream;
+    opj_codec_t *opj_codec;
+    opj_image_t *opj_image;
+
+    /* Number of highest resolution levels discarded while decoding. */
+    unsigned reduce;
+    /* Channel depth in bits scaled to a byte boundary. For example, 12 bit images are scaled to 16 bit. */
+    unsigned channel_depth_scaled;
+    unsigned shift;
+};
+
+static sail_status_t alloc_jpeg2000_state(struct sail_io *io,
+                                            const struct sail_load_options *load_options,
+                                            const struct sail_save_options *save_options,
+                                            struct jpeg2000_state **jpeg2000_state) {
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct jpeg2000_state), &ptr));
+    *jpeg2000_state = ptr;
+
+    **jpeg2000_state = (struct jpeg2000_state) {
+        .io           = io,
+        .load_options = load_options,
+        .save_options = save_options,
+
+        .frame_loaded         = false,
+        .opj_stream           = NULL,
+        .opj_codec            = NULL,
+        .opj_image            = NULL,
+        .reduce               = 0,
+        .channel_depth_scaled = 0,
+        .shift                = 0,
+    };
+
+    return SAIL_OK;
+}
+
+static void destroy_jpeg2000_state(struct jpeg2000_state *jpeg2000_state) {
+
+    if (jpeg2000_state == NULL) {
+        return;
+    }
+
+    if (jpeg2000_state->opj_image != NULL) {
+        opj_image_destroy(jpeg2000_state->opj_image);
+    }
+
+    if (jpeg2000_state->opj_codec != NULL) {
+        opj_destroy_codec(jpeg2000_state->opj_codec);
+    }
+
+    if (jpeg2000_state->opj_stream != NULL) {
+        opj_stream_destroy(jpeg2000_state->opj_stream);
+    }
+
+    sail_free(jpeg2000_state);
+}
+
+/* Dimension of the image area [start, end) on the reference grid reduced by 2^reduce. */
+static unsigned reduced_dimension(OPJ_UINT32 start, OPJ_UINT32 end, unsigned reduce) {
+
+    const uint64_t divisor = UINT64_C(1) << reduce;
+
+    return (unsigned)((end + divisor - 1) / divisor - (start + divisor - 1) / divisor);
+}
+
+/*
+ * Decoding functions.
+ */
+
+SAIL_EXPORT sail_status_t sail_codec_load_init_v8_jpeg2000(struct sail_io *io, const struct sail_load_options *load_options, void **state) {
+
+    *state = NULL;
+
+    /* Allocate a new state. */
+    struct jpeg2000_state *jpeg2000_state;
+    SAIL_TRY(alloc_jpeg2000_state(io, load_options, NULL, &jpeg2000_state));
+    *state = jpeg2000_state;
+
+    OPJ_CODEC_FORMAT codec_format;
+    SAIL_TRY(jpeg2000_private_openjpeg_codec_format(io, &codec_format));
+
+    /* Stream the data from the I/O object instead of reading it into memory. */
+    SAIL_TRY(jpeg2000_private_openjpeg_create_stream(io, &jpeg2000_state->opj_stream));
+
+    jpeg2000_state->opj_codec = opj_create_decompress(codec_format);
+
+    if (jpeg2000_state->opj_codec == NULL) {
+        SAIL_LOG_ERROR("JPEG2000: Failed to create a decoder");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    jpeg2000_private_openjpeg_set_log_handlers(jpeg2000_state->opj_codec);
+
+    opj_dparameters_t parameters;
+    opj_set_default_decoder_parameters(&parameters);
+
+    if (!opj_setup_decoder(jpeg2000_state->opj_codec, &parameters)) {
+        SAIL_LOG_ERROR("JPEG2000: Failed to set up the decoder");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Handle tuning. Decode code blocks in all processors by default. */
+    int threads = opj_get_num_cpus();
+
+    if (jpeg2000_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(jpeg2000_state->load_options->tuning, jpeg2000_private_openjpeg_tuning_key_value_callback, &threads);
+    }
+
+    if (opj_has_thread_support() && threads > 1) {
+        if (!opj_codec_set_threads(jpeg2000_state->opj_codec, threads)) {
+            SAIL_LOG_WARNING("JPEG2000: Failed to decode in %d threads", threads);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpeg2000(void *state, struct sail_image **image) {
+
+    struct jpeg2000_state *jpeg2000_state = state;
+
+    if (jpeg2000_state->frame_loaded) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    jpeg2000_state->frame_loaded = true;
+
+    /* Get image info. */
+    if (!opj_read_header(jpeg2000_state->opj_stream, jpeg2000_state->opj_codec, &jpeg2000_state->opj_image)) {
+        SAIL_LOG_ERROR("JPEG2000: Failed to read image header");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    const opj_image_t *opj_image = jpeg2000_state->opj_image;
+
+    if (opj_image->numcomps == 0) {
+        SAIL_LOG_ERROR("JPEG2000: Image has no channels");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    /* Check image parameters per channel. */
+    const unsigned channel_depth = opj_image->comps[0].prec;
+
+    for (OPJ_UINT32 i = 0; i < opj_image->numcomps; i++) {
+        if (opj_image->comps[i].dx != 1 || opj_image->comps[i].dy != 1) {
+            SAIL_LOG_ERROR("JPEG2000: Channel #%u has subsampling factor not equal to 1", i);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        if (opj_image->comps[i].prec != channel_depth) {
+            SAIL_LOG_ERROR("JPEG2000: Channel #%u depth %u doesn't match channel #0 depth %u", i, opj_image->comps[i].prec, channel_depth);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_BIT_DEPTH);
+        }
+    }
+
+    /* Detect image format. */
+    jpeg2000_state->channel_depth_scaled = ((channel_depth + 7) / 8) * 8;
+
+    if (jpeg2000_state->channel_depth_scaled != 8 && jpeg2000_state->channel_depth_scaled != 16) {
+        SAIL_LOG_ERROR("JPEG2000: Unsupported bit depth %u scaled from %u", jpeg2000_state->channel_depth_scaled, channel_depth);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_BIT_DEPTH);
+    }
+
+    jpeg2000_state->shift = jpeg2000_state->channel_depth_scaled - channel_depth;
+    SAIL_LOG_TRACE("JPEG2000: Channels: %u, Channel depth %u (scaled to %u), shift samples by %u",
+                    opj_image->numcomps, channel_depth, jpeg2000_state->channel_depth_scaled, jpeg2000_state->shift);
+
+    const enum SailPixelFormat pixel_format =
+        jpeg2000_private_openjpeg_pixel_format(opj_image->color_space,
+                                                opj_image->numcomps,
+                                                opj_image->comps[opj_image->numcomps - 1].alpha != 0,
+                                                jpeg2000_state->channel_depth_scaled);
+
+    if (pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN) {
+        SAIL_LOG_ERROR("JPEG2000: Unsupported pixel format");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    /* Discard the highest resolution levels for the requested scale. */
+    jpeg2000_state->reduce = jpeg2000_private_openjpeg_reduce_factor(jpeg2000_state->load_options->scale_denominator,
+                                                                    jpeg2000_state->opj_codec);
+
+    if (jpeg2000_state->reduce > 0) {
+        SAIL_LOG_TRACE("JPEG2000: Discarding %u resolution levels", jpeg2000_state->reduce);
+
+        if (!opj_set_decoded_resolution_factor(jpeg2000_state->opj_codec, jpeg2000_state->reduce)) {
+            SAIL_LOG_ERROR("JPEG2000: Failed to set resolution factor");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    }
+
+    unsigned width  = reduced_dimension(opj_image->x0, opj_image->x1, jpeg2000_state->reduce);
+    unsigned height = reduced_dimension(opj_image->y0, opj_image->y1, jpeg2000_state->reduce);
+
+    /* Decode only the tiles and code blocks of the region of interest. */
+    if (sail_roi_is_set(&jpeg2000_state->load_options->roi) && !(jpeg2000_state->load_options->options & SAIL_OPTION_PROBE)) {
+        struct sail_roi roi;
+        SAIL_TRY(sail_clip_roi(&jpeg2000_state->load_options->roi, width, height, &roi));
+
+        /* The region is in the scaled coordinates, and the decode area is on the reference grid. */
+        const uint64_t origin_x = (opj_image->x0 + (UINT64_C(1) << jpeg2000_state->reduce) - 1) >> jpeg2000_state->reduce;
+        const uint64_t origin_y = (opj_image->y0 + (UINT64_C(1) << jpeg2000_state->reduce) - 1) >> jpeg2000_state->reduce;
+
+        const OPJ_INT32 area_x0 = (OPJ_INT32)SAIL_MAX((origin_x + roi.x) << jpeg2000_state->reduce, opj_image->x0);
+        const OPJ_INT32 area_y0 = (OPJ_INT32)SAIL_MAX((origin_y + roi.y) << jpeg2000_state->reduce, opj_image->y0);
+        const OPJ_INT32 area_x1 = (OPJ_INT32)SAIL_MIN((origin_x + roi.x + roi.width) << jpeg2000_state->reduce, opj_image->x1);
+        const OPJ_INT32 area_y1 = (OPJ_INT32)SAIL_MIN((origin_y + roi.y + roi.height) << jpeg2000_state->reduce, opj_image->y1);
+
+        if (!opj_set_decode_area(jpeg2000_state->opj_codec, jpeg2000_state->opj_image, area_x0, area_y0, area_x1, area_y1)) {
+            SAIL_LOG_ERROR("JPEG2000: Failed to set decode area");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        width  = roi.width;
+        height = roi.height;
+    }
+
+    /* Allocate image. */
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    if (jpeg2000_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&image_local->source_image),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        image_local->source_image->pixel_format = pixel_format;
+        image_local->source_image->compression  = SAIL_COMPRESSION_JPEG_2000;
+    }
+
+    if (jpeg2000_state->load_options->options & SAIL_OPTION_ICCP
+            && opj_image->icc_profile_buf != NULL && opj_image->icc_profile_len > 0) {
+        SAIL_LOG_TRACE("JPEG2000: Found ICC profile %u bytes long", opj_image->icc_profile_len);
+
+        SAIL_TRY_OR_CLEANUP(sail_alloc_iccp_from_data(opj_image->icc_profile_buf, opj_image->icc_profile_len, &image_local->iccp),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->pixel_format   = pixel_format;
+    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_jpeg2000(void *state, struct sail_image *image) {
+
+    const struct jpeg2000_state *jpeg2000_state = state;
+
+    if (!opj_decode(jpeg2000_state->opj_codec, jpeg2000_state->opj_stream, jpeg2000_state->opj_image) ||
+            !opj_end_decompress(jpeg2000_state->opj_codec, jpeg2000_state->opj_stream)) {
+        SAIL_LOG_ERROR("JPEG2000: Failed to decode image");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    const opj_image_t *opj_image = jpeg2000_state->opj_image;
+    const unsigned number_channels = opj_image->numcomps;
+
+    /* Decoded channels may be a pixel smaller than expected on odd reference grid origins. */
+    const unsigned width  = SAIL_MIN(image->width, opj_image->comps[0].w);
+    const unsigned height = SAIL_MIN(image->height, opj_image->comps[0].h);
+
+    if (width < image->width || height < image->height) {
+        memset(image->pixels, 0, (size_t)image->bytes_per_line * image->height);
+    }
+
+    for (unsigned channel = 0; channel < number_channels; channel++) {
+        const opj_image_comp_t *comp = &opj_image->comps[channel];
+
+        if (comp->data == NULL || comp->w < width || comp->h < height) {
+            SAIL_LOG_ERROR("JPEG2000: Channel #%u is missing", channel);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+    }
+
+    for (unsigned row = 0; row < height; row++) {
+        for (unsigned channel = 0; channel < number_channels; channel++) {
+            const opj_image_comp_t *comp = &opj_image->comps[channel];
+            const OPJ_INT32 *data = comp->data + (size_t)row * comp->w;
+
+            /* Signed samples are moved into the unsigned range. */
+            const OPJ_INT32 offset = comp->sgnd ? (OPJ_INT32)(1U << (comp->prec - 1)) : 0;
+
+            if (jpeg2000_state->channel_depth_scaled == 8) {
+                unsigned char *scan = (unsigned char *)sail_scan_line(image, row) + channel;
+
+                for (unsigned column = 0; column < width; column++, scan += number_channels) {
+                    *scan = (unsigned char)((data[column] + offset) << jpeg2000_state->shift);
+                }
+            } else {
+                uint16_t *scan = (uint16_t *)sail_scan_line(image, row) + channel;
+
+                for (unsigned column = 0; column < width; column++, scan += number_channels) {
+                    *scan = (uint16_t)((data[column] + offset) << jpeg2000_state->shift);
+                }
+            }
+        }
+    }
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_jpeg2000(void **state) {
+
+    struct jpeg2000_state *jpeg2000_state = *state;
+
+    *state = NULL;
+
+    destroy_jpeg2000_state(jpeg2000_state);
+
+    return SAIL_OK;
+}
+
+/*
+ * Encoding functions.
+ */
+
+SAIL_EXPORT sail_status_t sail_codec_save_init_v8_jpeg2000(struct sail_io *io, const struct sail_save_options *save_options, void **state) {
+
+    (void)io;
+    (void)save_options;
+    (void)state;
+
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_jpeg2000(void *state, const struct sail_image *image) {
+
+    (void)state;
+    (void)image;
+
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_jpeg2000(void *state, const struct sail_image *image) {
+
+    (void)state;
+    (void)image;
+
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_jpeg2000(void **state) {
+
+    (void)state;
+
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+}
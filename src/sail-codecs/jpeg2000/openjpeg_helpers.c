@@ -0,0 +1,241 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h> /* SEEK_CUR */
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "openjpeg_helpers.h"
+
+enum SailPixelFormat jpeg2000_private_openjpeg_pixel_format(OPJ_COLOR_SPACE color_space, unsigned number_channels,
+                                                             bool has_alpha, unsigned channel_depth) {
+
+    switch (color_space) {
+        case OPJ_CLRSPC_CMYK: {
+            switch (number_channels) {
+                case 4: return (channel_depth == 8) ? SAIL_PIXEL_FORMAT_BPP32_CMYK  : SAIL_PIXEL_FORMAT_BPP64_CMYK;
+                case 5: return (channel_depth == 8) ? SAIL_PIXEL_FORMAT_BPP40_CMYKA : SAIL_PIXEL_FORMAT_BPP80_CMYKA;
+
+                default: {
+                    return SAIL_PIXEL_FORMAT_UNKNOWN;
+                }
+            }
+        }
+        case OPJ_CLRSPC_SYCC: {
+            return (number_channels == 3 && channel_depth == 8) ? SAIL_PIXEL_FORMAT_BPP24_YCBCR : SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+        case OPJ_CLRSPC_GRAY:
+        case OPJ_CLRSPC_SRGB:
+        case OPJ_CLRSPC_UNSPECIFIED:
+        case OPJ_CLRSPC_UNKNOWN: {
+            switch (number_channels) {
+                case 1: return (channel_depth == 8) ? SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE : SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE;
+                case 2: {
+                    if (!has_alpha) {
+                        return SAIL_PIXEL_FORMAT_UNKNOWN;
+                    }
+
+                    return (channel_depth == 8) ? SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA : SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA;
+                }
+                case 3: return (channel_depth == 8) ? SAIL_PIXEL_FORMAT_BPP24_RGB  : SAIL_PIXEL_FORMAT_BPP48_RGB;
+                case 4: return (channel_depth == 8) ? SAIL_PIXEL_FORMAT_BPP32_RGBA : SAIL_PIXEL_FORMAT_BPP64_RGBA;
+
+                default: {
+                    return SAIL_PIXEL_FORMAT_UNKNOWN;
+                }
+            }
+        }
+
+        default: {
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+    }
+}
+
+sail_status_t jpeg2000_private_openjpeg_codec_format(struct sail_io *io, OPJ_CODEC_FORMAT *codec_format) {
+
+    static const unsigned char JP2_SIGNATURE[] = { 0x00, 0x00, 0x00, 0x0C, 0x6A, 0x50, 0x20, 0x20, 0x0D, 0x0A, 0x87, 0x0A };
+    static const unsigned char J2K_SIGNATURE[] = { 0xFF, 0x4F, 0xFF, 0x51 };
+
+    size_t offset;
+    SAIL_TRY(io->tell(io->stream, &offset));
+
+    unsigned char signature[sizeof(JP2_SIGNATURE)];
+    size_t read_size;
+    SAIL_TRY(io->tolerant_read(io->stream, signature, sizeof(signature), &read_size));
+    SAIL_TRY(io->seek(io->stream, (long)offset, SEEK_SET));
+
+    if (read_size >= sizeof(JP2_SIGNATURE) && memcmp(signature, JP2_SIGNATURE, sizeof(JP2_SIGNATURE)) == 0) {
+        *codec_format = OPJ_CODEC_JP2;
+    } else if (read_size >= sizeof(J2K_SIGNATURE) && memcmp(signature, J2K_SIGNATURE, sizeof(J2K_SIGNATURE)) == 0) {
+        *codec_format = OPJ_CODEC_J2K;
+    } else {
+        SAIL_LOG_ERROR("JPEG2000: Unknown file signature");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    return SAIL_OK;
+}
+
+static OPJ_SIZE_T read_proc(void *buffer, OPJ_SIZE_T size, void *user_data) {
+
+    struct sail_io *io = user_data;
+
+    size_t read_size;
+
+    if (io->tolerant_read(io->stream, buffer, size, &read_size) != SAIL_OK || read_size == 0) {
+        return (OPJ_SIZE_T)-1;
+    }
+
+    return read_size;
+}
+
+static OPJ_OFF_T skip_proc(OPJ_OFF_T size, void *user_data) {
+
+    struct sail_io *io = user_data;
+
+    if (io->seek(io->stream, (long)size, SEEK_CUR) != SAIL_OK) {
+        return -1;
+    }
+
+    return size;
+}
+
+static OPJ_BOOL seek_proc(OPJ_OFF_T offset, void *user_data) {
+
+    struct sail_io *io = user_data;
+
+    return io->seek(io->stream, (long)offset, SEEK_SET) == SAIL_OK;
+}
+
+sail_status_t jpeg2000_private_openjpeg_create_stream(struct sail_io *io, opj_stream_t **stream) {
+
+    size_t size;
+    SAIL_TRY(sail_io_size(io, &size));
+
+    opj_stream_t *stream_local = opj_stream_create(OPJ_J2K_STREAM_CHUNK_SIZE, OPJ_TRUE);
+
+    if (stream_local == NULL) {
+        SAIL_LOG_ERROR("JPEG2000: Failed to create a stream");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    opj_stream_set_read_function(stream_local, read_proc);
+    opj_stream_set_skip_function(stream_local, skip_proc);
+    opj_stream_set_seek_function(stream_local, seek_proc);
+    opj_stream_set_user_data(stream_local, io, NULL);
+    opj_stream_set_user_data_length(stream_local, size);
+
+    *stream = stream_local;
+
+    return SAIL_OK;
+}
+
+/* OpenJPEG messages end with a new line. */
+static int message_length(const char *msg) {
+
+    const size_t length = strlen(msg);
+
+    return (length > 0 && msg[length - 1] == '\n') ? (int)length - 1 : (int)length;
+}
+
+static void error_handler(const char *msg, void *client_data) {
+
+    (void)client_data;
+
+    SAIL_LOG_ERROR("JPEG2000: %.*s", message_length(msg), msg);
+}
+
+static void warning_handler(const char *msg, void *client_data) {
+
+    (void)client_data;
+
+    SAIL_LOG_WARNING("JPEG2000: %.*s", message_length(msg), msg);
+}
+
+static void info_handler(const char *msg, void *client_data) {
+
+    (void)client_data;
+
+    SAIL_LOG_TRACE("JPEG2000: %.*s", message_length(msg), msg);
+}
+
+void jpeg2000_private_openjpeg_set_log_handlers(opj_codec_t *codec) {
+
+    opj_set_error_handler(codec, error_handler, NULL);
+    opj_set_warning_handler(codec, warning_handler, NULL);
+    opj_set_info_handler(codec, info_handler, NULL);
+}
+
+unsigned jpeg2000_private_openjpeg_reduce_factor(unsigned scale_denominator, opj_codec_t *codec) {
+
+    unsigned reduce = 0;
+
+    while ((2U << reduce) <= scale_denominator) {
+        reduce++;
+    }
+
+    if (reduce == 0) {
+        return 0;
+    }
+
+    /* Every component must keep at least its lowest resolution level. */
+    opj_codestream_info_v2_t *codestream_info = opj_get_cstr_info(codec);
+
+    if (codestream_info == NULL) {
+        return 0;
+    }
+
+    for (OPJ_UINT32 i = 0; i < codestream_info->nbcomps; i++) {
+        const OPJ_UINT32 resolutions = codestream_info->m_default_tile_info.tccp_info[i].numresolutions;
+
+        reduce = SAIL_MIN(reduce, (resolutions > 0) ? resolutions - 1 : 0);
+    }
+
+    opj_destroy_cstr_info(&codestream_info);
+
+    return reduce;
+}
+
+bool jpeg2000_private_openjpeg_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    int *threads = user_data;
+
+    if (strcmp(key, "jpeg2000-threads") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned threads_value = sail_variant_to_unsigned_int(value);
+
+            if (threads_value > 0) {
+                SAIL_LOG_TRACE("JPEG2000: Decoding in %u threads", threads_value);
+                *threads = (int)threads_value;
+            }
+        } else {
+            SAIL_LOG_WARNING("JPEG2000: 'jpeg2000-threads' must be an unsigned integer");
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,62 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_JPEG2000_OPENJPEG_HELPERS_H
+#define SAIL_JPEG2000_OPENJPEG_HELPERS_H
+
+#include <stdbool.h>
+
+#include <openjpeg.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_io;
+struct sail_variant;
+
+SAIL_HIDDEN enum SailPixelFormat jpeg2000_private_openjpeg_pixel_format(OPJ_COLOR_SPACE color_space, unsigned number_channels,
+                                                                         bool has_alpha, unsigned channel_depth);
+
+/*
+ * Detects the codec by the J2K codestream or JP2 box signature. Doesn't change the I/O position.
+ */
+SAIL_HIDDEN sail_status_t jpeg2000_private_openjpeg_codec_format(struct sail_io *io, OPJ_CODEC_FORMAT *codec_format);
+
+/*
+ * Creates a stream reading from the I/O object. OpenJPEG seeks from the start of the I/O object.
+ */
+SAIL_HIDDEN sail_status_t jpeg2000_private_openjpeg_create_stream(struct sail_io *io, opj_stream_t **stream);
+
+SAIL_HIDDEN void jpeg2000_private_openjpeg_set_log_handlers(opj_codec_t *codec);
+
+/*
+ * Converts the desired scale denominator into the number of highest resolution levels to discard.
+ */
+SAIL_HIDDEN unsigned jpeg2000_private_openjpeg_reduce_factor(unsigned scale_denominator, opj_codec_t *codec);
+
+SAIL_HIDDEN bool jpeg2000_private_openjpeg_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+#endif
@@ -24,12 +24,16 @@
 */
 
 #include <stddef.h> /* size_t */
-#include <string.h> /* memmove */
+#include <string.h> /* memcmp, memcpy, memmove, memset */
 
 #include <jxl/version.h>
 
 #include <sail-common/sail-common.h>
 
+#ifdef SAIL_WIN32
+    #include <Windows.h>
+#endif
+
 #include "helpers.h"
 
 SAIL_HIDDEN bool jpegxl_private_is_cmyk(JxlDecoder *decoder, uint32_t num_extra_channels) {
@@ -121,9 +125,12 @@ unsigned jpegxl_private_pixel_format_to_num_channels(enum SailPixelFormat pixel_
         case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA:
         case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: return 2;
         case SAIL_PIXEL_FORMAT_BPP24_RGB:
-        case SAIL_PIXEL_FORMAT_BPP48_RGB:             return 3;
+        case SAIL_PIXEL_FORMAT_BPP48_RGB:
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:        return 3;
         case SAIL_PIXEL_FORMAT_BPP32_RGBA:
-        case SAIL_PIXEL_FORMAT_BPP64_RGBA:            return 4;
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT:     return 4;
 
         default: {
             return 0;
@@ -144,6 +151,11 @@ JxlDataType jpegxl_private_pixel_format_to_jxl_data_type(enum SailPixelFormat pi
         case SAIL_PIXEL_FORMAT_BPP48_RGB:
         case SAIL_PIXEL_FORMAT_BPP64_RGBA:            return JXL_TYPE_UINT16;
 
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:       return JXL_TYPE_FLOAT16;
+
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT:     return JXL_TYPE_FLOAT;
+
         default: {
             return JXL_TYPE_UINT8;
         }
@@ -183,23 +195,38 @@ sail_status_t jpegxl_private_fetch_iccp(JxlDecoder *decoder, struct sail_iccp **
     return SAIL_OK;
 }
 
-sail_status_t jpegxl_private_read_more_data(struct sail_io *io, JxlDecoder *decoder, unsigned char *buffer, size_t buffer_size) {
+/* The input buffer stops growing at this size. */
+static const size_t JPEGXL_MAX_BUFFER_SIZE = 16 * 1024 * 1024;
+
+sail_status_t jpegxl_private_read_more_data(struct sail_io *io, JxlDecoder *decoder,
+                                            unsigned char **buffer, size_t *buffer_size, size_t *data_size) {
 
-    size_t remaining = JxlDecoderReleaseInput(decoder);
+    const size_t remaining = JxlDecoderReleaseInput(decoder);
 
     if (remaining > 0) {
-        memmove(buffer, buffer + buffer_size - remaining, remaining);
+        memmove(*buffer, *buffer + *data_size - remaining, remaining);
+    }
+
+    if (*buffer_size < JPEGXL_MAX_BUFFER_SIZE) {
+        const size_t new_buffer_size = SAIL_MIN(*buffer_size * 2, JPEGXL_MAX_BUFFER_SIZE);
+        void *ptr = *buffer;
+
+        SAIL_TRY(sail_realloc(new_buffer_size, &ptr));
+        *buffer      = ptr;
+        *buffer_size = new_buffer_size;
     }
 
     size_t bytes_read;
-    SAIL_TRY(io->tolerant_read(io->stream, buffer + remaining, buffer_size - remaining, &bytes_read));
+    SAIL_TRY(io->tolerant_read(io->stream, *buffer + remaining, *buffer_size - remaining, &bytes_read));
+
+    *data_size = remaining + bytes_read;
 
     if (bytes_read == 0) {
         JxlDecoderCloseInput(decoder);
         return SAIL_OK;
     }
 
-    if (JxlDecoderSetInput(decoder, buffer, bytes_read + remaining) != JXL_DEC_SUCCESS) {
+    if (JxlDecoderSetInput(decoder, *buffer, *data_size) != JXL_DEC_SUCCESS) {
         SAIL_LOG_ERROR("JPEGXL: Failed to set input buffer");
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
@@ -207,6 +234,127 @@ sail_status_t jpegxl_private_read_more_data(struct sail_io *io, JxlDecoder *deco
     return SAIL_OK;
 }
 
+bool jpegxl_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    unsigned *threads = user_data;
+
+    if (strcmp(key, "jpegxl-threads") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned threads_value = sail_variant_to_unsigned_int(value);
+
+            if (threads_value > 0) {
+                SAIL_LOG_TRACE("JPEGXL: Decoding in at most %u threads", threads_value);
+                *threads = threads_value;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool jpegxl_private_save_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    struct jpegxl_private_save_tuning *save_tuning = user_data;
+
+    if (strcmp(key, "jpegxl-threads") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned threads_value = sail_variant_to_unsigned_int(value);
+
+            if (threads_value > 0) {
+                SAIL_LOG_TRACE("JPEGXL: Encoding in at most %u threads", threads_value);
+                save_tuning->threads = threads_value;
+            }
+        }
+    } else if (strcmp(key, "jpegxl-effort") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned effort = sail_variant_to_unsigned_int(value);
+
+            if (effort >= 1 && effort <= 10) {
+                SAIL_LOG_TRACE("JPEGXL: effort=%u", effort);
+                save_tuning->effort = (int)effort;
+            } else {
+                SAIL_LOG_WARNING("JPEGXL: 'jpegxl-effort' must be in the range [1, 10]");
+            }
+        } else {
+            SAIL_LOG_WARNING("JPEGXL: 'jpegxl-effort' must be an unsigned integer");
+        }
+    } else if (strcmp(key, "jpegxl-jpeg-data") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_DATA) {
+            SAIL_LOG_TRACE("JPEGXL: Recompressing %u bytes of JPEG data", (unsigned)value->size);
+            save_tuning->jpeg_data      = sail_variant_to_data(value);
+            save_tuning->jpeg_data_size = value->size;
+        } else {
+            SAIL_LOG_WARNING("JPEGXL: 'jpegxl-jpeg-data' must be data");
+        }
+    }
+
+    return true;
+}
+
+/* A stage of the parallel runner. Every lane takes the next values until the range is exhausted. */
+struct runner_stage {
+    void *jpegxl_opaque;
+    JxlParallelRunFunction func;
+#ifdef SAIL_WIN32
+    volatile LONG next_value;
+#else
+    uint32_t next_value;
+#endif
+    uint32_t end_range;
+};
+
+static void run_lane(void *user_data, unsigned task, unsigned thread) {
+
+    (void)thread;
+
+    struct runner_stage *stage = user_data;
+
+    for (;;) {
+#ifdef SAIL_WIN32
+        const uint32_t value = (uint32_t)InterlockedExchangeAdd(&stage->next_value, 1);
+#else
+        const uint32_t value = __atomic_fetch_add(&stage->next_value, 1, __ATOMIC_RELAXED);
+#endif
+
+        if (value >= stage->end_range) {
+            break;
+        }
+
+        /* Lanes are the thread indexes libjxl sees. */
+        stage->func(stage->jpegxl_opaque, value, task);
+    }
+}
+
+JxlParallelRetCode jpegxl_private_thread_pool_runner(void *runner_opaque, void *jpegxl_opaque,
+                                                     JxlParallelRunInit init, JxlParallelRunFunction func,
+                                                     uint32_t start_range, uint32_t end_range) {
+
+    const unsigned max_threads = *(const unsigned *)runner_opaque;
+    const uint32_t range = (end_range > start_range) ? end_range - start_range : 0;
+    const unsigned lanes = (unsigned)SAIL_MAX(SAIL_MIN(SAIL_MIN(sail_thread_pool_size(), max_threads), range), 1U);
+
+    const JxlParallelRetCode ret = init(jpegxl_opaque, lanes);
+
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (range == 0) {
+        return 0;
+    }
+
+    struct runner_stage stage = {
+        .jpegxl_opaque = jpegxl_opaque,
+        .func          = func,
+        .next_value    = start_range,
+        .end_range     = end_range,
+    };
+
+    sail_thread_pool_run(lanes, run_lane, &stage);
+
+    return 0;
+}
+
 sail_status_t jpegxl_private_fetch_special_properties(const JxlBasicInfo *basic_info, struct sail_hash_map *special_properties) {
 
     struct sail_variant *variant;
@@ -335,3 +483,119 @@ sail_status_t jpegxl_private_fetch_metadata(JxlDecoder *decoder, struct sail_met
 
     return SAIL_OK;
 }
+
+void jpegxl_private_downscale(const void *frame, unsigned frame_width, unsigned frame_height, unsigned frame_bytes_per_line,
+                              unsigned factor, struct sail_image *image) {
+
+    const unsigned bytes_per_pixel = sail_bits_per_pixel(image->pixel_format) / 8;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const unsigned frame_row = SAIL_MIN(row * factor + factor / 2, frame_height - 1);
+        const unsigned char *frame_scan = (const unsigned char *)frame + (size_t)frame_row * frame_bytes_per_line;
+        unsigned char *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const unsigned frame_column = SAIL_MIN(column * factor + factor / 2, frame_width - 1);
+
+            memcpy(scan + (size_t)column * bytes_per_pixel, frame_scan + (size_t)frame_column * bytes_per_pixel, bytes_per_pixel);
+        }
+    }
+}
+
+static sail_status_t add_box(JxlEncoder *encoder, const char *type, const void *data, size_t size) {
+
+    if (JxlEncoderAddBox(encoder, type, data, size, JXL_FALSE) != JXL_ENC_SUCCESS) {
+        SAIL_LOG_ERROR("JPEGXL: Failed to add '%s' box", type);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t jpegxl_private_write_meta_data(JxlEncoder *encoder, const struct sail_meta_data_node *meta_data_node) {
+
+    bool use_boxes = false;
+
+    for (; meta_data_node != NULL; meta_data_node = meta_data_node->next) {
+        const struct sail_meta_data *meta_data = meta_data_node->meta_data;
+
+        if (meta_data->value->type != SAIL_VARIANT_TYPE_DATA) {
+            continue;
+        }
+
+        const char *type;
+
+        switch (meta_data->key) {
+            case SAIL_META_DATA_EXIF:  type = "Exif"; break;
+            case SAIL_META_DATA_XMP:   type = "xml "; break;
+            case SAIL_META_DATA_JUMBF: type = "jumb"; break;
+
+            default: {
+                SAIL_LOG_WARNING("JPEGXL: Ignoring unsupported meta data key '%s'", sail_meta_data_to_string(meta_data->key));
+                continue;
+            }
+        }
+
+        if (!use_boxes) {
+            if (JxlEncoderUseBoxes(encoder) != JXL_ENC_SUCCESS) {
+                SAIL_LOG_ERROR("JPEGXL: Failed to enable boxes");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+
+            use_boxes = true;
+        }
+
+        const unsigned char *data = sail_variant_to_data(meta_data->value);
+        const size_t size = meta_data->value->size;
+
+        SAIL_LOG_TRACE("JPEGXL: Writing '%s' box", type);
+
+        /*
+         * Exif boxes start with a 4-byte offset to the TIFF header. Loaded boxes already have it,
+         * and EXIF from other formats starts with the TIFF header right away.
+         */
+        if (meta_data->key == SAIL_META_DATA_EXIF
+                && size >= 4
+                && (memcmp(data, "II*\0", 4) == 0 || memcmp(data, "MM\0*", 4) == 0)) {
+            void *ptr;
+            SAIL_TRY(sail_malloc(size + 4, &ptr));
+            unsigned char *exif = ptr;
+
+            memset(exif, 0, 4);
+            memcpy(exif + 4, data, size);
+
+            SAIL_TRY_OR_CLEANUP(add_box(encoder, type, exif, size + 4),
+                                /* cleanup */ sail_free(exif));
+            sail_free(exif);
+        } else {
+            SAIL_TRY(add_box(encoder, type, data, size));
+        }
+    }
+
+    if (use_boxes) {
+        JxlEncoderCloseBoxes(encoder);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t jpegxl_private_write_output(struct sail_io *io, JxlEncoder *encoder, unsigned char *buffer, size_t buffer_size) {
+
+    JxlEncoderStatus status;
+
+    do {
+        uint8_t *next_out = buffer;
+        size_t avail_out = buffer_size;
+
+        status = JxlEncoderProcessOutput(encoder, &next_out, &avail_out);
+
+        if (status == JXL_ENC_ERROR) {
+            SAIL_LOG_ERROR("JPEGXL: Failed to encode image");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        SAIL_TRY(io->strict_write(io->stream, buffer, buffer_size - avail_out));
+    } while (status == JXL_ENC_NEED_MORE_OUTPUT);
+
+    return SAIL_OK;
+}
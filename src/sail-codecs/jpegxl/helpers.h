@@ -30,6 +30,7 @@
 #include <stdint.h>
 
 #include <jxl/decode.h>
+#include <jxl/encode.h>
 
 #include <sail-common/common.h>
 #include <sail-common/export.h>
@@ -37,8 +38,10 @@
 
 struct sail_hash_map;
 struct sail_iccp;
+struct sail_image;
 struct sail_io;
 struct sail_meta_data_node;
+struct sail_variant;
 
 SAIL_HIDDEN bool jpegxl_private_is_cmyk(JxlDecoder *decoder, uint32_t num_extra_channels);
 
@@ -54,7 +57,33 @@ SAIL_HIDDEN JxlDataType jpegxl_private_pixel_format_to_jxl_data_type(enum SailPi
 
 SAIL_HIDDEN sail_status_t jpegxl_private_fetch_iccp(JxlDecoder *decoder, struct sail_iccp **iccp);
 
-SAIL_HIDDEN sail_status_t jpegxl_private_read_more_data(struct sail_io *io, JxlDecoder *decoder, unsigned char *buffer, size_t buffer_size);
+/*
+ * Feeds the decoder with more data. The unconsumed input is kept, and the buffer grows twice on every call
+ * up to 16 MiB, so big files are read in a few big chunks.
+ */
+SAIL_HIDDEN sail_status_t jpegxl_private_read_more_data(struct sail_io *io, JxlDecoder *decoder,
+                                                        unsigned char **buffer, size_t *buffer_size, size_t *data_size);
+
+SAIL_HIDDEN bool jpegxl_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+struct jpegxl_private_save_tuning {
+    unsigned threads;
+    int effort;
+    /* JPEG bitstream to recompress losslessly instead of encoding pixels. */
+    const void *jpeg_data;
+    size_t jpeg_data_size;
+};
+
+SAIL_HIDDEN bool jpegxl_private_save_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+/*
+ * libjxl parallel runner that runs stages on the SAIL thread pool. 'runner_opaque' points to
+ * the unsigned maximum number of threads, so all decoders and encoders share the pool size
+ * as the thread budget.
+ */
+SAIL_HIDDEN JxlParallelRetCode jpegxl_private_thread_pool_runner(void *runner_opaque, void *jpegxl_opaque,
+                                                                 JxlParallelRunInit init, JxlParallelRunFunction func,
+                                                                 uint32_t start_range, uint32_t end_range);
 
 SAIL_HIDDEN sail_status_t jpegxl_private_fetch_special_properties(const JxlBasicInfo *basic_info, struct sail_hash_map *special_properties);
 
@@ -62,4 +91,18 @@ SAIL_HIDDEN sail_status_t jpegxl_private_fetch_name(JxlDecoder *decoder, uint32_
 
 SAIL_HIDDEN sail_status_t jpegxl_private_fetch_metadata(JxlDecoder *decoder, struct sail_meta_data_node **meta_data_node);
 
+/*
+ * Samples the center pixel of every 'factor' x 'factor' block of the full-size frame into the image.
+ * Used with DC-only decoding where every 8x8 block is already flat.
+ */
+SAIL_HIDDEN void jpegxl_private_downscale(const void *frame, unsigned frame_width, unsigned frame_height, unsigned frame_bytes_per_line,
+                                          unsigned factor, struct sail_image *image);
+
+SAIL_HIDDEN sail_status_t jpegxl_private_write_meta_data(JxlEncoder *encoder, const struct sail_meta_data_node *meta_data_node);
+
+/*
+ * Writes all the encoded data to the I/O object through the specified intermediate buffer.
+ */
+SAIL_HIDDEN sail_status_t jpegxl_private_write_output(struct sail_io *io, JxlEncoder *encoder, unsigned char *buffer, size_t buffer_size);
+
 #endif
@@ -23,6 +23,7 @@
     SOFTWARE.
 */
 
+#include <limits.h>
 #include <stdbool.h>
 #include <stddef.h> /* size_t */
 #include <stdint.h>
@@ -30,13 +31,23 @@
 #include <stdlib.h>
 
 #include <jxl/decode.h>
-#include <jxl/resizable_parallel_runner.h>
+#include <jxl/encode.h>
 
 #include <sail-common/sail-common.h>
 
 #include "helpers.h"
 #include "memory.h"
 
+/*
+ * Compression level is the Butteraugli distance. 0 is mathematically lossless.
+ */
+static const double COMPRESSION_MIN     = 0;
+static const double COMPRESSION_MAX     = 25;
+static const double COMPRESSION_DEFAULT = 1;
+
+/* Size of the buffer for progressive reading. */
+#define BUFFER_SIZE (64 * 1024)
+
 /*
  * Codec-specific state.
  */
@@ -51,11 +62,27 @@ struct jpegxl_state {
     bool frame_header_seen;
     JxlBasicInfo *basic_info;
     JxlMemoryManager *memory_manager;
-    void *runner;
+    /* Passed to jpegxl_private_thread_pool_runner(). */
+    unsigned max_threads;
     JxlDecoder *decoder;
-    /* For progressive reading. */
+    /* 8 to decode DC images only, 1 for the full resolution. */
+    unsigned scale_denominator;
+    /* Report progressive passes to load_options->pass_callback. */
+    bool passes;
+    /* Full-size frame the DC image is flushed into before downscaling. */
+    void *frame_buffer;
+    JxlEncoder *encoder;
+    JxlEncoderFrameSettings *frame_settings;
+    bool lossless;
+    bool frame_saved;
+    bool frame_added;
+    const void *jpeg_data;
+    size_t jpeg_data_size;
+    /* For progressive reading. Mapped I/O objects are passed to the decoder as a whole without the buffer. */
     unsigned char *buffer;
     size_t buffer_size;
+    size_t buffer_data_size;
+    bool mapped;
 };
 
 static sail_status_t alloc_jpegxl_state(struct sail_io *io,
@@ -76,9 +103,8 @@ static sail_status_t alloc_jpegxl_state(struct sail_io *io,
     };
 
     /* buffer */
-    const size_t buffer_size = 8192;
     void *buffer;
-    SAIL_TRY_OR_CLEANUP(sail_malloc(buffer_size, &buffer),
+    SAIL_TRY_OR_CLEANUP(sail_malloc(BUFFER_SIZE, &buffer),
                         /* on error */ sail_free(memory_manager));
 
     /* jpegxl_state */
@@ -97,10 +123,22 @@ static sail_status_t alloc_jpegxl_state(struct sail_io *io,
         .frame_header_seen = false,
         .basic_info        = NULL,
         .memory_manager    = memory_manager,
-        .runner            = NULL,
+        .max_threads       = UINT_MAX,
         .decoder           = NULL,
+        .scale_denominator = 1,
+        .passes            = false,
+        .frame_buffer      = NULL,
+        .encoder           = NULL,
+        .frame_settings    = NULL,
+        .lossless          = false,
+        .frame_saved       = false,
+        .frame_added       = false,
+        .jpeg_data         = NULL,
+        .jpeg_data_size    = 0,
         .buffer            = buffer,
-        .buffer_size       = buffer_size,
+        .buffer_size       = BUFFER_SIZE,
+        .buffer_data_size  = 0,
+        .mapped            = false,
     };
 
     return SAIL_OK;
@@ -117,14 +155,85 @@ static void destroy_jpegxl_state(struct jpegxl_state *jpegxl_state) {
     sail_free(jpegxl_state->basic_info);
     sail_free(jpegxl_state->memory_manager);
 
-    JxlResizableParallelRunnerDestroy(jpegxl_state->runner);
-    JxlDecoderCloseInput(jpegxl_state->decoder);
+    if (jpegxl_state->decoder != NULL) {
+        JxlDecoderCloseInput(jpegxl_state->decoder);
+    }
     JxlDecoderDestroy(jpegxl_state->decoder);
+    sail_free(jpegxl_state->frame_buffer);
+    JxlEncoderDestroy(jpegxl_state->encoder);
     sail_free(jpegxl_state->buffer);
 
     sail_free(jpegxl_state);
 }
 
+/* Sets up a new or reset decoder to read the image from the I/O object. */
+static sail_status_t setup_decoder(struct jpegxl_state *jpegxl_state, struct sail_io *io) {
+
+    if (JxlDecoderSetCoalescing(jpegxl_state->decoder, JXL_TRUE) != JXL_DEC_SUCCESS) {
+        SAIL_LOG_ERROR("JPEGXL: Failed to set coalescing");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Every 8x8 block of the DC image is a pixel of a 1/8 image, so thumbnails stop at the DC pass. */
+    if (jpegxl_state->load_options->scale_denominator >= 8) {
+        jpegxl_state->scale_denominator = 8;
+    }
+
+    /* Refine frames pass by pass. */
+    jpegxl_state->passes = jpegxl_state->load_options->pass_callback != NULL
+                            && jpegxl_state->load_options->row_callback == NULL
+                            && !sail_roi_is_set(&jpegxl_state->load_options->roi)
+                            && jpegxl_state->scale_denominator == 1;
+
+    /* Probing needs neither meta data boxes nor ICC profiles. */
+    int events = (jpegxl_state->load_options->options & SAIL_OPTION_PROBE)
+                    ? JXL_DEC_BASIC_INFO | JXL_DEC_FRAME | JXL_DEC_FULL_IMAGE
+                    : JXL_DEC_BASIC_INFO | JXL_DEC_BOX | JXL_DEC_COLOR_ENCODING | JXL_DEC_FRAME | JXL_DEC_FULL_IMAGE;
+
+    if (!(jpegxl_state->load_options->options & SAIL_OPTION_PROBE) && (jpegxl_state->scale_denominator > 1 || jpegxl_state->passes)) {
+        if (JxlDecoderSetProgressiveDetail(jpegxl_state->decoder, jpegxl_state->passes ? kPasses : kDC) != JXL_DEC_SUCCESS) {
+            SAIL_LOG_ERROR("JPEGXL: Failed to set progressive detail");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        events |= JXL_DEC_FRAME_PROGRESSION;
+    }
+
+    if (JxlDecoderSubscribeEvents(jpegxl_state->decoder, events) != JXL_DEC_SUCCESS) {
+        SAIL_LOG_ERROR("JPEGXL: Failed to subscribe to decoder events");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if (JxlDecoderSetParallelRunner(jpegxl_state->decoder,
+                                    jpegxl_private_thread_pool_runner,
+                                    &jpegxl_state->max_threads) != JXL_DEC_SUCCESS) {
+        SAIL_LOG_ERROR("JPEGXL: Failed to set parallel runner");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Memory and mmap'ed I/O objects are passed to the decoder in place at once. */
+    if ((io->features & SAIL_IO_FEATURE_MAPPED) && io->map != NULL) {
+        const void *data;
+        size_t data_size;
+
+        if (io->map(io->stream, &data, &data_size) == SAIL_OK) {
+            if (JxlDecoderSetInput(jpegxl_state->decoder, data, data_size) != JXL_DEC_SUCCESS) {
+                SAIL_LOG_ERROR("JPEGXL: Failed to set input buffer");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+
+            JxlDecoderCloseInput(jpegxl_state->decoder);
+            jpegxl_state->mapped = true;
+
+            sail_free(jpegxl_state->buffer);
+            jpegxl_state->buffer      = NULL;
+            jpegxl_state->buffer_size = 0;
+        }
+    }
+
+    return SAIL_OK;
+}
+
 /*
  * Decoding functions.
  */
@@ -138,31 +247,49 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_jpegxl(struct sail_io *io, con
     SAIL_TRY(alloc_jpegxl_state(io, load_options, NULL, &jpegxl_state));
     *state = jpegxl_state;
 
+    /* Handle tuning. */
+    if (jpegxl_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(jpegxl_state->load_options->tuning, jpegxl_private_tuning_key_value_callback, &jpegxl_state->max_threads);
+    }
+
     /* Init decoder. */
-    jpegxl_state->runner  = JxlResizableParallelRunnerCreate(jpegxl_state->memory_manager);
     jpegxl_state->decoder = JxlDecoderCreate(jpegxl_state->memory_manager);
 
-    if (JxlDecoderSetCoalescing(jpegxl_state->decoder, JXL_TRUE) != JXL_DEC_SUCCESS) {
-        SAIL_LOG_ERROR("JPEGXL: Failed to set coalescing");
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-    }
+    SAIL_TRY(setup_decoder(jpegxl_state, io));
 
-    if (JxlDecoderSubscribeEvents(jpegxl_state->decoder, JXL_DEC_BASIC_INFO
-                                                            | JXL_DEC_BOX
-                                                            | JXL_DEC_COLOR_ENCODING
-                                                            | JXL_DEC_FRAME
-                                                            | JXL_DEC_FULL_IMAGE) != JXL_DEC_SUCCESS) {
-        SAIL_LOG_ERROR("JPEGXL: Failed to subscribe to decoder events");
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-    }
+    return SAIL_OK;
+}
 
-    if (JxlDecoderSetParallelRunner(jpegxl_state->decoder,
-                                    JxlResizableParallelRunner,
-                                    jpegxl_state->runner) != JXL_DEC_SUCCESS) {
-        SAIL_LOG_ERROR("JPEGXL: Failed to set parallel runner");
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+SAIL_EXPORT sail_status_t sail_codec_load_reset_v8_jpegxl(void *state, struct sail_io *io) {
+
+    struct jpegxl_state *jpegxl_state = state;
+
+    /* Keep the decoder and its memory, and forget the previous image. */
+    JxlDecoderReset(jpegxl_state->decoder);
+
+    sail_destroy_source_image(jpegxl_state->source_image);
+    sail_free(jpegxl_state->basic_info);
+    sail_free(jpegxl_state->frame_buffer);
+
+    jpegxl_state->io                = io;
+    jpegxl_state->source_image      = NULL;
+    jpegxl_state->libjxl_success    = false;
+    jpegxl_state->frame_header_seen = false;
+    jpegxl_state->basic_info        = NULL;
+    jpegxl_state->frame_buffer      = NULL;
+    jpegxl_state->buffer_data_size  = 0;
+    jpegxl_state->mapped            = false;
+
+    /* The previous image could be mapped without the buffer. */
+    if (jpegxl_state->buffer == NULL) {
+        void *ptr;
+        SAIL_TRY(sail_malloc(BUFFER_SIZE, &ptr));
+        jpegxl_state->buffer      = ptr;
+        jpegxl_state->buffer_size = BUFFER_SIZE;
     }
 
+    SAIL_TRY(setup_decoder(jpegxl_state, io));
+
     return SAIL_OK;
 }
 
@@ -191,10 +318,17 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpegxl(void *state,
                 SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
             }
             case JXL_DEC_NEED_MORE_INPUT: {
+                if (jpegxl_state->mapped) {
+                    sail_destroy_image(image_local);
+                    SAIL_LOG_ERROR("JPEGXL: Unexpected end of data");
+                    SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+                }
+
                 SAIL_TRY_OR_CLEANUP(jpegxl_private_read_more_data(jpegxl_state->io,
                                                                      jpegxl_state->decoder,
-                                                                     jpegxl_state->buffer,
-                                                                     jpegxl_state->buffer_size),
+                                                                     &jpegxl_state->buffer,
+                                                                     &jpegxl_state->buffer_size,
+                                                                     &jpegxl_state->buffer_data_size),
                                     /* cleanup */ sail_destroy_image(image_local));
                 break;
             }
@@ -210,9 +344,11 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpegxl(void *state,
                     SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
                 }
 
-                /* Source image. */
+                /* Source image. It's kept in the state and outlives the frame arena. */
+                struct sail_arena *arena = sail_set_thread_arena(NULL);
+
                 SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&jpegxl_state->source_image),
-                                    /* cleanup */ sail_destroy_image(image_local));
+                                    /* cleanup */ sail_set_thread_arena(arena), sail_destroy_image(image_local));
 
                 if (jpegxl_private_is_cmyk(jpegxl_state->decoder, jpegxl_state->basic_info->num_extra_channels)) {
                     jpegxl_state->source_image->pixel_format =
@@ -231,14 +367,16 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpegxl(void *state,
                 if (jpegxl_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
                     if (jpegxl_state->load_options->options & SAIL_OPTION_META_DATA) {
                         SAIL_TRY_OR_CLEANUP(sail_alloc_hash_map(&jpegxl_state->source_image->special_properties),
-                                            /* cleanup */ sail_destroy_image(image_local));
+                                            /* cleanup */ sail_set_thread_arena(arena), sail_destroy_image(image_local));
                         SAIL_TRY_OR_CLEANUP(jpegxl_private_fetch_special_properties(
                                                 jpegxl_state->basic_info,
                                                 jpegxl_state->source_image->special_properties),
-                                            /* cleanup*/ sail_destroy_image(image_local));
+                                            /* cleanup*/ sail_set_thread_arena(arena), sail_destroy_image(image_local));
                     }
                 }
 
+                sail_set_thread_arena(arena);
+
                 SAIL_LOG_TRACE("JPEGXL: Animation(%s)", jpegxl_state->basic_info->have_animation ? "yes" : "no");
 
                 if (jpegxl_state->basic_info->have_animation) {
@@ -246,10 +384,6 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpegxl(void *state,
                         jpegxl_state->basic_info->animation.tps_numerator, jpegxl_state->basic_info->animation.tps_denominator,
                         jpegxl_state->basic_info->animation.num_loops);
                 }
-
-                JxlResizableParallelRunnerSetThreads(
-                        jpegxl_state->runner,
-                        JxlResizableParallelRunnerSuggestThreads(jpegxl_state->basic_info->xsize, jpegxl_state->basic_info->ysize));
                 break;
             }
             case JXL_DEC_FRAME: {
@@ -276,9 +410,27 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_jpegxl(void *state,
                     }
                 }
 
-                image_local->width          = jpegxl_state->basic_info->xsize;
-                image_local->height         = jpegxl_state->basic_info->ysize;
+                image_local->width          = (jpegxl_state->basic_info->xsize + jpegxl_state->scale_denominator - 1) / jpegxl_state->scale_denominator;
+                image_local->height         = (jpegxl_state->basic_info->ysize + jpegxl_state->scale_denominator - 1) / jpegxl_state->scale_denominator;
                 image_local->pixel_format   = jpegxl_private_source_pixel_format_to_output(jpegxl_state->source_image->pixel_format);
+
+                /* Decode HDR samples into the requested floating point pixel format without clamping them. */
+                {
+                    const enum SailPixelFormat output_pixel_format = jpegxl_state->load_options->output_pixel_format;
+
+                    const bool float_output = output_pixel_format == SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF
+                                                || output_pixel_format == SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT
+                                                || (output_pixel_format == SAIL_PIXEL_FORMAT_BPP48_RGB_HALF
+                                                    && jpegxl_state->basic_info->alpha_bits == 0);
+
+                    if (float_output
+                            && jpegxl_state->basic_info->num_color_channels == 3
+                            && !jpegxl_private_is_cmyk(jpegxl_state->decoder, jpegxl_state->basic_info->num_extra_channels)
+                            && jpegxl_state->scale_denominator == 1) {
+                        image_local->pixel_format = output_pixel_format;
+                    }
+                }
+
                 image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
                 if (jpegxl_state->basic_info->have_animation) {
@@ -336,11 +488,19 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_jpegxl(void *state, struct sa
         .align        = 0
     };
 
+    /* Scaled frames are decoded at the full size, and downscaled afterwards. */
+    const bool scaled = jpegxl_state->scale_denominator > 1;
+    const unsigned frame_bytes_per_line = sail_bytes_per_line(jpegxl_state->basic_info->xsize, image->pixel_format);
+
+    if (scaled && jpegxl_state->frame_buffer == NULL) {
+        SAIL_TRY(sail_malloc((size_t)frame_bytes_per_line * jpegxl_state->basic_info->ysize, &jpegxl_state->frame_buffer));
+    }
+
     JxlDecoderStatus status = JxlDecoderSetImageOutBuffer(
             jpegxl_state->decoder,
             &format,
-            image->pixels,
-            image->bytes_per_line * image->height);
+            scaled ? jpegxl_state->frame_buffer : image->pixels,
+            scaled ? (size_t)frame_bytes_per_line * jpegxl_state->basic_info->ysize : (size_t)image->bytes_per_line * image->height);
 
     if (status != JXL_DEC_SUCCESS) {
         SAIL_LOG_ERROR("JPEGXL: Failed to set output buffer. Error: %u", status);
@@ -350,6 +510,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_jpegxl(void *state, struct sa
     jpegxl_state->frame_header_seen = false;
 
     struct sail_meta_data_node **last_meta_data_node = &image->meta_data_node;
+    unsigned pass = 1;
 
     for (status = JxlDecoderProcessInput(jpegxl_state->decoder);
             !jpegxl_state->frame_header_seen && !jpegxl_state->libjxl_success;
@@ -360,13 +521,62 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_jpegxl(void *state, struct sa
                 SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
             }
             case JXL_DEC_NEED_MORE_INPUT: {
+                if (jpegxl_state->mapped) {
+                    SAIL_LOG_ERROR("JPEGXL: Unexpected end of data");
+                    SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+                }
+
                 SAIL_TRY(jpegxl_private_read_more_data(jpegxl_state->io,
                                                         jpegxl_state->decoder,
-                                                        jpegxl_state->buffer,
-                                                        jpegxl_state->buffer_size));
+                                                        &jpegxl_state->buffer,
+                                                        &jpegxl_state->buffer_size,
+                                                        &jpegxl_state->buffer_data_size));
+                break;
+            }
+            case JXL_DEC_FRAME_PROGRESSION: {
+                if (JxlDecoderFlushImage(jpegxl_state->decoder) != JXL_DEC_SUCCESS) {
+                    SAIL_LOG_ERROR("JPEGXL: Failed to flush image");
+                    SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+                }
+
+                bool stop = scaled;
+
+                if (scaled) {
+                    SAIL_LOG_TRACE("JPEGXL: Stopped at the DC pass");
+                    jpegxl_private_downscale(jpegxl_state->frame_buffer,
+                                             jpegxl_state->basic_info->xsize, jpegxl_state->basic_info->ysize, frame_bytes_per_line,
+                                             jpegxl_state->scale_denominator, image);
+                } else {
+                    SAIL_TRY(jpegxl_state->load_options->pass_callback(image, pass, &stop, jpegxl_state->load_options->pass_callback_user_data));
+
+                    if (stop) {
+                        SAIL_LOG_TRACE("JPEGXL: Stopped at pass #%u", pass);
+                    }
+
+                    pass++;
+                }
+
+                if (stop) {
+                    /* Still images end here, so the rest of the file is not even read. */
+                    if (!jpegxl_state->basic_info->have_animation) {
+                        jpegxl_state->libjxl_success = true;
+                        return SAIL_OK;
+                    }
+
+                    if (JxlDecoderSkipCurrentFrame(jpegxl_state->decoder) != JXL_DEC_SUCCESS) {
+                        SAIL_LOG_ERROR("JPEGXL: Failed to skip frame");
+                        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+                    }
+                }
                 break;
             }
             case JXL_DEC_FULL_IMAGE: {
+                /* Frames without a DC pass, like lossless ones, are decoded completely. */
+                if (scaled) {
+                    jpegxl_private_downscale(jpegxl_state->frame_buffer,
+                                             jpegxl_state->basic_info->xsize, jpegxl_state->basic_info->ysize, frame_bytes_per_line,
+                                             jpegxl_state->scale_denominator, image);
+                }
                 break;
             }
             case JXL_DEC_FRAME: {
@@ -414,32 +624,213 @@ SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_jpegxl(void **state) {
 
 SAIL_EXPORT sail_status_t sail_codec_save_init_v8_jpegxl(struct sail_io *io, const struct sail_save_options *save_options, void **state) {
 
-    (void)io;
-    (void)save_options;
-    (void)state;
+    *state = NULL;
+
+    /* Allocate a new state. */
+    struct jpegxl_state *jpegxl_state;
+    SAIL_TRY(alloc_jpegxl_state(io, NULL, save_options, &jpegxl_state));
+    *state = jpegxl_state;
+
+    if (jpegxl_state->save_options->compression != SAIL_COMPRESSION_JPEG_XL) {
+        SAIL_LOG_ERROR("JPEGXL: Only JPEG XL compression is allowed for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    /* Handle tuning. */
+    struct jpegxl_private_save_tuning save_tuning = {
+        .threads        = UINT_MAX,
+        .effort         = -1,
+        .jpeg_data      = NULL,
+        .jpeg_data_size = 0,
+    };
+
+    if (jpegxl_state->save_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(jpegxl_state->save_options->tuning, jpegxl_private_save_tuning_key_value_callback, &save_tuning);
+    }
+
+    jpegxl_state->max_threads    = save_tuning.threads;
+    jpegxl_state->jpeg_data      = save_tuning.jpeg_data;
+    jpegxl_state->jpeg_data_size = save_tuning.jpeg_data_size;
+
+    /* Init encoder. */
+    jpegxl_state->encoder = JxlEncoderCreate(jpegxl_state->memory_manager);
+
+    if (jpegxl_state->encoder == NULL) {
+        SAIL_LOG_ERROR("JPEGXL: Failed to create an encoder");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    if (JxlEncoderSetParallelRunner(jpegxl_state->encoder,
+                                    jpegxl_private_thread_pool_runner,
+                                    &jpegxl_state->max_threads) != JXL_ENC_SUCCESS) {
+        SAIL_LOG_ERROR("JPEGXL: Failed to set parallel runner");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    jpegxl_state->frame_settings = JxlEncoderFrameSettingsCreate(jpegxl_state->encoder, NULL);
+
+    if (jpegxl_state->frame_settings == NULL) {
+        SAIL_LOG_ERROR("JPEGXL: Failed to create frame settings");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    if (save_tuning.effort > 0) {
+        if (JxlEncoderFrameSettingsSetOption(jpegxl_state->frame_settings,
+                                             JXL_ENC_FRAME_SETTING_EFFORT,
+                                             save_tuning.effort) != JXL_ENC_SUCCESS) {
+            SAIL_LOG_ERROR("JPEGXL: Failed to set effort");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    }
+
+    /* The JPEG bitstream is recompressed as is, so the distance doesn't apply. */
+    if (jpegxl_state->jpeg_data != NULL) {
+        return SAIL_OK;
+    }
+
+    /* Compute the distance. */
+    const double compression = (jpegxl_state->save_options->compression_level < COMPRESSION_MIN ||
+                                jpegxl_state->save_options->compression_level > COMPRESSION_MAX)
+                                ? COMPRESSION_DEFAULT
+                                : jpegxl_state->save_options->compression_level;
+
+    jpegxl_state->lossless = compression == 0;
+
+    if (jpegxl_state->lossless) {
+        if (JxlEncoderSetFrameLossless(jpegxl_state->frame_settings, JXL_TRUE) != JXL_ENC_SUCCESS) {
+            SAIL_LOG_ERROR("JPEGXL: Failed to enable lossless mode");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    } else if (JxlEncoderSetFrameDistance(jpegxl_state->frame_settings, (float)compression) != JXL_ENC_SUCCESS) {
+        SAIL_LOG_ERROR("JPEGXL: Failed to set distance %.1f", compression);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_jpegxl(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct jpegxl_state *jpegxl_state = state;
+
+    if (jpegxl_state->frame_saved) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    jpegxl_state->frame_saved = true;
+
+    const unsigned num_channels = jpegxl_private_pixel_format_to_num_channels(image->pixel_format);
+
+    if (jpegxl_state->jpeg_data == NULL && num_channels == 0) {
+        SAIL_LOG_ERROR("JPEGXL: %s pixel format is not currently supported for saving", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    /* Basic info, the color encoding and the reconstruction data are taken from the JPEG bitstream. */
+    if (jpegxl_state->jpeg_data != NULL) {
+        if (JxlEncoderStoreJPEGMetadata(jpegxl_state->encoder, JXL_TRUE) != JXL_ENC_SUCCESS) {
+            SAIL_LOG_ERROR("JPEGXL: Failed to store JPEG reconstruction data");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        return SAIL_OK;
+    }
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    const JxlDataType data_type = jpegxl_private_pixel_format_to_jxl_data_type(image->pixel_format);
+    const bool is_gray = num_channels <= 2;
+    const bool has_alpha = num_channels == 2 || num_channels == 4;
+
+    JxlBasicInfo basic_info;
+    JxlEncoderInitBasicInfo(&basic_info);
+
+    basic_info.xsize                 = image->width;
+    basic_info.ysize                 = image->height;
+    basic_info.bits_per_sample       = (data_type == JXL_TYPE_FLOAT) ? 32 : ((data_type == JXL_TYPE_UINT16 || data_type == JXL_TYPE_FLOAT16) ? 16 : 8);
+    basic_info.exponent_bits_per_sample = (data_type == JXL_TYPE_FLOAT) ? 8 : ((data_type == JXL_TYPE_FLOAT16) ? 5 : 0);
+    basic_info.num_color_channels    = is_gray ? 1 : 3;
+    basic_info.num_extra_channels    = has_alpha ? 1 : 0;
+    basic_info.alpha_bits            = has_alpha ? basic_info.bits_per_sample : 0;
+    basic_info.alpha_exponent_bits   = has_alpha ? basic_info.exponent_bits_per_sample : 0;
+    basic_info.uses_original_profile = jpegxl_state->lossless ? JXL_TRUE : JXL_FALSE;
+
+    if (JxlEncoderSetBasicInfo(jpegxl_state->encoder, &basic_info) != JXL_ENC_SUCCESS) {
+        SAIL_LOG_ERROR("JPEGXL: Failed to set basic info");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if (jpegxl_state->save_options->options & SAIL_OPTION_ICCP && image->iccp != NULL) {
+        SAIL_LOG_TRACE("JPEGXL: ICC profile has been set");
+
+        if (JxlEncoderSetICCProfile(jpegxl_state->encoder, image->iccp->data, image->iccp->size) != JXL_ENC_SUCCESS) {
+            SAIL_LOG_ERROR("JPEGXL: Failed to set ICC profile");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    } else {
+        JxlColorEncoding color_encoding;
+        JxlColorEncodingSetToSRGB(&color_encoding, is_gray ? JXL_TRUE : JXL_FALSE);
+
+        if (JxlEncoderSetColorEncoding(jpegxl_state->encoder, &color_encoding) != JXL_ENC_SUCCESS) {
+            SAIL_LOG_ERROR("JPEGXL: Failed to set color encoding");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    }
+
+    if (jpegxl_state->save_options->options & SAIL_OPTION_META_DATA && image->meta_data_node != NULL) {
+        SAIL_TRY(jpegxl_private_write_meta_data(jpegxl_state->encoder, image->meta_data_node));
+    }
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_jpegxl(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct jpegxl_state *jpegxl_state = state;
+
+    if (jpegxl_state->jpeg_data != NULL) {
+        if (JxlEncoderAddJPEGFrame(jpegxl_state->frame_settings,
+                                   jpegxl_state->jpeg_data,
+                                   jpegxl_state->jpeg_data_size) != JXL_ENC_SUCCESS) {
+            SAIL_LOG_ERROR("JPEGXL: Failed to recompress JPEG data");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    } else {
+        const JxlPixelFormat format = {
+            .num_channels = jpegxl_private_pixel_format_to_num_channels(image->pixel_format),
+            .data_type    = jpegxl_private_pixel_format_to_jxl_data_type(image->pixel_format),
+            .endianness   = JXL_NATIVE_ENDIAN,
+            .align        = image->bytes_per_line,
+        };
+
+        if (JxlEncoderAddImageFrame(jpegxl_state->frame_settings,
+                                    &format,
+                                    image->pixels,
+                                    (size_t)image->bytes_per_line * image->height) != JXL_ENC_SUCCESS) {
+            SAIL_LOG_ERROR("JPEGXL: Failed to add frame");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    }
+
+    JxlEncoderCloseInput(jpegxl_state->encoder);
+    jpegxl_state->frame_added = true;
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_jpegxl(void **state) {
 
-    (void)state;
+    struct jpegxl_state *jpegxl_state = *state;
+
+    *state = NULL;
+
+    if (jpegxl_state->frame_added) {
+        SAIL_TRY_OR_CLEANUP(jpegxl_private_write_output(jpegxl_state->io,
+                                                        jpegxl_state->encoder,
+                                                        jpegxl_state->buffer,
+                                                        jpegxl_state->buffer_size),
+                            /* cleanup */ destroy_jpegxl_state(jpegxl_state));
+    }
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    destroy_jpegxl_state(jpegxl_state);
+
+    return SAIL_OK;
 }
@@ -0,0 +1,410 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "helpers.h"
+
+static const unsigned char KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+/* VkFormat values of the supported pixel formats. */
+enum VkFormat {
+    VK_FORMAT_R8_UNORM              = 9,
+    VK_FORMAT_R8_SRGB               = 15,
+    VK_FORMAT_R8G8B8_UNORM          = 23,
+    VK_FORMAT_R8G8B8_SRGB           = 29,
+    VK_FORMAT_B8G8R8_UNORM          = 30,
+    VK_FORMAT_B8G8R8_SRGB           = 36,
+    VK_FORMAT_R8G8B8A8_UNORM        = 37,
+    VK_FORMAT_R8G8B8A8_SRGB         = 43,
+    VK_FORMAT_B8G8R8A8_UNORM        = 44,
+    VK_FORMAT_B8G8R8A8_SRGB         = 50,
+    VK_FORMAT_R16G16B16A16_UNORM    = 91,
+    VK_FORMAT_BC1_RGB_UNORM_BLOCK   = 131,
+    VK_FORMAT_BC1_RGB_SRGB_BLOCK    = 132,
+    VK_FORMAT_BC1_RGBA_UNORM_BLOCK  = 133,
+    VK_FORMAT_BC1_RGBA_SRGB_BLOCK   = 134,
+    VK_FORMAT_BC2_UNORM_BLOCK       = 135,
+    VK_FORMAT_BC2_SRGB_BLOCK        = 136,
+    VK_FORMAT_BC3_UNORM_BLOCK       = 137,
+    VK_FORMAT_BC3_SRGB_BLOCK        = 138,
+    VK_FORMAT_BC4_UNORM_BLOCK       = 139,
+    VK_FORMAT_BC5_UNORM_BLOCK       = 141,
+    VK_FORMAT_BC7_UNORM_BLOCK       = 145,
+    VK_FORMAT_BC7_SRGB_BLOCK        = 146,
+};
+
+/* Data format descriptor constants, see the Khronos Data Format Specification. */
+#define KHR_DF_VERSION                  2
+#define KHR_DF_BASIC_BLOCK_HEADER_SIZE  24
+#define KHR_DF_SAMPLE_SIZE              16
+
+#define KHR_DF_MODEL_RGBSDA             1
+#define KHR_DF_MODEL_BC1A               128
+#define KHR_DF_MODEL_BC2                129
+#define KHR_DF_MODEL_BC3                130
+#define KHR_DF_MODEL_BC4                131
+#define KHR_DF_MODEL_BC5                132
+#define KHR_DF_MODEL_BC7                134
+
+#define KHR_DF_PRIMARIES_BT709          1
+#define KHR_DF_TRANSFER_LINEAR          1
+
+#define KHR_DF_CHANNEL_RED              0
+#define KHR_DF_CHANNEL_GREEN            1
+#define KHR_DF_CHANNEL_BLUE             2
+#define KHR_DF_CHANNEL_ALPHA            15
+#define KHR_DF_CHANNEL_BC_DATA          0
+#define KHR_DF_CHANNEL_BC1A_ALPHAPRESENT 1
+
+#define KHR_DF_MAX_SAMPLES 4
+
+struct ktx2_sample {
+    unsigned bit_offset;
+    unsigned bit_length;
+    unsigned channel;
+};
+
+/* Describes the pixel format in terms of the basic data format descriptor. */
+struct ktx2_format_description {
+    uint32_t vk_format;
+    unsigned type_size;
+    unsigned color_model;
+    unsigned bytes_per_block;
+    unsigned samples_count;
+    struct ktx2_sample samples[KHR_DF_MAX_SAMPLES];
+};
+
+static uint32_t read_le32(const unsigned char *bytes) {
+
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+static uint64_t read_le64(const unsigned char *bytes) {
+
+    return (uint64_t)read_le32(bytes) | (uint64_t)read_le32(bytes + 4) << 32;
+}
+
+static void write_le16(unsigned char *bytes, uint16_t v) {
+
+    bytes[0] = (unsigned char)v;
+    bytes[1] = (unsigned char)(v >> 8);
+}
+
+static void write_le32(unsigned char *bytes, uint32_t v) {
+
+    bytes[0] = (unsigned char)v;
+    bytes[1] = (unsigned char)(v >> 8);
+    bytes[2] = (unsigned char)(v >> 16);
+    bytes[3] = (unsigned char)(v >> 24);
+}
+
+static void write_le64(unsigned char *bytes, uint64_t v) {
+
+    write_le32(bytes,     (uint32_t)v);
+    write_le32(bytes + 4, (uint32_t)(v >> 32));
+}
+
+static bool format_description(enum SailPixelFormat pixel_format, struct ktx2_format_description *description) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_R8_UNORM, 1, KHR_DF_MODEL_RGBSDA, 1, 1,
+                { { 0, 8, KHR_DF_CHANNEL_RED } } };
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_RGB: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_R8G8B8_UNORM, 1, KHR_DF_MODEL_RGBSDA, 3, 3,
+                { { 0, 8, KHR_DF_CHANNEL_RED }, { 8, 8, KHR_DF_CHANNEL_GREEN }, { 16, 8, KHR_DF_CHANNEL_BLUE } } };
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_BGR: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_B8G8R8_UNORM, 1, KHR_DF_MODEL_RGBSDA, 3, 3,
+                { { 0, 8, KHR_DF_CHANNEL_BLUE }, { 8, 8, KHR_DF_CHANNEL_GREEN }, { 16, 8, KHR_DF_CHANNEL_RED } } };
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_R8G8B8A8_UNORM, 1, KHR_DF_MODEL_RGBSDA, 4, 4,
+                { { 0, 8, KHR_DF_CHANNEL_RED }, { 8, 8, KHR_DF_CHANNEL_GREEN }, { 16, 8, KHR_DF_CHANNEL_BLUE }, { 24, 8, KHR_DF_CHANNEL_ALPHA } } };
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_B8G8R8A8_UNORM, 1, KHR_DF_MODEL_RGBSDA, 4, 4,
+                { { 0, 8, KHR_DF_CHANNEL_BLUE }, { 8, 8, KHR_DF_CHANNEL_GREEN }, { 16, 8, KHR_DF_CHANNEL_RED }, { 24, 8, KHR_DF_CHANNEL_ALPHA } } };
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_R16G16B16A16_UNORM, 2, KHR_DF_MODEL_RGBSDA, 8, 4,
+                { { 0, 16, KHR_DF_CHANNEL_RED }, { 16, 16, KHR_DF_CHANNEL_GREEN }, { 32, 16, KHR_DF_CHANNEL_BLUE }, { 48, 16, KHR_DF_CHANNEL_ALPHA } } };
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP4_BC1: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 1, KHR_DF_MODEL_BC1A, 8, 1,
+                { { 0, 64, KHR_DF_CHANNEL_BC1A_ALPHAPRESENT } } };
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP8_BC2: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_BC2_UNORM_BLOCK, 1, KHR_DF_MODEL_BC2, 16, 2,
+                { { 0, 64, KHR_DF_CHANNEL_ALPHA }, { 64, 64, KHR_DF_CHANNEL_BC_DATA } } };
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP8_BC3: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_BC3_UNORM_BLOCK, 1, KHR_DF_MODEL_BC3, 16, 2,
+                { { 0, 64, KHR_DF_CHANNEL_ALPHA }, { 64, 64, KHR_DF_CHANNEL_BC_DATA } } };
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP4_BC4: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_BC4_UNORM_BLOCK, 1, KHR_DF_MODEL_BC4, 8, 1,
+                { { 0, 64, KHR_DF_CHANNEL_BC_DATA } } };
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP8_BC5: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_BC5_UNORM_BLOCK, 1, KHR_DF_MODEL_BC5, 16, 2,
+                { { 0, 64, KHR_DF_CHANNEL_RED }, { 64, 64, KHR_DF_CHANNEL_GREEN } } };
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP8_BC7: {
+            *description = (struct ktx2_format_description) { VK_FORMAT_BC7_UNORM_BLOCK, 1, KHR_DF_MODEL_BC7, 16, 1,
+                { { 0, 128, KHR_DF_CHANNEL_BC_DATA } } };
+            return true;
+        }
+
+        default: {
+            return false;
+        }
+    }
+}
+
+static size_t dfd_size(const struct ktx2_format_description *description) {
+
+    return 4 + KHR_DF_BASIC_BLOCK_HEADER_SIZE + (size_t)description->samples_count * KHR_DF_SAMPLE_SIZE;
+}
+
+/* Writes dfdTotalSize followed by the basic descriptor block. */
+static void write_dfd(unsigned char *bytes, const struct ktx2_format_description *description, bool block_compressed) {
+
+    const size_t size = dfd_size(description);
+
+    memset(bytes, 0, size);
+
+    write_le32(bytes, (uint32_t)size);
+
+    unsigned char *block = bytes + 4;
+
+    /* Khronos vendor and the basic descriptor type are both 0. */
+    write_le16(block + 4, KHR_DF_VERSION);
+    write_le16(block + 6, (uint16_t)(size - 4));
+    block[8]  = (unsigned char)description->color_model;
+    block[9]  = KHR_DF_PRIMARIES_BT709;
+    block[10] = KHR_DF_TRANSFER_LINEAR;
+    /* Texel block dimensions minus 1. */
+    block[12] = block_compressed ? 3 : 0;
+    block[13] = block_compressed ? 3 : 0;
+    block[16] = (unsigned char)description->bytes_per_block;
+
+    for (unsigned i = 0; i < description->samples_count; i++) {
+        const struct ktx2_sample *sample = &description->samples[i];
+        unsigned char *ptr = block + KHR_DF_BASIC_BLOCK_HEADER_SIZE + i * KHR_DF_SAMPLE_SIZE;
+
+        write_le16(ptr, (uint16_t)sample->bit_offset);
+        ptr[2] = (unsigned char)(sample->bit_length - 1);
+        ptr[3] = (unsigned char)sample->channel;
+        write_le32(ptr + 12, (sample->bit_length >= 32) ? UINT32_MAX : (UINT32_C(1) << sample->bit_length) - 1);
+    }
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t ktx2_private_read_header(struct sail_io *io, struct ktx2_private_header *header) {
+
+    unsigned char bytes[KTX2_HEADER_SIZE];
+    SAIL_TRY(io->strict_read(io->stream, bytes, sizeof(bytes)));
+
+    if (memcmp(bytes, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) {
+        SAIL_LOG_ERROR("KTX2: Invalid identifier");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    const unsigned char *ptr = bytes + sizeof(KTX2_IDENTIFIER);
+
+    *header = (struct ktx2_private_header) {
+        .vk_format               = read_le32(ptr),
+        .type_size               = read_le32(ptr + 4),
+        .pixel_width             = read_le32(ptr + 8),
+        .pixel_height            = read_le32(ptr + 12),
+        .pixel_depth             = read_le32(ptr + 16),
+        .layer_count             = read_le32(ptr + 20),
+        .face_count              = read_le32(ptr + 24),
+        .level_count             = read_le32(ptr + 28),
+        .supercompression_scheme = read_le32(ptr + 32),
+    };
+
+    /* Level count 0 requests generating mip levels at load time, but the file still has the base level. */
+    if (header->level_count == 0) {
+        header->level_count = 1;
+    }
+
+    if (header->level_count > KTX2_MAX_LEVELS) {
+        SAIL_LOG_ERROR("KTX2: Level count %u is invalid", header->level_count);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t ktx2_private_read_level_index(struct sail_io *io, struct ktx2_private_level *levels, unsigned level_count) {
+
+    for (unsigned i = 0; i < level_count; i++) {
+        unsigned char bytes[KTX2_LEVEL_INDEX_SIZE];
+        SAIL_TRY(io->strict_read(io->stream, bytes, sizeof(bytes)));
+
+        levels[i].offset = read_le64(bytes);
+        levels[i].length = read_le64(bytes + 8);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t ktx2_private_write_header(struct sail_io *io, enum SailPixelFormat pixel_format, unsigned width, unsigned height,
+                                        const struct ktx2_private_level *levels, unsigned level_count) {
+
+    struct ktx2_format_description description;
+
+    if (!format_description(pixel_format, &description)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    const size_t size = ktx2_private_header_size(pixel_format, level_count);
+    const size_t dfd_offset = KTX2_HEADER_SIZE + (size_t)level_count * KTX2_LEVEL_INDEX_SIZE;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(size, &ptr));
+    unsigned char *bytes = ptr;
+
+    memset(bytes, 0, size);
+    memcpy(bytes, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+
+    unsigned char *header = bytes + sizeof(KTX2_IDENTIFIER);
+
+    write_le32(header,      description.vk_format);
+    write_le32(header + 4,  description.type_size);
+    write_le32(header + 8,  width);
+    write_le32(header + 12, height);
+    /* Depth 0, 1 face, and no supercompression. */
+    write_le32(header + 24, 1);
+    write_le32(header + 28, level_count);
+    write_le32(header + 36, (uint32_t)dfd_offset);
+    write_le32(header + 40, (uint32_t)dfd_size(&description));
+
+    for (unsigned i = 0; i < level_count; i++) {
+        unsigned char *level = bytes + KTX2_HEADER_SIZE + i * KTX2_LEVEL_INDEX_SIZE;
+
+        write_le64(level,      levels[i].offset);
+        write_le64(level + 8,  levels[i].length);
+        write_le64(level + 16, levels[i].length);
+    }
+
+    write_dfd(bytes + dfd_offset, &description, sail_is_block_compressed(pixel_format));
+
+    SAIL_TRY_OR_CLEANUP(io->strict_write(io->stream, bytes, size),
+                        /* cleanup */ sail_free(bytes));
+
+    sail_free(bytes);
+
+    return SAIL_OK;
+}
+
+size_t ktx2_private_header_size(enum SailPixelFormat pixel_format, unsigned level_count) {
+
+    struct ktx2_format_description description;
+
+    if (!format_description(pixel_format, &description)) {
+        return 0;
+    }
+
+    return KTX2_HEADER_SIZE + (size_t)level_count * KTX2_LEVEL_INDEX_SIZE + dfd_size(&description);
+}
+
+size_t ktx2_private_level_alignment(enum SailPixelFormat pixel_format) {
+
+    struct ktx2_format_description description;
+
+    if (!format_description(pixel_format, &description)) {
+        return 4;
+    }
+
+    switch (description.bytes_per_block) {
+        case 3:  return 12;
+        case 8:  return 8;
+        case 16: return 16;
+
+        default: return 4;
+    }
+}
+
+enum SailPixelFormat ktx2_private_sail_pixel_format(uint32_t vk_format) {
+
+    switch (vk_format) {
+        case VK_FORMAT_R8_UNORM:
+        case VK_FORMAT_R8_SRGB:             return SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
+        case VK_FORMAT_R8G8B8_UNORM:
+        case VK_FORMAT_R8G8B8_SRGB:         return SAIL_PIXEL_FORMAT_BPP24_RGB;
+        case VK_FORMAT_B8G8R8_UNORM:
+        case VK_FORMAT_B8G8R8_SRGB:         return SAIL_PIXEL_FORMAT_BPP24_BGR;
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:       return SAIL_PIXEL_FORMAT_BPP32_RGBA;
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:       return SAIL_PIXEL_FORMAT_BPP32_BGRA;
+        case VK_FORMAT_R16G16B16A16_UNORM:  return SAIL_PIXEL_FORMAT_BPP64_RGBA;
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK: return SAIL_PIXEL_FORMAT_BPP4_BC1;
+        case VK_FORMAT_BC2_UNORM_BLOCK:
+        case VK_FORMAT_BC2_SRGB_BLOCK:      return SAIL_PIXEL_FORMAT_BPP8_BC2;
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:      return SAIL_PIXEL_FORMAT_BPP8_BC3;
+        case VK_FORMAT_BC4_UNORM_BLOCK:     return SAIL_PIXEL_FORMAT_BPP4_BC4;
+        case VK_FORMAT_BC5_UNORM_BLOCK:     return SAIL_PIXEL_FORMAT_BPP8_BC5;
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:      return SAIL_PIXEL_FORMAT_BPP8_BC7;
+
+        default: return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+}
+
+bool ktx2_private_supported_pixel_format(enum SailPixelFormat pixel_format) {
+
+    struct ktx2_format_description description;
+
+    return format_description(pixel_format, &description);
+}
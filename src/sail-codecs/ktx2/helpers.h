@@ -0,0 +1,86 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_KTX2_HELPERS_H
+#define SAIL_KTX2_HELPERS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_io;
+
+/* 12 bytes of the identifier followed by the header and the index, and 24 bytes per level in the level index. */
+#define KTX2_HEADER_SIZE      80
+#define KTX2_LEVEL_INDEX_SIZE 24
+
+/* Mip chains of 32-bit dimensions never exceed 32 levels. */
+#define KTX2_MAX_LEVELS 32
+
+/* Fields of the header and the index used by the codec. */
+struct ktx2_private_header {
+    uint32_t vk_format;
+    uint32_t type_size;
+    uint32_t pixel_width;
+    uint32_t pixel_height;
+    uint32_t pixel_depth;
+    uint32_t layer_count;
+    uint32_t face_count;
+    uint32_t level_count;
+    uint32_t supercompression_scheme;
+};
+
+struct ktx2_private_level {
+    uint64_t offset;
+    uint64_t length;
+};
+
+/* Reads the identifier, the header, and the index. Level count 0 is returned as 1. */
+SAIL_HIDDEN sail_status_t ktx2_private_read_header(struct sail_io *io, struct ktx2_private_header *header);
+
+/* Reads the level index that follows the header. */
+SAIL_HIDDEN sail_status_t ktx2_private_read_level_index(struct sail_io *io, struct ktx2_private_level *levels, unsigned level_count);
+
+/* Writes the identifier, the header, the index, the level index, and the data format descriptor. */
+SAIL_HIDDEN sail_status_t ktx2_private_write_header(struct sail_io *io, enum SailPixelFormat pixel_format, unsigned width, unsigned height,
+                                                    const struct ktx2_private_level *levels, unsigned level_count);
+
+/* Returns the number of bytes written by ktx2_private_write_header(). */
+SAIL_HIDDEN size_t ktx2_private_header_size(enum SailPixelFormat pixel_format, unsigned level_count);
+
+/* Returns the alignment of mip levels in the file, the least common multiple of the texel block size and 4. */
+SAIL_HIDDEN size_t ktx2_private_level_alignment(enum SailPixelFormat pixel_format);
+
+/* Returns the pixel format of the VkFormat, or SAIL_PIXEL_FORMAT_UNKNOWN if it's not supported. */
+SAIL_HIDDEN enum SailPixelFormat ktx2_private_sail_pixel_format(uint32_t vk_format);
+
+/* Returns true if the pixel format can be written. */
+SAIL_HIDDEN bool ktx2_private_supported_pixel_format(enum SailPixelFormat pixel_format);
+
+#endif
@@ -0,0 +1,385 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "helpers.h"
+
+/*
+ * Codec-specific state.
+ */
+struct ktx2_state {
+    struct sail_io *io;
+    const struct sail_load_options *load_options;
+    const struct sail_save_options *save_options;
+
+    unsigned frame_number;
+
+    enum SailPixelFormat pixel_format;
+    unsigned width;
+    unsigned height;
+    unsigned level_count;
+    struct ktx2_private_level levels[KTX2_MAX_LEVELS];
+
+    /* Mip levels are stored from the smallest to the largest, so saved frames are written in finish(). */
+    void *level_data[KTX2_MAX_LEVELS];
+};
+
+static sail_status_t alloc_ktx2_state(struct sail_io *io,
+                                        const struct sail_load_options *load_options,
+                                        const struct sail_save_options *save_options,
+                                        struct ktx2_state **ktx2_state) {
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct ktx2_state), &ptr));
+    *ktx2_state = ptr;
+
+    memset(*ktx2_state, 0, sizeof(struct ktx2_state));
+
+    (*ktx2_state)->io           = io;
+    (*ktx2_state)->load_options = load_options;
+    (*ktx2_state)->save_options = save_options;
+    (*ktx2_state)->pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN;
+
+    return SAIL_OK;
+}
+
+static void destroy_ktx2_state(struct ktx2_state *ktx2_state) {
+
+    if (ktx2_state == NULL) {
+        return;
+    }
+
+    for (unsigned i = 0; i < KTX2_MAX_LEVELS; i++) {
+        sail_free(ktx2_state->level_data[i]);
+    }
+
+    sail_free(ktx2_state);
+}
+
+/* Returns the dimension of the mip level. Every level is half the size of the previous one. */
+static unsigned mip_dimension(unsigned dimension, unsigned level) {
+
+    const unsigned value = (level < 32) ? dimension >> level : 0;
+
+    return (value > 0) ? value : 1;
+}
+
+/* Returns the number of levels in the full mip chain. */
+static unsigned full_mip_chain_length(unsigned width, unsigned height) {
+
+    unsigned levels = 1;
+
+    while (width > 1 || height > 1) {
+        width  = (width > 1)  ? width / 2  : 1;
+        height = (height > 1) ? height / 2 : 1;
+        levels++;
+    }
+
+    return levels;
+}
+
+/*
+ * Decoding functions.
+ */
+
+SAIL_EXPORT sail_status_t sail_codec_load_init_v8_ktx2(struct sail_io *io, const struct sail_load_options *load_options, void **state) {
+
+    *state = NULL;
+
+    /* Allocate a new state. */
+    struct ktx2_state *ktx2_state;
+    SAIL_TRY(alloc_ktx2_state(io, load_options, NULL, &ktx2_state));
+    *state = ktx2_state;
+
+    struct ktx2_private_header header;
+    SAIL_TRY(ktx2_private_read_header(ktx2_state->io, &header));
+
+    if (header.pixel_width == 0 || header.pixel_height == 0) {
+        SAIL_LOG_ERROR("KTX2: Only 2D textures are supported, but the texture is %ux%u", header.pixel_width, header.pixel_height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    if (header.pixel_depth > 0 || header.layer_count > 1 || header.face_count != 1) {
+        SAIL_LOG_ERROR("KTX2: Only 2D textures are supported, but not cube maps, volumes, and arrays");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
+    }
+
+    if (header.supercompression_scheme != 0) {
+        SAIL_LOG_ERROR("KTX2: Supercompression scheme %u is not supported", header.supercompression_scheme);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    ktx2_state->pixel_format = ktx2_private_sail_pixel_format(header.vk_format);
+
+    if (ktx2_state->pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN) {
+        SAIL_LOG_ERROR("KTX2: VkFormat %u is not supported", header.vk_format);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    if (sail_is_block_compressed(ktx2_state->pixel_format) && (header.pixel_width % 4 != 0 || header.pixel_height % 4 != 0)) {
+        SAIL_LOG_ERROR("KTX2: Block-compressed textures must have dimensions multiple of 4, but the texture is %ux%u",
+                        header.pixel_width, header.pixel_height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    const unsigned full_mip_levels = full_mip_chain_length(header.pixel_width, header.pixel_height);
+
+    if (header.level_count > full_mip_levels) {
+        SAIL_LOG_ERROR("KTX2: Level count %u exceeds the mip chain length %u", header.level_count, full_mip_levels);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    ktx2_state->width       = header.pixel_width;
+    ktx2_state->height      = header.pixel_height;
+    ktx2_state->level_count = header.level_count;
+
+    SAIL_TRY(ktx2_private_read_level_index(ktx2_state->io, ktx2_state->levels, ktx2_state->level_count));
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_ktx2(void *state, struct sail_image **image) {
+
+    struct ktx2_state *ktx2_state = state;
+
+    if (ktx2_state->frame_number >= ktx2_state->level_count) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    const unsigned width  = mip_dimension(ktx2_state->width,  ktx2_state->frame_number);
+    const unsigned height = mip_dimension(ktx2_state->height, ktx2_state->frame_number);
+
+    /* Block-compressed frames consist of whole blocks, so smaller mip levels are not exposed. */
+    if (sail_is_block_compressed(ktx2_state->pixel_format) && (width % 4 != 0 || height % 4 != 0)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    const struct ktx2_private_level *level = &ktx2_state->levels[ktx2_state->frame_number];
+    const size_t level_size = (size_t)sail_bytes_per_line(width, ktx2_state->pixel_format) * height;
+
+    if (level->length < level_size || level->offset > LONG_MAX) {
+        SAIL_LOG_ERROR("KTX2: Mip level %u is truncated", ktx2_state->frame_number);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    if (ktx2_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&image_local->source_image),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        image_local->source_image->pixel_format = ktx2_state->pixel_format;
+        image_local->source_image->compression  = SAIL_COMPRESSION_NONE;
+    }
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->pixel_format   = ktx2_state->pixel_format;
+    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_io_will_need(ktx2_state->io, (size_t)level->offset, level_size),
+                        /* cleanup */ sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(ktx2_state->io->seek(ktx2_state->io->stream, (long)level->offset, SEEK_SET),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    ktx2_state->frame_number++;
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_seek_frame_v8_ktx2(void *state, unsigned frame) {
+
+    struct ktx2_state *ktx2_state = state;
+
+    /* The level index has the offsets of all mip levels, so seek to any of them directly. */
+    if (frame >= ktx2_state->level_count) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    ktx2_state->frame_number = frame;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_ktx2(void *state, struct sail_image *image) {
+
+    struct ktx2_state *ktx2_state = state;
+
+    SAIL_TRY(ktx2_state->io->strict_read(ktx2_state->io->stream, image->pixels, (size_t)image->bytes_per_line * image->height));
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_ktx2(void **state) {
+
+    struct ktx2_state *ktx2_state = *state;
+
+    *state = NULL;
+
+    destroy_ktx2_state(ktx2_state);
+
+    return SAIL_OK;
+}
+
+/*
+ * Encoding functions.
+ */
+
+SAIL_EXPORT sail_status_t sail_codec_save_init_v8_ktx2(struct sail_io *io, const struct sail_save_options *save_options, void **state) {
+
+    *state = NULL;
+
+    struct ktx2_state *ktx2_state;
+    SAIL_TRY(alloc_ktx2_state(io, NULL, save_options, &ktx2_state));
+    *state = ktx2_state;
+
+    /* Sanity check. */
+    if (ktx2_state->save_options->compression != SAIL_COMPRESSION_NONE) {
+        SAIL_LOG_ERROR("KTX2: Only NONE compression is allowed for saving, block-compressed pixel formats are saved as is");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_ktx2(void *state, const struct sail_image *image) {
+
+    struct ktx2_state *ktx2_state = state;
+
+    /* The first frame is the texture, and the next frames are its mip levels. */
+    if (ktx2_state->frame_number == 0) {
+        if (!ktx2_private_supported_pixel_format(image->pixel_format)) {
+            SAIL_LOG_ERROR("KTX2: %s pixel format is not currently supported for saving", sail_pixel_format_to_string(image->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+
+        ktx2_state->pixel_format = image->pixel_format;
+        ktx2_state->width        = image->width;
+        ktx2_state->height       = image->height;
+    } else {
+        if (ktx2_state->frame_number >= full_mip_chain_length(ktx2_state->width, ktx2_state->height)) {
+            SAIL_LOG_ERROR("KTX2: The mip chain of %u levels is complete", ktx2_state->frame_number);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+        }
+
+        const unsigned width  = mip_dimension(ktx2_state->width,  ktx2_state->frame_number);
+        const unsigned height = mip_dimension(ktx2_state->height, ktx2_state->frame_number);
+
+        if (image->pixel_format != ktx2_state->pixel_format) {
+            SAIL_LOG_ERROR("KTX2: Mip level %u must have %s pixel format", ktx2_state->frame_number, sail_pixel_format_to_string(ktx2_state->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+        if (image->width != width || image->height != height) {
+            SAIL_LOG_ERROR("KTX2: Mip level %u must be %ux%u, but the frame is %ux%u", ktx2_state->frame_number, width, height, image->width, image->height);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+        }
+    }
+
+    ktx2_state->frame_number++;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_ktx2(void *state, const struct sail_image *image) {
+
+    struct ktx2_state *ktx2_state = state;
+
+    /* Mip levels are tightly packed. */
+    const unsigned bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+    const size_t level_size = (size_t)bytes_per_line * image->height;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(level_size, &ptr));
+    unsigned char *data = ptr;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        memcpy(data + (size_t)row * bytes_per_line, sail_scan_line(image, row), bytes_per_line);
+    }
+
+    ktx2_state->level_data[ktx2_state->level_count]    = data;
+    ktx2_state->levels[ktx2_state->level_count].length = level_size;
+    ktx2_state->level_count++;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_ktx2(void **state) {
+
+    struct ktx2_state *ktx2_state = *state;
+
+    /* Subsequent calls to finish() will expectedly fail in the above line. */
+    *state = NULL;
+
+    if (ktx2_state->level_count == 0) {
+        destroy_ktx2_state(ktx2_state);
+        return SAIL_OK;
+    }
+
+    /* Lay out the mip levels from the smallest to the largest. */
+    const size_t alignment = ktx2_private_level_alignment(ktx2_state->pixel_format);
+    size_t offset = ktx2_private_header_size(ktx2_state->pixel_format, ktx2_state->level_count);
+
+    for (unsigned i = ktx2_state->level_count; i > 0; i--) {
+        offset = (offset + alignment - 1) / alignment * alignment;
+        ktx2_state->levels[i - 1].offset = offset;
+        offset += (size_t)ktx2_state->levels[i - 1].length;
+    }
+
+    SAIL_TRY_OR_CLEANUP(ktx2_private_write_header(ktx2_state->io, ktx2_state->pixel_format, ktx2_state->width, ktx2_state->height,
+                                                  ktx2_state->levels, ktx2_state->level_count),
+                        /* cleanup */ destroy_ktx2_state(ktx2_state));
+
+    offset = ktx2_private_header_size(ktx2_state->pixel_format, ktx2_state->level_count);
+
+    for (unsigned i = ktx2_state->level_count; i > 0; i--) {
+        const struct ktx2_private_level *level = &ktx2_state->levels[i - 1];
+        static const unsigned char padding[16] = { 0 };
+
+        if (level->offset > offset) {
+            SAIL_TRY_OR_CLEANUP(ktx2_state->io->strict_write(ktx2_state->io->stream, padding, (size_t)level->offset - offset),
+                                /* cleanup */ destroy_ktx2_state(ktx2_state));
+        }
+        SAIL_TRY_OR_CLEANUP(ktx2_state->io->strict_write(ktx2_state->io->stream, ktx2_state->level_data[i - 1], (size_t)level->length),
+                            /* cleanup */ destroy_ktx2_state(ktx2_state));
+
+        offset = (size_t)(level->offset + level->length);
+    }
+
+    destroy_ktx2_state(ktx2_state);
+
+    return SAIL_OK;
+}
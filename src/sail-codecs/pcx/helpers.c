@@ -161,3 +161,88 @@ sail_status_t pcx_private_read_uncompressed(struct sail_io *io, unsigned bytes_p
 
     return SAIL_OK;
 }
+
+sail_status_t pcx_private_write_header(struct sail_io *io, const struct SailPcxHeader *header) {
+
+    SAIL_TRY(io->strict_write(io->stream, &header->id,             sizeof(header->id)));
+    SAIL_TRY(io->strict_write(io->stream, &header->version,        sizeof(header->version)));
+    SAIL_TRY(io->strict_write(io->stream, &header->encoding,       sizeof(header->encoding)));
+    SAIL_TRY(io->strict_write(io->stream, &header->bits_per_plane, sizeof(header->bits_per_plane)));
+    SAIL_TRY(io->strict_write(io->stream, &header->xmin,           sizeof(header->xmin)));
+    SAIL_TRY(io->strict_write(io->stream, &header->ymin,           sizeof(header->ymin)));
+    SAIL_TRY(io->strict_write(io->stream, &header->xmax,           sizeof(header->xmax)));
+    SAIL_TRY(io->strict_write(io->stream, &header->ymax,           sizeof(header->ymax)));
+    SAIL_TRY(io->strict_write(io->stream, &header->hdpi,           sizeof(header->hdpi)));
+    SAIL_TRY(io->strict_write(io->stream, &header->vdpi,           sizeof(header->vdpi)));
+    SAIL_TRY(io->strict_write(io->stream, header->palette,         sizeof(header->palette)));
+    SAIL_TRY(io->strict_write(io->stream, &header->reserved,       sizeof(header->reserved)));
+    SAIL_TRY(io->strict_write(io->stream, &header->planes,         sizeof(header->planes)));
+    SAIL_TRY(io->strict_write(io->stream, &header->bytes_per_line, sizeof(header->bytes_per_line)));
+    SAIL_TRY(io->strict_write(io->stream, &header->palette_info,   sizeof(header->palette_info)));
+    SAIL_TRY(io->strict_write(io->stream, &header->hscreen_size,   sizeof(header->hscreen_size)));
+    SAIL_TRY(io->strict_write(io->stream, &header->vscreen_size,   sizeof(header->vscreen_size)));
+    SAIL_TRY(io->strict_write(io->stream, header->filler,          sizeof(header->filler)));
+
+    return SAIL_OK;
+}
+
+sail_status_t pcx_private_pixel_format_to_planes(enum SailPixelFormat pixel_format, uint8_t *bits_per_plane, uint8_t *planes) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP4_INDEXED: *bits_per_plane = 4; *planes = 1; return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP8_INDEXED: *bits_per_plane = 8; *planes = 1; return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:    *bits_per_plane = 8; *planes = 3; return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:   *bits_per_plane = 8; *planes = 4; return SAIL_OK;
+
+        default: {
+            SAIL_LOG_ERROR("PCX: %s pixel format is not currently supported for saving", sail_pixel_format_to_string(pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+    }
+}
+
+sail_status_t pcx_private_palette_to_rgb(const struct sail_palette *palette, unsigned max_colors, uint8_t *rgb) {
+
+    if (palette == NULL || palette->data == NULL || palette->color_count == 0) {
+        SAIL_LOG_ERROR("PCX: Indexed image has no palette");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MISSING_PALETTE);
+    }
+
+    unsigned channels;
+
+    switch (palette->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:  { channels = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: { channels = 4; break; }
+        default: {
+            SAIL_LOG_ERROR("PCX: %s palette pixel format is not currently supported for saving",
+                            sail_pixel_format_to_string(palette->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+    }
+
+    if (palette->color_count > max_colors) {
+        SAIL_LOG_ERROR("PCX: Palette has %u colors, but the pixel format allows only %u", palette->color_count, max_colors);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    /* Unused entries are black. */
+    memset(rgb, 0, (size_t)max_colors * 3);
+
+    const unsigned char *entry = palette->data;
+
+    for (unsigned i = 0; i < palette->color_count; i++, entry += channels) {
+        memcpy(rgb + i * 3, entry, 3);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t pcx_private_write_palette256(struct sail_io *io, const uint8_t rgb[256 * 3]) {
+
+    const uint8_t signature = SAIL_PCX_PALETTE_SIGNATURE;
+
+    SAIL_TRY(io->strict_write(io->stream, &signature, sizeof(signature)));
+    SAIL_TRY(io->strict_write(io->stream, rgb, 256 * 3));
+
+    return SAIL_OK;
+}
@@ -75,6 +75,14 @@ SAIL_HIDDEN sail_status_t pcx_private_sail_pixel_format(unsigned bits_per_plane,
 
 SAIL_HIDDEN sail_status_t pcx_private_build_palette(enum SailPixelFormat pixel_format, struct sail_io *io, uint8_t palette16[48], struct sail_palette **palette);
 
+SAIL_HIDDEN sail_status_t pcx_private_write_header(struct sail_io *io, const struct SailPcxHeader *header);
+
+SAIL_HIDDEN sail_status_t pcx_private_pixel_format_to_planes(enum SailPixelFormat pixel_format, uint8_t *bits_per_plane, uint8_t *planes);
+
+SAIL_HIDDEN sail_status_t pcx_private_palette_to_rgb(const struct sail_palette *palette, unsigned max_colors, uint8_t *rgb);
+
+SAIL_HIDDEN sail_status_t pcx_private_write_palette256(struct sail_io *io, const uint8_t rgb[256 * 3]);
+
 SAIL_HIDDEN sail_status_t pcx_private_read_uncompressed(struct sail_io *io, unsigned bytes_per_plane_to_read, unsigned planes, unsigned char *buffer, struct sail_image *image);
 
 #endif
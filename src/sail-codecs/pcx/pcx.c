@@ -31,6 +31,8 @@
 
 #include <sail-common/sail-common.h>
 
+#include "common/rle/rle.h"
+
 #include "helpers.h"
 
 /* PCX signature. */
@@ -40,6 +42,9 @@ static const unsigned SAIL_PCX_SIGNATURE = 0x0A;
 static const uint8_t SAIL_PCX_RLE_MARKER     = 0xC0;
 static const uint8_t SAIL_PCX_RLE_COUNT_MASK = 0x3F;
 
+/* Version 3.0 and later with the 256-color palette at the end. */
+static const uint8_t SAIL_PCX_SAVE_VERSION = SAIL_PCX_V5;
+
 /*
  * Codec-specific state.
  */
@@ -50,8 +55,10 @@ struct pcx_state {
 
     struct SailPcxHeader pcx_header;
     unsigned char *scanline_buffer; /* buffer to read a single plane scan line. */
+    uint8_t palette256[256 * 3];
 
     bool frame_loaded;
+    bool frame_saved;
 };
 
 static sail_status_t alloc_pcx_state(struct sail_io *io,
@@ -70,6 +77,7 @@ static sail_status_t alloc_pcx_state(struct sail_io *io,
 
         .scanline_buffer = NULL,
         .frame_loaded    = false,
+        .frame_saved     = false,
     };
 
     return SAIL_OK;
@@ -182,44 +190,70 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_pcx(void *state, struct sail_
     if (pcx_state->pcx_header.encoding == SAIL_PCX_NO_ENCODING) {
         SAIL_TRY(pcx_private_read_uncompressed(pcx_state->io, pcx_state->pcx_header.bytes_per_line, pcx_state->pcx_header.planes, pcx_state->scanline_buffer, image));
     } else {
+        struct sail_buffered_reader reader;
+        SAIL_TRY(sail_init_buffered_reader(pcx_state->io, 0, &reader));
+
         for (unsigned row = 0; row < image->height; row++) {
             unsigned buffer_offset = 0;
 
             /* Decode all planes of a single scan line. */
-            for (unsigned bytes = 0; bytes < image->bytes_per_line;) {
-                uint8_t marker;
-                SAIL_TRY(pcx_state->io->strict_read(pcx_state->io->stream, &marker, sizeof(marker)));
+            while (buffer_offset < image->bytes_per_line) {
+                const unsigned left = image->bytes_per_line - buffer_offset;
 
-                uint8_t count;
-                uint8_t value;
+                uint8_t marker;
+                SAIL_TRY_OR_CLEANUP(sail_buffered_reader_read_byte(&reader, &marker),
+                                    /* cleanup */ sail_finish_buffered_reader(&reader));
 
                 /* RLE marker set. */
                 if ((marker & SAIL_PCX_RLE_MARKER) == SAIL_PCX_RLE_MARKER) {
-                    count = marker & SAIL_PCX_RLE_COUNT_MASK;
-                    SAIL_TRY(pcx_state->io->strict_read(pcx_state->io->stream, &value, sizeof(value)));
+                    uint8_t value;
+                    SAIL_TRY_OR_CLEANUP(sail_buffered_reader_read_byte(&reader, &value),
+                                        /* cleanup */ sail_finish_buffered_reader(&reader));
+
+                    /* Runs crossing the scan line are cut. */
+                    const unsigned count = SAIL_MIN((unsigned)(marker & SAIL_PCX_RLE_COUNT_MASK), left);
+
+                    memset(pcx_state->scanline_buffer + buffer_offset, value, count);
+                    buffer_offset += count;
                 } else {
-                    /* Pixel value. */
-                    count = 1;
-                    value = marker;
-                }
+                    /* Pixel value. Copy it together with the following buffered pixel values at once. */
+                    pcx_state->scanline_buffer[buffer_offset++] = marker;
+
+                    const unsigned char *buffered;
+                    const size_t buffered_size = sail_buffered_reader_buffered(&reader, &buffered);
+
+                    const unsigned max_literal = (unsigned)SAIL_MIN((size_t)(left - 1), buffered_size);
+                    unsigned literal = 0;
+
+                    while (literal < max_literal && (buffered[literal] & SAIL_PCX_RLE_MARKER) != SAIL_PCX_RLE_MARKER) {
+                        literal++;
+                    }
 
-                bytes += count;
+                    memcpy(pcx_state->scanline_buffer + buffer_offset, buffered, literal);
+                    buffer_offset += literal;
 
-                memset(pcx_state->scanline_buffer + buffer_offset, value, count);
-                buffer_offset += count;
+                    SAIL_TRY_OR_CLEANUP(sail_buffered_reader_skip(&reader, literal),
+                                        /* cleanup */ sail_finish_buffered_reader(&reader));
+                }
             }
 
             /* Merge planes into the image pixels. */
             unsigned char * const scan = sail_scan_line(image, row);
 
-            for (unsigned plane = 0; plane < pcx_state->pcx_header.planes; plane++) {
-                const unsigned buffer_plane_offset = plane * pcx_state->pcx_header.bytes_per_line;
+            if (pcx_state->pcx_header.planes == 1) {
+                memcpy(scan, pcx_state->scanline_buffer, image->bytes_per_line);
+            } else {
+                for (unsigned plane = 0; plane < pcx_state->pcx_header.planes; plane++) {
+                    const unsigned buffer_plane_offset = plane * pcx_state->pcx_header.bytes_per_line;
 
-                for (unsigned column = 0; column < pcx_state->pcx_header.bytes_per_line; column++) {
-                    *(scan + column * pcx_state->pcx_header.planes + plane) = *(pcx_state->scanline_buffer + buffer_plane_offset + column);
+                    for (unsigned column = 0; column < pcx_state->pcx_header.bytes_per_line; column++) {
+                        *(scan + column * pcx_state->pcx_header.planes + plane) = *(pcx_state->scanline_buffer + buffer_plane_offset + column);
+                    }
                 }
             }
         }
+
+        SAIL_TRY(sail_finish_buffered_reader(&reader));
     }
 
     return SAIL_OK;
@@ -242,32 +276,185 @@ SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_pcx(void **state) {
 
 SAIL_EXPORT sail_status_t sail_codec_save_init_v8_pcx(struct sail_io *io, const struct sail_save_options *save_options, void **state) {
 
-    (void)io;
-    (void)save_options;
-    (void)state;
+    *state = NULL;
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    /* Allocate a new state. */
+    struct pcx_state *pcx_state;
+    SAIL_TRY(alloc_pcx_state(io, NULL, save_options, &pcx_state));
+    *state = pcx_state;
+
+    /* Sanity check. */
+    if (pcx_state->save_options->compression != SAIL_COMPRESSION_NONE && pcx_state->save_options->compression != SAIL_COMPRESSION_RLE) {
+        SAIL_LOG_ERROR("PCX: Only NONE and RLE compressions are allowed for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    return SAIL_OK;
+}
+
+/* Converts the image resolution to dots per inch. Unknown units are saved as 0. */
+static uint16_t dots_per_inch(const struct sail_resolution *resolution, double value) {
+
+    double dpi;
+
+    switch (resolution->unit) {
+        case SAIL_RESOLUTION_UNIT_MICROMETER: dpi = value * 25400;  break;
+        case SAIL_RESOLUTION_UNIT_CENTIMETER: dpi = value * 2.54;   break;
+        case SAIL_RESOLUTION_UNIT_METER:      dpi = value * 0.0254; break;
+        case SAIL_RESOLUTION_UNIT_INCH:       dpi = value;          break;
+
+        default: {
+            return 0;
+        }
+    }
+
+    return (dpi <= 0 || dpi > UINT16_MAX) ? 0 : (uint16_t)(dpi + 0.5);
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_pcx(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct pcx_state *pcx_state = state;
+
+    if (pcx_state->frame_saved) {
+        SAIL_LOG_ERROR("PCX: Only single frame is supported for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    pcx_state->frame_saved = true;
+
+    if (image->width == 0 || image->height == 0 || image->width > UINT16_MAX || image->height > UINT16_MAX) {
+        SAIL_LOG_ERROR("PCX: Image dimensions must be in the range 1-%u pixels", UINT16_MAX);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    uint8_t bits_per_plane;
+    uint8_t planes;
+    SAIL_TRY(pcx_private_pixel_format_to_planes(image->pixel_format, &bits_per_plane, &planes));
+
+    /* Plane scan lines are even. */
+    const unsigned bytes_per_plane = (unsigned)sail_bytes_per_line(image->width, image->pixel_format) / planes;
+    const unsigned bytes_per_line = (bytes_per_plane + 1) & ~1U;
+
+    if (bytes_per_line > UINT16_MAX) {
+        SAIL_LOG_ERROR("PCX: Image is too wide");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    pcx_state->pcx_header = (struct SailPcxHeader) {
+        .id             = SAIL_PCX_SIGNATURE,
+        .version        = SAIL_PCX_SAVE_VERSION,
+        .encoding       = (pcx_state->save_options->compression == SAIL_COMPRESSION_RLE) ? SAIL_PCX_RLE_ENCODING : SAIL_PCX_NO_ENCODING,
+        .bits_per_plane = bits_per_plane,
+        .xmin           = 0,
+        .ymin           = 0,
+        .xmax           = (uint16_t)(image->width - 1),
+        .ymax           = (uint16_t)(image->height - 1),
+        .hdpi           = (image->resolution == NULL) ? 0 : dots_per_inch(image->resolution, image->resolution->x),
+        .vdpi           = (image->resolution == NULL) ? 0 : dots_per_inch(image->resolution, image->resolution->y),
+        .reserved       = 0,
+        .planes         = planes,
+        .bytes_per_line = (uint16_t)bytes_per_line,
+        .palette_info   = 1, /* Color. */
+        .hscreen_size   = 0,
+        .vscreen_size   = 0,
+    };
+
+    /* 16-color palette is stored in the header, and 256-color palette follows the pixels. */
+    if (image->pixel_format == SAIL_PIXEL_FORMAT_BPP4_INDEXED) {
+        SAIL_TRY(pcx_private_palette_to_rgb(image->palette, 16, pcx_state->pcx_header.palette));
+    } else if (image->pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED) {
+        SAIL_TRY(pcx_private_palette_to_rgb(image->palette, 256, pcx_state->palette256));
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(bytes_per_line, &ptr));
+    pcx_state->scanline_buffer = ptr;
+
+    /* The pad byte is always zero. */
+    memset(pcx_state->scanline_buffer, 0, bytes_per_line);
+
+    SAIL_TRY(pcx_private_write_header(pcx_state->io, &pcx_state->pcx_header));
+
+    return SAIL_OK;
+}
+
+/* Encodes a single plane scan line. Runs never cross planes. */
+static sail_status_t write_rle_plane(struct sail_buffered_writer *writer, const unsigned char *plane, unsigned size) {
+
+    for (unsigned x = 0; x < size;) {
+        const unsigned run = rle_private_run_length(plane + x, 1, SAIL_MIN(size - x, (unsigned)SAIL_PCX_RLE_COUNT_MASK));
+
+        /* Single values with both top bits unset are written as is. */
+        if (run == 1 && (plane[x] & SAIL_PCX_RLE_MARKER) != SAIL_PCX_RLE_MARKER) {
+            SAIL_TRY(sail_buffered_writer_strict_write(writer, plane + x, 1));
+        } else {
+            const uint8_t packet[2] = { (uint8_t)(SAIL_PCX_RLE_MARKER | run), plane[x] };
+            SAIL_TRY(sail_buffered_writer_strict_write(writer, packet, sizeof(packet)));
+        }
+
+        x += run;
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_frame(struct pcx_state *pcx_state, struct sail_buffered_writer *writer, const struct sail_image *image) {
+
+    const unsigned planes = pcx_state->pcx_header.planes;
+    const unsigned bytes_per_line = pcx_state->pcx_header.bytes_per_line;
+    const unsigned bytes_per_plane = (unsigned)sail_bytes_per_line(image->width, image->pixel_format) / planes;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const unsigned char *scan = sail_scan_line(image, row);
+
+        /* Split the pixels into planes. */
+        for (unsigned plane = 0; plane < planes; plane++) {
+            if (planes == 1) {
+                memcpy(pcx_state->scanline_buffer, scan, bytes_per_plane);
+            } else {
+                for (unsigned column = 0; column < bytes_per_plane; column++) {
+                    pcx_state->scanline_buffer[column] = scan[column * planes + plane];
+                }
+            }
+
+            if (pcx_state->pcx_header.encoding == SAIL_PCX_RLE_ENCODING) {
+                SAIL_TRY(write_rle_plane(writer, pcx_state->scanline_buffer, bytes_per_line));
+            } else {
+                SAIL_TRY(sail_buffered_writer_strict_write(writer, pcx_state->scanline_buffer, bytes_per_line));
+            }
+        }
+    }
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_pcx(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct pcx_state *pcx_state = state;
+
+    /* Plane scan lines are coalesced into large blocks. */
+    struct sail_buffered_writer writer;
+    SAIL_TRY(sail_init_buffered_writer(pcx_state->io, 0, &writer));
+
+    SAIL_TRY_OR_CLEANUP(write_frame(pcx_state, &writer, image),
+                        /* cleanup */ sail_finish_buffered_writer(&writer));
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    SAIL_TRY(sail_finish_buffered_writer(&writer));
+
+    if (image->pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED) {
+        SAIL_TRY(pcx_private_write_palette256(pcx_state->io, pcx_state->palette256));
+    }
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_pcx(void **state) {
 
-    (void)state;
+    struct pcx_state *pcx_state = *state;
+
+    *state = NULL;
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    destroy_pcx_state(pcx_state);
+
+    return SAIL_OK;
 }
@@ -28,6 +28,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <zlib.h>
+
 #include <sail-common/sail-common.h>
 
 #include "helpers.h"
@@ -36,27 +38,56 @@
  * Private functions.
  */
 
+static inline bool is_white_space(char c) {
+
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+static const char* skip_white_spaces(const char *str) {
+
+    while (is_white_space(*str)) {
+        str++;
+    }
+
+    return str;
+}
+
 static sail_status_t skip_raw_profile_header(const char *data, const char **start) {
 
     SAIL_CHECK_PTR(data);
     SAIL_CHECK_PTR(start);
 
-    char key[16];
-    int n;
-    char c;
-    int bytes_consumed;
+    /* Skip "\nexif\n    1234\n" before the actual HEX-encoded data. */
+    const char *ptr = skip_white_spaces(data);
 
-    /* Skip "\nexif\n    1234 " before the actual HEX-encoded data. */
-#ifdef _MSC_VER
-    if (sscanf_s(data, "%s %d %c %n", key, (unsigned)sizeof(key), &n, &c, 1, &bytes_consumed) != 3) {
-#else
-    if (sscanf(data, "%s %d %c %n", key, &n, &c, &bytes_consumed) != 3) {
-#endif
+    /* Key. */
+    const char *key = ptr;
+    while (*ptr != '\0' && !is_white_space(*ptr)) {
+        ptr++;
+    }
+
+    const bool has_key = ptr > key;
+    ptr = skip_white_spaces(ptr);
+
+    /* Length. */
+    if (*ptr == '+' || *ptr == '-') {
+        ptr++;
+    }
+
+    const char *length = ptr;
+    while (*ptr >= '0' && *ptr <= '9') {
+        ptr++;
+    }
+
+    const bool has_length = ptr > length;
+    ptr = skip_white_spaces(ptr);
+
+    if (!has_key || !has_length || *ptr == '\0') {
         SAIL_LOG_ERROR("PNG: Failed to parse raw profile header");
         SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
     }
 
-    *start = data + bytes_consumed - 1;
+    *start = ptr;
 
     return SAIL_OK;
 }
@@ -116,6 +147,205 @@ static sail_status_t hex_string_to_meta_data_node(const char *hex_str, enum Sail
     return SAIL_OK;
 }
 
+/* Returns the meta data key stored in a text chunk with the specified keyword. */
+static enum SailMetaData text_keyword_to_meta_data(const char *keyword) {
+
+    /* Legacy EXIF and friends. */
+    if (strcmp(keyword, "Raw profile type exif") == 0) {
+        return SAIL_META_DATA_EXIF;
+    } else if (strcmp(keyword, "Raw profile type iptc") == 0) {
+        return SAIL_META_DATA_IPTC;
+    } else if (strcmp(keyword, "Raw profile type xmp") == 0 || strcmp(keyword, "XML:com.adobe.xmp") == 0) {
+        return SAIL_META_DATA_XMP;
+    } else {
+        return sail_meta_data_from_string(keyword);
+    }
+}
+
+/* Converts the text of a text chunk into a meta data node. */
+static sail_status_t text_to_meta_data_node(const char *keyword, enum SailMetaData meta_data, const char *text,
+                                            struct sail_meta_data_node **meta_data_node) {
+
+    if (strncmp(keyword, "Raw profile type ", 17) == 0 && meta_data != SAIL_META_DATA_UNKNOWN) {
+        SAIL_TRY(hex_string_to_meta_data_node(text, meta_data, meta_data_node));
+        return SAIL_OK;
+    }
+
+    struct sail_meta_data_node *meta_data_node_local;
+    SAIL_TRY(sail_alloc_meta_data_node(&meta_data_node_local));
+
+    if (meta_data == SAIL_META_DATA_UNKNOWN) {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_and_value_from_unknown_key(keyword, &meta_data_node_local->meta_data),
+                            /* cleanup */ sail_destroy_meta_data_node(meta_data_node_local));
+    } else {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_and_value_from_known_key(meta_data, &meta_data_node_local->meta_data),
+                            /* cleanup */ sail_destroy_meta_data_node(meta_data_node_local));
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_set_variant_string(meta_data_node_local->meta_data->value, text),
+                        /* cleanup */ sail_destroy_meta_data_node(meta_data_node_local));
+
+    *meta_data_node = meta_data_node_local;
+
+    return SAIL_OK;
+}
+
+#if defined(PNG_HANDLE_AS_UNKNOWN_SUPPORTED) && defined(PNG_READ_USER_CHUNKS_SUPPORTED)
+/* Inflates a compressed text into a NUL-terminated string. */
+static sail_status_t inflate_text(const png_byte *data, size_t size, char **text) {
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+
+    if (inflateInit(&stream) != Z_OK) {
+        SAIL_LOG_ERROR("PNG: Failed to initialize zlib");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    stream.next_in  = (Bytef *)data;
+    stream.avail_in = (uInt)size;
+
+    size_t capacity = size * 2 + 64;
+    size_t length   = 0;
+    void *ptr       = NULL;
+    int status;
+
+    do {
+        if (ptr == NULL || capacity - length < 2) {
+            if (ptr != NULL) {
+                capacity *= 2;
+            }
+
+            SAIL_TRY_OR_CLEANUP(sail_realloc(capacity, &ptr),
+                                /* cleanup */ sail_free(ptr),
+                                              inflateEnd(&stream));
+        }
+
+        /* Keep a byte for the NUL terminator. */
+        const size_t available = capacity - length - 1;
+
+        stream.next_out  = (Bytef *)ptr + length;
+        stream.avail_out = (available < UINT32_MAX) ? (uInt)available : UINT32_MAX;
+
+        const uInt avail_out = stream.avail_out;
+        status = inflate(&stream, Z_NO_FLUSH);
+        length += avail_out - stream.avail_out;
+    } while (status == Z_OK);
+
+    inflateEnd(&stream);
+
+    if (status != Z_STREAM_END) {
+        sail_free(ptr);
+        SAIL_LOG_ERROR("PNG: Failed to inflate text");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    ((char *)ptr)[length] = '\0';
+    *text = ptr;
+
+    return SAIL_OK;
+}
+
+/*
+ * Reads zTXt and iTXt chunks handled as unknown, and stores their texts only if their keys
+ * are selected in the load options. Returns 1 when the chunk is used or skipped, or a negative
+ * value on memory allocation errors.
+ */
+static int read_text_chunk(png_structp png_ptr, png_unknown_chunkp chunk) {
+
+    struct png_private_text_chunks *text_chunks = png_get_user_chunk_ptr(png_ptr);
+
+    const png_byte *data = chunk->data;
+    const size_t size    = chunk->size;
+
+    /* NUL-terminated keyword. */
+    const png_byte *keyword_end = (size > 0) ? memchr(data, '\0', size) : NULL;
+
+    if (keyword_end == NULL) {
+        SAIL_LOG_WARNING("PNG: Skipping %s chunk without a keyword", (const char *)chunk->name);
+        return 1;
+    }
+
+    const char *keyword = (const char *)data;
+    const enum SailMetaData meta_data = text_keyword_to_meta_data(keyword);
+
+    if (!sail_load_meta_data_key(text_chunks->load_options, meta_data)) {
+        return 1;
+    }
+
+    const png_byte *text = keyword_end + 1;
+    size_t text_size     = (size_t)(data + size - text);
+    bool compressed;
+
+    if (memcmp(chunk->name, "zTXt", 4) == 0) {
+        /* Compression method. */
+        if (text_size < 1) {
+            SAIL_LOG_WARNING("PNG: Skipping truncated '%s' text", keyword);
+            return 1;
+        }
+
+        compressed = true;
+        text      += 1;
+        text_size -= 1;
+    } else {
+        /* Compression flag and method, language tag, and translated keyword. */
+        if (text_size < 2) {
+            SAIL_LOG_WARNING("PNG: Skipping truncated '%s' text", keyword);
+            return 1;
+        }
+
+        compressed = text[0] != 0;
+        text      += 2;
+        text_size -= 2;
+
+        for (int i = 0; i < 2; i++) {
+            const png_byte *end = (text_size > 0) ? memchr(text, '\0', text_size) : NULL;
+
+            if (end == NULL) {
+                SAIL_LOG_WARNING("PNG: Skipping truncated '%s' text", keyword);
+                return 1;
+            }
+
+            text_size -= (size_t)(end + 1 - text);
+            text       = end + 1;
+        }
+    }
+
+    char *str;
+
+    if (compressed) {
+        if (inflate_text(text, text_size, &str) != SAIL_OK) {
+            SAIL_LOG_WARNING("PNG: Skipping corrupted '%s' text", keyword);
+            return 1;
+        }
+    } else {
+        void *ptr;
+
+        if (sail_malloc(text_size + 1, &ptr) != SAIL_OK) {
+            return -1;
+        }
+
+        memcpy(ptr, text, text_size);
+        ((char *)ptr)[text_size] = '\0';
+        str = ptr;
+    }
+
+    struct sail_meta_data_node *meta_data_node;
+
+    if (text_to_meta_data_node(keyword, meta_data, str, &meta_data_node) != SAIL_OK) {
+        sail_free(str);
+        return -1;
+    }
+
+    sail_free(str);
+
+    *text_chunks->last_meta_data_node = meta_data_node;
+    text_chunks->last_meta_data_node  = &meta_data_node->next;
+
+    return 1;
+}
+#endif
+
 /*
  * Public functions.
  */
@@ -291,10 +521,151 @@ sail_status_t png_private_pixel_format_to_png_color_type(enum SailPixelFormat pi
     }
 }
 
-sail_status_t png_private_fetch_meta_data(png_structp png_ptr, png_infop info_ptr, struct sail_meta_data_node **target_meta_data_node) {
+bool png_private_set_output_pixel_format(png_structp png_ptr, png_infop info_ptr, int color_type, int bit_depth, enum SailPixelFormat pixel_format) {
+
+    bool bgr         = false;
+    bool alpha_first = false;
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE:
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA:
+        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA:
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:
+        case SAIL_PIXEL_FORMAT_BPP48_RGB:
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA: {
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:
+        case SAIL_PIXEL_FORMAT_BPP48_BGR:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA: {
+            bgr = true;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB: {
+            alpha_first = true;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR:
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR: {
+            bgr         = true;
+            alpha_first = true;
+            break;
+        }
+        default: {
+            return false;
+        }
+    }
+
+    int output_color_type;
+    int output_bit_depth;
+    SAIL_TRY_OR_EXECUTE(png_private_pixel_format_to_png_color_type(pixel_format, &output_color_type, &output_bit_depth),
+                        /* on error */ return false);
+
+    const bool output_color = (output_color_type & PNG_COLOR_MASK_COLOR) != 0;
+    const bool output_alpha = (output_color_type & PNG_COLOR_MASK_ALPHA) != 0;
+    const bool source_color = (color_type & PNG_COLOR_MASK_COLOR) != 0;
+    const bool source_alpha = (color_type & PNG_COLOR_MASK_ALPHA) != 0;
+    const bool source_trns  = png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS) != 0;
+
+    /* Converting RGB to grayscale is left to sail-manip that supports different luma coefficients. */
+    if (source_color && !output_color) {
+        return false;
+    }
+
+    /*
+     * png_set_swap() only swaps samples of 16-bit files, so samples expanded to 16 bits would stay big-endian.
+     * Expanding is left to sail-manip on little-endian hosts.
+     */
+#if !defined(PNG_READ_EXPAND_16_SUPPORTED) || SAIL_LITTLE_ENDIAN
+    if (output_bit_depth == 16 && bit_depth < 16) {
+        return false;
+    }
+#endif
+
+    if (color_type == PNG_COLOR_TYPE_PALETTE) {
+        png_set_palette_to_rgb(png_ptr);
+    } else if (!source_color && bit_depth < 8) {
+        png_set_expand_gray_1_2_4_to_8(png_ptr);
+    }
+
+    if (source_trns && output_alpha) {
+        png_set_tRNS_to_alpha(png_ptr);
+    }
+
+    if (!source_color && output_color) {
+        png_set_gray_to_rgb(png_ptr);
+    }
+
+    if (bit_depth == 16 && output_bit_depth == 8) {
+#ifdef PNG_READ_SCALE_16_TO_8_SUPPORTED
+        png_set_scale_16(png_ptr);
+#else
+        png_set_strip_16(png_ptr);
+#endif
+    }
+#ifdef PNG_READ_EXPAND_16_SUPPORTED
+    else if (bit_depth < 16 && output_bit_depth == 16) {
+        png_set_expand_16(png_ptr);
+    }
+#endif
+
+    if (output_alpha && !source_alpha && !source_trns) {
+        png_set_add_alpha(png_ptr, (output_bit_depth == 16) ? 0xFFFF : 0xFF, alpha_first ? PNG_FILLER_BEFORE : PNG_FILLER_AFTER);
+    } else if (!output_alpha && source_alpha) {
+        png_set_strip_alpha(png_ptr);
+    } else if (output_alpha && alpha_first) {
+        png_set_swap_alpha(png_ptr);
+    }
+
+    if (bgr) {
+        png_set_bgr(png_ptr);
+    }
+
+    return true;
+}
+
+void png_private_select_meta_data(png_structp png_ptr, const struct sail_load_options *load_options, struct png_private_text_chunks *text_chunks) {
+
+    text_chunks->load_options        = load_options;
+    text_chunks->meta_data_node      = NULL;
+    text_chunks->last_meta_data_node = &text_chunks->meta_data_node;
+
+#ifdef PNG_HANDLE_AS_UNKNOWN_SUPPORTED
+    /* Don't inflate and store texts nobody asked for. */
+    if (!(load_options->options & SAIL_OPTION_META_DATA)) {
+        static const png_byte chunks[] = "tEXt\0zTXt\0iTXt\0eXIf";
+        png_set_keep_unknown_chunks(png_ptr, PNG_HANDLE_CHUNK_NEVER, chunks, 4);
+        return;
+    }
+
+    if (!sail_load_meta_data_key(load_options, SAIL_META_DATA_EXIF)) {
+        static const png_byte chunks[] = "eXIf";
+        png_set_keep_unknown_chunks(png_ptr, PNG_HANDLE_CHUNK_NEVER, chunks, 1);
+    }
+
+#ifdef PNG_READ_USER_CHUNKS_SUPPORTED
+    /* libpng inflates all compressed texts, so read them manually to inflate only the selected keys. */
+    if (load_options->meta_data_keys != 0) {
+        static const png_byte chunks[] = "zTXt\0iTXt";
+        png_set_read_user_chunk_fn(png_ptr, text_chunks, read_text_chunk);
+        png_set_keep_unknown_chunks(png_ptr, PNG_HANDLE_CHUNK_ALWAYS, chunks, 2);
+    }
+#endif
+#else
+    (void)png_ptr;
+#endif
+}
+
+sail_status_t png_private_fetch_meta_data(png_structp png_ptr, png_infop info_ptr, const struct sail_load_options *load_options,
+                                          struct png_private_text_chunks *text_chunks, struct sail_meta_data_node **target_meta_data_node) {
 
     SAIL_CHECK_PTR(png_ptr);
     SAIL_CHECK_PTR(info_ptr);
+    SAIL_CHECK_PTR(text_chunks);
     SAIL_CHECK_PTR(target_meta_data_node);
 
     struct sail_meta_data_node **last_meta_data_node = target_meta_data_node;
@@ -304,46 +675,35 @@ sail_status_t png_private_fetch_meta_data(png_structp png_ptr, png_infop info_pt
     png_get_text(png_ptr, info_ptr, &lines, &num_text);
 
     for (int i = 0; i < num_text; i++) {
-        struct sail_meta_data_node *meta_data_node;
+        const enum SailMetaData meta_data = text_keyword_to_meta_data(lines[i].key);
 
-        /* Legacy EXIF and friends. */
-        if (strcmp(lines[i].key, "Raw profile type exif") == 0) {
-            SAIL_TRY(hex_string_to_meta_data_node(lines[i].text, SAIL_META_DATA_EXIF, &meta_data_node));
-        } else if (strcmp(lines[i].key, "Raw profile type iptc") == 0) {
-            SAIL_TRY(hex_string_to_meta_data_node(lines[i].text, SAIL_META_DATA_IPTC, &meta_data_node));
-        } else if (strcmp(lines[i].key, "Raw profile type xmp") == 0) {
-            SAIL_TRY(hex_string_to_meta_data_node(lines[i].text, SAIL_META_DATA_XMP, &meta_data_node));
-        } else {
-            enum SailMetaData meta_data;
-
-            if (strcmp(lines[i].key, "XML:com.adobe.xmp") == 0) {
-                meta_data = SAIL_META_DATA_XMP;
-            } else {
-                meta_data = sail_meta_data_from_string(lines[i].key);
-            }
+        if (!sail_load_meta_data_key(load_options, meta_data)) {
+            continue;
+        }
 
-            SAIL_TRY(sail_alloc_meta_data_node(&meta_data_node));
+        struct sail_meta_data_node *meta_data_node;
+        SAIL_TRY(text_to_meta_data_node(lines[i].key, meta_data, lines[i].text, &meta_data_node));
 
-            if (meta_data == SAIL_META_DATA_UNKNOWN) {
-                SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_and_value_from_unknown_key(lines[i].key, &meta_data_node->meta_data),
-                                    /* cleanup */ sail_destroy_meta_data_node(meta_data_node));
-            } else {
-                SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_and_value_from_known_key(meta_data, &meta_data_node->meta_data),
-                                    /* cleanup */ sail_destroy_meta_data_node(meta_data_node));
-            }
+        *last_meta_data_node = meta_data_node;
+        last_meta_data_node = &meta_data_node->next;
+    }
+
+    /* Texts read by read_text_chunk(). */
+    if (text_chunks->meta_data_node != NULL) {
+        *last_meta_data_node = text_chunks->meta_data_node;
 
-            SAIL_TRY_OR_CLEANUP(sail_set_variant_string(meta_data_node->meta_data->value, lines[i].text),
-                                /* cleanup */ sail_destroy_meta_data_node(meta_data_node));
+        while (*last_meta_data_node != NULL) {
+            last_meta_data_node = &(*last_meta_data_node)->next;
         }
 
-        *last_meta_data_node = meta_data_node;
-        last_meta_data_node = &meta_data_node->next;
+        text_chunks->meta_data_node      = NULL;
+        text_chunks->last_meta_data_node = &text_chunks->meta_data_node;
     }
 
     png_bytep exif;
     png_uint_32 exif_size;
 
-    if (png_get_eXIf_1(png_ptr, info_ptr, &exif_size, &exif) != 0) {
+    if (sail_load_meta_data_key(load_options, SAIL_META_DATA_EXIF) && png_get_eXIf_1(png_ptr, info_ptr, &exif_size, &exif) != 0) {
         struct sail_meta_data_node *meta_data_node;
 
         SAIL_TRY(sail_alloc_meta_data_node(&meta_data_node));
@@ -377,9 +737,10 @@ sail_status_t png_private_write_meta_data(png_structp png_ptr, png_infop info_pt
         png_text *lines = ptr;
 
         /* Indexes in 'lines' that must be freed. 1 = free, 0 = don't free. */
-        SAIL_TRY(sail_malloc(count * sizeof(bool), &ptr));
+        SAIL_TRY_OR_CLEANUP(sail_malloc(count * sizeof(int), &ptr),
+                            /* cleanup */ sail_free(lines));
         int *lines_to_free = ptr;
-        memset(lines_to_free, 0, count);
+        memset(lines_to_free, 0, count * sizeof(int));
 
         unsigned index = 0;
 
@@ -407,7 +768,7 @@ sail_status_t png_private_write_meta_data(png_structp png_ptr, png_infop info_pt
 
                 if (meta_data->key == SAIL_META_DATA_UNKNOWN) {
                     meta_data_key = meta_data->key_unknown;
-                    meta_data_value = (char *)meta_data->value;
+                    meta_data_value = sail_variant_to_string(meta_data->value);
                 } else {
                     if (meta_data->key == SAIL_META_DATA_IPTC) {
                         meta_data_key = "Raw profile type iptc";
@@ -534,92 +895,22 @@ sail_status_t png_private_fetch_palette(png_structp png_ptr, png_infop info_ptr,
 }
 
 #ifdef PNG_APNG_SUPPORTED
-sail_status_t png_private_blend_source(void *dst_raw, unsigned dst_offset, const void *src_raw, unsigned src_width, unsigned bytes_per_pixel) {
-
-    SAIL_CHECK_PTR(dst_raw);
-    SAIL_CHECK_PTR(src_raw);
-
-    memcpy((uint8_t *)dst_raw + dst_offset * bytes_per_pixel,
-            src_raw,
-            (size_t)src_width * bytes_per_pixel);
-
-    return SAIL_OK;
-}
-
-sail_status_t png_private_blend_over(void *dst_raw, unsigned dst_offset, const void *src_raw, unsigned width, enum SailPixelFormat pixel_format) {
-
-    SAIL_CHECK_PTR(src_raw);
-    SAIL_CHECK_PTR(dst_raw);
-
-    const unsigned bytes_per_pixel = sail_bits_per_pixel(pixel_format) / 8;
-
-    switch (pixel_format) {
-        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA: {
-            const uint8_t *src = src_raw;
-            uint8_t *dst = (uint8_t *)dst_raw + dst_offset * bytes_per_pixel;
-
-            while (width--) {
-                const double src_a = *(src+1) / 255.0;
-                const double dst_a = *(dst+1) / 255.0;
+enum SailAnimationDispose png_private_animation_dispose(png_byte dispose_op) {
 
-                *dst = (uint8_t)(src_a * (*src) + (1-src_a) * dst_a * (*dst)); src++; dst++;
-                *dst = (uint8_t)((src_a + (1-src_a) * dst_a) * 255);           src++; dst++;
-            }
-            break;
+    switch (dispose_op) {
+        case PNG_DISPOSE_OP_BACKGROUND: {
+            return SAIL_ANIMATION_DISPOSE_BACKGROUND;
         }
-        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: {
-            const uint16_t *src = src_raw;
-            uint16_t *dst = (uint16_t *)((uint8_t *)dst_raw + dst_offset * bytes_per_pixel);
-
-            while (width--) {
-                const double src_a = *(src+1) / 65535.0;
-                const double dst_a = *(dst+1) / 65535.0;
-
-                *dst = (uint16_t)(src_a * (*src) + (1-src_a) * dst_a * (*dst)); src++; dst++;
-                *dst = (uint16_t)((src_a + (1-src_a) * dst_a) * 65535);         src++; dst++;
-            }
-            break;
-        }
-        case SAIL_PIXEL_FORMAT_BPP32_RGBA: {
-            const uint8_t *src = src_raw;
-            uint8_t *dst = (uint8_t *)dst_raw + dst_offset * bytes_per_pixel;
-
-            while (width--) {
-                const double src_a = *(src+3) / 255.0;
-                const double dst_a = *(dst+3) / 255.0;
-
-                *dst = (uint8_t)(src_a * (*src) + (1-src_a) * dst_a * (*dst)); src++; dst++;
-                *dst = (uint8_t)(src_a * (*src) + (1-src_a) * dst_a * (*dst)); src++; dst++;
-                *dst = (uint8_t)(src_a * (*src) + (1-src_a) * dst_a * (*dst)); src++; dst++;
-                *dst = (uint8_t)((src_a + (1-src_a) * dst_a) * 255);           src++; dst++;
-            }
-            break;
-        }
-        case SAIL_PIXEL_FORMAT_BPP64_RGBA: {
-            const uint16_t *src = src_raw;
-            uint16_t *dst = (uint16_t *)((uint8_t *)dst_raw + dst_offset * bytes_per_pixel);
-
-            while (width--) {
-                const double src_a = *(src+3) / 65535.0;
-                const double dst_a = *(dst+3) / 65535.0;
-
-                *dst = (uint16_t)(src_a * (*src) + (1-src_a) * dst_a * (*dst)); src++; dst++;
-                *dst = (uint16_t)(src_a * (*src) + (1-src_a) * dst_a * (*dst)); src++; dst++;
-                *dst = (uint16_t)(src_a * (*src) + (1-src_a) * dst_a * (*dst)); src++; dst++;
-                *dst = (uint16_t)((src_a + (1-src_a) * dst_a) * 65535);         src++; dst++;
-            }
-            break;
+        case PNG_DISPOSE_OP_PREVIOUS: {
+            return SAIL_ANIMATION_DISPOSE_PREVIOUS;
         }
         default: {
-            SAIL_LOG_ERROR("Pixel format %s is not supported for blending operations", sail_pixel_format_to_string(pixel_format));
-            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+            return SAIL_ANIMATION_DISPOSE_NONE;
         }
     }
-
-    return SAIL_OK;
 }
 
-sail_status_t png_private_skip_hidden_frame(unsigned bytes_per_line, unsigned height, png_structp png_ptr, png_infop info_ptr, void **row) {
+sail_status_t png_private_skip_hidden_frame(unsigned width, unsigned height, unsigned bytes_per_line, bool interlaced, png_structp png_ptr, png_infop info_ptr, void **row) {
 
     SAIL_CHECK_PTR(png_ptr);
     SAIL_CHECK_PTR(info_ptr);
@@ -629,7 +920,9 @@ sail_status_t png_private_skip_hidden_frame(unsigned bytes_per_line, unsigned he
 
     png_read_frame_head(png_ptr, info_ptr);
 
-    for (unsigned i = 0; i < height; i++) {
+    const unsigned rows = interlaced ? png_private_interlaced_rows(width, height) : height;
+
+    for (unsigned i = 0; i < rows; i++) {
         png_read_row(png_ptr, (png_bytep)(*row), NULL);
     }
 
@@ -639,63 +932,139 @@ sail_status_t png_private_skip_hidden_frame(unsigned bytes_per_line, unsigned he
     return SAIL_OK;
 }
 
-sail_status_t png_private_alloc_rows(png_bytep **A, unsigned row_length, unsigned height) {
+sail_status_t png_private_store_num_frames_and_plays(png_structp png_ptr, png_infop info_ptr, struct sail_hash_map *special_properties) {
 
-    void *ptr;
-    SAIL_TRY(sail_malloc(height * sizeof(png_bytep), &ptr));
+    struct sail_variant *variant;
+    SAIL_TRY(sail_alloc_variant(&variant));
 
-    *A = ptr;
+    const unsigned num_frames = png_get_num_frames(png_ptr, info_ptr);
+    const unsigned num_plays = png_get_num_plays(png_ptr, info_ptr);
 
-    for (unsigned row = 0; row < height; row++) {
-        (*A)[row] = NULL;
-    }
+    SAIL_LOG_TRACE("PNG: Number of frames: %u", num_frames);
+    sail_set_variant_unsigned_int(variant, num_frames);
+    sail_put_hash_map(special_properties, "apng-frames", variant);
 
-    for (unsigned row = 0; row < height; row++) {
-        SAIL_TRY(sail_malloc(row_length, &ptr));
-        (*A)[row] = ptr;
+    SAIL_LOG_TRACE("PNG: Number of plays: %u", num_plays);
+    sail_set_variant_unsigned_int(variant, num_plays);
+    sail_put_hash_map(special_properties, "apng-plays", variant);
 
-        /* Set to the transparent background as per the APNG spec. */
-        memset((*A)[row], 0, row_length);
-    }
+    sail_destroy_variant(variant);
 
     return SAIL_OK;
 }
+#endif
 
-void png_private_destroy_rows(png_bytep **A, unsigned height) {
+unsigned png_private_interlaced_rows(unsigned width, unsigned height) {
+
+    unsigned rows = 0;
+
+    for (int pass = 0; pass < PNG_INTERLACE_ADAM7_PASSES; pass++) {
+        /* libpng skips empty passes. */
+        if (PNG_PASS_COLS(width, pass) > 0) {
+            rows += PNG_PASS_ROWS(height, pass);
+        }
+    }
+
+    return rows;
+}
+
+/* Copies the pixels of a compact pass row into their columns in the full row. */
+static void scatter_pass_row(const unsigned char *pass_row, unsigned char *row, unsigned cols, unsigned bits_per_pixel, int pass) {
+
+    const unsigned first_col = PNG_PASS_START_COL(pass);
+    const unsigned col_step  = 1U << PNG_PASS_COL_SHIFT(pass);
+
+    if (bits_per_pixel < 8) {
+        const unsigned mask = (1U << bits_per_pixel) - 1;
+
+        for (unsigned i = 0, x = first_col; i < cols; i++, x += col_step) {
+            const unsigned src_bit = i * bits_per_pixel;
+            const unsigned dst_bit = x * bits_per_pixel;
+            const unsigned value   = (pass_row[src_bit / 8] >> (8 - bits_per_pixel - src_bit % 8)) & mask;
+            const unsigned shift   = 8 - bits_per_pixel - dst_bit % 8;
+
+            row[dst_bit / 8] = (unsigned char)((row[dst_bit / 8] & ~(mask << shift)) | (value << shift));
+        }
 
-    if (*A == NULL) {
         return;
     }
 
-    for (unsigned row = 0; row < height; row++) {
-        sail_free((*A)[row]);
+    const unsigned bytes_per_pixel = bits_per_pixel / 8;
+
+    /* The last pass has all the columns. */
+    if (col_step == 1) {
+        memcpy(row, pass_row, (size_t)cols * bytes_per_pixel);
+        return;
     }
 
-    sail_free(*A);
-    *A = NULL;
+    /* Fixed sizes let the compiler replace memcpy() with plain moves. */
+    switch (bytes_per_pixel) {
+        case 1: {
+            for (unsigned i = 0, x = first_col; i < cols; i++, x += col_step) {
+                row[x] = pass_row[i];
+            }
+            break;
+        }
+        case 2: {
+            for (unsigned i = 0, x = first_col; i < cols; i++, x += col_step) {
+                memcpy(row + (size_t)x * 2, pass_row + (size_t)i * 2, 2);
+            }
+            break;
+        }
+        case 3: {
+            for (unsigned i = 0, x = first_col; i < cols; i++, x += col_step) {
+                memcpy(row + (size_t)x * 3, pass_row + (size_t)i * 3, 3);
+            }
+            break;
+        }
+        case 4: {
+            for (unsigned i = 0, x = first_col; i < cols; i++, x += col_step) {
+                memcpy(row + (size_t)x * 4, pass_row + (size_t)i * 4, 4);
+            }
+            break;
+        }
+        case 8: {
+            for (unsigned i = 0, x = first_col; i < cols; i++, x += col_step) {
+                memcpy(row + (size_t)x * 8, pass_row + (size_t)i * 8, 8);
+            }
+            break;
+        }
+        default: {
+            for (unsigned i = 0, x = first_col; i < cols; i++, x += col_step) {
+                memcpy(row + (size_t)x * bytes_per_pixel, pass_row + (size_t)i * bytes_per_pixel, bytes_per_pixel);
+            }
+            break;
+        }
+    }
 }
 
-sail_status_t png_private_store_num_frames_and_plays(png_structp png_ptr, png_infop info_ptr, struct sail_hash_map *special_properties) {
+sail_status_t png_private_read_deinterlaced(png_structp png_ptr, unsigned width, unsigned height, unsigned bits_per_pixel,
+                                            void *pixels, unsigned bytes_per_line, void *pass_row) {
 
-    struct sail_variant *variant;
-    SAIL_TRY(sail_alloc_variant(&variant));
+    SAIL_CHECK_PTR(png_ptr);
+    SAIL_CHECK_PTR(pixels);
+    SAIL_CHECK_PTR(pass_row);
 
-    const unsigned num_frames = png_get_num_frames(png_ptr, info_ptr);
-    const unsigned num_plays = png_get_num_plays(png_ptr, info_ptr);
+    for (int pass = 0; pass < PNG_INTERLACE_ADAM7_PASSES; pass++) {
+        const unsigned cols = PNG_PASS_COLS(width, pass);
 
-    SAIL_LOG_TRACE("PNG: Number of frames: %u", num_frames);
-    sail_set_variant_unsigned_int(variant, num_frames);
-    sail_put_hash_map(special_properties, "apng-frames", variant);
+        /* libpng skips empty passes. */
+        if (cols == 0) {
+            continue;
+        }
 
-    SAIL_LOG_TRACE("PNG: Number of plays: %u", num_plays);
-    sail_set_variant_unsigned_int(variant, num_plays);
-    sail_put_hash_map(special_properties, "apng-plays", variant);
+        const unsigned rows = PNG_PASS_ROWS(height, pass);
 
-    sail_destroy_variant(variant);
+        for (unsigned pass_row_index = 0; pass_row_index < rows; pass_row_index++) {
+            png_read_row(png_ptr, pass_row, NULL);
+
+            const unsigned row = PNG_ROW_FROM_PASS_ROW(pass_row_index, pass);
+            scatter_pass_row(pass_row, (unsigned char *)pixels + (size_t)row * bytes_per_line, cols, bits_per_pixel, pass);
+        }
+    }
 
     return SAIL_OK;
 }
-#endif
 
 sail_status_t png_private_fetch_resolution(png_structp png_ptr, png_infop info_ptr, struct sail_resolution **resolution) {
 
@@ -754,7 +1123,7 @@ sail_status_t png_private_write_resolution(png_structp png_ptr, png_infop info_p
 
 bool png_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
 
-    png_structp png_ptr = user_data;
+    struct png_private_save_tuning *save_tuning = user_data;
 
     if (strcmp(key, "png-filter") == 0) {
         if (value->type == SAIL_VARIANT_TYPE_STRING) {
@@ -787,7 +1156,60 @@ bool png_private_tuning_key_value_callback(const char *key, const struct sail_va
 
             sail_destroy_string_node_chain(string_node_filters);
 
-            png_set_filter(png_ptr, 0, filters);
+            png_set_filter(save_tuning->png_ptr, 0, filters);
+            save_tuning->filters = filters;
+        }
+    } else if (strcmp(key, "png-preset") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_STRING) {
+            const char *str_value = sail_variant_to_string(value);
+
+            if (strcmp(str_value, "fast") == 0) {
+                SAIL_LOG_TRACE("PNG: Applying FAST preset");
+                save_tuning->preset_filters    = PNG_FILTER_NONE;
+                save_tuning->compression_level = 1;
+                save_tuning->strategy          = Z_RLE;
+            } else if (strcmp(str_value, "balanced") == 0) {
+                SAIL_LOG_TRACE("PNG: Applying BALANCED preset");
+                save_tuning->preset_filters    = PNG_FILTER_SUB | PNG_FILTER_UP | PNG_FILTER_PAETH;
+                save_tuning->compression_level = 6;
+                save_tuning->strategy          = Z_FILTERED;
+            } else if (strcmp(str_value, "max") == 0) {
+                SAIL_LOG_TRACE("PNG: Applying MAX preset");
+                save_tuning->preset_filters    = PNG_ALL_FILTERS;
+                save_tuning->compression_level = 9;
+                save_tuning->strategy          = Z_FILTERED;
+            } else {
+                SAIL_LOG_WARNING("PNG: Unknown preset '%s'", str_value);
+            }
+        }
+    } else if (strcmp(key, "png-threads") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned threads = sail_variant_to_unsigned_int(value);
+
+            if (threads > 0) {
+                SAIL_LOG_TRACE("PNG: Encoding in %u threads", threads);
+                save_tuning->threads = threads;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool png_private_load_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    png_structp png_ptr = user_data;
+
+    if (strcmp(key, "png-skip-checksums") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_BOOL) {
+            if (sail_variant_to_bool(value)) {
+                SAIL_LOG_TRACE("PNG: Skipping CRC and Adler-32 checksums");
+
+                png_set_crc_action(png_ptr, PNG_CRC_QUIET_USE, PNG_CRC_QUIET_USE);
+#if defined(PNG_SET_OPTION_SUPPORTED) && defined(PNG_IGNORE_ADLER32)
+                png_set_option(png_ptr, PNG_IGNORE_ADLER32, PNG_OPTION_ON);
+#endif
+            }
         }
     }
 
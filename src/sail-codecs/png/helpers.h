@@ -35,13 +35,23 @@
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
+#include "common/animation/animation.h"
+
 struct sail_hash_map;
 struct sail_iccp;
+struct sail_load_options;
 struct sail_meta_data_node;
 struct sail_palette;
 struct sail_resolution;
 struct sail_variant;
 
+/* Texts of zTXt and iTXt chunks read manually to skip the meta data keys that are not selected. */
+struct png_private_text_chunks {
+    const struct sail_load_options *load_options;
+    struct sail_meta_data_node *meta_data_node;
+    struct sail_meta_data_node **last_meta_data_node;
+};
+
 SAIL_HIDDEN void png_private_my_error_fn(png_structp png_ptr, png_const_charp text);
 
 SAIL_HIDDEN void png_private_my_warning_fn(png_structp png_ptr, png_const_charp text);
@@ -54,7 +64,23 @@ SAIL_HIDDEN enum SailPixelFormat png_private_png_color_type_to_pixel_format(int
 
 SAIL_HIDDEN sail_status_t png_private_pixel_format_to_png_color_type(enum SailPixelFormat pixel_format, int *color_type, int *bit_depth);
 
-SAIL_HIDDEN sail_status_t png_private_fetch_meta_data(png_structp png_ptr, png_infop info_ptr, struct sail_meta_data_node **target_meta_data_node);
+/*
+ * Sets up libpng transformations to decode an image of the specified color type and bit depth
+ * into the requested pixel format. Returns false and sets up nothing if libpng cannot produce it.
+ */
+SAIL_HIDDEN bool png_private_set_output_pixel_format(png_structp png_ptr, png_infop info_ptr, int color_type, int bit_depth, enum SailPixelFormat pixel_format);
+
+/*
+ * Sets up libpng to skip the text and EXIF chunks with the meta data keys that are not selected
+ * in the load options. Must be called before png_read_info().
+ */
+SAIL_HIDDEN void png_private_select_meta_data(png_structp png_ptr, const struct sail_load_options *load_options, struct png_private_text_chunks *text_chunks);
+
+/*
+ * Fetches the selected meta data, and moves the texts read into 'text_chunks' to the target.
+ */
+SAIL_HIDDEN sail_status_t png_private_fetch_meta_data(png_structp png_ptr, png_infop info_ptr, const struct sail_load_options *load_options,
+                                                      struct png_private_text_chunks *text_chunks, struct sail_meta_data_node **target_meta_data_node);
 
 SAIL_HIDDEN sail_status_t png_private_write_meta_data(png_structp png_ptr, png_infop info_ptr, const struct sail_meta_data_node *meta_data_node);
 
@@ -63,23 +89,41 @@ SAIL_HIDDEN sail_status_t png_private_fetch_iccp(png_structp png_ptr, png_infop
 SAIL_HIDDEN sail_status_t png_private_fetch_palette(png_structp png_ptr, png_infop info_ptr, struct sail_palette **palette);
 
 #ifdef PNG_APNG_SUPPORTED
-SAIL_HIDDEN sail_status_t png_private_blend_source(void *dst_raw, unsigned dst_offset, const void *src_raw, unsigned src_width, unsigned bytes_per_pixel);
-
-SAIL_HIDDEN sail_status_t png_private_blend_over(void *dst_raw, unsigned dst_offset, const void *src_raw, unsigned width, enum SailPixelFormat pixel_format);
-
-SAIL_HIDDEN sail_status_t png_private_skip_hidden_frame(unsigned bytes_per_line, unsigned height, png_structp png_ptr, png_infop info_ptr, void **row);
+SAIL_HIDDEN enum SailAnimationDispose png_private_animation_dispose(png_byte dispose_op);
 
-SAIL_HIDDEN sail_status_t png_private_alloc_rows(png_bytep **A, unsigned row_length, unsigned height);
-
-SAIL_HIDDEN void png_private_destroy_rows(png_bytep **A, unsigned height);
+SAIL_HIDDEN sail_status_t png_private_skip_hidden_frame(unsigned width, unsigned height, unsigned bytes_per_line, bool interlaced, png_structp png_ptr, png_infop info_ptr, void **row);
 
 SAIL_HIDDEN sail_status_t png_private_store_num_frames_and_plays(png_structp png_ptr, png_infop info_ptr, struct sail_hash_map *special_properties);
 #endif
 
+/* Returns the number of rows libpng reads from an Adam7 image without the interlace handling. */
+SAIL_HIDDEN unsigned png_private_interlaced_rows(unsigned width, unsigned height);
+
+/*
+ * Reads all the Adam7 passes of the current frame compactly and scatters their pixels into the frame.
+ * The interlace handling must be disabled in libpng. 'pass_row' must hold one frame row.
+ */
+SAIL_HIDDEN sail_status_t png_private_read_deinterlaced(png_structp png_ptr, unsigned width, unsigned height, unsigned bits_per_pixel,
+                                                        void *pixels, unsigned bytes_per_line, void *pass_row);
+
 SAIL_HIDDEN sail_status_t png_private_fetch_resolution(png_structp png_ptr, png_infop info_ptr, struct sail_resolution **resolution);
 
 SAIL_HIDDEN sail_status_t png_private_write_resolution(png_structp png_ptr, png_infop info_ptr, const struct sail_resolution *resolution);
 
+/* Save tuning collected by png_private_tuning_key_value_callback(). */
+struct png_private_save_tuning {
+    png_structp png_ptr;
+    int filters;           /* PNG_FILTER_* values, or -1 when not set. */
+    unsigned threads;      /* Bands to encode in parallel. */
+
+    /* Set by "png-preset". -1 when not set. Explicit "png-filter" wins over the preset filters. */
+    int preset_filters;
+    int compression_level;
+    int strategy;
+};
+
 SAIL_HIDDEN bool png_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
 
+SAIL_HIDDEN bool png_private_load_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
 #endif
@@ -53,9 +53,9 @@ void png_private_my_write_fn(png_structp png_ptr, png_bytep bytes, png_size_t by
         return;
     }
 
-    struct sail_io *io = png_get_io_ptr(png_ptr);
+    struct sail_buffered_writer *writer = png_get_io_ptr(png_ptr);
 
-    sail_status_t err = io->strict_write(io->stream, bytes, bytes_size);
+    sail_status_t err = sail_buffered_writer_strict_write(writer, bytes, bytes_size);
 
     if (err != SAIL_OK) {
         png_error(png_ptr, "Failed to write to the I/O stream");
@@ -68,9 +68,13 @@ void png_private_my_flush_fn(png_structp png_ptr) {
         return;
     }
 
-    struct sail_io *io = png_get_io_ptr(png_ptr);
+    struct sail_buffered_writer *writer = png_get_io_ptr(png_ptr);
 
-    sail_status_t err = io->flush(io->stream);
+    sail_status_t err = sail_buffered_writer_flush(writer);
+
+    if (err == SAIL_OK) {
+        err = writer->io->flush(writer->io->stream);
+    }
 
     if (err != SAIL_OK) {
         png_error(png_ptr, "Failed to flush the I/O stream");
@@ -0,0 +1,489 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <png.h>
+#include <zlib.h>
+
+#include <sail-common/sail-common.h>
+
+#include "parallel.h"
+
+/*
+ * Private functions.
+ */
+
+/* Every band but the first one is primed with the tail of the previous band to keep the compression ratio. */
+#define DEFLATE_WINDOW_SIZE 32768
+
+/* zlib counts bytes in unsigned ints, so feed it in pieces. */
+#define ZLIB_MAX_PIECE ((size_t)1 << 30)
+
+struct band {
+
+    /* Input. */
+    const uint8_t *pixels;
+    const uint8_t *zero_row;
+    size_t row_bytes;
+    unsigned bytes_per_pixel;
+    unsigned first_row;
+    unsigned rows;
+    int filters;
+    int compression_level;
+    int strategy;
+    bool last;
+    const struct band *previous;
+
+    /* Output. */
+    uint8_t *filtered;
+    size_t filtered_size;
+    uLong adler;
+    uint8_t *compressed;
+    size_t compressed_size;
+    sail_status_t status;
+
+    void (*routine)(struct band *band);
+};
+
+static unsigned paeth_predictor(unsigned a, unsigned b, unsigned c) {
+
+    const int p  = (int)a + (int)b - (int)c;
+    const int pa = abs(p - (int)a);
+    const int pb = abs(p - (int)b);
+    const int pc = abs(p - (int)c);
+
+    if (pa <= pb && pa <= pc) {
+        return a;
+    } else if (pb <= pc) {
+        return b;
+    } else {
+        return c;
+    }
+}
+
+static void filter_row(int filter_value, const uint8_t *row, const uint8_t *prev, size_t row_bytes, unsigned bpp, uint8_t *out) {
+
+    *out++ = (uint8_t)filter_value;
+
+    switch (filter_value) {
+        case PNG_FILTER_VALUE_NONE: {
+            memcpy(out, row, row_bytes);
+            break;
+        }
+        case PNG_FILTER_VALUE_SUB: {
+            for (size_t i = 0; i < row_bytes; i++) {
+                out[i] = (uint8_t)(row[i] - (i >= bpp ? row[i - bpp] : 0));
+            }
+            break;
+        }
+        case PNG_FILTER_VALUE_UP: {
+            for (size_t i = 0; i < row_bytes; i++) {
+                out[i] = (uint8_t)(row[i] - prev[i]);
+            }
+            break;
+        }
+        case PNG_FILTER_VALUE_AVG: {
+            for (size_t i = 0; i < row_bytes; i++) {
+                const unsigned left = (i >= bpp) ? row[i - bpp] : 0;
+                out[i] = (uint8_t)(row[i] - ((left + prev[i]) >> 1));
+            }
+            break;
+        }
+        case PNG_FILTER_VALUE_PAETH: {
+            for (size_t i = 0; i < row_bytes; i++) {
+                const unsigned left       = (i >= bpp) ? row[i - bpp]  : 0;
+                const unsigned upper_left = (i >= bpp) ? prev[i - bpp] : 0;
+                out[i] = (uint8_t)(row[i] - paeth_predictor(left, prev[i], upper_left));
+            }
+            break;
+        }
+    }
+}
+
+/* The same heuristic libpng uses: the sum of the filtered bytes taken as signed values. */
+static size_t filtered_row_cost(const uint8_t *filtered, size_t row_bytes) {
+
+    size_t cost = 0;
+
+    for (size_t i = 1; i <= row_bytes; i++) {
+        cost += (filtered[i] < 128) ? filtered[i] : 256 - filtered[i];
+    }
+
+    return cost;
+}
+
+static void filter_band(struct band *band) {
+
+    static const int FILTER_MASKS[] = { PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, PNG_FILTER_AVG, PNG_FILTER_PAETH };
+    static const int FILTER_VALUES[] = { PNG_FILTER_VALUE_NONE, PNG_FILTER_VALUE_SUB, PNG_FILTER_VALUE_UP, PNG_FILTER_VALUE_AVG, PNG_FILTER_VALUE_PAETH };
+
+    const size_t filtered_row_bytes = band->row_bytes + 1;
+
+    band->filtered_size = (size_t)band->rows * filtered_row_bytes;
+
+    void *ptr;
+    SAIL_TRY_OR_EXECUTE(sail_malloc(band->filtered_size + filtered_row_bytes, &ptr),
+                        /* on error */ band->status = __sail_status; return);
+    band->filtered = ptr;
+
+    /* Scratch row to try filters into. */
+    uint8_t *candidate = band->filtered + band->filtered_size;
+
+    unsigned filters_count = 0;
+    for (size_t i = 0; i < sizeof(FILTER_MASKS) / sizeof(FILTER_MASKS[0]); i++) {
+        if (band->filters & FILTER_MASKS[i]) {
+            filters_count++;
+        }
+    }
+
+    for (unsigned r = 0; r < band->rows; r++) {
+        const unsigned row_index = band->first_row + r;
+        const uint8_t *row  = band->pixels + (size_t)row_index * band->row_bytes;
+        const uint8_t *prev = (row_index == 0) ? band->zero_row : row - band->row_bytes;
+        uint8_t *out = band->filtered + (size_t)r * filtered_row_bytes;
+
+        if (filters_count <= 1) {
+            int filter_value = PNG_FILTER_VALUE_NONE;
+
+            for (size_t i = 0; i < sizeof(FILTER_MASKS) / sizeof(FILTER_MASKS[0]); i++) {
+                if (band->filters & FILTER_MASKS[i]) {
+                    filter_value = FILTER_VALUES[i];
+                }
+            }
+
+            filter_row(filter_value, row, prev, band->row_bytes, band->bytes_per_pixel, out);
+            continue;
+        }
+
+        size_t best_cost = SIZE_MAX;
+
+        for (size_t i = 0; i < sizeof(FILTER_MASKS) / sizeof(FILTER_MASKS[0]); i++) {
+            if ((band->filters & FILTER_MASKS[i]) == 0) {
+                continue;
+            }
+
+            uint8_t *target = (best_cost == SIZE_MAX) ? out : candidate;
+            filter_row(FILTER_VALUES[i], row, prev, band->row_bytes, band->bytes_per_pixel, target);
+
+            const size_t cost = filtered_row_cost(target, band->row_bytes);
+
+            if (cost < best_cost) {
+                if (target == candidate) {
+                    memcpy(out, candidate, filtered_row_bytes);
+                }
+                best_cost = cost;
+            }
+        }
+    }
+
+    band->adler = adler32(0, NULL, 0);
+
+    for (size_t offset = 0; offset < band->filtered_size; offset += ZLIB_MAX_PIECE) {
+        const size_t piece = (band->filtered_size - offset < ZLIB_MAX_PIECE) ? band->filtered_size - offset : ZLIB_MAX_PIECE;
+        band->adler = adler32(band->adler, band->filtered + offset, (uInt)piece);
+    }
+
+    band->status = SAIL_OK;
+}
+
+static void deflate_band(struct band *band) {
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+
+    /* libpng's default: filtered data compresses better with Z_FILTERED. */
+    const int strategy = (band->strategy >= 0)
+                            ? band->strategy
+                            : (band->filters == PNG_FILTER_NONE) ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+
+    /* Raw deflate. The zlib header and trailer are written once for all bands. */
+    if (deflateInit2(&stream, band->compression_level, Z_DEFLATED, -15, 8, strategy) != Z_OK) {
+        SAIL_LOG_ERROR("PNG: Failed to initialize deflate");
+        band->status = SAIL_ERROR_UNDERLYING_CODEC;
+        return;
+    }
+
+    if (band->previous != NULL) {
+        const size_t dictionary_size = (band->previous->filtered_size < DEFLATE_WINDOW_SIZE)
+                                        ? band->previous->filtered_size
+                                        : DEFLATE_WINDOW_SIZE;
+
+        deflateSetDictionary(&stream,
+                             band->previous->filtered + band->previous->filtered_size - dictionary_size,
+                             (uInt)dictionary_size);
+    }
+
+    /* Room for the sync flush marker. */
+    size_t capacity = deflateBound(&stream, (uLong)band->filtered_size) + 64;
+
+    void *ptr;
+    SAIL_TRY_OR_EXECUTE(sail_malloc(capacity, &ptr),
+                        /* on error */ deflateEnd(&stream); band->status = __sail_status; return);
+    band->compressed = ptr;
+
+    const uint8_t *input = band->filtered;
+    size_t input_left    = band->filtered_size;
+
+    for (;;) {
+        if (stream.avail_in == 0 && input_left > 0) {
+            const size_t piece = (input_left < ZLIB_MAX_PIECE) ? input_left : ZLIB_MAX_PIECE;
+
+            stream.next_in  = (Bytef *)input;
+            stream.avail_in = (uInt)piece;
+
+            input      += piece;
+            input_left -= piece;
+        }
+
+        if (band->compressed_size == capacity) {
+            capacity += capacity / 2;
+
+            ptr = band->compressed;
+            SAIL_TRY_OR_EXECUTE(sail_realloc(capacity, &ptr),
+                                /* on error */ deflateEnd(&stream); band->status = __sail_status; return);
+            band->compressed = ptr;
+        }
+
+        const size_t space = (capacity - band->compressed_size < ZLIB_MAX_PIECE) ? capacity - band->compressed_size : ZLIB_MAX_PIECE;
+
+        stream.next_out  = band->compressed + band->compressed_size;
+        stream.avail_out = (uInt)space;
+
+        /* Only the last band finishes the stream. Others end on a byte boundary. */
+        const int flush = (input_left > 0) ? Z_NO_FLUSH : (band->last ? Z_FINISH : Z_SYNC_FLUSH);
+        const int ret = deflate(&stream, flush);
+
+        band->compressed_size += space - stream.avail_out;
+
+        if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+            SAIL_LOG_ERROR("PNG: Failed to deflate. Error: %d", ret);
+            deflateEnd(&stream);
+            band->status = SAIL_ERROR_UNDERLYING_CODEC;
+            return;
+        }
+
+        if (flush == Z_FINISH && ret == Z_STREAM_END) {
+            break;
+        }
+        if (flush == Z_SYNC_FLUSH && stream.avail_in == 0 && stream.avail_out > 0) {
+            break;
+        }
+    }
+
+    deflateEnd(&stream);
+
+    band->status = SAIL_OK;
+}
+
+static void band_task(void *user_data, unsigned task, unsigned thread) {
+
+    (void)thread;
+
+    struct band *bands = user_data;
+    bands[task].routine(&bands[task]);
+}
+
+/* Runs the routine over all bands on the thread pool. */
+static void run_bands(struct band *bands, unsigned bands_count, void (*routine)(struct band *band)) {
+
+    for (unsigned i = 0; i < bands_count; i++) {
+        bands[i].routine = routine;
+    }
+
+    sail_thread_pool_run(bands_count, band_task, bands);
+}
+
+static sail_status_t bands_status(const struct band *bands, unsigned bands_count) {
+
+    for (unsigned i = 0; i < bands_count; i++) {
+        SAIL_TRY(bands[i].status);
+    }
+
+    return SAIL_OK;
+}
+
+static void destroy_bands(struct band *bands, unsigned bands_count) {
+
+    for (unsigned i = 0; i < bands_count; i++) {
+        sail_free(bands[i].filtered);
+        sail_free(bands[i].compressed);
+    }
+
+    sail_free(bands);
+}
+
+/* Writes the zlib header the same way deflate() does. */
+static void write_zlib_header(int compression_level, int strategy, uint8_t *header) {
+
+    unsigned level_flags;
+
+    if (strategy >= Z_HUFFMAN_ONLY || compression_level < 2) {
+        level_flags = 0;
+    } else if (compression_level < 6) {
+        level_flags = 1;
+    } else if (compression_level == 6) {
+        level_flags = 2;
+    } else {
+        level_flags = 3;
+    }
+
+    unsigned value = (0x78 << 8) | (level_flags << 6);
+    value += 31 - (value % 31);
+
+    header[0] = (uint8_t)(value >> 8);
+    header[1] = (uint8_t)(value & 0xFF);
+}
+
+/*
+ * Public functions.
+ */
+
+void png_private_copy_row_in_file_order(const void *src, void *dst, size_t row_bytes, unsigned channels,
+                                        unsigned sample_size, bool swap_alpha, bool bgr, bool swap16) {
+
+    if ((!swap_alpha && !bgr) || sample_size == 0) {
+        memcpy(dst, src, row_bytes);
+    } else {
+        const unsigned pixel_size = channels * sample_size;
+        const uint8_t *src_pixel  = src;
+        uint8_t *dst_pixel        = dst;
+
+        for (size_t i = 0; i < row_bytes / pixel_size; i++, src_pixel += pixel_size, dst_pixel += pixel_size) {
+            if (swap_alpha) {
+                memcpy(dst_pixel, src_pixel + sample_size, pixel_size - sample_size);
+                memcpy(dst_pixel + pixel_size - sample_size, src_pixel, sample_size);
+            } else {
+                memcpy(dst_pixel, src_pixel, pixel_size);
+            }
+
+            if (bgr) {
+                for (unsigned s = 0; s < sample_size; s++) {
+                    const uint8_t blue = dst_pixel[s];
+                    dst_pixel[s] = dst_pixel[2 * sample_size + s];
+                    dst_pixel[2 * sample_size + s] = blue;
+                }
+            }
+        }
+    }
+
+    /* Swapping bytes is symmetric, so the same kernel converts host order samples into big-endian ones. */
+    if (swap16 && sample_size == 2) {
+        sail_be16_to_host(dst, dst, row_bytes / 2, 0);
+    }
+}
+
+sail_status_t png_private_deflate_parallel(const void *pixels, unsigned height, size_t row_bytes,
+                                           unsigned bytes_per_pixel, int filters, int compression_level,
+                                           int strategy, unsigned threads, void **data, size_t *data_size) {
+
+    SAIL_CHECK_PTR(pixels);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(data_size);
+
+    if (height == 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    const unsigned bands_count = (threads == 0) ? 1 : (threads > height ? height : threads);
+
+    void *ptr;
+    SAIL_TRY(sail_calloc(1, row_bytes, &ptr));
+    uint8_t *zero_row = ptr;
+
+    SAIL_TRY_OR_CLEANUP(sail_calloc(bands_count, sizeof(struct band), &ptr),
+                        /* cleanup */ sail_free(zero_row));
+    struct band *bands = ptr;
+
+    unsigned first_row = 0;
+
+    for (unsigned i = 0; i < bands_count; i++) {
+        struct band *band = &bands[i];
+
+        band->pixels            = pixels;
+        band->zero_row          = zero_row;
+        band->row_bytes         = row_bytes;
+        band->bytes_per_pixel   = (bytes_per_pixel == 0) ? 1 : bytes_per_pixel;
+        band->first_row         = first_row;
+        band->rows              = height / bands_count + (i < height % bands_count ? 1 : 0);
+        band->filters           = filters;
+        band->compression_level = compression_level;
+        band->strategy          = strategy;
+        band->last              = i + 1 == bands_count;
+        band->previous          = (i == 0) ? NULL : &bands[i - 1];
+        band->status            = SAIL_ERROR_UNDERLYING_CODEC;
+
+        first_row += band->rows;
+    }
+
+    run_bands(bands, bands_count, filter_band);
+    SAIL_TRY_OR_CLEANUP(bands_status(bands, bands_count),
+                        /* cleanup */ destroy_bands(bands, bands_count), sail_free(zero_row));
+
+    run_bands(bands, bands_count, deflate_band);
+    SAIL_TRY_OR_CLEANUP(bands_status(bands, bands_count),
+                        /* cleanup */ destroy_bands(bands, bands_count), sail_free(zero_row));
+
+    sail_free(zero_row);
+
+    /* Concatenate the bands into a single zlib stream. */
+    uLong adler = bands[0].adler;
+    size_t size = 2 + 4;
+
+    for (unsigned i = 0; i < bands_count; i++) {
+        if (i > 0) {
+            adler = adler32_combine(adler, bands[i].adler, (z_off_t)bands[i].filtered_size);
+        }
+        size += bands[i].compressed_size;
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(size, &ptr),
+                        /* cleanup */ destroy_bands(bands, bands_count));
+    uint8_t *stream = ptr;
+
+    write_zlib_header(compression_level, strategy, stream);
+    size_t offset = 2;
+
+    for (unsigned i = 0; i < bands_count; i++) {
+        memcpy(stream + offset, bands[i].compressed, bands[i].compressed_size);
+        offset += bands[i].compressed_size;
+    }
+
+    stream[offset++] = (uint8_t)(adler >> 24);
+    stream[offset++] = (uint8_t)(adler >> 16);
+    stream[offset++] = (uint8_t)(adler >> 8);
+    stream[offset++] = (uint8_t)adler;
+
+    destroy_bands(bands, bands_count);
+
+    *data      = stream;
+    *data_size = size;
+
+    return SAIL_OK;
+}
@@ -0,0 +1,57 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_PNG_PARALLEL_H
+#define SAIL_PNG_PARALLEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+/*
+ * Copies a row of pixels converting it into the PNG sample order. 'swap_alpha' moves the leading alpha
+ * sample to the end like png_set_swap_alpha(), 'bgr' swaps the red and blue samples like png_set_bgr(),
+ * 'swap16' swaps bytes of 16-bit samples like png_set_swap().
+ */
+SAIL_HIDDEN void png_private_copy_row_in_file_order(const void *src, void *dst, size_t row_bytes, unsigned channels,
+                                                    unsigned sample_size, bool swap_alpha, bool bgr, bool swap16);
+
+/*
+ * Filters and compresses the rows in 'threads' bands in parallel. Every band is deflated independently
+ * and ends with a sync flush, so the bands are concatenated into a single zlib stream that any PNG
+ * decoder reads. 'filters' is a combination of PNG_FILTER_* values to choose from for every row.
+ * 'strategy' is a zlib strategy, or -1 to pick one like libpng does.
+ *
+ * The returned data must be split into IDAT chunks. It must be freed with sail_free().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t png_private_deflate_parallel(const void *pixels, unsigned height, size_t row_bytes,
+                                                       unsigned bytes_per_pixel, int filters, int compression_level,
+                                                       int strategy, unsigned threads, void **data, size_t *data_size);
+
+#endif
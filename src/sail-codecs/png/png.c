@@ -34,8 +34,11 @@
 
 #include <sail-common/sail-common.h>
 
+#include "common/animation/animation.h"
+
 #include "helpers.h"
 #include "io.h"
+#include "parallel.h"
 
 /*
  * Codec-specific data types.
@@ -45,6 +48,9 @@ static const double COMPRESSION_MIN     = 1;
 static const double COMPRESSION_MAX     = 9;
 static const double COMPRESSION_DEFAULT = 6;
 
+/* Maximum size of IDAT chunks written by the parallel encoder. */
+static const size_t PARALLEL_IDAT_CHUNK_SIZE = 1024 * 1024;
+
 /*
  * Codec-specific state.
  */
@@ -59,16 +65,54 @@ struct png_state {
     int interlace_type;
 
     struct sail_image *first_image;
+    struct png_private_text_chunks text_chunks;
     int interlaced_passes;
     bool libpng_error;
     bool frame_saved;
     int frames;
     int current_frame;
 
+    /* Coalesces small chunk writes from libpng. */
+    struct sail_buffered_writer writer;
+
+    /* Interlaced frame buffered for the row callbacks. */
+    void *interlaced_pixels;
+
+    /* Compact row of an Adam7 pass. */
+    void *pass_row;
+
+    /* png_read_update_info() has been called. */
+    bool info_updated;
+
+    /* Incremental loading. The frame the progressive reader decodes into, and the rows it updated. */
+    bool push_header_read;
+    bool push_frame_done;
+    sail_status_t push_status;
+    struct sail_image *push_image;
+    bool push_rows;
+    unsigned push_first_row;
+    unsigned push_last_row;
+    size_t push_unprocessed;
+
+    /* Saving. */
+    int compression_level;
+    int preset_compression_level;
+    int strategy;
+    int filters;
+    unsigned threads;
+    bool swap_alpha;
+    bool bgr;
+    bool swap16;
+
+    /* Compressed frame written by the parallel encoder. */
+    void *parallel_idat;
+    bool parallel_idat_written;
+
     /* APNG-specific. */
 #ifdef PNG_APNG_SUPPORTED
     bool is_apng;
-    unsigned bytes_per_pixel;
+    bool dirty_only;
+    struct animation_canvas *canvas;
 
     png_uint_32 next_frame_width;
     png_uint_32 next_frame_height;
@@ -80,9 +124,6 @@ struct png_state {
     png_byte next_frame_blend_op;
 
     bool skipped_hidden;
-    png_bytep *prev;
-    /* Temporary scanline to read into. We need it for blending. */
-    void *temp_scanline;
     /* Scan line for skipping a first hidden frame. */
     void *scanline_for_skipping;
 #endif
@@ -106,16 +147,43 @@ static sail_status_t alloc_png_state(const struct sail_load_options *load_option
         .bit_depth         = 0,
         .interlace_type    = 0,
         .first_image       = NULL,
+        .text_chunks       = { NULL, NULL, NULL },
         .interlaced_passes = 0,
         .libpng_error      = false,
         .frame_saved       = false,
         .frames            = 0,
         .current_frame     = 0,
 
+        .writer            = { NULL, NULL, 0, 0 },
+        .interlaced_pixels = NULL,
+        .pass_row          = NULL,
+        .info_updated      = false,
+
+        .push_header_read = false,
+        .push_frame_done  = false,
+        .push_status      = SAIL_OK,
+        .push_image       = NULL,
+        .push_rows        = false,
+        .push_first_row   = 0,
+        .push_last_row    = 0,
+        .push_unprocessed = 0,
+
+        .compression_level        = (int)COMPRESSION_DEFAULT,
+        .preset_compression_level = -1,
+        .strategy                 = -1,
+        .filters                  = -1,
+        .threads                  = 1,
+        .swap_alpha               = false,
+        .bgr                      = false,
+        .swap16                   = false,
+        .parallel_idat            = NULL,
+        .parallel_idat_written    = false,
+
 /* APNG-specific. */
 #ifdef PNG_APNG_SUPPORTED
         .is_apng               = false,
-        .bytes_per_pixel       = 0,
+        .dirty_only            = false,
+        .canvas                = NULL,
 
         .next_frame_width      = 0,
         .next_frame_height     = 0,
@@ -127,8 +195,6 @@ static sail_status_t alloc_png_state(const struct sail_load_options *load_option
         .next_frame_blend_op   = PNG_BLEND_OP_SOURCE,
 
         .skipped_hidden        = false,
-        .prev                  = NULL,
-        .temp_scanline         = NULL,
         .scanline_for_skipping = NULL,
 #endif
     };
@@ -143,51 +209,94 @@ static void destroy_png_state(struct png_state *png_state) {
     }
 
 #ifdef PNG_APNG_SUPPORTED
-    sail_free(png_state->temp_scanline);
     sail_free(png_state->scanline_for_skipping);
-
-    if (png_state->first_image != NULL) {
-        png_private_destroy_rows(&png_state->prev, png_state->first_image->height);
-    }
+    animation_private_destroy_canvas(png_state->canvas);
 #endif
 
     sail_destroy_image(png_state->first_image);
+    sail_destroy_meta_data_node_chain(png_state->text_chunks.meta_data_node);
+    sail_free(png_state->interlaced_pixels);
+    sail_free(png_state->pass_row);
+    sail_free(png_state->parallel_idat);
+
+    /* Frees the writer if saving failed before finishing. */
+    sail_finish_buffered_writer(&png_state->writer);
 
     sail_free(png_state);
 }
 
 /*
- * Decoding functions.
+ * Filters and compresses the frame in bands in parallel, and writes it as IDAT chunks bypassing libpng.
+ * libpng transformations are applied to the rows manually. The frame must not be interlaced.
  */
+static sail_status_t save_frame_parallel(struct png_state *png_state, const struct sail_image *image) {
 
-SAIL_EXPORT sail_status_t sail_codec_load_init_v8_png(struct sail_io *io, const struct sail_load_options *load_options, void **state) {
+    const size_t row_bytes         = png_get_rowbytes(png_state->png_ptr, png_state->info_ptr);
+    const unsigned channels        = png_get_channels(png_state->png_ptr, png_state->info_ptr);
+    const unsigned bit_depth       = png_get_bit_depth(png_state->png_ptr, png_state->info_ptr);
+    const unsigned bytes_per_pixel = (channels * bit_depth + 7) / 8;
 
-    *state = NULL;
-
-    /* Allocate a new state. */
-    struct png_state *png_state;
-    SAIL_TRY(alloc_png_state(load_options, NULL, &png_state));
-    *state = png_state;
+    /* The same default libpng uses. */
+    int filters = png_state->filters;
 
-    /* Initialize PNG. */
-    if ((png_state->png_ptr = png_create_read_struct_2(PNG_LIBPNG_VER_STRING, NULL, png_private_my_error_fn, png_private_my_warning_fn, NULL, png_private_my_malloc_fn, png_private_my_free_fn)) == NULL) {
-        png_state->libpng_error = true;
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    if (filters <= 0) {
+        filters = (png_get_color_type(png_state->png_ptr, png_state->info_ptr) == PNG_COLOR_TYPE_PALETTE || bit_depth < 8)
+                    ? PNG_FILTER_NONE
+                    : PNG_ALL_FILTERS;
     }
 
-    if ((png_state->info_ptr = png_create_info_struct(png_state->png_ptr)) == NULL) {
-        png_state->libpng_error = true;
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    void *pixels;
+    SAIL_TRY(sail_malloc((size_t)image->height * row_bytes, &pixels));
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const void *scan_line;
+        SAIL_TRY_OR_CLEANUP(sail_scan_line_to_save(png_state->save_options, image, row, &scan_line),
+                            /* cleanup */ sail_free(pixels));
+
+        png_private_copy_row_in_file_order(scan_line,
+                                           (unsigned char *)pixels + (size_t)row * row_bytes,
+                                           row_bytes,
+                                           channels,
+                                           bit_depth / 8,
+                                           png_state->swap_alpha,
+                                           png_state->bgr,
+                                           png_state->swap16);
     }
 
-    /* Error handling setup. */
-    if (setjmp(png_jmpbuf(png_state->png_ptr))) {
-        png_state->libpng_error = true;
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    size_t idat_size;
+    SAIL_TRY_OR_CLEANUP(png_private_deflate_parallel(pixels,
+                                                     image->height,
+                                                     row_bytes,
+                                                     bytes_per_pixel,
+                                                     filters,
+                                                     png_state->compression_level,
+                                                     png_state->strategy,
+                                                     png_state->threads,
+                                                     &png_state->parallel_idat,
+                                                     &idat_size),
+                        /* cleanup */ sail_free(pixels));
+
+    sail_free(pixels);
+
+    for (size_t offset = 0; offset < idat_size; offset += PARALLEL_IDAT_CHUNK_SIZE) {
+        const size_t chunk_size = (idat_size - offset < PARALLEL_IDAT_CHUNK_SIZE) ? idat_size - offset : PARALLEL_IDAT_CHUNK_SIZE;
+
+        png_write_chunk(png_state->png_ptr, (png_const_bytep)"IDAT", (png_const_bytep)png_state->parallel_idat + offset, chunk_size);
     }
 
-    png_set_read_fn(png_state->png_ptr, io, png_private_my_read_fn);
-    png_read_info(png_state->png_ptr, png_state->info_ptr);
+    sail_free(png_state->parallel_idat);
+    png_state->parallel_idat = NULL;
+
+    png_state->parallel_idat_written = true;
+
+    return SAIL_OK;
+}
+
+/*
+ * Reads the header of the first image after png_read_info() or in the progressive info callback,
+ * and sets up the transformations.
+ */
+static sail_status_t read_first_image(struct png_state *png_state) {
 
     SAIL_TRY(sail_alloc_image(&png_state->first_image));
 
@@ -208,6 +317,13 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_png(struct sail_io *io, const
     png_state->first_image->pixel_format = png_private_png_color_type_to_pixel_format(png_state->color_type, png_state->bit_depth);
     png_state->first_image->bytes_per_line = sail_bytes_per_line(png_state->first_image->width, png_state->first_image->pixel_format);
 
+#if SAIL_LITTLE_ENDIAN
+    /* 16-bit samples are big-endian in PNG files and in the host byte order in SAIL images. */
+    if (png_state->bit_depth == 16) {
+        png_set_swap(png_state->png_ptr);
+    }
+#endif
+
     /* Fetch palette. */
     if (png_state->color_type == PNG_COLOR_TYPE_PALETTE) {
         SAIL_TRY(png_private_fetch_palette(png_state->png_ptr, png_state->info_ptr, &png_state->first_image->palette));
@@ -216,21 +332,82 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_png(struct sail_io *io, const
     /* Fetch resolution. */
     SAIL_TRY(png_private_fetch_resolution(png_state->png_ptr, png_state->info_ptr, &png_state->first_image->resolution));
 
-    png_state->interlaced_passes = png_set_interlace_handling(png_state->png_ptr);
+    /*
+     * Adam7 passes are deinterlaced by png_private_read_deinterlaced() instead of libpng.
+     * libpng would merge every pass into the full rows with a read-modify-write of the whole frame.
+     */
+    png_state->interlaced_passes = (png_state->interlace_type == PNG_INTERLACE_ADAM7) ? PNG_INTERLACE_ADAM7_PASSES : 1;
 
     SAIL_LOG_TRACE("PNG: Interlaced passes: %d", png_state->interlaced_passes);
 
+    /*
+     * Let libpng convert pixels into the requested output pixel format while decoding.
+     * Animated images keep the native pixel format as frame blending depends on it.
+     */
+    if (png_state->load_options->output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
 #ifdef PNG_APNG_SUPPORTED
-    png_state->bytes_per_pixel = sail_bits_per_pixel(png_state->first_image->pixel_format) / 8;
-    png_state->is_apng         = png_get_valid(png_state->png_ptr, png_state->info_ptr, PNG_INFO_acTL) != 0;
-    png_state->frames          = png_state->is_apng ? png_get_num_frames(png_state->png_ptr, png_state->info_ptr) : 1;
+        const bool animated = png_get_valid(png_state->png_ptr, png_state->info_ptr, PNG_INFO_acTL) != 0;
+#else
+        const bool animated = false;
+#endif
+
+        if (!animated && png_private_set_output_pixel_format(png_state->png_ptr,
+                                                             png_state->info_ptr,
+                                                             png_state->color_type,
+                                                             png_state->bit_depth,
+                                                             png_state->load_options->output_pixel_format)) {
+            png_read_update_info(png_state->png_ptr, png_state->info_ptr);
+            png_state->info_updated = true;
+
+            png_state->first_image->pixel_format   = png_state->load_options->output_pixel_format;
+            png_state->first_image->bytes_per_line = sail_bytes_per_line(png_state->first_image->width, png_state->first_image->pixel_format);
+
+            if (png_get_rowbytes(png_state->png_ptr, png_state->info_ptr) != png_state->first_image->bytes_per_line) {
+                SAIL_LOG_ERROR("PNG: Failed to set up decoding into %s", sail_pixel_format_to_string(png_state->first_image->pixel_format));
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+
+            sail_destroy_palette(png_state->first_image->palette);
+            png_state->first_image->palette = NULL;
+        } else {
+            SAIL_LOG_DEBUG("PNG: Cannot decode into %s, falling back to the native pixel format",
+                            sail_pixel_format_to_string(png_state->load_options->output_pixel_format));
+        }
+    }
+
+#ifdef PNG_APNG_SUPPORTED
+    png_state->is_apng = png_get_valid(png_state->png_ptr, png_state->info_ptr, PNG_INFO_acTL) != 0;
+    png_state->frames  = png_state->is_apng ? png_get_num_frames(png_state->png_ptr, png_state->info_ptr) : 1;
 
     if (png_state->frames == 0) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
     }
 
     if (png_state->is_apng) {
-        SAIL_TRY(png_private_alloc_rows(&png_state->prev, png_state->first_image->bytes_per_line, png_state->first_image->height));
+        /* Frames are composited into a transparent canvas that needs whole bytes per pixel. */
+        if (sail_bits_per_pixel(png_state->first_image->pixel_format) < 8) {
+            if (png_state->color_type == PNG_COLOR_TYPE_PALETTE) {
+                png_set_packing(png_state->png_ptr);
+                png_state->first_image->pixel_format = SAIL_PIXEL_FORMAT_BPP8_INDEXED;
+            } else {
+                png_set_expand_gray_1_2_4_to_8(png_state->png_ptr);
+                png_state->first_image->pixel_format = SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
+            }
+
+            png_read_update_info(png_state->png_ptr, png_state->info_ptr);
+            png_state->info_updated = true;
+
+            png_state->first_image->bytes_per_line = sail_bytes_per_line(png_state->first_image->width, png_state->first_image->pixel_format);
+        }
+
+        SAIL_TRY(sail_check_load_limits(png_state->load_options, png_state->first_image->width, png_state->first_image->height,
+                                        (size_t)png_state->first_image->height * png_state->first_image->bytes_per_line));
+        SAIL_TRY(animation_private_alloc_canvas(png_state->first_image->width, png_state->first_image->height,
+                                                png_state->first_image->pixel_format, /* background */ NULL,
+                                                animation_private_first_frame_only(png_state->load_options),
+                                                &png_state->canvas));
+
+        png_state->dirty_only = animation_private_dirty_only(png_state->load_options);
 
         if (png_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
             if (png_state->load_options->options & SAIL_OPTION_META_DATA) {
@@ -257,7 +434,8 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_png(struct sail_io *io, const
 
     /* Read meta data. */
     if (png_state->load_options->options & SAIL_OPTION_META_DATA) {
-        SAIL_TRY(png_private_fetch_meta_data(png_state->png_ptr, png_state->info_ptr, &png_state->first_image->meta_data_node));
+        SAIL_TRY(png_private_fetch_meta_data(png_state->png_ptr, png_state->info_ptr, png_state->load_options,
+                                             &png_state->text_chunks, &png_state->first_image->meta_data_node));
     }
 
     /* Fetch ICC profile. */
@@ -270,12 +448,163 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_png(struct sail_io *io, const
         SAIL_LOG_TRACE("PNG: Failed to read the image gamma so it stays default");
     }
 
+    return SAIL_OK;
+}
+
+/* Creates the libpng read structures. */
+static sail_status_t create_read_struct(struct png_state *png_state) {
+
+    if ((png_state->png_ptr = png_create_read_struct_2(PNG_LIBPNG_VER_STRING, NULL, png_private_my_error_fn, png_private_my_warning_fn, NULL, png_private_my_malloc_fn, png_private_my_free_fn)) == NULL) {
+        png_state->libpng_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if ((png_state->info_ptr = png_create_info_struct(png_state->png_ptr)) == NULL) {
+        png_state->libpng_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
+#ifdef SAIL_HAVE_PNG_PUSH
+/* Pauses the progressive reader, so the caller gets control back with the unprocessed data. */
+static void pause_push(png_structp png_ptr, struct png_state *png_state) {
+
+    png_state->push_unprocessed = png_process_data_pause(png_ptr, /* save */ 0);
+}
+
+/* Progressive reader callback. Reads the header of the first image, and pauses so the caller allocates the pixels. */
+static void push_info_callback(png_structp png_ptr, png_infop info_ptr) {
+
+    (void)info_ptr;
+
+    struct png_state *png_state = png_get_progressive_ptr(png_ptr);
+
 #ifdef PNG_APNG_SUPPORTED
-    if (png_state->is_apng) {
-        SAIL_TRY(sail_malloc(png_state->first_image->bytes_per_line, &png_state->temp_scanline));
+    /* Animated frames are composited into a canvas from the whole frame data. */
+    if (png_get_valid(png_ptr, png_state->info_ptr, PNG_INFO_acTL) != 0) {
+        png_state->push_status = SAIL_ERROR_NOT_IMPLEMENTED;
+        pause_push(png_ptr, png_state);
+        return;
     }
 #endif
 
+    /* libpng expands Adam7 passes to full rows, and png_progressive_combine_row() merges them. */
+    png_set_interlace_handling(png_ptr);
+
+    png_state->push_status = read_first_image(png_state);
+
+    if (png_state->push_status == SAIL_OK) {
+        if (!png_state->info_updated) {
+            png_read_update_info(png_ptr, png_state->info_ptr);
+            png_state->info_updated = true;
+        }
+
+        png_state->push_header_read = true;
+    }
+
+    pause_push(png_ptr, png_state);
+}
+
+/*
+ * Progressive reader callback. Merges the row into the frame. Doesn't pause, as libpng keeps
+ * inflating the current chunk data after a pause.
+ */
+static void push_row_callback(png_structp png_ptr, png_bytep new_row, png_uint_32 row_num, int pass) {
+
+    struct png_state *png_state = png_get_progressive_ptr(png_ptr);
+    const struct sail_image *image = png_state->push_image;
+
+    if (image == NULL || row_num >= image->height) {
+        png_error(png_ptr, "Unexpected row");
+    }
+
+    /* Interlaced passes don't update some rows. */
+    if (new_row != NULL) {
+        png_progressive_combine_row(png_ptr, sail_scan_line(image, row_num), new_row);
+
+        if (!png_state->push_rows) {
+            png_state->push_rows      = true;
+            png_state->push_first_row = row_num;
+            png_state->push_last_row  = row_num;
+        } else if (row_num < png_state->push_first_row) {
+            png_state->push_first_row = row_num;
+        } else if (row_num > png_state->push_last_row) {
+            png_state->push_last_row = row_num;
+        }
+    }
+
+    const int last_pass = (png_state->interlaced_passes > 1) ? PNG_INTERLACE_ADAM7_PASSES - 1 : 0;
+
+    if (row_num == image->height - 1 && pass == last_pass) {
+        png_state->push_frame_done = true;
+    }
+}
+
+/* Progressive reader callback called on IEND. */
+static void push_end_callback(png_structp png_ptr, png_infop info_ptr) {
+
+    (void)info_ptr;
+
+    struct png_state *png_state = png_get_progressive_ptr(png_ptr);
+
+    png_state->push_frame_done = true;
+}
+
+/* Feeds the data to the progressive reader. */
+static sail_status_t process_push_data(struct png_state *png_state, const void *data, size_t size, size_t *consumed) {
+
+    if (setjmp(png_jmpbuf(png_state->png_ptr))) {
+        png_state->libpng_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    png_state->push_unprocessed = 0;
+
+    png_process_data(png_state->png_ptr, png_state->info_ptr, (png_bytep)data, size);
+
+    *consumed = size - png_state->push_unprocessed;
+
+    return SAIL_OK;
+}
+#endif
+
+/*
+ * Decoding functions.
+ */
+
+SAIL_EXPORT sail_status_t sail_codec_load_init_v8_png(struct sail_io *io, const struct sail_load_options *load_options, void **state) {
+
+    *state = NULL;
+
+    /* Allocate a new state. */
+    struct png_state *png_state;
+    SAIL_TRY(alloc_png_state(load_options, NULL, &png_state));
+    *state = png_state;
+
+    /* Initialize PNG. */
+    SAIL_TRY(create_read_struct(png_state));
+
+    /* Error handling setup. */
+    if (setjmp(png_jmpbuf(png_state->png_ptr))) {
+        png_state->libpng_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    png_set_read_fn(png_state->png_ptr, io, png_private_my_read_fn);
+
+    /* Handle tuning. */
+    if (png_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(png_state->load_options->tuning, png_private_load_tuning_key_value_callback, png_state->png_ptr);
+    }
+
+    png_private_select_meta_data(png_state->png_ptr, png_state->load_options, &png_state->text_chunks);
+
+    png_read_info(png_state->png_ptr, png_state->info_ptr);
+
+    SAIL_TRY(read_first_image(png_state));
+
     return SAIL_OK;
 }
 
@@ -304,8 +633,10 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_png(void *state, st
         /* APNG feature: a hidden frame. */
         if (!png_state->skipped_hidden && png_get_first_frame_is_hidden(png_state->png_ptr, png_state->info_ptr)) {
             SAIL_LOG_TRACE("PNG: Skipping hidden frame");
-            SAIL_TRY_OR_CLEANUP(png_private_skip_hidden_frame(png_state->first_image->bytes_per_line,
+            SAIL_TRY_OR_CLEANUP(png_private_skip_hidden_frame(png_state->first_image->width,
                                                                png_state->first_image->height,
+                                                               png_state->first_image->bytes_per_line,
+                                                               png_state->interlaced_passes > 1,
                                                                png_state->png_ptr,
                                                                png_state->info_ptr,
                                                                &png_state->scanline_for_skipping),
@@ -341,16 +672,6 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_png(void *state, st
             png_state->next_frame_blend_op   = PNG_BLEND_OP_SOURCE;
         }
 
-        if (png_state->next_frame_width + png_state->next_frame_x_offset > image_local->width ||
-                png_state->next_frame_height + png_state->next_frame_y_offset > image_local->height) {
-            sail_destroy_image(image_local);
-            SAIL_LOG_ERROR("PNG: Frame %u,%u %ux%u doesn't fit into the canvas image %ux%u",
-                            png_state->next_frame_x_offset, png_state->next_frame_y_offset,
-                            png_state->next_frame_width, png_state->next_frame_height,
-                            image_local->width, image_local->height);
-            SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
-        }
-
         SAIL_LOG_TRACE("PNG: Frame #%u: %u,%u %ux%u, canvas image: %ux%u",
                         png_state->current_frame,
                         png_state->next_frame_x_offset, png_state->next_frame_y_offset,
@@ -362,6 +683,21 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_png(void *state, st
         }
 
         image_local->delay = (int)(((double)png_state->next_frame_delay_num / png_state->next_frame_delay_den) * 1000);
+
+        /* The first frame replaces the transparent canvas. */
+        const struct animation_frame frame = {
+            .rect    = { png_state->next_frame_x_offset, png_state->next_frame_y_offset,
+                         png_state->next_frame_width, png_state->next_frame_height },
+            .dispose = png_private_animation_dispose(png_state->next_frame_dispose_op),
+            .blend   = (png_state->current_frame == 0 || png_state->next_frame_blend_op == PNG_BLEND_OP_SOURCE)
+                        ? SAIL_ANIMATION_BLEND_SOURCE
+                        : SAIL_ANIMATION_BLEND_OVER,
+        };
+
+        SAIL_TRY_OR_CLEANUP(animation_private_start_frame(png_state->canvas, &frame),
+                            /* cleanup */ sail_destroy_image(image_local));
+        SAIL_TRY_OR_CLEANUP(animation_private_setup_image(png_state->canvas, png_state->dirty_only, image_local),
+                            /* cleanup */ sail_destroy_image(image_local));
     }
 #endif
 
@@ -385,62 +721,200 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_png(void *state, struct sail_
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    for (int current_pass = 0; current_pass < png_state->interlaced_passes; current_pass++) {
-    #ifdef PNG_APNG_SUPPORTED
-        if (png_state->is_apng) {
-            for (unsigned row = 0; row < image->height; row++) {
-                unsigned char *scanline = sail_scan_line(image, row);
-
-                memcpy(scanline, png_state->prev[row], png_state->first_image->bytes_per_line);
-
-                if (row >= png_state->next_frame_y_offset && row < png_state->next_frame_y_offset + png_state->next_frame_height) {
-                    png_read_row(png_state->png_ptr, (png_bytep)png_state->temp_scanline, NULL);
-
-                    /* Copy all pixel values including alpha. */
-                    if (png_state->current_frame == 1 || png_state->next_frame_blend_op == PNG_BLEND_OP_SOURCE) {
-                        SAIL_TRY(png_private_blend_source(scanline,
-                                                png_state->next_frame_x_offset,
-                                                png_state->temp_scanline,
-                                                png_state->next_frame_width,
-                                                png_state->bytes_per_pixel));
-                    } else { /* PNG_BLEND_OP_OVER */
-                        SAIL_TRY(png_private_blend_over(scanline,
-                                            png_state->next_frame_x_offset,
-                                            png_state->temp_scanline,
-                                            png_state->next_frame_width,
-                                            image->pixel_format));
-                    }
-
-                    /* Workaround: Apply disposal method only for images with bpp >= 8. */
-                    if (png_state->bytes_per_pixel > 0) {
-                        if (png_state->next_frame_dispose_op == PNG_DISPOSE_OP_BACKGROUND) {
-                            memset(png_state->prev[row] + png_state->next_frame_x_offset * png_state->bytes_per_pixel,
-                                    0,
-                                    (size_t)png_state->next_frame_width * png_state->bytes_per_pixel);
-                        } else if (png_state->next_frame_dispose_op == PNG_DISPOSE_OP_NONE) {
-                            memcpy(png_state->prev[row] + png_state->next_frame_x_offset * png_state->bytes_per_pixel,
-                                    scanline,
-                                    (size_t)png_state->next_frame_width * png_state->bytes_per_pixel);
-                        } else { /* PNG_DISPOSE_OP_PREVIOUS */
-                        }
-                    }
-                }
-            }
+    SAIL_TRY(sail_put_load_diagnostic_unsigned_long(png_state->load_options, image, "png-interlace-passes",
+                                                    (unsigned long)png_state->interlaced_passes));
+
+#ifdef PNG_APNG_SUPPORTED
+    /* Frames are composited into the canvas, so its rows are complete for the row callback after all passes. */
+    if (png_state->is_apng) {
+        SAIL_TRY(animation_private_bind_pixels(png_state->canvas, png_state->load_options, image));
+
+        void *frame_pixels;
+        unsigned frame_bytes_per_line;
+        SAIL_TRY(animation_private_frame_pixels(png_state->canvas, &frame_pixels, &frame_bytes_per_line));
+
+        if (png_state->interlaced_passes > 1) {
+            SAIL_TRY(sail_malloc(frame_bytes_per_line, &png_state->pass_row));
+            SAIL_TRY(png_private_read_deinterlaced(png_state->png_ptr,
+                                                   png_state->next_frame_width,
+                                                   png_state->next_frame_height,
+                                                   sail_bits_per_pixel(png_state->first_image->pixel_format),
+                                                   frame_pixels,
+                                                   frame_bytes_per_line,
+                                                   png_state->pass_row));
+            sail_free(png_state->pass_row);
+            png_state->pass_row = NULL;
         } else {
-            for (unsigned row = 0; row < image->height; row++) {
-                png_read_row(png_state->png_ptr, sail_scan_line(image, row), NULL);
+            for (unsigned row = 0; row < png_state->next_frame_height; row++) {
+                png_read_row(png_state->png_ptr, (png_bytep)frame_pixels + (size_t)row * frame_bytes_per_line, NULL);
             }
         }
-    #else
+
+        animation_private_finish_frame(png_state->canvas);
+
+        for (unsigned row = 0; row < image->height; row++) {
+            animation_private_copy_row(png_state->canvas, png_state->dirty_only, row, sail_scan_line_to_load(png_state->load_options, image, row));
+            SAIL_TRY(sail_scan_line_loaded(png_state->load_options, image, row));
+        }
+
+        return SAIL_OK;
+    }
+#endif
+
+    if (png_state->interlaced_passes > 1) {
+        /* Interlaced rows are complete only after the last pass, so buffer the whole frame for the row callback. */
+        void *pixels = image->pixels;
+
+        SAIL_TRY(sail_put_load_diagnostic_bool(png_state->load_options, image, "png-interlace-buffered",
+                                               png_state->load_options->row_callback != NULL));
+
+        if (png_state->load_options->row_callback != NULL) {
+            SAIL_TRY(sail_check_load_limits(png_state->load_options, image->width, image->height,
+                                            (size_t)image->height * image->bytes_per_line));
+            SAIL_TRY(sail_malloc((size_t)image->height * image->bytes_per_line, &png_state->interlaced_pixels));
+            pixels = png_state->interlaced_pixels;
+        }
+
+        SAIL_TRY(sail_malloc(image->bytes_per_line, &png_state->pass_row));
+        SAIL_TRY(png_private_read_deinterlaced(png_state->png_ptr,
+                                               image->width,
+                                               image->height,
+                                               sail_bits_per_pixel(image->pixel_format),
+                                               pixels,
+                                               image->bytes_per_line,
+                                               png_state->pass_row));
+        sail_free(png_state->pass_row);
+        png_state->pass_row = NULL;
+
         for (unsigned row = 0; row < image->height; row++) {
-            png_read_row(png_state->png_ptr, sail_scan_line(image, row), NULL);
+            if (png_state->interlaced_pixels != NULL) {
+                memcpy(sail_scan_line_to_load(png_state->load_options, image, row),
+                       (unsigned char *)png_state->interlaced_pixels + (size_t)row * image->bytes_per_line,
+                       image->bytes_per_line);
+            }
+
+            SAIL_TRY(sail_scan_line_loaded(png_state->load_options, image, row));
         }
-    #endif
+
+        sail_free(png_state->interlaced_pixels);
+        png_state->interlaced_pixels = NULL;
+
+        return SAIL_OK;
+    }
+
+    for (unsigned row = 0; row < image->height; row++) {
+        png_read_row(png_state->png_ptr, sail_scan_line_to_load(png_state->load_options, image, row), NULL);
+        SAIL_TRY(sail_scan_line_loaded(png_state->load_options, image, row));
+    }
+
+    return SAIL_OK;
+}
+
+#ifdef SAIL_HAVE_PNG_PUSH
+SAIL_EXPORT sail_status_t sail_codec_load_push_init_v8_png(const struct sail_load_options *load_options, void **state) {
+
+    *state = NULL;
+
+    struct png_state *png_state;
+    SAIL_TRY(alloc_png_state(load_options, NULL, &png_state));
+    *state = png_state;
+
+    SAIL_TRY(create_read_struct(png_state));
+
+    if (setjmp(png_jmpbuf(png_state->png_ptr))) {
+        png_state->libpng_error = true;
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    png_set_progressive_read_fn(png_state->png_ptr, png_state, push_info_callback, push_row_callback, push_end_callback);
+
+    if (png_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(png_state->load_options->tuning, png_private_load_tuning_key_value_callback, png_state->png_ptr);
     }
 
+    png_private_select_meta_data(png_state->png_ptr, png_state->load_options, &png_state->text_chunks);
+
     return SAIL_OK;
 }
 
+SAIL_EXPORT sail_status_t sail_codec_load_push_seek_next_frame_v8_png(void *state, const void *data, size_t size, bool end,
+                                                                      size_t *consumed, struct sail_image **image) {
+
+    struct png_state *png_state = state;
+
+    *consumed = 0;
+
+    if (png_state->libpng_error) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if (!png_state->push_header_read) {
+        SAIL_TRY(process_push_data(png_state, data, size, consumed));
+        SAIL_TRY(png_state->push_status);
+
+        if (!png_state->push_header_read) {
+            if (end) {
+                SAIL_LOG_ERROR("PNG: The image header is truncated");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+
+            return SAIL_ERROR_NEED_MORE_DATA;
+        }
+    }
+
+    if (png_state->current_frame == png_state->frames) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    SAIL_TRY(sail_copy_image(png_state->first_image, image));
+
+    png_state->push_frame_done = false;
+    png_state->current_frame++;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_push_frame_v8_png(void *state, const void *data, size_t size, bool end,
+                                                            size_t *consumed, struct sail_image *image,
+                                                            unsigned *first_row, unsigned *rows_count) {
+
+    struct png_state *png_state = state;
+
+    *consumed   = 0;
+    *first_row  = 0;
+    *rows_count = 0;
+
+    if (png_state->libpng_error) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    png_state->push_image = image;
+    png_state->push_rows  = false;
+
+    const sail_status_t status = process_push_data(png_state, data, size, consumed);
+
+    png_state->push_image = NULL;
+
+    if (png_state->push_rows) {
+        *first_row  = png_state->push_first_row;
+        *rows_count = png_state->push_last_row - png_state->push_first_row + 1;
+    }
+
+    SAIL_TRY(status);
+
+    if (png_state->push_frame_done) {
+        return SAIL_OK;
+    }
+
+    if (end) {
+        SAIL_LOG_ERROR("PNG: The image data is truncated");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_ERROR_NEED_MORE_DATA;
+}
+#endif
+
 SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_png(void **state) {
 
     struct png_state *png_state = *state;
@@ -499,10 +973,28 @@ SAIL_EXPORT sail_status_t sail_codec_save_init_v8_png(struct sail_io *io, const
 
     /* Handle tuning. */
     if (png_state->save_options->tuning != NULL) {
-        sail_traverse_hash_map_with_user_data(png_state->save_options->tuning, png_private_tuning_key_value_callback, png_state->png_ptr);
+        struct png_private_save_tuning save_tuning = { png_state->png_ptr, -1, 1, -1, -1, -1 };
+
+        sail_traverse_hash_map_with_user_data(png_state->save_options->tuning, png_private_tuning_key_value_callback, &save_tuning);
+
+        if (save_tuning.filters < 0 && save_tuning.preset_filters >= 0) {
+            png_set_filter(png_state->png_ptr, 0, save_tuning.preset_filters);
+            save_tuning.filters = save_tuning.preset_filters;
+        }
+
+        if (save_tuning.strategy >= 0) {
+            png_set_compression_strategy(png_state->png_ptr, save_tuning.strategy);
+        }
+
+        png_state->filters                  = save_tuning.filters;
+        png_state->threads                  = save_tuning.threads;
+        png_state->preset_compression_level = save_tuning.compression_level;
+        png_state->strategy                 = save_tuning.strategy;
     }
 
-    png_set_write_fn(png_state->png_ptr, io, png_private_my_write_fn, png_private_my_flush_fn);
+    SAIL_TRY(sail_init_buffered_writer(io, 0, &png_state->writer));
+
+    png_set_write_fn(png_state->png_ptr, &png_state->writer, png_private_my_write_fn, png_private_my_flush_fn);
 
     return SAIL_OK;
 }
@@ -581,16 +1073,27 @@ SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_png(void *state, co
     /* Save gamma. */
     png_set_gAMA(png_state->png_ptr, png_state->info_ptr, image->gamma);
 
-    /* Set compression. */
-    const double compression = (png_state->save_options->compression_level < COMPRESSION_MIN ||
-                                png_state->save_options->compression_level > COMPRESSION_MAX)
-                                ? COMPRESSION_DEFAULT
-                                : png_state->save_options->compression_level;
+    /* Set compression. Presets override the compression level. */
+    const double compression = (png_state->preset_compression_level >= 0)
+                                ? png_state->preset_compression_level
+                                : (png_state->save_options->compression_level < COMPRESSION_MIN ||
+                                   png_state->save_options->compression_level > COMPRESSION_MAX)
+                                    ? COMPRESSION_DEFAULT
+                                    : png_state->save_options->compression_level;
 
-    png_set_compression_level(png_state->png_ptr, (int)compression);
+    png_state->compression_level = (int)compression;
+    png_set_compression_level(png_state->png_ptr, png_state->compression_level);
 
     png_write_info(png_state->png_ptr, png_state->info_ptr);
 
+#if SAIL_LITTLE_ENDIAN
+    /* 16-bit samples are in the host byte order in SAIL images and big-endian in PNG files. */
+    if (bit_depth == 16) {
+        png_set_swap(png_state->png_ptr);
+        png_state->swap16 = true;
+    }
+#endif
+
     if (image->pixel_format == SAIL_PIXEL_FORMAT_BPP24_BGR      ||
             image->pixel_format == SAIL_PIXEL_FORMAT_BPP48_BGR  ||
             image->pixel_format == SAIL_PIXEL_FORMAT_BPP32_BGRA ||
@@ -598,6 +1101,7 @@ SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_png(void *state, co
             image->pixel_format == SAIL_PIXEL_FORMAT_BPP64_BGRA ||
             image->pixel_format == SAIL_PIXEL_FORMAT_BPP64_ABGR) {
         png_set_bgr(png_state->png_ptr);
+        png_state->bgr = true;
     }
 
     if (image->pixel_format == SAIL_PIXEL_FORMAT_BPP32_ARGB     ||
@@ -605,6 +1109,7 @@ SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_png(void *state, co
             image->pixel_format == SAIL_PIXEL_FORMAT_BPP64_ARGB ||
             image->pixel_format == SAIL_PIXEL_FORMAT_BPP64_ABGR) {
         png_set_swap_alpha(png_state->png_ptr);
+        png_state->swap_alpha = true;
     }
 
     if (png_state->save_options->options & SAIL_OPTION_INTERLACED) {
@@ -630,12 +1135,39 @@ SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_png(void *state, const struct
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    if (png_state->threads > 1 && png_state->interlaced_passes == 1 && image->height > 1) {
+        SAIL_TRY(save_frame_parallel(png_state, image));
+        return SAIL_OK;
+    }
+
+    /* Interlaced passes write every row multiple times, so request the whole frame from the row callback. */
+    if (png_state->save_options->row_callback != NULL && png_state->interlaced_passes > 1) {
+        SAIL_TRY(sail_malloc((size_t)image->height * image->bytes_per_line, &png_state->interlaced_pixels));
+
+        for (unsigned row = 0; row < image->height; row++) {
+            unsigned char *scan_line = (unsigned char *)png_state->interlaced_pixels + (size_t)row * image->bytes_per_line;
+            SAIL_TRY(sail_check_cancellation(png_state->save_options->cancellation));
+            SAIL_TRY(png_state->save_options->row_callback(image, row, scan_line, png_state->save_options->row_callback_user_data));
+        }
+    }
+
     for (int current_pass = 0; current_pass < png_state->interlaced_passes; current_pass++) {
         for (unsigned row = 0; row < image->height; row++) {
-            png_write_row(png_state->png_ptr, sail_scan_line(image, row));
+            const void *scan_line;
+
+            if (png_state->interlaced_pixels != NULL) {
+                scan_line = (const unsigned char *)png_state->interlaced_pixels + (size_t)row * image->bytes_per_line;
+            } else {
+                SAIL_TRY(sail_scan_line_to_save(png_state->save_options, image, row, &scan_line));
+            }
+
+            png_write_row(png_state->png_ptr, scan_line);
         }
     }
 
+    sail_free(png_state->interlaced_pixels);
+    png_state->interlaced_pixels = NULL;
+
     return SAIL_OK;
 }
 
@@ -649,19 +1181,29 @@ SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_png(void **state) {
     /* Error handling setup. */
     if (png_state->png_ptr != NULL) {
         if (setjmp(png_jmpbuf(png_state->png_ptr))) {
+            /* Finishing a cancelled frame fails, but the write struct must still be released. */
+            png_destroy_write_struct(&png_state->png_ptr, &png_state->info_ptr);
             destroy_png_state(png_state);
             SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
         }
     }
 
     if (png_state->png_ptr != NULL && !png_state->libpng_error) {
-        png_write_end(png_state->png_ptr, png_state->info_ptr);
+        /* libpng doesn't know about the IDAT chunks written by the parallel encoder. */
+        if (png_state->parallel_idat_written) {
+            png_write_chunk(png_state->png_ptr, (png_const_bytep)"IEND", NULL, 0);
+        } else {
+            png_write_end(png_state->png_ptr, png_state->info_ptr);
+        }
     }
 
     if (png_state->png_ptr != NULL) {
         png_destroy_write_struct(&png_state->png_ptr, &png_state->info_ptr);
     }
 
+    SAIL_TRY_OR_CLEANUP(sail_finish_buffered_writer(&png_state->writer),
+                        /* cleanup */ destroy_png_state(png_state));
+
     destroy_png_state(png_state);
 
     return SAIL_OK;
@@ -32,51 +32,51 @@
 
 #include "helpers.h"
 
-sail_status_t pnm_private_skip_to_letters_numbers_force_read(struct sail_io *io, char *first_char) {
+sail_status_t pnm_private_skip_to_letters_numbers_force_read(struct sail_buffered_reader *reader, char *first_char) {
 
-    char c;
+    uint8_t c;
 
     do {
-        SAIL_TRY(io->strict_read(io->stream, &c, 1));
+        SAIL_TRY(sail_buffered_reader_read_byte(reader, &c));
 
         if (c == '#') {
             do {
-                SAIL_TRY(io->strict_read(io->stream, &c, 1));
+                SAIL_TRY(sail_buffered_reader_read_byte(reader, &c));
             } while(c != '\n');
         }
     } while (!isalnum(c));
 
-    *first_char = c;
+    *first_char = (char)c;
 
     return SAIL_OK;
 }
 
-sail_status_t pnm_private_skip_to_letters_numbers(struct sail_io *io, char starting_char, char *first_char) {
+sail_status_t pnm_private_skip_to_letters_numbers(struct sail_buffered_reader *reader, char starting_char, char *first_char) {
 
     if (isalnum(starting_char)) {
         *first_char = starting_char;
         return SAIL_OK;
     }
 
-    SAIL_TRY(pnm_private_skip_to_letters_numbers_force_read(io, first_char));
+    SAIL_TRY(pnm_private_skip_to_letters_numbers_force_read(reader, first_char));
 
     return SAIL_OK;
 }
 
-sail_status_t pnm_private_read_word(struct sail_io *io, char *str, size_t str_size) {
+sail_status_t pnm_private_read_word(struct sail_buffered_reader *reader, char *str, size_t str_size) {
 
     if (str_size < 2) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
     }
 
     char first_char;
-    SAIL_TRY(pnm_private_skip_to_letters_numbers(io, SAIL_PNM_INVALID_STARTING_CHAR, &first_char));
+    SAIL_TRY(pnm_private_skip_to_letters_numbers(reader, SAIL_PNM_INVALID_STARTING_CHAR, &first_char));
 
     unsigned i = 0;
     char c = first_char;
 
     bool eof;
-    SAIL_TRY(io->eof(io->stream, &eof));
+    SAIL_TRY(sail_buffered_reader_eof(reader, &eof));
 
     if (eof) {
         *(str + i++) = c;
@@ -84,8 +84,10 @@ sail_status_t pnm_private_read_word(struct sail_io *io, char *str, size_t str_si
         while (isalnum(c) && i < str_size - 1 && !eof) {
             *(str + i++) = c;
 
-            SAIL_TRY(io->strict_read(io->stream, &c, 1));
-            SAIL_TRY(io->eof(io->stream, &eof));
+            uint8_t byte;
+            SAIL_TRY(sail_buffered_reader_read_byte(reader, &byte));
+            c = (char)byte;
+            SAIL_TRY(sail_buffered_reader_eof(reader, &eof));
         }
     }
 
@@ -100,39 +102,157 @@ sail_status_t pnm_private_read_word(struct sail_io *io, char *str, size_t str_si
     return SAIL_OK;
 }
 
-sail_status_t pnm_private_read_pixels(struct sail_io *io, struct sail_image *image, unsigned channels, unsigned bpc, double multiplier_to_full_range) {
+/* Returns true for the characters separating ASCII values. */
+static inline bool is_separator(unsigned char c) {
+
+    return !isalnum(c) && c != '#';
+}
+
+sail_status_t pnm_private_skip_separators(struct sail_buffered_reader *reader) {
+
+    for (;;) {
+        const unsigned char *buffered;
+        const size_t buffered_size = sail_buffered_reader_buffered(reader, &buffered);
+
+        if (buffered_size == 0) {
+            bool eof;
+            SAIL_TRY(sail_buffered_reader_eof(reader, &eof));
+
+            if (eof) {
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+            }
+
+            continue;
+        }
+
+        /* Separators are mostly single characters between the values, so scan the buffered data in place. */
+        size_t i = 0;
+
+        while (i < buffered_size && is_separator(buffered[i])) {
+            i++;
+        }
+
+        SAIL_TRY(sail_buffered_reader_skip(reader, i));
+
+        if (i == buffered_size) {
+            continue;
+        }
+
+        if (buffered[i] != '#') {
+            return SAIL_OK;
+        }
+
+        /* Skip the comment. */
+        uint8_t c;
+
+        do {
+            SAIL_TRY(sail_buffered_reader_read_byte(reader, &c));
+        } while (c != '\n');
+    }
+}
+
+sail_status_t pnm_private_read_ascii_value(struct sail_buffered_reader *reader, unsigned *value) {
+
+    SAIL_TRY(pnm_private_skip_separators(reader));
+
+    unsigned value_local = 0;
+    unsigned digits = 0;
+
+    for (;;) {
+        const unsigned char *buffered;
+        const size_t buffered_size = sail_buffered_reader_buffered(reader, &buffered);
+
+        if (buffered_size == 0) {
+            bool eof;
+            SAIL_TRY(sail_buffered_reader_eof(reader, &eof));
+
+            if (eof) {
+                break;
+            }
+
+            continue;
+        }
+
+        size_t i = 0;
+
+        while (i < buffered_size && buffered[i] >= '0' && buffered[i] <= '9') {
+            value_local = value_local * 10 + (buffered[i] - '0');
+            i++;
+
+            /* Values are at most 65535, so catching long numbers before they overflow is enough. */
+            if (++digits > 9) {
+                SAIL_LOG_ERROR("PNM: Value is too large");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+            }
+        }
+
+        if (i < buffered_size) {
+            if (digits == 0 || isalpha(buffered[i])) {
+                SAIL_LOG_ERROR("PNM: Unexpected character '%c'", buffered[i]);
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+            }
+
+            /* Consume the single whitespace that ends the value like before binary pixels. Comments are skipped later. */
+            SAIL_TRY(sail_buffered_reader_skip(reader, (buffered[i] == '#') ? i : i + 1));
+            break;
+        }
+
+        SAIL_TRY(sail_buffered_reader_skip(reader, i));
+    }
+
+    *value = value_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t pnm_private_read_pixels(struct sail_buffered_reader *reader, const struct sail_load_options *load_options, struct sail_image *image, unsigned channels, unsigned bpc, double multiplier_to_full_range) {
+
+    const unsigned samples = image->width * channels;
+    const bool full_range = multiplier_to_full_range == 1;
 
     for (unsigned row = 0; row < image->height; row++) {
-        uint8_t *scan8 = sail_scan_line(image, row);
-        uint16_t *scan16 = sail_scan_line(image, row);
-
-        for (unsigned column = 0; column < image->width; column++) {
-            for(unsigned channel = 0; channel < channels; channel++) {
-                char buffer[8];
-                SAIL_TRY(pnm_private_read_word(io, buffer, sizeof(buffer)));
-
-                unsigned value;
-            #ifdef _MSC_VER
-                if (sscanf_s(buffer, "%u", &value) != 1) {
-            #else
-                if (sscanf(buffer, "%u", &value) != 1) {
-            #endif
-                    SAIL_LOG_ERROR("PNM: Failed to read color value from '%s'", buffer);
-                    SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
-                }
-
-                if (SAIL_LIKELY(bpc == 8)) {
-                    *scan8++ = (uint8_t)(value * multiplier_to_full_range);
-                } else {
-                    *scan16++ = (uint16_t)(value * multiplier_to_full_range);
-                }
+        uint8_t *scan8 = sail_scan_line_to_load(load_options, image, row);
+        uint16_t *scan16 = sail_scan_line_to_load(load_options, image, row);
+
+        for (unsigned sample = 0; sample < samples; sample++) {
+            unsigned value;
+            SAIL_TRY(pnm_private_read_ascii_value(reader, &value));
+
+            if (!full_range) {
+                value = (unsigned)(value * multiplier_to_full_range);
+            }
+
+            if (SAIL_LIKELY(bpc == 8)) {
+                *scan8++ = (uint8_t)value;
+            } else {
+                *scan16++ = (uint16_t)value;
             }
         }
+
+        SAIL_TRY(sail_scan_line_loaded(load_options, image, row));
     }
 
     return SAIL_OK;
 }
 
+void pnm_private_build_full_range8(unsigned max_color, uint8_t table[256]) {
+
+    for (unsigned value = 0; value < 256; value++) {
+        table[value] = (uint8_t)((value < max_color ? value : max_color) * 255 / max_color);
+    }
+}
+
+void pnm_private_host_to_be16(const void *samples, size_t count, void *output) {
+
+    const uint16_t *values = samples;
+    uint8_t *bytes = output;
+
+    for (size_t i = 0; i < count; i++) {
+        *bytes++ = (uint8_t)(values[i] >> 8);
+        *bytes++ = (uint8_t)(values[i] & 0xFF);
+    }
+}
+
 enum SailPixelFormat pnm_private_rgb_sail_pixel_format(enum SailPnmVersion pnm_version, unsigned bpc) {
 
     switch (pnm_version) {
@@ -165,6 +285,63 @@ enum SailPixelFormat pnm_private_rgb_sail_pixel_format(enum SailPnmVersion pnm_v
     }
 }
 
+enum SailPixelFormat pnm_private_pam_sail_pixel_format(unsigned depth, unsigned bpc) {
+
+    switch (depth) {
+        case 1: return (bpc == 8) ? SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE       : SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE;
+        case 2: return (bpc == 8) ? SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA : SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA;
+        case 3: return (bpc == 8) ? SAIL_PIXEL_FORMAT_BPP24_RGB            : SAIL_PIXEL_FORMAT_BPP48_RGB;
+        case 4: return (bpc == 8) ? SAIL_PIXEL_FORMAT_BPP32_RGBA           : SAIL_PIXEL_FORMAT_BPP64_RGBA;
+
+        default: return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+}
+
+sail_status_t pnm_private_sail_pixel_format_to_pnm(enum SailPixelFormat pixel_format, enum SailPnmVersion *pnm_version, unsigned *depth, unsigned *bpc) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:          *pnm_version = SAIL_PNM_VERSION_P5; *depth = 1; *bpc = 8;  return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE:         *pnm_version = SAIL_PNM_VERSION_P5; *depth = 1; *bpc = 16; return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:               *pnm_version = SAIL_PNM_VERSION_P6; *depth = 3; *bpc = 8;  return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP48_RGB:               *pnm_version = SAIL_PNM_VERSION_P6; *depth = 3; *bpc = 16; return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA:   *pnm_version = SAIL_PNM_VERSION_P7; *depth = 2; *bpc = 8;  return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA:   *pnm_version = SAIL_PNM_VERSION_P7; *depth = 2; *bpc = 16; return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:              *pnm_version = SAIL_PNM_VERSION_P7; *depth = 4; *bpc = 8;  return SAIL_OK;
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA:              *pnm_version = SAIL_PNM_VERSION_P7; *depth = 4; *bpc = 16; return SAIL_OK;
+
+        default: {
+            SAIL_LOG_ERROR("PNM: %s pixel format is not supported for saving", sail_pixel_format_to_string(pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+    }
+}
+
+sail_status_t pnm_private_write_header(struct sail_io *io, enum SailPnmVersion pnm_version, unsigned width, unsigned height, unsigned depth, unsigned bpc) {
+
+    const unsigned max_color = (bpc == 8) ? 255 : 65535;
+
+    char header[160];
+    int header_length;
+
+    if (pnm_version == SAIL_PNM_VERSION_P7) {
+        const char *tuple_type = (depth == 2) ? "GRAYSCALE_ALPHA" : "RGB_ALPHA";
+
+        header_length = snprintf(header, sizeof(header), "P7\nWIDTH %u\nHEIGHT %u\nDEPTH %u\nMAXVAL %u\nTUPLTYPE %s\nENDHDR\n",
+                                    width, height, depth, max_color, tuple_type);
+    } else {
+        header_length = snprintf(header, sizeof(header), "P%c\n%u %u\n%u\n",
+                                    (pnm_version == SAIL_PNM_VERSION_P5) ? '5' : '6', width, height, max_color);
+    }
+
+    if (header_length < 0 || (size_t)header_length >= sizeof(header)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    SAIL_TRY(io->strict_write(io->stream, header, (size_t)header_length));
+
+    return SAIL_OK;
+}
+
 sail_status_t pnm_private_store_ascii(enum SailPnmVersion pnm_version, struct sail_hash_map *special_properties) {
 
     struct sail_variant *variant;
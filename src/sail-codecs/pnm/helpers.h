@@ -32,6 +32,7 @@
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
+struct sail_buffered_reader;
 struct sail_image;
 struct sail_io;
 
@@ -42,20 +43,39 @@ enum SailPnmVersion {
     SAIL_PNM_VERSION_P4,
     SAIL_PNM_VERSION_P5,
     SAIL_PNM_VERSION_P6,
+    SAIL_PNM_VERSION_P7,
 };
 
 static const char SAIL_PNM_INVALID_STARTING_CHAR = '\0';
 
-SAIL_HIDDEN sail_status_t pnm_private_skip_to_letters_numbers_force_read(struct sail_io *io, char *first_char);
+SAIL_HIDDEN sail_status_t pnm_private_skip_to_letters_numbers_force_read(struct sail_buffered_reader *reader, char *first_char);
 
-SAIL_HIDDEN sail_status_t pnm_private_skip_to_letters_numbers(struct sail_io *io, char starting_char, char *first_char);
+SAIL_HIDDEN sail_status_t pnm_private_skip_to_letters_numbers(struct sail_buffered_reader *reader, char starting_char, char *first_char);
 
-SAIL_HIDDEN sail_status_t pnm_private_read_word(struct sail_io *io, char *str, size_t str_size);
+SAIL_HIDDEN sail_status_t pnm_private_read_word(struct sail_buffered_reader *reader, char *str, size_t str_size);
 
-SAIL_HIDDEN sail_status_t pnm_private_read_pixels(struct sail_io *io, struct sail_image *image, unsigned channels, unsigned bpc, double multiplier_to_full_range);
+/* Skips whitespaces and comments before the next ASCII value. */
+SAIL_HIDDEN sail_status_t pnm_private_skip_separators(struct sail_buffered_reader *reader);
+
+/* Reads the next ASCII decimal value and consumes the single separator after it. */
+SAIL_HIDDEN sail_status_t pnm_private_read_ascii_value(struct sail_buffered_reader *reader, unsigned *value);
+
+SAIL_HIDDEN sail_status_t pnm_private_read_pixels(struct sail_buffered_reader *reader, const struct sail_load_options *load_options, struct sail_image *image, unsigned channels, unsigned bpc, double multiplier_to_full_range);
+
+/* Builds a table that stretches 8-bit samples from [0; max_color] to [0; 255]. */
+SAIL_HIDDEN void pnm_private_build_full_range8(unsigned max_color, uint8_t table[256]);
+
+/* Converts 16-bit samples in the host byte order into big-endian ones. */
+SAIL_HIDDEN void pnm_private_host_to_be16(const void *samples, size_t count, void *output);
 
 SAIL_HIDDEN enum SailPixelFormat pnm_private_rgb_sail_pixel_format(enum SailPnmVersion pnm_version, unsigned bpc);
 
+SAIL_HIDDEN enum SailPixelFormat pnm_private_pam_sail_pixel_format(unsigned depth, unsigned bpc);
+
+SAIL_HIDDEN sail_status_t pnm_private_sail_pixel_format_to_pnm(enum SailPixelFormat pixel_format, enum SailPnmVersion *pnm_version, unsigned *depth, unsigned *bpc);
+
+SAIL_HIDDEN sail_status_t pnm_private_write_header(struct sail_io *io, enum SailPnmVersion pnm_version, unsigned width, unsigned height, unsigned depth, unsigned bpc);
+
 SAIL_HIDDEN sail_status_t pnm_private_store_ascii(enum SailPnmVersion pnm_version, struct sail_hash_map *special_properties);
 
 #endif
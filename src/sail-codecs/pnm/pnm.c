@@ -44,9 +44,12 @@ struct pnm_state {
     const struct sail_save_options *save_options;
 
     bool frame_loaded;
+    bool frame_saved;
     enum SailPnmVersion version;
     double multiplier_to_full_range;
+    unsigned max_color;
     unsigned bpc;
+    unsigned depth;
 };
 
 static sail_status_t alloc_pnm_state(struct sail_io *io,
@@ -64,9 +67,12 @@ static sail_status_t alloc_pnm_state(struct sail_io *io,
         .save_options = save_options,
 
         .frame_loaded = false,
+        .frame_saved  = false,
 
         .multiplier_to_full_range = 0,
+        .max_color                = 0,
         .bpc                      = 0,
+        .depth                    = 0,
     };
 
     return SAIL_OK;
@@ -81,6 +87,173 @@ static void destroy_pnm_state(struct pnm_state *pnm_state) {
     sail_free(pnm_state);
 }
 
+/* Reads a header word without reading ahead, so probing reads only the header. */
+static sail_status_t read_header_word(struct sail_io *io, char *str, size_t str_size) {
+
+    struct sail_buffered_reader reader;
+    SAIL_TRY(sail_init_buffered_reader(io, 1, &reader));
+
+    SAIL_TRY_OR_CLEANUP(pnm_private_read_word(&reader, str, str_size),
+                        /* cleanup */ sail_finish_buffered_reader(&reader));
+
+    SAIL_TRY(sail_finish_buffered_reader(&reader));
+
+    return SAIL_OK;
+}
+
+/* Reads a header value without reading ahead. */
+static sail_status_t read_header_value(struct sail_io *io, unsigned *value) {
+
+    struct sail_buffered_reader reader;
+    SAIL_TRY(sail_init_buffered_reader(io, 1, &reader));
+
+    SAIL_TRY_OR_CLEANUP(pnm_private_read_ascii_value(&reader, value),
+                        /* cleanup */ sail_finish_buffered_reader(&reader));
+
+    SAIL_TRY(sail_finish_buffered_reader(&reader));
+
+    return SAIL_OK;
+}
+
+/* Reads the PAM header lines up to ENDHDR without reading ahead. */
+static sail_status_t read_pam_header_lines(struct sail_buffered_reader *reader, unsigned *width, unsigned *height, unsigned *depth, unsigned *max_color) {
+
+    *width = *height = *depth = *max_color = 0;
+
+    for (;;) {
+        char line[128];
+        size_t length = 0;
+        uint8_t c;
+
+        /* Lines longer than the buffer are truncated. */
+        for (;;) {
+            SAIL_TRY(sail_buffered_reader_read_byte(reader, &c));
+
+            if (c == '\n') {
+                break;
+            }
+
+            if (length < sizeof(line) - 1) {
+                line[length++] = (char)c;
+            }
+        }
+
+        line[length] = '\0';
+
+        const char *key = line;
+
+        while (*key == ' ' || *key == '\t' || *key == '\r') {
+            key++;
+        }
+
+        if (*key == '\0' || *key == '#') {
+            continue;
+        }
+
+        if (strncmp(key, "ENDHDR", 6) == 0) {
+            break;
+        }
+
+        const char *value = key;
+
+        while (*value != '\0' && *value != ' ' && *value != '\t') {
+            value++;
+        }
+
+        const size_t key_length = (size_t)(value - key);
+        const unsigned number = (unsigned)strtoul(value, NULL, 10);
+
+        if (key_length == 5 && strncmp(key, "WIDTH", 5) == 0) {
+            *width = number;
+        } else if (key_length == 6 && strncmp(key, "HEIGHT", 6) == 0) {
+            *height = number;
+        } else if (key_length == 5 && strncmp(key, "DEPTH", 5) == 0) {
+            *depth = number;
+        } else if (key_length == 6 && strncmp(key, "MAXVAL", 6) == 0) {
+            *max_color = number;
+        } else if (key_length == 8 && strncmp(key, "TUPLTYPE", 8) == 0) {
+            /* The tuple type is derived from the depth. */
+            SAIL_LOG_TRACE("PNM: Tuple type '%s'", value);
+        } else {
+            SAIL_LOG_WARNING("PNM: Skipping unknown PAM header line '%s'", key);
+        }
+    }
+
+    if (*width == 0 || *height == 0 || *depth == 0 || *max_color == 0) {
+        SAIL_LOG_ERROR("PNM: PAM header misses WIDTH, HEIGHT, DEPTH, or MAXVAL");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_pam_header(struct sail_io *io, unsigned *width, unsigned *height, unsigned *depth, unsigned *max_color) {
+
+    struct sail_buffered_reader reader;
+    SAIL_TRY(sail_init_buffered_reader(io, 1, &reader));
+
+    SAIL_TRY_OR_CLEANUP(read_pam_header_lines(&reader, width, height, depth, max_color),
+                        /* cleanup */ sail_finish_buffered_reader(&reader));
+
+    SAIL_TRY(sail_finish_buffered_reader(&reader));
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_ascii_pixels(const struct pnm_state *pnm_state, struct sail_buffered_reader *reader, struct sail_image *image) {
+
+    switch (pnm_state->version) {
+        case SAIL_PNM_VERSION_P1: {
+            for (unsigned row = 0; row < image->height; row++) {
+                uint8_t *scan = sail_scan_line_to_load(pnm_state->load_options, image, row);
+                unsigned shift = 8;
+
+                for (unsigned column = 0; column < image->width; column++) {
+                    /* Bits may go without separators. */
+                    SAIL_TRY(pnm_private_skip_separators(reader));
+
+                    uint8_t c;
+                    SAIL_TRY(sail_buffered_reader_read_byte(reader, &c));
+
+                    const unsigned value = c - '0';
+
+                    if (value != 0 && value != 1) {
+                        SAIL_LOG_ERROR("PNM: Unexpected character '%c'", c);
+                        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+                    }
+
+                    if (shift == 8) {
+                        *scan = 0;
+                    }
+
+                    *scan |= (value << --shift);
+
+                    if (shift == 0) {
+                        scan++;
+                        shift = 8;
+                    }
+                }
+
+                SAIL_TRY(sail_scan_line_loaded(pnm_state->load_options, image, row));
+            }
+            break;
+        }
+        case SAIL_PNM_VERSION_P2: {
+            SAIL_TRY(pnm_private_read_pixels(reader, pnm_state->load_options, image, 1, pnm_state->bpc, pnm_state->multiplier_to_full_range));
+            break;
+        }
+        case SAIL_PNM_VERSION_P3: {
+            SAIL_TRY(pnm_private_read_pixels(reader, pnm_state->load_options, image, 3, pnm_state->bpc, pnm_state->multiplier_to_full_range));
+            break;
+        }
+        default: {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
+        }
+    }
+
+    return SAIL_OK;
+}
+
 /*
  * Decoding functions.
  */
@@ -96,7 +269,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_pnm(struct sail_io *io, const
 
     /* Init decoder. */
     char str[8];
-    SAIL_TRY(pnm_private_read_word(pnm_state->io, str, sizeof(str)));
+    SAIL_TRY(read_header_word(pnm_state->io, str, sizeof(str)));
 
     const char pnm = str[1];
 
@@ -109,6 +282,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_pnm(struct sail_io *io, const
         case '4': pnm_state->version = SAIL_PNM_VERSION_P4; break;
         case '5': pnm_state->version = SAIL_PNM_VERSION_P5; break;
         case '6': pnm_state->version = SAIL_PNM_VERSION_P6; break;
+        case '7': pnm_state->version = SAIL_PNM_VERSION_P7; break;
 
         default: {
             SAIL_LOG_ERROR("PNM: Unsupported version '%c'", pnm);
@@ -129,52 +303,33 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_pnm(void *state, st
 
     pnm_state->frame_loaded = true;
 
-    char buffer[32];
-
-    /* Dimensions. */
     unsigned w;
-    SAIL_TRY(pnm_private_read_word(pnm_state->io, buffer, sizeof(buffer)));
-
-#ifdef _MSC_VER
-    if (sscanf_s(buffer, "%u", &w) != 1) {
-#else
-    if (sscanf(buffer, "%u", &w) != 1) {
-#endif
-        SAIL_LOG_ERROR("PNM: Failed to read image dimensions");
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
-    }
-
     unsigned h;
-    SAIL_TRY(pnm_private_read_word(pnm_state->io, buffer, sizeof(buffer)));
-
-#ifdef _MSC_VER
-    if (sscanf_s(buffer, "%u", &h) != 1) {
-#else
-    if (sscanf(buffer, "%u", &h) != 1) {
-#endif
-        SAIL_LOG_ERROR("PNM: Failed to read image dimensions");
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
-    }
+    unsigned max_color;
 
-    /* Maximum color. */
-    if (pnm_state->version == SAIL_PNM_VERSION_P2     ||
-            pnm_state->version == SAIL_PNM_VERSION_P3 ||
-            pnm_state->version == SAIL_PNM_VERSION_P5 ||
-            pnm_state->version == SAIL_PNM_VERSION_P6) {
-
-        SAIL_TRY(pnm_private_read_word(pnm_state->io, buffer, sizeof(buffer)));
-
-        unsigned max_color;
-#ifdef _MSC_VER
-        if (sscanf_s(buffer, "%u", &max_color) != 1) {
-#else
-        if (sscanf(buffer, "%u", &max_color) != 1) {
-#endif
-            SAIL_LOG_ERROR("PNM: Failed to read maximum color value");
-            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    if (pnm_state->version == SAIL_PNM_VERSION_P7) {
+        SAIL_TRY(read_pam_header(pnm_state->io, &w, &h, &pnm_state->depth, &max_color));
+    } else {
+        /* Dimensions. */
+        SAIL_TRY(read_header_value(pnm_state->io, &w));
+        SAIL_TRY(read_header_value(pnm_state->io, &h));
+
+        /* Maximum color. */
+        if (pnm_state->version == SAIL_PNM_VERSION_P1 || pnm_state->version == SAIL_PNM_VERSION_P4) {
+            max_color = 1;
+        } else {
+            SAIL_TRY(read_header_value(pnm_state->io, &max_color));
         }
+    }
 
-        if (max_color <= 255) {
+    if (pnm_state->version == SAIL_PNM_VERSION_P1 || pnm_state->version == SAIL_PNM_VERSION_P4) {
+        pnm_state->multiplier_to_full_range = 1;
+        pnm_state->bpc = 1;
+    } else {
+        if (max_color == 0) {
+            SAIL_LOG_ERROR("PNM: Maximum color value must not be 0");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        } else if (max_color <= 255) {
             pnm_state->bpc = 8;
             pnm_state->multiplier_to_full_range = 255.0 / max_color;
         } else if (max_color <= 65535) {
@@ -186,12 +341,14 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_pnm(void *state, st
         }
 
         SAIL_LOG_TRACE("PNM: Max color(%u), scale(%.1f)", max_color, pnm_state->multiplier_to_full_range);
-    } else {
-        pnm_state->multiplier_to_full_range = 1;
-        pnm_state->bpc = 1;
     }
 
-    enum SailPixelFormat pixel_format = pnm_private_rgb_sail_pixel_format(pnm_state->version, pnm_state->bpc);
+    pnm_state->max_color = max_color;
+
+    const enum SailPixelFormat pixel_format = (pnm_state->version == SAIL_PNM_VERSION_P7)
+                                                ? pnm_private_pam_sail_pixel_format(pnm_state->depth, pnm_state->bpc)
+                                                : pnm_private_rgb_sail_pixel_format(pnm_state->version, pnm_state->bpc);
+
 
     if (pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN) {
         SAIL_LOG_ERROR("PNM: Unsupported pixel format");
@@ -240,49 +397,48 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_pnm(void *state, struct sail_
     const struct pnm_state *pnm_state = state;
 
     switch (pnm_state->version) {
-        case SAIL_PNM_VERSION_P1: {
-            for (unsigned row = 0; row < image->height; row++) {
-                uint8_t *scan = sail_scan_line(image, row);
-                unsigned shift = 8;
+        case SAIL_PNM_VERSION_P1:
+        case SAIL_PNM_VERSION_P2:
+        case SAIL_PNM_VERSION_P3: {
+            /* ASCII values are parsed by single characters. */
+            struct sail_buffered_reader reader;
+            SAIL_TRY(sail_init_buffered_reader(pnm_state->io, 0, &reader));
 
-                for (unsigned column = 0; column < image->width; column++) {
-                    char first_char;
-                    SAIL_TRY(pnm_private_skip_to_letters_numbers_force_read(pnm_state->io, &first_char));
+            SAIL_TRY_OR_CLEANUP(read_ascii_pixels(pnm_state, &reader, image),
+                                /* cleanup */ sail_finish_buffered_reader(&reader));
 
-                    const unsigned value = first_char - '0';
+            SAIL_TRY(sail_finish_buffered_reader(&reader));
+            break;
+        }
+        case SAIL_PNM_VERSION_P4:
+        case SAIL_PNM_VERSION_P5:
+        case SAIL_PNM_VERSION_P6:
+        case SAIL_PNM_VERSION_P7: {
+            /* Samples below the full range are stretched to it like the ASCII ones. */
+            const bool rescale8 = pnm_state->bpc == 8 && pnm_state->max_color < 255;
+            uint8_t full_range8[256];
+
+            if (rescale8) {
+                pnm_private_build_full_range8(pnm_state->max_color, full_range8);
+            }
 
-                    if (value != 0 && value != 1) {
-                        SAIL_LOG_ERROR("PNM: Unexpected character '%c'", first_char);
-                        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
-                    }
+            for (unsigned row = 0; row < image->height; row++) {
+                void *scan = sail_scan_line_to_load(pnm_state->load_options, image, row);
 
-                    if (shift == 8) {
-                        *scan = 0;
-                    }
+                SAIL_TRY(pnm_state->io->strict_read(pnm_state->io->stream, scan, image->bytes_per_line));
 
-                    *scan |= (value << --shift);
+                /* 16-bit samples are stored big-endian. */
+                if (pnm_state->bpc == 16) {
+                    sail_be16_to_host(scan, scan, image->bytes_per_line / 2, pnm_state->max_color);
+                } else if (rescale8) {
+                    uint8_t *scan8 = scan;
 
-                    if (shift == 0) {
-                        scan++;
-                        shift = 8;
+                    for (unsigned i = 0; i < image->bytes_per_line; i++) {
+                        scan8[i] = full_range8[scan8[i]];
                     }
                 }
-            }
-            break;
-        }
-        case SAIL_PNM_VERSION_P2: {
-            SAIL_TRY(pnm_private_read_pixels(pnm_state->io, image, 1, pnm_state->bpc, pnm_state->multiplier_to_full_range));
-            break;
-        }
-        case SAIL_PNM_VERSION_P3: {
-            SAIL_TRY(pnm_private_read_pixels(pnm_state->io, image, 3, pnm_state->bpc, pnm_state->multiplier_to_full_range));
-            break;
-        }
-        case SAIL_PNM_VERSION_P4:
-        case SAIL_PNM_VERSION_P5:
-        case SAIL_PNM_VERSION_P6: {
-            for (unsigned row = 0; row < image->height; row++) {
-                SAIL_TRY(pnm_state->io->strict_read(pnm_state->io->stream, sail_scan_line(image, row), image->bytes_per_line));
+
+                SAIL_TRY(sail_scan_line_loaded(pnm_state->load_options, image, row));
             }
             break;
         }
@@ -308,32 +464,89 @@ SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_pnm(void **state) {
 
 SAIL_EXPORT sail_status_t sail_codec_save_init_v8_pnm(struct sail_io *io, const struct sail_save_options *save_options, void **state) {
 
-    (void)io;
-    (void)save_options;
-    (void)state;
+    *state = NULL;
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    /* Allocate a new state. */
+    struct pnm_state *pnm_state;
+    SAIL_TRY(alloc_pnm_state(io, NULL, save_options, &pnm_state));
+    *state = pnm_state;
+
+    /* Sanity check. */
+    if (pnm_state->save_options->compression != SAIL_COMPRESSION_NONE) {
+        SAIL_LOG_ERROR("PNM: Only NONE compression is allowed for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_pnm(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct pnm_state *pnm_state = state;
+
+    if (pnm_state->frame_saved) {
+        SAIL_LOG_ERROR("PNM: Only single frame is supported for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    pnm_state->frame_saved = true;
+
+    SAIL_TRY(pnm_private_sail_pixel_format_to_pnm(image->pixel_format, &pnm_state->version, &pnm_state->depth, &pnm_state->bpc));
+
+    SAIL_TRY(pnm_private_write_header(pnm_state->io, pnm_state->version, image->width, image->height, pnm_state->depth, pnm_state->bpc));
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_pnm(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    const struct pnm_state *pnm_state = state;
+
+    const size_t row_size = sail_bytes_per_line(image->width, image->pixel_format);
+
+    /* 8-bit rows without padding go in one write. */
+    if (pnm_state->bpc == 8 && image->bytes_per_line == row_size) {
+        SAIL_TRY(pnm_state->io->strict_write(pnm_state->io->stream, image->pixels, row_size * image->height));
+        return SAIL_OK;
+    }
+
+    struct sail_buffered_writer writer;
+    SAIL_TRY(sail_init_buffered_writer(pnm_state->io, 0, &writer));
+
+    void *row_be = NULL;
+
+    if (pnm_state->bpc == 16) {
+        SAIL_TRY_OR_CLEANUP(sail_malloc(row_size, &row_be),
+                            /* cleanup */ sail_finish_buffered_writer(&writer));
+    }
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const void *scan = sail_scan_line(image, row);
+
+        if (row_be != NULL) {
+            pnm_private_host_to_be16(scan, row_size / 2, row_be);
+            scan = row_be;
+        }
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+        SAIL_TRY_OR_CLEANUP(sail_buffered_writer_strict_write(&writer, scan, row_size),
+                            /* cleanup */ sail_free(row_be),
+                                          sail_finish_buffered_writer(&writer));
+    }
+
+    sail_free(row_be);
+
+    SAIL_TRY(sail_finish_buffered_writer(&writer));
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_pnm(void **state) {
 
-    (void)state;
+    struct pnm_state *pnm_state = *state;
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    *state = NULL;
+
+    destroy_pnm_state(pnm_state);
+
+    return SAIL_OK;
 }
@@ -23,6 +23,8 @@
     SOFTWARE.
 */
 
+#include <string.h>
+
 #include <sail-common/sail-common.h>
 
 #include "helpers.h"
@@ -31,7 +33,9 @@ sail_status_t psd_private_get_big_endian_uint16_t(struct sail_io *io, uint16_t *
 {
     SAIL_TRY(io->strict_read(io->stream, v, sizeof(*v)));
 
+#if SAIL_LITTLE_ENDIAN
     *v = sail_reverse_uint16(*v);
+#endif
 
     return SAIL_OK;
 }
@@ -40,33 +44,57 @@ sail_status_t psd_private_get_big_endian_uint32_t(struct sail_io *io, uint32_t *
 {
     SAIL_TRY(io->strict_read(io->stream, v, sizeof(*v)));
 
+#if SAIL_LITTLE_ENDIAN
     *v = sail_reverse_uint32(*v);
+#endif
 
     return SAIL_OK;
 }
 
+uint16_t psd_private_composite_channels(enum SailPsdMode mode, uint16_t channels) {
+
+    /* Channels after the color channels and the transparency are alpha and spot channels not needed for the composite. */
+    switch (mode) {
+        case SAIL_PSD_MODE_BITMAP:
+        case SAIL_PSD_MODE_INDEXED:   return SAIL_MIN(channels, 1);
+        case SAIL_PSD_MODE_GRAYSCALE: return SAIL_MIN(channels, 2);
+        case SAIL_PSD_MODE_RGB:       return SAIL_MIN(channels, 4);
+        case SAIL_PSD_MODE_CMYK:      return SAIL_MIN(channels, 5);
+        default:                      return channels;
+    }
+}
+
 sail_status_t psd_private_sail_pixel_format(enum SailPsdMode mode, uint16_t channels, uint16_t depth, enum SailPixelFormat *result) {
 
+    /* 32-bit floating point samples are converted to 16-bit. */
+    const bool bpp8 = depth == 8;
+    const bool bpp16 = depth == 16 || depth == 32;
+
     switch (mode) {
         case SAIL_PSD_MODE_BITMAP: {
-            switch (channels) {
-                case 1: *result = SAIL_PIXEL_FORMAT_BPP1_INDEXED; return SAIL_OK;
+            if (channels == 1 && depth == 1) {
+                *result = SAIL_PIXEL_FORMAT_BPP1_INDEXED;
+                return SAIL_OK;
             }
             break;
         }
         case SAIL_PSD_MODE_INDEXED: {
-            switch (channels) {
-                case 1: *result = SAIL_PIXEL_FORMAT_BPP8_INDEXED; return SAIL_OK;
+            if (channels == 1 && bpp8) {
+                *result = SAIL_PIXEL_FORMAT_BPP8_INDEXED;
+                return SAIL_OK;
             }
             break;
         }
         case SAIL_PSD_MODE_GRAYSCALE: {
             switch (channels) {
                 case 1: {
-                    switch (depth) {
-                        case 8:  *result = SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;  return SAIL_OK;
-                        case 16: *result = SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE; return SAIL_OK;
-                    }
+                    if (bpp8)  { *result = SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;  return SAIL_OK; }
+                    if (bpp16) { *result = SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE; return SAIL_OK; }
+                    break;
+                }
+                case 2: {
+                    if (bpp8)  { *result = SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA; return SAIL_OK; }
+                    if (bpp16) { *result = SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA; return SAIL_OK; }
                     break;
                 }
             }
@@ -75,17 +103,13 @@ sail_status_t psd_private_sail_pixel_format(enum SailPsdMode mode, uint16_t chan
         case SAIL_PSD_MODE_RGB: {
             switch (channels) {
                 case 3: {
-                    switch(depth) {
-                        case 8:  *result = SAIL_PIXEL_FORMAT_BPP24_RGB; return SAIL_OK;
-                        case 16: *result = SAIL_PIXEL_FORMAT_BPP48_RGB; return SAIL_OK;
-                    }
+                    if (bpp8)  { *result = SAIL_PIXEL_FORMAT_BPP24_RGB; return SAIL_OK; }
+                    if (bpp16) { *result = SAIL_PIXEL_FORMAT_BPP48_RGB; return SAIL_OK; }
                     break;
                 }
                 case 4: {
-                    switch (depth) {
-                        case 8:  *result = SAIL_PIXEL_FORMAT_BPP32_RGBA; return SAIL_OK;
-                        case 16: *result = SAIL_PIXEL_FORMAT_BPP64_RGBA; return SAIL_OK;
-                    }
+                    if (bpp8)  { *result = SAIL_PIXEL_FORMAT_BPP32_RGBA; return SAIL_OK; }
+                    if (bpp16) { *result = SAIL_PIXEL_FORMAT_BPP64_RGBA; return SAIL_OK; }
                     break;
                 }
             }
@@ -93,12 +117,14 @@ sail_status_t psd_private_sail_pixel_format(enum SailPsdMode mode, uint16_t chan
         }
         case SAIL_PSD_MODE_CMYK: {
             switch (channels) {
-                /* TODO: 5 channels? */
                 case 4: {
-                    switch (depth) {
-                        case 8:  *result = SAIL_PIXEL_FORMAT_BPP32_CMYK; return SAIL_OK;
-                        case 16: *result = SAIL_PIXEL_FORMAT_BPP64_CMYK; return SAIL_OK;
-                    }
+                    if (bpp8)       { *result = SAIL_PIXEL_FORMAT_BPP32_CMYK; return SAIL_OK; }
+                    if (depth == 16) { *result = SAIL_PIXEL_FORMAT_BPP64_CMYK; return SAIL_OK; }
+                    break;
+                }
+                case 5: {
+                    if (bpp8)       { *result = SAIL_PIXEL_FORMAT_BPP40_CMYKA; return SAIL_OK; }
+                    if (depth == 16) { *result = SAIL_PIXEL_FORMAT_BPP80_CMYKA; return SAIL_OK; }
                     break;
                 }
             }
@@ -109,7 +135,7 @@ sail_status_t psd_private_sail_pixel_format(enum SailPsdMode mode, uint16_t chan
         }
     }
 
-    SAIL_LOG_ERROR("PSD: Unsuppored combination of mode(%u) and channels(%u)", mode, channels);
+    SAIL_LOG_ERROR("PSD: Unsuppored combination of mode(%u), channels(%u), and depth(%u)", mode, channels, depth);
     SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
 }
 
@@ -123,3 +149,21 @@ enum SailCompression psd_private_sail_compression(enum SailPsdCompression compre
         default: return SAIL_COMPRESSION_UNKNOWN;
     }
 }
+
+bool psd_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    unsigned *threads = user_data;
+
+    if (strcmp(key, "psd-threads") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned threads_value = sail_variant_to_unsigned_int(value);
+
+            if (threads_value > 0) {
+                SAIL_LOG_TRACE("PSD: Decoding in at most %u threads", threads_value);
+                *threads = threads_value;
+            }
+        }
+    }
+
+    return true;
+}
@@ -26,6 +26,7 @@
 #ifndef SAIL_PSD_HELPERS_H
 #define SAIL_PSD_HELPERS_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <sail-common/common.h>
@@ -53,13 +54,21 @@ enum SailPsdCompression {
 };
 
 struct sail_io;
+struct sail_variant;
 
 SAIL_HIDDEN sail_status_t psd_private_get_big_endian_uint16_t(struct sail_io *io, uint16_t *v);
 
 SAIL_HIDDEN sail_status_t psd_private_get_big_endian_uint32_t(struct sail_io *io, uint32_t *v);
 
+/*
+ * Returns the number of leading channels that make up the composite image.
+ */
+SAIL_HIDDEN uint16_t psd_private_composite_channels(enum SailPsdMode mode, uint16_t channels);
+
 SAIL_HIDDEN sail_status_t psd_private_sail_pixel_format(enum SailPsdMode mode, uint16_t channels, uint16_t depth, enum SailPixelFormat *result);
 
 SAIL_HIDDEN enum SailCompression psd_private_sail_compression(enum SailPsdCompression compression);
 
+SAIL_HIDDEN bool psd_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
 #endif
@@ -0,0 +1,230 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "parallel.h"
+
+/*
+ * Private functions.
+ */
+
+struct worker {
+
+    /* Input. */
+    const struct psd_private_planes *planes;
+    struct sail_image *image;
+    unsigned first_row;
+    unsigned rows;
+
+    /* Output. */
+    sail_status_t status;
+};
+
+/* Unpacks a PackBits row. Runs must not cross the row boundary. */
+static sail_status_t unpack_row(const unsigned char *src, size_t src_size, unsigned char *dst, size_t dst_size) {
+
+    size_t in = 0;
+    size_t out = 0;
+
+    while (out < dst_size) {
+        if (in >= src_size) {
+            SAIL_LOG_ERROR("PSD: RLE row is truncated");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        const unsigned c = src[in++];
+
+        if (c < 128) {
+            const size_t length = c + 1;
+
+            if (length > src_size - in || length > dst_size - out) {
+                SAIL_LOG_ERROR("PSD: RLE literal run is out of bounds");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+            }
+
+            memcpy(dst + out, src + in, length);
+            in  += length;
+            out += length;
+        } else if (c > 128) {
+            const size_t length = 257 - c;
+
+            if (in >= src_size || length > dst_size - out) {
+                SAIL_LOG_ERROR("PSD: RLE repeat run is out of bounds");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+            }
+
+            memset(dst + out, src[in++], length);
+            out += length;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static void interleave_row(const unsigned char *channel_row, unsigned channel, const struct psd_private_planes *planes,
+                            unsigned width, unsigned char *scan) {
+
+    if (planes->channels == 1 && planes->depth <= 8) {
+        memcpy(scan, channel_row, planes->bytes_per_channel);
+        return;
+    }
+
+    if (planes->channels == 1 && planes->depth == 16) {
+        sail_be16_to_host(channel_row, scan, width, 0);
+        return;
+    }
+
+    if (planes->depth == 32) {
+        uint16_t *scan16 = (uint16_t *)scan + channel;
+
+        for (unsigned column = 0; column < width; column++, channel_row += 4, scan16 += planes->channels) {
+            const uint32_t bits = ((uint32_t)channel_row[0] << 24) | ((uint32_t)channel_row[1] << 16) |
+                                    ((uint32_t)channel_row[2] << 8) | channel_row[3];
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+
+            /* NaNs fail both comparisons and become 0. */
+            *scan16 = (value >= 1.0f) ? UINT16_MAX : (value > 0.0f) ? (uint16_t)(value * 65535.0f + 0.5f) : 0;
+        }
+    } else if (planes->depth == 16) {
+        uint16_t *scan16 = (uint16_t *)scan + channel;
+
+        for (unsigned column = 0; column < width; column++, channel_row += 2, scan16 += planes->channels) {
+            *scan16 = (uint16_t)((channel_row[0] << 8) | channel_row[1]);
+        }
+    } else {
+        scan += channel;
+
+        for (unsigned column = 0; column < width; column++, scan += planes->channels) {
+            *scan = channel_row[column];
+        }
+    }
+}
+
+static sail_status_t decode_band(const struct worker *worker, unsigned char *channel_buffer) {
+
+    const struct psd_private_planes *planes = worker->planes;
+    struct sail_image *image = worker->image;
+
+    for (unsigned row = worker->first_row; row < worker->first_row + worker->rows; row++) {
+        unsigned char *scan = sail_scan_line(image, row);
+
+        SAIL_TRY(sail_check_cancellation(planes->cancellation));
+
+        /* Single-channel 8-bit and 1-bit rows need no interleaving. */
+        if (planes->channels == 1 && planes->depth <= 8 && planes->row_offsets != NULL) {
+            SAIL_TRY(unpack_row(planes->data + planes->row_offsets[row], planes->row_sizes[row], scan, planes->bytes_per_channel));
+            continue;
+        }
+
+        for (unsigned channel = 0; channel < planes->channels; channel++) {
+            const size_t plane_row = (size_t)channel * image->height + row;
+            const unsigned char *channel_row;
+
+            if (planes->row_offsets != NULL) {
+                SAIL_TRY(unpack_row(planes->data + planes->row_offsets[plane_row], planes->row_sizes[plane_row],
+                                    channel_buffer, planes->bytes_per_channel));
+                channel_row = channel_buffer;
+            } else {
+                channel_row = planes->data + plane_row * planes->bytes_per_channel;
+            }
+
+            interleave_row(channel_row, channel, planes, image->width, scan);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static void decode_worker(struct worker *worker) {
+
+    void *ptr;
+    worker->status = sail_malloc(worker->planes->bytes_per_channel, &ptr);
+
+    if (worker->status != SAIL_OK) {
+        return;
+    }
+
+    worker->status = decode_band(worker, ptr);
+
+    sail_free(ptr);
+}
+
+static void decode_worker_task(void *user_data, unsigned task, unsigned thread) {
+
+    (void)thread;
+
+    struct worker *workers = user_data;
+    decode_worker(&workers[task]);
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t psd_private_decode_planes_parallel(const struct psd_private_planes *planes, struct sail_image *image, unsigned threads) {
+
+    const unsigned workers_count = (threads == 0) ? 1 : SAIL_MIN(threads, image->height);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct worker) * workers_count, &ptr));
+    struct worker *workers = ptr;
+
+    /* Split the rows into contiguous bands. */
+    const unsigned rows_per_worker = image->height / workers_count;
+    const unsigned rows_left       = image->height % workers_count;
+
+    for (unsigned i = 0, first_row = 0; i < workers_count; i++) {
+        workers[i] = (struct worker) {
+            .planes    = planes,
+            .image     = image,
+            .first_row = first_row,
+            .rows      = rows_per_worker + (i < rows_left ? 1 : 0),
+            .status    = SAIL_OK,
+        };
+
+        first_row += workers[i].rows;
+    }
+
+    sail_thread_pool_run(workers_count, decode_worker_task, workers);
+
+    sail_status_t status = SAIL_OK;
+
+    for (unsigned i = 0; i < workers_count && status == SAIL_OK; i++) {
+        status = workers[i].status;
+    }
+
+    sail_free(workers);
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
@@ -0,0 +1,67 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_PSD_PARALLEL_H
+#define SAIL_PSD_PARALLEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_cancellation;
+struct sail_image;
+
+/*
+ * Planar PSD image data read into memory. Rows of the first channel follow each other,
+ * then rows of the second channel, and so on.
+ */
+struct psd_private_planes {
+
+    const unsigned char *data;
+
+    /* Offsets and sizes of the channels * height RLE rows in 'data', or NULL if the data are uncompressed. */
+    const size_t *row_offsets;
+    const uint16_t *row_sizes;
+
+    unsigned channels;
+    unsigned depth;
+    size_t bytes_per_channel;
+
+    /* Checked by every task between rows. Can be NULL. */
+    const struct sail_cancellation *cancellation;
+};
+
+/*
+ * Decodes the planes and interleaves the channels into the image pixels in row bands,
+ * one band per thread pool task. 16-bit samples are converted from big endian, 32-bit floating point samples
+ * are clamped to [0, 1] and converted to 16-bit.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t psd_private_decode_planes_parallel(const struct psd_private_planes *planes, struct sail_image *image, unsigned threads);
+
+#endif
@@ -31,6 +31,7 @@
 #include <sail-common/sail-common.h>
 
 #include "helpers.h"
+#include "parallel.h"
 
 static const unsigned SAIL_PSD_MAGIC = 0x38425053;
 
@@ -47,11 +48,15 @@ struct psd_state {
     bool frame_loaded;
 
     uint16_t channels;
+    uint16_t composite_channels;
     uint16_t depth;
     enum SailPsdCompression compression;
-    unsigned bytes_per_channel;
-    unsigned char *scan_buffer;
+    size_t bytes_per_channel;
+    uint16_t *row_sizes;
     struct sail_palette *palette;
+
+    /* The number of threads to decode row bands in. */
+    unsigned threads;
 };
 
 static sail_status_t alloc_psd_state(struct sail_io *io,
@@ -70,12 +75,14 @@ static sail_status_t alloc_psd_state(struct sail_io *io,
 
         .frame_loaded      = false,
 
-        .channels          = 0,
-        .depth             = 0,
+        .channels           = 0,
+        .composite_channels = 0,
+        .depth              = 0,
         .compression       = SAIL_PSD_COMPRESSION_NONE,
         .bytes_per_channel = 0,
-        .scan_buffer       = NULL,
+        .row_sizes         = NULL,
         .palette           = NULL,
+        .threads           = 1,
     };
 
     return SAIL_OK;
@@ -87,13 +94,51 @@ static void destroy_psd_state(struct psd_state *psd_state) {
         return;
     }
 
-    sail_free(psd_state->scan_buffer);
+    sail_free(psd_state->row_sizes);
 
     sail_destroy_palette(psd_state->palette);
 
     sail_free(psd_state);
 }
 
+/* Hints the I/O object about the data that follow the bytes about to be skipped. */
+static sail_status_t will_need_after(struct sail_io *io, size_t bytes_to_skip, size_t length) {
+
+    if ((io->features & SAIL_IO_FEATURE_EXPENSIVE_SEEK) == 0) {
+        return SAIL_OK;
+    }
+
+    size_t offset;
+    SAIL_TRY(io->tell(io->stream, &offset));
+
+    SAIL_TRY(sail_io_will_need(io, offset + bytes_to_skip, length));
+
+    return SAIL_OK;
+}
+
+/* Allocates the state palette outside of the frame arena as the palette outlives the frame. */
+static sail_status_t alloc_state_palette(unsigned color_count, struct sail_palette **palette) {
+
+    struct sail_arena *arena = sail_set_thread_arena(NULL);
+    const sail_status_t status = sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, color_count, palette);
+    sail_set_thread_arena(arena);
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
+
+static enum SailPixelFormat float_source_pixel_format(uint16_t channels) {
+
+    switch (channels) {
+        case 1:  return SAIL_PIXEL_FORMAT_BPP32;
+        case 2:  return SAIL_PIXEL_FORMAT_BPP64;
+        case 3:  return SAIL_PIXEL_FORMAT_BPP96;
+        case 4:  return SAIL_PIXEL_FORMAT_BPP128;
+        default: return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+}
+
 /*
  * Decoding functions.
  */
@@ -124,6 +169,11 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_psd(struct sail_io *io, const
         SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
     }
 
+    /* Handle tuning. */
+    if (psd_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(psd_state->load_options->tuning, psd_private_tuning_key_value_callback, &psd_state->threads);
+    }
+
     return SAIL_OK;
 }
 
@@ -160,7 +210,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_psd(void *state, st
     /* Palette. */
     if (data_size > 0) {
         SAIL_LOG_TRACE("PSD: Palette data size: %u", data_size);
-        SAIL_TRY(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 256, &psd_state->palette));
+        SAIL_TRY(alloc_state_palette(256, &psd_state->palette));
 
         /* Merge RR GG BB... to RGB RGB... */
         unsigned char buf[256*3];
@@ -174,15 +224,17 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_psd(void *state, st
             }
         }
     } else if (mode == SAIL_PSD_MODE_BITMAP) {
-        SAIL_TRY(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 2, &psd_state->palette));
+        SAIL_TRY(alloc_state_palette(2, &psd_state->palette));
         memcpy(psd_state->palette->data, SAIL_PSD_MONO_PALETTE, 6);
     }
 
-    /* Skip the image resources. */
+    /* Skip the image resources. Only the length of the next section is needed after them. */
     SAIL_TRY(psd_private_get_big_endian_uint32_t(psd_state->io, &data_size));
+    SAIL_TRY(will_need_after(psd_state->io, data_size, sizeof(uint32_t)));
     SAIL_TRY(psd_state->io->seek(psd_state->io->stream, data_size, SEEK_CUR));
-    /* Skip the layer and mask information. */
+    /* Skip the layer and mask information. The image data follow until the end. */
     SAIL_TRY(psd_private_get_big_endian_uint32_t(psd_state->io, &data_size));
+    SAIL_TRY(will_need_after(psd_state->io, data_size, 0));
     SAIL_TRY(psd_state->io->seek(psd_state->io->stream, data_size, SEEK_CUR));
 
     /* Compression. */
@@ -196,24 +248,30 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_psd(void *state, st
 
     psd_state->compression = compression;
 
-    /* Skip byte counts for all the scan lines. */
-    if (psd_state->compression == SAIL_PSD_COMPRESSION_RLE) {
-        SAIL_TRY(psd_state->io->seek(psd_state->io->stream, (long)height * psd_state->channels * 2, SEEK_CUR));
-    }
+    psd_state->bytes_per_channel = ((size_t)width * psd_state->depth + 7) / 8;
 
-    /* Used to optimize uncompressed readings. */
-    if (psd_state->compression == SAIL_PSD_COMPRESSION_NONE) {
-        psd_state->bytes_per_channel = ((unsigned)width * psd_state->depth + 7) / 8;
+    /* Byte counts for all the compressed scan lines of all the channels. */
+    if (psd_state->compression == SAIL_PSD_COMPRESSION_RLE) {
+        const size_t rows = (size_t)height * psd_state->channels;
 
         void *ptr;
-        SAIL_TRY(sail_malloc(psd_state->bytes_per_channel, &ptr));
-        psd_state->scan_buffer = ptr;
+        SAIL_TRY(sail_malloc(rows * sizeof(uint16_t), &ptr));
+        psd_state->row_sizes = ptr;
+
+        SAIL_TRY(psd_state->io->strict_read(psd_state->io->stream, psd_state->row_sizes, rows * sizeof(uint16_t)));
+
+        for (size_t i = 0; i < rows; i++) {
+            const unsigned char *bytes = (const unsigned char *)&psd_state->row_sizes[i];
+            psd_state->row_sizes[i] = (uint16_t)((bytes[0] << 8) | bytes[1]);
+        }
     }
 
     SAIL_LOG_TRACE("PSD: mode(%u), channels(%u), depth(%u)", mode, psd_state->channels, psd_state->depth);
 
+    psd_state->composite_channels = psd_private_composite_channels(mode, psd_state->channels);
+
     enum SailPixelFormat pixel_format;
-    SAIL_TRY(psd_private_sail_pixel_format(mode, psd_state->channels, psd_state->depth, &pixel_format));
+    SAIL_TRY(psd_private_sail_pixel_format(mode, psd_state->composite_channels, psd_state->depth, &pixel_format));
 
     /* Allocate image. */
     struct sail_image *image_local;
@@ -223,7 +281,10 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_psd(void *state, st
         SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&image_local->source_image),
                             /* cleanup */ sail_destroy_image(image_local));
 
-        image_local->source_image->pixel_format = pixel_format;
+        /* Floating point samples have no SAIL pixel format. */
+        image_local->source_image->pixel_format = (psd_state->depth == 32)
+                                                    ? float_source_pixel_format(psd_state->composite_channels)
+                                                    : pixel_format;
         image_local->source_image->compression  = psd_private_sail_compression(psd_state->compression);
     }
 
@@ -245,55 +306,59 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_psd(void *state, struct sail_
 
     const struct psd_state *psd_state = state;
 
-    const unsigned bpp = (psd_state->channels * psd_state->depth + 7) / 8;
+    /* Extra channels follow the composite channels, so they are neither read nor decoded. */
+    const size_t plane_rows = (size_t)image->height * psd_state->composite_channels;
+
+    struct psd_private_planes planes = {
+        .data              = NULL,
+        .row_offsets       = NULL,
+        .row_sizes         = psd_state->row_sizes,
+        .channels          = psd_state->composite_channels,
+        .depth             = psd_state->depth,
+        .bytes_per_channel = psd_state->bytes_per_channel,
+        .cancellation      = psd_state->load_options->cancellation,
+    };
+
+    /* The channels are stored one after another, so read all of them at once to interleave them row by row. */
+    size_t data_size;
+    size_t *row_offsets = NULL;
 
     if (psd_state->compression == SAIL_PSD_COMPRESSION_RLE) {
-        for (unsigned channel = 0; channel < psd_state->channels; channel++) {
-            for (unsigned row = 0; row < image->height; row++) {
-                for (unsigned count = 0; count < image->width; ) {
-                    unsigned char c;
-                    SAIL_TRY(psd_state->io->strict_read(psd_state->io->stream, &c, sizeof(c)));
-
-                    if (c > 128) {
-                        c ^= 0xff;
-                        c += 2;
-
-                        unsigned char value;
-                        SAIL_TRY(psd_state->io->strict_read(psd_state->io->stream, &value, sizeof(value)));
-
-                        for (unsigned i = count; i < count + c; i++) {
-                            unsigned char *scan = (unsigned char *)sail_scan_line(image, row) + i * bpp;
-                            *(scan + channel) = value;
-                        }
-                    } else if (c < 128) {
-                        c++;
-
-                        for (unsigned i = count; i < count + c; i++) {
-                            unsigned char value;
-                            SAIL_TRY(psd_state->io->strict_read(psd_state->io->stream, &value, sizeof(value)));
-
-                            unsigned char *scan = (unsigned char *)sail_scan_line(image, row) + i * bpp;
-                            *(scan + channel) = value;
-                        }
-                    }
-
-                    count += c;
-                }
-            }
+        void *ptr;
+        SAIL_TRY(sail_malloc(plane_rows * sizeof(size_t), &ptr));
+        row_offsets = ptr;
+
+        data_size = 0;
+
+        for (size_t i = 0; i < plane_rows; i++) {
+            row_offsets[i] = data_size;
+            data_size += psd_state->row_sizes[i];
         }
+
+        planes.row_offsets = row_offsets;
     } else {
-        for (unsigned channel = 0; channel < psd_state->channels; channel++) {
-            for (unsigned row = 0; row < image->height; row++) {
-                SAIL_TRY(psd_state->io->strict_read(psd_state->io->stream, psd_state->scan_buffer, psd_state->bytes_per_channel));
-
-                for (unsigned count = 0; count < psd_state->bytes_per_channel; count++) {
-                    unsigned char *scan = (unsigned char *)sail_scan_line(image, row) + count * bpp;
-                    *(scan + channel) = *(psd_state->scan_buffer + count);
-                }
-            }
-        }
+        data_size = plane_rows * psd_state->bytes_per_channel;
     }
 
+    SAIL_TRY_OR_CLEANUP(sail_check_load_limits(psd_state->load_options, image->width, image->height, data_size),
+                        /* cleanup */ sail_free(row_offsets));
+
+    void *data;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(data_size, &data),
+                        /* cleanup */ sail_free(row_offsets));
+    planes.data = data;
+
+    SAIL_TRY_OR_CLEANUP(psd_state->io->strict_read(psd_state->io->stream, data, data_size),
+                        /* cleanup */ sail_free(data),
+                                      sail_free(row_offsets));
+
+    SAIL_TRY_OR_CLEANUP(psd_private_decode_planes_parallel(&planes, image, psd_state->threads),
+                        /* cleanup */ sail_free(data),
+                                      sail_free(row_offsets));
+
+    sail_free(data);
+    sail_free(row_offsets);
+
     return SAIL_OK;
 }
 
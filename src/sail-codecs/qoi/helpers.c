@@ -0,0 +1,297 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "helpers.h"
+
+#define QOI_OP_INDEX 0x00 /* 00xxxxxx */
+#define QOI_OP_DIFF  0x40 /* 01xxxxxx */
+#define QOI_OP_LUMA  0x80 /* 10xxxxxx */
+#define QOI_OP_RUN   0xc0 /* 11xxxxxx */
+#define QOI_OP_RGB   0xfe /* 11111110 */
+#define QOI_OP_RGBA  0xff /* 11111111 */
+
+#define QOI_MASK_2   0xc0 /* 11000000 */
+
+#define QOI_MAGIC (((uint32_t)'q') << 24 | ((uint32_t)'o') << 16 | ((uint32_t)'i') << 8 | ((uint32_t)'f'))
+
+/* Same limit as the reference implementation. */
+#define QOI_PIXELS_MAX ((uint32_t)400000000)
+
+#define QOI_COLOR_HASH(C) (((C).rgba.r * 3 + (C).rgba.g * 5 + (C).rgba.b * 7 + (C).rgba.a * 11) % 64)
+
+static const unsigned char QOI_PADDING[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+static uint32_t read_be32(const unsigned char *bytes) {
+
+    return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | (uint32_t)bytes[3];
+}
+
+static void write_be32(unsigned char *bytes, uint32_t v) {
+
+    bytes[0] = (unsigned char)(v >> 24);
+    bytes[1] = (unsigned char)(v >> 16);
+    bytes[2] = (unsigned char)(v >> 8);
+    bytes[3] = (unsigned char)v;
+}
+
+sail_status_t qoi_private_read_header(struct sail_io *io, struct qoi_private_header *header) {
+
+    unsigned char bytes[QOI_HEADER_SIZE];
+    SAIL_TRY(io->strict_read(io->stream, bytes, sizeof(bytes)));
+
+    const uint32_t magic = read_be32(bytes);
+    header->width        = read_be32(bytes + 4);
+    header->height       = read_be32(bytes + 8);
+    header->channels     = bytes[12];
+    header->colorspace   = bytes[13];
+
+    if (magic != QOI_MAGIC || header->width == 0 || header->height == 0 || header->height >= QOI_PIXELS_MAX / header->width) {
+        SAIL_LOG_ERROR("QOI: Image is broken without any details");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t qoi_private_write_header(struct sail_io *io, const struct qoi_private_header *header) {
+
+    if (header->width == 0 || header->height == 0 || header->height >= QOI_PIXELS_MAX / header->width) {
+        SAIL_LOG_ERROR("QOI: Image dimensions %ux%u are out of range", header->width, header->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    unsigned char bytes[QOI_HEADER_SIZE];
+
+    write_be32(bytes, QOI_MAGIC);
+    write_be32(bytes + 4, header->width);
+    write_be32(bytes + 8, header->height);
+    bytes[12] = header->channels;
+    bytes[13] = header->colorspace;
+
+    SAIL_TRY(io->strict_write(io->stream, bytes, sizeof(bytes)));
+
+    return SAIL_OK;
+}
+
+void qoi_private_init_decoder(struct qoi_private_decoder *decoder) {
+
+    memset(decoder->index, 0, sizeof(decoder->index));
+
+    decoder->px.rgba.r = 0;
+    decoder->px.rgba.g = 0;
+    decoder->px.rgba.b = 0;
+    decoder->px.rgba.a = 255;
+    decoder->run       = 0;
+}
+
+sail_status_t qoi_private_decode_row(struct sail_buffered_reader *reader, struct qoi_private_decoder *decoder,
+                                     unsigned char *row, unsigned width, unsigned channels) {
+
+    union qoi_private_rgba px = decoder->px;
+    unsigned run = decoder->run;
+
+    for (unsigned x = 0; x < width; x++, row += channels) {
+        if (run > 0) {
+            run--;
+        } else {
+            uint8_t b1;
+            SAIL_TRY(sail_buffered_reader_read_byte(reader, &b1));
+
+            if (b1 == QOI_OP_RGB) {
+                unsigned char rgb[3];
+                SAIL_TRY(sail_buffered_reader_strict_read(reader, rgb, sizeof(rgb)));
+                px.rgba.r = rgb[0];
+                px.rgba.g = rgb[1];
+                px.rgba.b = rgb[2];
+            } else if (b1 == QOI_OP_RGBA) {
+                unsigned char rgba[4];
+                SAIL_TRY(sail_buffered_reader_strict_read(reader, rgba, sizeof(rgba)));
+                px.rgba.r = rgba[0];
+                px.rgba.g = rgba[1];
+                px.rgba.b = rgba[2];
+                px.rgba.a = rgba[3];
+            } else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX) {
+                px = decoder->index[b1];
+            } else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF) {
+                px.rgba.r += ((b1 >> 4) & 0x03) - 2;
+                px.rgba.g += ((b1 >> 2) & 0x03) - 2;
+                px.rgba.b += ( b1       & 0x03) - 2;
+            } else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA) {
+                uint8_t b2;
+                SAIL_TRY(sail_buffered_reader_read_byte(reader, &b2));
+                const int vg = (b1 & 0x3f) - 32;
+                px.rgba.r += vg - 8 + ((b2 >> 4) & 0x0f);
+                px.rgba.g += vg;
+                px.rgba.b += vg - 8 +  (b2       & 0x0f);
+            } else {
+                run = b1 & 0x3f;
+            }
+
+            decoder->index[QOI_COLOR_HASH(px)] = px;
+        }
+
+        row[0] = px.rgba.r;
+        row[1] = px.rgba.g;
+        row[2] = px.rgba.b;
+
+        if (channels == 4) {
+            row[3] = px.rgba.a;
+        }
+    }
+
+    decoder->px  = px;
+    decoder->run = run;
+
+    return SAIL_OK;
+}
+
+void qoi_private_init_encoder(struct sail_io *io, struct qoi_private_encoder *encoder) {
+
+    memset(encoder->index, 0, sizeof(encoder->index));
+
+    encoder->px_prev.rgba.r = 0;
+    encoder->px_prev.rgba.g = 0;
+    encoder->px_prev.rgba.b = 0;
+    encoder->px_prev.rgba.a = 255;
+    encoder->run            = 0;
+
+    encoder->io          = io;
+    encoder->buffer_size = 0;
+}
+
+static sail_status_t flush_encoder(struct qoi_private_encoder *encoder) {
+
+    if (encoder->buffer_size > 0) {
+        SAIL_TRY(encoder->io->strict_write(encoder->io->stream, encoder->buffer, encoder->buffer_size));
+        encoder->buffer_size = 0;
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t qoi_private_encode_row(struct qoi_private_encoder *encoder, const unsigned char *row, unsigned width, unsigned channels) {
+
+    union qoi_private_rgba px_prev = encoder->px_prev;
+    union qoi_private_rgba px = px_prev;
+    unsigned run = encoder->run;
+
+    for (unsigned x = 0; x < width; x++, row += channels) {
+        /* The longest chunk is QOI_OP_RUN followed by QOI_OP_RGBA, 6 bytes. */
+        if (QOI_OUTPUT_BUFFER_SIZE - encoder->buffer_size < 6) {
+            SAIL_TRY(flush_encoder(encoder));
+        }
+
+        unsigned char *bytes = encoder->buffer + encoder->buffer_size;
+        unsigned p = 0;
+
+        px.rgba.r = row[0];
+        px.rgba.g = row[1];
+        px.rgba.b = row[2];
+
+        if (channels == 4) {
+            px.rgba.a = row[3];
+        }
+
+        if (px.v == px_prev.v) {
+            if (++run == 62) {
+                bytes[p++] = (unsigned char)(QOI_OP_RUN | (run - 1));
+                run = 0;
+            }
+        } else {
+            if (run > 0) {
+                bytes[p++] = (unsigned char)(QOI_OP_RUN | (run - 1));
+                run = 0;
+            }
+
+            const unsigned index_pos = QOI_COLOR_HASH(px);
+
+            if (encoder->index[index_pos].v == px.v) {
+                bytes[p++] = (unsigned char)(QOI_OP_INDEX | index_pos);
+            } else {
+                encoder->index[index_pos] = px;
+
+                if (px.rgba.a == px_prev.rgba.a) {
+                    const signed char vr = (signed char)(px.rgba.r - px_prev.rgba.r);
+                    const signed char vg = (signed char)(px.rgba.g - px_prev.rgba.g);
+                    const signed char vb = (signed char)(px.rgba.b - px_prev.rgba.b);
+
+                    const signed char vg_r = (signed char)(vr - vg);
+                    const signed char vg_b = (signed char)(vb - vg);
+
+                    if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                        bytes[p++] = (unsigned char)(QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+                    } else if (vg_r > -9 && vg_r < 8 && vg > -33 && vg < 32 && vg_b > -9 && vg_b < 8) {
+                        bytes[p++] = (unsigned char)(QOI_OP_LUMA | (vg + 32));
+                        bytes[p++] = (unsigned char)((vg_r + 8) << 4 | (vg_b + 8));
+                    } else {
+                        bytes[p++] = QOI_OP_RGB;
+                        bytes[p++] = px.rgba.r;
+                        bytes[p++] = px.rgba.g;
+                        bytes[p++] = px.rgba.b;
+                    }
+                } else {
+                    bytes[p++] = QOI_OP_RGBA;
+                    bytes[p++] = px.rgba.r;
+                    bytes[p++] = px.rgba.g;
+                    bytes[p++] = px.rgba.b;
+                    bytes[p++] = px.rgba.a;
+                }
+            }
+        }
+
+        encoder->buffer_size += p;
+        px_prev = px;
+    }
+
+    encoder->px_prev = px_prev;
+    encoder->run     = run;
+
+    return SAIL_OK;
+}
+
+sail_status_t qoi_private_finish_encoder(struct qoi_private_encoder *encoder) {
+
+    if (QOI_OUTPUT_BUFFER_SIZE - encoder->buffer_size < 1 + sizeof(QOI_PADDING)) {
+        SAIL_TRY(flush_encoder(encoder));
+    }
+
+    if (encoder->run > 0) {
+        encoder->buffer[encoder->buffer_size++] = (unsigned char)(QOI_OP_RUN | (encoder->run - 1));
+        encoder->run = 0;
+    }
+
+    memcpy(encoder->buffer + encoder->buffer_size, QOI_PADDING, sizeof(QOI_PADDING));
+    encoder->buffer_size += sizeof(QOI_PADDING);
+
+    SAIL_TRY(flush_encoder(encoder));
+
+    return SAIL_OK;
+}
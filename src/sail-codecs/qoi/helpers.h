@@ -0,0 +1,92 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_QOI_HELPERS_H
+#define SAIL_QOI_HELPERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_buffered_reader;
+struct sail_io;
+
+#define QOI_SRGB   0
+#define QOI_LINEAR 1
+
+#define QOI_HEADER_SIZE 14
+
+/* Encoded bytes are collected in a block of this size before being written. */
+#define QOI_OUTPUT_BUFFER_SIZE (64 * 1024)
+
+struct qoi_private_header {
+    uint32_t width;
+    uint32_t height;
+    uint8_t channels;
+    uint8_t colorspace;
+};
+
+union qoi_private_rgba {
+    struct { uint8_t r, g, b, a; } rgba;
+    uint32_t v;
+};
+
+/* Decoder state carried over from one row to the next. */
+struct qoi_private_decoder {
+    union qoi_private_rgba index[64];
+    union qoi_private_rgba px;
+    unsigned run;
+};
+
+/* Encoder state carried over from one row to the next. */
+struct qoi_private_encoder {
+    union qoi_private_rgba index[64];
+    union qoi_private_rgba px_prev;
+    unsigned run;
+
+    struct sail_io *io;
+    unsigned char buffer[QOI_OUTPUT_BUFFER_SIZE];
+    size_t buffer_size;
+};
+
+SAIL_HIDDEN sail_status_t qoi_private_read_header(struct sail_io *io, struct qoi_private_header *header);
+
+SAIL_HIDDEN sail_status_t qoi_private_write_header(struct sail_io *io, const struct qoi_private_header *header);
+
+SAIL_HIDDEN void qoi_private_init_decoder(struct qoi_private_decoder *decoder);
+
+SAIL_HIDDEN sail_status_t qoi_private_decode_row(struct sail_buffered_reader *reader, struct qoi_private_decoder *decoder,
+                                                 unsigned char *row, unsigned width, unsigned channels);
+
+SAIL_HIDDEN void qoi_private_init_encoder(struct sail_io *io, struct qoi_private_encoder *encoder);
+
+SAIL_HIDDEN sail_status_t qoi_private_encode_row(struct qoi_private_encoder *encoder, const unsigned char *row, unsigned width, unsigned channels);
+
+SAIL_HIDDEN sail_status_t qoi_private_finish_encoder(struct qoi_private_encoder *encoder);
+
+#endif
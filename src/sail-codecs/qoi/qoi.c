@@ -24,16 +24,12 @@
 */
 
 #include <stdbool.h>
-#include <stdio.h>
-#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include <sail-common/sail-common.h>
 
-#define QOI_MALLOC sail_malloc_std_signature
-#define QOI_FREE sail_free
-#define QOI_IMPLEMENTATION
-#define QOI_NO_STDIO
-#include "qoi.h"
+#include "helpers.h"
 
 /*
  * Codec-specific state.
@@ -45,12 +41,13 @@ struct qoi_state {
 
     bool frame_loaded;
     bool frame_saved;
+    bool header_written;
 
-    void *image_data;
-    size_t image_data_size;
-    void *pixels;
+    struct qoi_private_header header;
 
-    qoi_desc qoi_desc;
+    /* Pixels are decoded and encoded row by row, so only these small buffers are allocated. */
+    struct sail_buffered_reader reader;
+    struct qoi_private_encoder *encoder;
 };
 
 static sail_status_t alloc_qoi_state(struct sail_io *io,
@@ -67,12 +64,12 @@ static sail_status_t alloc_qoi_state(struct sail_io *io,
         .load_options = load_options,
         .save_options = save_options,
 
-        .frame_loaded = false,
-        .frame_saved  = false,
+        .frame_loaded   = false,
+        .frame_saved    = false,
+        .header_written = false,
 
-        .image_data      = NULL,
-        .image_data_size = 0,
-        .pixels          = NULL,
+        .reader  = { 0 },
+        .encoder = NULL,
     };
 
     return SAIL_OK;
@@ -84,8 +81,8 @@ static void destroy_qoi_state(struct qoi_state *qoi_state) {
         return;
     }
 
-    sail_free(qoi_state->image_data);
-    sail_free(qoi_state->pixels);
+    sail_finish_buffered_reader(&qoi_state->reader);
+    sail_free(qoi_state->encoder);
 
     sail_free(qoi_state);
 }
@@ -103,8 +100,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_qoi(struct sail_io *io, const
     SAIL_TRY(alloc_qoi_state(io, load_options, NULL, &qoi_state));
     *state = qoi_state;
 
-    /* Cache the entire file as the QOI API requires. */
-    SAIL_TRY(sail_alloc_data_from_io_contents(io, &qoi_state->image_data, &qoi_state->image_data_size));
+    SAIL_TRY(qoi_private_read_header(io, &qoi_state->header));
 
     return SAIL_OK;
 }
@@ -119,26 +115,17 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_qoi(void *state, st
 
     qoi_state->frame_loaded = true;
 
-    /* Decode the image. */
-    /* TODO Remove (int) when QOI supports size_t. */
-    qoi_state->pixels = qoi_decode(qoi_state->image_data, (int)qoi_state->image_data_size, &qoi_state->qoi_desc, 0);
-
-    if (qoi_state->pixels == NULL) {
-        SAIL_LOG_ERROR("QOI: Image is broken without any details");
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
-    }
-
-    if (qoi_state->qoi_desc.colorspace != QOI_SRGB) {
+    if (qoi_state->header.colorspace != QOI_SRGB) {
         SAIL_LOG_ERROR("QOI: Only RGB images are supported");
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
     }
 
     enum SailPixelFormat pixel_format;
-    switch (qoi_state->qoi_desc.channels) {
+    switch (qoi_state->header.channels) {
         case 3: pixel_format = SAIL_PIXEL_FORMAT_BPP24_RGB;  break;
         case 4: pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA; break;
         default: {
-            SAIL_LOG_ERROR("QOI: Number of channels is %d, but only RGB24 and RGB32 images are supported", qoi_state->qoi_desc.channels);
+            SAIL_LOG_ERROR("QOI: Number of channels is %d, but only RGB24 and RGB32 images are supported", qoi_state->header.channels);
             SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
         }
     }
@@ -155,8 +142,8 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_qoi(void *state, st
         image_local->source_image->compression  = SAIL_COMPRESSION_QOI;
     }
 
-    image_local->width          = qoi_state->qoi_desc.width;
-    image_local->height         = qoi_state->qoi_desc.height;
+    image_local->width          = qoi_state->header.width;
+    image_local->height         = qoi_state->header.height;
     image_local->pixel_format   = pixel_format;
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
@@ -167,11 +154,22 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_qoi(void *state, st
 
 SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_qoi(void *state, struct sail_image *image) {
 
-    const struct qoi_state *qoi_state = state;
+    struct qoi_state *qoi_state = state;
+
+    SAIL_TRY(sail_init_buffered_reader(qoi_state->io, 0, &qoi_state->reader));
 
-    const size_t pixels_size = (size_t)image->bytes_per_line * image->height;
+    /* Runs and the color index continue across rows. */
+    struct qoi_private_decoder decoder;
+    qoi_private_init_decoder(&decoder);
 
-    memcpy(image->pixels, qoi_state->pixels, pixels_size);
+    for (unsigned row = 0; row < image->height; row++) {
+        SAIL_TRY(qoi_private_decode_row(&qoi_state->reader, &decoder,
+                                        sail_scan_line_to_load(qoi_state->load_options, image, row),
+                                        image->width, qoi_state->header.channels));
+        SAIL_TRY(sail_scan_line_loaded(qoi_state->load_options, image, row));
+    }
+
+    SAIL_TRY(sail_finish_buffered_reader(&qoi_state->reader));
 
     return SAIL_OK;
 }
@@ -205,6 +203,12 @@ SAIL_EXPORT sail_status_t sail_codec_save_init_v8_qoi(struct sail_io *io, const
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
     }
 
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct qoi_private_encoder), &ptr));
+    qoi_state->encoder = ptr;
+
+    qoi_private_init_encoder(io, qoi_state->encoder);
+
     return SAIL_OK;
 }
 
@@ -212,6 +216,13 @@ SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_qoi(void *state, co
 
     struct qoi_state *qoi_state = state;
 
+    if (qoi_state->frame_saved) {
+        SAIL_LOG_ERROR("QOI: Only single frame is supported for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    qoi_state->frame_saved = true;
+
     unsigned char channels;
 
     switch (image->pixel_format) {
@@ -223,18 +234,15 @@ SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_qoi(void *state, co
         }
     }
 
-    int written;
-    qoi_state->pixels = qoi_encode(image->pixels, &(qoi_desc){
-    	                    .width      = image->width,
-                    	    .height     = image->height,
-                        	.channels   = channels,
-                        	.colorspace = QOI_SRGB
-                        }, &written);
-
-    if (qoi_state->pixels == NULL) {
-        SAIL_LOG_ERROR("QOI: Encoding failed without any details");
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-    }
+    qoi_state->header = (struct qoi_private_header) {
+        .width      = image->width,
+        .height     = image->height,
+        .channels   = channels,
+        .colorspace = QOI_SRGB,
+    };
+
+    SAIL_TRY(qoi_private_write_header(qoi_state->io, &qoi_state->header));
+    qoi_state->header_written = true;
 
     return SAIL_OK;
 }
@@ -243,9 +251,10 @@ SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_qoi(void *state, const struct
 
     struct qoi_state *qoi_state = state;
 
-    const size_t pixels_size = (size_t)image->bytes_per_line * image->height;
-
-    SAIL_TRY(qoi_state->io->strict_write(qoi_state->io->stream, qoi_state->pixels, pixels_size));
+    for (unsigned row = 0; row < image->height; row++) {
+        SAIL_TRY(qoi_private_encode_row(qoi_state->encoder, sail_scan_line(image, row),
+                                        image->width, qoi_state->header.channels));
+    }
 
     return SAIL_OK;
 }
@@ -257,6 +266,12 @@ SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_qoi(void **state) {
     /* Subsequent calls to finish() will expectedly fail in the above line. */
     *state = NULL;
 
+    /* Flush the pending run and write the end marker. */
+    if (qoi_state->header_written) {
+        SAIL_TRY_OR_CLEANUP(qoi_private_finish_encoder(qoi_state->encoder),
+                            /* cleanup */ destroy_qoi_state(qoi_state));
+    }
+
     destroy_qoi_state(qoi_state);
 
     return SAIL_OK;
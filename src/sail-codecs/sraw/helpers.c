@@ -0,0 +1,374 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "helpers.h"
+
+static const unsigned char SRAW_MAGIC[4] = { 'S', 'R', 'A', 'W' };
+
+static void write_le16(unsigned char *bytes, uint16_t value) {
+
+    bytes[0] = (unsigned char)value;
+    bytes[1] = (unsigned char)(value >> 8);
+}
+
+static uint16_t read_le16(const unsigned char *bytes) {
+
+    return (uint16_t)(bytes[0] | bytes[1] << 8);
+}
+
+void sraw_private_write_le32(unsigned char *bytes, uint32_t value) {
+
+    bytes[0] = (unsigned char)value;
+    bytes[1] = (unsigned char)(value >> 8);
+    bytes[2] = (unsigned char)(value >> 16);
+    bytes[3] = (unsigned char)(value >> 24);
+}
+
+uint32_t sraw_private_read_le32(const unsigned char *bytes) {
+
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+static void write_le64(unsigned char *bytes, uint64_t value) {
+
+    sraw_private_write_le32(bytes,     (uint32_t)value);
+    sraw_private_write_le32(bytes + 4, (uint32_t)(value >> 32));
+}
+
+static uint64_t read_le64(const unsigned char *bytes) {
+
+    return (uint64_t)sraw_private_read_le32(bytes) | (uint64_t)sraw_private_read_le32(bytes + 4) << 32;
+}
+
+static void write_double(unsigned char *bytes, double value) {
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    write_le64(bytes, bits);
+}
+
+static double read_double(const unsigned char *bytes) {
+
+    const uint64_t bits = read_le64(bytes);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+sail_status_t sraw_private_read_header(struct sail_io *io, struct sraw_private_header *header) {
+
+    unsigned char bytes[SRAW_HEADER_SIZE];
+    SAIL_TRY(io->strict_read(io->stream, bytes, sizeof(bytes)));
+
+    if (memcmp(bytes, SRAW_MAGIC, sizeof(SRAW_MAGIC)) != 0) {
+        SAIL_LOG_ERROR("SRAW: Invalid magic number");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    header->version = read_le16(bytes + 4);
+
+    if (header->version != SRAW_VERSION || read_le16(bytes + 6) != SRAW_HEADER_SIZE) {
+        SAIL_LOG_ERROR("SRAW: Version %u is not supported", header->version);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_FORMAT);
+    }
+
+    header->width                = sraw_private_read_le32(bytes + 8);
+    header->height               = sraw_private_read_le32(bytes + 12);
+    header->bytes_per_line       = sraw_private_read_le32(bytes + 16);
+    header->pixel_format         = sraw_private_read_le32(bytes + 20);
+    header->compression          = sraw_private_read_le32(bytes + 24);
+    header->rows_per_block       = sraw_private_read_le32(bytes + 28);
+    header->palette_pixel_format = sraw_private_read_le32(bytes + 32);
+    header->palette_color_count  = sraw_private_read_le32(bytes + 36);
+    header->iccp_size            = sraw_private_read_le32(bytes + 40);
+    header->meta_data_count      = sraw_private_read_le32(bytes + 44);
+    header->meta_data_size       = sraw_private_read_le32(bytes + 48);
+    header->resolution_unit      = sraw_private_read_le32(bytes + 52);
+    header->delay                = (int32_t)sraw_private_read_le32(bytes + 56);
+    header->flags                = sraw_private_read_le32(bytes + 60);
+    header->gamma                = read_double(bytes + 64);
+    header->resolution_x         = read_double(bytes + 72);
+    header->resolution_y         = read_double(bytes + 80);
+
+    if (header->width == 0 || header->height == 0 || header->rows_per_block == 0
+            || sail_bits_per_pixel(header->pixel_format) == 0
+            || header->bytes_per_line < sail_bytes_per_line(header->width, header->pixel_format)) {
+        SAIL_LOG_ERROR("SRAW: Image is broken");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sraw_private_write_header(struct sail_io *io, const struct sraw_private_header *header) {
+
+    unsigned char bytes[SRAW_HEADER_SIZE] = { 0 };
+
+    memcpy(bytes, SRAW_MAGIC, sizeof(SRAW_MAGIC));
+    write_le16(bytes + 4, SRAW_VERSION);
+    write_le16(bytes + 6, SRAW_HEADER_SIZE);
+
+    sraw_private_write_le32(bytes + 8,  header->width);
+    sraw_private_write_le32(bytes + 12, header->height);
+    sraw_private_write_le32(bytes + 16, header->bytes_per_line);
+    sraw_private_write_le32(bytes + 20, header->pixel_format);
+    sraw_private_write_le32(bytes + 24, header->compression);
+    sraw_private_write_le32(bytes + 28, header->rows_per_block);
+    sraw_private_write_le32(bytes + 32, header->palette_pixel_format);
+    sraw_private_write_le32(bytes + 36, header->palette_color_count);
+    sraw_private_write_le32(bytes + 40, header->iccp_size);
+    sraw_private_write_le32(bytes + 44, header->meta_data_count);
+    sraw_private_write_le32(bytes + 48, header->meta_data_size);
+    sraw_private_write_le32(bytes + 52, header->resolution_unit);
+    sraw_private_write_le32(bytes + 56, (uint32_t)header->delay);
+    sraw_private_write_le32(bytes + 60, header->flags);
+    write_double(bytes + 64, header->gamma);
+    write_double(bytes + 72, header->resolution_x);
+    write_double(bytes + 80, header->resolution_y);
+
+    SAIL_TRY(io->strict_write(io->stream, bytes, sizeof(bytes)));
+
+    return SAIL_OK;
+}
+
+/*
+ * Meta data entry: 8-bit known key flag, 32-bit key size, null-terminated key, 8-bit variant type,
+ * 32-bit value size, value. Numbers are little-endian, 'long' values are stored as 64-bit integers,
+ * strings are stored without the null character.
+ */
+static size_t variant_value_size(const struct sail_variant *variant) {
+
+    switch (variant->type) {
+        case SAIL_VARIANT_TYPE_BOOL:
+        case SAIL_VARIANT_TYPE_CHAR:
+        case SAIL_VARIANT_TYPE_UNSIGNED_CHAR:  return 1;
+        case SAIL_VARIANT_TYPE_SHORT:
+        case SAIL_VARIANT_TYPE_UNSIGNED_SHORT: return 2;
+        case SAIL_VARIANT_TYPE_INT:
+        case SAIL_VARIANT_TYPE_UNSIGNED_INT:
+        case SAIL_VARIANT_TYPE_FLOAT:          return 4;
+        case SAIL_VARIANT_TYPE_LONG:
+        case SAIL_VARIANT_TYPE_UNSIGNED_LONG:
+        case SAIL_VARIANT_TYPE_DOUBLE:         return 8;
+        case SAIL_VARIANT_TYPE_STRING:         return strlen(sail_variant_to_string(variant));
+        case SAIL_VARIANT_TYPE_DATA:           return variant->size;
+        default:                               return 0;
+    }
+}
+
+static const char* meta_data_key(const struct sail_meta_data *meta_data) {
+
+    return (meta_data->key == SAIL_META_DATA_UNKNOWN) ? meta_data->key_unknown : sail_meta_data_to_string(meta_data->key);
+}
+
+static bool is_serializable(const struct sail_meta_data *meta_data) {
+
+    return meta_data_key(meta_data) != NULL && meta_data->value != NULL && sail_check_variant_valid(meta_data->value) == SAIL_OK;
+}
+
+sail_status_t sraw_private_meta_data_size(const struct sail_meta_data_node *meta_data_node, uint32_t *count, uint32_t *size) {
+
+    uint64_t size_local = 0;
+    uint32_t count_local = 0;
+
+    for (; meta_data_node != NULL; meta_data_node = meta_data_node->next) {
+        const struct sail_meta_data *meta_data = meta_data_node->meta_data;
+
+        if (!is_serializable(meta_data)) {
+            SAIL_LOG_WARNING("SRAW: Skipping invalid meta data entry");
+            continue;
+        }
+
+        size_local += 1 + 4 + strlen(meta_data_key(meta_data)) + 1 + 1 + 4 + variant_value_size(meta_data->value);
+        count_local++;
+    }
+
+    if (size_local > UINT32_MAX) {
+        SAIL_LOG_ERROR("SRAW: Meta data is too large");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    *count = count_local;
+    *size  = (uint32_t)size_local;
+
+    return SAIL_OK;
+}
+
+void sraw_private_serialize_meta_data(const struct sail_meta_data_node *meta_data_node, unsigned char *buffer) {
+
+    for (; meta_data_node != NULL; meta_data_node = meta_data_node->next) {
+        const struct sail_meta_data *meta_data = meta_data_node->meta_data;
+
+        if (!is_serializable(meta_data)) {
+            continue;
+        }
+
+        const struct sail_variant *variant = meta_data->value;
+        const char *key = meta_data_key(meta_data);
+        const size_t key_size = strlen(key) + 1;
+        const size_t value_size = variant_value_size(variant);
+
+        *buffer++ = (meta_data->key == SAIL_META_DATA_UNKNOWN) ? 0 : 1;
+        sraw_private_write_le32(buffer, (uint32_t)key_size);
+        buffer += 4;
+        memcpy(buffer, key, key_size);
+        buffer += key_size;
+        *buffer++ = (unsigned char)variant->type;
+        sraw_private_write_le32(buffer, (uint32_t)value_size);
+        buffer += 4;
+
+        switch (variant->type) {
+            case SAIL_VARIANT_TYPE_BOOL:           *buffer = sail_variant_to_bool(variant) ? 1 : 0;                 break;
+            case SAIL_VARIANT_TYPE_CHAR:           *buffer = (unsigned char)sail_variant_to_char(variant);          break;
+            case SAIL_VARIANT_TYPE_UNSIGNED_CHAR:  *buffer = sail_variant_to_unsigned_char(variant);                break;
+            case SAIL_VARIANT_TYPE_SHORT:          write_le16(buffer, (uint16_t)sail_variant_to_short(variant));    break;
+            case SAIL_VARIANT_TYPE_UNSIGNED_SHORT: write_le16(buffer, sail_variant_to_unsigned_short(variant));     break;
+            case SAIL_VARIANT_TYPE_INT:            sraw_private_write_le32(buffer, (uint32_t)sail_variant_to_int(variant)); break;
+            case SAIL_VARIANT_TYPE_UNSIGNED_INT:   sraw_private_write_le32(buffer, sail_variant_to_unsigned_int(variant));  break;
+            case SAIL_VARIANT_TYPE_LONG:           write_le64(buffer, (uint64_t)(int64_t)sail_variant_to_long(variant)); break;
+            case SAIL_VARIANT_TYPE_UNSIGNED_LONG:  write_le64(buffer, (uint64_t)sail_variant_to_unsigned_long(variant)); break;
+            case SAIL_VARIANT_TYPE_FLOAT: {
+                const float value = sail_variant_to_float(variant);
+                uint32_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                sraw_private_write_le32(buffer, bits);
+                break;
+            }
+            case SAIL_VARIANT_TYPE_DOUBLE: write_double(buffer, sail_variant_to_double(variant)); break;
+            default: memcpy(buffer, variant->value, value_size); break;
+        }
+
+        buffer += value_size;
+    }
+}
+
+static sail_status_t deserialize_variant(enum SailVariantType type, const unsigned char *bytes, size_t size, struct sail_variant *variant) {
+
+    switch (type) {
+        case SAIL_VARIANT_TYPE_STRING: SAIL_TRY(sail_set_variant_substring(variant, (const char *)bytes, size)); return SAIL_OK;
+        case SAIL_VARIANT_TYPE_DATA:   SAIL_TRY(sail_set_variant_data(variant, bytes, size));                    return SAIL_OK;
+        default: break;
+    }
+
+    struct sail_variant probe = { .type = type, .value = NULL, .size = 0 };
+
+    if (type >= SAIL_VARIANT_TYPE_INVALID || size != variant_value_size(&probe)) {
+        SAIL_LOG_ERROR("SRAW: Meta data entry is broken");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    switch (type) {
+        case SAIL_VARIANT_TYPE_BOOL:           SAIL_TRY(sail_set_variant_bool(variant, bytes[0] != 0));                       break;
+        case SAIL_VARIANT_TYPE_CHAR:           SAIL_TRY(sail_set_variant_char(variant, (char)bytes[0]));                      break;
+        case SAIL_VARIANT_TYPE_UNSIGNED_CHAR:  SAIL_TRY(sail_set_variant_unsigned_char(variant, bytes[0]));                   break;
+        case SAIL_VARIANT_TYPE_SHORT:          SAIL_TRY(sail_set_variant_short(variant, (short)read_le16(bytes)));            break;
+        case SAIL_VARIANT_TYPE_UNSIGNED_SHORT: SAIL_TRY(sail_set_variant_unsigned_short(variant, read_le16(bytes)));          break;
+        case SAIL_VARIANT_TYPE_INT:            SAIL_TRY(sail_set_variant_int(variant, (int)sraw_private_read_le32(bytes)));   break;
+        case SAIL_VARIANT_TYPE_UNSIGNED_INT:   SAIL_TRY(sail_set_variant_unsigned_int(variant, sraw_private_read_le32(bytes))); break;
+        case SAIL_VARIANT_TYPE_LONG:           SAIL_TRY(sail_set_variant_long(variant, (long)(int64_t)read_le64(bytes)));     break;
+        case SAIL_VARIANT_TYPE_UNSIGNED_LONG:  SAIL_TRY(sail_set_variant_unsigned_long(variant, (unsigned long)read_le64(bytes))); break;
+        case SAIL_VARIANT_TYPE_FLOAT: {
+            const uint32_t bits = sraw_private_read_le32(bytes);
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            SAIL_TRY(sail_set_variant_float(variant, value));
+            break;
+        }
+        default: SAIL_TRY(sail_set_variant_double(variant, read_double(bytes))); break;
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sraw_private_deserialize_meta_data(const unsigned char *buffer, size_t size, uint32_t count,
+                                                 const struct sail_load_options *load_options,
+                                                 struct sail_meta_data_node **meta_data_node) {
+
+    struct sail_meta_data_node **last_meta_data_node = meta_data_node;
+    const unsigned char *end = buffer + size;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if ((size_t)(end - buffer) < 1 + 4) {
+            SAIL_LOG_ERROR("SRAW: Meta data is truncated");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        const bool known = buffer[0] != 0;
+        const uint32_t key_size = sraw_private_read_le32(buffer + 1);
+        buffer += 1 + 4;
+
+        if (key_size == 0 || (size_t)(end - buffer) < (size_t)key_size + 1 + 4 || buffer[key_size - 1] != '\0') {
+            SAIL_LOG_ERROR("SRAW: Meta data is truncated");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        const char *key = (const char *)buffer;
+        buffer += key_size;
+
+        const enum SailVariantType type = (enum SailVariantType)buffer[0];
+        const uint32_t value_size = sraw_private_read_le32(buffer + 1);
+        buffer += 1 + 4;
+
+        if ((size_t)(end - buffer) < value_size) {
+            SAIL_LOG_ERROR("SRAW: Meta data is truncated");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        const enum SailMetaData meta_data_key = known ? sail_meta_data_from_string(key) : SAIL_META_DATA_UNKNOWN;
+
+        if (!sail_load_meta_data_key(load_options, meta_data_key)) {
+            buffer += value_size;
+            continue;
+        }
+
+        struct sail_meta_data_node *meta_data_node_local;
+        SAIL_TRY(sail_alloc_meta_data_node(&meta_data_node_local));
+
+        if (meta_data_key == SAIL_META_DATA_UNKNOWN) {
+            SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_and_value_from_unknown_key(key, &meta_data_node_local->meta_data),
+                                /* cleanup */ sail_destroy_meta_data_node(meta_data_node_local));
+        } else {
+            SAIL_TRY_OR_CLEANUP(sail_alloc_meta_data_and_value_from_known_key(meta_data_key, &meta_data_node_local->meta_data),
+                                /* cleanup */ sail_destroy_meta_data_node(meta_data_node_local));
+        }
+
+        SAIL_TRY_OR_CLEANUP(deserialize_variant(type, buffer, value_size, meta_data_node_local->meta_data->value),
+                            /* cleanup */ sail_destroy_meta_data_node(meta_data_node_local));
+        buffer += value_size;
+
+        *last_meta_data_node = meta_data_node_local;
+        last_meta_data_node = &meta_data_node_local->next;
+    }
+
+    return SAIL_OK;
+}
@@ -0,0 +1,104 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_SRAW_HELPERS_H
+#define SAIL_SRAW_HELPERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_io;
+struct sail_load_options;
+struct sail_meta_data_node;
+
+#define SRAW_VERSION 1
+
+/* The header has a fixed size, all the numbers are little-endian. */
+#define SRAW_HEADER_SIZE 96
+
+/* Payload compressions stored in the header. */
+enum SailSrawCompression {
+    SAIL_SRAW_COMPRESSION_NONE = 0,
+    SAIL_SRAW_COMPRESSION_ZSTD = 1,
+};
+
+/* Header flags. */
+enum SailSrawFlag {
+    SAIL_SRAW_FLAG_RESOLUTION = 1 << 0,
+};
+
+/*
+ * File layout: header, palette, ICC profile, meta data, pixels. Uncompressed pixels are stored
+ * as is with the header stride. Compressed pixels are stored in blocks of 'rows_per_block' rows,
+ * every block is prefixed with its 32-bit compressed size.
+ */
+struct sraw_private_header {
+    uint16_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t bytes_per_line;
+    uint32_t pixel_format;
+    uint32_t compression;
+    uint32_t rows_per_block;
+    uint32_t palette_pixel_format;
+    uint32_t palette_color_count;
+    uint32_t iccp_size;
+    uint32_t meta_data_count;
+    uint32_t meta_data_size;
+    uint32_t resolution_unit;
+    int32_t  delay;
+    uint32_t flags;
+    double   gamma;
+    double   resolution_x;
+    double   resolution_y;
+};
+
+SAIL_HIDDEN sail_status_t sraw_private_read_header(struct sail_io *io, struct sraw_private_header *header);
+
+SAIL_HIDDEN sail_status_t sraw_private_write_header(struct sail_io *io, const struct sraw_private_header *header);
+
+SAIL_HIDDEN void sraw_private_write_le32(unsigned char *bytes, uint32_t value);
+
+SAIL_HIDDEN uint32_t sraw_private_read_le32(const unsigned char *bytes);
+
+/*
+ * Computes the number of entries and the size of the serialized meta data chain.
+ * Entries with invalid values are skipped.
+ */
+SAIL_HIDDEN sail_status_t sraw_private_meta_data_size(const struct sail_meta_data_node *meta_data_node, uint32_t *count, uint32_t *size);
+
+/* Serializes the meta data chain into the buffer of the size computed by sraw_private_meta_data_size(). */
+SAIL_HIDDEN void sraw_private_serialize_meta_data(const struct sail_meta_data_node *meta_data_node, unsigned char *buffer);
+
+/* Deserializes the meta data keys selected in the load options. */
+SAIL_HIDDEN sail_status_t sraw_private_deserialize_meta_data(const unsigned char *buffer, size_t size, uint32_t count,
+                                                             const struct sail_load_options *load_options,
+                                                             struct sail_meta_data_node **meta_data_node);
+
+#endif
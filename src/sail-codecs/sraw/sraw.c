@@ -0,0 +1,575 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef SAIL_HAVE_ZSTD
+    #include <zstd.h>
+#endif
+
+#include <sail-common/sail-common.h>
+
+#include "helpers.h"
+
+/* Compressed pixels are split into blocks of about this size. */
+static const size_t SRAW_BLOCK_SIZE = 1024 * 1024;
+
+#ifdef SAIL_HAVE_ZSTD
+/* Fast levels keep saving close to the speed of copying. */
+static const int ZSTD_LEVEL_MIN     = 1;
+static const int ZSTD_LEVEL_MAX     = 19;
+static const int ZSTD_LEVEL_DEFAULT = 1;
+#endif
+
+/*
+ * Codec-specific state.
+ */
+struct sraw_state {
+    struct sail_io *io;
+    const struct sail_load_options *load_options;
+    const struct sail_save_options *save_options;
+
+    bool frame_loaded;
+    bool frame_saved;
+
+    struct sraw_private_header header;
+
+#ifdef SAIL_HAVE_ZSTD
+    ZSTD_CCtx *cctx;
+    ZSTD_DCtx *dctx;
+    int zstd_level;
+#endif
+    void *block;
+    size_t block_capacity;
+};
+
+static sail_status_t alloc_sraw_state(struct sail_io *io,
+                                        const struct sail_load_options *load_options,
+                                        const struct sail_save_options *save_options,
+                                        struct sraw_state **sraw_state) {
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sraw_state), &ptr));
+    *sraw_state = ptr;
+
+    **sraw_state = (struct sraw_state) {
+        .io           = io,
+        .load_options = load_options,
+        .save_options = save_options,
+
+        .frame_loaded = false,
+        .frame_saved  = false,
+
+#ifdef SAIL_HAVE_ZSTD
+        .cctx       = NULL,
+        .dctx       = NULL,
+        .zstd_level = ZSTD_LEVEL_DEFAULT,
+#endif
+        .block          = NULL,
+        .block_capacity = 0,
+    };
+
+    return SAIL_OK;
+}
+
+static void destroy_sraw_state(struct sraw_state *sraw_state) {
+
+    if (sraw_state == NULL) {
+        return;
+    }
+
+#ifdef SAIL_HAVE_ZSTD
+    ZSTD_freeCCtx(sraw_state->cctx);
+    ZSTD_freeDCtx(sraw_state->dctx);
+#endif
+    sail_free(sraw_state->block);
+
+    sail_free(sraw_state);
+}
+
+static sail_status_t skip_bytes(struct sail_io *io, uint32_t size) {
+
+    if (size > 0) {
+        SAIL_TRY(io->seek(io->stream, (long)size, SEEK_CUR));
+    }
+
+    return SAIL_OK;
+}
+
+static unsigned rows_per_block(unsigned bytes_per_line) {
+
+    const size_t rows = SRAW_BLOCK_SIZE / bytes_per_line;
+
+    return (rows == 0) ? 1 : (rows > UINT32_MAX ? UINT32_MAX : (unsigned)rows);
+}
+
+#ifdef SAIL_HAVE_ZSTD
+static bool tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    int *zstd_level = user_data;
+
+    if (strcmp(key, "sraw-zstd-level") == 0) {
+        int level = -1;
+
+        if (value->type == SAIL_VARIANT_TYPE_INT) {
+            level = sail_variant_to_int(value);
+        } else if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            level = (int)sail_variant_to_unsigned_int(value);
+        }
+
+        if (level >= ZSTD_LEVEL_MIN && level <= ZSTD_LEVEL_MAX) {
+            SAIL_LOG_TRACE("SRAW: Compressing with ZSTD level %d", level);
+            *zstd_level = level;
+        } else {
+            SAIL_LOG_WARNING("SRAW: 'sraw-zstd-level' must be in the range [%d, %d]", ZSTD_LEVEL_MIN, ZSTD_LEVEL_MAX);
+        }
+    }
+
+    return true;
+}
+
+static sail_status_t decompress_block(ZSTD_DCtx *dctx, const void *src, size_t src_size, void *dst, size_t dst_size) {
+
+    const size_t result = ZSTD_decompressDCtx(dctx, dst, dst_size, src, src_size);
+
+    if (ZSTD_isError(result)) {
+        SAIL_LOG_ERROR("SRAW: %s", ZSTD_getErrorName(result));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    if (result != dst_size) {
+        SAIL_LOG_ERROR("SRAW: Block is truncated");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t load_zstd_pixels(struct sraw_state *sraw_state, struct sail_image *image) {
+
+    struct sail_io *io = sraw_state->io;
+    const size_t block_size = (size_t)sraw_state->header.rows_per_block * image->bytes_per_line;
+
+    sraw_state->dctx = ZSTD_createDCtx();
+
+    if (sraw_state->dctx == NULL) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    /* Decompress mapped data in place. */
+    const unsigned char *mapped = NULL;
+    size_t mapped_size = 0;
+
+    if ((io->features & SAIL_IO_FEATURE_MAPPED) && io->map != NULL) {
+        const void *data;
+
+        if (io->map(io->stream, &data, &mapped_size) == SAIL_OK) {
+            mapped = data;
+        }
+    }
+
+    if (mapped == NULL) {
+        sraw_state->block_capacity = ZSTD_compressBound(block_size);
+        SAIL_TRY(sail_malloc(sraw_state->block_capacity, &sraw_state->block));
+    }
+
+    size_t offset = 0;
+
+    for (unsigned row = 0; row < image->height; row += sraw_state->header.rows_per_block) {
+        const unsigned rows = (image->height - row < sraw_state->header.rows_per_block)
+                                ? image->height - row
+                                : sraw_state->header.rows_per_block;
+        unsigned char *dst = sail_scan_line(image, row);
+        const size_t dst_size = (size_t)rows * image->bytes_per_line;
+
+        if (mapped != NULL) {
+            if (mapped_size - offset < 4) {
+                SAIL_LOG_ERROR("SRAW: Block is truncated");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+            }
+
+            const uint32_t compressed_size = sraw_private_read_le32(mapped + offset);
+            offset += 4;
+
+            if (mapped_size - offset < compressed_size) {
+                SAIL_LOG_ERROR("SRAW: Block is truncated");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+            }
+
+            SAIL_TRY(decompress_block(sraw_state->dctx, mapped + offset, compressed_size, dst, dst_size));
+            offset += compressed_size;
+        } else {
+            unsigned char size_bytes[4];
+            SAIL_TRY(io->strict_read(io->stream, size_bytes, sizeof(size_bytes)));
+            const uint32_t compressed_size = sraw_private_read_le32(size_bytes);
+
+            if (compressed_size > sraw_state->block_capacity) {
+                SAIL_LOG_ERROR("SRAW: Block size %u is out of range", compressed_size);
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+            }
+
+            SAIL_TRY(io->strict_read(io->stream, sraw_state->block, compressed_size));
+            SAIL_TRY(decompress_block(sraw_state->dctx, sraw_state->block, compressed_size, dst, dst_size));
+        }
+    }
+
+    if (mapped != NULL) {
+        SAIL_TRY(io->seek(io->stream, (long)offset, SEEK_CUR));
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t save_zstd_pixels(struct sraw_state *sraw_state, const struct sail_image *image) {
+
+    struct sail_io *io = sraw_state->io;
+    const size_t block_size = (size_t)sraw_state->header.rows_per_block * image->bytes_per_line;
+
+    sraw_state->cctx = ZSTD_createCCtx();
+
+    if (sraw_state->cctx == NULL) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    /* Leave room for the block size in front of the compressed data. */
+    sraw_state->block_capacity = 4 + ZSTD_compressBound(block_size);
+    SAIL_TRY(sail_malloc(sraw_state->block_capacity, &sraw_state->block));
+
+    unsigned char *block = sraw_state->block;
+
+    for (unsigned row = 0; row < image->height; row += sraw_state->header.rows_per_block) {
+        const unsigned rows = (image->height - row < sraw_state->header.rows_per_block)
+                                ? image->height - row
+                                : sraw_state->header.rows_per_block;
+
+        const size_t compressed_size = ZSTD_compressCCtx(sraw_state->cctx, block + 4, sraw_state->block_capacity - 4,
+                                                         sail_scan_line(image, row), (size_t)rows * image->bytes_per_line,
+                                                         sraw_state->zstd_level);
+
+        if (ZSTD_isError(compressed_size)) {
+            SAIL_LOG_ERROR("SRAW: %s", ZSTD_getErrorName(compressed_size));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        sraw_private_write_le32(block, (uint32_t)compressed_size);
+        SAIL_TRY(io->strict_write(io->stream, block, 4 + compressed_size));
+    }
+
+    return SAIL_OK;
+}
+#endif
+
+/*
+ * Decoding functions.
+ */
+
+SAIL_EXPORT sail_status_t sail_codec_load_init_v8_sraw(struct sail_io *io, const struct sail_load_options *load_options, void **state) {
+
+    *state = NULL;
+
+    /* Allocate a new state. */
+    struct sraw_state *sraw_state;
+    SAIL_TRY(alloc_sraw_state(io, load_options, NULL, &sraw_state));
+    *state = sraw_state;
+
+    SAIL_TRY(sraw_private_read_header(io, &sraw_state->header));
+
+    switch (sraw_state->header.compression) {
+        case SAIL_SRAW_COMPRESSION_NONE: break;
+#ifdef SAIL_HAVE_ZSTD
+        case SAIL_SRAW_COMPRESSION_ZSTD: break;
+#endif
+        default: {
+            SAIL_LOG_ERROR("SRAW: Compression %u is not supported", sraw_state->header.compression);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_sraw(void *state, struct sail_image **image) {
+
+    struct sraw_state *sraw_state = state;
+    const struct sraw_private_header *header = &sraw_state->header;
+
+    if (sraw_state->frame_loaded) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    sraw_state->frame_loaded = true;
+
+    /* Construct the SAIL image. */
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    if (sraw_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&image_local->source_image),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        image_local->source_image->pixel_format = header->pixel_format;
+        image_local->source_image->compression  = (header->compression == SAIL_SRAW_COMPRESSION_ZSTD)
+                                                    ? SAIL_COMPRESSION_ZSTD
+                                                    : SAIL_COMPRESSION_NONE;
+    }
+
+    image_local->width          = header->width;
+    image_local->height         = header->height;
+    image_local->bytes_per_line = header->bytes_per_line;
+    image_local->pixel_format   = header->pixel_format;
+    image_local->gamma          = header->gamma;
+    image_local->delay          = header->delay;
+
+    if (header->flags & SAIL_SRAW_FLAG_RESOLUTION) {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_resolution_from_data(header->resolution_unit, header->resolution_x, header->resolution_y,
+                                                            &image_local->resolution),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    /* Probing needs the header only. */
+    if (sraw_state->load_options->options & SAIL_OPTION_PROBE) {
+        *image = image_local;
+        return SAIL_OK;
+    }
+
+    /* Palette. */
+    if (header->palette_color_count > 0) {
+        if (sail_bits_per_pixel(header->palette_pixel_format) == 0) {
+            SAIL_LOG_ERROR("SRAW: Palette pixel format is invalid");
+            sail_destroy_image(image_local);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        SAIL_TRY_OR_CLEANUP(sail_alloc_palette_for_data(header->palette_pixel_format, header->palette_color_count, &image_local->palette),
+                            /* cleanup */ sail_destroy_image(image_local));
+        SAIL_TRY_OR_CLEANUP(sraw_state->io->strict_read(sraw_state->io->stream, image_local->palette->data,
+                                                        sail_bytes_per_line(header->palette_color_count, header->palette_pixel_format)),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    /* ICC profile. */
+    if (header->iccp_size > 0 && (sraw_state->load_options->options & SAIL_OPTION_ICCP)) {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_iccp_for_data(header->iccp_size, &image_local->iccp),
+                            /* cleanup */ sail_destroy_image(image_local));
+        SAIL_TRY_OR_CLEANUP(sraw_state->io->strict_read(sraw_state->io->stream, image_local->iccp->data, header->iccp_size),
+                            /* cleanup */ sail_destroy_image(image_local));
+    } else {
+        SAIL_TRY_OR_CLEANUP(skip_bytes(sraw_state->io, header->iccp_size),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    /* Meta data. */
+    if (header->meta_data_count > 0 && (sraw_state->load_options->options & SAIL_OPTION_META_DATA)) {
+        void *meta_data;
+        SAIL_TRY_OR_CLEANUP(sail_malloc(header->meta_data_size, &meta_data),
+                            /* cleanup */ sail_destroy_image(image_local));
+        SAIL_TRY_OR_CLEANUP(sraw_state->io->strict_read(sraw_state->io->stream, meta_data, header->meta_data_size),
+                            /* cleanup */ sail_free(meta_data),
+                                          sail_destroy_image(image_local));
+        SAIL_TRY_OR_CLEANUP(sraw_private_deserialize_meta_data(meta_data, header->meta_data_size, header->meta_data_count,
+                                                               sraw_state->load_options, &image_local->meta_data_node),
+                            /* cleanup */ sail_free(meta_data),
+                                          sail_destroy_image(image_local));
+        sail_free(meta_data);
+    } else {
+        SAIL_TRY_OR_CLEANUP(skip_bytes(sraw_state->io, header->meta_data_size),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_sraw(void *state, struct sail_image *image) {
+
+    struct sraw_state *sraw_state = state;
+
+#ifdef SAIL_HAVE_ZSTD
+    if (sraw_state->header.compression == SAIL_SRAW_COMPRESSION_ZSTD) {
+        SAIL_TRY(load_zstd_pixels(sraw_state, image));
+        return SAIL_OK;
+    }
+#endif
+
+    /* Uncompressed pixels are stored with the same stride, so read them in one go. */
+    SAIL_TRY(sraw_state->io->strict_read(sraw_state->io->stream, image->pixels, (size_t)image->bytes_per_line * image->height));
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_sraw(void **state) {
+
+    struct sraw_state *sraw_state = *state;
+
+    *state = NULL;
+
+    destroy_sraw_state(sraw_state);
+
+    return SAIL_OK;
+}
+
+/*
+ * Encoding functions.
+ */
+
+SAIL_EXPORT sail_status_t sail_codec_save_init_v8_sraw(struct sail_io *io, const struct sail_save_options *save_options, void **state) {
+
+    *state = NULL;
+
+    struct sraw_state *sraw_state;
+    SAIL_TRY(alloc_sraw_state(io, NULL, save_options, &sraw_state));
+    *state = sraw_state;
+
+    /* Sanity check. */
+    switch (sraw_state->save_options->compression) {
+        case SAIL_COMPRESSION_NONE: sraw_state->header.compression = SAIL_SRAW_COMPRESSION_NONE; break;
+#ifdef SAIL_HAVE_ZSTD
+        case SAIL_COMPRESSION_ZSTD: sraw_state->header.compression = SAIL_SRAW_COMPRESSION_ZSTD; break;
+#endif
+        default: {
+            SAIL_LOG_ERROR("SRAW: %s compression is not supported for saving", sail_compression_to_string(sraw_state->save_options->compression));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+        }
+    }
+
+#ifdef SAIL_HAVE_ZSTD
+    /* Handle tuning. */
+    if (sraw_state->save_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(sraw_state->save_options->tuning, tuning_key_value_callback, &sraw_state->zstd_level);
+    }
+#endif
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_sraw(void *state, const struct sail_image *image) {
+
+    struct sraw_state *sraw_state = state;
+    struct sail_io *io = sraw_state->io;
+
+    if (sraw_state->frame_saved) {
+        SAIL_LOG_ERROR("SRAW: Only single frame is supported for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    sraw_state->frame_saved = true;
+
+    if (sail_bits_per_pixel(image->pixel_format) == 0) {
+        SAIL_LOG_ERROR("SRAW: %s pixel format is not currently supported for saving", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    const bool save_iccp      = (sraw_state->save_options->options & SAIL_OPTION_ICCP) && image->iccp != NULL;
+    const bool save_meta_data = sraw_state->save_options->options & SAIL_OPTION_META_DATA;
+
+    struct sraw_private_header *header = &sraw_state->header;
+
+    header->width                = image->width;
+    header->height               = image->height;
+    header->bytes_per_line       = image->bytes_per_line;
+    header->pixel_format         = image->pixel_format;
+    header->rows_per_block       = (header->compression == SAIL_SRAW_COMPRESSION_NONE) ? image->height : rows_per_block(image->bytes_per_line);
+    header->palette_pixel_format = (image->palette != NULL) ? image->palette->pixel_format : SAIL_PIXEL_FORMAT_UNKNOWN;
+    header->palette_color_count  = (image->palette != NULL) ? image->palette->color_count : 0;
+    header->iccp_size            = save_iccp ? (uint32_t)image->iccp->size : 0;
+    header->meta_data_count      = 0;
+    header->meta_data_size       = 0;
+    header->delay                = image->delay;
+    header->gamma                = image->gamma;
+    header->flags                = 0;
+
+    if (image->resolution != NULL) {
+        header->resolution_unit = image->resolution->unit;
+        header->resolution_x    = image->resolution->x;
+        header->resolution_y    = image->resolution->y;
+        header->flags          |= SAIL_SRAW_FLAG_RESOLUTION;
+    }
+
+    if (save_iccp && image->iccp->size > UINT32_MAX) {
+        SAIL_LOG_ERROR("SRAW: ICC profile is too large");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (save_meta_data) {
+        SAIL_TRY(sraw_private_meta_data_size(image->meta_data_node, &header->meta_data_count, &header->meta_data_size));
+    }
+
+    SAIL_TRY(sraw_private_write_header(io, header));
+
+    if (header->palette_color_count > 0) {
+        SAIL_TRY(io->strict_write(io->stream, image->palette->data,
+                                  sail_bytes_per_line(header->palette_color_count, header->palette_pixel_format)));
+    }
+
+    if (save_iccp) {
+        SAIL_TRY(io->strict_write(io->stream, image->iccp->data, image->iccp->size));
+    }
+
+    if (header->meta_data_size > 0) {
+        void *meta_data;
+        SAIL_TRY(sail_malloc(header->meta_data_size, &meta_data));
+
+        sraw_private_serialize_meta_data(image->meta_data_node, meta_data);
+
+        SAIL_TRY_OR_CLEANUP(io->strict_write(io->stream, meta_data, header->meta_data_size),
+                            /* cleanup */ sail_free(meta_data));
+        sail_free(meta_data);
+    }
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_sraw(void *state, const struct sail_image *image) {
+
+    struct sraw_state *sraw_state = state;
+
+#ifdef SAIL_HAVE_ZSTD
+    if (sraw_state->header.compression == SAIL_SRAW_COMPRESSION_ZSTD) {
+        SAIL_TRY(save_zstd_pixels(sraw_state, image));
+        return SAIL_OK;
+    }
+#endif
+
+    SAIL_TRY(sraw_state->io->strict_write(sraw_state->io->stream, image->pixels, (size_t)image->bytes_per_line * image->height));
+
+    return SAIL_OK;
+}
+
+SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_sraw(void **state) {
+
+    struct sraw_state *sraw_state = *state;
+
+    /* Subsequent calls to finish() will expectedly fail in the above line. */
+    *state = NULL;
+
+    destroy_sraw_state(sraw_state);
+
+    return SAIL_OK;
+}
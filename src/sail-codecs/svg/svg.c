@@ -25,6 +25,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 
 #ifdef SAIL_RESVG
@@ -38,6 +39,21 @@
 
 #include <sail-common/sail-common.h>
 
+/* Maximum number of renditions in "svg-sizes". */
+#define SVG_MAX_SIZES 32
+
+/* Requested output size. 0 means unset. */
+struct svg_tuning {
+    unsigned width;
+    unsigned height;
+    float scale;
+    unsigned threads;
+
+    /* Square boxes to render the image into, one frame per box. */
+    unsigned sizes[SVG_MAX_SIZES];
+    unsigned sizes_count;
+};
+
 /*
  * Codec-specific state.
  */
@@ -45,14 +61,21 @@ struct svg_state {
     const struct sail_load_options *load_options;
     const struct sail_save_options *save_options;
 
-    bool frame_loaded;
+    /* Every frame is a rendition of the same parsed image. */
+    unsigned frames_loaded;
+    struct svg_tuning tuning;
+    float intrinsic_width;
+    float intrinsic_height;
+
+    /* Rendering scale of the current frame and the number of threads to render row bands in. */
+    float scale;
+    unsigned threads;
 
 #ifdef SAIL_RESVG
     resvg_options *resvg_options;
     resvg_render_tree *resvg_tree;
 #else
     NSVGimage *nsvg_image;
-    NSVGrasterizer *nsvg_rasterizer;
 #endif
 };
 
@@ -68,14 +91,19 @@ static sail_status_t alloc_svg_state(const struct sail_load_options *load_option
         .load_options = load_options,
         .save_options = save_options,
 
-        .frame_loaded  = false,
+        .frames_loaded    = 0,
+        .tuning           = { .width = 0, .height = 0, .scale = 0, .threads = 1, .sizes_count = 0 },
+        .intrinsic_width  = 0,
+        .intrinsic_height = 0,
+
+        .scale   = 1,
+        .threads = 1,
 
 #ifdef SAIL_RESVG
         .resvg_options = NULL,
         .resvg_tree    = NULL,
 #else
         .nsvg_image      = NULL,
-        .nsvg_rasterizer = NULL,
 #endif
     };
 
@@ -96,13 +124,176 @@ static void destroy_svg_state(struct svg_state *svg_state) {
         resvg_tree_destroy(svg_state->resvg_tree);
     }
 #else
-    nsvgDeleteRasterizer(svg_state->nsvg_rasterizer);
     nsvgDelete(svg_state->nsvg_image);
 #endif
 
     sail_free(svg_state);
 }
 
+static bool unsigned_int_tuning(const char *key, const struct sail_variant *value, unsigned *result) {
+
+    if (value->type != SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+        SAIL_LOG_WARNING("SVG: '%s' must be an unsigned integer", key);
+        return false;
+    }
+
+    *result = sail_variant_to_unsigned_int(value);
+
+    return true;
+}
+
+static bool svg_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    struct svg_tuning *tuning = user_data;
+
+    if (strcmp(key, "svg-width") == 0) {
+        unsigned_int_tuning(key, value, &tuning->width);
+    } else if (strcmp(key, "svg-height") == 0) {
+        unsigned_int_tuning(key, value, &tuning->height);
+    } else if (strcmp(key, "svg-threads") == 0) {
+        unsigned threads;
+
+        if (unsigned_int_tuning(key, value, &threads) && threads > 0) {
+            tuning->threads = threads;
+        }
+    } else if (strcmp(key, "svg-sizes") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_STRING) {
+            const char *str = sail_variant_to_string(value);
+            char *end;
+
+            tuning->sizes_count = 0;
+
+            for (unsigned long size = strtoul(str, &end, 10); end != str; size = strtoul(str, &end, 10)) {
+                if (size == 0 || tuning->sizes_count == SVG_MAX_SIZES) {
+                    SAIL_LOG_WARNING("SVG: 'svg-sizes' must have at most %u sizes greater than 0", SVG_MAX_SIZES);
+                    break;
+                }
+
+                tuning->sizes[tuning->sizes_count++] = (unsigned)size;
+
+                str = (*end == ';' || *end == ',') ? end + 1 : end;
+            }
+        } else {
+            SAIL_LOG_WARNING("SVG: 'svg-sizes' must be a string");
+        }
+    } else if (strcmp(key, "svg-scale") == 0) {
+        float scale = 0;
+
+        if (value->type == SAIL_VARIANT_TYPE_FLOAT) {
+            scale = sail_variant_to_float(value);
+        } else if (value->type == SAIL_VARIANT_TYPE_DOUBLE) {
+            scale = (float)sail_variant_to_double(value);
+        }
+
+        if (scale > 0) {
+            tuning->scale = scale;
+        } else {
+            SAIL_LOG_WARNING("SVG: 'svg-scale' must be a positive float or double");
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Computes the scale to render the image of the intrinsic size at. The requested width and height
+ * fit the image into the box keeping the aspect ratio, and take precedence over the requested scale.
+ */
+static float compute_scale(const struct svg_tuning *tuning, float intrinsic_width, float intrinsic_height) {
+
+    if (intrinsic_width <= 0 || intrinsic_height <= 0) {
+        return 1;
+    }
+
+    const float scale_x = (float)tuning->width / intrinsic_width;
+    const float scale_y = (float)tuning->height / intrinsic_height;
+
+    if (tuning->width > 0 && tuning->height > 0) {
+        return SAIL_MIN(scale_x, scale_y);
+    } else if (tuning->width > 0) {
+        return scale_x;
+    } else if (tuning->height > 0) {
+        return scale_y;
+    } else if (tuning->scale > 0) {
+        return tuning->scale;
+    }
+
+    return 1;
+}
+
+static unsigned scaled_dimension(float dimension, float scale) {
+
+    const unsigned result = (unsigned)(dimension * scale + 0.5f);
+
+    return result == 0 ? 1 : result;
+}
+
+/*
+ * Band rendering.
+ */
+
+struct band {
+
+    const struct svg_state *svg_state;
+    struct sail_image *image;
+    unsigned first_row;
+    unsigned rows;
+    sail_status_t status;
+};
+
+/* Renders the rows of the band. The image is translated up, so the first band row lands on the first buffer row. */
+static void render_band(struct band *band) {
+
+    const struct svg_state *svg_state = band->svg_state;
+    struct sail_image *image = band->image;
+    unsigned char *pixels = (unsigned char *)image->pixels + (size_t)band->first_row * image->bytes_per_line;
+
+#ifdef SAIL_RESVG
+    /* resvg renders over the existing pixels. */
+    memset(pixels, 0, (size_t)band->rows * image->bytes_per_line);
+
+    #ifdef SAIL_HAVE_RESVG_FIT_TO
+        /* This API has no translation, so the image is always rendered in a single band. */
+        const resvg_fit_to resvg_fit_to = { RESVG_FIT_TO_ZOOM, svg_state->scale };
+        resvg_render(svg_state->resvg_tree, resvg_fit_to, image->width, band->rows, (char *)pixels);
+    #else
+        resvg_transform transform = resvg_transform_identity();
+        transform.a = svg_state->scale;
+        transform.d = svg_state->scale;
+        transform.f = -(float)band->first_row;
+
+        resvg_render(svg_state->resvg_tree, transform, image->width, band->rows, (char *)pixels);
+    #endif
+
+    band->status = SAIL_OK;
+#else
+    /* The rasterizer keeps its state between calls, so every band needs its own one. */
+    NSVGrasterizer *nsvg_rasterizer = nsvgCreateRasterizer();
+
+    if (nsvg_rasterizer == NULL) {
+        SAIL_LOG_ERROR("SVG: Failed to create NanoSVG rasterizer");
+        band->status = SAIL_ERROR_MEMORY_ALLOCATION;
+        return;
+    }
+
+    /* The rasterizer clears the buffer itself. */
+    nsvgRasterize(nsvg_rasterizer, svg_state->nsvg_image, /* x */ 0, /* y */ -(float)band->first_row, svg_state->scale,
+                    pixels, (int)image->width, (int)band->rows, (int)image->bytes_per_line);
+
+    nsvgDeleteRasterizer(nsvg_rasterizer);
+
+    band->status = SAIL_OK;
+#endif
+}
+
+static void render_band_task(void *user_data, unsigned task, unsigned thread) {
+
+    (void)thread;
+
+    struct band *bands = user_data;
+    render_band(&bands[task]);
+}
+
 /*
  * Decoding functions.
  */
@@ -142,12 +333,26 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_svg(struct sail_io *io, const
         SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
     }
 
-    svg_state->nsvg_rasterizer = nsvgCreateRasterizer();
+#endif
 
-    if (svg_state->nsvg_rasterizer == NULL) {
-        SAIL_LOG_ERROR("SVG: Failed to create NanoSVG rasterizer");
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    /* Handle tuning. */
+    if (svg_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(svg_state->load_options->tuning, svg_tuning_key_value_callback, &svg_state->tuning);
     }
+
+#ifdef SAIL_RESVG
+    const resvg_size intrinsic_size = resvg_get_image_size(svg_state->resvg_tree);
+    svg_state->intrinsic_width  = (float)intrinsic_size.width;
+    svg_state->intrinsic_height = (float)intrinsic_size.height;
+#else
+    svg_state->intrinsic_width  = svg_state->nsvg_image->width;
+    svg_state->intrinsic_height = svg_state->nsvg_image->height;
+#endif
+
+#if defined(SAIL_RESVG) && defined(SAIL_HAVE_RESVG_FIT_TO)
+    svg_state->threads = 1;
+#else
+    svg_state->threads = svg_state->tuning.threads;
 #endif
 
     return SAIL_OK;
@@ -157,11 +362,24 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_svg(void *state, st
 
     struct svg_state *svg_state = state;
 
-    if (svg_state->frame_loaded) {
+    const unsigned frames_count = (svg_state->tuning.sizes_count > 0) ? svg_state->tuning.sizes_count : 1;
+
+    if (svg_state->frames_loaded == frames_count) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
     }
 
-    svg_state->frame_loaded = true;
+    /* Renditions reuse the parsed image and differ only in the scale. */
+    if (svg_state->tuning.sizes_count > 0) {
+        struct svg_tuning rendition_tuning = svg_state->tuning;
+        rendition_tuning.width  = svg_state->tuning.sizes[svg_state->frames_loaded];
+        rendition_tuning.height = rendition_tuning.width;
+
+        svg_state->scale = compute_scale(&rendition_tuning, svg_state->intrinsic_width, svg_state->intrinsic_height);
+    } else {
+        svg_state->scale = compute_scale(&svg_state->tuning, svg_state->intrinsic_width, svg_state->intrinsic_height);
+    }
+
+    svg_state->frames_loaded++;
 
     struct sail_image *image_local;
     SAIL_TRY(sail_alloc_image(&image_local));
@@ -174,15 +392,8 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_svg(void *state, st
         image_local->source_image->compression  = SAIL_COMPRESSION_NONE;
     }
 
-#ifdef SAIL_RESVG
-    const resvg_size image_size = resvg_get_image_size(svg_state->resvg_tree);
-
-    image_local->width          = (unsigned)image_size.width;
-    image_local->height         = (unsigned)image_size.height;
-#else
-    image_local->width          = (unsigned)svg_state->nsvg_image->width;
-    image_local->height         = (unsigned)svg_state->nsvg_image->height;
-#endif
+    image_local->width          = scaled_dimension(svg_state->intrinsic_width, svg_state->scale);
+    image_local->height         = scaled_dimension(svg_state->intrinsic_height, svg_state->scale);
     image_local->pixel_format   = SAIL_PIXEL_FORMAT_BPP32_RGBA;
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
@@ -195,19 +406,39 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_svg(void *state, struct sail_
 
     const struct svg_state *svg_state = state;
 
-    memset(image->pixels, 0, (size_t)image->bytes_per_line * image->height);
+    const unsigned bands_count = SAIL_MIN(svg_state->threads, image->height);
 
-#ifdef SAIL_RESVG
-    #ifdef SAIL_HAVE_RESVG_FIT_TO
-        const resvg_fit_to resvg_fit_to = { RESVG_FIT_TO_ORIGINAL, 0 };
-        resvg_render(svg_state->resvg_tree, resvg_fit_to, image->width, image->height, image->pixels);
-    #else
-        resvg_render(svg_state->resvg_tree, resvg_transform_identity(), image->width, image->height, image->pixels);
-    #endif
-#else
-    nsvgRasterize(svg_state->nsvg_rasterizer, svg_state->nsvg_image, /* x */ 0, /* y */ 0, /* scale */ 1,
-                    image->pixels, (int)image->width, (int)image->height, (int)image->bytes_per_line);
-#endif
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct band) * bands_count, &ptr));
+    struct band *bands = ptr;
+
+    /* Split the rows into horizontal bands. */
+    const unsigned rows_per_band = image->height / bands_count;
+    const unsigned rows_left     = image->height % bands_count;
+
+    for (unsigned i = 0, first_row = 0; i < bands_count; i++) {
+        bands[i] = (struct band) {
+            .svg_state = svg_state,
+            .image     = image,
+            .first_row = first_row,
+            .rows      = rows_per_band + (i < rows_left ? 1 : 0),
+            .status    = SAIL_OK,
+        };
+
+        first_row += bands[i].rows;
+    }
+
+    sail_thread_pool_run(bands_count, render_band_task, bands);
+
+    sail_status_t status = SAIL_OK;
+
+    for (unsigned i = 0; i < bands_count && status == SAIL_OK; i++) {
+        status = bands[i].status;
+    }
+
+    sail_free(bands);
+
+    SAIL_TRY(status);
 
     return SAIL_OK;
 }
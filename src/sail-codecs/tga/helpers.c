@@ -30,10 +30,15 @@
 
 #include <sail-common/sail-common.h>
 
+#include "common/rle/rle.h"
+
 #include "helpers.h"
 
 static const uint16_t TGA2_EXTENSION_AREA_LENGTH = 495;
 
+/* Maximum number of pixels in a single RLE or raw packet. */
+static const unsigned TGA_MAX_PACKET_PIXELS = 128;
+
 sail_status_t tga_private_read_file_header(struct sail_io *io, struct TgaFileHeader *file_header) {
 
     SAIL_TRY(io->strict_read(io->stream, &file_header->id_length,                   sizeof(file_header->id_length)));
@@ -372,3 +377,149 @@ sail_status_t tga_private_fetch_palette(struct sail_io *io, const struct TgaFile
 
     return SAIL_OK;
 }
+
+sail_status_t tga_private_write_file_header(struct sail_io *io, const struct TgaFileHeader *file_header) {
+
+    SAIL_TRY(io->strict_write(io->stream, &file_header->id_length,                   sizeof(file_header->id_length)));
+    SAIL_TRY(io->strict_write(io->stream, &file_header->color_map_type,              sizeof(file_header->color_map_type)));
+    SAIL_TRY(io->strict_write(io->stream, &file_header->image_type,                  sizeof(file_header->image_type)));
+    SAIL_TRY(io->strict_write(io->stream, &file_header->first_color_map_entry_index, sizeof(file_header->first_color_map_entry_index)));
+    SAIL_TRY(io->strict_write(io->stream, &file_header->color_map_elements,          sizeof(file_header->color_map_elements)));
+    SAIL_TRY(io->strict_write(io->stream, &file_header->color_map_entry_size,        sizeof(file_header->color_map_entry_size)));
+    SAIL_TRY(io->strict_write(io->stream, &file_header->x,                           sizeof(file_header->x)));
+    SAIL_TRY(io->strict_write(io->stream, &file_header->y,                           sizeof(file_header->y)));
+    SAIL_TRY(io->strict_write(io->stream, &file_header->width,                       sizeof(file_header->width)));
+    SAIL_TRY(io->strict_write(io->stream, &file_header->height,                      sizeof(file_header->height)));
+    SAIL_TRY(io->strict_write(io->stream, &file_header->bpp,                         sizeof(file_header->bpp)));
+    SAIL_TRY(io->strict_write(io->stream, &file_header->descriptor,                  sizeof(file_header->descriptor)));
+
+    return SAIL_OK;
+}
+
+sail_status_t tga_private_write_file_footer(struct sail_io *io, const struct TgaFooter *footer) {
+
+    SAIL_TRY(io->strict_write(io->stream, &footer->extension_area_offset, sizeof(footer->extension_area_offset)));
+    SAIL_TRY(io->strict_write(io->stream, &footer->developer_area_offset, sizeof(footer->developer_area_offset)));
+    SAIL_TRY(io->strict_write(io->stream, &footer->signature,             sizeof(footer->signature)));
+
+    return SAIL_OK;
+}
+
+sail_status_t tga_private_sail_pixel_format_to_tga(enum SailPixelFormat pixel_format, bool rle, uint8_t *image_type, uint8_t *bpp) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_INDEXED: {
+            *image_type = rle ? TGA_INDEXED_RLE : TGA_INDEXED;
+            *bpp = 8;
+            return SAIL_OK;
+        }
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: {
+            *image_type = rle ? TGA_GRAY_RLE : TGA_GRAY;
+            *bpp = 8;
+            return SAIL_OK;
+        }
+        case SAIL_PIXEL_FORMAT_BPP16_BGR555: {
+            *image_type = rle ? TGA_TRUE_COLOR_RLE : TGA_TRUE_COLOR;
+            *bpp = 16;
+            return SAIL_OK;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_BGR: {
+            *image_type = rle ? TGA_TRUE_COLOR_RLE : TGA_TRUE_COLOR;
+            *bpp = 24;
+            return SAIL_OK;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: {
+            *image_type = rle ? TGA_TRUE_COLOR_RLE : TGA_TRUE_COLOR;
+            *bpp = 32;
+            return SAIL_OK;
+        }
+        default: {
+            SAIL_LOG_ERROR("TGA: %s pixel format is not currently supported for saving", sail_pixel_format_to_string(pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+    }
+}
+
+const char *tga_private_id_from_meta_data(const struct sail_meta_data_node *meta_data_node) {
+
+    for (; meta_data_node != NULL; meta_data_node = meta_data_node->next) {
+        const struct sail_meta_data *meta_data = meta_data_node->meta_data;
+
+        if (meta_data->key == SAIL_META_DATA_ID && meta_data->value->type == SAIL_VARIANT_TYPE_STRING) {
+            return sail_variant_to_string(meta_data->value);
+        }
+    }
+
+    return NULL;
+}
+
+sail_status_t tga_private_write_palette(struct sail_io *io, const struct sail_palette *palette) {
+
+    if (palette == NULL || palette->data == NULL || palette->color_count == 0) {
+        SAIL_LOG_ERROR("TGA: Indexed image has no palette");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MISSING_PALETTE);
+    }
+
+    unsigned channels;
+
+    switch (palette->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:  { channels = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: { channels = 4; break; }
+        default: {
+            SAIL_LOG_ERROR("TGA: %s palette pixel format is not currently supported for saving",
+                            sail_pixel_format_to_string(palette->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+    }
+
+    if (palette->color_count > 256) {
+        SAIL_LOG_ERROR("TGA: Palette has %u colors, but 8-bit indexed images allow only 256", palette->color_count);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    /* TGA stores BGR or BGRA entries. */
+    unsigned char entries[256 * 4];
+    const unsigned char *entry = palette->data;
+    unsigned char *target = entries;
+
+    for (unsigned i = 0; i < palette->color_count; i++, entry += channels) {
+        *target++ = entry[2];
+        *target++ = entry[1];
+        *target++ = entry[0];
+
+        if (channels == 4) {
+            *target++ = entry[3];
+        }
+    }
+
+    SAIL_TRY(io->strict_write(io->stream, entries, (size_t)palette->color_count * channels));
+
+    return SAIL_OK;
+}
+
+sail_status_t tga_private_write_rle_row(struct sail_buffered_writer *writer, const unsigned char *scan, unsigned width, unsigned pixel_size) {
+
+    for (unsigned x = 0; x < width;) {
+        const unsigned char *pixels = scan + (size_t)x * pixel_size;
+        const unsigned left = SAIL_MIN(width - x, TGA_MAX_PACKET_PIXELS);
+        const unsigned run  = rle_private_run_length(pixels, pixel_size, left);
+
+        if (run >= 2) {
+            /* 7th bit set = RLE packet. */
+            const uint8_t marker = (uint8_t)(0x80 | (run - 1));
+
+            SAIL_TRY(sail_buffered_writer_strict_write(writer, &marker, sizeof(marker)));
+            SAIL_TRY(sail_buffered_writer_strict_write(writer, pixels, pixel_size));
+            x += run;
+        } else {
+            const unsigned literal = rle_private_literal_length(pixels, pixel_size, left, 2);
+            const uint8_t marker = (uint8_t)(literal - 1);
+
+            SAIL_TRY(sail_buffered_writer_strict_write(writer, &marker, sizeof(marker)));
+            SAIL_TRY(sail_buffered_writer_strict_write(writer, pixels, (size_t)literal * pixel_size));
+            x += literal;
+        }
+    }
+
+    return SAIL_OK;
+}
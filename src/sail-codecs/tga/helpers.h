@@ -26,12 +26,14 @@
 #ifndef SAIL_TGA_HELPERS_H
 #define SAIL_TGA_HELPERS_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <sail-common/common.h>
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
+struct sail_buffered_writer;
 struct sail_io;
 struct sail_meta_data_node;
 struct sail_palette;
@@ -90,4 +92,16 @@ SAIL_HIDDEN sail_status_t tga_private_fetch_extension(struct sail_io *io, double
 
 SAIL_HIDDEN sail_status_t tga_private_fetch_palette(struct sail_io *io, const struct TgaFileHeader *file_header, struct sail_palette **palette);
 
+SAIL_HIDDEN sail_status_t tga_private_write_file_header(struct sail_io *io, const struct TgaFileHeader *file_header);
+
+SAIL_HIDDEN sail_status_t tga_private_write_file_footer(struct sail_io *io, const struct TgaFooter *footer);
+
+SAIL_HIDDEN sail_status_t tga_private_sail_pixel_format_to_tga(enum SailPixelFormat pixel_format, bool rle, uint8_t *image_type, uint8_t *bpp);
+
+SAIL_HIDDEN const char *tga_private_id_from_meta_data(const struct sail_meta_data_node *meta_data_node);
+
+SAIL_HIDDEN sail_status_t tga_private_write_palette(struct sail_io *io, const struct sail_palette *palette);
+
+SAIL_HIDDEN sail_status_t tga_private_write_rle_row(struct sail_buffered_writer *writer, const unsigned char *scan, unsigned width, unsigned pixel_size);
+
 #endif
@@ -24,12 +24,16 @@
 */
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <sail-common/sail-common.h>
 
+#include "common/rle/rle.h"
+#include "common/row_cursor/row_cursor.h"
+
 #include "helpers.h"
 
 static const char * const TGA_SIGNATURE   = "TRUEVISION-XFILE.";
@@ -47,6 +51,7 @@ struct tga_state {
     struct TgaFooter footer;
 
     bool frame_loaded;
+    bool frame_saved;
     bool tga2;
     bool flipped_h;
     bool flipped_v;
@@ -67,6 +72,7 @@ static sail_status_t alloc_tga_state(struct sail_io *io,
         .save_options = save_options,
 
         .frame_loaded  = false,
+        .frame_saved   = false,
         .tga2          = false,
         .flipped_h     = false,
         .flipped_v     = false,
@@ -99,6 +105,13 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_tga(struct sail_io *io, const
 
     /* Read TGA footer. */
     SAIL_TRY(tga_state->io->seek(tga_state->io->stream, -TGA_FOOTER_SIZE, SEEK_END));
+
+    if (io->features & SAIL_IO_FEATURE_EXPENSIVE_SEEK) {
+        size_t offset;
+        SAIL_TRY(io->tell(io->stream, &offset));
+        SAIL_TRY(sail_io_will_need(io, offset, (size_t)TGA_FOOTER_SIZE));
+    }
+
     SAIL_TRY(tga_private_read_file_footer(io, &tga_state->footer));
     SAIL_TRY(tga_state->io->seek(tga_state->io->stream, 0, SEEK_SET));
 
@@ -161,12 +174,17 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_tga(void *state, st
 
     /* Identificator. */
     if (tga_state->file_header.id_length > 0) {
-        SAIL_TRY_OR_CLEANUP(tga_private_fetch_id(tga_state->io, &tga_state->file_header, &image_local->meta_data_node),
-                            /* cleanup */ sail_destroy_image(image_local));
+        if (sail_load_meta_data_key(tga_state->load_options, SAIL_META_DATA_ID)) {
+            SAIL_TRY_OR_CLEANUP(tga_private_fetch_id(tga_state->io, &tga_state->file_header, &image_local->meta_data_node),
+                                /* cleanup */ sail_destroy_image(image_local));
+        } else {
+            SAIL_TRY_OR_CLEANUP(tga_state->io->seek(tga_state->io->stream, tga_state->file_header.id_length, SEEK_CUR),
+                                /* cleanup */ sail_destroy_image(image_local));
+        }
     }
 
     /* Extension area. */
-    if (tga_state->tga2 && tga_state->footer.extension_area_offset > 0) {
+    if (tga_state->load_options->options & SAIL_OPTION_META_DATA && tga_state->tga2 && tga_state->footer.extension_area_offset > 0) {
         /* Seek to offset. */
         size_t offset;
         SAIL_TRY_OR_CLEANUP(tga_state->io->tell(tga_state->io->stream, &offset),
@@ -196,56 +214,86 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_tga(void *state, struct sail_
 
     struct tga_state *tga_state = state;
 
+    const unsigned pixel_size = (tga_state->file_header.bpp + 7) / 8;
+
+    /* Rows and pixels are written straight into their final positions. */
+    struct row_cursor cursor;
+    row_cursor_private_init(&cursor, image, pixel_size, tga_state->flipped_v, tga_state->flipped_h);
+
     switch (tga_state->file_header.image_type) {
         case TGA_INDEXED:
         case TGA_TRUE_COLOR:
         case TGA_GRAY: {
-            SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, image->pixels, (size_t)image->bytes_per_line * image->height));
+            if (!tga_state->flipped_v && !tga_state->flipped_h) {
+                SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, image->pixels, (size_t)image->bytes_per_line * image->height));
+                break;
+            }
+
+            for (unsigned row = 0; row < image->height; row++) {
+                unsigned count;
+                unsigned char *scan = row_cursor_private_next(&cursor, image->width, &count);
+
+                SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, scan, (size_t)pixel_size * count));
+                row_cursor_private_reverse(&cursor, scan, count);
+            }
             break;
         }
         case TGA_INDEXED_RLE:
         case TGA_TRUE_COLOR_RLE:
         case TGA_GRAY_RLE: {
-            const unsigned pixel_size = (tga_state->file_header.bpp + 7) / 8;
             const unsigned pixels_num = image->width * image->height;
 
-            unsigned char *pixels = image->pixels;
+            struct sail_buffered_reader reader;
+            SAIL_TRY(sail_init_buffered_reader(tga_state->io, 0, &reader));
 
             for (unsigned i = 0; i < pixels_num;) {
                 unsigned char marker;
-                SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, &marker, 1));
+                SAIL_TRY_OR_CLEANUP(sail_buffered_reader_read_byte(&reader, &marker),
+                                    /* cleanup */ sail_finish_buffered_reader(&reader));
 
                 unsigned count = (marker & 0x7F) + 1;
 
+                if (count > pixels_num - i) {
+                    sail_finish_buffered_reader(&reader);
+                    SAIL_LOG_ERROR("TGA: RLE packet exceeds the image size");
+                    SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+                }
+
+                i += count;
+
                 /* 7th bit set = RLE packet. */
                 if (marker & 0x80) {
                     unsigned char pixel[4];
 
-                    SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, pixel, pixel_size));
+                    SAIL_TRY_OR_CLEANUP(sail_buffered_reader_strict_read(&reader, pixel, pixel_size),
+                                        /* cleanup */ sail_finish_buffered_reader(&reader));
 
-                    for (unsigned j = 0; j < count; j++, i++) {
-                        memcpy(pixels, pixel, pixel_size);
-                        pixels += pixel_size;
+                    /* Packets may span rows. */
+                    while (count > 0) {
+                        unsigned span_count;
+                        unsigned char *span = row_cursor_private_next(&cursor, count, &span_count);
+
+                        rle_private_fill(span, pixel, pixel_size, span_count);
+                        count -= span_count;
                     }
                 } else {
-                    for (unsigned j = 0; j < count; j++, i++) {
-                        SAIL_TRY(tga_state->io->strict_read(tga_state->io->stream, pixels, pixel_size));
-                        pixels += pixel_size;
+                    while (count > 0) {
+                        unsigned span_count;
+                        unsigned char *span = row_cursor_private_next(&cursor, count, &span_count);
+
+                        SAIL_TRY_OR_CLEANUP(sail_buffered_reader_strict_read(&reader, span, (size_t)pixel_size * span_count),
+                                            /* cleanup */ sail_finish_buffered_reader(&reader));
+                        row_cursor_private_reverse(&cursor, span, span_count);
+                        count -= span_count;
                     }
                 }
             }
+
+            SAIL_TRY(sail_finish_buffered_reader(&reader));
             break;
         }
     }
 
-    /* TODO: We can avoid this by putting pixels in reverse order like in the BMP codec. */
-    if (tga_state->flipped_v) {
-        sail_mirror_vertically(image);
-    }
-    if (tga_state->flipped_h) {
-        sail_mirror_horizontally(image);
-    }
-
     return SAIL_OK;
 }
 
@@ -266,32 +314,149 @@ SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_tga(void **state) {
 
 SAIL_EXPORT sail_status_t sail_codec_save_init_v8_tga(struct sail_io *io, const struct sail_save_options *save_options, void **state) {
 
-    (void)io;
-    (void)save_options;
-    (void)state;
+    *state = NULL;
+
+    /* Allocate a new state. */
+    struct tga_state *tga_state;
+    SAIL_TRY(alloc_tga_state(io, NULL, save_options, &tga_state));
+    *state = tga_state;
+
+    /* Sanity check. */
+    if (tga_state->save_options->compression != SAIL_COMPRESSION_NONE && tga_state->save_options->compression != SAIL_COMPRESSION_RLE) {
+        SAIL_LOG_ERROR("TGA: Only NONE and RLE compressions are allowed for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_tga(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct tga_state *tga_state = state;
+
+    if (tga_state->frame_saved) {
+        SAIL_LOG_ERROR("TGA: Only single frame is supported for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    tga_state->frame_saved = true;
+
+    if (image->width > UINT16_MAX || image->height > UINT16_MAX) {
+        SAIL_LOG_ERROR("TGA: Image dimensions must not exceed %u pixels", UINT16_MAX);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    uint8_t image_type;
+    uint8_t bpp;
+    SAIL_TRY(tga_private_sail_pixel_format_to_tga(image->pixel_format,
+                                                  tga_state->save_options->compression == SAIL_COMPRESSION_RLE,
+                                                  &image_type,
+                                                  &bpp));
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    /* Identificator. */
+    const char *id = NULL;
+
+    if (tga_state->save_options->options & SAIL_OPTION_META_DATA) {
+        id = tga_private_id_from_meta_data(image->meta_data_node);
+    }
+
+    const size_t id_length = (id == NULL) ? 0 : SAIL_MIN(strlen(id), (size_t)UINT8_MAX);
+
+    const bool indexed = image->pixel_format == SAIL_PIXEL_FORMAT_BPP8_INDEXED;
+
+    if (indexed && (image->palette == NULL || image->palette->color_count == 0)) {
+        SAIL_LOG_ERROR("TGA: Indexed image has no palette");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MISSING_PALETTE);
+    }
+
+    /* Rows are saved top-to-bottom. 32-bit pixels have 8 alpha bits. */
+    tga_state->file_header = (struct TgaFileHeader) {
+        .id_length                   = (uint8_t)id_length,
+        .color_map_type              = indexed ? TGA_HAS_COLOR_MAP : TGA_HAS_NO_COLOR_MAP,
+        .image_type                  = image_type,
+        .first_color_map_entry_index = 0,
+        .color_map_elements          = indexed ? (uint16_t)image->palette->color_count : 0,
+        .color_map_entry_size        = 0,
+        .x                           = 0,
+        .y                           = 0,
+        .width                       = (uint16_t)image->width,
+        .height                      = (uint16_t)image->height,
+        .bpp                         = bpp,
+        .descriptor                  = (uint8_t)(0x20 | (bpp == 32 ? 8 : 0)),
+    };
+
+    if (indexed) {
+        tga_state->file_header.color_map_entry_size = (image->palette->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA) ? 32 : 24;
+    }
+
+    SAIL_TRY(tga_private_write_file_header(tga_state->io, &tga_state->file_header));
+
+    if (id_length > 0) {
+        SAIL_TRY(tga_state->io->strict_write(tga_state->io->stream, id, id_length));
+    }
+
+    if (indexed) {
+        SAIL_TRY(tga_private_write_palette(tga_state->io, image->palette));
+    }
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_tga(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct tga_state *tga_state = state;
+
+    const unsigned pixel_size = (tga_state->file_header.bpp + 7) / 8;
+    const size_t bytes_in_row = (size_t)pixel_size * image->width;
+
+    if (tga_state->file_header.image_type == TGA_INDEXED_RLE ||
+            tga_state->file_header.image_type == TGA_TRUE_COLOR_RLE ||
+            tga_state->file_header.image_type == TGA_GRAY_RLE) {
+        /* Packets are coalesced into large blocks. They never cross scan lines. */
+        struct sail_buffered_writer writer;
+        SAIL_TRY(sail_init_buffered_writer(tga_state->io, 0, &writer));
+
+        for (unsigned row = 0; row < image->height; row++) {
+            SAIL_TRY_OR_CLEANUP(tga_private_write_rle_row(&writer, sail_scan_line(image, row), image->width, pixel_size),
+                                /* cleanup */ sail_finish_buffered_writer(&writer));
+        }
+
+        SAIL_TRY(sail_finish_buffered_writer(&writer));
+    } else if (image->bytes_per_line == bytes_in_row) {
+        /* Contiguous rows are written at once. */
+        SAIL_TRY(tga_state->io->strict_write(tga_state->io->stream, image->pixels, bytes_in_row * image->height));
+    } else {
+        struct sail_buffered_writer writer;
+        SAIL_TRY(sail_init_buffered_writer(tga_state->io, 0, &writer));
+
+        for (unsigned row = 0; row < image->height; row++) {
+            SAIL_TRY_OR_CLEANUP(sail_buffered_writer_strict_write(&writer, sail_scan_line(image, row), bytes_in_row),
+                                /* cleanup */ sail_finish_buffered_writer(&writer));
+        }
+
+        SAIL_TRY(sail_finish_buffered_writer(&writer));
+    }
+
+    /* TGA 2.0 footer without extension and developer areas. */
+    struct TgaFooter footer = {
+        .extension_area_offset = 0,
+        .developer_area_offset = 0,
+    };
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    memcpy(footer.signature, TGA_SIGNATURE, sizeof(footer.signature));
+
+    SAIL_TRY(tga_private_write_file_footer(tga_state->io, &footer));
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_tga(void **state) {
 
-    (void)state;
+    struct tga_state *tga_state = *state;
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    *state = NULL;
+
+    destroy_tga_state(tga_state);
+
+    return SAIL_OK;
 }
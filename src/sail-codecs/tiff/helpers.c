@@ -34,6 +34,10 @@
 
 #include "helpers.h"
 
+#ifdef SAIL_HAVE_TIFF_PARALLEL
+    #include "parallel.h"
+#endif
+
 void tiff_private_my_error_fn(const char *module, const char *format, va_list ap) {
 
     char buffer[160];
@@ -462,3 +466,482 @@ sail_status_t tiff_private_write_resolution(TIFF *tiff, const struct sail_resolu
 
     return SAIL_OK;
 }
+
+sail_status_t tiff_private_will_need_striles(TIFF *tiff) {
+
+    struct sail_io *io = (struct sail_io *)TIFFClientdata(tiff);
+
+    if ((io->features & SAIL_IO_FEATURE_EXPENSIVE_SEEK) == 0) {
+        return SAIL_OK;
+    }
+
+    const uint32_t striles = TIFFIsTiled(tiff) ? TIFFNumberOfTiles(tiff) : TIFFNumberOfStrips(tiff);
+
+    /* Merge adjacent strips or tiles into a single range. */
+    uint64_t range_offset = 0;
+    uint64_t range_length = 0;
+
+    for (uint32_t strile = 0; strile < striles; strile++) {
+        const uint64_t offset = TIFFGetStrileOffset(tiff, strile);
+        const uint64_t length = TIFFGetStrileByteCount(tiff, strile);
+
+        if (length == 0) {
+            continue;
+        }
+
+        if (range_length > 0 && offset == range_offset + range_length) {
+            range_length += length;
+            continue;
+        }
+
+        if (range_length > 0) {
+            SAIL_TRY(sail_io_will_need(io, (size_t)range_offset, (size_t)range_length));
+        }
+
+        range_offset = offset;
+        range_length = length;
+    }
+
+    if (range_length > 0) {
+        SAIL_TRY(sail_io_will_need(io, (size_t)range_offset, (size_t)range_length));
+    }
+
+    return SAIL_OK;
+}
+
+enum SailPixelFormat tiff_private_native_pixel_format(TIFF *tiff, bool *min_is_white) {
+
+    *min_is_white = false;
+
+    uint16_t photometric;
+    uint16_t bits_per_sample;
+    uint16_t samples_per_pixel;
+    uint16_t planar_config;
+    uint16_t sample_format;
+    uint16_t orientation;
+    uint16_t compression;
+
+    if (!TIFFGetField(tiff, TIFFTAG_PHOTOMETRIC, &photometric) ||
+            !TIFFGetFieldDefaulted(tiff, TIFFTAG_BITSPERSAMPLE, &bits_per_sample) ||
+            !TIFFGetFieldDefaulted(tiff, TIFFTAG_SAMPLESPERPIXEL, &samples_per_pixel) ||
+            !TIFFGetFieldDefaulted(tiff, TIFFTAG_PLANARCONFIG, &planar_config) ||
+            !TIFFGetFieldDefaulted(tiff, TIFFTAG_SAMPLEFORMAT, &sample_format) ||
+            !TIFFGetFieldDefaulted(tiff, TIFFTAG_ORIENTATION, &orientation) ||
+            !TIFFGetFieldDefaulted(tiff, TIFFTAG_COMPRESSION, &compression)) {
+        return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+
+    /* Leave everything that needs reordering or color conversion to TIFFRGBAImage. */
+    if ((planar_config != PLANARCONFIG_CONTIG && samples_per_pixel > 1) ||
+            sample_format != SAMPLEFORMAT_UINT ||
+            orientation != ORIENTATION_TOPLEFT ||
+            compression == COMPRESSION_OJPEG) {
+        return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+
+    uint16_t extra_samples_count = 0;
+    uint16_t *extra_samples = NULL;
+    TIFFGetFieldDefaulted(tiff, TIFFTAG_EXTRASAMPLES, &extra_samples_count, &extra_samples);
+
+    const uint16_t alpha = (extra_samples_count == 1 && extra_samples != NULL) ? extra_samples[0] : EXTRASAMPLE_UNSPECIFIED;
+
+    switch (photometric) {
+        case PHOTOMETRIC_MINISWHITE:
+        case PHOTOMETRIC_MINISBLACK: {
+            if (samples_per_pixel == 1) {
+                *min_is_white = photometric == PHOTOMETRIC_MINISWHITE;
+
+                switch (bits_per_sample) {
+                    case 1:  return SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE;
+                    case 2:  return SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE;
+                    case 4:  return SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE;
+                    case 8:  return SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
+                    case 16: return SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE;
+                }
+            } else if (samples_per_pixel == 2 && photometric == PHOTOMETRIC_MINISBLACK && alpha == EXTRASAMPLE_UNASSALPHA) {
+                switch (bits_per_sample) {
+                    case 8:  return SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA;
+                    case 16: return SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA;
+                }
+            }
+
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+        case PHOTOMETRIC_PALETTE: {
+            if (samples_per_pixel == 1) {
+                switch (bits_per_sample) {
+                    case 1: return SAIL_PIXEL_FORMAT_BPP1_INDEXED;
+                    case 2: return SAIL_PIXEL_FORMAT_BPP2_INDEXED;
+                    case 4: return SAIL_PIXEL_FORMAT_BPP4_INDEXED;
+                    case 8: return SAIL_PIXEL_FORMAT_BPP8_INDEXED;
+                }
+            }
+
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+        case PHOTOMETRIC_RGB: {
+            if (samples_per_pixel == 3) {
+                switch (bits_per_sample) {
+                    case 8:  return SAIL_PIXEL_FORMAT_BPP24_RGB;
+                    case 16: return SAIL_PIXEL_FORMAT_BPP48_RGB;
+                }
+            } else if (samples_per_pixel == 4 && alpha == EXTRASAMPLE_UNASSALPHA) {
+                switch (bits_per_sample) {
+                    case 8:  return SAIL_PIXEL_FORMAT_BPP32_RGBA;
+                    case 16: return SAIL_PIXEL_FORMAT_BPP64_RGBA;
+                }
+            } else if (samples_per_pixel == 4 && alpha == EXTRASAMPLE_ASSOCALPHA) {
+                switch (bits_per_sample) {
+                    case 8:  return SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED;
+                    case 16: return SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED;
+                }
+            }
+
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+        case PHOTOMETRIC_SEPARATED: {
+            uint16_t ink_set;
+
+            if (!TIFFGetFieldDefaulted(tiff, TIFFTAG_INKSET, &ink_set) || ink_set != INKSET_CMYK) {
+                return SAIL_PIXEL_FORMAT_UNKNOWN;
+            }
+
+            if (samples_per_pixel == 4) {
+                switch (bits_per_sample) {
+                    case 8:  return SAIL_PIXEL_FORMAT_BPP32_CMYK;
+                    case 16: return SAIL_PIXEL_FORMAT_BPP64_CMYK;
+                }
+            } else if (samples_per_pixel == 5 && alpha == EXTRASAMPLE_UNASSALPHA) {
+                switch (bits_per_sample) {
+                    case 8:  return SAIL_PIXEL_FORMAT_BPP40_CMYKA;
+                    case 16: return SAIL_PIXEL_FORMAT_BPP80_CMYKA;
+                }
+            }
+
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+        default: {
+            return SAIL_PIXEL_FORMAT_UNKNOWN;
+        }
+    }
+}
+
+sail_status_t tiff_private_fetch_palette(TIFF *tiff, struct sail_palette **palette) {
+
+    SAIL_CHECK_PTR(palette);
+
+    uint16_t bits_per_sample;
+    uint16_t *red;
+    uint16_t *green;
+    uint16_t *blue;
+
+    if (!TIFFGetFieldDefaulted(tiff, TIFFTAG_BITSPERSAMPLE, &bits_per_sample) ||
+            !TIFFGetField(tiff, TIFFTAG_COLORMAP, &red, &green, &blue)) {
+        SAIL_LOG_ERROR("TIFF: The indexed image has no palette");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MISSING_PALETTE);
+    }
+
+    const unsigned color_count = 1U << bits_per_sample;
+
+    /* Some writers store 8-bit colors. libtiff detects them the same way. */
+    unsigned shift = 0;
+
+    for (unsigned i = 0; i < color_count; i++) {
+        if (red[i] > 255 || green[i] > 255 || blue[i] > 255) {
+            shift = 8;
+            break;
+        }
+    }
+
+    struct sail_palette *palette_local;
+    SAIL_TRY(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, color_count, &palette_local));
+
+    unsigned char *data = palette_local->data;
+
+    for (unsigned i = 0; i < color_count; i++) {
+        *data++ = (unsigned char)(red[i]   >> shift);
+        *data++ = (unsigned char)(green[i] >> shift);
+        *data++ = (unsigned char)(blue[i]  >> shift);
+    }
+
+    *palette = palette_local;
+
+    return SAIL_OK;
+}
+
+static void invert_pixels(unsigned char *pixels, size_t size) {
+
+    for (size_t i = 0; i < size; i++) {
+        pixels[i] = (unsigned char)~pixels[i];
+    }
+}
+
+static sail_status_t read_native_strips(TIFF *tiff, struct sail_image *image, const struct sail_cancellation *cancellation) {
+
+    uint32_t rows_per_strip;
+    if (!TIFFGetFieldDefaulted(tiff, TIFFTAG_ROWSPERSTRIP, &rows_per_strip) || rows_per_strip == 0 || rows_per_strip > image->height) {
+        rows_per_strip = image->height;
+    }
+
+    /* Strips are decoded right into the image pixels. */
+    for (unsigned row = 0; row < image->height; row += rows_per_strip) {
+        const unsigned rows = (image->height - row < rows_per_strip) ? image->height - row : rows_per_strip;
+        const tmsize_t size = (tmsize_t)rows * image->bytes_per_line;
+
+        SAIL_TRY(sail_check_cancellation(cancellation));
+
+        if (TIFFReadEncodedStrip(tiff, TIFFComputeStrip(tiff, row, 0), sail_scan_line(image, row), size) < 0) {
+            SAIL_LOG_ERROR("TIFF: Failed to read the strip at row %u", row);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_native_tiles(TIFF *tiff, struct sail_image *image, const struct sail_cancellation *cancellation) {
+
+    uint32_t tile_width;
+    uint32_t tile_height;
+
+    if (!TIFFGetField(tiff, TIFFTAG_TILEWIDTH, &tile_width) || !TIFFGetField(tiff, TIFFTAG_TILELENGTH, &tile_height) ||
+            tile_width == 0 || tile_height == 0) {
+        SAIL_LOG_ERROR("TIFF: Failed to get the tile dimensions");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    const tmsize_t tile_size     = TIFFTileSize(tiff);
+    const tmsize_t tile_row_size = TIFFTileRowSize(tiff);
+    const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+
+    void *tile;
+    SAIL_TRY(sail_malloc((size_t)tile_size, &tile));
+
+    /* Tile widths are multiples of 16, so tiles always start on a byte boundary. */
+    for (unsigned y = 0; y < image->height; y += tile_height) {
+        const unsigned rows = (image->height - y < tile_height) ? image->height - y : tile_height;
+
+        SAIL_TRY_OR_CLEANUP(sail_check_cancellation(cancellation),
+                            /* cleanup */ sail_free(tile));
+
+        for (unsigned x = 0; x < image->width; x += tile_width) {
+            const unsigned columns = (image->width - x < tile_width) ? image->width - x : tile_width;
+
+            if (TIFFReadEncodedTile(tiff, TIFFComputeTile(tiff, x, y, 0, 0), tile, tile_size) < 0) {
+                sail_free(tile);
+                SAIL_LOG_ERROR("TIFF: Failed to read the tile at %u,%u", x, y);
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+
+            const size_t offset = (size_t)x * bits_per_pixel / 8;
+            const size_t length = ((size_t)columns * bits_per_pixel + 7) / 8;
+
+            for (unsigned row = 0; row < rows; row++) {
+                memcpy((unsigned char *)sail_scan_line(image, y + row) + offset,
+                       (const unsigned char *)tile + (size_t)row * tile_row_size,
+                       length);
+            }
+        }
+    }
+
+    sail_free(tile);
+
+    return SAIL_OK;
+}
+
+sail_status_t tiff_private_read_native(TIFF *tiff, struct sail_image *image, bool min_is_white, unsigned threads,
+                                       const struct sail_cancellation *cancellation) {
+
+    SAIL_CHECK_PTR(image);
+
+    if (TIFFScanlineSize(tiff) != (tmsize_t)image->bytes_per_line) {
+        SAIL_LOG_ERROR("TIFF: Scan line size %lld doesn't match %u bytes per line", (long long)TIFFScanlineSize(tiff), image->bytes_per_line);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    bool decoded = false;
+
+#ifdef SAIL_HAVE_TIFF_PARALLEL
+    if (threads > 1 && tiff_private_can_decode_in_parallel(tiff)) {
+        SAIL_LOG_TRACE("TIFF: Decoding in %u threads", threads);
+        SAIL_TRY(tiff_private_read_native_parallel(tiff, image, threads, cancellation));
+        decoded = true;
+    }
+#else
+    (void)threads;
+#endif
+
+    if (!decoded) {
+        if (TIFFIsTiled(tiff)) {
+            SAIL_TRY(read_native_tiles(tiff, image, cancellation));
+        } else {
+            SAIL_TRY(read_native_strips(tiff, image, cancellation));
+        }
+    }
+
+    /* SAIL grayscale formats treat zero as black. */
+    if (min_is_white) {
+        invert_pixels(image->pixels, (size_t)image->bytes_per_line * image->height);
+    }
+
+    return SAIL_OK;
+}
+
+bool tiff_private_load_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    unsigned *threads = user_data;
+
+    if (strcmp(key, "tiff-threads") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned threads_value = sail_variant_to_unsigned_int(value);
+
+            if (threads_value > 0) {
+                *threads = threads_value;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool tiff_private_save_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    struct tiff_private_save_tuning *save_tuning = user_data;
+
+    if (value->type != SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+        return true;
+    }
+
+    const unsigned number = sail_variant_to_unsigned_int(value);
+
+    if (strcmp(key, "tiff-tile-size") == 0) {
+        /* TIFF requires tile dimensions to be multiples of 16. */
+        save_tuning->tile_size = (number + 15) / 16 * 16;
+        SAIL_LOG_TRACE("TIFF: Writing %ux%u tiles", save_tuning->tile_size, save_tuning->tile_size);
+    } else if (strcmp(key, "tiff-pyramid-levels") == 0) {
+        save_tuning->pyramid_levels = number;
+        SAIL_LOG_TRACE("TIFF: Writing %u reduced-resolution levels", save_tuning->pyramid_levels);
+    } else if (strcmp(key, "tiff-threads") == 0) {
+        if (number > 0) {
+            save_tuning->threads = number;
+            SAIL_LOG_TRACE("TIFF: Encoding in %u threads", save_tuning->threads);
+        }
+    }
+
+    return true;
+}
+
+bool tiff_private_pixel_format_to_layout(enum SailPixelFormat pixel_format, uint16_t *photometric, uint16_t *bits_per_sample,
+                                         uint16_t *samples_per_pixel, uint16_t *extra_sample) {
+
+    *extra_sample = EXTRASAMPLE_UNSPECIFIED;
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: {
+            *photometric = PHOTOMETRIC_MINISBLACK; *bits_per_sample = 8; *samples_per_pixel = 1;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE: {
+            *photometric = PHOTOMETRIC_MINISBLACK; *bits_per_sample = 16; *samples_per_pixel = 1;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_RGB: {
+            *photometric = PHOTOMETRIC_RGB; *bits_per_sample = 8; *samples_per_pixel = 3;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP48_RGB: {
+            *photometric = PHOTOMETRIC_RGB; *bits_per_sample = 16; *samples_per_pixel = 3;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: {
+            *photometric = PHOTOMETRIC_RGB; *bits_per_sample = 8; *samples_per_pixel = 4; *extra_sample = EXTRASAMPLE_UNASSALPHA;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA: {
+            *photometric = PHOTOMETRIC_RGB; *bits_per_sample = 16; *samples_per_pixel = 4; *extra_sample = EXTRASAMPLE_UNASSALPHA;
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+void tiff_private_copy_tile(const struct sail_image *image, unsigned x, unsigned y, unsigned tile_size, void *tile) {
+
+    const size_t bytes_per_pixel = sail_bits_per_pixel(image->pixel_format) / 8;
+    const size_t tile_row_bytes  = tile_size * bytes_per_pixel;
+
+    const unsigned rows    = (image->height - y < tile_size) ? image->height - y : tile_size;
+    const unsigned columns = (image->width - x < tile_size) ? image->width - x : tile_size;
+    const size_t length    = columns * bytes_per_pixel;
+
+    unsigned char *tile_row = tile;
+
+    for (unsigned row = 0; row < rows; row++, tile_row += tile_row_bytes) {
+        memcpy(tile_row, (const unsigned char *)sail_scan_line(image, y + row) + x * bytes_per_pixel, length);
+        memset(tile_row + length, 0, tile_row_bytes - length);
+    }
+
+    memset(tile_row, 0, (tile_size - rows) * tile_row_bytes);
+}
+
+sail_status_t tiff_private_downscale_half(const struct sail_image *image, struct sail_image **reduced) {
+
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(reduced);
+
+    uint16_t photometric;
+    uint16_t bits_per_sample;
+    uint16_t samples_per_pixel;
+    uint16_t extra_sample;
+
+    if (!tiff_private_pixel_format_to_layout(image->pixel_format, &photometric, &bits_per_sample, &samples_per_pixel, &extra_sample)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    struct sail_image *reduced_local;
+    SAIL_TRY(sail_alloc_image(&reduced_local));
+
+    reduced_local->width          = (image->width + 1) / 2;
+    reduced_local->height         = (image->height + 1) / 2;
+    reduced_local->pixel_format   = image->pixel_format;
+    reduced_local->bytes_per_line = sail_bytes_per_line(reduced_local->width, reduced_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)reduced_local->bytes_per_line * reduced_local->height, &reduced_local->pixels),
+                        /* cleanup */ sail_destroy_image(reduced_local));
+
+    for (unsigned row = 0; row < reduced_local->height; row++) {
+        /* Repeat the last row and column of odd-sized images. */
+        const unsigned src_row1 = row * 2;
+        const unsigned src_row2 = (src_row1 + 1 < image->height) ? src_row1 + 1 : src_row1;
+
+        const unsigned char *scan1 = sail_scan_line(image, src_row1);
+        const unsigned char *scan2 = sail_scan_line(image, src_row2);
+        unsigned char *dst_scan    = sail_scan_line(reduced_local, row);
+
+        for (unsigned column = 0; column < reduced_local->width; column++) {
+            const unsigned src_column1 = column * 2;
+            const unsigned src_column2 = (src_column1 + 1 < image->width) ? src_column1 + 1 : src_column1;
+
+            for (unsigned sample = 0; sample < samples_per_pixel; sample++) {
+                const size_t index1 = (size_t)src_column1 * samples_per_pixel + sample;
+                const size_t index2 = (size_t)src_column2 * samples_per_pixel + sample;
+                const size_t index  = (size_t)column * samples_per_pixel + sample;
+
+                if (bits_per_sample == 16) {
+                    const uint16_t *src1 = (const uint16_t *)scan1;
+                    const uint16_t *src2 = (const uint16_t *)scan2;
+
+                    ((uint16_t *)dst_scan)[index] = (uint16_t)(((uint32_t)src1[index1] + src1[index2] + src2[index1] + src2[index2] + 2) / 4);
+                } else {
+                    dst_scan[index] = (unsigned char)(((unsigned)scan1[index1] + scan1[index2] + scan2[index1] + scan2[index2] + 2) / 4);
+                }
+            }
+        }
+    }
+
+    *reduced = reduced_local;
+
+    return SAIL_OK;
+}
@@ -27,6 +27,7 @@
 #define SAIL_TIFF_HELPERS_H
 
 #include <stdarg.h>
+#include <stdbool.h>
 #include <stdio.h>
 
 #include <tiffio.h>
@@ -35,8 +36,12 @@
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
+struct sail_image;
+struct sail_io;
 struct sail_meta_data_node;
+struct sail_palette;
 struct sail_resolution;
+struct sail_variant;
 
 SAIL_HIDDEN void tiff_private_my_error_fn(const char *module, const char *format, va_list ap);
 
@@ -60,4 +65,55 @@ SAIL_HIDDEN sail_status_t tiff_private_fetch_resolution(TIFF *tiff, struct sail_
 
 SAIL_HIDDEN sail_status_t tiff_private_write_resolution(TIFF *tiff, const struct sail_resolution *resolution);
 
+SAIL_HIDDEN sail_status_t tiff_private_will_need_striles(TIFF *tiff);
+
+/*
+ * Returns the pixel format the current directory can be decoded into without TIFFRGBAImage,
+ * or SAIL_PIXEL_FORMAT_UNKNOWN if it needs the RGBA fallback. 'min_is_white' is set to true
+ * for grayscale images that must be inverted after decoding.
+ */
+SAIL_HIDDEN enum SailPixelFormat tiff_private_native_pixel_format(TIFF *tiff, bool *min_is_white);
+
+SAIL_HIDDEN sail_status_t tiff_private_fetch_palette(TIFF *tiff, struct sail_palette **palette);
+
+/*
+ * Decodes the strips or tiles of the current directory into the image pixels as is.
+ * The image must have the pixel format returned by tiff_private_native_pixel_format().
+ * Decompresses them in the specified number of threads when the compression allows it.
+ * Checks the cancellation token between strips, rows of tiles, or batches.
+ */
+SAIL_HIDDEN sail_status_t tiff_private_read_native(TIFF *tiff, struct sail_image *image, bool min_is_white, unsigned threads,
+                                                   const struct sail_cancellation *cancellation);
+
+/* 'user_data' must point to an unsigned number of decoding threads. */
+SAIL_HIDDEN bool tiff_private_load_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+struct tiff_private_save_tuning {
+    /* Tile width and height, or 0 to write strips. */
+    unsigned tile_size;
+    /* The number of reduced-resolution levels written after every frame. */
+    unsigned pyramid_levels;
+    unsigned threads;
+};
+
+/* 'user_data' must point to struct tiff_private_save_tuning. */
+SAIL_HIDDEN bool tiff_private_save_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+/*
+ * Returns the TIFF sample layout of the pixel format, or false if the pixel format
+ * is not supported for saving. 'extra_sample' is set to EXTRASAMPLE_UNSPECIFIED
+ * when there is no alpha.
+ */
+SAIL_HIDDEN bool tiff_private_pixel_format_to_layout(enum SailPixelFormat pixel_format, uint16_t *photometric, uint16_t *bits_per_sample,
+                                                     uint16_t *samples_per_pixel, uint16_t *extra_sample);
+
+/* Copies the tile at the specified pixel position into a buffer of tile_size*tile_size pixels padding it with zeros. */
+SAIL_HIDDEN void tiff_private_copy_tile(const struct sail_image *image, unsigned x, unsigned y, unsigned tile_size, void *tile);
+
+/*
+ * Allocates a new image of half the size of the specified image averaging every 2x2 block of pixels.
+ * Supports the pixel formats accepted by tiff_private_pixel_format_to_layout().
+ */
+SAIL_HIDDEN sail_status_t tiff_private_downscale_half(const struct sail_image *image, struct sail_image **reduced);
+
 #endif
@@ -0,0 +1,593 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <tiffio.h>
+#include <zlib.h>
+
+#include <sail-common/sail-common.h>
+
+#include "helpers.h"
+#include "parallel.h"
+
+/*
+ * Private functions.
+ */
+
+/* Every worker gets consecutive strips or tiles with at least this number of compressed bytes per batch. */
+#define RAW_BYTES_PER_WORKER ((uint64_t)4 << 20)
+
+/* zlib counts bytes in unsigned ints, so feed it in pieces. */
+#define ZLIB_MAX_PIECE ((size_t)1 << 30)
+
+struct decoder {
+
+    const struct sail_image *image;
+    bool tiled;
+    uint32_t strile_width;
+    uint32_t strile_height;
+    uint32_t striles_across;
+    size_t strile_row_bytes;
+    size_t strile_size;
+    uint16_t compression;
+    uint16_t predictor;
+    uint16_t bits_per_sample;
+    uint16_t samples_per_pixel;
+    bool byte_swapped;
+};
+
+struct encoder {
+
+    const struct sail_image *image;
+    unsigned tile_size;
+    uint32_t tiles_across;
+    size_t tile_bytes;
+    size_t compressed_bound;
+};
+
+struct worker {
+
+    const struct decoder *decoder;
+    const struct encoder *encoder;
+
+    uint32_t first_strile;
+    uint32_t striles;
+
+    /* Decoding: raw bytes of consecutive striles. Encoding: compressed tiles, compressed_bound bytes apart. */
+    uint8_t *raw;
+    size_t raw_capacity;
+    uint64_t *raw_sizes;
+    uint64_t *raw_sizes_storage;
+
+    /* Tiles are decoded here and then clipped into the image, or copied from the image here and compressed. */
+    uint8_t *tile;
+
+    sail_status_t status;
+
+    void (*routine)(struct worker *worker);
+};
+
+static sail_status_t inflate_strile(const uint8_t *raw, size_t raw_size, uint8_t *output, size_t output_size) {
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+
+    if (inflateInit(&stream) != Z_OK) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    stream.next_in  = (Bytef *)raw;
+    stream.next_out = output;
+
+    size_t raw_left    = raw_size;
+    size_t output_left = output_size;
+
+    while (output_left > 0) {
+        if (stream.avail_in == 0) {
+            stream.avail_in = (uInt)(raw_left < ZLIB_MAX_PIECE ? raw_left : ZLIB_MAX_PIECE);
+            raw_left -= stream.avail_in;
+        }
+
+        stream.avail_out = (uInt)(output_left < ZLIB_MAX_PIECE ? output_left : ZLIB_MAX_PIECE);
+        const uInt avail_out = stream.avail_out;
+
+        const int ret = inflate(&stream, Z_NO_FLUSH);
+        output_left -= avail_out - stream.avail_out;
+
+        if (ret == Z_STREAM_END) {
+            break;
+        }
+        if (ret != Z_OK || (stream.avail_in == 0 && raw_left == 0 && stream.avail_out > 0)) {
+            inflateEnd(&stream);
+            SAIL_LOG_ERROR("TIFF: Failed to inflate the strip or tile: %s", stream.msg != NULL ? stream.msg : "not enough data");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+    }
+
+    inflateEnd(&stream);
+
+    if (output_left > 0) {
+        SAIL_LOG_ERROR("TIFF: Not enough data in the strip or tile, %zu bytes are missing", output_left);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
+/* Swaps 16-bit samples into the host byte order and undoes the horizontal predictor like libtiff does. */
+static void post_decode(const struct decoder *decoder, uint8_t *data, unsigned rows, size_t row_bytes, unsigned width) {
+
+    const unsigned samples = width * decoder->samples_per_pixel;
+
+    for (unsigned row = 0; row < rows; row++) {
+        uint8_t *scan = data + row * row_bytes;
+
+        if (decoder->bits_per_sample == 16) {
+            uint16_t *scan16 = (uint16_t *)scan;
+
+            if (decoder->byte_swapped) {
+                for (unsigned i = 0; i < samples; i++) {
+                    scan16[i] = (uint16_t)((scan16[i] << 8) | (scan16[i] >> 8));
+                }
+            }
+
+            if (decoder->predictor == PREDICTOR_HORIZONTAL) {
+                for (unsigned i = decoder->samples_per_pixel; i < samples; i++) {
+                    scan16[i] = (uint16_t)(scan16[i] + scan16[i - decoder->samples_per_pixel]);
+                }
+            }
+        } else if (decoder->predictor == PREDICTOR_HORIZONTAL) {
+            for (unsigned i = decoder->samples_per_pixel; i < samples; i++) {
+                scan[i] = (uint8_t)(scan[i] + scan[i - decoder->samples_per_pixel]);
+            }
+        }
+    }
+}
+
+static sail_status_t decode_strile(const struct decoder *decoder, uint8_t *tile, uint32_t strile,
+                                   const uint8_t *raw, size_t raw_size) {
+
+    const struct sail_image *image = decoder->image;
+
+    const unsigned x = decoder->tiled ? (strile % decoder->striles_across) * decoder->strile_width : 0;
+    const unsigned y = decoder->tiled ? (strile / decoder->striles_across) * decoder->strile_height : strile * decoder->strile_height;
+
+    if (x >= image->width || y >= image->height) {
+        return SAIL_OK;
+    }
+
+    const unsigned rows = (image->height - y < decoder->strile_height) ? image->height - y : decoder->strile_height;
+
+    /* Strips are decoded right into the image pixels. Tiles are decoded in full and then clipped. */
+    uint8_t *output          = decoder->tiled ? tile : sail_scan_line(image, y);
+    const size_t output_size = decoder->tiled ? decoder->strile_size : (size_t)rows * decoder->strile_row_bytes;
+
+    if (raw_size == 0) {
+        /* Sparse files leave missing striles out. */
+        memset(output, 0, output_size);
+    } else if (decoder->compression == COMPRESSION_NONE) {
+        if (raw_size < output_size) {
+            SAIL_LOG_ERROR("TIFF: Not enough data in the strip or tile #%u", strile);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        memcpy(output, raw, output_size);
+    } else {
+        SAIL_TRY(inflate_strile(raw, raw_size, output, output_size));
+    }
+
+    post_decode(decoder,
+                output,
+                decoder->tiled ? decoder->strile_height : rows,
+                decoder->strile_row_bytes,
+                decoder->tiled ? decoder->strile_width : image->width);
+
+    if (decoder->tiled) {
+        const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+        const unsigned columns        = (image->width - x < decoder->strile_width) ? image->width - x : decoder->strile_width;
+
+        /* Tile widths are multiples of 16, so tiles always start on a byte boundary. */
+        const size_t offset = (size_t)x * bits_per_pixel / 8;
+        const size_t length = ((size_t)columns * bits_per_pixel + 7) / 8;
+
+        for (unsigned row = 0; row < rows; row++) {
+            memcpy((uint8_t *)sail_scan_line(image, y + row) + offset, tile + row * decoder->strile_row_bytes, length);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static void decode_worker(struct worker *worker) {
+
+    const uint8_t *raw = worker->raw;
+
+    for (uint32_t i = 0; i < worker->striles; i++) {
+        worker->status = decode_strile(worker->decoder, worker->tile, worker->first_strile + i, raw, (size_t)worker->raw_sizes[i]);
+
+        if (worker->status != SAIL_OK) {
+            return;
+        }
+
+        raw += worker->raw_sizes[i];
+    }
+
+    worker->status = SAIL_OK;
+}
+
+static void encode_worker(struct worker *worker) {
+
+    const struct encoder *encoder = worker->encoder;
+
+    for (uint32_t i = 0; i < worker->striles; i++) {
+        const uint32_t tile = worker->first_strile + i;
+
+        tiff_private_copy_tile(encoder->image,
+                               (tile % encoder->tiles_across) * encoder->tile_size,
+                               (tile / encoder->tiles_across) * encoder->tile_size,
+                               encoder->tile_size,
+                               worker->tile);
+
+        uLongf compressed_size = (uLongf)encoder->compressed_bound;
+
+        /* libtiff uses the default zlib compression level unless told otherwise. */
+        if (compress2(worker->raw + i * encoder->compressed_bound, &compressed_size,
+                      worker->tile, (uLong)encoder->tile_bytes, Z_DEFAULT_COMPRESSION) != Z_OK) {
+            SAIL_LOG_ERROR("TIFF: Failed to deflate the tile #%u", tile);
+            worker->status = SAIL_ERROR_UNDERLYING_CODEC;
+            return;
+        }
+
+        worker->raw_sizes[i] = compressed_size;
+    }
+
+    worker->status = SAIL_OK;
+}
+
+static void worker_task(void *user_data, unsigned task, unsigned thread) {
+
+    (void)thread;
+
+    struct worker *workers = user_data;
+    workers[task].routine(&workers[task]);
+}
+
+/* Runs the routine in all workers on the thread pool. */
+static void run_workers(struct worker *workers, unsigned workers_count, void (*routine)(struct worker *worker)) {
+
+    for (unsigned i = 0; i < workers_count; i++) {
+        workers[i].routine = routine;
+    }
+
+    sail_thread_pool_run(workers_count, worker_task, workers);
+}
+
+/* Reads the raw bytes of the worker striles serially as the TIFF handle is not thread-safe. */
+static sail_status_t read_raw_striles(TIFF *tiff, bool tiled, struct worker *worker) {
+
+    uint64_t total = 0;
+
+    for (uint32_t i = 0; i < worker->striles; i++) {
+        total += worker->raw_sizes[i];
+    }
+
+    if (total > worker->raw_capacity) {
+        void *ptr = worker->raw;
+        SAIL_TRY(sail_realloc((size_t)total, &ptr));
+        worker->raw          = ptr;
+        worker->raw_capacity = (size_t)total;
+    }
+
+    uint8_t *raw = worker->raw;
+
+    for (uint32_t i = 0; i < worker->striles; i++) {
+        const uint32_t strile = worker->first_strile + i;
+        const tmsize_t size   = (tmsize_t)worker->raw_sizes[i];
+
+        if (size == 0) {
+            continue;
+        }
+
+        const tmsize_t read = tiled ? TIFFReadRawTile(tiff, strile, raw, size) : TIFFReadRawStrip(tiff, strile, raw, size);
+
+        if (read != size) {
+            SAIL_LOG_ERROR("TIFF: Failed to read the raw strip or tile #%u", strile);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        raw += size;
+    }
+
+    return SAIL_OK;
+}
+
+static void destroy_workers(struct worker *workers, unsigned workers_count) {
+
+    for (unsigned i = 0; i < workers_count; i++) {
+        sail_free(workers[i].raw);
+        sail_free(workers[i].tile);
+        sail_free(workers[i].raw_sizes_storage);
+    }
+
+    sail_free(workers);
+}
+
+/*
+ * Public functions.
+ */
+
+bool tiff_private_can_decode_in_parallel(TIFF *tiff) {
+
+    uint16_t compression;
+    uint16_t predictor;
+    uint16_t fill_order;
+    uint16_t bits_per_sample;
+
+    if (!TIFFGetFieldDefaulted(tiff, TIFFTAG_COMPRESSION, &compression) ||
+            !TIFFGetFieldDefaulted(tiff, TIFFTAG_FILLORDER, &fill_order) ||
+            !TIFFGetFieldDefaulted(tiff, TIFFTAG_BITSPERSAMPLE, &bits_per_sample)) {
+        return false;
+    }
+
+    if (compression != COMPRESSION_NONE && compression != COMPRESSION_DEFLATE && compression != COMPRESSION_ADOBE_DEFLATE) {
+        return false;
+    }
+
+    if (fill_order != FILLORDER_MSB2LSB) {
+        return false;
+    }
+
+    if (compression == COMPRESSION_NONE) {
+        return true;
+    }
+
+    if (!TIFFGetFieldDefaulted(tiff, TIFFTAG_PREDICTOR, &predictor)) {
+        return false;
+    }
+
+    return predictor == PREDICTOR_NONE || (predictor == PREDICTOR_HORIZONTAL && (bits_per_sample == 8 || bits_per_sample == 16));
+}
+
+sail_status_t tiff_private_read_native_parallel(TIFF *tiff, struct sail_image *image, unsigned threads,
+                                                const struct sail_cancellation *cancellation) {
+
+    SAIL_CHECK_PTR(image);
+
+    struct decoder decoder;
+    memset(&decoder, 0, sizeof(decoder));
+
+    decoder.image        = image;
+    decoder.tiled        = TIFFIsTiled(tiff);
+    decoder.byte_swapped = TIFFIsByteSwapped(tiff);
+    decoder.predictor    = PREDICTOR_NONE;
+
+    TIFFGetFieldDefaulted(tiff, TIFFTAG_COMPRESSION, &decoder.compression);
+    TIFFGetFieldDefaulted(tiff, TIFFTAG_BITSPERSAMPLE, &decoder.bits_per_sample);
+    TIFFGetFieldDefaulted(tiff, TIFFTAG_SAMPLESPERPIXEL, &decoder.samples_per_pixel);
+
+    if (decoder.compression != COMPRESSION_NONE) {
+        TIFFGetFieldDefaulted(tiff, TIFFTAG_PREDICTOR, &decoder.predictor);
+    }
+
+    uint32_t striles_count;
+
+    if (decoder.tiled) {
+        if (!TIFFGetField(tiff, TIFFTAG_TILEWIDTH, &decoder.strile_width) || !TIFFGetField(tiff, TIFFTAG_TILELENGTH, &decoder.strile_height) ||
+                decoder.strile_width == 0 || decoder.strile_height == 0) {
+            SAIL_LOG_ERROR("TIFF: Failed to get the tile dimensions");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        decoder.striles_across   = (image->width + decoder.strile_width - 1) / decoder.strile_width;
+        decoder.strile_row_bytes = (size_t)TIFFTileRowSize(tiff);
+        decoder.strile_size      = (size_t)TIFFTileSize(tiff);
+        striles_count            = TIFFNumberOfTiles(tiff);
+    } else {
+        uint32_t rows_per_strip;
+        if (!TIFFGetFieldDefaulted(tiff, TIFFTAG_ROWSPERSTRIP, &rows_per_strip) || rows_per_strip == 0 || rows_per_strip > image->height) {
+            rows_per_strip = image->height;
+        }
+
+        decoder.strile_width     = image->width;
+        decoder.strile_height    = rows_per_strip;
+        decoder.strile_row_bytes = image->bytes_per_line;
+        striles_count            = TIFFNumberOfStrips(tiff);
+    }
+
+    if (striles_count == 0) {
+        SAIL_LOG_ERROR("TIFF: The image has no strips or tiles");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    const unsigned workers_count = (threads == 0) ? 1 : (threads > striles_count ? striles_count : threads);
+
+    void *ptr;
+    SAIL_TRY(sail_calloc(workers_count, sizeof(struct worker), &ptr));
+    struct worker *workers = ptr;
+
+    for (unsigned i = 0; i < workers_count; i++) {
+        workers[i].decoder = &decoder;
+        workers[i].status  = SAIL_ERROR_UNDERLYING_CODEC;
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc((size_t)striles_count * sizeof(uint64_t), &ptr),
+                        /* cleanup */ destroy_workers(workers, workers_count));
+    uint64_t *raw_sizes = ptr;
+
+    for (uint32_t strile = 0; strile < striles_count; strile++) {
+        raw_sizes[strile] = TIFFGetStrileByteCount(tiff, strile);
+    }
+
+    if (decoder.tiled) {
+        for (unsigned i = 0; i < workers_count; i++) {
+            SAIL_TRY_OR_CLEANUP(sail_malloc(decoder.strile_size, &ptr),
+                                /* cleanup */ sail_free(raw_sizes), destroy_workers(workers, workers_count));
+            workers[i].tile = ptr;
+        }
+    }
+
+    /* Read a batch of raw striles serially, then decompress it in parallel. */
+    uint32_t next_strile = 0;
+
+    while (next_strile < striles_count) {
+        unsigned active_workers = 0;
+
+        SAIL_TRY_OR_CLEANUP(sail_check_cancellation(cancellation),
+                            /* cleanup */ sail_free(raw_sizes), destroy_workers(workers, workers_count));
+
+        for (unsigned i = 0; i < workers_count && next_strile < striles_count; i++) {
+            struct worker *worker = &workers[i];
+
+            worker->first_strile = next_strile;
+            worker->striles      = 0;
+            worker->raw_sizes    = raw_sizes + next_strile;
+
+            uint64_t raw_bytes = 0;
+
+            while (next_strile < striles_count && (worker->striles == 0 || raw_bytes < RAW_BYTES_PER_WORKER)) {
+                raw_bytes += raw_sizes[next_strile++];
+                worker->striles++;
+            }
+
+            SAIL_TRY_OR_CLEANUP(read_raw_striles(tiff, decoder.tiled, worker),
+                                /* cleanup */ sail_free(raw_sizes), destroy_workers(workers, workers_count));
+
+            active_workers++;
+        }
+
+        run_workers(workers, active_workers, decode_worker);
+
+        for (unsigned i = 0; i < active_workers; i++) {
+            SAIL_TRY_OR_CLEANUP(workers[i].status,
+                                /* cleanup */ sail_free(raw_sizes), destroy_workers(workers, workers_count));
+        }
+    }
+
+    sail_free(raw_sizes);
+    destroy_workers(workers, workers_count);
+
+    return SAIL_OK;
+}
+
+bool tiff_private_can_encode_in_parallel(int compression) {
+
+    return compression == COMPRESSION_DEFLATE || compression == COMPRESSION_ADOBE_DEFLATE;
+}
+
+sail_status_t tiff_private_write_tiles_parallel(TIFF *tiff, const struct sail_image *image, unsigned tile_size, unsigned threads,
+                                                const struct sail_cancellation *cancellation) {
+
+    SAIL_CHECK_PTR(image);
+
+    struct encoder encoder;
+
+    encoder.image            = image;
+    encoder.tile_size        = tile_size;
+    encoder.tiles_across     = (image->width + tile_size - 1) / tile_size;
+    encoder.tile_bytes       = (size_t)TIFFTileSize(tiff);
+    encoder.compressed_bound = compressBound((uLong)encoder.tile_bytes);
+
+    const uint32_t tiles_count = TIFFNumberOfTiles(tiff);
+
+    if (tiles_count == 0) {
+        SAIL_LOG_ERROR("TIFF: The image has no tiles");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    const unsigned workers_count = (threads == 0) ? 1 : (threads > tiles_count ? tiles_count : threads);
+
+    /* Every worker compresses a few tiles per batch to amortize starting threads. */
+    const uint64_t tiles_per_worker64 = RAW_BYTES_PER_WORKER / encoder.tile_bytes;
+    const uint32_t tiles_per_worker   = (tiles_per_worker64 == 0) ? 1 : (uint32_t)tiles_per_worker64;
+
+    void *ptr;
+    SAIL_TRY(sail_calloc(workers_count, sizeof(struct worker), &ptr));
+    struct worker *workers = ptr;
+
+    for (unsigned i = 0; i < workers_count; i++) {
+        struct worker *worker = &workers[i];
+
+        worker->encoder = &encoder;
+        worker->status  = SAIL_ERROR_UNDERLYING_CODEC;
+
+        SAIL_TRY_OR_CLEANUP(sail_malloc(encoder.tile_bytes, &ptr),
+                            /* cleanup */ destroy_workers(workers, workers_count));
+        worker->tile = ptr;
+
+        SAIL_TRY_OR_CLEANUP(sail_malloc(tiles_per_worker * encoder.compressed_bound, &ptr),
+                            /* cleanup */ destroy_workers(workers, workers_count));
+        worker->raw = ptr;
+
+        SAIL_TRY_OR_CLEANUP(sail_malloc(tiles_per_worker * sizeof(uint64_t), &ptr),
+                            /* cleanup */ destroy_workers(workers, workers_count));
+        worker->raw_sizes_storage = ptr;
+        worker->raw_sizes         = worker->raw_sizes_storage;
+    }
+
+    /* Compress a batch of tiles in parallel, then write them serially in order. */
+    uint32_t next_tile = 0;
+
+    while (next_tile < tiles_count) {
+        unsigned active_workers = 0;
+
+        SAIL_TRY_OR_CLEANUP(sail_check_cancellation(cancellation),
+                            /* cleanup */ destroy_workers(workers, workers_count));
+
+        for (unsigned i = 0; i < workers_count && next_tile < tiles_count; i++) {
+            workers[i].first_strile = next_tile;
+            workers[i].striles      = (tiles_count - next_tile < tiles_per_worker) ? tiles_count - next_tile : tiles_per_worker;
+
+            next_tile += workers[i].striles;
+            active_workers++;
+        }
+
+        run_workers(workers, active_workers, encode_worker);
+
+        for (unsigned i = 0; i < active_workers; i++) {
+            const struct worker *worker = &workers[i];
+
+            SAIL_TRY_OR_CLEANUP(worker->status,
+                                /* cleanup */ destroy_workers(workers, workers_count));
+
+            for (uint32_t t = 0; t < worker->striles; t++) {
+                const tmsize_t size = (tmsize_t)worker->raw_sizes[t];
+
+                if (TIFFWriteRawTile(tiff, worker->first_strile + t, worker->raw + t * encoder.compressed_bound, size) != size) {
+                    destroy_workers(workers, workers_count);
+                    SAIL_LOG_ERROR("TIFF: Failed to write the tile #%u", worker->first_strile + t);
+                    SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+                }
+            }
+        }
+    }
+
+    destroy_workers(workers, workers_count);
+
+    return SAIL_OK;
+}
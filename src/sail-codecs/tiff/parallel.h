@@ -0,0 +1,68 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_TIFF_PARALLEL_H
+#define SAIL_TIFF_PARALLEL_H
+
+#include <stdbool.h>
+
+#include <tiffio.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_cancellation;
+struct sail_image;
+
+/*
+ * Returns true if the strips or tiles of the current directory can be decompressed
+ * without libtiff by tiff_private_read_native_parallel().
+ */
+SAIL_HIDDEN bool tiff_private_can_decode_in_parallel(TIFF *tiff);
+
+/*
+ * Reads the raw strips or tiles of the current directory in batches and decompresses
+ * every batch in the specified number of threads right into the image pixels.
+ * The image must have the pixel format returned by tiff_private_native_pixel_format().
+ * Checks the cancellation token between batches.
+ */
+SAIL_HIDDEN sail_status_t tiff_private_read_native_parallel(TIFF *tiff, struct sail_image *image, unsigned threads,
+                                                            const struct sail_cancellation *cancellation);
+
+/*
+ * Returns true if tiles compressed with the specified TIFF compression can be written
+ * by tiff_private_write_tiles_parallel().
+ */
+SAIL_HIDDEN bool tiff_private_can_encode_in_parallel(int compression);
+
+/*
+ * Compresses the tiles of the image in batches in the specified number of threads,
+ * and writes them into the current directory in order. The directory must be set up
+ * for tiles of tile_size*tile_size pixels. Checks the cancellation token between batches.
+ */
+SAIL_HIDDEN sail_status_t tiff_private_write_tiles_parallel(TIFF *tiff, const struct sail_image *image, unsigned tile_size, unsigned threads,
+                                                            const struct sail_cancellation *cancellation);
+
+#endif
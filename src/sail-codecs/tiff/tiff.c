@@ -35,6 +35,10 @@
 #include "helpers.h"
 #include "io.h"
 
+#ifdef SAIL_HAVE_TIFF_PARALLEL
+    #include "parallel.h"
+#endif
+
 /*
  * Codec-specific state.
  */
@@ -43,11 +47,24 @@ struct tiff_state {
     const struct sail_save_options *save_options;
 
     TIFF *tiff;
-    uint16_t current_frame;
+    unsigned current_frame;
+
+    /* Offsets of the directories found so far, and the index of the directory libtiff has read. */
+    uint64_t *directory_offsets;
+    unsigned directory_offsets_count;
+    unsigned directory_offsets_capacity;
+    unsigned directory;
     bool libtiff_error;
     int save_compression;
     TIFFRGBAImage image;
-    int line;
+    struct tiff_private_save_tuning save_tuning;
+
+    /* Decode the current frame as is without TIFFRGBAImage. */
+    bool native;
+    bool min_is_white;
+
+    /* The number of threads to decompress strips and tiles in. */
+    unsigned threads;
 };
 
 static sail_status_t alloc_tiff_state(const struct sail_load_options *load_options,
@@ -64,9 +81,18 @@ static sail_status_t alloc_tiff_state(const struct sail_load_options *load_optio
 
         .tiff             = NULL,
         .current_frame    = 0,
+
+        .directory_offsets          = NULL,
+        .directory_offsets_count    = 0,
+        .directory_offsets_capacity = 0,
+        .directory                  = 0,
         .libtiff_error    = false,
         .save_compression = COMPRESSION_NONE,
-        .line             = 0,
+        .save_tuning      = { 0, 0, 1 },
+
+        .native       = false,
+        .min_is_white = false,
+        .threads      = 1,
     };
 
     tiff_private_zero_tiff_image(&(*tiff_state)->image);
@@ -82,9 +108,165 @@ static void destroy_tiff_state(struct tiff_state *tiff_state) {
 
     TIFFRGBAImageEnd(&tiff_state->image);
 
+    sail_free(tiff_state->directory_offsets);
+
     sail_free(tiff_state);
 }
 
+static sail_status_t remember_directory_offset(struct tiff_state *tiff_state) {
+
+    if (tiff_state->directory_offsets_count == tiff_state->directory_offsets_capacity) {
+        const unsigned capacity = (tiff_state->directory_offsets_capacity == 0) ? 16 : tiff_state->directory_offsets_capacity * 2;
+
+        void *ptr = tiff_state->directory_offsets;
+        SAIL_TRY(sail_realloc(capacity * sizeof(uint64_t), &ptr));
+
+        tiff_state->directory_offsets          = ptr;
+        tiff_state->directory_offsets_capacity = capacity;
+    }
+
+    tiff_state->directory_offsets[tiff_state->directory_offsets_count++] = TIFFCurrentDirOffset(tiff_state->tiff);
+
+    return SAIL_OK;
+}
+
+/*
+ * Reads the directory with the specified index. Known directories are read from their cached offsets.
+ * Unknown directories are found by walking the chain from the last known one, so reading directories
+ * in order never walks the chain from the beginning like TIFFSetDirectory() does.
+ */
+static sail_status_t read_directory(struct tiff_state *tiff_state, unsigned index) {
+
+    if (index < tiff_state->directory_offsets_count) {
+        if (!TIFFSetSubDirectory(tiff_state->tiff, tiff_state->directory_offsets[index])) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        tiff_state->directory = index;
+
+        return SAIL_OK;
+    }
+
+    const unsigned last_known = tiff_state->directory_offsets_count - 1;
+
+    if (tiff_state->directory != last_known) {
+        if (!TIFFSetSubDirectory(tiff_state->tiff, tiff_state->directory_offsets[last_known])) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        tiff_state->directory = last_known;
+    }
+
+    while (tiff_state->directory < index) {
+        if (!TIFFReadDirectory(tiff_state->tiff)) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+        }
+
+        tiff_state->directory++;
+        SAIL_TRY(remember_directory_offset(tiff_state));
+    }
+
+    return SAIL_OK;
+}
+
+/* Sets up the current directory to save the image. */
+static sail_status_t set_directory_fields(struct tiff_state *tiff_state, const struct sail_image *image, bool reduced) {
+
+    uint16_t photometric;
+    uint16_t bits_per_sample;
+    uint16_t samples_per_pixel;
+    uint16_t extra_sample;
+
+    if (!tiff_private_pixel_format_to_layout(image->pixel_format, &photometric, &bits_per_sample, &samples_per_pixel, &extra_sample)) {
+        SAIL_LOG_ERROR("TIFF: %s pixel format is not currently supported for saving", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    if (reduced) {
+        TIFFSetField(tiff_state->tiff, TIFFTAG_SUBFILETYPE, FILETYPE_REDUCEDIMAGE);
+    }
+
+    TIFFSetField(tiff_state->tiff, TIFFTAG_IMAGEWIDTH,  image->width);
+    TIFFSetField(tiff_state->tiff, TIFFTAG_IMAGELENGTH, image->height);
+    TIFFSetField(tiff_state->tiff, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+    TIFFSetField(tiff_state->tiff, TIFFTAG_SAMPLESPERPIXEL, samples_per_pixel);
+    TIFFSetField(tiff_state->tiff, TIFFTAG_BITSPERSAMPLE, bits_per_sample);
+    TIFFSetField(tiff_state->tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+    TIFFSetField(tiff_state->tiff, TIFFTAG_PHOTOMETRIC, photometric);
+    TIFFSetField(tiff_state->tiff, TIFFTAG_COMPRESSION, tiff_state->save_compression);
+
+    if (extra_sample != EXTRASAMPLE_UNSPECIFIED) {
+        TIFFSetField(tiff_state->tiff, TIFFTAG_EXTRASAMPLES, 1, &extra_sample);
+    }
+
+    if (tiff_state->save_tuning.tile_size > 0) {
+        TIFFSetField(tiff_state->tiff, TIFFTAG_TILEWIDTH,  tiff_state->save_tuning.tile_size);
+        TIFFSetField(tiff_state->tiff, TIFFTAG_TILELENGTH, tiff_state->save_tuning.tile_size);
+    } else {
+        TIFFSetField(tiff_state->tiff, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tiff_state->tiff, (uint32_t)-1));
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_tiles(struct tiff_state *tiff_state, const struct sail_image *image) {
+
+    const unsigned tile_size = tiff_state->save_tuning.tile_size;
+
+#ifdef SAIL_HAVE_TIFF_PARALLEL
+    if (tiff_state->save_tuning.threads > 1 && tiff_private_can_encode_in_parallel(tiff_state->save_compression)) {
+        SAIL_TRY(tiff_private_write_tiles_parallel(tiff_state->tiff, image, tile_size, tiff_state->save_tuning.threads,
+                                                  tiff_state->save_options->cancellation));
+        return SAIL_OK;
+    }
+#endif
+
+    const tmsize_t tile_bytes = TIFFTileSize(tiff_state->tiff);
+
+    void *tile;
+    SAIL_TRY(sail_malloc((size_t)tile_bytes, &tile));
+
+    for (unsigned y = 0; y < image->height; y += tile_size) {
+        SAIL_TRY_OR_CLEANUP(sail_check_cancellation(tiff_state->save_options->cancellation),
+                            /* cleanup */ sail_free(tile));
+
+        for (unsigned x = 0; x < image->width; x += tile_size) {
+            tiff_private_copy_tile(image, x, y, tile_size, tile);
+
+            if (TIFFWriteEncodedTile(tiff_state->tiff, TIFFComputeTile(tiff_state->tiff, x, y, 0, 0), tile, tile_bytes) < 0) {
+                sail_free(tile);
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+        }
+    }
+
+    sail_free(tile);
+
+    return SAIL_OK;
+}
+
+/* Writes the image pixels and finishes the current directory. */
+static sail_status_t write_directory(struct tiff_state *tiff_state, const struct sail_image *image) {
+
+    if (tiff_state->save_tuning.tile_size > 0) {
+        SAIL_TRY(write_tiles(tiff_state, image));
+    } else {
+        for (unsigned row = 0; row < image->height; row++) {
+            SAIL_TRY(sail_check_cancellation(tiff_state->save_options->cancellation));
+
+            if (TIFFWriteScanline(tiff_state->tiff, sail_scan_line(image, row), row, 0) < 0) {
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+        }
+    }
+
+    if (!TIFFWriteDirectory(tiff_state->tiff)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
 /*
  * Decoding functions.
  */
@@ -123,6 +305,14 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_tiff(struct sail_io *io, const
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    /* TIFFClientOpen() reads the first directory. */
+    SAIL_TRY(remember_directory_offset(tiff_state));
+
+    /* Handle tuning. */
+    if (tiff_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(tiff_state->load_options->tuning, tiff_private_load_tuning_key_value_callback, &tiff_state->threads);
+    }
+
     return SAIL_OK;
 }
 
@@ -138,20 +328,35 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_tiff(void *state, s
     SAIL_TRY(sail_alloc_image(&image_local));
 
     /* Start reading the next directory. */
-    if (!TIFFSetDirectory(tiff_state->tiff, tiff_state->current_frame++)) {
-        sail_destroy_image(image_local);
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
-    }
+    SAIL_TRY_OR_CLEANUP(read_directory(tiff_state, tiff_state->current_frame++),
+                        /* cleanup */ sail_destroy_image(image_local));
 
-    /* Start reading the next image. */
-    char emsg[1024];
-    if (!TIFFRGBAImageBegin(&tiff_state->image, tiff_state->tiff, /* stop */ 1, emsg)) {
-        SAIL_LOG_ERROR("TIFF: %s", emsg);
-        sail_destroy_image(image_local);
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    /*
+     * Decode the source pixel format as is when it maps to a SAIL pixel format.
+     * Fall back to TIFFRGBAImage for everything else, or when RGBA was requested explicitly.
+     */
+    enum SailPixelFormat native_pixel_format = tiff_private_native_pixel_format(tiff_state->tiff, &tiff_state->min_is_white);
+
+    tiff_state->native = native_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN &&
+                            tiff_state->load_options->output_pixel_format != SAIL_PIXEL_FORMAT_BPP32_RGBA;
+
+    /* Start reading the next image. Not needed when probing as no pixels are loaded. */
+    if ((tiff_state->load_options->options & SAIL_OPTION_PROBE) == 0 && !tiff_state->native) {
+        char emsg[1024];
+        if (!TIFFRGBAImageBegin(&tiff_state->image, tiff_state->tiff, /* stop */ 1, emsg)) {
+            SAIL_LOG_ERROR("TIFF: %s", emsg);
+            sail_destroy_image(image_local);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        tiff_state->image.req_orientation = ORIENTATION_TOPLEFT;
     }
 
-    tiff_state->image.req_orientation = ORIENTATION_TOPLEFT;
+    if ((tiff_state->load_options->options & SAIL_OPTION_PROBE) == 0) {
+        /* Let I/O objects with expensive seeking fetch the pixel data in large ranges. */
+        SAIL_TRY_OR_CLEANUP(tiff_private_will_need_striles(tiff_state->tiff),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
 
     /* Fill the image properties. */
     if (!TIFFGetField(tiff_state->tiff, TIFFTAG_IMAGEWIDTH,  &image_local->width) || !TIFFGetField(tiff_state->tiff, TIFFTAG_IMAGELENGTH, &image_local->height)) {
@@ -178,9 +383,15 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_tiff(void *state, s
     SAIL_TRY_OR_CLEANUP(tiff_private_fetch_resolution(tiff_state->tiff, &image_local->resolution),
                             /* cleanup */ sail_destroy_image(image_local));
 
-    image_local->pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+    image_local->pixel_format = tiff_state->native ? native_pixel_format : SAIL_PIXEL_FORMAT_BPP32_RGBA;
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
+    /* Fetch palette. */
+    if (sail_is_indexed(image_local->pixel_format)) {
+        SAIL_TRY_OR_CLEANUP(tiff_private_fetch_palette(tiff_state->tiff, &image_local->palette),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
     /* Source image. */
     if (tiff_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
         int compression = COMPRESSION_NONE;
@@ -193,7 +404,22 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_tiff(void *state, s
         SAIL_TRY_OR_CLEANUP(sail_alloc_source_image(&image_local->source_image),
                             /* cleanup */ sail_destroy_image(image_local));
 
-        image_local->source_image->pixel_format = tiff_private_bpp_to_pixel_format(tiff_state->image.bitspersample * tiff_state->image.samplesperpixel);
+        uint16_t bits_per_sample;
+        uint16_t samples_per_pixel;
+
+        if ((tiff_state->load_options->options & SAIL_OPTION_PROBE) || tiff_state->native) {
+            if (!TIFFGetFieldDefaulted(tiff_state->tiff, TIFFTAG_BITSPERSAMPLE, &bits_per_sample) ||
+                    !TIFFGetFieldDefaulted(tiff_state->tiff, TIFFTAG_SAMPLESPERPIXEL, &samples_per_pixel)) {
+                SAIL_LOG_ERROR("TIFF: Failed to get the image bits per pixel");
+                sail_destroy_image(image_local);
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+        } else {
+            bits_per_sample   = tiff_state->image.bitspersample;
+            samples_per_pixel = tiff_state->image.samplesperpixel;
+        }
+
+        image_local->source_image->pixel_format = tiff_private_bpp_to_pixel_format(bits_per_sample * samples_per_pixel);
         image_local->source_image->compression  = tiff_private_compression_to_sail_compression(compression);
     }
 
@@ -202,6 +428,25 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_tiff(void *state, s
     return SAIL_OK;
 }
 
+SAIL_EXPORT sail_status_t sail_codec_load_seek_frame_v8_tiff(void *state, unsigned frame) {
+
+    struct tiff_state *tiff_state = state;
+
+    if (tiff_state->libtiff_error) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Drop the frame sought but not loaded. */
+    TIFFRGBAImageEnd(&tiff_state->image);
+
+    /* Find the directory now to report missing frames. It's read again in seek_next_frame(). */
+    SAIL_TRY(read_directory(tiff_state, frame));
+
+    tiff_state->current_frame = frame;
+
+    return SAIL_OK;
+}
+
 SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_tiff(void *state, struct sail_image *image) {
 
     struct tiff_state *tiff_state = state;
@@ -210,6 +455,14 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_tiff(void *state, struct sail
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
+    SAIL_TRY(sail_put_load_diagnostic_bool(tiff_state->load_options, image, "tiff-used-rgba-fallback", !tiff_state->native));
+
+    if (tiff_state->native) {
+        SAIL_TRY(tiff_private_read_native(tiff_state->tiff, image, tiff_state->min_is_white, tiff_state->threads,
+                                          tiff_state->load_options->cancellation));
+        return SAIL_OK;
+    }
+
     if (!TIFFRGBAImageGet(&tiff_state->image, image->pixels, image->width, image->height)) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
@@ -251,6 +504,11 @@ SAIL_EXPORT sail_status_t sail_codec_save_init_v8_tiff(struct sail_io *io, const
                         /* cleanup */ SAIL_LOG_ERROR("TIFF: %s compression is not supported for saving", sail_compression_to_string(tiff_state->save_options->compression));
                                       return __sail_status);
 
+    /* Handle tuning. */
+    if (tiff_state->save_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(tiff_state->save_options->tuning, tiff_private_save_tuning_key_value_callback, &tiff_state->save_tuning);
+    }
+
     TIFFSetWarningHandler(tiff_private_my_warning_fn);
     TIFFSetErrorHandler(tiff_private_my_error_fn);
 
@@ -286,17 +544,7 @@ SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_tiff(void *state, c
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    tiff_state->line = 0;
-
-    TIFFSetField(tiff_state->tiff, TIFFTAG_IMAGEWIDTH,  image->width);
-    TIFFSetField(tiff_state->tiff, TIFFTAG_IMAGELENGTH, image->height);
-    TIFFSetField(tiff_state->tiff, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
-    TIFFSetField(tiff_state->tiff, TIFFTAG_SAMPLESPERPIXEL, 4);
-    TIFFSetField(tiff_state->tiff, TIFFTAG_BITSPERSAMPLE, 8);
-    TIFFSetField(tiff_state->tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
-    TIFFSetField(tiff_state->tiff, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
-    TIFFSetField(tiff_state->tiff, TIFFTAG_COMPRESSION, tiff_state->save_compression);
-    TIFFSetField(tiff_state->tiff, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(tiff_state->tiff, (uint32_t)-1));
+    SAIL_TRY(set_directory_fields(tiff_state, image, /* reduced */ false));
 
     /* Save ICC profile. */
     if (tiff_state->save_options->options & SAIL_OPTION_ICCP && image->iccp != NULL) {
@@ -324,16 +572,29 @@ SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_tiff(void *state, const struc
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
     }
 
-    for (unsigned row = 0; row < image->height; row++) {
-        if (TIFFWriteScanline(tiff_state->tiff, sail_scan_line(image, row), tiff_state->line++, 0) < 0) {
-            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-        }
-    }
+    SAIL_TRY(write_directory(tiff_state, image));
 
-    if (!TIFFWriteDirectory(tiff_state->tiff)) {
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    /* Follow the frame with reduced-resolution levels. */
+    const struct sail_image *previous = image;
+    struct sail_image *level = NULL;
+
+    for (unsigned i = 0; i < tiff_state->save_tuning.pyramid_levels && (previous->width > 1 || previous->height > 1); i++) {
+        struct sail_image *reduced;
+        SAIL_TRY_OR_CLEANUP(tiff_private_downscale_half(previous, &reduced),
+                            /* cleanup */ sail_destroy_image(level));
+
+        sail_destroy_image(level);
+        level    = reduced;
+        previous = level;
+
+        SAIL_TRY_OR_CLEANUP(set_directory_fields(tiff_state, level, /* reduced */ true),
+                            /* cleanup */ sail_destroy_image(level));
+        SAIL_TRY_OR_CLEANUP(write_directory(tiff_state, level),
+                            /* cleanup */ sail_destroy_image(level));
     }
 
+    sail_destroy_image(level);
+
     return SAIL_OK;
 }
 
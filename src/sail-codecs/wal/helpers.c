@@ -23,6 +23,8 @@
     SOFTWARE.
 */
 
+#include <string.h>
+
 #include <sail-common/sail-common.h>
 
 #include "helpers.h"
@@ -292,14 +294,21 @@ static const unsigned char WAL_PALETTE[256 * 3] =
 
 sail_status_t wal_private_read_file_header(struct sail_io *io, struct WalFileHeader *wal_header) {
 
-    SAIL_TRY(io->strict_read(io->stream, &wal_header->name,      sizeof(wal_header->name)));
-    SAIL_TRY(io->strict_read(io->stream, &wal_header->width,     sizeof(wal_header->width)));
-    SAIL_TRY(io->strict_read(io->stream, &wal_header->height,    sizeof(wal_header->height)));
-    SAIL_TRY(io->strict_read(io->stream, &wal_header->offset,    sizeof(wal_header->offset)));
-    SAIL_TRY(io->strict_read(io->stream, &wal_header->next_name, sizeof(wal_header->next_name)));
-    SAIL_TRY(io->strict_read(io->stream, &wal_header->flags,     sizeof(wal_header->flags)));
-    SAIL_TRY(io->strict_read(io->stream, &wal_header->contents,  sizeof(wal_header->contents)));
-    SAIL_TRY(io->strict_read(io->stream, &wal_header->value,     sizeof(wal_header->value)));
+    /* Read the whole header at once and unpack it. */
+    unsigned char buffer[sizeof(wal_header->name) + sizeof(wal_header->width) + sizeof(wal_header->height) + sizeof(wal_header->offset) +
+                            sizeof(wal_header->next_name) + sizeof(wal_header->flags) + sizeof(wal_header->contents) + sizeof(wal_header->value)];
+    SAIL_TRY(io->strict_read(io->stream, buffer, sizeof(buffer)));
+
+    const unsigned char *ptr = buffer;
+
+    memcpy(&wal_header->name,      ptr, sizeof(wal_header->name));      ptr += sizeof(wal_header->name);
+    memcpy(&wal_header->width,     ptr, sizeof(wal_header->width));     ptr += sizeof(wal_header->width);
+    memcpy(&wal_header->height,    ptr, sizeof(wal_header->height));    ptr += sizeof(wal_header->height);
+    memcpy(&wal_header->offset,    ptr, sizeof(wal_header->offset));    ptr += sizeof(wal_header->offset);
+    memcpy(&wal_header->next_name, ptr, sizeof(wal_header->next_name)); ptr += sizeof(wal_header->next_name);
+    memcpy(&wal_header->flags,     ptr, sizeof(wal_header->flags));     ptr += sizeof(wal_header->flags);
+    memcpy(&wal_header->contents,  ptr, sizeof(wal_header->contents));  ptr += sizeof(wal_header->contents);
+    memcpy(&wal_header->value,     ptr, sizeof(wal_header->value));
 
     return SAIL_OK;
 }
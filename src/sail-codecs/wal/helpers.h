@@ -30,12 +30,15 @@
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
+/* The base image and three mip levels. */
+#define SAIL_WAL_MIP_LEVELS 4
+
 struct WalFileHeader
 {
     char name[32];
     unsigned width;
     unsigned height;
-    int offset[4];
+    int offset[SAIL_WAL_MIP_LEVELS];
     char next_name[32];
     unsigned flags;
     unsigned contents;
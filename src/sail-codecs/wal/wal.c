@@ -43,8 +43,6 @@ struct wal_state {
     unsigned frame_number;
 
     struct WalFileHeader wal_header;
-    unsigned width;
-    unsigned height;
 };
 
 static sail_status_t alloc_wal_state(struct sail_io *io,
@@ -61,9 +59,7 @@ static sail_status_t alloc_wal_state(struct sail_io *io,
         .load_options = load_options,
         .save_options = save_options,
 
-        .frame_number  = 0,
-        .width         = 0,
-        .height        = 0,
+        .frame_number = 0,
     };
 
     return SAIL_OK;
@@ -94,9 +90,6 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_wal(struct sail_io *io, const
     /* Read WAL header. */
     SAIL_TRY(wal_private_read_file_header(wal_state->io, &wal_state->wal_header));
 
-    wal_state->width = wal_state->wal_header.width;
-    wal_state->height = wal_state->wal_header.height;
-
     return SAIL_OK;
 }
 
@@ -104,15 +97,13 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_wal(void *state, st
 
     struct wal_state *wal_state = state;
 
-    if (wal_state->frame_number == 4) {
+    /* Tiny images have less non-empty mip levels. */
+    if (wal_state->frame_number == SAIL_WAL_MIP_LEVELS ||
+            (wal_state->wal_header.width >> wal_state->frame_number) == 0 ||
+            (wal_state->wal_header.height >> wal_state->frame_number) == 0) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
     }
 
-    if (wal_state->frame_number > 0) {
-        wal_state->width /= 2;
-        wal_state->height /= 2;
-    }
-
     struct sail_image *image_local;
     SAIL_TRY(sail_alloc_image(&image_local));
 
@@ -124,16 +115,23 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_wal(void *state, st
         image_local->source_image->compression  = SAIL_COMPRESSION_NONE;
     }
 
-    image_local->width          = wal_state->width;
-    image_local->height         = wal_state->height;
+    /* Every mip level is half the size of the previous one. */
+    image_local->width          = wal_state->wal_header.width  >> wal_state->frame_number;
+    image_local->height         = wal_state->wal_header.height >> wal_state->frame_number;
     image_local->pixel_format   = SAIL_PIXEL_FORMAT_BPP8_INDEXED;
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
     SAIL_TRY_OR_CLEANUP(wal_private_assign_palette(image_local),
                         /* cleanup */ sail_destroy_image(image_local));
-    SAIL_TRY_OR_CLEANUP(wal_private_assign_meta_data(&wal_state->wal_header, &image_local->meta_data_node),
-                        /* cleanup */ sail_destroy_image(image_local));
 
+    if (wal_state->load_options->options & SAIL_OPTION_META_DATA) {
+        SAIL_TRY_OR_CLEANUP(wal_private_assign_meta_data(&wal_state->wal_header, &image_local->meta_data_node),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_io_will_need(wal_state->io, (size_t)wal_state->wal_header.offset[wal_state->frame_number],
+                                          (size_t)image_local->bytes_per_line * image_local->height),
+                        /* cleanup */ sail_destroy_image(image_local));
     SAIL_TRY_OR_CLEANUP(wal_state->io->seek(wal_state->io->stream, wal_state->wal_header.offset[wal_state->frame_number], SEEK_SET),
                         /* cleanup */ sail_destroy_image(image_local));
 
@@ -144,6 +142,20 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_wal(void *state, st
     return SAIL_OK;
 }
 
+SAIL_EXPORT sail_status_t sail_codec_load_seek_frame_v8_wal(void *state, unsigned frame) {
+
+    struct wal_state *wal_state = state;
+
+    /* Mip levels are laid out at known offsets, so seek to any of them directly. */
+    if (frame >= SAIL_WAL_MIP_LEVELS) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    wal_state->frame_number = frame;
+
+    return SAIL_OK;
+}
+
 SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_wal(void *state, struct sail_image *image) {
 
     struct wal_state *wal_state = state;
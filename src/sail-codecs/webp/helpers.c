@@ -23,45 +23,325 @@
     SOFTWARE.
 */
 
+#include <limits.h>
 #include <string.h>
 
+#include <webp/mux.h>
+
 #include <sail-common/sail-common.h>
 
 #include "helpers.h"
 
-void webp_private_fill_color(uint8_t *pixels, unsigned bytes_per_line, unsigned bytes_per_pixel,
-                                uint32_t color, unsigned x, unsigned y, unsigned width, unsigned height) {
+/* Entropy passes of the quality search for the target size or PSNR. */
+#define TARGET_PASSES 6
+
+uint32_t webp_private_premultiply_color(uint32_t color) {
+
+    uint8_t components[4];
+    memcpy(components, &color, sizeof(color));
+
+    for (unsigned i = 0; i < 3; i++) {
+        components[i] = (uint8_t)((components[i] * components[3] + 127) / 255);
+    }
+
+    memcpy(&color, components, sizeof(color));
+
+    return color;
+}
+
+bool webp_private_pixel_format_to_colorspace(enum SailPixelFormat pixel_format, WEBP_CSP_MODE *colorspace) {
 
-    uint8_t *scanline = pixels + y * bytes_per_line + x * bytes_per_pixel;
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:                  *colorspace = MODE_RGB;  return true;
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:                  *colorspace = MODE_BGR;  return true;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:                 *colorspace = MODE_RGBA; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA:                 *colorspace = MODE_BGRA; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB:                 *colorspace = MODE_ARGB; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED:   *colorspace = MODE_rgbA; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED:   *colorspace = MODE_bgrA; return true;
 
-    for (unsigned row = 0; row < height; row++, scanline += bytes_per_line) {
-        for (unsigned column = 0; column < width * bytes_per_pixel; column += bytes_per_pixel) {
-            memcpy(scanline + column, &color, sizeof(color));
+        default: {
+            return false;
         }
     }
 }
 
-sail_status_t webp_private_blend_over(void *dst_raw, unsigned dst_offset, const void *src_raw, unsigned width, unsigned bytes_per_pixel) {
+uint32_t webp_private_color_to_colorspace(uint32_t color, WEBP_CSP_MODE colorspace) {
+
+    if (WebPIsPremultipliedMode(colorspace)) {
+        color = webp_private_premultiply_color(color);
+    }
+
+    uint8_t rgba[4];
+    memcpy(rgba, &color, sizeof(color));
+
+    uint8_t components[4];
+
+    switch (colorspace) {
+        case MODE_BGRA:
+        case MODE_bgrA: {
+            components[0] = rgba[2]; components[1] = rgba[1]; components[2] = rgba[0]; components[3] = rgba[3];
+            break;
+        }
+        case MODE_ARGB: {
+            components[0] = rgba[3]; components[1] = rgba[0]; components[2] = rgba[1]; components[3] = rgba[2];
+            break;
+        }
+        default: {
+            return color;
+        }
+    }
+
+    memcpy(&color, components, sizeof(color));
+
+    return color;
+}
+
+sail_status_t webp_private_decode_into(const uint8_t *data, size_t data_size, WEBP_CSP_MODE colorspace,
+                                        uint8_t *output, size_t output_size, unsigned stride) {
+
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(output);
+
+    WebPDecoderConfig config;
+
+    if (!WebPInitDecoderConfig(&config)) {
+        SAIL_LOG_ERROR("WEBP: Failed to initialize decoder configuration");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    config.output.colorspace         = colorspace;
+    config.output.is_external_memory = 1;
+    config.output.u.RGBA.rgba        = output;
+    config.output.u.RGBA.stride      = (int)stride;
+    config.output.u.RGBA.size        = output_size;
+
+    const VP8StatusCode status = WebPDecode(data, data_size, &config);
+
+    WebPFreeDecBuffer(&config.output);
+
+    if (status != VP8_STATUS_OK) {
+        SAIL_LOG_ERROR("WEBP: Failed to decode image, error code: %d", status);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
+bool webp_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
+
+    bool *premultiply_alpha = user_data;
+
+    if (strcmp(key, "webp-premultiply-alpha") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_BOOL) {
+            *premultiply_alpha = sail_variant_to_bool(value);
+            SAIL_LOG_TRACE("WEBP: Premultiply alpha: %s", *premultiply_alpha ? "yes" : "no");
+        }
+    }
+
+    return true;
+}
 
-    SAIL_CHECK_PTR(src_raw);
-    SAIL_CHECK_PTR(dst_raw);
+bool webp_private_save_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data) {
 
-    if (bytes_per_pixel == 4) {
-        const uint8_t *src = src_raw;
-        uint8_t *dst = (uint8_t *)dst_raw + dst_offset * bytes_per_pixel;
+    struct webp_private_save_tuning *save_tuning = user_data;
 
-        while (width--) {
-            const double src_a = *(src+3) / 255.0;
-            const double dst_a = *(dst+3) / 255.0;
+    if (strcmp(key, "webp-method") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            const unsigned method = sail_variant_to_unsigned_int(value);
 
-            *dst = (uint8_t)(src_a * (*src) + (1-src_a) * dst_a * (*dst)); src++; dst++;
-            *dst = (uint8_t)(src_a * (*src) + (1-src_a) * dst_a * (*dst)); src++; dst++;
-            *dst = (uint8_t)(src_a * (*src) + (1-src_a) * dst_a * (*dst)); src++; dst++;
-            *dst = (uint8_t)((src_a + (1-src_a) * dst_a) * 255);           src++; dst++;
+            if (method <= 6) {
+                SAIL_LOG_TRACE("WEBP: Method: %u", method);
+                save_tuning->method = (int)method;
+            } else {
+                SAIL_LOG_WARNING("WEBP: Method %u is out of range [0; 6]", method);
+            }
         }
-    } else {
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_BIT_DEPTH);
+    } else if (strcmp(key, "webp-thread-level") == 0) {
+        /* libwebp accepts only 0 and 1. Non-zero integers also enable threads. */
+        if (value->type == SAIL_VARIANT_TYPE_BOOL) {
+            save_tuning->thread_level = sail_variant_to_bool(value) ? 1 : 0;
+            SAIL_LOG_TRACE("WEBP: Thread level: %d", save_tuning->thread_level);
+        } else if (value->type == SAIL_VARIANT_TYPE_UNSIGNED_INT) {
+            save_tuning->thread_level = (sail_variant_to_unsigned_int(value) > 0) ? 1 : 0;
+            SAIL_LOG_TRACE("WEBP: Thread level: %d", save_tuning->thread_level);
+        }
+    } else if (strcmp(key, "webp-lossless") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_BOOL) {
+            save_tuning->lossless = sail_variant_to_bool(value) ? 1 : 0;
+            SAIL_LOG_TRACE("WEBP: Lossless: %s", save_tuning->lossless ? "yes" : "no");
+        }
+    } else if (strcmp(key, "webp-preset") == 0) {
+        if (value->type == SAIL_VARIANT_TYPE_STRING) {
+            const char *str_value = sail_variant_to_string(value);
+
+            if (strcmp(str_value, "default") == 0) {
+                save_tuning->preset = WEBP_PRESET_DEFAULT;
+            } else if (strcmp(str_value, "picture") == 0) {
+                save_tuning->preset = WEBP_PRESET_PICTURE;
+            } else if (strcmp(str_value, "photo") == 0) {
+                save_tuning->preset = WEBP_PRESET_PHOTO;
+            } else if (strcmp(str_value, "drawing") == 0) {
+                save_tuning->preset = WEBP_PRESET_DRAWING;
+            } else if (strcmp(str_value, "icon") == 0) {
+                save_tuning->preset = WEBP_PRESET_ICON;
+            } else if (strcmp(str_value, "text") == 0) {
+                save_tuning->preset = WEBP_PRESET_TEXT;
+            } else {
+                SAIL_LOG_WARNING("WEBP: Unknown preset '%s'", str_value);
+                return true;
+            }
+
+            SAIL_LOG_TRACE("WEBP: Applying '%s' preset", str_value);
+        }
+    }
+
+    return true;
+}
+
+sail_status_t webp_private_init_config(const struct webp_private_save_tuning *save_tuning, float quality,
+                                       size_t target_size, double target_quality, WebPConfig *config) {
+
+    SAIL_CHECK_PTR(save_tuning);
+    SAIL_CHECK_PTR(config);
+
+    const WebPPreset preset = save_tuning->preset >= 0 ? (WebPPreset)save_tuning->preset : WEBP_PRESET_DEFAULT;
+
+    if (!WebPConfigPreset(config, preset, quality)) {
+        SAIL_LOG_ERROR("WEBP: Failed to initialize encoder configuration");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Explicit options take precedence over the preset. */
+    if (save_tuning->method >= 0) {
+        config->method = save_tuning->method;
+    }
+    if (save_tuning->thread_level >= 0) {
+        config->thread_level = save_tuning->thread_level;
     }
+    if (save_tuning->lossless >= 0) {
+        config->lossless = save_tuning->lossless;
+    }
+
+    /* libwebp searches for the quality in multiple passes. The target size takes precedence over the PSNR. */
+    if (target_size > 0 || target_quality > 0) {
+        config->target_size = (int)SAIL_MIN(target_size, (size_t)INT_MAX);
+        config->target_PSNR = (float)target_quality;
+        config->pass        = TARGET_PASSES;
+    }
+
+    if (!WebPValidateConfig(config)) {
+        SAIL_LOG_ERROR("WEBP: Invalid encoder configuration");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t webp_private_import_picture(const struct sail_image *image, WebPPicture *picture) {
+
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(picture);
+
+    picture->width  = (int)image->width;
+    picture->height = (int)image->height;
+
+    const uint8_t *pixels = image->pixels;
+    const int stride      = (int)image->bytes_per_line;
+    int result;
+
+    /* Import the rows as is, libwebp converts them to its internal representation. */
+    switch (image->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:  result = WebPPictureImportRGB(picture, pixels, stride);  break;
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:  result = WebPPictureImportBGR(picture, pixels, stride);  break;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: result = WebPPictureImportRGBA(picture, pixels, stride); break;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: result = WebPPictureImportBGRA(picture, pixels, stride); break;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX: result = WebPPictureImportRGBX(picture, pixels, stride); break;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX: result = WebPPictureImportBGRX(picture, pixels, stride); break;
+
+        default: {
+            SAIL_LOG_ERROR("WEBP: %s pixel format is not currently supported for saving", sail_pixel_format_to_string(image->pixel_format));
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        }
+    }
+
+    if (!result) {
+        SAIL_LOG_ERROR("WEBP: Failed to import pixels, error code: %d", picture->error_code);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t set_mux_chunk(WebPMux *mux, const char fourcc[4], const void *data, size_t data_size) {
+
+    const WebPData chunk = { data, data_size };
+
+    const WebPMuxError error = WebPMuxSetChunk(mux, fourcc, &chunk, /* copy */ 0);
+
+    if (error != WEBP_MUX_OK) {
+        SAIL_LOG_ERROR("WEBP: Failed to add %.4s chunk, error code: %d", fourcc, error);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t add_chunks(WebPMux *mux, const struct sail_iccp *iccp, const struct sail_meta_data_node *meta_data_node) {
+
+    if (iccp != NULL) {
+        SAIL_TRY(set_mux_chunk(mux, "ICCP", iccp->data, iccp->size));
+    }
+
+    for (; meta_data_node != NULL; meta_data_node = meta_data_node->next) {
+        const struct sail_meta_data *meta_data = meta_data_node->meta_data;
+
+        if (meta_data->key == SAIL_META_DATA_EXIF && meta_data->value->type == SAIL_VARIANT_TYPE_DATA) {
+            SAIL_TRY(set_mux_chunk(mux, "EXIF", sail_variant_to_data(meta_data->value), meta_data->value->size));
+        } else if (meta_data->key == SAIL_META_DATA_XMP && meta_data->value->type == SAIL_VARIANT_TYPE_STRING) {
+            SAIL_TRY(set_mux_chunk(mux, "XMP ", sail_variant_to_string(meta_data->value), strlen(sail_variant_to_string(meta_data->value))));
+        } else {
+            SAIL_LOG_WARNING("WEBP: Ignoring unsupported meta data key '%s'",
+                                meta_data->key == SAIL_META_DATA_UNKNOWN ? meta_data->key_unknown : sail_meta_data_to_string(meta_data->key));
+        }
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t webp_private_add_chunks(const struct sail_iccp *iccp, const struct sail_meta_data_node *meta_data_node,
+                                        WebPData *webp_data) {
+
+    SAIL_CHECK_PTR(webp_data);
+
+    if (iccp == NULL && meta_data_node == NULL) {
+        return SAIL_OK;
+    }
+
+    WebPMux *mux = WebPMuxCreate(webp_data, /* copy */ 0);
+
+    if (mux == NULL) {
+        SAIL_LOG_ERROR("WEBP: Failed to create a muxer");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    SAIL_TRY_OR_CLEANUP(add_chunks(mux, iccp, meta_data_node),
+                        /* cleanup */ WebPMuxDelete(mux));
+
+    WebPData assembled;
+    WebPDataInit(&assembled);
+
+    const WebPMuxError error = WebPMuxAssemble(mux, &assembled);
+
+    WebPMuxDelete(mux);
+
+    if (error != WEBP_MUX_OK) {
+        SAIL_LOG_ERROR("WEBP: Failed to assemble the image, error code: %d", error);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    WebPDataClear(webp_data);
+    *webp_data = assembled;
 
     return SAIL_OK;
 }
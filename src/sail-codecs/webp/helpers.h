@@ -26,19 +26,52 @@
 #ifndef SAIL_WEBP_HELPERS_H
 #define SAIL_WEBP_HELPERS_H
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#include <webp/decode.h>
 #include <webp/demux.h>
+#include <webp/encode.h>
 
 #include <sail-common/common.h>
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
-SAIL_HIDDEN void webp_private_fill_color(uint8_t *pixels, unsigned bytes_per_line, unsigned bytes_per_pixel,
-                                            uint32_t color, unsigned x, unsigned y, unsigned width, unsigned height);
+struct sail_iccp;
+struct sail_image;
+struct sail_meta_data_node;
+struct sail_variant;
 
-SAIL_HIDDEN sail_status_t webp_private_blend_over(void *dst_raw, unsigned dst_offset, const void *src_raw,
-                                                    unsigned width, unsigned bytes_per_pixel);
+/* Save tuning. Negative values mean the option is not set. */
+struct webp_private_save_tuning {
+    int method;
+    int thread_level;
+    int lossless;
+    int preset;
+};
+
+SAIL_HIDDEN uint32_t webp_private_premultiply_color(uint32_t color);
+
+SAIL_HIDDEN bool webp_private_pixel_format_to_colorspace(enum SailPixelFormat pixel_format, WEBP_CSP_MODE *colorspace);
+
+SAIL_HIDDEN uint32_t webp_private_color_to_colorspace(uint32_t color, WEBP_CSP_MODE colorspace);
+
+SAIL_HIDDEN sail_status_t webp_private_decode_into(const uint8_t *data, size_t data_size, WEBP_CSP_MODE colorspace,
+                                                    uint8_t *output, size_t output_size, unsigned stride);
+
+SAIL_HIDDEN bool webp_private_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+SAIL_HIDDEN bool webp_private_save_tuning_key_value_callback(const char *key, const struct sail_variant *value, void *user_data);
+
+/* Initializes the encoder configuration. Non-zero target size and quality enable the multi-pass quality search. */
+SAIL_HIDDEN sail_status_t webp_private_init_config(const struct webp_private_save_tuning *save_tuning, float quality,
+                                                   size_t target_size, double target_quality, WebPConfig *config);
+
+SAIL_HIDDEN sail_status_t webp_private_import_picture(const struct sail_image *image, WebPPicture *picture);
+
+SAIL_HIDDEN sail_status_t webp_private_add_chunks(const struct sail_iccp *iccp, const struct sail_meta_data_node *meta_data_node,
+                                                    WebPData *webp_data);
 
 SAIL_HIDDEN sail_status_t webp_private_fetch_iccp(WebPDemuxer *webp_demux, struct sail_iccp **iccp);
 
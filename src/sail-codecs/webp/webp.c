@@ -31,11 +31,22 @@
 
 #include <webp/decode.h>
 #include <webp/demux.h>
+#include <webp/encode.h>
+#include <webp/mux.h>
 
 #include <sail-common/sail-common.h>
 
+#include "common/animation/animation.h"
+
 #include "helpers.h"
 
+/*
+ * Quality is (100 - compression level) like in JPEG. The default level 25 gives libwebp's default quality 75.
+ */
+static const double COMPRESSION_MIN     = 0;
+static const double COMPRESSION_MAX     = 100;
+static const double COMPRESSION_DEFAULT = 25;
+
 /*
  * Codec-specific state.
  */
@@ -44,21 +55,36 @@ struct webp_state {
     const struct sail_save_options *save_options;
 
     struct sail_image *canvas_image;
+    struct animation_canvas *canvas;
     WebPDemuxer *webp_demux;
     WebPIterator *webp_iterator;
     unsigned frame_number;
     uint32_t background_color;
-    uint32_t frame_count;
+    bool animated;
     unsigned bytes_per_pixel;
-    unsigned frame_x;
-    unsigned frame_y;
-    unsigned frame_width;
-    unsigned frame_height;
-    WebPMuxAnimDispose frame_dispose_method;
-    WebPMuxAnimBlend frame_blend_method;
-
-    void *image_data;
+    WEBP_CSP_MODE colorspace;
+    bool premultiply_alpha;
+    bool dirty_only;
+
+    /*
+     * Non-mapped I/O objects are read in growing portions, and the demuxer is rebuilt
+     * over the data read so far until the requested frame is complete.
+     */
+    struct sail_io *io;
+    WebPDemuxState demux_state;
+    const void *image_data;
     size_t image_data_size;
+    size_t image_data_read;
+    void *allocated_image_data;
+
+    /* Saving. Frames are collected by the animation encoder that emits still images for single frames. */
+    WebPAnimEncoder *anim_encoder;
+    WebPConfig webp_config;
+    unsigned width;
+    unsigned height;
+    int timestamp;
+    struct sail_iccp *iccp;
+    struct sail_meta_data_node *meta_data_node;
 };
 
 static sail_status_t alloc_webp_state(const struct sail_load_options *load_options,
@@ -74,21 +100,30 @@ static sail_status_t alloc_webp_state(const struct sail_load_options *load_optio
         .save_options = save_options,
 
         .canvas_image         = NULL,
+        .canvas               = NULL,
         .webp_demux           = NULL,
         .webp_iterator        = NULL,
         .frame_number         = 0,
         .background_color     = 0,
-        .frame_count          = 0,
+        .animated             = false,
         .bytes_per_pixel      = 0,
-        .frame_x              = 0,
-        .frame_y              = 0,
-        .frame_width          = 0,
-        .frame_height         = 0,
-        .frame_dispose_method = WEBP_MUX_DISPOSE_NONE,
-        .frame_blend_method   = WEBP_MUX_NO_BLEND,
-
-        .image_data      = NULL,
-        .image_data_size = 0,
+        .colorspace           = MODE_RGBA,
+        .premultiply_alpha    = false,
+        .dirty_only           = false,
+
+        .io                   = NULL,
+        .demux_state          = WEBP_DEMUX_PARSING_HEADER,
+        .image_data           = NULL,
+        .image_data_size      = 0,
+        .image_data_read      = 0,
+        .allocated_image_data = NULL,
+
+        .anim_encoder         = NULL,
+        .width                = 0,
+        .height               = 0,
+        .timestamp            = 0,
+        .iccp                 = NULL,
+        .meta_data_node       = NULL,
     };
 
     return SAIL_OK;
@@ -105,15 +140,90 @@ static void destroy_webp_state(struct webp_state *webp_state) {
         sail_free(webp_state->webp_iterator);
     }
 
-    sail_free(webp_state->image_data);
+    sail_free(webp_state->allocated_image_data);
 
     WebPDemuxDelete(webp_state->webp_demux);
 
     sail_destroy_image(webp_state->canvas_image);
+    animation_private_destroy_canvas(webp_state->canvas);
+
+    WebPAnimEncoderDelete(webp_state->anim_encoder);
+    sail_destroy_iccp(webp_state->iccp);
+    sail_destroy_meta_data_node_chain(webp_state->meta_data_node);
 
     sail_free(webp_state);
 }
 
+/* The first portion is big enough for the headers and small images. */
+#define WEBP_FIRST_READ_SIZE (64 * 1024)
+
+static sail_status_t demux_data_read(struct webp_state *webp_state) {
+
+    WebPDemuxDelete(webp_state->webp_demux);
+
+    const WebPData data = { webp_state->image_data, webp_state->image_data_read };
+
+    webp_state->webp_demux = WebPDemuxPartial(&data, &webp_state->demux_state);
+
+    if (webp_state->webp_demux == NULL) {
+        SAIL_LOG_ERROR("WEBP: Failed to demux the image");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Reads the next portion, twice as big as the data read so far, and rebuilds the demuxer.
+ * The buffer grows with the data actually read, as the RIFF size comes from an untrusted header.
+ */
+static sail_status_t read_more_data(struct webp_state *webp_state) {
+
+    const size_t left    = webp_state->image_data_size - webp_state->image_data_read;
+    const size_t portion = SAIL_MAX(webp_state->image_data_read, (size_t)WEBP_FIRST_READ_SIZE);
+    const size_t size    = SAIL_MIN(left, portion);
+
+    SAIL_TRY(sail_realloc(webp_state->image_data_read + size, &webp_state->allocated_image_data));
+    webp_state->image_data = webp_state->allocated_image_data;
+
+    SAIL_TRY(webp_state->io->strict_read(webp_state->io->stream,
+                                           (char *)webp_state->allocated_image_data + webp_state->image_data_read,
+                                           size));
+    webp_state->image_data_read += size;
+
+    SAIL_TRY(demux_data_read(webp_state));
+
+    return SAIL_OK;
+}
+
+static bool all_data_read(const struct webp_state *webp_state) {
+
+    return webp_state->image_data_read == webp_state->image_data_size;
+}
+
+/*
+ * Points the iterator to the frame, reading more data if needed. Frame numbers start with 1.
+ * Incomplete frames are enough when only the frame headers are needed, for example, for probing.
+ */
+static sail_status_t get_frame(struct webp_state *webp_state, int frame_number, bool complete) {
+
+    while (WebPDemuxGetFrame(webp_state->webp_demux, frame_number, webp_state->webp_iterator) == 0 ||
+            (complete && !webp_state->webp_iterator->complete)) {
+        if (all_data_read(webp_state)) {
+            if (frame_number == 1) {
+                SAIL_LOG_ERROR("WEBP: Failed to get the first frame");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+            }
+
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+        }
+
+        SAIL_TRY(read_more_data(webp_state));
+    }
+
+    return SAIL_OK;
+}
+
 /*
  * Decoding functions.
  */
@@ -127,30 +237,121 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_webp(struct sail_io *io, const
     SAIL_TRY(alloc_webp_state(load_options, NULL, &webp_state));
     *state = webp_state;
 
-    /* Read the entire image. */
-    SAIL_ALIGNAS(uint32_t) char signature_and_size[8];
-    SAIL_TRY(io->strict_read(io->stream, signature_and_size, sizeof(signature_and_size)));
-    webp_state->image_data_size = *(uint32_t *)(signature_and_size + 4) + sizeof(signature_and_size);
-
-    SAIL_TRY(io->seek(io->stream, 0, SEEK_SET));
+    webp_state->io = io;
 
     void *ptr;
-    SAIL_TRY(sail_malloc(webp_state->image_data_size, &ptr));
-    webp_state->image_data = ptr;
+    SAIL_TRY(sail_malloc(sizeof(WebPIterator), &ptr));
+    webp_state->webp_iterator = ptr;
 
-    SAIL_TRY(io->strict_read(io->stream, webp_state->image_data, webp_state->image_data_size));
+    /* RIFF signature and size. */
+    uint32_t riff_size;
 
-    /* Construct a WebP demuxer. */
-    const WebPData data = { webp_state->image_data, webp_state->image_data_size };
+    if ((io->features & SAIL_IO_FEATURE_MAPPED) && io->map != NULL) {
+        /* Mapped I/O objects are borrowed without copying. */
+        size_t data_size;
+        SAIL_TRY(sail_borrow_or_alloc_data_from_io_contents(io, &webp_state->image_data, &data_size, &webp_state->allocated_image_data));
 
-    webp_state->webp_demux = WebPDemux(&data);
+        if (data_size < 8) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+        }
 
-    SAIL_TRY(sail_malloc(sizeof(WebPIterator), &ptr));
-    webp_state->webp_iterator = ptr;
+        memcpy(&riff_size, (const char *)webp_state->image_data + 4, sizeof(riff_size));
+        webp_state->image_data_size = (size_t)riff_size + 8;
+
+        if (webp_state->image_data_size > data_size) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+        }
+
+        webp_state->image_data_read = webp_state->image_data_size;
+    } else {
+        unsigned char header[8];
+        SAIL_TRY(io->strict_read(io->stream, header, sizeof(header)));
+
+        memcpy(&riff_size, header + 4, sizeof(riff_size));
+        webp_state->image_data_size = (size_t)riff_size + 8;
+
+        if (webp_state->image_data_size < sizeof(header)) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+        }
+
+        SAIL_TRY(sail_malloc(sizeof(header), &webp_state->allocated_image_data));
+        webp_state->image_data = webp_state->allocated_image_data;
+
+        memcpy(webp_state->allocated_image_data, header, sizeof(header));
+        webp_state->image_data_read = sizeof(header);
+    }
+
+    /* Construct a WebP demuxer over the data read so far, and read until the headers are parsed. */
+    SAIL_TRY(demux_data_read(webp_state));
+
+    while (webp_state->demux_state < WEBP_DEMUX_PARSED_HEADER) {
+        if (all_data_read(webp_state)) {
+            SAIL_LOG_ERROR("WEBP: Failed to parse the image headers");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        SAIL_TRY(read_more_data(webp_state));
+    }
+
+    const uint32_t format_flags = WebPDemuxGetI(webp_state->webp_demux, WEBP_FF_FORMAT_FLAGS);
+
+    /* EXIF and XMP chunks follow the frames, and ICCP precedes them. */
+    if ((webp_state->load_options->options & SAIL_OPTION_META_DATA) && (format_flags & (EXIF_FLAG | XMP_FLAG))) {
+        while (!all_data_read(webp_state)) {
+            SAIL_TRY(read_more_data(webp_state));
+        }
+    } else if ((webp_state->load_options->options & SAIL_OPTION_ICCP) && (format_flags & ICCP_FLAG)) {
+        SAIL_TRY(get_frame(webp_state, 1, /* complete */ true));
+    }
 
-    /* Frame count and other image info. */
+    /* Image info. */
     webp_state->background_color = WebPDemuxGetI(webp_state->webp_demux, WEBP_FF_BACKGROUND_COLOR);
-    webp_state->frame_count      = WebPDemuxGetI(webp_state->webp_demux, WEBP_FF_FRAME_COUNT);
+    webp_state->animated         = format_flags & ANIMATION_FLAG;
+
+    /* Handle tuning. */
+    if (webp_state->load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(webp_state->load_options->tuning, webp_private_tuning_key_value_callback, &webp_state->premultiply_alpha);
+    }
+
+    /*
+     * Decode opaque still images without alpha, and let libwebp produce the requested pixel format directly.
+     * Animated images need alpha to blend frames.
+     */
+    bool has_alpha = true;
+
+    if (!webp_state->animated) {
+        SAIL_TRY(get_frame(webp_state, 1, /* complete */ false));
+        has_alpha = webp_state->webp_iterator->has_alpha;
+    }
+
+    enum SailPixelFormat pixel_format;
+    WEBP_CSP_MODE colorspace;
+
+    if (webp_private_pixel_format_to_colorspace(webp_state->load_options->output_pixel_format, &colorspace) &&
+            (!webp_state->animated || WebPIsAlphaMode(colorspace))) {
+        pixel_format = webp_state->load_options->output_pixel_format;
+    } else {
+        if (webp_state->load_options->output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
+            SAIL_LOG_DEBUG("WEBP: Cannot decode into %s, falling back to the native pixel format",
+                            sail_pixel_format_to_string(webp_state->load_options->output_pixel_format));
+        }
+
+        if (!has_alpha) {
+            pixel_format = SAIL_PIXEL_FORMAT_BPP24_RGB;
+            colorspace   = MODE_RGB;
+        } else if (webp_state->premultiply_alpha) {
+            pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED;
+            colorspace   = MODE_rgbA;
+        } else {
+            pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+            colorspace   = MODE_RGBA;
+        }
+    }
+
+    webp_state->colorspace = colorspace;
+
+    /* libwebp premultiplies decoded pixels itself, so frames are blended in the premultiplied space. */
+    webp_state->background_color = webp_private_color_to_colorspace(webp_state->background_color, colorspace);
 
     /* Construct a canvas image. */
     struct sail_image *image_local;
@@ -166,7 +367,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_webp(struct sail_io *io, const
 
     image_local->width          = WebPDemuxGetI(webp_state->webp_demux, WEBP_FF_CANVAS_WIDTH);
     image_local->height         = WebPDemuxGetI(webp_state->webp_demux, WEBP_FF_CANVAS_HEIGHT);
-    image_local->pixel_format   = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+    image_local->pixel_format   = pixel_format;
     image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
 
     webp_state->bytes_per_pixel = image_local->bytes_per_line / image_local->width;
@@ -184,6 +385,7 @@ SAIL_EXPORT sail_status_t sail_codec_load_init_v8_webp(struct sail_io *io, const
     }
 
     webp_state->canvas_image = image_local;
+    webp_state->dirty_only   = animation_private_dirty_only(load_options);
 
     return SAIL_OK;
 }
@@ -192,64 +394,64 @@ SAIL_EXPORT sail_status_t sail_codec_load_seek_next_frame_v8_webp(void *state, s
 
     struct webp_state *webp_state = state;
 
-    /* Start demuxing. */
-    if (webp_state->frame_number == 0) {
-        if (WebPDemuxGetFrame(webp_state->webp_demux, 1, webp_state->webp_iterator) == 0) {
-            SAIL_LOG_ERROR("WEBP: Failed to get the first frame");
-            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-        }
+    const bool probe = webp_state->load_options->options & SAIL_OPTION_PROBE;
 
-        /* Allocate a canvas frame to apply disposal later. */
-        size_t image_size = (size_t)webp_state->canvas_image->bytes_per_line * webp_state->canvas_image->height;
+    /* Probing returns the first frame only as there is no canvas to apply disposal to. */
+    if (probe && webp_state->frame_number > 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
 
-        void *ptr;
-        SAIL_TRY(sail_malloc(image_size, &ptr));
-        webp_state->canvas_image->pixels = ptr;
+    /* The demuxer may be rebuilt with more data, so fetch frames by their numbers. */
+    SAIL_TRY(get_frame(webp_state, (int)webp_state->frame_number + 1, /* complete */ !probe));
 
-        /* Fill background. */
-        webp_private_fill_color(webp_state->canvas_image->pixels, webp_state->canvas_image->bytes_per_line, webp_state->bytes_per_pixel,
-                                webp_state->background_color, 0, 0, webp_state->canvas_image->width, webp_state->canvas_image->height);
-    } else {
-        switch (webp_state->frame_dispose_method) {
-            case WEBP_MUX_DISPOSE_BACKGROUND: {
-                webp_private_fill_color(webp_state->canvas_image->pixels, webp_state->canvas_image->bytes_per_line, webp_state->bytes_per_pixel,
-                                        webp_state->background_color, webp_state->frame_x, webp_state->frame_y,
-                                        webp_state->frame_width, webp_state->frame_height);
-                break;
-            }
-            case WEBP_MUX_DISPOSE_NONE: {
-                break;
-            }
-            default: {
-                SAIL_LOG_ERROR("WEBP: Unknown disposal method");
-                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-            }
-        }
-
-        if (WebPDemuxNextFrame(webp_state->webp_iterator) == 0) {
-            SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    /* Start demuxing. */
+    if (webp_state->frame_number == 0) {
+        /* Allocate a canvas filled with the background color to composite frames. Probing needs no pixels. */
+        if (!probe) {
+            /* Still images ignore the background color, and their pixels may have no alpha. */
+            SAIL_TRY(animation_private_alloc_canvas(webp_state->canvas_image->width, webp_state->canvas_image->height,
+                                                    webp_state->canvas_image->pixel_format,
+                                                    webp_state->animated ? &webp_state->background_color : NULL,
+                                                    animation_private_first_frame_only(webp_state->load_options),
+                                                    &webp_state->canvas));
         }
     }
 
     webp_state->frame_number++;
-    webp_state->frame_x              = webp_state->webp_iterator->x_offset;
-    webp_state->frame_y              = webp_state->webp_iterator->y_offset;
-    webp_state->frame_width          = webp_state->webp_iterator->width;
-    webp_state->frame_height         = webp_state->webp_iterator->height;
-    webp_state->frame_dispose_method = webp_state->webp_iterator->dispose_method;
-    webp_state->frame_blend_method   = webp_state->webp_iterator->blend_method;
+
+    if (!probe) {
+        const struct animation_frame frame = {
+            .rect    = { (unsigned)webp_state->webp_iterator->x_offset, (unsigned)webp_state->webp_iterator->y_offset,
+                         (unsigned)webp_state->webp_iterator->width, (unsigned)webp_state->webp_iterator->height },
+            .dispose = (webp_state->webp_iterator->dispose_method == WEBP_MUX_DISPOSE_BACKGROUND)
+                        ? SAIL_ANIMATION_DISPOSE_BACKGROUND
+                        : SAIL_ANIMATION_DISPOSE_NONE,
+            /* Opaque fragments cover the area anyway, so they're decoded right into the canvas without blending. */
+            .blend   = (webp_state->animated && webp_state->webp_iterator->has_alpha &&
+                        webp_state->webp_iterator->blend_method == WEBP_MUX_BLEND)
+                        ? SAIL_ANIMATION_BLEND_OVER
+                        : SAIL_ANIMATION_BLEND_SOURCE,
+        };
+
+        SAIL_TRY(animation_private_start_frame(webp_state->canvas, &frame));
+    }
 
     /* Construct image. */
     struct sail_image *image_local;
     SAIL_TRY(sail_copy_image_skeleton(webp_state->canvas_image, &image_local));
 
+    if (!probe) {
+        SAIL_TRY_OR_CLEANUP(animation_private_setup_image(webp_state->canvas, webp_state->dirty_only, image_local),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
     if (webp_state->load_options->options & SAIL_OPTION_SOURCE_IMAGE) {
         image_local->source_image->pixel_format = webp_state->webp_iterator->has_alpha
                                                     ? SAIL_PIXEL_FORMAT_BPP32_YUVA
                                                     : SAIL_PIXEL_FORMAT_BPP24_YUV;
     }
 
-    if (webp_state->frame_count > 1) {
+    if (webp_state->animated) {
         /* Fall back to 100 ms. when the duration is <= 0. */
         image_local->delay = webp_state->webp_iterator->duration <= 0 ? 100 : webp_state->webp_iterator->duration;
     }
@@ -263,45 +465,25 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_webp(void *state, struct sail
 
     struct webp_state *webp_state = state;
 
-    switch (webp_state->frame_blend_method) {
-        case WEBP_MUX_NO_BLEND: {
-            if (WebPDecodeRGBAInto(webp_state->webp_iterator->fragment.bytes,
-                                    webp_state->webp_iterator->fragment.size,
-                                    (uint8_t *)webp_state->canvas_image->pixels + webp_state->canvas_image->bytes_per_line * webp_state->frame_y +
-                                        webp_state->frame_x * webp_state->bytes_per_pixel,
-                                    (size_t)webp_state->canvas_image->bytes_per_line * webp_state->canvas_image->height,
-                                    webp_state->canvas_image->bytes_per_line) == NULL) {
-                SAIL_LOG_ERROR("WEBP: Failed to decode image");
-                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-            }
-            break;
-        }
-        case WEBP_MUX_BLEND: {
-            if (WebPDecodeRGBAInto(webp_state->webp_iterator->fragment.bytes,
-                                    webp_state->webp_iterator->fragment.size,
-                                    image->pixels,
-                                    (size_t)image->bytes_per_line * image->height,
-                                    webp_state->frame_width * webp_state->bytes_per_pixel) == NULL) {
-                SAIL_LOG_ERROR("WEBP: Failed to decode image");
-                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-            }
+    SAIL_TRY(animation_private_bind_pixels(webp_state->canvas, webp_state->load_options, image));
 
-            uint8_t *dst_scanline = (uint8_t *)sail_scan_line(webp_state->canvas_image, webp_state->frame_y) + webp_state->frame_x * webp_state->bytes_per_pixel;
-            uint8_t *src_scanline = image->pixels;
+    /* Frames replacing the canvas pixels are decoded right into the canvas. */
+    void *frame_pixels;
+    unsigned frame_bytes_per_line;
+    SAIL_TRY(animation_private_frame_pixels(webp_state->canvas, &frame_pixels, &frame_bytes_per_line));
 
-            for (unsigned row = 0; row < webp_state->frame_height; row++, dst_scanline += webp_state->canvas_image->bytes_per_line,
-                                                                          src_scanline += webp_state->frame_width * webp_state->bytes_per_pixel) {
-                SAIL_TRY(webp_private_blend_over(dst_scanline, 0, src_scanline, webp_state->frame_width, webp_state->bytes_per_pixel));
-            }
-            break;
-        }
-        default: {
-            SAIL_LOG_ERROR("WEBP: Unknown blending method");
-            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
-        }
-    }
+    const size_t frame_size = (size_t)frame_bytes_per_line * (webp_state->webp_iterator->height - 1) +
+                                (size_t)webp_state->webp_iterator->width * webp_state->bytes_per_pixel;
+
+    SAIL_TRY(webp_private_decode_into(webp_state->webp_iterator->fragment.bytes,
+                                        webp_state->webp_iterator->fragment.size,
+                                        webp_state->colorspace,
+                                        frame_pixels,
+                                        frame_size,
+                                        frame_bytes_per_line));
 
-    memcpy(image->pixels, webp_state->canvas_image->pixels, (size_t)image->bytes_per_line * image->height);
+    animation_private_finish_frame(webp_state->canvas);
+    animation_private_copy_to_image(webp_state->canvas, webp_state->dirty_only, image);
 
     return SAIL_OK;
 }
@@ -323,32 +505,141 @@ SAIL_EXPORT sail_status_t sail_codec_load_finish_v8_webp(void **state) {
 
 SAIL_EXPORT sail_status_t sail_codec_save_init_v8_webp(struct sail_io *io, const struct sail_save_options *save_options, void **state) {
 
-    (void)io;
-    (void)save_options;
-    (void)state;
+    *state = NULL;
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    struct webp_state *webp_state;
+    SAIL_TRY(alloc_webp_state(NULL, save_options, &webp_state));
+    *state = webp_state;
+
+    webp_state->io = io;
+
+    if (webp_state->save_options->compression != SAIL_COMPRESSION_WEBP) {
+        SAIL_LOG_ERROR("WEBP: Only WEBP compression is allowed for saving");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
+    }
+
+    /* Handle tuning. */
+    struct webp_private_save_tuning save_tuning = { -1, -1, -1, -1 };
+
+    if (webp_state->save_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(webp_state->save_options->tuning, webp_private_save_tuning_key_value_callback, &save_tuning);
+    }
+
+    const double compression = (webp_state->save_options->compression_level < COMPRESSION_MIN ||
+                                webp_state->save_options->compression_level > COMPRESSION_MAX)
+                                ? COMPRESSION_DEFAULT
+                                : webp_state->save_options->compression_level;
+
+    SAIL_TRY(webp_private_init_config(&save_tuning,
+                                      /* to quality */ (float)(COMPRESSION_MAX - compression),
+                                      webp_state->save_options->target_size,
+                                      webp_state->save_options->target_quality,
+                                      &webp_state->webp_config));
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_seek_next_frame_v8_webp(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct webp_state *webp_state = state;
+
+    if (webp_state->anim_encoder == NULL) {
+        WebPAnimEncoderOptions anim_options;
+
+        if (!WebPAnimEncoderOptionsInit(&anim_options)) {
+            SAIL_LOG_ERROR("WEBP: Failed to initialize animation encoder options");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        /* The canvas size is taken from the first frame. */
+        webp_state->anim_encoder = WebPAnimEncoderNew((int)image->width, (int)image->height, &anim_options);
+
+        if (webp_state->anim_encoder == NULL) {
+            SAIL_LOG_ERROR("WEBP: Failed to create an animation encoder");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        /* ICCP and meta data are muxed into the assembled image in the end. */
+        if (webp_state->save_options->options & SAIL_OPTION_ICCP && image->iccp != NULL) {
+            SAIL_TRY(sail_copy_iccp(image->iccp, &webp_state->iccp));
+        }
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+        if (webp_state->save_options->options & SAIL_OPTION_META_DATA && image->meta_data_node != NULL) {
+            SAIL_TRY(sail_copy_meta_data_node_chain(image->meta_data_node, &webp_state->meta_data_node));
+        }
+
+        webp_state->width  = image->width;
+        webp_state->height = image->height;
+    } else if (image->width != webp_state->width || image->height != webp_state->height) {
+        SAIL_LOG_ERROR("WEBP: All frames must have the same dimensions");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_frame_v8_webp(void *state, const struct sail_image *image) {
 
-    (void)state;
-    (void)image;
+    struct webp_state *webp_state = state;
+
+    WebPPicture picture;
+
+    if (!WebPPictureInit(&picture)) {
+        SAIL_LOG_ERROR("WEBP: Failed to initialize a picture");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Lossless encoding works in ARGB, lossy in YUV. Import right into the needed representation. */
+    picture.use_argb = webp_state->webp_config.lossless;
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    SAIL_TRY_OR_CLEANUP(webp_private_import_picture(image, &picture),
+                        /* cleanup */ WebPPictureFree(&picture));
+
+    const int result = WebPAnimEncoderAdd(webp_state->anim_encoder, &picture, webp_state->timestamp, &webp_state->webp_config);
+
+    WebPPictureFree(&picture);
+
+    if (!result) {
+        SAIL_LOG_ERROR("WEBP: Failed to encode frame: %s", WebPAnimEncoderGetError(webp_state->anim_encoder));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    /* Fall back to 100 ms. when the delay is <= 0 like the decoder does. */
+    webp_state->timestamp += image->delay <= 0 ? 100 : image->delay;
+
+    return SAIL_OK;
 }
 
 SAIL_EXPORT sail_status_t sail_codec_save_finish_v8_webp(void **state) {
 
-    (void)state;
+    struct webp_state *webp_state = *state;
+
+    *state = NULL;
+
+    if (webp_state->anim_encoder != NULL) {
+        WebPData webp_data;
+        WebPDataInit(&webp_data);
 
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+        /* Flush the last frame and assemble the image. */
+        if (!WebPAnimEncoderAdd(webp_state->anim_encoder, NULL, webp_state->timestamp, NULL) ||
+                !WebPAnimEncoderAssemble(webp_state->anim_encoder, &webp_data)) {
+            SAIL_LOG_ERROR("WEBP: Failed to assemble the image: %s", WebPAnimEncoderGetError(webp_state->anim_encoder));
+            destroy_webp_state(webp_state);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+        }
+
+        SAIL_TRY_OR_CLEANUP(webp_private_add_chunks(webp_state->iccp, webp_state->meta_data_node, &webp_data),
+                            /* cleanup */ WebPDataClear(&webp_data),
+                                          destroy_webp_state(webp_state));
+
+        SAIL_TRY_OR_CLEANUP(webp_state->io->strict_write(webp_state->io->stream, webp_data.bytes, webp_data.size),
+                            /* cleanup */ WebPDataClear(&webp_data),
+                                          destroy_webp_state(webp_state));
+
+        WebPDataClear(&webp_data);
+    }
+
+    destroy_webp_state(webp_state);
+
+    return SAIL_OK;
 }
@@ -23,6 +23,8 @@
     SOFTWARE.
 */
 
+#include <stdint.h>
+
 #include <sail-common/sail-common.h>
 
 #include "helpers.h"
@@ -36,3 +38,55 @@ unsigned char xbm_private_reverse_byte(unsigned char byte) {
 
    return (reverse_lookup_4bits[byte & 0xF] << 4) | reverse_lookup_4bits[byte >> 4];
 }
+
+/* Hex digit values with the 0x10 flag set. Other characters are 0. */
+static const uint8_t hex_lookup[256] = {
+    ['0'] = 0x10, ['1'] = 0x11, ['2'] = 0x12, ['3'] = 0x13, ['4'] = 0x14,
+    ['5'] = 0x15, ['6'] = 0x16, ['7'] = 0x17, ['8'] = 0x18, ['9'] = 0x19,
+    ['a'] = 0x1a, ['b'] = 0x1b, ['c'] = 0x1c, ['d'] = 0x1d, ['e'] = 0x1e, ['f'] = 0x1f,
+    ['A'] = 0x1a, ['B'] = 0x1b, ['C'] = 0x1c, ['D'] = 0x1d, ['E'] = 0x1e, ['F'] = 0x1f,
+};
+
+#define SAIL_XBM_HEX_DIGIT 0x10
+
+sail_status_t xbm_private_read_hex_literal(struct sail_buffered_reader *reader, unsigned *value) {
+
+    uint8_t c;
+
+    do {
+        SAIL_TRY(sail_buffered_reader_read_byte(reader, &c));
+    } while ((hex_lookup[c] & SAIL_XBM_HEX_DIGIT) == 0);
+
+    unsigned value_local = 0;
+    unsigned digits = 0;
+
+    for (;;) {
+        const uint8_t hex = hex_lookup[c];
+
+        if (hex & SAIL_XBM_HEX_DIGIT) {
+            /* Literals are at most 16-bit with optional leading zeros. */
+            if (++digits > 8) {
+                SAIL_LOG_ERROR("XBM: Hex literal is too long");
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+            }
+
+            value_local = (value_local << 4) | (hex & 0xF);
+        } else if ((c == 'x' || c == 'X') && digits == 1 && value_local == 0) {
+            /* "0x" prefix. */
+            digits = 0;
+        } else {
+            break;
+        }
+
+        SAIL_TRY(sail_buffered_reader_read_byte(reader, &c));
+    }
+
+    if (digits == 0) {
+        SAIL_LOG_ERROR("XBM: Hex literal has no digits");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    *value = value_local;
+
+    return SAIL_OK;
+}
@@ -27,7 +27,16 @@
 #define SAIL_XBM_HELPERS_H
 
 #include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_buffered_reader;
 
 SAIL_HIDDEN unsigned char xbm_private_reverse_byte(unsigned char byte);
 
+/*
+ * Reads the next hex literal like "0x1f" or "0X001F" from the C array body.
+ * Skips everything before the literal and consumes the single character after it.
+ */
+SAIL_HIDDEN sail_status_t xbm_private_read_hex_literal(struct sail_buffered_reader *reader, unsigned *value);
+
 #endif
@@ -189,45 +189,38 @@ SAIL_EXPORT sail_status_t sail_codec_load_frame_v8_xbm(void *state, struct sail_
 
     const struct xbm_state *xbm_state = state;
 
-    unsigned literals_to_read;
+    struct sail_buffered_reader reader;
+    SAIL_TRY(sail_init_buffered_reader(xbm_state->io, 0, &reader));
 
-    if (SAIL_LIKELY(xbm_state->version == SAIL_XBM_VERSION_11)) {
-        literals_to_read = ((image->width + 7) / 8) * image->height;
-    } else {
-        literals_to_read = (((image->width + 7) / 8 + 1) / 2) * image->height;
-    }
+    for (unsigned row = 0; row < image->height; row++) {
+        unsigned char *scan = sail_scan_line(image, row);
 
-    SAIL_LOG_TRACE("XBM: Literals to read(%u)", literals_to_read);
+        if (SAIL_LIKELY(xbm_state->version == SAIL_XBM_VERSION_11)) {
+            for (unsigned i = 0; i < image->bytes_per_line; i++) {
+                unsigned holder;
+                SAIL_TRY_OR_CLEANUP(xbm_private_read_hex_literal(&reader, &holder),
+                                    /* cleanup */ sail_finish_buffered_reader(&reader));
 
-    char buf[512 + 1];
-    unsigned char *pixels = image->pixels;
-
-    for (unsigned literals_read = 0; literals_read < literals_to_read; ) {
-        SAIL_TRY(sail_read_string_from_io(xbm_state->io, buf, sizeof(buf)));
-
-        unsigned buf_offset = 0;
-        unsigned holder;
-        char comma;
-        int bytes_consumed;
-
-    #ifdef _MSC_VER
-        while (sscanf_s(buf + buf_offset, "%x %c %n", &holder, &comma, 1, &bytes_consumed) == 2) {
-    #else
-        while (sscanf(buf + buf_offset, "%x %c %n", &holder, &comma, &bytes_consumed) == 2) {
-    #endif
-
-            if (SAIL_LIKELY(xbm_state->version == SAIL_XBM_VERSION_11)) {
-                *pixels++ = xbm_private_reverse_byte((unsigned char)holder);
-            } else {
-                *pixels++ = xbm_private_reverse_byte((unsigned char)(holder & 0xff));
-                *pixels++ = xbm_private_reverse_byte((unsigned char)(holder >> 8));
+                scan[i] = xbm_private_reverse_byte((unsigned char)holder);
+            }
+        } else {
+            /* Every row is padded to 16-bit literals. */
+            for (unsigned i = 0; i < image->bytes_per_line; i += 2) {
+                unsigned holder;
+                SAIL_TRY_OR_CLEANUP(xbm_private_read_hex_literal(&reader, &holder),
+                                    /* cleanup */ sail_finish_buffered_reader(&reader));
+
+                scan[i] = xbm_private_reverse_byte((unsigned char)(holder & 0xff));
+
+                if (i + 1 < image->bytes_per_line) {
+                    scan[i + 1] = xbm_private_reverse_byte((unsigned char)(holder >> 8));
+                }
             }
-
-            literals_read++;
-            buf_offset += bytes_consumed;
         }
     }
 
+    SAIL_TRY(sail_finish_buffered_reader(&reader));
+
     return SAIL_OK;
 }
 
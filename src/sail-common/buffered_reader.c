@@ -0,0 +1,273 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+/*
+ * Private functions.
+ */
+
+/* Makes at least the specified number of bytes available in the current block. */
+static sail_status_t ensure_available(struct sail_buffered_reader *reader, size_t size) {
+
+    if (reader->length - reader->pos >= size) {
+        return SAIL_OK;
+    }
+
+    if (reader->pos == reader->length) {
+        const sail_status_t status = sail_buffered_reader_refill(reader);
+
+        if (status == SAIL_ERROR_EOF) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+        }
+
+        SAIL_TRY(status);
+
+        if (reader->length - reader->pos >= size) {
+            return SAIL_OK;
+        }
+    }
+
+    /* Mapped data is never split into blocks, so no more data is available. */
+    if (reader->buffer == NULL) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    if (size > reader->capacity) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    /* Move the remaining bytes to the beginning and append the next bytes. */
+    const size_t remaining = reader->length - reader->pos;
+    memmove(reader->buffer, reader->buffer + reader->pos, remaining);
+
+    reader->length = remaining;
+    reader->pos    = 0;
+
+    while (reader->length < size) {
+        size_t read_size;
+        const sail_status_t status = reader->io->tolerant_read(reader->io->stream,
+                                                                reader->buffer + reader->length,
+                                                                reader->capacity - reader->length,
+                                                                &read_size);
+
+        if (status == SAIL_ERROR_EOF || (status == SAIL_OK && read_size == 0)) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+        }
+
+        SAIL_TRY(status);
+
+        reader->length += read_size;
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_init_buffered_reader(struct sail_io *io, size_t capacity, struct sail_buffered_reader *reader) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(reader);
+
+    *reader = (struct sail_buffered_reader) {
+        .io       = io,
+        .buffer   = NULL,
+        .capacity = (capacity == 0) ? SAIL_BUFFERED_READER_DEFAULT_CAPACITY : capacity,
+        .data     = NULL,
+        .length   = 0,
+        .pos      = 0,
+    };
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_finish_buffered_reader(struct sail_buffered_reader *reader) {
+
+    SAIL_CHECK_PTR(reader);
+
+    if (reader->io == NULL) {
+        return SAIL_OK;
+    }
+
+    /* The underlying I/O object is positioned right after the last block. */
+    const size_t unread = reader->length - reader->pos;
+
+    sail_free(reader->buffer);
+
+    struct sail_io *io = reader->io;
+
+    reader->io     = NULL;
+    reader->buffer = NULL;
+    reader->data   = NULL;
+    reader->length = 0;
+    reader->pos    = 0;
+
+    if (unread > 0) {
+        SAIL_TRY(io->seek(io->stream, -(long)unread, SEEK_CUR));
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_buffered_reader_refill(struct sail_buffered_reader *reader) {
+
+    SAIL_CHECK_PTR(reader);
+
+    struct sail_io *io = reader->io;
+
+    reader->length = 0;
+    reader->pos    = 0;
+
+    /* Serve mapped data in place and position the underlying I/O object after it. */
+    if (reader->buffer == NULL && (io->features & SAIL_IO_FEATURE_MAPPED) && io->map != NULL) {
+        const void *data;
+        size_t data_size;
+
+        if (io->map(io->stream, &data, &data_size) == SAIL_OK) {
+            if (data_size == 0) {
+                return SAIL_ERROR_EOF;
+            }
+
+            SAIL_TRY(io->seek(io->stream, (long)data_size, SEEK_CUR));
+
+            reader->data   = data;
+            reader->length = data_size;
+
+            return SAIL_OK;
+        }
+    }
+
+    if (reader->buffer == NULL) {
+        void *ptr;
+        SAIL_TRY(sail_malloc(reader->capacity, &ptr));
+        reader->buffer = ptr;
+        reader->data   = reader->buffer;
+    }
+
+    size_t read_size;
+    const sail_status_t status = io->tolerant_read(io->stream, reader->buffer, reader->capacity, &read_size);
+
+    if (status == SAIL_ERROR_EOF || (status == SAIL_OK && read_size == 0)) {
+        return SAIL_ERROR_EOF;
+    }
+
+    SAIL_TRY(status);
+
+    reader->length = read_size;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_buffered_reader_strict_read_slow(struct sail_buffered_reader *reader, void *buf, size_t size_to_read) {
+
+    SAIL_CHECK_PTR(reader);
+    SAIL_CHECK_PTR(buf);
+
+    unsigned char *out = buf;
+
+    while (size_to_read > 0) {
+        if (reader->pos == reader->length) {
+            const sail_status_t status = sail_buffered_reader_refill(reader);
+
+            if (status == SAIL_ERROR_EOF) {
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+            }
+
+            SAIL_TRY(status);
+        }
+
+        const size_t available = reader->length - reader->pos;
+        const size_t chunk = (size_to_read < available) ? size_to_read : available;
+
+        memcpy(out, reader->data + reader->pos, chunk);
+
+        reader->pos  += chunk;
+        out          += chunk;
+        size_to_read -= chunk;
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_buffered_reader_peek(struct sail_buffered_reader *reader, void *buf, size_t size_to_peek) {
+
+    SAIL_CHECK_PTR(reader);
+    SAIL_CHECK_PTR(buf);
+
+    SAIL_TRY(ensure_available(reader, size_to_peek));
+
+    memcpy(buf, reader->data + reader->pos, size_to_peek);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_buffered_reader_skip(struct sail_buffered_reader *reader, size_t size_to_skip) {
+
+    SAIL_CHECK_PTR(reader);
+
+    const size_t available = reader->length - reader->pos;
+
+    if (size_to_skip <= available) {
+        reader->pos += size_to_skip;
+        return SAIL_OK;
+    }
+
+    /* The underlying I/O object is positioned right after the current block. */
+    reader->pos = reader->length;
+
+    SAIL_TRY(reader->io->seek(reader->io->stream, (long)(size_to_skip - available), SEEK_CUR));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_buffered_reader_eof(struct sail_buffered_reader *reader, bool *result) {
+
+    SAIL_CHECK_PTR(reader);
+    SAIL_CHECK_PTR(result);
+
+    if (reader->pos < reader->length) {
+        *result = false;
+        return SAIL_OK;
+    }
+
+    const sail_status_t status = sail_buffered_reader_refill(reader);
+
+    if (status == SAIL_ERROR_EOF) {
+        *result = true;
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(status);
+
+    *result = false;
+
+    return SAIL_OK;
+}
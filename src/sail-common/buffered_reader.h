@@ -0,0 +1,189 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_BUFFERED_READER_H
+#define SAIL_BUFFERED_READER_H
+
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-common/compiler_specifics.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_io;
+
+/* Default read-ahead block size of buffered readers. */
+#define SAIL_BUFFERED_READER_DEFAULT_CAPACITY (64 * 1024)
+
+/*
+ * Buffered reader reads the underlying I/O object by large blocks and serves small reads
+ * from memory with inlined functions. Use it in codecs that read pixels by one to four bytes
+ * at a time, for example, in RLE decoders.
+ *
+ * The reader reads ahead, so the underlying I/O position is undefined while the reader is active.
+ * Do not use the I/O object directly until sail_finish_buffered_reader() moves the underlying
+ * I/O position back to the first unread byte.
+ *
+ * If the I/O object supports SAIL_IO_FEATURE_MAPPED, the reader serves reads from the mapped
+ * data directly without copying.
+ *
+ * Typical usage: sail_init_buffered_reader()        ->
+ *                sail_buffered_reader_read_byte()   ->
+ *                sail_buffered_reader_strict_read() ->
+ *                sail_finish_buffered_reader().
+ */
+struct sail_buffered_reader {
+
+    struct sail_io *io;
+
+    /* Allocated memory block. NULL when reading mapped data. */
+    unsigned char *buffer;
+    size_t capacity;
+
+    /* Data currently available for reading, and the reading position in it. */
+    const unsigned char *data;
+    size_t length;
+    size_t pos;
+};
+
+/*
+ * Initializes the specified buffered reader to read the specified I/O object by blocks of 'capacity'
+ * bytes. Pass 0 to use SAIL_BUFFERED_READER_DEFAULT_CAPACITY. Doesn't read anything yet.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_init_buffered_reader(struct sail_io *io, size_t capacity, struct sail_buffered_reader *reader);
+
+/*
+ * Moves the underlying I/O position to the first unread byte and frees the memory allocated by the reader.
+ * Does nothing if the reader is not initialized or already finished.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_finish_buffered_reader(struct sail_buffered_reader *reader);
+
+/*
+ * Discards the remaining data and reads the next block from the underlying I/O object.
+ * Used by the inlined functions below, codecs don't need to call it directly.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_EOF if no more data is available.
+ */
+SAIL_EXPORT sail_status_t sail_buffered_reader_refill(struct sail_buffered_reader *reader);
+
+/*
+ * Slow path of sail_buffered_reader_strict_read() when the requested size
+ * crosses the block boundary. Codecs don't need to call it directly.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_buffered_reader_strict_read_slow(struct sail_buffered_reader *reader, void *buf, size_t size_to_read);
+
+/*
+ * Copies the specified number of bytes into the buffer without consuming them.
+ * The size must not exceed the reader capacity.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_buffered_reader_peek(struct sail_buffered_reader *reader, void *buf, size_t size_to_peek);
+
+/*
+ * Skips the specified number of bytes. Seeks the underlying I/O object when skipping
+ * past the buffered data.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_buffered_reader_skip(struct sail_buffered_reader *reader, size_t size_to_skip);
+
+/*
+ * Assigns true to the specified result if all the data was read.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_buffered_reader_eof(struct sail_buffered_reader *reader, bool *result);
+
+/*
+ * Reads one byte.
+ *
+ * Returns SAIL_OK on success.
+ */
+static inline sail_status_t sail_buffered_reader_read_byte(struct sail_buffered_reader *reader, uint8_t *byte) {
+
+    if (SAIL_UNLIKELY(reader->pos == reader->length)) {
+        sail_status_t status = sail_buffered_reader_refill(reader);
+
+        if (status != SAIL_OK) {
+            return (status == SAIL_ERROR_EOF) ? SAIL_ERROR_READ_IO : status;
+        }
+    }
+
+    *byte = reader->data[reader->pos++];
+
+    return SAIL_OK;
+}
+
+/*
+ * Reads exactly the specified number of bytes. Fails if the actual number of bytes read
+ * is smaller than requested.
+ *
+ * Returns SAIL_OK on success.
+ */
+static inline sail_status_t sail_buffered_reader_strict_read(struct sail_buffered_reader *reader, void *buf, size_t size_to_read) {
+
+    if (SAIL_LIKELY(reader->length - reader->pos >= size_to_read)) {
+        memcpy(buf, reader->data + reader->pos, size_to_read);
+        reader->pos += size_to_read;
+
+        return SAIL_OK;
+    }
+
+    return sail_buffered_reader_strict_read_slow(reader, buf, size_to_read);
+}
+
+/*
+ * Returns the number of bytes already buffered by the reader and assigns the pointer to them.
+ * Reading them doesn't touch the underlying I/O object. Consume the bytes actually used
+ * with sail_buffered_reader_skip(). Returns 0 when the buffer is exhausted.
+ */
+static inline size_t sail_buffered_reader_buffered(const struct sail_buffered_reader *reader, const unsigned char **data) {
+
+    *data = reader->data + reader->pos;
+
+    return reader->length - reader->pos;
+}
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
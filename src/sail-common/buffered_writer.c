@@ -0,0 +1,117 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_init_buffered_writer(struct sail_io *io, size_t capacity, struct sail_buffered_writer *writer) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(writer);
+
+    capacity = (capacity == 0) ? SAIL_BUFFERED_WRITER_DEFAULT_CAPACITY : capacity;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(capacity, &ptr));
+
+    *writer = (struct sail_buffered_writer) {
+        .io       = io,
+        .buffer   = ptr,
+        .capacity = capacity,
+        .length   = 0,
+    };
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_finish_buffered_writer(struct sail_buffered_writer *writer) {
+
+    SAIL_CHECK_PTR(writer);
+
+    if (writer->io == NULL) {
+        return SAIL_OK;
+    }
+
+    const sail_status_t status = sail_buffered_writer_flush(writer);
+
+    sail_free(writer->buffer);
+
+    writer->io       = NULL;
+    writer->buffer   = NULL;
+    writer->capacity = 0;
+    writer->length   = 0;
+
+    return status;
+}
+
+sail_status_t sail_buffered_writer_flush(struct sail_buffered_writer *writer) {
+
+    SAIL_CHECK_PTR(writer);
+
+    if (writer->length == 0) {
+        return SAIL_OK;
+    }
+
+    /* Don't write the same data twice on error. */
+    const size_t length = writer->length;
+    writer->length = 0;
+
+    SAIL_TRY(writer->io->strict_write(writer->io->stream, writer->buffer, length));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_buffered_writer_strict_write_slow(struct sail_buffered_writer *writer, const void *buf, size_t size_to_write) {
+
+    SAIL_CHECK_PTR(writer);
+    SAIL_CHECK_PTR(buf);
+
+    /* Small write. Write the buffered data and start a new block. */
+    if (size_to_write < writer->capacity) {
+        SAIL_TRY(sail_buffered_writer_flush(writer));
+
+        memcpy(writer->buffer, buf, size_to_write);
+        writer->length = size_to_write;
+
+        return SAIL_OK;
+    }
+
+    /* Large write. Pass the buffered data and the new data with a single call. */
+    const struct sail_io_vector vectors[] = {
+        { writer->buffer, writer->length },
+        { buf,            size_to_write  },
+    };
+
+    writer->length = 0;
+
+    SAIL_TRY(sail_io_strict_write_vectored(writer->io, vectors, sizeof(vectors) / sizeof(vectors[0])));
+
+    return SAIL_OK;
+}
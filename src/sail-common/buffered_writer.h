@@ -0,0 +1,124 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_BUFFERED_WRITER_H
+#define SAIL_BUFFERED_WRITER_H
+
+#include <stddef.h> /* size_t */
+#include <string.h>
+
+#include <sail-common/compiler_specifics.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_io;
+
+/* Default buffer size of buffered writers. */
+#define SAIL_BUFFERED_WRITER_DEFAULT_CAPACITY (64 * 1024)
+
+/*
+ * Buffered writer coalesces small writes into a memory buffer and writes it to the underlying
+ * I/O object by large blocks. Use it in codecs that write many small pieces, for example,
+ * chunk headers and checksums.
+ *
+ * Writes larger than the buffer are passed to the underlying I/O object together with the buffered
+ * data with a single sail_io_strict_write_vectored() call.
+ *
+ * Do not use the I/O object directly until sail_buffered_writer_flush() or sail_finish_buffered_writer()
+ * writes the buffered data.
+ *
+ * Typical usage: sail_init_buffered_writer()          ->
+ *                sail_buffered_writer_strict_write()  ->
+ *                sail_finish_buffered_writer().
+ */
+struct sail_buffered_writer {
+
+    struct sail_io *io;
+
+    unsigned char *buffer;
+    size_t capacity;
+
+    /* Number of buffered bytes. */
+    size_t length;
+};
+
+/*
+ * Initializes the specified buffered writer to write into the specified I/O object with a buffer
+ * of 'capacity' bytes. Pass 0 to use SAIL_BUFFERED_WRITER_DEFAULT_CAPACITY.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_init_buffered_writer(struct sail_io *io, size_t capacity, struct sail_buffered_writer *writer);
+
+/*
+ * Writes the buffered data into the underlying I/O object and frees the memory allocated by the writer.
+ * Does nothing if the writer is not initialized or already finished. The memory is freed even on error.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_finish_buffered_writer(struct sail_buffered_writer *writer);
+
+/*
+ * Writes the buffered data into the underlying I/O object. Doesn't flush the I/O object itself.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_buffered_writer_flush(struct sail_buffered_writer *writer);
+
+/*
+ * Slow path of sail_buffered_writer_strict_write() when the data doesn't fit
+ * into the buffer. Codecs don't need to call it directly.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_buffered_writer_strict_write_slow(struct sail_buffered_writer *writer, const void *buf, size_t size_to_write);
+
+/*
+ * Writes exactly the specified number of bytes.
+ *
+ * Returns SAIL_OK on success.
+ */
+static inline sail_status_t sail_buffered_writer_strict_write(struct sail_buffered_writer *writer, const void *buf, size_t size_to_write) {
+
+    if (SAIL_LIKELY(writer->capacity - writer->length >= size_to_write)) {
+        memcpy(writer->buffer + writer->length, buf, size_to_write);
+        writer->length += size_to_write;
+
+        return SAIL_OK;
+    }
+
+    return sail_buffered_writer_strict_write_slow(writer, buf, size_to_write);
+}
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,77 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifdef SAIL_WIN32
+    #include <windows.h>
+#endif
+
+#include "sail-common.h"
+
+void sail_cancel(struct sail_cancellation *cancellation) {
+
+    if (cancellation == NULL) {
+        return;
+    }
+
+#ifdef SAIL_WIN32
+    InterlockedExchange(&cancellation->cancelled, 1);
+#else
+    __atomic_store_n(&cancellation->cancelled, 1, __ATOMIC_RELEASE);
+#endif
+}
+
+void sail_set_cancellation_deadline(struct sail_cancellation *cancellation, uint64_t timeout) {
+
+    if (cancellation == NULL) {
+        return;
+    }
+
+    cancellation->deadline = (timeout == 0) ? 0 : sail_now() + timeout;
+}
+
+sail_status_t sail_check_cancellation(const struct sail_cancellation *cancellation) {
+
+    if (cancellation == NULL) {
+        return SAIL_OK;
+    }
+
+#ifdef SAIL_WIN32
+    const long cancelled = InterlockedCompareExchange((volatile long *)&cancellation->cancelled, 0, 0);
+#else
+    const long cancelled = __atomic_load_n(&cancellation->cancelled, __ATOMIC_ACQUIRE);
+#endif
+
+    if (cancelled != 0) {
+        SAIL_LOG_DEBUG("The operation has been cancelled");
+        return SAIL_ERROR_CANCELLED;
+    }
+
+    if (cancellation->deadline != 0 && sail_now() >= cancellation->deadline) {
+        SAIL_LOG_DEBUG("The operation deadline has passed");
+        return SAIL_ERROR_CANCELLED;
+    }
+
+    return SAIL_OK;
+}
@@ -0,0 +1,80 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_CANCELLATION_H
+#define SAIL_CANCELLATION_H
+
+#include <stdint.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Cooperative cancellation token for long loading and saving operations. Set it in load or save
+ * options. Codecs check it between rows, strips, tiles, or channels, and return SAIL_ERROR_CANCELLED
+ * once it's cancelled or its deadline has passed. The frame being loaded or saved is discarded.
+ *
+ * A zero-initialized token is valid, and it's never cancelled and has no deadline. The token is not
+ * copied with the options, so it must outlive all the operations using it.
+ */
+struct sail_cancellation {
+
+    /* Non-zero when cancelled. Use sail_cancel() to cancel from another thread. */
+    volatile long cancelled;
+
+    /* Deadline in milliseconds since Epoch as returned by sail_now(). 0 means no deadline. */
+    uint64_t deadline;
+};
+
+typedef struct sail_cancellation sail_cancellation_t;
+
+/*
+ * Cancels all the operations using the token. It's safe to call from any thread.
+ */
+SAIL_EXPORT void sail_cancel(struct sail_cancellation *cancellation);
+
+/*
+ * Sets the token deadline to the specified number of milliseconds from now. 0 removes the deadline.
+ */
+SAIL_EXPORT void sail_set_cancellation_deadline(struct sail_cancellation *cancellation, uint64_t timeout);
+
+/*
+ * Checks the token. Codecs call it between rows, strips, tiles, or channels.
+ *
+ * Returns SAIL_OK if the token is NULL, not cancelled, and its deadline has not passed,
+ * or SAIL_ERROR_CANCELLED otherwise.
+ */
+SAIL_EXPORT sail_status_t sail_check_cancellation(const struct sail_cancellation *cancellation);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
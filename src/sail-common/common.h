@@ -33,7 +33,10 @@
  * Common data structures and functions used across SAIL, both in libsail and in image codecs.
  */
 
-/* Pixel format */
+/*
+ * Pixel format. Samples wider than 8 bits are stored in the host byte order. Codecs convert big-endian
+ * samples from image files, for example 16-bit PNM and PNG samples, while loading.
+ */
 enum SailPixelFormat {
 
     /*
@@ -170,6 +173,46 @@ enum SailPixelFormat {
     SAIL_PIXEL_FORMAT_BPP40_YUVA,
     SAIL_PIXEL_FORMAT_BPP48_YUVA,
     SAIL_PIXEL_FORMAT_BPP64_YUVA,
+
+    /*
+     * RGBA formats with color components premultiplied by alpha.
+     */
+    SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED,
+    SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED,
+
+    SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED,
+    SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED,
+
+    /*
+     * Planar 8-bit YCbCr formats with the same JFIF values as BPP24_YCBCR. The planes follow each other
+     * in the pixels buffer without padding, and bytes_per_line is always sail_bytes_per_line().
+     * Use sail_image_planes() to get the planes. 4:2:0 formats require even image dimensions.
+     */
+    SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420, /* Y plane, then Cb and Cr planes of half the width and height. */
+    SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12, /* Y plane, then an interleaved CbCr plane of half the height.   */
+    SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444, /* Y, Cb, and Cr planes of the full size.                        */
+
+    /*
+     * Floating point formats with IEEE 754 components in the host byte order and straight alpha.
+     * The nominal range is [0; 1]. HDR values above 1 are kept as is, and they are clamped
+     * when converting into integer pixel formats.
+     */
+    SAIL_PIXEL_FORMAT_BPP48_RGB_HALF,   /* 16-bit half precision RGB.    */
+    SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF,  /* 16-bit half precision RGBA.   */
+    SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, /* 32-bit single precision RGBA. */
+
+    /*
+     * Block-compressed GPU texture formats, also known as S3TC and RGTC/BPTC. Every 4x4 block of pixels
+     * is stored in 8 or 16 bytes, and the blocks follow each other left to right and top to bottom without
+     * padding. bytes_per_line is always sail_bytes_per_line(), so a row of blocks spans 4 lines.
+     * The image dimensions must be multiples of 4. Use sail-manip to convert from and into these formats.
+     */
+    SAIL_PIXEL_FORMAT_BPP4_BC1, /* RGB with 1-bit alpha, 8 bytes per block, aka DXT1.     */
+    SAIL_PIXEL_FORMAT_BPP8_BC2, /* RGB with 4-bit alpha, 16 bytes per block, aka DXT3.    */
+    SAIL_PIXEL_FORMAT_BPP8_BC3, /* RGB with interpolated alpha, 16 bytes per block, aka DXT5. */
+    SAIL_PIXEL_FORMAT_BPP4_BC4, /* One unsigned channel, 8 bytes per block, aka ATI1.      */
+    SAIL_PIXEL_FORMAT_BPP8_BC5, /* Two unsigned channels, 16 bytes per block, aka ATI2.    */
+    SAIL_PIXEL_FORMAT_BPP8_BC7, /* High quality RGBA, 16 bytes per block.                  */
 };
 
 /* Chroma subsampling. See https://en.wikipedia.org/wiki/Chroma_subsampling */
@@ -318,6 +361,33 @@ enum SailCodecFeature {
 
     /* Can preserve the source image information. */
     SAIL_CODEC_FEATURE_SOURCE_IMAGE = 1 << 7,
+
+    /* Can load a region of interest natively. See sail_load_options.roi. */
+    SAIL_CODEC_FEATURE_ROI          = 1 << 8,
+
+    /* Can load images at a reduced resolution natively. See sail_load_options.scale_denominator. */
+    SAIL_CODEC_FEATURE_SCALING      = 1 << 9,
+
+    /* Can load or save images row by row. See sail_load_options.row_callback and sail_save_options.row_callback. */
+    SAIL_CODEC_FEATURE_ROWS         = 1 << 10,
+
+    /* Can pass intermediate passes of progressive frames to sail_load_options.pass_callback. */
+    SAIL_CODEC_FEATURE_PASSES       = 1 << 11,
+
+    /* Can seek to an arbitrary frame without loading the preceding frames. See sail_load_frame_at(). */
+    SAIL_CODEC_FEATURE_SEEK         = 1 << 12,
+
+    /* Can reuse the decoder for the next image. See sail_restart_loading_from_io(). */
+    SAIL_CODEC_FEATURE_RESET        = 1 << 13,
+
+    /*
+     * Frames don't depend on each other, so they can be loaded in parallel with separate
+     * loading states. Requires SAIL_CODEC_FEATURE_SEEK. See sail_load_frames_from_memory().
+     */
+    SAIL_CODEC_FEATURE_PARALLEL     = 1 << 14,
+
+    /* Can decode data fed as it arrives without blocking, row by row. See sail_alloc_push_decoder(). */
+    SAIL_CODEC_FEATURE_PUSH         = 1 << 15,
 };
 
 /* Load or save options. */
@@ -340,6 +410,88 @@ enum SailOption {
      * Specifying this option for saving operations has no effect.
      */
     SAIL_OPTION_SOURCE_IMAGE = 1 << 3,
+
+    /*
+     * Instruction to load only the image properties like dimensions and pixel format
+     * in loading operations. Codecs read the minimum number of header bytes and skip
+     * the work needed to decode pixels. Meta data and ICC profiles are not loaded
+     * even if SAIL_OPTION_META_DATA or SAIL_OPTION_ICCP are specified. sail_load_next_frame()
+     * returns a frame without pixels. Only the first frame is guaranteed to be returned.
+     * Specifying this option for saving operations has no effect.
+     */
+    SAIL_OPTION_PROBE        = 1 << 4,
+
+    /*
+     * Instruction to load only the changed areas of animation frames in loading operations.
+     * Requires SAIL_OPTION_SOURCE_IMAGE. Codecs still composite every frame into a full canvas,
+     * but return only the dirty rectangle of the canvas that differs from the previous frame
+     * instead of the whole canvas. The first frame always covers the whole canvas.
+     * The rectangle position and the canvas size are stored in the source image special properties
+     * as "animation-frame-x", "animation-frame-y", "animation-canvas-width", and "animation-canvas-height"
+     * unsigned int values. Supported by the GIF, APNG, and WEBP codecs. Other codecs ignore it.
+     * Specifying this option for saving operations has no effect.
+     */
+    SAIL_OPTION_DIRTY_RECTANGLES = 1 << 5,
+
+    /*
+     * Instruction to store decoding diagnostics in the source image special properties
+     * in loading operations. Requires SAIL_OPTION_SOURCE_IMAGE. Diagnostics tell how a frame
+     * was decoded, for example, whether the codec used fast paths or fell back to slow generic ones,
+     * and are available after the frame pixels are loaded. SAIL stores:
+     *   - "bytes-read"                 - unsigned long number of bytes the codec consumed from the I/O
+     *                                    stream since the loading started including read-ahead buffers.
+     *   - "native-output-pixel-format" - bool, true if the codec decoded into the requested output
+     *                                    pixel format. Stored only if the output pixel format is set.
+     *   - "crop-fallback"              - bool, true if the codec decoded the whole frame and SAIL cropped
+     *                                    the region of interest out of it. Stored only if the ROI is set.
+     *   - "rows-fallback"              - bool, true if the codec decoded the whole frame and SAIL passed
+     *                                    its rows to the row callback. Stored only if the row callback is set.
+     * Codecs store their own diagnostics with the codec name prefix like "jpeg-scale-denom".
+     * Specifying this option for saving operations has no effect.
+     */
+    SAIL_OPTION_DIAGNOSTICS = 1 << 6,
+
+    /*
+     * Instruction to apply the orientation stored in the image, like the EXIF orientation of JPEG,
+     * while decoding in loading operations. Rows are written right into their places in the rotated
+     * or mirrored frame, so frames are returned in their display orientation without an extra pass.
+     * The dimensions and the resolution of transposed frames are swapped, and a region of interest
+     * is in the coordinates of the oriented frame. The source image orientation of oriented frames
+     * is SAIL_ORIENTATION_NORMAL, and they are decoded in a single pass. Supported by the JPEG codec.
+     * Other codecs ignore it, and report the orientation in the source image instead.
+     * Specifying this option for saving operations has no effect.
+     */
+    SAIL_OPTION_AUTO_ORIENT = 1 << 7,
+
+    /*
+     * Instruction to allocate the small side structures of frames, like the resolution, the palette,
+     * the meta data, and the source image, in a per-frame arena in loading operations. The arena
+     * is released with a single free by sail_destroy_image(), so the side structures must not
+     * outlive the image. Useful to probe many files. See sail_image.arena.
+     * Specifying this option for saving operations has no effect.
+     */
+    SAIL_OPTION_ARENA = 1 << 8,
+
+    /*
+     * Instruction to load only the first frame in loading operations. sail_load_next_frame()
+     * returns SAIL_ERROR_NO_MORE_FRAMES after the first frame without parsing the rest of the image.
+     * Animation codecs composite the first frame right into the frame pixels, and skip allocating
+     * canvases and buffers needed only to composite next frames. sail_load_from_file() and
+     * sail_load_from_memory() always specify this option.
+     * Specifying this option for saving operations has no effect.
+     */
+    SAIL_OPTION_FIRST_FRAME_ONLY = 1 << 9,
+
+    /*
+     * Instruction to copy the source bitstream as is in sail_transcode() instead of decoding
+     * and encoding frames when the input and output codecs are the same and no conversion
+     * callback is specified. Meta data and ICC profiles are dropped at the container level,
+     * like JPEG markers, PNG chunks, and RIFF chunks, unless SAIL_OPTION_META_DATA or SAIL_OPTION_ICCP
+     * are also specified. Other save options are ignored. Supported by the JPEG, PNG, and WEBP codecs.
+     * Other codecs decode and encode frames as usual.
+     * Specifying this option for loading operations has no effect.
+     */
+    SAIL_OPTION_PASSTHROUGH = 1 << 10,
 };
 
 #endif
@@ -23,8 +23,16 @@
     SOFTWARE.
 */
 
+#include <string.h>
+
 #include "sail-common.h"
 
+/* Hashes only select the candidate enum value. Strings that merely collide with a name are rejected. */
+static inline bool is_name(const char *str, const char *name) {
+
+    return str != NULL && name != NULL && strcmp(str, name) == 0;
+}
+
 const char* sail_pixel_format_to_string(enum SailPixelFormat pixel_format) {
 
     switch (pixel_format) {
@@ -123,12 +131,33 @@ const char* sail_pixel_format_to_string(enum SailPixelFormat pixel_format) {
         case SAIL_PIXEL_FORMAT_BPP40_YUVA:            return "BPP40-YUVA";
         case SAIL_PIXEL_FORMAT_BPP48_YUVA:            return "BPP48-YUVA";
         case SAIL_PIXEL_FORMAT_BPP64_YUVA:            return "BPP64-YUVA";
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED: return "BPP32-RGBA-PREMULTIPLIED";
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED: return "BPP32-BGRA-PREMULTIPLIED";
+
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED: return "BPP64-RGBA-PREMULTIPLIED";
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: return "BPP64-BGRA-PREMULTIPLIED";
+
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420:      return "BPP12-YCBCR-I420";
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12:      return "BPP12-YCBCR-NV12";
+        case SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444:      return "BPP24-YCBCR-I444";
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:        return "BPP48-RGB-HALF";
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:       return "BPP64-RGBA-HALF";
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT:     return "BPP128-RGBA-FLOAT";
+
+        case SAIL_PIXEL_FORMAT_BPP4_BC1:              return "BPP4-BC1";
+        case SAIL_PIXEL_FORMAT_BPP8_BC2:              return "BPP8-BC2";
+        case SAIL_PIXEL_FORMAT_BPP8_BC3:              return "BPP8-BC3";
+        case SAIL_PIXEL_FORMAT_BPP4_BC4:              return "BPP4-BC4";
+        case SAIL_PIXEL_FORMAT_BPP8_BC5:              return "BPP8-BC5";
+        case SAIL_PIXEL_FORMAT_BPP8_BC7:              return "BPP8-BC7";
     }
 
     return NULL;
 }
 
-enum SailPixelFormat sail_pixel_format_from_string(const char *str) {
+static enum SailPixelFormat pixel_format_from_hash(uint64_t hash) {
 
     /*
      * The switch doesn't look very nice, I know :) However, it's fast and doesn't require
@@ -137,7 +166,7 @@ enum SailPixelFormat sail_pixel_format_from_string(const char *str) {
      *     1. Introduce extra data structures and their initializations to work with hashes.
      *     2. Use a single ugly looking switch/case.
      */
-    switch (sail_string_hash(str)) {
+    switch (hash) {
         case UINT64_C(229442760833397):      return SAIL_PIXEL_FORMAT_UNKNOWN;
 
         case UINT64_C(6383902552):           return SAIL_PIXEL_FORMAT_BPP1;
@@ -233,11 +262,39 @@ enum SailPixelFormat sail_pixel_format_from_string(const char *str) {
         case UINT64_C(8244605668934919965):  return SAIL_PIXEL_FORMAT_BPP40_YUVA;
         case UINT64_C(8244605669248003109):  return SAIL_PIXEL_FORMAT_BPP48_YUVA;
         case UINT64_C(8244605671674397475):  return SAIL_PIXEL_FORMAT_BPP64_YUVA;
+
+        case UINT64_C(5755462582571748834):  return SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED;
+        case UINT64_C(10184454581647182306): return SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED;
+
+        case UINT64_C(403932174454299175):   return SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED;
+        case UINT64_C(4832924173529732647):  return SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED;
+
+        case UINT64_C(1347690752422677174):  return SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420;
+        case UINT64_C(1347690752422893854):  return SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12;
+        case UINT64_C(3116664480403115839):  return SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444;
+
+        case UINT64_C(12558027227981272355): return SAIL_PIXEL_FORMAT_BPP48_RGB_HALF;
+        case UINT64_C(8681486799609175842):  return SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF;
+        case UINT64_C(8069583518561661742):  return SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT;
+
+        case UINT64_C(7570804103619454):     return SAIL_PIXEL_FORMAT_BPP4_BC1;
+        case UINT64_C(7570804108363139):     return SAIL_PIXEL_FORMAT_BPP8_BC2;
+        case UINT64_C(7570804108363140):     return SAIL_PIXEL_FORMAT_BPP8_BC3;
+        case UINT64_C(7570804103619457):     return SAIL_PIXEL_FORMAT_BPP4_BC4;
+        case UINT64_C(7570804108363142):     return SAIL_PIXEL_FORMAT_BPP8_BC5;
+        case UINT64_C(7570804108363144):     return SAIL_PIXEL_FORMAT_BPP8_BC7;
     }
 
     return SAIL_PIXEL_FORMAT_UNKNOWN;
 }
 
+enum SailPixelFormat sail_pixel_format_from_string(const char *str) {
+
+    const enum SailPixelFormat pixel_format = pixel_format_from_hash(sail_string_hash(str));
+
+    return is_name(str, sail_pixel_format_to_string(pixel_format)) ? pixel_format : SAIL_PIXEL_FORMAT_UNKNOWN;
+}
+
 const char* sail_chroma_subsampling_to_string(enum SailChromaSubsampling chroma_subsampling) {
 
     switch (chroma_subsampling) {
@@ -255,9 +312,9 @@ const char* sail_chroma_subsampling_to_string(enum SailChromaSubsampling chroma_
     return NULL;
 }
 
-enum SailChromaSubsampling sail_chroma_subsampling_from_string(const char *str) {
+static enum SailChromaSubsampling chroma_subsampling_from_hash(uint64_t hash) {
 
-    switch (sail_string_hash(str)) {
+    switch (hash) {
         case UINT64_C(229442760833397): return SAIL_CHROMA_SUBSAMPLING_UNKNOWN;
         case UINT64_C(193434202):       return SAIL_CHROMA_SUBSAMPLING_311;
         case UINT64_C(193435257):       return SAIL_CHROMA_SUBSAMPLING_400;
@@ -272,6 +329,13 @@ enum SailChromaSubsampling sail_chroma_subsampling_from_string(const char *str)
     return SAIL_CHROMA_SUBSAMPLING_UNKNOWN;
 }
 
+enum SailChromaSubsampling sail_chroma_subsampling_from_string(const char *str) {
+
+    const enum SailChromaSubsampling chroma_subsampling = chroma_subsampling_from_hash(sail_string_hash(str));
+
+    return is_name(str, sail_chroma_subsampling_to_string(chroma_subsampling)) ? chroma_subsampling : SAIL_CHROMA_SUBSAMPLING_UNKNOWN;
+}
+
 const char* sail_orientation_to_string(enum SailOrientation orientation) {
 
     switch (orientation) {
@@ -288,9 +352,9 @@ const char* sail_orientation_to_string(enum SailOrientation orientation) {
     return NULL;
 }
 
-enum SailOrientation sail_orientation_from_string(const char *str) {
+static enum SailOrientation orientation_from_hash(uint64_t hash) {
 
-    switch (sail_string_hash(str)) {
+    switch (hash) {
         case UINT64_C(6952538422510):        return SAIL_ORIENTATION_NORMAL;
         case UINT64_C(8245347034976125518):  return SAIL_ORIENTATION_ROTATED_90;
         case UINT64_C(13842035122278411070): return SAIL_ORIENTATION_ROTATED_180;
@@ -304,6 +368,13 @@ enum SailOrientation sail_orientation_from_string(const char *str) {
     return SAIL_ORIENTATION_NORMAL;
 }
 
+enum SailOrientation sail_orientation_from_string(const char *str) {
+
+    const enum SailOrientation orientation = orientation_from_hash(sail_string_hash(str));
+
+    return is_name(str, sail_orientation_to_string(orientation)) ? orientation : SAIL_ORIENTATION_NORMAL;
+}
+
 const char* sail_compression_to_string(enum SailCompression compression) {
 
     switch (compression) {
@@ -351,9 +422,9 @@ const char* sail_compression_to_string(enum SailCompression compression) {
     return NULL;
 }
 
-enum SailCompression sail_compression_from_string(const char *str) {
+static enum SailCompression compression_from_hash(uint64_t hash) {
 
-    switch (sail_string_hash(str)) {
+    switch (hash) {
         case UINT64_C(229442760833397):      return SAIL_COMPRESSION_UNKNOWN;
         case UINT64_C(6384332661):           return SAIL_COMPRESSION_NONE;
         case UINT64_C(10962109560604417378): return SAIL_COMPRESSION_ADOBE_DEFLATE;
@@ -398,6 +469,13 @@ enum SailCompression sail_compression_from_string(const char *str) {
     return SAIL_COMPRESSION_UNKNOWN;
 }
 
+enum SailCompression sail_compression_from_string(const char *str) {
+
+    const enum SailCompression compression = compression_from_hash(sail_string_hash(str));
+
+    return is_name(str, sail_compression_to_string(compression)) ? compression : SAIL_COMPRESSION_UNKNOWN;
+}
+
 const char* sail_meta_data_to_string(enum SailMetaData meta_data) {
 
     switch (meta_data) {
@@ -435,9 +513,9 @@ const char* sail_meta_data_to_string(enum SailMetaData meta_data) {
     return NULL;
 }
 
-enum SailMetaData sail_meta_data_from_string(const char *str) {
+static enum SailMetaData meta_data_from_hash(uint64_t hash) {
 
-    switch (sail_string_hash(str)) {
+    switch (hash) {
         case UINT64_C(229444052301365):      return SAIL_META_DATA_UNKNOWN;
 
         case UINT64_C(6952072423676):        return SAIL_META_DATA_ARTIST;
@@ -472,6 +550,13 @@ enum SailMetaData sail_meta_data_from_string(const char *str) {
     return SAIL_META_DATA_UNKNOWN;
 }
 
+enum SailMetaData sail_meta_data_from_string(const char *str) {
+
+    const enum SailMetaData meta_data = meta_data_from_hash(sail_string_hash(str));
+
+    return is_name(str, sail_meta_data_to_string(meta_data)) ? meta_data : SAIL_META_DATA_UNKNOWN;
+}
+
 const char* sail_resolution_unit_to_string(enum SailResolutionUnit resolution_unit) {
 
     switch (resolution_unit) {
@@ -485,9 +570,9 @@ const char* sail_resolution_unit_to_string(enum SailResolutionUnit resolution_un
     return NULL;
 }
 
-enum SailResolutionUnit sail_resolution_unit_from_string(const char *str) {
+static enum SailResolutionUnit resolution_unit_from_hash(uint64_t hash) {
 
-    switch (sail_string_hash(str)) {
+    switch (hash) {
         case UINT64_C(229444052301365):     return SAIL_RESOLUTION_UNIT_UNKNOWN;
         case UINT64_C(8245152247842122364): return SAIL_RESOLUTION_UNIT_MICROMETER;
         case UINT64_C(8244682978514626197): return SAIL_RESOLUTION_UNIT_CENTIMETER;
@@ -498,6 +583,13 @@ enum SailResolutionUnit sail_resolution_unit_from_string(const char *str) {
     return SAIL_RESOLUTION_UNIT_UNKNOWN;
 }
 
+enum SailResolutionUnit sail_resolution_unit_from_string(const char *str) {
+
+    const enum SailResolutionUnit resolution_unit = resolution_unit_from_hash(sail_string_hash(str));
+
+    return is_name(str, sail_resolution_unit_to_string(resolution_unit)) ? resolution_unit : SAIL_RESOLUTION_UNIT_UNKNOWN;
+}
+
 const char* sail_codec_feature_to_string(enum SailCodecFeature codec_feature) {
 
     switch (codec_feature) {
@@ -509,14 +601,22 @@ const char* sail_codec_feature_to_string(enum SailCodecFeature codec_feature) {
         case SAIL_CODEC_FEATURE_INTERLACED:   return "INTERLACED";
         case SAIL_CODEC_FEATURE_ICCP:         return "ICCP";
         case SAIL_CODEC_FEATURE_SOURCE_IMAGE: return "SOURCE-IMAGE";
+        case SAIL_CODEC_FEATURE_ROI:          return "ROI";
+        case SAIL_CODEC_FEATURE_SCALING:      return "SCALING";
+        case SAIL_CODEC_FEATURE_ROWS:         return "ROWS";
+        case SAIL_CODEC_FEATURE_PASSES:       return "PASSES";
+        case SAIL_CODEC_FEATURE_SEEK:         return "SEEK";
+        case SAIL_CODEC_FEATURE_RESET:        return "RESET";
+        case SAIL_CODEC_FEATURE_PARALLEL:     return "PARALLEL";
+        case SAIL_CODEC_FEATURE_PUSH:         return "PUSH";
     }
 
     return NULL;
 }
 
-enum SailCodecFeature sail_codec_feature_from_string(const char *str) {
+static enum SailCodecFeature codec_feature_from_hash(uint64_t hash) {
 
-    switch (sail_string_hash(str)) {
+    switch (hash) {
         case UINT64_C(229442760833397):      return SAIL_CODEC_FEATURE_UNKNOWN;
         case UINT64_C(6952739426029):        return SAIL_CODEC_FEATURE_STATIC;
         case UINT64_C(7570758658679240):     return SAIL_CODEC_FEATURE_ANIMATED;
@@ -525,7 +625,22 @@ enum SailCodecFeature sail_codec_feature_from_string(const char *str) {
         case UINT64_C(8244927930303708800):  return SAIL_CODEC_FEATURE_INTERLACED;
         case UINT64_C(6384139556):           return SAIL_CODEC_FEATURE_ICCP;
         case UINT64_C(14115912967723543398): return SAIL_CODEC_FEATURE_SOURCE_IMAGE;
+        case UINT64_C(193468975):            return SAIL_CODEC_FEATURE_ROI;
+        case UINT64_C(229439735470214):      return SAIL_CODEC_FEATURE_SCALING;
+        case UINT64_C(6384476720):           return SAIL_CODEC_FEATURE_ROWS;
+        case UINT64_C(6952600133012):        return SAIL_CODEC_FEATURE_PASSES;
+        case UINT64_C(6384501165):           return SAIL_CODEC_FEATURE_SEEK;
+        case UINT64_C(210687367656):         return SAIL_CODEC_FEATURE_RESET;
+        case UINT64_C(7571381484614386):     return SAIL_CODEC_FEATURE_PARALLEL;
+        case UINT64_C(6384411237):           return SAIL_CODEC_FEATURE_PUSH;
     }
 
     return SAIL_CODEC_FEATURE_UNKNOWN;
 }
+
+enum SailCodecFeature sail_codec_feature_from_string(const char *str) {
+
+    const enum SailCodecFeature codec_feature = codec_feature_from_hash(sail_string_hash(str));
+
+    return is_name(str, sail_codec_feature_to_string(codec_feature)) ? codec_feature : SAIL_CODEC_FEATURE_UNKNOWN;
+}
@@ -49,4 +49,19 @@
     #define SAIL_UNLIKELY(x) (x)
 #endif
 
+/* Host byte order. Defined to 1 on little-endian hosts. */
+#if defined _MSC_VER
+    #define SAIL_LITTLE_ENDIAN 1
+#elif defined __BYTE_ORDER__ && defined __ORDER_LITTLE_ENDIAN__
+    #if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        #define SAIL_LITTLE_ENDIAN 1
+    #else
+        #define SAIL_LITTLE_ENDIAN 0
+    #endif
+#elif defined __LITTLE_ENDIAN__ || defined __i386__ || defined __x86_64__ || defined __aarch64__
+    #define SAIL_LITTLE_ENDIAN 1
+#else
+    #define SAIL_LITTLE_ENDIAN 0
+#endif
+
 #endif
@@ -30,9 +30,179 @@
 /*
  * Private functions.
  */
-static inline uint64_t calculate_hash(const char *key) {
 
-    return sail_string_hash(key) % SAIL_HASH_MAP_SIZE;
+/* Slots allocated with the hash map follow it, so its size is rounded up to their alignment. */
+#define SAIL_HASH_MAP_HEADER_SIZE ((sizeof(struct sail_hash_map) + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t))
+
+static inline struct sail_hash_map_slot* header_slots(const struct sail_hash_map *hash_map) {
+
+    return (struct sail_hash_map_slot *)((char *)hash_map + SAIL_HASH_MAP_HEADER_SIZE);
+}
+
+/* Allocates a hash map with the specified capacity of the slots allocated with it. */
+static sail_status_t alloc_hash_map(size_t capacity, struct sail_hash_map **hash_map) {
+
+    void *ptr;
+    SAIL_TRY(sail_private_arena_malloc(SAIL_HASH_MAP_HEADER_SIZE + capacity * sizeof(struct sail_hash_map_slot), &ptr));
+    struct sail_hash_map *hash_map_local = ptr;
+
+    hash_map_local->slots    = header_slots(hash_map_local);
+    hash_map_local->capacity = capacity;
+    hash_map_local->size     = 0;
+
+    memset(hash_map_local->slots, 0, capacity * sizeof(struct sail_hash_map_slot));
+
+    *hash_map = hash_map_local;
+
+    return SAIL_OK;
+}
+
+static void destroy_slot(struct sail_hash_map_slot *slot) {
+
+    if (slot->key != slot->inline_key) {
+        sail_free(slot->key);
+    }
+    if (slot->value.value != slot->value.inline_value.bytes) {
+        sail_free(slot->value.value);
+    }
+
+    slot->key = NULL;
+}
+
+/* Moves the slot contents and repoints inline keys and values to the new place. */
+static void move_slot(struct sail_hash_map_slot *source, struct sail_hash_map_slot *target) {
+
+    *target = *source;
+
+    if (source->key == source->inline_key) {
+        target->key = target->inline_key;
+    }
+    if (source->value.value == source->value.inline_value.bytes) {
+        target->value.value = target->value.inline_value.bytes;
+    }
+
+    source->key = NULL;
+}
+
+/* Stores the variant value in the empty or occupied slot. Keeps the old value on error. */
+static sail_status_t set_slot_value(struct sail_hash_map_slot *slot, const struct sail_variant *value) {
+
+    void *old_value = slot->value.value;
+    void *new_value;
+
+    if (value->size <= SAIL_VARIANT_INLINE_SIZE) {
+        new_value = slot->value.inline_value.bytes;
+    } else {
+        SAIL_TRY(sail_private_arena_malloc(value->size, &new_value));
+    }
+
+    if (old_value != NULL && old_value != slot->value.inline_value.bytes) {
+        sail_free(old_value);
+    }
+
+    memcpy(new_value, value->value, value->size);
+
+    slot->value.type  = value->type;
+    slot->value.value = new_value;
+    slot->value.size  = value->size;
+
+    return SAIL_OK;
+}
+
+/* Stores the key and the value in the empty slot. */
+static sail_status_t fill_slot(struct sail_hash_map_slot *slot, uint64_t hash, const char *key, const struct sail_variant *value) {
+
+    const size_t key_size = strlen(key) + 1;
+    char *key_local;
+
+    if (key_size <= SAIL_HASH_MAP_INLINE_KEY_SIZE) {
+        key_local = slot->inline_key;
+    } else {
+        void *ptr;
+        SAIL_TRY(sail_private_arena_malloc(key_size, &ptr));
+        key_local = ptr;
+    }
+
+    memcpy(key_local, key, key_size);
+
+    slot->value.value = NULL;
+
+    const sail_status_t status = set_slot_value(slot, value);
+
+    if (status != SAIL_OK) {
+        if (key_local != slot->inline_key) {
+            sail_free(key_local);
+        }
+        return status;
+    }
+
+    slot->hash = hash;
+    slot->key  = key_local;
+
+    return SAIL_OK;
+}
+
+/* Returns the slot index of the key or the index of the empty slot to put it into. */
+static size_t find_slot(const struct sail_hash_map *hash_map, uint64_t hash, const char *key) {
+
+    const size_t mask = hash_map->capacity - 1;
+    size_t index = (size_t)hash & mask;
+
+    while (hash_map->slots[index].key != NULL) {
+        const struct sail_hash_map_slot *slot = &hash_map->slots[index];
+
+        if (slot->hash == hash && strcmp(slot->key, key) == 0) {
+            break;
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    return index;
+}
+
+static struct sail_hash_map_slot* find_key(const struct sail_hash_map *hash_map, const char *key) {
+
+    struct sail_hash_map_slot *slot = &hash_map->slots[find_slot(hash_map, sail_string_hash(key), key)];
+
+    return slot->key == NULL ? NULL : slot;
+}
+
+/* Doubles the number of slots and moves the keys there. */
+static sail_status_t grow(struct sail_hash_map *hash_map) {
+
+    const size_t capacity = hash_map->capacity * 2;
+
+    void *ptr;
+    SAIL_TRY(sail_calloc(capacity, sizeof(struct sail_hash_map_slot), &ptr));
+    struct sail_hash_map_slot *slots = ptr;
+
+    const size_t mask = capacity - 1;
+
+    for (size_t i = 0; i < hash_map->capacity; i++) {
+        struct sail_hash_map_slot *slot = &hash_map->slots[i];
+
+        if (slot->key == NULL) {
+            continue;
+        }
+
+        size_t index = (size_t)slot->hash & mask;
+
+        while (slots[index].key != NULL) {
+            index = (index + 1) & mask;
+        }
+
+        move_slot(slot, &slots[index]);
+    }
+
+    if (hash_map->slots != header_slots(hash_map)) {
+        sail_free(hash_map->slots);
+    }
+
+    hash_map->slots    = slots;
+    hash_map->capacity = capacity;
+
+    return SAIL_OK;
 }
 
 /*
@@ -42,13 +212,7 @@ sail_status_t sail_alloc_hash_map(struct sail_hash_map **hash_map) {
 
     SAIL_CHECK_PTR(hash_map);
 
-    void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct sail_hash_map), &ptr));
-    *hash_map = ptr;
-
-    for (size_t i = 0; i < SAIL_HASH_MAP_SIZE; i++) {
-        (*hash_map)->buckets[i] = NULL;
-    }
+    SAIL_TRY(alloc_hash_map(SAIL_HASH_MAP_INITIAL_CAPACITY, hash_map));
 
     return SAIL_OK;
 }
@@ -61,6 +225,10 @@ void sail_destroy_hash_map(struct sail_hash_map *hash_map) {
 
     sail_clear_hash_map(hash_map);
 
+    if (hash_map->slots != header_slots(hash_map)) {
+        sail_free(hash_map->slots);
+    }
+
     sail_free(hash_map);
 }
 
@@ -68,36 +236,29 @@ sail_status_t sail_put_hash_map(struct sail_hash_map *hash_map, const char *key,
 
     SAIL_CHECK_PTR(hash_map);
     SAIL_CHECK_PTR(key);
-    SAIL_CHECK_PTR(value);
+    SAIL_TRY(sail_check_variant_valid(value));
 
-    struct sail_variant_node **key_variant_node;
+    const uint64_t hash = sail_string_hash(key);
+    struct sail_hash_map_slot *slot = &hash_map->slots[find_slot(hash_map, hash, key)];
 
-    for (key_variant_node = &hash_map->buckets[calculate_hash(key)]; *key_variant_node != NULL; key_variant_node = &(*key_variant_node)->next->next) {
-        struct sail_variant_node *value_variant_node = (*key_variant_node)->next;
-
-        if (strcmp(sail_variant_to_string((*key_variant_node)->variant), key) == 0) {
-            if (!sail_equal_variants(value_variant_node->variant, value)) {
-                /* Overwrite value. */
-                sail_destroy_variant(value_variant_node->variant);
-                SAIL_TRY(sail_copy_variant(value, &value_variant_node->variant));
-            }
-
-            return SAIL_OK;
+    if (slot->key != NULL) {
+        if (!sail_equal_variants(&slot->value, value)) {
+            /* Overwrite value. */
+            SAIL_TRY(set_slot_value(slot, value));
         }
-    }
 
-    struct sail_variant_node *local_variant_node;
+        return SAIL_OK;
+    }
 
-    SAIL_TRY(sail_alloc_variant_node_and_value(&local_variant_node));
-    SAIL_TRY_OR_CLEANUP(sail_set_variant_string(local_variant_node->variant, key),
-                        /* cleanup */ sail_destroy_variant_node_chain(local_variant_node));
+    /* Keep the load factor under 3/4. */
+    if ((hash_map->size + 1) * 4 > hash_map->capacity * 3) {
+        SAIL_TRY(grow(hash_map));
+        slot = &hash_map->slots[find_slot(hash_map, hash, key)];
+    }
 
-    SAIL_TRY_OR_CLEANUP(sail_alloc_variant_node(&local_variant_node->next),
-                        /* cleanup */ sail_destroy_variant_node_chain(local_variant_node));
-    SAIL_TRY_OR_CLEANUP(sail_copy_variant(value, &local_variant_node->next->variant),
-                        /* cleanup */ sail_destroy_variant_node_chain(local_variant_node));
+    SAIL_TRY(fill_slot(slot, hash, key, value));
 
-    *key_variant_node = local_variant_node;
+    hash_map->size++;
 
     return SAIL_OK;
 }
@@ -108,15 +269,7 @@ bool sail_hash_map_has_key(const struct sail_hash_map *hash_map, const char *key
         return false;
     }
 
-    for (const struct sail_variant_node *key_variant_node = hash_map->buckets[calculate_hash(key)];
-            key_variant_node != NULL;
-            key_variant_node = key_variant_node->next->next) {
-        if (strcmp(sail_variant_to_string(key_variant_node->variant), key) == 0) {
-            return true;
-        }
-    }
-
-    return false;
+    return find_key(hash_map, key) != NULL;
 }
 
 struct sail_variant* sail_hash_map_value(const struct sail_hash_map *hash_map, const char *key) {
@@ -125,38 +278,23 @@ struct sail_variant* sail_hash_map_value(const struct sail_hash_map *hash_map, c
         return NULL;
     }
 
-    for (struct sail_variant_node *key_variant_node = hash_map->buckets[calculate_hash(key)];
-            key_variant_node != NULL;
-            key_variant_node = key_variant_node->next->next) {
-        if (strcmp(sail_variant_to_string(key_variant_node->variant), key) == 0) {
-            return key_variant_node->next->variant;
-        }
-    }
+    struct sail_hash_map_slot *slot = find_key(hash_map, key);
 
-    return NULL;
+    return slot == NULL ? NULL : &slot->value;
 }
 
 unsigned sail_hash_map_size(const struct sail_hash_map *hash_map) {
 
-    unsigned size = 0;
-
-    for (size_t i = 0; i < SAIL_HASH_MAP_SIZE; i++) {
-        for (struct sail_variant_node *key_variant_node = hash_map->buckets[i];
-                key_variant_node != NULL;
-                key_variant_node = key_variant_node->next->next) {
-            size++;
-        }
-    }
-
-    return size;
+    return (unsigned)hash_map->size;
 }
 
 void sail_traverse_hash_map(const struct sail_hash_map *hash_map, bool (*callback)(const char *key, const struct sail_variant *value)){
 
-    for (size_t i = 0; i < SAIL_HASH_MAP_SIZE; i++) {
-        for (const struct sail_variant_node *key_variant_node = hash_map->buckets[i];
-                key_variant_node != NULL && callback(sail_variant_to_string(key_variant_node->variant), key_variant_node->next->variant);
-                key_variant_node = key_variant_node->next->next) {
+    for (size_t i = 0; i < hash_map->capacity; i++) {
+        const struct sail_hash_map_slot *slot = &hash_map->slots[i];
+
+        if (slot->key != NULL && !callback(slot->key, &slot->value)) {
+            return;
         }
     }
 }
@@ -165,10 +303,11 @@ void sail_traverse_hash_map_with_user_data(const struct sail_hash_map *hash_map,
                                            bool (*callback)(const char *key, const struct sail_variant *value, void *user_data),
                                            void *user_data) {
 
-    for (size_t i = 0; i < SAIL_HASH_MAP_SIZE; i++) {
-        for (const struct sail_variant_node *key_variant_node = hash_map->buckets[i];
-                key_variant_node != NULL && callback(sail_variant_to_string(key_variant_node->variant), key_variant_node->next->variant, user_data);
-                key_variant_node = key_variant_node->next->next) {
+    for (size_t i = 0; i < hash_map->capacity; i++) {
+        const struct sail_hash_map_slot *slot = &hash_map->slots[i];
+
+        if (slot->key != NULL && !callback(slot->key, &slot->value, user_data)) {
+            return;
         }
     }
 }
@@ -179,37 +318,39 @@ void sail_erase_hash_map_key(struct sail_hash_map *hash_map, const char *key) {
         return;
     }
 
-    for (struct sail_variant_node **head_variant_node = &hash_map->buckets[calculate_hash(key)],
-                *key_variant_node = *head_variant_node,
-                *prev_key_variant_node = NULL;
-            key_variant_node != NULL;
-            prev_key_variant_node = key_variant_node, key_variant_node = key_variant_node->next->next) {
-        if (strcmp(sail_variant_to_string(key_variant_node->variant), key) == 0) {
+    const size_t mask = hash_map->capacity - 1;
+    size_t index = find_slot(hash_map, sail_string_hash(key), key);
 
-            struct sail_variant_node *next_key_variant_node = key_variant_node->next->next;
+    if (hash_map->slots[index].key == NULL) {
+        return;
+    }
 
-            sail_destroy_variant_node(key_variant_node->next);
-            sail_destroy_variant_node(key_variant_node);
+    destroy_slot(&hash_map->slots[index]);
+    hash_map->size--;
 
-            /* Erase from the head. */
-            if (key_variant_node == *head_variant_node) {
-                *head_variant_node = next_key_variant_node;
-            } else {
-                /* Erase from the middle/end. */
-                prev_key_variant_node->next->next = next_key_variant_node;
-            }
+    /* Shift the following keys of the probe sequence back, so lookups don't stop at the hole. */
+    for (size_t next = (index + 1) & mask; hash_map->slots[next].key != NULL; next = (next + 1) & mask) {
+        const size_t home = (size_t)hash_map->slots[next].hash & mask;
 
-            return;
+        /* The key stays if its home slot is cyclically between the hole and its current slot. */
+        const bool stays = (index <= next) ? (index < home && home <= next) : (index < home || home <= next);
+
+        if (!stays) {
+            move_slot(&hash_map->slots[next], &hash_map->slots[index]);
+            index = next;
         }
     }
 }
 
 void sail_clear_hash_map(struct sail_hash_map *hash_map) {
 
-    for (size_t i = 0; i < SAIL_HASH_MAP_SIZE; i++) {
-        sail_destroy_variant_node_chain(hash_map->buckets[i]);
-        hash_map->buckets[i] = NULL;
+    for (size_t i = 0; i < hash_map->capacity; i++) {
+        if (hash_map->slots[i].key != NULL) {
+            destroy_slot(&hash_map->slots[i]);
+        }
     }
+
+    hash_map->size = 0;
 }
 
 sail_status_t sail_copy_hash_map(const struct sail_hash_map *source_hash_map, struct sail_hash_map **target_hash_map) {
@@ -217,14 +358,23 @@ sail_status_t sail_copy_hash_map(const struct sail_hash_map *source_hash_map, st
     SAIL_CHECK_PTR(source_hash_map);
     SAIL_CHECK_PTR(target_hash_map);
 
+    /* The same capacity keeps the keys in the same slots. */
     struct sail_hash_map *hash_map_local;
-    SAIL_TRY(sail_alloc_hash_map(&hash_map_local));
+    SAIL_TRY(alloc_hash_map(source_hash_map->capacity, &hash_map_local));
+
+    for (size_t i = 0; i < source_hash_map->capacity; i++) {
+        const struct sail_hash_map_slot *slot = &source_hash_map->slots[i];
 
-    for (size_t i = 0; i < SAIL_HASH_MAP_SIZE; i++) {
-        SAIL_TRY_OR_CLEANUP(sail_copy_variant_node_chain(source_hash_map->buckets[i], &hash_map_local->buckets[i]),
+        if (slot->key == NULL) {
+            continue;
+        }
+
+        SAIL_TRY_OR_CLEANUP(fill_slot(&hash_map_local->slots[i], slot->hash, slot->key, &slot->value),
                             /* cleanup */ sail_destroy_hash_map(hash_map_local));
     }
 
+    hash_map_local->size = source_hash_map->size;
+
     *target_hash_map = hash_map_local;
 
     return SAIL_OK;
@@ -26,21 +26,48 @@
 #ifndef SAIL_HASH_MAP_PRIVATE_H
 #define SAIL_HASH_MAP_PRIVATE_H
 
-struct sail_variant_node;
+#include <stdint.h>
+
+#include <sail-common/variant.h>
 
 enum {
-    SAIL_HASH_MAP_SIZE = 32
+    /* Must be a power of two. */
+    SAIL_HASH_MAP_INITIAL_CAPACITY = 8,
+
+    /* Keys up to this size are stored in slots without allocations. */
+    SAIL_HASH_MAP_INLINE_KEY_SIZE = 24,
+};
+
+/*
+ * Hash map slot. Empty slots have NULL keys.
+ */
+struct sail_hash_map_slot {
+
+    uint64_t hash;
+
+    /* Points to inline_key or to an allocated key. */
+    char *key;
+
+    /* Small values are stored in the variant inline storage. */
+    struct sail_variant value;
+
+    char inline_key[SAIL_HASH_MAP_INLINE_KEY_SIZE];
 };
 
 /*
- * A pretty limited hash map implementation.
+ * Open addressing hash map with linear probing. The initial slots are allocated together with
+ * the hash map, so maps of small lengths with small keys and values need a single allocation.
  */
 struct sail_hash_map {
 
-    /*
-     * Values follow keys in the chain, e.g. key1 -> value1 -> key2 -> value2 -> NULL.
-     */
-    struct sail_variant_node *buckets[SAIL_HASH_MAP_SIZE];
+    /* Points to the slots allocated with the hash map or, after growing, to allocated slots. */
+    struct sail_hash_map_slot *slots;
+
+    /* Number of slots, always a power of two. */
+    size_t capacity;
+
+    /* Number of keys. */
+    size_t size;
 };
 
 #endif
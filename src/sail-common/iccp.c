@@ -34,7 +34,7 @@ sail_status_t sail_alloc_iccp(struct sail_iccp **iccp) {
     SAIL_CHECK_PTR(iccp);
 
     void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct sail_iccp), &ptr));
+    SAIL_TRY(sail_private_arena_malloc(sizeof(struct sail_iccp), &ptr));
     *iccp = ptr;
 
     (*iccp)->data = NULL;
@@ -75,7 +75,7 @@ sail_status_t sail_alloc_iccp_for_data(size_t data_size, struct sail_iccp **iccp
     struct sail_iccp *iccp_local;
     SAIL_TRY(sail_alloc_iccp(&iccp_local));
 
-    SAIL_TRY_OR_CLEANUP(sail_malloc(data_size, &iccp_local->data),
+    SAIL_TRY_OR_CLEANUP(sail_private_arena_malloc(data_size, &iccp_local->data),
                         /* cleanup */ sail_destroy_iccp(iccp_local));
 
     iccp_local->size = data_size;
@@ -103,7 +103,7 @@ sail_status_t sail_copy_iccp(const struct sail_iccp *source_iccp, struct sail_ic
     struct sail_iccp *iccp_local;
     SAIL_TRY(sail_alloc_iccp(&iccp_local));
 
-    SAIL_TRY_OR_CLEANUP(sail_malloc(source_iccp->size, &iccp_local->data),
+    SAIL_TRY_OR_CLEANUP(sail_private_arena_malloc(source_iccp->size, &iccp_local->data),
                         /* cleanup */ sail_destroy_iccp(iccp_local));
 
     memcpy(iccp_local->data, source_iccp->data, source_iccp->size);
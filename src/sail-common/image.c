@@ -23,6 +23,7 @@
     SOFTWARE.
 */
 
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -38,18 +39,23 @@ sail_status_t sail_alloc_image(struct sail_image **image) {
     SAIL_TRY(sail_malloc(sizeof(struct sail_image), &ptr));
     *image = ptr;
 
-    (*image)->pixels         = NULL;
-    (*image)->width          = 0;
-    (*image)->height         = 0;
-    (*image)->bytes_per_line = 0;
-    (*image)->resolution     = NULL;
-    (*image)->pixel_format   = SAIL_PIXEL_FORMAT_UNKNOWN;
-    (*image)->gamma          = 1;
-    (*image)->delay          = -1;
-    (*image)->palette        = NULL;
-    (*image)->meta_data_node = NULL;
-    (*image)->iccp           = NULL;
-    (*image)->source_image   = NULL;
+    (*image)->pixels           = NULL;
+    (*image)->width            = 0;
+    (*image)->height           = 0;
+    (*image)->bytes_per_line   = 0;
+    (*image)->resolution       = NULL;
+    (*image)->pixel_format     = SAIL_PIXEL_FORMAT_UNKNOWN;
+    (*image)->gamma            = 1;
+    (*image)->delay            = -1;
+    (*image)->palette          = NULL;
+    (*image)->meta_data_node   = NULL;
+    (*image)->iccp             = NULL;
+    (*image)->source_image     = NULL;
+    (*image)->pixels_alignment = 0;
+    (*image)->pixels_borrowed  = false;
+
+    (*image)->pixels_file_backed_size = 0;
+    (*image)->arena                   = NULL;
 
     return SAIL_OK;
 }
@@ -60,17 +66,66 @@ void sail_destroy_image(struct sail_image *image) {
         return;
     }
 
-    sail_free(image->pixels);
+    sail_free_image_pixels(image);
 
     sail_destroy_resolution(image->resolution);
     sail_destroy_palette(image->palette);
     sail_destroy_meta_data_node_chain(image->meta_data_node);
     sail_destroy_iccp(image->iccp);
     sail_destroy_source_image(image->source_image);
+    sail_destroy_arena(image->arena);
 
     sail_free(image);
 }
 
+void sail_free_image_pixels(struct sail_image *image) {
+
+    if (image == NULL) {
+        return;
+    }
+
+    if (image->pixels_borrowed) {
+        /* Borrowed from the source image by sail_image_view(). */
+    } else if (image->pixels_file_backed_size > 0) {
+        sail_free_file_backed_memory(image->pixels, image->pixels_file_backed_size);
+    } else if (image->pixels_alignment > 0) {
+        sail_aligned_free(image->pixels);
+    } else {
+        sail_free(image->pixels);
+    }
+
+    image->pixels           = NULL;
+    image->pixels_alignment = 0;
+    image->pixels_borrowed  = false;
+
+    image->pixels_file_backed_size = 0;
+}
+
+sail_status_t sail_alloc_image_pixels(struct sail_image *image, bool file_backed) {
+
+    SAIL_CHECK_PTR(image);
+
+    if (image->pixels != NULL) {
+        SAIL_LOG_ERROR("The image already has pixels");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    }
+
+    const size_t pixels_size = (size_t)image->height * image->bytes_per_line;
+
+    if (file_backed) {
+        SAIL_TRY(sail_alloc_file_backed_memory(pixels_size, &image->pixels));
+    } else {
+        SAIL_TRY(sail_malloc(pixels_size, &image->pixels));
+    }
+
+    image->pixels_alignment = 0;
+    image->pixels_borrowed  = false;
+
+    image->pixels_file_backed_size = file_backed ? pixels_size : 0;
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_copy_image(const struct sail_image *source, struct sail_image **target) {
 
     SAIL_CHECK_PTR(source);
@@ -81,12 +136,28 @@ sail_status_t sail_copy_image(const struct sail_image *source, struct sail_image
 
     /* Pixels. */
     if (source->pixels != NULL) {
-        const unsigned pixels_size = source->height * source->bytes_per_line;
-
-        SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
-                            /* cleanup */ sail_destroy_image(image_local));
+        const size_t pixels_size = (size_t)image_local->height * image_local->bytes_per_line;
+
+        if (source->pixels_file_backed_size > 0) {
+            SAIL_TRY_OR_CLEANUP(sail_alloc_image_pixels(image_local, true),
+                                /* cleanup */ sail_destroy_image(image_local));
+        } else if (source->pixels_alignment > 0) {
+            SAIL_TRY_OR_CLEANUP(sail_aligned_malloc(source->pixels_alignment, pixels_size, &image_local->pixels),
+                                /* cleanup */ sail_destroy_image(image_local));
+            image_local->pixels_alignment = source->pixels_alignment;
+        } else {
+            SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
+                                /* cleanup */ sail_destroy_image(image_local));
+        }
 
-        memcpy(image_local->pixels, source->pixels, pixels_size);
+        if (source->pixels_borrowed) {
+            /* The stride of a view may exceed its rows, so copy them one by one. */
+            for (unsigned row = 0; row < source->height; row++) {
+                memcpy(sail_scan_line(image_local, row), sail_scan_line(source, row), image_local->bytes_per_line);
+            }
+        } else {
+            memcpy(image_local->pixels, source->pixels, pixels_size);
+        }
     }
 
     /* Palette. */
@@ -111,7 +182,9 @@ sail_status_t sail_copy_image_skeleton(const struct sail_image *source, struct s
 
     image_local->width                = source->width;
     image_local->height               = source->height;
-    image_local->bytes_per_line       = source->bytes_per_line;
+    image_local->bytes_per_line       = source->pixels_borrowed
+                                            ? sail_bytes_per_line(source->width, source->pixel_format)
+                                            : source->bytes_per_line;
 
     if (source->resolution != NULL) {
         SAIL_TRY_OR_CLEANUP(sail_copy_resolution(source->resolution, &image_local->resolution),
@@ -155,6 +228,30 @@ sail_status_t sail_check_image_skeleton_valid(const struct sail_image *image)
         SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
     }
 
+    /* Planes follow each other without padding, and 4:2:0 chroma planes cover 2x2 blocks. */
+    if (sail_is_planar(image->pixel_format)) {
+        if (image->bytes_per_line != sail_bytes_per_line(image->width, image->pixel_format)) {
+            SAIL_LOG_ERROR("Planar images cannot have padded rows");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+        }
+        if (image->pixel_format != SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444 && (image->width % 2 != 0 || image->height % 2 != 0)) {
+            SAIL_LOG_ERROR("4:2:0 planar images must have even dimensions, but the image is %ux%u", image->width, image->height);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+        }
+    }
+
+    /* Rows of blocks follow each other without padding. */
+    if (sail_is_block_compressed(image->pixel_format)) {
+        if (image->bytes_per_line != sail_bytes_per_line(image->width, image->pixel_format)) {
+            SAIL_LOG_ERROR("Block-compressed images cannot have padded rows");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+        }
+        if (image->width % 4 != 0 || image->height % 4 != 0) {
+            SAIL_LOG_ERROR("Block-compressed images must have dimensions multiple of 4, but the image is %ux%u", image->width, image->height);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+        }
+    }
+
     return SAIL_OK;
 }
 
@@ -187,50 +284,205 @@ sail_status_t sail_mirror_horizontally(struct sail_image *image) {
     return SAIL_OK;
 }
 
+/* Swaps two rows through a small stack buffer, so rows can be swapped in parallel. */
+static void swap_rows(unsigned char *scan1, unsigned char *scan2, unsigned bytes_per_line) {
+
+    unsigned char chunk[256];
+
+    for (unsigned offset = 0; offset < bytes_per_line; offset += sizeof(chunk)) {
+        const unsigned size = (bytes_per_line - offset < sizeof(chunk)) ? bytes_per_line - offset : (unsigned)sizeof(chunk);
+
+        memcpy(chunk,          scan1 + offset, size);
+        memcpy(scan1 + offset, scan2 + offset, size);
+        memcpy(scan2 + offset, chunk,          size);
+    }
+}
+
+/*
+ * Reverses the order of pixels in a row. Called with constant pixel sizes, so compilers
+ * inline fixed-size copies and vectorize the loop.
+ */
+static inline void reverse_pixels(unsigned char *scan, unsigned width, unsigned bytes_per_pixel) {
+
+    unsigned char pixel[16];
+
+    for (unsigned char *left = scan, *right = scan + (size_t)(width - 1) * bytes_per_pixel; left < right;
+            left += bytes_per_pixel, right -= bytes_per_pixel) {
+        memcpy(pixel, left,  bytes_per_pixel);
+        memcpy(left,  right, bytes_per_pixel);
+        memcpy(right, pixel, bytes_per_pixel);
+    }
+}
+
+static void reverse_row(unsigned char *scan, unsigned width, unsigned bytes_per_pixel) {
+
+    switch (bytes_per_pixel) {
+        case 1:  reverse_pixels(scan, width, 1);  break;
+        case 2:  reverse_pixels(scan, width, 2);  break;
+        case 3:  reverse_pixels(scan, width, 3);  break;
+        case 4:  reverse_pixels(scan, width, 4);  break;
+        case 6:  reverse_pixels(scan, width, 6);  break;
+        case 8:  reverse_pixels(scan, width, 8);  break;
+        case 12: reverse_pixels(scan, width, 12); break;
+        case 16: reverse_pixels(scan, width, 16); break;
+        default: reverse_pixels(scan, width, bytes_per_pixel);
+    }
+}
+
+/* Rows of planar and block-compressed images are not pixels, so they cannot be mirrored, rotated, or viewed. */
+static sail_status_t check_image_not_planar(const struct sail_image *image) {
+
+    if (sail_is_planar(image->pixel_format)) {
+        SAIL_LOG_ERROR("Planar pixel format %s is not supported, convert the image first", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+    if (sail_is_block_compressed(image->pixel_format)) {
+        SAIL_LOG_ERROR("Block-compressed pixel format %s is not supported, convert the image first", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t byte_aligned_bytes_per_pixel(const struct sail_image *image, unsigned *bytes_per_pixel) {
+
+    const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+
+    if (bits_per_pixel % 8 != 0 || bits_per_pixel == 0) {
+        SAIL_LOG_ERROR("Only byte-aligned pixels are supported for the horizontal mirroring and rotating");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    *bytes_per_pixel = bits_per_pixel / 8;
+
+    return SAIL_OK;
+}
+
+/* Transposes the pixels into a new buffer, rotating them by 90 degrees clockwise or counterclockwise. */
+static sail_status_t rotate_90(struct sail_image *image, unsigned bytes_per_pixel, bool clockwise) {
+
+    const unsigned width          = image->height;
+    const unsigned height         = image->width;
+    const unsigned bytes_per_line = width * bytes_per_pixel;
+
+    const size_t pixels_size = (size_t)height * bytes_per_line;
+    const bool file_backed = image->pixels_file_backed_size > 0;
+
+    void *pixels;
+
+    if (file_backed) {
+        SAIL_TRY(sail_alloc_file_backed_memory(pixels_size, &pixels));
+    } else {
+        SAIL_TRY(sail_malloc(pixels_size, &pixels));
+    }
+
+    const struct sail_image *source = image;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    for (unsigned row = 0; row < height; row++) {
+        unsigned char *scan = (unsigned char *)pixels + (size_t)row * bytes_per_line;
+
+        /* The target row is the source column. */
+        const unsigned column = clockwise ? row : height - 1 - row;
+
+        for (unsigned x = 0; x < width; x++) {
+            const unsigned source_row = clockwise ? width - 1 - x : x;
+            const unsigned char *source_pixel = (const unsigned char *)sail_scan_line(source, source_row) + (size_t)column * bytes_per_pixel;
+
+            memcpy(scan + (size_t)x * bytes_per_pixel, source_pixel, bytes_per_pixel);
+        }
+    }
+
+    sail_free_image_pixels(image);
+
+    image->pixels           = pixels;
+    image->pixels_alignment = 0;
+    image->width            = width;
+    image->height           = height;
+    image->bytes_per_line   = bytes_per_line;
+
+    image->pixels_file_backed_size = file_backed ? pixels_size : 0;
+
+    if (image->resolution != NULL) {
+        const double x = image->resolution->x;
+
+        image->resolution->x = image->resolution->y;
+        image->resolution->y = x;
+    }
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_mirror(struct sail_image *image, enum SailOrientation orientation)
 {
     switch (orientation) {
         case SAIL_ORIENTATION_MIRRORED_VERTICALLY: {
             SAIL_TRY(sail_check_image_valid(image));
+            SAIL_TRY(check_image_not_planar(image));
 
-            void *line;
-            SAIL_TRY(sail_malloc(image->bytes_per_line, &line));
+            const unsigned half_height = image->height / 2;
 
-            for (unsigned row1 = 0, row2 = image->height - 1; row1 < row2; row1++, row2--) {
-                memcpy(line,                        sail_scan_line(image, row1), image->bytes_per_line);
-                memcpy(sail_scan_line(image, row1), sail_scan_line(image, row2), image->bytes_per_line);
-                memcpy(sail_scan_line(image, row2), line,                        image->bytes_per_line);
+            #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+            for (unsigned row = 0; row < half_height; row++) {
+                swap_rows(sail_scan_line(image, row), sail_scan_line(image, image->height - 1 - row), image->bytes_per_line);
             }
-
-            sail_free(line);
             break;
         }
         case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY: {
             SAIL_TRY(sail_check_image_valid(image));
+            SAIL_TRY(check_image_not_planar(image));
 
-            const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+            unsigned bytes_per_pixel;
+            SAIL_TRY(byte_aligned_bytes_per_pixel(image, &bytes_per_pixel));
 
-            if (bits_per_pixel % 8 != 0) {
-                SAIL_LOG_ERROR("Only byte-aligned pixels are supported for the horizontal mirroring");
-                SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+            #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+            for (unsigned row = 0; row < image->height; row++) {
+                reverse_row(sail_scan_line(image, row), image->width, bytes_per_pixel);
             }
+            break;
+        }
+        default: {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+    }
 
-            const unsigned bytes_per_pixel = bits_per_pixel / 8;
+    return SAIL_OK;
+}
 
-            void *pixel;
-            SAIL_TRY(sail_malloc(bytes_per_pixel, &pixel));
+sail_status_t sail_rotate(struct sail_image *image, enum SailOrientation orientation) {
 
-            for (unsigned row = 0; row < image->height; row++) {
-                unsigned char *scan = sail_scan_line(image, row);
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_TRY(check_image_not_planar(image));
 
-                for (unsigned col1 = 0, col2 = (image->width - 1) * bytes_per_pixel; col1 < col2; col1 += bytes_per_pixel, col2 -= bytes_per_pixel) {
-                    memcpy(pixel,       scan + col1, bytes_per_pixel);
-                    memcpy(scan + col1, scan + col2, bytes_per_pixel);
-                    memcpy(scan + col2, pixel,       bytes_per_pixel);
-                }
+    unsigned bytes_per_pixel;
+    SAIL_TRY(byte_aligned_bytes_per_pixel(image, &bytes_per_pixel));
+
+    switch (orientation) {
+        case SAIL_ORIENTATION_ROTATED_90: {
+            SAIL_TRY(rotate_90(image, bytes_per_pixel, true));
+            break;
+        }
+        case SAIL_ORIENTATION_ROTATED_180: {
+            /* Reverse the pixel order in place: swap mirrored rows and reverse them. */
+            const unsigned half_height = image->height / 2;
+
+            #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+            for (unsigned row = 0; row < half_height; row++) {
+                unsigned char *scan1 = sail_scan_line(image, row);
+                unsigned char *scan2 = sail_scan_line(image, image->height - 1 - row);
+
+                swap_rows(scan1, scan2, image->width * bytes_per_pixel);
+                reverse_row(scan1, image->width, bytes_per_pixel);
+                reverse_row(scan2, image->width, bytes_per_pixel);
             }
 
-            sail_free(pixel);
+            if (image->height % 2 != 0) {
+                reverse_row(sail_scan_line(image, half_height), image->width, bytes_per_pixel);
+            }
+            break;
+        }
+        case SAIL_ORIENTATION_ROTATED_270: {
+            SAIL_TRY(rotate_90(image, bytes_per_pixel, false));
             break;
         }
         default: {
@@ -241,6 +493,46 @@ sail_status_t sail_mirror(struct sail_image *image, enum SailOrientation orienta
     return SAIL_OK;
 }
 
+sail_status_t sail_image_view(const struct sail_image *image,
+                              unsigned x, unsigned y, unsigned width, unsigned height,
+                              struct sail_image **view) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_TRY(check_image_not_planar(image));
+    SAIL_CHECK_PTR(view);
+
+    if (width == 0 || height == 0 || x >= image->width || y >= image->height
+            || width > image->width - x || height > image->height - y) {
+        SAIL_LOG_ERROR("View %ux%u at %u,%u doesn't fit into the %ux%u image", width, height, x, y, image->width, image->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+
+    if (((size_t)x * bits_per_pixel) % 8 != 0) {
+        SAIL_LOG_ERROR("View left edge %u of a %u-bit image doesn't start on a byte boundary", x, bits_per_pixel);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct sail_image *view_local;
+    SAIL_TRY(sail_copy_image_skeleton(image, &view_local));
+
+    if (image->palette != NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_copy_palette(image->palette, &view_local->palette),
+                            /* cleanup */ sail_destroy_image(view_local));
+    }
+
+    view_local->width           = width;
+    view_local->height          = height;
+    view_local->bytes_per_line  = image->bytes_per_line;
+    view_local->pixels          = (uint8_t *)sail_scan_line(image, y) + (size_t)x * bits_per_pixel / 8;
+    view_local->pixels_borrowed = true;
+
+    *view = view_local;
+
+    return SAIL_OK;
+}
+
 void* sail_scan_line(const struct sail_image *image, unsigned row) {
 
     if (SAIL_UNLIKELY(image == NULL || image->pixels == NULL)) {
@@ -249,3 +541,57 @@ void* sail_scan_line(const struct sail_image *image, unsigned row) {
 
     return (uint8_t *)image->pixels + image->bytes_per_line * row;
 }
+
+sail_status_t sail_image_planes(const struct sail_image *image, void *planes[4], unsigned strides[4], unsigned *planes_count) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(planes);
+    SAIL_CHECK_PTR(strides);
+    SAIL_CHECK_PTR(planes_count);
+
+    for (unsigned i = 0; i < 4; i++) {
+        planes[i]  = NULL;
+        strides[i] = 0;
+    }
+
+    uint8_t *pixels = image->pixels;
+    const size_t luma_size = (size_t)image->width * image->height;
+
+    switch (image->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420: {
+            planes[0]  = pixels;
+            planes[1]  = pixels + luma_size;
+            planes[2]  = pixels + luma_size + luma_size / 4;
+            strides[0] = image->width;
+            strides[1] = image->width / 2;
+            strides[2] = image->width / 2;
+            *planes_count = 3;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12: {
+            planes[0]  = pixels;
+            planes[1]  = pixels + luma_size;
+            strides[0] = image->width;
+            strides[1] = image->width;
+            *planes_count = 2;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444: {
+            planes[0]  = pixels;
+            planes[1]  = pixels + luma_size;
+            planes[2]  = pixels + luma_size * 2;
+            strides[0] = image->width;
+            strides[1] = image->width;
+            strides[2] = image->width;
+            *planes_count = 3;
+            break;
+        }
+        default: {
+            planes[0]  = pixels;
+            strides[0] = image->bytes_per_line;
+            *planes_count = 1;
+        }
+    }
+
+    return SAIL_OK;
+}
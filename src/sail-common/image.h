@@ -36,6 +36,7 @@
 extern "C" {
 #endif
 
+struct sail_arena;
 struct sail_iccp;
 struct sail_meta_data_node;
 struct sail_palette;
@@ -50,7 +51,9 @@ struct sail_image {
 
     /*
      * Image pixels. The channels are interleaved per pixel. The pixels are
-     * organized row by row, left to right, top to bottom.
+     * organized row by row, left to right, top to bottom. Planar pixel formats
+     * store their planes one after another instead, see sail_image_planes().
+     * Block-compressed pixel formats store rows of 4x4 blocks.
      *
      * LOAD: Set by SAIL to an allocated array of pixels.
      * SAVE: Must be set by a caller to an allocated array of pixels.
@@ -160,6 +163,48 @@ struct sail_image {
      * SAVE: Ignored.
      */
     struct sail_source_image *source_image;
+
+    /*
+     * Alignment of the pixels buffer in bytes if it was allocated with sail_aligned_malloc(),
+     * or 0 if it was allocated with sail_malloc(). sail_destroy_image() and sail_free_image_pixels()
+     * use it to free the pixels properly.
+     *
+     * LOAD: Set by SAIL to the pixels alignment requested in sail_load_options, or to 0.
+     * SAVE: Ignored.
+     */
+    unsigned pixels_alignment;
+
+    /*
+     * True if the pixels are borrowed from another image by sail_image_view(). Borrowed pixels
+     * are never freed by sail_destroy_image() and sail_free_image_pixels(), and bytes_per_line
+     * is the stride of the source image.
+     *
+     * LOAD: Set by SAIL to false.
+     * SAVE: Ignored.
+     */
+    bool pixels_borrowed;
+
+    /*
+     * Size of the pixels buffer in bytes if it was allocated with sail_alloc_file_backed_memory(),
+     * or 0 otherwise. sail_destroy_image() and sail_free_image_pixels() use it to free the pixels
+     * properly. sail-manip functions allocate the pixels of their resulting images in file-backed
+     * memory too if the pixels of the input image are file-backed.
+     *
+     * LOAD: Set by SAIL to the pixels size if the pixels size reaches the file_backed_pixels_threshold
+     *       specified in sail_load_options, or to 0.
+     * SAVE: Ignored.
+     */
+    size_t pixels_file_backed_size;
+
+    /*
+     * Arena that holds the side structures of the image, like the resolution, the palette,
+     * the meta data, and the source image, or NULL. sail_destroy_image() destroys it after
+     * the side structures, so they must not outlive the image. See sail_set_thread_arena().
+     *
+     * LOAD: Set by SAIL if SAIL_OPTION_ARENA is specified, or to NULL.
+     * SAVE: Ignored.
+     */
+    struct sail_arena *arena;
 };
 
 typedef struct sail_image sail_image_t;
@@ -178,7 +223,24 @@ SAIL_EXPORT sail_status_t sail_alloc_image(struct sail_image **image);
 SAIL_EXPORT void sail_destroy_image(struct sail_image *image);
 
 /*
- * Makes a deep copy of the specified image.
+ * Frees the image pixels with sail_free(), sail_aligned_free(), or sail_free_file_backed_memory()
+ * depending on how they were allocated, and sets the pixels to NULL. Borrowed pixels are not freed,
+ * just detached. Does nothing if the image is NULL.
+ */
+SAIL_EXPORT void sail_free_image_pixels(struct sail_image *image);
+
+/*
+ * Allocates pixels of the image of height * bytes_per_line bytes with sail_malloc(), or
+ * with sail_alloc_file_backed_memory() if file_backed is true. The image must have no pixels.
+ * The allocated pixels are not initialized unless they are file-backed.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_image_pixels(struct sail_image *image, bool file_backed);
+
+/*
+ * Makes a deep copy of the specified image. File-backed pixels are copied into file-backed memory. The pixels of a view made with sail_image_view()
+ * are copied into a new tightly packed buffer.
  *
  * Returns SAIL_OK on success.
  */
@@ -228,18 +290,63 @@ SAIL_EXPORT sail_status_t sail_mirror_horizontally(struct sail_image *image);
  *
  * Only SAIL_ORIENTATION_MIRRORED_HORIZONTALLY and SAIL_ORIENTATION_MIRRORED_VERTICALLY
  * values are accepted. When mirroring horizontally, the image pixel size must be a multiple of 8,
- * e.g. 8, 16, 24 etc.
+ * e.g. 8, 16, 24 etc. Planar and block-compressed images are not supported.
  *
  * Returns SAIL_OK on success.
  */
 SAIL_EXPORT sail_status_t sail_mirror(struct sail_image *image, enum SailOrientation orientation);
 
+/*
+ * Rotates the image clockwise by the specified angle.
+ *
+ * Only SAIL_ORIENTATION_ROTATED_90, SAIL_ORIENTATION_ROTATED_180, and SAIL_ORIENTATION_ROTATED_270
+ * values are accepted. The image pixel size must be a multiple of 8, e.g. 8, 16, 24 etc.
+ * Planar and block-compressed images are not supported.
+ * Rotating by 180 degrees works in place. Rotating by 90 and 270 degrees swaps the image dimensions
+ * and the resolution, and replaces the pixels with a new tightly packed buffer.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_rotate(struct sail_image *image, enum SailOrientation orientation);
+
+/*
+ * Makes a view of the specified rectangle of the image without copying pixels. The view borrows
+ * the source pixels and their stride: its pixels point to the top left pixel of the rectangle, and
+ * its bytes_per_line equals the source bytes_per_line. All other properties and the palette are
+ * copied. Modifying the view pixels modifies the source image pixels.
+ *
+ * The rectangle must lie within the image, and its left edge must start on a byte boundary, i.e.
+ * x multiplied by the bits per pixel must be a multiple of 8. Planar and block-compressed images are not supported.
+ * The source image must outlive the view.
+ * Destroy the view with sail_destroy_image() as usual; it doesn't free the borrowed pixels.
+ *
+ * Operations that replace the pixels buffer, like rotating by 90 degrees, detach the view
+ * from the source image.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_image_view(const struct sail_image *image,
+                                          unsigned x, unsigned y, unsigned width, unsigned height,
+                                          struct sail_image **view);
+
 /*
  * Returns the scan line at the given row.
  * Return NULL if the image or its pixels is NULL.
  */
 SAIL_EXPORT void* sail_scan_line(const struct sail_image *image, unsigned row);
 
+/*
+ * Returns the planes of the image pixels and their strides in bytes. Planar pixel formats,
+ * like SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420, have two or three planes in the order of their
+ * channels. NV12 has the luma plane and the interleaved CbCr plane. Other pixel formats have
+ * a single plane that equals the image pixels. Unused entries are set to NULL and 0.
+ *
+ * The planes point into the image pixels, so they are valid until the pixels are freed or replaced.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_image_planes(const struct sail_image *image, void *planes[4], unsigned strides[4], unsigned *planes_count);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
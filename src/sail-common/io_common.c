@@ -23,11 +23,55 @@
     SOFTWARE.
 */
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "sail-common.h"
 
+/* Reads a non-seekable stream of unknown size until EOF by growing the buffer. */
+static sail_status_t alloc_data_from_stream(struct sail_io *io, void **data, size_t *data_size) {
+
+    size_t capacity = 64 * 1024;
+    size_t data_size_local = 0;
+
+    void *data_local;
+    SAIL_TRY(sail_malloc(capacity, &data_local));
+
+    for (;;) {
+        if (data_size_local == capacity) {
+            if (capacity > SIZE_MAX / 2) {
+                sail_free(data_local);
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+            }
+
+            capacity *= 2;
+            SAIL_TRY_OR_CLEANUP(sail_realloc(capacity, &data_local),
+                                /* cleanup */ sail_free(data_local));
+        }
+
+        size_t read_size;
+        const sail_status_t status = io->tolerant_read(io->stream,
+                                                        (unsigned char *)data_local + data_size_local,
+                                                        capacity - data_size_local,
+                                                        &read_size);
+
+        if (status == SAIL_ERROR_EOF || (status == SAIL_OK && read_size == 0)) {
+            break;
+        }
+
+        SAIL_TRY_OR_CLEANUP(status,
+                            /* cleanup */ sail_free(data_local));
+
+        data_size_local += read_size;
+    }
+
+    *data      = data_local;
+    *data_size = data_size_local;
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_alloc_io(struct sail_io **io) {
 
     SAIL_CHECK_PTR(io);
@@ -36,17 +80,20 @@ sail_status_t sail_alloc_io(struct sail_io **io) {
     SAIL_TRY(sail_malloc(sizeof(struct sail_io), &ptr));
     *io = ptr;
 
-    (*io)->features       = 0;
-    (*io)->stream         = NULL;
-    (*io)->tolerant_read  = NULL;
-    (*io)->strict_read    = NULL;
-    (*io)->tolerant_write = NULL;
-    (*io)->strict_write   = NULL;
-    (*io)->seek           = NULL;
-    (*io)->tell           = NULL;
-    (*io)->flush          = NULL;
-    (*io)->close          = NULL;
-    (*io)->eof            = NULL;
+    (*io)->features              = 0;
+    (*io)->stream                = NULL;
+    (*io)->tolerant_read         = NULL;
+    (*io)->strict_read           = NULL;
+    (*io)->tolerant_write        = NULL;
+    (*io)->strict_write          = NULL;
+    (*io)->seek                  = NULL;
+    (*io)->tell                  = NULL;
+    (*io)->flush                 = NULL;
+    (*io)->close                 = NULL;
+    (*io)->eof                   = NULL;
+    (*io)->map                   = NULL;
+    (*io)->strict_write_vectored = NULL;
+    (*io)->will_need             = NULL;
 
     return SAIL_OK;
 }
@@ -103,6 +150,36 @@ sail_status_t sail_io_size(struct sail_io *io, size_t *size) {
     return SAIL_OK;
 }
 
+sail_status_t sail_io_strict_write_vectored(struct sail_io *io, const struct sail_io_vector *vectors, size_t vectors_count) {
+
+    SAIL_CHECK_PTR(io);
+    SAIL_CHECK_PTR(vectors);
+
+    if ((io->features & SAIL_IO_FEATURE_VECTORED) && io->strict_write_vectored != NULL) {
+        SAIL_TRY(io->strict_write_vectored(io->stream, vectors, vectors_count));
+        return SAIL_OK;
+    }
+
+    for (size_t i = 0; i < vectors_count; i++) {
+        if (vectors[i].size > 0) {
+            SAIL_TRY(io->strict_write(io->stream, vectors[i].data, vectors[i].size));
+        }
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_io_will_need(struct sail_io *io, size_t offset, size_t length) {
+
+    SAIL_CHECK_PTR(io);
+
+    if ((io->features & SAIL_IO_FEATURE_EXPENSIVE_SEEK) && io->will_need != NULL) {
+        SAIL_TRY(io->will_need(io->stream, offset, length));
+    }
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_io_contents_into_data(struct sail_io *io, void *data) {
 
     SAIL_CHECK_PTR(io);
@@ -134,6 +211,12 @@ sail_status_t sail_alloc_data_from_io_contents(struct sail_io *io, void **data,
     SAIL_CHECK_PTR(data);
     SAIL_CHECK_PTR(data_size);
 
+    /* Streams like pipes have no size. */
+    if ((io->features & SAIL_IO_FEATURE_SEEKABLE) == 0) {
+        SAIL_TRY(alloc_data_from_stream(io, data, data_size));
+        return SAIL_OK;
+    }
+
     size_t data_size_local;
     SAIL_TRY(sail_io_size(io, &data_size_local));
 
@@ -150,6 +233,44 @@ sail_status_t sail_alloc_data_from_io_contents(struct sail_io *io, void **data,
     return SAIL_OK;
 }
 
+sail_status_t sail_borrow_or_alloc_data_from_io_contents(struct sail_io *io, const void **data, size_t *data_size,
+                                                         void **allocated_data) {
+
+    SAIL_CHECK_PTR(io);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(data_size);
+    SAIL_CHECK_PTR(allocated_data);
+
+    if ((io->features & SAIL_IO_FEATURE_MAPPED) && io->map != NULL) {
+        const void *data_local;
+        size_t data_size_local;
+        const sail_status_t status = io->map(io->stream, &data_local, &data_size_local);
+
+        /* Fall back to reading when the I/O object cannot map the data after all. */
+        if (status == SAIL_OK) {
+            SAIL_TRY(io->seek(io->stream, 0, SEEK_END));
+
+            *data           = data_local;
+            *data_size      = data_size_local;
+            *allocated_data = NULL;
+
+            return SAIL_OK;
+        } else if (status != SAIL_ERROR_NOT_IMPLEMENTED) {
+            SAIL_LOG_AND_RETURN(status);
+        }
+    }
+
+    void *data_local;
+    size_t data_size_local;
+    SAIL_TRY(sail_alloc_data_from_io_contents(io, &data_local, &data_size_local));
+
+    *data           = data_local;
+    *data_size      = data_size_local;
+    *allocated_data = data_local;
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_read_string_from_io(struct sail_io *io, char *str, size_t str_size) {
 
     SAIL_CHECK_PTR(io);
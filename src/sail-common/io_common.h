@@ -112,14 +112,80 @@ typedef sail_status_t (*sail_io_close_t)(void *stream);
  */
 typedef sail_status_t (*sail_io_eof_t)(void *stream, bool *result);
 
+/*
+ * Assigns a pointer to the contiguous memory region that holds the I/O data from the current
+ * position until the end and its size. Doesn't change the current position. The pointer
+ * remains valid until the I/O object is closed.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NOT_IMPLEMENTED if the data cannot be mapped.
+ */
+typedef sail_status_t (*sail_io_map_t)(void *stream, const void **data, size_t *size);
+
+/*
+ * A memory segment to write with a single vectored write call.
+ */
+struct sail_io_vector {
+
+    const void *data;
+    size_t size;
+};
+
+/*
+ * Writes the specified segments one after another with a single call. Fails if the actual
+ * number of bytes written is smaller than the total size of the segments.
+ *
+ * Returns SAIL_OK on success.
+ */
+typedef sail_status_t (*sail_io_strict_write_vectored_t)(void *stream, const struct sail_io_vector *vectors, size_t vectors_count);
+
+/*
+ * Hints the I/O object that the specified range is going to be read soon. Zero length means
+ * the data until the end of the stream. Doesn't change the current position. The I/O object
+ * may prefetch the range, for example, with a single HTTP range request.
+ *
+ * Returns SAIL_OK on success.
+ */
+typedef sail_status_t (*sail_io_will_need_t)(void *stream, size_t offset, size_t length);
+
 /* I/O features. */
 enum SailIoFeature {
 
     /*
      * The I/O object is seekable. When this flag is off, the seek callback
-     * must return SAIL_ERROR_NOT_IMPLEMENTED.
+     * must return SAIL_ERROR_NOT_IMPLEMENTED unless SAIL_IO_FEATURE_STREAMING is set.
      */
     SAIL_IO_FEATURE_SEEKABLE = 1 << 0,
+
+    /*
+     * The I/O data reside in a contiguous memory region, so codecs can borrow it with
+     * the map callback instead of reading it into their own buffers. When this flag is off,
+     * the map callback may be NULL.
+     */
+    SAIL_IO_FEATURE_MAPPED   = 1 << 1,
+
+    /*
+     * The I/O object writes several memory segments with a single strict_write_vectored call
+     * faster than with separate strict_write calls. When this flag is off, the strict_write_vectored
+     * callback may be NULL.
+     */
+    SAIL_IO_FEATURE_VECTORED = 1 << 2,
+
+    /*
+     * Seeking is expensive, for example, on remote object storage, and reading the skipped
+     * data should be avoided. Codecs announce the ranges they're going to read with the will_need
+     * callback, so the I/O object can batch them into a few large requests. When this flag is off,
+     * the will_need callback may be NULL.
+     */
+    SAIL_IO_FEATURE_EXPENSIVE_SEEK = 1 << 3,
+
+    /*
+     * The I/O object is a forward-only stream like a pipe or a socket. It has no size, seeking forward
+     * skips data, and seeking backward is possible only within the first SAIL_IO_STREAM_PREFIX_SIZE
+     * bytes until they're passed. This is enough for magic number detection and for codecs that read
+     * forward only. It's never combined with SAIL_IO_FEATURE_SEEKABLE.
+     */
+    SAIL_IO_FEATURE_STREAMING = 1 << 4,
 };
 
 /*
@@ -182,6 +248,21 @@ struct sail_io {
      * EOF callback.
      */
     sail_io_eof_t eof;
+
+    /*
+     * Map callback. Optional. Used only when SAIL_IO_FEATURE_MAPPED is set.
+     */
+    sail_io_map_t map;
+
+    /*
+     * Vectored write callback. Optional. Used only when SAIL_IO_FEATURE_VECTORED is set.
+     */
+    sail_io_strict_write_vectored_t strict_write_vectored;
+
+    /*
+     * Read hint callback. Optional. Used only when SAIL_IO_FEATURE_EXPENSIVE_SEEK is set.
+     */
+    sail_io_will_need_t will_need;
 };
 
 typedef struct sail_io sail_io_t;
@@ -218,6 +299,25 @@ SAIL_EXPORT sail_status_t sail_check_io_valid(const struct sail_io *io);
  */
 SAIL_EXPORT sail_status_t sail_io_size(struct sail_io *io, size_t *size);
 
+/*
+ * Writes the specified segments one after another. Uses the strict_write_vectored callback
+ * if the I/O object has the SAIL_IO_FEATURE_VECTORED feature. Otherwise, writes the segments
+ * with separate strict_write calls. Empty segments are skipped.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_io_strict_write_vectored(struct sail_io *io, const struct sail_io_vector *vectors, size_t vectors_count);
+
+/*
+ * Hints the I/O object that the specified range is going to be read soon. Zero length means
+ * the data until the end of the stream. Does nothing unless the I/O object has
+ * the SAIL_IO_FEATURE_EXPENSIVE_SEEK feature. Codecs call it before seeking
+ * over data they don't need.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_io_will_need(struct sail_io *io, size_t offset, size_t length);
+
 /*
  * Reads the specified I/O stream until EOF into the memory buffer. Reads the stream
  * from the current position. The buffer must be large enough.
@@ -236,6 +336,21 @@ SAIL_EXPORT sail_status_t sail_io_contents_into_data(struct sail_io *io, void *d
  */
 SAIL_EXPORT sail_status_t sail_alloc_data_from_io_contents(struct sail_io *io, void **data, size_t *data_size);
 
+/*
+ * Returns the contents of the specified I/O stream from the current position until EOF
+ * in a contiguous memory buffer and moves the position to EOF.
+ *
+ * If the I/O object has the SAIL_IO_FEATURE_MAPPED feature, borrows its memory region
+ * without copying and assigns NULL to 'allocated_data'. Otherwise, allocates a memory buffer,
+ * reads the stream into it, and assigns the buffer to both 'data' and 'allocated_data'.
+ * The caller must free 'allocated_data' with sail_free(). 'data' is valid until the I/O
+ * object is closed or 'allocated_data' is freed.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_borrow_or_alloc_data_from_io_contents(struct sail_io *io, const void **data, size_t *data_size,
+                                                                     void **allocated_data);
+
 /*
  * Reads a string ended with '\n' from the I/O stream. Trailing new line characters
  * are not stripped. The string buffer size must be >= 2 to hold at least "\n".
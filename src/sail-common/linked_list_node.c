@@ -30,7 +30,7 @@ sail_status_t sail_private_alloc_linked_list_node(struct linked_list_node **node
     SAIL_CHECK_PTR(node);
 
     void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct linked_list_node), &ptr));
+    SAIL_TRY(sail_private_arena_malloc(sizeof(struct linked_list_node), &ptr));
     *node = ptr;
 
     (*node)->value = NULL;
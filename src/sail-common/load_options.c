@@ -26,18 +26,86 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#ifdef SAIL_WIN32
+    #include <windows.h>
+#endif
+
 #include "sail-common.h"
 
+/*
+ * Private functions.
+ */
+
+/* Load options with a reference counter. The public structure goes first. */
+struct shared_load_options {
+
+    struct sail_load_options load_options;
+    volatile long references;
+};
+
+static inline struct shared_load_options* shared_load_options(const struct sail_load_options *load_options) {
+
+    return (struct shared_load_options *)load_options;
+}
+
+/* Returns the special properties to store the diagnostics into, or NULL if the diagnostics are not requested. */
+static sail_status_t diagnostics_map(const struct sail_load_options *load_options, struct sail_image *image,
+                                     struct sail_hash_map **special_properties) {
+
+    *special_properties = NULL;
+
+    if (load_options == NULL || !(load_options->options & SAIL_OPTION_DIAGNOSTICS) || image->source_image == NULL) {
+        return SAIL_OK;
+    }
+
+    if (image->source_image->special_properties == NULL) {
+        SAIL_TRY(sail_alloc_hash_map(&image->source_image->special_properties));
+    }
+
+    *special_properties = image->source_image->special_properties;
+
+    return SAIL_OK;
+}
+
+static sail_status_t put_diagnostic(struct sail_hash_map *special_properties, const char *key, struct sail_variant *variant) {
+
+    SAIL_TRY_OR_CLEANUP(sail_put_hash_map(special_properties, key, variant),
+                        /* cleanup */ sail_destroy_variant(variant));
+
+    sail_destroy_variant(variant);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
 sail_status_t sail_alloc_load_options(struct sail_load_options **load_options) {
 
     SAIL_CHECK_PTR(load_options);
 
     void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct sail_load_options), &ptr));
+    SAIL_TRY(sail_malloc(sizeof(struct shared_load_options), &ptr));
+    shared_load_options(ptr)->references = 1;
     *load_options = ptr;
 
-    (*load_options)->options = 0;
-    (*load_options)->tuning  = NULL;
+    (*load_options)->options                 = 0;
+    (*load_options)->tuning                  = NULL;
+    (*load_options)->meta_data_keys          = 0;
+    (*load_options)->row_alignment           = 0;
+    (*load_options)->pixels_alignment        = 0;
+    (*load_options)->file_backed_pixels_threshold = 0;
+    (*load_options)->roi                     = (struct sail_roi) { 0, 0, 0, 0 };
+    (*load_options)->scale_denominator       = 1;
+    (*load_options)->row_callback            = NULL;
+    (*load_options)->row_callback_user_data  = NULL;
+    (*load_options)->output_pixel_format     = SAIL_PIXEL_FORMAT_UNKNOWN;
+    (*load_options)->pass_callback           = NULL;
+    (*load_options)->pass_callback_user_data = NULL;
+    (*load_options)->cancellation            = NULL;
+    (*load_options)->stats                   = NULL;
+    (*load_options)->limits                  = (struct sail_load_limits) { 0, 0, 0, 0 };
 
     return SAIL_OK;
 }
@@ -48,6 +116,16 @@ void sail_destroy_load_options(struct sail_load_options *load_options) {
         return;
     }
 
+#ifdef SAIL_WIN32
+    const long references = InterlockedDecrement(&shared_load_options(load_options)->references);
+#else
+    const long references = __atomic_sub_fetch(&shared_load_options(load_options)->references, 1, __ATOMIC_ACQ_REL);
+#endif
+
+    if (references > 0) {
+        return;
+    }
+
     sail_destroy_hash_map(load_options->tuning);
     sail_free(load_options);
 }
@@ -86,7 +164,21 @@ sail_status_t sail_copy_load_options(const struct sail_load_options *source, str
     struct sail_load_options *target_local;
     SAIL_TRY(sail_alloc_load_options(&target_local));
 
-    target_local->options = source->options;
+    target_local->options                 = source->options;
+    target_local->meta_data_keys          = source->meta_data_keys;
+    target_local->row_alignment           = source->row_alignment;
+    target_local->pixels_alignment        = source->pixels_alignment;
+    target_local->file_backed_pixels_threshold = source->file_backed_pixels_threshold;
+    target_local->roi                     = source->roi;
+    target_local->scale_denominator       = source->scale_denominator;
+    target_local->row_callback            = source->row_callback;
+    target_local->row_callback_user_data  = source->row_callback_user_data;
+    target_local->output_pixel_format     = source->output_pixel_format;
+    target_local->pass_callback           = source->pass_callback;
+    target_local->pass_callback_user_data = source->pass_callback_user_data;
+    target_local->cancellation            = source->cancellation;
+    target_local->stats                   = source->stats;
+    target_local->limits                  = source->limits;
 
     if (source->tuning != NULL) {
         SAIL_TRY_OR_CLEANUP(sail_copy_hash_map(source->tuning, &target_local->tuning),
@@ -97,3 +189,201 @@ sail_status_t sail_copy_load_options(const struct sail_load_options *source, str
 
     return SAIL_OK;
 }
+
+sail_status_t sail_share_load_options(const struct sail_load_options *source, struct sail_load_options **target) {
+
+    SAIL_CHECK_PTR(source);
+    SAIL_CHECK_PTR(target);
+
+#ifdef SAIL_WIN32
+    InterlockedIncrement(&shared_load_options(source)->references);
+#else
+    __atomic_add_fetch(&shared_load_options(source)->references, 1, __ATOMIC_RELAXED);
+#endif
+
+    *target = (struct sail_load_options *)source;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_detach_load_options(struct sail_load_options **load_options) {
+
+    SAIL_CHECK_PTR(load_options);
+    SAIL_CHECK_PTR(*load_options);
+
+#ifdef SAIL_WIN32
+    const long references = InterlockedCompareExchange(&shared_load_options(*load_options)->references, 0, 0);
+#else
+    const long references = __atomic_load_n(&shared_load_options(*load_options)->references, __ATOMIC_ACQUIRE);
+#endif
+
+    if (references == 1) {
+        return SAIL_OK;
+    }
+
+    struct sail_load_options *load_options_local;
+    SAIL_TRY(sail_copy_load_options(*load_options, &load_options_local));
+
+    sail_destroy_load_options(*load_options);
+    *load_options = load_options_local;
+
+    return SAIL_OK;
+}
+
+bool sail_load_meta_data_key(const struct sail_load_options *load_options, enum SailMetaData key) {
+
+    if (load_options == NULL || !(load_options->options & SAIL_OPTION_META_DATA)) {
+        return false;
+    }
+
+    return load_options->meta_data_keys == 0 || (load_options->meta_data_keys & SAIL_META_DATA_KEY_BIT(key)) != 0;
+}
+
+bool sail_load_planar_output(const struct sail_load_options *load_options) {
+
+    return load_options != NULL
+            && sail_is_planar(load_options->output_pixel_format)
+            && load_options->row_callback == NULL
+            && !sail_roi_is_set(&load_options->roi);
+}
+
+bool sail_roi_is_set(const struct sail_roi *roi) {
+
+    return roi != NULL && roi->width > 0 && roi->height > 0;
+}
+
+sail_status_t sail_clip_roi(const struct sail_roi *roi, unsigned width, unsigned height, struct sail_roi *clipped_roi) {
+
+    SAIL_CHECK_PTR(roi);
+    SAIL_CHECK_PTR(clipped_roi);
+
+    if (roi->x >= width || roi->y >= height) {
+        SAIL_LOG_ERROR("Region of interest %u,%u is outside of %ux%u frame", roi->x, roi->y, width, height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    clipped_roi->x      = roi->x;
+    clipped_roi->y      = roi->y;
+    clipped_roi->width  = (roi->width < width - roi->x) ? roi->width : width - roi->x;
+    clipped_roi->height = (roi->height < height - roi->y) ? roi->height : height - roi->y;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_check_load_limits(const struct sail_load_options *load_options, unsigned width, unsigned height, size_t bytes) {
+
+    if (load_options == NULL) {
+        return SAIL_OK;
+    }
+
+    const struct sail_load_limits *limits = &load_options->limits;
+
+    if (limits->max_pixels > 0 && (uint64_t)width * height > limits->max_pixels) {
+        SAIL_LOG_ERROR("%ux%u pixels exceed the limit of %llu pixels", width, height, (unsigned long long)limits->max_pixels);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    if (limits->max_bytes > 0 && bytes > limits->max_bytes) {
+        SAIL_LOG_ERROR("%llu bytes of pixels exceed the limit of %llu bytes", (unsigned long long)bytes, (unsigned long long)limits->max_bytes);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    return SAIL_OK;
+}
+
+void* sail_scan_line_to_load(const struct sail_load_options *load_options, const struct sail_image *image, unsigned row) {
+
+    if (load_options != NULL && load_options->row_callback != NULL) {
+        return image->pixels;
+    }
+
+    return sail_scan_line(image, row);
+}
+
+sail_status_t sail_scan_line_loaded(const struct sail_load_options *load_options, const struct sail_image *image, unsigned row) {
+
+    if (load_options == NULL) {
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(sail_check_cancellation(load_options->cancellation));
+
+    if (load_options->row_callback != NULL) {
+        SAIL_TRY(load_options->row_callback(image, row, image->pixels, load_options->row_callback_user_data));
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_put_load_diagnostic_bool(const struct sail_load_options *load_options, struct sail_image *image,
+                                            const char *key, bool value) {
+
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(key);
+
+    struct sail_hash_map *special_properties;
+    SAIL_TRY(diagnostics_map(load_options, image, &special_properties));
+
+    if (special_properties == NULL) {
+        return SAIL_OK;
+    }
+
+    struct sail_variant *variant;
+    SAIL_TRY(sail_alloc_variant(&variant));
+
+    SAIL_TRY_OR_CLEANUP(sail_set_variant_bool(variant, value),
+                        /* cleanup */ sail_destroy_variant(variant));
+
+    SAIL_TRY(put_diagnostic(special_properties, key, variant));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_put_load_diagnostic_unsigned_long(const struct sail_load_options *load_options, struct sail_image *image,
+                                                     const char *key, unsigned long value) {
+
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(key);
+
+    struct sail_hash_map *special_properties;
+    SAIL_TRY(diagnostics_map(load_options, image, &special_properties));
+
+    if (special_properties == NULL) {
+        return SAIL_OK;
+    }
+
+    struct sail_variant *variant;
+    SAIL_TRY(sail_alloc_variant(&variant));
+
+    SAIL_TRY_OR_CLEANUP(sail_set_variant_unsigned_long(variant, value),
+                        /* cleanup */ sail_destroy_variant(variant));
+
+    SAIL_TRY(put_diagnostic(special_properties, key, variant));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_put_load_diagnostic_string(const struct sail_load_options *load_options, struct sail_image *image,
+                                              const char *key, const char *value) {
+
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(key);
+    SAIL_CHECK_PTR(value);
+
+    struct sail_hash_map *special_properties;
+    SAIL_TRY(diagnostics_map(load_options, image, &special_properties));
+
+    if (special_properties == NULL) {
+        return SAIL_OK;
+    }
+
+    struct sail_variant *variant;
+    SAIL_TRY(sail_alloc_variant(&variant));
+
+    SAIL_TRY_OR_CLEANUP(sail_set_variant_string(variant, value),
+                        /* cleanup */ sail_destroy_variant(variant));
+
+    SAIL_TRY(put_diagnostic(special_properties, key, variant));
+
+    return SAIL_OK;
+}
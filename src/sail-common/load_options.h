@@ -26,6 +26,11 @@
 #ifndef SAIL_LOAD_OPTIONS_H
 #define SAIL_LOAD_OPTIONS_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/common.h>
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
@@ -33,9 +38,68 @@
 extern "C" {
 #endif
 
+struct sail_cancellation;
+struct sail_stats;
 struct sail_hash_map;
+struct sail_image;
 struct sail_load_features;
 
+/*
+ * A rectangular region of interest in pixels.
+ */
+struct sail_roi {
+
+    unsigned x;
+    unsigned y;
+    unsigned width;
+    unsigned height;
+};
+
+/*
+ * Returns the bit of the specified meta data key in sail_load_options.meta_data_keys.
+ */
+#define SAIL_META_DATA_KEY_BIT(key) ((uint64_t)1 << (key))
+
+/*
+ * Resource limits to reject malicious or unexpectedly large images before allocating memory for them.
+ * Loading fails with SAIL_ERROR_LIMIT_EXCEEDED when a limit is exceeded. 0 means no limit.
+ */
+struct sail_load_limits {
+
+    /* Maximum number of pixels, width * height, of a frame or a codec canvas. */
+    uint64_t max_pixels;
+
+    /* Maximum size in bytes of a single pixel buffer allocated for a frame by SAIL, or internally by codecs. */
+    size_t max_bytes;
+
+    /* Maximum number of frames loaded with the same loading state. */
+    unsigned max_frames;
+
+    /* Maximum total size in bytes of the meta data values and the ICC profile of a frame. */
+    size_t max_meta_data_bytes;
+};
+
+/*
+ * Receives decoded rows of a frame one by one, from top to bottom. 'scan_line' points to
+ * image->bytes_per_line bytes of the specified row and is valid only during the call.
+ * Don't access image->pixels in the callback.
+ *
+ * Returns SAIL_OK to continue loading. Any other status stops loading the frame and is returned
+ * to the caller.
+ */
+typedef sail_status_t (*sail_load_row_callback_t)(const struct sail_image *image, unsigned row, const void *scan_line, void *user_data);
+
+/*
+ * Receives a progressive frame after every output pass but the last one. 'image' holds the whole frame
+ * refined with the data read so far, and its pixels are valid only during the call. 'pass' starts with 1.
+ * Set '*stop' to true to finish the frame with the pixels of the current pass, for example, when
+ * they're good enough for a preview.
+ *
+ * Returns SAIL_OK to continue loading. Any other status stops loading the frame and is returned
+ * to the caller.
+ */
+typedef sail_status_t (*sail_load_pass_callback_t)(const struct sail_image *image, unsigned pass, bool *stop, void *user_data);
+
 /*
  * Options to modify loading operations.
  */
@@ -59,6 +123,136 @@ struct sail_load_options {
      * or forward compatible.
      */
     struct sail_hash_map *tuning;
+
+    /*
+     * Or-ed SAIL_META_DATA_KEY_BIT() bits of the meta data keys to load when SAIL_OPTION_META_DATA is set.
+     * Codecs check the keys with sail_load_meta_data_key() and skip parsing, decompressing, and copying
+     * other keys, for example, large XMP packets or compressed PNG texts. Meta data with unknown keys
+     * are selected with SAIL_META_DATA_UNKNOWN. SAIL drops the keys that are not selected from loaded
+     * images even if the codec doesn't check them.
+     *
+     * 0 by default which means all keys.
+     */
+    uint64_t meta_data_keys;
+
+    /*
+     * Alignment of every row of pixels in bytes. When it's greater than 1, bytes_per_line of loaded
+     * images is rounded up to a multiple of it. The padding bytes are zeroed. Must be 0 or a power of two.
+     * Planar images are always tightly packed.
+     * 0 by default which means tightly packed rows.
+     */
+    unsigned row_alignment;
+
+    /*
+     * Alignment of the pixels buffer in bytes. When it's greater than 1, pixels of loaded images
+     * are allocated with sail_aligned_malloc(). Combined with row_alignment, it allows SIMD consumers
+     * to use aligned loads on every row. Must be 0 or a power of two. 0 by default.
+     */
+    unsigned pixels_alignment;
+
+    /*
+     * Minimum size of the pixels buffer in bytes to allocate it with sail_alloc_file_backed_memory()
+     * instead of the heap. The OS writes file-backed pixels to a temporary file under memory pressure,
+     * so frames larger than the physical memory can be loaded and processed with sail-manip.
+     * File-backed pixels are aligned to the OS page size regardless of pixels_alignment.
+     * 0 by default which means pixels are never file-backed.
+     */
+    size_t file_backed_pixels_threshold;
+
+    /*
+     * Region of interest to load instead of the whole frame. It's clipped to the frame size, so loaded
+     * images have the dimensions of the clipped region. A region outside of the frame is an error.
+     * A zero width or height means the whole frame, which is the default.
+     *
+     * Codecs with the SAIL_CODEC_FEATURE_ROI feature decode only the region. Other codecs decode
+     * the whole frame into a temporary buffer, and the region is copied out of it. In both cases,
+     * only the region is returned to the caller.
+     *
+     * For pixel formats with less than 8 bits per pixel, the region must start on a byte boundary.
+     * With scale_denominator, the region is in the coordinates of the scaled frame.
+     */
+    struct sail_roi roi;
+
+    /*
+     * Hint to load images at a reduced resolution, for example, for thumbnails. Codecs with
+     * the SAIL_CODEC_FEATURE_SCALING feature divide the image dimensions by up to this factor
+     * in the decoder, which is much faster than loading the full image and scaling it down.
+     * Loaded images report the actual scaled dimensions. Other codecs ignore the hint.
+     *
+     * Codecs round it down to a factor they support, for example, 2, 4, or 8 for JPEG, and 8 for JPEG XL.
+     * 0 or 1 means the full resolution, which is the default.
+     */
+    unsigned scale_denominator;
+
+    /*
+     * Callback to receive decoded rows instead of the whole frame, for example, to stream them into
+     * an encoder or a hash. When it's set, sail_load_next_frame() passes every row to the callback
+     * and returns images without pixels.
+     *
+     * Codecs with the SAIL_CODEC_FEATURE_ROWS feature decode frames row by row, so the memory usage
+     * is proportional to the image width. With other codecs, when SAIL crops a region of interest
+     * itself, or when a codec cannot decode a specific frame row by row, for example, a bottom-up BMP
+     * that is RLE-compressed or read from unseekable I/O, the whole frame is decoded into a temporary
+     * buffer first. row_alignment is ignored.
+     *
+     * NULL by default.
+     */
+    sail_load_row_callback_t row_callback;
+
+    /* User data passed to row_callback. */
+    void *row_callback_user_data;
+
+    /*
+     * Pixel format to decode frames into. Codecs with native output transformations, like JPEG
+     * and PNG, ask the decoder to produce the format directly, so pixels are converted while they
+     * are decoded. Codecs that cannot produce the requested format return their usual pixel format.
+     * Consumers must always check image->pixel_format and convert with sail-manip if it differs.
+     *
+     * JPEG and AVIF decode into planar YCbCr formats, like SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420,
+     * without converting to RGB when the frame is stored with the same chroma subsampling.
+     * See sail_load_planar_output().
+     *
+     * SAIL_PIXEL_FORMAT_UNKNOWN by default which means the codec chooses the pixel format itself.
+     */
+    enum SailPixelFormat output_pixel_format;
+
+    /*
+     * Callback to receive coarse intermediate images of progressive frames, for example, to render
+     * a preview before the whole file is read, or to stop decoding early. Codecs with
+     * the SAIL_CODEC_FEATURE_PASSES feature refine progressive frames in multiple output passes and
+     * call it after every pass but the last one. The final image is returned by sail_load_next_frame()
+     * as usual. Other frames, and frames loaded with row_callback or roi, are decoded in a single pass.
+     *
+     * NULL by default.
+     */
+    sail_load_pass_callback_t pass_callback;
+
+    /* User data passed to pass_callback. */
+    void *pass_callback_user_data;
+
+    /*
+     * Cancellation token to stop loading from another thread or on a deadline. Codecs check it
+     * between rows, strips, tiles, or channels, and sail_load_next_frame() returns SAIL_ERROR_CANCELLED.
+     * The token is not owned by the options and is copied as a pointer.
+     *
+     * NULL by default.
+     */
+    struct sail_cancellation *cancellation;
+
+    /*
+     * Stats to add the stage timings and the I/O and memory counters of loading to. The stats are not
+     * owned by the options and are copied as a pointer. See sail_stats.
+     *
+     * NULL by default.
+     */
+    struct sail_stats *stats;
+
+    /*
+     * Resource limits. Frame dimensions, frame counts, and meta data are checked by SAIL,
+     * codecs check the buffers they allocate internally with sail_check_load_limits().
+     * No limits by default.
+     */
+    struct sail_load_limits limits;
 };
 
 typedef struct sail_load_options sail_load_options_t;
@@ -71,8 +265,9 @@ typedef struct sail_load_options sail_load_options_t;
 SAIL_EXPORT sail_status_t sail_alloc_load_options(struct sail_load_options **load_options);
 
 /*
- * Destroys the specified load options object and all its internal allocated memory buffers. The load options
- * MUST NOT be used anymore after calling this function. Does nothing if the load options is NULL.
+ * Drops a reference to the specified load options object. When the last reference is dropped, destroys
+ * the object and all its internal allocated memory buffers. The load options MUST NOT be used anymore
+ * after calling this function. Does nothing if the load options is NULL.
  */
 SAIL_EXPORT void sail_destroy_load_options(struct sail_load_options *load_options);
 
@@ -90,6 +285,93 @@ SAIL_EXPORT sail_status_t sail_alloc_load_options_from_features(const struct sai
  */
 SAIL_EXPORT sail_status_t sail_copy_load_options(const struct sail_load_options *source, struct sail_load_options **target);
 
+/*
+ * Shares the specified load options object instead of copying it. Increments its reference counter,
+ * and sets the target to the same object. Every reference must be dropped with sail_destroy_load_options().
+ * The load options must be allocated with sail_alloc_load_options() or other functions of this file.
+ *
+ * Shared load options must not be modified. Call sail_detach_load_options() before modifying them.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_share_load_options(const struct sail_load_options *source, struct sail_load_options **target);
+
+/*
+ * Makes the specified load options object safe to modify. If it's shared, replaces it with a deep copy
+ * and drops the reference to the shared object. Otherwise, does nothing.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_detach_load_options(struct sail_load_options **load_options);
+
+/*
+ * Returns true if SAIL_OPTION_META_DATA is set in the load options, and the specified meta data key
+ * is selected in meta_data_keys. Used by codecs to skip the meta data that are not requested.
+ * Returns false if the load options are NULL.
+ */
+SAIL_EXPORT bool sail_load_meta_data_key(const struct sail_load_options *load_options, enum SailMetaData key);
+
+/*
+ * Returns true if output_pixel_format is a planar pixel format, and codecs may decode frames into it.
+ * Planar frames are not delivered row by row and cannot be cropped, so they are not decoded with
+ * row_callback or roi. Returns false if the load options are NULL.
+ */
+SAIL_EXPORT bool sail_load_planar_output(const struct sail_load_options *load_options);
+
+/*
+ * Returns true if the region of interest is set, i.e. it has a non-zero width and height.
+ */
+SAIL_EXPORT bool sail_roi_is_set(const struct sail_roi *roi);
+
+/*
+ * Clips the region of interest to the specified frame size.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_INVALID_ARGUMENT if the region is outside of the frame.
+ */
+SAIL_EXPORT sail_status_t sail_clip_roi(const struct sail_roi *roi, unsigned width, unsigned height, struct sail_roi *clipped_roi);
+
+/*
+ * Checks a width x height pixel buffer of the specified size in bytes against the resource limits
+ * of the load options. Codecs call it before allocating internal buffers like canvases.
+ * Does nothing if the load options are NULL.
+ *
+ * Returns SAIL_OK if the buffer fits the limits, or SAIL_ERROR_LIMIT_EXCEEDED otherwise.
+ */
+SAIL_EXPORT sail_status_t sail_check_load_limits(const struct sail_load_options *load_options, unsigned width, unsigned height, size_t bytes);
+
+/*
+ * Returns the buffer to decode the specified row into. Used by codecs with the SAIL_CODEC_FEATURE_ROWS
+ * feature. When the row callback is set, SAIL allocates pixels for a single row, and all rows are decoded
+ * into it. Otherwise, or if the load options are NULL, returns sail_scan_line(image, row).
+ *
+ * Codecs must call sail_scan_line_loaded() when the row is decoded.
+ */
+SAIL_EXPORT void* sail_scan_line_to_load(const struct sail_load_options *load_options, const struct sail_image *image, unsigned row);
+
+/*
+ * Checks the cancellation token and passes the decoded row to the row callback if it's set.
+ * Does nothing if the load options are NULL.
+ *
+ * Returns SAIL_OK on success, SAIL_ERROR_CANCELLED, or the status returned by the row callback.
+ */
+SAIL_EXPORT sail_status_t sail_scan_line_loaded(const struct sail_load_options *load_options, const struct sail_image *image, unsigned row);
+
+/*
+ * Stores the diagnostic value with the specified key in the source image special properties
+ * if SAIL_OPTION_DIAGNOSTICS is set in the load options, and the image has a source image.
+ * Allocates the special properties if necessary. Does nothing otherwise, or if the load options are NULL.
+ * Used by codecs and SAIL to report how frames were decoded. See SAIL_OPTION_DIAGNOSTICS.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_put_load_diagnostic_bool(const struct sail_load_options *load_options, struct sail_image *image,
+                                                        const char *key, bool value);
+SAIL_EXPORT sail_status_t sail_put_load_diagnostic_unsigned_long(const struct sail_load_options *load_options, struct sail_image *image,
+                                                                 const char *key, unsigned long value);
+SAIL_EXPORT sail_status_t sail_put_load_diagnostic_string(const struct sail_load_options *load_options, struct sail_image *image,
+                                                          const char *key, const char *value);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
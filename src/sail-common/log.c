@@ -37,6 +37,10 @@
     #endif
 #endif
 
+#ifdef SAIL_WIN32
+    #include <windows.h>
+#endif
+
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -64,7 +68,16 @@
 #define SAIL_LOG_FPTR       stderr
 #define SAIL_LOG_STD_HANDLE STD_ERROR_HANDLE /* for Windows */
 
+/*
+ * Private functions.
+ */
+
+/* Release builds don't format debug messages by default. */
+#ifdef NDEBUG
+static enum SailLogLevel sail_max_log_level = SAIL_LOG_LEVEL_INFO;
+#else
 static enum SailLogLevel sail_max_log_level = SAIL_LOG_LEVEL_DEBUG;
+#endif
 
 static sail_logger sail_external_logger = NULL;
 
@@ -115,22 +128,8 @@ static bool check_ansi_colors_supported(void) {
     return ansi_colors_supported;
 }
 
-void sail_log(enum SailLogLevel level, const char *file, int line, const char *format, ...) {
-
-    /* Filter out. */
-    if (level > sail_max_log_level) {
-        return;
-    }
-
-    if (sail_external_logger != NULL) {
-        va_list args;
-        va_start(args, format);
-
-        sail_external_logger(level, file, line, format, args);
-
-        va_end(args);
-        return;
-    }
+/* Writes the message to stderr. */
+static void print_message(enum SailLogLevel level, const char *file, int line, const char *format, va_list args) {
 
     const char *level_string = NULL;
 
@@ -163,9 +162,6 @@ void sail_log(enum SailLogLevel level, const char *file, int line, const char *f
     }
 
     /* Print log level. */
-    va_list args;
-    va_start(args, format);
-
     fprintf(SAIL_LOG_FPTR, "SAIL: [%s] ", level_string);
 
     /* Print file and line. */
@@ -185,6 +181,168 @@ void sail_log(enum SailLogLevel level, const char *file, int line, const char *f
     }
 
     fprintf(SAIL_LOG_FPTR, "\n");
+}
+
+/* Passes the message to the external logger or writes it to stderr. */
+static void dispatch_message(enum SailLogLevel level, const char *file, int line, const char *format, va_list args) {
+
+    if (sail_external_logger != NULL) {
+        sail_external_logger(level, file, line, format, args);
+    } else {
+        print_message(level, file, line, format, args);
+    }
+}
+
+static void dispatch_formatted_message(enum SailLogLevel level, const char *file, int line, const char *format, ...) {
+
+    va_list args;
+    va_start(args, format);
+
+    dispatch_message(level, file, line, format, args);
+
+    va_end(args);
+}
+
+/*
+ * Deferred log mode. Records are formatted by the logging threads into a bounded lock-free
+ * queue and written by sail_flush_log(). Every cell has a sequence number that tells whether
+ * it's free for the producer with the same position or filled for the consumer.
+ */
+enum {
+    LOG_QUEUE_SIZE   = 128, /* Must be a power of two. */
+    LOG_MESSAGE_SIZE = 256,
+};
+
+#ifdef SAIL_WIN32
+typedef volatile LONG log_counter_t;
+#else
+typedef unsigned log_counter_t;
+#endif
+
+struct log_record {
+
+    log_counter_t sequence;
+
+    enum SailLogLevel level;
+    const char *file;
+    int line;
+    char message[LOG_MESSAGE_SIZE];
+};
+
+static struct log_record log_queue[LOG_QUEUE_SIZE];
+
+static bool log_deferred = false;
+
+static log_counter_t log_enqueue_position = 0;
+static log_counter_t log_dequeue_position = 0;
+static log_counter_t log_dropped_records  = 0;
+/* Only one thread flushes the queue at a time. */
+static log_counter_t log_flushing = 0;
+
+static inline unsigned load_counter(log_counter_t *counter) {
+
+#ifdef SAIL_WIN32
+    return (unsigned)InterlockedCompareExchange(counter, 0, 0);
+#else
+    return __atomic_load_n(counter, __ATOMIC_ACQUIRE);
+#endif
+}
+
+static inline void store_counter(log_counter_t *counter, unsigned value) {
+
+#ifdef SAIL_WIN32
+    InterlockedExchange(counter, (LONG)value);
+#else
+    __atomic_store_n(counter, value, __ATOMIC_RELEASE);
+#endif
+}
+
+static inline bool compare_exchange_counter(log_counter_t *counter, unsigned expected, unsigned desired) {
+
+#ifdef SAIL_WIN32
+    return (unsigned)InterlockedCompareExchange(counter, (LONG)desired, (LONG)expected) == expected;
+#else
+    return __atomic_compare_exchange_n(counter, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline unsigned exchange_counter(log_counter_t *counter, unsigned value) {
+
+#ifdef SAIL_WIN32
+    return (unsigned)InterlockedExchange(counter, (LONG)value);
+#else
+    return __atomic_exchange_n(counter, value, __ATOMIC_ACQ_REL);
+#endif
+}
+
+static void init_log_queue(void) {
+
+    for (unsigned i = 0; i < LOG_QUEUE_SIZE; i++) {
+        store_counter(&log_queue[i].sequence, i);
+    }
+
+    store_counter(&log_enqueue_position, 0);
+    store_counter(&log_dequeue_position, 0);
+    store_counter(&log_dropped_records, 0);
+}
+
+/* Formats the message into a free cell, or drops it if the queue is full. Never blocks. */
+static void defer_message(enum SailLogLevel level, const char *file, int line, const char *format, va_list args) {
+
+    unsigned position = load_counter(&log_enqueue_position);
+    struct log_record *record;
+
+    for (;;) {
+        record = &log_queue[position & (LOG_QUEUE_SIZE - 1)];
+
+        const int difference = (int)(load_counter(&record->sequence) - position);
+
+        if (difference == 0) {
+            if (compare_exchange_counter(&log_enqueue_position, position, position + 1)) {
+                break;
+            }
+        } else if (difference < 0) {
+            /* The queue is full. */
+            unsigned dropped;
+
+            do {
+                dropped = load_counter(&log_dropped_records);
+            } while (!compare_exchange_counter(&log_dropped_records, dropped, dropped + 1));
+
+            return;
+        }
+
+        position = load_counter(&log_enqueue_position);
+    }
+
+    record->level = level;
+    record->file  = file;
+    record->line  = line;
+    vsnprintf(record->message, sizeof(record->message), format, args);
+
+    /* Hand the cell over to the consumer. */
+    store_counter(&record->sequence, position + 1);
+}
+
+/*
+ * Public functions.
+ */
+
+void sail_log(enum SailLogLevel level, const char *file, int line, const char *format, ...) {
+
+    /* Filter out. */
+    if (!sail_log_is_enabled(level)) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+
+    if (log_deferred) {
+        defer_message(level, file, line, format, args);
+    } else {
+        dispatch_message(level, file, line, format, args);
+    }
 
     va_end(args);
 }
@@ -194,7 +352,62 @@ void sail_set_log_barrier(enum SailLogLevel max_level) {
     sail_max_log_level = max_level;
 }
 
+bool sail_log_is_enabled(enum SailLogLevel level) {
+
+    return level <= sail_max_log_level;
+}
+
 void sail_set_logger(sail_logger logger) {
 
     sail_external_logger = logger;
 }
+
+void sail_set_log_deferred(bool deferred) {
+
+    if (deferred == log_deferred) {
+        return;
+    }
+
+    if (deferred) {
+        init_log_queue();
+        log_deferred = true;
+    } else {
+        log_deferred = false;
+        sail_flush_log();
+    }
+}
+
+void sail_flush_log(void) {
+
+    /* Another thread is flushing the queue, and it will take the new records too. */
+    if (exchange_counter(&log_flushing, 1) != 0) {
+        return;
+    }
+
+    unsigned position = load_counter(&log_dequeue_position);
+
+    for (;;) {
+        struct log_record *record = &log_queue[position & (LOG_QUEUE_SIZE - 1)];
+
+        /* Empty, or the producer is still formatting the record. */
+        if (load_counter(&record->sequence) != position + 1) {
+            break;
+        }
+
+        dispatch_formatted_message(record->level, record->file, record->line, "%s", record->message);
+
+        /* Hand the cell over to the producer of the next round. */
+        position++;
+        store_counter(&log_dequeue_position, position);
+        store_counter(&record->sequence, position + LOG_QUEUE_SIZE - 1);
+    }
+
+    const unsigned dropped = exchange_counter(&log_dropped_records, 0);
+
+    if (dropped > 0 && sail_log_is_enabled(SAIL_LOG_LEVEL_WARNING)) {
+        dispatch_formatted_message(SAIL_LOG_LEVEL_WARNING, __FILE__, __LINE__,
+                                   "%u log messages were dropped as the deferred log queue was full", dropped);
+    }
+
+    store_counter(&log_flushing, 0);
+}
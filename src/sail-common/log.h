@@ -27,7 +27,9 @@
 #define SAIL_LOG_H
 
 #include <stdarg.h>
+#include <stdbool.h>
 
+#include <sail-common/config.h>
 #include <sail-common/export.h>
 
 #ifdef __cplusplus
@@ -54,12 +56,19 @@ SAIL_EXPORT void sail_log(enum SailLogLevel level, const char *file, int line, c
 
 /*
  * Sets a maximum log level barrier. Only messages of the specified log level or lower will be displayed.
+ * The default barrier is SAIL_LOG_LEVEL_DEBUG, or SAIL_LOG_LEVEL_INFO in release builds (with NDEBUG defined).
  *
  * This function is not thread-safe. It's recommended to call it in the main thread
  * before initializing SAIL.
  */
 SAIL_EXPORT void sail_set_log_barrier(enum SailLogLevel max_level);
 
+/*
+ * Returns true if messages of the specified log level pass the log barrier set by sail_set_log_barrier().
+ * Use it to skip building expensive diagnostic strings that would be filtered out anyway.
+ */
+SAIL_EXPORT bool sail_log_is_enabled(enum SailLogLevel level);
+
 /*
  * Sets an external logger to pass all filtered log messages into.
  *
@@ -68,35 +77,92 @@ SAIL_EXPORT void sail_set_log_barrier(enum SailLogLevel max_level);
  */
 SAIL_EXPORT void sail_set_logger(sail_logger logger);
 
+/*
+ * Enables or disables the deferred log mode. In the deferred mode, logging threads format messages
+ * into a bounded lock-free queue and return immediately without writing to stderr or calling
+ * the external logger. The queued messages are written by sail_flush_log().
+ *
+ * Messages longer than 255 characters are truncated. When the queue is full, new messages are dropped,
+ * and the next sail_flush_log() reports the number of dropped messages. The external logger receives
+ * the formatted messages with the "%s" format. Disabling the deferred mode flushes the queue.
+ *
+ * This function is not thread-safe. It's recommended to call it in the main thread
+ * before initializing SAIL.
+ */
+SAIL_EXPORT void sail_set_log_deferred(bool deferred);
+
+/*
+ * Writes the messages queued in the deferred log mode to stderr or passes them into the external
+ * logger, in the order they were logged. Can be called from any thread, for example periodically
+ * from a background thread owned by the application. Does nothing if another thread is flushing
+ * the queue at the moment.
+ */
+SAIL_EXPORT void sail_flush_log(void);
+
+/*
+ * Log macros of the levels less important than SAIL_MIN_COMPILED_LOG_LEVEL set in CMake are
+ * compiled out. Their arguments are not evaluated, and the compiler drops their strings.
+ */
+#ifndef SAIL_MIN_COMPILED_LOG_LEVEL
+    #define SAIL_MIN_COMPILED_LOG_LEVEL 6 /* SAIL_LOG_LEVEL_TRACE */
+#endif
+
+/* Keeps the arguments referenced to avoid unused variable warnings, but never evaluates them. */
+#define SAIL_LOG_COMPILED_OUT(level, ...) ((void)(0 && (sail_log(level, __FILE__, __LINE__, __VA_ARGS__), 0)))
+
 /*
  * Log an error message.
  */
-#define SAIL_LOG_ERROR(...) sail_log(SAIL_LOG_LEVEL_ERROR, __FILE__, __LINE__, __VA_ARGS__)
+#if SAIL_MIN_COMPILED_LOG_LEVEL >= 1
+    #define SAIL_LOG_ERROR(...) sail_log(SAIL_LOG_LEVEL_ERROR, __FILE__, __LINE__, __VA_ARGS__)
+#else
+    #define SAIL_LOG_ERROR(...) SAIL_LOG_COMPILED_OUT(SAIL_LOG_LEVEL_ERROR, __VA_ARGS__)
+#endif
 
 /*
  * Log a warning message.
  */
-#define SAIL_LOG_WARNING(...) sail_log(SAIL_LOG_LEVEL_WARNING, __FILE__, __LINE__, __VA_ARGS__)
+#if SAIL_MIN_COMPILED_LOG_LEVEL >= 2
+    #define SAIL_LOG_WARNING(...) sail_log(SAIL_LOG_LEVEL_WARNING, __FILE__, __LINE__, __VA_ARGS__)
+#else
+    #define SAIL_LOG_WARNING(...) SAIL_LOG_COMPILED_OUT(SAIL_LOG_LEVEL_WARNING, __VA_ARGS__)
+#endif
 
 /*
  * Log an important information message.
  */
-#define SAIL_LOG_INFO(...) sail_log(SAIL_LOG_LEVEL_INFO, __FILE__, __LINE__, __VA_ARGS__)
+#if SAIL_MIN_COMPILED_LOG_LEVEL >= 3
+    #define SAIL_LOG_INFO(...) sail_log(SAIL_LOG_LEVEL_INFO, __FILE__, __LINE__, __VA_ARGS__)
+#else
+    #define SAIL_LOG_INFO(...) SAIL_LOG_COMPILED_OUT(SAIL_LOG_LEVEL_INFO, __VA_ARGS__)
+#endif
 
 /*
  * Log a regular message.
  */
-#define SAIL_LOG_MESSAGE(...) sail_log(SAIL_LOG_LEVEL_MESSAGE, __FILE__, __LINE__, __VA_ARGS__)
+#if SAIL_MIN_COMPILED_LOG_LEVEL >= 4
+    #define SAIL_LOG_MESSAGE(...) sail_log(SAIL_LOG_LEVEL_MESSAGE, __FILE__, __LINE__, __VA_ARGS__)
+#else
+    #define SAIL_LOG_MESSAGE(...) SAIL_LOG_COMPILED_OUT(SAIL_LOG_LEVEL_MESSAGE, __VA_ARGS__)
+#endif
 
 /*
  * Log a debug message.
  */
-#define SAIL_LOG_DEBUG(...) sail_log(SAIL_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __VA_ARGS__)
+#if SAIL_MIN_COMPILED_LOG_LEVEL >= 5
+    #define SAIL_LOG_DEBUG(...) sail_log(SAIL_LOG_LEVEL_DEBUG, __FILE__, __LINE__, __VA_ARGS__)
+#else
+    #define SAIL_LOG_DEBUG(...) SAIL_LOG_COMPILED_OUT(SAIL_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#endif
 
 /*
  * Log a verbose trace message which is usually interesting only for developers.
  */
-#define SAIL_LOG_TRACE(...) sail_log(SAIL_LOG_LEVEL_TRACE, __FILE__, __LINE__, __VA_ARGS__)
+#if SAIL_MIN_COMPILED_LOG_LEVEL >= 6
+    #define SAIL_LOG_TRACE(...) sail_log(SAIL_LOG_LEVEL_TRACE, __FILE__, __LINE__, __VA_ARGS__)
+#else
+    #define SAIL_LOG_TRACE(...) SAIL_LOG_COMPILED_OUT(SAIL_LOG_LEVEL_TRACE, __VA_ARGS__)
+#endif
 
 /* extern "C" */
 #ifdef __cplusplus
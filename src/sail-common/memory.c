@@ -23,20 +23,486 @@
     SOFTWARE.
 */
 
+#include <errno.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef SAIL_WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
 
 #include "sail-common.h"
 
+/*
+ * Private functions.
+ */
+
+static void* default_malloc(void *user_data, size_t size) {
+
+    (void)user_data;
+
+    return malloc(size);
+}
+
+static void* default_realloc(void *user_data, void *ptr, size_t size) {
+
+    (void)user_data;
+
+    return realloc(ptr, size);
+}
+
+static void default_free(void *user_data, void *ptr) {
+
+    (void)user_data;
+
+    free(ptr);
+}
+
+static struct sail_allocator sail_current_allocator = {
+    NULL, default_malloc, default_realloc, default_free, NULL, NULL
+};
+
+/* Stats of the current loading or saving operation to count allocations into. */
+static SAIL_THREAD_LOCAL struct sail_stats *thread_stats = NULL;
+
+static inline void count_allocation(size_t size) {
+
+    if (SAIL_UNLIKELY(thread_stats != NULL)) {
+        thread_stats->allocations++;
+        thread_stats->allocated_bytes += size;
+    }
+}
+
+static bool is_default_allocator(void) {
+
+    return sail_current_allocator.malloc == default_malloc;
+}
+
+/*
+ * Header of tracked allocations. It's padded to TRACKED_HEADER_SIZE bytes, so the blocks
+ * keep the alignment of the allocator.
+ */
+struct tracked_header {
+
+    size_t size;
+    const char *tag;
+    struct tracked_header *prev;
+    struct tracked_header *next;
+};
+
+#define TRACKED_HEADER_SIZE 32
+
+static bool memory_tracking = false;
+
+/* Live tracked blocks and the stats. Guarded by the tracking lock. */
+static struct tracked_header *tracked_blocks = NULL;
+static struct sail_memory_stats tracked_stats;
+
+static SAIL_THREAD_LOCAL const char *thread_memory_tag = NULL;
+
+#ifdef SAIL_WIN32
+static volatile LONG tracking_lock = 0;
+#else
+static int tracking_lock = 0;
+#endif
+
+static void lock_tracking(void) {
+
+#ifdef SAIL_WIN32
+    while (InterlockedExchange(&tracking_lock, 1) != 0) {
+        YieldProcessor();
+    }
+#else
+    while (__atomic_exchange_n(&tracking_lock, 1, __ATOMIC_ACQUIRE) != 0) {
+    }
+#endif
+}
+
+static void unlock_tracking(void) {
+
+#ifdef SAIL_WIN32
+    InterlockedExchange(&tracking_lock, 0);
+#else
+    __atomic_store_n(&tracking_lock, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+static unsigned size_class(size_t size) {
+
+    unsigned size_class = 0;
+
+    for (size_t limit = 64; size > limit && size_class < SAIL_MEMORY_SIZE_CLASSES - 1; limit <<= 4) {
+        size_class++;
+    }
+
+    return size_class;
+}
+
+/* Must be called with the tracking lock held. */
+static void link_tracked_block(struct tracked_header *header) {
+
+    header->prev = NULL;
+    header->next = tracked_blocks;
+
+    if (tracked_blocks != NULL) {
+        tracked_blocks->prev = header;
+    }
+
+    tracked_blocks = header;
+}
+
+/* Must be called with the tracking lock held. */
+static void unlink_tracked_block(struct tracked_header *header) {
+
+    if (header->prev != NULL) {
+        header->prev->next = header->next;
+    } else {
+        tracked_blocks = header->next;
+    }
+
+    if (header->next != NULL) {
+        header->next->prev = header->prev;
+    }
+}
+
+/* Links the new block and adds it to the stats. 'old_size' is the size of the reallocated block. */
+static void *track_block(struct tracked_header *header, size_t size, size_t old_size) {
+
+    header->size = size;
+    header->tag  = thread_memory_tag;
+
+    lock_tracking();
+
+    link_tracked_block(header);
+
+    tracked_stats.current_bytes = tracked_stats.current_bytes - old_size + size;
+    tracked_stats.allocations++;
+    tracked_stats.size_class_allocations[size_class(size)]++;
+
+    if (tracked_stats.current_bytes > tracked_stats.peak_bytes) {
+        tracked_stats.peak_bytes = tracked_stats.current_bytes;
+    }
+
+    unlock_tracking();
+
+    return (unsigned char *)header + TRACKED_HEADER_SIZE;
+}
+
+static struct tracked_header *tracked_header_of(void *ptr) {
+
+    return (struct tracked_header *)((unsigned char *)ptr - TRACKED_HEADER_SIZE);
+}
+
+/* Allocates memory with the current allocator and tracks it if the tracking is enabled. */
+static void *allocate(size_t size) {
+
+    if (SAIL_LIKELY(!memory_tracking)) {
+        return sail_current_allocator.malloc(sail_current_allocator.user_data, size);
+    }
+
+    if (size > SIZE_MAX - TRACKED_HEADER_SIZE) {
+        return NULL;
+    }
+
+    struct tracked_header *header = sail_current_allocator.malloc(sail_current_allocator.user_data, size + TRACKED_HEADER_SIZE);
+
+    if (header == NULL) {
+        return NULL;
+    }
+
+    return track_block(header, size, 0);
+}
+
+static void *reallocate(void *ptr, size_t size) {
+
+    if (SAIL_LIKELY(!memory_tracking)) {
+        return sail_current_allocator.realloc(sail_current_allocator.user_data, ptr, size);
+    }
+
+    if (ptr == NULL) {
+        return allocate(size);
+    }
+
+    if (size > SIZE_MAX - TRACKED_HEADER_SIZE) {
+        return NULL;
+    }
+
+    struct tracked_header *header = tracked_header_of(ptr);
+    const size_t old_size = header->size;
+
+    lock_tracking();
+    unlink_tracked_block(header);
+    unlock_tracking();
+
+    struct tracked_header *new_header = sail_current_allocator.realloc(sail_current_allocator.user_data, header, size + TRACKED_HEADER_SIZE);
+
+    if (new_header == NULL) {
+        lock_tracking();
+        link_tracked_block(header);
+        unlock_tracking();
+
+        return NULL;
+    }
+
+    return track_block(new_header, size, old_size);
+}
+
+/*
+ * Arenas. Every allocation in a block is preceded by its size, so it can be reallocated.
+ */
+#define ARENA_FIRST_BLOCK_SIZE     2048
+#define ARENA_BLOCK_SIZE           4096
+#define ARENA_MAX_ALLOCATION_SIZE  1024
+#define ARENA_ALIGNMENT            16
+
+#define ARENA_ALIGN(size) (((size) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+struct arena_block {
+
+    struct arena_block *next;
+    unsigned char *data;
+    size_t size;
+    size_t used;
+};
+
+/* The first block is allocated together with the arena. */
+struct sail_arena {
+
+    struct arena_block *blocks;
+    struct arena_block first_block;
+};
+
+/* The data ranges of the arena blocks sorted by their addresses. Guarded by the tracking lock. */
+struct arena_range {
+
+    uintptr_t begin;
+    uintptr_t end;
+};
+
+static struct arena_range *arena_ranges = NULL;
+static size_t arena_ranges_count        = 0;
+static size_t arena_ranges_capacity     = 0;
+
+static SAIL_THREAD_LOCAL struct sail_arena *thread_arena = NULL;
+
+/* Checks without the lock if any arena exists to keep freeing fast without arenas. */
+static inline bool arenas_exist(void) {
+
+#ifdef SAIL_WIN32
+    return *(volatile size_t *)&arena_ranges_count != 0;
+#else
+    return __atomic_load_n(&arena_ranges_count, __ATOMIC_RELAXED) != 0;
+#endif
+}
+
+static inline void set_arena_ranges_count(size_t count) {
+
+#ifdef SAIL_WIN32
+    *(volatile size_t *)&arena_ranges_count = count;
+#else
+    __atomic_store_n(&arena_ranges_count, count, __ATOMIC_RELAXED);
+#endif
+}
+
+/* Returns the index of the first range that begins after the address. Must be called with the tracking lock held. */
+static size_t upper_arena_range(uintptr_t address) {
+
+    size_t low  = 0;
+    size_t high = arena_ranges_count;
+
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+
+        if (arena_ranges[middle].begin <= address) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+static bool register_arena_block(const struct arena_block *block) {
+
+    lock_tracking();
+
+    if (arena_ranges_count == arena_ranges_capacity) {
+        const size_t capacity = (arena_ranges_capacity == 0) ? 64 : arena_ranges_capacity * 2;
+        struct arena_range *ranges = sail_current_allocator.realloc(sail_current_allocator.user_data, arena_ranges, capacity * sizeof(struct arena_range));
+
+        if (ranges == NULL) {
+            unlock_tracking();
+            return false;
+        }
+
+        arena_ranges          = ranges;
+        arena_ranges_capacity = capacity;
+    }
+
+    const uintptr_t begin = (uintptr_t)block->data;
+    const size_t index = upper_arena_range(begin);
+
+    memmove(arena_ranges + index + 1, arena_ranges + index, (arena_ranges_count - index) * sizeof(struct arena_range));
+    arena_ranges[index].begin = begin;
+    arena_ranges[index].end   = begin + block->size;
+
+    set_arena_ranges_count(arena_ranges_count + 1);
+
+    unlock_tracking();
+
+    return true;
+}
+
+static void unregister_arena_block(const struct arena_block *block) {
+
+    lock_tracking();
+
+    const size_t index = upper_arena_range((uintptr_t)block->data) - 1;
+
+    memmove(arena_ranges + index, arena_ranges + index + 1, (arena_ranges_count - index - 1) * sizeof(struct arena_range));
+    set_arena_ranges_count(arena_ranges_count - 1);
+
+    if (arena_ranges_count == 0) {
+        sail_current_allocator.free(sail_current_allocator.user_data, arena_ranges);
+
+        arena_ranges          = NULL;
+        arena_ranges_capacity = 0;
+    }
+
+    unlock_tracking();
+}
+
+static bool is_arena_pointer(const void *ptr) {
+
+    const uintptr_t address = (uintptr_t)ptr;
+
+    lock_tracking();
+
+    const size_t index = upper_arena_range(address);
+    const bool result = index > 0 && address < arena_ranges[index - 1].end;
+
+    unlock_tracking();
+
+    return result;
+}
+
+static inline size_t arena_allocation_size(const void *ptr) {
+
+    return *(const size_t *)((const unsigned char *)ptr - ARENA_ALIGNMENT);
+}
+
+static void init_arena_block(struct arena_block *block, unsigned char *data, size_t size) {
+
+    block->next = NULL;
+    block->data = data;
+    block->size = size;
+    block->used = 0;
+}
+
+static void* arena_allocate(struct sail_arena *arena, size_t size) {
+
+    const size_t total_size = ARENA_ALIGNMENT + ARENA_ALIGN(size);
+    struct arena_block *block = arena->blocks;
+
+    if (block->size - block->used < total_size) {
+        const size_t block_size = (total_size > ARENA_BLOCK_SIZE) ? total_size : ARENA_BLOCK_SIZE;
+        unsigned char *ptr = allocate(ARENA_ALIGN(sizeof(struct arena_block)) + block_size);
+
+        if (ptr == NULL) {
+            return NULL;
+        }
+
+        count_allocation(block_size);
+
+        block = (struct arena_block *)ptr;
+        init_arena_block(block, ptr + ARENA_ALIGN(sizeof(struct arena_block)), block_size);
+
+        if (!register_arena_block(block)) {
+            sail_free(ptr);
+            return NULL;
+        }
+
+        block->next   = arena->blocks;
+        arena->blocks = block;
+    }
+
+    unsigned char *ptr = block->data + block->used;
+    *(size_t *)ptr = size;
+
+    block->used += total_size;
+
+    return ptr + ARENA_ALIGNMENT;
+}
+
+/* Moves the arena allocation to a new place if it grows. */
+static void* arena_reallocate(void *ptr, size_t size) {
+
+    const size_t old_size = arena_allocation_size(ptr);
+
+    if (size <= old_size) {
+        return ptr;
+    }
+
+    void *new_ptr = (thread_arena != NULL && size <= ARENA_MAX_ALLOCATION_SIZE)
+                        ? arena_allocate(thread_arena, size)
+                        : allocate(size);
+
+    if (new_ptr != NULL) {
+        memcpy(new_ptr, ptr, old_size);
+    }
+
+    return new_ptr;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_set_memory_allocator(const struct sail_allocator *allocator) {
+
+    if (allocator == NULL) {
+        sail_current_allocator.user_data      = NULL;
+        sail_current_allocator.malloc         = default_malloc;
+        sail_current_allocator.realloc        = default_realloc;
+        sail_current_allocator.free           = default_free;
+        sail_current_allocator.aligned_malloc = NULL;
+        sail_current_allocator.aligned_free   = NULL;
+
+        return SAIL_OK;
+    }
+
+    SAIL_CHECK_PTR(allocator->malloc);
+    SAIL_CHECK_PTR(allocator->realloc);
+    SAIL_CHECK_PTR(allocator->free);
+
+    if ((allocator->aligned_malloc == NULL) != (allocator->aligned_free == NULL)) {
+        SAIL_LOG_ERROR("Aligned allocation callbacks must be both set or both NULL");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    sail_current_allocator = *allocator;
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_malloc(size_t size, void **ptr) {
 
     SAIL_CHECK_PTR(ptr);
 
-    void *ptr_local = malloc(size);
+    void *ptr_local = allocate(size);
 
     if (ptr_local == NULL) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
     }
 
+    count_allocation(size);
+
     *ptr = ptr_local;
 
     return SAIL_OK;
@@ -56,12 +522,16 @@ sail_status_t sail_realloc(size_t size, void **ptr) {
 
     SAIL_CHECK_PTR(ptr);
 
-    void *ptr_local = realloc(*ptr, size);
+    void *ptr_local = (*ptr != NULL && SAIL_UNLIKELY(arenas_exist()) && is_arena_pointer(*ptr))
+                        ? arena_reallocate(*ptr, size)
+                        : reallocate(*ptr, size);
 
     if (ptr_local == NULL) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
     }
 
+    count_allocation(size);
+
     *ptr = ptr_local;
 
     return SAIL_OK;
@@ -71,12 +541,28 @@ sail_status_t sail_calloc(size_t nmemb, size_t size, void **ptr) {
 
     SAIL_CHECK_PTR(ptr);
 
-    void *ptr_local = calloc(nmemb, size);
+    void *ptr_local;
+
+    if (is_default_allocator() && !memory_tracking) {
+        ptr_local = calloc(nmemb, size);
+    } else {
+        if (size != 0 && nmemb > SIZE_MAX / size) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+        }
+
+        ptr_local = allocate(nmemb * size);
+
+        if (ptr_local != NULL) {
+            memset(ptr_local, 0, nmemb * size);
+        }
+    }
 
     if (ptr_local == NULL) {
         SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
     }
 
+    count_allocation(nmemb * size);
+
     *ptr = ptr_local;
 
     return SAIL_OK;
@@ -84,5 +570,325 @@ sail_status_t sail_calloc(size_t nmemb, size_t size, void **ptr) {
 
 void sail_free(void *ptr) {
 
-    free(ptr);
+    /* Arena memory is released with the arena. */
+    if (ptr != NULL && SAIL_UNLIKELY(arenas_exist()) && is_arena_pointer(ptr)) {
+        return;
+    }
+
+    if (SAIL_UNLIKELY(memory_tracking) && ptr != NULL) {
+        struct tracked_header *header = tracked_header_of(ptr);
+
+        lock_tracking();
+
+        unlink_tracked_block(header);
+
+        tracked_stats.current_bytes -= header->size;
+        tracked_stats.frees++;
+
+        unlock_tracking();
+
+        ptr = header;
+    }
+
+    sail_current_allocator.free(sail_current_allocator.user_data, ptr);
+}
+
+sail_status_t sail_aligned_malloc(size_t alignment, size_t size, void **ptr) {
+
+    SAIL_CHECK_PTR(ptr);
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        SAIL_LOG_ERROR("Alignment %u is not a power of two", (unsigned)alignment);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    /* Tracked aligned blocks are over-allocated with sail_malloc(). */
+    if (sail_current_allocator.aligned_malloc != NULL && !memory_tracking) {
+        void *ptr_local = sail_current_allocator.aligned_malloc(sail_current_allocator.user_data, alignment, size);
+
+        if (ptr_local == NULL) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+        }
+
+        count_allocation(size);
+
+        *ptr = ptr_local;
+
+        return SAIL_OK;
+    }
+
+    /* Over-allocate and store the original pointer right before the aligned block. */
+    if (alignment < sizeof(void *)) {
+        alignment = sizeof(void *);
+    }
+
+    if (size > SIZE_MAX - alignment - sizeof(void *)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    void *original;
+    SAIL_TRY(sail_malloc(size + alignment + sizeof(void *), &original));
+
+    const uintptr_t aligned = ((uintptr_t)original + sizeof(void *) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    ((void **)aligned)[-1] = original;
+
+    *ptr = (void *)aligned;
+
+    return SAIL_OK;
+}
+
+void sail_aligned_free(void *ptr) {
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    if (sail_current_allocator.aligned_free != NULL && !memory_tracking) {
+        sail_current_allocator.aligned_free(sail_current_allocator.user_data, ptr);
+        return;
+    }
+
+    sail_free(((void **)ptr)[-1]);
+}
+
+sail_status_t sail_alloc_file_backed_memory(size_t size, void **ptr) {
+
+    SAIL_CHECK_PTR(ptr);
+
+    if (size == 0) {
+        SAIL_LOG_ERROR("Cannot allocate zero bytes of file-backed memory");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+#ifdef SAIL_WIN32
+    char dir_path[MAX_PATH + 1];
+    char path[MAX_PATH + 1];
+
+    if (GetTempPathA(sizeof(dir_path), dir_path) == 0 || GetTempFileNameA(dir_path, "sail", 0, path) == 0) {
+        SAIL_LOG_ERROR("Failed to get a temporary file name. Error: 0x%X", GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    /* The file is deleted when the view is unmapped and all the handles are closed. */
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                                FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+
+    if (file == INVALID_HANDLE_VALUE) {
+        SAIL_LOG_ERROR("Failed to create temporary file '%s'. Error: 0x%X", path, GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    const unsigned long long size64 = size;
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, (DWORD)(size64 >> 32), (DWORD)(size64 & 0xFFFFFFFF), NULL);
+    CloseHandle(file);
+
+    if (mapping == NULL) {
+        SAIL_LOG_ERROR("Failed to map %llu bytes of temporary file '%s'. Error: 0x%X", size64, path, GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    void *ptr_local = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    CloseHandle(mapping);
+
+    if (ptr_local == NULL) {
+        SAIL_LOG_ERROR("Failed to map %llu bytes of temporary file '%s'. Error: 0x%X", size64, path, GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+#else
+    const char *dir_path = getenv("TMPDIR");
+
+    if (dir_path == NULL || dir_path[0] == '\0') {
+        dir_path = "/tmp";
+    }
+
+    char *path;
+    SAIL_TRY(sail_concat(&path, 2, dir_path, "/sail-XXXXXX"));
+
+    const int fd = mkstemp(path);
+
+    if (fd < 0) {
+        SAIL_LOG_ERROR("Failed to create temporary file '%s': %s", path, strerror(errno));
+        sail_free(path);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    /* The file is deleted when the memory is unmapped. */
+    unlink(path);
+    sail_free(path);
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        SAIL_LOG_ERROR("Failed to resize temporary file to %llu bytes: %s", (unsigned long long)size, strerror(errno));
+        close(fd);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    void *ptr_local = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (ptr_local == MAP_FAILED) {
+        SAIL_LOG_ERROR("Failed to map %llu bytes of temporary file: %s", (unsigned long long)size, strerror(errno));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+#endif
+
+    count_allocation(size);
+
+    *ptr = ptr_local;
+
+    return SAIL_OK;
+}
+
+void sail_free_file_backed_memory(void *ptr, size_t size) {
+
+    if (ptr == NULL) {
+        return;
+    }
+
+#ifdef SAIL_WIN32
+    (void)size;
+
+    if (!UnmapViewOfFile(ptr)) {
+        SAIL_LOG_ERROR("Failed to unmap file-backed memory. Error: 0x%X", GetLastError());
+    }
+#else
+    if (munmap(ptr, size) != 0) {
+        SAIL_LOG_ERROR("Failed to unmap file-backed memory: %s", strerror(errno));
+    }
+#endif
+}
+
+struct sail_stats* sail_set_thread_stats(struct sail_stats *stats) {
+
+    struct sail_stats *previous = thread_stats;
+    thread_stats = stats;
+
+    return previous;
+}
+
+sail_status_t sail_set_memory_tracking(bool enabled) {
+
+    if (enabled == memory_tracking) {
+        return SAIL_OK;
+    }
+
+    if (!enabled && tracked_blocks != NULL) {
+        SAIL_LOG_ERROR("Cannot disable memory tracking while tracked memory is allocated");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    }
+
+    memset(&tracked_stats, 0, sizeof(tracked_stats));
+    memory_tracking = enabled;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_memory_stats(struct sail_memory_stats *stats) {
+
+    SAIL_CHECK_PTR(stats);
+
+    lock_tracking();
+    *stats = tracked_stats;
+    unlock_tracking();
+
+    return SAIL_OK;
+}
+
+void sail_reset_memory_peak(void) {
+
+    lock_tracking();
+    tracked_stats.peak_bytes = tracked_stats.current_bytes;
+    unlock_tracking();
+}
+
+const char* sail_set_memory_tag(const char *tag) {
+
+    const char *previous = thread_memory_tag;
+    thread_memory_tag = tag;
+
+    return previous;
+}
+
+size_t sail_log_memory_leaks(void) {
+
+    size_t leaks = 0;
+
+    /* Not locked, so external loggers may allocate memory. */
+    for (const struct tracked_header *header = tracked_blocks; header != NULL; header = header->next) {
+        SAIL_LOG_WARNING("Leaked %llu bytes at %p allocated with tag '%s'",
+                            (unsigned long long)header->size, (const void *)((const unsigned char *)header + TRACKED_HEADER_SIZE),
+                            (header->tag == NULL) ? "" : header->tag);
+        leaks++;
+    }
+
+    return leaks;
+}
+
+sail_status_t sail_alloc_arena(struct sail_arena **arena) {
+
+    SAIL_CHECK_PTR(arena);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(ARENA_ALIGN(sizeof(struct sail_arena)) + ARENA_FIRST_BLOCK_SIZE, &ptr));
+    struct sail_arena *arena_local = ptr;
+
+    init_arena_block(&arena_local->first_block, (unsigned char *)ptr + ARENA_ALIGN(sizeof(struct sail_arena)), ARENA_FIRST_BLOCK_SIZE);
+    arena_local->blocks = &arena_local->first_block;
+
+    if (!register_arena_block(&arena_local->first_block)) {
+        sail_free(arena_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    *arena = arena_local;
+
+    return SAIL_OK;
+}
+
+void sail_destroy_arena(struct sail_arena *arena) {
+
+    if (arena == NULL) {
+        return;
+    }
+
+    for (struct arena_block *block = arena->blocks; block != NULL;) {
+        struct arena_block *next = block->next;
+
+        unregister_arena_block(block);
+
+        if (block != &arena->first_block) {
+            sail_free(block);
+        }
+
+        block = next;
+    }
+
+    sail_free(arena);
+}
+
+struct sail_arena* sail_set_thread_arena(struct sail_arena *arena) {
+
+    struct sail_arena *previous = thread_arena;
+    thread_arena = arena;
+
+    return previous;
+}
+
+sail_status_t sail_private_arena_malloc(size_t size, void **ptr) {
+
+    SAIL_CHECK_PTR(ptr);
+
+    if (thread_arena == NULL || size > ARENA_MAX_ALLOCATION_SIZE) {
+        SAIL_TRY(sail_malloc(size, ptr));
+        return SAIL_OK;
+    }
+
+    void *ptr_local = arena_allocate(thread_arena, size);
+
+    if (ptr_local == NULL) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    *ptr = ptr_local;
+
+    return SAIL_OK;
 }
@@ -26,7 +26,9 @@
 #ifndef SAIL_MEMORY_H
 #define SAIL_MEMORY_H
 
+#include <stdbool.h>
 #include <stddef.h> /* size_t */
+#include <stdint.h>
 
 #include <sail-common/export.h>
 #include <sail-common/status.h>
@@ -35,6 +37,46 @@
 extern "C" {
 #endif
 
+struct sail_arena;
+struct sail_stats;
+
+/*
+ * Custom memory allocator. All the callbacks receive 'user_data' as the first argument.
+ *
+ * 'malloc', 'realloc', and 'free' are mandatory and must follow the semantics of the standard
+ * functions. 'realloc' receives NULL to allocate new memory.
+ *
+ * 'aligned_malloc' and 'aligned_free' are optional and must be both set or both NULL.
+ * When they are NULL, sail_aligned_malloc() over-allocates memory with 'malloc'.
+ */
+struct sail_allocator {
+
+    void *user_data;
+
+    void* (*malloc)(void *user_data, size_t size);
+    void* (*realloc)(void *user_data, void *ptr, size_t size);
+    void  (*free)(void *user_data, void *ptr);
+
+    void* (*aligned_malloc)(void *user_data, size_t alignment, size_t size);
+    void  (*aligned_free)(void *user_data, void *ptr);
+};
+
+/*
+ * Routes all the memory allocations made with sail_malloc(), sail_realloc(), sail_calloc(),
+ * sail_aligned_malloc(), and the corresponding free functions through the specified allocator.
+ * This includes the codecs that pass SAIL memory functions to their underlying libraries like libpng,
+ * libjxl, and QOI. The allocator is copied. Pass NULL to restore the standard allocator.
+ *
+ * Memory allocated with one allocator must never be freed with another one, so set the allocator
+ * before initializing SAIL and allocating any SAIL objects.
+ *
+ * This function is not thread-safe. It's recommended to call it in the main thread
+ * before initializing SAIL.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_set_memory_allocator(const struct sail_allocator *allocator);
+
 /*
  * Interface to malloc().
  *
@@ -72,6 +114,150 @@ SAIL_EXPORT sail_status_t sail_calloc(size_t nmemb, size_t size, void **ptr);
  */
 SAIL_EXPORT void sail_free(void *ptr);
 
+/*
+ * Allocates memory aligned to the specified alignment. The alignment must be a power of two.
+ * The memory must be freed with sail_aligned_free().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_aligned_malloc(size_t alignment, size_t size, void **ptr);
+
+/*
+ * Frees memory allocated with sail_aligned_malloc(). Does nothing if the pointer is NULL.
+ */
+SAIL_EXPORT void sail_aligned_free(void *ptr);
+
+/*
+ * Allocates zeroed memory backed by an anonymous temporary file. The OS writes its pages
+ * to the file under memory pressure instead of keeping them in RAM or swap, so the buffer
+ * may exceed the physical memory. The file is created in the directory specified by TMPDIR
+ * on POSIX systems or by GetTempPath() on Windows, and is deleted when the memory is freed.
+ * The memory is aligned to the OS page size and ignores the allocator set with
+ * sail_set_memory_allocator(). The memory must be freed with sail_free_file_backed_memory().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_file_backed_memory(size_t size, void **ptr);
+
+/*
+ * Frees memory of the specified size allocated with sail_alloc_file_backed_memory().
+ * Does nothing if the pointer is NULL.
+ */
+SAIL_EXPORT void sail_free_file_backed_memory(void *ptr, size_t size);
+
+/*
+ * Sets the stats to count the allocations of the current thread into, or stops counting if the stats
+ * are NULL. Loading and saving functions set the stats from their options while they run.
+ *
+ * Returns the previous stats of the current thread.
+ */
+SAIL_EXPORT struct sail_stats* sail_set_thread_stats(struct sail_stats *stats);
+
+/* Number of allocation size classes in sail_memory_stats. */
+#define SAIL_MEMORY_SIZE_CLASSES 7
+
+/*
+ * Statistics of the memory allocated with sail_malloc(), sail_realloc(), sail_calloc(),
+ * and sail_aligned_malloc() while the memory tracking is enabled.
+ */
+struct sail_memory_stats {
+
+    /* Number of bytes currently allocated. */
+    uint64_t current_bytes;
+
+    /* Maximum number of bytes allocated at the same time. */
+    uint64_t peak_bytes;
+
+    /* Number of allocations and reallocations. */
+    uint64_t allocations;
+
+    /* Number of freed blocks. */
+    uint64_t frees;
+
+    /*
+     * Number of allocations by the size: up to 64 bytes, 1 KiB, 16 KiB, 256 KiB, 4 MiB, 64 MiB,
+     * and larger.
+     */
+    uint64_t size_class_allocations[SAIL_MEMORY_SIZE_CLASSES];
+};
+
+typedef struct sail_memory_stats sail_memory_stats_t;
+
+/*
+ * Enables or disables tracking of every allocated block to collect sail_memory_stats and find leaks.
+ * The tracking adds a small header to every block and serializes allocations with a lock, so it's
+ * intended for debugging and memory regression tests. Enabling the tracking resets the stats.
+ * The tracking cannot be disabled while tracked blocks are allocated.
+ *
+ * Memory allocated with the tracking disabled must never be freed with the tracking enabled
+ * and vice versa, so enable the tracking before initializing SAIL and allocating any SAIL objects.
+ *
+ * This function is not thread-safe. It's recommended to call it in the main thread
+ * before initializing SAIL.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_set_memory_tracking(bool enabled);
+
+/*
+ * Retrieves the memory stats collected since the memory tracking was enabled. The stats are zero
+ * if the tracking is disabled.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_memory_stats(struct sail_memory_stats *stats);
+
+/*
+ * Resets the peak number of bytes to the number of bytes currently allocated to measure
+ * the high-water mark of the next operation.
+ */
+SAIL_EXPORT void sail_reset_memory_peak(void);
+
+/*
+ * Sets the tag to mark the tracked blocks allocated by the current thread with, for example,
+ * the name of a call site. The tag must be a static string. Pass NULL to clear the tag.
+ *
+ * Returns the previous tag of the current thread.
+ */
+SAIL_EXPORT const char* sail_set_memory_tag(const char *tag);
+
+/*
+ * Logs every tracked block that is still allocated along with its size and tag as a warning.
+ * Call it when no other thread allocates memory, for example, before exiting.
+ *
+ * Returns the number of the allocated blocks.
+ */
+SAIL_EXPORT size_t sail_log_memory_leaks(void);
+
+/*
+ * Allocates a new arena to hold the small side structures of an image, like the resolution,
+ * the palette, the ICC profile, the source image, the meta data, and the special properties,
+ * in a few large blocks instead of many small allocations. See sail_set_thread_arena().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_arena(struct sail_arena **arena);
+
+/*
+ * Destroys the specified arena and releases all the memory allocated in it at once.
+ * Does nothing if the arena is NULL.
+ */
+SAIL_EXPORT void sail_destroy_arena(struct sail_arena *arena);
+
+/*
+ * Sets the arena to allocate the side structures of images created by the current thread in,
+ * or stops using an arena if it's NULL. Only the side structure allocation functions, like
+ * sail_alloc_palette() or sail_alloc_meta_data_node(), and only small blocks use the arena.
+ * Memory in the arena can be freed and reallocated as usual: sail_free() ignores it, and
+ * sail_realloc() moves it out of the arena when it grows. It's valid until the arena is destroyed.
+ *
+ * Codecs that keep side structures allocated while loading a frame in their states must
+ * suspend the arena while allocating them, as the arena is destroyed with the frame.
+ *
+ * Returns the previous arena of the current thread.
+ */
+SAIL_EXPORT struct sail_arena* sail_set_thread_arena(struct sail_arena *arena);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
@@ -34,7 +34,7 @@ sail_status_t sail_alloc_meta_data(struct sail_meta_data **meta_data) {
     SAIL_CHECK_PTR(meta_data);
 
     void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct sail_meta_data), &ptr));
+    SAIL_TRY(sail_private_arena_malloc(sizeof(struct sail_meta_data), &ptr));
     *meta_data = ptr;
 
     (*meta_data)->key         = SAIL_META_DATA_UNKNOWN;
@@ -34,7 +34,7 @@ sail_status_t sail_alloc_palette(struct sail_palette **palette) {
     SAIL_CHECK_PTR(palette);
 
     void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct sail_palette), &ptr));
+    SAIL_TRY(sail_private_arena_malloc(sizeof(struct sail_palette), &ptr));
     *palette = ptr;
 
     (*palette)->pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN;
@@ -65,7 +65,7 @@ sail_status_t sail_copy_palette(const struct sail_palette *source_palette, struc
     const unsigned bits_per_pixel = sail_bits_per_pixel(source_palette->pixel_format);
     const unsigned palette_size = source_palette->color_count * ((bits_per_pixel + 7) / 8);
 
-    SAIL_TRY_OR_CLEANUP(sail_malloc(palette_size, &palette_local->data),
+    SAIL_TRY_OR_CLEANUP(sail_private_arena_malloc(palette_size, &palette_local->data),
                         /* cleanup */ sail_destroy_palette(palette_local));
 
     palette_local->pixel_format = source_palette->pixel_format;
@@ -91,7 +91,7 @@ sail_status_t sail_alloc_palette_for_data(enum SailPixelFormat pixel_format, uns
     const unsigned palette_size = sail_bytes_per_line(color_count, pixel_format);
 
     void *ptr;
-    SAIL_TRY_OR_CLEANUP(sail_malloc(palette_size, &ptr),
+    SAIL_TRY_OR_CLEANUP(sail_private_arena_malloc(palette_size, &ptr),
                         /* cleanup */ sail_destroy_palette(palette_local));
     palette_local->data = ptr;
 
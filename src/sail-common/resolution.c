@@ -40,7 +40,7 @@ sail_status_t sail_alloc_resolution_from_data(enum SailResolutionUnit unit, doub
     SAIL_CHECK_PTR(resolution);
 
     void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct sail_resolution), &ptr));
+    SAIL_TRY(sail_private_arena_malloc(sizeof(struct sail_resolution), &ptr));
     *resolution = ptr;
 
     (*resolution)->unit = unit;
@@ -30,6 +30,9 @@
 
 #include <sail-common/config.h>
 
+#include <sail-common/buffered_reader.h>
+#include <sail-common/buffered_writer.h>
+#include <sail-common/cancellation.h>
 #include <sail-common/common.h>
 #include <sail-common/common_serialize.h>
 #include <sail-common/compiler_specifics.h>
@@ -51,8 +54,11 @@
 #include <sail-common/save_features.h>
 #include <sail-common/save_options.h>
 #include <sail-common/source_image.h>
+#include <sail-common/stats.h>
 #include <sail-common/status.h>
 #include <sail-common/string_node.h>
+#include <sail-common/thread_pool.h>
+#include <sail-common/trace.h>
 #include <sail-common/utils.h>
 #include <sail-common/variant.h>
 #include <sail-common/variant_node.h>
@@ -60,6 +66,7 @@
 #ifdef SAIL_BUILD
     #include <sail-common/hash_map_private.h>
     #include <sail-common/linked_list_node.h>
+    #include <sail-common/memory_private.h>
 #endif
 
 #endif
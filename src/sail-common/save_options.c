@@ -26,20 +26,51 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#ifdef SAIL_WIN32
+    #include <windows.h>
+#endif
+
 #include "sail-common.h"
 
+/*
+ * Private functions.
+ */
+
+/* Save options with a reference counter. The public structure goes first. */
+struct shared_save_options {
+
+    struct sail_save_options save_options;
+    volatile long references;
+};
+
+static inline struct shared_save_options* shared_save_options(const struct sail_save_options *save_options) {
+
+    return (struct shared_save_options *)save_options;
+}
+
+/*
+ * Public functions.
+ */
+
 sail_status_t sail_alloc_save_options(struct sail_save_options **save_options) {
 
     SAIL_CHECK_PTR(save_options);
 
     void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct sail_save_options), &ptr));
+    SAIL_TRY(sail_malloc(sizeof(struct shared_save_options), &ptr));
+    shared_save_options(ptr)->references = 1;
     *save_options = ptr;
 
-    (*save_options)->options           = 0;
-    (*save_options)->compression       = SAIL_COMPRESSION_UNKNOWN;
-    (*save_options)->compression_level = 0;
-    (*save_options)->tuning            = NULL;
+    (*save_options)->options                = 0;
+    (*save_options)->compression            = SAIL_COMPRESSION_UNKNOWN;
+    (*save_options)->compression_level      = 0;
+    (*save_options)->target_size            = 0;
+    (*save_options)->target_quality         = 0;
+    (*save_options)->tuning                 = NULL;
+    (*save_options)->row_callback           = NULL;
+    (*save_options)->row_callback_user_data = NULL;
+    (*save_options)->cancellation           = NULL;
+    (*save_options)->stats                  = NULL;
 
     return SAIL_OK;
 }
@@ -50,6 +81,17 @@ void sail_destroy_save_options(struct sail_save_options *save_options) {
         return;
     }
 
+#ifdef SAIL_WIN32
+    const long references = InterlockedDecrement(&shared_save_options(save_options)->references);
+#else
+    const long references = __atomic_sub_fetch(&shared_save_options(save_options)->references, 1, __ATOMIC_ACQ_REL);
+#endif
+
+    if (references > 0) {
+        return;
+    }
+
+    sail_destroy_hash_map(save_options->tuning);
     sail_free(save_options);
 }
 
@@ -90,9 +132,15 @@ sail_status_t sail_copy_save_options(const struct sail_save_options *source, str
     struct sail_save_options *target_local;
     SAIL_TRY(sail_alloc_save_options(&target_local));
 
-    target_local->options           = source->options;
-    target_local->compression       = source->compression;
-    target_local->compression_level = source->compression_level;
+    target_local->options                = source->options;
+    target_local->compression            = source->compression;
+    target_local->compression_level      = source->compression_level;
+    target_local->target_size            = source->target_size;
+    target_local->target_quality         = source->target_quality;
+    target_local->row_callback           = source->row_callback;
+    target_local->row_callback_user_data = source->row_callback_user_data;
+    target_local->cancellation           = source->cancellation;
+    target_local->stats                  = source->stats;
 
     if (source->tuning != NULL) {
         SAIL_TRY_OR_CLEANUP(sail_copy_hash_map(source->tuning, &target_local->tuning),
@@ -103,3 +151,60 @@ sail_status_t sail_copy_save_options(const struct sail_save_options *source, str
 
     return SAIL_OK;
 }
+
+sail_status_t sail_share_save_options(const struct sail_save_options *source, struct sail_save_options **target) {
+
+    SAIL_CHECK_PTR(source);
+    SAIL_CHECK_PTR(target);
+
+#ifdef SAIL_WIN32
+    InterlockedIncrement(&shared_save_options(source)->references);
+#else
+    __atomic_add_fetch(&shared_save_options(source)->references, 1, __ATOMIC_RELAXED);
+#endif
+
+    *target = (struct sail_save_options *)source;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_detach_save_options(struct sail_save_options **save_options) {
+
+    SAIL_CHECK_PTR(save_options);
+    SAIL_CHECK_PTR(*save_options);
+
+#ifdef SAIL_WIN32
+    const long references = InterlockedCompareExchange(&shared_save_options(*save_options)->references, 0, 0);
+#else
+    const long references = __atomic_load_n(&shared_save_options(*save_options)->references, __ATOMIC_ACQUIRE);
+#endif
+
+    if (references == 1) {
+        return SAIL_OK;
+    }
+
+    struct sail_save_options *save_options_local;
+    SAIL_TRY(sail_copy_save_options(*save_options, &save_options_local));
+
+    sail_destroy_save_options(*save_options);
+    *save_options = save_options_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_scan_line_to_save(const struct sail_save_options *save_options, const struct sail_image *image,
+                                      unsigned row, const void **scan_line) {
+
+    if (save_options != NULL) {
+        SAIL_TRY(sail_check_cancellation(save_options->cancellation));
+    }
+
+    if (save_options != NULL && save_options->row_callback != NULL) {
+        SAIL_TRY(save_options->row_callback(image, row, image->pixels, save_options->row_callback_user_data));
+        *scan_line = image->pixels;
+    } else {
+        *scan_line = sail_scan_line(image, row);
+    }
+
+    return SAIL_OK;
+}
@@ -26,6 +26,8 @@
 #ifndef SAIL_SAVE_OPTIONS_H
 #define SAIL_SAVE_OPTIONS_H
 
+#include <stddef.h>
+
 #include <sail-common/common.h>
 #include <sail-common/export.h>
 #include <sail-common/status.h>
@@ -34,9 +36,22 @@
 extern "C" {
 #endif
 
+struct sail_cancellation;
+struct sail_stats;
 struct sail_hash_map;
+struct sail_image;
 struct sail_save_features;
 
+/*
+ * Fills the specified row of a frame being saved. Rows are requested one by one, from top to bottom.
+ * 'scan_line' points to image->bytes_per_line bytes and is valid only during the call.
+ * Don't access image->pixels in the callback.
+ *
+ * Returns SAIL_OK to continue saving. Any other status stops saving the frame and is returned
+ * to the caller.
+ */
+typedef sail_status_t (*sail_save_row_callback_t)(const struct sail_image *image, unsigned row, void *scan_line, void *user_data);
+
 /*
  * Options to modify saving operations.
  */
@@ -65,8 +80,60 @@ struct sail_save_options {
      */
     double compression_level;
 
+    /*
+     * Maximum size of the encoded frame in bytes. When it's not 0, the codec searches for the highest
+     * quality that fits and ignores compression_level. If even the lowest quality doesn't fit,
+     * the lowest quality is saved. Supported by the JPEG and WEBP codecs, ignored by other codecs.
+     *
+     * 0 by default.
+     */
+    size_t target_size;
+
+    /*
+     * Minimum quality of the encoded frame, as PSNR in dB of the encoded samples. When it's not 0,
+     * the codec searches for the lowest quality that reaches it and ignores compression_level.
+     * When both targets are set, the quality is capped by target_size. Supported by the JPEG
+     * and WEBP codecs, ignored by other codecs.
+     *
+     * 0 by default.
+     */
+    double target_quality;
+
     /* Codec-specific tuning options. */
     struct sail_hash_map *tuning;
+
+    /*
+     * Callback to produce rows instead of passing the whole frame, for example, to transcode images
+     * that don't fit into memory. When it's set, sail_write_next_frame() accepts images without pixels
+     * and requests every row from the callback.
+     *
+     * Codecs with the SAIL_CODEC_FEATURE_ROWS feature request rows while encoding, so the memory usage
+     * is proportional to the image width. With other codecs, the whole frame is requested into
+     * a temporary buffer first.
+     *
+     * NULL by default.
+     */
+    sail_save_row_callback_t row_callback;
+
+    /* User data passed to row_callback. */
+    void *row_callback_user_data;
+
+    /*
+     * Cancellation token to stop saving from another thread or on a deadline. Codecs check it
+     * between rows, strips, or tiles, and sail_write_next_frame() returns SAIL_ERROR_CANCELLED.
+     * The token is not owned by the options and is copied as a pointer.
+     *
+     * NULL by default.
+     */
+    struct sail_cancellation *cancellation;
+
+    /*
+     * Stats to add the stage timings and the I/O and memory counters of saving to. The stats are not
+     * owned by the options and are copied as a pointer. See sail_stats.
+     *
+     * NULL by default.
+     */
+    struct sail_stats *stats;
 };
 
 typedef struct sail_save_options sail_save_options_t;
@@ -79,9 +146,9 @@ typedef struct sail_save_options sail_save_options_t;
 SAIL_EXPORT sail_status_t sail_alloc_save_options(struct sail_save_options **save_options);
 
 /*
- * Destroys the specified save options object and all its internal allocated memory buffers.
- * The save options MUST NOT be used anymore after calling this function. It does nothing
- * if the save options is NULL.
+ * Drops a reference to the specified save options object. When the last reference is dropped,
+ * destroys the object and all its internal allocated memory buffers. The save options MUST NOT
+ * be used anymore after calling this function. It does nothing if the save options is NULL.
  */
 SAIL_EXPORT void sail_destroy_save_options(struct sail_save_options *save_options);
 
@@ -99,6 +166,36 @@ SAIL_EXPORT sail_status_t sail_alloc_save_options_from_features(const struct sai
  */
 SAIL_EXPORT sail_status_t sail_copy_save_options(const struct sail_save_options *source, struct sail_save_options **target);
 
+/*
+ * Shares the specified save options object instead of copying it. Increments its reference counter,
+ * and sets the target to the same object. Every reference must be dropped with sail_destroy_save_options().
+ * The save options must be allocated with sail_alloc_save_options() or other functions of this file.
+ *
+ * Shared save options must not be modified. Call sail_detach_save_options() before modifying them.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_share_save_options(const struct sail_save_options *source, struct sail_save_options **target);
+
+/*
+ * Makes the specified save options object safe to modify. If it's shared, replaces it with a deep copy
+ * and drops the reference to the shared object. Otherwise, does nothing.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_detach_save_options(struct sail_save_options **save_options);
+
+/*
+ * Returns the specified row to encode. Used by codecs with the SAIL_CODEC_FEATURE_ROWS feature.
+ * When the row callback is set, SAIL allocates pixels for a single row, and the callback fills it
+ * with every row. Otherwise, or if the save options are NULL, returns sail_scan_line(image, row).
+ * Checks the cancellation token first.
+ *
+ * Returns SAIL_OK on success, SAIL_ERROR_CANCELLED, or the status returned by the row callback.
+ */
+SAIL_EXPORT sail_status_t sail_scan_line_to_save(const struct sail_save_options *save_options, const struct sail_image *image,
+                                                 unsigned row, const void **scan_line);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
@@ -34,7 +34,7 @@ sail_status_t sail_alloc_source_image(struct sail_source_image **source_image) {
     SAIL_CHECK_PTR(source_image);
 
     void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct sail_source_image), &ptr));
+    SAIL_TRY(sail_private_arena_malloc(sizeof(struct sail_source_image), &ptr));
     *source_image = ptr;
 
     (*source_image)->pixel_format       = SAIL_PIXEL_FORMAT_UNKNOWN;
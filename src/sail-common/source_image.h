@@ -65,7 +65,8 @@ struct sail_source_image {
     /*
      * Source image orientation.
      *
-     * LOAD: Set by SAIL to the source image orientation.
+     * LOAD: Set by SAIL to the source image orientation. SAIL_ORIENTATION_NORMAL when the orientation
+     *       is already applied with SAIL_OPTION_AUTO_ORIENT.
      * SAVE: Ignored.
      */
     enum SailOrientation orientation;
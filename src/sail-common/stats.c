@@ -0,0 +1,53 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stddef.h>
+
+#include "sail-common.h"
+
+/*
+ * Public functions.
+ */
+
+void sail_add_stats(struct sail_stats *target, const struct sail_stats *source) {
+
+    if (target == NULL || source == NULL) {
+        return;
+    }
+
+    target->detection_ns    += source->detection_ns;
+    target->init_ns         += source->init_ns;
+    target->seek_ns         += source->seek_ns;
+    target->frames_ns       += source->frames_ns;
+    target->finish_ns       += source->finish_ns;
+    target->frames          += source->frames;
+    target->read_calls      += source->read_calls;
+    target->bytes_read      += source->bytes_read;
+    target->write_calls     += source->write_calls;
+    target->bytes_written   += source->bytes_written;
+    target->seek_calls      += source->seek_calls;
+    target->allocations     += source->allocations;
+    target->allocated_bytes += source->allocated_bytes;
+}
@@ -0,0 +1,97 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_STATS_H
+#define SAIL_STATS_H
+
+#include <stdint.h>
+
+#include <sail-common/export.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Per-stage timings and I/O and memory counters of loading and saving operations. Set it in load
+ * or save options to find out where an operation spends its time. SAIL adds to the counters,
+ * so one structure may collect several operations. Timings are in nanoseconds as returned
+ * by sail_now_ns().
+ *
+ * A zero-initialized structure is valid. It's not copied with the options, so it must outlive all
+ * the operations using it. The counters are not atomic, so every thread must use its own structure.
+ * Merge them with sail_add_stats() to export to metrics.
+ */
+struct sail_stats {
+
+    /* Time spent detecting the codec by the file extension or magic number. */
+    uint64_t detection_ns;
+
+    /* Time spent loading the codec and initializing the loading or saving. */
+    uint64_t init_ns;
+
+    /* Time spent reading or writing frame headers and meta data. */
+    uint64_t seek_ns;
+
+    /* Time spent decoding or encoding pixels. */
+    uint64_t frames_ns;
+
+    /* Time spent finishing the loading or saving. */
+    uint64_t finish_ns;
+
+    /* Number of frames loaded or saved. */
+    uint64_t frames;
+
+    /* Number of I/O read calls and bytes read. */
+    uint64_t read_calls;
+    uint64_t bytes_read;
+
+    /* Number of I/O write calls and bytes written. */
+    uint64_t write_calls;
+    uint64_t bytes_written;
+
+    /* Number of I/O seek calls. */
+    uint64_t seek_calls;
+
+    /* Number of sail_malloc(), sail_calloc(), sail_realloc(), sail_aligned_malloc(), and
+     * sail_alloc_file_backed_memory() calls in the loading or saving thread, and the bytes they allocated.
+     * Allocations in helper threads are not counted. */
+    uint64_t allocations;
+    uint64_t allocated_bytes;
+};
+
+typedef struct sail_stats sail_stats_t;
+
+/*
+ * Adds the counters of the source stats to the target stats.
+ */
+SAIL_EXPORT void sail_add_stats(struct sail_stats *target, const struct sail_stats *source);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -61,11 +61,13 @@ enum SailStatus {
     SAIL_ERROR_UNSUPPORTED_SEEK_WHENCE,
     SAIL_ERROR_EMPTY_STRING,
     SAIL_ERROR_INVALID_VARIANT,
+    SAIL_ERROR_FILE_NOT_FOUND,
 
     /*
      * Encoding/decoding common errors.
      */
     SAIL_ERROR_INVALID_IO = 100,
+    SAIL_ERROR_NEED_MORE_DATA,
 
     /*
      * Encoding/decoding specific errors.
@@ -84,6 +86,8 @@ enum SailStatus {
     SAIL_ERROR_MISSING_PALETTE,
     SAIL_ERROR_UNSUPPORTED_FORMAT,
     SAIL_ERROR_BROKEN_IMAGE,
+    SAIL_ERROR_CANCELLED,
+    SAIL_ERROR_LIMIT_EXCEEDED,
 
     /*
      * Codecs-specific errors.
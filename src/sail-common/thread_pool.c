@@ -0,0 +1,774 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifdef __linux__
+    /* pthread_setaffinity_np() and sched_getcpu(). */
+    #define _GNU_SOURCE
+#endif
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef SAIL_WIN32
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+#ifdef __linux__
+    #include <sched.h>
+
+    /* NUMA topology is read from sysfs. */
+    #define POOL_NUMA
+#endif
+
+#include "sail-common.h"
+
+/*
+ * Private functions.
+ */
+
+#ifdef SAIL_WIN32
+    typedef SRWLOCK pool_mutex_t;
+    typedef CONDITION_VARIABLE pool_cond_t;
+    typedef HANDLE pool_thread_t;
+
+    #define POOL_MUTEX_INITIALIZER SRWLOCK_INIT
+    #define POOL_COND_INITIALIZER  CONDITION_VARIABLE_INIT
+#else
+    typedef pthread_mutex_t pool_mutex_t;
+    typedef pthread_cond_t pool_cond_t;
+    typedef pthread_t pool_thread_t;
+
+    #define POOL_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+    #define POOL_COND_INITIALIZER  PTHREAD_COND_INITIALIZER
+#endif
+
+/* NUMA nodes above the limit are not used. */
+#define POOL_MAX_NODES 16
+
+/* Node of the threads that don't belong to a node. They take tasks of any node. */
+#define POOL_ANY_NODE UINT_MAX
+
+/* Parallel stage. Lives on the stack of the thread that runs it, or on the heap when it's detached. */
+struct batch {
+
+    sail_thread_pool_task_t task;
+    void *user_data;
+    unsigned tasks_count;
+
+    /* The number of the tasks taken and finished. */
+    unsigned next_task;
+    unsigned finished_tasks;
+
+    /*
+     * Contiguous ranges of the tasks left per NUMA node. Threads take the tasks of their node from
+     * the start of its range. 0 nodes mean the tasks are taken in order by any thread.
+     */
+    unsigned nodes_count;
+    unsigned node_next_task[POOL_MAX_NODES];
+    unsigned node_end_task[POOL_MAX_NODES];
+
+    /* Nobody waits for detached batches, so they're freed when finished. */
+    bool detached;
+
+    /* Next batch with tasks to take. */
+    struct batch *next;
+};
+
+struct worker {
+
+    pool_thread_t thread;
+
+    /* Thread index passed to tasks. 0 is reserved for the threads that run parallel stages. */
+    unsigned index;
+
+    /* The worker exits when the pool generation changes. */
+    unsigned generation;
+
+    /* NUMA node the worker is bound to, or POOL_ANY_NODE. */
+    unsigned node;
+};
+
+/* Everything below is guarded by the mutex. */
+static pool_mutex_t pool_mutex     = POOL_MUTEX_INITIALIZER;
+/* Signaled when new batches are queued or the workers must exit. */
+static pool_cond_t pool_work_cond  = POOL_COND_INITIALIZER;
+/* Signaled when batches are finished. */
+static pool_cond_t pool_done_cond  = POOL_COND_INITIALIZER;
+
+static unsigned pool_size;
+static sail_thread_pool_executor_t pool_executor;
+static void *pool_executor_data;
+static sail_thread_pool_submitter_t pool_submitter;
+static void *pool_submitter_data;
+
+static struct worker *pool_workers;
+static unsigned pool_workers_count;
+static unsigned pool_generation;
+/* The number of threads stopping the workers. No workers are started until they're done. */
+static unsigned pool_stopping;
+
+static struct batch *pool_batches;
+
+/* The number of NUMA nodes the workers are spread over. 1 when NUMA-aware threads are disabled. */
+static unsigned pool_nodes_count = 1;
+
+#ifdef POOL_NUMA
+/* Processors of the NUMA nodes with processors, and the node of every processor. Loaded once. */
+static bool pool_topology_loaded;
+static unsigned pool_topology_nodes_count;
+static cpu_set_t pool_node_cpus[POOL_MAX_NODES];
+static unsigned char pool_cpu_nodes[CPU_SETSIZE];
+#endif
+
+static void lock_pool(void) {
+#ifdef SAIL_WIN32
+    AcquireSRWLockExclusive(&pool_mutex);
+#else
+    pthread_mutex_lock(&pool_mutex);
+#endif
+}
+
+static void unlock_pool(void) {
+#ifdef SAIL_WIN32
+    ReleaseSRWLockExclusive(&pool_mutex);
+#else
+    pthread_mutex_unlock(&pool_mutex);
+#endif
+}
+
+static void wait_pool(pool_cond_t *cond) {
+#ifdef SAIL_WIN32
+    SleepConditionVariableSRW(cond, &pool_mutex, INFINITE, 0);
+#else
+    pthread_cond_wait(cond, &pool_mutex);
+#endif
+}
+
+static void broadcast_pool(pool_cond_t *cond) {
+#ifdef SAIL_WIN32
+    WakeAllConditionVariable(cond);
+#else
+    pthread_cond_broadcast(cond);
+#endif
+}
+
+static unsigned processor_count(void) {
+#ifdef SAIL_WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+
+    return system_info.dwNumberOfProcessors > 0 ? (unsigned)system_info.dwNumberOfProcessors : 1;
+#else
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? (unsigned)count : 1;
+#endif
+}
+
+static unsigned effective_size_locked(void) {
+
+    return (pool_size == 0) ? processor_count() : pool_size;
+}
+
+/*
+ * Takes the next task of the node and dequeues the batch when no tasks are left. When the node has
+ * no tasks left, takes the last task of the node with the most tasks left, so its threads keep taking
+ * the tasks in order.
+ */
+static unsigned take_task_locked(struct batch *batch, unsigned node) {
+
+    unsigned task;
+
+    if (batch->nodes_count == 0) {
+        task = batch->next_task;
+    } else if (node < batch->nodes_count && batch->node_next_task[node] < batch->node_end_task[node]) {
+        task = batch->node_next_task[node]++;
+    } else {
+        unsigned most_tasks_left = 0;
+
+        for (unsigned i = 0; i < batch->nodes_count; i++) {
+            const unsigned tasks_left = batch->node_end_task[i] - batch->node_next_task[i];
+
+            if (tasks_left > most_tasks_left) {
+                most_tasks_left = tasks_left;
+                node = i;
+            }
+        }
+
+        task = --batch->node_end_task[node];
+    }
+
+    batch->next_task++;
+
+    if (batch->next_task == batch->tasks_count) {
+        for (struct batch **node = &pool_batches; *node != NULL; node = &(*node)->next) {
+            if (*node == batch) {
+                *node = batch->next;
+                break;
+            }
+        }
+    }
+
+    return task;
+}
+
+static void finish_task_locked(struct batch *batch) {
+
+    if (++batch->finished_tasks == batch->tasks_count) {
+        if (batch->detached) {
+            sail_free(batch);
+        } else {
+            broadcast_pool(&pool_done_cond);
+        }
+    }
+}
+
+/* Splits the tasks into contiguous ranges per NUMA node, so task N of stages with the same tasks count runs on the same node. */
+static void partition_batch_locked(struct batch *batch) {
+
+    if (pool_nodes_count <= 1 || batch->tasks_count <= 1) {
+        return;
+    }
+
+    batch->nodes_count = pool_nodes_count;
+
+    for (unsigned node = 0; node < pool_nodes_count; node++) {
+        batch->node_next_task[node] = (unsigned)((uint64_t)batch->tasks_count * node / pool_nodes_count);
+        batch->node_end_task[node]  = (unsigned)((uint64_t)batch->tasks_count * (node + 1) / pool_nodes_count);
+    }
+}
+
+static void enqueue_batch_locked(struct batch *batch) {
+
+    struct batch **last = &pool_batches;
+    while (*last != NULL) {
+        last = &(*last)->next;
+    }
+    *last = batch;
+
+    broadcast_pool(&pool_work_cond);
+}
+
+#ifdef POOL_NUMA
+/* Parses the next range of a sysfs list like "0-3,8,10-11". Returns false at the end of the list. */
+static bool next_list_range(const char **list, unsigned *first, unsigned *last) {
+
+    char *end;
+    const unsigned long range_first = strtoul(*list, &end, 10);
+
+    if (end == *list) {
+        return false;
+    }
+
+    unsigned long range_last = range_first;
+
+    if (*end == '-') {
+        const char *last_start = end + 1;
+        range_last = strtoul(last_start, &end, 10);
+
+        if (end == last_start || range_last < range_first) {
+            return false;
+        }
+    }
+
+    *first = (unsigned)range_first;
+    *last  = (unsigned)range_last;
+    *list  = (*end == ',') ? end + 1 : end;
+
+    return true;
+}
+
+static bool read_sysfs_list(const char *path, char *list, size_t list_size) {
+
+    FILE *file = fopen(path, "r");
+
+    if (file == NULL) {
+        return false;
+    }
+
+    const bool read = fgets(list, (int)list_size, file) != NULL;
+    fclose(file);
+
+    return read;
+}
+
+/* Loads the processors of the online NUMA nodes. Memory-only nodes are skipped. */
+static void load_topology_locked(void) {
+
+    if (pool_topology_loaded) {
+        return;
+    }
+
+    pool_topology_loaded      = true;
+    pool_topology_nodes_count = 0;
+
+    char nodes_list[256];
+
+    if (!read_sysfs_list("/sys/devices/system/node/online", nodes_list, sizeof(nodes_list))) {
+        return;
+    }
+
+    const char *nodes = nodes_list;
+    unsigned first_node;
+    unsigned last_node;
+
+    while (next_list_range(&nodes, &first_node, &last_node)) {
+        for (unsigned node = first_node; node <= last_node && pool_topology_nodes_count < POOL_MAX_NODES; node++) {
+            char path[64];
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+
+            char cpus_list[1024];
+
+            if (!read_sysfs_list(path, cpus_list, sizeof(cpus_list))) {
+                continue;
+            }
+
+            cpu_set_t *cpus = &pool_node_cpus[pool_topology_nodes_count];
+            CPU_ZERO(cpus);
+
+            const char *list = cpus_list;
+            unsigned first_cpu;
+            unsigned last_cpu;
+
+            while (next_list_range(&list, &first_cpu, &last_cpu)) {
+                for (unsigned cpu = first_cpu; cpu <= last_cpu && cpu < CPU_SETSIZE; cpu++) {
+                    CPU_SET(cpu, cpus);
+                    pool_cpu_nodes[cpu] = (unsigned char)pool_topology_nodes_count;
+                }
+            }
+
+            if (CPU_COUNT(cpus) > 0) {
+                pool_topology_nodes_count++;
+            }
+        }
+    }
+
+    SAIL_LOG_TRACE("Found %u NUMA nodes with processors", pool_topology_nodes_count);
+}
+#endif
+
+/* Returns the NUMA node of the calling thread, or POOL_ANY_NODE. */
+static unsigned current_node_locked(void) {
+
+#ifdef POOL_NUMA
+    if (pool_nodes_count > 1) {
+        const int cpu = sched_getcpu();
+
+        if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &pool_node_cpus[pool_cpu_nodes[cpu]])) {
+            return pool_cpu_nodes[cpu];
+        }
+    }
+#endif
+
+    return POOL_ANY_NODE;
+}
+
+/* Binds the calling worker to the processors of its NUMA node. The worker stays unbound on failure. */
+static void bind_worker_locked(const struct worker *worker) {
+
+#ifdef POOL_NUMA
+    if (worker->node != POOL_ANY_NODE
+            && pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &pool_node_cpus[worker->node]) != 0) {
+        SAIL_LOG_WARNING("Failed to bind a thread pool thread to NUMA node %u", worker->node);
+    }
+#else
+    (void)worker;
+#endif
+}
+
+static void worker_routine(struct worker *worker) {
+
+    lock_pool();
+
+    bind_worker_locked(worker);
+
+    for (;;) {
+        while (pool_generation == worker->generation && pool_batches == NULL) {
+            wait_pool(&pool_work_cond);
+        }
+
+        if (pool_generation != worker->generation) {
+            break;
+        }
+
+        struct batch *batch = pool_batches;
+        const unsigned task = take_task_locked(batch, worker->node);
+
+        unlock_pool();
+        batch->task(batch->user_data, task, worker->index);
+        lock_pool();
+
+        finish_task_locked(batch);
+    }
+
+    unlock_pool();
+}
+
+#ifdef SAIL_WIN32
+static DWORD WINAPI worker_thread(LPVOID arg) {
+
+    worker_routine(arg);
+
+    return 0;
+}
+#else
+static void* worker_thread(void *arg) {
+
+    worker_routine(arg);
+
+    return NULL;
+}
+#endif
+
+/* Starts the workers if they're not running. Parallel stages run in the calling thread if this fails. */
+static void start_workers_locked(void) {
+
+    if (pool_workers != NULL || pool_stopping > 0) {
+        return;
+    }
+
+    const unsigned workers_count = effective_size_locked() - 1;
+
+    if (workers_count == 0) {
+        return;
+    }
+
+    void *ptr;
+    if (sail_malloc(sizeof(struct worker) * workers_count, &ptr) != SAIL_OK) {
+        return;
+    }
+
+    pool_workers = ptr;
+
+    for (unsigned i = 0; i < workers_count; i++) {
+        struct worker *worker = &pool_workers[pool_workers_count];
+
+        worker->index      = pool_workers_count + 1;
+        worker->generation = pool_generation;
+
+        /* Spread the threads including the calling thread over the nodes evenly. */
+        worker->node = (pool_nodes_count > 1)
+                        ? (unsigned)((uint64_t)worker->index * pool_nodes_count / (workers_count + 1))
+                        : POOL_ANY_NODE;
+
+#ifdef SAIL_WIN32
+        worker->thread = CreateThread(NULL, 0, worker_thread, worker, 0, NULL);
+        const bool started = worker->thread != NULL;
+#else
+        const bool started = pthread_create(&worker->thread, NULL, worker_thread, worker) == 0;
+#endif
+
+        if (!started) {
+            SAIL_LOG_WARNING("Failed to start a thread pool thread");
+            break;
+        }
+
+        pool_workers_count++;
+    }
+
+    SAIL_LOG_TRACE("Started %u thread pool threads on %u NUMA nodes", pool_workers_count, pool_nodes_count);
+}
+
+static void stop_workers(void) {
+
+    lock_pool();
+
+    struct worker *workers = pool_workers;
+    const unsigned workers_count = pool_workers_count;
+
+    pool_workers       = NULL;
+    pool_workers_count = 0;
+    pool_generation++;
+    pool_stopping++;
+
+    broadcast_pool(&pool_work_cond);
+    unlock_pool();
+
+    for (unsigned i = 0; i < workers_count; i++) {
+#ifdef SAIL_WIN32
+        WaitForSingleObject(workers[i].thread, INFINITE);
+        CloseHandle(workers[i].thread);
+#else
+        pthread_join(workers[i].thread, NULL);
+#endif
+    }
+
+    sail_free(workers);
+
+    lock_pool();
+    pool_stopping--;
+    unlock_pool();
+}
+
+/*
+ * Public functions.
+ */
+
+void sail_set_thread_pool_size(unsigned threads) {
+
+    lock_pool();
+    pool_size = threads;
+    unlock_pool();
+
+    stop_workers();
+
+    /* Restart the workers for the queued detached tasks. */
+    lock_pool();
+    if (pool_batches != NULL) {
+        start_workers_locked();
+    }
+    unlock_pool();
+}
+
+unsigned sail_thread_pool_size(void) {
+
+    lock_pool();
+    const unsigned size = effective_size_locked();
+    unlock_pool();
+
+    return size;
+}
+
+void sail_set_thread_pool_numa(bool enabled) {
+
+    lock_pool();
+
+#ifdef POOL_NUMA
+    if (enabled) {
+        load_topology_locked();
+    }
+
+    pool_nodes_count = (enabled && pool_topology_nodes_count > 1) ? pool_topology_nodes_count : 1;
+#else
+    (void)enabled;
+#endif
+
+    unlock_pool();
+
+    /* Restart the workers bound to the nodes. */
+    stop_workers();
+
+    lock_pool();
+    if (pool_batches != NULL) {
+        start_workers_locked();
+    }
+    unlock_pool();
+}
+
+unsigned sail_thread_pool_numa_nodes(void) {
+
+    lock_pool();
+    const unsigned nodes_count = pool_nodes_count;
+    unlock_pool();
+
+    return nodes_count;
+}
+
+void sail_set_thread_pool_executor(sail_thread_pool_executor_t executor, void *executor_data) {
+
+    lock_pool();
+    pool_executor      = executor;
+    pool_executor_data = executor_data;
+    unlock_pool();
+}
+
+void sail_set_thread_pool_submitter(sail_thread_pool_submitter_t submitter, void *submitter_data) {
+
+    lock_pool();
+    pool_submitter      = submitter;
+    pool_submitter_data = submitter_data;
+    unlock_pool();
+}
+
+void sail_thread_pool_run(unsigned tasks_count, sail_thread_pool_task_t task, void *user_data) {
+
+    if (tasks_count == 0 || task == NULL) {
+        return;
+    }
+
+    lock_pool();
+
+    const sail_thread_pool_executor_t executor = pool_executor;
+    void *executor_data = pool_executor_data;
+
+    if (executor == NULL && tasks_count > 1) {
+        start_workers_locked();
+    }
+
+    const bool single_threaded = tasks_count == 1 || pool_workers_count == 0;
+
+    if (executor != NULL || single_threaded) {
+        unlock_pool();
+
+        if (executor != NULL) {
+            executor(executor_data, tasks_count, task, user_data);
+        } else {
+            for (unsigned i = 0; i < tasks_count; i++) {
+                task(user_data, i, 0);
+            }
+        }
+
+        return;
+    }
+
+    /* Queue the batch for the workers and take its tasks here as well. */
+    struct batch batch = {
+        .task           = task,
+        .user_data      = user_data,
+        .tasks_count    = tasks_count,
+        .next_task      = 0,
+        .finished_tasks = 0,
+        .detached       = false,
+        .next           = NULL,
+    };
+
+    partition_batch_locked(&batch);
+    enqueue_batch_locked(&batch);
+
+    const unsigned node = current_node_locked();
+
+    while (batch.next_task < batch.tasks_count) {
+        const unsigned current_task = take_task_locked(&batch, node);
+
+        unlock_pool();
+        task(user_data, current_task, 0);
+        lock_pool();
+
+        finish_task_locked(&batch);
+    }
+
+    while (batch.finished_tasks < batch.tasks_count) {
+        wait_pool(&pool_done_cond);
+    }
+
+    unlock_pool();
+}
+
+sail_status_t sail_thread_pool_submit(sail_thread_pool_task_t task, void *user_data) {
+
+    SAIL_CHECK_PTR(task);
+
+    lock_pool();
+
+    const sail_thread_pool_submitter_t submitter = pool_submitter;
+    void *submitter_data = pool_submitter_data;
+
+    if (submitter != NULL) {
+        unlock_pool();
+        submitter(submitter_data, task, user_data);
+        return SAIL_OK;
+    }
+
+    /* The external executor waits for its tasks, so detached tasks always go to the internal threads. */
+    start_workers_locked();
+
+    if (pool_workers_count == 0) {
+        unlock_pool();
+        task(user_data, 0, 0);
+        return SAIL_OK;
+    }
+
+    void *ptr;
+    SAIL_TRY_OR_EXECUTE(sail_malloc(sizeof(struct batch), &ptr),
+                        /* on error */ unlock_pool(); return __sail_status);
+    struct batch *batch = ptr;
+
+    *batch = (struct batch) {
+        .task           = task,
+        .user_data      = user_data,
+        .tasks_count    = 1,
+        .next_task      = 0,
+        .finished_tasks = 0,
+        .detached       = true,
+        .next           = NULL,
+    };
+
+    enqueue_batch_locked(batch);
+    unlock_pool();
+
+    return SAIL_OK;
+}
+
+struct first_touch {
+    unsigned char *buffer;
+    size_t size;
+    unsigned parts;
+};
+
+static void first_touch_task(void *user_data, unsigned task, unsigned thread) {
+
+    (void)thread;
+
+    const struct first_touch *first_touch = user_data;
+
+    const size_t part_size = first_touch->size / first_touch->parts;
+    const size_t offset    = part_size * task;
+    const size_t size      = (task + 1 == first_touch->parts) ? first_touch->size - offset : part_size;
+
+    memset(first_touch->buffer + offset, 0, size);
+}
+
+void sail_thread_pool_first_touch(void *buffer, size_t size) {
+
+    const unsigned nodes_count = sail_thread_pool_numa_nodes();
+
+    if (buffer == NULL || nodes_count <= 1 || size < nodes_count) {
+        return;
+    }
+
+    struct first_touch first_touch = {
+        .buffer = buffer,
+        .size   = size,
+        .parts  = nodes_count,
+    };
+
+    sail_thread_pool_run(nodes_count, first_touch_task, &first_touch);
+}
+
+void sail_finish_thread_pool(void) {
+
+    stop_workers();
+
+    /* Run the queued detached tasks here, so their owners are notified. */
+    lock_pool();
+
+    while (pool_batches != NULL) {
+        struct batch *batch = pool_batches;
+        const unsigned task = take_task_locked(batch, POOL_ANY_NODE);
+
+        unlock_pool();
+        batch->task(batch->user_data, task, 0);
+        lock_pool();
+
+        finish_task_locked(batch);
+    }
+
+    unlock_pool();
+}
@@ -0,0 +1,159 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_THREAD_POOL_H
+#define SAIL_THREAD_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Library-wide thread pool. Codecs and sail-manip run their parallel stages on it, so
+ * the number of threads SAIL uses never exceeds the pool size.
+ *
+ * A parallel stage is split into tasks. The calling thread runs the tasks too, and idle
+ * threads take the remaining tasks of any running stage. Threads are started on the first
+ * parallel stage and live until sail_finish_thread_pool() or a pool size change.
+ */
+
+/*
+ * Task of a parallel stage. 'task' is the task index in the range [0, tasks_count).
+ * 'thread' is the index of the thread running the task in the range [0, sail_thread_pool_size()).
+ * No two tasks of the same stage run with the same thread index at the same time.
+ */
+typedef void (*sail_thread_pool_task_t)(void *user_data, unsigned task, unsigned thread);
+
+/*
+ * External executor that replaces the internal threads. It must run the task with every
+ * index in the range [0, tasks_count) with the thread indexes described above, and return
+ * only when all the tasks are finished. It may be called from multiple threads at once.
+ */
+typedef void (*sail_thread_pool_executor_t)(void *executor_data,
+                                            unsigned tasks_count,
+                                            sail_thread_pool_task_t task,
+                                            void *user_data);
+
+/*
+ * Non-blocking hook that runs detached tasks submitted with sail_thread_pool_submit() outside
+ * the internal threads. It must schedule the task to run once with the task index 0 and the thread
+ * index 0, and return immediately without waiting for the task. It may be called from multiple
+ * threads at once.
+ */
+typedef void (*sail_thread_pool_submitter_t)(void *submitter_data,
+                                             sail_thread_pool_task_t task,
+                                             void *user_data);
+
+/*
+ * Sets the number of threads including the calling thread. 0 means the number of
+ * online processors, 1 disables multithreading. Stops the running threads. The new
+ * threads are started on the next parallel stage.
+ *
+ * Make sure no parallel stages are running.
+ */
+SAIL_EXPORT void sail_set_thread_pool_size(unsigned threads);
+
+/*
+ * Returns the number of threads parallel stages run in including the calling thread.
+ * Always returns at least 1.
+ */
+SAIL_EXPORT unsigned sail_thread_pool_size(void);
+
+/*
+ * Enables NUMA-aware threads. The internal threads are spread over the NUMA nodes evenly and bound
+ * to the processors of their nodes. The tasks of a parallel stage are split into contiguous ranges
+ * per node, so task N of stages with the same number of tasks runs on the same node. Threads take
+ * the tasks of their node first, and the tasks of other nodes when their node has no tasks left.
+ * Stops the running threads.
+ *
+ * Supported on Linux. Has no effect on systems with a single NUMA node and with the external executor.
+ * Disabled by default.
+ */
+SAIL_EXPORT void sail_set_thread_pool_numa(bool enabled);
+
+/*
+ * Returns the number of NUMA nodes the internal threads are spread over, or 1 if NUMA-aware
+ * threads are disabled or not supported.
+ */
+SAIL_EXPORT unsigned sail_thread_pool_numa_nodes(void);
+
+/*
+ * Zeroes the newly allocated buffer in a parallel stage with a task per NUMA node, so the pages of
+ * every contiguous part are first touched and allocated on its node. Parallel stages processing rows
+ * in contiguous bands of tasks then run on the nodes holding their rows. Does nothing when
+ * sail_thread_pool_numa_nodes() returns 1.
+ */
+SAIL_EXPORT void sail_thread_pool_first_touch(void *buffer, size_t size);
+
+/*
+ * Sets the external executor that runs parallel stages instead of the internal threads.
+ * sail_thread_pool_size() still limits the number of tasks parallel stages are split into.
+ * The executor blocks until its tasks finish, so it never runs detached tasks. They still run
+ * on the internal threads unless a submitter is set with sail_set_thread_pool_submitter().
+ * Pass NULL to switch back to the internal threads.
+ */
+SAIL_EXPORT void sail_set_thread_pool_executor(sail_thread_pool_executor_t executor, void *executor_data);
+
+/*
+ * Sets the submitter that runs detached tasks instead of the internal threads. Use it together
+ * with the external executor to keep SAIL from starting its own threads. Pass NULL to switch
+ * back to the internal threads.
+ */
+SAIL_EXPORT void sail_set_thread_pool_submitter(sail_thread_pool_submitter_t submitter, void *submitter_data);
+
+/*
+ * Runs the task with every index in the range [0, tasks_count) and returns when all
+ * the tasks are finished. Can be called from tasks.
+ */
+SAIL_EXPORT void sail_thread_pool_run(unsigned tasks_count, sail_thread_pool_task_t task, void *user_data);
+
+/*
+ * Queues the task to run on the internal threads with the task index 0 and returns immediately.
+ * Passes the task to the submitter instead if it's set. Runs the task in the calling thread before
+ * returning if the pool has no threads, i.e. its size is 1 or the threads failed to start.
+ *
+ * Returns SAIL_OK on success. The task is not run on error.
+ */
+SAIL_EXPORT sail_status_t sail_thread_pool_submit(sail_thread_pool_task_t task, void *user_data);
+
+/*
+ * Stops the internal threads. They are started again on the next parallel stage.
+ * The queued submitted tasks are run in the calling thread. Make sure no parallel
+ * stages are running.
+ */
+SAIL_EXPORT void sail_finish_thread_pool(void);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,69 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stddef.h>
+
+#include <sail-common/sail-common.h>
+
+static sail_trace_begin_span_t sail_trace_begin_span = NULL;
+static sail_trace_end_span_t   sail_trace_end_span   = NULL;
+static void                   *sail_trace_user_data  = NULL;
+
+void sail_set_tracer(sail_trace_begin_span_t begin_span, sail_trace_end_span_t end_span, void *user_data) {
+
+    /* Either both callbacks are set or none. */
+    if (begin_span == NULL || end_span == NULL) {
+        begin_span = NULL;
+        end_span   = NULL;
+        user_data  = NULL;
+    }
+
+    sail_trace_begin_span = begin_span;
+    sail_trace_end_span   = end_span;
+    sail_trace_user_data  = user_data;
+}
+
+bool sail_is_tracing_enabled(void) {
+
+    return sail_trace_begin_span != NULL;
+}
+
+void *sail_begin_trace_span(const char *name, const struct sail_trace_attributes *attributes) {
+
+    if (sail_trace_begin_span == NULL) {
+        return NULL;
+    }
+
+    return sail_trace_begin_span(name, attributes, sail_trace_user_data);
+}
+
+void sail_end_trace_span(void *span, const struct sail_trace_attributes *attributes, sail_status_t status) {
+
+    if (sail_trace_end_span == NULL) {
+        return;
+    }
+
+    sail_trace_end_span(span, attributes, status, sail_trace_user_data);
+}
@@ -0,0 +1,122 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_TRACE_H
+#define SAIL_TRACE_H
+
+#include <stdbool.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Attributes of a tracing span. Unknown attributes are NULL, zero or SAIL_PIXEL_FORMAT_UNKNOWN.
+ * The attributes are valid only during the tracer call.
+ */
+struct sail_trace_attributes {
+
+    /* Codec name like "PNG". */
+    const char *codec;
+
+    /* Frame dimensions. */
+    unsigned width;
+    unsigned height;
+
+    /* Frame pixel format. */
+    enum SailPixelFormat pixel_format;
+};
+
+typedef struct sail_trace_attributes sail_trace_attributes_t;
+
+/*
+ * Called when a span starts. Returns a span handle passed to the end callback. The handle may be NULL.
+ *
+ * SAIL emits these spans:
+ *   - "init_context"          - Initializing the context on the first use.
+ *   - "enumerate_codecs"      - Enumerating the built-in codecs and the codec info files.
+ *   - "parse_codec_info"      - Parsing a codec info file.
+ *   - "preload_codecs"        - Loading all the codecs with SAIL_FLAG_PRELOAD_CODECS.
+ *   - "detect_codec"          - Detecting the codec by the file extension or magic number.
+ *   - "load_codec"            - Loading the codec library.
+ *   - "open_codec_library"    - Opening the codec library with dlopen() or LoadLibraryEx().
+ *   - "resolve_codec_symbols" - Resolving the codec functions in the opened library.
+ *   - "load_init"             - Loading the codec and initializing loading.
+ *   - "load_seek_next_frame"  - Reading the frame header and meta data.
+ *   - "load_seek_frame"       - Seeking to a frame by its index.
+ *   - "load_frame"            - Decoding the frame pixels.
+ *   - "load_finish"           - Finishing loading.
+ *   - "save_init"             - Loading the codec and initializing saving.
+ *   - "save_seek_next_frame"  - Writing the frame header and meta data.
+ *   - "save_frame"            - Encoding the frame pixels.
+ *   - "save_finish"           - Finishing saving.
+ *   - "convert"               - Converting a frame to another pixel format.
+ *
+ * Spans are nested, for example, "load_codec" within "load_init", and "parse_codec_info"
+ * within "enumerate_codecs" within "init_context".
+ */
+typedef void *(*sail_trace_begin_span_t)(const char *name, const struct sail_trace_attributes *attributes, void *user_data);
+
+/*
+ * Called when a span ends. The attributes include the frame properties known by the end of the span,
+ * for example, the dimensions of the frame after "load_seek_next_frame".
+ */
+typedef void (*sail_trace_end_span_t)(void *span, const struct sail_trace_attributes *attributes, sail_status_t status, void *user_data);
+
+/*
+ * Sets tracer callbacks to emit spans around loading and saving stages into, for example,
+ * OpenTelemetry or Perfetto. Spans are emitted from the threads loading and saving images,
+ * so the callbacks must be thread-safe. Pass NULL callbacks to stop tracing.
+ *
+ * This function is not thread-safe. It's recommended to call it in the main thread
+ * before initializing SAIL.
+ */
+SAIL_EXPORT void sail_set_tracer(sail_trace_begin_span_t begin_span, sail_trace_end_span_t end_span, void *user_data);
+
+/*
+ * Returns true if a tracer is set. Use it to skip collecting span attributes when nobody traces.
+ */
+SAIL_EXPORT bool sail_is_tracing_enabled(void);
+
+/*
+ * Starts a span if a tracer is set. Returns the span handle to pass to sail_end_trace_span().
+ */
+SAIL_EXPORT void *sail_begin_trace_span(const char *name, const struct sail_trace_attributes *attributes);
+
+/*
+ * Ends the span started by sail_begin_trace_span(). Must be called only if a tracer is set.
+ */
+SAIL_EXPORT void sail_end_trace_span(void *span, const struct sail_trace_attributes *attributes, sail_status_t status);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
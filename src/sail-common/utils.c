@@ -32,6 +32,12 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+#endif
+
 #ifdef SAIL_WIN32
     #include <io.h>
     #include <share.h> /* _SH_DENYWR */
@@ -39,6 +45,7 @@
 #else
     #include <errno.h>
     #include <sys/time.h>
+    #include <time.h>
     #include <unistd.h>
 #endif
 
@@ -48,26 +55,219 @@
  * Private functions.
  */
 
+/* Classes of characters in HEX_DIGITS. Digits also keep their values in the low 4 bits. */
+#define SAIL_HEX_DIGIT 0x10
+#define SAIL_HEX_SPACE 0x20
+
+static const uint8_t HEX_DIGITS[256] = {
+    ['0'] = SAIL_HEX_DIGIT | 0x0, ['1'] = SAIL_HEX_DIGIT | 0x1, ['2'] = SAIL_HEX_DIGIT | 0x2, ['3'] = SAIL_HEX_DIGIT | 0x3,
+    ['4'] = SAIL_HEX_DIGIT | 0x4, ['5'] = SAIL_HEX_DIGIT | 0x5, ['6'] = SAIL_HEX_DIGIT | 0x6, ['7'] = SAIL_HEX_DIGIT | 0x7,
+    ['8'] = SAIL_HEX_DIGIT | 0x8, ['9'] = SAIL_HEX_DIGIT | 0x9,
+    ['A'] = SAIL_HEX_DIGIT | 0xA, ['B'] = SAIL_HEX_DIGIT | 0xB, ['C'] = SAIL_HEX_DIGIT | 0xC,
+    ['D'] = SAIL_HEX_DIGIT | 0xD, ['E'] = SAIL_HEX_DIGIT | 0xE, ['F'] = SAIL_HEX_DIGIT | 0xF,
+    ['a'] = SAIL_HEX_DIGIT | 0xA, ['b'] = SAIL_HEX_DIGIT | 0xB, ['c'] = SAIL_HEX_DIGIT | 0xC,
+    ['d'] = SAIL_HEX_DIGIT | 0xD, ['e'] = SAIL_HEX_DIGIT | 0xE, ['f'] = SAIL_HEX_DIGIT | 0xF,
+
+    [' '] = SAIL_HEX_SPACE, ['\t'] = SAIL_HEX_SPACE, ['\n'] = SAIL_HEX_SPACE,
+    ['\v'] = SAIL_HEX_SPACE, ['\f'] = SAIL_HEX_SPACE, ['\r'] = SAIL_HEX_SPACE,
+};
+
+static const char HEX_CHARS[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SAIL_HEX_SSE2
+
+/* Decodes 16 HEX digits into 8 bytes. Returns false without writing anything if any of the characters is not a digit. */
+static inline bool decode_hex_16(const unsigned char *input, unsigned char *output) {
+
+    const __m128i chars = _mm_loadu_si128((const __m128i *)input);
+    const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+
+    /* Characters above 127 are negative, so they never pass the signed comparisons. */
+    const __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+    const __m128i is_alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+    if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xFFFF) {
+        return false;
+    }
+
+    const __m128i nibbles = _mm_or_si128(_mm_and_si128(is_digit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+                                         _mm_andnot_si128(is_digit, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+
+    /* The first digit of every pair is the low byte of a 16-bit lane. */
+    const __m128i high  = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4);
+    const __m128i low   = _mm_srli_epi16(nibbles, 8);
+    const __m128i bytes = _mm_or_si128(high, low);
+
+    _mm_storel_epi64((__m128i *)output, _mm_packus_epi16(bytes, bytes));
+
+    return true;
+}
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SAIL_HEX_NEON
+
+static inline bool decode_hex_16(const unsigned char *input, unsigned char *output) {
+
+    const uint8x16_t chars = vld1q_u8(input);
+
+    const uint8x16_t digit    = vsubq_u8(chars, vdupq_n_u8('0'));
+    const uint8x16_t alpha    = vsubq_u8(vorrq_u8(chars, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    const uint8x16_t is_digit = vcltq_u8(digit, vdupq_n_u8(10));
+    const uint8x16_t is_alpha = vcltq_u8(alpha, vdupq_n_u8(6));
+
+    if (vminvq_u8(vorrq_u8(is_digit, is_alpha)) != 0xFF) {
+        return false;
+    }
+
+    const uint16x8_t nibbles = vreinterpretq_u16_u8(vbslq_u8(is_digit, digit, vaddq_u8(alpha, vdupq_n_u8(10))));
+
+    /* The first digit of every pair is the low byte of a 16-bit lane. */
+    const uint8x8_t high = vmovn_u16(nibbles);
+    const uint8x8_t low  = vshrn_n_u16(nibbles, 8);
+
+    vst1_u8(output, vorr_u8(vshl_n_u8(high, 4), low));
+
+    return true;
+}
+#endif
+
+/*
+ * Decodes pairs of HEX digits with a lookup table. Long runs of digits are decoded by 16 digits at a time.
+ * White spaces between pairs are skipped. Stops at the first character that is neither a digit nor a white space,
+ * and at an unpaired digit.
+ */
 static sail_status_t hex_string_into_data(const char *str, size_t str_length, void *data, size_t *data_saved) {
 
-    unsigned char *data_local = data;
-    *data_saved = 0;
-    unsigned byte;
-    int bytes_consumed;
+    const unsigned char *input = (const unsigned char *)str;
+    unsigned char *output = data;
+    size_t i = 0;
 
-#ifdef _MSC_VER
-    while (str_length > 1U && sscanf_s(str, "%02x%n", &byte, &bytes_consumed) == 1) {
-#else
-    while (str_length > 1U && sscanf(str, "%02x%n", &byte, &bytes_consumed) == 1) {
+    for (;;) {
+#if defined(SAIL_HEX_SSE2) || defined(SAIL_HEX_NEON)
+        for (; i + 16 <= str_length && decode_hex_16(input + i, output); i += 16) {
+            output += 8;
+        }
 #endif
-        str += bytes_consumed;
-        str_length -= bytes_consumed;
-        data_local[(*data_saved)++] = (unsigned char)byte;
+
+        /* Digits up to the next white space. */
+        while (i + 1 < str_length) {
+            const uint8_t high = HEX_DIGITS[input[i]];
+            const uint8_t low  = HEX_DIGITS[input[i + 1]];
+
+            if ((high & low & SAIL_HEX_DIGIT) == 0) {
+                break;
+            }
+
+            *output++ = (unsigned char)(((high & 0xF) << 4) | (low & 0xF));
+            i += 2;
+        }
+
+        if (i >= str_length || HEX_DIGITS[input[i]] != SAIL_HEX_SPACE) {
+            break;
+        }
+
+        /* Line breaks and other white spaces. */
+        while (i < str_length && HEX_DIGITS[input[i]] == SAIL_HEX_SPACE) {
+            i++;
+        }
     }
 
+    *data_saved = (size_t)(output - (unsigned char *)data);
+
     return SAIL_OK;
 }
 
+/*
+ * Fixed point multiplier to rescale 16-bit samples from [0; max_value] to [0; 65535]. (v * m) >> 32 equals
+ * floor(v * 65535 / max_value) exactly for every v <= max_value as the added error never reaches 1/max_value.
+ */
+struct be16_scale {
+    uint16_t max_value;
+    uint32_t high;
+    uint32_t low;
+};
+
+static inline struct be16_scale be16_scale_init(unsigned max_value) {
+
+    const uint64_t m = ((uint64_t)65535 << 32) / max_value + 1;
+
+    struct be16_scale scale = { (uint16_t)max_value, (uint32_t)(m >> 32), (uint32_t)m };
+
+    return scale;
+}
+
+static inline uint16_t be16_scale_value(uint16_t v, const struct be16_scale *scale) {
+
+    if (v > scale->max_value) {
+        v = scale->max_value;
+    }
+
+    return (uint16_t)(v * scale->high + (uint32_t)(((uint64_t)v * scale->low) >> 32));
+}
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SAIL_BE16_SSE2
+
+/* pshufb needs SSSE3, but 16-bit lanes are swapped with plain shifts just as fast. */
+static inline __m128i be16_swap_8(__m128i v) {
+
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+static inline __m128i be16_scale_high_4(__m128i v32, __m128i low) {
+
+    const __m128i even = _mm_srli_epi64(_mm_mul_epu32(v32, low), 32);
+    const __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(v32, 32), low);
+
+    return _mm_or_si128(even, _mm_and_si128(odd, _mm_set_epi32(-1, 0, -1, 0)));
+}
+
+static inline __m128i be16_scale_8(__m128i v, const struct be16_scale *scale) {
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i high = _mm_set1_epi16((short)scale->high);
+    const __m128i low  = _mm_set1_epi32((int)scale->low);
+
+    /* min(v, max) without SSE4.1. */
+    v = _mm_subs_epu16(v, _mm_subs_epu16(v, _mm_set1_epi16((short)scale->max_value)));
+
+    const __m128i product_lo = _mm_mullo_epi16(v, high);
+    const __m128i product_hi = _mm_mulhi_epu16(v, high);
+
+    const __m128i sum0 = _mm_add_epi32(_mm_unpacklo_epi16(product_lo, product_hi), be16_scale_high_4(_mm_unpacklo_epi16(v, zero), low));
+    const __m128i sum1 = _mm_add_epi32(_mm_unpackhi_epi16(product_lo, product_hi), be16_scale_high_4(_mm_unpackhi_epi16(v, zero), low));
+
+    /* Unsigned 32 to 16-bit packing without SSE4.1. The sums never exceed 65535. */
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(sum0, bias), _mm_sub_epi32(sum1, bias));
+
+    return _mm_xor_si128(packed, _mm_set1_epi16((short)0x8000));
+}
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SAIL_BE16_NEON
+
+static inline uint32x4_t be16_scale_4(uint16x4_t v, uint16x4_t high, uint32x2_t low) {
+
+    const uint32x4_t v32 = vmovl_u16(v);
+
+    const uint32x2_t high0 = vshrn_n_u64(vmull_u32(vget_low_u32(v32), low), 32);
+    const uint32x2_t high1 = vshrn_n_u64(vmull_u32(vget_high_u32(v32), low), 32);
+
+    return vaddq_u32(vmull_u16(v, high), vcombine_u32(high0, high1));
+}
+
+static inline uint16x8_t be16_scale_8(uint16x8_t v, const struct be16_scale *scale) {
+
+    const uint16x4_t high = vdup_n_u16((uint16_t)scale->high);
+    const uint32x2_t low  = vdup_n_u32(scale->low);
+
+    v = vminq_u16(v, vdupq_n_u16(scale->max_value));
+
+    return vcombine_u16(vmovn_u32(be16_scale_4(vget_low_u16(v), high, low)),
+                        vmovn_u32(be16_scale_4(vget_high_u16(v), high, low)));
+}
+#endif
+
 /*
  * Public functions.
  */
@@ -238,6 +438,102 @@ uint64_t sail_string_hash(const char *str) {
     return hash;
 }
 
+/* Primes and the structure of the XXH64 hash. */
+static const uint64_t DATA_HASH_PRIME1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t DATA_HASH_PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t DATA_HASH_PRIME3 = 0x165667B19E3779F9ULL;
+static const uint64_t DATA_HASH_PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t DATA_HASH_PRIME5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotate_left(uint64_t value, unsigned bits) {
+
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline uint64_t read_uint64(const unsigned char *bytes) {
+
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(value));
+
+    return value;
+}
+
+static inline uint64_t data_hash_round(uint64_t accumulator, uint64_t value) {
+
+    return rotate_left(accumulator + value * DATA_HASH_PRIME2, 31) * DATA_HASH_PRIME1;
+}
+
+static inline uint64_t data_hash_merge(uint64_t hash, uint64_t accumulator) {
+
+    return (hash ^ data_hash_round(0, accumulator)) * DATA_HASH_PRIME1 + DATA_HASH_PRIME4;
+}
+
+uint64_t sail_data_hash(const void *data, size_t size) {
+
+    if (data == NULL || size == 0) {
+        return 0;
+    }
+
+    const unsigned char *bytes = data;
+    const unsigned char *end = bytes + size;
+
+    uint64_t hash;
+
+    if (size >= 32) {
+        uint64_t accumulators[4] = {
+            DATA_HASH_PRIME1 + DATA_HASH_PRIME2,
+            DATA_HASH_PRIME2,
+            0,
+            0 - DATA_HASH_PRIME1
+        };
+
+        for (; end - bytes >= 32; bytes += 32) {
+            for (unsigned i = 0; i < 4; i++) {
+                accumulators[i] = data_hash_round(accumulators[i], read_uint64(bytes + i * 8));
+            }
+        }
+
+        hash = rotate_left(accumulators[0], 1) + rotate_left(accumulators[1], 7) +
+                rotate_left(accumulators[2], 12) + rotate_left(accumulators[3], 18);
+
+        for (unsigned i = 0; i < 4; i++) {
+            hash = data_hash_merge(hash, accumulators[i]);
+        }
+    } else {
+        hash = DATA_HASH_PRIME5;
+    }
+
+    hash += (uint64_t)size;
+
+    for (; end - bytes >= 8; bytes += 8) {
+        hash ^= data_hash_round(0, read_uint64(bytes));
+        hash  = rotate_left(hash, 27) * DATA_HASH_PRIME1 + DATA_HASH_PRIME4;
+    }
+
+    if (end - bytes >= 4) {
+        uint32_t value;
+        memcpy(&value, bytes, sizeof(value));
+
+        hash ^= (uint64_t)value * DATA_HASH_PRIME1;
+        hash  = rotate_left(hash, 23) * DATA_HASH_PRIME2 + DATA_HASH_PRIME3;
+        bytes += 4;
+    }
+
+    for (; bytes < end; bytes++) {
+        hash ^= (uint64_t)(*bytes) * DATA_HASH_PRIME5;
+        hash  = rotate_left(hash, 11) * DATA_HASH_PRIME1;
+    }
+
+    /* Final avalanche. */
+    hash ^= hash >> 33;
+    hash *= DATA_HASH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= DATA_HASH_PRIME3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
 unsigned sail_bits_per_pixel(enum SailPixelFormat pixel_format) {
 
     switch (pixel_format) {
@@ -336,6 +632,27 @@ unsigned sail_bits_per_pixel(enum SailPixelFormat pixel_format) {
         case SAIL_PIXEL_FORMAT_BPP40_YUVA: return 40;
         case SAIL_PIXEL_FORMAT_BPP48_YUVA: return 48;
         case SAIL_PIXEL_FORMAT_BPP64_YUVA: return 64;
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED: return 32;
+
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: return 64;
+
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420:
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12: return 12;
+        case SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444: return 24;
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:    return 48;
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:   return 64;
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT: return 128;
+
+        case SAIL_PIXEL_FORMAT_BPP4_BC1:
+        case SAIL_PIXEL_FORMAT_BPP4_BC4: return 4;
+        case SAIL_PIXEL_FORMAT_BPP8_BC2:
+        case SAIL_PIXEL_FORMAT_BPP8_BC3:
+        case SAIL_PIXEL_FORMAT_BPP8_BC5:
+        case SAIL_PIXEL_FORMAT_BPP8_BC7: return 8;
     }
 
     return 0;
@@ -451,6 +768,37 @@ bool sail_is_grayscale(enum SailPixelFormat pixel_format) {
     }
 }
 
+bool sail_is_planar(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420:
+        case SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12:
+        case SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+bool sail_is_block_compressed(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP4_BC1:
+        case SAIL_PIXEL_FORMAT_BPP8_BC2:
+        case SAIL_PIXEL_FORMAT_BPP8_BC3:
+        case SAIL_PIXEL_FORMAT_BPP4_BC4:
+        case SAIL_PIXEL_FORMAT_BPP8_BC5:
+        case SAIL_PIXEL_FORMAT_BPP8_BC7: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
 bool sail_is_rgb_family(enum SailPixelFormat pixel_format) {
 
     switch (pixel_format) {
@@ -481,7 +829,16 @@ bool sail_is_rgb_family(enum SailPixelFormat pixel_format) {
         case SAIL_PIXEL_FORMAT_BPP64_RGBA:
         case SAIL_PIXEL_FORMAT_BPP64_BGRA:
         case SAIL_PIXEL_FORMAT_BPP64_ARGB:
-        case SAIL_PIXEL_FORMAT_BPP64_ABGR: {
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR:
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED:
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT: {
             return true;
         }
         default: {
@@ -543,6 +900,43 @@ uint64_t sail_now(void) {
 #endif
 }
 
+uint64_t sail_now_ns(void) {
+
+#ifdef SAIL_WIN32
+    static SAIL_THREAD_LOCAL LONGLONG frequency = 0;
+
+    LARGE_INTEGER li;
+
+    if (frequency == 0) {
+        if (!QueryPerformanceFrequency(&li)) {
+            SAIL_LOG_ERROR("Failed to get the current time. Error: 0x%X", GetLastError());
+            return 0;
+        }
+
+        frequency = li.QuadPart;
+    }
+
+    if (!QueryPerformanceCounter(&li)) {
+        SAIL_LOG_ERROR("Failed to get the current time. Error: 0x%X", GetLastError());
+        return 0;
+    }
+
+    /* Split the conversion to not overflow. */
+    const uint64_t counter = (uint64_t)li.QuadPart;
+
+    return counter / frequency * 1000000000 + counter % frequency * 1000000000 / frequency;
+#else
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        sail_print_errno("Failed to get the current time: %s");
+        return 0;
+    }
+
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+#endif
+}
+
 bool sail_path_exists(const char *path) {
 
     if (path == NULL) {
@@ -706,6 +1100,47 @@ sail_status_t sail_file_size(const char *path, size_t *size) {
     return SAIL_OK;
 }
 
+sail_status_t sail_path_modification_time(const char *path, uint64_t *mtime) {
+
+    SAIL_CHECK_PTR(path);
+    SAIL_CHECK_PTR(mtime);
+
+#ifdef SAIL_WINDOWS_UTF8_PATHS
+    wchar_t *wpath;
+    SAIL_TRY(sail_multibyte_to_wchar(path, &wpath));
+
+    struct _stat attrs;
+
+    if (_wstat(wpath, &attrs) != 0) {
+        sail_free(wpath);
+        SAIL_LOG_ERROR("Failed to stat '%s'", path);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    sail_free(wpath);
+#else
+    #ifdef _MSC_VER
+        struct _stat attrs;
+
+        if (_stat(path, &attrs) != 0) {
+            SAIL_LOG_ERROR("Failed to stat '%s'", path);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+        }
+    #else
+        struct stat attrs;
+
+        if (stat(path, &attrs) != 0) {
+            SAIL_LOG_ERROR("Failed to stat '%s'", path);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+        }
+    #endif
+#endif
+
+    *mtime = (uint64_t)attrs.st_mtime;
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_file_contents_into_data(const char *path, void *data) {
 
     SAIL_CHECK_PTR(path);
@@ -802,20 +1237,15 @@ sail_status_t sail_data_into_hex_string(const void *data, size_t data_size, char
     SAIL_CHECK_PTR(data);
     SAIL_CHECK_PTR(str);
 
-    char *str_local_copy = str;
-
     const unsigned char *data_local = data;
-    size_t data_local_index = 0;
 
     for (size_t i = 0; i < data_size; i++) {
-#ifdef _MSC_VER
-        sprintf_s(str_local_copy, 3, "%02X", data_local[data_local_index++]);
-#else
-        snprintf(str_local_copy, 3, "%02X", data_local[data_local_index++]);
-#endif
-        str_local_copy += 2;
+        str[i * 2]     = HEX_CHARS[data_local[i] >> 4];
+        str[i * 2 + 1] = HEX_CHARS[data_local[i] & 0xF];
     }
 
+    str[data_size * 2] = '\0';
+
     return SAIL_OK;
 }
 
@@ -885,6 +1315,44 @@ uint64_t sail_reverse_uint64(uint64_t v)
 #endif
 }
 
+void sail_be16_to_host(const void *input, void *output, size_t count, unsigned max_value) {
+
+    const uint8_t *in = input;
+    uint16_t *out = output;
+    size_t i = 0;
+
+    const bool rescale = max_value > 0 && max_value < 65535;
+    const struct be16_scale scale = rescale ? be16_scale_init(max_value) : (struct be16_scale) { 0, 0, 0 };
+
+#if SAIL_LITTLE_ENDIAN && defined(SAIL_BE16_SSE2)
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = be16_swap_8(_mm_loadu_si128((const __m128i *)(in + i * 2)));
+
+        if (rescale) {
+            v = be16_scale_8(v, &scale);
+        }
+
+        _mm_storeu_si128((__m128i *)(out + i), v);
+    }
+#elif SAIL_LITTLE_ENDIAN && defined(SAIL_BE16_NEON)
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t v = vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(in + i * 2)));
+
+        if (rescale) {
+            v = be16_scale_8(v, &scale);
+        }
+
+        vst1q_u16(out + i, v);
+    }
+#endif
+
+    for (; i < count; i++) {
+        const uint16_t v = (uint16_t)((in[i * 2] << 8) | in[i * 2 + 1]);
+
+        out[i] = rescale ? be16_scale_value(v, &scale) : v;
+    }
+}
+
 #ifdef SAIL_WINDOWS_UTF8_PATHS
 sail_status_t sail_multibyte_to_wchar(const char *str, wchar_t **wstr) {
 
@@ -93,6 +93,15 @@ SAIL_EXPORT sail_status_t sail_to_wchar(const char *input, wchar_t **output);
  */
 SAIL_EXPORT uint64_t sail_string_hash(const char *str);
 
+/*
+ * Computes a fast non-cryptographic 64-bit hash of the specified data. The data is processed
+ * in 8-byte words with the XXH64 algorithm, so the hash is independent of the data alignment,
+ * but depends on the CPU endianness.
+ *
+ * Returns 0 if the data is NULL or empty.
+ */
+SAIL_EXPORT uint64_t sail_data_hash(const void *data, size_t size);
+
 /*
  * Returns the number of bits per pixel of the specified pixel format.
  * For example, for SAIL_PIXEL_FORMAT_RGB 24 is returned. Returns 0 on unknown pixel format.
@@ -148,6 +157,18 @@ SAIL_EXPORT bool sail_is_indexed(enum SailPixelFormat pixel_format);
  */
 SAIL_EXPORT bool sail_is_grayscale(enum SailPixelFormat pixel_format);
 
+/*
+ * Returns true if the given pixel format stores its channels in separate planes, like
+ * SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420. See sail_image_planes().
+ */
+SAIL_EXPORT bool sail_is_planar(enum SailPixelFormat pixel_format);
+
+/*
+ * Returns true if the given pixel format stores 4x4 blocks of pixels rather than rows,
+ * like SAIL_PIXEL_FORMAT_BPP4_BC1.
+ */
+SAIL_EXPORT bool sail_is_block_compressed(enum SailPixelFormat pixel_format);
+
 /*
  * Returns true if the given pixel format is a kind of RGB, packed or not. E.g. RGBA, BGRA, RGB555 etc.
  */
@@ -163,6 +184,12 @@ SAIL_EXPORT void sail_print_errno(const char *format);
  */
 SAIL_EXPORT uint64_t sail_now(void);
 
+/*
+ * Returns the current number of nanoseconds of a monotonic clock or 0 on error.
+ * Only differences of the returned values are meaningful.
+ */
+SAIL_EXPORT uint64_t sail_now_ns(void);
+
 /*
  * Returns true if the specified file system path exists.
  */
@@ -185,6 +212,14 @@ SAIL_EXPORT bool sail_is_file(const char *path);
  */
 SAIL_EXPORT sail_status_t sail_file_size(const char *path, size_t *size);
 
+/*
+ * Retrieves the last modification time of the specified file or directory
+ * in seconds since the Epoch.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_path_modification_time(const char *path, uint64_t *mtime);
+
 /*
  * Reads the specified file into the memory buffer. The buffer must be large enough.
  *
@@ -255,6 +290,14 @@ SAIL_EXPORT uint32_t sail_reverse_uint32(uint32_t v);
  */
 SAIL_EXPORT uint64_t sail_reverse_uint64(uint64_t v);
 
+/*
+ * Converts the specified number of big-endian 16-bit samples into the host byte order. 16-bit samples
+ * in SAIL images are always in the host byte order. If max_value is between 1 and 65534, rescales the samples
+ * from [0; max_value] to the full [0; 65535] range. Samples greater than max_value are clamped. The input and
+ * the output buffers may be the same buffer.
+ */
+SAIL_EXPORT void sail_be16_to_host(const void *input, void *output, size_t count, unsigned max_value);
+
 /*
  * Converts a character string to a UTF-16 string. Available on Windows only.
  *
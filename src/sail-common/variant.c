@@ -30,13 +30,41 @@
 /*
  * Private functions.
  */
-static sail_status_t set_variant_value(struct sail_variant *variant, enum SailVariantType type, const void *value, const size_t size) {
+static inline bool variant_value_is_allocated(const struct sail_variant *variant) {
+
+    return variant->value != NULL && variant->value != variant->inline_value.bytes;
+}
+
+/* Copies the value of the specified size into the variant storage of possibly greater size. */
+static sail_status_t set_variant_value_of_size(struct sail_variant *variant, enum SailVariantType type,
+                                               const void *value, size_t value_size, size_t size) {
 
     SAIL_CHECK_PTR(variant);
 
-    void **ptr = &variant->value;
-    SAIL_TRY(sail_realloc(size, ptr));
-    memcpy(variant->value, value, size);
+    if (size <= SAIL_VARIANT_INLINE_SIZE) {
+        /* Small values are stored inline, and the source may be the inline storage itself. */
+        if (variant_value_is_allocated(variant)) {
+            memcpy(variant->inline_value.bytes, value, value_size);
+            sail_free(variant->value);
+        } else {
+            memmove(variant->inline_value.bytes, value, value_size);
+        }
+
+        variant->value = variant->inline_value.bytes;
+    } else {
+        void *ptr;
+
+        if (variant_value_is_allocated(variant)) {
+            ptr = variant->value;
+            SAIL_TRY(sail_realloc(size, &ptr));
+        } else {
+            SAIL_TRY(sail_private_arena_malloc(size, &ptr));
+        }
+
+        memcpy(ptr, value, value_size);
+
+        variant->value = ptr;
+    }
 
     variant->type = type;
     variant->size = size;
@@ -44,6 +72,13 @@ static sail_status_t set_variant_value(struct sail_variant *variant, enum SailVa
     return SAIL_OK;
 }
 
+static sail_status_t set_variant_value(struct sail_variant *variant, enum SailVariantType type, const void *value, size_t size) {
+
+    SAIL_TRY(set_variant_value_of_size(variant, type, value, size, size));
+
+    return SAIL_OK;
+}
+
 static sail_status_t alloc_variant(enum SailVariantType type, const void *value, const size_t size, struct sail_variant **variant) {
 
     SAIL_CHECK_PTR(variant);
@@ -67,7 +102,7 @@ sail_status_t sail_alloc_variant(struct sail_variant **variant) {
     SAIL_CHECK_PTR(variant);
 
     void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct sail_variant), &ptr));
+    SAIL_TRY(sail_private_arena_malloc(sizeof(struct sail_variant), &ptr));
     *variant = ptr;
 
     (*variant)->type  = SAIL_VARIANT_TYPE_INVALID;
@@ -83,7 +118,9 @@ void sail_destroy_variant(struct sail_variant *variant) {
         return;
     }
 
-    sail_free(variant->value);
+    if (variant_value_is_allocated(variant)) {
+        sail_free(variant->value);
+    }
     sail_free(variant);
 }
 
@@ -175,7 +212,9 @@ sail_status_t sail_set_variant_shallow_string(struct sail_variant *variant, char
 
     SAIL_CHECK_PTR(variant);
 
-    sail_free(variant->value);
+    if (variant_value_is_allocated(variant)) {
+        sail_free(variant->value);
+    }
 
     variant->type  = SAIL_VARIANT_TYPE_STRING;
     variant->value = value;
@@ -186,7 +225,7 @@ sail_status_t sail_set_variant_shallow_string(struct sail_variant *variant, char
 
 sail_status_t sail_set_variant_substring(struct sail_variant *variant, const char *value, size_t size) {
 
-    SAIL_TRY(set_variant_value(variant, SAIL_VARIANT_TYPE_STRING, value, size + 1));
+    SAIL_TRY(set_variant_value_of_size(variant, SAIL_VARIANT_TYPE_STRING, value, size, size + 1));
 
     char *str = variant->value;
     str[size] = '\0';
@@ -205,7 +244,9 @@ sail_status_t sail_set_variant_shallow_data(struct sail_variant *variant, void *
 
     SAIL_CHECK_PTR(variant);
 
-    sail_free(variant->value);
+    if (variant_value_is_allocated(variant)) {
+        sail_free(variant->value);
+    }
 
     variant->type  = SAIL_VARIANT_TYPE_DATA;
     variant->value = value;
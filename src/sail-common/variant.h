@@ -28,6 +28,7 @@
 
 #include <stdbool.h>
 #include <stddef.h> /* size_t */
+#include <stdint.h>
 #include <stdio.h> /* FILE */
 
 #include <sail-common/common.h>
@@ -38,6 +39,9 @@
 extern "C" {
 #endif
 
+/* Maximum size of values stored in variants without allocations. */
+#define SAIL_VARIANT_INLINE_SIZE 16
+
 /*
  * Type of variant data.
  */
@@ -75,9 +79,21 @@ struct sail_variant {
     void *value;
 
     /*
-     * The size of the allocated memory for the value. For strings, it's strlen() + 1.
+     * The size of the value. For strings, it's strlen() + 1.
      */
     size_t size;
+
+    /*
+     * Storage of values up to SAIL_VARIANT_INLINE_SIZE bytes, like scalars and short strings,
+     * so they don't need allocations. The value points to it when it's used. Must not be accessed
+     * directly.
+     */
+    union {
+        uint64_t u;
+        double d;
+        void *p;
+        unsigned char bytes[SAIL_VARIANT_INLINE_SIZE];
+    } inline_value;
 };
 
 /*
@@ -0,0 +1,577 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* Analyze images with at least this number of pixels in multiple threads. Also the number of pixels in a chunk. */
+static const size_t PARALLEL_PIXELS_THRESHOLD = 65536;
+
+/* Number of hash slots of a color set. Twice the maximum number of colors. */
+#define COLOR_SLOTS (SAIL_ANALYSIS_MAX_COLORS * 2)
+
+/* Positions of components in pixels of the pixel formats analyzed as is. */
+struct pixel_layout {
+    unsigned bytes_per_component;
+    /* Number of components in a pixel including padding. */
+    unsigned components;
+    unsigned r, g, b;
+    /* Equals to 'components' if there is no alpha. */
+    unsigned a;
+};
+
+/* Distinct colors as R, G, B, and A 16-bit values packed from the most significant bits. */
+struct color_set {
+    uint64_t colors[SAIL_ANALYSIS_MAX_COLORS];
+    /* Indexes of colors plus one. Zero marks empty slots. */
+    uint16_t slots[COLOR_SLOTS];
+    unsigned count;
+    /* More than SAIL_ANALYSIS_MAX_COLORS colors were inserted. */
+    bool overflow;
+};
+
+/* Analysis of a chunk of rows. */
+struct partial_analysis {
+    bool opaque;
+    bool grayscale;
+    bool fits_8_bits;
+    uint16_t min[4];
+    uint16_t max[4];
+    struct color_set color_set;
+};
+
+static bool pixel_layout(enum SailPixelFormat pixel_format, struct pixel_layout *layout) {
+
+    static const struct pixel_layout GRAY8     = { 1, 1, 0, 0, 0, 1 };
+    static const struct pixel_layout GRAY16    = { 2, 1, 0, 0, 0, 1 };
+    static const struct pixel_layout GRAY8A    = { 1, 2, 0, 0, 0, 1 };
+    static const struct pixel_layout GRAY16A   = { 2, 2, 0, 0, 0, 1 };
+    static const struct pixel_layout RGB24     = { 1, 3, 0, 1, 2, 3 };
+    static const struct pixel_layout BGR24     = { 1, 3, 2, 1, 0, 3 };
+    static const struct pixel_layout RGB48     = { 2, 3, 0, 1, 2, 3 };
+    static const struct pixel_layout BGR48     = { 2, 3, 2, 1, 0, 3 };
+    static const struct pixel_layout RGBX32    = { 1, 4, 0, 1, 2, 4 };
+    static const struct pixel_layout BGRX32    = { 1, 4, 2, 1, 0, 4 };
+    static const struct pixel_layout XRGB32    = { 1, 4, 1, 2, 3, 4 };
+    static const struct pixel_layout XBGR32    = { 1, 4, 3, 2, 1, 4 };
+    static const struct pixel_layout RGBA32    = { 1, 4, 0, 1, 2, 3 };
+    static const struct pixel_layout BGRA32    = { 1, 4, 2, 1, 0, 3 };
+    static const struct pixel_layout ARGB32    = { 1, 4, 1, 2, 3, 0 };
+    static const struct pixel_layout ABGR32    = { 1, 4, 3, 2, 1, 0 };
+    static const struct pixel_layout RGBX64    = { 2, 4, 0, 1, 2, 4 };
+    static const struct pixel_layout BGRX64    = { 2, 4, 2, 1, 0, 4 };
+    static const struct pixel_layout XRGB64    = { 2, 4, 1, 2, 3, 4 };
+    static const struct pixel_layout XBGR64    = { 2, 4, 3, 2, 1, 4 };
+    static const struct pixel_layout RGBA64    = { 2, 4, 0, 1, 2, 3 };
+    static const struct pixel_layout BGRA64    = { 2, 4, 2, 1, 0, 3 };
+    static const struct pixel_layout ARGB64    = { 2, 4, 1, 2, 3, 0 };
+    static const struct pixel_layout ABGR64    = { 2, 4, 3, 2, 1, 0 };
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:        *layout = GRAY8;   return true;
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE:       *layout = GRAY16;  return true;
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA: *layout = GRAY8A;  return true;
+        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: *layout = GRAY16A; return true;
+
+        case SAIL_PIXEL_FORMAT_BPP24_RGB: *layout = RGB24; return true;
+        case SAIL_PIXEL_FORMAT_BPP24_BGR: *layout = BGR24; return true;
+        case SAIL_PIXEL_FORMAT_BPP48_RGB: *layout = RGB48; return true;
+        case SAIL_PIXEL_FORMAT_BPP48_BGR: *layout = BGR48; return true;
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX: *layout = RGBX32; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX: *layout = BGRX32; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB: *layout = XRGB32; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR: *layout = XBGR32; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: *layout = RGBA32; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: *layout = BGRA32; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB: *layout = ARGB32; return true;
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: *layout = ABGR32; return true;
+
+        case SAIL_PIXEL_FORMAT_BPP64_RGBX: *layout = RGBX64; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_BGRX: *layout = BGRX64; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_XRGB: *layout = XRGB64; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_XBGR: *layout = XBGR64; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA: *layout = RGBA64; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA: *layout = BGRA64; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB: *layout = ARGB64; return true;
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR: *layout = ABGR64; return true;
+
+        default: return false;
+    }
+}
+
+static inline uint64_t color_key(unsigned r, unsigned g, unsigned b, unsigned a) {
+
+    return ((uint64_t)r << 48) | ((uint64_t)g << 32) | ((uint64_t)b << 16) | a;
+}
+
+static inline unsigned color_slot(uint64_t key) {
+
+    return (unsigned)((key * 0x9E3779B97F4A7C15ULL) >> 55) & (COLOR_SLOTS - 1);
+}
+
+static void init_color_set(struct color_set *color_set) {
+
+    memset(color_set->slots, 0, sizeof(color_set->slots));
+    color_set->count    = 0;
+    color_set->overflow = false;
+}
+
+/* Returns the index of the color in the set, or -1. */
+static int find_color(const struct color_set *color_set, uint64_t key) {
+
+    for (unsigned slot = color_slot(key); color_set->slots[slot] != 0; slot = (slot + 1) & (COLOR_SLOTS - 1)) {
+        if (color_set->colors[color_set->slots[slot] - 1] == key) {
+            return color_set->slots[slot] - 1;
+        }
+    }
+
+    return -1;
+}
+
+static void insert_color(struct color_set *color_set, uint64_t key) {
+
+    if (color_set->overflow) {
+        return;
+    }
+
+    unsigned slot = color_slot(key);
+
+    for (; color_set->slots[slot] != 0; slot = (slot + 1) & (COLOR_SLOTS - 1)) {
+        if (color_set->colors[color_set->slots[slot] - 1] == key) {
+            return;
+        }
+    }
+
+    if (color_set->count == SAIL_ANALYSIS_MAX_COLORS) {
+        color_set->overflow = true;
+        return;
+    }
+
+    color_set->colors[color_set->count] = key;
+    color_set->slots[slot] = (uint16_t)(++color_set->count);
+}
+
+/*
+ * Analyzes pixels of the specified component type. The last inserted color is cached,
+ * as neighbor pixels often have the same color.
+ */
+#define ANALYZE_ROWS(name, type, max_value, fits_8_bits_check)                                                         \
+static void name(const struct sail_image *image, const struct pixel_layout *layout,                                  \
+                 unsigned first_row, unsigned rows, struct partial_analysis *partial) {                              \
+                                                                                                                     \
+    bool opaque      = true;                                                                                         \
+    bool grayscale   = true;                                                                                         \
+    bool fits_8_bits = true;                                                                                         \
+    unsigned min[4]  = { max_value, max_value, max_value, max_value };                                               \
+    unsigned max[4]  = { 0, 0, 0, 0 };                                                                               \
+    bool has_last    = false;                                                                                        \
+    uint64_t last    = 0;                                                                                            \
+                                                                                                                     \
+    for (unsigned row = first_row; row < first_row + rows; row++) {                                                  \
+        const type *scan = sail_scan_line(image, row);                                                               \
+                                                                                                                     \
+        for (unsigned column = 0; column < image->width; column++, scan += layout->components) {                     \
+            const unsigned r = scan[layout->r];                                                                      \
+            const unsigned g = scan[layout->g];                                                                      \
+            const unsigned b = scan[layout->b];                                                                      \
+            const unsigned a = (layout->a < layout->components) ? scan[layout->a] : (max_value);                     \
+                                                                                                                     \
+            opaque      = opaque && a == (max_value);                                                                \
+            grayscale   = grayscale && r == g && g == b;                                                             \
+            fits_8_bits = fits_8_bits && fits_8_bits_check(r) && fits_8_bits_check(g)                                \
+                                      && fits_8_bits_check(b) && fits_8_bits_check(a);                               \
+                                                                                                                     \
+            min[0] = (r < min[0]) ? r : min[0]; max[0] = (r > max[0]) ? r : max[0];                                  \
+            min[1] = (g < min[1]) ? g : min[1]; max[1] = (g > max[1]) ? g : max[1];                                  \
+            min[2] = (b < min[2]) ? b : min[2]; max[2] = (b > max[2]) ? b : max[2];                                  \
+            min[3] = (a < min[3]) ? a : min[3]; max[3] = (a > max[3]) ? a : max[3];                                  \
+                                                                                                                     \
+            const uint64_t key = color_key(r, g, b, a);                                                              \
+                                                                                                                     \
+            if (!has_last || key != last) {                                                                          \
+                insert_color(&partial->color_set, key);                                                              \
+                has_last = true;                                                                                     \
+                last     = key;                                                                                      \
+            }                                                                                                        \
+        }                                                                                                            \
+    }                                                                                                                \
+                                                                                                                     \
+    partial->opaque      = opaque;                                                                                   \
+    partial->grayscale   = grayscale;                                                                                \
+    partial->fits_8_bits = fits_8_bits;                                                                              \
+                                                                                                                     \
+    for (unsigned c = 0; c < 4; c++) {                                                                               \
+        partial->min[c] = (uint16_t)min[c];                                                                          \
+        partial->max[c] = (uint16_t)max[c];                                                                          \
+    }                                                                                                                \
+}
+
+#define FITS_8_BITS_UINT8(v)  true
+#define FITS_8_BITS_UINT16(v) (((v) >> 8) == ((v) & 0xFF))
+
+ANALYZE_ROWS(analyze_rows_uint8,  uint8_t,  255,   FITS_8_BITS_UINT8)
+ANALYZE_ROWS(analyze_rows_uint16, uint16_t, 65535, FITS_8_BITS_UINT16)
+
+static int compare_color_keys(const void *a, const void *b) {
+
+    const uint64_t x = *(const uint64_t *)a;
+    const uint64_t y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static sail_status_t analyze_layout(const struct sail_image *image, const struct pixel_layout *layout, struct sail_image_analysis *analysis) {
+
+    const bool parallel = (size_t)image->width * image->height >= PARALLEL_PIXELS_THRESHOLD;
+    const unsigned rows_per_chunk = parallel
+                                        ? (unsigned)((PARALLEL_PIXELS_THRESHOLD + image->width - 1) / image->width)
+                                        : image->height;
+    const unsigned chunks = (image->height + rows_per_chunk - 1) / rows_per_chunk;
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct partial_analysis) * chunks, &ptr));
+    struct partial_analysis *partials = ptr;
+
+    unsigned chunk;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) if (parallel) num_threads(sail_thread_pool_size())
+    for (chunk = 0; chunk < chunks; chunk++) {
+        const unsigned first_row = chunk * rows_per_chunk;
+        const unsigned rows      = (image->height - first_row < rows_per_chunk) ? image->height - first_row : rows_per_chunk;
+
+        init_color_set(&partials[chunk].color_set);
+
+        if (layout->bytes_per_component == 1) {
+            analyze_rows_uint8(image, layout, first_row, rows, &partials[chunk]);
+        } else {
+            analyze_rows_uint16(image, layout, first_row, rows, &partials[chunk]);
+        }
+    }
+
+    /* Merge the chunks. */
+    struct color_set *color_set = &partials[0].color_set;
+
+    analysis->bits_per_component = layout->bytes_per_component * 8;
+    analysis->opaque             = partials[0].opaque;
+    analysis->grayscale          = partials[0].grayscale;
+    analysis->fits_8_bits        = partials[0].fits_8_bits;
+
+    uint16_t min[4], max[4];
+    memcpy(min, partials[0].min, sizeof(min));
+    memcpy(max, partials[0].max, sizeof(max));
+
+    for (unsigned i = 1; i < chunks; i++) {
+        analysis->opaque      = analysis->opaque && partials[i].opaque;
+        analysis->grayscale   = analysis->grayscale && partials[i].grayscale;
+        analysis->fits_8_bits = analysis->fits_8_bits && partials[i].fits_8_bits;
+
+        for (unsigned c = 0; c < 4; c++) {
+            min[c] = (partials[i].min[c] < min[c]) ? partials[i].min[c] : min[c];
+            max[c] = (partials[i].max[c] > max[c]) ? partials[i].max[c] : max[c];
+        }
+
+        if (partials[i].color_set.overflow) {
+            color_set->overflow = true;
+        }
+
+        for (unsigned j = 0; j < partials[i].color_set.count && !color_set->overflow; j++) {
+            insert_color(color_set, partials[i].color_set.colors[j]);
+        }
+    }
+
+    analysis->min.component1 = min[0]; analysis->min.component2 = min[1];
+    analysis->min.component3 = min[2]; analysis->min.component4 = min[3];
+    analysis->max.component1 = max[0]; analysis->max.component2 = max[1];
+    analysis->max.component3 = max[2]; analysis->max.component4 = max[3];
+
+    if (color_set->overflow) {
+        analysis->colors_count = SAIL_ANALYSIS_MAX_COLORS + 1;
+    } else {
+        analysis->colors_count = color_set->count;
+
+        qsort(color_set->colors, color_set->count, sizeof(uint64_t), compare_color_keys);
+
+        for (unsigned i = 0; i < color_set->count; i++) {
+            const uint64_t key = color_set->colors[i];
+
+            analysis->colors[i].component1 = (uint16_t)(key >> 48);
+            analysis->colors[i].component2 = (uint16_t)(key >> 32);
+            analysis->colors[i].component3 = (uint16_t)(key >> 16);
+            analysis->colors[i].component4 = (uint16_t)key;
+        }
+    }
+
+    sail_free(partials);
+
+    return SAIL_OK;
+}
+
+/* Returns true if the pixels fit into the pixel format without losing data. */
+static bool fits_pixel_format(const struct sail_image_analysis *analysis, enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP1_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP2_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP4_INDEXED:
+        case SAIL_PIXEL_FORMAT_BPP8_INDEXED: {
+            /* Indexed images get BPP24-RGB palettes that most codecs support. */
+            return analysis->opaque && analysis->fits_8_bits
+                    && analysis->colors_count <= (1U << sail_bits_per_pixel(pixel_format));
+        }
+
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:        return analysis->grayscale && analysis->opaque && analysis->fits_8_bits;
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE:       return analysis->grayscale && analysis->opaque;
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA: return analysis->grayscale && analysis->fits_8_bits;
+        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: return analysis->grayscale;
+
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:
+        case SAIL_PIXEL_FORMAT_BPP24_BGR: return analysis->opaque && analysis->fits_8_bits;
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB:
+        case SAIL_PIXEL_FORMAT_BPP48_BGR: return analysis->opaque;
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA:
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: return analysis->fits_8_bits;
+
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA:
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR: return true;
+
+        default: return false;
+    }
+}
+
+static bool has_pixel_format(const struct sail_save_features *save_features, enum SailPixelFormat pixel_format) {
+
+    for (unsigned i = 0; i < save_features->pixel_formats_length; i++) {
+        if (save_features->pixel_formats[i] == pixel_format) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+enum SailPixelFormat lossless_pixel_format_for_saving(enum SailPixelFormat input_pixel_format,
+                                                      const struct sail_image_analysis *analysis,
+                                                      const struct sail_save_features *save_features) {
+
+    /* Ordered by the number of bits per pixel. */
+    static const enum SailPixelFormat CANDIDATES[] = {
+        SAIL_PIXEL_FORMAT_BPP1_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP2_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP4_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP8_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA,
+        SAIL_PIXEL_FORMAT_BPP24_RGB,
+        SAIL_PIXEL_FORMAT_BPP24_BGR,
+        SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA,
+        SAIL_PIXEL_FORMAT_BPP32_RGBA,
+        SAIL_PIXEL_FORMAT_BPP32_BGRA,
+        SAIL_PIXEL_FORMAT_BPP32_ARGB,
+        SAIL_PIXEL_FORMAT_BPP32_ABGR,
+        SAIL_PIXEL_FORMAT_BPP48_RGB,
+        SAIL_PIXEL_FORMAT_BPP48_BGR,
+        SAIL_PIXEL_FORMAT_BPP64_RGBA,
+        SAIL_PIXEL_FORMAT_BPP64_BGRA,
+        SAIL_PIXEL_FORMAT_BPP64_ARGB,
+        SAIL_PIXEL_FORMAT_BPP64_ABGR,
+    };
+
+    struct pixel_layout layout;
+
+    if (!pixel_layout(input_pixel_format, &layout)) {
+        return SAIL_PIXEL_FORMAT_UNKNOWN;
+    }
+
+    for (size_t i = 0; i < sizeof(CANDIDATES) / sizeof(CANDIDATES[0]); i++) {
+        const enum SailPixelFormat candidate = CANDIDATES[i];
+
+        if (!has_pixel_format(save_features, candidate) || !fits_pixel_format(analysis, candidate)) {
+            continue;
+        }
+
+        if (!sail_is_indexed(candidate) && candidate != input_pixel_format && !sail_can_convert(input_pixel_format, candidate)) {
+            continue;
+        }
+
+        /* Don't convert into another pixel format of the same size. */
+        if (has_pixel_format(save_features, input_pixel_format)
+                && sail_bits_per_pixel(input_pixel_format) <= sail_bits_per_pixel(candidate)) {
+            return input_pixel_format;
+        }
+
+        return candidate;
+    }
+
+    return SAIL_PIXEL_FORMAT_UNKNOWN;
+}
+
+sail_status_t palettize_image(const struct sail_image *image,
+                              const struct sail_image_analysis *analysis,
+                              enum SailPixelFormat pixel_format,
+                              struct sail_image **image_output) {
+
+    struct pixel_layout layout;
+
+    if (!pixel_layout(image->pixel_format, &layout) || !fits_pixel_format(analysis, pixel_format)) {
+        SAIL_LOG_ERROR("Cannot palettize %s image into %s", sail_pixel_format_to_string(image->pixel_format),
+                        sail_pixel_format_to_string(pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct color_set), &ptr));
+    struct color_set *color_set = ptr;
+
+    init_color_set(color_set);
+
+    /* Colors with 16-bit components fit into 8 bits, so they are narrowed by dropping the duplicated byte. */
+    const unsigned shift = analysis->bits_per_component - 8;
+
+    struct sail_image *image_local;
+    SAIL_TRY_OR_CLEANUP(sail_copy_image_skeleton(image, &image_local),
+                        /* cleanup */ sail_free(color_set));
+
+    sail_destroy_palette(image_local->palette);
+    image_local->palette = NULL;
+
+    image_local->pixel_format   = pixel_format;
+    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, analysis->colors_count, &image_local->palette),
+                        /* cleanup */ sail_destroy_image(image_local),
+                                      sail_free(color_set));
+
+    uint8_t *palette = image_local->palette->data;
+
+    for (unsigned i = 0; i < analysis->colors_count; i++) {
+        const sail_rgba64_t *color = &analysis->colors[i];
+
+        insert_color(color_set, color_key(color->component1, color->component2, color->component3, color->component4));
+
+        palette[i * 3 + 0] = (uint8_t)(color->component1 >> shift);
+        palette[i * 3 + 1] = (uint8_t)(color->component2 >> shift);
+        palette[i * 3 + 2] = (uint8_t)(color->component3 >> shift);
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_image_pixels(image_local, image->pixels_file_backed_size > 0),
+                        /* cleanup */ sail_destroy_image(image_local),
+                                      sail_free(color_set));
+
+    const unsigned bits_per_index = sail_bits_per_pixel(pixel_format);
+    const unsigned max_value      = (layout.bytes_per_component == 1) ? 255 : 65535;
+    const unsigned indexes[4]     = { layout.r, layout.g, layout.b, layout.a };
+    const bool parallel = (size_t)image->width * image->height >= PARALLEL_PIXELS_THRESHOLD;
+
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) if (parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image->height; row++) {
+        const uint8_t *scan8   = sail_scan_line(image, row);
+        const uint16_t *scan16 = (const uint16_t *)scan8;
+        uint8_t *output        = sail_scan_line(image_local, row);
+
+        memset(output, 0, image_local->bytes_per_line);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const size_t offset = (size_t)column * layout.components;
+            unsigned c[4];
+
+            for (unsigned i = 0; i < 4; i++) {
+                if (indexes[i] >= layout.components) {
+                    c[i] = max_value;
+                } else {
+                    c[i] = (layout.bytes_per_component == 1) ? scan8[offset + indexes[i]] : scan16[offset + indexes[i]];
+                }
+            }
+
+            /* Every color is in the set. */
+            const unsigned color_index = (unsigned)find_color(color_set, color_key(c[0], c[1], c[2], c[3]));
+            const unsigned bit         = column * bits_per_index;
+
+            output[bit / 8] |= (uint8_t)(color_index << (8 - bits_per_index - bit % 8));
+        }
+    }
+
+    sail_free(color_set);
+
+    *image_output = image_local;
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_analyze_image(const struct sail_image *image, struct sail_image_analysis *analysis) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(analysis);
+
+    struct pixel_layout layout;
+
+    if (pixel_layout(image->pixel_format, &layout)) {
+        SAIL_TRY(analyze_layout(image, &layout, analysis));
+        return SAIL_OK;
+    }
+
+    const enum SailPixelFormat pixel_format = (sail_bits_per_pixel(image->pixel_format) > 32)
+                                                ? SAIL_PIXEL_FORMAT_BPP64_RGBA
+                                                : SAIL_PIXEL_FORMAT_BPP32_RGBA;
+
+    if (!sail_can_convert(image->pixel_format, pixel_format)) {
+        SAIL_LOG_ERROR("Cannot analyze %s image", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    struct sail_image *image_rgba;
+    SAIL_TRY(sail_convert_image(image, pixel_format, &image_rgba));
+
+    pixel_layout(pixel_format, &layout);
+
+    SAIL_TRY_OR_CLEANUP(analyze_layout(image_rgba, &layout, analysis),
+                        /* cleanup */ sail_destroy_image(image_rgba));
+
+    sail_destroy_image(image_rgba);
+
+    return SAIL_OK;
+}
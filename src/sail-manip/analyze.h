@@ -0,0 +1,102 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ANALYZE_H
+#define SAIL_ANALYZE_H
+
+#include <stdbool.h>
+
+#include <sail-common/export.h>
+#include <sail-common/pixel.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_image;
+
+/* Maximum number of distinct colors collected by sail_analyze_image(). */
+#define SAIL_ANALYSIS_MAX_COLORS 256
+
+/*
+ * Content of image pixels.
+ */
+struct sail_image_analysis {
+
+    /* Number of bits per component of the analyzed values: 8 or 16. */
+    unsigned bits_per_component;
+
+    /* All alpha values are at maximum. True for pixel formats without alpha. */
+    bool opaque;
+
+    /* All pixels have equal R, G, and B components. */
+    bool grayscale;
+
+    /*
+     * All 16-bit components are 8-bit values multiplied by 257, so narrowing them to 8 bits is lossless.
+     * Always true for 8-bit components.
+     */
+    bool fits_8_bits;
+
+    /* Number of distinct colors, or SAIL_ANALYSIS_MAX_COLORS + 1 if there are more. */
+    unsigned colors_count;
+
+    /*
+     * Distinct RGBA colors sorted in ascending order when colors_count <= SAIL_ANALYSIS_MAX_COLORS.
+     * Components have bits_per_component bits. Alpha is at maximum for pixel formats without alpha.
+     */
+    sail_rgba64_t colors[SAIL_ANALYSIS_MAX_COLORS];
+
+    /* Minimum and maximum values of R, G, B, and A components with bits_per_component bits. */
+    sail_rgba64_t min;
+    sail_rgba64_t max;
+};
+
+typedef struct sail_image_analysis sail_image_analysis_t;
+
+/*
+ * Analyzes the image pixels in a single pass: whether the image is opaque or grayscale, its distinct
+ * colors up to SAIL_ANALYSIS_MAX_COLORS, and the range of every component. Useful to find a smaller
+ * pixel format to save the image into without losing data. See SAIL_CONVERSION_OPTION_DOWNGRADE.
+ *
+ * Grayscale, RGB, and RGBA pixel formats with 8 or 16 bits per component, including
+ * the formats with padding like SAIL_PIXEL_FORMAT_BPP32_RGBX, are analyzed as is.
+ * Other pixel formats are converted to SAIL_PIXEL_FORMAT_BPP32_RGBA first, or to
+ * SAIL_PIXEL_FORMAT_BPP64_RGBA if they have more than 32 bits per pixel.
+ *
+ * Large images are analyzed in multiple threads with OpenMP.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT if the pixel format is not supported.
+ */
+SAIL_EXPORT sail_status_t sail_analyze_image(const struct sail_image *image, struct sail_image_analysis *analysis);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,828 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+#include "bcn.h"
+
+/*
+ * Private functions.
+ */
+
+/* Compress and decompress images with at least this number of pixels in multiple threads. */
+static const size_t PARALLEL_PIXELS_THRESHOLD = 65536;
+
+/* Weights of the second endpoint in BC7 4-bit index palettes, out of 64. */
+static const unsigned BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+typedef void (*block_decoder_t)(const uint8_t *block, uint8_t rgba[64]);
+typedef void (*block_encoder_t)(const uint8_t rgba[64], uint8_t *block);
+
+static inline unsigned clamp_component(float value) {
+
+    return (value <= 0) ? 0 : ((value >= 255) ? 255 : (unsigned)(value + 0.5f));
+}
+
+static inline unsigned read_le16(const uint8_t *data) {
+
+    return (unsigned)data[0] | ((unsigned)data[1] << 8);
+}
+
+static inline void write_le16(uint8_t *data, unsigned value) {
+
+    data[0] = (uint8_t)(value & 0xFF);
+    data[1] = (uint8_t)(value >> 8);
+}
+
+static inline unsigned squared_distance(const uint8_t *a, const uint8_t *b, unsigned channels) {
+
+    unsigned distance = 0;
+
+    for (unsigned i = 0; i < channels; i++) {
+        const int d = (int)a[i] - (int)b[i];
+        distance += (unsigned)(d * d);
+    }
+
+    return distance;
+}
+
+/*
+ * Color blocks of BC1, BC2, and BC3.
+ */
+
+static inline unsigned pack_rgb565(const unsigned rgb[3]) {
+
+    return ((rgb[0] * 31 + 127) / 255) << 11 | ((rgb[1] * 63 + 127) / 255) << 5 | ((rgb[2] * 31 + 127) / 255);
+}
+
+static inline void unpack_rgb565(unsigned color, uint8_t rgb[3]) {
+
+    const unsigned r = (color >> 11) & 0x1F;
+    const unsigned g = (color >> 5) & 0x3F;
+    const unsigned b = color & 0x1F;
+
+    rgb[0] = (uint8_t)((r << 3) | (r >> 2));
+    rgb[1] = (uint8_t)((g << 2) | (g >> 4));
+    rgb[2] = (uint8_t)((b << 3) | (b >> 2));
+}
+
+/*
+ * Builds the RGBA palette of a color block. Four-color blocks interpolate two colors,
+ * three-color blocks interpolate one color and have transparent black as the last entry.
+ */
+static void color_palette(unsigned color0, unsigned color1, bool four_colors, uint8_t palette[4][4]) {
+
+    unpack_rgb565(color0, palette[0]);
+    unpack_rgb565(color1, palette[1]);
+
+    for (unsigned i = 0; i < 3; i++) {
+        const unsigned c0 = palette[0][i];
+        const unsigned c1 = palette[1][i];
+
+        if (four_colors) {
+            palette[2][i] = (uint8_t)((2 * c0 + c1 + 1) / 3);
+            palette[3][i] = (uint8_t)((c0 + 2 * c1 + 1) / 3);
+        } else {
+            palette[2][i] = (uint8_t)((c0 + c1 + 1) / 2);
+            palette[3][i] = 0;
+        }
+    }
+
+    palette[0][3] = palette[1][3] = palette[2][3] = 255;
+    palette[3][3] = four_colors ? 255 : 0;
+}
+
+static void decode_color_block(const uint8_t *block, bool bc1, uint8_t rgba[64]) {
+
+    const unsigned color0 = read_le16(block);
+    const unsigned color1 = read_le16(block + 2);
+
+    /* Only BC1 has three-color blocks. */
+    uint8_t palette[4][4];
+    color_palette(color0, color1, !bc1 || color0 > color1, palette);
+
+    for (unsigned i = 0; i < 16; i++) {
+        const unsigned index = (block[4 + i / 4] >> ((i % 4) * 2)) & 3;
+
+        memcpy(rgba + i * 4, palette[index], bc1 ? 4 : 3);
+    }
+}
+
+/*
+ * Computes the endpoints of the line that fits the pixels best along their principal axis.
+ * Pixels marked to skip don't participate. Only the first 'channels' components are used.
+ */
+static void principal_endpoints(const uint8_t rgba[64], const bool skip[16], unsigned channels, float endpoint0[4], float endpoint1[4]) {
+
+    float mean[4] = { 0, 0, 0, 0 };
+    unsigned count = 0;
+
+    for (unsigned i = 0; i < 16; i++) {
+        if (skip == NULL || !skip[i]) {
+            for (unsigned c = 0; c < channels; c++) {
+                mean[c] += rgba[i * 4 + c];
+            }
+            count++;
+        }
+    }
+
+    for (unsigned c = 0; c < channels; c++) {
+        mean[c] /= (float)count;
+    }
+
+    float covariance[4][4] = { { 0 } };
+
+    for (unsigned i = 0; i < 16; i++) {
+        if (skip == NULL || !skip[i]) {
+            for (unsigned c1 = 0; c1 < channels; c1++) {
+                for (unsigned c2 = 0; c2 < channels; c2++) {
+                    covariance[c1][c2] += ((float)rgba[i * 4 + c1] - mean[c1]) * ((float)rgba[i * 4 + c2] - mean[c2]);
+                }
+            }
+        }
+    }
+
+    /* Start from the row of the most varying channel, it's never orthogonal to the principal axis. */
+    unsigned start = 0;
+
+    for (unsigned c = 1; c < channels; c++) {
+        if (covariance[c][c] > covariance[start][start]) {
+            start = c;
+        }
+    }
+
+    float axis[4] = { 0, 0, 0, 0 };
+    memcpy(axis, covariance[start], sizeof(float) * channels);
+
+    /* Power iterations. */
+    for (unsigned iteration = 0; iteration < 8; iteration++) {
+        float next[4] = { 0, 0, 0, 0 };
+        float length = 0;
+
+        for (unsigned c1 = 0; c1 < channels; c1++) {
+            for (unsigned c2 = 0; c2 < channels; c2++) {
+                next[c1] += covariance[c1][c2] * axis[c2];
+            }
+            length += next[c1] * next[c1];
+        }
+
+        if (length < 1e-6f) {
+            break;
+        }
+
+        length = sqrtf(length);
+
+        for (unsigned c = 0; c < channels; c++) {
+            axis[c] = next[c] / length;
+        }
+    }
+
+    float min_projection = 0;
+    float max_projection = 0;
+
+    for (unsigned i = 0; i < 16; i++) {
+        if (skip == NULL || !skip[i]) {
+            float projection = 0;
+
+            for (unsigned c = 0; c < channels; c++) {
+                projection += ((float)rgba[i * 4 + c] - mean[c]) * axis[c];
+            }
+
+            if (projection < min_projection) {
+                min_projection = projection;
+            }
+            if (projection > max_projection) {
+                max_projection = projection;
+            }
+        }
+    }
+
+    for (unsigned c = 0; c < channels; c++) {
+        endpoint0[c] = mean[c] + axis[c] * max_projection;
+        endpoint1[c] = mean[c] + axis[c] * min_projection;
+    }
+}
+
+/*
+ * Refines the endpoints with least squares for the selected indices. 'weights' are the fractions
+ * of the second endpoint in the palette entries. Returns false if the system is degenerate.
+ */
+static bool refine_endpoints(const uint8_t rgba[64], const bool skip[16], unsigned channels,
+                             const uint8_t indices[16], const float *weights, float endpoint0[4], float endpoint1[4]) {
+
+    float aa = 0, ab = 0, bb = 0;
+    float ap[4] = { 0, 0, 0, 0 };
+    float bp[4] = { 0, 0, 0, 0 };
+
+    for (unsigned i = 0; i < 16; i++) {
+        if (skip != NULL && skip[i]) {
+            continue;
+        }
+
+        const float b = weights[indices[i]];
+        const float a = 1 - b;
+
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+
+        for (unsigned c = 0; c < channels; c++) {
+            ap[c] += a * rgba[i * 4 + c];
+            bp[c] += b * rgba[i * 4 + c];
+        }
+    }
+
+    const float determinant = aa * bb - ab * ab;
+
+    if (fabsf(determinant) < 1e-6f) {
+        return false;
+    }
+
+    for (unsigned c = 0; c < channels; c++) {
+        endpoint0[c] = (ap[c] * bb - bp[c] * ab) / determinant;
+        endpoint1[c] = (bp[c] * aa - ap[c] * ab) / determinant;
+    }
+
+    return true;
+}
+
+/*
+ * Encodes the color block with the specified endpoints and returns the total error.
+ * Transparent pixels are encoded with the transparent entry of a three-color block.
+ */
+static unsigned try_color_endpoints(const uint8_t rgba[64], const bool transparent[16], bool four_colors,
+                                    const float endpoint0[4], const float endpoint1[4],
+                                    uint8_t block[8], uint8_t indices[16]) {
+
+    const unsigned rgb0[3] = { clamp_component(endpoint0[0]), clamp_component(endpoint0[1]), clamp_component(endpoint0[2]) };
+    const unsigned rgb1[3] = { clamp_component(endpoint1[0]), clamp_component(endpoint1[1]), clamp_component(endpoint1[2]) };
+
+    unsigned color0 = pack_rgb565(rgb0);
+    unsigned color1 = pack_rgb565(rgb1);
+
+    /* The order of the colors selects between four-color and three-color blocks. */
+    if ((four_colors && color0 < color1) || (!four_colors && color0 > color1)) {
+        const unsigned color = color0;
+        color0 = color1;
+        color1 = color;
+    }
+
+    /* Equal colors make a three-color block in BC1, and its first entries are the same color. */
+    const bool palette_four_colors = four_colors && color0 > color1;
+
+    uint8_t palette[4][4];
+    color_palette(color0, color1, palette_four_colors, palette);
+
+    const unsigned colors = palette_four_colors ? 4 : 3;
+    unsigned error = 0;
+    uint32_t packed_indices = 0;
+
+    for (unsigned i = 0; i < 16; i++) {
+        unsigned best_index = 3;
+
+        if (!transparent[i]) {
+            unsigned best_distance = UINT32_MAX;
+
+            for (unsigned index = 0; index < colors; index++) {
+                const unsigned distance = squared_distance(rgba + i * 4, palette[index], 3);
+
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best_index = index;
+                }
+            }
+
+            error += best_distance;
+        }
+
+        indices[i] = (uint8_t)best_index;
+        packed_indices |= (uint32_t)best_index << (i * 2);
+    }
+
+    write_le16(block, color0);
+    write_le16(block + 2, color1);
+
+    for (unsigned i = 0; i < 4; i++) {
+        block[4 + i] = (uint8_t)(packed_indices >> (i * 8));
+    }
+
+    return error;
+}
+
+static void encode_color_block(const uint8_t rgba[64], bool bc1, uint8_t block[8]) {
+
+    static const float FOUR_COLORS_WEIGHTS[4]  = { 0.0f, 1.0f, 1.0f / 3, 2.0f / 3 };
+    static const float THREE_COLORS_WEIGHTS[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+    /* BC1 encodes pixels with alpha below 50% as transparent. */
+    bool transparent[16];
+    unsigned transparent_count = 0;
+
+    for (unsigned i = 0; i < 16; i++) {
+        transparent[i] = bc1 && rgba[i * 4 + 3] < 128;
+        transparent_count += transparent[i] ? 1 : 0;
+    }
+
+    if (transparent_count == 16) {
+        memset(block, 0, 4);
+        memset(block + 4, 0xFF, 4);
+        return;
+    }
+
+    const bool four_colors = transparent_count == 0;
+
+    float endpoint0[4];
+    float endpoint1[4];
+    principal_endpoints(rgba, transparent, 3, endpoint0, endpoint1);
+
+    uint8_t indices[16];
+    unsigned best_error = try_color_endpoints(rgba, transparent, four_colors, endpoint0, endpoint1, block, indices);
+
+    for (unsigned iteration = 0; iteration < 2 && best_error > 0; iteration++) {
+        const unsigned color0 = read_le16(block);
+        const unsigned color1 = read_le16(block + 2);
+        const float *weights = (!bc1 || color0 > color1) ? FOUR_COLORS_WEIGHTS : THREE_COLORS_WEIGHTS;
+
+        if (!refine_endpoints(rgba, transparent, 3, indices, weights, endpoint0, endpoint1)) {
+            break;
+        }
+
+        uint8_t refined_block[8];
+        uint8_t refined_indices[16];
+        const unsigned error = try_color_endpoints(rgba, transparent, four_colors, endpoint0, endpoint1, refined_block, refined_indices);
+
+        if (error >= best_error) {
+            break;
+        }
+
+        best_error = error;
+        memcpy(block, refined_block, sizeof(refined_block));
+        memcpy(indices, refined_indices, sizeof(refined_indices));
+    }
+}
+
+/*
+ * Single channel blocks of BC3 alpha, BC4, and BC5.
+ */
+
+static void single_channel_palette(unsigned value0, unsigned value1, uint8_t palette[8]) {
+
+    palette[0] = (uint8_t)value0;
+    palette[1] = (uint8_t)value1;
+
+    if (value0 > value1) {
+        for (unsigned k = 1; k <= 6; k++) {
+            palette[k + 1] = (uint8_t)(((7 - k) * value0 + k * value1 + 3) / 7);
+        }
+    } else {
+        for (unsigned k = 1; k <= 4; k++) {
+            palette[k + 1] = (uint8_t)(((5 - k) * value0 + k * value1 + 2) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+static void decode_single_channel_block(const uint8_t *block, uint8_t *values, unsigned step) {
+
+    uint8_t palette[8];
+    single_channel_palette(block[0], block[1], palette);
+
+    uint64_t packed_indices = 0;
+
+    for (unsigned i = 0; i < 6; i++) {
+        packed_indices |= (uint64_t)block[2 + i] << (i * 8);
+    }
+
+    for (unsigned i = 0; i < 16; i++) {
+        values[i * step] = palette[(packed_indices >> (i * 3)) & 7];
+    }
+}
+
+/* Selects the indices of the values in the palette, packs them, and returns the total error. */
+static unsigned pick_single_channel_indices(const uint8_t values[16], const uint8_t palette[8], uint64_t *packed_indices) {
+
+    unsigned error = 0;
+    *packed_indices = 0;
+
+    for (unsigned i = 0; i < 16; i++) {
+        unsigned best_index = 0;
+        unsigned best_distance = UINT32_MAX;
+
+        for (unsigned index = 0; index < 8; index++) {
+            const int d = (int)values[i] - (int)palette[index];
+            const unsigned distance = (unsigned)(d * d);
+
+            if (distance < best_distance) {
+                best_distance = distance;
+                best_index = index;
+            }
+        }
+
+        error += best_distance;
+        *packed_indices |= (uint64_t)best_index << (i * 3);
+    }
+
+    return error;
+}
+
+/*
+ * Encodes the values with an eight-value palette between the extremes, or with a six-value
+ * palette and exact 0 and 255 when it's closer.
+ */
+static void encode_single_channel_block(const uint8_t *values, unsigned step, uint8_t block[8]) {
+
+    uint8_t block_values[16];
+    unsigned min = 255, max = 0;
+    unsigned inner_min = 255, inner_max = 0;
+
+    for (unsigned i = 0; i < 16; i++) {
+        const unsigned value = values[i * step];
+        block_values[i] = (uint8_t)value;
+
+        min = (value < min) ? value : min;
+        max = (value > max) ? value : max;
+
+        if (value > 0 && value < 255) {
+            inner_min = (value < inner_min) ? value : inner_min;
+            inner_max = (value > inner_max) ? value : inner_max;
+        }
+    }
+
+    uint8_t palette[8];
+    uint64_t packed_indices;
+
+    single_channel_palette(max, min, palette);
+    unsigned best_error = pick_single_channel_indices(block_values, palette, &packed_indices);
+    unsigned value0 = max, value1 = min;
+
+    if (best_error > 0 && inner_min <= inner_max && (min == 0 || max == 255)) {
+        uint64_t inner_packed_indices;
+
+        single_channel_palette(inner_min, inner_max, palette);
+        const unsigned error = pick_single_channel_indices(block_values, palette, &inner_packed_indices);
+
+        if (error < best_error) {
+            value0 = inner_min;
+            value1 = inner_max;
+            packed_indices = inner_packed_indices;
+        }
+    }
+
+    block[0] = (uint8_t)value0;
+    block[1] = (uint8_t)value1;
+
+    for (unsigned i = 0; i < 6; i++) {
+        block[2 + i] = (uint8_t)(packed_indices >> (i * 8));
+    }
+}
+
+/*
+ * BC7 blocks.
+ */
+
+static void write_bits(uint8_t block[16], unsigned *offset, unsigned value, unsigned count) {
+
+    for (unsigned i = 0; i < count; i++, (*offset)++) {
+        if (value & (1u << i)) {
+            block[*offset / 8] |= (uint8_t)(1u << (*offset % 8));
+        }
+    }
+}
+
+/* Quantizes the endpoint to 7 bits per channel with the P-bit that gives the smallest error. */
+static void quantize_bc7_endpoint(const float endpoint[4], unsigned quantized[4], unsigned *pbit, uint8_t restored[4]) {
+
+    unsigned best_error = UINT32_MAX;
+
+    for (unsigned p = 0; p < 2; p++) {
+        unsigned candidate[4];
+        unsigned error = 0;
+
+        for (unsigned c = 0; c < 4; c++) {
+            const unsigned value = clamp_component(endpoint[c]);
+            unsigned q = (value < p) ? 0 : (value - p + 1) / 2;
+            q = (q > 127) ? 127 : q;
+
+            const int d = (int)value - (int)((q << 1) | p);
+            error += (unsigned)(d * d);
+            candidate[c] = q;
+        }
+
+        if (error < best_error) {
+            best_error = error;
+            *pbit = p;
+            memcpy(quantized, candidate, sizeof(candidate));
+        }
+    }
+
+    for (unsigned c = 0; c < 4; c++) {
+        restored[c] = (uint8_t)((quantized[c] << 1) | *pbit);
+    }
+}
+
+/* Encodes the BC7 mode 6 block with the specified endpoints and returns the total error. */
+static unsigned try_bc7_endpoints(const uint8_t rgba[64], const float endpoint0[4], const float endpoint1[4],
+                                  uint8_t block[16], uint8_t indices[16]) {
+
+    unsigned quantized[2][4];
+    unsigned pbits[2];
+    uint8_t restored[2][4];
+
+    quantize_bc7_endpoint(endpoint0, quantized[0], &pbits[0], restored[0]);
+    quantize_bc7_endpoint(endpoint1, quantized[1], &pbits[1], restored[1]);
+
+    uint8_t palette[16][4];
+
+    for (unsigned index = 0; index < 16; index++) {
+        for (unsigned c = 0; c < 4; c++) {
+            palette[index][c] = (uint8_t)(((64 - BC7_WEIGHTS4[index]) * restored[0][c] + BC7_WEIGHTS4[index] * restored[1][c] + 32) >> 6);
+        }
+    }
+
+    unsigned error = 0;
+
+    for (unsigned i = 0; i < 16; i++) {
+        unsigned best_index = 0;
+        unsigned best_distance = UINT32_MAX;
+
+        for (unsigned index = 0; index < 16; index++) {
+            const unsigned distance = squared_distance(rgba + i * 4, palette[index], 4);
+
+            if (distance < best_distance) {
+                best_distance = distance;
+                best_index = index;
+            }
+        }
+
+        error += best_distance;
+        indices[i] = (uint8_t)best_index;
+    }
+
+    /* The most significant bit of the first index is implicitly 0. */
+    const bool swap = indices[0] >= 8;
+    const unsigned first = swap ? 1 : 0;
+
+    memset(block, 0, 16);
+    unsigned offset = 0;
+
+    write_bits(block, &offset, 1u << 6, 7);
+
+    for (unsigned c = 0; c < 4; c++) {
+        write_bits(block, &offset, quantized[first][c], 7);
+        write_bits(block, &offset, quantized[1 - first][c], 7);
+    }
+
+    write_bits(block, &offset, pbits[first], 1);
+    write_bits(block, &offset, pbits[1 - first], 1);
+
+    for (unsigned i = 0; i < 16; i++) {
+        const unsigned index = swap ? 15 - indices[i] : indices[i];
+        write_bits(block, &offset, index, (i == 0) ? 3 : 4);
+    }
+
+    return error;
+}
+
+/*
+ * Block decoders and encoders.
+ */
+
+static void decode_bc1_block(const uint8_t *block, uint8_t rgba[64]) {
+
+    decode_color_block(block, true /* BC1 */, rgba);
+}
+
+static void decode_bc2_block(const uint8_t *block, uint8_t rgba[64]) {
+
+    decode_color_block(block + 8, false /* BC1 */, rgba);
+
+    for (unsigned i = 0; i < 16; i++) {
+        rgba[i * 4 + 3] = (uint8_t)(((block[i / 2] >> ((i % 2) * 4)) & 0xF) * 17);
+    }
+}
+
+static void decode_bc3_block(const uint8_t *block, uint8_t rgba[64]) {
+
+    decode_color_block(block + 8, false /* BC1 */, rgba);
+    decode_single_channel_block(block, rgba + 3, 4);
+}
+
+static void decode_bc4_block(const uint8_t *block, uint8_t rgba[64]) {
+
+    decode_single_channel_block(block, rgba, 4);
+
+    for (unsigned i = 0; i < 16; i++) {
+        rgba[i * 4 + 1] = rgba[i * 4 + 2] = rgba[i * 4];
+        rgba[i * 4 + 3] = 255;
+    }
+}
+
+static void decode_bc5_block(const uint8_t *block, uint8_t rgba[64]) {
+
+    decode_single_channel_block(block, rgba, 4);
+    decode_single_channel_block(block + 8, rgba + 1, 4);
+
+    for (unsigned i = 0; i < 16; i++) {
+        rgba[i * 4 + 2] = 0;
+        rgba[i * 4 + 3] = 255;
+    }
+}
+
+static void encode_bc1_block(const uint8_t rgba[64], uint8_t *block) {
+
+    encode_color_block(rgba, true /* BC1 */, block);
+}
+
+static void encode_bc2_block(const uint8_t rgba[64], uint8_t *block) {
+
+    for (unsigned i = 0; i < 8; i++) {
+        const unsigned alpha0 = (rgba[i * 8 + 3] * 15 + 127) / 255;
+        const unsigned alpha1 = (rgba[i * 8 + 7] * 15 + 127) / 255;
+
+        block[i] = (uint8_t)(alpha0 | (alpha1 << 4));
+    }
+
+    encode_color_block(rgba, false /* BC1 */, block + 8);
+}
+
+static void encode_bc3_block(const uint8_t rgba[64], uint8_t *block) {
+
+    encode_single_channel_block(rgba + 3, 4, block);
+    encode_color_block(rgba, false /* BC1 */, block + 8);
+}
+
+static void encode_bc4_block(const uint8_t rgba[64], uint8_t *block) {
+
+    encode_single_channel_block(rgba, 4, block);
+}
+
+static void encode_bc5_block(const uint8_t rgba[64], uint8_t *block) {
+
+    encode_single_channel_block(rgba, 4, block);
+    encode_single_channel_block(rgba + 1, 4, block + 8);
+}
+
+static void encode_bc7_block(const uint8_t rgba[64], uint8_t *block) {
+
+    float endpoint0[4];
+    float endpoint1[4];
+    principal_endpoints(rgba, NULL, 4, endpoint0, endpoint1);
+
+    uint8_t indices[16];
+    unsigned best_error = try_bc7_endpoints(rgba, endpoint0, endpoint1, block, indices);
+
+    float weights[16];
+
+    for (unsigned index = 0; index < 16; index++) {
+        weights[index] = (float)BC7_WEIGHTS4[index] / 64;
+    }
+
+    if (best_error > 0 && refine_endpoints(rgba, NULL, 4, indices, weights, endpoint0, endpoint1)) {
+        uint8_t refined_block[16];
+        uint8_t refined_indices[16];
+
+        if (try_bc7_endpoints(rgba, endpoint0, endpoint1, refined_block, refined_indices) < best_error) {
+            memcpy(block, refined_block, sizeof(refined_block));
+        }
+    }
+}
+
+static block_decoder_t block_decoder(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP4_BC1: return decode_bc1_block;
+        case SAIL_PIXEL_FORMAT_BPP8_BC2: return decode_bc2_block;
+        case SAIL_PIXEL_FORMAT_BPP8_BC3: return decode_bc3_block;
+        case SAIL_PIXEL_FORMAT_BPP4_BC4: return decode_bc4_block;
+        case SAIL_PIXEL_FORMAT_BPP8_BC5: return decode_bc5_block;
+
+        default: return NULL;
+    }
+}
+
+static block_encoder_t block_encoder(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP4_BC1: return encode_bc1_block;
+        case SAIL_PIXEL_FORMAT_BPP8_BC2: return encode_bc2_block;
+        case SAIL_PIXEL_FORMAT_BPP8_BC3: return encode_bc3_block;
+        case SAIL_PIXEL_FORMAT_BPP4_BC4: return encode_bc4_block;
+        case SAIL_PIXEL_FORMAT_BPP8_BC5: return encode_bc5_block;
+        case SAIL_PIXEL_FORMAT_BPP8_BC7: return encode_bc7_block;
+
+        default: return NULL;
+    }
+}
+
+/* Returns the number of bytes in a compressed 4x4 block. */
+static inline unsigned block_size(enum SailPixelFormat pixel_format) {
+
+    return sail_bits_per_pixel(pixel_format) * 2;
+}
+
+/*
+ * Public functions.
+ */
+
+bool bcn_can_decode(enum SailPixelFormat pixel_format) {
+
+    return block_decoder(pixel_format) != NULL;
+}
+
+sail_status_t bcn_to_rgba32(const struct sail_image *image, struct sail_image *image_output) {
+
+    const block_decoder_t decoder = block_decoder(image->pixel_format);
+
+    if (decoder == NULL) {
+        SAIL_LOG_ERROR("Decoding %s blocks is not supported", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    const unsigned size = block_size(image->pixel_format);
+    const unsigned blocks_x = image->width / 4;
+    const unsigned blocks_y = image->height / 4;
+    const bool parallel = (size_t)image->width * image->height >= PARALLEL_PIXELS_THRESHOLD;
+
+    unsigned block_y;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) if (parallel) num_threads(sail_thread_pool_size())
+    for (block_y = 0; block_y < blocks_y; block_y++) {
+        const uint8_t *block = sail_scan_line(image, block_y * 4);
+
+        for (unsigned block_x = 0; block_x < blocks_x; block_x++, block += size) {
+            uint8_t rgba[64];
+            decoder(block, rgba);
+
+            for (unsigned y = 0; y < 4; y++) {
+                uint8_t *scan = (uint8_t *)sail_scan_line(image_output, block_y * 4 + y) + (size_t)block_x * 16;
+                memcpy(scan, rgba + y * 16, 16);
+            }
+        }
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t rgba32_to_bcn(const struct sail_image *image, struct sail_image *image_output) {
+
+    const block_encoder_t encoder = block_encoder(image_output->pixel_format);
+
+    if (encoder == NULL) {
+        SAIL_LOG_ERROR("Encoding %s blocks is not supported", sail_pixel_format_to_string(image_output->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    const unsigned size = block_size(image_output->pixel_format);
+    const unsigned blocks_x = image->width / 4;
+    const unsigned blocks_y = image->height / 4;
+    const bool parallel = (size_t)image->width * image->height >= PARALLEL_PIXELS_THRESHOLD;
+
+    unsigned block_y;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) if (parallel) num_threads(sail_thread_pool_size())
+    for (block_y = 0; block_y < blocks_y; block_y++) {
+        uint8_t *block = sail_scan_line(image_output, block_y * 4);
+
+        for (unsigned block_x = 0; block_x < blocks_x; block_x++, block += size) {
+            uint8_t rgba[64];
+
+            for (unsigned y = 0; y < 4; y++) {
+                const uint8_t *scan = (const uint8_t *)sail_scan_line(image, block_y * 4 + y) + (size_t)block_x * 16;
+                memcpy(rgba + y * 16, scan, 16);
+            }
+
+            encoder(rgba, block);
+        }
+    }
+
+    return SAIL_OK;
+}
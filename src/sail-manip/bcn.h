@@ -0,0 +1,56 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_BCN_H
+#define SAIL_BCN_H
+
+#include <stdbool.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_image;
+
+/*
+ * Returns true if blocks of the specified block-compressed pixel format can be decoded.
+ * BC7 blocks are only encoded.
+ */
+SAIL_HIDDEN bool bcn_can_decode(enum SailPixelFormat pixel_format);
+
+/*
+ * Decodes the block-compressed image into the allocated BPP32-RGBA image of the same size.
+ * BC4 is decoded into gray pixels, and BC5 into red and green with zero blue.
+ */
+SAIL_HIDDEN sail_status_t bcn_to_rgba32(const struct sail_image *image, struct sail_image *image_output);
+
+/*
+ * Encodes the BPP32-RGBA image into the allocated block-compressed image of the same size.
+ * BC4 takes the red channel, and BC5 takes the red and green channels. BC7 blocks
+ * are always encoded in mode 6.
+ */
+SAIL_HIDDEN sail_status_t rgba32_to_bcn(const struct sail_image *image, struct sail_image *image_output);
+
+#endif
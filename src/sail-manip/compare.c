@@ -0,0 +1,401 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* Compare images with at least this number of pixels in multiple threads. */
+static const size_t PARALLEL_PIXELS_THRESHOLD = 65536;
+
+/* SSIM window size and step. */
+#define SSIM_WINDOW 8
+#define SSIM_STEP   4
+
+#ifndef M_PI
+    #define M_PI 3.14159265358979323846
+#endif
+
+/* Returns the number of 8-bit components of pixel formats compared as is, or 0. */
+static unsigned psnr_components(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: return 1;
+
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:
+        case SAIL_PIXEL_FORMAT_BPP24_BGR: return 3;
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA:
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR: return 4;
+
+        default: return 0;
+    }
+}
+
+static sail_status_t check_same_dimensions(const struct sail_image *image1, const struct sail_image *image2) {
+
+    if (image1->width != image2->width || image1->height != image2->height) {
+        SAIL_LOG_ERROR("Cannot compare images of different dimensions %ux%u and %ux%u",
+                        image1->width, image1->height, image2->width, image2->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    return SAIL_OK;
+}
+
+/* Converts the image to grayscale unless it's already grayscale. The caller must destroy the returned image if it's not NULL. */
+static sail_status_t to_grayscale(const struct sail_image *image, struct sail_image **image_gray, const struct sail_image **image_source) {
+
+    *image_gray = NULL;
+
+    if (image->pixel_format == SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE) {
+        *image_source = image;
+    } else {
+        SAIL_TRY(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, image_gray));
+        *image_source = *image_gray;
+    }
+
+    return SAIL_OK;
+}
+
+/* Converts the image to grayscale and scales it with the area filter. */
+static sail_status_t scaled_grayscale(const struct sail_image *image, unsigned width, unsigned height, struct sail_image **image_output) {
+
+    struct sail_image *image_gray;
+    const struct sail_image *image_source;
+    SAIL_TRY(to_grayscale(image, &image_gray, &image_source));
+
+    SAIL_TRY_OR_CLEANUP(sail_scale_image(image_source, width, height, SAIL_SCALE_FILTER_AREA, image_output),
+                        /* cleanup */ sail_destroy_image(image_gray));
+
+    sail_destroy_image(image_gray);
+
+    return SAIL_OK;
+}
+
+static uint64_t sum_squared_differences(const struct sail_image *image1, const struct sail_image *image2, unsigned components) {
+
+    const squared_differences_kernel_t kernel = squared_differences_kernel();
+    const unsigned length = image1->width * components;
+    const bool parallel = (size_t)image1->width * image1->height >= PARALLEL_PIXELS_THRESHOLD;
+
+    unsigned long long sum = 0;
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) if (parallel) num_threads(sail_thread_pool_size()) reduction(+:sum)
+    for (row = 0; row < image1->height; row++) {
+        sum += kernel(sail_scan_line(image1, row), sail_scan_line(image2, row), length);
+    }
+
+    return sum;
+}
+
+/* Returns the SSIM of two grayscale windows. */
+static double window_ssim(const struct sail_image *image1, const struct sail_image *image2,
+                          unsigned x, unsigned y, unsigned window_width, unsigned window_height) {
+
+    static const double C1 = (0.01 * 255) * (0.01 * 255);
+    static const double C2 = (0.03 * 255) * (0.03 * 255);
+
+    uint64_t sum1 = 0, sum2 = 0, sum11 = 0, sum22 = 0, sum12 = 0;
+
+    for (unsigned row = y; row < y + window_height; row++) {
+        const uint8_t *scan1 = (const uint8_t *)sail_scan_line(image1, row) + x;
+        const uint8_t *scan2 = (const uint8_t *)sail_scan_line(image2, row) + x;
+
+        for (unsigned column = 0; column < window_width; column++) {
+            const unsigned a = scan1[column];
+            const unsigned b = scan2[column];
+
+            sum1  += a;
+            sum2  += b;
+            sum11 += a * a;
+            sum22 += b * b;
+            sum12 += a * b;
+        }
+    }
+
+    const double n      = (double)window_width * window_height;
+    const double mean1  = sum1 / n;
+    const double mean2  = sum2 / n;
+    const double var1   = sum11 / n - mean1 * mean1;
+    const double var2   = sum22 / n - mean2 * mean2;
+    const double covar  = sum12 / n - mean1 * mean2;
+
+    return ((2 * mean1 * mean2 + C1) * (2 * covar + C2)) / ((mean1 * mean1 + mean2 * mean2 + C1) * (var1 + var2 + C2));
+}
+
+static double mean_ssim(const struct sail_image *image1, const struct sail_image *image2) {
+
+    const unsigned window_width  = (image1->width < SSIM_WINDOW) ? image1->width : SSIM_WINDOW;
+    const unsigned window_height = (image1->height < SSIM_WINDOW) ? image1->height : SSIM_WINDOW;
+    const unsigned windows_x     = (image1->width - window_width) / SSIM_STEP + 1;
+    const unsigned windows_y     = (image1->height - window_height) / SSIM_STEP + 1;
+    const bool parallel = (size_t)image1->width * image1->height >= PARALLEL_PIXELS_THRESHOLD;
+
+    double sum = 0;
+    unsigned window_row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) if (parallel) num_threads(sail_thread_pool_size()) reduction(+:sum)
+    for (window_row = 0; window_row < windows_y; window_row++) {
+        for (unsigned window_column = 0; window_column < windows_x; window_column++) {
+            sum += window_ssim(image1, image2, window_column * SSIM_STEP, window_row * SSIM_STEP, window_width, window_height);
+        }
+    }
+
+    return sum / ((double)windows_x * windows_y);
+}
+
+static int compare_doubles(const void *a, const void *b) {
+
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+/*
+ * Public functions.
+ */
+
+bool sail_equal_image_pixels(const struct sail_image *image1, const struct sail_image *image2) {
+
+    if (sail_check_image_valid(image1) != SAIL_OK || sail_check_image_valid(image2) != SAIL_OK) {
+        return false;
+    }
+
+    if (image1->width != image2->width || image1->height != image2->height || image1->pixel_format != image2->pixel_format) {
+        return false;
+    }
+
+    if (sail_is_indexed(image1->pixel_format)) {
+        const struct sail_palette *palette1 = image1->palette;
+        const struct sail_palette *palette2 = image2->palette;
+
+        if (palette1 == NULL || palette2 == NULL) {
+            return palette1 == palette2;
+        }
+
+        if (palette1->pixel_format != palette2->pixel_format || palette1->color_count != palette2->color_count) {
+            return false;
+        }
+
+        const size_t palette_size = (size_t)palette1->color_count * sail_bits_per_pixel(palette1->pixel_format) / 8;
+
+        if (memcmp(palette1->data, palette2->data, palette_size) != 0) {
+            return false;
+        }
+    }
+
+    const unsigned row_size = sail_bytes_per_line(image1->width, image1->pixel_format);
+
+    for (unsigned row = 0; row < image1->height; row++) {
+        if (memcmp(sail_scan_line(image1, row), sail_scan_line(image2, row), row_size) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+sail_status_t sail_image_psnr(const struct sail_image *image1, const struct sail_image *image2, double *psnr) {
+
+    SAIL_TRY(sail_check_image_valid(image1));
+    SAIL_TRY(sail_check_image_valid(image2));
+    SAIL_CHECK_PTR(psnr);
+
+    SAIL_TRY(check_same_dimensions(image1, image2));
+
+    unsigned components = (image1->pixel_format == image2->pixel_format) ? psnr_components(image1->pixel_format) : 0;
+
+    struct sail_image *image_rgba1 = NULL;
+    struct sail_image *image_rgba2 = NULL;
+
+    if (components == 0) {
+        SAIL_TRY(sail_convert_image(image1, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_rgba1));
+        SAIL_TRY_OR_CLEANUP(sail_convert_image(image2, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_rgba2),
+                            /* cleanup */ sail_destroy_image(image_rgba1));
+
+        image1     = image_rgba1;
+        image2     = image_rgba2;
+        components = 4;
+    }
+
+    const uint64_t sum = sum_squared_differences(image1, image2, components);
+    const double values = (double)image1->width * image1->height * components;
+
+    sail_destroy_image(image_rgba1);
+    sail_destroy_image(image_rgba2);
+
+    if (sum == 0) {
+        *psnr = INFINITY;
+    } else {
+        const double mse = (double)sum / values;
+        *psnr = 10.0 * log10(255.0 * 255.0 / mse);
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_image_ssim(const struct sail_image *image1, const struct sail_image *image2, double *ssim) {
+
+    SAIL_TRY(sail_check_image_valid(image1));
+    SAIL_TRY(sail_check_image_valid(image2));
+    SAIL_CHECK_PTR(ssim);
+
+    SAIL_TRY(check_same_dimensions(image1, image2));
+
+    struct sail_image *image_gray1;
+    const struct sail_image *image_source1;
+    SAIL_TRY(to_grayscale(image1, &image_gray1, &image_source1));
+
+    struct sail_image *image_gray2;
+    const struct sail_image *image_source2;
+    SAIL_TRY_OR_CLEANUP(to_grayscale(image2, &image_gray2, &image_source2),
+                        /* cleanup */ sail_destroy_image(image_gray1));
+
+    *ssim = mean_ssim(image_source1, image_source2);
+
+    sail_destroy_image(image_gray1);
+    sail_destroy_image(image_gray2);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_image_dhash(const struct sail_image *image, uint64_t *hash) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(hash);
+
+    struct sail_image *image_small;
+    SAIL_TRY(scaled_grayscale(image, 9, 8, &image_small));
+
+    uint64_t result = 0;
+
+    for (unsigned row = 0; row < 8; row++) {
+        const uint8_t *scan = sail_scan_line(image_small, row);
+
+        for (unsigned column = 0; column < 8; column++) {
+            result = (result << 1) | (scan[column] > scan[column + 1]);
+        }
+    }
+
+    sail_destroy_image(image_small);
+
+    *hash = result;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_image_phash(const struct sail_image *image, uint64_t *hash) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(hash);
+
+    struct sail_image *image_small;
+    SAIL_TRY(scaled_grayscale(image, 32, 32, &image_small));
+
+    /* DCT-II basis of the 8 lowest frequencies. */
+    double basis[8][32];
+
+    for (unsigned u = 0; u < 8; u++) {
+        for (unsigned x = 0; x < 32; x++) {
+            basis[u][x] = cos((2 * x + 1) * u * M_PI / 64);
+        }
+    }
+
+    /* Transform the rows, and then the columns. */
+    double rows[32][8];
+
+    for (unsigned y = 0; y < 32; y++) {
+        const uint8_t *scan = sail_scan_line(image_small, y);
+
+        for (unsigned u = 0; u < 8; u++) {
+            double sum = 0;
+
+            for (unsigned x = 0; x < 32; x++) {
+                sum += scan[x] * basis[u][x];
+            }
+
+            rows[y][u] = sum;
+        }
+    }
+
+    sail_destroy_image(image_small);
+
+    double coefficients[64];
+
+    for (unsigned v = 0; v < 8; v++) {
+        for (unsigned u = 0; u < 8; u++) {
+            double sum = 0;
+
+            for (unsigned y = 0; y < 32; y++) {
+                sum += rows[y][u] * basis[v][y];
+            }
+
+            coefficients[v * 8 + u] = sum;
+        }
+    }
+
+    /* The DC coefficient is the average brightness and doesn't take part in the median. */
+    double sorted[63];
+    memcpy(sorted, coefficients + 1, sizeof(sorted));
+    qsort(sorted, 63, sizeof(double), compare_doubles);
+    const double median = sorted[31];
+
+    uint64_t result = 0;
+
+    for (unsigned i = 0; i < 64; i++) {
+        result = (result << 1) | (coefficients[i] > median);
+    }
+
+    *hash = result;
+
+    return SAIL_OK;
+}
+
+unsigned sail_hash_distance(uint64_t hash1, uint64_t hash2) {
+
+    uint64_t bits = hash1 ^ hash2;
+    unsigned distance = 0;
+
+    while (bits != 0) {
+        bits &= bits - 1;
+        distance++;
+    }
+
+    return distance;
+}
@@ -0,0 +1,115 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_COMPARE_H
+#define SAIL_COMPARE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_image;
+
+/*
+ * Returns true if both the images are valid and have the same dimensions, pixel format, palette,
+ * and pixels. Padding bytes at the end of rows are ignored. Images in different pixel formats
+ * are never equal.
+ */
+SAIL_EXPORT bool sail_equal_image_pixels(const struct sail_image *image1, const struct sail_image *image2);
+
+/*
+ * Computes the peak signal-to-noise ratio in decibels between two images of the same dimensions.
+ * Images in the same pixel format with 8-bit grayscale, RGB, or RGBA components are compared as is.
+ * Other images are converted to SAIL_PIXEL_FORMAT_BPP32_RGBA first. Equal images have an infinite PSNR.
+ *
+ * Squared differences are summed with SSSE3, AVX2, or NEON instructions when available.
+ * Large images are compared in multiple threads with OpenMP.
+ *
+ * Allowed input pixel formats:
+ *   - All pixel formats that sail_convert_image() can convert to SAIL_PIXEL_FORMAT_BPP32_RGBA.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_INVALID_ARGUMENT if the image dimensions differ.
+ */
+SAIL_EXPORT sail_status_t sail_image_psnr(const struct sail_image *image1, const struct sail_image *image2, double *psnr);
+
+/*
+ * Computes the mean structural similarity index between two images of the same dimensions.
+ * The luma of the images is compared in 8x8 windows with a step of 4 pixels. The result is 1
+ * for equal images and decreases with their differences. Images in other pixel formats than
+ * SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE are converted to it first.
+ *
+ * Large images are compared in multiple threads with OpenMP.
+ *
+ * Allowed input pixel formats:
+ *   - All pixel formats that sail_convert_image() can convert to SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_INVALID_ARGUMENT if the image dimensions differ.
+ */
+SAIL_EXPORT sail_status_t sail_image_ssim(const struct sail_image *image1, const struct sail_image *image2, double *ssim);
+
+/*
+ * Computes the 64-bit difference hash of the image. The luma of the image is scaled to 9x8 pixels
+ * with the area filter, and every bit tells if a pixel is brighter than its right neighbor.
+ * Similar images have hashes with a small sail_hash_distance(), usually less than 10.
+ *
+ * Allowed input pixel formats:
+ *   - All pixel formats that sail_convert_image() can convert to SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_image_dhash(const struct sail_image *image, uint64_t *hash);
+
+/*
+ * Computes the 64-bit perceptual hash of the image. The luma of the image is scaled to 32x32 pixels
+ * with the area filter, and every bit tells if one of the 8x8 lowest frequencies of its discrete
+ * cosine transform is greater than their median. It's slower than sail_image_dhash(), but more robust
+ * against gamma and color changes.
+ *
+ * Allowed input pixel formats:
+ *   - All pixel formats that sail_convert_image() can convert to SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_image_phash(const struct sail_image *image, uint64_t *hash);
+
+/*
+ * Returns the number of different bits of two image hashes.
+ */
+SAIL_EXPORT unsigned sail_hash_distance(uint64_t hash1, uint64_t hash2);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -33,9 +33,12 @@ sail_status_t sail_alloc_conversion_options(struct sail_conversion_options **opt
     SAIL_TRY(sail_malloc(sizeof(struct sail_conversion_options), &ptr));
     *options = ptr;
 
-    (*options)->options      = SAIL_CONVERSION_OPTION_DROP_ALPHA;
-    (*options)->background48 = (sail_rgb48_t){ 0, 0, 0 };
-    (*options)->background24 = (sail_rgb24_t){ 0, 0, 0 };
+    (*options)->options                   = SAIL_CONVERSION_OPTION_DROP_ALPHA;
+    (*options)->background48              = (sail_rgb48_t){ 0, 0, 0 };
+    (*options)->background24              = (sail_rgb24_t){ 0, 0, 0 };
+    (*options)->luma_coefficients         = SAIL_LUMA_COEFFICIENTS_BT601;
+    (*options)->parallel_pixels_threshold = 0;
+    (*options)->parallel_chunk_size       = 0;
 
     return SAIL_OK;
 }
@@ -57,6 +57,24 @@ struct sail_conversion_options {
      * when options has SAIL_CONVERSION_OPTION_BLEND_ALPHA.
      */
     sail_rgb24_t background24;
+
+    /*
+     * Luma coefficients to convert color pixels to grayscale. SAIL_LUMA_COEFFICIENTS_BT601 by default.
+     */
+    enum SailLumaCoefficients luma_coefficients;
+
+    /*
+     * Images with fewer pixels are converted in the calling thread as starting threads costs more
+     * than converting them. If zero, 65536 is assumed. Has no effect when SAIL is compiled without OpenMP.
+     */
+    unsigned parallel_pixels_threshold;
+
+    /*
+     * Approximate number of input and output bytes converted by a thread at once. Rows are grouped
+     * into chunks of this size to fit into the L2 cache. A chunk has at least one row. If zero,
+     * 262144 is assumed. Has no effect when SAIL is compiled without OpenMP.
+     */
+    unsigned parallel_chunk_size;
 };
 
 typedef struct sail_conversion_options sail_conversion_options_t;
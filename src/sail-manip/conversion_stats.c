@@ -0,0 +1,208 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef SAIL_WIN32
+    #include <windows.h>
+#endif
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+static bool conversion_stats_enabled = false;
+
+/* Counters in the order of their first use. Guarded by the stats lock. */
+static struct sail_conversion_stats conversion_stats[SAIL_CONVERSION_STATS_CAPACITY];
+static size_t conversion_stats_count = 0;
+
+/*
+ * Open addressing hash table of the counter indexes plus one, so zero marks empty slots.
+ * Twice larger than the number of counters to keep the probes short.
+ */
+#define CONVERSION_STATS_SLOTS (SAIL_CONVERSION_STATS_CAPACITY * 2)
+static uint16_t conversion_stats_slots[CONVERSION_STATS_SLOTS];
+
+#ifdef SAIL_WIN32
+static volatile LONG conversion_stats_lock = 0;
+#else
+static int conversion_stats_lock = 0;
+#endif
+
+static void lock_conversion_stats(void) {
+
+#ifdef SAIL_WIN32
+    while (InterlockedExchange(&conversion_stats_lock, 1) != 0) {
+        YieldProcessor();
+    }
+#else
+    while (__atomic_exchange_n(&conversion_stats_lock, 1, __ATOMIC_ACQUIRE) != 0) {
+    }
+#endif
+}
+
+static void unlock_conversion_stats(void) {
+
+#ifdef SAIL_WIN32
+    InterlockedExchange(&conversion_stats_lock, 0);
+#else
+    __atomic_store_n(&conversion_stats_lock, 0, __ATOMIC_RELEASE);
+#endif
+}
+
+void record_conversion_stats(enum SailPixelFormat input_pixel_format,
+                             enum SailPixelFormat output_pixel_format,
+                             enum SailConversionKernel kernel,
+                             enum SailInstructionSet instruction_set,
+                             uint64_t pixels,
+                             uint64_t nanoseconds) {
+
+    if (!conversion_stats_enabled) {
+        return;
+    }
+
+    lock_conversion_stats();
+
+    const uint32_t key = ((uint32_t)input_pixel_format << 16) | ((uint32_t)output_pixel_format << 6)
+                            | ((uint32_t)kernel << 3) | (uint32_t)instruction_set;
+    size_t slot = (key * 2654435761u) % CONVERSION_STATS_SLOTS;
+    size_t i;
+
+    for (;; slot = (slot + 1) % CONVERSION_STATS_SLOTS) {
+        if (conversion_stats_slots[slot] == 0) {
+            if (conversion_stats_count == SAIL_CONVERSION_STATS_CAPACITY) {
+                unlock_conversion_stats();
+                return;
+            }
+
+            i = conversion_stats_count++;
+            conversion_stats_slots[slot] = (uint16_t)(i + 1);
+
+            conversion_stats[i] = (struct sail_conversion_stats) {
+                .input_pixel_format  = input_pixel_format,
+                .output_pixel_format = output_pixel_format,
+                .kernel              = kernel,
+                .instruction_set     = instruction_set,
+            };
+
+            break;
+        }
+
+        i = conversion_stats_slots[slot] - 1;
+        const struct sail_conversion_stats *stats = &conversion_stats[i];
+
+        if (stats->input_pixel_format == input_pixel_format && stats->output_pixel_format == output_pixel_format
+                && stats->kernel == kernel && stats->instruction_set == instruction_set) {
+            break;
+        }
+    }
+
+    conversion_stats[i].calls++;
+    conversion_stats[i].pixels      += pixels;
+    conversion_stats[i].nanoseconds += nanoseconds;
+
+    unlock_conversion_stats();
+}
+
+/*
+ * Public functions.
+ */
+
+void sail_set_conversion_stats_enabled(bool enabled) {
+
+    if (enabled) {
+        sail_reset_conversion_stats();
+    }
+
+    conversion_stats_enabled = enabled;
+}
+
+bool sail_is_conversion_stats_enabled(void) {
+
+    return conversion_stats_enabled;
+}
+
+sail_status_t sail_conversion_stats(struct sail_conversion_stats *stats, size_t capacity, size_t *count) {
+
+    if (capacity > 0) {
+        SAIL_CHECK_PTR(stats);
+    }
+    SAIL_CHECK_PTR(count);
+
+    lock_conversion_stats();
+
+    const size_t copied = (capacity < conversion_stats_count) ? capacity : conversion_stats_count;
+
+    if (copied > 0) {
+        memcpy(stats, conversion_stats, copied * sizeof(struct sail_conversion_stats));
+    }
+
+    *count = conversion_stats_count;
+
+    unlock_conversion_stats();
+
+    return SAIL_OK;
+}
+
+void sail_reset_conversion_stats(void) {
+
+    lock_conversion_stats();
+    memset(conversion_stats_slots, 0, sizeof(conversion_stats_slots));
+    conversion_stats_count = 0;
+    unlock_conversion_stats();
+}
+
+const char* sail_conversion_kernel_to_string(enum SailConversionKernel kernel) {
+
+    switch (kernel) {
+        case SAIL_CONVERSION_KERNEL_ICC:       return "icc";
+        case SAIL_CONVERSION_KERNEL_LUMA:      return "luma";
+        case SAIL_CONVERSION_KERNEL_NARROW:    return "narrow";
+        case SAIL_CONVERSION_KERNEL_ROW:       return "row";
+        case SAIL_CONVERSION_KERNEL_BLEND_ROW: return "blend-row";
+        case SAIL_CONVERSION_KERNEL_PIXEL:     return "pixel";
+    }
+
+    return NULL;
+}
+
+const char* sail_instruction_set_to_string(enum SailInstructionSet instruction_set) {
+
+    switch (instruction_set) {
+        case SAIL_INSTRUCTION_SET_GENERIC: return "generic";
+        case SAIL_INSTRUCTION_SET_SSSE3:   return "ssse3";
+        case SAIL_INSTRUCTION_SET_AVX2:    return "avx2";
+        case SAIL_INSTRUCTION_SET_NEON:    return "neon";
+        case SAIL_INSTRUCTION_SET_F16C:    return "f16c";
+    }
+
+    return NULL;
+}
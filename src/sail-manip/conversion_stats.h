@@ -0,0 +1,155 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_CONVERSION_STATS_H
+#define SAIL_CONVERSION_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Conversion paths selected by sail_convert_image() and conversion plans. */
+enum SailConversionKernel {
+
+    /* Direct ICC profile transform applied with SAIL_CONVERSION_OPTION_APPLY_ICCP. */
+    SAIL_CONVERSION_KERNEL_ICC,
+
+    /* RGB to grayscale row kernel. */
+    SAIL_CONVERSION_KERNEL_LUMA,
+
+    /* 16-bit to 8-bit components row kernel. */
+    SAIL_CONVERSION_KERNEL_NARROW,
+
+    /* Reordering, expanding, and color space row kernels. */
+    SAIL_CONVERSION_KERNEL_ROW,
+
+    /* Row kernels blending alpha with the background. */
+    SAIL_CONVERSION_KERNEL_BLEND_ROW,
+
+    /* Generic path converting every pixel through RGBA32 or RGBA64. */
+    SAIL_CONVERSION_KERNEL_PIXEL,
+};
+
+/* Instruction sets of the kernel implementations selected at runtime. */
+enum SailInstructionSet {
+
+    /* Portable C code. */
+    SAIL_INSTRUCTION_SET_GENERIC,
+
+    SAIL_INSTRUCTION_SET_SSSE3,
+    SAIL_INSTRUCTION_SET_AVX2,
+    SAIL_INSTRUCTION_SET_NEON,
+
+    /* Half precision conversions of x86 CPUs with AVX. */
+    SAIL_INSTRUCTION_SET_F16C,
+};
+
+/*
+ * Counters of the conversions between a pair of pixel formats with a kernel collected while
+ * the conversion stats are enabled.
+ */
+struct sail_conversion_stats {
+
+    enum SailPixelFormat input_pixel_format;
+    enum SailPixelFormat output_pixel_format;
+
+    enum SailConversionKernel kernel;
+
+    /* SAIL_INSTRUCTION_SET_GENERIC if the portable implementation of the kernel ran. */
+    enum SailInstructionSet instruction_set;
+
+    /* Number of converted images. */
+    uint64_t calls;
+
+    /* Number of converted pixels. */
+    uint64_t pixels;
+
+    /* Time spent converting the pixels. */
+    uint64_t nanoseconds;
+};
+
+typedef struct sail_conversion_stats sail_conversion_stats_t;
+
+/*
+ * Maximum number of distinct conversions counted. It fits all the conversion pairs with all
+ * their kernels. Conversions above it are not counted.
+ */
+#define SAIL_CONVERSION_STATS_CAPACITY 4096
+
+/*
+ * Enables or disables counting of every pixel format conversion. Enabling the stats resets them.
+ * Counting times every conversion and serializes the counter updates with a lock, so it's intended
+ * for profiling which conversions run and whether their SIMD implementations are used.
+ *
+ * This function is not thread-safe. It's recommended to call it in the main thread
+ * before converting images.
+ */
+SAIL_EXPORT void sail_set_conversion_stats_enabled(bool enabled);
+
+/*
+ * Returns true if the conversion stats are enabled.
+ */
+SAIL_EXPORT bool sail_is_conversion_stats_enabled(void);
+
+/*
+ * Copies up to 'capacity' counters of the conversions converted since the stats were enabled
+ * or reset into 'stats' in the order of their first use, and saves their total number
+ * into 'count'. 'stats' can be NULL if 'capacity' is 0 to query the number only.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_conversion_stats(struct sail_conversion_stats *stats, size_t capacity, size_t *count);
+
+/*
+ * Resets the conversion stats.
+ */
+SAIL_EXPORT void sail_reset_conversion_stats(void);
+
+/*
+ * Returns a string representation of the specified conversion kernel. For example: "row".
+ * Returns NULL if the kernel is not known.
+ */
+SAIL_EXPORT const char* sail_conversion_kernel_to_string(enum SailConversionKernel kernel);
+
+/*
+ * Returns a string representation of the specified instruction set. For example: "avx2".
+ * Returns NULL if the instruction set is not known.
+ */
+SAIL_EXPORT const char* sail_instruction_set_to_string(enum SailInstructionSet instruction_set);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -28,6 +28,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <sail-manip/sail-manip.h>
 
@@ -42,8 +43,15 @@ struct output_context {
     int b;
     int a;
     const struct sail_conversion_options *options;
+    bool parallel;      /* Convert rows in multiple threads. */
+    int rows_per_chunk; /* Number of rows converted by a thread at once. */
+    uint8_t *scratch;   /* Scratch buffer of the conversion plan for sub-byte indexes, or NULL. */
 };
 
+/* Used when sail_conversion_options is NULL or its parallel fields are zero. */
+static const unsigned DEFAULT_PARALLEL_PIXELS_THRESHOLD = 65536;
+static const unsigned DEFAULT_PARALLEL_CHUNK_SIZE       = 256 * 1024;
+
 typedef void (*pixel_consumer_t)(const struct output_context *output_context, uint8_t **scan8, uint16_t **scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64);
 
 static inline void pixel_consumer_gray8(const struct output_context *output_context, uint8_t **scan8, uint16_t ** scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
@@ -124,6 +132,57 @@ static inline void pixel_consumer_rgba64_kind(const struct output_context *outpu
     *scan16 += 4;
 }
 
+static inline void pixel_consumer_rgba32_premultiplied_kind(const struct output_context *output_context, uint8_t **scan8, uint16_t ** scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
+
+    (void)scan16;
+
+    if (rgba32 != NULL) {
+        const sail_rgba32_t premultiplied = {
+            premultiply_uint8(rgba32->component1, rgba32->component4),
+            premultiply_uint8(rgba32->component2, rgba32->component4),
+            premultiply_uint8(rgba32->component3, rgba32->component4),
+            rgba32->component4
+        };
+        fill_rgba32_pixel_from_uint8_values(&premultiplied, *scan8, output_context->r, output_context->g, output_context->b, output_context->a, output_context->options);
+    } else {
+        const sail_rgba64_t premultiplied = {
+            premultiply_uint16(rgba64->component1, rgba64->component4),
+            premultiply_uint16(rgba64->component2, rgba64->component4),
+            premultiply_uint16(rgba64->component3, rgba64->component4),
+            rgba64->component4
+        };
+        fill_rgba32_pixel_from_uint16_values(&premultiplied, *scan8, output_context->r, output_context->g, output_context->b, output_context->a, output_context->options);
+    }
+
+    *scan8 += 4;
+}
+
+static inline void pixel_consumer_rgba64_premultiplied_kind(const struct output_context *output_context, uint8_t ** scan8, uint16_t **scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
+
+    (void)scan8;
+
+    /* Premultiply 8-bit components with 16-bit precision to not lose the colors of nearly transparent pixels. */
+    sail_rgba64_t widened;
+
+    if (rgba32 != NULL) {
+        widened.component1 = (uint16_t)(rgba32->component1 * 257);
+        widened.component2 = (uint16_t)(rgba32->component2 * 257);
+        widened.component3 = (uint16_t)(rgba32->component3 * 257);
+        widened.component4 = (uint16_t)(rgba32->component4 * 257);
+        rgba64 = &widened;
+    }
+
+    const sail_rgba64_t premultiplied = {
+        premultiply_uint16(rgba64->component1, rgba64->component4),
+        premultiply_uint16(rgba64->component2, rgba64->component4),
+        premultiply_uint16(rgba64->component3, rgba64->component4),
+        rgba64->component4
+    };
+    fill_rgba64_pixel_from_uint16_values(&premultiplied, *scan16, output_context->r, output_context->g, output_context->b, output_context->a, output_context->options);
+
+    *scan16 += 4;
+}
+
 static inline void pixel_consumer_ycbcr(const struct output_context *output_context, uint8_t **scan8, uint16_t ** scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
 
     (void)scan16;
@@ -137,6 +196,72 @@ static inline void pixel_consumer_ycbcr(const struct output_context *output_cont
     *scan8 += 3;
 }
 
+/*
+ * Half precision and floating point components get the nominal [0; 1] range. The pixels are filled
+ * as 16-bit ones first, so alpha blending works like with the integer pixel formats.
+ */
+static inline void pixel_consumer_rgb_half(const struct output_context *output_context, uint8_t **scan8, uint16_t **scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
+
+    (void)scan8;
+
+    uint16_t values[3];
+
+    if (rgba32 != NULL) {
+        fill_rgb48_pixel_from_uint8_values(rgba32, values, 0, 1, 2, output_context->options);
+    } else {
+        fill_rgb48_pixel_from_uint16_values(rgba64, values, 0, 1, 2, output_context->options);
+    }
+
+    for (unsigned i = 0; i < 3; i++) {
+        (*scan16)[i] = float_to_half(uint16_to_float(values[i]));
+    }
+
+    *scan16 += 3;
+}
+
+static inline void pixel_consumer_rgba_half(const struct output_context *output_context, uint8_t **scan8, uint16_t **scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
+
+    (void)scan8;
+
+    uint16_t values[4];
+
+    if (rgba32 != NULL) {
+        fill_rgba64_pixel_from_uint8_values(rgba32, values, 0, 1, 2, 3, output_context->options);
+    } else {
+        fill_rgba64_pixel_from_uint16_values(rgba64, values, 0, 1, 2, 3, output_context->options);
+    }
+
+    for (unsigned i = 0; i < 4; i++) {
+        (*scan16)[i] = float_to_half(uint16_to_float(values[i]));
+    }
+
+    *scan16 += 4;
+}
+
+static inline void pixel_consumer_rgba_float(const struct output_context *output_context, uint8_t **scan8, uint16_t **scan16, const sail_rgba32_t *rgba32, const sail_rgba64_t *rgba64) {
+
+    (void)scan16;
+
+    uint16_t values[4];
+
+    if (rgba32 != NULL) {
+        fill_rgba64_pixel_from_uint8_values(rgba32, values, 0, 1, 2, 3, output_context->options);
+    } else {
+        fill_rgba64_pixel_from_uint16_values(rgba64, values, 0, 1, 2, 3, output_context->options);
+    }
+
+    float values_float[4];
+
+    for (unsigned i = 0; i < 4; i++) {
+        values_float[i] = uint16_to_float(values[i]);
+    }
+
+    memcpy(*scan8, values_float, sizeof(values_float));
+
+    *scan8 += sizeof(values_float);
+}
+
+/* After adding a new output pixel format, also update CONVERTIBLE_OUTPUTS. */
 static bool verify_and_construct_rgba_indexes_silent(enum SailPixelFormat output_pixel_format, pixel_consumer_t *pixel_consumer, int *r, int *g, int *b, int *a) {
 
     switch (output_pixel_format) {
@@ -169,6 +294,15 @@ static bool verify_and_construct_rgba_indexes_silent(enum SailPixelFormat output
 
         case SAIL_PIXEL_FORMAT_BPP24_YCBCR: { *pixel_consumer = pixel_consumer_ycbcr; *r = *g = *b = *a = -1; /* unused. */ break; }
 
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED: { *pixel_consumer = pixel_consumer_rgba32_premultiplied_kind; *r = 0; *g = 1; *b = 2; *a = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED: { *pixel_consumer = pixel_consumer_rgba32_premultiplied_kind; *r = 2; *g = 1; *b = 0; *a = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED: { *pixel_consumer = pixel_consumer_rgba64_premultiplied_kind; *r = 0; *g = 1; *b = 2; *a = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: { *pixel_consumer = pixel_consumer_rgba64_premultiplied_kind; *r = 2; *g = 1; *b = 0; *a = 3; break; }
+
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF:    { *pixel_consumer = pixel_consumer_rgb_half;   *r = 0; *g = 1; *b = 2; *a = -1; break; }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF:   { *pixel_consumer = pixel_consumer_rgba_half;  *r = 0; *g = 1; *b = 2; *a = 3;  break; }
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT: { *pixel_consumer = pixel_consumer_rgba_float; *r = 0; *g = 1; *b = 2; *a = 3;  break; }
+
         default: {
             return false;
         }
@@ -187,135 +321,221 @@ static sail_status_t verify_and_construct_rgba_indexes_verbose(enum SailPixelFor
     }
 }
 
-static sail_status_t convert_from_indexed(const struct sail_image *image,
-                                            const unsigned input_bit_shift, const unsigned bit_shift_decrease_by,
-                                            const unsigned input_bit_mask, const unsigned bit_mask_shift_by,
-                                            pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+/* Copies the palette table entries of the specified indexes into the output scan line. */
+static inline void gather_indexed_pixels(const uint8_t *indexes, unsigned count, const uint8_t *table, unsigned pixel_size, uint8_t *scan_output) {
+
+    /* Constant sizes let compilers inline memcpy(). */
+    switch (pixel_size) {
+        case 1: {
+            for (unsigned i = 0; i < count; i++) {
+                scan_output[i] = table[indexes[i]];
+            }
+            break;
+        }
+        case 2: {
+            for (unsigned i = 0; i < count; i++) {
+                memcpy(scan_output + i * 2, table + indexes[i] * 2, 2);
+            }
+            break;
+        }
+        case 3: {
+            for (unsigned i = 0; i < count; i++) {
+                memcpy(scan_output + i * 3, table + indexes[i] * 3, 3);
+            }
+            break;
+        }
+        case 4: {
+            for (unsigned i = 0; i < count; i++) {
+                memcpy(scan_output + i * 4, table + indexes[i] * 4, 4);
+            }
+            break;
+        }
+        case 6: {
+            for (unsigned i = 0; i < count; i++) {
+                memcpy(scan_output + i * 6, table + indexes[i] * 6, 6);
+            }
+            break;
+        }
+        default: {
+            for (unsigned i = 0; i < count; i++) {
+                memcpy(scan_output + i * pixel_size, table + indexes[i] * pixel_size, pixel_size);
+            }
+            break;
+        }
+    }
+}
+
+/*
+ * Converts 1, 2, 4, or 8-bit indexes into the output pixels from the table. Sub-byte indexes
+ * are converted a byte at a time with a lookup table of the output pixels of all 256 bytes.
+ * The lookup table is built in the scratch buffer of the conversion plan if it has one.
+ */
+static sail_status_t convert_with_pixel_table(const struct sail_image *image, const unsigned bits_per_index,
+                                                const uint8_t *table, const unsigned pixel_size,
+                                                const struct output_context *output_context) {
 
-    sail_status_t status = SAIL_OK;
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) shared(status)
+    if (bits_per_index == 8) {
+        #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
+        for (row = 0; row < image->height; row++) {
+            gather_indexed_pixels(sail_scan_line(image, row), image->width, table, pixel_size, sail_scan_line(output_context->image, row));
+        }
+
+        return SAIL_OK;
+    }
+
+    const unsigned indexes_per_byte = 8 / bits_per_index;
+    const unsigned index_mask       = (1U << bits_per_index) - 1;
+    const unsigned expanded_size    = indexes_per_byte * pixel_size;
+
+    uint8_t *expanded = output_context->scratch;
+
+    if (expanded == NULL) {
+        void *ptr;
+        SAIL_TRY(sail_malloc((size_t)256 * expanded_size, &ptr));
+        expanded = ptr;
+    }
+
+    for (unsigned byte = 0; byte < 256; byte++) {
+        for (unsigned i = 0; i < indexes_per_byte; i++) {
+            const unsigned index = (byte >> (8 - bits_per_index * (i + 1))) & index_mask;
+
+            memcpy(expanded + byte * expanded_size + i * pixel_size, table + index * pixel_size, pixel_size);
+        }
+    }
+
+    const unsigned full_bytes = image->width / indexes_per_byte;
+    const unsigned tail_size  = (image->width % indexes_per_byte) * pixel_size;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
-        #pragma omp flush(status)
-        if (status == SAIL_OK) {
-            const uint8_t  *scan_input    = sail_scan_line(image, row);
-                  uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
-                  uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
-
-            for (unsigned column = 0; column < image->width;) {
-                unsigned bit_shift = input_bit_shift;
-                unsigned bit_mask = input_bit_mask;
-                const uint8_t byte = *scan_input++;
-
-                while (bit_mask > 0 && column < image->width) {
-                    const uint8_t index = (byte & bit_mask) >> bit_shift;
-
-                    sail_rgba32_t rgba32;
-                    SAIL_TRY_OR_EXECUTE(get_palette_rgba32(image->palette, index, &rgba32),
-                                        /* on error */ status = __sail_status);
-                    #pragma omp flush(status)
-                    pixel_consumer(output_context, &scan_output8, &scan_output16, &rgba32, NULL);
-
-                    bit_shift -= bit_shift_decrease_by;
-                    bit_mask >>= bit_mask_shift_by;
-                    column++;
-                }
-            }
+        const uint8_t *scan_input  = sail_scan_line(image, row);
+              uint8_t *scan_output = sail_scan_line(output_context->image, row);
+
+        for (unsigned i = 0; i < full_bytes; i++) {
+            memcpy(scan_output, expanded + scan_input[i] * expanded_size, expanded_size);
+            scan_output += expanded_size;
+        }
+
+        if (tail_size > 0) {
+            memcpy(scan_output, expanded + scan_input[full_bytes] * expanded_size, tail_size);
+        }
+    }
+
+    if (expanded != output_context->scratch) {
+        sail_free(expanded);
+    }
+
+    return SAIL_OK;
+}
+
+/* Expands the palette into a table of output pixels once, so converting indexed rows is a table lookup. */
+static sail_status_t convert_from_indexed(const struct sail_image *image, const unsigned bits_per_index,
+                                            pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+
+    const unsigned colors = 1U << bits_per_index;
+    const unsigned pixel_size = sail_bits_per_pixel(output_context->image->pixel_format) / 8;
+
+    /* 256 entries of up to 8 bytes per pixel. uint64_t keeps 16-bit components aligned. */
+    uint64_t table64[256];
+    uint8_t *table = (uint8_t *)table64;
+
+    for (unsigned index = 0; index < colors; index++) {
+        sail_rgba32_t rgba32 = { 0, 0, 0, 255 };
+
+        /* Out-of-range indexes produce black pixels. */
+        if (index < image->palette->color_count) {
+            SAIL_TRY(get_palette_rgba32(image->palette, index, &rgba32));
         }
+
+        uint8_t *scan8 = table + index * pixel_size;
+        uint16_t *scan16 = (uint16_t *)scan8;
+        pixel_consumer(output_context, &scan8, &scan16, &rgba32, NULL);
     }
 
+    SAIL_TRY(convert_with_pixel_table(image, bits_per_index, table, pixel_size, output_context));
+
     return SAIL_OK;
 }
 
 static sail_status_t convert_from_bpp1_indexed(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    SAIL_TRY(convert_from_indexed(image, 7, 1, /* 10000000 */ 0x80, 1, pixel_consumer, output_context));
+    SAIL_TRY(convert_from_indexed(image, 1, pixel_consumer, output_context));
 
     return SAIL_OK;
 }
 
 static sail_status_t convert_from_bpp2_indexed(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    SAIL_TRY(convert_from_indexed(image, 6, 2, /* 11000000 */ 0xC0, 2, pixel_consumer, output_context));
+    SAIL_TRY(convert_from_indexed(image, 2, pixel_consumer, output_context));
 
     return SAIL_OK;
 }
 
 static sail_status_t convert_from_bpp4_indexed(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    SAIL_TRY(convert_from_indexed(image, 4, 4, /* 11110000 */ 0xF0, 4, pixel_consumer, output_context));
+    SAIL_TRY(convert_from_indexed(image, 4, pixel_consumer, output_context));
 
     return SAIL_OK;
 }
 
 static sail_status_t convert_from_bpp8_indexed(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    SAIL_TRY(convert_from_indexed(image, 0, 0, /* 11111111 */ 0xFF, 8, pixel_consumer, output_context));
+    SAIL_TRY(convert_from_indexed(image, 8, pixel_consumer, output_context));
 
     return SAIL_OK;
 }
 
-static sail_status_t convert_from_grayscale_up_to_bpp8(const struct sail_image *image,
-                                                        const unsigned input_bit_shift, const unsigned bit_shift_decrease_by,
-                                                        const unsigned input_bit_mask, const unsigned bit_mask_shift_by,
+/* Converts every possible gray value once, so converting grayscale rows is a table lookup. */
+static sail_status_t convert_from_grayscale_up_to_bpp8(const struct sail_image *image, const unsigned bits_per_pixel,
                                                         const unsigned multiplicator_to_255,
                                                         pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    unsigned row;
-
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
-    for (row = 0; row < image->height; row++) {
-        const uint8_t  *scan_input    = sail_scan_line(image, row);
-              uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
-              uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
+    const unsigned pixel_size = sail_bits_per_pixel(output_context->image->pixel_format) / 8;
 
-        for (unsigned column = 0; column < image->width;) {
-            unsigned bit_shift = input_bit_shift;
-            unsigned bit_mask = input_bit_mask;
-            const uint8_t byte = *scan_input++;
+    /* 256 entries of up to 8 bytes per pixel. uint64_t keeps 16-bit components aligned. */
+    uint64_t table64[256];
+    uint8_t *table = (uint8_t *)table64;
 
-            while (bit_mask > 0 && column < image->width) {
-                const uint8_t index = (byte & bit_mask) >> bit_shift;
+    for (unsigned value = 0; value < (1U << bits_per_pixel); value++) {
+        sail_rgba32_t rgba32;
+        spread_gray8_to_rgba32((uint8_t)(value * multiplicator_to_255), &rgba32);
 
-                sail_rgba32_t rgba32;
-                spread_gray8_to_rgba32((uint8_t)(index * multiplicator_to_255), &rgba32);
-                pixel_consumer(output_context, &scan_output8, &scan_output16, &rgba32, NULL);
-
-                bit_shift -= bit_shift_decrease_by;
-                bit_mask >>= bit_mask_shift_by;
-                column++;
-            }
-        }
+        uint8_t *scan8 = table + value * pixel_size;
+        uint16_t *scan16 = (uint16_t *)scan8;
+        pixel_consumer(output_context, &scan8, &scan16, &rgba32, NULL);
     }
 
+    SAIL_TRY(convert_with_pixel_table(image, bits_per_pixel, table, pixel_size, output_context));
+
     return SAIL_OK;
 }
 
 static sail_status_t convert_from_bpp1_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 7, 1, /* 10000000 */ 0x80, 1, 255, pixel_consumer, output_context));
+    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 1, 255, pixel_consumer, output_context));
 
     return SAIL_OK;
 }
 
 static sail_status_t convert_from_bpp2_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 6, 2, /* 11000000 */ 0xC0, 2, 85, pixel_consumer, output_context));
+    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 2, 85, pixel_consumer, output_context));
 
     return SAIL_OK;
 }
 
 static sail_status_t convert_from_bpp4_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 4, 4, /* 11110000 */ 0xF0, 4, 17, pixel_consumer, output_context));
+    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 4, 17, pixel_consumer, output_context));
 
     return SAIL_OK;
 }
 
 static sail_status_t convert_from_bpp8_grayscale(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
-    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 0, 0, /* 11111111 */ 0xFF, 8, 1, pixel_consumer, output_context));
+    SAIL_TRY(convert_from_grayscale_up_to_bpp8(image, 8, 1, pixel_consumer, output_context));
 
     return SAIL_OK;
 }
@@ -324,7 +544,7 @@ static sail_status_t convert_from_bpp16_grayscale(const struct sail_image *image
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -344,7 +564,7 @@ static sail_status_t convert_from_bpp16_grayscale_alpha(const struct sail_image
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -366,7 +586,7 @@ static sail_status_t convert_from_bpp32_grayscale_alpha(const struct sail_image
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -388,7 +608,7 @@ static sail_status_t convert_from_bpp16_rgb555(const struct sail_image *image, p
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -409,7 +629,7 @@ static sail_status_t convert_from_bpp16_bgr555(const struct sail_image *image, p
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -430,7 +650,7 @@ static sail_status_t convert_from_bpp16_rgb565(const struct sail_image *image, p
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -451,7 +671,7 @@ static sail_status_t convert_from_bpp16_bgr565(const struct sail_image *image, p
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -472,7 +692,7 @@ static sail_status_t convert_from_bpp24_rgb_kind(const struct sail_image *image,
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -493,7 +713,7 @@ static sail_status_t convert_from_bpp48_rgb_kind(const struct sail_image *image,
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -514,7 +734,7 @@ static sail_status_t convert_from_bpp32_rgba_kind(const struct sail_image *image
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -535,7 +755,7 @@ static sail_status_t convert_from_bpp64_rgba_kind(const struct sail_image *image
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint16_t *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -552,11 +772,147 @@ static sail_status_t convert_from_bpp64_rgba_kind(const struct sail_image *image
     return SAIL_OK;
 }
 
+/* HDR values are clamped by float_to_uint16(). */
+static sail_status_t convert_from_bpp48_rgb_half(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image->height; row++) {
+        const uint16_t *scan_input    = sail_scan_line(image, row);
+              uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
+              uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const sail_rgba64_t rgba64 = {
+                float_to_uint16(half_to_float(scan_input[0])),
+                float_to_uint16(half_to_float(scan_input[1])),
+                float_to_uint16(half_to_float(scan_input[2])),
+                65535
+            };
+
+            pixel_consumer(output_context, &scan_output8, &scan_output16, NULL, &rgba64);
+            scan_input += 3;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t convert_from_bpp64_rgba_half(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image->height; row++) {
+        const uint16_t *scan_input    = sail_scan_line(image, row);
+              uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
+              uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const sail_rgba64_t rgba64 = {
+                float_to_uint16(half_to_float(scan_input[0])),
+                float_to_uint16(half_to_float(scan_input[1])),
+                float_to_uint16(half_to_float(scan_input[2])),
+                float_to_uint16(half_to_float(scan_input[3]))
+            };
+
+            pixel_consumer(output_context, &scan_output8, &scan_output16, NULL, &rgba64);
+            scan_input += 4;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t convert_from_bpp128_rgba_float(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image->height; row++) {
+        const uint8_t  *scan_input    = sail_scan_line(image, row);
+              uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
+              uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            float values[4];
+            memcpy(values, scan_input, sizeof(values));
+
+            const sail_rgba64_t rgba64 = {
+                float_to_uint16(values[0]),
+                float_to_uint16(values[1]),
+                float_to_uint16(values[2]),
+                float_to_uint16(values[3])
+            };
+
+            pixel_consumer(output_context, &scan_output8, &scan_output16, NULL, &rgba64);
+            scan_input += sizeof(values);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t convert_from_bpp32_rgba_premultiplied_kind(const struct sail_image *image, int ri, int gi, int bi, int ai, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image->height; row++) {
+        const uint8_t  *scan_input    = sail_scan_line(image, row);
+              uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
+              uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const uint8_t a = *(scan_input+ai);
+            const sail_rgba32_t rgba32 = {
+                unpremultiply_uint8(*(scan_input+ri), a),
+                unpremultiply_uint8(*(scan_input+gi), a),
+                unpremultiply_uint8(*(scan_input+bi), a),
+                a
+            };
+
+            pixel_consumer(output_context, &scan_output8, &scan_output16, &rgba32, NULL);
+            scan_input += 4;
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t convert_from_bpp64_rgba_premultiplied_kind(const struct sail_image *image, int ri, int gi, int bi, int ai, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
+
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image->height; row++) {
+        const uint16_t *scan_input    = sail_scan_line(image, row);
+              uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
+              uint16_t *scan_output16 = sail_scan_line(output_context->image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const uint16_t a = *(scan_input+ai);
+            const sail_rgba64_t rgba64 = {
+                unpremultiply_uint16(*(scan_input+ri), a),
+                unpremultiply_uint16(*(scan_input+gi), a),
+                unpremultiply_uint16(*(scan_input+bi), a),
+                a
+            };
+
+            pixel_consumer(output_context, &scan_output8, &scan_output16, NULL, &rgba64);
+            scan_input += 4;
+        }
+    }
+
+    return SAIL_OK;
+}
+
 static sail_status_t convert_from_bpp32_cmyk(const struct sail_image *image, pixel_consumer_t pixel_consumer, const struct output_context *output_context) {
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -578,7 +934,7 @@ static sail_status_t convert_from_bpp24_ycbcr(const struct sail_image *image, pi
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -600,7 +956,7 @@ static sail_status_t convert_from_bpp32_ycck(const struct sail_image *image, pix
 
     unsigned row;
 
-    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
     for (row = 0; row < image->height; row++) {
         const uint8_t  *scan_input    = sail_scan_line(image, row);
               uint8_t  *scan_output8  = sail_scan_line(output_context->image, row);
@@ -618,30 +974,410 @@ static sail_status_t convert_from_bpp32_ycck(const struct sail_image *image, pix
     return SAIL_OK;
 }
 
-static sail_status_t conversion_impl(
-    const struct sail_image *image,
-    struct sail_image *image_output,
-    pixel_consumer_t pixel_consumer,
-    int r, /* Index of the RED component.   */
-    int g, /* Index of the GREEN component. */
-    int b, /* Index of the BLUE component.  */
-    int a, /* Index of the ALPHA component. */
-    const struct sail_conversion_options *options) {
+/* Conversions implemented with row kernels. See row_kernels.h. */
+struct row_conversion {
+    enum SailPixelFormat input_pixel_format;
+    enum SailPixelFormat output_pixel_format;
+    bool drops_alpha; /* Converted with blend_row_kernel() when alpha blending is requested. */
+    enum SailRowKernel row_kernel;
+};
 
-    const struct output_context output_context = { image_output, r, g, b, a, options };
+static const struct row_conversion ROW_CONVERSIONS[] = {
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,      SAIL_PIXEL_FORMAT_BPP24_BGR,  false, SAIL_ROW_KERNEL_SWAP_RGB24 },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,      SAIL_PIXEL_FORMAT_BPP24_RGB,  false, SAIL_ROW_KERNEL_SWAP_RGB24 },
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,      SAIL_PIXEL_FORMAT_BPP32_RGBA, false, SAIL_ROW_KERNEL_RGB24_TO_RGBA32 },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,      SAIL_PIXEL_FORMAT_BPP32_BGRA, false, SAIL_ROW_KERNEL_RGB24_TO_RGBA32 },
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,      SAIL_PIXEL_FORMAT_BPP32_BGRA, false, SAIL_ROW_KERNEL_RGB24_TO_RGBA32_SWAPPED },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,      SAIL_PIXEL_FORMAT_BPP32_RGBA, false, SAIL_ROW_KERNEL_RGB24_TO_RGBA32_SWAPPED },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,     SAIL_PIXEL_FORMAT_BPP32_BGRA, false, SAIL_ROW_KERNEL_SWAP_RGBA32 },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,     SAIL_PIXEL_FORMAT_BPP32_RGBA, false, SAIL_ROW_KERNEL_SWAP_RGBA32 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,     SAIL_PIXEL_FORMAT_BPP24_RGB,  true,  SAIL_ROW_KERNEL_RGBA32_TO_RGB24 },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,     SAIL_PIXEL_FORMAT_BPP24_BGR,  true,  SAIL_ROW_KERNEL_RGBA32_TO_RGB24 },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,     SAIL_PIXEL_FORMAT_BPP24_RGB,  true,  SAIL_ROW_KERNEL_RGBA32_TO_RGB24_SWAPPED },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,     SAIL_PIXEL_FORMAT_BPP24_BGR,  true,  SAIL_ROW_KERNEL_RGBA32_TO_RGB24_SWAPPED },
+    { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, SAIL_PIXEL_FORMAT_BPP24_RGB,  false, SAIL_ROW_KERNEL_GRAY8_TO_RGB24 },
+    { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, SAIL_PIXEL_FORMAT_BPP24_BGR,  false, SAIL_ROW_KERNEL_GRAY8_TO_RGB24 },
+    { SAIL_PIXEL_FORMAT_BPP24_YCBCR,    SAIL_PIXEL_FORMAT_BPP24_RGB,  false, SAIL_ROW_KERNEL_YCBCR24_TO_RGB24 },
+    { SAIL_PIXEL_FORMAT_BPP24_YCBCR,    SAIL_PIXEL_FORMAT_BPP32_RGBA, false, SAIL_ROW_KERNEL_YCBCR24_TO_RGBA32 },
+    { SAIL_PIXEL_FORMAT_BPP32_CMYK,     SAIL_PIXEL_FORMAT_BPP24_RGB,  false, SAIL_ROW_KERNEL_CMYK32_TO_RGB24 },
+    { SAIL_PIXEL_FORMAT_BPP32_CMYK,     SAIL_PIXEL_FORMAT_BPP32_RGBA, false, SAIL_ROW_KERNEL_CMYK32_TO_RGBA32 },
+    { SAIL_PIXEL_FORMAT_BPP32_YCCK,     SAIL_PIXEL_FORMAT_BPP24_RGB,  false, SAIL_ROW_KERNEL_YCCK32_TO_RGB24 },
+    { SAIL_PIXEL_FORMAT_BPP32_YCCK,     SAIL_PIXEL_FORMAT_BPP32_RGBA, false, SAIL_ROW_KERNEL_YCCK32_TO_RGBA32 },
+
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, false, SAIL_ROW_KERNEL_PREMULTIPLY_RGBA32 },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA, SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED, false, SAIL_ROW_KERNEL_PREMULTIPLY_RGBA32 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED, false, SAIL_ROW_KERNEL_PREMULTIPLY_RGBA32_SWAPPED },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA, SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, false, SAIL_ROW_KERNEL_PREMULTIPLY_RGBA32_SWAPPED },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, SAIL_PIXEL_FORMAT_BPP32_RGBA, false, SAIL_ROW_KERNEL_UNPREMULTIPLY_RGBA32 },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED, SAIL_PIXEL_FORMAT_BPP32_BGRA, false, SAIL_ROW_KERNEL_UNPREMULTIPLY_RGBA32 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, SAIL_PIXEL_FORMAT_BPP32_BGRA, false, SAIL_ROW_KERNEL_UNPREMULTIPLY_RGBA32_SWAPPED },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED, SAIL_PIXEL_FORMAT_BPP32_RGBA, false, SAIL_ROW_KERNEL_UNPREMULTIPLY_RGBA32_SWAPPED },
+
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF,   SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, false, SAIL_ROW_KERNEL_RGBA_HALF_TO_RGBA_FLOAT },
+    { SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF,   false, SAIL_ROW_KERNEL_RGBA_FLOAT_TO_RGBA_HALF },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA,        SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF,   false, SAIL_ROW_KERNEL_RGBA64_TO_RGBA_HALF },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF,   SAIL_PIXEL_FORMAT_BPP64_RGBA,        false, SAIL_ROW_KERNEL_RGBA_HALF_TO_RGBA64 },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA,        SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, false, SAIL_ROW_KERNEL_RGBA64_TO_RGBA_FLOAT },
+    { SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, SAIL_PIXEL_FORMAT_BPP64_RGBA,        false, SAIL_ROW_KERNEL_RGBA_FLOAT_TO_RGBA64 },
+};
 
-    /* After adding a new input pixel format, also update the switch in sail_can_convert(). */
-    switch (image->pixel_format) {
-        case SAIL_PIXEL_FORMAT_BPP1_INDEXED: {
-            SAIL_TRY(convert_from_bpp1_indexed(image, pixel_consumer, &output_context));
-            break;
+static const size_t ROW_CONVERSIONS_LENGTH = sizeof(ROW_CONVERSIONS) / sizeof(ROW_CONVERSIONS[0]);
+
+/* Conversions to grayscale implemented with luma row kernels. See row_kernels.h. */
+struct luma_conversion {
+    enum SailPixelFormat input_pixel_format;
+    enum SailPixelFormat output_pixel_format;
+    bool bgr;       /* The input color components are in the BGR order. */
+    bool has_alpha; /* Converted in the generic path when alpha blending is requested. */
+    enum SailLumaRowKernel luma_row_kernel;
+};
+
+static const struct luma_conversion LUMA_CONVERSIONS[] = {
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,  SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  false, false, SAIL_LUMA_ROW_KERNEL_RGB24_TO_GRAY8 },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,  SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  true,  false, SAIL_LUMA_ROW_KERNEL_RGB24_TO_GRAY8 },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  false, true,  SAIL_LUMA_ROW_KERNEL_RGBA32_TO_GRAY8 },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  true,  true,  SAIL_LUMA_ROW_KERNEL_RGBA32_TO_GRAY8 },
+    { SAIL_PIXEL_FORMAT_BPP48_RGB,  SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, false, false, SAIL_LUMA_ROW_KERNEL_RGB48_TO_GRAY16 },
+    { SAIL_PIXEL_FORMAT_BPP48_BGR,  SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, true,  false, SAIL_LUMA_ROW_KERNEL_RGB48_TO_GRAY16 },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, false, true,  SAIL_LUMA_ROW_KERNEL_RGBA64_TO_GRAY16 },
+    { SAIL_PIXEL_FORMAT_BPP64_BGRA, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, true,  true,  SAIL_LUMA_ROW_KERNEL_RGBA64_TO_GRAY16 },
+};
+
+static const size_t LUMA_CONVERSIONS_LENGTH = sizeof(LUMA_CONVERSIONS) / sizeof(LUMA_CONVERSIONS[0]);
+
+static const struct luma_conversion* find_luma_conversion(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
+
+    for (size_t i = 0; i < LUMA_CONVERSIONS_LENGTH; i++) {
+        const struct luma_conversion *luma_conversion = &LUMA_CONVERSIONS[i];
+
+        if (luma_conversion->input_pixel_format == input_pixel_format &&
+                luma_conversion->output_pixel_format == output_pixel_format) {
+            return luma_conversion;
         }
-        case SAIL_PIXEL_FORMAT_BPP2_INDEXED: {
-            SAIL_TRY(convert_from_bpp2_indexed(image, pixel_consumer, &output_context));
-            break;
+    }
+
+    return NULL;
+}
+
+/* Conversions narrowing 16-bit components to 8 bits without reordering them. See narrow_row_kernel(). */
+struct narrow_conversion {
+    enum SailPixelFormat input_pixel_format;
+    enum SailPixelFormat output_pixel_format;
+    unsigned components;
+    int alpha; /* Index of the ALPHA component that is never dithered, or -1. */
+};
+
+static const struct narrow_conversion NARROW_CONVERSIONS[] = {
+    { SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 1, -1 },
+    { SAIL_PIXEL_FORMAT_BPP48_RGB,       SAIL_PIXEL_FORMAT_BPP24_RGB,      3, -1 },
+    { SAIL_PIXEL_FORMAT_BPP48_BGR,       SAIL_PIXEL_FORMAT_BPP24_BGR,      3, -1 },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA,      SAIL_PIXEL_FORMAT_BPP32_RGBA,     4,  3 },
+    { SAIL_PIXEL_FORMAT_BPP64_BGRA,      SAIL_PIXEL_FORMAT_BPP32_BGRA,     4,  3 },
+    { SAIL_PIXEL_FORMAT_BPP64_ARGB,      SAIL_PIXEL_FORMAT_BPP32_ARGB,     4,  0 },
+    { SAIL_PIXEL_FORMAT_BPP64_ABGR,      SAIL_PIXEL_FORMAT_BPP32_ABGR,     4,  0 },
+};
+
+static const size_t NARROW_CONVERSIONS_LENGTH = sizeof(NARROW_CONVERSIONS) / sizeof(NARROW_CONVERSIONS[0]);
+
+static const struct narrow_conversion* find_narrow_conversion(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
+
+    for (size_t i = 0; i < NARROW_CONVERSIONS_LENGTH; i++) {
+        const struct narrow_conversion *narrow_conversion = &NARROW_CONVERSIONS[i];
+
+        if (narrow_conversion->input_pixel_format == input_pixel_format &&
+                narrow_conversion->output_pixel_format == output_pixel_format) {
+            return narrow_conversion;
         }
-        case SAIL_PIXEL_FORMAT_BPP4_INDEXED: {
-            SAIL_TRY(convert_from_bpp4_indexed(image, pixel_consumer, &output_context));
+    }
+
+    return NULL;
+}
+
+static const struct row_conversion* find_row_conversion(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
+
+    for (size_t i = 0; i < ROW_CONVERSIONS_LENGTH; i++) {
+        const struct row_conversion *row_conversion = &ROW_CONVERSIONS[i];
+
+        if (row_conversion->input_pixel_format == input_pixel_format &&
+                row_conversion->output_pixel_format == output_pixel_format) {
+            return row_conversion;
+        }
+    }
+
+    return NULL;
+}
+
+static void convert_with_row_kernel(const struct sail_image *image, row_kernel_t row_kernel, const struct output_context *output_context) {
+
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image->height; row++) {
+        row_kernel(sail_scan_line(image, row), sail_scan_line(output_context->image, row), image->width);
+    }
+}
+
+static void convert_with_blend_row_kernel(const struct sail_image *image, blend_row_kernel_t blend_row_kernel,
+                                          const uint8_t background[3], const struct output_context *output_context) {
+
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image->height; row++) {
+        blend_row_kernel(sail_scan_line(image, row), sail_scan_line(output_context->image, row), image->width, background);
+    }
+}
+
+static void convert_with_luma_row_kernel(const struct sail_image *image, luma_row_kernel_t luma_row_kernel,
+                                         const uint16_t weights[3], const struct output_context *output_context) {
+
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image->height; row++) {
+        luma_row_kernel(sail_scan_line(image, row), sail_scan_line(output_context->image, row), image->width, weights);
+    }
+}
+
+/* Narrows rows with the thresholds built by init_conversion_plan() that repeat every 8 rows. */
+static void convert_with_narrow_row_kernel(const struct sail_image *image, narrow_row_kernel_t narrow_row, unsigned components,
+                                           const uint16_t thresholds[8][SAIL_NARROW_THRESHOLDS_LENGTH],
+                                           const struct output_context *output_context) {
+
+    const unsigned length = image->width * components;
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE, output_context->rows_per_chunk) if (output_context->parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image->height; row++) {
+        narrow_row(sail_scan_line(image, row), sail_scan_line(output_context->image, row), length, thresholds[row % 8]);
+    }
+}
+
+/*
+ * Converts small images in the calling thread and splits large images into chunks of rows
+ * that fit into the L2 cache, so starting threads and scheduling rows one by one don't cost
+ * more than the conversion itself.
+ */
+static void setup_parallelism(const struct sail_image *image, const struct sail_conversion_options *options, struct output_context *output_context) {
+
+    const unsigned pixels_threshold = (options == NULL || options->parallel_pixels_threshold == 0)
+                                        ? DEFAULT_PARALLEL_PIXELS_THRESHOLD : options->parallel_pixels_threshold;
+    const unsigned chunk_size = (options == NULL || options->parallel_chunk_size == 0)
+                                    ? DEFAULT_PARALLEL_CHUNK_SIZE : options->parallel_chunk_size;
+
+    /* In-place conversions read and write the same rows. */
+    const size_t row_size = (image == output_context->image)
+                                ? image->bytes_per_line
+                                : (size_t)image->bytes_per_line + output_context->image->bytes_per_line;
+
+    output_context->parallel       = (uint64_t)image->width * image->height >= pixels_threshold;
+    output_context->rows_per_chunk = (int)SAIL_MAX(1, SAIL_MIN(image->height, chunk_size / row_size));
+
+    /*
+     * With NUMA-aware threads, give every thread a single contiguous band of rows. With the static
+     * schedule, the bands match the parts of the pixels placed on the nodes by sail_thread_pool_first_touch().
+     */
+    if (output_context->parallel && sail_thread_pool_numa_nodes() > 1) {
+        const unsigned threads = sail_thread_pool_size();
+
+        output_context->rows_per_chunk = (int)SAIL_MAX(1, (image->height + threads - 1) / threads);
+    }
+}
+
+/* Kernels selected by init_conversion_plan(). */
+enum conversion_kind {
+    CONVERSION_KIND_LUMA,
+    CONVERSION_KIND_NARROW,
+    CONVERSION_KIND_ROW,
+    CONVERSION_KIND_BLEND_ROW,
+    CONVERSION_KIND_PIXEL_CONSUMER,
+};
+
+struct sail_conversion_plan {
+    enum SailPixelFormat input_pixel_format;
+    enum SailPixelFormat output_pixel_format;
+    struct sail_conversion_options options;
+    bool has_options;
+
+    enum conversion_kind kind;
+    enum SailInstructionSet instruction_set; /* Of the selected kernel implementation. */
+
+    /* CONVERSION_KIND_PIXEL_CONSUMER. */
+    pixel_consumer_t pixel_consumer;
+    int r; /* Index of the RED component.   */
+    int g; /* Index of the GREEN component. */
+    int b; /* Index of the BLUE component.  */
+    int a; /* Index of the ALPHA component. */
+    uint8_t *scratch;
+
+    /* CONVERSION_KIND_LUMA. */
+    luma_row_kernel_t luma_row_kernel;
+    uint16_t weights[3];
+
+    /* CONVERSION_KIND_NARROW. */
+    narrow_row_kernel_t narrow_row_kernel;
+    unsigned components;
+    uint16_t thresholds[8][SAIL_NARROW_THRESHOLDS_LENGTH];
+
+    /* CONVERSION_KIND_ROW and CONVERSION_KIND_BLEND_ROW. */
+    row_kernel_t row_kernel;
+    blend_row_kernel_t blend_row_kernel;
+    uint8_t background[3];
+};
+
+/*
+ * Validates the pixel formats and selects the conversion kernel once, so executing the plan
+ * only converts rows. Doesn't allocate the scratch buffer.
+ */
+static sail_status_t init_conversion_plan(enum SailPixelFormat input_pixel_format,
+                                          enum SailPixelFormat output_pixel_format,
+                                          const struct sail_conversion_options *options,
+                                          struct sail_conversion_plan *plan) {
+
+    memset(plan, 0, sizeof(*plan));
+
+    /* Planar images are converted as a whole by convert_planar_image(). */
+    if (sail_is_planar(input_pixel_format) || sail_is_planar(output_pixel_format)) {
+        SAIL_LOG_ERROR("Conversion plans and updating don't support planar pixel formats");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    /* Block-compressed images are converted as a whole by convert_block_compressed_image(). */
+    if (sail_is_block_compressed(input_pixel_format) || sail_is_block_compressed(output_pixel_format)) {
+        SAIL_LOG_ERROR("Conversion plans and updating don't support block-compressed pixel formats");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    SAIL_TRY(verify_and_construct_rgba_indexes_verbose(output_pixel_format, &plan->pixel_consumer, &plan->r, &plan->g, &plan->b, &plan->a));
+
+    if (!sail_can_convert(input_pixel_format, output_pixel_format)) {
+        SAIL_LOG_ERROR("Conversion from %s is not currently supported", sail_pixel_format_to_string(input_pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    plan->input_pixel_format  = input_pixel_format;
+    plan->output_pixel_format = output_pixel_format;
+    plan->has_options         = options != NULL;
+
+    if (options != NULL) {
+        plan->options = *options;
+    }
+
+    const bool blend_alpha = options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA);
+
+    const struct luma_conversion *luma_conversion = find_luma_conversion(input_pixel_format, output_pixel_format);
+
+    if (luma_conversion != NULL && !(luma_conversion->has_alpha && blend_alpha)) {
+        luma_weights(options, plan->weights);
+
+        if (luma_conversion->bgr) {
+            const uint16_t r_weight = plan->weights[0];
+            plan->weights[0] = plan->weights[2];
+            plan->weights[2] = r_weight;
+        }
+
+        plan->kind            = CONVERSION_KIND_LUMA;
+        plan->luma_row_kernel = luma_row_kernel(luma_conversion->luma_row_kernel, &plan->instruction_set);
+
+        return SAIL_OK;
+    }
+
+    const struct narrow_conversion *narrow_conversion = find_narrow_conversion(input_pixel_format, output_pixel_format);
+
+    if (narrow_conversion != NULL) {
+        const bool dither = options != NULL && (options->options & SAIL_CONVERSION_OPTION_DITHER);
+
+        /*
+         * The thresholds of 128 round to the nearest integer. The ordered dithering thresholds
+         * are spread over [0; 257) like BAYER_8X8 over [0; 64).
+         */
+        for (unsigned y = 0; y < 8; y++) {
+            for (unsigned i = 0; i < SAIL_NARROW_THRESHOLDS_LENGTH; i++) {
+                const unsigned x = i / narrow_conversion->components;
+                const bool alpha = (int)(i % narrow_conversion->components) == narrow_conversion->alpha;
+
+                plan->thresholds[y][i] = (dither && !alpha) ? (uint16_t)((BAYER_8X8[y][x % 8] * 2 + 1) * 257 / 128) : 128;
+            }
+        }
+
+        plan->kind              = CONVERSION_KIND_NARROW;
+        plan->narrow_row_kernel = narrow_row_kernel(&plan->instruction_set);
+        plan->components        = narrow_conversion->components;
+
+        return SAIL_OK;
+    }
+
+    const struct row_conversion *row_conversion = find_row_conversion(input_pixel_format, output_pixel_format);
+
+    if (row_conversion != NULL) {
+        if (row_conversion->drops_alpha && blend_alpha) {
+            /* Blend kernels expect the background in the order of the input color components. */
+            const bool bgr = input_pixel_format == SAIL_PIXEL_FORMAT_BPP32_BGRA;
+
+            plan->background[0] = bgr ? options->background24.component3 : options->background24.component1;
+            plan->background[1] = options->background24.component2;
+            plan->background[2] = bgr ? options->background24.component1 : options->background24.component3;
+
+            plan->kind             = CONVERSION_KIND_BLEND_ROW;
+            plan->blend_row_kernel = blend_row_kernel(row_conversion->row_kernel, &plan->instruction_set);
+        } else {
+            plan->kind       = CONVERSION_KIND_ROW;
+            plan->row_kernel = row_kernel(row_conversion->row_kernel, &plan->instruction_set);
+        }
+
+        return SAIL_OK;
+    }
+
+    plan->kind = CONVERSION_KIND_PIXEL_CONSUMER;
+
+    return SAIL_OK;
+}
+
+/* Converts the image pixels into the output pixels of the same dimensions with the selected kernel. */
+static sail_status_t convert_with_plan_kernel(const struct sail_conversion_plan *plan,
+                                              const struct sail_image *image,
+                                              struct sail_image *image_output) {
+
+    const struct sail_conversion_options *options = plan->has_options ? &plan->options : NULL;
+    const pixel_consumer_t pixel_consumer = plan->pixel_consumer;
+
+    struct output_context output_context = { image_output, plan->r, plan->g, plan->b, plan->a, options, false, 1, plan->scratch };
+    setup_parallelism(image, options, &output_context);
+
+    switch (plan->kind) {
+        case CONVERSION_KIND_LUMA: {
+            convert_with_luma_row_kernel(image, plan->luma_row_kernel, plan->weights, &output_context);
+            return SAIL_OK;
+        }
+        case CONVERSION_KIND_NARROW: {
+            convert_with_narrow_row_kernel(image, plan->narrow_row_kernel, plan->components, plan->thresholds, &output_context);
+            return SAIL_OK;
+        }
+        case CONVERSION_KIND_ROW: {
+            convert_with_row_kernel(image, plan->row_kernel, &output_context);
+            return SAIL_OK;
+        }
+        case CONVERSION_KIND_BLEND_ROW: {
+            convert_with_blend_row_kernel(image, plan->blend_row_kernel, plan->background, &output_context);
+            return SAIL_OK;
+        }
+        case CONVERSION_KIND_PIXEL_CONSUMER: {
+            break;
+        }
+    }
+
+    /* After adding a new input pixel format, also update CONVERTIBLE_INPUTS. */
+    switch (image->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP1_INDEXED: {
+            SAIL_TRY(convert_from_bpp1_indexed(image, pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP2_INDEXED: {
+            SAIL_TRY(convert_from_bpp2_indexed(image, pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP4_INDEXED: {
+            SAIL_TRY(convert_from_bpp4_indexed(image, pixel_consumer, &output_context));
             break;
         }
         case SAIL_PIXEL_FORMAT_BPP8_INDEXED: {
@@ -784,6 +1520,34 @@ static sail_status_t conversion_impl(
             SAIL_TRY(convert_from_bpp32_ycck(image, pixel_consumer, &output_context));
             break;
         }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED: {
+            SAIL_TRY(convert_from_bpp32_rgba_premultiplied_kind(image, 0, 1, 2, 3, pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED: {
+            SAIL_TRY(convert_from_bpp32_rgba_premultiplied_kind(image, 2, 1, 0, 3, pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED: {
+            SAIL_TRY(convert_from_bpp64_rgba_premultiplied_kind(image, 0, 1, 2, 3, pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED: {
+            SAIL_TRY(convert_from_bpp64_rgba_premultiplied_kind(image, 2, 1, 0, 3, pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP48_RGB_HALF: {
+            SAIL_TRY(convert_from_bpp48_rgb_half(image, pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF: {
+            SAIL_TRY(convert_from_bpp64_rgba_half(image, pixel_consumer, &output_context));
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT: {
+            SAIL_TRY(convert_from_bpp128_rgba_float(image, pixel_consumer, &output_context));
+            break;
+        }
         default: {
             SAIL_LOG_ERROR("Conversion from %s is not currently supported", sail_pixel_format_to_string(image->pixel_format));
             SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
@@ -793,6 +1557,265 @@ static sail_status_t conversion_impl(
     return SAIL_OK;
 }
 
+static enum SailConversionKernel conversion_kernel(enum conversion_kind kind) {
+
+    switch (kind) {
+        case CONVERSION_KIND_LUMA:           return SAIL_CONVERSION_KERNEL_LUMA;
+        case CONVERSION_KIND_NARROW:         return SAIL_CONVERSION_KERNEL_NARROW;
+        case CONVERSION_KIND_ROW:            return SAIL_CONVERSION_KERNEL_ROW;
+        case CONVERSION_KIND_BLEND_ROW:      return SAIL_CONVERSION_KERNEL_BLEND_ROW;
+        case CONVERSION_KIND_PIXEL_CONSUMER: return SAIL_CONVERSION_KERNEL_PIXEL;
+    }
+
+    return SAIL_CONVERSION_KERNEL_PIXEL;
+}
+
+/* Converts the pixels with the selected kernel and counts the conversion if the conversion stats are enabled. */
+static sail_status_t apply_conversion_plan(const struct sail_conversion_plan *plan,
+                                           const struct sail_image *image,
+                                           struct sail_image *image_output) {
+
+    if (!sail_is_conversion_stats_enabled()) {
+        SAIL_TRY(convert_with_plan_kernel(plan, image, image_output));
+        return SAIL_OK;
+    }
+
+    const uint64_t started = sail_now_ns();
+
+    SAIL_TRY(convert_with_plan_kernel(plan, image, image_output));
+
+    record_conversion_stats(plan->input_pixel_format, plan->output_pixel_format, conversion_kernel(plan->kind),
+                            plan->instruction_set, (uint64_t)image->width * image->height, sail_now_ns() - started);
+
+    return SAIL_OK;
+}
+
+/*
+ * Applies the ICC profile of the image if requested and possible, and falls back to the plan kernel.
+ * The output image loses its ICC profile when the profile is applied.
+ */
+static sail_status_t execute_conversion_plan(const struct sail_conversion_plan *plan,
+                                             const struct sail_image *image,
+                                             struct sail_image *image_output) {
+
+    if (plan->has_options && (plan->options.options & SAIL_CONVERSION_OPTION_APPLY_ICCP) && image->iccp != NULL) {
+        const bool blend_alpha = plan->options.options & SAIL_CONVERSION_OPTION_BLEND_ALPHA;
+
+        struct output_context output_context = { image_output, plan->r, plan->g, plan->b, plan->a, &plan->options, false, 1, NULL };
+        setup_parallelism(image, &plan->options, &output_context);
+
+        const uint64_t started = sail_is_conversion_stats_enabled() ? sail_now_ns() : 0;
+
+        const sail_status_t status = icc_transform_to_srgb(image->iccp, image, image_output, blend_alpha,
+                                                           output_context.parallel, output_context.rows_per_chunk);
+
+        if (status == SAIL_OK) {
+            if (started != 0) {
+                record_conversion_stats(plan->input_pixel_format, plan->output_pixel_format, SAIL_CONVERSION_KERNEL_ICC,
+                                        SAIL_INSTRUCTION_SET_GENERIC, (uint64_t)image->width * image->height, sail_now_ns() - started);
+            }
+
+            sail_destroy_iccp(image_output->iccp);
+            image_output->iccp = NULL;
+
+            return SAIL_OK;
+        } else if (status != SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT && status != SAIL_ERROR_NOT_IMPLEMENTED) {
+            return status;
+        }
+
+        /* Fall back to the conversion without color management. */
+    }
+
+    SAIL_TRY(apply_conversion_plan(plan, image, image_output));
+
+    return SAIL_OK;
+}
+
+/* Allocates an image of the same size and properties with tightly packed pixels in the specified pixel format. */
+static sail_status_t alloc_output_image(const struct sail_image *image, enum SailPixelFormat output_pixel_format, struct sail_image **image_output) {
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_copy_image_skeleton(image, &image_local));
+
+    image_local->pixel_format = output_pixel_format;
+    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_check_image_skeleton_valid(image_local),
+                        /* cleanup */ sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(sail_alloc_image_pixels(image_local, image->pixels_file_backed_size > 0),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image_output = image_local;
+
+    return SAIL_OK;
+}
+
+/* Converts the image between packed pixel formats with a conversion plan. */
+static sail_status_t convert_packed_image(const struct sail_image *image,
+                                          enum SailPixelFormat output_pixel_format,
+                                          const struct sail_conversion_options *options,
+                                          struct sail_image **image_output) {
+
+    struct sail_conversion_plan plan;
+    SAIL_TRY(init_conversion_plan(image->pixel_format, output_pixel_format, options, &plan));
+
+    struct sail_image *image_local;
+    SAIL_TRY(alloc_output_image(image, output_pixel_format, &image_local));
+
+    SAIL_TRY_OR_CLEANUP(execute_conversion_plan(&plan, image, image_local),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image_output = image_local;
+
+    return SAIL_OK;
+}
+
+/*
+ * Converts the image from or into a planar pixel format. Planar formats hold the same values
+ * as BPP24-YCBCR, so they are laid out into or from BPP24-YCBCR, and other pixel formats
+ * are converted from or into BPP24-YCBCR with a conversion plan.
+ */
+static sail_status_t convert_planar_image(const struct sail_image *image,
+                                          enum SailPixelFormat output_pixel_format,
+                                          const struct sail_conversion_options *options,
+                                          struct sail_image **image_output) {
+
+    if (!sail_can_convert(image->pixel_format, output_pixel_format)) {
+        SAIL_LOG_ERROR("Conversion from %s to %s is not currently supported",
+                        sail_pixel_format_to_string(image->pixel_format), sail_pixel_format_to_string(output_pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    if (image->pixel_format == output_pixel_format) {
+        SAIL_TRY(sail_copy_image(image, image_output));
+        return SAIL_OK;
+    }
+
+    /* Fail early on odd dimensions of 4:2:0 outputs. */
+    if (sail_is_planar(output_pixel_format) && output_pixel_format != SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444
+            && (image->width % 2 != 0 || image->height % 2 != 0)) {
+        SAIL_LOG_ERROR("4:2:0 planar images must have even dimensions, but the image is %ux%u", image->width, image->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    const struct sail_image *image_ycbcr = image;
+    struct sail_image *image_ycbcr_local = NULL;
+
+    if (sail_is_planar(image->pixel_format)) {
+        SAIL_TRY(alloc_output_image(image, SAIL_PIXEL_FORMAT_BPP24_YCBCR, &image_ycbcr_local));
+        SAIL_TRY_OR_CLEANUP(planar_to_ycbcr24(image, image_ycbcr_local),
+                            /* cleanup */ sail_destroy_image(image_ycbcr_local));
+        image_ycbcr = image_ycbcr_local;
+    } else if (image->pixel_format != SAIL_PIXEL_FORMAT_BPP24_YCBCR) {
+        SAIL_TRY(convert_packed_image(image, SAIL_PIXEL_FORMAT_BPP24_YCBCR, options, &image_ycbcr_local));
+        image_ycbcr = image_ycbcr_local;
+    }
+
+    if (sail_is_planar(output_pixel_format)) {
+        struct sail_image *image_local;
+        SAIL_TRY_OR_CLEANUP(alloc_output_image(image_ycbcr, output_pixel_format, &image_local),
+                            /* cleanup */ sail_destroy_image(image_ycbcr_local));
+        SAIL_TRY_OR_CLEANUP(ycbcr24_to_planar(image_ycbcr, image_local),
+                            /* cleanup */ sail_destroy_image(image_local),
+                                          sail_destroy_image(image_ycbcr_local));
+
+        sail_destroy_image(image_ycbcr_local);
+        *image_output = image_local;
+    } else if (output_pixel_format == SAIL_PIXEL_FORMAT_BPP24_YCBCR) {
+        *image_output = image_ycbcr_local;
+    } else {
+        SAIL_TRY_OR_CLEANUP(convert_packed_image(image_ycbcr, output_pixel_format, options, image_output),
+                            /* cleanup */ sail_destroy_image(image_ycbcr_local));
+        sail_destroy_image(image_ycbcr_local);
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Converts the image from or into a block-compressed pixel format. Blocks are decoded into
+ * and encoded from BPP32-RGBA, and other pixel formats are converted from or into BPP32-RGBA.
+ */
+static sail_status_t convert_block_compressed_image(const struct sail_image *image,
+                                                    enum SailPixelFormat output_pixel_format,
+                                                    const struct sail_conversion_options *options,
+                                                    struct sail_image **image_output) {
+
+    if (!sail_can_convert(image->pixel_format, output_pixel_format)) {
+        SAIL_LOG_ERROR("Conversion from %s to %s is not currently supported",
+                        sail_pixel_format_to_string(image->pixel_format), sail_pixel_format_to_string(output_pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    if (image->pixel_format == output_pixel_format) {
+        SAIL_TRY(sail_copy_image(image, image_output));
+        return SAIL_OK;
+    }
+
+    /* Fail early on dimensions that don't consist of whole blocks. */
+    if (sail_is_block_compressed(output_pixel_format) && (image->width % 4 != 0 || image->height % 4 != 0)) {
+        SAIL_LOG_ERROR("Block-compressed images must have dimensions multiple of 4, but the image is %ux%u", image->width, image->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    const struct sail_image *image_rgba = image;
+    struct sail_image *image_rgba_local = NULL;
+
+    if (sail_is_block_compressed(image->pixel_format)) {
+        SAIL_TRY(alloc_output_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_rgba_local));
+        SAIL_TRY_OR_CLEANUP(bcn_to_rgba32(image, image_rgba_local),
+                            /* cleanup */ sail_destroy_image(image_rgba_local));
+        image_rgba = image_rgba_local;
+    } else if (sail_is_planar(image->pixel_format)) {
+        SAIL_TRY(convert_planar_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, options, &image_rgba_local));
+        image_rgba = image_rgba_local;
+    } else if (image->pixel_format != SAIL_PIXEL_FORMAT_BPP32_RGBA) {
+        SAIL_TRY(convert_packed_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, options, &image_rgba_local));
+        image_rgba = image_rgba_local;
+    }
+
+    if (sail_is_block_compressed(output_pixel_format)) {
+        struct sail_image *image_local;
+        SAIL_TRY_OR_CLEANUP(alloc_output_image(image_rgba, output_pixel_format, &image_local),
+                            /* cleanup */ sail_destroy_image(image_rgba_local));
+        SAIL_TRY_OR_CLEANUP(rgba32_to_bcn(image_rgba, image_local),
+                            /* cleanup */ sail_destroy_image(image_local),
+                                          sail_destroy_image(image_rgba_local));
+
+        sail_destroy_image(image_rgba_local);
+        *image_output = image_local;
+    } else if (output_pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA) {
+        *image_output = image_rgba_local;
+    } else if (sail_is_planar(output_pixel_format)) {
+        SAIL_TRY_OR_CLEANUP(convert_planar_image(image_rgba, output_pixel_format, options, image_output),
+                            /* cleanup */ sail_destroy_image(image_rgba_local));
+        sail_destroy_image(image_rgba_local);
+    } else {
+        SAIL_TRY_OR_CLEANUP(convert_packed_image(image_rgba, output_pixel_format, options, image_output),
+                            /* cleanup */ sail_destroy_image(image_rgba_local));
+        sail_destroy_image(image_rgba_local);
+    }
+
+    return SAIL_OK;
+}
+
+/* Converts the image without emitting a tracing span. */
+static sail_status_t convert_image(const struct sail_image *image,
+                                   enum SailPixelFormat output_pixel_format,
+                                   const struct sail_conversion_options *options,
+                                   struct sail_image **image_output) {
+
+    if (sail_is_block_compressed(image->pixel_format) || sail_is_block_compressed(output_pixel_format)) {
+        SAIL_TRY(convert_block_compressed_image(image, output_pixel_format, options, image_output));
+    } else if (sail_is_planar(image->pixel_format) || sail_is_planar(output_pixel_format)) {
+        SAIL_TRY(convert_planar_image(image, output_pixel_format, options, image_output));
+    } else {
+        SAIL_TRY(convert_packed_image(image, output_pixel_format, options, image_output));
+    }
+
+    return SAIL_OK;
+}
+
 /*
  * Public functions.
  */
@@ -814,28 +1837,99 @@ sail_status_t sail_convert_image_with_options(const struct sail_image *image,
     SAIL_TRY(sail_check_image_valid(image));
     SAIL_CHECK_PTR(image_output);
 
-    int r, g, b, a;
-    pixel_consumer_t pixel_consumer;
-    SAIL_TRY(verify_and_construct_rgba_indexes_verbose(output_pixel_format, &pixel_consumer, &r, &g, &b, &a));
+    if (sail_is_tracing_enabled()) {
+        const struct sail_trace_attributes attributes = { NULL, image->width, image->height, image->pixel_format };
+        void *span = sail_begin_trace_span("convert", &attributes);
 
-    struct sail_image *image_local;
-    SAIL_TRY(sail_copy_image_skeleton(image, &image_local));
+        const sail_status_t status = convert_image(image, output_pixel_format, options, image_output);
 
-    image_local->pixel_format = output_pixel_format;
-    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+        const struct sail_trace_attributes output_attributes = { NULL, image->width, image->height, output_pixel_format };
+        sail_end_trace_span(span, &output_attributes, status);
 
-    const size_t pixels_size = (size_t)image_local->height * image_local->bytes_per_line;
-    SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
-                        /* cleanup */ sail_destroy_image(image_local));
+        SAIL_TRY(status);
 
-    SAIL_TRY_OR_CLEANUP(conversion_impl(image, image_local, pixel_consumer, r, g, b, a, options),
-                        /* cleanup */ sail_destroy_image(image_local));
+        return SAIL_OK;
+    }
 
-    *image_output = image_local;
+    SAIL_TRY(convert_image(image, output_pixel_format, options, image_output));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_create_conversion_plan(enum SailPixelFormat input_pixel_format,
+                                          enum SailPixelFormat output_pixel_format,
+                                          const struct sail_conversion_options *options,
+                                          struct sail_conversion_plan **plan) {
+
+    SAIL_CHECK_PTR(plan);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_conversion_plan), &ptr));
+    struct sail_conversion_plan *plan_local = ptr;
+
+    SAIL_TRY_OR_CLEANUP(init_conversion_plan(input_pixel_format, output_pixel_format, options, plan_local),
+                        /* cleanup */ sail_free(plan_local));
+
+    /* Sub-byte indexes are expanded into a table of the output pixels of all 256 bytes. */
+    const unsigned bits_per_index = sail_is_indexed(input_pixel_format) ? sail_bits_per_pixel(input_pixel_format) : 8;
+
+    if (plan_local->kind == CONVERSION_KIND_PIXEL_CONSUMER && bits_per_index < 8) {
+        const size_t scratch_size = (size_t)256 * (8 / bits_per_index) * (sail_bits_per_pixel(output_pixel_format) / 8);
+
+        SAIL_TRY_OR_CLEANUP(sail_malloc(scratch_size, &ptr),
+                            /* cleanup */ sail_free(plan_local));
+        plan_local->scratch = ptr;
+    }
+
+    *plan = plan_local;
 
     return SAIL_OK;
 }
 
+sail_status_t sail_execute_conversion_plan(const struct sail_conversion_plan *plan,
+                                           const struct sail_image *image,
+                                           struct sail_image *image_output) {
+
+    SAIL_CHECK_PTR(plan);
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_TRY(sail_check_image_valid(image_output));
+
+    if (image->pixel_format != plan->input_pixel_format || image_output->pixel_format != plan->output_pixel_format) {
+        SAIL_LOG_ERROR("The plan converts %s to %s, but the images are %s and %s",
+                        sail_pixel_format_to_string(plan->input_pixel_format), sail_pixel_format_to_string(plan->output_pixel_format),
+                        sail_pixel_format_to_string(image->pixel_format), sail_pixel_format_to_string(image_output->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_PIXEL_FORMAT);
+    }
+
+    if (image->width != image_output->width || image->height != image_output->height) {
+        SAIL_LOG_ERROR("The output image is %ux%u instead of %ux%u", image_output->width, image_output->height, image->width, image->height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    if (image_output->bytes_per_line < sail_bytes_per_line(image_output->width, image_output->pixel_format)) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+    }
+
+    if (image->pixels == image_output->pixels) {
+        SAIL_LOG_ERROR("Conversion plans cannot convert pixels in place");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    SAIL_TRY(execute_conversion_plan(plan, image, image_output));
+
+    return SAIL_OK;
+}
+
+void sail_destroy_conversion_plan(struct sail_conversion_plan *plan) {
+
+    if (plan == NULL) {
+        return;
+    }
+
+    sail_free(plan->scratch);
+    sail_free(plan);
+}
+
 sail_status_t sail_update_image(struct sail_image *image, enum SailPixelFormat output_pixel_format) {
 
     SAIL_TRY(sail_update_image_with_options(image, output_pixel_format, NULL /* options */));
@@ -849,9 +1943,8 @@ sail_status_t sail_update_image_with_options(struct sail_image *image,
 
     SAIL_TRY(sail_check_image_valid(image));
 
-    int r, g, b, a;
-    pixel_consumer_t pixel_consumer;
-    SAIL_TRY(verify_and_construct_rgba_indexes_verbose(output_pixel_format, &pixel_consumer, &r, &g, &b, &a));
+    struct sail_conversion_plan plan;
+    SAIL_TRY(init_conversion_plan(image->pixel_format, output_pixel_format, options, &plan));
 
     if (image->pixel_format == output_pixel_format) {
         return SAIL_OK;
@@ -865,135 +1958,241 @@ sail_status_t sail_update_image_with_options(struct sail_image *image,
         SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
     }
 
-    SAIL_TRY(conversion_impl(image, image, pixel_consumer, r, g, b, a, options));
+    SAIL_TRY(apply_conversion_plan(&plan, image, image));
+
+    /*
+     * Rows are converted in place at their original offsets, so they can be converted in parallel.
+     * Then they are moved forward one by one to drop the unused bytes at the end of every row.
+     * Views keep the stride of their source image.
+     */
+    const unsigned bytes_per_line = sail_bytes_per_line(image->width, output_pixel_format);
+
+    if (bytes_per_line < image->bytes_per_line && !image->pixels_borrowed) {
+        uint8_t *pixels = image->pixels;
+
+        for (unsigned row = 1; row < image->height; row++) {
+            memmove(pixels + (size_t)row * bytes_per_line, pixels + (size_t)row * image->bytes_per_line, bytes_per_line);
+        }
+
+        image->bytes_per_line = bytes_per_line;
+    }
 
     image->pixel_format = output_pixel_format;
 
     return SAIL_OK;
 }
 
-bool sail_can_convert(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
+sail_status_t sail_apply_iccp(struct sail_image *image) {
 
-    /* After adding a new input pixel format, also update the switch in conversion_impl(). */
-    switch (input_pixel_format) {
-        case SAIL_PIXEL_FORMAT_BPP1_INDEXED:
-        case SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE:
-        case SAIL_PIXEL_FORMAT_BPP2_INDEXED:
-        case SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE:
-        case SAIL_PIXEL_FORMAT_BPP4_INDEXED:
-        case SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE:
-        case SAIL_PIXEL_FORMAT_BPP8_INDEXED:
-        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:
-        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE:
-        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA:
-        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA:
-        case SAIL_PIXEL_FORMAT_BPP16_RGB555:
-        case SAIL_PIXEL_FORMAT_BPP16_BGR555:
-        case SAIL_PIXEL_FORMAT_BPP16_RGB565:
-        case SAIL_PIXEL_FORMAT_BPP16_BGR565:
-        case SAIL_PIXEL_FORMAT_BPP24_RGB:
-        case SAIL_PIXEL_FORMAT_BPP24_BGR:
-        case SAIL_PIXEL_FORMAT_BPP48_RGB:
-        case SAIL_PIXEL_FORMAT_BPP48_BGR:
-        case SAIL_PIXEL_FORMAT_BPP32_RGBX:
-        case SAIL_PIXEL_FORMAT_BPP32_BGRX:
-        case SAIL_PIXEL_FORMAT_BPP32_XRGB:
-        case SAIL_PIXEL_FORMAT_BPP32_XBGR:
-        case SAIL_PIXEL_FORMAT_BPP32_RGBA:
-        case SAIL_PIXEL_FORMAT_BPP32_BGRA:
-        case SAIL_PIXEL_FORMAT_BPP32_ARGB:
-        case SAIL_PIXEL_FORMAT_BPP32_ABGR:
-        case SAIL_PIXEL_FORMAT_BPP64_RGBX:
-        case SAIL_PIXEL_FORMAT_BPP64_BGRX:
-        case SAIL_PIXEL_FORMAT_BPP64_XRGB:
-        case SAIL_PIXEL_FORMAT_BPP64_XBGR:
-        case SAIL_PIXEL_FORMAT_BPP64_RGBA:
-        case SAIL_PIXEL_FORMAT_BPP64_BGRA:
-        case SAIL_PIXEL_FORMAT_BPP64_ARGB:
-        case SAIL_PIXEL_FORMAT_BPP64_ABGR:
-        case SAIL_PIXEL_FORMAT_BPP32_CMYK:
-        case SAIL_PIXEL_FORMAT_BPP24_YCBCR: {
-            int r, g, b, a;
-            pixel_consumer_t pixel_consumer;
-            return verify_and_construct_rgba_indexes_silent(output_pixel_format, &pixel_consumer, &r, &g, &b, &a);
-        }
-        default: {
-            return false;
-        }
-    }
-}
+    SAIL_TRY(sail_check_image_valid(image));
 
-/* Sorted by priority. */
-static const enum SailPixelFormat GRAYSCALE_CANDIDATES[] = {
+    if (image->iccp == NULL) {
+        return SAIL_OK;
+    }
 
-    /* After adding a new output pixel format, also update this list. */
-    SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
-    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+    struct output_context output_context = { image, 0, 0, 0, 0, NULL, false, 1, NULL };
+    setup_parallelism(image, NULL /* options */, &output_context);
 
-    SAIL_PIXEL_FORMAT_BPP24_YCBCR,
+    SAIL_TRY(icc_transform_to_srgb(image->iccp, image, image, false /* blend alpha */,
+                                   output_context.parallel, output_context.rows_per_chunk));
 
-    SAIL_PIXEL_FORMAT_BPP24_RGB,
-    SAIL_PIXEL_FORMAT_BPP24_BGR,
+    sail_destroy_iccp(image->iccp);
+    image->iccp = NULL;
 
-    SAIL_PIXEL_FORMAT_BPP48_RGB,
-    SAIL_PIXEL_FORMAT_BPP48_BGR,
+    return SAIL_OK;
+}
 
-    SAIL_PIXEL_FORMAT_BPP32_RGBA,
-    SAIL_PIXEL_FORMAT_BPP32_BGRA,
-    SAIL_PIXEL_FORMAT_BPP32_ARGB,
-    SAIL_PIXEL_FORMAT_BPP32_ABGR,
-    SAIL_PIXEL_FORMAT_BPP32_RGBX,
-    SAIL_PIXEL_FORMAT_BPP32_BGRX,
-    SAIL_PIXEL_FORMAT_BPP32_XRGB,
-    SAIL_PIXEL_FORMAT_BPP32_XBGR,
+/* Every pixel format fits into this number of table entries. */
+#define PIXEL_FORMATS_COUNT (SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT + 1)
 
-    SAIL_PIXEL_FORMAT_BPP64_RGBA,
-    SAIL_PIXEL_FORMAT_BPP64_BGRA,
-    SAIL_PIXEL_FORMAT_BPP64_ARGB,
-    SAIL_PIXEL_FORMAT_BPP64_ABGR,
-    SAIL_PIXEL_FORMAT_BPP64_RGBX,
-    SAIL_PIXEL_FORMAT_BPP64_BGRX,
-    SAIL_PIXEL_FORMAT_BPP64_XRGB,
-    SAIL_PIXEL_FORMAT_BPP64_XBGR,
+/*
+ * Pixel formats that can be converted from. Any of them can be converted into any convertible output pixel format,
+ * so these two tables make up the whole conversion matrix.
+ */
+static const bool CONVERTIBLE_INPUTS[PIXEL_FORMATS_COUNT] = {
+
+    /* After adding a new input pixel format, also update the switch in convert_with_plan_kernel(). */
+    [SAIL_PIXEL_FORMAT_BPP1_INDEXED]          = true,
+    [SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE]        = true,
+    [SAIL_PIXEL_FORMAT_BPP2_INDEXED]          = true,
+    [SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE]        = true,
+    [SAIL_PIXEL_FORMAT_BPP4_INDEXED]          = true,
+    [SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE]        = true,
+    [SAIL_PIXEL_FORMAT_BPP8_INDEXED]          = true,
+    [SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE]        = true,
+    [SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE]       = true,
+    [SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA] = true,
+    [SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA] = true,
+    [SAIL_PIXEL_FORMAT_BPP16_RGB555]          = true,
+    [SAIL_PIXEL_FORMAT_BPP16_BGR555]          = true,
+    [SAIL_PIXEL_FORMAT_BPP16_RGB565]          = true,
+    [SAIL_PIXEL_FORMAT_BPP16_BGR565]          = true,
+    [SAIL_PIXEL_FORMAT_BPP24_RGB]             = true,
+    [SAIL_PIXEL_FORMAT_BPP24_BGR]             = true,
+    [SAIL_PIXEL_FORMAT_BPP48_RGB]             = true,
+    [SAIL_PIXEL_FORMAT_BPP48_BGR]             = true,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_XRGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_XBGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_ARGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_ABGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_XRGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_XBGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_ARGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_ABGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_CMYK]            = true,
+    [SAIL_PIXEL_FORMAT_BPP24_YCBCR]           = true,
+    [SAIL_PIXEL_FORMAT_BPP32_YCCK]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED] = true,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED] = true,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED] = true,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED] = true,
+    [SAIL_PIXEL_FORMAT_BPP48_RGB_HALF]        = true,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF]       = true,
+    [SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT]     = true,
 };
 
-static const size_t GRAYSCALE_CANDIDATES_LENGTH = sizeof(GRAYSCALE_CANDIDATES) / sizeof(GRAYSCALE_CANDIDATES[0]);
+/* Pixel formats that can be converted into. Must match verify_and_construct_rgba_indexes_silent(). */
+static const bool CONVERTIBLE_OUTPUTS[PIXEL_FORMATS_COUNT] = {
+
+    [SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE]        = true,
+    [SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE]       = true,
+    [SAIL_PIXEL_FORMAT_BPP24_RGB]             = true,
+    [SAIL_PIXEL_FORMAT_BPP24_BGR]             = true,
+    [SAIL_PIXEL_FORMAT_BPP48_RGB]             = true,
+    [SAIL_PIXEL_FORMAT_BPP48_BGR]             = true,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_XRGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_XBGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_ARGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP32_ABGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRX]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_XRGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_XBGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_ARGB]            = true,
+    [SAIL_PIXEL_FORMAT_BPP64_ABGR]            = true,
+    [SAIL_PIXEL_FORMAT_BPP24_YCBCR]           = true,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED] = true,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED] = true,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED] = true,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED] = true,
+    [SAIL_PIXEL_FORMAT_BPP48_RGB_HALF]        = true,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF]       = true,
+    [SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT]     = true,
+};
 
-/* Sorted by priority. */
-static const enum SailPixelFormat INDEXED_OR_FULL_COLOR_CANDIDATES[] = {
+bool sail_can_convert(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format) {
 
-    /* After adding a new output pixel format, also update this list. */
-    SAIL_PIXEL_FORMAT_BPP24_YCBCR,
+    /* Block-compressed pixel formats are converted through BPP32-RGBA. See convert_block_compressed_image(). */
+    if (sail_is_block_compressed(input_pixel_format) || sail_is_block_compressed(output_pixel_format)) {
+        if (input_pixel_format == output_pixel_format) {
+            return true;
+        }
+        if (sail_is_block_compressed(input_pixel_format) && !bcn_can_decode(input_pixel_format)) {
+            return false;
+        }
 
-    SAIL_PIXEL_FORMAT_BPP24_RGB,
-    SAIL_PIXEL_FORMAT_BPP24_BGR,
+        return sail_can_convert(sail_is_block_compressed(input_pixel_format)  ? SAIL_PIXEL_FORMAT_BPP32_RGBA : input_pixel_format,
+                                sail_is_block_compressed(output_pixel_format) ? SAIL_PIXEL_FORMAT_BPP32_RGBA : output_pixel_format);
+    }
 
-    SAIL_PIXEL_FORMAT_BPP48_RGB,
-    SAIL_PIXEL_FORMAT_BPP48_BGR,
+    /* Planar pixel formats are converted through BPP24-YCBCR. See convert_planar_image(). */
+    if (sail_is_planar(input_pixel_format) || sail_is_planar(output_pixel_format)) {
+        return sail_can_convert(sail_is_planar(input_pixel_format)  ? SAIL_PIXEL_FORMAT_BPP24_YCBCR : input_pixel_format,
+                                sail_is_planar(output_pixel_format) ? SAIL_PIXEL_FORMAT_BPP24_YCBCR : output_pixel_format);
+    }
 
-    SAIL_PIXEL_FORMAT_BPP32_RGBA,
-    SAIL_PIXEL_FORMAT_BPP32_BGRA,
-    SAIL_PIXEL_FORMAT_BPP32_ARGB,
-    SAIL_PIXEL_FORMAT_BPP32_ABGR,
-    SAIL_PIXEL_FORMAT_BPP32_RGBX,
-    SAIL_PIXEL_FORMAT_BPP32_BGRX,
-    SAIL_PIXEL_FORMAT_BPP32_XRGB,
-    SAIL_PIXEL_FORMAT_BPP32_XBGR,
+    if ((unsigned)input_pixel_format >= PIXEL_FORMATS_COUNT || (unsigned)output_pixel_format >= PIXEL_FORMATS_COUNT) {
+        return false;
+    }
 
-    SAIL_PIXEL_FORMAT_BPP64_RGBA,
-    SAIL_PIXEL_FORMAT_BPP64_BGRA,
-    SAIL_PIXEL_FORMAT_BPP64_ARGB,
-    SAIL_PIXEL_FORMAT_BPP64_ABGR,
-    SAIL_PIXEL_FORMAT_BPP64_RGBX,
-    SAIL_PIXEL_FORMAT_BPP64_BGRX,
-    SAIL_PIXEL_FORMAT_BPP64_XRGB,
-    SAIL_PIXEL_FORMAT_BPP64_XBGR,
+    return CONVERTIBLE_INPUTS[input_pixel_format] && CONVERTIBLE_OUTPUTS[output_pixel_format];
+}
 
-    SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
-    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+/*
+ * Priorities of the output pixel formats starting with 1, the highest one. 0 means the pixel format is not a candidate.
+ * After adding a new output pixel format, also update these tables.
+ */
+static const uint8_t GRAYSCALE_PRIORITIES[PIXEL_FORMATS_COUNT] = {
+
+    [SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE]        = 1,
+    [SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE]       = 2,
+    [SAIL_PIXEL_FORMAT_BPP24_YCBCR]           = 3,
+    [SAIL_PIXEL_FORMAT_BPP24_RGB]             = 4,
+    [SAIL_PIXEL_FORMAT_BPP24_BGR]             = 5,
+    [SAIL_PIXEL_FORMAT_BPP48_RGB]             = 6,
+    [SAIL_PIXEL_FORMAT_BPP48_BGR]             = 7,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA]            = 8,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA]            = 9,
+    [SAIL_PIXEL_FORMAT_BPP32_ARGB]            = 10,
+    [SAIL_PIXEL_FORMAT_BPP32_ABGR]            = 11,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBX]            = 12,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRX]            = 13,
+    [SAIL_PIXEL_FORMAT_BPP32_XRGB]            = 14,
+    [SAIL_PIXEL_FORMAT_BPP32_XBGR]            = 15,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA]            = 16,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA]            = 17,
+    [SAIL_PIXEL_FORMAT_BPP64_ARGB]            = 18,
+    [SAIL_PIXEL_FORMAT_BPP64_ABGR]            = 19,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBX]            = 20,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRX]            = 21,
+    [SAIL_PIXEL_FORMAT_BPP64_XRGB]            = 22,
+    [SAIL_PIXEL_FORMAT_BPP64_XBGR]            = 23,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED] = 24,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED] = 25,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED] = 26,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED] = 27,
+    [SAIL_PIXEL_FORMAT_BPP48_RGB_HALF]        = 28,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF]       = 29,
+    [SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT]     = 30,
 };
 
-static const size_t INDEXED_OR_FULL_COLOR_CANDIDATES_LENGTH = sizeof(INDEXED_OR_FULL_COLOR_CANDIDATES) / sizeof(INDEXED_OR_FULL_COLOR_CANDIDATES[0]);
+static const uint8_t INDEXED_OR_FULL_COLOR_PRIORITIES[PIXEL_FORMATS_COUNT] = {
+
+    [SAIL_PIXEL_FORMAT_BPP24_YCBCR]           = 1,
+    [SAIL_PIXEL_FORMAT_BPP24_RGB]             = 2,
+    [SAIL_PIXEL_FORMAT_BPP24_BGR]             = 3,
+    [SAIL_PIXEL_FORMAT_BPP48_RGB]             = 4,
+    [SAIL_PIXEL_FORMAT_BPP48_BGR]             = 5,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA]            = 6,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA]            = 7,
+    [SAIL_PIXEL_FORMAT_BPP32_ARGB]            = 8,
+    [SAIL_PIXEL_FORMAT_BPP32_ABGR]            = 9,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBX]            = 10,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRX]            = 11,
+    [SAIL_PIXEL_FORMAT_BPP32_XRGB]            = 12,
+    [SAIL_PIXEL_FORMAT_BPP32_XBGR]            = 13,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA]            = 14,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA]            = 15,
+    [SAIL_PIXEL_FORMAT_BPP64_ARGB]            = 16,
+    [SAIL_PIXEL_FORMAT_BPP64_ABGR]            = 17,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBX]            = 18,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRX]            = 19,
+    [SAIL_PIXEL_FORMAT_BPP64_XRGB]            = 20,
+    [SAIL_PIXEL_FORMAT_BPP64_XBGR]            = 21,
+    [SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE]        = 22,
+    [SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE]       = 23,
+    [SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED] = 24,
+    [SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED] = 25,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED] = 26,
+    [SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED] = 27,
+    [SAIL_PIXEL_FORMAT_BPP48_RGB_HALF]        = 28,
+    [SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF]       = 29,
+    [SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT]     = 30,
+};
 
 enum SailPixelFormat sail_closest_pixel_format(enum SailPixelFormat input_pixel_format,
                                                const enum SailPixelFormat pixel_formats[],
@@ -1003,36 +2202,30 @@ enum SailPixelFormat sail_closest_pixel_format(enum SailPixelFormat input_pixel_
         return SAIL_PIXEL_FORMAT_UNKNOWN;
     }
 
-    const enum SailPixelFormat *candidates;
-    size_t candidates_length;
+    const uint8_t *priorities = sail_is_grayscale(input_pixel_format) ? GRAYSCALE_PRIORITIES : INDEXED_OR_FULL_COLOR_PRIORITIES;
 
-    if (sail_is_grayscale(input_pixel_format)) {
-        candidates = GRAYSCALE_CANDIDATES;
-        candidates_length = GRAYSCALE_CANDIDATES_LENGTH;
-    } else {
-        candidates = INDEXED_OR_FULL_COLOR_CANDIDATES;
-        candidates_length = INDEXED_OR_FULL_COLOR_CANDIDATES_LENGTH;
-    }
-
-    size_t best_index_candidate = UINT_MAX;
-    size_t best_index_result = 0;
-    bool found = false;
+    enum SailPixelFormat best_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN;
+    unsigned best_priority = UINT_MAX;
 
-    /* O(n^2) (sic!). */
     for (size_t i = 0; i < pixel_formats_length; i++) {
-        for (size_t k = 0; k < candidates_length; k++) {
-            if (pixel_formats[i] == candidates[k]) {
-                if (k < best_index_candidate) {
-                    best_index_candidate = k;
-                    best_index_result = i;
-                    found = true;
-                    break;
-                }
-            }
+        /* The input pixel format is the closest one, and it doesn't need any conversion. */
+        if (pixel_formats[i] == input_pixel_format) {
+            return input_pixel_format;
+        }
+
+        if ((unsigned)pixel_formats[i] >= PIXEL_FORMATS_COUNT) {
+            continue;
+        }
+
+        const unsigned priority = priorities[pixel_formats[i]];
+
+        if (priority > 0 && priority < best_priority) {
+            best_pixel_format = pixel_formats[i];
+            best_priority = priority;
         }
     }
 
-    return found ? pixel_formats[best_index_result] : SAIL_PIXEL_FORMAT_UNKNOWN;
+    return best_pixel_format;
 }
 
 enum SailPixelFormat sail_closest_pixel_format_from_save_features(enum SailPixelFormat input_pixel_format, const struct sail_save_features *save_features) {
@@ -1058,6 +2251,30 @@ sail_status_t sail_convert_image_for_saving_with_options(const struct sail_image
     SAIL_CHECK_PTR(save_features);
     SAIL_CHECK_PTR(image_output);
 
+    if (options != NULL && (options->options & SAIL_CONVERSION_OPTION_DOWNGRADE)) {
+        struct sail_image_analysis analysis;
+        enum SailPixelFormat lossless_pixel_format = SAIL_PIXEL_FORMAT_UNKNOWN;
+
+        if (sail_analyze_image(image, &analysis) == SAIL_OK) {
+            lossless_pixel_format = lossless_pixel_format_for_saving(image->pixel_format, &analysis, save_features);
+        }
+
+        if (lossless_pixel_format == image->pixel_format) {
+            SAIL_TRY(sail_copy_image(image, image_output));
+            return SAIL_OK;
+        } else if (sail_is_indexed(lossless_pixel_format)) {
+            SAIL_TRY(palettize_image(image, &analysis, lossless_pixel_format, image_output));
+            return SAIL_OK;
+        } else if (lossless_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
+            /* Dithering would change the exact values. */
+            struct sail_conversion_options options_local = *options;
+            options_local.options &= ~SAIL_CONVERSION_OPTION_DITHER;
+
+            SAIL_TRY(sail_convert_image_with_options(image, lossless_pixel_format, &options_local, image_output));
+            return SAIL_OK;
+        }
+    }
+
     enum SailPixelFormat best_pixel_format = sail_closest_pixel_format_from_save_features(image->pixel_format, save_features);
 
     if (best_pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN) {
@@ -38,6 +38,7 @@ extern "C" {
 #endif
 
 struct sail_conversion_options;
+struct sail_conversion_plan;
 struct sail_image;
 struct sail_save_features;
 
@@ -48,9 +49,9 @@ struct sail_save_features;
  * when converting RGBA pixels to RGB. If you need to control this behavior,
  * use sail_convert_image_with_options().
  *
- * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
- * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
- * instructions (like AVX or SSE) are used.
+ * Common conversions between RGB, BGR, RGBA, BGRA, premultiplied RGBA and BGRA, grayscale, YCbCr,
+ * CMYK, and YCCK pixels use row kernels with SSSE3, AVX2, or NEON instructions when available.
+ * Other conversions go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
  *
  * The image ICC profile is not involved in the conversion procedure.
  *
@@ -58,7 +59,7 @@ struct sail_save_features;
  * the original image.
  *
  * Allowed input pixel formats:
- *   - Anything except LUV and LAB
+ *   - Anything except LUV, LAB, and BC7
  *
  * Allowed output pixel formats:
  *   - SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE
@@ -90,6 +91,38 @@ struct sail_save_features;
  *
  *   - SAIL_PIXEL_FORMAT_BPP24_YCBCR
  *
+ *   - SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP48_RGB_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420
+ *   - SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12
+ *   - SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP4_BC1
+ *   - SAIL_PIXEL_FORMAT_BPP8_BC2
+ *   - SAIL_PIXEL_FORMAT_BPP8_BC3
+ *   - SAIL_PIXEL_FORMAT_BPP4_BC4
+ *   - SAIL_PIXEL_FORMAT_BPP8_BC5
+ *   - SAIL_PIXEL_FORMAT_BPP8_BC7
+ *
+ * Planar pixel formats are converted through BPP24-YCBCR. 4:2:0 chroma samples are replicated
+ * when converting from them and averaged when converting into them.
+ *
+ * Block-compressed pixel formats are decoded and encoded through BPP32-RGBA in multiple threads.
+ * BC1 encodes pixels with alpha below 128 as transparent. BC4 is decoded into gray pixels and
+ * encoded from the red channel. BC5 is decoded into red and green and encoded from them.
+ * BC7 is encoded in mode 6, and it cannot be decoded.
+ *
+ * Half precision and floating point components have the nominal [0; 1] range. They are converted
+ * through 16-bit components, so HDR values above 1 are clamped unless converting between
+ * BPP64-RGBA-HALF and BPP128-RGBA-FLOAT.
+ *
  * Returns SAIL_OK on success.
  */
 SAIL_EXPORT sail_status_t sail_convert_image(const struct sail_image *image,
@@ -101,17 +134,22 @@ SAIL_EXPORT sail_status_t sail_convert_image(const struct sail_image *image,
  *
  * Options (which may be NULL) control the conversion behavior.
  *
- * The conversion procedure may be slow. It converts every pixel into the BPP32-RGBA or
- * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
- * instructions (like AVX or SSE) are used.
+ * Common conversions between RGB, BGR, RGBA, BGRA, premultiplied RGBA and BGRA, grayscale, YCbCr,
+ * CMYK, and YCCK pixels use row kernels with SSSE3, AVX2, or NEON instructions when available.
+ * Other conversions go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
  *
- * The image ICC profile (if any) is not involved into the conversion procedure.
+ * The image ICC profile (if any) is not involved into the conversion procedure unless
+ * the options have SAIL_CONVERSION_OPTION_APPLY_ICCP. In that case, pixels are transformed from
+ * the ICC profile into sRGB and converted into the output pixel format in a single pass with
+ * Little CMS, and the output image gets no ICC profile. The input pixel format and the profile
+ * color space must match, and the output pixel format must be RGB. Otherwise, or if SAIL
+ * is compiled without color management, the option is ignored.
  *
  * The resulting image gets updated pixel format and bytes per line. Other properties are copied from
  * the original image.
  *
  * Allowed input pixel formats:
- *   - Anything except LUV and LAB
+ *   - Anything except LUV, LAB, and BC7
  *
  * Allowed output pixel formats:
  *   - SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE
@@ -143,6 +181,38 @@ SAIL_EXPORT sail_status_t sail_convert_image(const struct sail_image *image,
  *
  *   - SAIL_PIXEL_FORMAT_BPP24_YCBCR
  *
+ *   - SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP48_RGB_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420
+ *   - SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12
+ *   - SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP4_BC1
+ *   - SAIL_PIXEL_FORMAT_BPP8_BC2
+ *   - SAIL_PIXEL_FORMAT_BPP8_BC3
+ *   - SAIL_PIXEL_FORMAT_BPP4_BC4
+ *   - SAIL_PIXEL_FORMAT_BPP8_BC5
+ *   - SAIL_PIXEL_FORMAT_BPP8_BC7
+ *
+ * Planar pixel formats are converted through BPP24-YCBCR. 4:2:0 chroma samples are replicated
+ * when converting from them and averaged when converting into them.
+ *
+ * Block-compressed pixel formats are decoded and encoded through BPP32-RGBA in multiple threads.
+ * BC1 encodes pixels with alpha below 128 as transparent. BC4 is decoded into gray pixels and
+ * encoded from the red channel. BC5 is decoded into red and green and encoded from them.
+ * BC7 is encoded in mode 6, and it cannot be decoded.
+ *
+ * Half precision and floating point components have the nominal [0; 1] range. They are converted
+ * through 16-bit components, so HDR values above 1 are clamped unless converting between
+ * BPP64-RGBA-HALF and BPP128-RGBA-FLOAT.
+ *
  * Returns SAIL_OK on success.
  */
 SAIL_EXPORT sail_status_t sail_convert_image_with_options(const struct sail_image *image,
@@ -150,6 +220,50 @@ SAIL_EXPORT sail_status_t sail_convert_image_with_options(const struct sail_imag
                                                           const struct sail_conversion_options *options,
                                                           struct sail_image **image_output);
 
+/*
+ * Creates a plan to convert images of the input pixel format to the output pixel format with
+ * the specified options. The options are copied and can be NULL. See sail_convert_image_with_options()
+ * for the supported pixel formats. Planar pixel formats are not supported.
+ *
+ * The plan validates the pixel formats, selects the conversion kernel, and allocates scratch buffers
+ * once, so executing it for many images of the same pixel format, like animation frames, only converts
+ * the rows. Executing it gives the same pixels as sail_convert_image_with_options().
+ *
+ * Typical usage: sail_create_conversion_plan()  ->
+ *                sail_execute_conversion_plan() ->
+ *                ...                            ->
+ *                sail_destroy_conversion_plan().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_create_conversion_plan(enum SailPixelFormat input_pixel_format,
+                                                      enum SailPixelFormat output_pixel_format,
+                                                      const struct sail_conversion_options *options,
+                                                      struct sail_conversion_plan **plan);
+
+/*
+ * Converts the pixels of the input image into the pixels of the existing output image with the plan.
+ * The images must have the pixel formats of the plan and the same dimensions. The output pixels
+ * must be allocated, so the same output image can be reused for every input image. For example,
+ * convert the first image with sail_convert_image_with_options() and the next ones into its result.
+ *
+ * Only the output pixels are written. If the plan options have SAIL_CONVERSION_OPTION_APPLY_ICCP
+ * and the input ICC profile is applied, the output ICC profile is destroyed. Other output properties
+ * stay as is.
+ *
+ * A plan has scratch buffers, so it must not be executed in multiple threads at once.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_execute_conversion_plan(const struct sail_conversion_plan *plan,
+                                                       const struct sail_image *image,
+                                                       struct sail_image *image_output);
+
+/*
+ * Destroys the specified conversion plan. Does nothing if the plan is NULL.
+ */
+SAIL_EXPORT void sail_destroy_conversion_plan(struct sail_conversion_plan *plan);
+
 /*
  * Updates the image to the pixel format. If the function fails, the image pixels
  * may be left partially converted.
@@ -158,16 +272,19 @@ SAIL_EXPORT sail_status_t sail_convert_image_with_options(const struct sail_imag
  * when converting RGBA pixels to RGB. If you need to control this behavior,
  * use sail_update_image_with_options().
  *
- * Doesn't reallocate pixels. For example, when updating 100x100 BPP32-RGBA image
+ * Doesn't reallocate pixels and converts them in place, so the peak memory usage doesn't grow.
+ * Rows are packed with the new bytes per line. For example, when updating 100x100 BPP32-RGBA image
  * to BPP24-RGB, the resulting pixel data will have 10'000 unused bytes at the end.
+ * Planar pixel formats are not supported.
  *
- * The updating procedure may be slow. It converts every pixel into the BPP32-RGBA or
- * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
- * instructions (like AVX or SSE) are used.
+ * Common updates between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+ * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other updates
+ * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
  *
  * The image ICC profile (if any) is not involved into the conversion procedure.
  *
  * The image gets updated pixel format and bytes per line. Other properties stay as is.
+ * Views made with sail_image_view() are updated in place and keep the stride of their source image.
  *
  * Allowed input pixel formats:
  *   - Anything that produces equal or smaller image except LUV and LAB which are not supported
@@ -202,6 +319,15 @@ SAIL_EXPORT sail_status_t sail_convert_image_with_options(const struct sail_imag
  *
  *   - SAIL_PIXEL_FORMAT_BPP24_YCBCR
  *
+ *   - SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP48_RGB_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT
+ *
  * Returns SAIL_OK on success.
  */
 SAIL_EXPORT sail_status_t sail_update_image(struct sail_image *image, enum SailPixelFormat output_pixel_format);
@@ -212,16 +338,19 @@ SAIL_EXPORT sail_status_t sail_update_image(struct sail_image *image, enum SailP
  *
  * Options (which may be NULL) control the conversion behavior.
  *
- * Doesn't reallocate pixels. For example, when updating 100x100 BPP32-RGBA image
+ * Doesn't reallocate pixels and converts them in place, so the peak memory usage doesn't grow.
+ * Rows are packed with the new bytes per line. For example, when updating 100x100 BPP32-RGBA image
  * to BPP24-RGB, the resulting pixel data will have 10'000 unused bytes at the end.
+ * Planar pixel formats are not supported.
  *
- * The updating procedure may be slow. It converts every pixel into the BPP32-RGBA or
- * BPP64-RGBA formats first, and only then to the requested output format. No platform-specific
- * instructions (like AVX or SSE) are used.
+ * Common updates between RGB, BGR, RGBA, BGRA, grayscale, YCbCr, CMYK, and YCCK pixels
+ * use row kernels with SSSE3, AVX2, or NEON instructions when available. Other updates
+ * go through BPP32-RGBA or BPP64-RGBA pixels and may be slow.
  *
  * The image ICC profile (if any) is not involved into the conversion procedure.
  *
  * The image gets updated pixel format and bytes per line. Other properties stay as is.
+ * Views made with sail_image_view() are updated in place and keep the stride of their source image.
  *
  * Allowed input pixel formats:
  *   - Anything that produces equal or smaller image except LUV and LAB which are not supported
@@ -256,12 +385,37 @@ SAIL_EXPORT sail_status_t sail_update_image(struct sail_image *image, enum SailP
  *
  *   - SAIL_PIXEL_FORMAT_BPP24_YCBCR
  *
+ *   - SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED
+ *   - SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED
+ *
+ *   - SAIL_PIXEL_FORMAT_BPP48_RGB_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF
+ *   - SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT
+ *
  * Returns SAIL_OK on success.
  */
 SAIL_EXPORT sail_status_t sail_update_image_with_options(struct sail_image *image,
                                                          enum SailPixelFormat output_pixel_format,
                                                          const struct sail_conversion_options *options);
 
+/*
+ * Transforms the image pixels from the image ICC profile into sRGB in place and destroys the profile.
+ * Does nothing if the image has no ICC profile. Transforms are built with Little CMS once per profile
+ * and pixel format, and cached. Large images are transformed in multiple threads with OpenMP.
+ *
+ * Allowed pixel formats:
+ *   - Grayscale, RGB, and CMYK formats with 8 or 16 bits per component that match the profile
+ *     color space. Grayscale and CMYK images must be converted to RGB first, or with
+ *     sail_convert_image_with_options() and SAIL_CONVERSION_OPTION_APPLY_ICCP in a single pass.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NOT_IMPLEMENTED if SAIL is compiled without color management.
+ * Returns SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT if the pixel format is not supported.
+ */
+SAIL_EXPORT sail_status_t sail_apply_iccp(struct sail_image *image);
+
 /*
  * Returns true if the conversion or updating functions can convert or update from the input
  * pixel format to the output pixel format.
@@ -269,7 +423,8 @@ SAIL_EXPORT sail_status_t sail_update_image_with_options(struct sail_image *imag
 SAIL_EXPORT bool sail_can_convert(enum SailPixelFormat input_pixel_format, enum SailPixelFormat output_pixel_format);
 
 /*
- * Returns the closest pixel format to the input pixel format from the list.
+ * Returns the closest pixel format to the input pixel format from the list. If the list contains
+ * the input pixel format itself, it's returned, so images are saved without conversion.
  *
  * This function can be used to find the best pixel format to save an image into.
  *
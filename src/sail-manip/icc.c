@@ -0,0 +1,327 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-manip/sail-manip.h>
+
+#ifdef SAIL_HAVE_LCMS2
+
+#include <lcms2.h>
+
+#ifdef SAIL_WIN32
+    #include <Windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+/*
+ * Private functions.
+ */
+
+/* Every cached transform keeps its profile parsed, so keep the cache small. */
+#define TRANSFORMS_CACHE_SIZE 16
+
+struct cached_transform {
+
+    uint64_t profile_hash;
+    size_t profile_size;
+    cmsUInt32Number input_format;
+    cmsUInt32Number output_format;
+    cmsHTRANSFORM transform;
+    unsigned users;      /* Threads using the transform right now. It's not evicted while used. */
+    uint64_t last_used;
+};
+
+static struct cached_transform transforms_cache[TRANSFORMS_CACHE_SIZE];
+static uint64_t transforms_cache_clock;
+
+#ifdef SAIL_WIN32
+    static SRWLOCK transforms_cache_lock = SRWLOCK_INIT;
+
+    static void lock_transforms_cache(void)   { AcquireSRWLockExclusive(&transforms_cache_lock); }
+    static void unlock_transforms_cache(void) { ReleaseSRWLockExclusive(&transforms_cache_lock); }
+#else
+    static pthread_mutex_t transforms_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+    static void lock_transforms_cache(void)   { pthread_mutex_lock(&transforms_cache_lock); }
+    static void unlock_transforms_cache(void) { pthread_mutex_unlock(&transforms_cache_lock); }
+#endif
+
+/* FNV-1a. */
+static uint64_t hash_profile(const void *data, size_t size) {
+
+    const uint8_t *bytes = data;
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static cmsUInt32Number lcms_pixel_format(enum SailPixelFormat pixel_format) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE:        return TYPE_GRAY_8;
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE:       return TYPE_GRAY_16;
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA: return TYPE_GRAYA_8;
+        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: return TYPE_GRAYA_16;
+
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:             return TYPE_RGB_8;
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:             return TYPE_BGR_8;
+        case SAIL_PIXEL_FORMAT_BPP48_RGB:             return TYPE_RGB_16;
+        case SAIL_PIXEL_FORMAT_BPP48_BGR:             return TYPE_BGR_16;
+
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX:
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:            return TYPE_RGBA_8;
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA:            return TYPE_BGRA_8;
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB:
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB:            return TYPE_ARGB_8;
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR:
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR:            return TYPE_ABGR_8;
+
+        case SAIL_PIXEL_FORMAT_BPP64_RGBX:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA:            return TYPE_RGBA_16;
+        case SAIL_PIXEL_FORMAT_BPP64_BGRX:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA:            return TYPE_BGRA_16;
+        case SAIL_PIXEL_FORMAT_BPP64_XRGB:
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB:            return TYPE_ARGB_16;
+        case SAIL_PIXEL_FORMAT_BPP64_XBGR:
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR:            return TYPE_ABGR_16;
+
+        case SAIL_PIXEL_FORMAT_BPP32_CMYK:            return TYPE_CMYK_8;
+        case SAIL_PIXEL_FORMAT_BPP64_CMYK:            return TYPE_CMYK_16;
+
+        default: {
+            return 0;
+        }
+    }
+}
+
+static bool profile_matches_pixel_format(cmsHPROFILE profile, cmsUInt32Number format) {
+
+    switch (cmsGetColorSpace(profile)) {
+        case cmsSigGrayData: return T_COLORSPACE(format) == PT_GRAY;
+        case cmsSigRgbData:  return T_COLORSPACE(format) == PT_RGB;
+        case cmsSigCmykData: return T_COLORSPACE(format) == PT_CMYK;
+
+        default: {
+            return false;
+        }
+    }
+}
+
+static sail_status_t create_transform(const struct sail_iccp *iccp, cmsUInt32Number input_format, cmsUInt32Number output_format,
+                                      cmsHTRANSFORM *transform) {
+
+    cmsHPROFILE input_profile = cmsOpenProfileFromMem(iccp->data, (cmsUInt32Number)iccp->size);
+
+    if (input_profile == NULL) {
+        SAIL_LOG_ERROR("Failed to parse the ICC profile");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    if (!profile_matches_pixel_format(input_profile, input_format)) {
+        cmsCloseProfile(input_profile);
+        SAIL_LOG_ERROR("The ICC profile color space doesn't match the pixel format");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    cmsHPROFILE output_profile = cmsCreate_sRGBProfile();
+
+    /* Transforms without the one-pixel cache can be used by multiple threads at once. */
+    const cmsUInt32Number flags = cmsFLAGS_NOCACHE | ((T_EXTRA(input_format) > 0 && T_EXTRA(output_format) > 0) ? cmsFLAGS_COPY_ALPHA : 0);
+
+    *transform = cmsCreateTransform(input_profile, input_format, output_profile, output_format, INTENT_PERCEPTUAL, flags);
+
+    cmsCloseProfile(output_profile);
+    cmsCloseProfile(input_profile);
+
+    if (*transform == NULL) {
+        SAIL_LOG_ERROR("Failed to create a color transform from the ICC profile");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    return SAIL_OK;
+}
+
+/* Returns a cached or a new transform. Every successful call must be followed by release_transform(). */
+static sail_status_t acquire_transform(const struct sail_iccp *iccp, cmsUInt32Number input_format, cmsUInt32Number output_format,
+                                       cmsHTRANSFORM *transform) {
+
+    const uint64_t profile_hash = hash_profile(iccp->data, iccp->size);
+
+    lock_transforms_cache();
+
+    for (unsigned i = 0; i < TRANSFORMS_CACHE_SIZE; i++) {
+        struct cached_transform *cached = &transforms_cache[i];
+
+        if (cached->transform != NULL && cached->profile_hash == profile_hash && cached->profile_size == iccp->size
+                && cached->input_format == input_format && cached->output_format == output_format) {
+            cached->users++;
+            cached->last_used = ++transforms_cache_clock;
+            *transform = cached->transform;
+
+            unlock_transforms_cache();
+            return SAIL_OK;
+        }
+    }
+
+    unlock_transforms_cache();
+
+    /* Build the transform without holding the lock as it takes a while. */
+    cmsHTRANSFORM transform_local;
+    SAIL_TRY(create_transform(iccp, input_format, output_format, &transform_local));
+
+    lock_transforms_cache();
+
+    /* Replace the least recently used transform that is not in use. */
+    struct cached_transform *victim = NULL;
+
+    for (unsigned i = 0; i < TRANSFORMS_CACHE_SIZE; i++) {
+        struct cached_transform *cached = &transforms_cache[i];
+
+        if (cached->users == 0 && (victim == NULL || cached->last_used < victim->last_used)) {
+            victim = cached;
+        }
+    }
+
+    if (victim != NULL) {
+        if (victim->transform != NULL) {
+            cmsDeleteTransform(victim->transform);
+        }
+
+        victim->profile_hash  = profile_hash;
+        victim->profile_size  = iccp->size;
+        victim->input_format  = input_format;
+        victim->output_format = output_format;
+        victim->transform     = transform_local;
+        victim->users         = 1;
+        victim->last_used     = ++transforms_cache_clock;
+    }
+
+    unlock_transforms_cache();
+
+    /* All the cached transforms are in use, release_transform() deletes this one. */
+    *transform = transform_local;
+
+    return SAIL_OK;
+}
+
+static void release_transform(cmsHTRANSFORM transform) {
+
+    lock_transforms_cache();
+
+    for (unsigned i = 0; i < TRANSFORMS_CACHE_SIZE; i++) {
+        if (transforms_cache[i].transform == transform) {
+            transforms_cache[i].users--;
+
+            unlock_transforms_cache();
+            return;
+        }
+    }
+
+    unlock_transforms_cache();
+
+    cmsDeleteTransform(transform);
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t icc_transform_to_srgb(const struct sail_iccp *iccp,
+                                    const struct sail_image *image,
+                                    struct sail_image *image_output,
+                                    bool blend_alpha,
+                                    bool parallel,
+                                    int rows_per_chunk) {
+
+    const cmsUInt32Number input_format  = lcms_pixel_format(image->pixel_format);
+    const cmsUInt32Number output_format = lcms_pixel_format(image_output->pixel_format);
+
+    /* Alpha is copied, or dropped when the output has no alpha. */
+    if (input_format == 0 || output_format == 0 || T_COLORSPACE(output_format) != PT_RGB
+            || (T_EXTRA(output_format) > 0 && T_EXTRA(input_format) == 0)
+            || (blend_alpha && T_EXTRA(input_format) > 0 && T_EXTRA(output_format) == 0)) {
+        SAIL_LOG_DEBUG("Color transform from %s to %s is not supported",
+                       sail_pixel_format_to_string(image->pixel_format), sail_pixel_format_to_string(image_output->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    cmsHTRANSFORM transform;
+    SAIL_TRY(acquire_transform(iccp, input_format, output_format, &transform));
+
+    const unsigned chunks = (image->height + rows_per_chunk - 1) / rows_per_chunk;
+    unsigned chunk;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) if (parallel) num_threads(sail_thread_pool_size())
+    for (chunk = 0; chunk < chunks; chunk++) {
+        const unsigned first_row = chunk * rows_per_chunk;
+        const unsigned rows      = SAIL_MIN((unsigned)rows_per_chunk, image->height - first_row);
+
+        cmsDoTransformLineStride(transform,
+                                 sail_scan_line(image, first_row),
+                                 sail_scan_line(image_output, first_row),
+                                 image->width,
+                                 rows,
+                                 image->bytes_per_line,
+                                 image_output->bytes_per_line,
+                                 0,
+                                 0);
+    }
+
+    release_transform(transform);
+
+    return SAIL_OK;
+}
+
+#else
+
+sail_status_t icc_transform_to_srgb(const struct sail_iccp *iccp,
+                                    const struct sail_image *image,
+                                    struct sail_image *image_output,
+                                    bool blend_alpha,
+                                    bool parallel,
+                                    int rows_per_chunk) {
+
+    (void)iccp;
+    (void)image;
+    (void)image_output;
+    (void)blend_alpha;
+    (void)parallel;
+    (void)rows_per_chunk;
+
+    SAIL_LOG_DEBUG("SAIL is compiled without color management");
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+}
+
+#endif
@@ -0,0 +1,56 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ICC_H
+#define SAIL_ICC_H
+
+#include <stdbool.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_iccp;
+struct sail_image;
+
+/*
+ * Transforms the input image pixels from the ICC profile into sRGB and saves them in the output image
+ * of the same dimensions. The images can be the same object when their pixel formats are the same.
+ * Transforms are built once per profile and pair of pixel formats, and cached. Alpha is copied
+ * or dropped if the output pixel format has no alpha. When 'blend_alpha' is true, transforms
+ * that drop alpha are not supported, so the caller can blend it instead.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NOT_IMPLEMENTED if SAIL is compiled without color management.
+ * Returns SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT if Little CMS cannot transform between the pixel formats
+ * or the profile color space doesn't match the input pixel format.
+ */
+SAIL_HIDDEN sail_status_t icc_transform_to_srgb(const struct sail_iccp *iccp,
+                                                const struct sail_image *image,
+                                                struct sail_image *image_output,
+                                                bool blend_alpha,
+                                                bool parallel,
+                                                int rows_per_chunk);
+
+#endif
@@ -0,0 +1,648 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h> /* jpeglib.h needs FILE */
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+#ifdef SAIL_HAVE_JPEG_TRANSCODING
+
+#include <setjmp.h>
+
+#include <jerror.h>
+#include <jpeglib.h>
+
+#define IO_BUFFER_SIZE (64 * 1024)
+
+#define EXIF_ORIENTATION_TAG 0x0112
+
+/*
+ * A transform of DCT blocks. Every orientation is a transposition (optional)
+ * followed by horizontal and vertical flips (optional).
+ */
+struct block_transform {
+
+    bool transpose;
+    bool flip_x;
+    bool flip_y;
+};
+
+struct transcode_error_context {
+
+    struct jpeg_error_mgr jpeg_error_mgr;
+    jmp_buf *setjmp_buffer;
+};
+
+struct source_mgr {
+
+    struct jpeg_source_mgr pub;
+    struct sail_io *io;
+    JOCTET *buffer;
+};
+
+struct destination_mgr {
+
+    struct jpeg_destination_mgr pub;
+    struct sail_io *io;
+    JOCTET *buffer;
+};
+
+/*
+ * Error handling.
+ */
+static void output_message(j_common_ptr cinfo) {
+
+    char buffer[JMSG_LENGTH_MAX];
+
+    (*cinfo->err->format_message)(cinfo, buffer);
+
+    SAIL_LOG_ERROR("JPEG: %s", buffer);
+}
+
+static void error_exit(j_common_ptr cinfo) {
+
+    struct transcode_error_context *error_context = (struct transcode_error_context *)cinfo->err;
+
+    (*cinfo->err->output_message)(cinfo);
+
+    longjmp(*error_context->setjmp_buffer, 1);
+}
+
+/*
+ * Source manager reading from a SAIL I/O stream.
+ */
+static void init_source(j_decompress_ptr cinfo) {
+
+    (void)cinfo;
+}
+
+static boolean fill_input_buffer(j_decompress_ptr cinfo) {
+
+    struct source_mgr *src = (struct source_mgr *)cinfo->src;
+    size_t nbytes;
+
+    if (src->io->tolerant_read(src->io->stream, src->buffer, IO_BUFFER_SIZE, &nbytes) != SAIL_OK || nbytes == 0) {
+        WARNMS(cinfo, JWRN_JPEG_EOF);
+
+        /* Insert a fake EOI marker. */
+        src->buffer[0] = (JOCTET)0xFF;
+        src->buffer[1] = (JOCTET)JPEG_EOI;
+        nbytes = 2;
+    }
+
+    src->pub.next_input_byte = src->buffer;
+    src->pub.bytes_in_buffer = nbytes;
+
+    return TRUE;
+}
+
+static void skip_input_data(j_decompress_ptr cinfo, long num_bytes) {
+
+    struct jpeg_source_mgr *src = cinfo->src;
+
+    if (num_bytes > 0) {
+        while (num_bytes > (long)src->bytes_in_buffer) {
+            num_bytes -= (long)src->bytes_in_buffer;
+            (void)(*src->fill_input_buffer)(cinfo);
+        }
+
+        src->next_input_byte += (size_t)num_bytes;
+        src->bytes_in_buffer -= (size_t)num_bytes;
+    }
+}
+
+static void term_source(j_decompress_ptr cinfo) {
+
+    (void)cinfo;
+}
+
+static void set_source(j_decompress_ptr cinfo, struct sail_io *io) {
+
+    struct source_mgr *src = (*cinfo->mem->alloc_small)((j_common_ptr)cinfo, JPOOL_PERMANENT, sizeof(struct source_mgr));
+
+    src->buffer                = (*cinfo->mem->alloc_small)((j_common_ptr)cinfo, JPOOL_PERMANENT, IO_BUFFER_SIZE);
+    src->io                    = io;
+    src->pub.init_source       = init_source;
+    src->pub.fill_input_buffer = fill_input_buffer;
+    src->pub.skip_input_data   = skip_input_data;
+    src->pub.resync_to_restart = jpeg_resync_to_restart;
+    src->pub.term_source       = term_source;
+    src->pub.bytes_in_buffer   = 0;
+    src->pub.next_input_byte   = NULL;
+
+    cinfo->src = &src->pub;
+}
+
+/*
+ * Destination manager writing into a SAIL I/O stream.
+ */
+static void init_destination(j_compress_ptr cinfo) {
+
+    struct destination_mgr *dest = (struct destination_mgr *)cinfo->dest;
+
+    dest->pub.next_output_byte = dest->buffer;
+    dest->pub.free_in_buffer   = IO_BUFFER_SIZE;
+}
+
+static boolean empty_output_buffer(j_compress_ptr cinfo) {
+
+    struct destination_mgr *dest = (struct destination_mgr *)cinfo->dest;
+
+    if (dest->io->strict_write(dest->io->stream, dest->buffer, IO_BUFFER_SIZE) != SAIL_OK) {
+        ERREXIT(cinfo, JERR_FILE_WRITE);
+    }
+
+    dest->pub.next_output_byte = dest->buffer;
+    dest->pub.free_in_buffer   = IO_BUFFER_SIZE;
+
+    return TRUE;
+}
+
+static void term_destination(j_compress_ptr cinfo) {
+
+    struct destination_mgr *dest = (struct destination_mgr *)cinfo->dest;
+    const size_t datacount = IO_BUFFER_SIZE - dest->pub.free_in_buffer;
+
+    if (datacount > 0 && dest->io->strict_write(dest->io->stream, dest->buffer, datacount) != SAIL_OK) {
+        ERREXIT(cinfo, JERR_FILE_WRITE);
+    }
+
+    if (dest->io->flush(dest->io->stream) != SAIL_OK) {
+        ERREXIT(cinfo, JERR_FILE_WRITE);
+    }
+}
+
+static void set_destination(j_compress_ptr cinfo, struct sail_io *io) {
+
+    struct destination_mgr *dest = (*cinfo->mem->alloc_small)((j_common_ptr)cinfo, JPOOL_PERMANENT, sizeof(struct destination_mgr));
+
+    dest->buffer                  = (*cinfo->mem->alloc_small)((j_common_ptr)cinfo, JPOOL_PERMANENT, IO_BUFFER_SIZE);
+    dest->io                      = io;
+    dest->pub.init_destination    = init_destination;
+    dest->pub.empty_output_buffer = empty_output_buffer;
+    dest->pub.term_destination    = term_destination;
+
+    cinfo->dest = &dest->pub;
+}
+
+/*
+ * Transforms.
+ */
+static bool orientation_to_block_transform(enum SailOrientation orientation, struct block_transform *transform) {
+
+    switch (orientation) {
+        case SAIL_ORIENTATION_NORMAL:                             { *transform = (struct block_transform){ false, false, false }; return true; }
+        case SAIL_ORIENTATION_ROTATED_90:                         { *transform = (struct block_transform){ true,  true,  false }; return true; }
+        case SAIL_ORIENTATION_ROTATED_180:                        { *transform = (struct block_transform){ false, true,  true  }; return true; }
+        case SAIL_ORIENTATION_ROTATED_270:                        { *transform = (struct block_transform){ true,  false, true  }; return true; }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY:              { *transform = (struct block_transform){ false, true,  false }; return true; }
+        case SAIL_ORIENTATION_MIRRORED_VERTICALLY:                { *transform = (struct block_transform){ false, false, true  }; return true; }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90:   { *transform = (struct block_transform){ true,  true,  true  }; return true; }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270:  { *transform = (struct block_transform){ true,  false, false }; return true; }
+    }
+
+    return false;
+}
+
+/* Returns the transform applying 'first' and then 'second'. */
+static struct block_transform compose_block_transforms(struct block_transform first, struct block_transform second) {
+
+    /* Transposing swaps the axes of the flips that precede it. */
+    struct block_transform result = {
+        first.transpose != second.transpose,
+        second.flip_x != (second.transpose ? first.flip_y : first.flip_x),
+        second.flip_y != (second.transpose ? first.flip_x : first.flip_y),
+    };
+
+    return result;
+}
+
+static bool is_identity_block_transform(struct block_transform transform) {
+
+    return !transform.transpose && !transform.flip_x && !transform.flip_y;
+}
+
+/*
+ * Flipping a block negates its odd horizontal or vertical frequencies.
+ */
+static void transform_block(const JCOEF *src, JCOEF *dst, struct block_transform transform) {
+
+    for (unsigned v = 0; v < DCTSIZE; v++) {
+        for (unsigned u = 0; u < DCTSIZE; u++) {
+            const JCOEF coef = transform.transpose ? src[u * DCTSIZE + v] : src[v * DCTSIZE + u];
+            const bool negate = (transform.flip_x && (u & 1)) != (transform.flip_y && (v & 1));
+
+            dst[v * DCTSIZE + u] = negate ? (JCOEF)-coef : coef;
+        }
+    }
+}
+
+static JDIMENSION round_up(JDIMENSION value, JDIMENSION multiple) {
+
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+/*
+ * Requests coefficient arrays for the transformed image. Must be called before jpeg_read_coefficients()
+ * which realizes virtual arrays. The arrays are zeroed, as libjpeg reads complete iMCUs and only
+ * the blocks inside the image are transformed.
+ */
+static jvirt_barray_ptr* request_transformed_coefficients(j_decompress_ptr src_context, struct block_transform transform) {
+
+    jvirt_barray_ptr *coef_arrays = (*src_context->mem->alloc_small)((j_common_ptr)src_context,
+                                                                     JPOOL_IMAGE,
+                                                                     sizeof(jvirt_barray_ptr) * (size_t)src_context->num_components);
+
+    for (int ci = 0; ci < src_context->num_components; ci++) {
+        const jpeg_component_info *component = src_context->comp_info + ci;
+
+        const JDIMENSION width  = round_up(component->width_in_blocks,  (JDIMENSION)component->h_samp_factor);
+        const JDIMENSION height = round_up(component->height_in_blocks, (JDIMENSION)component->v_samp_factor);
+
+        coef_arrays[ci] = (*src_context->mem->request_virt_barray)((j_common_ptr)src_context,
+                                                                   JPOOL_IMAGE,
+                                                                   TRUE,
+                                                                   transform.transpose ? height : width,
+                                                                   transform.transpose ? width : height,
+                                                                   (JDIMENSION)(transform.transpose ? component->h_samp_factor
+                                                                                                    : component->v_samp_factor));
+    }
+
+    return coef_arrays;
+}
+
+/*
+ * Transposes the sampling factors and quantization tables, and trims partial iMCUs at the edges
+ * that are flipped. Returns false if nothing is left.
+ */
+static bool transform_critical_parameters(j_compress_ptr dst_context, struct block_transform transform) {
+
+    if (transform.transpose) {
+        const JDIMENSION width = dst_context->image_width;
+        dst_context->image_width  = dst_context->image_height;
+        dst_context->image_height = width;
+
+        for (int ci = 0; ci < dst_context->num_components; ci++) {
+            jpeg_component_info *component = dst_context->comp_info + ci;
+
+            const int h_samp_factor = component->h_samp_factor;
+            component->h_samp_factor = component->v_samp_factor;
+            component->v_samp_factor = h_samp_factor;
+        }
+
+        for (int i = 0; i < NUM_QUANT_TBLS; i++) {
+            JQUANT_TBL *table = dst_context->quant_tbl_ptrs[i];
+
+            if (table == NULL) {
+                continue;
+            }
+
+            for (unsigned v = 0; v < DCTSIZE; v++) {
+                for (unsigned u = v + 1; u < DCTSIZE; u++) {
+                    const UINT16 value = table->quantval[v * DCTSIZE + u];
+                    table->quantval[v * DCTSIZE + u] = table->quantval[u * DCTSIZE + v];
+                    table->quantval[u * DCTSIZE + v] = value;
+                }
+            }
+        }
+    }
+
+    int max_h_samp_factor = 1;
+    int max_v_samp_factor = 1;
+
+    for (int ci = 0; ci < dst_context->num_components; ci++) {
+        max_h_samp_factor = SAIL_MAX(max_h_samp_factor, dst_context->comp_info[ci].h_samp_factor);
+        max_v_samp_factor = SAIL_MAX(max_v_samp_factor, dst_context->comp_info[ci].v_samp_factor);
+    }
+
+    const JDIMENSION imcu_width  = (JDIMENSION)max_h_samp_factor * DCTSIZE;
+    const JDIMENSION imcu_height = (JDIMENSION)max_v_samp_factor * DCTSIZE;
+
+    if (transform.flip_x) {
+        dst_context->image_width = dst_context->image_width / imcu_width * imcu_width;
+    }
+    if (transform.flip_y) {
+        dst_context->image_height = dst_context->image_height / imcu_height * imcu_height;
+    }
+
+#if JPEG_LIB_VERSION >= 80
+    dst_context->jpeg_width  = dst_context->image_width;
+    dst_context->jpeg_height = dst_context->image_height;
+#endif
+
+    return dst_context->image_width > 0 && dst_context->image_height > 0;
+}
+
+/*
+ * Moves the blocks into the transformed positions. Must be called after jpeg_write_coefficients()
+ * which computes the component dimensions of the transformed image. The trimmed dimensions are
+ * multiples of iMCUs, so every flipped block has a source block.
+ */
+static void transform_coefficients(j_decompress_ptr src_context,
+                                   jvirt_barray_ptr *src_coef_arrays,
+                                   j_compress_ptr dst_context,
+                                   jvirt_barray_ptr *dst_coef_arrays,
+                                   struct block_transform transform) {
+
+    for (int ci = 0; ci < dst_context->num_components; ci++) {
+        const jpeg_component_info *component = dst_context->comp_info + ci;
+
+        for (JDIMENSION dst_y = 0; dst_y < component->height_in_blocks; dst_y++) {
+            JBLOCKROW dst_row = (*src_context->mem->access_virt_barray)((j_common_ptr)src_context,
+                                                                        dst_coef_arrays[ci],
+                                                                        dst_y,
+                                                                        1,
+                                                                        TRUE)[0];
+
+            const JDIMENSION y = transform.flip_y ? component->height_in_blocks - 1 - dst_y : dst_y;
+
+            if (transform.transpose) {
+                for (JDIMENSION dst_x = 0; dst_x < component->width_in_blocks; dst_x++) {
+                    const JDIMENSION x = transform.flip_x ? component->width_in_blocks - 1 - dst_x : dst_x;
+
+                    JBLOCKROW src_row = (*src_context->mem->access_virt_barray)((j_common_ptr)src_context,
+                                                                                src_coef_arrays[ci],
+                                                                                x,
+                                                                                1,
+                                                                                FALSE)[0];
+
+                    transform_block(src_row[y], dst_row[dst_x], transform);
+                }
+            } else {
+                JBLOCKROW src_row = (*src_context->mem->access_virt_barray)((j_common_ptr)src_context,
+                                                                            src_coef_arrays[ci],
+                                                                            y,
+                                                                            1,
+                                                                            FALSE)[0];
+
+                for (JDIMENSION dst_x = 0; dst_x < component->width_in_blocks; dst_x++) {
+                    const JDIMENSION x = transform.flip_x ? component->width_in_blocks - 1 - dst_x : dst_x;
+
+                    transform_block(src_row[x], dst_row[dst_x], transform);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Markers.
+ */
+static bool marker_has_signature(jpeg_saved_marker_ptr marker, int code, const char *signature, size_t length) {
+
+    return marker->marker == code && marker->data_length >= length && memcmp(marker->data, signature, length) == 0;
+}
+
+static unsigned read_exif_uint16(const JOCTET *data, bool big_endian) {
+
+    return big_endian ? ((unsigned)data[0] << 8) | data[1] : ((unsigned)data[1] << 8) | data[0];
+}
+
+static unsigned long read_exif_uint32(const JOCTET *data, bool big_endian) {
+
+    return big_endian
+        ? ((unsigned long)data[0] << 24) | ((unsigned long)data[1] << 16) | ((unsigned long)data[2] << 8) | data[3]
+        : ((unsigned long)data[3] << 24) | ((unsigned long)data[2] << 16) | ((unsigned long)data[1] << 8) | data[0];
+}
+
+/*
+ * Returns a pointer to the 16-bit orientation value in the first IFD of the EXIF marker,
+ * or NULL if there is no orientation.
+ */
+static JOCTET* exif_orientation(jpeg_saved_marker_ptr marker, bool *big_endian) {
+
+    if (!marker_has_signature(marker, JPEG_APP0 + 1, "Exif\0\0", 6) || marker->data_length < 6 + 8) {
+        return NULL;
+    }
+
+    JOCTET *tiff = marker->data + 6;
+    const unsigned long tiff_length = marker->data_length - 6;
+
+    if (memcmp(tiff, "MM", 2) == 0) {
+        *big_endian = true;
+    } else if (memcmp(tiff, "II", 2) == 0) {
+        *big_endian = false;
+    } else {
+        return NULL;
+    }
+
+    if (read_exif_uint16(tiff + 2, *big_endian) != 42) {
+        return NULL;
+    }
+
+    const unsigned long ifd = read_exif_uint32(tiff + 4, *big_endian);
+
+    if (ifd > tiff_length - 2) {
+        return NULL;
+    }
+
+    const unsigned entries = read_exif_uint16(tiff + ifd, *big_endian);
+
+    for (unsigned i = 0; i < entries; i++) {
+        const unsigned long entry = ifd + 2 + i * 12UL;
+
+        if (entry + 12 > tiff_length) {
+            break;
+        }
+
+        if (read_exif_uint16(tiff + entry, *big_endian) == EXIF_ORIENTATION_TAG) {
+            /* SHORT */
+            return read_exif_uint16(tiff + entry + 2, *big_endian) == 3 ? tiff + entry + 8 : NULL;
+        }
+    }
+
+    return NULL;
+}
+
+static enum SailOrientation exif_orientation_to_orientation(unsigned exif_orientation) {
+
+    /* Orientation that displays the image correctly. */
+    switch (exif_orientation) {
+        case 2:  return SAIL_ORIENTATION_MIRRORED_HORIZONTALLY;
+        case 3:  return SAIL_ORIENTATION_ROTATED_180;
+        case 4:  return SAIL_ORIENTATION_MIRRORED_VERTICALLY;
+        case 5:  return SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270;
+        case 6:  return SAIL_ORIENTATION_ROTATED_90;
+        case 7:  return SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90;
+        case 8:  return SAIL_ORIENTATION_ROTATED_270;
+        default: return SAIL_ORIENTATION_NORMAL;
+    }
+}
+
+static void write_markers(j_decompress_ptr src_context, j_compress_ptr dst_context, int options) {
+
+    for (jpeg_saved_marker_ptr marker = src_context->marker_list; marker != NULL; marker = marker->next) {
+        /* libjpeg writes these markers itself. */
+        if (dst_context->write_JFIF_header && marker_has_signature(marker, JPEG_APP0, "JFIF\0", 5)) {
+            continue;
+        }
+        if (dst_context->write_Adobe_marker && marker_has_signature(marker, JPEG_APP0 + 14, "Adobe", 5)) {
+            continue;
+        }
+
+        if (marker_has_signature(marker, JPEG_APP0 + 2, "ICC_PROFILE\0", 12)) {
+            if (options & SAIL_JPEG_TRANSCODE_OPTION_STRIP_ICCP) {
+                continue;
+            }
+        } else if (options & SAIL_JPEG_TRANSCODE_OPTION_STRIP_META_DATA) {
+            continue;
+        }
+
+        bool big_endian;
+        JOCTET *orientation;
+
+        if ((options & SAIL_JPEG_TRANSCODE_OPTION_AUTO_ORIENT) && (orientation = exif_orientation(marker, &big_endian)) != NULL) {
+            orientation[0] = big_endian ? 0 : 1;
+            orientation[1] = big_endian ? 1 : 0;
+        }
+
+        jpeg_write_marker(dst_context, marker->marker, marker->data, marker->data_length);
+    }
+}
+
+static enum SailOrientation saved_exif_orientation(j_decompress_ptr src_context) {
+
+    for (jpeg_saved_marker_ptr marker = src_context->marker_list; marker != NULL; marker = marker->next) {
+        bool big_endian;
+        const JOCTET *orientation = exif_orientation(marker, &big_endian);
+
+        if (orientation != NULL) {
+            return exif_orientation_to_orientation(read_exif_uint16(orientation, big_endian));
+        }
+    }
+
+    return SAIL_ORIENTATION_NORMAL;
+}
+
+#endif
+
+/*
+ * Public functions.
+ */
+sail_status_t sail_transcode_jpeg(struct sail_io *input, struct sail_io *output, enum SailOrientation orientation, int options) {
+
+    SAIL_CHECK_PTR(input);
+    SAIL_CHECK_PTR(output);
+
+#ifdef SAIL_HAVE_JPEG_TRANSCODING
+    struct block_transform transform;
+
+    if (!orientation_to_block_transform(orientation, &transform)) {
+        SAIL_LOG_ERROR("JPEG: Unknown orientation %d", orientation);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct jpeg_decompress_struct src_context;
+    struct jpeg_compress_struct dst_context;
+    struct transcode_error_context src_error_context;
+    struct transcode_error_context dst_error_context;
+    jmp_buf setjmp_buffer;
+
+    memset(&src_context, 0, sizeof(src_context));
+    memset(&dst_context, 0, sizeof(dst_context));
+
+    src_context.err = jpeg_std_error(&src_error_context.jpeg_error_mgr);
+    src_error_context.jpeg_error_mgr.error_exit     = error_exit;
+    src_error_context.jpeg_error_mgr.output_message = output_message;
+    src_error_context.setjmp_buffer                 = &setjmp_buffer;
+
+    dst_context.err = jpeg_std_error(&dst_error_context.jpeg_error_mgr);
+    dst_error_context.jpeg_error_mgr.error_exit     = error_exit;
+    dst_error_context.jpeg_error_mgr.output_message = output_message;
+    dst_error_context.setjmp_buffer                 = &setjmp_buffer;
+
+    if (setjmp(setjmp_buffer) != 0) {
+        jpeg_destroy_compress(&dst_context);
+        jpeg_destroy_decompress(&src_context);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNDERLYING_CODEC);
+    }
+
+    jpeg_create_decompress(&src_context);
+    jpeg_create_compress(&dst_context);
+
+    set_source(&src_context, input);
+    set_destination(&dst_context, output);
+
+    jpeg_save_markers(&src_context, JPEG_COM, 0xFFFF);
+    for (int i = 0; i < 16; i++) {
+        jpeg_save_markers(&src_context, JPEG_APP0 + i, 0xFFFF);
+    }
+
+    (void)jpeg_read_header(&src_context, TRUE);
+
+    if (options & SAIL_JPEG_TRANSCODE_OPTION_AUTO_ORIENT) {
+        struct block_transform exif_transform;
+        orientation_to_block_transform(saved_exif_orientation(&src_context), &exif_transform);
+
+        transform = compose_block_transforms(exif_transform, transform);
+    }
+
+    const bool transformed = !is_identity_block_transform(transform);
+    jvirt_barray_ptr *dst_coef_arrays = transformed ? request_transformed_coefficients(&src_context, transform) : NULL;
+
+    jvirt_barray_ptr *src_coef_arrays = jpeg_read_coefficients(&src_context);
+
+    jpeg_copy_critical_parameters(&src_context, &dst_context);
+
+    if (transformed && !transform_critical_parameters(&dst_context, transform)) {
+        SAIL_LOG_ERROR("JPEG: The image is too small to be flipped without partial blocks");
+        jpeg_destroy_compress(&dst_context);
+        jpeg_destroy_decompress(&src_context);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    }
+
+    if (options & SAIL_JPEG_TRANSCODE_OPTION_PROGRESSIVE) {
+        jpeg_simple_progression(&dst_context);
+    }
+    if (options & SAIL_JPEG_TRANSCODE_OPTION_OPTIMIZE_CODING) {
+        dst_context.optimize_coding = TRUE;
+    }
+
+    jpeg_write_coefficients(&dst_context, transformed ? dst_coef_arrays : src_coef_arrays);
+
+    write_markers(&src_context, &dst_context, options);
+
+    if (transformed) {
+        transform_coefficients(&src_context, src_coef_arrays, &dst_context, dst_coef_arrays, transform);
+    }
+
+    jpeg_finish_compress(&dst_context);
+    (void)jpeg_finish_decompress(&src_context);
+
+    jpeg_destroy_compress(&dst_context);
+    jpeg_destroy_decompress(&src_context);
+
+    return SAIL_OK;
+#else
+    (void)orientation;
+    (void)options;
+
+    SAIL_LOG_ERROR("SAIL is compiled without JPEG transcoding");
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+#endif
+}
@@ -0,0 +1,101 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_JPEG_TRANSCODE_H
+#define SAIL_JPEG_TRANSCODE_H
+
+#include <sail-common/common.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_io;
+
+/*
+ * Options to control lossless JPEG transcoding. See sail_transcode_jpeg().
+ */
+enum SailJpegTranscodeOption {
+
+    /* Write a progressive JPEG. Otherwise, a baseline JPEG is written. */
+    SAIL_JPEG_TRANSCODE_OPTION_PROGRESSIVE     = 1 << 0,
+
+    /* Compute optimal Huffman tables. Makes baseline files smaller at the cost of an extra pass. */
+    SAIL_JPEG_TRANSCODE_OPTION_OPTIMIZE_CODING = 1 << 1,
+
+    /* Drop comments, EXIF, XMP, and other APPn markers except ICC profiles. */
+    SAIL_JPEG_TRANSCODE_OPTION_STRIP_META_DATA = 1 << 2,
+
+    /* Drop ICC profiles. */
+    SAIL_JPEG_TRANSCODE_OPTION_STRIP_ICCP      = 1 << 3,
+
+    /*
+     * Apply the EXIF orientation before the orientation passed to sail_transcode_jpeg(),
+     * and reset the EXIF orientation to normal.
+     */
+    SAIL_JPEG_TRANSCODE_OPTION_AUTO_ORIENT     = 1 << 4,
+};
+
+/*
+ * Reads a JPEG image from the input I/O stream and writes it into the output I/O stream
+ * without decoding pixels. DCT coefficients are copied, or moved for the specified orientation,
+ * so the transcoding is lossless and much cheaper than loading and saving the image. This is
+ * the jpegtran functionality of libjpeg.
+ *
+ * The orientation is applied as sail_rotate() and sail_mirror() do: SAIL_ORIENTATION_ROTATED_90 rotates
+ * the image clockwise, SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90 mirrors it horizontally and then
+ * rotates clockwise, etc. Flipping moves the partial blocks at the right or bottom edge to the opposite
+ * edge where they cannot be stored, so these partial blocks are trimmed like 'jpegtran -trim' does.
+ * Transforms that don't flip the image, like SAIL_ORIENTATION_NORMAL, keep all the pixels.
+ *
+ * Options is an or-ed set of SailJpegTranscodeOption-s. Meta data and ICC profiles are copied
+ * as is unless they are stripped. libjpeg writes its own JFIF and Adobe markers.
+ *
+ * Typical usage: sail_alloc_io_read_file()             ->
+ *                sail_alloc_io_write_growable_memory() ->
+ *                sail_transcode_jpeg()                 ->
+ *                sail_take_io_growable_memory_buffer() ->
+ *                sail_destroy_io()                     ->
+ *                sail_destroy_io().
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NOT_IMPLEMENTED if SAIL is compiled without JPEG transcoding.
+ * Returns SAIL_ERROR_INVALID_ARGUMENT if the orientation is not known.
+ * Returns SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS if the image is trimmed to nothing.
+ * Returns SAIL_ERROR_UNDERLYING_CODEC if libjpeg fails to read or write the image.
+ */
+SAIL_EXPORT sail_status_t sail_transcode_jpeg(struct sail_io *input,
+                                              struct sail_io *output,
+                                              enum SailOrientation orientation,
+                                              int options);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -47,8 +47,91 @@ enum SailConversionOption {
      * Formula:
      *   opacity = alpha / max_alpha (to convert to [0, 1])
      *   output_pixel = opacity * input_pixel + (1 - opacity) * background
+     *
+     * The result is rounded to the nearest integer.
      */
     SAIL_CONVERSION_OPTION_BLEND_ALPHA = 1 << 1,
+
+    /*
+     * Transform the pixels from the image ICC profile into sRGB in the same pass as the conversion.
+     * The output image gets no ICC profile then. Requires SAIL compiled with color management
+     * (Little CMS 2) and an RGB output pixel format. Otherwise, the image is converted as usual
+     * and keeps the ICC profile. See sail_convert_image_with_options().
+     */
+    SAIL_CONVERSION_OPTION_APPLY_ICCP  = 1 << 2,
+
+    /*
+     * Apply ordered dithering with an 8x8 Bayer matrix when narrowing 16-bit components to 8 bits
+     * without reordering them, for example, when converting BPP48-RGB pixels to BPP24-RGB or BPP64-RGBA
+     * pixels to BPP32-RGBA. Alpha is not dithered. Other conversions round 16-bit components
+     * to the nearest 8-bit values.
+     */
+    SAIL_CONVERSION_OPTION_DITHER      = 1 << 3,
+
+    /*
+     * Analyze the image pixels in sail_convert_image_for_saving_with_options() with sail_analyze_image(),
+     * and save the image into the smallest pixel format from the save features that holds the pixels
+     * without losing data. For example, opaque RGBA images are saved as RGB, gray-looking color images
+     * as grayscale, images with up to 256 opaque colors as indexed with a BPP24-RGB palette, and 16-bit
+     * images with 8-bit values as 8-bit. Dithering is not applied. Images in pixel formats that
+     * sail_analyze_image() converts first, and images that fit no smaller pixel format, are converted as usual.
+     */
+    SAIL_CONVERSION_OPTION_DOWNGRADE   = 1 << 4,
+};
+
+/*
+ * Luma coefficients to convert color pixels to grayscale.
+ *
+ * Formula:
+ *   gray = Kr * R + Kg * G + Kb * B
+ *
+ * The result is rounded to the nearest integer.
+ */
+enum SailLumaCoefficients {
+
+    /* ITU-R BT.601. Kr = 0.299, Kg = 0.587, Kb = 0.114. The default. */
+    SAIL_LUMA_COEFFICIENTS_BT601,
+
+    /* ITU-R BT.709. Kr = 0.2126, Kg = 0.7152, Kb = 0.0722. */
+    SAIL_LUMA_COEFFICIENTS_BT709,
+
+    /* ITU-R BT.2020. Kr = 0.2627, Kg = 0.6780, Kb = 0.0593. */
+    SAIL_LUMA_COEFFICIENTS_BT2020,
+};
+
+/*
+ * Filters to scale images with. When downscaling, filters are widened by the scaling factor,
+ * so all source pixels contribute to the result.
+ */
+enum SailScaleFilter {
+
+    /* Averages the source pixels whose centers fall into the output pixel. Like nearest neighbor when upscaling. */
+    SAIL_SCALE_FILTER_BOX,
+
+    /* Triangle filter. Bilinear interpolation when upscaling. */
+    SAIL_SCALE_FILTER_BILINEAR,
+
+    /* Keys cubic filter with a = -0.5 (Catmull-Rom). */
+    SAIL_SCALE_FILTER_BICUBIC,
+
+    /* Lanczos filter with 3 lobes. The sharpest and the slowest filter. */
+    SAIL_SCALE_FILTER_LANCZOS3,
+
+    /* Weights the source pixels by the exact area they cover in the output pixel. Best for downscaling by non-integer factors. */
+    SAIL_SCALE_FILTER_AREA,
+};
+
+/* Dithering methods used by sail_quantize_image(). */
+enum SailDither {
+
+    /* Maps every pixel to the nearest palette color. */
+    SAIL_DITHER_NONE,
+
+    /* Diffuses the quantization error to the neighbor pixels. The best quality, but processes rows serially. */
+    SAIL_DITHER_FLOYD_STEINBERG,
+
+    /* Adds an 8x8 Bayer threshold matrix to the pixels. Produces a regular pattern, but processes rows in parallel. */
+    SAIL_DITHER_ORDERED,
 };
 
 #endif
@@ -25,10 +25,47 @@
 
 #include <sail-manip/sail-manip.h>
 
-/* https://en.wikipedia.org/wiki/Grayscale */
-static const double R_TO_GRAY_COEFFICIENT = 0.299;
-static const double G_TO_GRAY_COEFFICIENT = 0.587;
-static const double B_TO_GRAY_COEFFICIENT = 0.114;
+/*
+ * Luma weights in 1/32768 units adding up to 32768. See https://en.wikipedia.org/wiki/Luma_(video)
+ */
+static const uint16_t BT601_LUMA_WEIGHTS[3]  = { 9798, 19235, 3735 };
+static const uint16_t BT709_LUMA_WEIGHTS[3]  = { 6966, 23436, 2366 };
+static const uint16_t BT2020_LUMA_WEIGHTS[3] = { 8608, 22217, 1943 };
+
+const uint8_t BAYER_8X8[8][8] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 },
+};
+
+void luma_weights(const struct sail_conversion_options *options, uint16_t weights[3]) {
+
+    const uint16_t *source;
+
+    switch (options == NULL ? SAIL_LUMA_COEFFICIENTS_BT601 : options->luma_coefficients) {
+        case SAIL_LUMA_COEFFICIENTS_BT709: {
+            source = BT709_LUMA_WEIGHTS;
+            break;
+        }
+        case SAIL_LUMA_COEFFICIENTS_BT2020: {
+            source = BT2020_LUMA_WEIGHTS;
+            break;
+        }
+        default: {
+            source = BT601_LUMA_WEIGHTS;
+            break;
+        }
+    }
+
+    weights[0] = source[0];
+    weights[1] = source[1];
+    weights[2] = source[2];
+}
 
 sail_status_t get_palette_rgba32(const struct sail_palette *palette, unsigned index, sail_rgba32_t *rgba32) {
 
@@ -73,7 +110,7 @@ void spread_gray8_to_rgba32(uint8_t value, sail_rgba32_t *rgba32) {
 
 void spread_gray16_to_rgba32(uint16_t value, sail_rgba32_t *rgba32) {
 
-    rgba32->component1 = rgba32->component2 = rgba32->component3 = (uint8_t)(value / 257.0);
+    rgba32->component1 = rgba32->component2 = rgba32->component3 = narrow_uint16(value);
     rgba32->component4 = 255;
 }
 
@@ -94,18 +131,19 @@ void fill_gray8_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *sc
     sail_rgb24_t rgb24;
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        rgb24.component1 = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        rgb24.component2 = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        rgb24.component3 = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        rgb24.component1 = blend_uint8(rgba32->component1, options->background24.component1, rgba32->component4);
+        rgb24.component2 = blend_uint8(rgba32->component2, options->background24.component2, rgba32->component4);
+        rgb24.component3 = blend_uint8(rgba32->component3, options->background24.component3, rgba32->component4);
     } else {
         rgb24.component1 = rgba32->component1;
         rgb24.component2 = rgba32->component2;
         rgb24.component3 = rgba32->component3;
     }
 
-    *scan = (uint8_t)((R_TO_GRAY_COEFFICIENT * rgb24.component1) + (G_TO_GRAY_COEFFICIENT * rgb24.component2) + (B_TO_GRAY_COEFFICIENT * rgb24.component3));
+    uint16_t weights[3];
+    luma_weights(options, weights);
+
+    *scan = (uint8_t)luma(weights, rgb24.component1, rgb24.component2, rgb24.component3);
 }
 
 void fill_gray8_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *scan, const struct sail_conversion_options *options) {
@@ -113,18 +151,19 @@ void fill_gray8_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *s
     sail_rgb24_t rgb24;
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        rgb24.component1 = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        rgb24.component2 = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        rgb24.component3 = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        rgb24.component1 = narrow_uint16(blend_uint16(rgba64->component1, options->background48.component1, rgba64->component4));
+        rgb24.component2 = narrow_uint16(blend_uint16(rgba64->component2, options->background48.component2, rgba64->component4));
+        rgb24.component3 = narrow_uint16(blend_uint16(rgba64->component3, options->background48.component3, rgba64->component4));
     } else {
-        rgb24.component1 = (uint8_t)(rgba64->component1 / 257.0);
-        rgb24.component2 = (uint8_t)(rgba64->component2 / 257.0);
-        rgb24.component3 = (uint8_t)(rgba64->component3 / 257.0);
+        rgb24.component1 = narrow_uint16(rgba64->component1);
+        rgb24.component2 = narrow_uint16(rgba64->component2);
+        rgb24.component3 = narrow_uint16(rgba64->component3);
     }
 
-    *scan = (uint8_t)((R_TO_GRAY_COEFFICIENT * rgb24.component1) + (G_TO_GRAY_COEFFICIENT * rgb24.component2) + (B_TO_GRAY_COEFFICIENT * rgb24.component3));
+    uint16_t weights[3];
+    luma_weights(options, weights);
+
+    *scan = (uint8_t)luma(weights, rgb24.component1, rgb24.component2, rgb24.component3);
 }
 
 void fill_gray16_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *scan, const struct sail_conversion_options *options) {
@@ -132,18 +171,19 @@ void fill_gray16_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *
     sail_rgb48_t rgb48;
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        rgb48.component1 = (uint16_t)(opacity * (rgba32->component1 * 257) + (1 - opacity) * options->background48.component1);
-        rgb48.component2 = (uint16_t)(opacity * (rgba32->component2 * 257) + (1 - opacity) * options->background48.component2);
-        rgb48.component3 = (uint16_t)(opacity * (rgba32->component3 * 257) + (1 - opacity) * options->background48.component3);
+        rgb48.component1 = blend_uint16((uint16_t)(rgba32->component1 * 257), options->background48.component1, (uint16_t)(rgba32->component4 * 257));
+        rgb48.component2 = blend_uint16((uint16_t)(rgba32->component2 * 257), options->background48.component2, (uint16_t)(rgba32->component4 * 257));
+        rgb48.component3 = blend_uint16((uint16_t)(rgba32->component3 * 257), options->background48.component3, (uint16_t)(rgba32->component4 * 257));
     } else {
         rgb48.component1 = rgba32->component1 * 257;
         rgb48.component2 = rgba32->component2 * 257;
         rgb48.component3 = rgba32->component3 * 257;
     }
 
-    *scan = (uint16_t)((R_TO_GRAY_COEFFICIENT * rgb48.component1) + (G_TO_GRAY_COEFFICIENT * rgb48.component2) + (B_TO_GRAY_COEFFICIENT * rgb48.component3));
+    uint16_t weights[3];
+    luma_weights(options, weights);
+
+    *scan = (uint16_t)luma(weights, rgb48.component1, rgb48.component2, rgb48.component3);
 }
 
 void fill_gray16_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *scan, const struct sail_conversion_options *options) {
@@ -151,28 +191,27 @@ void fill_gray16_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t
     sail_rgb48_t rgb48;
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        rgb48.component1 = (uint16_t)(opacity * rgba64->component1 + (1 - opacity) * options->background48.component1);
-        rgb48.component2 = (uint16_t)(opacity * rgba64->component2 + (1 - opacity) * options->background48.component2);
-        rgb48.component3 = (uint16_t)(opacity * rgba64->component3 + (1 - opacity) * options->background48.component3);
+        rgb48.component1 = blend_uint16(rgba64->component1, options->background48.component1, rgba64->component4);
+        rgb48.component2 = blend_uint16(rgba64->component2, options->background48.component2, rgba64->component4);
+        rgb48.component3 = blend_uint16(rgba64->component3, options->background48.component3, rgba64->component4);
     } else {
         rgb48.component1 = rgba64->component1;
         rgb48.component2 = rgba64->component2;
         rgb48.component3 = rgba64->component3;
     }
 
-    *scan = (uint16_t)((R_TO_GRAY_COEFFICIENT * rgb48.component1) + (G_TO_GRAY_COEFFICIENT * rgb48.component2) + (B_TO_GRAY_COEFFICIENT * rgb48.component3));
+    uint16_t weights[3];
+    luma_weights(options, weights);
+
+    *scan = (uint16_t)luma(weights, rgb48.component1, rgb48.component2, rgb48.component3);
 }
 
 void fill_rgb24_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        *(scan+r) = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        *(scan+g) = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        *(scan+b) = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        *(scan+r) = blend_uint8(rgba32->component1, options->background24.component1, rgba32->component4);
+        *(scan+g) = blend_uint8(rgba32->component2, options->background24.component2, rgba32->component4);
+        *(scan+b) = blend_uint8(rgba32->component3, options->background24.component3, rgba32->component4);
     } else {
         *(scan+r) = rgba32->component1;
         *(scan+g) = rgba32->component2;
@@ -183,26 +222,22 @@ void fill_rgb24_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *sc
 void fill_rgb24_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        *(scan+g) = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        *(scan+b) = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        *(scan+r) = narrow_uint16(blend_uint16(rgba64->component1, options->background48.component1, rgba64->component4));
+        *(scan+g) = narrow_uint16(blend_uint16(rgba64->component2, options->background48.component2, rgba64->component4));
+        *(scan+b) = narrow_uint16(blend_uint16(rgba64->component3, options->background48.component3, rgba64->component4));
     } else {
-        *(scan+r) = (uint8_t)(rgba64->component1 / 257.0);
-        *(scan+g) = (uint8_t)(rgba64->component2 / 257.0);
-        *(scan+b) = (uint8_t)(rgba64->component3 / 257.0);
+        *(scan+r) = narrow_uint16(rgba64->component1);
+        *(scan+g) = narrow_uint16(rgba64->component2);
+        *(scan+b) = narrow_uint16(rgba64->component3);
     }
 }
 
 void fill_rgb48_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        *(scan+r) = (uint16_t)(opacity * (rgba32->component1 * 257) + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * (rgba32->component2 * 257) + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * (rgba32->component3 * 257) + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend_uint16((uint16_t)(rgba32->component1 * 257), options->background48.component1, (uint16_t)(rgba32->component4 * 257));
+        *(scan+g) = blend_uint16((uint16_t)(rgba32->component2 * 257), options->background48.component2, (uint16_t)(rgba32->component4 * 257));
+        *(scan+b) = blend_uint16((uint16_t)(rgba32->component3 * 257), options->background48.component3, (uint16_t)(rgba32->component4 * 257));
     } else {
         *(scan+r) = rgba32->component1 * 257;
         *(scan+g) = rgba32->component2 * 257;
@@ -213,11 +248,9 @@ void fill_rgb48_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *s
 void fill_rgb48_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *scan, int r, int g, int b, const struct sail_conversion_options *options) {
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint16_t)(opacity * rgba64->component1 + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * rgba64->component2 + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * rgba64->component3 + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend_uint16(rgba64->component1, options->background48.component1, rgba64->component4);
+        *(scan+g) = blend_uint16(rgba64->component2, options->background48.component2, rgba64->component4);
+        *(scan+b) = blend_uint16(rgba64->component3, options->background48.component3, rgba64->component4);
     } else {
         *(scan+r) = rgba64->component1;
         *(scan+g) = rgba64->component2;
@@ -228,11 +261,9 @@ void fill_rgb48_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *
 void fill_rgba32_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        *(scan+r) = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        *(scan+g) = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        *(scan+b) = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        *(scan+r) = blend_uint8(rgba32->component1, options->background24.component1, rgba32->component4);
+        *(scan+g) = blend_uint8(rgba32->component2, options->background24.component2, rgba32->component4);
+        *(scan+b) = blend_uint8(rgba32->component3, options->background24.component3, rgba32->component4);
     } else {
         *(scan+r) = rgba32->component1;
         *(scan+g) = rgba32->component2;
@@ -247,30 +278,26 @@ void fill_rgba32_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *s
 void fill_rgba32_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        *(scan+g) = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        *(scan+b) = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        *(scan+r) = narrow_uint16(blend_uint16(rgba64->component1, options->background48.component1, rgba64->component4));
+        *(scan+g) = narrow_uint16(blend_uint16(rgba64->component2, options->background48.component2, rgba64->component4));
+        *(scan+b) = narrow_uint16(blend_uint16(rgba64->component3, options->background48.component3, rgba64->component4));
     } else {
-        *(scan+r) = (uint8_t)(rgba64->component1 / 257.0);
-        *(scan+g) = (uint8_t)(rgba64->component2 / 257.0);
-        *(scan+b) = (uint8_t)(rgba64->component3 / 257.0);
+        *(scan+r) = narrow_uint16(rgba64->component1);
+        *(scan+g) = narrow_uint16(rgba64->component2);
+        *(scan+b) = narrow_uint16(rgba64->component3);
     }
 
     if (a >= 0) {
-        *(scan+a) = (uint8_t)(rgba64->component4 / 257.0);
+        *(scan+a) = narrow_uint16(rgba64->component4);
     }
 }
 
 void fill_rgba64_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        *(scan+r) = (uint16_t)(opacity * (rgba32->component1 * 257) + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * (rgba32->component2 * 257) + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * (rgba32->component3 * 257) + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend_uint16((uint16_t)(rgba32->component1 * 257), options->background48.component1, (uint16_t)(rgba32->component4 * 257));
+        *(scan+g) = blend_uint16((uint16_t)(rgba32->component2 * 257), options->background48.component2, (uint16_t)(rgba32->component4 * 257));
+        *(scan+b) = blend_uint16((uint16_t)(rgba32->component3 * 257), options->background48.component3, (uint16_t)(rgba32->component4 * 257));
     } else {
         *(scan+r) = rgba32->component1 * 257;
         *(scan+g) = rgba32->component2 * 257;
@@ -285,11 +312,9 @@ void fill_rgba64_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint16_t *
 void fill_rgba64_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint16_t *scan, int r, int g, int b, int a, const struct sail_conversion_options *options) {
 
     if (a < 0 && rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        *(scan+r) = (uint16_t)(opacity * rgba64->component1 + (1 - opacity) * options->background48.component1);
-        *(scan+g) = (uint16_t)(opacity * rgba64->component2 + (1 - opacity) * options->background48.component2);
-        *(scan+b) = (uint16_t)(opacity * rgba64->component3 + (1 - opacity) * options->background48.component3);
+        *(scan+r) = blend_uint16(rgba64->component1, options->background48.component1, rgba64->component4);
+        *(scan+g) = blend_uint16(rgba64->component2, options->background48.component2, rgba64->component4);
+        *(scan+b) = blend_uint16(rgba64->component3, options->background48.component3, rgba64->component4);
     } else {
         *(scan+r) = rgba64->component1;
         *(scan+g) = rgba64->component2;
@@ -306,11 +331,9 @@ void fill_ycbcr_pixel_from_uint8_values(const sail_rgba32_t *rgba32, uint8_t *sc
     sail_rgba32_t rgba32_no_alpha;
 
     if (rgba32->component4 < 255 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba32->component4 / 255.0;
-
-        rgba32_no_alpha.component1 = (uint8_t)(opacity * rgba32->component1 + (1 - opacity) * options->background24.component1);
-        rgba32_no_alpha.component2 = (uint8_t)(opacity * rgba32->component2 + (1 - opacity) * options->background24.component2);
-        rgba32_no_alpha.component3 = (uint8_t)(opacity * rgba32->component3 + (1 - opacity) * options->background24.component3);
+        rgba32_no_alpha.component1 = blend_uint8(rgba32->component1, options->background24.component1, rgba32->component4);
+        rgba32_no_alpha.component2 = blend_uint8(rgba32->component2, options->background24.component2, rgba32->component4);
+        rgba32_no_alpha.component3 = blend_uint8(rgba32->component3, options->background24.component3, rgba32->component4);
     } else {
         rgba32_no_alpha = *rgba32;
     }
@@ -323,15 +346,13 @@ void fill_ycbcr_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *s
     sail_rgba32_t rgba32_no_alpha;
 
     if (rgba64->component4 < 65535 && options != NULL && (options->options & SAIL_CONVERSION_OPTION_BLEND_ALPHA)) {
-        const double opacity = rgba64->component4 / 65535.0;
-
-        rgba32_no_alpha.component1 = (uint8_t)((opacity * rgba64->component1 + (1 - opacity) * options->background48.component1) / 257.0);
-        rgba32_no_alpha.component2 = (uint8_t)((opacity * rgba64->component2 + (1 - opacity) * options->background48.component2) / 257.0);
-        rgba32_no_alpha.component3 = (uint8_t)((opacity * rgba64->component3 + (1 - opacity) * options->background48.component3) / 257.0);
+        rgba32_no_alpha.component1 = narrow_uint16(blend_uint16(rgba64->component1, options->background48.component1, rgba64->component4));
+        rgba32_no_alpha.component2 = narrow_uint16(blend_uint16(rgba64->component2, options->background48.component2, rgba64->component4));
+        rgba32_no_alpha.component3 = narrow_uint16(blend_uint16(rgba64->component3, options->background48.component3, rgba64->component4));
     } else {
-        rgba32_no_alpha.component1 = (uint8_t)(rgba64->component1 / 257.0);
-        rgba32_no_alpha.component2 = (uint8_t)(rgba64->component2 / 257.0);
-        rgba32_no_alpha.component3 = (uint8_t)(rgba64->component3 / 257.0);
+        rgba32_no_alpha.component1 = narrow_uint16(rgba64->component1);
+        rgba32_no_alpha.component2 = narrow_uint16(rgba64->component2);
+        rgba32_no_alpha.component3 = narrow_uint16(rgba64->component3);
     }
 
     convert_rgba32_to_ycbcr24(&rgba32_no_alpha, scan+0, scan+1, scan+2);
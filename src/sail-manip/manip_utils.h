@@ -27,15 +27,32 @@
 #define SAIL_MANIP_UTILS_H
 
 #include <stdint.h>
+#include <string.h>
 
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
+#include <sail-manip/conversion_stats.h>
+#include <sail-manip/manip_common.h>
+
 struct sail_conversion_options;
+struct sail_image;
+struct sail_image_analysis;
 struct sail_palette;
+struct sail_save_features;
 
 SAIL_HIDDEN sail_status_t get_palette_rgba32(const struct sail_palette *palette, unsigned index, sail_rgba32_t *rgba32);
 
+/*
+ * 8x8 Bayer threshold matrix with the values in [0; 64) for ordered dithering.
+ */
+SAIL_HIDDEN extern const uint8_t BAYER_8X8[8][8];
+
+/*
+ * Returns R, G, and B luma weights in 1/32768 units. The weights add up to 32768.
+ */
+SAIL_HIDDEN void luma_weights(const struct sail_conversion_options *options, uint16_t weights[3]);
+
 SAIL_HIDDEN void spread_gray8_to_rgba32(uint8_t value, sail_rgba32_t *rgba32);
 
 SAIL_HIDDEN void spread_gray16_to_rgba32(uint16_t value, sail_rgba32_t *rgba32);
@@ -72,4 +89,212 @@ SAIL_HIDDEN void fill_ycbcr_pixel_from_uint8_values(const sail_rgba32_t *rgba32,
 
 SAIL_HIDDEN void fill_ycbcr_pixel_from_uint16_values(const sail_rgba64_t *rgba64, uint8_t *scan, const struct sail_conversion_options *options);
 
+/*
+ * Returns the smallest pixel format from the save features that holds the analyzed pixels without losing data,
+ * or SAIL_PIXEL_FORMAT_UNKNOWN if the input pixel format is not analyzed as is or no pixel formats fit.
+ * Returns the input pixel format instead of candidates of the same size.
+ */
+SAIL_HIDDEN enum SailPixelFormat lossless_pixel_format_for_saving(enum SailPixelFormat input_pixel_format,
+                                                                  const struct sail_image_analysis *analysis,
+                                                                  const struct sail_save_features *save_features);
+
+/*
+ * Converts the image into the indexed pixel format with a BPP24-RGB palette of the analyzed distinct colors.
+ * The image must be opaque and have no more colors than the pixel format holds.
+ */
+SAIL_HIDDEN sail_status_t palettize_image(const struct sail_image *image,
+                                          const struct sail_image_analysis *analysis,
+                                          enum SailPixelFormat pixel_format,
+                                          struct sail_image **image_output);
+
+/*
+ * Adds a conversion of 'pixels' pixels that took 'nanoseconds' to the conversion stats.
+ * Does nothing if the stats are disabled or full.
+ */
+SAIL_HIDDEN void record_conversion_stats(enum SailPixelFormat input_pixel_format,
+                                         enum SailPixelFormat output_pixel_format,
+                                         enum SailConversionKernel kernel,
+                                         enum SailInstructionSet instruction_set,
+                                         uint64_t pixels,
+                                         uint64_t nanoseconds);
+
+/*
+ * Blends the color component with the background: (a * c + (max - a) * background + max / 2) / max.
+ * The division is an exact multiply-shift, so SIMD kernels are able to produce the same results.
+ */
+static inline uint8_t blend_uint8(uint8_t c, uint8_t background, uint8_t a) {
+
+    const unsigned value = a * c + (255 - a) * background + 127;
+
+    return (uint8_t)((value + 1 + (value >> 8)) >> 8);
+}
+
+static inline uint16_t blend_uint16(uint16_t c, uint16_t background, uint16_t a) {
+
+    const uint32_t value = (uint32_t)a * c + (uint32_t)(65535 - a) * background + 32767;
+
+    return (uint16_t)((value + 1 + (value >> 16)) >> 16);
+}
+
+/*
+ * Narrows the 16-bit component to 8 bits: (v * 255 + 32895) >> 16, i.e. v / 257 rounded to the nearest integer.
+ * The narrowing row kernels produce the same results with the threshold of 128.
+ */
+static inline uint8_t narrow_uint16(uint16_t v) {
+
+    return (uint8_t)(((uint32_t)v * 255 + 32895) >> 16);
+}
+
+/* Multiplies the color component by alpha. It's blending over the black background. */
+static inline uint8_t premultiply_uint8(uint8_t c, uint8_t a) {
+
+    return blend_uint8(c, 0, a);
+}
+
+static inline uint16_t premultiply_uint16(uint16_t c, uint16_t a) {
+
+    return blend_uint16(c, 0, a);
+}
+
+/*
+ * Divides the premultiplied color component by alpha: (c * max + a / 2) / a clamped to max.
+ * Fully transparent pixels get black color components.
+ */
+static inline uint8_t unpremultiply_uint8(uint8_t c, uint8_t a) {
+
+    if (a == 0) {
+        return 0;
+    }
+
+    const unsigned value = (c * 255U + a / 2) / a;
+
+    return value > 255 ? 255 : (uint8_t)value;
+}
+
+static inline uint16_t unpremultiply_uint16(uint16_t c, uint16_t a) {
+
+    if (a == 0) {
+        return 0;
+    }
+
+    const uint64_t value = ((uint64_t)c * 65535 + a / 2) / a;
+
+    return value > 65535 ? 65535 : (uint16_t)value;
+}
+
+/*
+ * Computes rounded luma of 8-bit or 16-bit color components with the weights from luma_weights().
+ * The integer math is shared with the luma row kernels, so they produce the same results.
+ */
+static inline uint32_t luma(const uint16_t weights[3], uint32_t c1, uint32_t c2, uint32_t c3) {
+
+    return (weights[0] * c1 + weights[1] * c2 + weights[2] * c3 + 16384) >> 15;
+}
+
+/*
+ * Converts the half precision value into single precision. Every half precision value is exact
+ * in single precision. Signaling NaNs become quiet like with F16C and NEON.
+ */
+static inline float half_to_float(uint16_t h) {
+
+    const uint32_t sign     = (uint32_t)(h & 0x8000) << 16;
+    const uint32_t exponent = (h >> 10) & 0x1F;
+    const uint32_t mantissa = h & 0x3FF;
+
+    uint32_t bits;
+
+    if (exponent == 0) {
+        /* Zero or subnormal: mantissa * 2^-24. */
+        const float value = (float)mantissa * (1.0f / 16777216.0f);
+        return sign != 0 ? -value : value;
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13) | (mantissa != 0 ? 0x400000 : 0);
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+/*
+ * Converts the single precision value into half precision rounding to the nearest even value
+ * like F16C and NEON. Values too large for half precision become infinities.
+ */
+static inline uint16_t float_to_half(float value) {
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint16_t sign      = (uint16_t)((bits >> 16) & 0x8000);
+    const uint32_t magnitude = bits & 0x7FFFFFFF;
+
+    /* Infinity or quiet NaN with the truncated payload. */
+    if (magnitude >= 0x7F800000) {
+        return (uint16_t)(sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x200 | ((magnitude >> 13) & 0x3FF) : 0));
+    }
+
+    /* 65520 and above round to infinity. */
+    if (magnitude >= 0x477FF000) {
+        return (uint16_t)(sign | 0x7C00);
+    }
+
+    uint32_t h;
+    uint32_t remainder;
+    uint32_t halfway;
+
+    if (magnitude >= 0x38800000) {
+        /* Normal: rebias the exponent and drop 13 mantissa bits. */
+        h         = (magnitude - 0x38000000) >> 13;
+        remainder = magnitude & 0x1FFF;
+        halfway   = 0x1000;
+    } else if (magnitude >= 0x33000000) {
+        /* Subnormal: (1.mantissa) * 2^(exponent - 126) units of 2^-24. */
+        const uint32_t shift = 126 - (magnitude >> 23);
+        const uint32_t full  = (magnitude & 0x7FFFFF) | 0x800000;
+
+        h         = full >> shift;
+        remainder = full & ((1u << shift) - 1);
+        halfway   = 1u << (shift - 1);
+    } else {
+        /* 2^-25 and below round to zero. */
+        return sign;
+    }
+
+    /* A carry into the exponent produces the next power of two. */
+    if (remainder > halfway || (remainder == halfway && (h & 1))) {
+        h++;
+    }
+
+    return (uint16_t)(sign | h);
+}
+
+/*
+ * Converts the floating point value into a 16-bit component: [0; 1] scaled to [0; 65535] and rounded
+ * to the nearest even integer. HDR values are clamped, NaNs become 0. Shared with the row kernels.
+ */
+static inline uint16_t float_to_uint16(float value) {
+
+    const float clamped = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+    const float scaled  = clamped * 65535.0f;
+
+    /* Compare instead of subtracting, so compilers don't fuse the multiplication into the rounding. */
+    uint32_t result = (uint32_t)scaled;
+    const float halfway = (float)result + 0.5f;
+
+    if (scaled > halfway || (scaled == halfway && (result & 1))) {
+        result++;
+    }
+
+    return (uint16_t)result;
+}
+
+/* Converts the 16-bit component into [0; 1]. 65535 becomes exactly 1. Shared with the row kernels. */
+static inline float uint16_to_float(uint16_t value) {
+
+    return (float)value / 65535.0f;
+}
+
 #endif
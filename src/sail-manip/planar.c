@@ -0,0 +1,117 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+
+#include <sail-manip/sail-manip.h>
+
+#include "planar.h"
+
+sail_status_t planar_to_ycbcr24(const struct sail_image *image, struct sail_image *image_output) {
+
+    void *planes[4];
+    unsigned strides[4];
+    unsigned planes_count;
+    SAIL_TRY(sail_image_planes(image, planes, strides, &planes_count));
+
+    const bool subsampled  = image->pixel_format != SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444;
+    const bool interleaved = image->pixel_format == SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    for (unsigned row = 0; row < image->height; row++) {
+        const unsigned chroma_row = subsampled ? row / 2 : row;
+
+        const uint8_t *y  = (const uint8_t *)planes[0] + (size_t)row * strides[0];
+        const uint8_t *cb = (const uint8_t *)planes[1] + (size_t)chroma_row * strides[1];
+        const uint8_t *cr = interleaved ? cb + 1 : (const uint8_t *)planes[2] + (size_t)chroma_row * strides[2];
+        uint8_t *scan = sail_scan_line(image_output, row);
+
+        for (unsigned x = 0; x < image->width; x++) {
+            const unsigned chroma_x = interleaved ? (x / 2) * 2 : (subsampled ? x / 2 : x);
+
+            *scan++ = y[x];
+            *scan++ = cb[chroma_x];
+            *scan++ = cr[chroma_x];
+        }
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t ycbcr24_to_planar(const struct sail_image *image, struct sail_image *image_output) {
+
+    void *planes[4];
+    unsigned strides[4];
+    unsigned planes_count;
+    SAIL_TRY(sail_image_planes(image_output, planes, strides, &planes_count));
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan = sail_scan_line(image, row);
+        uint8_t *y = (uint8_t *)planes[0] + (size_t)row * strides[0];
+
+        for (unsigned x = 0; x < image->width; x++) {
+            y[x] = scan[x * 3];
+        }
+    }
+
+    if (image_output->pixel_format == SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444) {
+        #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+        for (unsigned row = 0; row < image->height; row++) {
+            const uint8_t *scan = sail_scan_line(image, row);
+            uint8_t *cb = (uint8_t *)planes[1] + (size_t)row * strides[1];
+            uint8_t *cr = (uint8_t *)planes[2] + (size_t)row * strides[2];
+
+            for (unsigned x = 0; x < image->width; x++) {
+                cb[x] = scan[x * 3 + 1];
+                cr[x] = scan[x * 3 + 2];
+            }
+        }
+
+        return SAIL_OK;
+    }
+
+    const bool interleaved = image_output->pixel_format == SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12;
+    const unsigned chroma_width  = image->width / 2;
+    const unsigned chroma_height = image->height / 2;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE)
+    for (unsigned row = 0; row < chroma_height; row++) {
+        const uint8_t *scan1 = sail_scan_line(image, row * 2);
+        const uint8_t *scan2 = sail_scan_line(image, row * 2 + 1);
+        uint8_t *cb = (uint8_t *)planes[1] + (size_t)row * strides[1];
+        uint8_t *cr = interleaved ? cb + 1 : (uint8_t *)planes[2] + (size_t)row * strides[2];
+        const unsigned step = interleaved ? 2 : 1;
+
+        for (unsigned x = 0; x < chroma_width; x++) {
+            const size_t offset = (size_t)x * 6;
+
+            cb[x * step] = (uint8_t)((scan1[offset + 1] + scan1[offset + 4] + scan2[offset + 1] + scan2[offset + 4] + 2) / 4);
+            cr[x * step] = (uint8_t)((scan1[offset + 2] + scan1[offset + 5] + scan2[offset + 2] + scan2[offset + 5] + 2) / 4);
+        }
+    }
+
+    return SAIL_OK;
+}
@@ -0,0 +1,46 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_PLANAR_H
+#define SAIL_PLANAR_H
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_image;
+
+/*
+ * Lays out the planar image into the allocated BPP24-YCBCR image of the same size.
+ * 4:2:0 chroma samples are replicated into 2x2 blocks.
+ */
+SAIL_HIDDEN sail_status_t planar_to_ycbcr24(const struct sail_image *image, struct sail_image *image_output);
+
+/*
+ * Lays out the BPP24-YCBCR image into the allocated planar image of the same size.
+ * 4:2:0 chroma samples are averaged over 2x2 blocks.
+ */
+SAIL_HIDDEN sail_status_t ycbcr24_to_planar(const struct sail_image *image, struct sail_image *image_output);
+
+#endif
@@ -0,0 +1,464 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* Map images with at least this number of pixels in multiple threads. */
+static const size_t PARALLEL_PIXELS_THRESHOLD = 65536;
+
+/* Histogram bins of 5 bits per color component and 3 bits of alpha. */
+#define HISTOGRAM_BINS (1U << 18)
+
+static inline unsigned histogram_bin(const uint8_t *rgba) {
+
+    return ((unsigned)(rgba[0] >> 3) << 13) | ((unsigned)(rgba[1] >> 3) << 8) | ((unsigned)(rgba[2] >> 3) << 3) | (rgba[3] >> 5);
+}
+
+/* The histogram colors with their exact average values. */
+struct color_entry {
+
+    uint64_t sums[4];
+    uint32_t count;
+    uint8_t value[4];
+};
+
+struct color_box {
+
+    unsigned begin;
+    unsigned end;
+    uint64_t weight;
+    unsigned channel; /* The component with the largest range. */
+    unsigned range;
+};
+
+static int compare_entries_0(const void *a, const void *b) { return (int)((const struct color_entry *)a)->value[0] - (int)((const struct color_entry *)b)->value[0]; }
+static int compare_entries_1(const void *a, const void *b) { return (int)((const struct color_entry *)a)->value[1] - (int)((const struct color_entry *)b)->value[1]; }
+static int compare_entries_2(const void *a, const void *b) { return (int)((const struct color_entry *)a)->value[2] - (int)((const struct color_entry *)b)->value[2]; }
+static int compare_entries_3(const void *a, const void *b) { return (int)((const struct color_entry *)a)->value[3] - (int)((const struct color_entry *)b)->value[3]; }
+
+static int (* const COMPARE_ENTRIES[4])(const void *, const void *) = {
+    compare_entries_0, compare_entries_1, compare_entries_2, compare_entries_3
+};
+
+static void update_box(const struct color_entry *entries, struct color_box *box) {
+
+    uint8_t min[4] = { 255, 255, 255, 255 };
+    uint8_t max[4] = { 0, 0, 0, 0 };
+
+    box->weight = 0;
+
+    for (unsigned i = box->begin; i < box->end; i++) {
+        for (unsigned c = 0; c < 4; c++) {
+            if (entries[i].value[c] < min[c]) {
+                min[c] = entries[i].value[c];
+            }
+            if (entries[i].value[c] > max[c]) {
+                max[c] = entries[i].value[c];
+            }
+        }
+
+        box->weight += entries[i].count;
+    }
+
+    box->channel = 0;
+    box->range   = 0;
+
+    for (unsigned c = 0; c < 4; c++) {
+        if ((unsigned)(max[c] - min[c]) > box->range) {
+            box->channel = c;
+            box->range   = max[c] - min[c];
+        }
+    }
+}
+
+/* Splits the histogram colors into boxes with the median cut algorithm. Returns the number of boxes. */
+static unsigned median_cut(struct color_entry *entries, unsigned entries_count, unsigned colors, struct color_box *boxes) {
+
+    unsigned boxes_count = 1;
+
+    boxes[0].begin = 0;
+    boxes[0].end   = entries_count;
+    update_box(entries, &boxes[0]);
+
+    while (boxes_count < colors) {
+        /* Split the box with the largest range weighted by the number of pixels. */
+        struct color_box *box = NULL;
+        uint64_t best_score = 0;
+
+        for (unsigned i = 0; i < boxes_count; i++) {
+            const uint64_t score = (uint64_t)boxes[i].range * boxes[i].weight;
+
+            if (boxes[i].end - boxes[i].begin > 1 && score > best_score) {
+                box = &boxes[i];
+                best_score = score;
+            }
+        }
+
+        if (box == NULL) {
+            break;
+        }
+
+        qsort(entries + box->begin, box->end - box->begin, sizeof(struct color_entry), COMPARE_ENTRIES[box->channel]);
+
+        /* Split at the weighted median leaving at least one color in every box. */
+        uint64_t weight = 0;
+        unsigned split = box->begin + 1;
+
+        for (unsigned i = box->begin; i < box->end - 1; i++) {
+            weight += entries[i].count;
+            split = i + 1;
+
+            if (weight * 2 >= box->weight) {
+                break;
+            }
+        }
+
+        struct color_box *new_box = &boxes[boxes_count++];
+
+        new_box->begin = split;
+        new_box->end   = box->end;
+        box->end       = split;
+
+        update_box(entries, box);
+        update_box(entries, new_box);
+    }
+
+    return boxes_count;
+}
+
+static unsigned nearest_palette_color(const uint8_t (*palette)[4], unsigned palette_count, int r, int g, int b, int a) {
+
+    unsigned nearest = 0;
+    int nearest_distance = INT32_MAX;
+
+    for (unsigned i = 0; i < palette_count; i++) {
+        const int dr = r - palette[i][0];
+        const int dg = g - palette[i][1];
+        const int db = b - palette[i][2];
+        const int da = a - palette[i][3];
+        const int distance = dr * dr + dg * dg + db * db + da * da;
+
+        if (distance < nearest_distance) {
+            nearest = i;
+            nearest_distance = distance;
+        }
+    }
+
+    return nearest;
+}
+
+/* Finds the nearest palette color to the center of the histogram bin. */
+static uint8_t nearest_to_bin(const uint8_t (*palette)[4], unsigned palette_count, unsigned bin) {
+
+    const int r = (int)((bin >> 13) & 0x1F) << 3 | 4;
+    const int g = (int)((bin >> 8) & 0x1F) << 3 | 4;
+    const int b = (int)((bin >> 3) & 0x1F) << 3 | 4;
+    const int a = ((bin & 0x7) == 0x7) ? 255 : (int)(bin & 0x7) << 5 | 16;
+
+    return (uint8_t)nearest_palette_color(palette, palette_count, r, g, b, a);
+}
+
+/* Returns the palette index of the pixel. Fills missing lookup table entries. */
+static inline uint8_t map_pixel(int16_t *lookup, const uint8_t (*palette)[4], unsigned palette_count, const uint8_t *rgba) {
+
+    const unsigned bin = histogram_bin(rgba);
+
+    if (lookup[bin] < 0) {
+        lookup[bin] = nearest_to_bin(palette, palette_count, bin);
+    }
+
+    return (uint8_t)lookup[bin];
+}
+
+static inline uint8_t clamp_uint8(int value) {
+
+    return (value < 0) ? 0 : ((value > 255) ? 255 : (uint8_t)value);
+}
+
+static void map_floyd_steinberg(const struct sail_image *image, int16_t *lookup, const uint8_t (*palette)[4],
+                                unsigned palette_count, int32_t *errors, struct sail_image *image_output) {
+
+    /* Errors of the current and the next rows with one extra pixel on both sides. */
+    int32_t *errors_current = errors;
+    int32_t *errors_next    = errors + (size_t)(image->width + 2) * 4;
+
+    memset(errors_current, 0, sizeof(int32_t) * (image->width + 2) * 4 * 2);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan_input = sail_scan_line(image, row);
+        uint8_t *scan_output      = sail_scan_line(image_output, row);
+
+        memset(errors_next, 0, sizeof(int32_t) * (image->width + 2) * 4);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            int32_t *error = errors_current + (column + 1) * 4;
+            uint8_t rgba[4];
+
+            /* Errors are stored multiplied by 16. */
+            for (unsigned c = 0; c < 4; c++) {
+                rgba[c] = clamp_uint8(scan_input[column * 4 + c] + (error[c] + 8) / 16);
+            }
+
+            const uint8_t index = map_pixel(lookup, palette, palette_count, rgba);
+            scan_output[column] = index;
+
+            /* The previous, the current, and the next pixels in the next row. */
+            int32_t *error_next = errors_next + column * 4;
+
+            for (unsigned c = 0; c < 4; c++) {
+                const int32_t quantization_error = (int32_t)rgba[c] - palette[index][c];
+
+                error[c + 4]      += quantization_error * 7;
+                error_next[c]     += quantization_error * 3;
+                error_next[c + 4] += quantization_error * 5;
+                error_next[c + 8] += quantization_error * 1;
+            }
+        }
+
+        int32_t *swap  = errors_current;
+        errors_current = errors_next;
+        errors_next    = swap;
+    }
+}
+
+static void map_pixels(const struct sail_image *image, int16_t *lookup, const uint8_t (*palette)[4], unsigned palette_count,
+                       bool ordered, struct sail_image *image_output) {
+
+    const bool parallel = (size_t)image->width * image->height >= PARALLEL_PIXELS_THRESHOLD;
+
+    if (parallel) {
+        /* Threads must not fill the lookup table lazily, so fill it completely. */
+        unsigned bin;
+
+        #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) num_threads(sail_thread_pool_size())
+        for (bin = 0; bin < HISTOGRAM_BINS; bin++) {
+            if (lookup[bin] < 0) {
+                lookup[bin] = nearest_to_bin(palette, palette_count, bin);
+            }
+        }
+    }
+
+    /* The dithering amplitude is about the distance between the palette colors. */
+    const int spread = (int)(255.0 / cbrt((double)palette_count));
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) if (parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image->height; row++) {
+        const uint8_t *scan_input = sail_scan_line(image, row);
+        uint8_t *scan_output      = sail_scan_line(image_output, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const uint8_t *pixel = scan_input + column * 4;
+
+            if (ordered) {
+                const int offset = ((int)BAYER_8X8[row % 8][column % 8] * 2 - 63) * spread / 128;
+                const uint8_t rgba[4] = {
+                    clamp_uint8(pixel[0] + offset),
+                    clamp_uint8(pixel[1] + offset),
+                    clamp_uint8(pixel[2] + offset),
+                    pixel[3]
+                };
+
+                scan_output[column] = map_pixel(lookup, palette, palette_count, rgba);
+            } else {
+                scan_output[column] = map_pixel(lookup, palette, palette_count, pixel);
+            }
+        }
+    }
+}
+
+static sail_status_t quantize_rgba32(const struct sail_image *image, unsigned colors, enum SailDither dither,
+                                     struct sail_image *image_output) {
+
+    void *ptr;
+
+    /* Count the pixels in every histogram bin. */
+    SAIL_TRY(sail_calloc(HISTOGRAM_BINS, sizeof(uint32_t), &ptr));
+    uint32_t *histogram = ptr;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            histogram[histogram_bin(scan + column * 4)]++;
+        }
+    }
+
+    unsigned entries_count = 0;
+
+    for (unsigned bin = 0; bin < HISTOGRAM_BINS; bin++) {
+        if (histogram[bin] > 0) {
+            entries_count++;
+        }
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_calloc(entries_count, sizeof(struct color_entry), &ptr),
+                        /* cleanup */ sail_free(histogram));
+    struct color_entry *entries = ptr;
+
+    /* Replace the counts with the entry indexes and sum the exact colors of every entry. */
+    for (unsigned bin = 0, entry = 0; bin < HISTOGRAM_BINS; bin++) {
+        histogram[bin] = (histogram[bin] > 0) ? entry++ : UINT32_MAX;
+    }
+
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const uint8_t *pixel = scan + column * 4;
+            struct color_entry *entry = &entries[histogram[histogram_bin(pixel)]];
+
+            entry->sums[0] += pixel[0];
+            entry->sums[1] += pixel[1];
+            entry->sums[2] += pixel[2];
+            entry->sums[3] += pixel[3];
+            entry->count++;
+        }
+    }
+
+    sail_free(histogram);
+
+    for (unsigned i = 0; i < entries_count; i++) {
+        for (unsigned c = 0; c < 4; c++) {
+            entries[i].value[c] = (uint8_t)((entries[i].sums[c] + entries[i].count / 2) / entries[i].count);
+        }
+    }
+
+    /* Build the palette from the average colors of the boxes. */
+    struct color_box boxes[256];
+    const unsigned palette_count = median_cut(entries, entries_count, colors, boxes);
+
+    uint8_t palette[256][4];
+    bool opaque = true;
+
+    for (unsigned i = 0; i < palette_count; i++) {
+        uint64_t sums[4] = { 0, 0, 0, 0 };
+
+        for (unsigned e = boxes[i].begin; e < boxes[i].end; e++) {
+            for (unsigned c = 0; c < 4; c++) {
+                sums[c] += entries[e].sums[c];
+            }
+        }
+
+        for (unsigned c = 0; c < 4; c++) {
+            palette[i][c] = (uint8_t)((sums[c] + boxes[i].weight / 2) / boxes[i].weight);
+        }
+
+        opaque = opaque && palette[i][3] == 255;
+    }
+
+    sail_free(entries);
+
+    SAIL_TRY(sail_alloc_palette_for_data(opaque ? SAIL_PIXEL_FORMAT_BPP24_RGB : SAIL_PIXEL_FORMAT_BPP32_RGBA,
+                                         palette_count, &image_output->palette));
+
+    for (unsigned i = 0; i < palette_count; i++) {
+        memcpy((uint8_t *)image_output->palette->data + i * (opaque ? 3 : 4), palette[i], opaque ? 3 : 4);
+    }
+
+    /* Map the pixels. */
+    SAIL_TRY(sail_malloc(sizeof(int16_t) * HISTOGRAM_BINS, &ptr));
+    int16_t *lookup = ptr;
+    memset(lookup, 0xFF, sizeof(int16_t) * HISTOGRAM_BINS);
+
+    if (dither == SAIL_DITHER_FLOYD_STEINBERG) {
+        SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(int32_t) * (image->width + 2) * 4 * 2, &ptr),
+                            /* cleanup */ sail_free(lookup));
+
+        map_floyd_steinberg(image, lookup, (const uint8_t (*)[4])palette, palette_count, ptr, image_output);
+
+        sail_free(ptr);
+    } else {
+        map_pixels(image, lookup, (const uint8_t (*)[4])palette, palette_count, dither == SAIL_DITHER_ORDERED, image_output);
+    }
+
+    sail_free(lookup);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_quantize_image(const struct sail_image *image,
+                                  unsigned colors,
+                                  enum SailDither dither,
+                                  struct sail_image **image_output) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(image_output);
+
+    if (colors == 0 || colors > 256) {
+        SAIL_LOG_ERROR("Cannot quantize an image to %u colors, the number of colors must be in the range [1; 256]", colors);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (dither != SAIL_DITHER_NONE && dither != SAIL_DITHER_FLOYD_STEINBERG && dither != SAIL_DITHER_ORDERED) {
+        SAIL_LOG_ERROR("Unknown dithering method %d", (int)dither);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct sail_image *image_rgba = NULL;
+
+    if (image->pixel_format != SAIL_PIXEL_FORMAT_BPP32_RGBA) {
+        SAIL_TRY(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_rgba));
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY_OR_CLEANUP(sail_copy_image_skeleton(image, &image_local),
+                        /* cleanup */ sail_destroy_image(image_rgba));
+
+    sail_destroy_palette(image_local->palette);
+    image_local->palette = NULL;
+
+    image_local->pixel_format   = SAIL_PIXEL_FORMAT_BPP8_INDEXED;
+    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_image_pixels(image_local, image->pixels_file_backed_size > 0),
+                        /* cleanup */ sail_destroy_image(image_local),
+                                      sail_destroy_image(image_rgba));
+
+    SAIL_TRY_OR_CLEANUP(quantize_rgba32((image_rgba != NULL) ? image_rgba : image, colors, dither, image_local),
+                        /* cleanup */ sail_destroy_image(image_local),
+                                      sail_destroy_image(image_rgba));
+
+    sail_destroy_image(image_rgba);
+
+    *image_output = image_local;
+
+    return SAIL_OK;
+}
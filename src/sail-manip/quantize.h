@@ -0,0 +1,74 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_QUANTIZE_H
+#define SAIL_QUANTIZE_H
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#include <sail-manip/manip_common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_image;
+
+/*
+ * Quantizes the input image to a palette of up to the specified number of colors and saves
+ * the result in the output image with the SAIL_PIXEL_FORMAT_BPP8_INDEXED pixel format.
+ *
+ * The palette is built with the median cut algorithm over a histogram of the image colors
+ * with 5 bits per color component and 3 bits of alpha. Pixels are mapped to the nearest
+ * palette colors with a lookup table indexed by the same histogram bins, optionally with dithering.
+ * The palette pixel format is SAIL_PIXEL_FORMAT_BPP24_RGB for opaque images and
+ * SAIL_PIXEL_FORMAT_BPP32_RGBA otherwise. The palette has fewer colors if the image has fewer
+ * distinct histogram colors.
+ *
+ * Large images are mapped in multiple threads with OpenMP unless Floyd-Steinberg dithering is used.
+ *
+ * Allowed input pixel formats:
+ *   - All pixel formats that sail_convert_image() can convert to SAIL_PIXEL_FORMAT_BPP32_RGBA.
+ *     Other formats than SAIL_PIXEL_FORMAT_BPP32_RGBA are converted first.
+ *
+ * The resulting image gets a new pixel format, bytes per line, and palette. Other properties
+ * are copied from the original image.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_INVALID_ARGUMENT if the number of colors is not in the range [1; 256].
+ * Returns SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT if the pixel format is not supported.
+ */
+SAIL_EXPORT sail_status_t sail_quantize_image(const struct sail_image *image,
+                                              unsigned colors,
+                                              enum SailDither dither,
+                                              struct sail_image **image_output);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
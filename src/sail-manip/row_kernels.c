@@ -0,0 +1,2493 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define SAIL_ROW_KERNELS_X86
+
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define SAIL_TARGET(isa)
+    #else
+        #include <cpuid.h>
+        #define SAIL_TARGET(isa) __attribute__((target(isa)))
+    #endif
+
+    #include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define SAIL_ROW_KERNELS_NEON
+
+    #include <arm_neon.h>
+#endif
+
+/*
+ * Private functions.
+ */
+
+#if defined(SAIL_ROW_KERNELS_X86) || defined(SAIL_ROW_KERNELS_NEON)
+/*
+ * Internal override of the CPU detection to run every kernel on one machine in tests and benchmarks.
+ * The SAIL_ROW_KERNELS_INSTRUCTION_SET environment variable set to "generic", "ssse3", or "avx2" disables
+ * the faster kernels. Returns SAIL_INSTRUCTION_SET_F16C when nothing is disabled.
+ */
+static enum SailInstructionSet instruction_set_limit(void) {
+
+    char *env;
+#ifdef _MSC_VER
+    if (_dupenv_s(&env, NULL, "SAIL_ROW_KERNELS_INSTRUCTION_SET") != 0) {
+        env = NULL;
+    }
+#else
+    env = getenv("SAIL_ROW_KERNELS_INSTRUCTION_SET");
+#endif
+
+    enum SailInstructionSet limit = SAIL_INSTRUCTION_SET_F16C;
+
+    if (env != NULL) {
+        if (strcmp(env, "generic") == 0) {
+            limit = SAIL_INSTRUCTION_SET_GENERIC;
+        } else if (strcmp(env, "ssse3") == 0) {
+            limit = SAIL_INSTRUCTION_SET_SSSE3;
+        } else if (strcmp(env, "avx2") == 0) {
+            limit = SAIL_INSTRUCTION_SET_AVX2;
+        }
+    }
+
+#ifdef _MSC_VER
+    free(env);
+#endif
+
+    return limit;
+}
+#endif
+
+/*
+ * Portable kernels. SIMD kernels process the bulk of a row and finish its tail with them.
+ */
+
+static void swap_rgb24(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t c1 = scan_input[column * 3 + 0];
+        const uint8_t c2 = scan_input[column * 3 + 1];
+        const uint8_t c3 = scan_input[column * 3 + 2];
+
+        scan_output[column * 3 + 0] = c3;
+        scan_output[column * 3 + 1] = c2;
+        scan_output[column * 3 + 2] = c1;
+    }
+}
+
+static void rgb24_to_rgba32(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        scan_output[column * 4 + 0] = scan_input[column * 3 + 0];
+        scan_output[column * 4 + 1] = scan_input[column * 3 + 1];
+        scan_output[column * 4 + 2] = scan_input[column * 3 + 2];
+        scan_output[column * 4 + 3] = 255;
+    }
+}
+
+static void rgb24_to_rgba32_swapped(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        scan_output[column * 4 + 0] = scan_input[column * 3 + 2];
+        scan_output[column * 4 + 1] = scan_input[column * 3 + 1];
+        scan_output[column * 4 + 2] = scan_input[column * 3 + 0];
+        scan_output[column * 4 + 3] = 255;
+    }
+}
+
+static void swap_rgba32(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t c1 = scan_input[column * 4 + 0];
+        const uint8_t c2 = scan_input[column * 4 + 1];
+        const uint8_t c3 = scan_input[column * 4 + 2];
+        const uint8_t c4 = scan_input[column * 4 + 3];
+
+        scan_output[column * 4 + 0] = c3;
+        scan_output[column * 4 + 1] = c2;
+        scan_output[column * 4 + 2] = c1;
+        scan_output[column * 4 + 3] = c4;
+    }
+}
+
+static void rgba32_to_rgb24(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t c1 = scan_input[column * 4 + 0];
+        const uint8_t c2 = scan_input[column * 4 + 1];
+        const uint8_t c3 = scan_input[column * 4 + 2];
+
+        scan_output[column * 3 + 0] = c1;
+        scan_output[column * 3 + 1] = c2;
+        scan_output[column * 3 + 2] = c3;
+    }
+}
+
+static void rgba32_to_rgb24_swapped(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t c1 = scan_input[column * 4 + 0];
+        const uint8_t c2 = scan_input[column * 4 + 1];
+        const uint8_t c3 = scan_input[column * 4 + 2];
+
+        scan_output[column * 3 + 0] = c3;
+        scan_output[column * 3 + 1] = c2;
+        scan_output[column * 3 + 2] = c1;
+    }
+}
+
+static void rgba32_to_rgb24_blend(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint8_t background[3]) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t a  = scan_input[column * 4 + 3];
+        const uint8_t c1 = blend_uint8(scan_input[column * 4 + 0], background[0], a);
+        const uint8_t c2 = blend_uint8(scan_input[column * 4 + 1], background[1], a);
+        const uint8_t c3 = blend_uint8(scan_input[column * 4 + 2], background[2], a);
+
+        scan_output[column * 3 + 0] = c1;
+        scan_output[column * 3 + 1] = c2;
+        scan_output[column * 3 + 2] = c3;
+    }
+}
+
+static void rgba32_to_rgb24_swapped_blend(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint8_t background[3]) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t a  = scan_input[column * 4 + 3];
+        const uint8_t c1 = blend_uint8(scan_input[column * 4 + 0], background[0], a);
+        const uint8_t c2 = blend_uint8(scan_input[column * 4 + 1], background[1], a);
+        const uint8_t c3 = blend_uint8(scan_input[column * 4 + 2], background[2], a);
+
+        scan_output[column * 3 + 0] = c3;
+        scan_output[column * 3 + 1] = c2;
+        scan_output[column * 3 + 2] = c1;
+    }
+}
+
+static void premultiply_rgba32(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t a  = scan_input[column * 4 + 3];
+        const uint8_t c1 = premultiply_uint8(scan_input[column * 4 + 0], a);
+        const uint8_t c2 = premultiply_uint8(scan_input[column * 4 + 1], a);
+        const uint8_t c3 = premultiply_uint8(scan_input[column * 4 + 2], a);
+
+        scan_output[column * 4 + 0] = c1;
+        scan_output[column * 4 + 1] = c2;
+        scan_output[column * 4 + 2] = c3;
+        scan_output[column * 4 + 3] = a;
+    }
+}
+
+static void premultiply_rgba32_swapped(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t a  = scan_input[column * 4 + 3];
+        const uint8_t c1 = premultiply_uint8(scan_input[column * 4 + 0], a);
+        const uint8_t c2 = premultiply_uint8(scan_input[column * 4 + 1], a);
+        const uint8_t c3 = premultiply_uint8(scan_input[column * 4 + 2], a);
+
+        scan_output[column * 4 + 0] = c3;
+        scan_output[column * 4 + 1] = c2;
+        scan_output[column * 4 + 2] = c1;
+        scan_output[column * 4 + 3] = a;
+    }
+}
+
+static void unpremultiply_rgba32(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t a  = scan_input[column * 4 + 3];
+        const uint8_t c1 = unpremultiply_uint8(scan_input[column * 4 + 0], a);
+        const uint8_t c2 = unpremultiply_uint8(scan_input[column * 4 + 1], a);
+        const uint8_t c3 = unpremultiply_uint8(scan_input[column * 4 + 2], a);
+
+        scan_output[column * 4 + 0] = c1;
+        scan_output[column * 4 + 1] = c2;
+        scan_output[column * 4 + 2] = c3;
+        scan_output[column * 4 + 3] = a;
+    }
+}
+
+static void unpremultiply_rgba32_swapped(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t a  = scan_input[column * 4 + 3];
+        const uint8_t c1 = unpremultiply_uint8(scan_input[column * 4 + 0], a);
+        const uint8_t c2 = unpremultiply_uint8(scan_input[column * 4 + 1], a);
+        const uint8_t c3 = unpremultiply_uint8(scan_input[column * 4 + 2], a);
+
+        scan_output[column * 4 + 0] = c3;
+        scan_output[column * 4 + 1] = c2;
+        scan_output[column * 4 + 2] = c1;
+        scan_output[column * 4 + 3] = a;
+    }
+}
+
+static void rgb24_to_gray8(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint16_t weights[3]) {
+
+    for (unsigned column = 0; column < width; column++) {
+        scan_output[column] = (uint8_t)luma(weights, scan_input[column * 3 + 0], scan_input[column * 3 + 1], scan_input[column * 3 + 2]);
+    }
+}
+
+static void rgba32_to_gray8(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint16_t weights[3]) {
+
+    for (unsigned column = 0; column < width; column++) {
+        scan_output[column] = (uint8_t)luma(weights, scan_input[column * 4 + 0], scan_input[column * 4 + 1], scan_input[column * 4 + 2]);
+    }
+}
+
+static void rgb48_to_gray16(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint16_t weights[3]) {
+
+    const uint16_t *scan_input16  = (const uint16_t *)scan_input;
+          uint16_t *scan_output16 = (uint16_t *)scan_output;
+
+    for (unsigned column = 0; column < width; column++) {
+        scan_output16[column] = (uint16_t)luma(weights, scan_input16[column * 3 + 0], scan_input16[column * 3 + 1], scan_input16[column * 3 + 2]);
+    }
+}
+
+static void rgba64_to_gray16(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint16_t weights[3]) {
+
+    const uint16_t *scan_input16  = (const uint16_t *)scan_input;
+          uint16_t *scan_output16 = (uint16_t *)scan_output;
+
+    for (unsigned column = 0; column < width; column++) {
+        scan_output16[column] = (uint16_t)luma(weights, scan_input16[column * 4 + 0], scan_input16[column * 4 + 1], scan_input16[column * 4 + 2]);
+    }
+}
+
+static void gray8_to_rgb24(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t value = scan_input[column];
+
+        scan_output[column * 3 + 0] = value;
+        scan_output[column * 3 + 1] = value;
+        scan_output[column * 3 + 2] = value;
+    }
+}
+
+/*
+ * (v + t) / 257 is computed as (s - (s >> 8)) >> 8 with s = v + t saturated to 65535.
+ * It's exact for all 16-bit sums, and saturation doesn't change the result for t < 257.
+ */
+static void narrow_row(const uint8_t *scan_input, uint8_t *scan_output, unsigned length, const uint16_t *thresholds) {
+
+    const uint16_t *scan_input16 = (const uint16_t *)scan_input;
+
+    for (unsigned i = 0; i < length; i++) {
+        const unsigned sum = SAIL_MIN(scan_input16[i] + thresholds[i % SAIL_NARROW_THRESHOLDS_LENGTH], 65535U);
+
+        scan_output[i] = (uint8_t)((sum - (sum >> 8)) >> 8);
+    }
+}
+
+static void ycbcr24_to_rgb24(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        sail_rgba32_t rgba32;
+        convert_ycbcr24_to_rgba32(scan_input[column * 3 + 0], scan_input[column * 3 + 1], scan_input[column * 3 + 2], &rgba32);
+
+        scan_output[column * 3 + 0] = rgba32.component1;
+        scan_output[column * 3 + 1] = rgba32.component2;
+        scan_output[column * 3 + 2] = rgba32.component3;
+    }
+}
+
+static void cmyk32_to_rgb24(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        sail_rgba32_t rgba32;
+        convert_cmyk32_to_rgba32(scan_input[column * 4 + 0], scan_input[column * 4 + 1],
+                                 scan_input[column * 4 + 2], scan_input[column * 4 + 3], &rgba32);
+
+        scan_output[column * 3 + 0] = rgba32.component1;
+        scan_output[column * 3 + 1] = rgba32.component2;
+        scan_output[column * 3 + 2] = rgba32.component3;
+    }
+}
+
+static void ycck32_to_rgb24(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        sail_rgba32_t rgba32;
+        convert_ycck32_to_rgba32(scan_input[column * 4 + 0], scan_input[column * 4 + 1],
+                                 scan_input[column * 4 + 2], scan_input[column * 4 + 3], &rgba32);
+
+        scan_output[column * 3 + 0] = rgba32.component1;
+        scan_output[column * 3 + 1] = rgba32.component2;
+        scan_output[column * 3 + 2] = rgba32.component3;
+    }
+}
+
+static void ycbcr24_to_rgba32(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        convert_ycbcr24_to_rgba32(scan_input[column * 3 + 0], scan_input[column * 3 + 1], scan_input[column * 3 + 2],
+                                  (sail_rgba32_t *)(scan_output + column * 4));
+    }
+}
+
+static void cmyk32_to_rgba32(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        convert_cmyk32_to_rgba32(scan_input[column * 4 + 0], scan_input[column * 4 + 1],
+                                 scan_input[column * 4 + 2], scan_input[column * 4 + 3],
+                                 (sail_rgba32_t *)(scan_output + column * 4));
+    }
+}
+
+static void ycck32_to_rgba32(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    for (unsigned column = 0; column < width; column++) {
+        convert_ycck32_to_rgba32(scan_input[column * 4 + 0], scan_input[column * 4 + 1],
+                                 scan_input[column * 4 + 2], scan_input[column * 4 + 3],
+                                 (sail_rgba32_t *)(scan_output + column * 4));
+    }
+}
+
+static inline uint8_t filtered_uint8(int32_t sum) {
+
+    sum += 1 << (SAIL_FILTER_WEIGHT_BITS - 1);
+
+    if (sum < 0) {
+        return 0;
+    }
+
+    sum >>= SAIL_FILTER_WEIGHT_BITS;
+
+    return (sum > 255) ? 255 : (uint8_t)sum;
+}
+
+static void filter_rows(const uint8_t *scan_input, size_t stride, unsigned count, const int16_t *weights,
+                        uint8_t *scan_output, unsigned length) {
+
+    for (unsigned i = 0; i < length; i++) {
+        int32_t sum = 0;
+
+        for (unsigned k = 0; k < count; k++) {
+            sum += scan_input[k * stride + i] * weights[k];
+        }
+
+        scan_output[i] = filtered_uint8(sum);
+    }
+}
+
+static inline void filter_columns_components(const uint8_t *scan_input, uint8_t *scan_output, unsigned width,
+                                             const unsigned *firsts, const unsigned *counts, const int16_t *weights,
+                                             unsigned weights_stride, unsigned components) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t *input = scan_input + firsts[column] * components;
+        const int16_t *column_weights = weights + column * weights_stride;
+        int32_t sums[4] = { 0, 0, 0, 0 };
+
+        for (unsigned k = 0; k < counts[column]; k++) {
+            for (unsigned c = 0; c < components; c++) {
+                sums[c] += input[k * components + c] * column_weights[k];
+            }
+        }
+
+        for (unsigned c = 0; c < components; c++) {
+            scan_output[column * components + c] = filtered_uint8(sums[c]);
+        }
+    }
+}
+
+static void filter_columns_1(const uint8_t *scan_input, uint8_t *scan_output, unsigned width,
+                             const unsigned *firsts, const unsigned *counts, const int16_t *weights, unsigned weights_stride) {
+
+    filter_columns_components(scan_input, scan_output, width, firsts, counts, weights, weights_stride, 1);
+}
+
+static void filter_columns_2(const uint8_t *scan_input, uint8_t *scan_output, unsigned width,
+                             const unsigned *firsts, const unsigned *counts, const int16_t *weights, unsigned weights_stride) {
+
+    filter_columns_components(scan_input, scan_output, width, firsts, counts, weights, weights_stride, 2);
+}
+
+static void filter_columns_3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width,
+                             const unsigned *firsts, const unsigned *counts, const int16_t *weights, unsigned weights_stride) {
+
+    filter_columns_components(scan_input, scan_output, width, firsts, counts, weights, weights_stride, 3);
+}
+
+static void filter_columns_4(const uint8_t *scan_input, uint8_t *scan_output, unsigned width,
+                             const unsigned *firsts, const unsigned *counts, const int16_t *weights, unsigned weights_stride) {
+
+    filter_columns_components(scan_input, scan_output, width, firsts, counts, weights, weights_stride, 4);
+}
+
+static uint64_t squared_differences(const uint8_t *scan1, const uint8_t *scan2, unsigned length) {
+
+    uint64_t sum = 0;
+
+    for (unsigned i = 0; i < length; i++) {
+        const int difference = (int)scan1[i] - (int)scan2[i];
+        sum += (uint64_t)(difference * difference);
+    }
+
+    return sum;
+}
+
+/*
+ * Half precision and floating point components. The conversions are the functions from manip_utils.h,
+ * and the SIMD kernels compute them with the same single precision operations.
+ */
+static void half_to_float_components(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const uint16_t *scan_input16       = (const uint16_t *)scan_input;
+          float    *scan_output_float = (float *)scan_output;
+
+    for (unsigned i = 0; i < length; i++) {
+        scan_output_float[i] = half_to_float(scan_input16[i]);
+    }
+}
+
+static void float_to_half_components(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const float    *scan_input_float = (const float *)scan_input;
+          uint16_t *scan_output16    = (uint16_t *)scan_output;
+
+    for (unsigned i = 0; i < length; i++) {
+        scan_output16[i] = float_to_half(scan_input_float[i]);
+    }
+}
+
+static void uint16_to_half_components(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const uint16_t *scan_input16  = (const uint16_t *)scan_input;
+          uint16_t *scan_output16 = (uint16_t *)scan_output;
+
+    for (unsigned i = 0; i < length; i++) {
+        scan_output16[i] = float_to_half(uint16_to_float(scan_input16[i]));
+    }
+}
+
+static void half_to_uint16_components(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const uint16_t *scan_input16  = (const uint16_t *)scan_input;
+          uint16_t *scan_output16 = (uint16_t *)scan_output;
+
+    for (unsigned i = 0; i < length; i++) {
+        scan_output16[i] = float_to_uint16(half_to_float(scan_input16[i]));
+    }
+}
+
+static void uint16_to_float_components(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const uint16_t *scan_input16      = (const uint16_t *)scan_input;
+          float    *scan_output_float = (float *)scan_output;
+
+    for (unsigned i = 0; i < length; i++) {
+        scan_output_float[i] = uint16_to_float(scan_input16[i]);
+    }
+}
+
+static void float_to_uint16_components(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const float    *scan_input_float = (const float *)scan_input;
+          uint16_t *scan_output16    = (uint16_t *)scan_output;
+
+    for (unsigned i = 0; i < length; i++) {
+        scan_output16[i] = float_to_uint16(scan_input_float[i]);
+    }
+}
+
+static void rgba_half_to_rgba_float(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    half_to_float_components(scan_input, scan_output, width * 4);
+}
+
+static void rgba_float_to_rgba_half(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    float_to_half_components(scan_input, scan_output, width * 4);
+}
+
+static void rgba64_to_rgba_half(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    uint16_to_half_components(scan_input, scan_output, width * 4);
+}
+
+static void rgba_half_to_rgba64(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    half_to_uint16_components(scan_input, scan_output, width * 4);
+}
+
+static void rgba64_to_rgba_float(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    uint16_to_float_components(scan_input, scan_output, width * 4);
+}
+
+static void rgba_float_to_rgba64(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    float_to_uint16_components(scan_input, scan_output, width * 4);
+}
+
+/*
+ * YCbCr, YCCK, and CMYK kernels use the fixed-point form of the tables in ycbcr.c and ycck.c:
+ * round(K * d) == (K * 32768 * d + 16384) >> 15 for all the table entries, which is what
+ * _mm_mulhrs_epi16() and vqrdmulhq_s16() compute. Factors above 1 are split into d + mulhrs(d, K - 1).
+ * The results are identical to the scalar functions.
+ */
+#define SAIL_CR_R_FRACTION 13173 /* 1.40200 * 32768 - 32768 */
+#define SAIL_CB_G_FACTOR   11277 /* 0.34414 * 32768 */
+#define SAIL_CR_G_FACTOR   23401 /* 0.71414 * 32768 */
+#define SAIL_CB_B_FRACTION 25297 /* 1.77200 * 32768 - 32768 */
+
+#ifdef SAIL_ROW_KERNELS_X86
+
+/*
+ * SSSE3 kernels. 24-bit pixels are processed four at a time and stored with exact 8+4-byte stores,
+ * so the kernels never write past the converted pixels and stay safe in place.
+ */
+
+SAIL_TARGET("ssse3")
+static inline void store_12_bytes(uint8_t *scan_output, __m128i value) {
+
+    _mm_storel_epi64((__m128i *)scan_output, value);
+
+    const int last = _mm_cvtsi128_si32(_mm_srli_si128(value, 8));
+    memcpy(scan_output + 8, &last, sizeof(last));
+}
+
+SAIL_TARGET("ssse3")
+static void swap_rgb24_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, -1, -1, -1, -1);
+    unsigned column = 0;
+
+    /* 16-byte loads read 5.33 pixels. */
+    for (; column + 6 <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(scan_input + column * 3));
+        store_12_bytes(scan_output + column * 3, _mm_shuffle_epi8(pixels, mask));
+    }
+
+    swap_rgb24(scan_input + column * 3, scan_output + column * 3, width - column);
+}
+
+SAIL_TARGET("ssse3")
+static void rgb24_to_rgba32_kind_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, __m128i mask, row_kernel_t tail) {
+
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    unsigned column = 0;
+
+    for (; column + 6 <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(scan_input + column * 3));
+        _mm_storeu_si128((__m128i *)(scan_output + column * 4), _mm_or_si128(_mm_shuffle_epi8(pixels, mask), alpha));
+    }
+
+    tail(scan_input + column * 3, scan_output + column * 4, width - column);
+}
+
+SAIL_TARGET("ssse3")
+static void rgb24_to_rgba32_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    rgb24_to_rgba32_kind_ssse3(scan_input, scan_output, width,
+                               _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1), rgb24_to_rgba32);
+}
+
+SAIL_TARGET("ssse3")
+static void rgb24_to_rgba32_swapped_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    rgb24_to_rgba32_kind_ssse3(scan_input, scan_output, width,
+                               _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1), rgb24_to_rgba32_swapped);
+}
+
+SAIL_TARGET("ssse3")
+static void swap_rgba32_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    unsigned column = 0;
+
+    for (; column + 4 <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(scan_input + column * 4));
+        _mm_storeu_si128((__m128i *)(scan_output + column * 4), _mm_shuffle_epi8(pixels, mask));
+    }
+
+    swap_rgba32(scan_input + column * 4, scan_output + column * 4, width - column);
+}
+
+SAIL_TARGET("ssse3")
+static void rgba32_to_rgb24_kind_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, __m128i mask, row_kernel_t tail) {
+
+    unsigned column = 0;
+
+    for (; column + 4 <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(scan_input + column * 4));
+        store_12_bytes(scan_output + column * 3, _mm_shuffle_epi8(pixels, mask));
+    }
+
+    tail(scan_input + column * 4, scan_output + column * 3, width - column);
+}
+
+SAIL_TARGET("ssse3")
+static void rgba32_to_rgb24_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    rgba32_to_rgb24_kind_ssse3(scan_input, scan_output, width,
+                               _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1), rgba32_to_rgb24);
+}
+
+SAIL_TARGET("ssse3")
+static void rgba32_to_rgb24_swapped_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    rgba32_to_rgb24_kind_ssse3(scan_input, scan_output, width,
+                               _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1), rgba32_to_rgb24_swapped);
+}
+
+/* Divides 16-bit values up to 65152 by 255 exactly as (value + 1 + (value >> 8)) >> 8. */
+SAIL_TARGET("ssse3")
+static inline __m128i divide_by_255_ssse3(__m128i value) {
+
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(value, _mm_set1_epi16(1)), _mm_srli_epi16(value, 8)), 8);
+}
+
+/* Blends two RGBA pixels extended to 16 bits. Alpha of the result is not used. */
+SAIL_TARGET("ssse3")
+static inline __m128i blend_2_pixels_ssse3(__m128i pixels, __m128i background) {
+
+    const __m128i alpha_mask = _mm_setr_epi8(6, 7, 6, 7, 6, 7, 6, 7, 14, 15, 14, 15, 14, 15, 14, 15);
+
+    const __m128i alpha    = _mm_shuffle_epi8(pixels, alpha_mask);
+    const __m128i inverted = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+
+    const __m128i value = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(pixels, alpha), _mm_mullo_epi16(background, inverted)),
+                                        _mm_set1_epi16(127));
+
+    return divide_by_255_ssse3(value);
+}
+
+SAIL_TARGET("ssse3")
+static void rgba32_to_rgb24_blend_kind_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint8_t background[3],
+                                             __m128i mask, blend_row_kernel_t tail) {
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i background16 = _mm_setr_epi16(background[0], background[1], background[2], 0,
+                                                background[0], background[1], background[2], 0);
+    unsigned column = 0;
+
+    for (; column + 4 <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(scan_input + column * 4));
+
+        const __m128i blended1 = blend_2_pixels_ssse3(_mm_unpacklo_epi8(pixels, zero), background16);
+        const __m128i blended2 = blend_2_pixels_ssse3(_mm_unpackhi_epi8(pixels, zero), background16);
+
+        store_12_bytes(scan_output + column * 3, _mm_shuffle_epi8(_mm_packus_epi16(blended1, blended2), mask));
+    }
+
+    tail(scan_input + column * 4, scan_output + column * 3, width - column, background);
+}
+
+SAIL_TARGET("ssse3")
+static void rgba32_to_rgb24_blend_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint8_t background[3]) {
+
+    rgba32_to_rgb24_blend_kind_ssse3(scan_input, scan_output, width, background,
+                                     _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1), rgba32_to_rgb24_blend);
+}
+
+SAIL_TARGET("ssse3")
+static void rgba32_to_rgb24_swapped_blend_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint8_t background[3]) {
+
+    rgba32_to_rgb24_blend_kind_ssse3(scan_input, scan_output, width, background,
+                                     _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1), rgba32_to_rgb24_swapped_blend);
+}
+
+/* Premultiplies two RGBA pixels extended to 16 bits. Alpha is multiplied by 255, so it doesn't change. */
+SAIL_TARGET("ssse3")
+static inline __m128i premultiply_2_pixels_ssse3(__m128i pixels) {
+
+    const __m128i alpha_mask = _mm_setr_epi8(6, 7, 6, 7, 6, 7, -1, -1, 14, 15, 14, 15, 14, 15, -1, -1);
+
+    const __m128i alpha = _mm_or_si128(_mm_shuffle_epi8(pixels, alpha_mask), _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255));
+
+    return divide_by_255_ssse3(_mm_add_epi16(_mm_mullo_epi16(pixels, alpha), _mm_set1_epi16(127)));
+}
+
+SAIL_TARGET("ssse3")
+static void premultiply_rgba32_kind_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, __m128i mask, row_kernel_t tail) {
+
+    const __m128i zero = _mm_setzero_si128();
+    unsigned column = 0;
+
+    for (; column + 4 <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(scan_input + column * 4));
+
+        const __m128i premultiplied1 = premultiply_2_pixels_ssse3(_mm_unpacklo_epi8(pixels, zero));
+        const __m128i premultiplied2 = premultiply_2_pixels_ssse3(_mm_unpackhi_epi8(pixels, zero));
+
+        _mm_storeu_si128((__m128i *)(scan_output + column * 4), _mm_shuffle_epi8(_mm_packus_epi16(premultiplied1, premultiplied2), mask));
+    }
+
+    tail(scan_input + column * 4, scan_output + column * 4, width - column);
+}
+
+SAIL_TARGET("ssse3")
+static void premultiply_rgba32_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    premultiply_rgba32_kind_ssse3(scan_input, scan_output, width,
+                                  _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), premultiply_rgba32);
+}
+
+SAIL_TARGET("ssse3")
+static void premultiply_rgba32_swapped_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    premultiply_rgba32_kind_ssse3(scan_input, scan_output, width,
+                                  _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15), premultiply_rgba32_swapped);
+}
+
+/*
+ * Unpremultiplies a pixel given as 32-bit components. The float division is correctly rounded,
+ * and (c * 255 + a / 2) / a never gets closer than 1 / a to the next integer, so truncating it
+ * gives the exact integer quotient. Zero alpha produces the integer indefinite value that
+ * is saturated to 0 later. The alpha component of the result is not used.
+ */
+SAIL_TARGET("ssse3")
+static inline __m128i unpremultiply_pixel_ssse3(__m128i pixel) {
+
+    const __m128i alpha = _mm_shuffle_epi32(pixel, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128i value = _mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(pixel, 8), pixel), _mm_srli_epi32(alpha, 1));
+
+    return _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(value), _mm_cvtepi32_ps(alpha)));
+}
+
+SAIL_TARGET("ssse3")
+static void unpremultiply_rgba32_kind_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, __m128i mask, row_kernel_t tail) {
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_mask = _mm_set1_epi32((int)0xFF000000);
+    unsigned column = 0;
+
+    for (; column + 4 <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(scan_input + column * 4));
+
+        const __m128i pixels1 = _mm_unpacklo_epi8(pixels, zero);
+        const __m128i pixels2 = _mm_unpackhi_epi8(pixels, zero);
+
+        /* Signed saturation turns invalid quotients into negative values, and unsigned saturation clamps them. */
+        const __m128i unpremultiplied1 = _mm_packs_epi32(unpremultiply_pixel_ssse3(_mm_unpacklo_epi16(pixels1, zero)),
+                                                         unpremultiply_pixel_ssse3(_mm_unpackhi_epi16(pixels1, zero)));
+        const __m128i unpremultiplied2 = _mm_packs_epi32(unpremultiply_pixel_ssse3(_mm_unpacklo_epi16(pixels2, zero)),
+                                                         unpremultiply_pixel_ssse3(_mm_unpackhi_epi16(pixels2, zero)));
+
+        const __m128i unpremultiplied = _mm_or_si128(_mm_andnot_si128(alpha_mask, _mm_packus_epi16(unpremultiplied1, unpremultiplied2)),
+                                                     _mm_and_si128(alpha_mask, pixels));
+
+        _mm_storeu_si128((__m128i *)(scan_output + column * 4), _mm_shuffle_epi8(unpremultiplied, mask));
+    }
+
+    tail(scan_input + column * 4, scan_output + column * 4, width - column);
+}
+
+SAIL_TARGET("ssse3")
+static void unpremultiply_rgba32_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unpremultiply_rgba32_kind_ssse3(scan_input, scan_output, width,
+                                    _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), unpremultiply_rgba32);
+}
+
+SAIL_TARGET("ssse3")
+static void unpremultiply_rgba32_swapped_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unpremultiply_rgba32_kind_ssse3(scan_input, scan_output, width,
+                                    _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15), unpremultiply_rgba32_swapped);
+}
+
+/*
+ * Extracts the component at 'offset' of 8 pixels of 'bytes_per_pixel' bytes as 16-bit values.
+ * 'pixels1' holds the first four pixels, 'pixels2' holds the next four pixels.
+ */
+SAIL_TARGET("ssse3")
+static inline __m128i extract_8_components_ssse3(__m128i pixels1, __m128i pixels2, char bytes_per_pixel, char offset) {
+
+    const char o0 = offset;
+    const char o1 = (char)(offset + bytes_per_pixel);
+    const char o2 = (char)(offset + bytes_per_pixel * 2);
+    const char o3 = (char)(offset + bytes_per_pixel * 3);
+
+    return _mm_or_si128(_mm_shuffle_epi8(pixels1, _mm_setr_epi8(o0, -1, o1, -1, o2, -1, o3, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+                        _mm_shuffle_epi8(pixels2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, o0, -1, o1, -1, o2, -1, o3, -1)));
+}
+
+/* Saturates 8 pixels given as 16-bit components and stores them as RGB24 or RGBA32 with opaque alpha. */
+SAIL_TARGET("ssse3")
+static inline void store_8_rgb_pixels_ssse3(uint8_t *scan_output, __m128i r, __m128i g, __m128i b, bool rgba) {
+
+    const __m128i rg = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_packus_epi16(g, g));
+    const __m128i ba = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_set1_epi8((char)0xFF));
+
+    const __m128i pixels1 = _mm_unpacklo_epi16(rg, ba);
+    const __m128i pixels2 = _mm_unpackhi_epi16(rg, ba);
+
+    if (rgba) {
+        _mm_storeu_si128((__m128i *)scan_output, pixels1);
+        _mm_storeu_si128((__m128i *)(scan_output + 16), pixels2);
+    } else {
+        const __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+        store_12_bytes(scan_output, _mm_shuffle_epi8(pixels1, mask));
+        store_12_bytes(scan_output + 12, _mm_shuffle_epi8(pixels2, mask));
+    }
+}
+
+/* Computes unclamped R, G, and B of 8 pixels. YCbCr passes Cb and Cr centered around 0, YCCK passes them as is. */
+SAIL_TARGET("ssse3")
+static inline void ycbcr_8_pixels_ssse3(__m128i y, __m128i cb, __m128i cr, __m128i *r, __m128i *g, __m128i *b) {
+
+    *r = _mm_add_epi16(_mm_add_epi16(y, cr), _mm_mulhrs_epi16(cr, _mm_set1_epi16(SAIL_CR_R_FRACTION)));
+    *g = _mm_sub_epi16(_mm_sub_epi16(y, _mm_mulhrs_epi16(cb, _mm_set1_epi16(SAIL_CB_G_FACTOR))),
+                       _mm_mulhrs_epi16(cr, _mm_set1_epi16(SAIL_CR_G_FACTOR)));
+    *b = _mm_add_epi16(_mm_add_epi16(y, cb), _mm_mulhrs_epi16(cb, _mm_set1_epi16(SAIL_CB_B_FRACTION)));
+}
+
+SAIL_TARGET("ssse3")
+static void ycbcr24_to_rgb_kind_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, bool rgba, row_kernel_t tail) {
+
+    const __m128i half = _mm_set1_epi16(128);
+    const unsigned output_bytes_per_pixel = rgba ? 4 : 3;
+    unsigned column = 0;
+
+    /* The second load reads 4 bytes past the 8 pixels. */
+    for (; column + 10 <= width; column += 8) {
+        const __m128i pixels1 = _mm_loadu_si128((const __m128i *)(scan_input + column * 3));
+        const __m128i pixels2 = _mm_loadu_si128((const __m128i *)(scan_input + column * 3 + 12));
+
+        const __m128i y  = extract_8_components_ssse3(pixels1, pixels2, 3, 0);
+        const __m128i cb = _mm_sub_epi16(extract_8_components_ssse3(pixels1, pixels2, 3, 1), half);
+        const __m128i cr = _mm_sub_epi16(extract_8_components_ssse3(pixels1, pixels2, 3, 2), half);
+
+        __m128i r, g, b;
+        ycbcr_8_pixels_ssse3(y, cb, cr, &r, &g, &b);
+
+        store_8_rgb_pixels_ssse3(scan_output + column * output_bytes_per_pixel, r, g, b, rgba);
+    }
+
+    tail(scan_input + column * 3, scan_output + column * output_bytes_per_pixel, width - column);
+}
+
+SAIL_TARGET("ssse3")
+static void ycbcr24_to_rgb24_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    ycbcr24_to_rgb_kind_ssse3(scan_input, scan_output, width, false, ycbcr24_to_rgb24);
+}
+
+SAIL_TARGET("ssse3")
+static void ycbcr24_to_rgba32_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    ycbcr24_to_rgb_kind_ssse3(scan_input, scan_output, width, true, ycbcr24_to_rgba32);
+}
+
+/* (c * k + 127) / 255 is the blending of C, M, and Y with K as alpha over the black background. */
+SAIL_TARGET("ssse3")
+static void cmyk32_to_rgb_kind_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, bool rgba, row_kernel_t tail) {
+
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i mask  = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const unsigned output_bytes_per_pixel = rgba ? 4 : 3;
+    unsigned column = 0;
+
+    for (; column + 4 <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(scan_input + column * 4));
+
+        const __m128i converted1 = blend_2_pixels_ssse3(_mm_unpacklo_epi8(pixels, zero), zero);
+        const __m128i converted2 = blend_2_pixels_ssse3(_mm_unpackhi_epi8(pixels, zero), zero);
+        const __m128i converted  = _mm_packus_epi16(converted1, converted2);
+
+        if (rgba) {
+            const __m128i opaque = _mm_or_si128(converted, alpha);
+            _mm_storeu_si128((__m128i *)(scan_output + column * 4), opaque);
+        } else {
+            store_12_bytes(scan_output + column * 3, _mm_shuffle_epi8(converted, mask));
+        }
+    }
+
+    tail(scan_input + column * 4, scan_output + column * output_bytes_per_pixel, width - column);
+}
+
+SAIL_TARGET("ssse3")
+static void cmyk32_to_rgb24_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    cmyk32_to_rgb_kind_ssse3(scan_input, scan_output, width, false, cmyk32_to_rgb24);
+}
+
+SAIL_TARGET("ssse3")
+static void cmyk32_to_rgba32_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    cmyk32_to_rgb_kind_ssse3(scan_input, scan_output, width, true, cmyk32_to_rgba32);
+}
+
+/* Clamps YCCK color components to 0..255, inverts them, and applies K as CMYK does. */
+SAIL_TARGET("ssse3")
+static inline __m128i ycck_component_ssse3(__m128i value, __m128i k) {
+
+    const __m128i max      = _mm_set1_epi16(255);
+    const __m128i clamped  = _mm_min_epi16(_mm_max_epi16(value, _mm_setzero_si128()), max);
+    const __m128i inverted = _mm_sub_epi16(max, clamped);
+
+    return divide_by_255_ssse3(_mm_add_epi16(_mm_mullo_epi16(inverted, k), _mm_set1_epi16(127)));
+}
+
+SAIL_TARGET("ssse3")
+static void ycck32_to_rgb_kind_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, bool rgba, row_kernel_t tail) {
+
+    const unsigned output_bytes_per_pixel = rgba ? 4 : 3;
+    unsigned column = 0;
+
+    for (; column + 8 <= width; column += 8) {
+        const __m128i pixels1 = _mm_loadu_si128((const __m128i *)(scan_input + column * 4));
+        const __m128i pixels2 = _mm_loadu_si128((const __m128i *)(scan_input + column * 4 + 16));
+
+        const __m128i y  = extract_8_components_ssse3(pixels1, pixels2, 4, 0);
+        const __m128i cb = extract_8_components_ssse3(pixels1, pixels2, 4, 1);
+        const __m128i cr = extract_8_components_ssse3(pixels1, pixels2, 4, 2);
+        const __m128i k  = extract_8_components_ssse3(pixels1, pixels2, 4, 3);
+
+        __m128i r, g, b;
+        ycbcr_8_pixels_ssse3(y, cb, cr, &r, &g, &b);
+
+        /* The exact integer forms of -179.456, +135.45984, and -226.816 after truncating in ycck.c. */
+        r = ycck_component_ssse3(_mm_sub_epi16(r, _mm_set1_epi16(180)), k);
+        g = ycck_component_ssse3(_mm_add_epi16(g, _mm_set1_epi16(135)), k);
+        b = ycck_component_ssse3(_mm_sub_epi16(b, _mm_set1_epi16(227)), k);
+
+        store_8_rgb_pixels_ssse3(scan_output + column * output_bytes_per_pixel, r, g, b, rgba);
+    }
+
+    tail(scan_input + column * 4, scan_output + column * output_bytes_per_pixel, width - column);
+}
+
+SAIL_TARGET("ssse3")
+static void ycck32_to_rgb24_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    ycck32_to_rgb_kind_ssse3(scan_input, scan_output, width, false, ycck32_to_rgb24);
+}
+
+SAIL_TARGET("ssse3")
+static void ycck32_to_rgba32_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    ycck32_to_rgb_kind_ssse3(scan_input, scan_output, width, true, ycck32_to_rgba32);
+}
+
+/* Computes luma of four pixels given as two pairs of 16-bit components. */
+SAIL_TARGET("ssse3")
+static inline void store_luma_4_pixels_ssse3(uint8_t *scan_output, __m128i pixels1, __m128i pixels2, __m128i weights) {
+
+    const __m128i sum  = _mm_hadd_epi32(_mm_madd_epi16(pixels1, weights), _mm_madd_epi16(pixels2, weights));
+    const __m128i luma = _mm_srli_epi32(_mm_add_epi32(sum, _mm_set1_epi32(16384)), 15);
+
+    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(luma, luma), _mm_setzero_si128());
+    const int values = _mm_cvtsi128_si32(packed);
+    memcpy(scan_output, &values, sizeof(values));
+}
+
+SAIL_TARGET("ssse3")
+static void rgb24_to_gray8_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint16_t weights[3]) {
+
+    const __m128i mask1 = _mm_setr_epi8(0, -1, 1, -1, 2, -1, -1, -1, 3, -1, 4, -1, 5, -1, -1, -1);
+    const __m128i mask2 = _mm_setr_epi8(6, -1, 7, -1, 8, -1, -1, -1, 9, -1, 10, -1, 11, -1, -1, -1);
+    const __m128i weights16 = _mm_setr_epi16((short)weights[0], (short)weights[1], (short)weights[2], 0,
+                                             (short)weights[0], (short)weights[1], (short)weights[2], 0);
+    unsigned column = 0;
+
+    for (; column + 6 <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(scan_input + column * 3));
+        store_luma_4_pixels_ssse3(scan_output + column, _mm_shuffle_epi8(pixels, mask1), _mm_shuffle_epi8(pixels, mask2), weights16);
+    }
+
+    rgb24_to_gray8(scan_input + column * 3, scan_output + column, width - column, weights);
+}
+
+SAIL_TARGET("ssse3")
+static void rgba32_to_gray8_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint16_t weights[3]) {
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weights16 = _mm_setr_epi16((short)weights[0], (short)weights[1], (short)weights[2], 0,
+                                             (short)weights[0], (short)weights[1], (short)weights[2], 0);
+    unsigned column = 0;
+
+    for (; column + 4 <= width; column += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(scan_input + column * 4));
+        store_luma_4_pixels_ssse3(scan_output + column, _mm_unpacklo_epi8(pixels, zero), _mm_unpackhi_epi8(pixels, zero), weights16);
+    }
+
+    rgba32_to_gray8(scan_input + column * 4, scan_output + column, width - column, weights);
+}
+
+SAIL_TARGET("ssse3")
+static void gray8_to_rgb24_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    const __m128i mask1 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+    const __m128i mask2 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+    const __m128i mask3 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const __m128i values = _mm_loadu_si128((const __m128i *)(scan_input + column));
+        uint8_t *output = scan_output + column * 3;
+
+        _mm_storeu_si128((__m128i *)(output + 0),  _mm_shuffle_epi8(values, mask1));
+        _mm_storeu_si128((__m128i *)(output + 16), _mm_shuffle_epi8(values, mask2));
+        _mm_storeu_si128((__m128i *)(output + 32), _mm_shuffle_epi8(values, mask3));
+    }
+
+    gray8_to_rgb24(scan_input + column, scan_output + column * 3, width - column);
+}
+
+SAIL_TARGET("ssse3")
+static inline __m128i narrow_8_components_ssse3(__m128i values, __m128i thresholds) {
+
+    const __m128i sums = _mm_adds_epu16(values, thresholds);
+
+    return _mm_srli_epi16(_mm_sub_epi16(sums, _mm_srli_epi16(sums, 8)), 8);
+}
+
+SAIL_TARGET("ssse3")
+static void narrow_row_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned length, const uint16_t *thresholds) {
+
+    unsigned i = 0;
+
+    /* SAIL_NARROW_THRESHOLDS_LENGTH is a multiple of 16, so the thresholds are never split. */
+    for (; i + 16 <= length; i += 16) {
+        const uint16_t *row_thresholds = thresholds + i % SAIL_NARROW_THRESHOLDS_LENGTH;
+
+        const __m128i values1 = narrow_8_components_ssse3(_mm_loadu_si128((const __m128i *)(scan_input + i * 2)),
+                                                          _mm_loadu_si128((const __m128i *)row_thresholds));
+        const __m128i values2 = narrow_8_components_ssse3(_mm_loadu_si128((const __m128i *)(scan_input + i * 2 + 16)),
+                                                          _mm_loadu_si128((const __m128i *)(row_thresholds + 8)));
+
+        _mm_storeu_si128((__m128i *)(scan_output + i), _mm_packus_epi16(values1, values2));
+    }
+
+    narrow_row(scan_input + i * 2, scan_output + i, length - i, thresholds + i % SAIL_NARROW_THRESHOLDS_LENGTH);
+}
+
+/*
+ * Scaling filters. Pairs of 8-bit components widened to 16 bits are multiplied by pairs of weights
+ * with _mm_madd_epi16(), and the exact 32-bit sums are rounded like in filtered_uint8().
+ */
+SAIL_TARGET("ssse3")
+static inline __m128i filtered_4_sums_ssse3(__m128i sums) {
+
+    return _mm_srai_epi32(_mm_add_epi32(sums, _mm_set1_epi32(1 << (SAIL_FILTER_WEIGHT_BITS - 1))), SAIL_FILTER_WEIGHT_BITS);
+}
+
+SAIL_TARGET("ssse3")
+static inline __m128i weights_pair_ssse3(int16_t weight1, int16_t weight2) {
+
+    return _mm_set1_epi32((int)((uint32_t)(uint16_t)weight1 | ((uint32_t)(uint16_t)weight2 << 16)));
+}
+
+SAIL_TARGET("ssse3")
+static void filter_rows_ssse3(const uint8_t *scan_input, size_t stride, unsigned count, const int16_t *weights,
+                              uint8_t *scan_output, unsigned length) {
+
+    const __m128i zero = _mm_setzero_si128();
+    unsigned i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m128i sums[4] = { zero, zero, zero, zero };
+
+        for (unsigned k = 0; k < count; k += 2) {
+            const __m128i values1 = _mm_loadu_si128((const __m128i *)(scan_input + k * stride + i));
+            const __m128i values2 = (k + 1 < count) ? _mm_loadu_si128((const __m128i *)(scan_input + (k + 1) * stride + i)) : zero;
+            const __m128i pair    = weights_pair_ssse3(weights[k], (k + 1 < count) ? weights[k + 1] : 0);
+
+            const __m128i low1  = _mm_unpacklo_epi8(values1, zero);
+            const __m128i high1 = _mm_unpackhi_epi8(values1, zero);
+            const __m128i low2  = _mm_unpacklo_epi8(values2, zero);
+            const __m128i high2 = _mm_unpackhi_epi8(values2, zero);
+
+            sums[0] = _mm_add_epi32(sums[0], _mm_madd_epi16(_mm_unpacklo_epi16(low1, low2), pair));
+            sums[1] = _mm_add_epi32(sums[1], _mm_madd_epi16(_mm_unpackhi_epi16(low1, low2), pair));
+            sums[2] = _mm_add_epi32(sums[2], _mm_madd_epi16(_mm_unpacklo_epi16(high1, high2), pair));
+            sums[3] = _mm_add_epi32(sums[3], _mm_madd_epi16(_mm_unpackhi_epi16(high1, high2), pair));
+        }
+
+        const __m128i low  = _mm_packs_epi32(filtered_4_sums_ssse3(sums[0]), filtered_4_sums_ssse3(sums[1]));
+        const __m128i high = _mm_packs_epi32(filtered_4_sums_ssse3(sums[2]), filtered_4_sums_ssse3(sums[3]));
+
+        _mm_storeu_si128((__m128i *)(scan_output + i), _mm_packus_epi16(low, high));
+    }
+
+    filter_rows(scan_input + i, stride, count, weights, scan_output + i, length - i);
+}
+
+SAIL_TARGET("ssse3")
+static void filter_columns_4_ssse3(const uint8_t *scan_input, uint8_t *scan_output, unsigned width,
+                                   const unsigned *firsts, const unsigned *counts, const int16_t *weights, unsigned weights_stride) {
+
+    const __m128i zero = _mm_setzero_si128();
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t *input = scan_input + firsts[column] * 4;
+        const int16_t *column_weights = weights + column * weights_stride;
+        const unsigned count = counts[column];
+        __m128i sums = zero;
+        unsigned k = 0;
+
+        /* Two pixels at a time: interleave their components and multiply them by a pair of weights. */
+        for (; k + 2 <= count; k += 2) {
+            const __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(input + k * 4)), zero);
+            const __m128i pairs  = _mm_unpacklo_epi16(pixels, _mm_srli_si128(pixels, 8));
+
+            sums = _mm_add_epi32(sums, _mm_madd_epi16(pairs, weights_pair_ssse3(column_weights[k], column_weights[k + 1])));
+        }
+
+        if (k < count) {
+            int value;
+            memcpy(&value, input + k * 4, sizeof(value));
+
+            const __m128i pixel = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero);
+
+            sums = _mm_add_epi32(sums, _mm_madd_epi16(pixel, weights_pair_ssse3(column_weights[k], 0)));
+        }
+
+        const __m128i packed = _mm_packs_epi32(filtered_4_sums_ssse3(sums), zero);
+        const int result = _mm_cvtsi128_si32(_mm_packus_epi16(packed, zero));
+        memcpy(scan_output + column * 4, &result, sizeof(result));
+    }
+}
+
+/*
+ * AVX2 kernels. Shuffles work within 128-bit lanes, so 24-bit pixels are loaded four per lane
+ * and packed back with a cross-lane permutation.
+ */
+
+SAIL_TARGET("avx2")
+static inline __m256i load_2x12_bytes(const uint8_t *scan_input) {
+
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)scan_input)),
+                                   _mm_loadu_si128((const __m128i *)(scan_input + 12)), 1);
+}
+
+SAIL_TARGET("avx2")
+static inline void store_2x12_bytes(uint8_t *scan_output, __m256i value) {
+
+    const __m256i packed = _mm256_permutevar8x32_epi32(value, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+    _mm_storeu_si128((__m128i *)scan_output, _mm256_castsi256_si128(packed));
+    _mm_storel_epi64((__m128i *)(scan_output + 16), _mm256_extracti128_si256(packed, 1));
+}
+
+SAIL_TARGET("avx2")
+static void swap_rgb24_avx2(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    const __m256i mask = _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, -1, -1, -1, -1));
+    unsigned column = 0;
+
+    /* The second lane load reads up to the middle of the tenth pixel. */
+    for (; column + 10 <= width; column += 8) {
+        const __m256i pixels = load_2x12_bytes(scan_input + column * 3);
+        store_2x12_bytes(scan_output + column * 3, _mm256_shuffle_epi8(pixels, mask));
+    }
+
+    swap_rgb24_ssse3(scan_input + column * 3, scan_output + column * 3, width - column);
+}
+
+SAIL_TARGET("avx2")
+static void rgb24_to_rgba32_kind_avx2(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, __m128i mask128, row_kernel_t tail) {
+
+    const __m256i mask  = _mm256_broadcastsi128_si256(mask128);
+    const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+    unsigned column = 0;
+
+    for (; column + 10 <= width; column += 8) {
+        const __m256i pixels = load_2x12_bytes(scan_input + column * 3);
+        _mm256_storeu_si256((__m256i *)(scan_output + column * 4), _mm256_or_si256(_mm256_shuffle_epi8(pixels, mask), alpha));
+    }
+
+    tail(scan_input + column * 3, scan_output + column * 4, width - column);
+}
+
+SAIL_TARGET("avx2")
+static void rgb24_to_rgba32_avx2(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    rgb24_to_rgba32_kind_avx2(scan_input, scan_output, width,
+                              _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1), rgb24_to_rgba32_ssse3);
+}
+
+SAIL_TARGET("avx2")
+static void rgb24_to_rgba32_swapped_avx2(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    rgb24_to_rgba32_kind_avx2(scan_input, scan_output, width,
+                              _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1), rgb24_to_rgba32_swapped_ssse3);
+}
+
+SAIL_TARGET("avx2")
+static void swap_rgba32_avx2(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    const __m256i mask = _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15));
+    unsigned column = 0;
+
+    for (; column + 8 <= width; column += 8) {
+        const __m256i pixels = _mm256_loadu_si256((const __m256i *)(scan_input + column * 4));
+        _mm256_storeu_si256((__m256i *)(scan_output + column * 4), _mm256_shuffle_epi8(pixels, mask));
+    }
+
+    swap_rgba32_ssse3(scan_input + column * 4, scan_output + column * 4, width - column);
+}
+
+SAIL_TARGET("avx2")
+static void rgba32_to_rgb24_kind_avx2(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, __m128i mask128, row_kernel_t tail) {
+
+    const __m256i mask = _mm256_broadcastsi128_si256(mask128);
+    unsigned column = 0;
+
+    for (; column + 8 <= width; column += 8) {
+        const __m256i pixels = _mm256_loadu_si256((const __m256i *)(scan_input + column * 4));
+        store_2x12_bytes(scan_output + column * 3, _mm256_shuffle_epi8(pixels, mask));
+    }
+
+    tail(scan_input + column * 4, scan_output + column * 3, width - column);
+}
+
+SAIL_TARGET("avx2")
+static void rgba32_to_rgb24_avx2(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    rgba32_to_rgb24_kind_avx2(scan_input, scan_output, width,
+                              _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1), rgba32_to_rgb24_ssse3);
+}
+
+SAIL_TARGET("avx2")
+static void rgba32_to_rgb24_swapped_avx2(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    rgba32_to_rgb24_kind_avx2(scan_input, scan_output, width,
+                              _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1), rgba32_to_rgb24_swapped_ssse3);
+}
+
+SAIL_TARGET("avx2")
+static inline __m256i narrow_16_components_avx2(__m256i values, __m256i thresholds) {
+
+    const __m256i sums = _mm256_adds_epu16(values, thresholds);
+
+    return _mm256_srli_epi16(_mm256_sub_epi16(sums, _mm256_srli_epi16(sums, 8)), 8);
+}
+
+SAIL_TARGET("avx2")
+static void narrow_row_avx2(const uint8_t *scan_input, uint8_t *scan_output, unsigned length, const uint16_t *thresholds) {
+
+    unsigned i = 0;
+
+    /* SAIL_NARROW_THRESHOLDS_LENGTH is a multiple of 32, so the thresholds are never split. */
+    for (; i + 32 <= length; i += 32) {
+        const uint16_t *row_thresholds = thresholds + i % SAIL_NARROW_THRESHOLDS_LENGTH;
+
+        const __m256i values1 = narrow_16_components_avx2(_mm256_loadu_si256((const __m256i *)(scan_input + i * 2)),
+                                                          _mm256_loadu_si256((const __m256i *)row_thresholds));
+        const __m256i values2 = narrow_16_components_avx2(_mm256_loadu_si256((const __m256i *)(scan_input + i * 2 + 32)),
+                                                          _mm256_loadu_si256((const __m256i *)(row_thresholds + 16)));
+
+        /* packus interleaves the lanes of its arguments. */
+        const __m256i packed = _mm256_packus_epi16(values1, values2);
+        _mm256_storeu_si256((__m256i *)(scan_output + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+
+    narrow_row_ssse3(scan_input + i * 2, scan_output + i, length - i, thresholds + i % SAIL_NARROW_THRESHOLDS_LENGTH);
+}
+
+/*
+ * 32-bit lanes of the squared differences kernels grow by at most 4 * 255 * 255 per iteration,
+ * so they're flushed into 64-bit sums every SAIL_SQUARED_DIFFERENCES_BLOCK iterations.
+ */
+#define SAIL_SQUARED_DIFFERENCES_BLOCK 8192
+
+SAIL_TARGET("ssse3")
+static uint64_t squared_differences_ssse3(const uint8_t *scan1, const uint8_t *scan2, unsigned length) {
+
+    const __m128i zero = _mm_setzero_si128();
+    uint64_t sum = 0;
+    unsigned i = 0;
+
+    while (length - i >= 16) {
+        const unsigned iterations = ((length - i) / 16 < SAIL_SQUARED_DIFFERENCES_BLOCK) ? (length - i) / 16 : SAIL_SQUARED_DIFFERENCES_BLOCK;
+        __m128i sums = zero;
+
+        for (unsigned k = 0; k < iterations; k++, i += 16) {
+            const __m128i values1 = _mm_loadu_si128((const __m128i *)(scan1 + i));
+            const __m128i values2 = _mm_loadu_si128((const __m128i *)(scan2 + i));
+
+            /* Absolute differences, then squares summed in pairs. */
+            const __m128i differences = _mm_or_si128(_mm_subs_epu8(values1, values2), _mm_subs_epu8(values2, values1));
+            const __m128i low  = _mm_unpacklo_epi8(differences, zero);
+            const __m128i high = _mm_unpackhi_epi8(differences, zero);
+
+            sums = _mm_add_epi32(sums, _mm_add_epi32(_mm_madd_epi16(low, low), _mm_madd_epi16(high, high)));
+        }
+
+        uint32_t lanes[4];
+        _mm_storeu_si128((__m128i *)lanes, sums);
+        sum += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+
+    return sum + squared_differences(scan1 + i, scan2 + i, length - i);
+}
+
+SAIL_TARGET("avx2")
+static uint64_t squared_differences_avx2(const uint8_t *scan1, const uint8_t *scan2, unsigned length) {
+
+    const __m256i zero = _mm256_setzero_si256();
+    uint64_t sum = 0;
+    unsigned i = 0;
+
+    while (length - i >= 32) {
+        const unsigned iterations = ((length - i) / 32 < SAIL_SQUARED_DIFFERENCES_BLOCK) ? (length - i) / 32 : SAIL_SQUARED_DIFFERENCES_BLOCK;
+        __m256i sums = zero;
+
+        for (unsigned k = 0; k < iterations; k++, i += 32) {
+            const __m256i values1 = _mm256_loadu_si256((const __m256i *)(scan1 + i));
+            const __m256i values2 = _mm256_loadu_si256((const __m256i *)(scan2 + i));
+
+            const __m256i differences = _mm256_or_si256(_mm256_subs_epu8(values1, values2), _mm256_subs_epu8(values2, values1));
+            const __m256i low  = _mm256_unpacklo_epi8(differences, zero);
+            const __m256i high = _mm256_unpackhi_epi8(differences, zero);
+
+            sums = _mm256_add_epi32(sums, _mm256_add_epi32(_mm256_madd_epi16(low, low), _mm256_madd_epi16(high, high)));
+        }
+
+        uint32_t lanes[8];
+        _mm256_storeu_si256((__m256i *)lanes, sums);
+
+        for (unsigned k = 0; k < 8; k++) {
+            sum += lanes[k];
+        }
+    }
+
+    return sum + squared_differences_ssse3(scan1 + i, scan2 + i, length - i);
+}
+
+/*
+ * F16C kernels. Eight components are converted at a time. Integer components are widened
+ * and narrowed with 128-bit instructions as AVX has no 256-bit integer ones, and
+ * _mm256_cvtps_epi32() rounds to the nearest even integer like float_to_uint16().
+ */
+SAIL_TARGET("avx,f16c")
+static inline __m256 uint16_to_float_8_components_f16c(const uint8_t *scan_input) {
+
+    const __m128i values = _mm_loadu_si128((const __m128i *)scan_input);
+    const __m128i zero   = _mm_setzero_si128();
+
+    const __m256i widened = _mm256_insertf128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(values, zero)),
+                                                    _mm_unpackhi_epi16(values, zero), 1);
+
+    return _mm256_div_ps(_mm256_cvtepi32_ps(widened), _mm256_set1_ps(65535.0f));
+}
+
+/* _mm256_max_ps() returns its second argument for NaNs, so they become 0. */
+SAIL_TARGET("avx,f16c")
+static inline __m128i float_to_uint16_8_components_f16c(__m256 values) {
+
+    const __m256 clamped = _mm256_min_ps(_mm256_max_ps(values, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+    const __m256i result = _mm256_cvtps_epi32(_mm256_mul_ps(clamped, _mm256_set1_ps(65535.0f)));
+
+    return _mm_packus_epi32(_mm256_castsi256_si128(result), _mm256_extractf128_si256(result, 1));
+}
+
+SAIL_TARGET("avx,f16c")
+static void half_to_float_components_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const __m256 values = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(scan_input + i * 2)));
+        _mm256_storeu_ps((float *)(scan_output + i * 4), values);
+    }
+
+    half_to_float_components(scan_input + i * 2, scan_output + i * 4, length - i);
+}
+
+SAIL_TARGET("avx,f16c")
+static void float_to_half_components_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const __m128i values = _mm256_cvtps_ph(_mm256_loadu_ps((const float *)(scan_input + i * 4)), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i *)(scan_output + i * 2), values);
+    }
+
+    float_to_half_components(scan_input + i * 4, scan_output + i * 2, length - i);
+}
+
+SAIL_TARGET("avx,f16c")
+static void uint16_to_half_components_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const __m128i values = _mm256_cvtps_ph(uint16_to_float_8_components_f16c(scan_input + i * 2), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i *)(scan_output + i * 2), values);
+    }
+
+    uint16_to_half_components(scan_input + i * 2, scan_output + i * 2, length - i);
+}
+
+SAIL_TARGET("avx,f16c")
+static void half_to_uint16_components_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const __m256 values = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(scan_input + i * 2)));
+        _mm_storeu_si128((__m128i *)(scan_output + i * 2), float_to_uint16_8_components_f16c(values));
+    }
+
+    half_to_uint16_components(scan_input + i * 2, scan_output + i * 2, length - i);
+}
+
+SAIL_TARGET("avx,f16c")
+static void uint16_to_float_components_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        _mm256_storeu_ps((float *)(scan_output + i * 4), uint16_to_float_8_components_f16c(scan_input + i * 2));
+    }
+
+    uint16_to_float_components(scan_input + i * 2, scan_output + i * 4, length - i);
+}
+
+SAIL_TARGET("avx,f16c")
+static void float_to_uint16_components_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const __m256 values = _mm256_loadu_ps((const float *)(scan_input + i * 4));
+        _mm_storeu_si128((__m128i *)(scan_output + i * 2), float_to_uint16_8_components_f16c(values));
+    }
+
+    float_to_uint16_components(scan_input + i * 4, scan_output + i * 2, length - i);
+}
+
+static void rgba_half_to_rgba_float_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    half_to_float_components_f16c(scan_input, scan_output, width * 4);
+}
+
+static void rgba_float_to_rgba_half_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    float_to_half_components_f16c(scan_input, scan_output, width * 4);
+}
+
+static void rgba64_to_rgba_half_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    uint16_to_half_components_f16c(scan_input, scan_output, width * 4);
+}
+
+static void rgba_half_to_rgba64_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    half_to_uint16_components_f16c(scan_input, scan_output, width * 4);
+}
+
+static void rgba64_to_rgba_float_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    uint16_to_float_components_f16c(scan_input, scan_output, width * 4);
+}
+
+static void rgba_float_to_rgba64_f16c(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    float_to_uint16_components_f16c(scan_input, scan_output, width * 4);
+}
+
+static void cpuid(unsigned leaf, unsigned subleaf, unsigned registers[4]) {
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    int values[4];
+    __cpuidex(values, (int)leaf, (int)subleaf);
+
+    for (int i = 0; i < 4; i++) {
+        registers[i] = (unsigned)values[i];
+    }
+#else
+    __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+static uint64_t xgetbv0(void) {
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    unsigned eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+static void detect_x86_features(bool *ssse3, bool *avx2) {
+
+    unsigned registers[4];
+
+    cpuid(0, 0, registers);
+    const unsigned max_leaf = registers[0];
+
+    cpuid(1, 0, registers);
+    *ssse3 = (registers[2] & (1u << 9)) != 0;
+
+    /* AVX2 also needs AVX and the OS saving YMM registers. */
+    const bool osxsave = (registers[2] & (1u << 27)) != 0;
+    const bool avx     = (registers[2] & (1u << 28)) != 0;
+
+    *avx2 = false;
+
+    if (max_leaf >= 7 && osxsave && avx && (xgetbv0() & 0x6) == 0x6) {
+        cpuid(7, 0, registers);
+        *avx2 = (registers[1] & (1u << 5)) != 0;
+    }
+
+    const enum SailInstructionSet limit = instruction_set_limit();
+
+    *ssse3 = *ssse3 && limit >= SAIL_INSTRUCTION_SET_SSSE3;
+    *avx2  = *avx2 && limit >= SAIL_INSTRUCTION_SET_AVX2;
+}
+
+/* F16C kernels also use AVX, so they need the OS saving YMM registers too. */
+static bool detect_x86_f16c(void) {
+
+    unsigned registers[4];
+    cpuid(1, 0, registers);
+
+    const bool osxsave = (registers[2] & (1u << 27)) != 0;
+    const bool avx     = (registers[2] & (1u << 28)) != 0;
+    const bool f16c    = (registers[2] & (1u << 29)) != 0;
+
+    return osxsave && avx && f16c && (xgetbv0() & 0x6) == 0x6 && instruction_set_limit() >= SAIL_INSTRUCTION_SET_F16C;
+}
+
+#endif /* SAIL_ROW_KERNELS_X86 */
+
+#ifdef SAIL_ROW_KERNELS_NEON
+
+/*
+ * NEON kernels. Structured loads and stores de-interleave and interleave 16 pixels at a time.
+ */
+
+static void swap_rgb24_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x3_t pixels = vld3q_u8(scan_input + column * 3);
+        const uint8x16x3_t swapped = { { pixels.val[2], pixels.val[1], pixels.val[0] } };
+        vst3q_u8(scan_output + column * 3, swapped);
+    }
+
+    swap_rgb24(scan_input + column * 3, scan_output + column * 3, width - column);
+}
+
+static void rgb24_to_rgba32_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x3_t pixels = vld3q_u8(scan_input + column * 3);
+        const uint8x16x4_t expanded = { { pixels.val[0], pixels.val[1], pixels.val[2], vdupq_n_u8(255) } };
+        vst4q_u8(scan_output + column * 4, expanded);
+    }
+
+    rgb24_to_rgba32(scan_input + column * 3, scan_output + column * 4, width - column);
+}
+
+static void rgb24_to_rgba32_swapped_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x3_t pixels = vld3q_u8(scan_input + column * 3);
+        const uint8x16x4_t expanded = { { pixels.val[2], pixels.val[1], pixels.val[0], vdupq_n_u8(255) } };
+        vst4q_u8(scan_output + column * 4, expanded);
+    }
+
+    rgb24_to_rgba32_swapped(scan_input + column * 3, scan_output + column * 4, width - column);
+}
+
+static void swap_rgba32_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(scan_input + column * 4);
+        const uint8x16x4_t swapped = { { pixels.val[2], pixels.val[1], pixels.val[0], pixels.val[3] } };
+        vst4q_u8(scan_output + column * 4, swapped);
+    }
+
+    swap_rgba32(scan_input + column * 4, scan_output + column * 4, width - column);
+}
+
+static void rgba32_to_rgb24_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(scan_input + column * 4);
+        const uint8x16x3_t dropped = { { pixels.val[0], pixels.val[1], pixels.val[2] } };
+        vst3q_u8(scan_output + column * 3, dropped);
+    }
+
+    rgba32_to_rgb24(scan_input + column * 4, scan_output + column * 3, width - column);
+}
+
+static void rgba32_to_rgb24_swapped_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(scan_input + column * 4);
+        const uint8x16x3_t dropped = { { pixels.val[2], pixels.val[1], pixels.val[0] } };
+        vst3q_u8(scan_output + column * 3, dropped);
+    }
+
+    rgba32_to_rgb24_swapped(scan_input + column * 4, scan_output + column * 3, width - column);
+}
+
+static inline uint8x8_t blend_neon(uint8x8_t c, uint8x8_t background, uint8x8_t a) {
+
+    const uint16x8_t value = vaddq_u16(vmlal_u8(vmull_u8(c, a), background, vsub_u8(vdup_n_u8(255), a)), vdupq_n_u16(127));
+
+    /* (value + 1 + (value >> 8)) >> 8 */
+    return vshrn_n_u16(vaddq_u16(vaddq_u16(value, vdupq_n_u16(1)), vshrq_n_u16(value, 8)), 8);
+}
+
+static inline uint8x16_t blend_16_components_neon(uint8x16_t c, uint8_t background, uint8x16_t a) {
+
+    const uint8x8_t background8 = vdup_n_u8(background);
+
+    return vcombine_u8(blend_neon(vget_low_u8(c), background8, vget_low_u8(a)),
+                       blend_neon(vget_high_u8(c), background8, vget_high_u8(a)));
+}
+
+static void rgba32_to_rgb24_blend_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint8_t background[3]) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(scan_input + column * 4);
+        const uint8x16x3_t blended = { {
+            blend_16_components_neon(pixels.val[0], background[0], pixels.val[3]),
+            blend_16_components_neon(pixels.val[1], background[1], pixels.val[3]),
+            blend_16_components_neon(pixels.val[2], background[2], pixels.val[3])
+        } };
+        vst3q_u8(scan_output + column * 3, blended);
+    }
+
+    rgba32_to_rgb24_blend(scan_input + column * 4, scan_output + column * 3, width - column, background);
+}
+
+static void rgba32_to_rgb24_swapped_blend_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint8_t background[3]) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(scan_input + column * 4);
+        const uint8x16x3_t blended = { {
+            blend_16_components_neon(pixels.val[2], background[2], pixels.val[3]),
+            blend_16_components_neon(pixels.val[1], background[1], pixels.val[3]),
+            blend_16_components_neon(pixels.val[0], background[0], pixels.val[3])
+        } };
+        vst3q_u8(scan_output + column * 3, blended);
+    }
+
+    rgba32_to_rgb24_swapped_blend(scan_input + column * 4, scan_output + column * 3, width - column, background);
+}
+
+/* Premultiplying is blending over the black background. */
+static void premultiply_rgba32_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(scan_input + column * 4);
+        const uint8x16x4_t premultiplied = { {
+            blend_16_components_neon(pixels.val[0], 0, pixels.val[3]),
+            blend_16_components_neon(pixels.val[1], 0, pixels.val[3]),
+            blend_16_components_neon(pixels.val[2], 0, pixels.val[3]),
+            pixels.val[3]
+        } };
+        vst4q_u8(scan_output + column * 4, premultiplied);
+    }
+
+    premultiply_rgba32(scan_input + column * 4, scan_output + column * 4, width - column);
+}
+
+static void premultiply_rgba32_swapped_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(scan_input + column * 4);
+        const uint8x16x4_t premultiplied = { {
+            blend_16_components_neon(pixels.val[2], 0, pixels.val[3]),
+            blend_16_components_neon(pixels.val[1], 0, pixels.val[3]),
+            blend_16_components_neon(pixels.val[0], 0, pixels.val[3]),
+            pixels.val[3]
+        } };
+        vst4q_u8(scan_output + column * 4, premultiplied);
+    }
+
+    premultiply_rgba32_swapped(scan_input + column * 4, scan_output + column * 4, width - column);
+}
+
+/* Truncating the correctly rounded float quotient gives the exact integer quotient. See unpremultiply_pixel_ssse3(). */
+static inline uint32x4_t unpremultiply_4_components_neon(uint16x4_t c, uint16x4_t a) {
+
+    const uint32x4_t a32   = vmovl_u16(a);
+    const uint32x4_t value = vmlal_n_u16(vshrq_n_u32(a32, 1), c, 255);
+
+    return vcvtq_u32_f32(vdivq_f32(vcvtq_f32_u32(value), vcvtq_f32_u32(a32)));
+}
+
+static inline uint8x8_t unpremultiply_8_components_neon(uint8x8_t c, uint8x8_t a) {
+
+    const uint16x8_t c16 = vmovl_u8(c);
+    const uint16x8_t a16 = vmovl_u8(a);
+
+    const uint16x8_t value = vcombine_u16(vqmovn_u32(unpremultiply_4_components_neon(vget_low_u16(c16), vget_low_u16(a16))),
+                                          vqmovn_u32(unpremultiply_4_components_neon(vget_high_u16(c16), vget_high_u16(a16))));
+
+    /* Division by zero alpha produces garbage. Fully transparent pixels are black. */
+    return vand_u8(vqmovn_u16(value), vtst_u8(a, a));
+}
+
+static void unpremultiply_rgba32_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 8 <= width; column += 8) {
+        const uint8x8x4_t pixels = vld4_u8(scan_input + column * 4);
+        const uint8x8x4_t unpremultiplied = { {
+            unpremultiply_8_components_neon(pixels.val[0], pixels.val[3]),
+            unpremultiply_8_components_neon(pixels.val[1], pixels.val[3]),
+            unpremultiply_8_components_neon(pixels.val[2], pixels.val[3]),
+            pixels.val[3]
+        } };
+        vst4_u8(scan_output + column * 4, unpremultiplied);
+    }
+
+    unpremultiply_rgba32(scan_input + column * 4, scan_output + column * 4, width - column);
+}
+
+static void unpremultiply_rgba32_swapped_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 8 <= width; column += 8) {
+        const uint8x8x4_t pixels = vld4_u8(scan_input + column * 4);
+        const uint8x8x4_t unpremultiplied = { {
+            unpremultiply_8_components_neon(pixels.val[2], pixels.val[3]),
+            unpremultiply_8_components_neon(pixels.val[1], pixels.val[3]),
+            unpremultiply_8_components_neon(pixels.val[0], pixels.val[3]),
+            pixels.val[3]
+        } };
+        vst4_u8(scan_output + column * 4, unpremultiplied);
+    }
+
+    unpremultiply_rgba32_swapped(scan_input + column * 4, scan_output + column * 4, width - column);
+}
+
+/* Stores 16 pixels as RGB24 or RGBA32 with opaque alpha. */
+static inline void store_16_rgb_pixels_neon(uint8_t *scan_output, uint8x16_t r, uint8x16_t g, uint8x16_t b, bool rgba) {
+
+    if (rgba) {
+        const uint8x16x4_t pixels = { { r, g, b, vdupq_n_u8(255) } };
+        vst4q_u8(scan_output, pixels);
+    } else {
+        const uint8x16x3_t pixels = { { r, g, b } };
+        vst3q_u8(scan_output, pixels);
+    }
+}
+
+/* Computes unclamped R, G, and B of 8 pixels. YCbCr passes 128 as 'center', YCCK passes 0. */
+static inline void ycbcr_8_pixels_neon(uint8x8_t y8, uint8x8_t cb8, uint8x8_t cr8, int16_t center,
+                                       int16x8_t *r, int16x8_t *g, int16x8_t *b) {
+
+    const int16x8_t y  = vreinterpretq_s16_u16(vmovl_u8(y8));
+    const int16x8_t cb = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(cb8)), vdupq_n_s16(center));
+    const int16x8_t cr = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(cr8)), vdupq_n_s16(center));
+
+    *r = vaddq_s16(vaddq_s16(y, cr), vqrdmulhq_n_s16(cr, SAIL_CR_R_FRACTION));
+    *g = vsubq_s16(vsubq_s16(y, vqrdmulhq_n_s16(cb, SAIL_CB_G_FACTOR)), vqrdmulhq_n_s16(cr, SAIL_CR_G_FACTOR));
+    *b = vaddq_s16(vaddq_s16(y, cb), vqrdmulhq_n_s16(cb, SAIL_CB_B_FRACTION));
+}
+
+static void ycbcr24_to_rgb_kind_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, bool rgba, row_kernel_t tail) {
+
+    const unsigned output_bytes_per_pixel = rgba ? 4 : 3;
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x3_t pixels = vld3q_u8(scan_input + column * 3);
+
+        int16x8_t r1, g1, b1, r2, g2, b2;
+        ycbcr_8_pixels_neon(vget_low_u8(pixels.val[0]), vget_low_u8(pixels.val[1]), vget_low_u8(pixels.val[2]), 128, &r1, &g1, &b1);
+        ycbcr_8_pixels_neon(vget_high_u8(pixels.val[0]), vget_high_u8(pixels.val[1]), vget_high_u8(pixels.val[2]), 128, &r2, &g2, &b2);
+
+        /* Saturating narrowing clamps the components to 0..255. */
+        store_16_rgb_pixels_neon(scan_output + column * output_bytes_per_pixel,
+                                 vcombine_u8(vqmovun_s16(r1), vqmovun_s16(r2)),
+                                 vcombine_u8(vqmovun_s16(g1), vqmovun_s16(g2)),
+                                 vcombine_u8(vqmovun_s16(b1), vqmovun_s16(b2)),
+                                 rgba);
+    }
+
+    tail(scan_input + column * 3, scan_output + column * output_bytes_per_pixel, width - column);
+}
+
+static void ycbcr24_to_rgb24_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    ycbcr24_to_rgb_kind_neon(scan_input, scan_output, width, false, ycbcr24_to_rgb24);
+}
+
+static void ycbcr24_to_rgba32_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    ycbcr24_to_rgb_kind_neon(scan_input, scan_output, width, true, ycbcr24_to_rgba32);
+}
+
+/* (c * k + 127) / 255 is the blending of C, M, and Y with K as alpha over the black background. */
+static void cmyk32_to_rgb_kind_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, bool rgba, row_kernel_t tail) {
+
+    const unsigned output_bytes_per_pixel = rgba ? 4 : 3;
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(scan_input + column * 4);
+
+        store_16_rgb_pixels_neon(scan_output + column * output_bytes_per_pixel,
+                                 blend_16_components_neon(pixels.val[0], 0, pixels.val[3]),
+                                 blend_16_components_neon(pixels.val[1], 0, pixels.val[3]),
+                                 blend_16_components_neon(pixels.val[2], 0, pixels.val[3]),
+                                 rgba);
+    }
+
+    tail(scan_input + column * 4, scan_output + column * output_bytes_per_pixel, width - column);
+}
+
+static void cmyk32_to_rgb24_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    cmyk32_to_rgb_kind_neon(scan_input, scan_output, width, false, cmyk32_to_rgb24);
+}
+
+static void cmyk32_to_rgba32_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    cmyk32_to_rgb_kind_neon(scan_input, scan_output, width, true, cmyk32_to_rgba32);
+}
+
+/* Clamps YCCK color components to 0..255, inverts them, and applies K as CMYK does. */
+static inline uint8x8_t ycck_component_neon(int16x8_t value, uint8x8_t k) {
+
+    return blend_neon(vmvn_u8(vqmovun_s16(value)), vdup_n_u8(0), k);
+}
+
+/* The exact integer forms of -179.456, +135.45984, and -226.816 after truncating in ycck.c. */
+static inline void ycck_8_pixels_neon(uint8x8_t y, uint8x8_t cb, uint8x8_t cr, uint8x8_t k,
+                                      uint8x8_t *r, uint8x8_t *g, uint8x8_t *b) {
+
+    int16x8_t r16, g16, b16;
+    ycbcr_8_pixels_neon(y, cb, cr, 0, &r16, &g16, &b16);
+
+    *r = ycck_component_neon(vsubq_s16(r16, vdupq_n_s16(180)), k);
+    *g = ycck_component_neon(vaddq_s16(g16, vdupq_n_s16(135)), k);
+    *b = ycck_component_neon(vsubq_s16(b16, vdupq_n_s16(227)), k);
+}
+
+static void ycck32_to_rgb_kind_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, bool rgba, row_kernel_t tail) {
+
+    const unsigned output_bytes_per_pixel = rgba ? 4 : 3;
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(scan_input + column * 4);
+
+        uint8x8_t r1, g1, b1, r2, g2, b2;
+        ycck_8_pixels_neon(vget_low_u8(pixels.val[0]), vget_low_u8(pixels.val[1]),
+                           vget_low_u8(pixels.val[2]), vget_low_u8(pixels.val[3]), &r1, &g1, &b1);
+        ycck_8_pixels_neon(vget_high_u8(pixels.val[0]), vget_high_u8(pixels.val[1]),
+                           vget_high_u8(pixels.val[2]), vget_high_u8(pixels.val[3]), &r2, &g2, &b2);
+
+        store_16_rgb_pixels_neon(scan_output + column * output_bytes_per_pixel,
+                                 vcombine_u8(r1, r2), vcombine_u8(g1, g2), vcombine_u8(b1, b2), rgba);
+    }
+
+    tail(scan_input + column * 4, scan_output + column * output_bytes_per_pixel, width - column);
+}
+
+static void ycck32_to_rgb24_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    ycck32_to_rgb_kind_neon(scan_input, scan_output, width, false, ycck32_to_rgb24);
+}
+
+static void ycck32_to_rgba32_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    ycck32_to_rgb_kind_neon(scan_input, scan_output, width, true, ycck32_to_rgba32);
+}
+
+static inline uint16x4_t luma_4_components_neon(uint16x4_t c1, uint16x4_t c2, uint16x4_t c3, const uint16_t weights[3]) {
+
+    const uint32x4_t sum = vmlal_n_u16(vmlal_n_u16(vmull_n_u16(c1, weights[0]), c2, weights[1]), c3, weights[2]);
+
+    /* (sum + 16384) >> 15 */
+    return vrshrn_n_u32(sum, 15);
+}
+
+static inline uint8x16_t luma_16_pixels_neon(uint8x16_t c1, uint8x16_t c2, uint8x16_t c3, const uint16_t weights[3]) {
+
+    const uint16x8_t c1_low  = vmovl_u8(vget_low_u8(c1));
+    const uint16x8_t c2_low  = vmovl_u8(vget_low_u8(c2));
+    const uint16x8_t c3_low  = vmovl_u8(vget_low_u8(c3));
+    const uint16x8_t c1_high = vmovl_u8(vget_high_u8(c1));
+    const uint16x8_t c2_high = vmovl_u8(vget_high_u8(c2));
+    const uint16x8_t c3_high = vmovl_u8(vget_high_u8(c3));
+
+    const uint16x8_t luma_low  = vcombine_u16(luma_4_components_neon(vget_low_u16(c1_low), vget_low_u16(c2_low), vget_low_u16(c3_low), weights),
+                                              luma_4_components_neon(vget_high_u16(c1_low), vget_high_u16(c2_low), vget_high_u16(c3_low), weights));
+    const uint16x8_t luma_high = vcombine_u16(luma_4_components_neon(vget_low_u16(c1_high), vget_low_u16(c2_high), vget_low_u16(c3_high), weights),
+                                              luma_4_components_neon(vget_high_u16(c1_high), vget_high_u16(c2_high), vget_high_u16(c3_high), weights));
+
+    return vcombine_u8(vmovn_u16(luma_low), vmovn_u16(luma_high));
+}
+
+static void rgb24_to_gray8_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint16_t weights[3]) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x3_t pixels = vld3q_u8(scan_input + column * 3);
+        vst1q_u8(scan_output + column, luma_16_pixels_neon(pixels.val[0], pixels.val[1], pixels.val[2], weights));
+    }
+
+    rgb24_to_gray8(scan_input + column * 3, scan_output + column, width - column, weights);
+}
+
+static void rgba32_to_gray8_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint16_t weights[3]) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16x4_t pixels = vld4q_u8(scan_input + column * 4);
+        vst1q_u8(scan_output + column, luma_16_pixels_neon(pixels.val[0], pixels.val[1], pixels.val[2], weights));
+    }
+
+    rgba32_to_gray8(scan_input + column * 4, scan_output + column, width - column, weights);
+}
+
+static void gray8_to_rgb24_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    unsigned column = 0;
+
+    for (; column + 16 <= width; column += 16) {
+        const uint8x16_t values = vld1q_u8(scan_input + column);
+        const uint8x16x3_t expanded = { { values, values, values } };
+        vst3q_u8(scan_output + column * 3, expanded);
+    }
+
+    gray8_to_rgb24(scan_input + column, scan_output + column * 3, width - column);
+}
+
+static inline uint8x8_t narrow_8_components_neon(uint16x8_t values, uint16x8_t thresholds) {
+
+    const uint16x8_t sums = vqaddq_u16(values, thresholds);
+
+    return vshrn_n_u16(vsubq_u16(sums, vshrq_n_u16(sums, 8)), 8);
+}
+
+static void narrow_row_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned length, const uint16_t *thresholds) {
+
+    const uint16_t *scan_input16 = (const uint16_t *)scan_input;
+    unsigned i = 0;
+
+    /* SAIL_NARROW_THRESHOLDS_LENGTH is a multiple of 16, so the thresholds are never split. */
+    for (; i + 16 <= length; i += 16) {
+        const uint16_t *row_thresholds = thresholds + i % SAIL_NARROW_THRESHOLDS_LENGTH;
+
+        const uint8x8_t values1 = narrow_8_components_neon(vld1q_u16(scan_input16 + i),     vld1q_u16(row_thresholds));
+        const uint8x8_t values2 = narrow_8_components_neon(vld1q_u16(scan_input16 + i + 8), vld1q_u16(row_thresholds + 8));
+
+        vst1q_u8(scan_output + i, vcombine_u8(values1, values2));
+    }
+
+    narrow_row(scan_input + i * 2, scan_output + i, length - i, thresholds + i % SAIL_NARROW_THRESHOLDS_LENGTH);
+}
+
+/*
+ * Scaling filters. vrshrq_n_s32() rounds the exact 32-bit sums like filtered_uint8().
+ */
+static inline uint8x8_t filtered_8_sums_neon(int32x4_t sums1, int32x4_t sums2) {
+
+    const int16x8_t values = vcombine_s16(vqmovn_s32(vrshrq_n_s32(sums1, SAIL_FILTER_WEIGHT_BITS)),
+                                          vqmovn_s32(vrshrq_n_s32(sums2, SAIL_FILTER_WEIGHT_BITS)));
+
+    return vqmovun_s16(values);
+}
+
+static void filter_rows_neon(const uint8_t *scan_input, size_t stride, unsigned count, const int16_t *weights,
+                             uint8_t *scan_output, unsigned length) {
+
+    unsigned i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        int32x4_t sums[4] = { vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0) };
+
+        for (unsigned k = 0; k < count; k++) {
+            const uint8x16_t values = vld1q_u8(scan_input + k * stride + i);
+            const int16x8_t low     = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(values)));
+            const int16x8_t high    = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(values)));
+
+            sums[0] = vmlal_n_s16(sums[0], vget_low_s16(low),   weights[k]);
+            sums[1] = vmlal_n_s16(sums[1], vget_high_s16(low),  weights[k]);
+            sums[2] = vmlal_n_s16(sums[2], vget_low_s16(high),  weights[k]);
+            sums[3] = vmlal_n_s16(sums[3], vget_high_s16(high), weights[k]);
+        }
+
+        vst1q_u8(scan_output + i, vcombine_u8(filtered_8_sums_neon(sums[0], sums[1]), filtered_8_sums_neon(sums[2], sums[3])));
+    }
+
+    filter_rows(scan_input + i, stride, count, weights, scan_output + i, length - i);
+}
+
+static void filter_columns_4_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width,
+                                  const unsigned *firsts, const unsigned *counts, const int16_t *weights, unsigned weights_stride) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint8_t *input = scan_input + firsts[column] * 4;
+        const int16_t *column_weights = weights + column * weights_stride;
+        int32x4_t sums = vdupq_n_s32(0);
+
+        for (unsigned k = 0; k < counts[column]; k++) {
+            uint32_t value;
+            memcpy(&value, input + k * 4, sizeof(value));
+
+            const int16x4_t pixel = vget_low_s16(vreinterpretq_s16_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(value)))));
+
+            sums = vmlal_n_s16(sums, pixel, column_weights[k]);
+        }
+
+        const uint32_t result = vget_lane_u32(vreinterpret_u32_u8(filtered_8_sums_neon(sums, sums)), 0);
+        memcpy(scan_output + column * 4, &result, sizeof(result));
+    }
+}
+
+/* See SAIL_SQUARED_DIFFERENCES_BLOCK in the x86 kernels. */
+#define SAIL_SQUARED_DIFFERENCES_BLOCK 8192
+
+static uint64_t squared_differences_neon(const uint8_t *scan1, const uint8_t *scan2, unsigned length) {
+
+    uint64_t sum = 0;
+    unsigned i = 0;
+
+    while (length - i >= 16) {
+        const unsigned iterations = ((length - i) / 16 < SAIL_SQUARED_DIFFERENCES_BLOCK) ? (length - i) / 16 : SAIL_SQUARED_DIFFERENCES_BLOCK;
+        uint32x4_t sums = vdupq_n_u32(0);
+
+        for (unsigned k = 0; k < iterations; k++, i += 16) {
+            const uint8x16_t differences = vabdq_u8(vld1q_u8(scan1 + i), vld1q_u8(scan2 + i));
+
+            sums = vpadalq_u16(sums, vmull_u8(vget_low_u8(differences),  vget_low_u8(differences)));
+            sums = vpadalq_u16(sums, vmull_u8(vget_high_u8(differences), vget_high_u8(differences)));
+        }
+
+        sum += vaddlvq_u32(sums);
+    }
+
+    return sum + squared_differences(scan1 + i, scan2 + i, length - i);
+}
+
+/*
+ * Half precision and floating point NEON kernels. vmaxnmq_f32() returns the number for NaNs,
+ * so they become 0, and vcvtnq_u32_f32() rounds to the nearest even integer like float_to_uint16().
+ */
+static inline float32x4_t uint16_to_float_4_components_neon(uint16x4_t values) {
+
+    return vdivq_f32(vcvtq_f32_u32(vmovl_u16(values)), vdupq_n_f32(65535.0f));
+}
+
+static inline uint16x4_t float_to_uint16_4_components_neon(float32x4_t values) {
+
+    const float32x4_t clamped = vminnmq_f32(vmaxnmq_f32(values, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+
+    return vmovn_u32(vcvtnq_u32_f32(vmulq_f32(clamped, vdupq_n_f32(65535.0f))));
+}
+
+static void half_to_float_components_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const uint16_t *scan_input16      = (const uint16_t *)scan_input;
+          float    *scan_output_float = (float *)scan_output;
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const uint16x8_t values = vld1q_u16(scan_input16 + i);
+
+        vst1q_f32(scan_output_float + i,     vcvt_f32_f16(vreinterpret_f16_u16(vget_low_u16(values))));
+        vst1q_f32(scan_output_float + i + 4, vcvt_f32_f16(vreinterpret_f16_u16(vget_high_u16(values))));
+    }
+
+    half_to_float_components(scan_input + i * 2, scan_output + i * 4, length - i);
+}
+
+static void float_to_half_components_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const float    *scan_input_float = (const float *)scan_input;
+          uint16_t *scan_output16    = (uint16_t *)scan_output;
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const float16x4_t values1 = vcvt_f16_f32(vld1q_f32(scan_input_float + i));
+        const float16x4_t values2 = vcvt_f16_f32(vld1q_f32(scan_input_float + i + 4));
+
+        vst1q_u16(scan_output16 + i, vcombine_u16(vreinterpret_u16_f16(values1), vreinterpret_u16_f16(values2)));
+    }
+
+    float_to_half_components(scan_input + i * 4, scan_output + i * 2, length - i);
+}
+
+static void uint16_to_half_components_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const uint16_t *scan_input16  = (const uint16_t *)scan_input;
+          uint16_t *scan_output16 = (uint16_t *)scan_output;
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const uint16x8_t values = vld1q_u16(scan_input16 + i);
+
+        const float16x4_t values1 = vcvt_f16_f32(uint16_to_float_4_components_neon(vget_low_u16(values)));
+        const float16x4_t values2 = vcvt_f16_f32(uint16_to_float_4_components_neon(vget_high_u16(values)));
+
+        vst1q_u16(scan_output16 + i, vcombine_u16(vreinterpret_u16_f16(values1), vreinterpret_u16_f16(values2)));
+    }
+
+    uint16_to_half_components(scan_input + i * 2, scan_output + i * 2, length - i);
+}
+
+static void half_to_uint16_components_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const uint16_t *scan_input16  = (const uint16_t *)scan_input;
+          uint16_t *scan_output16 = (uint16_t *)scan_output;
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const uint16x8_t values = vld1q_u16(scan_input16 + i);
+
+        const uint16x4_t values1 = float_to_uint16_4_components_neon(vcvt_f32_f16(vreinterpret_f16_u16(vget_low_u16(values))));
+        const uint16x4_t values2 = float_to_uint16_4_components_neon(vcvt_f32_f16(vreinterpret_f16_u16(vget_high_u16(values))));
+
+        vst1q_u16(scan_output16 + i, vcombine_u16(values1, values2));
+    }
+
+    half_to_uint16_components(scan_input + i * 2, scan_output + i * 2, length - i);
+}
+
+static void uint16_to_float_components_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const uint16_t *scan_input16      = (const uint16_t *)scan_input;
+          float    *scan_output_float = (float *)scan_output;
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const uint16x8_t values = vld1q_u16(scan_input16 + i);
+
+        vst1q_f32(scan_output_float + i,     uint16_to_float_4_components_neon(vget_low_u16(values)));
+        vst1q_f32(scan_output_float + i + 4, uint16_to_float_4_components_neon(vget_high_u16(values)));
+    }
+
+    uint16_to_float_components(scan_input + i * 2, scan_output + i * 4, length - i);
+}
+
+static void float_to_uint16_components_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned length) {
+
+    const float    *scan_input_float = (const float *)scan_input;
+          uint16_t *scan_output16    = (uint16_t *)scan_output;
+    unsigned i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        const uint16x4_t values1 = float_to_uint16_4_components_neon(vld1q_f32(scan_input_float + i));
+        const uint16x4_t values2 = float_to_uint16_4_components_neon(vld1q_f32(scan_input_float + i + 4));
+
+        vst1q_u16(scan_output16 + i, vcombine_u16(values1, values2));
+    }
+
+    float_to_uint16_components(scan_input + i * 4, scan_output + i * 2, length - i);
+}
+
+static void rgba_half_to_rgba_float_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    half_to_float_components_neon(scan_input, scan_output, width * 4);
+}
+
+static void rgba_float_to_rgba_half_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    float_to_half_components_neon(scan_input, scan_output, width * 4);
+}
+
+static void rgba64_to_rgba_half_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    uint16_to_half_components_neon(scan_input, scan_output, width * 4);
+}
+
+static void rgba_half_to_rgba64_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    half_to_uint16_components_neon(scan_input, scan_output, width * 4);
+}
+
+static void rgba64_to_rgba_float_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    uint16_to_float_components_neon(scan_input, scan_output, width * 4);
+}
+
+static void rgba_float_to_rgba64_neon(const uint8_t *scan_input, uint8_t *scan_output, unsigned width) {
+
+    float_to_uint16_components_neon(scan_input, scan_output, width * 4);
+}
+
+static bool detect_neon(void) {
+
+    return instruction_set_limit() != SAIL_INSTRUCTION_SET_GENERIC;
+}
+
+#endif /* SAIL_ROW_KERNELS_NEON */
+
+/*
+ * Public functions.
+ */
+
+row_kernel_t row_kernel(enum SailRowKernel kernel, enum SailInstructionSet *instruction_set) {
+
+#ifdef SAIL_ROW_KERNELS_X86
+    bool ssse3, avx2;
+    detect_x86_features(&ssse3, &avx2);
+    const bool f16c = detect_x86_f16c();
+
+    #define SAIL_SELECT_KERNEL(name) \
+        *instruction_set = avx2 ? SAIL_INSTRUCTION_SET_AVX2 : (ssse3 ? SAIL_INSTRUCTION_SET_SSSE3 : SAIL_INSTRUCTION_SET_GENERIC); \
+        return avx2 ? name##_avx2 : (ssse3 ? name##_ssse3 : name)
+    #define SAIL_SELECT_SSSE3_KERNEL(name) \
+        *instruction_set = ssse3 ? SAIL_INSTRUCTION_SET_SSSE3 : SAIL_INSTRUCTION_SET_GENERIC; \
+        return ssse3 ? name##_ssse3 : name
+    #define SAIL_SELECT_F16C_KERNEL(name) \
+        *instruction_set = f16c ? SAIL_INSTRUCTION_SET_F16C : SAIL_INSTRUCTION_SET_GENERIC; \
+        return f16c ? name##_f16c : name
+#elif defined(SAIL_ROW_KERNELS_NEON)
+    const bool neon = detect_neon();
+
+    #define SAIL_SELECT_KERNEL(name) \
+        *instruction_set = neon ? SAIL_INSTRUCTION_SET_NEON : SAIL_INSTRUCTION_SET_GENERIC; \
+        return neon ? name##_neon : name
+    #define SAIL_SELECT_SSSE3_KERNEL(name) SAIL_SELECT_KERNEL(name)
+    #define SAIL_SELECT_F16C_KERNEL(name) SAIL_SELECT_KERNEL(name)
+#else
+    #define SAIL_SELECT_KERNEL(name) *instruction_set = SAIL_INSTRUCTION_SET_GENERIC; return name
+    #define SAIL_SELECT_SSSE3_KERNEL(name) *instruction_set = SAIL_INSTRUCTION_SET_GENERIC; return name
+    #define SAIL_SELECT_F16C_KERNEL(name) *instruction_set = SAIL_INSTRUCTION_SET_GENERIC; return name
+#endif
+
+    switch (kernel) {
+        case SAIL_ROW_KERNEL_SWAP_RGB24:              SAIL_SELECT_KERNEL(swap_rgb24);
+        case SAIL_ROW_KERNEL_RGB24_TO_RGBA32:         SAIL_SELECT_KERNEL(rgb24_to_rgba32);
+        case SAIL_ROW_KERNEL_RGB24_TO_RGBA32_SWAPPED: SAIL_SELECT_KERNEL(rgb24_to_rgba32_swapped);
+        case SAIL_ROW_KERNEL_SWAP_RGBA32:             SAIL_SELECT_KERNEL(swap_rgba32);
+        case SAIL_ROW_KERNEL_RGBA32_TO_RGB24:         SAIL_SELECT_KERNEL(rgba32_to_rgb24);
+        case SAIL_ROW_KERNEL_RGBA32_TO_RGB24_SWAPPED: SAIL_SELECT_KERNEL(rgba32_to_rgb24_swapped);
+        case SAIL_ROW_KERNEL_GRAY8_TO_RGB24:          SAIL_SELECT_SSSE3_KERNEL(gray8_to_rgb24);
+        case SAIL_ROW_KERNEL_YCBCR24_TO_RGB24:        SAIL_SELECT_SSSE3_KERNEL(ycbcr24_to_rgb24);
+        case SAIL_ROW_KERNEL_YCBCR24_TO_RGBA32:       SAIL_SELECT_SSSE3_KERNEL(ycbcr24_to_rgba32);
+        case SAIL_ROW_KERNEL_CMYK32_TO_RGB24:         SAIL_SELECT_SSSE3_KERNEL(cmyk32_to_rgb24);
+        case SAIL_ROW_KERNEL_CMYK32_TO_RGBA32:        SAIL_SELECT_SSSE3_KERNEL(cmyk32_to_rgba32);
+        case SAIL_ROW_KERNEL_YCCK32_TO_RGB24:         SAIL_SELECT_SSSE3_KERNEL(ycck32_to_rgb24);
+        case SAIL_ROW_KERNEL_YCCK32_TO_RGBA32:        SAIL_SELECT_SSSE3_KERNEL(ycck32_to_rgba32);
+
+        case SAIL_ROW_KERNEL_PREMULTIPLY_RGBA32:           SAIL_SELECT_SSSE3_KERNEL(premultiply_rgba32);
+        case SAIL_ROW_KERNEL_PREMULTIPLY_RGBA32_SWAPPED:   SAIL_SELECT_SSSE3_KERNEL(premultiply_rgba32_swapped);
+        case SAIL_ROW_KERNEL_UNPREMULTIPLY_RGBA32:         SAIL_SELECT_SSSE3_KERNEL(unpremultiply_rgba32);
+        case SAIL_ROW_KERNEL_UNPREMULTIPLY_RGBA32_SWAPPED: SAIL_SELECT_SSSE3_KERNEL(unpremultiply_rgba32_swapped);
+
+        case SAIL_ROW_KERNEL_RGBA_HALF_TO_RGBA_FLOAT: SAIL_SELECT_F16C_KERNEL(rgba_half_to_rgba_float);
+        case SAIL_ROW_KERNEL_RGBA_FLOAT_TO_RGBA_HALF: SAIL_SELECT_F16C_KERNEL(rgba_float_to_rgba_half);
+        case SAIL_ROW_KERNEL_RGBA64_TO_RGBA_HALF:     SAIL_SELECT_F16C_KERNEL(rgba64_to_rgba_half);
+        case SAIL_ROW_KERNEL_RGBA_HALF_TO_RGBA64:     SAIL_SELECT_F16C_KERNEL(rgba_half_to_rgba64);
+        case SAIL_ROW_KERNEL_RGBA64_TO_RGBA_FLOAT:    SAIL_SELECT_F16C_KERNEL(rgba64_to_rgba_float);
+        case SAIL_ROW_KERNEL_RGBA_FLOAT_TO_RGBA64:    SAIL_SELECT_F16C_KERNEL(rgba_float_to_rgba64);
+    }
+
+#undef SAIL_SELECT_KERNEL
+#undef SAIL_SELECT_SSSE3_KERNEL
+#undef SAIL_SELECT_F16C_KERNEL
+
+    *instruction_set = SAIL_INSTRUCTION_SET_GENERIC;
+
+    return NULL;
+}
+
+blend_row_kernel_t blend_row_kernel(enum SailRowKernel kernel, enum SailInstructionSet *instruction_set) {
+
+#ifdef SAIL_ROW_KERNELS_X86
+    bool ssse3, avx2;
+    detect_x86_features(&ssse3, &avx2);
+    (void)avx2;
+
+    #define SAIL_SELECT_KERNEL(name) \
+        *instruction_set = ssse3 ? SAIL_INSTRUCTION_SET_SSSE3 : SAIL_INSTRUCTION_SET_GENERIC; \
+        return ssse3 ? name##_ssse3 : name
+#elif defined(SAIL_ROW_KERNELS_NEON)
+    const bool neon = detect_neon();
+
+    #define SAIL_SELECT_KERNEL(name) \
+        *instruction_set = neon ? SAIL_INSTRUCTION_SET_NEON : SAIL_INSTRUCTION_SET_GENERIC; \
+        return neon ? name##_neon : name
+#else
+    #define SAIL_SELECT_KERNEL(name) *instruction_set = SAIL_INSTRUCTION_SET_GENERIC; return name
+#endif
+
+    switch (kernel) {
+        case SAIL_ROW_KERNEL_RGBA32_TO_RGB24:         SAIL_SELECT_KERNEL(rgba32_to_rgb24_blend);
+        case SAIL_ROW_KERNEL_RGBA32_TO_RGB24_SWAPPED: SAIL_SELECT_KERNEL(rgba32_to_rgb24_swapped_blend);
+
+        default: {
+            *instruction_set = SAIL_INSTRUCTION_SET_GENERIC;
+            return NULL;
+        }
+    }
+
+#undef SAIL_SELECT_KERNEL
+}
+
+narrow_row_kernel_t narrow_row_kernel(enum SailInstructionSet *instruction_set) {
+
+#ifdef SAIL_ROW_KERNELS_X86
+    bool ssse3, avx2;
+    detect_x86_features(&ssse3, &avx2);
+
+    *instruction_set = avx2 ? SAIL_INSTRUCTION_SET_AVX2 : (ssse3 ? SAIL_INSTRUCTION_SET_SSSE3 : SAIL_INSTRUCTION_SET_GENERIC);
+    return avx2 ? narrow_row_avx2 : (ssse3 ? narrow_row_ssse3 : narrow_row);
+#elif defined(SAIL_ROW_KERNELS_NEON)
+    const bool neon = detect_neon();
+
+    *instruction_set = neon ? SAIL_INSTRUCTION_SET_NEON : SAIL_INSTRUCTION_SET_GENERIC;
+    return neon ? narrow_row_neon : narrow_row;
+#else
+    *instruction_set = SAIL_INSTRUCTION_SET_GENERIC;
+    return narrow_row;
+#endif
+}
+
+luma_row_kernel_t luma_row_kernel(enum SailLumaRowKernel kernel, enum SailInstructionSet *instruction_set) {
+
+#ifdef SAIL_ROW_KERNELS_X86
+    bool ssse3, avx2;
+    detect_x86_features(&ssse3, &avx2);
+    (void)avx2;
+
+    #define SAIL_SELECT_KERNEL(name) \
+        *instruction_set = ssse3 ? SAIL_INSTRUCTION_SET_SSSE3 : SAIL_INSTRUCTION_SET_GENERIC; \
+        return ssse3 ? name##_ssse3 : name
+#elif defined(SAIL_ROW_KERNELS_NEON)
+    const bool neon = detect_neon();
+
+    #define SAIL_SELECT_KERNEL(name) \
+        *instruction_set = neon ? SAIL_INSTRUCTION_SET_NEON : SAIL_INSTRUCTION_SET_GENERIC; \
+        return neon ? name##_neon : name
+#else
+    #define SAIL_SELECT_KERNEL(name) *instruction_set = SAIL_INSTRUCTION_SET_GENERIC; return name
+#endif
+
+    switch (kernel) {
+        case SAIL_LUMA_ROW_KERNEL_RGB24_TO_GRAY8:   SAIL_SELECT_KERNEL(rgb24_to_gray8);
+        case SAIL_LUMA_ROW_KERNEL_RGBA32_TO_GRAY8:  SAIL_SELECT_KERNEL(rgba32_to_gray8);
+
+        /* 16-bit components don't fit signed 16-bit SIMD multiplications. */
+        case SAIL_LUMA_ROW_KERNEL_RGB48_TO_GRAY16:  *instruction_set = SAIL_INSTRUCTION_SET_GENERIC; return rgb48_to_gray16;
+        case SAIL_LUMA_ROW_KERNEL_RGBA64_TO_GRAY16: *instruction_set = SAIL_INSTRUCTION_SET_GENERIC; return rgba64_to_gray16;
+    }
+
+#undef SAIL_SELECT_KERNEL
+
+    *instruction_set = SAIL_INSTRUCTION_SET_GENERIC;
+
+    return NULL;
+}
+
+filter_rows_kernel_t filter_rows_kernel(void) {
+
+#ifdef SAIL_ROW_KERNELS_X86
+    bool ssse3, avx2;
+    detect_x86_features(&ssse3, &avx2);
+    (void)avx2;
+
+    return ssse3 ? filter_rows_ssse3 : filter_rows;
+#elif defined(SAIL_ROW_KERNELS_NEON)
+    return detect_neon() ? filter_rows_neon : filter_rows;
+#else
+    return filter_rows;
+#endif
+}
+
+filter_columns_kernel_t filter_columns_kernel(unsigned components) {
+
+#ifdef SAIL_ROW_KERNELS_X86
+    bool ssse3, avx2;
+    detect_x86_features(&ssse3, &avx2);
+    (void)avx2;
+
+    const filter_columns_kernel_t filter_columns_4_fastest = ssse3 ? filter_columns_4_ssse3 : filter_columns_4;
+#elif defined(SAIL_ROW_KERNELS_NEON)
+    const filter_columns_kernel_t filter_columns_4_fastest = detect_neon() ? filter_columns_4_neon : filter_columns_4;
+#else
+    const filter_columns_kernel_t filter_columns_4_fastest = filter_columns_4;
+#endif
+
+    switch (components) {
+        case 1:  return filter_columns_1;
+        case 2:  return filter_columns_2;
+        case 3:  return filter_columns_3;
+        case 4:  return filter_columns_4_fastest;
+
+        default: {
+            return NULL;
+        }
+    }
+}
+
+squared_differences_kernel_t squared_differences_kernel(void) {
+
+#ifdef SAIL_ROW_KERNELS_X86
+    bool ssse3, avx2;
+    detect_x86_features(&ssse3, &avx2);
+
+    return avx2 ? squared_differences_avx2 : (ssse3 ? squared_differences_ssse3 : squared_differences);
+#elif defined(SAIL_ROW_KERNELS_NEON)
+    return detect_neon() ? squared_differences_neon : squared_differences;
+#else
+    return squared_differences;
+#endif
+}
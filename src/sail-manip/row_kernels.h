@@ -0,0 +1,226 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_ROW_KERNELS_H
+#define SAIL_ROW_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <sail-common/export.h>
+
+#include <sail-manip/conversion_stats.h>
+
+/*
+ * Converts 'width' pixels of a scan line. Kernels walk rows forward, so they also work in place
+ * when the output pixel is not larger than the input pixel.
+ */
+typedef void (*row_kernel_t)(const uint8_t *scan_input, uint8_t *scan_output, unsigned width);
+
+enum SailRowKernel {
+
+    /* RGB24 <-> BGR24. */
+    SAIL_ROW_KERNEL_SWAP_RGB24,
+
+    /* RGB24 -> RGBA32 and BGR24 -> BGRA32. */
+    SAIL_ROW_KERNEL_RGB24_TO_RGBA32,
+
+    /* RGB24 -> BGRA32 and BGR24 -> RGBA32. */
+    SAIL_ROW_KERNEL_RGB24_TO_RGBA32_SWAPPED,
+
+    /* RGBA32 <-> BGRA32. */
+    SAIL_ROW_KERNEL_SWAP_RGBA32,
+
+    /* RGBA32 -> RGB24 and BGRA32 -> BGR24. Alpha is dropped. */
+    SAIL_ROW_KERNEL_RGBA32_TO_RGB24,
+
+    /* RGBA32 -> BGR24 and BGRA32 -> RGB24. Alpha is dropped. */
+    SAIL_ROW_KERNEL_RGBA32_TO_RGB24_SWAPPED,
+
+    /* Gray8 -> RGB24 or BGR24. */
+    SAIL_ROW_KERNEL_GRAY8_TO_RGB24,
+
+    /* YCbCr24 -> RGB24. */
+    SAIL_ROW_KERNEL_YCBCR24_TO_RGB24,
+
+    /* YCbCr24 -> RGBA32. */
+    SAIL_ROW_KERNEL_YCBCR24_TO_RGBA32,
+
+    /* CMYK32 -> RGB24. */
+    SAIL_ROW_KERNEL_CMYK32_TO_RGB24,
+
+    /* CMYK32 -> RGBA32. */
+    SAIL_ROW_KERNEL_CMYK32_TO_RGBA32,
+
+    /* YCCK32 -> RGB24. */
+    SAIL_ROW_KERNEL_YCCK32_TO_RGB24,
+
+    /* YCCK32 -> RGBA32. */
+    SAIL_ROW_KERNEL_YCCK32_TO_RGBA32,
+
+    /* RGBA32 -> premultiplied RGBA32 and BGRA32 -> premultiplied BGRA32. */
+    SAIL_ROW_KERNEL_PREMULTIPLY_RGBA32,
+
+    /* RGBA32 -> premultiplied BGRA32 and BGRA32 -> premultiplied RGBA32. */
+    SAIL_ROW_KERNEL_PREMULTIPLY_RGBA32_SWAPPED,
+
+    /* Premultiplied RGBA32 -> RGBA32 and premultiplied BGRA32 -> BGRA32. */
+    SAIL_ROW_KERNEL_UNPREMULTIPLY_RGBA32,
+
+    /* Premultiplied RGBA32 -> BGRA32 and premultiplied BGRA32 -> RGBA32. */
+    SAIL_ROW_KERNEL_UNPREMULTIPLY_RGBA32_SWAPPED,
+
+    /* Half precision RGBA64 -> floating point RGBA128. */
+    SAIL_ROW_KERNEL_RGBA_HALF_TO_RGBA_FLOAT,
+
+    /* Floating point RGBA128 -> half precision RGBA64. */
+    SAIL_ROW_KERNEL_RGBA_FLOAT_TO_RGBA_HALF,
+
+    /* RGBA64 or BGRA64 -> half precision RGBA64 or BGRA64. */
+    SAIL_ROW_KERNEL_RGBA64_TO_RGBA_HALF,
+
+    /* Half precision RGBA64 or BGRA64 -> RGBA64 or BGRA64. HDR values are clamped. */
+    SAIL_ROW_KERNEL_RGBA_HALF_TO_RGBA64,
+
+    /* RGBA64 or BGRA64 -> floating point RGBA128 or BGRA128. */
+    SAIL_ROW_KERNEL_RGBA64_TO_RGBA_FLOAT,
+
+    /* Floating point RGBA128 or BGRA128 -> RGBA64 or BGRA64. HDR values are clamped. */
+    SAIL_ROW_KERNEL_RGBA_FLOAT_TO_RGBA64,
+};
+
+/*
+ * Converts 'width' pixels of a scan line and blends them with the background given in the order
+ * of the input color components instead of dropping alpha.
+ */
+typedef void (*blend_row_kernel_t)(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint8_t background[3]);
+
+enum SailLumaRowKernel {
+
+    /* RGB24 or BGR24 -> Gray8. */
+    SAIL_LUMA_ROW_KERNEL_RGB24_TO_GRAY8,
+
+    /* RGBA32 or BGRA32 -> Gray8. Alpha is dropped. */
+    SAIL_LUMA_ROW_KERNEL_RGBA32_TO_GRAY8,
+
+    /* RGB48 or BGR48 -> Gray16. */
+    SAIL_LUMA_ROW_KERNEL_RGB48_TO_GRAY16,
+
+    /* RGBA64 or BGRA64 -> Gray16. Alpha is dropped. */
+    SAIL_LUMA_ROW_KERNEL_RGBA64_TO_GRAY16,
+};
+
+/*
+ * Converts 'width' pixels of a scan line to grayscale with the luma weights from luma_weights()
+ * given in the order of the input color components.
+ */
+typedef void (*luma_row_kernel_t)(const uint8_t *scan_input, uint8_t *scan_output, unsigned width, const uint16_t weights[3]);
+
+/*
+ * Number of thresholds used by the narrowing kernels. It's a multiple of 8 pixels of 1-4 components
+ * and of the SIMD register widths, so a threshold pattern repeating every 8 pixels fits it.
+ */
+#define SAIL_NARROW_THRESHOLDS_LENGTH 96
+
+/*
+ * Narrows 'length' 16-bit components of a scan line to 8 bits as (component + threshold) / 257
+ * with component N using thresholds[N % SAIL_NARROW_THRESHOLDS_LENGTH]. Thresholds must be less than 257.
+ * Thresholds of 128 round to the nearest integer like narrow_uint16(), other thresholds dither.
+ */
+typedef void (*narrow_row_kernel_t)(const uint8_t *scan_input, uint8_t *scan_output, unsigned length, const uint16_t *thresholds);
+
+/*
+ * Returns the fastest implementation of the specified kernel supported by the current CPU.
+ * SSSE3, AVX2, and F16C implementations are selected at runtime on x86, NEON implementations are
+ * always used on AArch64. All implementations produce exactly the same output. Saves the instruction
+ * set of the selected implementation into 'instruction_set'. Tests cap the selection with the
+ * SAIL_ROW_KERNELS_INSTRUCTION_SET environment variable set to "generic", "ssse3", or "avx2".
+ */
+SAIL_HIDDEN row_kernel_t row_kernel(enum SailRowKernel kernel, enum SailInstructionSet *instruction_set);
+
+/*
+ * Returns the fastest implementation of the specified kernel blending alpha with the background
+ * instead of dropping it, or NULL if the kernel doesn't drop alpha. Blending is bit-identical
+ * to blend_uint8(). Saves the instruction set like row_kernel().
+ */
+SAIL_HIDDEN blend_row_kernel_t blend_row_kernel(enum SailRowKernel kernel, enum SailInstructionSet *instruction_set);
+
+/*
+ * Returns the fastest implementation of the narrowing kernel. Results are bit-identical to the portable implementation.
+ * Saves the instruction set like row_kernel().
+ */
+SAIL_HIDDEN narrow_row_kernel_t narrow_row_kernel(enum SailInstructionSet *instruction_set);
+
+/*
+ * Returns the fastest implementation of the specified luma kernel. Results are bit-identical to luma().
+ * Saves the instruction set like row_kernel().
+ */
+SAIL_HIDDEN luma_row_kernel_t luma_row_kernel(enum SailLumaRowKernel kernel, enum SailInstructionSet *instruction_set);
+
+/*
+ * Fixed-point precision of the scaling filter weights. The weights of every output pixel sum to 1 << SAIL_FILTER_WEIGHT_BITS.
+ */
+#define SAIL_FILTER_WEIGHT_BITS 14
+
+/*
+ * Filters 'length' 8-bit components of 'count' consecutive scan lines located 'stride' bytes apart
+ * into a single scan line. Used by the vertical pass of scaling.
+ */
+typedef void (*filter_rows_kernel_t)(const uint8_t *scan_input, size_t stride, unsigned count, const int16_t *weights,
+                                     uint8_t *scan_output, unsigned length);
+
+/*
+ * Filters a scan line of 'width' output pixels with 8-bit components horizontally. Output pixel N is
+ * the weighted sum of counts[N] input pixels starting at firsts[N] with the weights starting
+ * at weights[N * weights_stride]. Used by the horizontal pass of scaling.
+ */
+typedef void (*filter_columns_kernel_t)(const uint8_t *scan_input, uint8_t *scan_output, unsigned width,
+                                        const unsigned *firsts, const unsigned *counts, const int16_t *weights, unsigned weights_stride);
+
+/*
+ * Returns the fastest implementation of the vertical scaling filter. Results are bit-identical
+ * to the portable implementation.
+ */
+SAIL_HIDDEN filter_rows_kernel_t filter_rows_kernel(void);
+
+/*
+ * Returns the fastest implementation of the horizontal scaling filter for pixels of 1-4 8-bit components,
+ * or NULL for other numbers of components. Results are bit-identical to the portable implementation.
+ */
+SAIL_HIDDEN filter_columns_kernel_t filter_columns_kernel(unsigned components);
+
+/*
+ * Returns the sum of squared differences of 'length' 8-bit components of two scan lines.
+ * Used by image comparison.
+ */
+typedef uint64_t (*squared_differences_kernel_t)(const uint8_t *scan1, const uint8_t *scan2, unsigned length);
+
+/*
+ * Returns the fastest implementation of the squared differences kernel. Results are identical
+ * to the portable implementation.
+ */
+SAIL_HIDDEN squared_differences_kernel_t squared_differences_kernel(void);
+
+#endif
@@ -30,13 +30,23 @@
 
 #include <sail-common/sail-common.h>
 
+#include <sail-manip/analyze.h>
+#include <sail-manip/compare.h>
 #include <sail-manip/conversion_options.h>
+#include <sail-manip/conversion_stats.h>
 #include <sail-manip/convert.h>
+#include <sail-manip/jpeg_transcode.h>
 #include <sail-manip/manip_common.h>
+#include <sail-manip/quantize.h>
+#include <sail-manip/scale.h>
 
 #ifdef SAIL_BUILD
+    #include <sail-manip/bcn.h>
     #include <sail-manip/cmyk.h>
+    #include <sail-manip/icc.h>
     #include <sail-manip/manip_utils.h>
+    #include <sail-manip/planar.h>
+    #include <sail-manip/row_kernels.h>
     #include <sail-manip/ycbcr.h>
     #include <sail-manip/ycck.h>
 #endif
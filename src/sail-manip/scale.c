@@ -0,0 +1,487 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-manip/sail-manip.h>
+
+/*
+ * Private functions.
+ */
+
+/* Scale images with at least this number of output pixels in multiple threads. */
+static const size_t PARALLEL_PIXELS_THRESHOLD = 65536;
+
+static const double PI = 3.14159265358979323846;
+
+/*
+ * Fixed-point filter weights of every output pixel along one dimension. Output pixel N is the weighted
+ * sum of counts[N] input pixels starting at firsts[N] with the weights starting at values[N * stride].
+ */
+struct filter_weights {
+
+    unsigned *firsts;
+    unsigned *counts;
+    int16_t *values;
+    unsigned stride;
+};
+
+static double box_filter(double x) {
+
+    return (x >= -0.5 && x < 0.5) ? 1.0 : 0.0;
+}
+
+static double triangle_filter(double x) {
+
+    x = fabs(x);
+
+    return (x < 1.0) ? 1.0 - x : 0.0;
+}
+
+static double bicubic_filter(double x) {
+
+    const double a = -0.5;
+
+    x = fabs(x);
+
+    if (x < 1.0) {
+        return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+    } else if (x < 2.0) {
+        return (((x - 5.0) * x + 8.0) * x - 4.0) * a;
+    } else {
+        return 0.0;
+    }
+}
+
+static double sinc(double x) {
+
+    if (x == 0.0) {
+        return 1.0;
+    }
+
+    x *= PI;
+
+    return sin(x) / x;
+}
+
+static double lanczos3_filter(double x) {
+
+    return (x > -3.0 && x < 3.0) ? sinc(x) * sinc(x / 3.0) : 0.0;
+}
+
+static bool components_of_pixel_format(enum SailPixelFormat pixel_format, unsigned *components, unsigned *component_size) {
+
+    switch (pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: {
+            *components = 1; *component_size = 1;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA: {
+            *components = 2; *component_size = 1;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:
+        case SAIL_PIXEL_FORMAT_BPP24_YCBCR: {
+            *components = 3; *component_size = 1;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBX:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRX:
+        case SAIL_PIXEL_FORMAT_BPP32_XRGB:
+        case SAIL_PIXEL_FORMAT_BPP32_XBGR:
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA:
+        case SAIL_PIXEL_FORMAT_BPP32_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP32_ABGR:
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP32_CMYK:
+        case SAIL_PIXEL_FORMAT_BPP32_YCCK: {
+            *components = 4; *component_size = 1;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE: {
+            *components = 1; *component_size = 2;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA: {
+            *components = 2; *component_size = 2;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP48_RGB:
+        case SAIL_PIXEL_FORMAT_BPP48_BGR: {
+            *components = 3; *component_size = 2;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP64_RGBX:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRX:
+        case SAIL_PIXEL_FORMAT_BPP64_XRGB:
+        case SAIL_PIXEL_FORMAT_BPP64_XBGR:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA:
+        case SAIL_PIXEL_FORMAT_BPP64_ARGB:
+        case SAIL_PIXEL_FORMAT_BPP64_ABGR:
+        case SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED:
+        case SAIL_PIXEL_FORMAT_BPP64_CMYK: {
+            *components = 4; *component_size = 2;
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+static void destroy_filter_weights(struct filter_weights *weights) {
+
+    sail_free(weights->firsts);
+    sail_free(weights->counts);
+    sail_free(weights->values);
+}
+
+static sail_status_t alloc_filter_weights(unsigned input_size, unsigned output_size, enum SailScaleFilter filter,
+                                          struct filter_weights *weights) {
+
+    double (*function)(double);
+    double support;
+
+    switch (filter) {
+        case SAIL_SCALE_FILTER_BOX:      function = box_filter;      support = 0.5; break;
+        case SAIL_SCALE_FILTER_BILINEAR: function = triangle_filter; support = 1.0; break;
+        case SAIL_SCALE_FILTER_BICUBIC:  function = bicubic_filter;  support = 2.0; break;
+        case SAIL_SCALE_FILTER_LANCZOS3: function = lanczos3_filter; support = 3.0; break;
+        case SAIL_SCALE_FILTER_AREA:     function = NULL;            support = 0.5; break;
+
+        default: {
+            SAIL_LOG_ERROR("Unknown scale filter %d", (int)filter);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
+    /* Widen the filter when downscaling, so every input pixel contributes to the output. */
+    const double scale        = (double)input_size / output_size;
+    const double filter_scale = (scale > 1.0) ? scale : 1.0;
+
+    support *= filter_scale;
+
+    *weights = (struct filter_weights) { NULL, NULL, NULL, (unsigned)ceil(support * 2.0) + 2 };
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(unsigned) * output_size, &ptr),
+                        /* cleanup */ destroy_filter_weights(weights));
+    weights->firsts = ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(unsigned) * output_size, &ptr),
+                        /* cleanup */ destroy_filter_weights(weights));
+    weights->counts = ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(int16_t) * output_size * weights->stride, &ptr),
+                        /* cleanup */ destroy_filter_weights(weights));
+    weights->values = ptr;
+
+    double *values;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(double) * weights->stride, &ptr),
+                        /* cleanup */ destroy_filter_weights(weights));
+    values = ptr;
+
+    for (unsigned i = 0; i < output_size; i++) {
+        const double center = (i + 0.5) * scale;
+
+        const double first_position = floor(center - support);
+        const double last_position  = ceil(center + support);
+
+        unsigned first = (first_position < 0.0) ? 0 : (unsigned)first_position;
+        unsigned last  = (last_position > input_size) ? input_size : (unsigned)last_position;
+
+        if (last - first > weights->stride) {
+            last = first + weights->stride;
+        }
+
+        double total = 0.0;
+
+        for (unsigned k = 0; k < last - first; k++) {
+            const double x = first + k;
+
+            if (function == NULL) {
+                /* The part of the input pixel [x, x + 1) covered by the output pixel. */
+                const double left  = (x > center - filter_scale / 2.0) ? x : center - filter_scale / 2.0;
+                const double right = (x + 1.0 < center + filter_scale / 2.0) ? x + 1.0 : center + filter_scale / 2.0;
+
+                values[k] = (right > left) ? right - left : 0.0;
+            } else {
+                values[k] = function((x + 0.5 - center) / filter_scale);
+            }
+
+            total += values[k];
+        }
+
+        /* Cut off the input pixels with zero weights. */
+        while (last > first + 1 && values[last - first - 1] == 0.0) {
+            last--;
+        }
+        while (first + 1 < last && values[0] == 0.0) {
+            memmove(values, values + 1, sizeof(double) * (last - first - 1));
+            first++;
+        }
+
+        int16_t *fixed_values = weights->values + (size_t)i * weights->stride;
+
+        if (total == 0.0) {
+            const unsigned nearest = (center < input_size) ? (unsigned)center : input_size - 1;
+
+            weights->firsts[i] = nearest;
+            weights->counts[i] = 1;
+            fixed_values[0]    = 1 << SAIL_FILTER_WEIGHT_BITS;
+            continue;
+        }
+
+        /* Round the normalized weights to fixed-point and put the rounding error into the largest weight. */
+        int fixed_total = 0;
+        unsigned largest = 0;
+
+        for (unsigned k = 0; k < last - first; k++) {
+            fixed_values[k] = (int16_t)floor(values[k] / total * (1 << SAIL_FILTER_WEIGHT_BITS) + 0.5);
+            fixed_total += fixed_values[k];
+
+            if (fixed_values[k] > fixed_values[largest]) {
+                largest = k;
+            }
+        }
+
+        fixed_values[largest] = (int16_t)(fixed_values[largest] + (1 << SAIL_FILTER_WEIGHT_BITS) - fixed_total);
+
+        weights->firsts[i] = first;
+        weights->counts[i] = last - first;
+    }
+
+    sail_free(values);
+
+    return SAIL_OK;
+}
+
+static inline uint16_t filtered_uint16(int64_t sum) {
+
+    sum += 1 << (SAIL_FILTER_WEIGHT_BITS - 1);
+
+    if (sum < 0) {
+        return 0;
+    }
+
+    sum >>= SAIL_FILTER_WEIGHT_BITS;
+
+    return (sum > 65535) ? 65535 : (uint16_t)sum;
+}
+
+static void filter_columns_16(const uint16_t *scan_input, uint16_t *scan_output, unsigned width, unsigned components,
+                              const struct filter_weights *weights) {
+
+    for (unsigned column = 0; column < width; column++) {
+        const uint16_t *input = scan_input + weights->firsts[column] * components;
+        const int16_t *column_weights = weights->values + (size_t)column * weights->stride;
+
+        for (unsigned c = 0; c < components; c++) {
+            int64_t sum = 0;
+
+            for (unsigned k = 0; k < weights->counts[column]; k++) {
+                sum += (int64_t)input[k * components + c] * column_weights[k];
+            }
+
+            scan_output[column * components + c] = filtered_uint16(sum);
+        }
+    }
+}
+
+static void filter_rows_16(const uint8_t *scan_input, size_t stride, unsigned count, const int16_t *weights,
+                           uint16_t *scan_output, unsigned length) {
+
+    for (unsigned i = 0; i < length; i++) {
+        int64_t sum = 0;
+
+        for (unsigned k = 0; k < count; k++) {
+            sum += (int64_t)((const uint16_t *)(scan_input + k * stride))[i] * weights[k];
+        }
+
+        scan_output[i] = filtered_uint16(sum);
+    }
+}
+
+/*
+ * Filters the rows [first_row, first_row + rows) of the input image horizontally into the output rows
+ * located 'output_stride' bytes apart.
+ */
+static void scale_horizontally(const struct sail_image *image, unsigned first_row, unsigned rows,
+                               unsigned components, unsigned component_size, const struct filter_weights *weights,
+                               unsigned width, uint8_t *output, size_t output_stride) {
+
+    const filter_columns_kernel_t kernel = filter_columns_kernel(components);
+    const bool parallel = (size_t)width * rows >= PARALLEL_PIXELS_THRESHOLD;
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) if (parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < rows; row++) {
+        const uint8_t *scan_input = sail_scan_line(image, first_row + row);
+        uint8_t *scan_output      = output + row * output_stride;
+
+        if (component_size == 1) {
+            kernel(scan_input, scan_output, width, weights->firsts, weights->counts, weights->values, weights->stride);
+        } else {
+            filter_columns_16((const uint16_t *)scan_input, (uint16_t *)scan_output, width, components, weights);
+        }
+    }
+}
+
+/*
+ * Filters the input rows located 'input_stride' bytes apart vertically into the output image.
+ * Output row N is computed from the input rows starting at weights->firsts[N] - first_row.
+ */
+static void scale_vertically(const uint8_t *input, size_t input_stride, unsigned first_row,
+                             unsigned component_size, const struct filter_weights *weights, struct sail_image *image_output) {
+
+    const filter_rows_kernel_t kernel = filter_rows_kernel();
+    const unsigned length = image_output->bytes_per_line / component_size;
+    const bool parallel = (size_t)image_output->width * image_output->height >= PARALLEL_PIXELS_THRESHOLD;
+    unsigned row;
+
+    #pragma omp parallel for schedule(SAIL_OPENMP_SCHEDULE) if (parallel) num_threads(sail_thread_pool_size())
+    for (row = 0; row < image_output->height; row++) {
+        const uint8_t *scan_input   = input + (weights->firsts[row] - first_row) * input_stride;
+        const int16_t *row_weights  = weights->values + (size_t)row * weights->stride;
+        uint8_t *scan_output        = sail_scan_line(image_output, row);
+
+        if (component_size == 1) {
+            kernel(scan_input, input_stride, weights->counts[row], row_weights, scan_output, length);
+        } else {
+            filter_rows_16(scan_input, input_stride, weights->counts[row], row_weights, (uint16_t *)scan_output, length);
+        }
+    }
+}
+
+static sail_status_t scale_impl(const struct sail_image *image, enum SailScaleFilter filter,
+                                unsigned components, unsigned component_size, struct sail_image *image_output) {
+
+    const bool scale_width  = image_output->width != image->width;
+    const bool scale_height = image_output->height != image->height;
+
+    struct filter_weights horizontal_weights = { NULL, NULL, NULL, 0 };
+    struct filter_weights vertical_weights   = { NULL, NULL, NULL, 0 };
+
+    if (scale_width) {
+        SAIL_TRY(alloc_filter_weights(image->width, image_output->width, filter, &horizontal_weights));
+    }
+
+    if (scale_height) {
+        SAIL_TRY_OR_CLEANUP(alloc_filter_weights(image->height, image_output->height, filter, &vertical_weights),
+                            /* cleanup */ destroy_filter_weights(&horizontal_weights));
+    }
+
+    if (!scale_height) {
+        scale_horizontally(image, 0, image->height, components, component_size, &horizontal_weights,
+                           image_output->width, image_output->pixels, image_output->bytes_per_line);
+    } else if (!scale_width) {
+        scale_vertically(image->pixels, image->bytes_per_line, 0, component_size, &vertical_weights, image_output);
+    } else {
+        /* Filter only the input rows the vertical pass needs. */
+        const unsigned last_output_row = image_output->height - 1;
+        const unsigned first_row = vertical_weights.firsts[0];
+        const unsigned rows      = vertical_weights.firsts[last_output_row] + vertical_weights.counts[last_output_row] - first_row;
+        const size_t stride      = sail_bytes_per_line(image_output->width, image_output->pixel_format);
+
+        /* The intermediate rows of file-backed images are as tall as the input, so back them with a file too. */
+        const bool file_backed = image->pixels_file_backed_size > 0;
+
+        void *temp;
+        SAIL_TRY_OR_CLEANUP(file_backed ? sail_alloc_file_backed_memory(stride * rows, &temp) : sail_malloc(stride * rows, &temp),
+                            /* cleanup */ destroy_filter_weights(&vertical_weights),
+                                          destroy_filter_weights(&horizontal_weights));
+
+        scale_horizontally(image, first_row, rows, components, component_size, &horizontal_weights,
+                           image_output->width, temp, stride);
+        scale_vertically(temp, stride, first_row, component_size, &vertical_weights, image_output);
+
+        if (file_backed) {
+            sail_free_file_backed_memory(temp, stride * rows);
+        } else {
+            sail_free(temp);
+        }
+    }
+
+    destroy_filter_weights(&vertical_weights);
+    destroy_filter_weights(&horizontal_weights);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_scale_image(const struct sail_image *image,
+                               unsigned width,
+                               unsigned height,
+                               enum SailScaleFilter filter,
+                               struct sail_image **image_output) {
+
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(image_output);
+
+    if (width == 0 || height == 0) {
+        SAIL_LOG_ERROR("Cannot scale an image to %ux%u", width, height);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    unsigned components, component_size;
+
+    if (!components_of_pixel_format(image->pixel_format, &components, &component_size)) {
+        SAIL_LOG_ERROR("Scaling %s pixels is not supported", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_copy_image_skeleton(image, &image_local));
+
+    image_local->width          = width;
+    image_local->height         = height;
+    image_local->bytes_per_line = sail_bytes_per_line(image_local->width, image_local->pixel_format);
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_image_pixels(image_local, image->pixels_file_backed_size > 0),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    if (width == image->width && height == image->height) {
+        for (unsigned row = 0; row < height; row++) {
+            memcpy(sail_scan_line(image_local, row), sail_scan_line(image, row), image_local->bytes_per_line);
+        }
+    } else {
+        SAIL_TRY_OR_CLEANUP(scale_impl(image, filter, components, component_size, image_local),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    *image_output = image_local;
+
+    return SAIL_OK;
+}
@@ -0,0 +1,76 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_SCALE_H
+#define SAIL_SCALE_H
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#include <sail-manip/manip_common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_image;
+
+/*
+ * Scales the input image to the specified dimensions with the filter and saves the result
+ * in the output image.
+ *
+ * The image is filtered horizontally and vertically in two separable passes with precomputed
+ * fixed-point weights. The vertical pass and the horizontal pass over 4-component pixels use
+ * SSSE3 or NEON instructions when available. Large images are scaled in multiple threads with OpenMP.
+ *
+ * All components including alpha are filtered independently. Scale images with premultiplied alpha,
+ * for example SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, to avoid color fringes around transparent areas.
+ *
+ * The resulting image gets updated dimensions and bytes per line. Other properties are copied from
+ * the original image.
+ *
+ * Allowed input pixel formats:
+ *   - Grayscale, RGB, YCbCr, CMYK, and YCCK formats with 8 or 16 bits per component,
+ *     with or without alpha. For example, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+ *     SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP32_BGRA, or SAIL_PIXEL_FORMAT_BPP64_RGBA.
+ *
+ * Indexed images and pixel formats with components of other sizes are not supported.
+ * Convert them with sail_convert_image() first.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT if the pixel format is not supported.
+ */
+SAIL_EXPORT sail_status_t sail_scale_image(const struct sail_image *image,
+                                           unsigned width,
+                                           unsigned height,
+                                           enum SailScaleFilter filter,
+                                           struct sail_image **image_output);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
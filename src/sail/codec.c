@@ -55,30 +55,7 @@ static sail_status_t alloc_codec(struct sail_codec **codec) {
     return SAIL_OK;
 }
 
-#ifdef SAIL_COMBINE_CODECS
-static sail_status_t load_combined_codec(const struct sail_codec_info *codec_info, struct sail_codec *codec) {
-
-#ifdef SAIL_STATIC
-    /* For example: [ "gif", "jpeg", "png" ]. */
-    extern const char * const sail_enabled_codecs[];
-    extern struct sail_codec_layout_v8 const sail_enabled_codecs_layouts[];
-#else
-    SAIL_IMPORT extern const char * const sail_enabled_codecs[];
-    SAIL_IMPORT extern struct sail_codec_layout_v8 const sail_enabled_codecs_layouts[];
-#endif
-    for (size_t i = 0; sail_enabled_codecs[i] != NULL; i++) {
-        if (strcmp(sail_enabled_codecs[i], codec_info->name) == 0) {
-            *codec->v8 = sail_enabled_codecs_layouts[i];
-            return SAIL_OK;
-        }
-    }
-
-    SAIL_LOG_ERROR("Failed to find combined %s codec", codec_info->name);
-    SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
-}
-#endif
-
-static sail_status_t load_codec_from_file(const struct sail_codec_info *codec_info, struct sail_codec *codec) {
+static sail_status_t open_codec_library(const struct sail_codec_info *codec_info, struct sail_codec *codec) {
 
 #ifdef SAIL_WIN32
     HMODULE handle = LoadLibraryEx(codec_info->path, NULL, LOAD_LIBRARY_SEARCH_SYSTEM32 | LOAD_LIBRARY_SEARCH_USER_DIRS);
@@ -100,6 +77,17 @@ static sail_status_t load_codec_from_file(const struct sail_codec_info *codec_in
 
     codec->handle = handle;
 
+    return SAIL_OK;
+}
+
+static sail_status_t resolve_codec_symbols(const struct sail_codec_info *codec_info, struct sail_codec *codec) {
+
+#ifdef SAIL_WIN32
+    HMODULE handle = codec->handle;
+#else
+    void *handle = codec->handle;
+#endif
+
 #ifdef SAIL_WIN32
     #define SAIL_RESOLVE_FUNC GetProcAddress
     #define SAIL_RESOLVE_LOG_ERROR(symbol) \
@@ -110,6 +98,23 @@ static sail_status_t load_codec_from_file(const struct sail_codec_info *codec_in
         SAIL_LOG_ERROR("Failed to resolve '%s' in '%s': %s", symbol, codec_info->path, dlerror())
 #endif
 
+    /* Codecs built with sail_codec() export all the functions as a single table. */
+    char layout_symbol_name[64];
+    const int written = snprintf(layout_symbol_name, sizeof(layout_symbol_name), "sail_codec_layout_v8_%s", codec_info->name);
+
+    if (written > 0 && (size_t)written < sizeof(layout_symbol_name)) {
+        sail_to_lower(layout_symbol_name);
+
+        const struct sail_codec_layout_v8 *layout =
+            (const struct sail_codec_layout_v8 *)SAIL_RESOLVE_FUNC(handle, layout_symbol_name);
+
+        if (layout != NULL) {
+            *codec->v8 = *layout;
+            return SAIL_OK;
+        }
+    }
+
+    /* Client codecs may export the functions only. */
 #define SAIL_RESOLVE(target, handle, symbol, name)                                 \
     {                                                                              \
         char *full_symbol_name;                                                    \
@@ -134,6 +139,28 @@ static sail_status_t load_codec_from_file(const struct sail_codec_info *codec_in
     SAIL_RESOLVE(codec->v8->load_frame,           handle, sail_codec_load_frame_v8,           codec_info->name);
     SAIL_RESOLVE(codec->v8->load_finish,          handle, sail_codec_load_finish_v8,          codec_info->name);
 
+    if (codec_info->load_features->features & SAIL_CODEC_FEATURE_SEEK) {
+        SAIL_RESOLVE(codec->v8->load_seek_frame,  handle, sail_codec_load_seek_frame_v8,      codec_info->name);
+    } else {
+        codec->v8->load_seek_frame = NULL;
+    }
+
+    if (codec_info->load_features->features & SAIL_CODEC_FEATURE_RESET) {
+        SAIL_RESOLVE(codec->v8->load_reset,       handle, sail_codec_load_reset_v8,           codec_info->name);
+    } else {
+        codec->v8->load_reset = NULL;
+    }
+
+    if (codec_info->load_features->features & SAIL_CODEC_FEATURE_PUSH) {
+        SAIL_RESOLVE(codec->v8->load_push_init,            handle, sail_codec_load_push_init_v8,            codec_info->name);
+        SAIL_RESOLVE(codec->v8->load_push_seek_next_frame, handle, sail_codec_load_push_seek_next_frame_v8, codec_info->name);
+        SAIL_RESOLVE(codec->v8->load_push_frame,           handle, sail_codec_load_push_frame_v8,           codec_info->name);
+    } else {
+        codec->v8->load_push_init            = NULL;
+        codec->v8->load_push_seek_next_frame = NULL;
+        codec->v8->load_push_frame           = NULL;
+    }
+
     SAIL_RESOLVE(codec->v8->save_init,            handle, sail_codec_save_init_v8,            codec_info->name);
     SAIL_RESOLVE(codec->v8->save_seek_next_frame, handle, sail_codec_save_seek_next_frame_v8, codec_info->name);
     SAIL_RESOLVE(codec->v8->save_frame,           handle, sail_codec_save_frame_v8,           codec_info->name);
@@ -142,6 +169,33 @@ static sail_status_t load_codec_from_file(const struct sail_codec_info *codec_in
     return SAIL_OK;
 }
 
+/* Runs the codec loading stage within a tracing span. */
+static sail_status_t run_traced(const char *span_name,
+                                sail_status_t (*stage)(const struct sail_codec_info *codec_info, struct sail_codec *codec),
+                                const struct sail_codec_info *codec_info, struct sail_codec *codec) {
+
+    if (!sail_is_tracing_enabled()) {
+        return stage(codec_info, codec);
+    }
+
+    struct sail_trace_attributes attributes = { codec_info->name, 0, 0, SAIL_PIXEL_FORMAT_UNKNOWN };
+    void *span = sail_begin_trace_span(span_name, &attributes);
+
+    const sail_status_t status = stage(codec_info, codec);
+
+    sail_end_trace_span(span, &attributes, status);
+
+    return status;
+}
+
+static sail_status_t load_codec_from_file(const struct sail_codec_info *codec_info, struct sail_codec *codec) {
+
+    SAIL_TRY(run_traced("open_codec_library",    open_codec_library,    codec_info, codec));
+    SAIL_TRY(run_traced("resolve_codec_symbols", resolve_codec_symbols, codec_info, codec));
+
+    return SAIL_OK;
+}
+
 /*
  * Public functions.
  */
@@ -157,53 +211,57 @@ sail_status_t alloc_and_load_codec(const struct sail_codec_info *codec_info, str
     }
 
     /*
-     * When SAIL_COMBINE_CODECS is ON, we can load built-in codecs with empty paths,
-     * and client codecs with non-empty paths from disk.
-     *
-     * When SAIL_COMBINE_CODECS is OFF, we can load only codecs with non-empty paths from disk.
+     * When SAIL_COMBINE_CODECS is ON, built-in codecs with empty paths are attached
+     * in alloc_combined_codec() when the context is initialized. Here we can load only
+     * client codecs with non-empty paths from disk.
      */
-#ifndef SAIL_COMBINE_CODECS
     if (codec_info->path == NULL) {
-        SAIL_LOG_ERROR("Failed to load %s codec with empty path when SAIL_COMBINE_CODECS is disabled", codec_info->name);
+        SAIL_LOG_ERROR("Failed to load %s codec with empty path", codec_info->name);
         SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
     }
-#endif
-
-    const bool fetch_combined_codec = codec_info->path == NULL;
 
     struct sail_codec *codec_local;
     SAIL_TRY(alloc_codec(&codec_local));
     codec_local->layout = codec_info->layout;
 
-    if (fetch_combined_codec) {
-        SAIL_LOG_DEBUG("Fetching V%d functions for %s codec", codec_info->layout, codec_info->name);
-    } else {
-        SAIL_LOG_DEBUG("Loading %s codec from %s", codec_info->name, codec_info->path);
-    }
+    SAIL_LOG_DEBUG("Loading %s codec from %s", codec_info->name, codec_info->path);
 
     void *ptr;
     SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct sail_codec_layout_v8), &ptr),
                         /* cleanup */ destroy_codec(codec_local));
     codec_local->v8 = ptr;
 
-#ifdef SAIL_COMBINE_CODECS
-    if (fetch_combined_codec) {
-        SAIL_TRY_OR_CLEANUP(load_combined_codec(codec_info, codec_local),
-                            /* cleanup */ destroy_codec(codec_local));
-    } else {
-        SAIL_TRY_OR_CLEANUP(load_codec_from_file(codec_info, codec_local),
-                            /* cleanup */ destroy_codec(codec_local));
-    }
-#else
     SAIL_TRY_OR_CLEANUP(load_codec_from_file(codec_info, codec_local),
                         /* cleanup */ destroy_codec(codec_local));
-#endif
 
     *codec = codec_local;
 
     return SAIL_OK;
 }
 
+#ifdef SAIL_COMBINE_CODECS
+sail_status_t alloc_combined_codec(const struct sail_codec_layout_v8 *layout, struct sail_codec **codec) {
+
+    SAIL_CHECK_PTR(layout);
+    SAIL_CHECK_PTR(codec);
+
+    struct sail_codec *codec_local;
+    SAIL_TRY(alloc_codec(&codec_local));
+    codec_local->layout = SAIL_CODEC_LAYOUT_V8;
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct sail_codec_layout_v8), &ptr),
+                        /* cleanup */ destroy_codec(codec_local));
+    codec_local->v8 = ptr;
+
+    *codec_local->v8 = *layout;
+
+    *codec = codec_local;
+
+    return SAIL_OK;
+}
+#endif
+
 void destroy_codec(struct sail_codec *codec) {
 
     if (codec == NULL) {
@@ -59,6 +59,15 @@ typedef struct sail_codec sail_codec_t;
  */
 SAIL_HIDDEN sail_status_t alloc_and_load_codec(const struct sail_codec_info *codec_info, struct sail_codec **codec);
 
+#ifdef SAIL_COMBINE_CODECS
+/*
+ * Allocates a built-in codec with the specified functions from the combined library.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t alloc_combined_codec(const struct sail_codec_layout_v8 *layout, struct sail_codec **codec);
+#endif
+
 /*
  * Destroys the specified codec and all its internal memory buffers.
  * Does nothing if the codec is NULL.
@@ -33,3 +33,13 @@ const struct sail_codec_bundle_node* sail_codec_bundle_list(void) {
 
     return context->codec_bundle_node;
 }
+
+const struct sail_codec_bundle_node* sail_codec_bundle_list_in_context(const struct sail_context *context) {
+
+    if (context == NULL) {
+        SAIL_LOG_ERROR("Context is NULL");
+        return NULL;
+    }
+
+    return context->codec_bundle_node;
+}
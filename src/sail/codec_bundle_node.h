@@ -33,6 +33,7 @@ extern "C" {
 #endif
 
 struct sail_codec_bundle;
+struct sail_context;
 
 /*
  * A structure representing a codec information linked list.
@@ -56,6 +57,14 @@ typedef struct sail_codec_bundle_node sail_codec_bundle_node_t;
  */
 SAIL_EXPORT const struct sail_codec_bundle_node* sail_codec_bundle_list(void);
 
+/*
+ * Returns a linked list of codec info nodes found by the specified explicit context
+ * allocated by sail_alloc_context().
+ *
+ * Returns a pointer to the first codec info node or NULL when no SAIL codecs were found.
+ */
+SAIL_EXPORT const struct sail_codec_bundle_node* sail_codec_bundle_list_in_context(const struct sail_context *context);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
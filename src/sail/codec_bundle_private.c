@@ -23,8 +23,50 @@
     SOFTWARE.
 */
 
+#include <stddef.h> /* size_t */
+
 #include <sail/sail.h>
 
+/*
+ * Private functions.
+ */
+
+/*
+ * Destroys the codec info unless it's constant data of a built-in codec from sail-codecs.
+ * Shallow copies of built-in codec infos share their data with the originals.
+ */
+static void destroy_bundled_codec_info(struct sail_codec_info *codec_info) {
+
+#ifdef SAIL_COMBINE_CODECS
+#ifdef SAIL_STATIC
+    extern struct sail_codec_info * const sail_enabled_codecs_info[];
+#else
+    SAIL_IMPORT extern struct sail_codec_info * const sail_enabled_codecs_info[];
+#endif
+
+    if (codec_info == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; sail_enabled_codecs_info[i] != NULL; i++) {
+        if (sail_enabled_codecs_info[i] == codec_info) {
+            return;
+        }
+
+        if (sail_enabled_codecs_info[i]->load_features == codec_info->load_features) {
+            sail_free(codec_info);
+            return;
+        }
+    }
+#endif
+
+    destroy_codec_info(codec_info);
+}
+
+/*
+ * Public functions.
+ */
+
 sail_status_t alloc_codec_bundle(struct sail_codec_bundle **codec_bundle) {
 
     SAIL_CHECK_PTR(codec_bundle);
@@ -45,7 +87,7 @@ void destroy_codec_bundle(struct sail_codec_bundle *codec_bundle) {
         return;
     }
 
-    destroy_codec_info(codec_bundle->codec_info);
+    destroy_bundled_codec_info(codec_bundle->codec_info);
     destroy_codec(codec_bundle->codec);
 
     sail_free(codec_bundle);
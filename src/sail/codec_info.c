@@ -29,8 +29,44 @@
 
 #include <sail/sail.h>
 
+/*
+ * Private functions.
+ */
+
+/* \xFF\xDD => "ff dd". The string must be at least size * 3 bytes long. */
+static void magic_number_to_hex_string(const unsigned char *buffer, size_t size, char *hex_numbers) {
+
+    char *hex_numbers_ptr = hex_numbers;
+
+    for (size_t i = 0; i < size; i++, hex_numbers_ptr += 3) {
+#ifdef _MSC_VER
+        sprintf_s(hex_numbers_ptr, 4, "%02x ", buffer[i]);
+#else
+        snprintf(hex_numbers_ptr, 4, "%02x ", buffer[i]);
+#endif
+    }
+
+    *(hex_numbers_ptr-1) = '\0';
+}
+
+/*
+ * Public functions.
+ */
+
 sail_status_t sail_codec_info_from_path(const char *path, const struct sail_codec_info **codec_info) {
 
+    struct sail_context *context;
+    SAIL_TRY(fetch_global_context_guarded(&context));
+
+    SAIL_TRY(sail_codec_info_from_path_in_context(context, path, codec_info));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_codec_info_from_path_in_context(const struct sail_context *context, const char *path,
+                                                   const struct sail_codec_info **codec_info) {
+
+    SAIL_CHECK_PTR(context);
     SAIL_CHECK_PTR(path);
     SAIL_CHECK_PTR(codec_info);
 
@@ -64,7 +100,7 @@ sail_status_t sail_codec_info_from_path(const char *path, const struct sail_code
         SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
     }
 
-    SAIL_TRY(sail_codec_info_from_extension(dot+1, codec_info));
+    SAIL_TRY(sail_codec_info_from_extension_in_context(context, dot+1, codec_info));
 
     return SAIL_OK;
 }
@@ -103,179 +139,143 @@ sail_status_t sail_codec_info_by_magic_number_from_memory(const void *buffer, si
 
 sail_status_t sail_codec_info_by_magic_number_from_io(struct sail_io *io, const struct sail_codec_info **codec_info) {
 
-    SAIL_CHECK_PTR(io);
-    SAIL_CHECK_PTR(codec_info);
-
     struct sail_context *context;
     SAIL_TRY(fetch_global_context_guarded(&context));
 
+    SAIL_TRY(sail_codec_info_by_magic_number_from_io_in_context(context, io, codec_info));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_codec_info_by_magic_number_from_io_in_context(const struct sail_context *context, struct sail_io *io,
+                                                                 const struct sail_codec_info **codec_info) {
+
+    SAIL_CHECK_PTR(context);
+    SAIL_CHECK_PTR(io);
+    SAIL_CHECK_PTR(codec_info);
+
     size_t saved_offset;
     SAIL_TRY(io->tell(io->stream, &saved_offset));
 
-    /* Read the image magic. */
-    unsigned char buffer[SAIL_MAGIC_BUFFER_SIZE];
-    SAIL_TRY(io->strict_read(io->stream, buffer, sizeof(buffer)));
+    /* Read the image magic. Images shorter than the magic buffer can still match shorter magic numbers. */
+    unsigned char buffer[SAIL_MAGIC_BUFFER_SIZE] = { 0 };
+    size_t read_size;
+    SAIL_TRY(sail_io_will_need(io, saved_offset, sizeof(buffer)));
+    SAIL_TRY(io->tolerant_read(io->stream, buffer, sizeof(buffer), &read_size));
 
     /* Seek back. */
     SAIL_TRY(io->seek(io->stream, (long)saved_offset, SEEK_SET));
 
-    /* \xFF\xDD => "FF DD" + string terminator. */
+    /* \xFF\xDD => "FF DD" + string terminator. Built only when it's going to be printed. */
     char hex_numbers[sizeof(buffer) * 3 + 1];
+    hex_numbers[0] = '\0';
 
-    /* Debug print. */
-    {
-        char *hex_numbers_ptr = hex_numbers;
-
-        for (size_t i = 0; i < sizeof(buffer); i++, hex_numbers_ptr += 3) {
-#ifdef _MSC_VER
-            sprintf_s(hex_numbers_ptr, 4, "%02x ", buffer[i]);
-#else
-            snprintf(hex_numbers_ptr, 4, "%02x ", buffer[i]);
-#endif
-        }
-
-        *(hex_numbers_ptr-1) = '\0';
+    if (sail_log_is_enabled(SAIL_LOG_LEVEL_DEBUG)) {
+        magic_number_to_hex_string(buffer, sizeof(buffer), hex_numbers);
         SAIL_LOG_DEBUG("Read magic number: '%s'", hex_numbers);
     }
 
     /* Find the codec info. */
-    for (struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
-        const struct sail_codec_bundle *codec_bundle = codec_bundle_node->codec_bundle;
-        const struct sail_string_node *magic_number_node = codec_bundle->codec_info->magic_number_node;
-
-        /*
-         * Split "ab cd" into bytes and compare individual bytes against the read magic number.
-         * Additionally, we support "??" pattern matching any byte. For example, "?? ?? 66 74"
-         * matches both "00 20 66 74" and "20 30 66 74".
-         */
-        while (magic_number_node != NULL) {
-            size_t buffer_index = 0;
-            const char *magic = magic_number_node->string;
-            char hex_byte[3];
-            int bytes_consumed = 0;
-            bool mismatch = false;
-
-            SAIL_LOG_TRACE("Check against %s magic '%s'", codec_bundle->codec_info->name, magic);
-
-#ifdef _MSC_VER
-            while (buffer_index < sizeof(buffer) && sscanf_s(magic, "%2s%n", hex_byte, (unsigned)sizeof(hex_byte), &bytes_consumed) == 1) {
-#else
-            while (buffer_index < sizeof(buffer) && sscanf(magic, "%2s%n", hex_byte, &bytes_consumed) == 1) {
-#endif
-                if (hex_byte[0] == '?') {
-                    SAIL_LOG_TRACE("Skipping ? character");
-                } else {
-                    unsigned byte = 0;
+    if (magic_number_matcher_find(context->magic_number_matcher, buffer, read_size, codec_info, NULL) == SAIL_OK) {
+        SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
+        return SAIL_OK;
+    }
 
-#ifdef _MSC_VER
-                    if (sscanf_s(hex_byte, "%02x", &byte) != 1 || byte != buffer[buffer_index]) {
-#else
-                    if (sscanf(hex_byte, "%02x", &byte) != 1 || byte != buffer[buffer_index]) {
-#endif
-                        SAIL_LOG_TRACE("Character mismatch %02x != %02x", buffer[buffer_index], byte);
-                        mismatch = true;
-                        break;
-                    }
-                }
-
-                magic += bytes_consumed;
-                buffer_index++;
-            }
-
-            if (mismatch) {
-                magic_number_node = magic_number_node->next;
-            } else {
-                *codec_info = codec_bundle->codec_info;
-                SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
-                return SAIL_OK;
-            }
+    if (sail_log_is_enabled(SAIL_LOG_LEVEL_ERROR)) {
+        if (hex_numbers[0] == '\0') {
+            magic_number_to_hex_string(buffer, sizeof(buffer), hex_numbers);
         }
+
+        SAIL_LOG_ERROR("Magic number '%s' is not supported by any codec", hex_numbers);
     }
 
-    SAIL_LOG_ERROR("Magic number '%s' is not supported by any codec", hex_numbers);
     SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
 }
 
-sail_status_t sail_codec_info_from_extension(const char *extension, const struct sail_codec_info **codec_info) {
+sail_status_t sail_codec_info_sniff_from_memory(const void *buffer, size_t buffer_size,
+                                                const struct sail_codec_info **codec_info, unsigned *confidence) {
 
-    SAIL_CHECK_PTR(extension);
+    SAIL_CHECK_PTR(buffer);
     SAIL_CHECK_PTR(codec_info);
 
-    SAIL_LOG_DEBUG("Finding codec info for extension '%s'", extension);
+    struct sail_context *context;
+    SAIL_TRY(fetch_global_context_guarded(&context));
+
+    /* Only the magic window is matched, so a longer prefix is fine. */
+    unsigned char magic_buffer[SAIL_MAGIC_BUFFER_SIZE] = { 0 };
+    const size_t magic_buffer_size = (buffer_size < sizeof(magic_buffer)) ? buffer_size : sizeof(magic_buffer);
+    memcpy(magic_buffer, buffer, magic_buffer_size);
+
+    unsigned confidence_local;
+
+    if (magic_number_matcher_find(context->magic_number_matcher, magic_buffer, magic_buffer_size, codec_info, &confidence_local) != SAIL_OK) {
+        /* Not an error. Sniffing arbitrary data is expected to fail. */
+        return SAIL_ERROR_CODEC_NOT_FOUND;
+    }
+
+    SAIL_LOG_DEBUG("Sniffed codec info: %s with confidence %u", (*codec_info)->name, confidence_local);
+
+    if (confidence != NULL) {
+        *confidence = confidence_local;
+    }
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_codec_info_from_extension(const char *extension, const struct sail_codec_info **codec_info) {
 
     struct sail_context *context;
     SAIL_TRY(fetch_global_context_guarded(&context));
 
-    char *extension_copy;
-    SAIL_TRY(sail_strdup(extension, &extension_copy));
+    SAIL_TRY(sail_codec_info_from_extension_in_context(context, extension, codec_info));
 
-    /* Will compare in lower case. */
-    sail_to_lower(extension_copy);
+    return SAIL_OK;
+}
 
-    for (struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
-        const struct sail_codec_bundle *codec_bundle = codec_bundle_node->codec_bundle;
-        const struct sail_string_node *extension_node = codec_bundle->codec_info->extension_node;
+sail_status_t sail_codec_info_from_extension_in_context(const struct sail_context *context, const char *extension,
+                                                        const struct sail_codec_info **codec_info) {
 
-        while (extension_node != NULL) {
-            SAIL_LOG_TRACE("Check against %s extension '%s'", codec_bundle->codec_info->name, extension_node->string);
+    SAIL_CHECK_PTR(context);
+    SAIL_CHECK_PTR(extension);
+    SAIL_CHECK_PTR(codec_info);
 
-            if (strcmp(extension_node->string, extension_copy) == 0) {
-                sail_free(extension_copy);
-                *codec_info = codec_bundle->codec_info;
-                SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
-                return SAIL_OK;
-            } else {
-                SAIL_LOG_TRACE("Extension mismatch '%s' != '%s'", extension_copy, extension_node->string);
-            }
+    SAIL_LOG_DEBUG("Finding codec info for extension '%s'", extension);
 
-            extension_node = extension_node->next;
-        }
+    /* The index is case-insensitive. */
+    if (codec_info_index_find(context->extension_index, extension, codec_info) == SAIL_OK) {
+        SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
+        return SAIL_OK;
     }
 
-    sail_free(extension_copy);
     SAIL_LOG_ERROR("Extension %s is not supported by any codec", extension);
     SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
 }
 
 sail_status_t sail_codec_info_from_mime_type(const char *mime_type, const struct sail_codec_info **codec_info) {
 
-    SAIL_CHECK_PTR(mime_type);
-    SAIL_CHECK_PTR(codec_info);
-
-    SAIL_LOG_DEBUG("Finding codec info for mime type '%s'", mime_type);
-
     struct sail_context *context;
     SAIL_TRY(fetch_global_context_guarded(&context));
 
-    char *mime_type_copy;
-    SAIL_TRY(sail_strdup(mime_type, &mime_type_copy));
+    SAIL_TRY(sail_codec_info_from_mime_type_in_context(context, mime_type, codec_info));
 
-    /* Will compare in lower case. */
-    sail_to_lower(mime_type_copy);
-
-    for (struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
-        const struct sail_codec_bundle *codec_bundle = codec_bundle_node->codec_bundle;
-        const struct sail_string_node *mime_type_node = codec_bundle->codec_info->mime_type_node;
+    return SAIL_OK;
+}
 
-        while (mime_type_node != NULL) {
-            SAIL_LOG_TRACE("Check against %s MIME type '%s'", codec_bundle->codec_info->name, mime_type_node->string);
+sail_status_t sail_codec_info_from_mime_type_in_context(const struct sail_context *context, const char *mime_type,
+                                                        const struct sail_codec_info **codec_info) {
 
-            if (strcmp(mime_type_node->string, mime_type_copy) == 0) {
-                sail_free(mime_type_copy);
-                *codec_info = codec_bundle->codec_info;
-                SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
-                return SAIL_OK;
-            } else {
-                SAIL_LOG_TRACE("MIME type mismatch '%s' != '%s'", mime_type_copy, mime_type_node->string);
-            }
+    SAIL_CHECK_PTR(context);
+    SAIL_CHECK_PTR(mime_type);
+    SAIL_CHECK_PTR(codec_info);
 
-            mime_type_node = mime_type_node->next;
-        }
+    SAIL_LOG_DEBUG("Finding codec info for mime type '%s'", mime_type);
 
-        codec_bundle_node = codec_bundle_node->next;
+    /* The index is case-insensitive. */
+    if (codec_info_index_find(context->mime_type_index, mime_type, codec_info) == SAIL_OK) {
+        SAIL_LOG_DEBUG("Found codec info: %s", (*codec_info)->name);
+        return SAIL_OK;
     }
 
-    sail_free(mime_type_copy);
     SAIL_LOG_ERROR("MIME type %s is not supported by any codec", mime_type);
     SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
 }
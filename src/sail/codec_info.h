@@ -37,6 +37,7 @@
 extern "C" {
 #endif
 
+struct sail_context;
 struct sail_io;
 struct sail_load_features;
 struct sail_save_features;
@@ -114,7 +115,8 @@ typedef struct sail_codec_info sail_codec_info_t;
 SAIL_EXPORT sail_status_t sail_codec_info_from_path(const char *path, const struct sail_codec_info **codec_info);
 
 /*
- * Finds a first codec info object that supports the magic number read from the specified file.
+ * Finds a codec info object that supports the magic number read from the specified file.
+ * When multiple codecs match, the one with the most specific magic number wins. See sail_codec_info_sniff_from_memory().
  * The comparison algorithm is case insensitive.
  *
  * The assigned codec info MUST NOT be destroyed. It is a pointer to an internal data structure.
@@ -129,7 +131,8 @@ SAIL_EXPORT sail_status_t sail_codec_info_from_path(const char *path, const stru
 SAIL_EXPORT sail_status_t sail_codec_info_by_magic_number_from_path(const char *path, const struct sail_codec_info **codec_info);
 
 /*
- * Finds a first codec info object that supports the magic number read from the specified memory buffer.
+ * Finds a codec info object that supports the magic number read from the specified memory buffer.
+ * When multiple codecs match, the one with the most specific magic number wins. See sail_codec_info_sniff_from_memory().
  * The comparison algorithm is case insensitive.
  *
  * The assigned codec info MUST NOT be destroyed. It is a pointer to an internal data structure.
@@ -145,7 +148,8 @@ SAIL_EXPORT sail_status_t sail_codec_info_by_magic_number_from_memory(const void
                                                                       const struct sail_codec_info **codec_info);
 
 /*
- * Finds a first codec info object that supports the magic number read from the specified I/O data source.
+ * Finds a codec info object that supports the magic number read from the specified I/O data source.
+ * When multiple codecs match, the one with the most specific magic number wins. See sail_codec_info_sniff_from_memory().
  * The comparison algorithm is case insensitive. After loading a magic number, this function rewinds the I/O
  * cursor position back to the previous position. That's why the I/O source must be seekable.
  *
@@ -163,6 +167,25 @@ SAIL_EXPORT sail_status_t sail_codec_info_by_magic_number_from_memory(const void
  */
 SAIL_EXPORT sail_status_t sail_codec_info_by_magic_number_from_io(struct sail_io *io, const struct sail_codec_info **codec_info);
 
+/*
+ * Finds the codec info object which magic number matches the specified memory buffer
+ * with the highest confidence. Magic numbers with more non-wildcard bytes are more specific
+ * and win over the shorter ones. Among equally specific magic numbers, the codec priority wins.
+ * In contrast to sail_codec_info_by_magic_number_from_memory(), it doesn't log errors when no codec
+ * matches, so it's suitable for sniffing arbitrary data. Only the first SAIL_MAGIC_BUFFER_SIZE bytes
+ * of the buffer are used.
+ *
+ * If 'confidence' is not NULL, it's assigned the number of matched non-wildcard bytes.
+ * Use it to decide whether to trust the result or to fall back to another detection method,
+ * for example, to the file extension.
+ *
+ * The assigned codec info MUST NOT be destroyed. It is a pointer to an internal data structure.
+ *
+ * Returns SAIL_OK on success or SAIL_ERROR_CODEC_NOT_FOUND when no codec matches.
+ */
+SAIL_EXPORT sail_status_t sail_codec_info_sniff_from_memory(const void *buffer, size_t buffer_size,
+                                                            const struct sail_codec_info **codec_info, unsigned *confidence);
+
 /*
  * Finds a first codec info object that supports the specified file extension.
  * The comparison algorithm is case insensitive. For example: "jpg".
@@ -203,6 +226,29 @@ SAIL_EXPORT sail_status_t sail_codec_info_from_extension(const char *extension,
  */
 SAIL_EXPORT sail_status_t sail_codec_info_from_mime_type(const char *mime_type, const struct sail_codec_info **codec_info);
 
+/*
+ * Functions working with explicit contexts allocated by sail_alloc_context(). They behave exactly
+ * like the functions above, but search the codec info objects of the specified context instead of
+ * the global static context. The found codec info objects can be used only with the functions
+ * accepting the same context like sail_start_loading_from_io_in_context().
+ *
+ * The assigned codec info MUST NOT be destroyed. It is a pointer to an internal data structure
+ * of the context.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_codec_info_from_path_in_context(const struct sail_context *context, const char *path,
+                                                               const struct sail_codec_info **codec_info);
+
+SAIL_EXPORT sail_status_t sail_codec_info_by_magic_number_from_io_in_context(const struct sail_context *context, struct sail_io *io,
+                                                                             const struct sail_codec_info **codec_info);
+
+SAIL_EXPORT sail_status_t sail_codec_info_from_extension_in_context(const struct sail_context *context, const char *extension,
+                                                                    const struct sail_codec_info **codec_info);
+
+SAIL_EXPORT sail_status_t sail_codec_info_from_mime_type_in_context(const struct sail_context *context, const char *mime_type,
+                                                                    const struct sail_codec_info **codec_info);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
@@ -0,0 +1,697 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef SAIL_WIN32
+    #include <process.h> /* _getpid */
+    #include <windows.h> /* MoveFileEx */
+#else
+    #include <unistd.h> /* getpid */
+#endif
+
+#include <sail/sail.h>
+
+/* Bump the format version every time the cache layout changes. */
+static const char CACHE_MAGIC[8] = { 'S', 'A', 'I', 'L', 'C', 'C', 'H', '\0' };
+static const uint32_t CACHE_FORMAT_VERSION = 1;
+static const uint32_t CACHE_BYTE_ORDER_MARK = 0x01020304;
+
+/* NULL strings are stored with this length. */
+static const uint32_t CACHE_NULL_STRING_LENGTH = UINT32_MAX;
+
+struct cache_writer {
+
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+};
+
+struct cache_reader {
+
+    const unsigned char *data;
+    size_t size;
+    size_t offset;
+};
+
+/*
+ * Private functions.
+ */
+
+static uint64_t codecs_path_modification_time(const char *path) {
+
+    uint64_t mtime;
+
+    /* Missing paths are allowed. They just don't contribute any codecs. */
+    if (!sail_is_dir(path) || sail_path_modification_time(path, &mtime) != SAIL_OK) {
+        return 0;
+    }
+
+    return mtime;
+}
+
+static sail_status_t write_bytes(struct cache_writer *writer, const void *bytes, size_t size) {
+
+    if (writer->size + size > writer->capacity) {
+        size_t capacity = (writer->capacity == 0) ? 4096 : writer->capacity;
+
+        while (writer->size + size > capacity) {
+            capacity *= 2;
+        }
+
+        void *ptr = writer->data;
+        SAIL_TRY(sail_realloc(capacity, &ptr));
+
+        writer->data     = ptr;
+        writer->capacity = capacity;
+    }
+
+    memcpy(writer->data + writer->size, bytes, size);
+    writer->size += size;
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_uint32(struct cache_writer *writer, uint32_t value) {
+
+    SAIL_TRY(write_bytes(writer, &value, sizeof(value)));
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_int(struct cache_writer *writer, int value) {
+
+    const int32_t value32 = value;
+    SAIL_TRY(write_bytes(writer, &value32, sizeof(value32)));
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_uint64(struct cache_writer *writer, uint64_t value) {
+
+    SAIL_TRY(write_bytes(writer, &value, sizeof(value)));
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_double(struct cache_writer *writer, double value) {
+
+    SAIL_TRY(write_bytes(writer, &value, sizeof(value)));
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_string(struct cache_writer *writer, const char *str) {
+
+    if (str == NULL) {
+        SAIL_TRY(write_uint32(writer, CACHE_NULL_STRING_LENGTH));
+    } else {
+        const size_t length = strlen(str);
+
+        SAIL_TRY(write_uint32(writer, (uint32_t)length));
+        SAIL_TRY(write_bytes(writer, str, length));
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_string_node_chain(struct cache_writer *writer, const struct sail_string_node *string_node) {
+
+    uint32_t count = 0;
+
+    for (const struct sail_string_node *node = string_node; node != NULL; node = node->next) {
+        count++;
+    }
+
+    SAIL_TRY(write_uint32(writer, count));
+
+    for (const struct sail_string_node *node = string_node; node != NULL; node = node->next) {
+        SAIL_TRY(write_string(writer, node->string));
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_load_features(struct cache_writer *writer, const struct sail_load_features *load_features) {
+
+    SAIL_TRY(write_int(writer, load_features->features));
+    SAIL_TRY(write_string_node_chain(writer, load_features->tuning));
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_save_features(struct cache_writer *writer, const struct sail_save_features *save_features) {
+
+    SAIL_TRY(write_uint32(writer, save_features->pixel_formats_length));
+
+    for (unsigned i = 0; i < save_features->pixel_formats_length; i++) {
+        SAIL_TRY(write_int(writer, save_features->pixel_formats[i]));
+    }
+
+    SAIL_TRY(write_int(writer, save_features->features));
+
+    SAIL_TRY(write_uint32(writer, save_features->compressions_length));
+
+    for (unsigned i = 0; i < save_features->compressions_length; i++) {
+        SAIL_TRY(write_int(writer, save_features->compressions[i]));
+    }
+
+    SAIL_TRY(write_int(writer, save_features->default_compression));
+
+    if (save_features->compression_level == NULL) {
+        SAIL_TRY(write_uint32(writer, 0));
+    } else {
+        SAIL_TRY(write_uint32(writer, 1));
+        SAIL_TRY(write_double(writer, save_features->compression_level->min_level));
+        SAIL_TRY(write_double(writer, save_features->compression_level->max_level));
+        SAIL_TRY(write_double(writer, save_features->compression_level->default_level));
+        SAIL_TRY(write_double(writer, save_features->compression_level->step));
+    }
+
+    SAIL_TRY(write_string_node_chain(writer, save_features->tuning));
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_codec_info(struct cache_writer *writer, const struct sail_codec_info *codec_info) {
+
+    SAIL_TRY(write_string(writer, codec_info->path));
+    SAIL_TRY(write_int(writer, codec_info->layout));
+    SAIL_TRY(write_int(writer, codec_info->priority));
+    SAIL_TRY(write_string(writer, codec_info->version));
+    SAIL_TRY(write_string(writer, codec_info->name));
+    SAIL_TRY(write_string(writer, codec_info->description));
+    SAIL_TRY(write_string_node_chain(writer, codec_info->magic_number_node));
+    SAIL_TRY(write_string_node_chain(writer, codec_info->extension_node));
+    SAIL_TRY(write_string_node_chain(writer, codec_info->mime_type_node));
+    SAIL_TRY(write_load_features(writer, codec_info->load_features));
+    SAIL_TRY(write_save_features(writer, codec_info->save_features));
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_cache(struct cache_writer *writer,
+                                 const struct sail_string_node *codecs_paths,
+                                 const struct sail_codec_bundle_node *codec_bundle_node) {
+
+    SAIL_TRY(write_bytes(writer, CACHE_MAGIC, sizeof(CACHE_MAGIC)));
+    SAIL_TRY(write_uint32(writer, CACHE_BYTE_ORDER_MARK));
+    SAIL_TRY(write_uint32(writer, CACHE_FORMAT_VERSION));
+    SAIL_TRY(write_uint32(writer, SAIL_VERSION));
+
+    /* Cache key. */
+    uint32_t paths_count = 0;
+
+    for (const struct sail_string_node *node = codecs_paths; node != NULL; node = node->next) {
+        paths_count++;
+    }
+
+    SAIL_TRY(write_uint32(writer, paths_count));
+
+    const uint64_t now = (uint64_t)time(NULL);
+
+    for (const struct sail_string_node *node = codecs_paths; node != NULL; node = node->next) {
+        const uint64_t mtime = codecs_path_modification_time(node->string);
+
+        /*
+         * The modification time has a granularity of one second. A codec installed in the same second
+         * right after the enumeration would not invalidate the cache, so don't save it at all.
+         */
+        if (mtime + 1 >= now) {
+            SAIL_LOG_DEBUG("'%s' was modified too recently to cache its codecs", node->string);
+            return SAIL_ERROR_CONFLICTING_OPERATION;
+        }
+
+        SAIL_TRY(write_string(writer, node->string));
+        SAIL_TRY(write_uint64(writer, mtime));
+    }
+
+    /* Codec infos. */
+    uint32_t codecs_count = 0;
+
+    for (const struct sail_codec_bundle_node *node = codec_bundle_node; node != NULL; node = node->next) {
+        codecs_count++;
+    }
+
+    SAIL_TRY(write_uint32(writer, codecs_count));
+
+    for (const struct sail_codec_bundle_node *node = codec_bundle_node; node != NULL; node = node->next) {
+        SAIL_TRY(write_codec_info(writer, node->codec_bundle->codec_info));
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_bytes(struct cache_reader *reader, void *bytes, size_t size) {
+
+    if (reader->size - reader->offset < size) {
+        SAIL_LOG_ERROR("Codec info cache is truncated");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_PARSE_FILE);
+    }
+
+    memcpy(bytes, reader->data + reader->offset, size);
+    reader->offset += size;
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_uint32(struct cache_reader *reader, uint32_t *value) {
+
+    SAIL_TRY(read_bytes(reader, value, sizeof(*value)));
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_int(struct cache_reader *reader, int *value) {
+
+    int32_t value32;
+    SAIL_TRY(read_bytes(reader, &value32, sizeof(value32)));
+
+    *value = value32;
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_uint64(struct cache_reader *reader, uint64_t *value) {
+
+    SAIL_TRY(read_bytes(reader, value, sizeof(*value)));
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_double(struct cache_reader *reader, double *value) {
+
+    SAIL_TRY(read_bytes(reader, value, sizeof(*value)));
+
+    return SAIL_OK;
+}
+
+/* Validates the number of the following elements of the specified size against the remaining data. */
+static sail_status_t read_count(struct cache_reader *reader, size_t element_size, uint32_t *count) {
+
+    SAIL_TRY(read_uint32(reader, count));
+
+    if ((reader->size - reader->offset) / element_size < *count) {
+        SAIL_LOG_ERROR("Codec info cache is truncated");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_PARSE_FILE);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_string(struct cache_reader *reader, char **str) {
+
+    uint32_t length;
+    SAIL_TRY(read_uint32(reader, &length));
+
+    if (length == CACHE_NULL_STRING_LENGTH) {
+        *str = NULL;
+        return SAIL_OK;
+    }
+
+    if (reader->size - reader->offset < length) {
+        SAIL_LOG_ERROR("Codec info cache is truncated");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_PARSE_FILE);
+    }
+
+    if (length == 0) {
+        SAIL_TRY(sail_strdup("", str));
+    } else {
+        SAIL_TRY(sail_strdup_length((const char *)reader->data + reader->offset, length, str));
+    }
+
+    reader->offset += length;
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_string_node_chain(struct cache_reader *reader, struct sail_string_node **string_node) {
+
+    uint32_t count;
+    SAIL_TRY(read_count(reader, sizeof(uint32_t), &count));
+
+    struct sail_string_node *first_string_node = NULL;
+    struct sail_string_node **last_string_node = &first_string_node;
+
+    for (uint32_t i = 0; i < count; i++) {
+        struct sail_string_node *node;
+        SAIL_TRY_OR_CLEANUP(sail_alloc_string_node(&node),
+                            /* cleanup */ sail_destroy_string_node_chain(first_string_node));
+
+        *last_string_node = node;
+        last_string_node = &node->next;
+
+        SAIL_TRY_OR_CLEANUP(read_string(reader, &node->string),
+                            /* cleanup */ sail_destroy_string_node_chain(first_string_node));
+    }
+
+    *string_node = first_string_node;
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_ints(struct cache_reader *reader, int **values, unsigned *length) {
+
+    uint32_t count;
+    SAIL_TRY(read_count(reader, sizeof(int32_t), &count));
+
+    *length = count;
+
+    if (count == 0) {
+        *values = NULL;
+        return SAIL_OK;
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(count * sizeof(int), &ptr));
+    *values = ptr;
+
+    for (uint32_t i = 0; i < count; i++) {
+        SAIL_TRY(read_int(reader, &(*values)[i]));
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_load_features(struct cache_reader *reader, struct sail_load_features *load_features) {
+
+    SAIL_TRY(read_int(reader, &load_features->features));
+    SAIL_TRY(read_string_node_chain(reader, &load_features->tuning));
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_save_features(struct cache_reader *reader, struct sail_save_features *save_features) {
+
+    SAIL_TRY(read_ints(reader, (int **)&save_features->pixel_formats, &save_features->pixel_formats_length));
+    SAIL_TRY(read_int(reader, &save_features->features));
+    SAIL_TRY(read_ints(reader, (int **)&save_features->compressions, &save_features->compressions_length));
+
+    int default_compression;
+    SAIL_TRY(read_int(reader, &default_compression));
+    save_features->default_compression = default_compression;
+
+    uint32_t has_compression_level;
+    SAIL_TRY(read_uint32(reader, &has_compression_level));
+
+    if (has_compression_level != 0) {
+        SAIL_TRY(sail_alloc_compression_level(&save_features->compression_level));
+
+        SAIL_TRY(read_double(reader, &save_features->compression_level->min_level));
+        SAIL_TRY(read_double(reader, &save_features->compression_level->max_level));
+        SAIL_TRY(read_double(reader, &save_features->compression_level->default_level));
+        SAIL_TRY(read_double(reader, &save_features->compression_level->step));
+    }
+
+    SAIL_TRY(read_string_node_chain(reader, &save_features->tuning));
+
+    return SAIL_OK;
+}
+
+/* On error, the partially read fields are destroyed together with the codec info object by the caller. */
+static sail_status_t read_codec_info_fields(struct cache_reader *reader, struct sail_codec_info *codec_info) {
+
+    SAIL_TRY(read_string(reader, &codec_info->path));
+    SAIL_TRY(read_int(reader, &codec_info->layout));
+
+    int priority;
+    SAIL_TRY(read_int(reader, &priority));
+    codec_info->priority = priority;
+
+    SAIL_TRY(read_string(reader, &codec_info->version));
+    SAIL_TRY(read_string(reader, &codec_info->name));
+    SAIL_TRY(read_string(reader, &codec_info->description));
+    SAIL_TRY(read_string_node_chain(reader, &codec_info->magic_number_node));
+    SAIL_TRY(read_string_node_chain(reader, &codec_info->extension_node));
+    SAIL_TRY(read_string_node_chain(reader, &codec_info->mime_type_node));
+
+    SAIL_TRY(sail_alloc_load_features(&codec_info->load_features));
+    SAIL_TRY(read_load_features(reader, codec_info->load_features));
+
+    SAIL_TRY(sail_alloc_save_features(&codec_info->save_features));
+    SAIL_TRY(read_save_features(reader, codec_info->save_features));
+
+    if (codec_info->layout != SAIL_CODEC_LAYOUT_V8) {
+        SAIL_LOG_ERROR("Codec info cache contains unsupported codec layout version %d", codec_info->layout);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_CODEC_LAYOUT);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_codec_bundle_node(struct cache_reader *reader, struct sail_codec_bundle_node **codec_bundle_node) {
+
+    struct sail_codec_bundle_node *codec_bundle_node_local;
+    SAIL_TRY(alloc_codec_bundle_node(&codec_bundle_node_local));
+
+    SAIL_TRY_OR_CLEANUP(alloc_codec_bundle(&codec_bundle_node_local->codec_bundle),
+                        /* cleanup */ destroy_codec_bundle_node(codec_bundle_node_local));
+    SAIL_TRY_OR_CLEANUP(alloc_codec_info(&codec_bundle_node_local->codec_bundle->codec_info),
+                        /* cleanup */ destroy_codec_bundle_node(codec_bundle_node_local));
+    SAIL_TRY_OR_CLEANUP(read_codec_info_fields(reader, codec_bundle_node_local->codec_bundle->codec_info),
+                        /* cleanup */ destroy_codec_bundle_node(codec_bundle_node_local));
+
+    *codec_bundle_node = codec_bundle_node_local;
+
+    return SAIL_OK;
+}
+
+/* Returns SAIL_OK if the cache header and key match the current SAIL version and codecs paths. */
+static sail_status_t check_cache_key(struct cache_reader *reader, const struct sail_string_node *codecs_paths) {
+
+    char magic[sizeof(CACHE_MAGIC)];
+    uint32_t byte_order_mark;
+    uint32_t format_version;
+    uint32_t sail_version;
+
+    SAIL_TRY(read_bytes(reader, magic, sizeof(magic)));
+    SAIL_TRY(read_uint32(reader, &byte_order_mark));
+    SAIL_TRY(read_uint32(reader, &format_version));
+    SAIL_TRY(read_uint32(reader, &sail_version));
+
+    if (memcmp(magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || byte_order_mark != CACHE_BYTE_ORDER_MARK) {
+        SAIL_LOG_ERROR("File is not a codec info cache");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_PARSE_FILE);
+    }
+
+    if (format_version != CACHE_FORMAT_VERSION || sail_version != SAIL_VERSION) {
+        SAIL_LOG_DEBUG("Codec info cache was written by another SAIL version");
+        return SAIL_ERROR_PARSE_FILE;
+    }
+
+    uint32_t paths_count;
+    SAIL_TRY(read_uint32(reader, &paths_count));
+
+    const struct sail_string_node *node = codecs_paths;
+
+    for (uint32_t i = 0; i < paths_count; i++, node = node->next) {
+        if (node == NULL) {
+            SAIL_LOG_DEBUG("Codec info cache was saved for more codecs paths");
+            return SAIL_ERROR_PARSE_FILE;
+        }
+
+        char *path;
+        uint64_t mtime;
+
+        SAIL_TRY(read_string(reader, &path));
+        SAIL_TRY_OR_CLEANUP(read_uint64(reader, &mtime),
+                            /* cleanup */ sail_free(path));
+
+        const bool same_path = path != NULL && strcmp(path, node->string) == 0;
+        sail_free(path);
+
+        if (!same_path) {
+            SAIL_LOG_DEBUG("Codec info cache was saved for other codecs paths");
+            return SAIL_ERROR_PARSE_FILE;
+        }
+
+        if (mtime != codecs_path_modification_time(node->string)) {
+            SAIL_LOG_DEBUG("'%s' was modified since the codec info cache was saved", node->string);
+            return SAIL_ERROR_PARSE_FILE;
+        }
+    }
+
+    if (node != NULL) {
+        SAIL_LOG_DEBUG("Codec info cache was saved for fewer codecs paths");
+        return SAIL_ERROR_PARSE_FILE;
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_cache(struct cache_reader *reader,
+                                const struct sail_string_node *codecs_paths,
+                                struct sail_codec_bundle_node **codec_bundle_node) {
+
+    SAIL_TRY(check_cache_key(reader, codecs_paths));
+
+    uint32_t codecs_count;
+    SAIL_TRY(read_uint32(reader, &codecs_count));
+
+    struct sail_codec_bundle_node *first_codec_bundle_node = NULL;
+    struct sail_codec_bundle_node **last_codec_bundle_node = &first_codec_bundle_node;
+
+    for (uint32_t i = 0; i < codecs_count; i++) {
+        SAIL_TRY_OR_CLEANUP(read_codec_bundle_node(reader, last_codec_bundle_node),
+                            /* cleanup */ destroy_codec_bundle_node_chain(first_codec_bundle_node));
+
+        last_codec_bundle_node = &(*last_codec_bundle_node)->next;
+    }
+
+    if (reader->offset != reader->size) {
+        destroy_codec_bundle_node_chain(first_codec_bundle_node);
+        SAIL_LOG_ERROR("Codec info cache has trailing data");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_PARSE_FILE);
+    }
+
+    *codec_bundle_node = first_codec_bundle_node;
+
+    return SAIL_OK;
+}
+
+static sail_status_t replace_file(const char *source, const char *target) {
+
+#ifdef SAIL_WIN32
+    #ifdef SAIL_WINDOWS_UTF8_PATHS
+        wchar_t *wsource;
+        SAIL_TRY(sail_multibyte_to_wchar(source, &wsource));
+
+        wchar_t *wtarget;
+        SAIL_TRY_OR_CLEANUP(sail_multibyte_to_wchar(target, &wtarget),
+                            /* cleanup */ sail_free(wsource));
+
+        const BOOL moved = MoveFileExW(wsource, wtarget, MOVEFILE_REPLACE_EXISTING);
+
+        sail_free(wtarget);
+        sail_free(wsource);
+    #else
+        const BOOL moved = MoveFileExA(source, target, MOVEFILE_REPLACE_EXISTING);
+    #endif
+
+    if (!moved) {
+        SAIL_LOG_ERROR("Failed to move '%s' to '%s'. Error: 0x%X", source, target, GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+#else
+    if (rename(source, target) != 0) {
+        sail_print_errno("Failed to rename the codec info cache: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+#endif
+
+    return SAIL_OK;
+}
+
+static sail_status_t write_file(const char *path, const void *data, size_t data_size) {
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_write_file(path, &io));
+
+    SAIL_TRY_OR_CLEANUP(io->strict_write(io->stream, data, data_size),
+                        /* cleanup */ sail_destroy_io(io));
+    SAIL_TRY_OR_CLEANUP(io->flush(io->stream),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t codec_info_cache_load(const char *cache_path,
+                                    const struct sail_string_node *codecs_paths,
+                                    struct sail_codec_bundle_node **codec_bundle_node) {
+
+    SAIL_CHECK_PTR(cache_path);
+    SAIL_CHECK_PTR(codec_bundle_node);
+
+    if (!sail_is_file(cache_path)) {
+        SAIL_LOG_DEBUG("Codec info cache '%s' doesn't exist", cache_path);
+        return SAIL_ERROR_OPEN_FILE;
+    }
+
+    void *data;
+    size_t data_size;
+    SAIL_TRY(sail_alloc_data_from_file_contents(cache_path, &data, &data_size));
+
+    struct cache_reader reader = { data, data_size, 0 };
+
+    SAIL_TRY_OR_CLEANUP(read_cache(&reader, codecs_paths, codec_bundle_node),
+                        /* cleanup */ sail_free(data));
+
+    sail_free(data);
+
+    return SAIL_OK;
+}
+
+sail_status_t codec_info_cache_save(const char *cache_path,
+                                    const struct sail_string_node *codecs_paths,
+                                    const struct sail_codec_bundle_node *codec_bundle_node) {
+
+    SAIL_CHECK_PTR(cache_path);
+
+    struct cache_writer writer = { NULL, 0, 0 };
+
+    SAIL_TRY_OR_CLEANUP(write_cache(&writer, codecs_paths, codec_bundle_node),
+                        /* cleanup */ sail_free(writer.data));
+
+    /* Write into a unique temporary file and rename it to never expose a partially written cache. */
+    const size_t temp_path_size = strlen(cache_path) + 32;
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(temp_path_size, &ptr),
+                        /* cleanup */ sail_free(writer.data));
+    char *temp_path = ptr;
+
+#ifdef SAIL_WIN32
+    const unsigned pid = (unsigned)_getpid();
+#else
+    const unsigned pid = (unsigned)getpid();
+#endif
+
+    snprintf(temp_path, temp_path_size, "%s.%u.tmp", cache_path, pid);
+
+    SAIL_TRY_OR_CLEANUP(write_file(temp_path, writer.data, writer.size),
+                        /* cleanup */ remove(temp_path),
+                                      sail_free(temp_path),
+                                      sail_free(writer.data));
+    sail_free(writer.data);
+
+    SAIL_TRY_OR_CLEANUP(replace_file(temp_path, cache_path),
+                        /* cleanup */ remove(temp_path),
+                                      sail_free(temp_path));
+    sail_free(temp_path);
+
+    SAIL_LOG_DEBUG("Saved codec info cache '%s'", cache_path);
+
+    return SAIL_OK;
+}
@@ -0,0 +1,65 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_CODEC_INFO_CACHE_PRIVATE_H
+#define SAIL_CODEC_INFO_CACHE_PRIVATE_H
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_codec_bundle_node;
+struct sail_string_node;
+
+/*
+ * Binary cache of the codec info objects enumerated in a list of codecs paths. The cache is keyed
+ * by the list of paths and their modification times, so installing or removing a codec invalidates it.
+ * Modifying a codec info file in place doesn't change the directory modification time,
+ * so the cache file must be deleted in this case.
+ *
+ * The cache is stored in the native byte order and is not meant to be shared between machines.
+ */
+
+/*
+ * Loads codec bundles from the specified cache file. Fails if the cache doesn't exist, is corrupted,
+ * was written by another SAIL version, or any of the codecs paths was modified since the cache was saved.
+ * The codec bundles are not loaded, only their codec info objects are.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t codec_info_cache_load(const char *cache_path,
+                                                const struct sail_string_node *codecs_paths,
+                                                struct sail_codec_bundle_node **codec_bundle_node);
+
+/*
+ * Saves the codec info objects of the specified codec bundles enumerated in the specified codecs paths
+ * into the cache file. The file is written atomically, so concurrent processes never read a partial cache.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t codec_info_cache_save(const char *cache_path,
+                                                const struct sail_string_node *codecs_paths,
+                                                const struct sail_codec_bundle_node *codec_bundle_node);
+
+#endif
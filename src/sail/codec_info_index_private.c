@@ -0,0 +1,157 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+/*
+ * Private functions.
+ */
+
+/* djb2 over lower-cased characters, so the keys don't need to be copied and converted. */
+static uint64_t case_insensitive_hash(const char *str) {
+
+    uint64_t hash = 5381;
+    int c;
+
+    while ((c = (unsigned char)*str++) != 0) {
+        hash = ((hash << 5) + hash) + (uint64_t)tolower(c); /* hash * 33 + c */
+    }
+
+    return hash;
+}
+
+/* The second string must be in lower case. */
+static bool case_insensitive_equal(const char *str, const char *lower_str) {
+
+    for (; *str != '\0' && *lower_str != '\0'; str++, lower_str++) {
+        if (tolower((unsigned char)*str) != (unsigned char)*lower_str) {
+            return false;
+        }
+    }
+
+    return *str == '\0' && *lower_str == '\0';
+}
+
+static struct sail_codec_info_index_entry* find_entry(const struct sail_codec_info_index *index, const char *key, uint64_t hash) {
+
+    const size_t mask = index->capacity - 1;
+
+    for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask) {
+        struct sail_codec_info_index_entry *entry = index->entries + i;
+
+        if (entry->key == NULL || (entry->hash == hash && case_insensitive_equal(key, entry->key))) {
+            return entry;
+        }
+    }
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t alloc_codec_info_index(const struct sail_codec_bundle_node *codec_bundle_node,
+                                      codec_info_index_keys_t keys,
+                                      struct sail_codec_info_index **index) {
+
+    SAIL_CHECK_PTR(keys);
+    SAIL_CHECK_PTR(index);
+
+    size_t keys_length = 0;
+
+    for (const struct sail_codec_bundle_node *node = codec_bundle_node; node != NULL; node = node->next) {
+        for (const struct sail_string_node *key_node = keys(node->codec_bundle->codec_info); key_node != NULL; key_node = key_node->next) {
+            keys_length++;
+        }
+    }
+
+    /* Keep the load factor under 50% so probe sequences stay short. */
+    size_t capacity = 16;
+
+    while (capacity < keys_length * 2) {
+        capacity *= 2;
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_codec_info_index), &ptr));
+    struct sail_codec_info_index *index_local = ptr;
+
+    SAIL_TRY_OR_CLEANUP(sail_calloc(capacity, sizeof(struct sail_codec_info_index_entry), &ptr),
+                        /* cleanup */ sail_free(index_local));
+    index_local->entries  = ptr;
+    index_local->capacity = capacity;
+
+    for (const struct sail_codec_bundle_node *node = codec_bundle_node; node != NULL; node = node->next) {
+        const struct sail_codec_info *codec_info = node->codec_bundle->codec_info;
+
+        for (const struct sail_string_node *key_node = keys(codec_info); key_node != NULL; key_node = key_node->next) {
+            const uint64_t hash = case_insensitive_hash(key_node->string);
+            struct sail_codec_info_index_entry *entry = find_entry(index_local, key_node->string, hash);
+
+            /* Codecs with higher priorities come first and win. */
+            if (entry->key == NULL) {
+                entry->hash       = hash;
+                entry->key        = key_node->string;
+                entry->codec_info = codec_info;
+            }
+        }
+    }
+
+    *index = index_local;
+
+    return SAIL_OK;
+}
+
+void destroy_codec_info_index(struct sail_codec_info_index *index) {
+
+    if (index == NULL) {
+        return;
+    }
+
+    sail_free(index->entries);
+    sail_free(index);
+}
+
+sail_status_t codec_info_index_find(const struct sail_codec_info_index *index,
+                                     const char *key,
+                                     const struct sail_codec_info **codec_info) {
+
+    SAIL_CHECK_PTR(index);
+    SAIL_CHECK_PTR(key);
+    SAIL_CHECK_PTR(codec_info);
+
+    const struct sail_codec_info_index_entry *entry = find_entry(index, key, case_insensitive_hash(key));
+
+    if (entry->key == NULL) {
+        return SAIL_ERROR_CODEC_NOT_FOUND;
+    }
+
+    *codec_info = entry->codec_info;
+
+    return SAIL_OK;
+}
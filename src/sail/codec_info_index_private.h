@@ -0,0 +1,92 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_CODEC_INFO_INDEX_PRIVATE_H
+#define SAIL_CODEC_INFO_INDEX_PRIVATE_H
+
+#include <stddef.h> /* size_t */
+#include <stdint.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_codec_bundle_node;
+struct sail_codec_info;
+struct sail_string_node;
+
+struct sail_codec_info_index_entry {
+
+    /* Case-insensitive hash of the key. */
+    uint64_t hash;
+
+    /* Shallow pointer to a lower-case string owned by the codec info. NULL for empty entries. */
+    const char *key;
+
+    /* Shallow pointer to the codec info. */
+    const struct sail_codec_info *codec_info;
+};
+
+/*
+ * Open-addressing hash table mapping lower-case strings like file extensions or MIME types
+ * to codec info objects. It's built once on context initialization and never modified afterwards.
+ */
+struct sail_codec_info_index {
+
+    struct sail_codec_info_index_entry *entries;
+
+    /* Power of two. */
+    size_t capacity;
+};
+
+/*
+ * Returns a linked list of keys of the specified codec info to index. For example, its extensions.
+ */
+typedef const struct sail_string_node* (*codec_info_index_keys_t)(const struct sail_codec_info *codec_info);
+
+/*
+ * Builds a new index of the specified codec bundles. The codec bundles must be already sorted by priority.
+ * When multiple codecs share the same key, the first one wins.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t alloc_codec_info_index(const struct sail_codec_bundle_node *codec_bundle_node,
+                                                  codec_info_index_keys_t keys,
+                                                  struct sail_codec_info_index **index);
+
+/*
+ * Destroys the specified index. Does nothing if the index is NULL.
+ */
+SAIL_HIDDEN void destroy_codec_info_index(struct sail_codec_info_index *index);
+
+/*
+ * Finds a codec info by the specified key. The comparison is case-insensitive. Never allocates memory.
+ *
+ * Returns SAIL_OK on success or SAIL_ERROR_CODEC_NOT_FOUND.
+ */
+SAIL_HIDDEN sail_status_t codec_info_index_find(const struct sail_codec_info_index *index,
+                                                 const char *key,
+                                                 const struct sail_codec_info **codec_info);
+
+#endif
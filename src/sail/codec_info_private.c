@@ -107,15 +107,28 @@ struct init_data {
 
 static sail_status_t codec_priority_from_string(const char *str, enum SailCodecPriority *result) {
 
+    static const char * const CODEC_PRIORITY_NAMES[] = { "HIGHEST", "HIGH", "MEDIUM", "LOW", "LOWEST" };
+
+    enum SailCodecPriority codec_priority;
+
     switch (sail_string_hash(str)) {
-        case UINT64_C(229425771102513): *result = SAIL_CODEC_PRIORITY_HIGHEST; return SAIL_OK;
-        case UINT64_C(6384110277):      *result = SAIL_CODEC_PRIORITY_HIGH;    return SAIL_OK;
-        case UINT64_C(6952486921094):   *result = SAIL_CODEC_PRIORITY_MEDIUM;  return SAIL_OK;
-        case UINT64_C(193462455):       *result = SAIL_CODEC_PRIORITY_LOW;     return SAIL_OK;
-        case UINT64_C(6952460323299):   *result = SAIL_CODEC_PRIORITY_LOWEST;  return SAIL_OK;
+        case UINT64_C(229425771102513): codec_priority = SAIL_CODEC_PRIORITY_HIGHEST; break;
+        case UINT64_C(6384110277):      codec_priority = SAIL_CODEC_PRIORITY_HIGH;    break;
+        case UINT64_C(6952486921094):   codec_priority = SAIL_CODEC_PRIORITY_MEDIUM;  break;
+        case UINT64_C(193462455):       codec_priority = SAIL_CODEC_PRIORITY_LOW;     break;
+        case UINT64_C(6952460323299):   codec_priority = SAIL_CODEC_PRIORITY_LOWEST;  break;
 
         default: return SAIL_ERROR_UNSUPPORTED_CODEC_PRIORITY;
     }
+
+    /* Reject strings that merely collide with a priority name. */
+    if (strcmp(str, CODEC_PRIORITY_NAMES[codec_priority]) != 0) {
+        return SAIL_ERROR_UNSUPPORTED_CODEC_PRIORITY;
+    }
+
+    *result = codec_priority;
+
+    return SAIL_OK;
 }
 
 static sail_status_t inih_handler_sail_error(void *data, const char *section, const char *name, const char *value) {
@@ -324,28 +337,6 @@ static sail_status_t check_codec_info(const struct sail_codec_info *codec_info)
     return SAIL_OK;
 }
 
-static sail_status_t alloc_codec_info(struct sail_codec_info **codec_info) {
-
-    SAIL_CHECK_PTR(codec_info);
-
-    void *ptr;
-    SAIL_TRY(sail_malloc(sizeof(struct sail_codec_info), &ptr));
-    *codec_info = ptr;
-
-    (*codec_info)->path              = NULL;
-    (*codec_info)->layout            = 0;
-    (*codec_info)->version           = NULL;
-    (*codec_info)->name              = NULL;
-    (*codec_info)->description       = NULL;
-    (*codec_info)->magic_number_node = NULL;
-    (*codec_info)->extension_node    = NULL;
-    (*codec_info)->mime_type_node    = NULL;
-    (*codec_info)->load_features     = NULL;
-    (*codec_info)->save_features    = NULL;
-
-    return SAIL_OK;
-}
-
 static sail_status_t codec_read_info_from_input(const char *input, int (*ini_parser)(const char*, ini_handler, void*), struct sail_codec_info **codec_info) {
 
     struct sail_codec_info *codec_info_local;
@@ -398,6 +389,28 @@ static sail_status_t codec_read_info_from_input(const char *input, int (*ini_par
  * Public functions.
  */
 
+sail_status_t alloc_codec_info(struct sail_codec_info **codec_info) {
+
+    SAIL_CHECK_PTR(codec_info);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_codec_info), &ptr));
+    *codec_info = ptr;
+
+    (*codec_info)->path              = NULL;
+    (*codec_info)->layout            = 0;
+    (*codec_info)->version           = NULL;
+    (*codec_info)->name              = NULL;
+    (*codec_info)->description       = NULL;
+    (*codec_info)->magic_number_node = NULL;
+    (*codec_info)->extension_node    = NULL;
+    (*codec_info)->mime_type_node    = NULL;
+    (*codec_info)->load_features     = NULL;
+    (*codec_info)->save_features     = NULL;
+
+    return SAIL_OK;
+}
+
 void destroy_codec_info(struct sail_codec_info *codec_info) {
 
     if (codec_info == NULL) {
@@ -35,6 +35,13 @@ struct sail_codec_info;
  * Private codec info functions.
  */
 
+/*
+ * Allocates a new empty codec info object. Load and save features are not allocated.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t alloc_codec_info(struct sail_codec_info **codec_info);
+
 SAIL_HIDDEN void destroy_codec_info(struct sail_codec_info *codec_info);
 
 /*
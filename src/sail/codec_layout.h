@@ -33,12 +33,27 @@
  */
 #define SAIL_CODEC_LAYOUT_V8 8
 
+/*
+ * Codec functions. Codecs built with sail_codec() also export them as a single
+ * 'sail_codec_layout_v8_<codec name>' table, so libsail resolves one symbol per codec.
+ */
 struct sail_codec_layout_v8 {
     sail_codec_load_init_v8_t            load_init;
     sail_codec_load_seek_next_frame_v8_t load_seek_next_frame;
     sail_codec_load_frame_v8_t           load_frame;
     sail_codec_load_finish_v8_t          load_finish;
 
+    /* Optional. NULL unless the codec has the SEEK load feature. */
+    sail_codec_load_seek_frame_v8_t      load_seek_frame;
+
+    /* Optional. NULL unless the codec has the RESET load feature. */
+    sail_codec_load_reset_v8_t           load_reset;
+
+    /* Optional. NULL unless the codec has the PUSH load feature. */
+    sail_codec_load_push_init_v8_t            load_push_init;
+    sail_codec_load_push_seek_next_frame_v8_t load_push_seek_next_frame;
+    sail_codec_load_push_frame_v8_t           load_push_frame;
+
     sail_codec_save_init_v8_t            save_init;
     sail_codec_save_seek_next_frame_v8_t save_seek_next_frame;
     sail_codec_save_frame_v8_t           save_frame;
@@ -23,12 +23,52 @@
     SOFTWARE.
 */
 
+#include <ctype.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <sail/sail.h>
 
+/*
+ * Private functions.
+ */
+
+static bool codec_name_equal(const char *name1, const char *name2) {
+
+    for (; *name1 != '\0' && *name2 != '\0'; name1++, name2++) {
+        if (toupper((unsigned char)*name1) != toupper((unsigned char)*name2)) {
+            return false;
+        }
+    }
+
+    return *name1 == '\0' && *name2 == '\0';
+}
+
+static sail_status_t preload_codec(const struct sail_context *context, const char *name) {
+
+    SAIL_CHECK_PTR(name);
+
+    for (const struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
+        const struct sail_codec_info *codec_info = codec_bundle_node->codec_bundle->codec_info;
+
+        if (codec_name_equal(codec_info->name, name)) {
+            const struct sail_codec *codec;
+            SAIL_TRY(load_codec_by_codec_info(codec_info, &codec));
+
+            return SAIL_OK;
+        }
+    }
+
+    SAIL_LOG_ERROR("Codec '%s' is not found", name);
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
+}
+
+/*
+ * Public functions.
+ */
+
 sail_status_t sail_init(void) {
 
     SAIL_TRY(sail_init_with_flags(0));
@@ -44,6 +84,35 @@ sail_status_t sail_init_with_flags(int flags) {
     return SAIL_OK;
 }
 
+sail_status_t sail_preload_codecs(const char * const names[], size_t names_length, uint64_t *load_times) {
+
+    SAIL_CHECK_PTR(names);
+
+    struct sail_context *context;
+    SAIL_TRY(fetch_global_context_guarded(&context));
+
+    sail_status_t status = SAIL_OK;
+
+    for (size_t i = 0; i < names_length; i++) {
+        const uint64_t start_time = sail_now();
+        const sail_status_t codec_status = preload_codec(context, names[i]);
+        const uint64_t load_time = sail_now() - start_time;
+
+        if (codec_status == SAIL_OK) {
+            SAIL_LOG_DEBUG("Preloaded codec '%s' in %lu ms", names[i], (unsigned long)load_time);
+        } else if (status == SAIL_OK) {
+            /* Try to preload the rest of the codecs anyway. */
+            status = codec_status;
+        }
+
+        if (load_times != NULL) {
+            load_times[i] = (codec_status == SAIL_OK) ? load_time : 0;
+        }
+    }
+
+    return status;
+}
+
 sail_status_t sail_unload_codecs(void) {
 
     SAIL_TRY(sail_unload_codecs_private());
@@ -54,4 +123,19 @@ sail_status_t sail_unload_codecs(void) {
 void sail_finish(void) {
 
     destroy_global_context();
+    sail_finish_thread_pool();
+}
+
+sail_status_t sail_alloc_context(int flags, struct sail_context **context) {
+
+    SAIL_CHECK_PTR(context);
+
+    SAIL_TRY(alloc_explicit_context(flags, context));
+
+    return SAIL_OK;
+}
+
+void sail_destroy_context(struct sail_context *context) {
+
+    destroy_explicit_context(context);
 }
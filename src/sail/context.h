@@ -26,6 +26,9 @@
 #ifndef SAIL_CONTEXT_H
 #define SAIL_CONTEXT_H
 
+#include <stddef.h> /* size_t */
+#include <stdint.h>
+
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
@@ -42,9 +45,15 @@ extern "C" {
  * All SAIL loading, saving, and probing functions will re-use it then.
  *
  * SAIL context modification (creating, destroying, loading and unloading codecs) is guarded with a mutex
- * to avoid unpredictable errors in a multi-threaded environment.
+ * to avoid unpredictable errors in a multi-threaded environment. Once initialized, the context is immutable,
+ * so reading it and fetching already loaded codecs take no locks.
+ *
+ * Applications that need isolated sets of codecs can allocate explicit contexts with sail_alloc_context()
+ * and use them with the *_in_context() functions.
  */
 
+struct sail_context;
+
 /*
  * Flags to control SAIL initialization behavior.
  */
@@ -104,10 +113,32 @@ SAIL_EXPORT sail_status_t sail_init(void);
  * is searched if SAIL_THIRD_PARTY_CODECS_PATH is enabled in CMake (the default), so you can load
  * your own codecs from there.
  *
+ * If SAIL_CODECS_CACHE_FILE environment variable is set, the codec info objects enumerated
+ * in the codecs paths above are cached in the specified file, and subsequent initializations
+ * read the cache instead of parsing the codec info files. The cache is invalidated when
+ * the modification time of any codecs path changes, i.e. when codecs are installed or removed.
+ * Delete the cache file manually if you edit codec info files in place.
+ *
  * Returns SAIL_OK on success.
  */
 SAIL_EXPORT sail_status_t sail_init_with_flags(int flags);
 
+/*
+ * Loads the codecs with the specified names like "JPEG" or "PNG" into the global static context,
+ * so the first loading or saving operation of these formats doesn't pay for loading them from disk.
+ * The global static context is initialized if it doesn't exist yet. Names are case-insensitive.
+ * Already loaded codecs are skipped. When SAIL is compiled with SAIL_COMBINE_CODECS enabled,
+ * only third-party codecs are actually loaded from disk.
+ *
+ * If 'load_times' is not NULL, it must point to an array of 'names_length' elements. It's filled
+ * with the number of milliseconds spent on loading every codec, or 0 if the codec failed to load.
+ *
+ * All the specified codecs are tried even if some of them fail to load.
+ *
+ * Returns SAIL_OK on success or the error code of the first codec that failed to load.
+ */
+SAIL_EXPORT sail_status_t sail_preload_codecs(const char * const names[], size_t names_length, uint64_t *load_times);
+
 /*
  * Unloads all the loaded codecs from the global static context to release memory occupied by them.
  * Use this function if you want to release some memory but do not want to deinitialize SAIL
@@ -128,7 +159,8 @@ SAIL_EXPORT sail_status_t sail_unload_codecs(void);
  * loading or saving functions.
  *
  * Unloads all codecs. All pointers to codec info objects, load and save features, and codecs
- * get invalidated. Using them after calling sail_finish() may lead to a crash.
+ * get invalidated. Using them after calling sail_finish() may lead to a crash. Stops the thread
+ * pool threads with sail_finish_thread_pool().
  *
  * It's possible to initialize a new global static context afterwards, implicitly or explicitly.
  *
@@ -139,6 +171,35 @@ SAIL_EXPORT sail_status_t sail_unload_codecs(void);
  */
 SAIL_EXPORT void sail_finish(void);
 
+/*
+ * Allocates and initializes a new explicit context independent of the global static context.
+ * See sail_init_with_flags() for the flags and the codecs path search algorithm.
+ *
+ * An explicit context owns its own list of codec info objects and loaded codecs. Loading a codec into
+ * one context never blocks or affects other contexts, so threads or worker pools using their own contexts
+ * don't share any locks after initialization. Codec info objects are bound to the context they were found in.
+ * Use them only with the functions accepting the same context, for example
+ * sail_codec_info_from_path_in_context() and sail_start_loading_from_io_in_context().
+ *
+ * Typical usage: sail_alloc_context()                    ->
+ *                sail_codec_info_from_path_in_context()  ->
+ *                sail_start_loading_from_io_in_context() ->
+ *                sail_load_next_frame()                  ->
+ *                sail_stop_loading()                     ->
+ *                sail_destroy_context().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_context(int flags, struct sail_context **context);
+
+/*
+ * Destroys the specified explicit context and unloads its codecs. All pointers to its codec info objects
+ * and codecs get invalidated. Does nothing if the context is NULL.
+ *
+ * Warning: Make sure no loading or saving operations with this context are in progress.
+ */
+SAIL_EXPORT void sail_destroy_context(struct sail_context *context);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
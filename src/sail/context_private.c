@@ -44,6 +44,12 @@
 
 static struct sail_context *global_context = NULL;
 
+/*
+ * The global context published with release semantics after it's been fully initialized.
+ * Readers that find it non-NULL don't need to lock anything as the context is immutable from now on.
+ */
+static struct sail_context *initialized_global_context = NULL;
+
 #ifdef SAIL_THREAD_SAFE
 static sail_mutex_t global_context_guard_mutex;
 
@@ -191,8 +197,16 @@ static sail_status_t alloc_context(struct sail_context **context) {
     SAIL_TRY(sail_malloc(sizeof(struct sail_context), &ptr));
     *context = ptr;
 
-    (*context)->initialized     = false;
-    (*context)->codec_bundle_node = NULL;
+    (*context)->initialized          = false;
+    (*context)->codec_bundle_node    = NULL;
+    (*context)->magic_number_matcher = NULL;
+    (*context)->extension_index      = NULL;
+    (*context)->mime_type_index      = NULL;
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY_OR_CLEANUP(threading_init_mutex(&(*context)->codecs_mutex),
+                        /* cleanup */ sail_free(*context));
+#endif
 
     return SAIL_OK;
 }
@@ -217,32 +231,49 @@ static sail_status_t destroy_context(struct sail_context *context) {
         return SAIL_OK;
     }
 
+    destroy_magic_number_matcher(context->magic_number_matcher);
+    destroy_codec_info_index(context->extension_index);
+    destroy_codec_info_index(context->mime_type_index);
     destroy_codec_bundle_node_chain(context->codec_bundle_node);
+
+#ifdef SAIL_THREAD_SAFE
+    threading_destroy_mutex(&context->codecs_mutex);
+#endif
+
     sail_free(context);
 
     return SAIL_OK;
 }
 
+/* Must be called with the context locked before the context is published. */
 static sail_status_t preload_codecs(struct sail_context *context) {
 
     SAIL_CHECK_PTR(context);
 
-    SAIL_TRY(lock_context());
-
     SAIL_LOG_DEBUG("Preloading codecs");
 
     for (struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
-        const struct sail_codec *codec;
+        struct sail_codec_bundle *codec_bundle = codec_bundle_node->codec_bundle;
 
-        /* Ignore loading errors on purpose. */
-        (void)load_codec_by_codec_info(codec_bundle_node->codec_bundle->codec_info, &codec);
+        if (codec_bundle->codec == NULL) {
+            /* Ignore loading errors on purpose. */
+            (void)alloc_and_load_codec(codec_bundle->codec_info, &codec_bundle->codec);
+        }
     }
 
-    SAIL_TRY(unlock_context());
-
     return SAIL_OK;
 }
 
+static const struct sail_string_node* codec_info_extensions(const struct sail_codec_info *codec_info) {
+
+    return codec_info->extension_node;
+}
+
+static const struct sail_string_node* codec_info_mime_types(const struct sail_codec_info *codec_info) {
+
+    return codec_info->mime_type_node;
+}
+
 static int codec_bundle_priority_comparator(const void *elem1, const void *elem2) {
 
     const int priority1 = (*(struct sail_codec_bundle_node **)elem1)->codec_bundle->codec_info->priority;
@@ -310,7 +341,7 @@ static sail_status_t print_enumerated_codecs(struct sail_context *context) {
 
     const struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node;
 
-    if (codec_bundle_node == NULL) {
+    if (codec_bundle_node == NULL || !sail_log_is_enabled(SAIL_LOG_LEVEL_DEBUG)) {
         return SAIL_OK;
     }
 
@@ -435,7 +466,22 @@ static sail_status_t build_codec_bundle_from_codec_info_path(const char *codec_i
                         /* cleanup */ destroy_codec_bundle_node(local_codec_bundle_node),
                                       sail_free(codec_full_path));
 
-    SAIL_TRY_OR_CLEANUP(codec_read_info_from_file(codec_info_full_path, &local_codec_bundle_node->codec_bundle->codec_info),
+    const bool traced = sail_is_tracing_enabled();
+    struct sail_trace_attributes attributes = { NULL, 0, 0, SAIL_PIXEL_FORMAT_UNKNOWN };
+    void *span = NULL;
+
+    if (traced) {
+        span = sail_begin_trace_span("parse_codec_info", &attributes);
+    }
+
+    const sail_status_t status = codec_read_info_from_file(codec_info_full_path, &local_codec_bundle_node->codec_bundle->codec_info);
+
+    if (traced) {
+        attributes.codec = (status == SAIL_OK) ? local_codec_bundle_node->codec_bundle->codec_info->name : NULL;
+        sail_end_trace_span(span, &attributes, status);
+    }
+
+    SAIL_TRY_OR_CLEANUP(status,
                         destroy_codec_bundle_node(local_codec_bundle_node),
                         sail_free(codec_full_path));
     local_codec_bundle_node->codec_bundle->codec_info->path = codec_full_path;
@@ -446,19 +492,39 @@ static sail_status_t build_codec_bundle_from_codec_info_path(const char *codec_i
     return SAIL_OK;
 }
 
-static sail_status_t enumerate_codecs_in_paths(struct sail_context *context, const struct sail_string_node *string_node) {
+static const char* codecs_cache_file_env(void) {
 
-    SAIL_CHECK_PTR(context);
+    static SAIL_THREAD_LOCAL bool codecs_cache_file_env_called = false;
+    static SAIL_THREAD_LOCAL const char *env = NULL;
+
+    if (codecs_cache_file_env_called) {
+        return env;
+    }
+
+    codecs_cache_file_env_called = true;
+
+#ifdef _MSC_VER
+    _dupenv_s((char **)&env, NULL, "SAIL_CODECS_CACHE_FILE");
+#else
+    env = getenv("SAIL_CODECS_CACHE_FILE");
+#endif
+
+    if (env != NULL) {
+        SAIL_LOG_DEBUG("SAIL_CODECS_CACHE_FILE environment variable is set. Caching codec infos in '%s'", env);
+    }
+
+    return env;
+}
+
+/* Appends the parsed codec info objects to the specified codec bundle node. */
+static sail_status_t enumerate_codec_infos_in_paths(const struct sail_string_node *string_node,
+                                                    struct sail_codec_bundle_node **last_codec_bundle_node) {
 
-    /* Used to load and store codec info objects. */
-    struct sail_codec_bundle_node **last_codec_bundle_node = &context->codec_bundle_node;
     struct sail_codec_bundle_node *codec_bundle_node;
 
     for (; string_node != NULL; string_node = string_node->next) {
         const char *codecs_path = string_node->string;
 
-        SAIL_TRY(add_lib_subdir_to_dll_search_path(codecs_path));
-
         SAIL_LOG_DEBUG("Enumerating codecs in '%s'", codecs_path);
 
 #ifdef SAIL_WIN32
@@ -552,6 +618,38 @@ static sail_status_t enumerate_codecs_in_paths(struct sail_context *context, con
 
     return SAIL_OK;
 }
+
+static sail_status_t enumerate_codecs_in_paths(struct sail_context *context, const struct sail_string_node *string_node) {
+
+    SAIL_CHECK_PTR(context);
+
+    for (const struct sail_string_node *node = string_node; node != NULL; node = node->next) {
+        SAIL_TRY(add_lib_subdir_to_dll_search_path(node->string));
+    }
+
+    /* Append to the already registered codecs like the combined ones. */
+    struct sail_codec_bundle_node **last_codec_bundle_node = &context->codec_bundle_node;
+
+    while (*last_codec_bundle_node != NULL) {
+        last_codec_bundle_node = &(*last_codec_bundle_node)->next;
+    }
+
+    const char *cache_path = codecs_cache_file_env();
+
+    if (cache_path != NULL && codec_info_cache_load(cache_path, string_node, last_codec_bundle_node) == SAIL_OK) {
+        SAIL_LOG_DEBUG("Loaded codec infos from the cache '%s'", cache_path);
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(enumerate_codec_infos_in_paths(string_node, last_codec_bundle_node));
+
+    /* The cache is optional, so ignore errors. */
+    if (cache_path != NULL) {
+        SAIL_TRY_OR_SUPPRESS(codec_info_cache_save(cache_path, string_node, *last_codec_bundle_node));
+    }
+
+    return SAIL_OK;
+}
 #endif
 
 /* Initializes the context and loads all the codec info files. */
@@ -564,19 +662,18 @@ static sail_status_t init_context_impl(struct sail_context *context) {
 #ifdef SAIL_STATIC
     /* For example: [ "gif", "jpeg", "png" ]. */
     extern const char * const sail_enabled_codecs[];
-    extern const char * const sail_enabled_codecs_info[];
+    extern struct sail_codec_info * const sail_enabled_codecs_info[];
+    extern struct sail_codec_layout_v8 const sail_enabled_codecs_layouts[];
 #else
     SAIL_IMPORT extern const char * const sail_enabled_codecs[];
-    SAIL_IMPORT extern const char * const sail_enabled_codecs_info[];
+    SAIL_IMPORT extern struct sail_codec_info * const sail_enabled_codecs_info[];
+    SAIL_IMPORT extern struct sail_codec_layout_v8 const sail_enabled_codecs_layouts[];
 #endif
 
     /* Load codec info objects. */
     struct sail_codec_bundle_node **last_codec_bundle_node = &context->codec_bundle_node;
 
     for (size_t i = 0; sail_enabled_codecs[i] != NULL; i++) {
-        const char *sail_codec_info = sail_enabled_codecs_info[i];
-
-        /* Parse codec info. */
         struct sail_codec_bundle_node *codec_bundle_node;
         SAIL_TRY_OR_EXECUTE(alloc_codec_bundle_node(&codec_bundle_node),
                             /* on error */ continue);
@@ -585,7 +682,23 @@ static sail_status_t init_context_impl(struct sail_context *context) {
                             /* on error */ destroy_codec_bundle_node(codec_bundle_node);
                                            continue);
 
-        SAIL_TRY_OR_EXECUTE(codec_read_info_from_string(sail_codec_info, &codec_bundle_node->codec_bundle->codec_info),
+        /*
+         * Built-in codec infos are constant data generated at build time, so nothing is parsed.
+         * Codec infos are bound to their contexts, so explicit contexts get shallow copies.
+         */
+        if (context == global_context) {
+            codec_bundle_node->codec_bundle->codec_info = sail_enabled_codecs_info[i];
+        } else {
+            void *ptr;
+            SAIL_TRY_OR_EXECUTE(sail_malloc(sizeof(struct sail_codec_info), &ptr),
+                                /* on error */ destroy_codec_bundle_node(codec_bundle_node);
+                                               continue);
+            memcpy(ptr, sail_enabled_codecs_info[i], sizeof(struct sail_codec_info));
+            codec_bundle_node->codec_bundle->codec_info = ptr;
+        }
+
+        /* The functions are known by the same index, so attach them now instead of searching by name later. */
+        SAIL_TRY_OR_EXECUTE(alloc_combined_codec(&sail_enabled_codecs_layouts[i], &codec_bundle_node->codec_bundle->codec),
                             /* on error */ destroy_codec_bundle_node(codec_bundle_node);
                                            continue);
 
@@ -740,16 +853,25 @@ static void print_build_statistics(void) {
 #endif
 }
 
-/* Initializes the context and loads all the codec info files if the context is not initialized. */
-static sail_status_t init_context(struct sail_context *context, int flags) {
-
-    SAIL_CHECK_PTR(context);
+/* Runs the context initialization stage within a tracing span. */
+static sail_status_t run_traced(const char *span_name, sail_status_t (*stage)(struct sail_context *context),
+                                struct sail_context *context) {
 
-    if (context->initialized) {
-        return SAIL_OK;
+    if (!sail_is_tracing_enabled()) {
+        return stage(context);
     }
 
-    context->initialized = true;
+    const struct sail_trace_attributes attributes = { NULL, 0, 0, SAIL_PIXEL_FORMAT_UNKNOWN };
+    void *span = sail_begin_trace_span(span_name, &attributes);
+
+    const sail_status_t status = stage(context);
+
+    sail_end_trace_span(span, &attributes, status);
+
+    return status;
+}
+
+static sail_status_t init_context_stages(struct sail_context *context, int flags) {
 
     /* Time counter. */
     uint64_t start_time = sail_now();
@@ -764,7 +886,7 @@ static sail_status_t init_context(struct sail_context *context, int flags) {
     }
 #endif
 
-    SAIL_TRY(init_context_impl(context));
+    SAIL_TRY(run_traced("enumerate_codecs", init_context_impl, context));
 
     if (context->codec_bundle_node == NULL) {
         print_no_codecs_found();
@@ -774,8 +896,15 @@ static sail_status_t init_context(struct sail_context *context, int flags) {
 
     SAIL_TRY(print_enumerated_codecs(context));
 
+    /* Compile magic numbers once, so detecting image formats doesn't parse them again and again. */
+    SAIL_TRY(alloc_magic_number_matcher(context->codec_bundle_node, &context->magic_number_matcher));
+
+    /* The same for extensions and MIME types. */
+    SAIL_TRY(alloc_codec_info_index(context->codec_bundle_node, codec_info_extensions, &context->extension_index));
+    SAIL_TRY(alloc_codec_info_index(context->codec_bundle_node, codec_info_mime_types, &context->mime_type_index));
+
     if (flags & SAIL_FLAG_PRELOAD_CODECS) {
-        SAIL_TRY(preload_codecs(context));
+        SAIL_TRY(run_traced("preload_codecs", preload_codecs, context));
     }
 
     SAIL_LOG_DEBUG("Initialized in %lu ms.", (unsigned long)(sail_now() - start_time));
@@ -783,6 +912,31 @@ static sail_status_t init_context(struct sail_context *context, int flags) {
     return SAIL_OK;
 }
 
+/* Initializes the context and loads all the codec info files if the context is not initialized. */
+static sail_status_t init_context(struct sail_context *context, int flags) {
+
+    SAIL_CHECK_PTR(context);
+
+    if (context->initialized) {
+        return SAIL_OK;
+    }
+
+    context->initialized = true;
+
+    if (!sail_is_tracing_enabled()) {
+        return init_context_stages(context, flags);
+    }
+
+    const struct sail_trace_attributes attributes = { NULL, 0, 0, SAIL_PIXEL_FORMAT_UNKNOWN };
+    void *span = sail_begin_trace_span("init_context", &attributes);
+
+    const sail_status_t status = init_context_stages(context, flags);
+
+    sail_end_trace_span(span, &attributes, status);
+
+    return status;
+}
+
 /*
  * Public functions.
  */
@@ -792,6 +946,7 @@ sail_status_t destroy_global_context(void) {
     SAIL_TRY(lock_context());
 
     SAIL_LOG_DEBUG("Destroyed context %p", global_context);
+    SAIL_ATOMIC_STORE_PTR_RELEASE(&initialized_global_context, (struct sail_context *)NULL);
     destroy_context(global_context);
     global_context = NULL;
 
@@ -818,6 +973,14 @@ sail_status_t fetch_global_context_guarded_with_flags(struct sail_context **cont
 
     SAIL_CHECK_PTR(context);
 
+    /* Fast path: the context is already initialized. Flags are only meaningful during initialization. */
+    struct sail_context *initialized_context = SAIL_ATOMIC_LOAD_PTR_ACQUIRE(&initialized_global_context);
+
+    if (SAIL_LIKELY(initialized_context != NULL)) {
+        *context = initialized_context;
+        return SAIL_OK;
+    }
+
     SAIL_TRY(lock_context());
 
     SAIL_TRY_OR_CLEANUP(fetch_global_context_unsafe_with_flags(context, flags),
@@ -837,6 +1000,11 @@ sail_status_t fetch_global_context_unsafe_with_flags(struct sail_context **conte
     SAIL_TRY(allocate_global_context(&local_context));
     SAIL_TRY(init_context(local_context, flags));
 
+    /* Publish the context for lock-free readers. */
+    if (initialized_global_context == NULL) {
+        SAIL_ATOMIC_STORE_PTR_RELEASE(&initialized_global_context, local_context);
+    }
+
     *context = local_context;
 
     return SAIL_OK;
@@ -856,18 +1024,25 @@ sail_status_t sail_unload_codecs_private(void) {
     SAIL_TRY_OR_CLEANUP(fetch_global_context_unsafe(&context),
                 /* cleanup */ unlock_context());
 
+    SAIL_TRY_OR_CLEANUP(lock_context_codecs(context),
+                        /* cleanup */ unlock_context());
+
     int counter = 0;
 
     for (struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
         struct sail_codec_bundle *codec_bundle = codec_bundle_node->codec_bundle;
 
-        if (codec_bundle->codec != NULL) {
-            destroy_codec(codec_bundle->codec);
-            codec_bundle->codec = NULL;
+        struct sail_codec *codec = codec_bundle->codec;
+
+        if (codec != NULL) {
+            SAIL_ATOMIC_STORE_PTR_RELEASE(&codec_bundle->codec, (struct sail_codec *)NULL);
+            destroy_codec(codec);
             counter++;
         }
     }
 
+    SAIL_TRY_OR_CLEANUP(unlock_context_codecs(context),
+                        /* cleanup */ unlock_context());
     SAIL_TRY(unlock_context());
 
     SAIL_LOG_DEBUG("Unloaded codecs number: %d", counter);
@@ -894,3 +1069,63 @@ sail_status_t unlock_context(void) {
 
     return SAIL_OK;
 }
+
+sail_status_t alloc_explicit_context(int flags, struct sail_context **context) {
+
+    SAIL_CHECK_PTR(context);
+
+    struct sail_context *context_local;
+    SAIL_TRY(alloc_context(&context_local));
+
+    /*
+     * Initialization updates process-wide state like the DLL search path,
+     * so explicit contexts are still initialized one at a time.
+     */
+    SAIL_TRY_OR_CLEANUP(lock_context(),
+                        /* cleanup */ destroy_context(context_local));
+
+    SAIL_TRY_OR_CLEANUP(init_context(context_local, flags),
+                        /* cleanup */ unlock_context(),
+                                      destroy_context(context_local));
+
+    SAIL_TRY_OR_CLEANUP(unlock_context(),
+                        /* cleanup */ destroy_context(context_local));
+
+    SAIL_LOG_DEBUG("Allocated new explicit context %p", context_local);
+
+    *context = context_local;
+
+    return SAIL_OK;
+}
+
+void destroy_explicit_context(struct sail_context *context) {
+
+    if (context == NULL) {
+        return;
+    }
+
+    SAIL_LOG_DEBUG("Destroyed explicit context %p", context);
+    destroy_context(context);
+}
+
+sail_status_t lock_context_codecs(struct sail_context *context) {
+
+    SAIL_CHECK_PTR(context);
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY(threading_lock_mutex(&context->codecs_mutex));
+#endif
+
+    return SAIL_OK;
+}
+
+sail_status_t unlock_context_codecs(struct sail_context *context) {
+
+    SAIL_CHECK_PTR(context);
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY(threading_unlock_mutex(&context->codecs_mutex));
+#endif
+
+    return SAIL_OK;
+}
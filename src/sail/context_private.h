@@ -28,10 +28,17 @@
 
 #include <stdbool.h>
 
+#include <sail-common/config.h>
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
+#ifdef SAIL_THREAD_SAFE
+    #include <sail/threading.h>
+#endif
+
 struct sail_codec_bundle_node;
+struct sail_codec_info_index;
+struct sail_magic_number_matcher;
 
 /*
  * Context is a main entry point to start working with SAIL. It enumerates codec info objects which could be
@@ -44,12 +51,34 @@ struct sail_context {
 
     /* Linked list of found codec info objects. */
     struct sail_codec_bundle_node *codec_bundle_node;
+
+    /* Magic numbers of the found codecs compiled for fast matching. */
+    struct sail_magic_number_matcher *magic_number_matcher;
+
+    /* Lower-case file extensions and MIME types of the found codecs. */
+    struct sail_codec_info_index *extension_index;
+    struct sail_codec_info_index *mime_type_index;
+
+#ifdef SAIL_THREAD_SAFE
+    /* Guards lazy loading and unloading of the codecs of this context only. */
+    sail_mutex_t codecs_mutex;
+#endif
 };
 
 typedef struct sail_context sail_context_t;
 
+#ifndef SAIL_THREAD_SAFE
+    /* No other threads to synchronize with. See threading.h for the thread-safe versions. */
+    #define SAIL_ATOMIC_LOAD_PTR_ACQUIRE(ptr)         (*(ptr))
+    #define SAIL_ATOMIC_STORE_PTR_RELEASE(ptr, value) (void)(*(ptr) = (value))
+#endif
+
 SAIL_HIDDEN sail_status_t destroy_global_context(void);
 
+/*
+ * Returns the global context initializing it if necessary. Once the context is initialized, it's immutable
+ * and this function takes no locks.
+ */
 SAIL_HIDDEN sail_status_t fetch_global_context_guarded(struct sail_context **context);
 
 SAIL_HIDDEN sail_status_t fetch_global_context_unsafe(struct sail_context **context);
@@ -64,4 +93,18 @@ SAIL_HIDDEN sail_status_t lock_context(void);
 
 SAIL_HIDDEN sail_status_t unlock_context(void);
 
+/*
+ * Allocates and initializes a new context independent of the global context.
+ */
+SAIL_HIDDEN sail_status_t alloc_explicit_context(int flags, struct sail_context **context);
+
+SAIL_HIDDEN void destroy_explicit_context(struct sail_context *context);
+
+/*
+ * Locks the specified context to load or unload its codecs. Other contexts are not affected.
+ */
+SAIL_HIDDEN sail_status_t lock_context_codecs(struct sail_context *context);
+
+SAIL_HIDDEN sail_status_t unlock_context_codecs(struct sail_context *context);
+
 #endif
@@ -0,0 +1,152 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#define EXIF_COMPRESSION_TAG                 0x0103
+#define EXIF_JPEG_INTERCHANGE_FORMAT_TAG     0x0201
+#define EXIF_JPEG_INTERCHANGE_FORMAT_LEN_TAG 0x0202
+
+/* Old-style JPEG compression of the thumbnail. */
+#define EXIF_COMPRESSION_JPEG 6
+
+/*
+ * Private functions.
+ */
+
+static uint16_t read_uint16(const unsigned char *data, bool big_endian) {
+
+    return big_endian ? (uint16_t)((data[0] << 8) | data[1]) : (uint16_t)((data[1] << 8) | data[0]);
+}
+
+static uint32_t read_uint32(const unsigned char *data, bool big_endian) {
+
+    return big_endian
+        ? ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3]
+        : ((uint32_t)data[3] << 24) | ((uint32_t)data[2] << 16) | ((uint32_t)data[1] << 8) | data[0];
+}
+
+/* Reads a SHORT or LONG value stored in place in the IFD entry. */
+static bool read_entry_value(const unsigned char *entry, bool big_endian, uint32_t *value) {
+
+    switch (read_uint16(entry + 2, big_endian)) {
+        case 3: *value = read_uint16(entry + 8, big_endian); return true; /* SHORT */
+        case 4: *value = read_uint32(entry + 8, big_endian); return true; /* LONG */
+
+        default: return false;
+    }
+}
+
+/*
+ * Public functions.
+ */
+
+bool exif_thumbnail(const void *data, size_t data_size, const void **thumbnail, size_t *thumbnail_size) {
+
+    const unsigned char *tiff = data;
+    size_t tiff_size = data_size;
+
+    if (tiff_size >= 6 && memcmp(tiff, "Exif\0\0", 6) == 0) {
+        tiff      += 6;
+        tiff_size -= 6;
+    }
+
+    if (tiff_size < 8) {
+        return false;
+    }
+
+    bool big_endian;
+
+    if (memcmp(tiff, "MM", 2) == 0) {
+        big_endian = true;
+    } else if (memcmp(tiff, "II", 2) == 0) {
+        big_endian = false;
+    } else {
+        return false;
+    }
+
+    if (read_uint16(tiff + 2, big_endian) != 42) {
+        return false;
+    }
+
+    /* Skip IFD0 to the next IFD. */
+    uint32_t ifd = read_uint32(tiff + 4, big_endian);
+
+    if (ifd > tiff_size - 2) {
+        return false;
+    }
+
+    const size_t ifd0_entries = read_uint16(tiff + ifd, big_endian);
+
+    if (ifd + 2 + ifd0_entries * 12 + 4 > tiff_size) {
+        return false;
+    }
+
+    ifd = read_uint32(tiff + ifd + 2 + ifd0_entries * 12, big_endian);
+
+    if (ifd == 0 || ifd > tiff_size - 2) {
+        return false;
+    }
+
+    /* IFD1 describes the thumbnail. */
+    const size_t ifd1_entries = read_uint16(tiff + ifd, big_endian);
+
+    uint32_t compression = EXIF_COMPRESSION_JPEG;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+
+    for (size_t i = 0; i < ifd1_entries; i++) {
+        const size_t entry = ifd + 2 + i * 12;
+
+        if (entry + 12 > tiff_size) {
+            break;
+        }
+
+        uint32_t value;
+
+        if (!read_entry_value(tiff + entry, big_endian, &value)) {
+            continue;
+        }
+
+        switch (read_uint16(tiff + entry, big_endian)) {
+            case EXIF_COMPRESSION_TAG:                 compression = value; break;
+            case EXIF_JPEG_INTERCHANGE_FORMAT_TAG:     offset      = value; break;
+            case EXIF_JPEG_INTERCHANGE_FORMAT_LEN_TAG: length      = value; break;
+        }
+    }
+
+    /* Uncompressed TIFF thumbnails are rare, and they're not supported. */
+    if (compression != EXIF_COMPRESSION_JPEG || offset == 0 || length == 0 || offset > tiff_size || length > tiff_size - offset) {
+        return false;
+    }
+
+    *thumbnail      = tiff + offset;
+    *thumbnail_size = length;
+
+    return true;
+}
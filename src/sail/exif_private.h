@@ -0,0 +1,42 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_EXIF_PRIVATE_H
+#define SAIL_EXIF_PRIVATE_H
+
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
+
+#include <sail-common/export.h>
+
+/*
+ * Finds the JPEG thumbnail in the second IFD (IFD1) of the EXIF data. The data may or may not
+ * start with "Exif\0\0". The thumbnail is a pointer into the EXIF data.
+ *
+ * Returns true if the thumbnail is found.
+ */
+SAIL_HIDDEN bool exif_thumbnail(const void *data, size_t data_size, const void **thumbnail, size_t *thumbnail_size);
+
+#endif
@@ -0,0 +1,515 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+enum {
+    /* Number of buckets in the tables of entries. */
+    IMAGE_CACHE_BUCKETS = 256
+};
+
+/* Parameters of a decoded image. Two loads with equal keys produce equal images. */
+struct image_cache_key {
+    uint64_t data_hash;
+    size_t data_size;
+
+    /* No load options were specified, so the codec defaults were used. */
+    bool default_options;
+    int options;
+    uint64_t meta_data_keys;
+    unsigned row_alignment;
+    unsigned pixels_alignment;
+    struct sail_roi roi;
+    unsigned scale_denominator;
+    enum SailPixelFormat output_pixel_format;
+    struct sail_load_limits limits;
+    uint64_t tuning_hash;
+};
+
+struct image_cache_entry {
+    struct image_cache_key key;
+    struct sail_image *image;
+    size_t bytes;
+
+    /* Number of callers that acquired the image. */
+    unsigned references;
+    /* The entry is in the key table and in the LRU list. Otherwise, it's freed with the last reference. */
+    bool cached;
+
+    /* Chain of the key table. */
+    struct image_cache_entry *key_next;
+    /* Chain of the image table used to find the entries being released. */
+    struct image_cache_entry *image_next;
+    /* LRU list, the most recently used entries go first. */
+    struct image_cache_entry *lru_prev;
+    struct image_cache_entry *lru_next;
+};
+
+struct sail_image_cache {
+    size_t max_bytes;
+    /* Total size of the cached entries. */
+    size_t bytes;
+
+    struct image_cache_entry *key_buckets[IMAGE_CACHE_BUCKETS];
+    struct image_cache_entry *image_buckets[IMAGE_CACHE_BUCKETS];
+    struct image_cache_entry *lru_head;
+    struct image_cache_entry *lru_tail;
+
+#ifdef SAIL_THREAD_SAFE
+    /* Guards all the fields above. Images are loaded without locking. */
+    sail_mutex_t mutex;
+#endif
+};
+
+/*
+ * Private functions.
+ */
+
+static void lock_image_cache(struct sail_image_cache *image_cache) {
+
+#ifdef SAIL_THREAD_SAFE
+    (void)threading_lock_mutex(&image_cache->mutex);
+#else
+    (void)image_cache;
+#endif
+}
+
+static void unlock_image_cache(struct sail_image_cache *image_cache) {
+
+#ifdef SAIL_THREAD_SAFE
+    (void)threading_unlock_mutex(&image_cache->mutex);
+#else
+    (void)image_cache;
+#endif
+}
+
+/* Sums the hashes of the tuning options, so their order doesn't matter. */
+static bool hash_tuning_option(const char *key, const struct sail_variant *value, void *user_data) {
+
+    uint64_t *tuning_hash = user_data;
+
+    const uint64_t value_hash = sail_data_hash(value->value, value->size) ^ (uint64_t)value->type;
+
+    *tuning_hash += sail_data_hash(key, strlen(key)) * 31 + value_hash;
+
+    return true;
+}
+
+static void build_key(const void *buffer, size_t buffer_size, const struct sail_load_options *load_options,
+                      struct image_cache_key *key) {
+
+    memset(key, 0, sizeof(*key));
+
+    key->data_hash = sail_data_hash(buffer, buffer_size);
+    key->data_size = buffer_size;
+
+    if (load_options == NULL) {
+        key->default_options = true;
+        return;
+    }
+
+    key->options             = load_options->options;
+    key->meta_data_keys      = load_options->meta_data_keys;
+    key->row_alignment       = load_options->row_alignment;
+    key->pixels_alignment    = load_options->pixels_alignment;
+    key->roi                 = load_options->roi;
+    key->scale_denominator   = load_options->scale_denominator;
+    key->output_pixel_format = load_options->output_pixel_format;
+    key->limits              = load_options->limits;
+
+    if (load_options->tuning != NULL) {
+        sail_traverse_hash_map_with_user_data(load_options->tuning, hash_tuning_option, &key->tuning_hash);
+    }
+}
+
+static bool keys_equal(const struct image_cache_key *key1, const struct image_cache_key *key2) {
+
+    return key1->data_hash                  == key2->data_hash                  &&
+           key1->data_size                  == key2->data_size                  &&
+           key1->default_options            == key2->default_options            &&
+           key1->options                    == key2->options                    &&
+           key1->meta_data_keys             == key2->meta_data_keys             &&
+           key1->row_alignment              == key2->row_alignment              &&
+           key1->pixels_alignment           == key2->pixels_alignment           &&
+           key1->roi.x                      == key2->roi.x                      &&
+           key1->roi.y                      == key2->roi.y                      &&
+           key1->roi.width                  == key2->roi.width                  &&
+           key1->roi.height                 == key2->roi.height                 &&
+           key1->scale_denominator          == key2->scale_denominator          &&
+           key1->output_pixel_format        == key2->output_pixel_format        &&
+           key1->limits.max_pixels          == key2->limits.max_pixels          &&
+           key1->limits.max_bytes           == key2->limits.max_bytes           &&
+           key1->limits.max_frames          == key2->limits.max_frames          &&
+           key1->limits.max_meta_data_bytes == key2->limits.max_meta_data_bytes &&
+           key1->tuning_hash                == key2->tuning_hash;
+}
+
+static inline size_t key_bucket(const struct image_cache_key *key) {
+
+    return (size_t)(key->data_hash % IMAGE_CACHE_BUCKETS);
+}
+
+static inline size_t image_bucket(const struct sail_image *image) {
+
+    /* Allocations are aligned, so skip the low bits. */
+    return (size_t)(((uintptr_t)image >> 4) % IMAGE_CACHE_BUCKETS);
+}
+
+static size_t image_bytes(const struct sail_image *image) {
+
+    size_t bytes = (size_t)image->bytes_per_line * image->height;
+
+    if (image->palette != NULL) {
+        bytes += sail_bytes_per_line(image->palette->color_count, image->palette->pixel_format);
+    }
+
+    if (image->iccp != NULL) {
+        bytes += image->iccp->size;
+    }
+
+    return bytes;
+}
+
+static void destroy_entry(struct image_cache_entry *entry) {
+
+    sail_destroy_image(entry->image);
+    sail_free(entry);
+}
+
+static void lru_unlink(struct sail_image_cache *image_cache, struct image_cache_entry *entry) {
+
+    if (entry->lru_prev == NULL) {
+        image_cache->lru_head = entry->lru_next;
+    } else {
+        entry->lru_prev->lru_next = entry->lru_next;
+    }
+
+    if (entry->lru_next == NULL) {
+        image_cache->lru_tail = entry->lru_prev;
+    } else {
+        entry->lru_next->lru_prev = entry->lru_prev;
+    }
+
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
+}
+
+static void lru_push_front(struct sail_image_cache *image_cache, struct image_cache_entry *entry) {
+
+    entry->lru_prev = NULL;
+    entry->lru_next = image_cache->lru_head;
+
+    if (image_cache->lru_head == NULL) {
+        image_cache->lru_tail = entry;
+    } else {
+        image_cache->lru_head->lru_prev = entry;
+    }
+
+    image_cache->lru_head = entry;
+}
+
+static void unlink_image(struct sail_image_cache *image_cache, struct image_cache_entry *entry) {
+
+    for (struct image_cache_entry **node = &image_cache->image_buckets[image_bucket(entry->image)]; *node != NULL; node = &(*node)->image_next) {
+        if (*node == entry) {
+            *node = entry->image_next;
+            return;
+        }
+    }
+}
+
+/* Removes the entry from the key table and the LRU list. Frees it if nobody uses it. */
+static void evict_entry(struct sail_image_cache *image_cache, struct image_cache_entry *entry) {
+
+    for (struct image_cache_entry **node = &image_cache->key_buckets[key_bucket(&entry->key)]; *node != NULL; node = &(*node)->key_next) {
+        if (*node == entry) {
+            *node = entry->key_next;
+            break;
+        }
+    }
+
+    lru_unlink(image_cache, entry);
+
+    image_cache->bytes -= entry->bytes;
+    entry->cached = false;
+
+    if (entry->references == 0) {
+        unlink_image(image_cache, entry);
+        destroy_entry(entry);
+    }
+}
+
+/* Finds a cached entry and acquires it. Must be called with the cache locked. */
+static struct image_cache_entry* acquire_entry(struct sail_image_cache *image_cache, const struct image_cache_key *key) {
+
+    for (struct image_cache_entry *entry = image_cache->key_buckets[key_bucket(key)]; entry != NULL; entry = entry->key_next) {
+        if (keys_equal(&entry->key, key)) {
+            entry->references++;
+
+            lru_unlink(image_cache, entry);
+            lru_push_front(image_cache, entry);
+
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/* Inserts the acquired entry and evicts the least recently used entries to fit it. */
+static void insert_entry(struct sail_image_cache *image_cache, struct image_cache_entry *entry) {
+
+    const size_t bucket = image_bucket(entry->image);
+    entry->image_next = image_cache->image_buckets[bucket];
+    image_cache->image_buckets[bucket] = entry;
+
+    if (entry->bytes > image_cache->max_bytes) {
+        SAIL_LOG_TRACE("Image cache: %zu bytes don't fit into the cache, not caching", entry->bytes);
+        return;
+    }
+
+    while (image_cache->max_bytes - image_cache->bytes < entry->bytes) {
+        evict_entry(image_cache, image_cache->lru_tail);
+    }
+
+    const size_t key_index = key_bucket(&entry->key);
+    entry->key_next = image_cache->key_buckets[key_index];
+    image_cache->key_buckets[key_index] = entry;
+
+    lru_push_front(image_cache, entry);
+
+    image_cache->bytes += entry->bytes;
+    entry->cached = true;
+}
+
+static sail_status_t load_image(const void *buffer, size_t buffer_size, const struct sail_codec_info *codec_info,
+                                const struct sail_load_options *load_options, struct sail_image **image) {
+
+    void *state;
+    SAIL_TRY(sail_start_loading_from_memory_with_options(buffer, buffer_size, codec_info, load_options, &state));
+
+    struct sail_image *image_local;
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, &image_local),
+                        /* cleanup */ sail_stop_loading(state));
+    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+static sail_status_t load_from_memory(struct sail_image_cache *image_cache,
+                                      const void *buffer, size_t buffer_size,
+                                      const struct sail_codec_info *codec_info,
+                                      const struct sail_load_options *load_options,
+                                      const struct sail_image **image) {
+
+    if (load_options != NULL && (load_options->row_callback != NULL || load_options->pass_callback != NULL)) {
+        SAIL_LOG_ERROR("Image cache: Row and pass callbacks are not supported");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct image_cache_key key;
+    build_key(buffer, buffer_size, load_options, &key);
+
+    lock_image_cache(image_cache);
+    struct image_cache_entry *entry = acquire_entry(image_cache, &key);
+    unlock_image_cache(image_cache);
+
+    if (entry != NULL) {
+        *image = entry->image;
+        return SAIL_OK;
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct image_cache_entry), &ptr));
+    struct image_cache_entry *entry_local = ptr;
+
+    *entry_local = (struct image_cache_entry) {
+        .key        = key,
+        .image      = NULL,
+        .bytes      = 0,
+        .references = 1,
+        .cached     = false,
+        .key_next   = NULL,
+        .image_next = NULL,
+        .lru_prev   = NULL,
+        .lru_next   = NULL,
+    };
+
+    SAIL_TRY_OR_CLEANUP(load_image(buffer, buffer_size, codec_info, load_options, &entry_local->image),
+                        /* cleanup */ sail_free(entry_local));
+
+    entry_local->bytes = image_bytes(entry_local->image);
+
+    lock_image_cache(image_cache);
+
+    /* Another thread could load the same image in the meantime. */
+    entry = acquire_entry(image_cache, &key);
+
+    if (entry == NULL) {
+        insert_entry(image_cache, entry_local);
+        entry = entry_local;
+    } else {
+        destroy_entry(entry_local);
+    }
+
+    unlock_image_cache(image_cache);
+
+    *image = entry->image;
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_alloc_image_cache(size_t max_bytes, struct sail_image_cache **image_cache) {
+
+    SAIL_CHECK_PTR(image_cache);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_image_cache), &ptr));
+    struct sail_image_cache *image_cache_local = ptr;
+
+    image_cache_local->max_bytes = max_bytes;
+    image_cache_local->bytes     = 0;
+    image_cache_local->lru_head  = NULL;
+    image_cache_local->lru_tail  = NULL;
+
+    for (size_t i = 0; i < IMAGE_CACHE_BUCKETS; i++) {
+        image_cache_local->key_buckets[i]   = NULL;
+        image_cache_local->image_buckets[i] = NULL;
+    }
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY_OR_CLEANUP(threading_init_mutex(&image_cache_local->mutex),
+                        /* cleanup */ sail_free(image_cache_local));
+#endif
+
+    *image_cache = image_cache_local;
+
+    return SAIL_OK;
+}
+
+void sail_destroy_image_cache(struct sail_image_cache *image_cache) {
+
+    if (image_cache == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; i < IMAGE_CACHE_BUCKETS; i++) {
+        for (struct image_cache_entry *entry = image_cache->image_buckets[i]; entry != NULL;) {
+            struct image_cache_entry *entry_next = entry->image_next;
+
+            if (entry->references > 0) {
+                SAIL_LOG_WARNING("Image cache: Destroying an image that has not been released");
+            }
+
+            destroy_entry(entry);
+            entry = entry_next;
+        }
+    }
+
+#ifdef SAIL_THREAD_SAFE
+    (void)threading_destroy_mutex(&image_cache->mutex);
+#endif
+
+    sail_free(image_cache);
+}
+
+sail_status_t sail_image_cache_load_from_memory(struct sail_image_cache *image_cache,
+                                                const void *buffer, size_t buffer_size,
+                                                const struct sail_load_options *load_options,
+                                                const struct sail_image **image) {
+
+    SAIL_CHECK_PTR(image_cache);
+    SAIL_CHECK_PTR(buffer);
+    SAIL_CHECK_PTR(image);
+
+    SAIL_TRY(load_from_memory(image_cache, buffer, buffer_size, NULL, load_options, image));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_image_cache_load_from_file(struct sail_image_cache *image_cache,
+                                              const char *path,
+                                              const struct sail_load_options *load_options,
+                                              const struct sail_image **image) {
+
+    SAIL_CHECK_PTR(image_cache);
+    SAIL_CHECK_PTR(path);
+    SAIL_CHECK_PTR(image);
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY_OR_EXECUTE(sail_codec_info_from_path(path, &codec_info),
+                        /* on error */ codec_info = NULL);
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_mmap_file(path, &io));
+
+    const void *data;
+    size_t data_size;
+    SAIL_TRY_OR_CLEANUP(io->map(io->stream, &data, &data_size),
+                        /* cleanup */ sail_destroy_io(io));
+
+    SAIL_TRY_OR_CLEANUP(load_from_memory(image_cache, data, data_size, codec_info, load_options, image),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+void sail_image_cache_release(struct sail_image_cache *image_cache, const struct sail_image *image) {
+
+    if (image_cache == NULL || image == NULL) {
+        return;
+    }
+
+    lock_image_cache(image_cache);
+
+    struct image_cache_entry *entry = image_cache->image_buckets[image_bucket(image)];
+
+    while (entry != NULL && entry->image != image) {
+        entry = entry->image_next;
+    }
+
+    if (entry == NULL) {
+        SAIL_LOG_ERROR("Image cache: The released image doesn't belong to the cache");
+    } else if (--entry->references == 0 && !entry->cached) {
+        unlink_image(image_cache, entry);
+        destroy_entry(entry);
+    }
+
+    unlock_image_cache(image_cache);
+}
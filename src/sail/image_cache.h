@@ -0,0 +1,104 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_IMAGE_CACHE_H
+#define SAIL_IMAGE_CACHE_H
+
+#include <stddef.h> /* size_t */
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_image;
+struct sail_image_cache;
+struct sail_load_options;
+
+/*
+ * Allocates a new in-process cache of decoded images bounded by 'max_bytes' bytes of pixels,
+ * palettes, and ICC profiles. When a new image doesn't fit, the least recently used images
+ * are evicted. Images larger than 'max_bytes' are loaded, but never cached.
+ *
+ * Images are keyed by the XXH64 hash and the size of their source data, and by the load options
+ * that affect decoding: options, alignments, region of interest, scale denominator, output pixel format,
+ * and tuning. The hash is not cryptographic, so the cache must not be shared between untrusted
+ * sources that can craft colliding data.
+ *
+ * The cache is thread-safe when SAIL is compiled with SAIL_THREAD_SAFE.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_image_cache(size_t max_bytes, struct sail_image_cache **image_cache);
+
+/*
+ * Destroys the specified image cache and all the cached images. All the images
+ * acquired from the cache MUST be released before. Does nothing if the cache is NULL.
+ */
+SAIL_EXPORT void sail_destroy_image_cache(struct sail_image_cache *image_cache);
+
+/*
+ * Returns the first frame of the specified memory buffer from the cache. On a cache miss, the frame
+ * is loaded with the specified load options and cached. The codec is detected by the magic number.
+ * If you don't need specific load options, just pass NULL. Load options with the row or pass callbacks
+ * are not supported.
+ *
+ * The image is shared between all the callers and MUST NOT be modified or destroyed.
+ * Release it with sail_image_cache_release() when it's not needed anymore. Evicted images stay
+ * valid until they're released.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_image_cache_load_from_memory(struct sail_image_cache *image_cache,
+                                                            const void *buffer, size_t buffer_size,
+                                                            const struct sail_load_options *load_options,
+                                                            const struct sail_image **image);
+
+/*
+ * Returns the first frame of the specified image file from the cache. The file is mapped into memory
+ * to compute its hash, and then works like sail_image_cache_load_from_memory(). The codec is detected
+ * by the file extension, and by the magic number if it fails.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_image_cache_load_from_file(struct sail_image_cache *image_cache,
+                                                          const char *path,
+                                                          const struct sail_load_options *load_options,
+                                                          const struct sail_image **image);
+
+/*
+ * Releases the image acquired from the cache. The image MUST NOT be used anymore after calling
+ * this function. Does nothing if the image is NULL.
+ */
+SAIL_EXPORT void sail_image_cache_release(struct sail_image_cache *image_cache, const struct sail_image *image);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
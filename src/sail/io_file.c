@@ -35,17 +35,80 @@
     #include <share.h>
 #endif
 
+#ifdef SAIL_WIN32
+    /* _get_osfhandle */
+    #include <io.h>
+
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 #include <sail/sail.h>
 
 struct io_file_state {
     FILE *fptr;
+    bool writable;
+
+    /* Fetched from the open file on demand. Not cached for writable files as they grow. */
     size_t file_size;
+    bool file_size_known;
+
+    /* See SailIoFileFlags. */
+    int flags;
+    /* SAIL_IO_FILE_FLAG_NO_CACHE: the data before this offset are dropped from the page cache. */
+    size_t dropped_offset;
+    size_t read_since_drop;
+};
+
+/* Drop the read data from the page cache by blocks of this size. */
+static const size_t IO_FILE_DROP_CACHE_BLOCK_SIZE = 8 * 1024 * 1024;
+
+struct io_mmap_file_state {
+    /* NULL for empty files. */
+    const unsigned char *data;
+    size_t size;
+    size_t pos;
+
+#ifdef SAIL_WIN32
+    HANDLE mapping;
+#endif
 };
 
 /*
  * Private functions.
  */
 
+/* Drops the data read so far from the page cache. */
+static void io_file_drop_cache(struct io_file_state *io_file_state) {
+
+#ifdef POSIX_FADV_DONTNEED
+    const long offset = ftell(io_file_state->fptr);
+
+    if (offset < 0 || (size_t)offset <= io_file_state->dropped_offset) {
+        return;
+    }
+
+    errno = posix_fadvise(fileno(io_file_state->fptr),
+                          (off_t)io_file_state->dropped_offset,
+                          (off_t)((size_t)offset - io_file_state->dropped_offset),
+                          POSIX_FADV_DONTNEED);
+
+    if (errno == 0) {
+        io_file_state->dropped_offset = (size_t)offset;
+    } else {
+        sail_print_errno("Failed to drop the file data from the page cache: %s");
+    }
+#else
+    (void)io_file_state;
+#endif
+
+    io_file_state->read_since_drop = 0;
+}
+
 static sail_status_t io_file_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
 
     SAIL_CHECK_PTR(stream);
@@ -56,6 +119,14 @@ static sail_status_t io_file_tolerant_read(void *stream, void *buf, size_t size_
 
     *read_size = fread(buf, 1, size_to_read, io_file_state->fptr);
 
+    if (io_file_state->flags & SAIL_IO_FILE_FLAG_NO_CACHE) {
+        io_file_state->read_since_drop += *read_size;
+
+        if (io_file_state->read_since_drop >= IO_FILE_DROP_CACHE_BLOCK_SIZE) {
+            io_file_drop_cache(io_file_state);
+        }
+    }
+
     return SAIL_OK;
 }
 
@@ -151,6 +222,10 @@ static sail_status_t io_file_close(void *stream) {
 
     struct io_file_state *io_file_state = stream;
 
+    if (io_file_state->flags & SAIL_IO_FILE_FLAG_NO_CACHE) {
+        io_file_drop_cache(io_file_state);
+    }
+
     if (fclose(io_file_state->fptr) != 0) {
         sail_print_errno("Failed to close the file: %s");
         SAIL_LOG_AND_RETURN(SAIL_ERROR_CLOSE_IO);
@@ -161,6 +236,45 @@ static sail_status_t io_file_close(void *stream) {
     return SAIL_OK;
 }
 
+static sail_status_t io_file_size(struct io_file_state *io_file_state, size_t *size) {
+
+    if (io_file_state->file_size_known) {
+        *size = io_file_state->file_size;
+        return SAIL_OK;
+    }
+
+    /* Account for the buffered data. */
+    if (io_file_state->writable && fflush(io_file_state->fptr) != 0) {
+        sail_print_errno("Failed to flush file buffer: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_WRITE_IO);
+    }
+
+#ifdef SAIL_WIN32
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx((HANDLE)_get_osfhandle(_fileno(io_file_state->fptr)), &file_size)) {
+        SAIL_LOG_ERROR("Failed to get the file size. Error: 0x%X", GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    *size = (size_t)file_size.QuadPart;
+#else
+    struct stat attrs;
+    if (fstat(fileno(io_file_state->fptr), &attrs) != 0) {
+        sail_print_errno("Failed to get the file size: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    *size = (size_t)attrs.st_size;
+#endif
+
+    if (!io_file_state->writable) {
+        io_file_state->file_size       = *size;
+        io_file_state->file_size_known = true;
+    }
+
+    return SAIL_OK;
+}
+
 static sail_status_t io_file_eof(void *stream, bool *result) {
 
     SAIL_CHECK_PTR(stream);
@@ -174,13 +288,16 @@ static sail_status_t io_file_eof(void *stream, bool *result) {
         size_t offset;
         SAIL_TRY(io_file_tell(stream, &offset));
 
-        *result = (offset >= io_file_state->file_size);
+        size_t file_size;
+        SAIL_TRY(io_file_size(io_file_state, &file_size));
+
+        *result = (offset >= file_size);
     }
 
     return SAIL_OK;
 }
 
-static sail_status_t alloc_io_file(const char *path, const char *mode, struct sail_io **io) {
+static sail_status_t alloc_io_file(const char *path, const char *mode, int flags, struct sail_io **io) {
 
     SAIL_CHECK_PTR(path);
     SAIL_CHECK_PTR(mode);
@@ -207,10 +324,23 @@ static sail_status_t alloc_io_file(const char *path, const char *mode, struct sa
     SAIL_TRY(sail_malloc(sizeof(struct io_file_state), &ptr));
     struct io_file_state *io_file_state = ptr;
 
-    io_file_state->fptr = fptr;
-
-    SAIL_TRY_OR_CLEANUP(sail_file_size(path, &io_file_state->file_size),
-                        /* cleanup */ fclose(io_file_state->fptr), sail_free(io_file_state));
+    io_file_state->fptr            = fptr;
+    io_file_state->writable        = (strchr(mode, 'w') != NULL || strchr(mode, '+') != NULL);
+    io_file_state->file_size       = 0;
+    io_file_state->file_size_known = false;
+    io_file_state->flags           = flags;
+    io_file_state->dropped_offset  = 0;
+    io_file_state->read_since_drop = 0;
+
+#ifdef POSIX_FADV_SEQUENTIAL
+    /* Advices are optimizations, so failures are not errors. */
+    if (flags & SAIL_IO_FILE_FLAG_SEQUENTIAL) {
+        posix_fadvise(fileno(fptr), 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+    if (flags & SAIL_IO_FILE_FLAG_NO_CACHE) {
+        posix_fadvise(fileno(fptr), 0, 0, POSIX_FADV_NOREUSE);
+    }
+#endif
 
     SAIL_TRY_OR_CLEANUP(sail_alloc_io(io),
                         /* cleanup */ fclose(io_file_state->fptr), sail_free(io_file_state));
@@ -220,13 +350,266 @@ static sail_status_t alloc_io_file(const char *path, const char *mode, struct sa
     return SAIL_OK;
 }
 
+static sail_status_t io_mmap_file_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(read_size);
+
+    struct io_mmap_file_state *io_mmap_file_state = stream;
+
+    *read_size = 0;
+
+    if (io_mmap_file_state->pos >= io_mmap_file_state->size) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_EOF);
+    }
+
+    const size_t available = io_mmap_file_state->size - io_mmap_file_state->pos;
+    const size_t actual_size_to_read = size_to_read > available ? available : size_to_read;
+
+    memcpy(buf, io_mmap_file_state->data + io_mmap_file_state->pos, actual_size_to_read);
+    io_mmap_file_state->pos += actual_size_to_read;
+
+    *read_size = actual_size_to_read;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mmap_file_strict_read(void *stream, void *buf, size_t size_to_read) {
+
+    size_t read_size;
+
+    SAIL_TRY(io_mmap_file_tolerant_read(stream, buf, size_to_read, &read_size));
+
+    if (read_size != size_to_read) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mmap_file_seek(void *stream, long offset, int whence) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct io_mmap_file_state *io_mmap_file_state = stream;
+
+    long long new_pos;
+
+    switch (whence) {
+        case SEEK_SET: {
+            new_pos = offset;
+            break;
+        }
+
+        case SEEK_CUR: {
+            new_pos = (long long)io_mmap_file_state->pos + offset;
+            break;
+        }
+
+        case SEEK_END: {
+            new_pos = (long long)io_mmap_file_state->size + offset;
+            break;
+        }
+
+        default: {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_SEEK_WHENCE);
+        }
+    }
+
+    /* Seeking past the end is allowed like with fseek(), reading from there returns EOF. */
+    if (new_pos < 0) {
+        SAIL_LOG_ERROR("Failed to seek to a negative position");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+    }
+
+    io_mmap_file_state->pos = (size_t)new_pos;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mmap_file_tell(void *stream, size_t *offset) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(offset);
+
+    const struct io_mmap_file_state *io_mmap_file_state = stream;
+
+    *offset = io_mmap_file_state->pos;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mmap_file_close(void *stream) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct io_mmap_file_state *io_mmap_file_state = stream;
+
+    sail_status_t status = SAIL_OK;
+
+    if (io_mmap_file_state->data != NULL) {
+#ifdef SAIL_WIN32
+        if (!UnmapViewOfFile(io_mmap_file_state->data)) {
+            SAIL_LOG_ERROR("Failed to unmap the file. Error: 0x%X", GetLastError());
+            status = SAIL_ERROR_CLOSE_IO;
+        }
+        CloseHandle(io_mmap_file_state->mapping);
+#else
+        if (munmap((void *)io_mmap_file_state->data, io_mmap_file_state->size) != 0) {
+            sail_print_errno("Failed to unmap the file: %s");
+            status = SAIL_ERROR_CLOSE_IO;
+        }
+#endif
+    }
+
+    sail_free(io_mmap_file_state);
+
+    return status;
+}
+
+static sail_status_t io_mmap_file_eof(void *stream, bool *result) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(result);
+
+    const struct io_mmap_file_state *io_mmap_file_state = stream;
+
+    *result = io_mmap_file_state->pos >= io_mmap_file_state->size;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_mmap_file_map(void *stream, const void **data, size_t *size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(size);
+
+    const struct io_mmap_file_state *io_mmap_file_state = stream;
+
+    if (io_mmap_file_state->pos >= io_mmap_file_state->size) {
+        *data = io_mmap_file_state->data + io_mmap_file_state->size;
+        *size = 0;
+    } else {
+        *data = io_mmap_file_state->data + io_mmap_file_state->pos;
+        *size = io_mmap_file_state->size - io_mmap_file_state->pos;
+    }
+
+    return SAIL_OK;
+}
+
+#ifdef SAIL_WIN32
+static sail_status_t map_file(const char *path, struct io_mmap_file_state *io_mmap_file_state) {
+
+    #ifdef SAIL_WINDOWS_UTF8_PATHS
+        wchar_t *wpath;
+        SAIL_TRY(sail_multibyte_to_wchar(path, &wpath));
+
+        HANDLE file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+        sail_free(wpath);
+    #else
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    #endif
+
+    if (file == INVALID_HANDLE_VALUE) {
+        SAIL_LOG_ERROR("Failed to open the specified file. Error: 0x%X", GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        SAIL_LOG_ERROR("Failed to get the file size. Error: 0x%X", GetLastError());
+        CloseHandle(file);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    io_mmap_file_state->size = (size_t)file_size.QuadPart;
+
+    /* Empty files cannot be mapped. */
+    if (io_mmap_file_state->size == 0) {
+        CloseHandle(file);
+        return SAIL_OK;
+    }
+
+    io_mmap_file_state->mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+
+    if (io_mmap_file_state->mapping == NULL) {
+        SAIL_LOG_ERROR("Failed to map the file. Error: 0x%X", GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    io_mmap_file_state->data = MapViewOfFile(io_mmap_file_state->mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (io_mmap_file_state->data == NULL) {
+        SAIL_LOG_ERROR("Failed to map the file. Error: 0x%X", GetLastError());
+        CloseHandle(io_mmap_file_state->mapping);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    return SAIL_OK;
+}
+#else
+static sail_status_t map_file(const char *path, struct io_mmap_file_state *io_mmap_file_state) {
+
+    const int fd = open(path, O_RDONLY);
+
+    if (fd < 0) {
+        sail_print_errno("Failed to open the specified file: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+
+    struct stat attrs;
+    if (fstat(fd, &attrs) != 0) {
+        sail_print_errno("Failed to get the file size: %s");
+        close(fd);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    io_mmap_file_state->size = (size_t)attrs.st_size;
+
+    /* Empty files cannot be mapped. */
+    if (io_mmap_file_state->size == 0) {
+        close(fd);
+        return SAIL_OK;
+    }
+
+    /* The mapping stays valid after closing the descriptor. */
+    void *data = mmap(NULL, io_mmap_file_state->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        sail_print_errno("Failed to map the file: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_FILE);
+    }
+
+    io_mmap_file_state->data = data;
+
+    return SAIL_OK;
+}
+#endif
+
 /*
  * Public functions.
  */
 
 sail_status_t sail_alloc_io_read_file(const char *path, struct sail_io **io) {
 
-    SAIL_TRY(alloc_io_file(path, "rb", io));
+    SAIL_TRY(sail_alloc_io_read_file_with_flags(path, 0, io));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_alloc_io_read_file_with_flags(const char *path, int flags, struct sail_io **io) {
+
+#ifdef _MSC_VER
+    /* "S" optimizes caching for sequential access. */
+    SAIL_TRY(alloc_io_file(path, (flags & SAIL_IO_FILE_FLAG_SEQUENTIAL) ? "rbS" : "rb", flags, io));
+#else
+    SAIL_TRY(alloc_io_file(path, "rb", flags, io));
+#endif
 
     (*io)->features       = SAIL_IO_FEATURE_SEEKABLE;
     (*io)->tolerant_read  = io_file_tolerant_read;
@@ -244,8 +627,9 @@ sail_status_t sail_alloc_io_read_file(const char *path, struct sail_io **io) {
 
 sail_status_t sail_alloc_io_read_write_file(const char *path, struct sail_io **io) {
 
-    SAIL_TRY(alloc_io_file(path, "w+b", io));
+    SAIL_TRY(alloc_io_file(path, "w+b", 0, io));
 
+    (*io)->features       = SAIL_IO_FEATURE_SEEKABLE;
     (*io)->tolerant_read  = io_file_tolerant_read;
     (*io)->strict_read    = io_file_strict_read;
     (*io)->tolerant_write = io_file_tolerant_write;
@@ -258,3 +642,43 @@ sail_status_t sail_alloc_io_read_write_file(const char *path, struct sail_io **i
 
     return SAIL_OK;
 }
+
+sail_status_t sail_alloc_io_read_mmap_file(const char *path, struct sail_io **io) {
+
+    SAIL_CHECK_PTR(path);
+    SAIL_CHECK_PTR(io);
+
+    SAIL_LOG_DEBUG("Mapping file '%s' for reading", path);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct io_mmap_file_state), &ptr));
+    struct io_mmap_file_state *io_mmap_file_state = ptr;
+
+    io_mmap_file_state->data = NULL;
+    io_mmap_file_state->size = 0;
+    io_mmap_file_state->pos  = 0;
+
+    SAIL_TRY_OR_CLEANUP(map_file(path, io_mmap_file_state),
+                        /* cleanup */ sail_free(io_mmap_file_state));
+
+    struct sail_io *io_local;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io(&io_local),
+                        /* cleanup */ io_mmap_file_close(io_mmap_file_state));
+
+    io_local->features       = SAIL_IO_FEATURE_SEEKABLE | SAIL_IO_FEATURE_MAPPED;
+    io_local->stream         = io_mmap_file_state;
+    io_local->tolerant_read  = io_mmap_file_tolerant_read;
+    io_local->strict_read    = io_mmap_file_strict_read;
+    io_local->tolerant_write = sail_io_noop_tolerant_write;
+    io_local->strict_write   = sail_io_noop_strict_write;
+    io_local->seek           = io_mmap_file_seek;
+    io_local->tell           = io_mmap_file_tell;
+    io_local->flush          = sail_io_noop_flush;
+    io_local->close          = io_mmap_file_close;
+    io_local->eof            = io_mmap_file_eof;
+    io_local->map            = io_mmap_file_map;
+
+    *io = io_local;
+
+    return SAIL_OK;
+}
@@ -35,6 +35,25 @@ extern "C" {
 
 struct sail_io;
 
+/*
+ * Flags to control file I/O behavior.
+ */
+enum SailIoFileFlags {
+
+    /*
+     * The file is read sequentially from the beginning to the end. Tells the OS
+     * to read ahead aggressively.
+     */
+    SAIL_IO_FILE_FLAG_SEQUENTIAL = 1 << 0,
+
+    /*
+     * The file is read once. Drops the data already read from the OS page cache,
+     * so large decodes don't evict the cache of other processes. Has no effect on Windows
+     * and on platforms without posix_fadvise().
+     */
+    SAIL_IO_FILE_FLAG_NO_CACHE   = 1 << 1,
+};
+
 /*
  * Opens the specified image file for reading and allocates a new I/O object for it.
  *
@@ -42,6 +61,14 @@ struct sail_io;
  */
 SAIL_EXPORT sail_status_t sail_alloc_io_read_file(const char *path, struct sail_io **io);
 
+/*
+ * Opens the specified image file for reading with the specified or-ed SailIoFileFlags
+ * and allocates a new I/O object for it.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_io_read_file_with_flags(const char *path, int flags, struct sail_io **io);
+
 /*
  * Opens the specified image file for reading and writing, and allocates a new I/O object for it.
  *
@@ -49,6 +76,15 @@ SAIL_EXPORT sail_status_t sail_alloc_io_read_file(const char *path, struct sail_
  */
 SAIL_EXPORT sail_status_t sail_alloc_io_read_write_file(const char *path, struct sail_io **io);
 
+/*
+ * Maps the specified image file into memory for reading and allocates a new I/O object for it.
+ * The I/O object has the SAIL_IO_FEATURE_MAPPED feature, so codecs that need the whole file
+ * in memory borrow the mapping instead of reading the file into their own buffers.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_io_read_mmap_file(const char *path, struct sail_io **io);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
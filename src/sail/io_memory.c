@@ -24,6 +24,7 @@
 */
 
 #include <errno.h>
+#include <stdint.h> /* SIZE_MAX */
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -236,6 +237,181 @@ static sail_status_t io_memory_eof(void *stream, bool *result) {
     return SAIL_OK;
 }
 
+static sail_status_t io_memory_map(void *stream, const void **data, size_t *size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(data);
+    SAIL_CHECK_PTR(size);
+
+    const struct mem_io_read_stream *mem_io_read_stream = (const struct mem_io_read_stream *)stream;
+    const struct mem_io_buffer_info *mem_io_buffer_info = &mem_io_read_stream->mem_io_buffer_info;
+
+    const size_t pos = mem_io_buffer_info->pos > mem_io_buffer_info->accessible_length
+                        ? mem_io_buffer_info->accessible_length
+                        : mem_io_buffer_info->pos;
+
+    *data = (const char *)mem_io_read_stream->buffer + pos;
+    *size = mem_io_buffer_info->accessible_length - pos;
+
+    return SAIL_OK;
+}
+
+/* Growable memory buffers never shrink and grow at least by this size. */
+static const size_t GROWABLE_MEMORY_MIN_CAPACITY = 4096;
+
+static sail_status_t io_growable_memory_reserve(struct mem_io_write_stream *mem_io_write_stream, size_t capacity) {
+
+    struct mem_io_buffer_info *mem_io_buffer_info = &mem_io_write_stream->mem_io_buffer_info;
+
+    if (capacity <= mem_io_buffer_info->length) {
+        return SAIL_OK;
+    }
+
+    /* Grow geometrically to keep the number of reallocations logarithmic. */
+    size_t new_length = mem_io_buffer_info->length < GROWABLE_MEMORY_MIN_CAPACITY
+                            ? GROWABLE_MEMORY_MIN_CAPACITY
+                            : mem_io_buffer_info->length;
+
+    while (new_length < capacity) {
+        new_length = (new_length > SIZE_MAX / 2) ? capacity : new_length * 2;
+    }
+
+    SAIL_TRY(sail_realloc(new_length, &mem_io_write_stream->buffer));
+
+    mem_io_buffer_info->length = new_length;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_growable_memory_tolerant_write(void *stream, const void *buf, size_t size_to_write, size_t *written_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(written_size);
+
+    struct mem_io_write_stream *mem_io_write_stream = (struct mem_io_write_stream *)stream;
+    struct mem_io_buffer_info *mem_io_buffer_info = &mem_io_write_stream->mem_io_buffer_info;
+
+    *written_size = 0;
+
+    if (size_to_write > SIZE_MAX - mem_io_buffer_info->pos) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_WRITE_IO);
+    }
+
+    SAIL_TRY(io_growable_memory_reserve(mem_io_write_stream, mem_io_buffer_info->pos + size_to_write));
+
+    /* Fill the gap after seeking past the end. */
+    if (mem_io_buffer_info->pos > mem_io_buffer_info->accessible_length) {
+        memset((char *)mem_io_write_stream->buffer + mem_io_buffer_info->accessible_length,
+                0,
+                mem_io_buffer_info->pos - mem_io_buffer_info->accessible_length);
+    }
+
+    memcpy((char *)mem_io_write_stream->buffer + mem_io_buffer_info->pos, buf, size_to_write);
+    mem_io_buffer_info->pos += size_to_write;
+
+    *written_size = size_to_write;
+
+    if (mem_io_buffer_info->pos > mem_io_buffer_info->accessible_length) {
+        mem_io_buffer_info->accessible_length = mem_io_buffer_info->pos;
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_growable_memory_strict_write(void *stream, const void *buf, size_t size_to_write) {
+
+    size_t written_size;
+
+    SAIL_TRY(io_growable_memory_tolerant_write(stream, buf, size_to_write, &written_size));
+
+    if (written_size != size_to_write) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_WRITE_IO);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_growable_memory_strict_write_vectored(void *stream, const struct sail_io_vector *vectors, size_t vectors_count) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(vectors);
+
+    struct mem_io_write_stream *mem_io_write_stream = (struct mem_io_write_stream *)stream;
+
+    size_t total_size = mem_io_write_stream->mem_io_buffer_info.pos;
+
+    for (size_t i = 0; i < vectors_count; i++) {
+        if (vectors[i].size > SIZE_MAX - total_size) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_WRITE_IO);
+        }
+
+        total_size += vectors[i].size;
+    }
+
+    /* Reallocate once for all the segments. */
+    SAIL_TRY(io_growable_memory_reserve(mem_io_write_stream, total_size));
+
+    for (size_t i = 0; i < vectors_count; i++) {
+        if (vectors[i].size > 0) {
+            SAIL_TRY(io_growable_memory_strict_write(stream, vectors[i].data, vectors[i].size));
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_growable_memory_seek(void *stream, long offset, int whence) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct mem_io_buffer_info *mem_io_buffer_info = (struct mem_io_buffer_info *)stream;
+
+    size_t base;
+
+    switch (whence) {
+        case SEEK_SET: {
+            base = 0;
+            break;
+        }
+
+        case SEEK_CUR: {
+            base = mem_io_buffer_info->pos;
+            break;
+        }
+
+        case SEEK_END: {
+            base = mem_io_buffer_info->accessible_length;
+            break;
+        }
+
+        default: {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_SEEK_WHENCE);
+        }
+    }
+
+    /* Seeking past the end is allowed, the buffer grows on the next write. */
+    if (offset < 0 && (size_t)(-(offset + 1)) >= base) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+    }
+
+    mem_io_buffer_info->pos = (offset < 0) ? base - (size_t)(-(offset + 1)) - 1 : base + (size_t)offset;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_growable_memory_close(void *stream) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct mem_io_write_stream *mem_io_write_stream = (struct mem_io_write_stream *)stream;
+
+    sail_free(mem_io_write_stream->buffer);
+    sail_free(mem_io_write_stream);
+
+    return SAIL_OK;
+}
+
 /*
  * Public functions.
  */
@@ -260,6 +436,7 @@ sail_status_t sail_alloc_io_read_memory(const void *buffer, size_t length, struc
     mem_io_read_stream->mem_io_buffer_info.pos               = 0;
     mem_io_read_stream->buffer                               = buffer;
 
+    io_local->features       = SAIL_IO_FEATURE_SEEKABLE | SAIL_IO_FEATURE_MAPPED;
     io_local->stream         = mem_io_read_stream;
     io_local->tolerant_read  = io_memory_tolerant_read;
     io_local->strict_read    = io_memory_strict_read;
@@ -270,6 +447,7 @@ sail_status_t sail_alloc_io_read_memory(const void *buffer, size_t length, struc
     io_local->flush          = sail_io_noop_flush;
     io_local->close          = io_memory_close;
     io_local->eof            = io_memory_eof;
+    io_local->map            = io_memory_map;
 
     *io = io_local;
 
@@ -312,3 +490,65 @@ sail_status_t sail_alloc_io_read_write_memory(void *buffer, size_t length, struc
 
     return SAIL_OK;
 }
+
+sail_status_t sail_alloc_io_write_growable_memory(struct sail_io **io) {
+
+    SAIL_CHECK_PTR(io);
+
+    SAIL_LOG_DEBUG("Opening growable memory buffer for reading/writing");
+
+    struct sail_io *io_local;
+    SAIL_TRY(sail_alloc_io(&io_local));
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct mem_io_write_stream), &ptr),
+                        /* cleanup */ sail_destroy_io(io_local));
+    struct mem_io_write_stream *mem_io_write_stream = ptr;
+
+    mem_io_write_stream->mem_io_buffer_info.length            = 0;
+    mem_io_write_stream->mem_io_buffer_info.accessible_length = 0;
+    mem_io_write_stream->mem_io_buffer_info.pos               = 0;
+    mem_io_write_stream->buffer                               = NULL;
+
+    io_local->features              = SAIL_IO_FEATURE_SEEKABLE | SAIL_IO_FEATURE_VECTORED;
+    io_local->stream                = mem_io_write_stream;
+    io_local->tolerant_read         = io_memory_tolerant_read;
+    io_local->strict_read           = io_memory_strict_read;
+    io_local->tolerant_write        = io_growable_memory_tolerant_write;
+    io_local->strict_write          = io_growable_memory_strict_write;
+    io_local->seek                  = io_growable_memory_seek;
+    io_local->tell                  = io_memory_tell;
+    io_local->flush                 = io_memory_flush;
+    io_local->close                 = io_growable_memory_close;
+    io_local->eof                   = io_memory_eof;
+    io_local->strict_write_vectored = io_growable_memory_strict_write_vectored;
+
+    *io = io_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_take_io_growable_memory_buffer(struct sail_io *io, void **buffer, size_t *buffer_size) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(buffer);
+    SAIL_CHECK_PTR(buffer_size);
+
+    if (io->close != io_growable_memory_close) {
+        SAIL_LOG_ERROR("The I/O object is not a growable memory buffer");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_IO);
+    }
+
+    struct mem_io_write_stream *mem_io_write_stream = (struct mem_io_write_stream *)io->stream;
+    struct mem_io_buffer_info *mem_io_buffer_info = &mem_io_write_stream->mem_io_buffer_info;
+
+    *buffer      = mem_io_write_stream->buffer;
+    *buffer_size = mem_io_buffer_info->accessible_length;
+
+    mem_io_write_stream->buffer           = NULL;
+    mem_io_buffer_info->length            = 0;
+    mem_io_buffer_info->accessible_length = 0;
+    mem_io_buffer_info->pos               = 0;
+
+    return SAIL_OK;
+}
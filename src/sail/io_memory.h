@@ -51,6 +51,25 @@ SAIL_EXPORT sail_status_t sail_alloc_io_read_memory(const void *buffer, size_t l
  */
 SAIL_EXPORT sail_status_t sail_alloc_io_read_write_memory(void *buffer, size_t length, struct sail_io **io);
 
+/*
+ * Allocates a new I/O object for reading and writing into a memory buffer owned by the I/O object.
+ * The buffer starts empty and grows geometrically on writes, so no upper bound of the output size
+ * is needed. Take the final buffer with sail_take_io_growable_memory_buffer() before destroying
+ * the I/O object.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_io_write_growable_memory(struct sail_io **io);
+
+/*
+ * Transfers the ownership of the buffer written into the I/O object allocated with
+ * sail_alloc_io_write_growable_memory() to the caller. The buffer must be freed with sail_free().
+ * Assigns NULL to the buffer if nothing was written. The I/O object becomes empty and can be reused.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_take_io_growable_memory_buffer(struct sail_io *io, void **buffer, size_t *buffer_size);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
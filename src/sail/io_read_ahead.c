@@ -0,0 +1,542 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
+#include <stdio.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+struct io_read_ahead_block {
+    unsigned char *data;
+    /* Offset of the block in the underlying I/O stream. */
+    size_t offset;
+    size_t length;
+    /* Status of reading the block. Failed blocks have zero length. */
+    sail_status_t status;
+};
+
+struct io_read_ahead_state {
+    /* Underlying I/O object. Accessed by the filler only after allocation. */
+    struct sail_io *io;
+    /* Current position in the underlying I/O stream. Accessed by the filler only. */
+    size_t io_pos;
+
+    size_t size;
+    size_t block_size;
+    unsigned blocks_count;
+    unsigned char *blocks_data;
+    struct io_read_ahead_block *blocks;
+
+    /* Current position of the consumer. */
+    size_t pos;
+
+    /*
+     * Ring of filled blocks starting at 'head'. The consumer position is always within the head block,
+     * or equals to 'next_offset' when the ring is empty. Guarded by the mutex.
+     */
+    unsigned head;
+    unsigned count;
+    /* Offset of the next block to read. */
+    size_t next_offset;
+    /* EOF or an error is reached, so nothing is read until the next seek. */
+    bool finished;
+    /* Incremented on every seek that discards the ring, so blocks in flight are dropped. */
+    unsigned generation;
+
+#ifdef SAIL_THREAD_SAFE
+    sail_mutex_t mutex;
+    sail_cond_t filled_cond;
+    sail_cond_t free_cond;
+    sail_thread_t thread;
+    bool stop;
+#endif
+};
+
+/*
+ * Private functions.
+ */
+
+/* Reads a single block at the specified offset. Called without the mutex locked. */
+static void read_block(struct io_read_ahead_state *io_read_ahead_state, size_t offset, struct io_read_ahead_block *block) {
+
+    struct sail_io *io = io_read_ahead_state->io;
+
+    block->offset = offset;
+    block->length = 0;
+    block->status = SAIL_OK;
+
+    if (io_read_ahead_state->io_pos != offset) {
+        block->status = io->seek(io->stream, (long)offset, SEEK_SET);
+
+        if (block->status != SAIL_OK) {
+            return;
+        }
+
+        io_read_ahead_state->io_pos = offset;
+    }
+
+    block->status = io->tolerant_read(io->stream, block->data, io_read_ahead_state->block_size, &block->length);
+
+    /* The memory I/O reports EOF as an error. */
+    if (block->status == SAIL_ERROR_EOF) {
+        block->status = SAIL_OK;
+        block->length = 0;
+    }
+
+    io_read_ahead_state->io_pos += block->length;
+}
+
+/* Publishes the block read for the specified generation. Called with the mutex locked. */
+static void commit_block(struct io_read_ahead_state *io_read_ahead_state, unsigned generation, const struct io_read_ahead_block *block) {
+
+    if (generation != io_read_ahead_state->generation) {
+        return;
+    }
+
+    if (block->status != SAIL_OK) {
+        /* Keep the failed block in the ring to report the error to the consumer. */
+        io_read_ahead_state->count++;
+        io_read_ahead_state->finished = true;
+    } else if (block->length == 0) {
+        io_read_ahead_state->finished = true;
+    } else {
+        io_read_ahead_state->count++;
+        io_read_ahead_state->next_offset += block->length;
+    }
+}
+
+static struct io_read_ahead_block *next_free_block(struct io_read_ahead_state *io_read_ahead_state) {
+
+    return &io_read_ahead_state->blocks[(io_read_ahead_state->head + io_read_ahead_state->count) % io_read_ahead_state->blocks_count];
+}
+
+#ifdef SAIL_THREAD_SAFE
+static void read_ahead_routine(void *arg) {
+
+    struct io_read_ahead_state *io_read_ahead_state = arg;
+
+    if (threading_lock_mutex(&io_read_ahead_state->mutex) != SAIL_OK) {
+        return;
+    }
+
+    while (!io_read_ahead_state->stop) {
+        if (io_read_ahead_state->finished || io_read_ahead_state->count == io_read_ahead_state->blocks_count) {
+            if (threading_wait_cond(&io_read_ahead_state->free_cond, &io_read_ahead_state->mutex) != SAIL_OK) {
+                break;
+            }
+            continue;
+        }
+
+        const unsigned generation = io_read_ahead_state->generation;
+        const size_t offset = io_read_ahead_state->next_offset;
+        struct io_read_ahead_block *block = next_free_block(io_read_ahead_state);
+
+        /* The block is not in the ring yet, so the consumer never touches it while it's being read. */
+        threading_unlock_mutex(&io_read_ahead_state->mutex);
+        read_block(io_read_ahead_state, offset, block);
+        threading_lock_mutex(&io_read_ahead_state->mutex);
+
+        commit_block(io_read_ahead_state, generation, block);
+        threading_broadcast_cond(&io_read_ahead_state->filled_cond);
+    }
+
+    threading_unlock_mutex(&io_read_ahead_state->mutex);
+}
+#endif
+
+/* Waits for the head block and stores it in 'block', or NULL on EOF. Called with the mutex locked. */
+static sail_status_t wait_for_block(struct io_read_ahead_state *io_read_ahead_state, struct io_read_ahead_block **block) {
+
+    while (io_read_ahead_state->count == 0 && !io_read_ahead_state->finished) {
+#ifdef SAIL_THREAD_SAFE
+        SAIL_TRY(threading_wait_cond(&io_read_ahead_state->filled_cond, &io_read_ahead_state->mutex));
+#else
+        struct io_read_ahead_block *free_block = next_free_block(io_read_ahead_state);
+        read_block(io_read_ahead_state, io_read_ahead_state->next_offset, free_block);
+        commit_block(io_read_ahead_state, io_read_ahead_state->generation, free_block);
+#endif
+    }
+
+    *block = (io_read_ahead_state->count == 0) ? NULL : &io_read_ahead_state->blocks[io_read_ahead_state->head];
+
+    return SAIL_OK;
+}
+
+/* Drops the head block from the ring. Called with the mutex locked. */
+static sail_status_t pop_block(struct io_read_ahead_state *io_read_ahead_state) {
+
+    io_read_ahead_state->head = (io_read_ahead_state->head + 1) % io_read_ahead_state->blocks_count;
+    io_read_ahead_state->count--;
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY(threading_broadcast_cond(&io_read_ahead_state->free_cond));
+#endif
+
+    return SAIL_OK;
+}
+
+static sail_status_t lock_state(struct io_read_ahead_state *io_read_ahead_state) {
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY(threading_lock_mutex(&io_read_ahead_state->mutex));
+#else
+    (void)io_read_ahead_state;
+#endif
+
+    return SAIL_OK;
+}
+
+static sail_status_t unlock_state(struct io_read_ahead_state *io_read_ahead_state) {
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY(threading_unlock_mutex(&io_read_ahead_state->mutex));
+#else
+    (void)io_read_ahead_state;
+#endif
+
+    return SAIL_OK;
+}
+
+static sail_status_t read_locked(struct io_read_ahead_state *io_read_ahead_state, unsigned char *buf, size_t size_to_read, size_t *read_size) {
+
+    while (size_to_read > 0) {
+        struct io_read_ahead_block *block;
+        SAIL_TRY(wait_for_block(io_read_ahead_state, &block));
+
+        if (block == NULL) {
+            break;
+        }
+
+        SAIL_TRY(block->status);
+
+        const size_t block_end = block->offset + block->length;
+        const size_t available = block_end - io_read_ahead_state->pos;
+        const size_t chunk = (size_to_read < available) ? size_to_read : available;
+
+        memcpy(buf, block->data + (io_read_ahead_state->pos - block->offset), chunk);
+
+        buf                      += chunk;
+        size_to_read             -= chunk;
+        *read_size               += chunk;
+        io_read_ahead_state->pos += chunk;
+
+        if (io_read_ahead_state->pos == block_end) {
+            SAIL_TRY(pop_block(io_read_ahead_state));
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_read_ahead_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(read_size);
+
+    struct io_read_ahead_state *io_read_ahead_state = stream;
+
+    *read_size = 0;
+
+    SAIL_TRY(lock_state(io_read_ahead_state));
+    SAIL_TRY_OR_CLEANUP(read_locked(io_read_ahead_state, buf, size_to_read, read_size),
+                        /* cleanup */ unlock_state(io_read_ahead_state));
+    SAIL_TRY(unlock_state(io_read_ahead_state));
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_read_ahead_strict_read(void *stream, void *buf, size_t size_to_read) {
+
+    size_t read_size;
+
+    SAIL_TRY(io_read_ahead_tolerant_read(stream, buf, size_to_read, &read_size));
+
+    if (read_size != size_to_read) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t seek_locked(struct io_read_ahead_state *io_read_ahead_state, size_t target) {
+
+    /* Skip the prefetched blocks if the target is within the ring. */
+    if (io_read_ahead_state->count > 0) {
+        const struct io_read_ahead_block *head_block = &io_read_ahead_state->blocks[io_read_ahead_state->head];
+
+        if (head_block->status == SAIL_OK && target >= head_block->offset && target < io_read_ahead_state->next_offset) {
+            while (target >= head_block->offset + head_block->length) {
+                SAIL_TRY(pop_block(io_read_ahead_state));
+                head_block = &io_read_ahead_state->blocks[io_read_ahead_state->head];
+            }
+
+            io_read_ahead_state->pos = target;
+            return SAIL_OK;
+        }
+    } else if (target == io_read_ahead_state->next_offset && !io_read_ahead_state->finished) {
+        /* The block at the target is already being read. */
+        io_read_ahead_state->pos = target;
+        return SAIL_OK;
+    }
+
+    /* Discard the ring and restart prefetching from the target. */
+    io_read_ahead_state->generation++;
+    io_read_ahead_state->count       = 0;
+    io_read_ahead_state->finished    = false;
+    io_read_ahead_state->next_offset = target;
+    io_read_ahead_state->pos         = target;
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY(threading_broadcast_cond(&io_read_ahead_state->free_cond));
+#endif
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_read_ahead_seek(void *stream, long offset, int whence) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct io_read_ahead_state *io_read_ahead_state = stream;
+
+    long base;
+
+    switch (whence) {
+        case SEEK_SET: base = 0;                               break;
+        case SEEK_CUR: base = (long)io_read_ahead_state->pos;  break;
+        case SEEK_END: base = (long)io_read_ahead_state->size; break;
+
+        default: {
+            SAIL_LOG_ERROR("Invalid seek whence %d", whence);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+        }
+    }
+
+    if (base + offset < 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+    }
+
+    SAIL_TRY(lock_state(io_read_ahead_state));
+    SAIL_TRY_OR_CLEANUP(seek_locked(io_read_ahead_state, (size_t)(base + offset)),
+                        /* cleanup */ unlock_state(io_read_ahead_state));
+    SAIL_TRY(unlock_state(io_read_ahead_state));
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_read_ahead_tell(void *stream, size_t *offset) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(offset);
+
+    const struct io_read_ahead_state *io_read_ahead_state = stream;
+
+    /* The position is changed by the consumer only. */
+    *offset = io_read_ahead_state->pos;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_read_ahead_eof(void *stream, bool *result) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(result);
+
+    const struct io_read_ahead_state *io_read_ahead_state = stream;
+
+    *result = io_read_ahead_state->pos >= io_read_ahead_state->size;
+
+    return SAIL_OK;
+}
+
+static void destroy_io_read_ahead_state(struct io_read_ahead_state *io_read_ahead_state) {
+
+    sail_free(io_read_ahead_state->blocks_data);
+    sail_free(io_read_ahead_state->blocks);
+    sail_free(io_read_ahead_state);
+}
+
+static sail_status_t io_read_ahead_close(void *stream) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct io_read_ahead_state *io_read_ahead_state = stream;
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY(threading_lock_mutex(&io_read_ahead_state->mutex));
+    io_read_ahead_state->stop = true;
+    SAIL_TRY_OR_CLEANUP(threading_broadcast_cond(&io_read_ahead_state->free_cond),
+                        /* cleanup */ threading_unlock_mutex(&io_read_ahead_state->mutex));
+    SAIL_TRY(threading_unlock_mutex(&io_read_ahead_state->mutex));
+
+    SAIL_TRY(threading_join_thread(&io_read_ahead_state->thread));
+
+    threading_destroy_cond(&io_read_ahead_state->free_cond);
+    threading_destroy_cond(&io_read_ahead_state->filled_cond);
+    threading_destroy_mutex(&io_read_ahead_state->mutex);
+#endif
+
+    struct sail_io *io = io_read_ahead_state->io;
+    const sail_status_t status = io->close(io->stream);
+
+    /* Avoid closing the stream twice. */
+    io->stream = NULL;
+    sail_destroy_io(io);
+
+    destroy_io_read_ahead_state(io_read_ahead_state);
+
+    return status;
+}
+
+static sail_status_t alloc_io_read_ahead_state(struct sail_io *io, size_t block_size, unsigned blocks,
+                                               struct io_read_ahead_state **io_read_ahead_state) {
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct io_read_ahead_state), &ptr));
+    struct io_read_ahead_state *io_read_ahead_state_local = ptr;
+
+    memset(io_read_ahead_state_local, 0, sizeof(struct io_read_ahead_state));
+
+    io_read_ahead_state_local->io           = io;
+    io_read_ahead_state_local->block_size   = block_size;
+    io_read_ahead_state_local->blocks_count = blocks;
+
+    SAIL_TRY_OR_CLEANUP(io->tell(io->stream, &io_read_ahead_state_local->pos),
+                        /* cleanup */ destroy_io_read_ahead_state(io_read_ahead_state_local));
+    SAIL_TRY_OR_CLEANUP(sail_io_size(io, &io_read_ahead_state_local->size),
+                        /* cleanup */ destroy_io_read_ahead_state(io_read_ahead_state_local));
+
+    io_read_ahead_state_local->size       += io_read_ahead_state_local->pos;
+    io_read_ahead_state_local->io_pos      = io_read_ahead_state_local->pos;
+    io_read_ahead_state_local->next_offset = io_read_ahead_state_local->pos;
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(block_size * blocks, &ptr),
+                        /* cleanup */ destroy_io_read_ahead_state(io_read_ahead_state_local));
+    io_read_ahead_state_local->blocks_data = ptr;
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct io_read_ahead_block) * blocks, &ptr),
+                        /* cleanup */ destroy_io_read_ahead_state(io_read_ahead_state_local));
+    io_read_ahead_state_local->blocks = ptr;
+
+    for (unsigned i = 0; i < blocks; i++) {
+        io_read_ahead_state_local->blocks[i].data   = io_read_ahead_state_local->blocks_data + i * block_size;
+        io_read_ahead_state_local->blocks[i].offset = 0;
+        io_read_ahead_state_local->blocks[i].length = 0;
+        io_read_ahead_state_local->blocks[i].status = SAIL_OK;
+    }
+
+    *io_read_ahead_state = io_read_ahead_state_local;
+
+    return SAIL_OK;
+}
+
+#ifdef SAIL_THREAD_SAFE
+static sail_status_t start_read_ahead_thread(struct io_read_ahead_state *io_read_ahead_state) {
+
+    SAIL_TRY(threading_init_mutex(&io_read_ahead_state->mutex));
+
+    SAIL_TRY_OR_CLEANUP(threading_init_cond(&io_read_ahead_state->filled_cond),
+                        /* cleanup */ threading_destroy_mutex(&io_read_ahead_state->mutex));
+
+    SAIL_TRY_OR_CLEANUP(threading_init_cond(&io_read_ahead_state->free_cond),
+                        /* cleanup */ threading_destroy_cond(&io_read_ahead_state->filled_cond),
+                                      threading_destroy_mutex(&io_read_ahead_state->mutex));
+
+    SAIL_TRY_OR_CLEANUP(threading_create_thread(&io_read_ahead_state->thread, read_ahead_routine, io_read_ahead_state),
+                        /* cleanup */ threading_destroy_cond(&io_read_ahead_state->free_cond),
+                                      threading_destroy_cond(&io_read_ahead_state->filled_cond),
+                                      threading_destroy_mutex(&io_read_ahead_state->mutex));
+
+    return SAIL_OK;
+}
+#endif
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_alloc_io_read_ahead(struct sail_io *io, size_t block_size, unsigned blocks,
+                                       struct sail_io **read_ahead_io) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(read_ahead_io);
+
+    if ((io->features & SAIL_IO_FEATURE_SEEKABLE) == 0) {
+        SAIL_LOG_ERROR("Read-ahead I/O requires a seekable I/O object");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_IO);
+    }
+
+    if (block_size == 0) {
+        block_size = SAIL_IO_READ_AHEAD_DEFAULT_BLOCK_SIZE;
+    }
+    if (blocks == 0) {
+        blocks = SAIL_IO_READ_AHEAD_DEFAULT_BLOCKS;
+    }
+
+    struct io_read_ahead_state *io_read_ahead_state;
+    SAIL_TRY(alloc_io_read_ahead_state(io, block_size, blocks, &io_read_ahead_state));
+
+    struct sail_io *read_ahead_io_local;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io(&read_ahead_io_local),
+                        /* cleanup */ destroy_io_read_ahead_state(io_read_ahead_state));
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY_OR_CLEANUP(start_read_ahead_thread(io_read_ahead_state),
+                        /* cleanup */ sail_destroy_io(read_ahead_io_local),
+                                      destroy_io_read_ahead_state(io_read_ahead_state));
+#endif
+
+    read_ahead_io_local->features       = SAIL_IO_FEATURE_SEEKABLE;
+    read_ahead_io_local->stream         = io_read_ahead_state;
+    read_ahead_io_local->tolerant_read  = io_read_ahead_tolerant_read;
+    read_ahead_io_local->strict_read    = io_read_ahead_strict_read;
+    read_ahead_io_local->tolerant_write = sail_io_noop_tolerant_write;
+    read_ahead_io_local->strict_write   = sail_io_noop_strict_write;
+    read_ahead_io_local->seek           = io_read_ahead_seek;
+    read_ahead_io_local->tell           = io_read_ahead_tell;
+    read_ahead_io_local->flush          = sail_io_noop_flush;
+    read_ahead_io_local->close          = io_read_ahead_close;
+    read_ahead_io_local->eof            = io_read_ahead_eof;
+
+    *read_ahead_io = read_ahead_io_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_alloc_io_read_ahead_file(const char *path, struct sail_io **io) {
+
+    SAIL_CHECK_PTR(io);
+
+    struct sail_io *file_io;
+    SAIL_TRY(sail_alloc_io_read_file(path, &file_io));
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io_read_ahead(file_io, 0, 0, io),
+                        /* cleanup */ sail_destroy_io(file_io));
+
+    return SAIL_OK;
+}
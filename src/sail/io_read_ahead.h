@@ -0,0 +1,83 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_IO_READ_AHEAD_H
+#define SAIL_IO_READ_AHEAD_H
+
+#include <stddef.h> /* size_t */
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_io;
+
+/* Default size of a single read-ahead block in bytes. */
+#define SAIL_IO_READ_AHEAD_DEFAULT_BLOCK_SIZE (256 * 1024)
+
+/* Default number of read-ahead blocks. */
+#define SAIL_IO_READ_AHEAD_DEFAULT_BLOCKS 4
+
+/*
+ * Allocates a new read-only I/O object that prefetches the specified seekable I/O object
+ * in the background. Up to 'blocks' blocks of 'block_size' bytes ahead of the current position
+ * are read by a helper thread while the codec decodes the data already read, so storage latency
+ * and decoding overlap. Pass 0 to use SAIL_IO_READ_AHEAD_DEFAULT_BLOCK_SIZE and
+ * SAIL_IO_READ_AHEAD_DEFAULT_BLOCKS. Seeking outside of the prefetched data discards it
+ * and restarts prefetching from the new position.
+ *
+ * The new I/O object takes the ownership of 'io' on success and closes it when it's closed itself.
+ * 'io' MUST NOT be used directly afterwards. When SAIL is compiled without SAIL_THREAD_SAFE,
+ * the blocks are read synchronously on demand.
+ *
+ * Typical usage: sail_alloc_io_read_file()           ->
+ *                sail_alloc_io_read_ahead()          ->
+ *                sail_start_loading_from_io()        ->
+ *                sail_load_next_frame()              ->
+ *                sail_stop_loading()                 ->
+ *                sail_destroy_io().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_io_read_ahead(struct sail_io *io, size_t block_size, unsigned blocks,
+                                                   struct sail_io **read_ahead_io);
+
+/*
+ * Opens the specified image file for reading and allocates a new read-ahead I/O object
+ * for it with the default block size and number of blocks. See sail_alloc_io_read_ahead().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_io_read_ahead_file(const char *path, struct sail_io **io);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
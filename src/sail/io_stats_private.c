@@ -0,0 +1,216 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
+
+#include <sail/sail.h>
+
+struct io_stats_state {
+
+    /* Underlying I/O object. Not owned. */
+    struct sail_io *io;
+    struct sail_stats *stats;
+};
+
+/*
+ * Private functions.
+ */
+
+static sail_status_t io_stats_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
+
+    struct io_stats_state *io_stats_state = stream;
+    struct sail_io *io = io_stats_state->io;
+
+    const sail_status_t status = io->tolerant_read(io->stream, buf, size_to_read, read_size);
+
+    io_stats_state->stats->read_calls++;
+    if (status == SAIL_OK) {
+        io_stats_state->stats->bytes_read += *read_size;
+    }
+
+    return status;
+}
+
+static sail_status_t io_stats_strict_read(void *stream, void *buf, size_t size_to_read) {
+
+    struct io_stats_state *io_stats_state = stream;
+    struct sail_io *io = io_stats_state->io;
+
+    const sail_status_t status = io->strict_read(io->stream, buf, size_to_read);
+
+    io_stats_state->stats->read_calls++;
+    if (status == SAIL_OK) {
+        io_stats_state->stats->bytes_read += size_to_read;
+    }
+
+    return status;
+}
+
+static sail_status_t io_stats_tolerant_write(void *stream, const void *buf, size_t size_to_write, size_t *written_size) {
+
+    struct io_stats_state *io_stats_state = stream;
+    struct sail_io *io = io_stats_state->io;
+
+    const sail_status_t status = io->tolerant_write(io->stream, buf, size_to_write, written_size);
+
+    io_stats_state->stats->write_calls++;
+    if (status == SAIL_OK) {
+        io_stats_state->stats->bytes_written += *written_size;
+    }
+
+    return status;
+}
+
+static sail_status_t io_stats_strict_write(void *stream, const void *buf, size_t size_to_write) {
+
+    struct io_stats_state *io_stats_state = stream;
+    struct sail_io *io = io_stats_state->io;
+
+    const sail_status_t status = io->strict_write(io->stream, buf, size_to_write);
+
+    io_stats_state->stats->write_calls++;
+    if (status == SAIL_OK) {
+        io_stats_state->stats->bytes_written += size_to_write;
+    }
+
+    return status;
+}
+
+static sail_status_t io_stats_strict_write_vectored(void *stream, const struct sail_io_vector *vectors, size_t vectors_count) {
+
+    struct io_stats_state *io_stats_state = stream;
+    struct sail_io *io = io_stats_state->io;
+
+    const sail_status_t status = io->strict_write_vectored(io->stream, vectors, vectors_count);
+
+    io_stats_state->stats->write_calls++;
+    if (status == SAIL_OK) {
+        for (size_t i = 0; i < vectors_count; i++) {
+            io_stats_state->stats->bytes_written += vectors[i].size;
+        }
+    }
+
+    return status;
+}
+
+static sail_status_t io_stats_seek(void *stream, long offset, int whence) {
+
+    struct io_stats_state *io_stats_state = stream;
+    struct sail_io *io = io_stats_state->io;
+
+    io_stats_state->stats->seek_calls++;
+
+    return io->seek(io->stream, offset, whence);
+}
+
+static sail_status_t io_stats_tell(void *stream, size_t *offset) {
+
+    struct io_stats_state *io_stats_state = stream;
+    struct sail_io *io = io_stats_state->io;
+
+    return io->tell(io->stream, offset);
+}
+
+static sail_status_t io_stats_flush(void *stream) {
+
+    struct io_stats_state *io_stats_state = stream;
+    struct sail_io *io = io_stats_state->io;
+
+    return io->flush(io->stream);
+}
+
+static sail_status_t io_stats_close(void *stream) {
+
+    /* The underlying I/O object is not owned. */
+    sail_free(stream);
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_stats_eof(void *stream, bool *result) {
+
+    struct io_stats_state *io_stats_state = stream;
+    struct sail_io *io = io_stats_state->io;
+
+    return io->eof(io->stream, result);
+}
+
+static sail_status_t io_stats_map(void *stream, const void **data, size_t *size) {
+
+    struct io_stats_state *io_stats_state = stream;
+    struct sail_io *io = io_stats_state->io;
+
+    return io->map(io->stream, data, size);
+}
+
+static sail_status_t io_stats_will_need(void *stream, size_t offset, size_t length) {
+
+    struct io_stats_state *io_stats_state = stream;
+    struct sail_io *io = io_stats_state->io;
+
+    return io->will_need(io->stream, offset, length);
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t alloc_io_stats(struct sail_io *io, struct sail_stats *stats, struct sail_io **stats_io) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(stats);
+    SAIL_CHECK_PTR(stats_io);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct io_stats_state), &ptr));
+    struct io_stats_state *io_stats_state = ptr;
+
+    io_stats_state->io    = io;
+    io_stats_state->stats = stats;
+
+    struct sail_io *stats_io_local;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io(&stats_io_local),
+                        /* cleanup */ sail_free(io_stats_state));
+
+    stats_io_local->features              = io->features;
+    stats_io_local->stream                = io_stats_state;
+    stats_io_local->tolerant_read         = io_stats_tolerant_read;
+    stats_io_local->strict_read           = io_stats_strict_read;
+    stats_io_local->tolerant_write        = io_stats_tolerant_write;
+    stats_io_local->strict_write          = io_stats_strict_write;
+    stats_io_local->seek                  = io_stats_seek;
+    stats_io_local->tell                  = io_stats_tell;
+    stats_io_local->flush                 = io_stats_flush;
+    stats_io_local->close                 = io_stats_close;
+    stats_io_local->eof                   = io_stats_eof;
+    stats_io_local->map                   = (io->map == NULL) ? NULL : io_stats_map;
+    stats_io_local->strict_write_vectored = (io->strict_write_vectored == NULL) ? NULL : io_stats_strict_write_vectored;
+    stats_io_local->will_need             = (io->will_need == NULL) ? NULL : io_stats_will_need;
+
+    *stats_io = stats_io_local;
+
+    return SAIL_OK;
+}
@@ -0,0 +1,379 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
+#include <stdio.h>
+#include <string.h>
+
+#ifdef SAIL_WIN32
+    /* _setmode */
+    #include <fcntl.h>
+    #include <io.h>
+#endif
+
+#include <sail/sail.h>
+
+struct io_stream_state {
+    struct sail_io *io;
+
+    /* The first bytes of the stream read so far. */
+    unsigned char prefix[SAIL_IO_STREAM_PREFIX_SIZE];
+    size_t prefix_length;
+
+    size_t pos;
+    bool eof;
+};
+
+/*
+ * Private functions.
+ */
+
+/* Reads the next bytes from the underlying I/O object. Sets the EOF flag when nothing is read. */
+static sail_status_t read_from_source(struct io_stream_state *io_stream_state, void *buf, size_t size_to_read, size_t *read_size) {
+
+    struct sail_io *io = io_stream_state->io;
+
+    *read_size = 0;
+
+    if (io_stream_state->eof) {
+        return SAIL_OK;
+    }
+
+    const sail_status_t status = io->tolerant_read(io->stream, buf, size_to_read, read_size);
+
+    /* The memory I/O reports EOF as an error. */
+    if (status == SAIL_ERROR_EOF || (status == SAIL_OK && *read_size == 0)) {
+        *read_size = 0;
+        io_stream_state->eof = true;
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_stream_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(read_size);
+
+    struct io_stream_state *io_stream_state = stream;
+    unsigned char *buf_ptr = buf;
+
+    *read_size = 0;
+
+    /* Pipes and sockets return short reads, so read until the buffer is full or EOF. */
+    while (size_to_read > 0) {
+        size_t chunk;
+
+        if (io_stream_state->pos < io_stream_state->prefix_length) {
+            /* Replay the prefix. */
+            const size_t available = io_stream_state->prefix_length - io_stream_state->pos;
+            chunk = (size_to_read < available) ? size_to_read : available;
+
+            memcpy(buf_ptr, io_stream_state->prefix + io_stream_state->pos, chunk);
+        } else if (io_stream_state->prefix_length < SAIL_IO_STREAM_PREFIX_SIZE) {
+            /* Fill the prefix. */
+            size_t prefix_read_size;
+            SAIL_TRY(read_from_source(io_stream_state,
+                                      io_stream_state->prefix + io_stream_state->prefix_length,
+                                      SAIL_IO_STREAM_PREFIX_SIZE - io_stream_state->prefix_length,
+                                      &prefix_read_size));
+
+            if (prefix_read_size == 0) {
+                break;
+            }
+
+            io_stream_state->prefix_length += prefix_read_size;
+            continue;
+        } else {
+            SAIL_TRY(read_from_source(io_stream_state, buf_ptr, size_to_read, &chunk));
+
+            if (chunk == 0) {
+                break;
+            }
+        }
+
+        buf_ptr               += chunk;
+        size_to_read          -= chunk;
+        *read_size            += chunk;
+        io_stream_state->pos  += chunk;
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_stream_strict_read(void *stream, void *buf, size_t size_to_read) {
+
+    size_t read_size;
+
+    SAIL_TRY(io_stream_tolerant_read(stream, buf, size_to_read, &read_size));
+
+    if (read_size != size_to_read) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_stream_seek(void *stream, long offset, int whence) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct io_stream_state *io_stream_state = stream;
+
+    long base;
+
+    switch (whence) {
+        case SEEK_SET: base = 0;                           break;
+        case SEEK_CUR: base = (long)io_stream_state->pos;  break;
+
+        case SEEK_END: {
+            SAIL_LOG_ERROR("Streams cannot seek relative to the end");
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+        }
+        default: {
+            SAIL_LOG_ERROR("Invalid seek whence %d", whence);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+        }
+    }
+
+    if (base + offset < 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+    }
+
+    const size_t target = (size_t)(base + offset);
+
+    if (target < io_stream_state->pos) {
+        /* Seek back within the prefix if it's not passed yet. */
+        if (io_stream_state->pos > io_stream_state->prefix_length) {
+            SAIL_LOG_ERROR("Streams cannot seek back past the first %u bytes", (unsigned)SAIL_IO_STREAM_PREFIX_SIZE);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+        }
+
+        io_stream_state->pos = target;
+        return SAIL_OK;
+    }
+
+    /* Skip forward by reading. */
+    unsigned char buffer[4096];
+
+    while (io_stream_state->pos < target) {
+        const size_t remaining = target - io_stream_state->pos;
+
+        size_t read_size;
+        SAIL_TRY(io_stream_tolerant_read(stream, buffer, (remaining < sizeof(buffer)) ? remaining : sizeof(buffer), &read_size));
+
+        if (read_size == 0) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+        }
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_stream_tell(void *stream, size_t *offset) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(offset);
+
+    const struct io_stream_state *io_stream_state = stream;
+
+    *offset = io_stream_state->pos;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_stream_eof(void *stream, bool *result) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(result);
+
+    struct io_stream_state *io_stream_state = stream;
+
+    if (io_stream_state->pos < io_stream_state->prefix_length) {
+        *result = false;
+        return SAIL_OK;
+    }
+
+    /* Peek the next byte into the prefix while it's not full. */
+    if (io_stream_state->prefix_length < SAIL_IO_STREAM_PREFIX_SIZE) {
+        size_t read_size;
+        SAIL_TRY(read_from_source(io_stream_state,
+                                  io_stream_state->prefix + io_stream_state->prefix_length,
+                                  SAIL_IO_STREAM_PREFIX_SIZE - io_stream_state->prefix_length,
+                                  &read_size));
+
+        io_stream_state->prefix_length += read_size;
+
+        *result = (read_size == 0);
+        return SAIL_OK;
+    }
+
+    if (io_stream_state->eof) {
+        *result = true;
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(io_stream_state->io->eof(io_stream_state->io->stream, result));
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_stream_close(void *stream) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct io_stream_state *io_stream_state = stream;
+
+    struct sail_io *io = io_stream_state->io;
+    const sail_status_t status = io->close(io->stream);
+
+    /* Avoid closing the stream twice. */
+    io->stream = NULL;
+    sail_destroy_io(io);
+
+    sail_free(io_stream_state);
+
+    return status;
+}
+
+static sail_status_t io_stdin_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
+
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(read_size);
+
+    *read_size = fread(buf, 1, size_to_read, stream);
+
+    if (*read_size == 0 && ferror((FILE *)stream)) {
+        sail_print_errno("Failed to read the standard input: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_stdin_strict_read(void *stream, void *buf, size_t size_to_read) {
+
+    size_t read_size;
+
+    SAIL_TRY(io_stdin_tolerant_read(stream, buf, size_to_read, &read_size));
+
+    if (read_size != size_to_read) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_stdin_eof(void *stream, bool *result) {
+
+    SAIL_CHECK_PTR(result);
+
+    *result = feof((FILE *)stream) != 0;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_stdin_close(void *stream) {
+
+    /* The standard input is not owned. */
+    (void)stream;
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_alloc_io_read_stream(struct sail_io *io, struct sail_io **stream_io) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(stream_io);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct io_stream_state), &ptr));
+    struct io_stream_state *io_stream_state = ptr;
+
+    io_stream_state->io            = io;
+    io_stream_state->prefix_length = 0;
+    io_stream_state->pos           = 0;
+    io_stream_state->eof           = false;
+
+    struct sail_io *stream_io_local;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io(&stream_io_local),
+                        /* cleanup */ sail_free(io_stream_state));
+
+    stream_io_local->features       = SAIL_IO_FEATURE_STREAMING;
+    stream_io_local->stream         = io_stream_state;
+    stream_io_local->tolerant_read  = io_stream_tolerant_read;
+    stream_io_local->strict_read    = io_stream_strict_read;
+    stream_io_local->tolerant_write = sail_io_noop_tolerant_write;
+    stream_io_local->strict_write   = sail_io_noop_strict_write;
+    stream_io_local->seek           = io_stream_seek;
+    stream_io_local->tell           = io_stream_tell;
+    stream_io_local->flush          = sail_io_noop_flush;
+    stream_io_local->close          = io_stream_close;
+    stream_io_local->eof            = io_stream_eof;
+
+    *stream_io = stream_io_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_alloc_io_read_stdin(struct sail_io **io) {
+
+    SAIL_CHECK_PTR(io);
+
+#ifdef SAIL_WIN32
+    if (_setmode(_fileno(stdin), _O_BINARY) == -1) {
+        sail_print_errno("Failed to switch the standard input to the binary mode: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_OPEN_FILE);
+    }
+#endif
+
+    struct sail_io *stdin_io;
+    SAIL_TRY(sail_alloc_io(&stdin_io));
+
+    stdin_io->stream         = stdin;
+    stdin_io->tolerant_read  = io_stdin_tolerant_read;
+    stdin_io->strict_read    = io_stdin_strict_read;
+    stdin_io->tolerant_write = sail_io_noop_tolerant_write;
+    stdin_io->strict_write   = sail_io_noop_strict_write;
+    stdin_io->seek           = sail_io_noop_seek;
+    stdin_io->tell           = sail_io_noop_tell;
+    stdin_io->flush          = sail_io_noop_flush;
+    stdin_io->close          = io_stdin_close;
+    stdin_io->eof            = io_stdin_eof;
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io_read_stream(stdin_io, io),
+                        /* cleanup */ sail_destroy_io(stdin_io));
+
+    return SAIL_OK;
+}
@@ -0,0 +1,71 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_IO_STREAM_H
+#define SAIL_IO_STREAM_H
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_io;
+
+/* Number of first bytes of a stream kept in memory to seek back to. */
+#define SAIL_IO_STREAM_PREFIX_SIZE 4096
+
+/*
+ * Allocates a new forward-only I/O object with the SAIL_IO_FEATURE_STREAMING feature
+ * that reads the specified non-seekable I/O object, for example, a pipe or a socket.
+ * Only the read callbacks of 'io' are used.
+ *
+ * The first SAIL_IO_STREAM_PREFIX_SIZE bytes are kept in memory, so magic number detection
+ * can seek back to the beginning. Codecs that read forward only, like PNG, JPEG, GIF, or QOI,
+ * load images from the new I/O object directly with constant memory. Codecs that need to seek
+ * backward or to the end fail with SAIL_ERROR_SEEK_IO or SAIL_ERROR_NOT_IMPLEMENTED.
+ *
+ * The new I/O object takes the ownership of 'io' on success and closes it when it's closed itself.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_io_read_stream(struct sail_io *io, struct sail_io **stream_io);
+
+/*
+ * Allocates a new forward-only I/O object that reads the standard input. See sail_alloc_io_read_stream().
+ * The standard input is switched to the binary mode on Windows and is not closed when the I/O object
+ * is closed.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_io_read_stdin(struct sail_io **io);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -120,6 +120,111 @@ sail_status_t SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_seek_next_frame_v8)(void
  */
 sail_status_t SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_frame_v8)(void *state, struct sail_image *image);
 
+/*
+ * Optional. Must be implemented only by codecs with the SEEK load feature.
+ *
+ * Positions the decoder so the next call to sail_codec_load_seek_next_frame_v8() seeks to the frame
+ * with the specified zero-based index. The frame is NOT loaded or decoded. Frames can be sought
+ * in any order, including backwards.
+ *
+ * libsail, the caller of this function, guarantees the following:
+ *   - The state points to the state allocated by sail_codec_load_init_v8().
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NO_MORE_FRAMES when the frame doesn't exist.
+ */
+sail_status_t SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_seek_frame_v8)(void *state, unsigned frame);
+
+/*
+ * Optional. Must be implemented only by codecs with the RESET load feature.
+ *
+ * Starts loading a new image from the specified I/O object as if the state was allocated
+ * by sail_codec_load_init_v8() with the same load options. The underlying decoder is reused,
+ * so it's not set up again for every image.
+ *
+ * libsail, the caller of this function, guarantees the following:
+ *   - The state points to the state allocated by sail_codec_load_init_v8().
+ *   - The I/O object is valid.
+ *
+ * This function MUST:
+ *   - Stop using the previous I/O object.
+ *   - Keep the state valid for sail_codec_load_finish_v8() on error.
+ *
+ * Returns SAIL_OK on success.
+ */
+sail_status_t SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_reset_v8)(void *state, struct sail_io *io);
+
+/*
+ * Optional. Must be implemented only by codecs with the PUSH load feature.
+ *
+ * Starts incremental loading. Unlike sail_codec_load_init_v8(), the state doesn't read from an I/O
+ * object. Instead, libsail offers the data as it arrives to sail_codec_load_push_seek_next_frame_v8()
+ * and sail_codec_load_push_frame_v8(). The state is destroyed with sail_codec_load_finish_v8().
+ *
+ * libsail, the caller of this function, guarantees the following:
+ *   - The load options are valid.
+ *
+ * This function MUST:
+ *   - Allocate the state even on error, so it's destroyed with sail_codec_load_finish_v8().
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NOT_IMPLEMENTED when the load options can't be honored incrementally.
+ * libsail then loads the image with sail_codec_load_init_v8() instead.
+ */
+sail_status_t SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_push_init_v8)(const struct sail_load_options *load_options, void **state);
+
+/*
+ * Optional. Must be implemented only by codecs with the PUSH load feature.
+ *
+ * Decodes the next frame header from the offered data like sail_codec_load_seek_next_frame_v8() does.
+ *
+ * libsail, the caller of this function, guarantees the following:
+ *   - The state points to the state allocated by sail_codec_load_push_init_v8().
+ *   - The data starts with the first byte not consumed by the previous call.
+ *   - The end flag is set when no more data will ever be offered.
+ *
+ * This function MUST:
+ *   - Set consumed to the number of bytes it doesn't need to be offered again.
+ *   - Not block and not return SAIL_ERROR_NEED_MORE_DATA when the end flag is set.
+ *   - Allocate the image the same way sail_codec_load_seek_next_frame_v8() does.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NEED_MORE_DATA when more data is needed to decode the header.
+ * Returns SAIL_ERROR_NO_MORE_FRAMES when no more frames are available.
+ * Returns SAIL_ERROR_NOT_IMPLEMENTED when the image can't be loaded incrementally. libsail then
+ * loads it with sail_codec_load_init_v8() from the start. Valid only for the first frame.
+ */
+sail_status_t SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_push_seek_next_frame_v8)(void *state,
+                                                                                 const void *data, size_t size, bool end,
+                                                                                 size_t *consumed,
+                                                                                 struct sail_image **image);
+
+/*
+ * Optional. Must be implemented only by codecs with the PUSH load feature.
+ *
+ * Decodes the frame rows available in the offered data. The image pixels are pre-allocated
+ * and zeroed by libsail. Rows are written with the packed stride, i.e. bytes per line.
+ *
+ * libsail, the caller of this function, guarantees the following:
+ *   - The state points to the state allocated by sail_codec_load_push_init_v8().
+ *   - The image points to the image allocated by sail_codec_load_push_seek_next_frame_v8().
+ *   - The data starts with the first byte not consumed by the previous call.
+ *   - The end flag is set when no more data will ever be offered.
+ *
+ * This function MUST:
+ *   - Set consumed to the number of bytes it doesn't need to be offered again.
+ *   - Set first_row and rows_count to the range of rows updated by this call, or zero rows.
+ *   - Not block and not return SAIL_ERROR_NEED_MORE_DATA when the end flag is set.
+ *
+ * Returns SAIL_OK when the frame is completely decoded.
+ * Returns SAIL_ERROR_NEED_MORE_DATA when more data is needed to finish the frame.
+ */
+sail_status_t SAIL_CONSTRUCT_CODEC_FUNC(sail_codec_load_push_frame_v8)(void *state,
+                                                                       const void *data, size_t size, bool end,
+                                                                       size_t *consumed,
+                                                                       struct sail_image *image,
+                                                                       unsigned *first_row, unsigned *rows_count);
+
 /*
  * Finilizes loading operation. No more loadings are possible after calling this function.
  * This function doesn't close the io stream. It just stops decoding. Use io->close() or sail_destroy_io()
@@ -34,9 +34,18 @@
 
 typedef sail_status_t (*sail_codec_load_init_v8_t)(struct sail_io *io, const struct sail_load_options *load_options, void **state);
 typedef sail_status_t (*sail_codec_load_seek_next_frame_v8_t)(void *state, struct sail_image **image);
+typedef sail_status_t (*sail_codec_load_seek_frame_v8_t)(void *state, unsigned frame);
+typedef sail_status_t (*sail_codec_load_reset_v8_t)(void *state, struct sail_io *io);
 typedef sail_status_t (*sail_codec_load_frame_v8_t)(void *state, struct sail_image *image);
 typedef sail_status_t (*sail_codec_load_finish_v8_t)(void **state);
 
+typedef sail_status_t (*sail_codec_load_push_init_v8_t)(const struct sail_load_options *load_options, void **state);
+typedef sail_status_t (*sail_codec_load_push_seek_next_frame_v8_t)(void *state, const void *data, size_t size, bool end,
+                                                                   size_t *consumed, struct sail_image **image);
+typedef sail_status_t (*sail_codec_load_push_frame_v8_t)(void *state, const void *data, size_t size, bool end,
+                                                         size_t *consumed, struct sail_image *image,
+                                                         unsigned *first_row, unsigned *rows_count);
+
 /*
  * Encoding functions.
  */
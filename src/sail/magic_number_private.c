@@ -0,0 +1,255 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+/*
+ * Private functions.
+ */
+
+static bool hex_digit_to_value(char c, unsigned char *value) {
+
+    if (c >= '0' && c <= '9') {
+        *value = (unsigned char)(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+        *value = (unsigned char)(c - 'a' + 10);
+    } else if (c >= 'A' && c <= 'F') {
+        *value = (unsigned char)(c - 'A' + 10);
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Compiles "ab cd ?? ef" into bytes and masks. "??" matches any byte.
+ */
+static sail_status_t compile_magic_number(const char *str, struct sail_magic_number *magic_number) {
+
+    memset(magic_number->bytes, 0, sizeof(magic_number->bytes));
+    memset(magic_number->mask,  0, sizeof(magic_number->mask));
+    magic_number->length     = 0;
+    magic_number->confidence = 0;
+
+    while (*str != '\0') {
+        if (*str == ' ') {
+            str++;
+            continue;
+        }
+
+        if (magic_number->length >= SAIL_MAGIC_BUFFER_SIZE || str[1] == '\0' || (str[2] != ' ' && str[2] != '\0')) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_PARSE_FILE);
+        }
+
+        if (str[0] == '?' && str[1] == '?') {
+            /* Wildcard. Keep the zero mask. */
+        } else {
+            unsigned char high;
+            unsigned char low;
+
+            if (!hex_digit_to_value(str[0], &high) || !hex_digit_to_value(str[1], &low)) {
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_PARSE_FILE);
+            }
+
+            magic_number->bytes[magic_number->length] = (unsigned char)((high << 4) | low);
+            magic_number->mask[magic_number->length]  = 0xFF;
+            magic_number->confidence++;
+        }
+
+        magic_number->length++;
+        str += 2;
+    }
+
+    if (magic_number->length == 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_PARSE_FILE);
+    }
+
+    return SAIL_OK;
+}
+
+static bool magic_number_matches(const struct sail_magic_number *magic_number, const unsigned char *buffer) {
+
+    for (size_t i = 0; i < magic_number->length; i++) {
+        if ((buffer[i] & magic_number->mask[i]) != magic_number->bytes[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t alloc_magic_number_matcher(const struct sail_codec_bundle_node *codec_bundle_node,
+                                          struct sail_magic_number_matcher **matcher) {
+
+    SAIL_CHECK_PTR(matcher);
+
+    /* Count the number of magic numbers. */
+    size_t magic_numbers_max_length = 0;
+
+    for (const struct sail_codec_bundle_node *node = codec_bundle_node; node != NULL; node = node->next) {
+        for (const struct sail_string_node *magic_number_node = node->codec_bundle->codec_info->magic_number_node;
+                magic_number_node != NULL; magic_number_node = magic_number_node->next) {
+            magic_numbers_max_length++;
+        }
+    }
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_magic_number_matcher), &ptr));
+    struct sail_magic_number_matcher *matcher_local = ptr;
+
+    matcher_local->magic_numbers        = NULL;
+    matcher_local->magic_numbers_length = 0;
+    matcher_local->indexes              = NULL;
+    memset(matcher_local->offsets, 0, sizeof(matcher_local->offsets));
+
+    if (magic_numbers_max_length == 0) {
+        *matcher = matcher_local;
+        return SAIL_OK;
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct sail_magic_number) * magic_numbers_max_length, &ptr),
+                        /* cleanup */ destroy_magic_number_matcher(matcher_local));
+    matcher_local->magic_numbers = ptr;
+
+    /* Compile. */
+    for (const struct sail_codec_bundle_node *node = codec_bundle_node; node != NULL; node = node->next) {
+        const struct sail_codec_info *codec_info = node->codec_bundle->codec_info;
+
+        for (const struct sail_string_node *magic_number_node = codec_info->magic_number_node;
+                magic_number_node != NULL; magic_number_node = magic_number_node->next) {
+            struct sail_magic_number *magic_number = matcher_local->magic_numbers + matcher_local->magic_numbers_length;
+
+            SAIL_TRY_OR_EXECUTE(compile_magic_number(magic_number_node->string, magic_number),
+                                /* on error */ SAIL_LOG_ERROR("Failed to compile %s magic number '%s'. Skipping it",
+                                                                codec_info->name, magic_number_node->string);
+                                               continue);
+
+            magic_number->codec_info = codec_info;
+            matcher_local->magic_numbers_length++;
+        }
+    }
+
+    /* Count the candidates for every first byte. Magic numbers starting with a wildcard match every byte. */
+    size_t indexes_length = 0;
+
+    for (unsigned byte = 0; byte < 256; byte++) {
+        for (size_t i = 0; i < matcher_local->magic_numbers_length; i++) {
+            const struct sail_magic_number *magic_number = matcher_local->magic_numbers + i;
+
+            if ((byte & magic_number->mask[0]) == magic_number->bytes[0]) {
+                indexes_length++;
+            }
+        }
+    }
+
+    if (indexes_length > 0) {
+        SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(unsigned) * indexes_length, &ptr),
+                            /* cleanup */ destroy_magic_number_matcher(matcher_local));
+        matcher_local->indexes = ptr;
+    }
+
+    /* Build the first byte dispatch table preserving the priority order. */
+    size_t offset = 0;
+
+    for (unsigned byte = 0; byte < 256; byte++) {
+        matcher_local->offsets[byte] = offset;
+
+        for (size_t i = 0; i < matcher_local->magic_numbers_length; i++) {
+            const struct sail_magic_number *magic_number = matcher_local->magic_numbers + i;
+
+            if ((byte & magic_number->mask[0]) == magic_number->bytes[0]) {
+                matcher_local->indexes[offset++] = (unsigned)i;
+            }
+        }
+    }
+
+    matcher_local->offsets[256] = offset;
+
+    *matcher = matcher_local;
+
+    return SAIL_OK;
+}
+
+void destroy_magic_number_matcher(struct sail_magic_number_matcher *matcher) {
+
+    if (matcher == NULL) {
+        return;
+    }
+
+    sail_free(matcher->magic_numbers);
+    sail_free(matcher->indexes);
+    sail_free(matcher);
+}
+
+sail_status_t magic_number_matcher_find(const struct sail_magic_number_matcher *matcher,
+                                         const unsigned char *buffer, size_t buffer_size,
+                                         const struct sail_codec_info **codec_info,
+                                         unsigned *confidence) {
+
+    SAIL_CHECK_PTR(matcher);
+    SAIL_CHECK_PTR(buffer);
+    SAIL_CHECK_PTR(codec_info);
+
+    if (buffer_size == 0) {
+        return SAIL_ERROR_CODEC_NOT_FOUND;
+    }
+
+    const struct sail_magic_number *best_magic_number = NULL;
+
+    /*
+     * Candidates are in priority order, so a less prioritized codec wins only when its magic number
+     * is strictly more specific. For example, a RIFF container matched by "52 49 46 46 ?? ?? ?? ?? 57 45 42 50"
+     * wins over a codec matching just "52 49 46 46".
+     */
+    for (size_t i = matcher->offsets[buffer[0]]; i < matcher->offsets[buffer[0] + 1]; i++) {
+        const struct sail_magic_number *magic_number = matcher->magic_numbers + matcher->indexes[i];
+
+        if (magic_number->length <= buffer_size && magic_number_matches(magic_number, buffer)) {
+            if (best_magic_number == NULL || magic_number->confidence > best_magic_number->confidence) {
+                best_magic_number = magic_number;
+            }
+        }
+    }
+
+    if (best_magic_number == NULL) {
+        return SAIL_ERROR_CODEC_NOT_FOUND;
+    }
+
+    *codec_info = best_magic_number->codec_info;
+
+    if (confidence != NULL) {
+        *confidence = best_magic_number->confidence;
+    }
+
+    return SAIL_OK;
+}
@@ -0,0 +1,99 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_MAGIC_NUMBER_PRIVATE_H
+#define SAIL_MAGIC_NUMBER_PRIVATE_H
+
+#include <stddef.h> /* size_t */
+
+#include <sail-common/config.h>
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_codec_bundle_node;
+struct sail_codec_info;
+
+/*
+ * A single magic number compiled from a codec info string like "ff d8" or "?? ?? 66 74".
+ * Wildcard bytes have zero masks and zero bytes.
+ */
+struct sail_magic_number {
+
+    /* Shallow pointer to the codec info the magic number belongs to. */
+    const struct sail_codec_info *codec_info;
+
+    unsigned char bytes[SAIL_MAGIC_BUFFER_SIZE];
+    unsigned char mask[SAIL_MAGIC_BUFFER_SIZE];
+
+    /* Number of bytes including wildcards. */
+    size_t length;
+
+    /* Number of non-wildcard bytes. The more bytes match, the more specific the magic number is. */
+    unsigned confidence;
+};
+
+/*
+ * Magic numbers of all the enumerated codecs compiled into byte+mask arrays.
+ * Candidates are dispatched by the first byte of the image magic: indexes[offsets[byte] .. offsets[byte+1])
+ * point to the magic numbers that may match, in codec priority order.
+ */
+struct sail_magic_number_matcher {
+
+    struct sail_magic_number *magic_numbers;
+    size_t magic_numbers_length;
+
+    /* Indexes into magic_numbers. */
+    unsigned *indexes;
+    size_t offsets[256 + 1];
+};
+
+/*
+ * Compiles the magic numbers of the specified codec bundles into a new matcher.
+ * The codec bundles must be already sorted by priority. Magic numbers that fail to compile are skipped.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t alloc_magic_number_matcher(const struct sail_codec_bundle_node *codec_bundle_node,
+                                                      struct sail_magic_number_matcher **matcher);
+
+/*
+ * Destroys the specified matcher. Does nothing if the matcher is NULL.
+ */
+SAIL_HIDDEN void destroy_magic_number_matcher(struct sail_magic_number_matcher *matcher);
+
+/*
+ * Finds the codec info which magic number matches the specified buffer of SAIL_MAGIC_BUFFER_SIZE bytes
+ * with the highest confidence, i.e. with the largest number of non-wildcard bytes. Codec priority
+ * breaks ties. Only the first 'buffer_size' bytes of the buffer are meaningful, magic numbers
+ * longer than that never match. 'confidence' can be NULL. Never allocates memory.
+ *
+ * Returns SAIL_OK on success or SAIL_ERROR_CODEC_NOT_FOUND.
+ */
+SAIL_HIDDEN sail_status_t magic_number_matcher_find(const struct sail_magic_number_matcher *matcher,
+                                                     const unsigned char *buffer, size_t buffer_size,
+                                                     const struct sail_codec_info **codec_info,
+                                                     unsigned *confidence);
+
+#endif
@@ -0,0 +1,388 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#define JPEG_MARKER_TEM   0x01
+#define JPEG_MARKER_RST0  0xD0
+#define JPEG_MARKER_RST7  0xD7
+#define JPEG_MARKER_SOS   0xDA
+#define JPEG_MARKER_APP1  0xE1
+#define JPEG_MARKER_APP2  0xE2
+#define JPEG_MARKER_APP13 0xED
+#define JPEG_MARKER_COM   0xFE
+
+#define WEBP_VP8X_FLAG_ICCP 0x20
+#define WEBP_VP8X_FLAG_EXIF 0x08
+#define WEBP_VP8X_FLAG_XMP  0x04
+
+/*
+ * Writes the kept parts of the input data. Adjacent parts are merged into a single write.
+ */
+struct passthrough_writer {
+
+    struct sail_io *io;
+    const unsigned char *run;
+    size_t run_size;
+};
+
+/*
+ * Private functions.
+ */
+
+static uint16_t read_be16(const unsigned char *data) {
+
+    return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+static uint32_t read_be32(const unsigned char *data) {
+
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
+
+static uint32_t read_le32(const unsigned char *data) {
+
+    return ((uint32_t)data[3] << 24) | ((uint32_t)data[2] << 16) | ((uint32_t)data[1] << 8) | data[0];
+}
+
+static void write_le32(unsigned char *data, uint32_t value) {
+
+    data[0] = (unsigned char)(value & 0xFF);
+    data[1] = (unsigned char)((value >> 8) & 0xFF);
+    data[2] = (unsigned char)((value >> 16) & 0xFF);
+    data[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+
+static sail_status_t flush_run(struct passthrough_writer *writer) {
+
+    if (writer->run_size > 0) {
+        SAIL_TRY(writer->io->strict_write(writer->io->stream, writer->run, writer->run_size));
+    }
+
+    writer->run      = NULL;
+    writer->run_size = 0;
+
+    return SAIL_OK;
+}
+
+/* The data must stay valid until the next flush. */
+static sail_status_t keep(struct passthrough_writer *writer, const unsigned char *data, size_t size) {
+
+    if (writer->run != NULL && writer->run + writer->run_size == data) {
+        writer->run_size += size;
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(flush_run(writer));
+
+    writer->run      = data;
+    writer->run_size = size;
+
+    return SAIL_OK;
+}
+
+/*
+ * JPEG.
+ */
+
+static bool is_jpeg_iccp(unsigned marker, const unsigned char *payload, size_t payload_size) {
+
+    return marker == JPEG_MARKER_APP2 && payload_size >= 12 && memcmp(payload, "ICC_PROFILE\0", 12) == 0;
+}
+
+/* EXIF and XMP in APP1, IPTC in APP13, and comments. Other APP segments carry decoding parameters. */
+static bool is_jpeg_meta_data(unsigned marker) {
+
+    return marker == JPEG_MARKER_APP1 || marker == JPEG_MARKER_APP13 || marker == JPEG_MARKER_COM;
+}
+
+static sail_status_t copy_jpeg(const unsigned char *data, size_t data_size, bool keep_meta_data, bool keep_iccp,
+                               struct passthrough_writer *writer) {
+
+    if (data_size < 2 || data[0] != 0xFF || data[1] != 0xD8) {
+        SAIL_LOG_ERROR("PASSTHROUGH: Missing JPEG SOI marker");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    SAIL_TRY(keep(writer, data, 2));
+
+    size_t pos = 2;
+
+    while (pos < data_size) {
+        if (data_size - pos < 2 || data[pos] != 0xFF) {
+            SAIL_LOG_ERROR("PASSTHROUGH: Invalid JPEG marker at offset %zu", pos);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        const unsigned marker = data[pos + 1];
+
+        /* Fill bytes. */
+        if (marker == 0xFF) {
+            SAIL_TRY(keep(writer, data + pos, 1));
+            pos++;
+            continue;
+        }
+
+        if (marker == JPEG_MARKER_TEM || (marker >= JPEG_MARKER_RST0 && marker <= JPEG_MARKER_RST7)) {
+            SAIL_TRY(keep(writer, data + pos, 2));
+            pos += 2;
+            continue;
+        }
+
+        /* Scans and everything after them are copied as is. */
+        if (marker == JPEG_MARKER_SOS) {
+            SAIL_TRY(keep(writer, data + pos, data_size - pos));
+            break;
+        }
+
+        if (data_size - pos < 4) {
+            SAIL_LOG_ERROR("PASSTHROUGH: Truncated JPEG segment at offset %zu", pos);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        const size_t length = read_be16(data + pos + 2);
+
+        if (length < 2 || length > data_size - pos - 2) {
+            SAIL_LOG_ERROR("PASSTHROUGH: Invalid JPEG segment length %zu at offset %zu", length, pos);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        const bool drop = (!keep_meta_data && is_jpeg_meta_data(marker)) ||
+                            (!keep_iccp && is_jpeg_iccp(marker, data + pos + 4, length - 2));
+
+        if (!drop) {
+            SAIL_TRY(keep(writer, data + pos, 2 + length));
+        }
+
+        pos += 2 + length;
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * PNG.
+ */
+
+static const unsigned char PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+
+static bool is_png_chunk(const unsigned char *type, const char *name) {
+
+    return memcmp(type, name, 4) == 0;
+}
+
+static sail_status_t copy_png(const unsigned char *data, size_t data_size, bool keep_meta_data, bool keep_iccp,
+                              struct passthrough_writer *writer) {
+
+    if (data_size < sizeof(PNG_SIGNATURE) || memcmp(data, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) != 0) {
+        SAIL_LOG_ERROR("PASSTHROUGH: Missing PNG signature");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    SAIL_TRY(keep(writer, data, sizeof(PNG_SIGNATURE)));
+
+    size_t pos = sizeof(PNG_SIGNATURE);
+
+    /* Length, type, data, and CRC. */
+    while (data_size - pos >= 12) {
+        const size_t length = read_be32(data + pos);
+
+        if (length > data_size - pos - 12) {
+            break;
+        }
+
+        const unsigned char *type = data + pos + 4;
+
+        const bool meta_data = is_png_chunk(type, "tEXt") || is_png_chunk(type, "zTXt") ||
+                                is_png_chunk(type, "iTXt") || is_png_chunk(type, "eXIf");
+        const bool drop = (!keep_meta_data && meta_data) || (!keep_iccp && is_png_chunk(type, "iCCP"));
+
+        if (!drop) {
+            SAIL_TRY(keep(writer, data + pos, 12 + length));
+        }
+
+        pos += 12 + length;
+
+        if (is_png_chunk(type, "IEND")) {
+            return SAIL_OK;
+        }
+    }
+
+    SAIL_LOG_ERROR("PASSTHROUGH: Truncated PNG chunk at offset %zu", pos);
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+}
+
+/*
+ * WEBP.
+ */
+
+/* Returns the chunk size including the header and the padding byte, or 0 if the chunk is truncated. */
+static size_t webp_chunk_size(const unsigned char *data, size_t pos, size_t end) {
+
+    if (end - pos < 8) {
+        return 0;
+    }
+
+    const size_t length = read_le32(data + pos + 4);
+
+    if (length > end - pos - 8) {
+        return 0;
+    }
+
+    /* The padding byte of the last chunk may be missing. */
+    return SAIL_MIN(8 + length + (length & 1), end - pos);
+}
+
+static unsigned webp_dropped_flags(const unsigned char *fourcc, bool keep_meta_data, bool keep_iccp) {
+
+    if (!keep_iccp && memcmp(fourcc, "ICCP", 4) == 0) {
+        return WEBP_VP8X_FLAG_ICCP;
+    } else if (!keep_meta_data && memcmp(fourcc, "EXIF", 4) == 0) {
+        return WEBP_VP8X_FLAG_EXIF;
+    } else if (!keep_meta_data && memcmp(fourcc, "XMP ", 4) == 0) {
+        return WEBP_VP8X_FLAG_XMP;
+    }
+
+    return 0;
+}
+
+static sail_status_t copy_webp(const unsigned char *data, size_t data_size, bool keep_meta_data, bool keep_iccp,
+                               struct passthrough_writer *writer) {
+
+    if (data_size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WEBP", 4) != 0) {
+        SAIL_LOG_ERROR("PASSTHROUGH: Missing WEBP RIFF header");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+    }
+
+    const size_t end = SAIL_MIN((size_t)read_le32(data + 4) + 8, data_size);
+
+    /* The RIFF size comes first, so sum up the kept chunks before writing them. */
+    size_t kept_size = 4;
+    unsigned dropped_flags = 0;
+
+    for (size_t pos = 12; pos < end;) {
+        const size_t chunk_size = webp_chunk_size(data, pos, end);
+
+        if (chunk_size == 0) {
+            SAIL_LOG_ERROR("PASSTHROUGH: Truncated WEBP chunk at offset %zu", pos);
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_BROKEN_IMAGE);
+        }
+
+        const unsigned flags = webp_dropped_flags(data + pos, keep_meta_data, keep_iccp);
+
+        if (flags == 0) {
+            kept_size += chunk_size;
+        } else {
+            dropped_flags |= flags;
+        }
+
+        pos += chunk_size;
+    }
+
+    unsigned char header[12];
+    memcpy(header, "RIFF", 4);
+    write_le32(header + 4, (uint32_t)kept_size);
+    memcpy(header + 8, "WEBP", 4);
+
+    SAIL_TRY(writer->io->strict_write(writer->io->stream, header, sizeof(header)));
+
+    for (size_t pos = 12; pos < end;) {
+        const size_t chunk_size = webp_chunk_size(data, pos, end);
+
+        if (webp_dropped_flags(data + pos, keep_meta_data, keep_iccp) == 0) {
+            /* The extended header must not announce the dropped chunks. */
+            if (memcmp(data + pos, "VP8X", 4) == 0 && chunk_size > 8 && dropped_flags != 0) {
+                unsigned char flags = (unsigned char)(data[pos + 8] & ~dropped_flags);
+
+                SAIL_TRY(keep(writer, data + pos, 8));
+                SAIL_TRY(flush_run(writer));
+                SAIL_TRY(writer->io->strict_write(writer->io->stream, &flags, 1));
+                SAIL_TRY(keep(writer, data + pos + 9, chunk_size - 9));
+            } else {
+                SAIL_TRY(keep(writer, data + pos, chunk_size));
+            }
+        }
+
+        pos += chunk_size;
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Public functions.
+ */
+
+bool passthrough_private_supported(const struct sail_codec_info *codec_info) {
+
+    return codec_info != NULL &&
+            (strcmp(codec_info->name, "JPEG") == 0 || strcmp(codec_info->name, "PNG") == 0 || strcmp(codec_info->name, "WEBP") == 0);
+}
+
+sail_status_t passthrough_private_copy(struct sail_io *io_input, const struct sail_codec_info *codec_info,
+                                       struct sail_io *io_output, bool keep_meta_data, bool keep_iccp) {
+
+    SAIL_TRY(sail_check_io_valid(io_input));
+    SAIL_TRY(sail_check_io_valid(io_output));
+    SAIL_CHECK_PTR(codec_info);
+
+    if (!passthrough_private_supported(codec_info)) {
+        SAIL_LOG_ERROR("PASSTHROUGH: %s codec doesn't support passthrough copying", codec_info->name);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    }
+
+    const void *data;
+    size_t data_size;
+    void *allocated_data;
+    SAIL_TRY(sail_borrow_or_alloc_data_from_io_contents(io_input, &data, &data_size, &allocated_data));
+
+    struct passthrough_writer writer = { io_output, NULL, 0 };
+    sail_status_t status;
+
+    if (strcmp(codec_info->name, "JPEG") == 0) {
+        status = copy_jpeg(data, data_size, keep_meta_data, keep_iccp, &writer);
+    } else if (strcmp(codec_info->name, "PNG") == 0) {
+        status = copy_png(data, data_size, keep_meta_data, keep_iccp, &writer);
+    } else {
+        status = copy_webp(data, data_size, keep_meta_data, keep_iccp, &writer);
+    }
+
+    if (status == SAIL_OK) {
+        status = flush_run(&writer);
+    }
+
+    sail_free(allocated_data);
+
+    SAIL_TRY(status);
+
+    SAIL_TRY(io_output->flush(io_output->stream));
+
+    return SAIL_OK;
+}
@@ -0,0 +1,54 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_PASSTHROUGH_PRIVATE_H
+#define SAIL_PASSTHROUGH_PRIVATE_H
+
+#include <stdbool.h>
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+struct sail_codec_info;
+struct sail_io;
+
+/*
+ * Returns true if the bitstreams of the specified codec can be copied with passthrough_private_copy().
+ * Supported codecs are JPEG, PNG, and WEBP.
+ */
+SAIL_HIDDEN bool passthrough_private_supported(const struct sail_codec_info *codec_info);
+
+/*
+ * Copies the image bitstream from the current position of the input I/O stream into the output
+ * I/O stream without decoding it. Meta data like EXIF, XMP, and comments is dropped at the container
+ * level unless 'keep_meta_data' is true. The ICC profile is dropped unless 'keep_iccp' is true.
+ * Mapped input I/O streams are copied without reading them into an intermediate buffer.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_HIDDEN sail_status_t passthrough_private_copy(struct sail_io *io_input, const struct sail_codec_info *codec_info,
+                                                   struct sail_io *io_output, bool keep_meta_data, bool keep_iccp);
+
+#endif
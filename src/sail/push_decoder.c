@@ -0,0 +1,694 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* SIZE_MAX */
+#include <stdio.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+/* Decoding restarts at least after this many new bytes. */
+static const size_t PUSH_DECODER_MIN_RESTART_STEP = 4096;
+
+/* How the push decoder loads: not chosen yet, with the codec incremental functions, or by restarting. */
+enum push_decoder_mode {
+
+    PUSH_DECODER_MODE_UNKNOWN,
+    PUSH_DECODER_MODE_INCREMENTAL,
+    PUSH_DECODER_MODE_RESTART,
+};
+
+struct sail_push_decoder {
+    const struct sail_codec_info *codec_info;
+    struct sail_load_options *load_options;
+
+    enum push_decoder_mode mode;
+
+    /*
+     * Fed data. In the incremental mode, only the data not consumed by the codec yet, unless
+     * the first frame header is not decoded, so the restart mode can still take over.
+     */
+    unsigned char *buffer;
+    size_t size;
+    size_t capacity;
+    bool finished;
+
+    /* Incremental mode. The first byte not consumed by the codec, and whether all the fed data is kept. */
+    size_t offset;
+    bool retain;
+
+    /* Incremental mode. The codec and its state. */
+    const struct sail_codec *codec;
+    void *codec_state;
+
+    /* Incremental mode. The frame being decoded, and the rows updated by the last call. NULL between frames. */
+    struct sail_image *frame;
+    unsigned first_row;
+    unsigned rows_count;
+
+    /* Restart mode. I/O object reading the fed data, and its position. */
+    struct sail_io *io;
+    size_t pos;
+
+    /* Restart mode. Set when the current loading attempt tried to read data that has not been fed yet. */
+    bool starved;
+
+    /* Restart mode. Current loading attempt. NULL when there is no attempt in progress. */
+    void *state;
+
+    /* Restart mode. Don't start a new loading attempt until this many bytes are fed. */
+    size_t restart_size;
+
+    /* Number of returned frames. New attempts skip them. */
+    unsigned frames;
+
+    /* All the frames are returned. */
+    bool exhausted;
+};
+
+/*
+ * Private functions.
+ */
+
+static sail_status_t io_push_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(buf);
+    SAIL_CHECK_PTR(read_size);
+
+    struct sail_push_decoder *push_decoder = stream;
+
+    *read_size = 0;
+
+    const size_t available = (push_decoder->pos < push_decoder->size) ? push_decoder->size - push_decoder->pos : 0;
+
+    if (size_to_read > available && !push_decoder->finished) {
+        push_decoder->starved = true;
+    }
+
+    if (available == 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_EOF);
+    }
+
+    const size_t actual_size_to_read = (size_to_read > available) ? available : size_to_read;
+
+    memcpy(buf, push_decoder->buffer + push_decoder->pos, actual_size_to_read);
+    push_decoder->pos += actual_size_to_read;
+
+    *read_size = actual_size_to_read;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_push_strict_read(void *stream, void *buf, size_t size_to_read) {
+
+    size_t read_size;
+
+    SAIL_TRY(io_push_tolerant_read(stream, buf, size_to_read, &read_size));
+
+    if (read_size != size_to_read) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_READ_IO);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_push_seek(void *stream, long offset, int whence) {
+
+    SAIL_CHECK_PTR(stream);
+
+    struct sail_push_decoder *push_decoder = stream;
+
+    size_t base;
+
+    switch (whence) {
+        case SEEK_SET: {
+            base = 0;
+            break;
+        }
+
+        case SEEK_CUR: {
+            base = push_decoder->pos;
+            break;
+        }
+
+        case SEEK_END: {
+            /* The end is unknown until the data is finished. */
+            if (!push_decoder->finished) {
+                push_decoder->starved = true;
+                SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+            }
+
+            base = push_decoder->size;
+            break;
+        }
+
+        default: {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_SEEK_WHENCE);
+        }
+    }
+
+    /* Seeking past the fed data is allowed, reading there starves. */
+    if (offset < 0 && (size_t)(-(offset + 1)) >= base) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_SEEK_IO);
+    }
+
+    push_decoder->pos = (offset < 0) ? base - (size_t)(-(offset + 1)) - 1 : base + (size_t)offset;
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_push_tell(void *stream, size_t *offset) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(offset);
+
+    const struct sail_push_decoder *push_decoder = stream;
+
+    *offset = push_decoder->pos;
+
+    return SAIL_OK;
+}
+
+/* The fed data is owned by the push decoder. */
+static sail_status_t io_push_close(void *stream) {
+
+    SAIL_CHECK_PTR(stream);
+
+    return SAIL_OK;
+}
+
+static sail_status_t io_push_eof(void *stream, bool *result) {
+
+    SAIL_CHECK_PTR(stream);
+    SAIL_CHECK_PTR(result);
+
+    struct sail_push_decoder *push_decoder = stream;
+
+    *result = push_decoder->pos >= push_decoder->size;
+
+    /* The end of the fed data is not necessarily the end of the image. */
+    if (*result && !push_decoder->finished) {
+        push_decoder->starved = true;
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t append_data(struct sail_push_decoder *push_decoder, const void *data, size_t size) {
+
+    if (size > SIZE_MAX - push_decoder->size) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_MEMORY_ALLOCATION);
+    }
+
+    if (push_decoder->size + size > push_decoder->capacity) {
+        /* Grow geometrically to keep the number of reallocations logarithmic. */
+        size_t new_capacity = (push_decoder->capacity < PUSH_DECODER_MIN_RESTART_STEP)
+                                ? PUSH_DECODER_MIN_RESTART_STEP
+                                : push_decoder->capacity;
+
+        while (new_capacity < push_decoder->size + size) {
+            new_capacity = (new_capacity > SIZE_MAX / 2) ? push_decoder->size + size : new_capacity * 2;
+        }
+
+        void *ptr = push_decoder->buffer;
+        SAIL_TRY(sail_realloc(new_capacity, &ptr));
+
+        push_decoder->buffer   = ptr;
+        push_decoder->capacity = new_capacity;
+    }
+
+    memcpy(push_decoder->buffer + push_decoder->size, data, size);
+    push_decoder->size += size;
+
+    return SAIL_OK;
+}
+
+static void stop_attempt(struct sail_push_decoder *push_decoder) {
+
+    if (push_decoder->state != NULL) {
+        sail_stop_loading(push_decoder->state);
+        push_decoder->state = NULL;
+    }
+}
+
+/* Stops the current attempt and postpones the next one until the fed data doubles. */
+static sail_status_t wait_for_more_data(struct sail_push_decoder *push_decoder) {
+
+    stop_attempt(push_decoder);
+
+    const size_t step = (push_decoder->size < PUSH_DECODER_MIN_RESTART_STEP) ? PUSH_DECODER_MIN_RESTART_STEP : push_decoder->size;
+
+    push_decoder->restart_size = (step > SIZE_MAX - push_decoder->size) ? SIZE_MAX : push_decoder->size + step;
+
+    return SAIL_ERROR_NEED_MORE_DATA;
+}
+
+/* Starts loading the fed data from the beginning and skips the frames returned by previous attempts. */
+static sail_status_t start_attempt(struct sail_push_decoder *push_decoder) {
+
+    push_decoder->pos     = 0;
+    push_decoder->starved = false;
+
+    SAIL_TRY(sail_start_loading_from_io_with_options(push_decoder->io,
+                                                     push_decoder->codec_info,
+                                                     push_decoder->load_options,
+                                                     &push_decoder->state));
+
+    for (unsigned i = 0; i < push_decoder->frames; i++) {
+        struct sail_image *image;
+        SAIL_TRY(sail_load_next_frame(push_decoder->state, &image));
+
+        sail_destroy_image(image);
+    }
+
+    return SAIL_OK;
+}
+
+static sail_status_t load_next_frame_restarting(struct sail_push_decoder *push_decoder, struct sail_image **image) {
+
+    if (push_decoder->state == NULL) {
+        if (!push_decoder->finished && push_decoder->size < push_decoder->restart_size) {
+            return SAIL_ERROR_NEED_MORE_DATA;
+        }
+
+        const sail_status_t status = start_attempt(push_decoder);
+
+        if (status != SAIL_OK) {
+            if (push_decoder->starved && !push_decoder->finished) {
+                return wait_for_more_data(push_decoder);
+            }
+
+            stop_attempt(push_decoder);
+            SAIL_LOG_AND_RETURN(status);
+        }
+    }
+
+    struct sail_image *image_local;
+    const sail_status_t status = sail_load_next_frame(push_decoder->state, &image_local);
+
+    /* Codecs may succeed on truncated data, so frames read past the fed data are not trusted. */
+    if (push_decoder->starved && !push_decoder->finished) {
+        if (status == SAIL_OK) {
+            sail_destroy_image(image_local);
+        }
+
+        return wait_for_more_data(push_decoder);
+    }
+
+    if (status != SAIL_OK) {
+        stop_attempt(push_decoder);
+
+        if (status == SAIL_ERROR_NO_MORE_FRAMES) {
+            push_decoder->exhausted = true;
+            return SAIL_ERROR_NO_MORE_FRAMES;
+        }
+
+        SAIL_LOG_AND_RETURN(status);
+    }
+
+    push_decoder->frames++;
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+/* Returns true if libsail doesn't need the whole frame or the I/O object to honor the load options. */
+static bool incremental_load_options(const struct sail_load_options *load_options) {
+
+    return !sail_roi_is_set(&load_options->roi) &&
+            load_options->row_callback == NULL &&
+            load_options->row_alignment <= 1 &&
+            load_options->stats == NULL &&
+            !(load_options->options & (SAIL_OPTION_PROBE | SAIL_OPTION_DIAGNOSTICS | SAIL_OPTION_ARENA));
+}
+
+static void stop_incremental(struct sail_push_decoder *push_decoder) {
+
+    sail_destroy_image(push_decoder->frame);
+    push_decoder->frame      = NULL;
+    push_decoder->rows_count = 0;
+
+    if (push_decoder->codec_state != NULL) {
+        push_decoder->codec->v8->load_finish(&push_decoder->codec_state);
+        push_decoder->codec_state = NULL;
+    }
+}
+
+/* Detects the codec, and starts the incremental mode if the codec and the load options allow it. */
+static sail_status_t choose_mode(struct sail_push_decoder *push_decoder) {
+
+    if (push_decoder->codec_info == NULL) {
+        const sail_status_t status = (push_decoder->size == 0)
+                                        ? SAIL_ERROR_CODEC_NOT_FOUND
+                                        : sail_codec_info_by_magic_number_from_memory(push_decoder->buffer,
+                                                                                      push_decoder->size,
+                                                                                      &push_decoder->codec_info);
+
+        if (status != SAIL_OK) {
+            if (!push_decoder->finished && push_decoder->size < SAIL_MAGIC_BUFFER_SIZE) {
+                return SAIL_ERROR_NEED_MORE_DATA;
+            }
+
+            SAIL_LOG_AND_RETURN(status);
+        }
+    }
+
+    push_decoder->mode = PUSH_DECODER_MODE_RESTART;
+
+    if (!(push_decoder->codec_info->load_features->features & SAIL_CODEC_FEATURE_PUSH)) {
+        return SAIL_OK;
+    }
+
+    if (push_decoder->load_options == NULL) {
+        SAIL_TRY(sail_alloc_load_options_from_features(push_decoder->codec_info->load_features, &push_decoder->load_options));
+    }
+
+    if (!incremental_load_options(push_decoder->load_options)) {
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(load_codec_by_codec_info(push_decoder->codec_info, &push_decoder->codec));
+
+    const sail_status_t status = push_decoder->codec->v8->load_push_init(push_decoder->load_options, &push_decoder->codec_state);
+
+    if (status != SAIL_OK) {
+        stop_incremental(push_decoder);
+
+        if (status == SAIL_ERROR_NOT_IMPLEMENTED) {
+            return SAIL_OK;
+        }
+
+        SAIL_LOG_AND_RETURN(status);
+    }
+
+    push_decoder->mode   = PUSH_DECODER_MODE_INCREMENTAL;
+    push_decoder->retain = true;
+
+    return SAIL_OK;
+}
+
+/* Drops the data consumed by the codec unless all the fed data is kept. */
+static void drop_consumed_data(struct sail_push_decoder *push_decoder) {
+
+    if (push_decoder->retain || push_decoder->offset == 0) {
+        return;
+    }
+
+    memmove(push_decoder->buffer, push_decoder->buffer + push_decoder->offset, push_decoder->size - push_decoder->offset);
+
+    push_decoder->size  -= push_decoder->offset;
+    push_decoder->offset = 0;
+}
+
+/* Allocates zeroed pixels for the frame, as the codec may decode them in several passes. */
+static sail_status_t alloc_frame_pixels(const struct sail_load_options *load_options, struct sail_image *image) {
+
+    const size_t pixels_size = (size_t)image->height * image->bytes_per_line;
+
+    SAIL_TRY(sail_check_load_limits(load_options, image->width, image->height, pixels_size));
+
+    if (load_options->file_backed_pixels_threshold > 0 && pixels_size >= load_options->file_backed_pixels_threshold) {
+        /* File-backed memory is zeroed. */
+        SAIL_TRY(sail_alloc_image_pixels(image, true /* file-backed */));
+        return SAIL_OK;
+    }
+
+    if (load_options->pixels_alignment > 1) {
+        SAIL_TRY(sail_aligned_malloc(load_options->pixels_alignment, pixels_size, &image->pixels));
+        image->pixels_alignment = load_options->pixels_alignment;
+    } else {
+        SAIL_TRY(sail_malloc(pixels_size, &image->pixels));
+    }
+
+    memset(image->pixels, 0, pixels_size);
+
+    return SAIL_OK;
+}
+
+/* Decodes the next frame header, or returns SAIL_ERROR_NOT_IMPLEMENTED to switch to the restart mode. */
+static sail_status_t seek_next_frame_incrementally(struct sail_push_decoder *push_decoder) {
+
+    const struct sail_load_options *load_options = push_decoder->load_options;
+
+    SAIL_TRY(sail_check_cancellation(load_options->cancellation));
+
+    if ((load_options->options & SAIL_OPTION_FIRST_FRAME_ONLY) && push_decoder->frames > 0) {
+        return SAIL_ERROR_NO_MORE_FRAMES;
+    }
+
+    if (load_options->limits.max_frames > 0 && push_decoder->frames >= load_options->limits.max_frames) {
+        SAIL_LOG_ERROR("The number of frames exceeds the limit of %u frames", load_options->limits.max_frames);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    size_t consumed = 0;
+    struct sail_image *image_local;
+    const sail_status_t status = push_decoder->codec->v8->load_push_seek_next_frame(push_decoder->codec_state,
+                                                                                    push_decoder->buffer + push_decoder->offset,
+                                                                                    push_decoder->size - push_decoder->offset,
+                                                                                    push_decoder->finished,
+                                                                                    &consumed,
+                                                                                    &image_local);
+    push_decoder->offset += consumed;
+
+    if (status != SAIL_OK) {
+        if (status == SAIL_ERROR_NOT_IMPLEMENTED && push_decoder->frames == 0) {
+            return SAIL_ERROR_NOT_IMPLEMENTED;
+        }
+
+        drop_consumed_data(push_decoder);
+
+        if (status == SAIL_ERROR_NEED_MORE_DATA || status == SAIL_ERROR_NO_MORE_FRAMES) {
+            return status;
+        }
+
+        SAIL_LOG_AND_RETURN(status);
+    }
+
+    /* The restart mode cannot take over anymore. */
+    push_decoder->retain = false;
+    drop_consumed_data(push_decoder);
+
+    filter_meta_data(load_options, image_local);
+
+    SAIL_TRY_OR_CLEANUP(check_sought_frame(load_options, push_decoder->codec_info, image_local),
+                        /* cleanup */ sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(alloc_frame_pixels(load_options, image_local),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    push_decoder->frame = image_local;
+
+    return SAIL_OK;
+}
+
+static sail_status_t load_next_frame_incrementally(struct sail_push_decoder *push_decoder, struct sail_image **image) {
+
+    push_decoder->rows_count = 0;
+
+    if (push_decoder->frame == NULL) {
+        const sail_status_t status = seek_next_frame_incrementally(push_decoder);
+
+        if (status == SAIL_ERROR_NOT_IMPLEMENTED) {
+            SAIL_LOG_TRACE("The %s codec cannot load the data incrementally, fall back to restarts", push_decoder->codec_info->name);
+            stop_incremental(push_decoder);
+            push_decoder->mode   = PUSH_DECODER_MODE_RESTART;
+            push_decoder->retain = false;
+            return load_next_frame_restarting(push_decoder, image);
+        }
+
+        if (status == SAIL_ERROR_NEED_MORE_DATA && !push_decoder->finished) {
+            return SAIL_ERROR_NEED_MORE_DATA;
+        }
+
+        if (status != SAIL_OK) {
+            push_decoder->exhausted = true;
+            stop_incremental(push_decoder);
+
+            if (status == SAIL_ERROR_NO_MORE_FRAMES) {
+                return SAIL_ERROR_NO_MORE_FRAMES;
+            }
+
+            SAIL_LOG_AND_RETURN((status == SAIL_ERROR_NEED_MORE_DATA) ? SAIL_ERROR_UNDERLYING_CODEC : status);
+        }
+    }
+
+    size_t consumed = 0;
+    const sail_status_t status = push_decoder->codec->v8->load_push_frame(push_decoder->codec_state,
+                                                                          push_decoder->buffer + push_decoder->offset,
+                                                                          push_decoder->size - push_decoder->offset,
+                                                                          push_decoder->finished,
+                                                                          &consumed,
+                                                                          push_decoder->frame,
+                                                                          &push_decoder->first_row,
+                                                                          &push_decoder->rows_count);
+    push_decoder->offset += consumed;
+    drop_consumed_data(push_decoder);
+
+    if (status == SAIL_ERROR_NEED_MORE_DATA && !push_decoder->finished) {
+        return SAIL_ERROR_NEED_MORE_DATA;
+    }
+
+    if (status != SAIL_OK) {
+        push_decoder->exhausted = true;
+        stop_incremental(push_decoder);
+        SAIL_LOG_AND_RETURN((status == SAIL_ERROR_NEED_MORE_DATA) ? SAIL_ERROR_UNDERLYING_CODEC : status);
+    }
+
+    *image = push_decoder->frame;
+
+    push_decoder->frame      = NULL;
+    push_decoder->rows_count = 0;
+    push_decoder->frames++;
+
+    return SAIL_OK;
+}
+
+static sail_status_t load_next_frame(struct sail_push_decoder *push_decoder, struct sail_image **image) {
+
+    if (push_decoder->exhausted) {
+        return SAIL_ERROR_NO_MORE_FRAMES;
+    }
+
+    if (push_decoder->mode == PUSH_DECODER_MODE_UNKNOWN) {
+        SAIL_TRY(choose_mode(push_decoder));
+    }
+
+    if (push_decoder->mode == PUSH_DECODER_MODE_INCREMENTAL) {
+        return load_next_frame_incrementally(push_decoder, image);
+    }
+
+    return load_next_frame_restarting(push_decoder, image);
+}
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_alloc_push_decoder(const struct sail_codec_info *codec_info,
+                                      const struct sail_load_options *load_options,
+                                      struct sail_push_decoder **push_decoder) {
+
+    SAIL_CHECK_PTR(push_decoder);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct sail_push_decoder), &ptr));
+    struct sail_push_decoder *push_decoder_local = ptr;
+
+    memset(push_decoder_local, 0, sizeof(*push_decoder_local));
+    push_decoder_local->codec_info = codec_info;
+
+    if (load_options != NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_copy_load_options(load_options, &push_decoder_local->load_options),
+                            /* cleanup */ sail_destroy_push_decoder(push_decoder_local));
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_alloc_io(&push_decoder_local->io),
+                        /* cleanup */ sail_destroy_push_decoder(push_decoder_local));
+
+    struct sail_io *io = push_decoder_local->io;
+
+    io->features       = SAIL_IO_FEATURE_SEEKABLE;
+    io->stream         = push_decoder_local;
+    io->tolerant_read  = io_push_tolerant_read;
+    io->strict_read    = io_push_strict_read;
+    io->tolerant_write = sail_io_noop_tolerant_write;
+    io->strict_write   = sail_io_noop_strict_write;
+    io->seek           = io_push_seek;
+    io->tell           = io_push_tell;
+    io->flush          = sail_io_noop_flush;
+    io->close          = io_push_close;
+    io->eof            = io_push_eof;
+
+    *push_decoder = push_decoder_local;
+
+    return SAIL_OK;
+}
+
+void sail_destroy_push_decoder(struct sail_push_decoder *push_decoder) {
+
+    if (push_decoder == NULL) {
+        return;
+    }
+
+    stop_attempt(push_decoder);
+    stop_incremental(push_decoder);
+
+    sail_destroy_io(push_decoder->io);
+    sail_destroy_load_options(push_decoder->load_options);
+    sail_free(push_decoder->buffer);
+    sail_free(push_decoder);
+}
+
+sail_status_t sail_push_decoder_feed(struct sail_push_decoder *push_decoder,
+                                     const void *data, size_t size,
+                                     struct sail_image **image) {
+
+    SAIL_CHECK_PTR(push_decoder);
+    SAIL_CHECK_PTR(image);
+
+    if (size > 0) {
+        SAIL_CHECK_PTR(data);
+    }
+
+    if (push_decoder->finished) {
+        SAIL_LOG_ERROR("Cannot feed data after finishing it");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    }
+
+    if (size > 0) {
+        SAIL_TRY(append_data(push_decoder, data, size));
+    }
+
+    return load_next_frame(push_decoder, image);
+}
+
+sail_status_t sail_push_decoder_finish(struct sail_push_decoder *push_decoder, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(push_decoder);
+    SAIL_CHECK_PTR(image);
+
+    push_decoder->finished = true;
+
+    return load_next_frame(push_decoder, image);
+}
+
+sail_status_t sail_push_decoder_rows(const struct sail_push_decoder *push_decoder,
+                                     const struct sail_image **image,
+                                     unsigned *first_row, unsigned *rows_count) {
+
+    SAIL_CHECK_PTR(push_decoder);
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(first_row);
+    SAIL_CHECK_PTR(rows_count);
+
+    *image      = push_decoder->frame;
+    *first_row  = (push_decoder->rows_count > 0) ? push_decoder->first_row : 0;
+    *rows_count = push_decoder->rows_count;
+
+    return SAIL_OK;
+}
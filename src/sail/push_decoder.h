@@ -0,0 +1,126 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_PUSH_DECODER_H
+#define SAIL_PUSH_DECODER_H
+
+#include <stddef.h> /* size_t */
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_codec_info;
+struct sail_image;
+struct sail_load_options;
+struct sail_push_decoder;
+
+/*
+ * Allocates a new push decoder that loads an image from data fed by the caller as it arrives,
+ * for example, from a non-blocking socket in an event loop. Feeding never blocks and decodes
+ * on the calling thread.
+ *
+ * Pass codec info if you would like to load with a specific codec. If not, just pass NULL,
+ * and SAIL will detect it by the magic number as soon as enough data is fed. If you do not need
+ * specific load options, just pass NULL. The load options are copied.
+ *
+ * Codecs with the PUSH load feature decode the fed data incrementally. The decoder keeps only
+ * the bytes the codec has not consumed yet, and sail_push_decoder_rows() reports the rows decoded
+ * so far. Incremental decoding needs no region of interest, row callback, row alignment, stats,
+ * and no SAIL_OPTION_PROBE, SAIL_OPTION_DIAGNOSTICS, or SAIL_OPTION_ARENA options. A codec can
+ * also refuse to decode a specific image incrementally, for example, an animated PNG.
+ *
+ * Only the PNG and JPEG codecs have the PUSH load feature. WebP and JPEG XL are deliberately out
+ * of scope so far: their libraries decode incrementally with WebPIDecoder and JxlDecoderSetInput(),
+ * but the codecs are not ported to them yet, and they load with the restarts described below.
+ *
+ * Otherwise, codecs read their input with blocking I/O callbacks, so the decoder keeps the fed data
+ * in memory, and restarts decoding from the beginning when a codec asks for data that has not arrived
+ * yet. Restarts happen only after the fed data doubles, so the total decoding work stays linear.
+ * Frames are returned only after a codec has read them without running out of data.
+ *
+ * Typical usage: sail_alloc_push_decoder()        ->
+ *                sail_push_decoder_feed() * N     ->
+ *                sail_push_decoder_finish() * N   ->
+ *                sail_destroy_push_decoder().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_alloc_push_decoder(const struct sail_codec_info *codec_info,
+                                                  const struct sail_load_options *load_options,
+                                                  struct sail_push_decoder **push_decoder);
+
+/*
+ * Destroys the specified push decoder with the fed data. Does nothing if the decoder is NULL.
+ */
+SAIL_EXPORT void sail_destroy_push_decoder(struct sail_push_decoder *push_decoder);
+
+/*
+ * Appends 'size' bytes of 'data' to the fed data and tries to load the next frame.
+ * Pass zero size to try to load the next frame after a previous frame without feeding new data.
+ *
+ * Returns SAIL_OK and an image that must be destroyed with sail_destroy_image() when the next frame
+ * is loaded, SAIL_ERROR_NEED_MORE_DATA when the fed data is not enough to load it yet,
+ * SAIL_ERROR_NO_MORE_FRAMES when the fed data has no more frames, or another error if the data
+ * is broken. Feeding after sail_push_decoder_finish() fails with SAIL_ERROR_CONFLICTING_OPERATION.
+ */
+SAIL_EXPORT sail_status_t sail_push_decoder_feed(struct sail_push_decoder *push_decoder,
+                                                 const void *data, size_t size,
+                                                 struct sail_image **image);
+
+/*
+ * Marks the end of the fed data and loads the next frame from it. Call it until it returns
+ * SAIL_ERROR_NO_MORE_FRAMES to get the frames not returned by sail_push_decoder_feed().
+ * Truncated data fails with the codec error instead of SAIL_ERROR_NEED_MORE_DATA.
+ *
+ * Returns SAIL_OK and an image that must be destroyed with sail_destroy_image() when the next frame
+ * is loaded, SAIL_ERROR_NO_MORE_FRAMES when there are no more frames, or another error.
+ */
+SAIL_EXPORT sail_status_t sail_push_decoder_finish(struct sail_push_decoder *push_decoder, struct sail_image **image);
+
+/*
+ * Returns the frame being decoded incrementally, and the range of its rows updated by the last
+ * sail_push_decoder_feed() or sail_push_decoder_finish() call. Rows not decoded yet are zeroed.
+ * Interlaced frames update the same rows several times. The frame is owned by the decoder and stays
+ * valid until the next call that feeds or finishes the data. Do not modify it.
+ *
+ * Assigns a NULL frame and zero rows when no frame is being decoded incrementally, for example,
+ * between frames, before the frame header is decoded, or when the decoder restarts decoding.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_push_decoder_rows(const struct sail_push_decoder *push_decoder,
+                                                 const struct sail_image **image,
+                                                 unsigned *first_row, unsigned *rows_count);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
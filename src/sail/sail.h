@@ -35,22 +35,33 @@
 #include <sail/codec_info.h>
 #include <sail/codec_priority.h>
 #include <sail/context.h>
+#include <sail/image_cache.h>
 #include <sail/io_file.h>
 #include <sail/io_memory.h>
 #include <sail/io_noop.h>
+#include <sail/io_read_ahead.h>
+#include <sail/io_stream.h>
+#include <sail/push_decoder.h>
 #include <sail/sail_advanced.h>
 #include <sail/sail_deep_diver.h>
 #include <sail/sail_junior.h>
 #include <sail/sail_technical_diver.h>
+#include <sail/transcode.h>
 
 #ifdef SAIL_BUILD
     #include <sail/codec.h>
     #include <sail/codec_bundle_node_private.h>
     #include <sail/codec_bundle_private.h>
+    #include <sail/codec_info_cache_private.h>
+    #include <sail/codec_info_index_private.h>
     #include <sail/codec_info_private.h>
     #include <sail/codec_layout.h>
     #include <sail/context_private.h>
+    #include <sail/exif_private.h>
     #include <sail/ini.h>
+    #include <sail/io_stats_private.h>
+    #include <sail/magic_number_private.h>
+    #include <sail/passthrough_private.h>
     #include <sail/sail_private.h>
     #include <sail/sail_technical_diver_private.h>
     #ifdef SAIL_THREAD_SAFE
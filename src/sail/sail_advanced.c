@@ -23,11 +23,541 @@
     SOFTWARE.
 */
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <sail/sail.h>
 
+/*
+ * Private functions.
+ */
+
+static bool is_valid_alignment(unsigned alignment) {
+
+    return (alignment & (alignment - 1)) == 0;
+}
+
+/* Moves tightly packed rows to a wider stride in place, starting from the last row, and zeroes the padding. */
+static void spread_rows(void *pixels, unsigned height, unsigned packed_bytes_per_line, unsigned bytes_per_line) {
+
+    unsigned char *pixels_ptr = pixels;
+
+    for (unsigned row = height; row > 0; row--) {
+        unsigned char *scan_line = pixels_ptr + (size_t)(row - 1) * bytes_per_line;
+
+        memmove(scan_line, pixels_ptr + (size_t)(row - 1) * packed_bytes_per_line, packed_bytes_per_line);
+        memset(scan_line + packed_bytes_per_line, 0, bytes_per_line - packed_bytes_per_line);
+    }
+}
+
+/* Takes a recycled pixels buffer of the same size and alignment or allocates a new one. */
+static sail_status_t alloc_pixels(struct hidden_state *state_of_mind, size_t pixels_size, unsigned pixels_alignment, void **pixels) {
+
+    for (unsigned i = 0; i < state_of_mind->recycled_pixels_count; i++) {
+        const struct recycled_pixels *recycled_pixels = &state_of_mind->recycled_pixels[i];
+
+        if (recycled_pixels->pixels_size == pixels_size && recycled_pixels->pixels_alignment == pixels_alignment) {
+            *pixels = recycled_pixels->pixels;
+            state_of_mind->recycled_pixels[i] = state_of_mind->recycled_pixels[--state_of_mind->recycled_pixels_count];
+            return SAIL_OK;
+        }
+    }
+
+    if (pixels_alignment > 0) {
+        SAIL_TRY(sail_aligned_malloc(pixels_alignment, pixels_size, pixels));
+    } else {
+        SAIL_TRY(sail_malloc(pixels_size, pixels));
+    }
+
+    /* Place the bands of rows on the NUMA nodes that run the parallel stages over them. */
+    sail_thread_pool_first_touch(*pixels, pixels_size);
+
+    return SAIL_OK;
+}
+
+/* Returns true if the pixels buffer of the specified size must be file-backed. */
+static bool is_file_backed(const struct sail_load_options *load_options, size_t pixels_size) {
+
+    return load_options->file_backed_pixels_threshold > 0 && pixels_size >= load_options->file_backed_pixels_threshold;
+}
+
+/* Allocates a temporary buffer for the whole frame, file-backed if it's large enough. */
+static sail_status_t alloc_frame_pixels(const struct sail_load_options *load_options, size_t pixels_size, void **pixels) {
+
+    if (is_file_backed(load_options, pixels_size)) {
+        SAIL_TRY(sail_alloc_file_backed_memory(pixels_size, pixels));
+    } else {
+        SAIL_TRY(sail_malloc(pixels_size, pixels));
+    }
+
+    return SAIL_OK;
+}
+
+static void free_frame_pixels(const struct sail_load_options *load_options, void *pixels, size_t pixels_size) {
+
+    if (is_file_backed(load_options, pixels_size)) {
+        sail_free_file_backed_memory(pixels, pixels_size);
+    } else {
+        sail_free(pixels);
+    }
+}
+
+/*
+ * Computes the region of interest SAIL must crop the frame to. Codecs with the ROI feature
+ * crop frames themselves.
+ */
+static sail_status_t frame_crop(const struct hidden_state *state_of_mind, const struct sail_image *image, bool *crop, struct sail_roi *roi) {
+
+    *crop = false;
+
+    if (!sail_roi_is_set(&state_of_mind->load_options->roi) ||
+            (state_of_mind->codec_info->load_features->features & SAIL_CODEC_FEATURE_ROI)) {
+        return SAIL_OK;
+    }
+
+    SAIL_TRY(sail_clip_roi(&state_of_mind->load_options->roi, image->width, image->height, roi));
+
+    if (sail_is_block_compressed(image->pixel_format)) {
+        SAIL_LOG_ERROR("Region of interest is not supported for %s pixel format", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    const unsigned bits_per_pixel = sail_bits_per_pixel(image->pixel_format);
+
+    if (((size_t)roi->x * bits_per_pixel) % 8 != 0) {
+        SAIL_LOG_ERROR("Region of interest must start on a byte boundary for %s pixel format", sail_pixel_format_to_string(image->pixel_format));
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    }
+
+    *crop = true;
+
+    return SAIL_OK;
+}
+
+/*
+ * Seeks to the next frame and checks it against the resource limits. Frame dimensions are checked
+ * unless in the probe mode.
+ */
+static sail_status_t seek_next_frame(struct hidden_state *state_of_mind, struct sail_image **image) {
+
+    const struct sail_load_options *load_options = state_of_mind->load_options;
+
+    SAIL_TRY(sail_check_cancellation(load_options->cancellation));
+
+    if ((load_options->options & SAIL_OPTION_FIRST_FRAME_ONLY) && state_of_mind->frames_loaded > 0) {
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    if (load_options->limits.max_frames > 0 && state_of_mind->frames_loaded >= load_options->limits.max_frames) {
+        SAIL_LOG_ERROR("The number of frames exceeds the limit of %u frames", load_options->limits.max_frames);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    /* Side structures of the frame are allocated in its arena. */
+    struct sail_arena *arena = NULL;
+
+    if (load_options->options & SAIL_OPTION_ARENA) {
+        SAIL_TRY(sail_alloc_arena(&arena));
+    }
+
+    struct sail_arena *previous_arena = sail_set_thread_arena(arena);
+
+    struct sail_image *image_local;
+    const sail_status_t status = state_of_mind->codec->v8->load_seek_next_frame(state_of_mind->state, &image_local);
+
+    if (status == SAIL_OK) {
+        image_local->arena = arena;
+        filter_meta_data(load_options, image_local);
+    }
+
+    sail_set_thread_arena(previous_arena);
+
+    SAIL_TRY_OR_CLEANUP(status,
+                        /* cleanup */ sail_destroy_arena(arena));
+
+    state_of_mind->frames_loaded++;
+
+    SAIL_TRY_OR_CLEANUP(check_sought_frame(load_options, state_of_mind->codec_info, image_local),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+/*
+ * Decodes the frame into the pixels buffer with the specified stride, cropping it if necessary.
+ * The image keeps the pixels buffer even on error.
+ */
+static sail_status_t load_frame_pixels(struct hidden_state *state_of_mind, struct sail_image *image,
+                                        const struct sail_roi *crop, void *pixels, unsigned bytes_per_line) {
+
+    if (crop == NULL) {
+        /* Codecs write rows with their own stride. */
+        const unsigned codec_bytes_per_line = image->bytes_per_line;
+
+        image->pixels = pixels;
+        SAIL_TRY(state_of_mind->codec->v8->load_frame(state_of_mind->state, image));
+
+        if (bytes_per_line > codec_bytes_per_line) {
+            spread_rows(image->pixels, image->height, codec_bytes_per_line, bytes_per_line);
+        }
+
+        image->bytes_per_line = bytes_per_line;
+
+        return SAIL_OK;
+    }
+
+    /* Decode the whole frame and copy the region of interest out of it. */
+    SAIL_TRY_OR_CLEANUP(sail_check_load_limits(state_of_mind->load_options, image->width, image->height,
+                                               (size_t)image->height * image->bytes_per_line),
+                        /* cleanup */ image->pixels = pixels);
+
+    const size_t frame_pixels_size = (size_t)image->height * image->bytes_per_line;
+
+    void *frame_pixels;
+    SAIL_TRY_OR_CLEANUP(alloc_frame_pixels(state_of_mind->load_options, frame_pixels_size, &frame_pixels),
+                        /* cleanup */ image->pixels = pixels);
+
+    image->pixels = frame_pixels;
+    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->load_frame(state_of_mind->state, image),
+                        /* cleanup */ free_frame_pixels(state_of_mind->load_options, frame_pixels, frame_pixels_size),
+                                      image->pixels = pixels);
+
+    const size_t offset = (size_t)crop->x * sail_bits_per_pixel(image->pixel_format) / 8;
+    const unsigned crop_bytes_per_line = sail_bytes_per_line(crop->width, image->pixel_format);
+
+    for (unsigned row = 0; row < crop->height; row++) {
+        unsigned char *scan_line = (unsigned char *)pixels + (size_t)row * bytes_per_line;
+
+        memcpy(scan_line, (const unsigned char *)sail_scan_line(image, crop->y + row) + offset, crop_bytes_per_line);
+        memset(scan_line + crop_bytes_per_line, 0, bytes_per_line - crop_bytes_per_line);
+    }
+
+    free_frame_pixels(state_of_mind->load_options, frame_pixels, frame_pixels_size);
+
+    image->pixels         = pixels;
+    image->width          = crop->width;
+    image->height         = crop->height;
+    image->bytes_per_line = bytes_per_line;
+
+    return SAIL_OK;
+}
+
+/* Forwards the rows of a region of interest to the row callback of the caller. */
+struct crop_rows {
+
+    sail_load_row_callback_t row_callback;
+    void *row_callback_user_data;
+    struct sail_roi roi;
+};
+
+static sail_status_t crop_row_callback(const struct sail_image *image, unsigned row, const void *scan_line, void *user_data) {
+
+    const struct crop_rows *crop_rows = user_data;
+
+    if (row < crop_rows->roi.y || row >= crop_rows->roi.y + crop_rows->roi.height) {
+        return SAIL_OK;
+    }
+
+    struct sail_image crop_image = *image;
+
+    crop_image.pixels         = NULL;
+    crop_image.width          = crop_rows->roi.width;
+    crop_image.height         = crop_rows->roi.height;
+    crop_image.bytes_per_line = sail_bytes_per_line(crop_rows->roi.width, image->pixel_format);
+
+    const size_t offset = (size_t)crop_rows->roi.x * sail_bits_per_pixel(image->pixel_format) / 8;
+
+    SAIL_TRY(crop_rows->row_callback(&crop_image, row - crop_rows->roi.y, (const unsigned char *)scan_line + offset,
+                                        crop_rows->row_callback_user_data));
+
+    return SAIL_OK;
+}
+
+/*
+ * Passes the decoded rows to the row callback. Codecs with the ROWS feature decode into a single row buffer,
+ * other codecs decode the whole frame into a temporary buffer. Codecs with the ROWS feature return
+ * SAIL_ERROR_NOT_IMPLEMENTED before reading the frame to decline decoding it row by row, for example,
+ * bottom-up BMP frames from unseekable I/O. Saves if the whole frame was decoded into 'rows_fallback'.
+ * The image has no pixels afterwards.
+ */
+static sail_status_t load_frame_rows(struct hidden_state *state_of_mind, struct sail_image *image, const struct sail_roi *crop,
+                                     bool *rows_fallback) {
+
+    struct sail_load_options *load_options = state_of_mind->load_options;
+
+    *rows_fallback = true;
+
+    if (state_of_mind->codec_info->load_features->features & SAIL_CODEC_FEATURE_ROWS) {
+        void *scan_line;
+        SAIL_TRY(sail_malloc(image->bytes_per_line, &scan_line));
+
+        const sail_load_row_callback_t row_callback = load_options->row_callback;
+        void *row_callback_user_data = load_options->row_callback_user_data;
+
+        struct crop_rows crop_rows;
+
+        /* Codecs keep a pointer to the load options, so crop rows on the fly. */
+        if (crop != NULL) {
+            crop_rows.row_callback           = row_callback;
+            crop_rows.row_callback_user_data = row_callback_user_data;
+            crop_rows.roi                    = *crop;
+
+            load_options->row_callback           = crop_row_callback;
+            load_options->row_callback_user_data = &crop_rows;
+        }
+
+        image->pixels = scan_line;
+        const sail_status_t status = state_of_mind->codec->v8->load_frame(state_of_mind->state, image);
+        image->pixels = NULL;
+
+        sail_free(scan_line);
+
+        load_options->row_callback           = row_callback;
+        load_options->row_callback_user_data = row_callback_user_data;
+
+        if (status != SAIL_ERROR_NOT_IMPLEMENTED) {
+            SAIL_TRY(status);
+
+            if (crop != NULL) {
+                image->width          = crop->width;
+                image->height         = crop->height;
+                image->bytes_per_line = sail_bytes_per_line(crop->width, image->pixel_format);
+            }
+
+            *rows_fallback = false;
+
+            return SAIL_OK;
+        }
+    }
+
+    const unsigned height         = (crop != NULL) ? crop->height : image->height;
+    const unsigned bytes_per_line = (crop != NULL) ? sail_bytes_per_line(crop->width, image->pixel_format) : image->bytes_per_line;
+
+    const size_t pixels_size = (size_t)height * bytes_per_line;
+
+    SAIL_TRY(sail_check_load_limits(load_options, image->width, image->height, pixels_size));
+
+    void *pixels;
+    SAIL_TRY(alloc_frame_pixels(load_options, pixels_size, &pixels));
+
+    /* Codecs without the ROWS feature decode the whole frame, so hide the row callback from them. */
+    const sail_load_row_callback_t row_callback = load_options->row_callback;
+    load_options->row_callback = NULL;
+
+    const sail_status_t status = load_frame_pixels(state_of_mind, image, crop, pixels, bytes_per_line);
+
+    load_options->row_callback = row_callback;
+
+    SAIL_TRY_OR_CLEANUP(status,
+                        /* cleanup */ free_frame_pixels(load_options, pixels, pixels_size),
+                                      image->pixels = NULL);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        SAIL_TRY_OR_CLEANUP(sail_check_cancellation(load_options->cancellation),
+                            /* cleanup */ free_frame_pixels(load_options, pixels, pixels_size),
+                                          image->pixels = NULL);
+        SAIL_TRY_OR_CLEANUP(row_callback(image, row, sail_scan_line(image, row), load_options->row_callback_user_data),
+                            /* cleanup */ free_frame_pixels(load_options, pixels, pixels_size),
+                                          image->pixels = NULL);
+    }
+
+    free_frame_pixels(load_options, pixels, pixels_size);
+    image->pixels = NULL;
+
+    return SAIL_OK;
+}
+
+/*
+ * Saves the frame with rows requested from the row callback. Codecs with the ROWS feature request rows
+ * into a single row buffer, other codecs get the whole frame requested into a temporary buffer.
+ */
+static sail_status_t write_frame_rows(struct hidden_state *state_of_mind, const struct sail_image *image) {
+
+    struct sail_save_options *save_options = state_of_mind->save_options;
+
+    struct sail_image image_rows = *image;
+
+    if (image_rows.bytes_per_line == 0) {
+        image_rows.bytes_per_line = sail_bytes_per_line(image_rows.width, image_rows.pixel_format);
+    }
+
+    const bool native_rows = state_of_mind->codec_info->save_features->features & SAIL_CODEC_FEATURE_ROWS;
+    const size_t pixels_size = native_rows ? image_rows.bytes_per_line : (size_t)image_rows.height * image_rows.bytes_per_line;
+
+    void *pixels;
+    SAIL_TRY(sail_malloc(pixels_size, &pixels));
+    image_rows.pixels = pixels;
+
+    /* Codecs without the ROWS feature get the whole frame, so hide the row callback from them. */
+    const sail_save_row_callback_t row_callback = save_options->row_callback;
+
+    if (!native_rows) {
+        for (unsigned row = 0; row < image_rows.height; row++) {
+            SAIL_TRY_OR_CLEANUP(sail_check_cancellation(save_options->cancellation),
+                                /* cleanup */ sail_free(pixels));
+            SAIL_TRY_OR_CLEANUP(row_callback(&image_rows, row, sail_scan_line(&image_rows, row), save_options->row_callback_user_data),
+                                /* cleanup */ sail_free(pixels));
+        }
+
+        save_options->row_callback = NULL;
+    }
+
+    sail_status_t status = state_of_mind->codec->v8->save_seek_next_frame(state_of_mind->state, &image_rows);
+
+    if (status == SAIL_OK) {
+        status = state_of_mind->codec->v8->save_frame(state_of_mind->state, &image_rows);
+    }
+
+    save_options->row_callback = row_callback;
+    sail_free(pixels);
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
+
+/* Stores the SAIL diagnostics of the loaded frame. See SAIL_OPTION_DIAGNOSTICS. */
+static sail_status_t store_frame_diagnostics(const struct hidden_state *state_of_mind, struct sail_image *image, bool crop,
+                                             bool rows_fallback) {
+
+    const struct sail_load_options *load_options = state_of_mind->load_options;
+
+    if (!(load_options->options & SAIL_OPTION_DIAGNOSTICS)) {
+        return SAIL_OK;
+    }
+
+    size_t offset;
+
+    if (state_of_mind->io->tell(state_of_mind->io->stream, &offset) == SAIL_OK && offset >= state_of_mind->load_start_offset) {
+        SAIL_TRY(sail_put_load_diagnostic_unsigned_long(load_options, image, "bytes-read",
+                                                        (unsigned long)(offset - state_of_mind->load_start_offset)));
+    }
+
+    if (load_options->output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN) {
+        SAIL_TRY(sail_put_load_diagnostic_bool(load_options, image, "native-output-pixel-format",
+                                               image->pixel_format == load_options->output_pixel_format));
+    }
+
+    if (sail_roi_is_set(&load_options->roi)) {
+        SAIL_TRY(sail_put_load_diagnostic_bool(load_options, image, "crop-fallback", crop));
+    }
+
+    if (load_options->row_callback != NULL) {
+        SAIL_TRY(sail_put_load_diagnostic_bool(load_options, image, "rows-fallback", rows_fallback));
+    }
+
+    return SAIL_OK;
+}
+
+/*
+ * Loads the pixels of the frame returned by seek_next_frame(). Destroys the frame on error.
+ */
+static sail_status_t load_sought_frame(struct hidden_state *state_of_mind, struct sail_image *image_local) {
+
+    const unsigned row_alignment    = state_of_mind->load_options->row_alignment;
+    const unsigned pixels_alignment = state_of_mind->load_options->pixels_alignment;
+
+    if (!is_valid_alignment(row_alignment) || !is_valid_alignment(pixels_alignment)) {
+        SAIL_LOG_ERROR("Row alignment %u and pixels alignment %u must be powers of two", row_alignment, pixels_alignment);
+        sail_destroy_image(image_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    bool crop;
+    struct sail_roi roi;
+    SAIL_TRY_OR_CLEANUP(frame_crop(state_of_mind, image_local, &crop, &roi),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    if (state_of_mind->load_options->row_callback != NULL) {
+        bool rows_fallback;
+        SAIL_TRY_OR_CLEANUP(load_frame_rows(state_of_mind, image_local, crop ? &roi : NULL, &rows_fallback),
+                            /* cleanup */ sail_destroy_image(image_local));
+        SAIL_TRY_OR_CLEANUP(store_frame_diagnostics(state_of_mind, image_local, crop, rows_fallback),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        return SAIL_OK;
+    }
+
+    const unsigned height = crop ? roi.height : image_local->height;
+    const unsigned packed_bytes_per_line = crop ? sail_bytes_per_line(roi.width, image_local->pixel_format) : image_local->bytes_per_line;
+    const unsigned bytes_per_line = (row_alignment > 1 && !sail_is_planar(image_local->pixel_format) && !sail_is_block_compressed(image_local->pixel_format))
+                                        ? (packed_bytes_per_line + row_alignment - 1) & ~(row_alignment - 1)
+                                        : packed_bytes_per_line;
+
+    /* Allocate pixels. */
+    const size_t pixels_size = (size_t)height * bytes_per_line;
+
+    SAIL_TRY_OR_CLEANUP(sail_check_load_limits(state_of_mind->load_options, image_local->width, image_local->height, pixels_size),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    void *pixels;
+
+    if (is_file_backed(state_of_mind->load_options, pixels_size)) {
+        SAIL_TRY_OR_CLEANUP(sail_alloc_file_backed_memory(pixels_size, &pixels),
+                            /* cleanup */ sail_destroy_image(image_local));
+
+        image_local->pixels_file_backed_size = pixels_size;
+    } else {
+        image_local->pixels_alignment = (pixels_alignment > 1) ? pixels_alignment : 0;
+
+        SAIL_TRY_OR_CLEANUP(alloc_pixels(state_of_mind, pixels_size, image_local->pixels_alignment, &pixels),
+                            /* cleanup */ sail_destroy_image(image_local));
+    }
+
+    SAIL_TRY_OR_CLEANUP(load_frame_pixels(state_of_mind, image_local, crop ? &roi : NULL, pixels, bytes_per_line),
+                        /* cleanup */ sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(store_frame_diagnostics(state_of_mind, image_local, crop, false),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    return SAIL_OK;
+}
+
+/* Seeks to the next frame and measures the seek stage. */
+static sail_status_t measured_seek_next_frame(struct hidden_state *state_of_mind, struct sail_image **image) {
+
+    struct stage_scope stage_scope;
+    begin_stage_scope(state_of_mind->load_options->stats, "load_seek_next_frame", state_of_mind->codec_info, NULL, &stage_scope);
+
+    const sail_status_t status = seek_next_frame(state_of_mind, image);
+
+    end_stage_scope(&stage_scope, STATS_STAGE_SEEK, (status == SAIL_OK) ? *image : NULL, status);
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
+
+/* Adds a successfully loaded or saved frame to the stats. */
+static void count_frame(const struct hidden_state *state_of_mind) {
+
+    struct sail_stats *stats = hidden_state_stats(state_of_mind);
+
+    if (stats != NULL) {
+        stats->frames++;
+    }
+}
+
+/* Finds the JPEG thumbnail embedded into the EXIF meta data of the frame. */
+static bool find_exif_thumbnail(const struct sail_image *image, const void **thumbnail, size_t *thumbnail_size) {
+
+    for (const struct sail_meta_data_node *node = image->meta_data_node; node != NULL; node = node->next) {
+        if (node->meta_data->key == SAIL_META_DATA_EXIF && node->meta_data->value->type == SAIL_VARIANT_TYPE_DATA
+                && exif_thumbnail(sail_variant_to_data(node->meta_data->value), node->meta_data->value->size, thumbnail, thumbnail_size)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Public functions.
+ */
+
 sail_status_t sail_probe_io(struct sail_io *io, struct sail_image **image, const struct sail_codec_info **codec_info) {
 
     SAIL_CHECK_PTR(io);
@@ -48,14 +578,17 @@ sail_status_t sail_probe_io(struct sail_io *io, struct sail_image **image, const
                         /* cleanup */ codec->v8->load_finish(&state),
                                       sail_destroy_load_options(load_options_local));
 
-    sail_destroy_load_options(load_options_local);
-
+    /* Codecs keep a pointer to the load options, so destroy them after finishing. */
     struct sail_image *image_local;
 
     SAIL_TRY_OR_CLEANUP(codec->v8->load_seek_next_frame(state, &image_local),
-                        /* cleanup */ codec->v8->load_finish(&state));
+                        /* cleanup */ codec->v8->load_finish(&state),
+                                      sail_destroy_load_options(load_options_local));
     SAIL_TRY_OR_CLEANUP(codec->v8->load_finish(&state),
-                        /* ceanup */ sail_destroy_image(image_local));
+                        /* ceanup */ sail_destroy_image(image_local),
+                                     sail_destroy_load_options(load_options_local));
+
+    sail_destroy_load_options(load_options_local);
 
     *image = image_local;
 
@@ -77,6 +610,78 @@ sail_status_t sail_probe_memory(const void *buffer, size_t buffer_size, struct s
     return SAIL_OK;
 }
 
+sail_status_t sail_load_thumbnail_from_io(struct sail_io *io, const struct sail_codec_info *codec_info, struct sail_image **image) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(image);
+
+    const struct sail_codec_info *codec_info_local = codec_info;
+
+    if (codec_info_local == NULL) {
+        SAIL_TRY(sail_codec_info_by_magic_number_from_io(io, &codec_info_local));
+    }
+
+    struct sail_load_options *load_options;
+    SAIL_TRY(sail_alloc_load_options_from_features(codec_info_local->load_features, &load_options));
+
+    /* EXIF is the only meta data needed, and the fallback decodes at the lowest resolution. */
+    load_options->options          &= SAIL_OPTION_META_DATA;
+    load_options->meta_data_keys    = SAIL_META_DATA_KEY_BIT(SAIL_META_DATA_EXIF);
+    load_options->scale_denominator = 8;
+
+    void *state;
+    SAIL_TRY_OR_CLEANUP(start_loading_io_with_options(NULL, io, false, codec_info_local, load_options, false, &state),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+
+    sail_destroy_load_options(load_options);
+
+    struct hidden_state *state_of_mind = state;
+
+    struct sail_image *image_local;
+    SAIL_TRY_OR_CLEANUP(seek_next_frame(state_of_mind, &image_local),
+                        /* cleanup */ sail_stop_loading(state));
+
+    const void *thumbnail_data;
+    size_t thumbnail_data_size;
+    struct sail_image *thumbnail = NULL;
+
+    if (find_exif_thumbnail(image_local, &thumbnail_data, &thumbnail_data_size)
+            && sail_load_from_memory(thumbnail_data, thumbnail_data_size, &thumbnail) != SAIL_OK) {
+        SAIL_LOG_WARNING("Failed to load the embedded thumbnail, loading the scaled image instead");
+        thumbnail = NULL;
+    }
+
+    if (thumbnail != NULL) {
+        sail_destroy_image(image_local);
+        image_local = thumbnail;
+    } else {
+        SAIL_TRY_OR_CLEANUP(load_sought_frame(state_of_mind, image_local),
+                            /* cleanup */ sail_stop_loading(state));
+    }
+
+    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_load_thumbnail_from_memory(const void *buffer, size_t buffer_size, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(buffer);
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_memory(buffer, buffer_size, &io));
+
+    SAIL_TRY_OR_CLEANUP(sail_load_thumbnail_from_io(io, NULL, image),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_start_loading_from_file(const char *path, const struct sail_codec_info *codec_info, void **state) {
 
     SAIL_TRY(sail_start_loading_from_file_with_options(path, codec_info, NULL, state));
@@ -103,23 +708,167 @@ sail_status_t sail_load_next_frame(void *state, struct sail_image **image) {
     SAIL_CHECK_PTR(state_of_mind->codec);
 
     struct sail_image *image_local;
-    SAIL_TRY(state_of_mind->codec->v8->load_seek_next_frame(state_of_mind->state, &image_local));
+    SAIL_TRY(measured_seek_next_frame(state_of_mind, &image_local));
 
-    if (image_local->pixels != NULL) {
-        SAIL_LOG_ERROR("Internal error in %s codec: codecs must not allocate pixels", state_of_mind->codec_info->name);
-        sail_destroy_image(image_local);
+    /* Header-only mode. */
+    if (state_of_mind->load_options->options & SAIL_OPTION_PROBE) {
+        *image = image_local;
+        return SAIL_OK;
+    }
+
+    struct stage_scope stage_scope;
+    begin_stage_scope(state_of_mind->load_options->stats, "load_frame", state_of_mind->codec_info, image_local, &stage_scope);
+
+    const sail_status_t status = load_sought_frame(state_of_mind, image_local);
+
+    end_stage_scope(&stage_scope, STATS_STAGE_FRAMES, (status == SAIL_OK) ? image_local : NULL, status);
+
+    SAIL_TRY(status);
+
+    count_frame(state_of_mind);
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_load_frame_at(void *state, unsigned frame, struct sail_image **image) {
+
+    SAIL_CHECK_PTR(state);
+    SAIL_CHECK_PTR(image);
+
+    struct hidden_state *state_of_mind = (struct hidden_state *)state;
+
+    SAIL_TRY(sail_check_io_valid(state_of_mind->io));
+    SAIL_CHECK_PTR(state_of_mind->state);
+    SAIL_CHECK_PTR(state_of_mind->codec);
+
+    if (state_of_mind->codec->v8->load_seek_frame == NULL) {
+        SAIL_LOG_ERROR("%s codec cannot seek to frames", state_of_mind->codec_info->name);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NOT_IMPLEMENTED);
+    }
+
+    struct stage_scope stage_scope;
+    begin_stage_scope(state_of_mind->load_options->stats, "load_seek_frame", state_of_mind->codec_info, NULL, &stage_scope);
+
+    const sail_status_t status = state_of_mind->codec->v8->load_seek_frame(state_of_mind->state, frame);
+
+    end_stage_scope(&stage_scope, STATS_STAGE_SEEK, NULL, status);
+
+    SAIL_TRY(status);
+
+    SAIL_TRY(sail_load_next_frame(state, image));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_load_next_frame_into(void *state, struct sail_image *image, size_t pixels_size) {
+
+    SAIL_CHECK_PTR(state);
+    SAIL_CHECK_PTR(image);
+    SAIL_CHECK_PTR(image->pixels);
+
+    struct hidden_state *state_of_mind = (struct hidden_state *)state;
+
+    SAIL_TRY(sail_check_io_valid(state_of_mind->io));
+    SAIL_CHECK_PTR(state_of_mind->state);
+    SAIL_CHECK_PTR(state_of_mind->codec);
+
+    if (state_of_mind->load_options->options & SAIL_OPTION_PROBE) {
+        SAIL_LOG_ERROR("Cannot load pixels into a caller buffer in the probe mode");
         SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
     }
 
-    /* Allocate pixels. */
-    const size_t pixels_size = (size_t)image_local->height * image_local->bytes_per_line;
-    SAIL_TRY_OR_CLEANUP(sail_malloc(pixels_size, &image_local->pixels),
-                        /* cleanup */ sail_destroy_image(image_local));
+    if (state_of_mind->load_options->row_callback != NULL) {
+        SAIL_LOG_ERROR("Cannot load pixels into a caller buffer with the row callback set");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY(measured_seek_next_frame(state_of_mind, &image_local));
 
-    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->load_frame(state_of_mind->state, image_local),
+    bool crop;
+    struct sail_roi roi;
+    SAIL_TRY_OR_CLEANUP(frame_crop(state_of_mind, image_local, &crop, &roi),
                         /* cleanup */ sail_destroy_image(image_local));
 
-    *image = image_local;
+    const unsigned height = crop ? roi.height : image_local->height;
+    const unsigned packed_bytes_per_line = crop ? sail_bytes_per_line(roi.width, image_local->pixel_format) : image_local->bytes_per_line;
+    const unsigned bytes_per_line = (image->bytes_per_line == 0) ? packed_bytes_per_line : image->bytes_per_line;
+
+    if (bytes_per_line < packed_bytes_per_line) {
+        SAIL_LOG_ERROR("Stride %u is less than %u bytes per line of the frame", bytes_per_line, packed_bytes_per_line);
+        sail_destroy_image(image_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+    }
+
+    if ((sail_is_planar(image_local->pixel_format) || sail_is_block_compressed(image_local->pixel_format))
+            && bytes_per_line != packed_bytes_per_line) {
+        SAIL_LOG_ERROR("%s frames cannot be loaded with stride %u", sail_pixel_format_to_string(image_local->pixel_format), bytes_per_line);
+        sail_destroy_image(image_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+    }
+
+    if (pixels_size < (size_t)height * bytes_per_line) {
+        SAIL_LOG_ERROR("Pixel buffer is too small for %ux%u frame with stride %u",
+                        crop ? roi.width : image_local->width, height, bytes_per_line);
+        sail_destroy_image(image_local);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+
+    struct stage_scope stage_scope;
+    begin_stage_scope(state_of_mind->load_options->stats, "load_frame", state_of_mind->codec_info, image_local, &stage_scope);
+
+    const sail_status_t status = load_frame_pixels(state_of_mind, image_local, crop ? &roi : NULL, image->pixels, bytes_per_line);
+
+    end_stage_scope(&stage_scope, STATS_STAGE_FRAMES, image_local, status);
+
+    SAIL_TRY_OR_CLEANUP(status,
+                        /* cleanup */ image_local->pixels = NULL,
+                                      sail_destroy_image(image_local));
+    SAIL_TRY_OR_CLEANUP(store_frame_diagnostics(state_of_mind, image_local, crop, false),
+                        /* cleanup */ image_local->pixels = NULL,
+                                      sail_destroy_image(image_local));
+
+    count_frame(state_of_mind);
+
+    /* Replace the properties of the previous frame. */
+    image->pixels = NULL;
+    sail_destroy_resolution(image->resolution);
+    sail_destroy_palette(image->palette);
+    sail_destroy_meta_data_node_chain(image->meta_data_node);
+    sail_destroy_iccp(image->iccp);
+    sail_destroy_source_image(image->source_image);
+    sail_destroy_arena(image->arena);
+
+    *image = *image_local;
+    sail_free(image_local);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_recycle_image(void *state, struct sail_image *image) {
+
+    SAIL_CHECK_PTR(state);
+
+    if (image == NULL) {
+        return SAIL_OK;
+    }
+
+    struct hidden_state *state_of_mind = (struct hidden_state *)state;
+
+    /* File-backed pixels are rare and large, so they're not recycled. */
+    if (image->pixels != NULL && !image->pixels_borrowed && image->pixels_file_backed_size == 0 && state_of_mind->recycled_pixels_count < SAIL_RECYCLED_PIXELS_MAX) {
+        struct recycled_pixels *recycled_pixels = &state_of_mind->recycled_pixels[state_of_mind->recycled_pixels_count++];
+
+        recycled_pixels->pixels           = image->pixels;
+        recycled_pixels->pixels_size      = (size_t)image->height * image->bytes_per_line;
+        recycled_pixels->pixels_alignment = image->pixels_alignment;
+
+        image->pixels = NULL;
+    }
+
+    sail_destroy_image(image);
 
     return SAIL_OK;
 }
@@ -134,12 +883,19 @@ sail_status_t sail_stop_loading(void *state) {
     struct hidden_state *state_of_mind = (struct hidden_state *)state;
 
     /* Not an error. */
-    if (state_of_mind->codec == NULL) {
+    if (state_of_mind->codec == NULL || state_of_mind->state == NULL) {
         destroy_hidden_state(state_of_mind);
         return SAIL_OK;
     }
 
-    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->load_finish(&state_of_mind->state),
+    struct stage_scope stage_scope;
+    begin_stage_scope(state_of_mind->load_options->stats, "load_finish", state_of_mind->codec_info, NULL, &stage_scope);
+
+    const sail_status_t status = state_of_mind->codec->v8->load_finish(&state_of_mind->state);
+
+    end_stage_scope(&stage_scope, STATS_STAGE_FINISH, NULL, status);
+
+    SAIL_TRY_OR_CLEANUP(status,
                         /* cleanup */ destroy_hidden_state(state_of_mind));
 
     destroy_hidden_state(state_of_mind);
@@ -161,6 +917,13 @@ sail_status_t sail_start_saving_into_memory(void *buffer, size_t buffer_size, co
     return SAIL_OK;
 }
 
+sail_status_t sail_start_saving_into_growable_memory(const struct sail_codec_info *codec_info, void **state) {
+
+    SAIL_TRY(sail_start_saving_into_growable_memory_with_options(codec_info, NULL, state));
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_write_next_frame(void *state, const struct sail_image *image) {
 
     SAIL_CHECK_PTR(state);
@@ -173,19 +936,47 @@ sail_status_t sail_write_next_frame(void *state, const struct sail_image *image)
     SAIL_CHECK_PTR(state_of_mind->codec_info);
     SAIL_CHECK_PTR(state_of_mind->codec);
 
+    SAIL_TRY(sail_check_cancellation(state_of_mind->save_options->cancellation));
+
     /* Check if we actually able to save the requested pixel format. */
     SAIL_TRY(allowed_write_output_pixel_format(state_of_mind->codec_info->save_features,
                                                 image->pixel_format));
 
-    SAIL_TRY(state_of_mind->codec->v8->save_seek_next_frame(state_of_mind->state, image));
-    SAIL_TRY(state_of_mind->codec->v8->save_frame(state_of_mind->state, image));
+    struct stage_scope stage_scope;
+    sail_status_t status;
+
+    if (state_of_mind->save_options->row_callback != NULL) {
+        begin_stage_scope(state_of_mind->save_options->stats, "save_frame", state_of_mind->codec_info, image, &stage_scope);
+        status = write_frame_rows(state_of_mind, image);
+        end_stage_scope(&stage_scope, STATS_STAGE_FRAMES, image, status);
+
+        SAIL_TRY(status);
+
+        count_frame(state_of_mind);
+
+        return SAIL_OK;
+    }
+
+    begin_stage_scope(state_of_mind->save_options->stats, "save_seek_next_frame", state_of_mind->codec_info, image, &stage_scope);
+    status = state_of_mind->codec->v8->save_seek_next_frame(state_of_mind->state, image);
+    end_stage_scope(&stage_scope, STATS_STAGE_SEEK, image, status);
+
+    SAIL_TRY(status);
+
+    begin_stage_scope(state_of_mind->save_options->stats, "save_frame", state_of_mind->codec_info, image, &stage_scope);
+    status = state_of_mind->codec->v8->save_frame(state_of_mind->state, image);
+    end_stage_scope(&stage_scope, STATS_STAGE_FRAMES, image, status);
+
+    SAIL_TRY(status);
+
+    count_frame(state_of_mind);
 
     return SAIL_OK;
 }
 
 sail_status_t sail_stop_saving(void *state) {
 
-    SAIL_TRY(stop_saving(state, NULL));
+    SAIL_TRY(stop_saving(state, NULL, NULL));
 
     return SAIL_OK;
 }
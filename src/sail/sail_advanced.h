@@ -64,6 +64,30 @@ SAIL_EXPORT sail_status_t sail_probe_io(struct sail_io *io, struct sail_image **
 SAIL_EXPORT sail_status_t sail_probe_memory(const void *buffer, size_t buffer_size,
                                             struct sail_image **image, const struct sail_codec_info **codec_info);
 
+/*
+ * Loads a small preview of the first frame from the specified I/O source. Pass codec info if you would like
+ * to load it with a specific codec. If not, just pass NULL, and SAIL will detect it automatically.
+ *
+ * If the image has EXIF meta data with a JPEG thumbnail, for example, a camera JPEG, the thumbnail
+ * is loaded instead of the image. Otherwise, the image is loaded at the lowest resolution the codec
+ * can decode, or at the full resolution if the codec doesn't support SAIL_CODEC_FEATURE_SCALING.
+ * The thumbnail size is not guaranteed. Use sail-manip to scale it further.
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_load_thumbnail_from_io(struct sail_io *io, const struct sail_codec_info *codec_info, struct sail_image **image);
+
+/*
+ * Loads a small preview of the first frame from the specified memory buffer. See sail_load_thumbnail_from_io().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_load_thumbnail_from_memory(const void *buffer, size_t buffer_size, struct sail_image **image);
+
 /*
  * Starts loading the specified image file. Pass codec info if you would like to start loading
  * with a specific codec. If not, just pass NULL, and SAIL will detect it automatically.
@@ -102,14 +126,86 @@ SAIL_EXPORT sail_status_t sail_start_loading_from_file(const char *path, const s
 SAIL_EXPORT sail_status_t sail_start_loading_from_memory(const void *buffer, size_t buffer_size,
                                                          const struct sail_codec_info *codec_info, void **state);
 
+/*
+ * Starts saving into a memory buffer allocated and grown by SAIL, so no upper bound
+ * of the output size is needed.
+ *
+ * Typical usage: sail_codec_info_from_extension()          ->
+ *                sail_start_saving_into_growable_memory()  ->
+ *                sail_write_next_frame()                   ->
+ *                sail_stop_saving_into_growable_memory().
+ *
+ * STATE explanation: Passes the address of a local void* pointer. SAIL will store an internal state
+ * in it and destroy it in sail_stop_saving_into_growable_memory(). States must be used per image.
+ * DO NOT use the same state to start saving multiple images at the same time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_start_saving_into_growable_memory(const struct sail_codec_info *codec_info, void **state);
+
 /*
  * Continues loading the file started by sail_start_loading_from_file() and brothers.
+ * If the loading was started with SAIL_OPTION_PROBE, the returned frame has no pixels.
+ * If the loading was started with sail_load_options.row_callback, the decoded rows are passed
+ * to the callback, and the returned frame has no pixels either.
  *
  * Returns SAIL_OK on success.
  * Returns SAIL_ERROR_NO_MORE_FRAMES when no more frames are available.
  */
 SAIL_EXPORT sail_status_t sail_load_next_frame(void *state, struct sail_image **image);
 
+/*
+ * Continues loading the file started by sail_start_loading_from_file() and brothers into the pixel
+ * buffer provided by the caller. Use it to decode animations or batches of images into a reused
+ * or mapped buffer without allocating pixels for every frame.
+ *
+ * The caller sets image->pixels to a buffer of 'pixels_size' bytes and image->bytes_per_line
+ * to the stride of the buffer, or to 0 to use tightly packed rows. On success, all the other image
+ * properties are replaced with the properties of the new frame, and image->bytes_per_line is set
+ * to the actual stride. The pixels are never freed or reallocated by SAIL, so set image->pixels
+ * to NULL before destroying the image with sail_destroy_image() if you own the buffer.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NO_MORE_FRAMES when no more frames are available.
+ * Returns SAIL_ERROR_INCORRECT_BYTES_PER_LINE when the stride is less than the frame needs.
+ * Returns SAIL_ERROR_INVALID_ARGUMENT when the buffer is too small for the frame.
+ */
+SAIL_EXPORT sail_status_t sail_load_next_frame_into(void *state, struct sail_image *image, size_t pixels_size);
+
+/*
+ * Seeks to the frame with the specified zero-based index and loads it like sail_load_next_frame()
+ * without loading the preceding frames. Frames can be loaded in any order. Subsequent
+ * sail_load_next_frame() calls continue with the frames following the loaded one.
+ *
+ * Only codecs with the SEEK load feature support seeking. See sail_codec_info.load_features.
+ *
+ * Returns SAIL_OK on success.
+ * Returns SAIL_ERROR_NO_MORE_FRAMES when the frame doesn't exist.
+ * Returns SAIL_ERROR_NOT_IMPLEMENTED when the codec cannot seek.
+ */
+SAIL_EXPORT sail_status_t sail_load_frame_at(void *state, unsigned frame, struct sail_image **image);
+
+/*
+ * Returns the frame loaded with sail_load_next_frame() back to the loading state to reuse its pixels.
+ * The next sail_load_next_frame() call with the same state reuses the pixels buffer instead
+ * of allocating a new one if the frame size matches, so decoding animations with identical frames
+ * doesn't allocate pixels for every frame. Up to SAIL_RECYCLED_PIXELS_MAX buffers are kept. They're freed
+ * in sail_stop_loading().
+ *
+ * Takes the ownership of the image and destroys it. The image MUST NOT be used anymore after calling
+ * this function. Does nothing if the image is NULL.
+ *
+ * Typical usage: sail_start_loading_from_file() ->
+ *                sail_load_next_frame()         ->
+ *                sail_recycle_image()           ->
+ *                sail_load_next_frame()         ->
+ *                sail_recycle_image()           ->
+ *                sail_stop_loading().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_recycle_image(void *state, struct sail_image *image);
+
 /*
  * Stops loading the file started by sail_start_loading_from_file() and brothers.
  * Does nothing if the state is NULL.
@@ -167,6 +263,9 @@ SAIL_EXPORT sail_status_t sail_start_saving_into_memory(void *buffer, size_t buf
  * Consider converting the image into a supported image format beforehand with functions
  * from sail-manip.
  *
+ * If the saving was started with sail_save_options.row_callback, the image pixels are ignored
+ * and may be NULL. The rows are requested from the callback instead.
+ *
  * Returns SAIL_OK on success.
  */
 SAIL_EXPORT sail_status_t sail_write_next_frame(void *state, const struct sail_image *image);
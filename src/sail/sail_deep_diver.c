@@ -35,7 +35,14 @@ sail_status_t sail_start_loading_from_file_with_options(const char *path, const
     const struct sail_codec_info *codec_info_local;
 
     if (codec_info == NULL) {
-        SAIL_TRY(sail_codec_info_from_path(path, &codec_info_local));
+        struct stage_scope stage_scope;
+        begin_stage_scope((load_options == NULL) ? NULL : load_options->stats, "detect_codec", NULL, NULL, &stage_scope);
+
+        const sail_status_t status = sail_codec_info_from_path(path, &codec_info_local);
+
+        end_stage_scope(&stage_scope, STATS_STAGE_DETECTION, NULL, status);
+
+        SAIL_TRY(status);
     } else {
         codec_info_local = codec_info;
     }
@@ -43,7 +50,7 @@ sail_status_t sail_start_loading_from_file_with_options(const char *path, const
     struct sail_io *io;
     SAIL_TRY(sail_alloc_io_read_file(path, &io));
 
-    SAIL_TRY(start_loading_io_with_options(io, true, codec_info_local, load_options, state));
+    SAIL_TRY(start_loading_io_with_options(NULL, io, true, codec_info_local, load_options, false, state));
 
     return SAIL_OK;
 }
@@ -57,7 +64,14 @@ sail_status_t sail_start_loading_from_memory_with_options(const void *buffer, si
     const struct sail_codec_info *codec_info_local;
 
     if (codec_info == NULL) {
-        SAIL_TRY(sail_codec_info_by_magic_number_from_memory(buffer, buffer_size, &codec_info_local));
+        struct stage_scope stage_scope;
+        begin_stage_scope((load_options == NULL) ? NULL : load_options->stats, "detect_codec", NULL, NULL, &stage_scope);
+
+        const sail_status_t status = sail_codec_info_by_magic_number_from_memory(buffer, buffer_size, &codec_info_local);
+
+        end_stage_scope(&stage_scope, STATS_STAGE_DETECTION, NULL, status);
+
+        SAIL_TRY(status);
     } else {
         codec_info_local = codec_info;
     }
@@ -65,7 +79,31 @@ sail_status_t sail_start_loading_from_memory_with_options(const void *buffer, si
     struct sail_io *io;
     SAIL_TRY(sail_alloc_io_read_memory(buffer, buffer_size, &io));
 
-    SAIL_TRY(start_loading_io_with_options(io, true, codec_info_local, load_options, state));
+    SAIL_TRY(start_loading_io_with_options(NULL, io, true, codec_info_local, load_options, false, state));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_restart_loading_from_file(void *state, const char *path) {
+
+    SAIL_CHECK_PTR(path);
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_file(path, &io));
+
+    SAIL_TRY(restart_loading_io(state, io, true));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_restart_loading_from_memory(void *state, const void *buffer, size_t buffer_size) {
+
+    SAIL_CHECK_PTR(buffer);
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_memory(buffer, buffer_size, &io));
+
+    SAIL_TRY(restart_loading_io(state, io, true));
 
     return SAIL_OK;
 }
@@ -78,7 +116,14 @@ sail_status_t sail_start_saving_into_file_with_options(const char *path, const s
     const struct sail_codec_info *codec_info_local;
 
     if (codec_info == NULL) {
-        SAIL_TRY(sail_codec_info_from_path(path, &codec_info_local));
+        struct stage_scope stage_scope;
+        begin_stage_scope((save_options == NULL) ? NULL : save_options->stats, "detect_codec", NULL, NULL, &stage_scope);
+
+        const sail_status_t status = sail_codec_info_from_path(path, &codec_info_local);
+
+        end_stage_scope(&stage_scope, STATS_STAGE_DETECTION, NULL, status);
+
+        SAIL_TRY(status);
     } else {
         codec_info_local = codec_info;
     }
@@ -87,7 +132,7 @@ sail_status_t sail_start_saving_into_file_with_options(const char *path, const s
     SAIL_TRY(sail_alloc_io_read_write_file(path, &io));
 
     /* The I/O object will be destroyed in this function. */
-    SAIL_TRY(start_saving_io_with_options(io, true, codec_info_local, save_options, state));
+    SAIL_TRY(start_saving_io_with_options(NULL, io, true, codec_info_local, save_options, false, state));
 
     return SAIL_OK;
 }
@@ -102,14 +147,38 @@ sail_status_t sail_start_saving_into_memory_with_options(void *buffer, size_t bu
     SAIL_TRY(sail_alloc_io_read_write_memory(buffer, buffer_size, &io));
 
     /* The I/O object will be destroyed in this function. */
-    SAIL_TRY(start_saving_io_with_options(io, true, codec_info, save_options, state));
+    SAIL_TRY(start_saving_io_with_options(NULL, io, true, codec_info, save_options, false, state));
 
     return SAIL_OK;
 }
 
 sail_status_t sail_stop_saving_with_written(void *state, size_t *written) {
 
-    SAIL_TRY(stop_saving(state, written));
+    SAIL_TRY(stop_saving(state, written, NULL));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_start_saving_into_growable_memory_with_options(const struct sail_codec_info *codec_info,
+                                                                  const struct sail_save_options *save_options,
+                                                                  void **state) {
+    SAIL_CHECK_PTR(codec_info);
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_write_growable_memory(&io));
+
+    /* The I/O object will be destroyed in this function. */
+    SAIL_TRY(start_saving_io_with_options(NULL, io, true, codec_info, save_options, false, state));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_stop_saving_into_growable_memory(void *state, void **buffer, size_t *buffer_size) {
+
+    SAIL_CHECK_PTR(buffer);
+    SAIL_CHECK_PTR(buffer_size);
+
+    SAIL_TRY(stop_saving(state, buffer_size, buffer));
 
     return SAIL_OK;
 }
@@ -86,6 +86,16 @@ SAIL_EXPORT sail_status_t sail_start_loading_from_memory_with_options(const void
                                                                       const struct sail_codec_info *codec_info,
                                                                       const struct sail_load_options *load_options, void **state);
 
+/*
+ * Starts loading the specified image file or memory buffer with the state of a previous loading operation,
+ * its codec, and load options. See sail_restart_loading_from_io().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_restart_loading_from_file(void *state, const char *path);
+
+SAIL_EXPORT sail_status_t sail_restart_loading_from_memory(void *state, const void *buffer, size_t buffer_size);
+
 /*
  * Starts saving the specified image file with the specified save options. Pass codec info if you would like
  * to start saving with a specific codec. If not, just pass NULL, and SAIL will detect it automatically.
@@ -133,10 +143,34 @@ SAIL_EXPORT sail_status_t sail_start_saving_into_memory_with_options(void *buffe
                                                                      const struct sail_codec_info *codec_info,
                                                                      const struct sail_save_options *save_options, void **state);
 
+/*
+ * Starts saving into a memory buffer allocated and grown by SAIL with the specified save options.
+ * If you do not need specific save options, just pass NULL. Codec-specific defaults will be used in this case.
+ * No upper bound of the output size is needed. Use sail_stop_saving_into_growable_memory() to stop saving
+ * and take the buffer.
+ *
+ * The save options are deep copied.
+ *
+ * Typical usage: sail_codec_info_from_extension()                     ->
+ *                sail_start_saving_into_growable_memory_with_options() ->
+ *                sail_write_next_frame()                              ->
+ *                sail_stop_saving_into_growable_memory().
+ *
+ * STATE explanation: Passes the address of a local void* pointer. SAIL will store an internal state
+ * in it and destroy it in sail_stop_saving_into_growable_memory(). States must be used per image.
+ * DO NOT use the same state to start saving multiple images at the same time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_start_saving_into_growable_memory_with_options(const struct sail_codec_info *codec_info,
+                                                                              const struct sail_save_options *save_options,
+                                                                              void **state);
 
 /*
  * Stops saving started by sail_start_saving_into_file() and brothers. Closes the underlying I/O target.
  * Assigns the number of bytes written to the 'written' argument. Does nothing if the state is NULL.
+ * The I/O target is sought to its end first, so the number is the I/O position there. Forward-only
+ * streams with SAIL_IO_FEATURE_STREAMING are not sought, they are always at the end.
  *
  * It is essential to always stop saving to free memory and I/O resources. Failure to do so
  * will lead to memory leaks.
@@ -145,6 +179,18 @@ SAIL_EXPORT sail_status_t sail_start_saving_into_memory_with_options(void *buffe
  */
 SAIL_EXPORT sail_status_t sail_stop_saving_with_written(void *state, size_t *written);
 
+/*
+ * Stops saving started by sail_start_saving_into_growable_memory() and brothers, and transfers
+ * the ownership of the written buffer to the caller. The buffer must be freed with sail_free().
+ * Assigns NULL to the buffer and 0 to its size if the state is NULL or nothing was written.
+ *
+ * It is essential to always stop saving to free memory and I/O resources. Failure to do so
+ * will lead to memory leaks.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_stop_saving_into_growable_memory(void *state, void **buffer, size_t *buffer_size);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
@@ -23,6 +23,7 @@
     SOFTWARE.
 */
 
+#include <stdint.h>
 #include <stdlib.h>
 
 #include <sail/sail.h>
@@ -44,6 +45,583 @@ static sail_status_t probe_file_with_io(const char *path, struct sail_image **im
     return SAIL_OK;
 }
 
+static sail_status_t probe_file_header_only(const char *path, struct sail_image **image, const struct sail_codec_info **codec_info) {
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_file(path, &io));
+
+    const struct sail_codec_info *codec_info_local;
+    SAIL_TRY_OR_EXECUTE(sail_codec_info_from_path(path, &codec_info_local),
+                        /* on error */ SAIL_TRY_OR_CLEANUP(sail_codec_info_by_magic_number_from_io(io, &codec_info_local),
+                                                           /* cleanup */ sail_destroy_io(io)));
+
+    struct sail_load_options *load_options;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_load_options_from_features(codec_info_local->load_features, &load_options),
+                        /* cleanup */ sail_destroy_io(io));
+
+    load_options->options = (load_options->options & SAIL_OPTION_SOURCE_IMAGE) | SAIL_OPTION_PROBE;
+
+    /* The state owns the I/O object. */
+    void *state;
+    SAIL_TRY_OR_CLEANUP(start_loading_io_with_options(NULL, io, true, codec_info_local, load_options, false, &state),
+                        /* cleanup */ sail_destroy_load_options(load_options));
+
+    sail_destroy_load_options(load_options);
+
+    struct sail_image *image_local;
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, &image_local),
+                        /* cleanup */ sail_stop_loading(state));
+    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image      = image_local;
+    *codec_info = codec_info_local;
+
+    return SAIL_OK;
+}
+
+/*
+ * Items of a batch distributed across the tasks of a parallel stage. Every task takes
+ * the next item until none are left, so slow items don't stall the other tasks.
+ */
+struct batch {
+    size_t length;
+
+    size_t next_index;
+#ifdef SAIL_THREAD_SAFE
+    sail_mutex_t next_index_mutex;
+#endif
+};
+
+static bool batch_next_index(struct batch *batch, size_t *index) {
+
+    bool found = false;
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY_OR_EXECUTE(threading_lock_mutex(&batch->next_index_mutex),
+                        /* on error */ return false);
+#endif
+
+    if (batch->next_index < batch->length) {
+        *index = batch->next_index++;
+        found = true;
+    }
+
+#ifdef SAIL_THREAD_SAFE
+    threading_unlock_mutex(&batch->next_index_mutex);
+#endif
+
+    return found;
+}
+
+/* Runs the worker in 'threads' tasks on the thread pool, or in the calling thread without SAIL_THREAD_SAFE. */
+static sail_status_t run_batch(struct batch *batch, unsigned threads, sail_thread_pool_task_t worker, void *user_data) {
+
+    batch->next_index = 0;
+
+#ifdef SAIL_THREAD_SAFE
+    if (threads == 0) {
+        threads = sail_thread_pool_size();
+    }
+    if (threads > batch->length) {
+        threads = (unsigned)batch->length;
+    }
+
+    SAIL_TRY(threading_init_mutex(&batch->next_index_mutex));
+
+    sail_thread_pool_run(threads, worker, user_data);
+
+    threading_destroy_mutex(&batch->next_index_mutex);
+#else
+    (void)threads;
+
+    worker(user_data, 0, 0);
+#endif
+
+    return SAIL_OK;
+}
+
+/* Returns the first failed status of the batch items. */
+static sail_status_t batch_status(const sail_status_t *statuses, size_t length) {
+
+    for (size_t i = 0; i < length; i++) {
+        if (statuses[i] != SAIL_OK) {
+            return statuses[i];
+        }
+    }
+
+    return SAIL_OK;
+}
+
+struct probe_files_state {
+    struct batch batch;
+
+    const char * const *paths;
+    struct sail_image **images;
+    const struct sail_codec_info **codec_infos;
+    sail_status_t *statuses;
+};
+
+static void probe_files_worker(void *user_data, unsigned task, unsigned thread) {
+
+    (void)task;
+    (void)thread;
+
+    struct probe_files_state *probe_files_state = user_data;
+    size_t index;
+
+    while (batch_next_index(&probe_files_state->batch, &index)) {
+        const struct sail_codec_info *codec_info = NULL;
+        struct sail_image *image = NULL;
+
+        probe_files_state->statuses[index] = probe_file_header_only(probe_files_state->paths[index], &image, &codec_info);
+
+        probe_files_state->images[index] = image;
+
+        if (probe_files_state->codec_infos != NULL) {
+            probe_files_state->codec_infos[index] = codec_info;
+        }
+    }
+}
+
+/* Loading states of different codecs reused by a batch task. */
+#define LOAD_BATCH_STATES_MAX 4
+
+struct load_batch_state {
+    struct batch batch;
+
+    const void * const *buffers;
+    const size_t *buffer_sizes;
+    const struct sail_load_options *load_options;
+
+    /* Contiguous output buffer or NULL. */
+    unsigned char *pixels;
+    size_t pixels_stride;
+
+    struct sail_image **images;
+    sail_status_t *statuses;
+};
+
+struct load_batch_codec_state {
+    const struct sail_codec_info *codec_info;
+    void *state;
+};
+
+/* Starts loading the buffer with the reused state of the same codec, or with a new state. */
+static sail_status_t load_batch_start(const struct load_batch_state *load_batch_state,
+                                        struct load_batch_codec_state codec_states[LOAD_BATCH_STATES_MAX],
+                                        size_t index, void **state) {
+
+    const void *buffer       = load_batch_state->buffers[index];
+    const size_t buffer_size = load_batch_state->buffer_sizes[index];
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_by_magic_number_from_memory(buffer, buffer_size, &codec_info));
+
+    struct load_batch_codec_state *codec_state = NULL;
+
+    for (unsigned i = 0; i < LOAD_BATCH_STATES_MAX; i++) {
+        if (codec_states[i].state != NULL && codec_states[i].codec_info == codec_info) {
+            codec_state = &codec_states[i];
+
+            SAIL_TRY_OR_CLEANUP(sail_restart_loading_from_memory(codec_state->state, buffer, buffer_size),
+                                /* cleanup */ sail_stop_loading(codec_state->state),
+                                              codec_state->state = NULL);
+
+            *state = codec_state->state;
+
+            return SAIL_OK;
+        }
+    }
+
+    /* Take a free slot or replace a state in round robin. */
+    for (unsigned i = 0; i < LOAD_BATCH_STATES_MAX && codec_state == NULL; i++) {
+        if (codec_states[i].state == NULL) {
+            codec_state = &codec_states[i];
+        }
+    }
+
+    if (codec_state == NULL) {
+        codec_state = &codec_states[index % LOAD_BATCH_STATES_MAX];
+
+        sail_stop_loading(codec_state->state);
+        codec_state->state = NULL;
+    }
+
+    SAIL_TRY(sail_start_loading_from_memory_with_options(buffer, buffer_size, codec_info, load_batch_state->load_options, &codec_state->state));
+
+    codec_state->codec_info = codec_info;
+    *state = codec_state->state;
+
+    return SAIL_OK;
+}
+
+static sail_status_t load_batch_image(const struct load_batch_state *load_batch_state,
+                                        struct load_batch_codec_state codec_states[LOAD_BATCH_STATES_MAX],
+                                        size_t index, struct sail_image **image) {
+
+    void *state;
+    SAIL_TRY(load_batch_start(load_batch_state, codec_states, index, &state));
+
+    if (load_batch_state->pixels == NULL) {
+        SAIL_TRY(sail_load_next_frame(state, image));
+        return SAIL_OK;
+    }
+
+    struct sail_image *image_local;
+    SAIL_TRY(sail_alloc_image(&image_local));
+
+    image_local->pixels         = load_batch_state->pixels + index * load_batch_state->pixels_stride;
+    image_local->bytes_per_line = 0;
+
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame_into(state, image_local, load_batch_state->pixels_stride),
+                        /* cleanup */ image_local->pixels = NULL,
+                                      sail_destroy_image(image_local));
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+static void load_batch_worker(void *user_data, unsigned task, unsigned thread) {
+
+    (void)task;
+    (void)thread;
+
+    struct load_batch_state *load_batch_state = user_data;
+    struct load_batch_codec_state codec_states[LOAD_BATCH_STATES_MAX] = { { NULL, NULL } };
+    size_t index;
+
+    while (batch_next_index(&load_batch_state->batch, &index)) {
+        struct sail_image *image = NULL;
+
+        load_batch_state->statuses[index] = load_batch_image(load_batch_state, codec_states, index, &image);
+
+        load_batch_state->images[index] = image;
+    }
+
+    for (unsigned i = 0; i < LOAD_BATCH_STATES_MAX; i++) {
+        sail_stop_loading(codec_states[i].state);
+    }
+}
+
+static sail_status_t load_batch(const void * const buffers[], const size_t buffer_sizes[], size_t buffers_length,
+                                const struct sail_load_options *load_options,
+                                void *pixels, size_t pixels_stride,
+                                struct sail_image *images[], unsigned threads) {
+
+    SAIL_CHECK_PTR(buffers);
+    SAIL_CHECK_PTR(buffer_sizes);
+    SAIL_CHECK_PTR(images);
+
+    if (buffers_length == 0) {
+        return SAIL_OK;
+    }
+
+    for (size_t i = 0; i < buffers_length; i++) {
+        images[i] = NULL;
+    }
+
+    /* Initialize the context once instead of racing for it in every worker. */
+    SAIL_TRY(sail_init());
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(sail_status_t) * buffers_length, &ptr));
+
+    struct load_batch_state load_batch_state = {
+        .batch         = { .length = buffers_length },
+        .buffers       = buffers,
+        .buffer_sizes  = buffer_sizes,
+        .load_options  = load_options,
+        .pixels        = pixels,
+        .pixels_stride = pixels_stride,
+        .images        = images,
+        .statuses      = ptr,
+    };
+
+    SAIL_TRY_OR_CLEANUP(run_batch(&load_batch_state.batch, threads, load_batch_worker, &load_batch_state),
+                        /* cleanup */ sail_free(load_batch_state.statuses));
+
+    const sail_status_t status = batch_status(load_batch_state.statuses, buffers_length);
+
+    sail_free(load_batch_state.statuses);
+
+    return status;
+}
+
+struct load_frames_state {
+    const void *buffer;
+    size_t buffer_size;
+    const struct sail_codec_info *codec_info;
+    const struct sail_load_options *load_options;
+
+    size_t next_frame;
+
+    /* Index of the first frame that doesn't exist. */
+    size_t frames_count;
+
+    /* The first failed frame and its status. */
+    size_t failed_frame;
+    sail_status_t status;
+
+    /* Loaded frames in order. */
+    struct sail_image **frames;
+    size_t frames_capacity;
+
+#ifdef SAIL_THREAD_SAFE
+    sail_mutex_t mutex;
+#endif
+};
+
+static void load_frames_lock(struct load_frames_state *load_frames_state) {
+
+#ifdef SAIL_THREAD_SAFE
+    (void)threading_lock_mutex(&load_frames_state->mutex);
+#else
+    (void)load_frames_state;
+#endif
+}
+
+static void load_frames_unlock(struct load_frames_state *load_frames_state) {
+
+#ifdef SAIL_THREAD_SAFE
+    threading_unlock_mutex(&load_frames_state->mutex);
+#else
+    (void)load_frames_state;
+#endif
+}
+
+/* Takes the next frame to load unless the end or a failed frame is already reached. */
+static bool load_frames_next(struct load_frames_state *load_frames_state, size_t *frame) {
+
+    load_frames_lock(load_frames_state);
+
+    const bool found = load_frames_state->next_frame < load_frames_state->frames_count
+                        && load_frames_state->next_frame < load_frames_state->failed_frame;
+
+    if (found) {
+        *frame = load_frames_state->next_frame++;
+    }
+
+    load_frames_unlock(load_frames_state);
+
+    return found;
+}
+
+static sail_status_t store_frame(struct load_frames_state *load_frames_state, size_t frame, struct sail_image *image) {
+
+    if (frame >= load_frames_state->frames_capacity) {
+        size_t frames_capacity = (load_frames_state->frames_capacity == 0) ? 16 : load_frames_state->frames_capacity;
+
+        while (frame >= frames_capacity) {
+            frames_capacity *= 2;
+        }
+
+        void *ptr = load_frames_state->frames;
+        SAIL_TRY(sail_realloc(sizeof(struct sail_image *) * frames_capacity, &ptr));
+        load_frames_state->frames = ptr;
+
+        for (size_t i = load_frames_state->frames_capacity; i < frames_capacity; i++) {
+            load_frames_state->frames[i] = NULL;
+        }
+
+        load_frames_state->frames_capacity = frames_capacity;
+    }
+
+    load_frames_state->frames[frame] = image;
+
+    return SAIL_OK;
+}
+
+/* Stores the loaded frame, or the end of the frames, or the failed frame. */
+static void load_frames_finish_frame(struct load_frames_state *load_frames_state, size_t frame,
+                                        sail_status_t status, struct sail_image *image) {
+
+    load_frames_lock(load_frames_state);
+    if (status == SAIL_OK) {
+        status = store_frame(load_frames_state, frame, image);
+
+        if (status != SAIL_OK) {
+            sail_destroy_image(image);
+        }
+    }
+
+    if (status == SAIL_ERROR_NO_MORE_FRAMES) {
+        if (frame < load_frames_state->frames_count) {
+            load_frames_state->frames_count = frame;
+        }
+    } else if (status != SAIL_OK && frame < load_frames_state->failed_frame) {
+        load_frames_state->failed_frame = frame;
+        load_frames_state->status       = status;
+    }
+
+    load_frames_unlock(load_frames_state);
+}
+
+/* Every task seeks to the frames it takes with its own loading state over the shared buffer. */
+static void load_frames_worker(void *user_data, unsigned task, unsigned thread) {
+
+    (void)task;
+    (void)thread;
+
+    struct load_frames_state *load_frames_state = user_data;
+
+    void *state = NULL;
+    const sail_status_t status = sail_start_loading_from_memory_with_options(load_frames_state->buffer,
+                                                                            load_frames_state->buffer_size,
+                                                                            load_frames_state->codec_info,
+                                                                            load_frames_state->load_options,
+                                                                            &state);
+
+    if (status != SAIL_OK) {
+        load_frames_finish_frame(load_frames_state, 0, status, NULL);
+        return;
+    }
+
+    const unsigned max_frames = (load_frames_state->load_options == NULL) ? 0 : load_frames_state->load_options->limits.max_frames;
+    size_t frame;
+
+    while (load_frames_next(load_frames_state, &frame)) {
+        if (max_frames > 0 && frame >= max_frames) {
+            SAIL_LOG_ERROR("Frame #%zu exceeds the limit of %u frames", frame, max_frames);
+            load_frames_finish_frame(load_frames_state, frame, SAIL_ERROR_LIMIT_EXCEEDED, NULL);
+            continue;
+        }
+
+        struct sail_image *image = NULL;
+        const sail_status_t frame_status = sail_load_frame_at(state, (unsigned)frame, &image);
+
+        load_frames_finish_frame(load_frames_state, frame, frame_status, image);
+    }
+
+    sail_stop_loading(state);
+}
+
+/* Loads the frames one by one for codecs with dependent frames. */
+static void load_frames_sequentially(struct load_frames_state *load_frames_state) {
+
+    void *state = NULL;
+    sail_status_t status = sail_start_loading_from_memory_with_options(load_frames_state->buffer,
+                                                                      load_frames_state->buffer_size,
+                                                                      load_frames_state->codec_info,
+                                                                      load_frames_state->load_options,
+                                                                      &state);
+
+    if (status != SAIL_OK) {
+        load_frames_finish_frame(load_frames_state, 0, status, NULL);
+        return;
+    }
+
+    for (size_t frame = 0; status == SAIL_OK; frame++) {
+        struct sail_image *image = NULL;
+        status = sail_load_next_frame(state, &image);
+
+        load_frames_finish_frame(load_frames_state, frame, status, image);
+    }
+
+    sail_stop_loading(state);
+}
+
+static sail_status_t load_frames(const void *buffer, size_t buffer_size, const struct sail_codec_info *codec_info,
+                                 const struct sail_load_options *load_options,
+                                 struct sail_image ***frames, size_t *frames_count, unsigned threads) {
+
+    SAIL_CHECK_PTR(frames);
+    SAIL_CHECK_PTR(frames_count);
+
+    if (codec_info == NULL) {
+        SAIL_TRY(sail_codec_info_by_magic_number_from_memory(buffer, buffer_size, &codec_info));
+    }
+
+    struct load_frames_state load_frames_state = {
+        .buffer          = buffer,
+        .buffer_size     = buffer_size,
+        .codec_info      = codec_info,
+        .load_options    = load_options,
+        .next_frame      = 0,
+        .frames_count    = SIZE_MAX,
+        .failed_frame    = SIZE_MAX,
+        .status          = SAIL_OK,
+        .frames          = NULL,
+        .frames_capacity = 0,
+    };
+
+    const int parallel_features = SAIL_CODEC_FEATURE_PARALLEL | SAIL_CODEC_FEATURE_SEEK;
+    const bool parallel = (codec_info->load_features->features & parallel_features) == parallel_features;
+
+#ifdef SAIL_THREAD_SAFE
+    if (threads == 0) {
+        threads = sail_thread_pool_size();
+    }
+
+    SAIL_TRY(threading_init_mutex(&load_frames_state.mutex));
+
+    if (parallel && threads > 1) {
+        sail_thread_pool_run(threads, load_frames_worker, &load_frames_state);
+    } else {
+        load_frames_sequentially(&load_frames_state);
+    }
+
+    threading_destroy_mutex(&load_frames_state.mutex);
+#else
+    (void)threads;
+    (void)parallel;
+
+    load_frames_sequentially(&load_frames_state);
+#endif
+
+    if (load_frames_state.failed_frame < load_frames_state.frames_count || load_frames_state.frames_count == 0) {
+        for (size_t i = 0; i < load_frames_state.frames_capacity; i++) {
+            sail_destroy_image(load_frames_state.frames[i]);
+        }
+
+        sail_free(load_frames_state.frames);
+
+        if (load_frames_state.frames_count == 0) {
+            SAIL_LOG_AND_RETURN(SAIL_ERROR_NO_MORE_FRAMES);
+        }
+
+        return load_frames_state.status;
+    }
+
+    *frames       = load_frames_state.frames;
+    *frames_count = load_frames_state.frames_count;
+
+    return SAIL_OK;
+}
+
+/*
+ * Loads the first frame from the I/O object and destroys it. Codecs skip the state
+ * needed to composite next frames. See SAIL_OPTION_FIRST_FRAME_ONLY.
+ */
+static sail_status_t load_first_frame_from_io(struct sail_io *io, const struct sail_codec_info *codec_info, struct sail_image **image) {
+
+    struct sail_load_options *load_options;
+    SAIL_TRY_OR_CLEANUP(sail_alloc_load_options_from_features(codec_info->load_features, &load_options),
+                        /* cleanup */ sail_destroy_io(io));
+
+    load_options->options |= SAIL_OPTION_FIRST_FRAME_ONLY;
+
+    /* The loading state shares the load options and owns the I/O object. */
+    void *state = NULL;
+    const sail_status_t status = start_loading_io_with_options(NULL, io, true, codec_info, load_options, false, &state);
+
+    sail_destroy_load_options(load_options);
+    SAIL_TRY(status);
+
+    struct sail_image *image_local;
+
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, &image_local),
+                        /* cleanup */ sail_stop_loading(state));
+
+    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
 /*
  * Public functions.
  */
@@ -74,44 +652,160 @@ sail_status_t sail_probe_file(const char *path, struct sail_image **image, const
                                       sail_destroy_io(io),
                                       sail_destroy_load_options(load_options_local));
 
-    sail_destroy_load_options(load_options_local);
-
+    /* Codecs keep a pointer to the load options, so destroy them after finishing. */
     struct sail_image *image_local;
 
     SAIL_TRY_OR_CLEANUP(codec->v8->load_seek_next_frame(state, &image_local),
                         /* cleanup */ codec->v8->load_finish(&state),
-                                      sail_destroy_io(io));
+                                      sail_destroy_io(io),
+                                      sail_destroy_load_options(load_options_local));
 
     SAIL_TRY_OR_CLEANUP(codec->v8->load_finish(&state),
                         /* cleanup */ sail_destroy_image(image_local),
-                                      sail_destroy_io(io));
+                                      sail_destroy_io(io),
+                                      sail_destroy_load_options(load_options_local));
 
     sail_destroy_io(io);
+    sail_destroy_load_options(load_options_local);
 
     *image = image_local;
 
     return SAIL_OK;
 }
 
+sail_status_t sail_probe_files(const char * const paths[], size_t paths_length,
+                                struct sail_image *images[], const struct sail_codec_info *codec_infos[],
+                                unsigned threads) {
+
+    SAIL_CHECK_PTR(paths);
+    SAIL_CHECK_PTR(images);
+
+    if (paths_length == 0) {
+        return SAIL_OK;
+    }
+
+    for (size_t i = 0; i < paths_length; i++) {
+        images[i] = NULL;
+
+        if (codec_infos != NULL) {
+            codec_infos[i] = NULL;
+        }
+    }
+
+    /* Initialize the context once instead of racing for it in every worker. */
+    SAIL_TRY(sail_init());
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(sail_status_t) * paths_length, &ptr));
+
+    struct probe_files_state probe_files_state = {
+        .batch       = { .length = paths_length },
+        .paths       = paths,
+        .images      = images,
+        .codec_infos = codec_infos,
+        .statuses    = ptr,
+    };
+
+    SAIL_TRY_OR_CLEANUP(run_batch(&probe_files_state.batch, threads, probe_files_worker, &probe_files_state),
+                        /* cleanup */ sail_free(probe_files_state.statuses));
+
+    const sail_status_t status = batch_status(probe_files_state.statuses, paths_length);
+
+    sail_free(probe_files_state.statuses);
+
+    return status;
+}
+
+sail_status_t sail_load_batch_from_memory(const void * const buffers[], const size_t buffer_sizes[], size_t buffers_length,
+                                          const struct sail_load_options *load_options,
+                                          struct sail_image *images[], unsigned threads) {
+
+    SAIL_TRY(load_batch(buffers, buffer_sizes, buffers_length, load_options, NULL, 0, images, threads));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_load_batch_from_memory_into(const void * const buffers[], const size_t buffer_sizes[], size_t buffers_length,
+                                               const struct sail_load_options *load_options,
+                                               void *pixels, size_t pixels_stride,
+                                               struct sail_image *images[], unsigned threads) {
+
+    SAIL_CHECK_PTR(pixels);
+
+    SAIL_TRY(load_batch(buffers, buffer_sizes, buffers_length, load_options, pixels, pixels_stride, images, threads));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_load_frames_from_file(const char *path, const struct sail_load_options *load_options,
+                                        struct sail_image ***frames, size_t *frames_count, unsigned threads) {
+
+    SAIL_CHECK_PTR(path);
+
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY_OR_EXECUTE(sail_codec_info_from_path(path, &codec_info),
+                        /* on error */ codec_info = NULL);
+
+    /* The loading states share the mapping. */
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_mmap_file(path, &io));
+
+    const void *data;
+    size_t data_size;
+    SAIL_TRY_OR_CLEANUP(io->map(io->stream, &data, &data_size),
+                        /* cleanup */ sail_destroy_io(io));
+
+    SAIL_TRY_OR_CLEANUP(load_frames(data, data_size, codec_info, load_options, frames, frames_count, threads),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_load_frames_from_memory(const void *buffer, size_t buffer_size, const struct sail_load_options *load_options,
+                                          struct sail_image ***frames, size_t *frames_count, unsigned threads) {
+
+    SAIL_CHECK_PTR(buffer);
+
+    SAIL_TRY(load_frames(buffer, buffer_size, NULL, load_options, frames, frames_count, threads));
+
+    return SAIL_OK;
+}
+
 sail_status_t sail_load_from_file(const char *path, struct sail_image **image) {
 
     SAIL_CHECK_PTR(path);
     SAIL_CHECK_PTR(image);
 
-    void *state = NULL;
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_from_path(path, &codec_info));
 
-    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_file(path, NULL /* codec info */, &state),
-                        /* cleanup */ sail_stop_loading(state));
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_file(path, &io));
 
-    struct sail_image *image_local;
+    SAIL_TRY(load_first_frame_from_io(io, codec_info, image));
 
-    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, &image_local),
-                        /* cleanup */ sail_stop_loading(state));
+    return SAIL_OK;
+}
 
-    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
-                        /* cleanup */ sail_destroy_image(image_local));
+sail_status_t sail_load_thumbnail_from_file(const char *path, struct sail_image **image) {
 
-    *image = image_local;
+    SAIL_CHECK_PTR(path);
+    SAIL_CHECK_PTR(image);
+
+    /* Detect the codec by the magic number if the file extension is unknown. */
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY_OR_EXECUTE(sail_codec_info_from_path(path, &codec_info),
+                        /* on error */ codec_info = NULL);
+
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_file(path, &io));
+
+    SAIL_TRY_OR_CLEANUP(sail_load_thumbnail_from_io(io, codec_info, image),
+                        /* cleanup */ sail_destroy_io(io));
+
+    sail_destroy_io(io);
 
     return SAIL_OK;
 }
@@ -121,16 +815,13 @@ sail_status_t sail_load_from_memory(const void *buffer, size_t buffer_size, stru
     SAIL_CHECK_PTR(buffer);
     SAIL_CHECK_PTR(image);
 
-    void *state = NULL;
+    const struct sail_codec_info *codec_info;
+    SAIL_TRY(sail_codec_info_by_magic_number_from_memory(buffer, buffer_size, &codec_info));
 
-    SAIL_TRY_OR_CLEANUP(sail_start_loading_from_memory(buffer, buffer_size, NULL /* codec info */, &state),
-                        /* cleanup */ sail_stop_loading(state));
-
-    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, image),
-                        /* cleanup */ sail_stop_loading(state));
+    struct sail_io *io;
+    SAIL_TRY(sail_alloc_io_read_memory(buffer, buffer_size, &io));
 
-    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
-                        /* cleanup */ sail_destroy_image(*image));
+    SAIL_TRY(load_first_frame_from_io(io, codec_info, image));
 
     return SAIL_OK;
 }
@@ -38,6 +38,7 @@ extern "C" {
 struct sail_image;
 struct sail_io;
 struct sail_codec_info;
+struct sail_load_options;
 
 /*
  * Loads the specified image file and returns its properties without pixels.
@@ -52,6 +53,95 @@ struct sail_codec_info;
  */
 SAIL_EXPORT sail_status_t sail_probe_file(const char *path, struct sail_image **image, const struct sail_codec_info **codec_info);
 
+/*
+ * Probes the specified image files in parallel and returns their properties without pixels.
+ * In contrast to sail_probe_file(), the files are probed with SAIL_OPTION_PROBE, so meta data
+ * and ICC profiles are not loaded. 'images' must point to an array of 'paths_length' elements.
+ * If 'codec_infos' is not NULL, it must point to an array of 'paths_length' elements too.
+ * The assigned codec infos MUST NOT be destroyed because they are pointers to internal data structures.
+ *
+ * The files are distributed across 'threads' tasks on the thread pool. If 'threads' is 0,
+ * sail_thread_pool_size() is used. When SAIL is compiled with SAIL_THREAD_SAFE disabled,
+ * the files are probed sequentially in the calling thread.
+ *
+ * All the files are probed even if some of them fail. The images of the failed files are set to NULL.
+ * The caller must destroy the successfully probed images with sail_destroy_image().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success or the error code of the first file in 'paths' that failed to probe.
+ */
+SAIL_EXPORT sail_status_t sail_probe_files(const char * const paths[], size_t paths_length,
+                                           struct sail_image *images[], const struct sail_codec_info *codec_infos[],
+                                           unsigned threads);
+
+/*
+ * Loads the first frames of the specified memory buffers in parallel, for example, batches of images
+ * for machine learning. 'buffer_sizes' and 'images' must point to arrays of 'buffers_length' elements.
+ * Codecs are detected by magic numbers. If the load options are NULL, codec-specific defaults are used.
+ * Otherwise, they are applied to every image.
+ *
+ * The buffers are distributed across 'threads' tasks on the thread pool like in sail_probe_files().
+ * Every task reuses its loading states for the images of the same codec with sail_restart_loading_from_memory().
+ *
+ * All the buffers are loaded even if some of them fail. The images of the failed buffers are set to NULL.
+ * The caller must destroy the successfully loaded images with sail_destroy_image().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success or the error code of the first buffer in 'buffers' that failed to load.
+ */
+SAIL_EXPORT sail_status_t sail_load_batch_from_memory(const void * const buffers[], const size_t buffer_sizes[], size_t buffers_length,
+                                                      const struct sail_load_options *load_options,
+                                                      struct sail_image *images[], unsigned threads);
+
+/*
+ * Loads the first frames of the specified memory buffers in parallel like sail_load_batch_from_memory()
+ * into one contiguous output buffer. The pixels of the image with index i start at
+ * 'pixels' + i * 'pixels_stride' with tightly packed rows, so 'pixels' must hold 'buffers_length' * 'pixels_stride' bytes.
+ * Images that don't fit into 'pixels_stride' bytes fail with SAIL_ERROR_INVALID_ARGUMENT.
+ *
+ * The images point into the output buffer, so set their pixels to NULL before destroying them
+ * with sail_destroy_image(). See sail_load_next_frame_into().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success or the error code of the first buffer in 'buffers' that failed to load.
+ */
+SAIL_EXPORT sail_status_t sail_load_batch_from_memory_into(const void * const buffers[], const size_t buffer_sizes[], size_t buffers_length,
+                                                           const struct sail_load_options *load_options,
+                                                           void *pixels, size_t pixels_stride,
+                                                           struct sail_image *images[], unsigned threads);
+
+/*
+ * Loads all the frames of the specified image file. See sail_load_frames_from_memory().
+ * The file is memory-mapped and shared between the loading states.
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_load_frames_from_file(const char *path, const struct sail_load_options *load_options,
+                                                     struct sail_image ***frames, size_t *frames_count, unsigned threads);
+
+/*
+ * Loads all the frames of the specified memory buffer, for example, pages of a multi-page document.
+ * The codec is detected by magic numbers. If the load options are NULL, codec-specific defaults are used.
+ *
+ * If the codec supports SAIL_CODEC_FEATURE_PARALLEL, the frames are distributed across 'threads' tasks
+ * on the thread pool. Every task seeks to its frames with its own loading state over the same buffer.
+ * Otherwise, the frames are loaded one by one. Pass 0 to use all the threads of the thread pool.
+ *
+ * The caller must destroy the loaded frames with sail_destroy_image() and then free the array
+ * with sail_free().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success or the error code of the first frame that failed to load.
+ */
+SAIL_EXPORT sail_status_t sail_load_frames_from_memory(const void *buffer, size_t buffer_size, const struct sail_load_options *load_options,
+                                                       struct sail_image ***frames, size_t *frames_count, unsigned threads);
+
 /*
  * Loads the specified image file and returns its properties and pixels.
  *
@@ -70,6 +160,16 @@ SAIL_EXPORT sail_status_t sail_load_from_file(const char *path, struct sail_imag
  */
 SAIL_EXPORT sail_status_t sail_load_from_memory(const void *buffer, size_t buffer_size, struct sail_image **image);
 
+/*
+ * Loads a small preview of the first frame of the specified image file, for example, for gallery listings.
+ * See sail_load_thumbnail_from_io().
+ *
+ * Typical usage: This is a standalone function that could be called at any time.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_load_thumbnail_from_file(const char *path, struct sail_image **image);
+
 /*
  * Saves the specified image into the file.
  *
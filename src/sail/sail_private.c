@@ -23,53 +23,90 @@
     SOFTWARE.
 */
 
+#include <string.h>
+
 #include <sail/sail.h>
 
 /*
  * Private functions.
  */
 
+/* Returns the total size of the meta data values and the ICC profile of the image. */
+static size_t meta_data_size(const struct sail_image *image) {
+
+    size_t size = (image->iccp != NULL) ? image->iccp->size : 0;
+
+    for (const struct sail_meta_data_node *node = image->meta_data_node; node != NULL; node = node->next) {
+        if (node->meta_data->key_unknown != NULL) {
+            size += strlen(node->meta_data->key_unknown);
+        }
+
+        if (node->meta_data->value != NULL) {
+            size += node->meta_data->value->size;
+        }
+    }
+
+    return size;
+}
+
 static void print_unsupported_write_pixel_format(enum SailPixelFormat pixel_format) {
 
     SAIL_LOG_ERROR("This codec cannot save %s pixels. Use its save features to get the list of supported pixel formats for saving",
                     sail_pixel_format_to_string(pixel_format));
 }
 
-static sail_status_t load_codec_by_codec_info_unsafe(const struct sail_codec_info *codec_info, const struct sail_codec **codec) {
+static void fill_trace_attributes(const char *codec, const struct sail_image *image, struct sail_trace_attributes *attributes) {
 
-    SAIL_CHECK_PTR(codec_info);
-    SAIL_CHECK_PTR(codec);
-
-    struct sail_context *context;
-    SAIL_TRY(fetch_global_context_unsafe(&context));
+    attributes->codec        = codec;
+    attributes->width        = (image == NULL) ? 0 : image->width;
+    attributes->height       = (image == NULL) ? 0 : image->height;
+    attributes->pixel_format = (image == NULL) ? SAIL_PIXEL_FORMAT_UNKNOWN : image->pixel_format;
+}
 
-    /* Find the codec in the cache. */
-    struct sail_codec_bundle *found_codec_bundle = NULL;
+static sail_status_t find_codec_bundle(const struct sail_context *context, const struct sail_codec_info *codec_info,
+                                        struct sail_codec_bundle **codec_bundle) {
 
+    /* The list of codec bundles is immutable after the context is initialized, so no locking is needed. */
     for (struct sail_codec_bundle_node *codec_bundle_node = context->codec_bundle_node; codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
-        struct sail_codec_bundle *codec_bundle = codec_bundle_node->codec_bundle;
-
-        if (codec_bundle->codec_info == codec_info) {
-            if (codec_bundle->codec != NULL) {
-                *codec = codec_bundle->codec;
-                return SAIL_OK;
-            }
-
-            found_codec_bundle = codec_bundle_node->codec_bundle;
-            break;
+        if (codec_bundle_node->codec_bundle->codec_info == codec_info) {
+            *codec_bundle = codec_bundle_node->codec_bundle;
+            return SAIL_OK;
         }
     }
 
     /* Something weird. The pointer to the codec info is not found in the cache. */
-    if (found_codec_bundle == NULL) {
-        SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
-    }
+    SAIL_LOG_AND_RETURN(SAIL_ERROR_CODEC_NOT_FOUND);
+}
+
+/* Must be called with the context codecs locked. */
+static sail_status_t load_codec_into_bundle(struct sail_codec_bundle *codec_bundle, const struct sail_codec **codec) {
+
+    /* Some other thread might have loaded the codec while we were waiting for the lock. */
+    struct sail_codec *codec_local = codec_bundle->codec;
+
+    if (codec_local == NULL) {
+        const bool traced = sail_is_tracing_enabled();
+        struct sail_trace_attributes attributes;
+        void *span = NULL;
+
+        if (traced) {
+            fill_trace_attributes(codec_bundle->codec_info->name, NULL, &attributes);
+            span = sail_begin_trace_span("load_codec", &attributes);
+        }
+
+        const sail_status_t status = alloc_and_load_codec(codec_bundle->codec_info, &codec_local);
+
+        if (traced) {
+            sail_end_trace_span(span, &attributes, status);
+        }
+
+        SAIL_TRY(status);
 
-    if (found_codec_bundle->codec == NULL) {
-        SAIL_TRY(alloc_and_load_codec(found_codec_bundle->codec_info, &found_codec_bundle->codec));
+        /* Publish the fully loaded codec for lock-free readers. */
+        SAIL_ATOMIC_STORE_PTR_RELEASE(&codec_bundle->codec, codec_local);
     }
 
-    *codec = found_codec_bundle->codec;
+    *codec = codec_local;
 
     return SAIL_OK;
 }
@@ -80,15 +117,40 @@ static sail_status_t load_codec_by_codec_info_unsafe(const struct sail_codec_inf
 
 sail_status_t load_codec_by_codec_info(const struct sail_codec_info *codec_info, const struct sail_codec **codec) {
 
+    SAIL_TRY(load_codec_by_codec_info_in_context(NULL, codec_info, codec));
+
+    return SAIL_OK;
+}
+
+sail_status_t load_codec_by_codec_info_in_context(struct sail_context *context,
+                                                  const struct sail_codec_info *codec_info,
+                                                  const struct sail_codec **codec) {
+
     SAIL_CHECK_PTR(codec_info);
     SAIL_CHECK_PTR(codec);
 
-    SAIL_TRY(lock_context());
+    if (context == NULL) {
+        SAIL_TRY(fetch_global_context_guarded(&context));
+    }
+
+    struct sail_codec_bundle *codec_bundle;
+    SAIL_TRY(find_codec_bundle(context, codec_info, &codec_bundle));
 
-    SAIL_TRY_OR_CLEANUP(load_codec_by_codec_info_unsafe(codec_info, codec),
-                        /* cleanup */ unlock_context());
+    /* Fast path: the codec is already loaded. */
+    const struct sail_codec *loaded_codec = SAIL_ATOMIC_LOAD_PTR_ACQUIRE(&codec_bundle->codec);
 
-    SAIL_TRY(unlock_context());
+    if (SAIL_LIKELY(loaded_codec != NULL)) {
+        *codec = loaded_codec;
+        return SAIL_OK;
+    }
+
+    /* Slow path: only the first lazy load of a codec synchronizes, and only with the same context. */
+    SAIL_TRY(lock_context_codecs(context));
+
+    SAIL_TRY_OR_CLEANUP(load_codec_into_bundle(codec_bundle, codec),
+                        /* cleanup */ unlock_context_codecs(context));
+
+    SAIL_TRY(unlock_context_codecs(context));
 
     return SAIL_OK;
 }
@@ -99,6 +161,8 @@ void destroy_hidden_state(struct hidden_state *state) {
         return;
     }
 
+    sail_destroy_io(state->stats_io);
+
     if (state->own_io) {
         sail_destroy_io(state->io);
     }
@@ -106,17 +170,108 @@ void destroy_hidden_state(struct hidden_state *state) {
     sail_destroy_load_options(state->load_options);
     sail_destroy_save_options(state->save_options);
 
+    for (unsigned i = 0; i < state->recycled_pixels_count; i++) {
+        if (state->recycled_pixels[i].pixels_alignment > 0) {
+            sail_aligned_free(state->recycled_pixels[i].pixels);
+        } else {
+            sail_free(state->recycled_pixels[i].pixels);
+        }
+    }
+
     /* This state must be freed and zeroed by codecs. We free it just in case to avoid memory leaks. */
     sail_free(state->state);
 
     sail_free(state);
 }
 
-sail_status_t stop_saving(void *state, size_t *written) {
+struct sail_stats *hidden_state_stats(const struct hidden_state *state) {
+
+    if (state->load_options != NULL) {
+        return state->load_options->stats;
+    }
+    if (state->save_options != NULL) {
+        return state->save_options->stats;
+    }
+
+    return NULL;
+}
+
+struct sail_io *hidden_state_codec_io(const struct hidden_state *state) {
+
+    return (state->stats_io == NULL) ? state->io : state->stats_io;
+}
+
+sail_status_t update_hidden_state_stats_io(struct hidden_state *state) {
+
+    struct sail_stats *stats = hidden_state_stats(state);
+    struct sail_io *stats_io = NULL;
+
+    if (stats != NULL) {
+        SAIL_TRY(alloc_io_stats(state->io, stats, &stats_io));
+    }
+
+    sail_destroy_io(state->stats_io);
+    state->stats_io = stats_io;
+
+    return SAIL_OK;
+}
+
+void begin_stage_scope(struct sail_stats *stats, const char *span_name,
+                       const struct sail_codec_info *codec_info, const struct sail_image *image,
+                       struct stage_scope *scope) {
+
+    scope->stats  = stats;
+    scope->codec  = (codec_info == NULL) ? NULL : codec_info->name;
+    scope->traced = sail_is_tracing_enabled();
+
+    if (scope->traced) {
+        struct sail_trace_attributes attributes;
+        fill_trace_attributes(scope->codec, image, &attributes);
+
+        scope->span = sail_begin_trace_span(span_name, &attributes);
+    }
+
+    if (stats == NULL) {
+        return;
+    }
+
+    scope->previous = sail_set_thread_stats(stats);
+    scope->start    = sail_now_ns();
+}
+
+void end_stage_scope(const struct stage_scope *scope, enum stats_stage stage,
+                     const struct sail_image *image, sail_status_t status) {
+
+    if (scope->stats != NULL) {
+        const uint64_t elapsed = sail_now_ns() - scope->start;
+
+        switch (stage) {
+            case STATS_STAGE_DETECTION: scope->stats->detection_ns += elapsed; break;
+            case STATS_STAGE_INIT:      scope->stats->init_ns      += elapsed; break;
+            case STATS_STAGE_SEEK:      scope->stats->seek_ns      += elapsed; break;
+            case STATS_STAGE_FRAMES:    scope->stats->frames_ns    += elapsed; break;
+            case STATS_STAGE_FINISH:    scope->stats->finish_ns    += elapsed; break;
+        }
+
+        sail_set_thread_stats(scope->previous);
+    }
+
+    if (scope->traced) {
+        struct sail_trace_attributes attributes;
+        fill_trace_attributes(scope->codec, image, &attributes);
+
+        sail_end_trace_span(scope->span, &attributes, status);
+    }
+}
+
+sail_status_t stop_saving(void *state, size_t *written, void **growable_buffer) {
 
     if (written != NULL) {
         *written = 0;
     }
+    if (growable_buffer != NULL) {
+        *growable_buffer = NULL;
+    }
 
     /* Not an error. */
     if (state == NULL) {
@@ -131,13 +286,33 @@ sail_status_t stop_saving(void *state, size_t *written) {
         return SAIL_OK;
     }
 
-    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->save_finish(&state_of_mind->state),
+    struct stage_scope stage_scope;
+    begin_stage_scope(hidden_state_stats(state_of_mind), "save_finish", state_of_mind->codec_info, NULL, &stage_scope);
+
+    const sail_status_t status = state_of_mind->codec->v8->save_finish(&state_of_mind->state);
+
+    end_stage_scope(&stage_scope, STATS_STAGE_FINISH, NULL, status);
+
+    SAIL_TRY_OR_CLEANUP(status,
                         /* cleanup */ destroy_hidden_state(state_of_mind));
 
-    if (written != NULL) {
-        /* The stream cursor may not be positioned at the end. Let's move it. */
-        SAIL_TRY_OR_CLEANUP(state_of_mind->io->seek(state_of_mind->io->stream, 0, SEEK_END),
+    if (growable_buffer != NULL) {
+        size_t buffer_size;
+        SAIL_TRY_OR_CLEANUP(sail_take_io_growable_memory_buffer(state_of_mind->io, growable_buffer, &buffer_size),
                             /* cleanup */ destroy_hidden_state(state_of_mind));
+
+        if (written != NULL) {
+            *written = buffer_size;
+        }
+    } else if (written != NULL) {
+        /*
+         * The stream cursor may not be positioned at the end. Let's move it. Forward-only streams
+         * are always at the end. Custom I/O objects without features are still sought like before.
+         */
+        if (!(state_of_mind->io->features & SAIL_IO_FEATURE_STREAMING)) {
+            SAIL_TRY_OR_CLEANUP(state_of_mind->io->seek(state_of_mind->io->stream, 0, SEEK_END),
+                                /* cleanup */ destroy_hidden_state(state_of_mind));
+        }
         state_of_mind->io->tell(state_of_mind->io->stream, written);
     }
 
@@ -159,3 +334,43 @@ sail_status_t allowed_write_output_pixel_format(const struct sail_save_features
     print_unsupported_write_pixel_format(pixel_format);
     SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
 }
+
+void filter_meta_data(const struct sail_load_options *load_options, struct sail_image *image) {
+
+    if (load_options->meta_data_keys == 0) {
+        return;
+    }
+
+    struct sail_meta_data_node **link = &image->meta_data_node;
+
+    while (*link != NULL) {
+        struct sail_meta_data_node *node = *link;
+
+        if (sail_load_meta_data_key(load_options, node->meta_data->key)) {
+            link = &node->next;
+        } else {
+            *link = node->next;
+            sail_destroy_meta_data_node(node);
+        }
+    }
+}
+
+sail_status_t check_sought_frame(const struct sail_load_options *load_options,
+                                 const struct sail_codec_info *codec_info, const struct sail_image *image) {
+
+    if (image->pixels != NULL) {
+        SAIL_LOG_ERROR("Internal error in %s codec: codecs must not allocate pixels", codec_info->name);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    }
+
+    if (load_options->limits.max_meta_data_bytes > 0 && meta_data_size(image) > load_options->limits.max_meta_data_bytes) {
+        SAIL_LOG_ERROR("Meta data exceed the limit of %llu bytes", (unsigned long long)load_options->limits.max_meta_data_bytes);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_LIMIT_EXCEEDED);
+    }
+
+    if (!(load_options->options & SAIL_OPTION_PROBE)) {
+        SAIL_TRY(sail_check_load_limits(load_options, image->width, image->height, 0));
+    }
+
+    return SAIL_OK;
+}
@@ -28,6 +28,7 @@
 
 #include <stdbool.h>
 #include <stddef.h> /* size_t */
+#include <stdint.h>
 
 #include <sail-common/common.h>
 #include <sail-common/export.h>
@@ -35,13 +36,30 @@
 
 struct sail_codec_info;
 struct sail_codec;
+struct sail_context;
+struct sail_image;
+struct sail_load_options;
 struct sail_save_features;
+struct sail_stats;
+
+/* Maximum number of recycled pixel buffers kept per loading state. See sail_recycle_image(). */
+#define SAIL_RECYCLED_PIXELS_MAX 4
+
+struct recycled_pixels {
+
+    void *pixels;
+    size_t pixels_size;
+    unsigned pixels_alignment;
+};
 
 struct hidden_state {
 
     struct sail_io *io;
     bool own_io;
 
+    /* I/O object passed to codecs that counts the I/O calls of 'io' into the stats. NULL without stats. */
+    struct sail_io *stats_io;
+
     struct sail_load_options *load_options;
     struct sail_save_options *save_options;
 
@@ -51,14 +69,97 @@ struct hidden_state {
     /* Shallow pointers to internal data structures so no need to free these. */
     const struct sail_codec_info *codec_info;
     const struct sail_codec *codec;
+
+    /* Pixel buffers of recycled frames to reuse in subsequent frames. */
+    struct recycled_pixels recycled_pixels[SAIL_RECYCLED_PIXELS_MAX];
+    unsigned recycled_pixels_count;
+
+    /* Number of frames loaded so far to enforce the frames limit. */
+    unsigned frames_loaded;
+
+    /* I/O position when the loading started to report the bytes read in the diagnostics. */
+    size_t load_start_offset;
 };
 
+/* Stages of loading and saving measured in sail_stats. */
+enum stats_stage {
+
+    STATS_STAGE_DETECTION,
+    STATS_STAGE_INIT,
+    STATS_STAGE_SEEK,
+    STATS_STAGE_FRAMES,
+    STATS_STAGE_FINISH,
+};
+
+/* Measures a single stage into the stats, counts the allocations of the current thread meanwhile, and traces it. */
+struct stage_scope {
+
+    struct sail_stats *stats;
+    struct sail_stats *previous;
+    uint64_t start;
+
+    const char *codec;
+    bool traced;
+    void *span;
+};
+
+/* Loads the codec into the global context if it's not loaded yet. */
 SAIL_HIDDEN sail_status_t load_codec_by_codec_info(const struct sail_codec_info *codec_info,
                                                     const struct sail_codec **codec);
 
+/*
+ * Loads the codec into the specified context if it's not loaded yet. The codec info must belong
+ * to the context. If the context is NULL, the global context is used.
+ */
+SAIL_HIDDEN sail_status_t load_codec_by_codec_info_in_context(struct sail_context *context,
+                                                               const struct sail_codec_info *codec_info,
+                                                               const struct sail_codec **codec);
+
 SAIL_HIDDEN void destroy_hidden_state(struct hidden_state *state);
 
-SAIL_HIDDEN sail_status_t stop_saving(void *state, size_t *written);
+/* Returns the stats from the load or save options of the state, or NULL. */
+SAIL_HIDDEN struct sail_stats *hidden_state_stats(const struct hidden_state *state);
+
+/* Returns the I/O object to pass to codecs. */
+SAIL_HIDDEN struct sail_io *hidden_state_codec_io(const struct hidden_state *state);
+
+/*
+ * Wraps the I/O object of the state into a new stats I/O object if the options of the state have stats.
+ * Replaces the previous stats I/O object.
+ */
+SAIL_HIDDEN sail_status_t update_hidden_state_stats_io(struct hidden_state *state);
+
+/*
+ * Starts measuring a stage and starts a tracing span with the specified name. Does nothing
+ * if the stats are NULL and no tracer is set. The codec info and the image may be NULL.
+ */
+SAIL_HIDDEN void begin_stage_scope(struct sail_stats *stats, const char *span_name,
+                                   const struct sail_codec_info *codec_info, const struct sail_image *image,
+                                   struct stage_scope *scope);
+
+/*
+ * Adds the time elapsed since begin_stage_scope() to the stage, restores the previous thread stats,
+ * and ends the tracing span. The image may be NULL.
+ */
+SAIL_HIDDEN void end_stage_scope(const struct stage_scope *scope, enum stats_stage stage,
+                                 const struct sail_image *image, sail_status_t status);
+
+/*
+ * Finishes saving and destroys the state. When 'growable_buffer' is not NULL, the I/O object
+ * must be a growable memory buffer, and its ownership is transferred to the caller. 'written'
+ * is assigned the buffer size then.
+ */
+SAIL_HIDDEN sail_status_t stop_saving(void *state, size_t *written, void **growable_buffer);
+
+/* Drops the meta data with the keys that are not selected in the load options. */
+SAIL_HIDDEN void filter_meta_data(const struct sail_load_options *load_options, struct sail_image *image);
+
+/*
+ * Checks the frame returned by a codec seek function against the resource limits. Frame dimensions
+ * are checked unless in the probe mode.
+ */
+SAIL_HIDDEN sail_status_t check_sought_frame(const struct sail_load_options *load_options,
+                                             const struct sail_codec_info *codec_info, const struct sail_image *image);
 
 SAIL_HIDDEN sail_status_t allowed_write_output_pixel_format(const struct sail_save_features *save_features, enum SailPixelFormat pixel_format);
 
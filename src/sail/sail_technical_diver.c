@@ -27,6 +27,105 @@
 
 #include <sail/sail.h>
 
+/*
+ * Private functions.
+ */
+
+struct load_async_state {
+    struct sail_io *io;
+    const struct sail_codec_info *codec_info;
+    struct sail_load_options *load_options;
+    sail_load_async_callback_t callback;
+    void *user_data;
+};
+
+struct save_async_state {
+    struct sail_io *io;
+    const struct sail_codec_info *codec_info;
+    struct sail_save_options *save_options;
+    const struct sail_image *image;
+    sail_save_async_callback_t callback;
+    void *user_data;
+};
+
+static sail_status_t load_first_frame(struct sail_io *io, const struct sail_codec_info *codec_info,
+                                        const struct sail_load_options *load_options, struct sail_image **image) {
+
+    if (codec_info == NULL) {
+        SAIL_TRY(sail_codec_info_by_magic_number_from_io(io, &codec_info));
+    }
+
+    void *state;
+    SAIL_TRY(sail_start_loading_from_io_with_options(io, codec_info, load_options, &state));
+
+    struct sail_image *image_local;
+    SAIL_TRY_OR_CLEANUP(sail_load_next_frame(state, &image_local),
+                        /* cleanup */ sail_stop_loading(state));
+    SAIL_TRY_OR_CLEANUP(sail_stop_loading(state),
+                        /* cleanup */ sail_destroy_image(image_local));
+
+    *image = image_local;
+
+    return SAIL_OK;
+}
+
+static sail_status_t save_image(struct sail_io *io, const struct sail_codec_info *codec_info,
+                                const struct sail_save_options *save_options, const struct sail_image *image) {
+
+    void *state;
+    SAIL_TRY(sail_start_saving_into_io_with_options(io, codec_info, save_options, &state));
+
+    SAIL_TRY_OR_CLEANUP(sail_write_next_frame(state, image),
+                        /* cleanup */ sail_stop_saving(state));
+    SAIL_TRY(sail_stop_saving(state));
+
+    return SAIL_OK;
+}
+
+static void load_async_task(void *user_data, unsigned task, unsigned thread) {
+
+    (void)task;
+    (void)thread;
+
+    struct load_async_state *load_async_state = user_data;
+
+    struct sail_image *image = NULL;
+    const sail_status_t status = load_first_frame(load_async_state->io, load_async_state->codec_info,
+                                                  load_async_state->load_options, &image);
+
+    sail_destroy_load_options(load_async_state->load_options);
+
+    /* The callback may destroy the I/O object and the user data, so free the state first. */
+    const sail_load_async_callback_t callback = load_async_state->callback;
+    void *callback_user_data = load_async_state->user_data;
+    sail_free(load_async_state);
+
+    callback(status, image, callback_user_data);
+}
+
+static void save_async_task(void *user_data, unsigned task, unsigned thread) {
+
+    (void)task;
+    (void)thread;
+
+    struct save_async_state *save_async_state = user_data;
+
+    const sail_status_t status = save_image(save_async_state->io, save_async_state->codec_info,
+                                            save_async_state->save_options, save_async_state->image);
+
+    sail_destroy_save_options(save_async_state->save_options);
+
+    const sail_save_async_callback_t callback = save_async_state->callback;
+    void *callback_user_data = save_async_state->user_data;
+    sail_free(save_async_state);
+
+    callback(status, callback_user_data);
+}
+
+/*
+ * Public functions.
+ */
+
 sail_status_t sail_start_loading_from_io(struct sail_io *io, const struct sail_codec_info *codec_info, void **state) {
 
     SAIL_TRY(sail_start_loading_from_io_with_options(io, codec_info, NULL, state));
@@ -38,7 +137,23 @@ sail_status_t sail_start_loading_from_io_with_options(struct sail_io *io,
                                                       const struct sail_codec_info *codec_info,
                                                       const struct sail_load_options *load_options, void **state) {
 
-    SAIL_TRY(start_loading_io_with_options(io, false, codec_info, load_options, state));
+    SAIL_TRY(start_loading_io_with_options(NULL, io, false, codec_info, load_options, false, state));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_start_loading_from_io_with_shared_options(struct sail_io *io,
+                                                             const struct sail_codec_info *codec_info,
+                                                             const struct sail_load_options *load_options, void **state) {
+
+    SAIL_TRY(start_loading_io_with_options(NULL, io, false, codec_info, load_options, true, state));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_restart_loading_from_io(void *state, struct sail_io *io) {
+
+    SAIL_TRY(restart_loading_io(state, io, false));
 
     return SAIL_OK;
 }
@@ -54,7 +169,120 @@ sail_status_t sail_start_saving_into_io_with_options(struct sail_io *io,
                                                      const struct sail_codec_info *codec_info,
                                                      const struct sail_save_options *save_options, void **state) {
 
-    SAIL_TRY(start_saving_io_with_options(io, false, codec_info, save_options, state));
+    SAIL_TRY(start_saving_io_with_options(NULL, io, false, codec_info, save_options, false, state));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_start_saving_into_io_with_shared_options(struct sail_io *io,
+                                                            const struct sail_codec_info *codec_info,
+                                                            const struct sail_save_options *save_options, void **state) {
+
+    SAIL_TRY(start_saving_io_with_options(NULL, io, false, codec_info, save_options, true, state));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_start_loading_from_io_in_context(struct sail_context *context, struct sail_io *io,
+                                                    const struct sail_codec_info *codec_info,
+                                                    const struct sail_load_options *load_options, void **state) {
+
+    SAIL_CHECK_PTR(context);
+
+    SAIL_TRY(start_loading_io_with_options(context, io, false, codec_info, load_options, false, state));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_start_saving_into_io_in_context(struct sail_context *context, struct sail_io *io,
+                                                   const struct sail_codec_info *codec_info,
+                                                   const struct sail_save_options *save_options, void **state) {
+
+    SAIL_CHECK_PTR(context);
+
+    SAIL_TRY(start_saving_io_with_options(context, io, false, codec_info, save_options, false, state));
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_load_async(struct sail_io *io, const struct sail_codec_info *codec_info,
+                              const struct sail_load_options *load_options,
+                              sail_load_async_callback_t callback, void *user_data) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(callback);
+
+    /* Initialize the context here instead of racing for it in the thread pool. */
+    SAIL_TRY(sail_init());
+
+    struct sail_load_options *load_options_copy = NULL;
+
+    if (load_options != NULL) {
+        SAIL_TRY(sail_copy_load_options(load_options, &load_options_copy));
+    }
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct load_async_state), &ptr),
+                        /* cleanup */ sail_destroy_load_options(load_options_copy));
+    struct load_async_state *load_async_state = ptr;
+
+    *load_async_state = (struct load_async_state) {
+        .io           = io,
+        .codec_info   = codec_info,
+        .load_options = load_options_copy,
+        .callback     = callback,
+        .user_data    = user_data,
+    };
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY_OR_CLEANUP(sail_thread_pool_submit(load_async_task, load_async_state),
+                        /* cleanup */ sail_destroy_load_options(load_options_copy),
+                                      sail_free(load_async_state));
+#else
+    load_async_task(load_async_state, 0, 0);
+#endif
+
+    return SAIL_OK;
+}
+
+sail_status_t sail_save_async(struct sail_io *io, const struct sail_codec_info *codec_info,
+                              const struct sail_save_options *save_options, const struct sail_image *image,
+                              sail_save_async_callback_t callback, void *user_data) {
+
+    SAIL_TRY(sail_check_io_valid(io));
+    SAIL_CHECK_PTR(codec_info);
+    SAIL_TRY(sail_check_image_valid(image));
+    SAIL_CHECK_PTR(callback);
+
+    SAIL_TRY(sail_init());
+
+    struct sail_save_options *save_options_copy = NULL;
+
+    if (save_options != NULL) {
+        SAIL_TRY(sail_copy_save_options(save_options, &save_options_copy));
+    }
+
+    void *ptr;
+    SAIL_TRY_OR_CLEANUP(sail_malloc(sizeof(struct save_async_state), &ptr),
+                        /* cleanup */ sail_destroy_save_options(save_options_copy));
+    struct save_async_state *save_async_state = ptr;
+
+    *save_async_state = (struct save_async_state) {
+        .io           = io,
+        .codec_info   = codec_info,
+        .save_options = save_options_copy,
+        .image        = image,
+        .callback     = callback,
+        .user_data    = user_data,
+    };
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY_OR_CLEANUP(sail_thread_pool_submit(save_async_task, save_async_state),
+                        /* cleanup */ sail_destroy_save_options(save_options_copy),
+                                      sail_free(save_async_state));
+#else
+    save_async_task(save_async_state, 0, 0);
+#endif
 
     return SAIL_OK;
 }
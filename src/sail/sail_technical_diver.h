@@ -34,6 +34,8 @@ extern "C" {
 #endif
 
 struct sail_codec_info;
+struct sail_context;
+struct sail_image;
 struct sail_io;
 struct sail_load_options;
 struct sail_save_options;
@@ -79,6 +81,42 @@ SAIL_EXPORT sail_status_t sail_start_loading_from_io_with_options(struct sail_io
                                                                   const struct sail_codec_info *codec_info,
                                                                   const struct sail_load_options *load_options, void **state);
 
+/*
+ * Starts loading the specified I/O stream with the specified load options like sail_start_loading_from_io_with_options()
+ * does, but shares the load options with sail_share_load_options() instead of copying them. It saves copying
+ * the tuning when many images are loaded with the same options.
+ *
+ * The load options must be allocated with sail_alloc_load_options() or other functions of load_options.h,
+ * and must not be modified until sail_stop_loading().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_start_loading_from_io_with_shared_options(struct sail_io *io,
+                                                                         const struct sail_codec_info *codec_info,
+                                                                         const struct sail_load_options *load_options, void **state);
+
+/*
+ * Starts loading the specified I/O stream with the state of a previous loading operation started
+ * with sail_start_loading_from_io(), sail_start_loading_from_file(), etc. The new image is loaded
+ * with the same codec and load options, so the caller must make sure it has the same format.
+ * The I/O object is not owned by the state and must outlive it.
+ *
+ * Codecs with the RESET load feature reuse their decoders, so the decoders are not set up for every image.
+ * It's useful to decode many small images back to back in the same thread. Other codecs set up new decoders.
+ *
+ * Typical usage: sail_start_loading_from_io()   ->
+ *                sail_load_next_frame()         ->
+ *                sail_restart_loading_from_io() ->
+ *                sail_load_next_frame()         ->
+ *                ...                            ->
+ *                sail_stop_loading().
+ *
+ * On error, the state can only be stopped with sail_stop_loading() or restarted again.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_restart_loading_from_io(void *state, struct sail_io *io);
+
 /*
  * Starts saving into the specified I/O stream.
  *
@@ -120,6 +158,115 @@ SAIL_EXPORT sail_status_t sail_start_saving_into_io_with_options(struct sail_io
                                                                  const struct sail_codec_info *codec_info,
                                                                  const struct sail_save_options *save_options, void **state);
 
+/*
+ * Starts saving into the specified I/O stream with the specified save options like sail_start_saving_into_io_with_options()
+ * does, but shares the save options with sail_share_save_options() instead of copying them.
+ *
+ * The save options must be allocated with sail_alloc_save_options() or other functions of save_options.h,
+ * and must not be modified until sail_stop_saving().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_start_saving_into_io_with_shared_options(struct sail_io *io,
+                                                                        const struct sail_codec_info *codec_info,
+                                                                        const struct sail_save_options *save_options, void **state);
+
+/*
+ * Starts loading the specified I/O stream with the codec of the specified explicit context allocated
+ * by sail_alloc_context(). The codec info must be found in the same context, for example,
+ * with sail_codec_info_from_extension_in_context(). The codec is loaded into the context if it's not
+ * loaded yet. If you don't need specific load options, just pass NULL.
+ *
+ * The context must not be destroyed until sail_stop_loading() is called.
+ *
+ * Typical usage: sail_alloc_context()                         ->
+ *                sail_alloc_io_read_file()                    ->
+ *                sail_codec_info_from_path_in_context()       ->
+ *                sail_start_loading_from_io_in_context()      ->
+ *                sail_load_next_frame()                       ->
+ *                sail_stop_loading()                          ->
+ *                sail_destroy_io()                            ->
+ *                sail_destroy_context().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_start_loading_from_io_in_context(struct sail_context *context, struct sail_io *io,
+                                                                const struct sail_codec_info *codec_info,
+                                                                const struct sail_load_options *load_options, void **state);
+
+/*
+ * Starts saving into the specified I/O stream with the codec of the specified explicit context allocated
+ * by sail_alloc_context(). The codec info must be found in the same context. If you don't need specific
+ * save options, just pass NULL.
+ *
+ * The context must not be destroyed until sail_stop_saving() is called.
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_start_saving_into_io_in_context(struct sail_context *context, struct sail_io *io,
+                                                               const struct sail_codec_info *codec_info,
+                                                               const struct sail_save_options *save_options, void **state);
+
+/*
+ * Callback of sail_load_async(). On success, 'image' is the loaded image that the callback
+ * must destroy with sail_destroy_image(). On error, 'image' is NULL.
+ */
+typedef void (*sail_load_async_callback_t)(sail_status_t status, struct sail_image *image, void *user_data);
+
+/*
+ * Callback of sail_save_async().
+ */
+typedef void (*sail_save_async_callback_t)(sail_status_t status, void *user_data);
+
+/*
+ * Loads the first frame from the specified I/O stream on the thread pool and returns immediately.
+ * If the codec info is NULL, the codec is detected by the magic number. If you don't need specific
+ * load options, just pass NULL.
+ * Codec-specific defaults will be used in this case. The load options are deep copied.
+ *
+ * The callback is called exactly once from a thread pool thread when the function returns SAIL_OK,
+ * and is not called on error. The I/O stream must stay valid and must not be used until the callback
+ * is called. The image is loaded on the internal threads even when an external executor is set, or
+ * with the submitter set with sail_set_thread_pool_submitter(). When the thread pool has no threads
+ * or SAIL is compiled with SAIL_THREAD_SAFE disabled, the image is loaded and the callback is called
+ * in the calling thread before returning.
+ *
+ * Typical usage: sail_alloc_io()        ->
+ *                set I/O callbacks      ->
+ *                sail_load_async()      ->
+ *                the callback is called ->
+ *                sail_destroy_io().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_load_async(struct sail_io *io, const struct sail_codec_info *codec_info,
+                                          const struct sail_load_options *load_options,
+                                          sail_load_async_callback_t callback, void *user_data);
+
+/*
+ * Saves the specified image into the specified I/O stream on the thread pool and returns immediately.
+ * If you don't need specific save options, just pass NULL. Codec-specific defaults will be used
+ * in this case. The save options are deep copied.
+ *
+ * The callback is called exactly once from a thread pool thread when the function returns SAIL_OK,
+ * and is not called on error. The I/O stream and the image must stay valid and must not be used until
+ * the callback is called. The image is saved on the same threads as in sail_load_async(). When
+ * the thread pool has no threads or SAIL is compiled with SAIL_THREAD_SAFE disabled, the image
+ * is saved and the callback is called in the calling thread before returning.
+ *
+ * Typical usage: sail_alloc_io()                  ->
+ *                set I/O callbacks                ->
+ *                sail_codec_info_from_extension() ->
+ *                sail_save_async()                ->
+ *                the callback is called           ->
+ *                sail_destroy_io().
+ *
+ * Returns SAIL_OK on success.
+ */
+SAIL_EXPORT sail_status_t sail_save_async(struct sail_io *io, const struct sail_codec_info *codec_info,
+                                          const struct sail_save_options *save_options, const struct sail_image *image,
+                                          sail_save_async_callback_t callback, void *user_data);
+
 /* extern "C" */
 #ifdef __cplusplus
 }
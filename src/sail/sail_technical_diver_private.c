@@ -56,13 +56,19 @@ static sail_status_t allowed_write_compression(const struct sail_save_features *
     SAIL_LOG_AND_RETURN(SAIL_ERROR_UNSUPPORTED_COMPRESSION);
 }
 
-/*
- * Public functions.
- */
+/* Remembers the I/O position when the loading starts. See SAIL_OPTION_DIAGNOSTICS. */
+static void remember_load_start_offset(struct hidden_state *state_of_mind) {
 
-sail_status_t start_loading_io_with_options(struct sail_io *io, bool own_io,
-                                            const struct sail_codec_info *codec_info,
-                                            const struct sail_load_options *load_options, void **state) {
+    if (!(state_of_mind->load_options->options & SAIL_OPTION_DIAGNOSTICS)
+            || state_of_mind->io->tell(state_of_mind->io->stream, &state_of_mind->load_start_offset) != SAIL_OK) {
+        state_of_mind->load_start_offset = 0;
+    }
+}
+
+static sail_status_t start_loading(struct sail_context *context,
+                                   struct sail_io *io, bool own_io,
+                                   const struct sail_codec_info *codec_info,
+                                   const struct sail_load_options *load_options, bool share_options, void **state) {
 
     SAIL_TRY_OR_CLEANUP(check_io_arguments(io, codec_info, state),
                         /* cleanup */ if (own_io) sail_destroy_io(io));
@@ -76,24 +82,51 @@ sail_status_t start_loading_io_with_options(struct sail_io *io, bool own_io,
 
     state_of_mind->io           = io;
     state_of_mind->own_io       = own_io;
+    state_of_mind->stats_io     = NULL;
     state_of_mind->load_options = NULL;
     state_of_mind->save_options = NULL;
     state_of_mind->state        = NULL;
     state_of_mind->codec_info   = codec_info;
     state_of_mind->codec        = NULL;
 
-    SAIL_TRY_OR_CLEANUP(load_codec_by_codec_info(state_of_mind->codec_info, &state_of_mind->codec),
+    state_of_mind->recycled_pixels_count = 0;
+    state_of_mind->frames_loaded         = 0;
+    state_of_mind->load_start_offset     = 0;
+
+    SAIL_TRY_OR_CLEANUP(load_codec_by_codec_info_in_context(context, state_of_mind->codec_info, &state_of_mind->codec),
                         /* cleanup */ destroy_hidden_state(state_of_mind));
 
     if (load_options == NULL) {
         SAIL_TRY_OR_CLEANUP(sail_alloc_load_options_from_features(state_of_mind->codec_info->load_features, &state_of_mind->load_options),
                             /* cleanup */ destroy_hidden_state(state_of_mind));
+    } else if (share_options) {
+        SAIL_TRY_OR_CLEANUP(sail_share_load_options(load_options, &state_of_mind->load_options),
+                            /* cleanup */ destroy_hidden_state(state_of_mind));
     } else {
         SAIL_TRY_OR_CLEANUP(sail_copy_load_options(load_options, &state_of_mind->load_options),
                             /* cleanup */ destroy_hidden_state(state_of_mind));
     }
 
-    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->load_init(state_of_mind->io, state_of_mind->load_options, &state_of_mind->state),
+    /* Probing never needs meta data or ICC profiles. */
+    const bool strip_meta_data = (state_of_mind->load_options->options & SAIL_OPTION_PROBE) &&
+                                    (state_of_mind->load_options->options & (SAIL_OPTION_META_DATA | SAIL_OPTION_ICCP));
+
+    /* Row callbacks are swapped while loading frames, so they need private options. Copies are private already. */
+    if (strip_meta_data || state_of_mind->load_options->row_callback != NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_detach_load_options(&state_of_mind->load_options),
+                            /* cleanup */ destroy_hidden_state(state_of_mind));
+    }
+
+    if (strip_meta_data) {
+        state_of_mind->load_options->options &= ~(SAIL_OPTION_META_DATA | SAIL_OPTION_ICCP);
+    }
+
+    SAIL_TRY_OR_CLEANUP(update_hidden_state_stats_io(state_of_mind),
+                        /* cleanup */ destroy_hidden_state(state_of_mind));
+
+    remember_load_start_offset(state_of_mind);
+
+    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->load_init(hidden_state_codec_io(state_of_mind), state_of_mind->load_options, &state_of_mind->state),
                         /* cleanup */ state_of_mind->codec->v8->load_finish(&state_of_mind->state),
                                       destroy_hidden_state(state_of_mind));
 
@@ -102,9 +135,10 @@ sail_status_t start_loading_io_with_options(struct sail_io *io, bool own_io,
     return SAIL_OK;
 }
 
-sail_status_t start_saving_io_with_options(struct sail_io *io, bool own_io,
-                                           const struct sail_codec_info *codec_info,
-                                           const struct sail_save_options *save_options, void **state) {
+static sail_status_t start_saving(struct sail_context *context,
+                                  struct sail_io *io, bool own_io,
+                                  const struct sail_codec_info *codec_info,
+                                  const struct sail_save_options *save_options, bool share_options, void **state) {
 
     SAIL_TRY_OR_CLEANUP(check_io_arguments(io, codec_info, state),
                         /* cleanup */ if (own_io) sail_destroy_io(io));
@@ -127,24 +161,41 @@ sail_status_t start_saving_io_with_options(struct sail_io *io, bool own_io,
 
     state_of_mind->io           = io;
     state_of_mind->own_io       = own_io;
+    state_of_mind->stats_io     = NULL;
     state_of_mind->load_options = NULL;
     state_of_mind->save_options = NULL;
     state_of_mind->state        = NULL;
     state_of_mind->codec_info   = codec_info;
     state_of_mind->codec        = NULL;
 
-    SAIL_TRY_OR_CLEANUP(load_codec_by_codec_info(state_of_mind->codec_info, &state_of_mind->codec),
+    state_of_mind->recycled_pixels_count = 0;
+    state_of_mind->frames_loaded         = 0;
+    state_of_mind->load_start_offset     = 0;
+
+    SAIL_TRY_OR_CLEANUP(load_codec_by_codec_info_in_context(context, state_of_mind->codec_info, &state_of_mind->codec),
                         /* cleanup */ destroy_hidden_state(state_of_mind));
 
     if (save_options == NULL) {
         SAIL_TRY_OR_CLEANUP(sail_alloc_save_options_from_features(state_of_mind->codec_info->save_features, &state_of_mind->save_options),
                             /* cleanup */ destroy_hidden_state(state_of_mind));
+    } else if (share_options) {
+        SAIL_TRY_OR_CLEANUP(sail_share_save_options(save_options, &state_of_mind->save_options),
+                            /* cleanup */ destroy_hidden_state(state_of_mind));
     } else {
         SAIL_TRY_OR_CLEANUP(sail_copy_save_options(save_options, &state_of_mind->save_options),
                             /* cleanup */ destroy_hidden_state(state_of_mind));
     }
 
-    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->save_init(state_of_mind->io, state_of_mind->save_options, &state_of_mind->state),
+    /* Row callbacks are swapped while saving frames, so they need private options. Copies are private already. */
+    if (state_of_mind->save_options->row_callback != NULL) {
+        SAIL_TRY_OR_CLEANUP(sail_detach_save_options(&state_of_mind->save_options),
+                            /* cleanup */ destroy_hidden_state(state_of_mind));
+    }
+
+    SAIL_TRY_OR_CLEANUP(update_hidden_state_stats_io(state_of_mind),
+                        /* cleanup */ destroy_hidden_state(state_of_mind));
+
+    SAIL_TRY_OR_CLEANUP(state_of_mind->codec->v8->save_init(hidden_state_codec_io(state_of_mind), state_of_mind->save_options, &state_of_mind->state),
                         /* cleanup */ state_of_mind->codec->v8->save_finish(&state_of_mind->state),
                                       destroy_hidden_state(state_of_mind));
 
@@ -152,3 +203,106 @@ sail_status_t start_saving_io_with_options(struct sail_io *io, bool own_io,
 
     return SAIL_OK;
 }
+
+/*
+ * Public functions.
+ */
+
+sail_status_t start_loading_io_with_options(struct sail_context *context,
+                                            struct sail_io *io, bool own_io,
+                                            const struct sail_codec_info *codec_info,
+                                            const struct sail_load_options *load_options, bool share_options, void **state) {
+
+    struct stage_scope stage_scope;
+    begin_stage_scope((load_options == NULL) ? NULL : load_options->stats, "load_init", codec_info, NULL, &stage_scope);
+
+    const sail_status_t status = start_loading(context, io, own_io, codec_info, load_options, share_options, state);
+
+    end_stage_scope(&stage_scope, STATS_STAGE_INIT, NULL, status);
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
+
+sail_status_t restart_loading_io(void *state, struct sail_io *io, bool own_io) {
+
+    SAIL_TRY_OR_CLEANUP(sail_check_io_valid(io),
+                        /* cleanup */ if (own_io) sail_destroy_io(io));
+
+    if (state == NULL) {
+        if (own_io) {
+            sail_destroy_io(io);
+        }
+        SAIL_LOG_ERROR("'state' argument is NULL");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_NULL_PTR);
+    }
+
+    struct hidden_state *state_of_mind = state;
+
+    if (state_of_mind->codec == NULL || state_of_mind->load_options == NULL) {
+        if (own_io) {
+            sail_destroy_io(io);
+        }
+        SAIL_LOG_ERROR("Only loading states can be restarted");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_CONFLICTING_OPERATION);
+    }
+
+    struct sail_io *old_io = state_of_mind->io;
+    const bool own_old_io  = state_of_mind->own_io;
+
+    state_of_mind->io            = io;
+    state_of_mind->own_io        = own_io;
+    state_of_mind->frames_loaded = 0;
+
+    struct stage_scope stage_scope;
+    begin_stage_scope(state_of_mind->load_options->stats, "load_init", state_of_mind->codec_info, NULL, &stage_scope);
+
+    sail_status_t status = update_hidden_state_stats_io(state_of_mind);
+
+    remember_load_start_offset(state_of_mind);
+
+    if (status == SAIL_OK) {
+        /* Reuse the decoder when the codec supports it, or set up a new one otherwise. */
+        if (state_of_mind->state != NULL && state_of_mind->codec->v8->load_reset != NULL) {
+            status = state_of_mind->codec->v8->load_reset(state_of_mind->state, hidden_state_codec_io(state_of_mind));
+        } else {
+            if (state_of_mind->state != NULL) {
+                state_of_mind->codec->v8->load_finish(&state_of_mind->state);
+            }
+
+            status = state_of_mind->codec->v8->load_init(hidden_state_codec_io(state_of_mind), state_of_mind->load_options, &state_of_mind->state);
+        }
+    }
+
+    if (status != SAIL_OK && state_of_mind->state != NULL) {
+        state_of_mind->codec->v8->load_finish(&state_of_mind->state);
+    }
+
+    end_stage_scope(&stage_scope, STATS_STAGE_INIT, NULL, status);
+
+    if (own_old_io) {
+        sail_destroy_io(old_io);
+    }
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
+
+sail_status_t start_saving_io_with_options(struct sail_context *context,
+                                           struct sail_io *io, bool own_io,
+                                           const struct sail_codec_info *codec_info,
+                                           const struct sail_save_options *save_options, bool share_options, void **state) {
+
+    struct stage_scope stage_scope;
+    begin_stage_scope((save_options == NULL) ? NULL : save_options->stats, "save_init", codec_info, NULL, &stage_scope);
+
+    const sail_status_t status = start_saving(context, io, own_io, codec_info, save_options, share_options, state);
+
+    end_stage_scope(&stage_scope, STATS_STAGE_INIT, NULL, status);
+
+    SAIL_TRY(status);
+
+    return SAIL_OK;
+}
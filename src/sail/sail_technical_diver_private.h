@@ -32,16 +32,31 @@
 #include <sail-common/status.h>
 
 struct sail_codec_info;
+struct sail_context;
 struct sail_io;
 struct sail_load_options;
 struct sail_save_options;
 
-SAIL_HIDDEN sail_status_t start_loading_io_with_options(struct sail_io *io, bool own_io,
+/*
+ * Starts loading or saving with the codec of the specified context. If the context is NULL,
+ * the global context is used. The options are deep copied unless share_options is true.
+ * Only options allocated by SAIL can be shared.
+ */
+SAIL_HIDDEN sail_status_t start_loading_io_with_options(struct sail_context *context,
+                                                        struct sail_io *io, bool own_io,
                                                         const struct sail_codec_info *codec_info,
-                                                        const struct sail_load_options *load_options, void **state);
+                                                        const struct sail_load_options *load_options, bool share_options, void **state);
 
-SAIL_HIDDEN sail_status_t start_saving_io_with_options(struct sail_io *io, bool own_io,
+/*
+ * Starts loading the specified I/O stream with the loading state, codec, and load options of
+ * the previous image. Destroys the previous I/O object if the state owns it. On error, the state
+ * can only be stopped or restarted again.
+ */
+SAIL_HIDDEN sail_status_t restart_loading_io(void *state, struct sail_io *io, bool own_io);
+
+SAIL_HIDDEN sail_status_t start_saving_io_with_options(struct sail_context *context,
+                                                       struct sail_io *io, bool own_io,
                                                        const struct sail_codec_info *codec_info,
-                                                       const struct sail_save_options *save_options, void **state);
+                                                       const struct sail_save_options *save_options, bool share_options, void **state);
 
 #endif
@@ -25,8 +25,40 @@
 
 #include <errno.h>
 
+#ifndef SAIL_WIN32
+    #include <unistd.h>
+#endif
+
 #include <sail/sail.h>
 
+struct thread_routine_holder
+{
+    void (*routine)(void *);
+    void *arg;
+};
+
+#ifdef SAIL_WIN32
+static DWORD WINAPI thread_routine_trampoline(LPVOID parameter)
+#else
+static void *thread_routine_trampoline(void *parameter)
+#endif
+{
+    struct thread_routine_holder *thread_routine_holder = parameter;
+
+    void (*routine)(void *) = thread_routine_holder->routine;
+    void *arg = thread_routine_holder->arg;
+
+    sail_free(thread_routine_holder);
+
+    routine(arg);
+
+#ifdef SAIL_WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
 #ifdef SAIL_WIN32
 struct callback_holder
 {
@@ -152,3 +184,146 @@ sail_status_t threading_destroy_mutex(sail_mutex_t *mutex)
     }
 #endif
 }
+
+sail_status_t threading_init_cond(sail_cond_t *cond)
+{
+    SAIL_CHECK_PTR(cond);
+
+#ifdef SAIL_WIN32
+    InitializeConditionVariable(cond);
+    return SAIL_OK;
+#else
+    if (SAIL_LIKELY((errno = pthread_cond_init(cond, NULL)) == 0)) {
+        return SAIL_OK;
+    } else {
+        sail_print_errno("Failed to initialize condition variable: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#endif
+}
+
+sail_status_t threading_wait_cond(sail_cond_t *cond, sail_mutex_t *mutex)
+{
+    SAIL_CHECK_PTR(cond);
+    SAIL_CHECK_PTR(mutex);
+
+#ifdef SAIL_WIN32
+    if (SAIL_LIKELY(SleepConditionVariableCS(cond, mutex, INFINITE))) {
+        return SAIL_OK;
+    } else {
+        SAIL_LOG_ERROR("Failed to wait for condition variable. Error: 0x%X", GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#else
+    if (SAIL_LIKELY((errno = pthread_cond_wait(cond, mutex)) == 0)) {
+        return SAIL_OK;
+    } else {
+        sail_print_errno("Failed to wait for condition variable: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#endif
+}
+
+sail_status_t threading_broadcast_cond(sail_cond_t *cond)
+{
+    SAIL_CHECK_PTR(cond);
+
+#ifdef SAIL_WIN32
+    WakeAllConditionVariable(cond);
+    return SAIL_OK;
+#else
+    if (SAIL_LIKELY((errno = pthread_cond_broadcast(cond)) == 0)) {
+        return SAIL_OK;
+    } else {
+        sail_print_errno("Failed to broadcast condition variable: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#endif
+}
+
+sail_status_t threading_destroy_cond(sail_cond_t *cond)
+{
+    SAIL_CHECK_PTR(cond);
+
+#ifdef SAIL_WIN32
+    /* Windows condition variables don't need to be destroyed. */
+    return SAIL_OK;
+#else
+    if (SAIL_LIKELY((errno = pthread_cond_destroy(cond)) == 0)) {
+        return SAIL_OK;
+    } else {
+        sail_print_errno("Failed to destroy condition variable: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#endif
+}
+
+sail_status_t threading_create_thread(sail_thread_t *thread, void (*routine)(void *), void *arg)
+{
+    SAIL_CHECK_PTR(thread);
+    SAIL_CHECK_PTR(routine);
+
+    void *ptr;
+    SAIL_TRY(sail_malloc(sizeof(struct thread_routine_holder), &ptr));
+    struct thread_routine_holder *thread_routine_holder = ptr;
+
+    thread_routine_holder->routine = routine;
+    thread_routine_holder->arg     = arg;
+
+#ifdef SAIL_WIN32
+    *thread = CreateThread(NULL, 0, thread_routine_trampoline, thread_routine_holder, 0, NULL);
+
+    if (SAIL_LIKELY(*thread != NULL)) {
+        return SAIL_OK;
+    } else {
+        sail_free(thread_routine_holder);
+        SAIL_LOG_ERROR("Failed to create thread. Error: 0x%X", GetLastError());
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#else
+    if (SAIL_LIKELY((errno = pthread_create(thread, NULL, thread_routine_trampoline, thread_routine_holder)) == 0)) {
+        return SAIL_OK;
+    } else {
+        sail_free(thread_routine_holder);
+        sail_print_errno("Failed to create thread: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#endif
+}
+
+sail_status_t threading_join_thread(sail_thread_t *thread)
+{
+    SAIL_CHECK_PTR(thread);
+
+#ifdef SAIL_WIN32
+    if (SAIL_LIKELY(WaitForSingleObject(*thread, INFINITE) == WAIT_OBJECT_0)) {
+        CloseHandle(*thread);
+        return SAIL_OK;
+    } else {
+        SAIL_LOG_ERROR("Failed to join thread. Error: 0x%X", GetLastError());
+        CloseHandle(*thread);
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#else
+    if (SAIL_LIKELY((errno = pthread_join(*thread, NULL)) == 0)) {
+        return SAIL_OK;
+    } else {
+        sail_print_errno("Failed to join thread: %s");
+        SAIL_LOG_AND_RETURN(SAIL_ERROR_INVALID_ARGUMENT);
+    }
+#endif
+}
+
+unsigned threading_processor_count(void)
+{
+#ifdef SAIL_WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+
+    return system_info.dwNumberOfProcessors > 0 ? (unsigned)system_info.dwNumberOfProcessors : 1;
+#else
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? (unsigned)count : 1;
+#endif
+}
@@ -72,4 +72,47 @@ SAIL_HIDDEN sail_status_t threading_unlock_mutex(sail_mutex_t *mutex);
 
 SAIL_HIDDEN sail_status_t threading_destroy_mutex(sail_mutex_t *mutex);
 
+/* Condition variables. */
+
+#ifdef SAIL_WIN32
+    typedef CONDITION_VARIABLE sail_cond_t;
+#else
+    typedef pthread_cond_t sail_cond_t;
+#endif
+
+SAIL_HIDDEN sail_status_t threading_init_cond(sail_cond_t *cond);
+
+/* Atomically unlocks the mutex and waits for the condition variable. The mutex must be locked once. */
+SAIL_HIDDEN sail_status_t threading_wait_cond(sail_cond_t *cond, sail_mutex_t *mutex);
+
+SAIL_HIDDEN sail_status_t threading_broadcast_cond(sail_cond_t *cond);
+
+SAIL_HIDDEN sail_status_t threading_destroy_cond(sail_cond_t *cond);
+
+/* Threads. */
+
+#ifdef SAIL_WIN32
+    typedef HANDLE sail_thread_t;
+#else
+    typedef pthread_t sail_thread_t;
+#endif
+
+SAIL_HIDDEN sail_status_t threading_create_thread(sail_thread_t *thread, void (*routine)(void *), void *arg);
+
+SAIL_HIDDEN sail_status_t threading_join_thread(sail_thread_t *thread);
+
+/* Returns the number of online processors, at least 1. */
+SAIL_HIDDEN unsigned threading_processor_count(void);
+
+/* Atomic pointers. */
+
+#ifdef SAIL_WIN32
+    /* Interlocked functions imply a full memory barrier. */
+    #define SAIL_ATOMIC_LOAD_PTR_ACQUIRE(ptr)         InterlockedCompareExchangePointer((PVOID volatile *)(ptr), NULL, NULL)
+    #define SAIL_ATOMIC_STORE_PTR_RELEASE(ptr, value) (void)InterlockedExchangePointer((PVOID volatile *)(ptr), (PVOID)(value))
+#else
+    #define SAIL_ATOMIC_LOAD_PTR_ACQUIRE(ptr)         __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+    #define SAIL_ATOMIC_STORE_PTR_RELEASE(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#endif
+
 #endif
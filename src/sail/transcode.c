@@ -0,0 +1,453 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
+#include <string.h>
+
+#include <sail/sail.h>
+
+struct transcode_queue {
+    /* Ring of frames starting at 'head'. */
+    struct sail_image *frames[SAIL_TRANSCODE_QUEUE_SIZE];
+    unsigned head;
+    unsigned count;
+    /* The producer stage is finished, so no more frames come. */
+    bool closed;
+};
+
+struct transcode_state {
+    struct sail_io *io_input;
+    struct sail_io *io_output;
+    const struct sail_codec_info *codec_info_input;
+    const struct sail_codec_info *codec_info_output;
+    const struct sail_load_options *load_options;
+    const struct sail_save_options *save_options;
+    sail_transcode_convert_t convert;
+    void *user_data;
+
+    /* Guarded by the mutex. */
+    struct transcode_queue loaded;
+    struct transcode_queue converted;
+    /* Status of the first failed stage. All the stages stop when it's set. */
+    sail_status_t status;
+    /* The output codec has saved its only frame, so all the stages stop. */
+    bool stopped;
+
+#ifdef SAIL_THREAD_SAFE
+    sail_mutex_t mutex;
+    /* Signaled on every change of the queues or the status. */
+    sail_cond_t cond;
+#endif
+};
+
+/*
+ * Private functions.
+ */
+
+/* Single-frame codecs save only the first frame like sail_save_into_file(). */
+static bool single_frame_output(const struct transcode_state *transcode_state) {
+
+    return (transcode_state->codec_info_output->save_features->features
+                & (SAIL_CODEC_FEATURE_ANIMATED | SAIL_CODEC_FEATURE_MULTI_PAGED)) == 0;
+}
+
+/* Converts the loaded frame and destroys it unless it's saved as is. */
+static sail_status_t convert_frame(struct transcode_state *transcode_state, struct sail_image *image,
+                                   struct sail_image **image_output) {
+
+    if (transcode_state->convert == NULL) {
+        *image_output = image;
+        return SAIL_OK;
+    }
+
+    struct sail_image *image_converted = NULL;
+    const sail_status_t status = transcode_state->convert(image, &image_converted, transcode_state->user_data);
+
+    if (image_converted != image) {
+        sail_destroy_image(image);
+    }
+
+    if (status != SAIL_OK) {
+        sail_destroy_image(image_converted);
+        return status;
+    }
+
+    SAIL_CHECK_PTR(image_converted);
+
+    *image_output = image_converted;
+
+    return SAIL_OK;
+}
+
+/* Returns true if the load options change frames compared to the source bitstream. */
+static bool load_options_change_frames(const struct sail_load_options *load_options) {
+
+    if (load_options == NULL) {
+        return false;
+    }
+
+    return sail_roi_is_set(&load_options->roi) ||
+            load_options->scale_denominator > 1 ||
+            load_options->output_pixel_format != SAIL_PIXEL_FORMAT_UNKNOWN ||
+            (load_options->options & (SAIL_OPTION_PROBE | SAIL_OPTION_DIRTY_RECTANGLES |
+                                      SAIL_OPTION_AUTO_ORIENT | SAIL_OPTION_FIRST_FRAME_ONLY)) != 0;
+}
+
+/* Returns true if the source bitstream is copied as is. See SAIL_OPTION_PASSTHROUGH. */
+static bool passthrough(const struct transcode_state *transcode_state) {
+
+    return transcode_state->save_options != NULL &&
+            (transcode_state->save_options->options & SAIL_OPTION_PASSTHROUGH) &&
+            transcode_state->convert == NULL &&
+            strcmp(transcode_state->codec_info_input->name, transcode_state->codec_info_output->name) == 0 &&
+            passthrough_private_supported(transcode_state->codec_info_output) &&
+            !load_options_change_frames(transcode_state->load_options);
+}
+
+#ifdef SAIL_THREAD_SAFE
+/* Stops all the stages with the specified status unless another stage has failed before. */
+static void fail_transcoding(struct transcode_state *transcode_state, sail_status_t status) {
+
+    (void)threading_lock_mutex(&transcode_state->mutex);
+
+    if (transcode_state->status == SAIL_OK) {
+        transcode_state->status = status;
+    }
+
+    (void)threading_broadcast_cond(&transcode_state->cond);
+    threading_unlock_mutex(&transcode_state->mutex);
+}
+
+static void stop_transcoding(struct transcode_state *transcode_state) {
+
+    (void)threading_lock_mutex(&transcode_state->mutex);
+
+    transcode_state->stopped = true;
+
+    (void)threading_broadcast_cond(&transcode_state->cond);
+    threading_unlock_mutex(&transcode_state->mutex);
+}
+
+static bool transcoding_stopped(const struct transcode_state *transcode_state) {
+
+    return transcode_state->status != SAIL_OK || transcode_state->stopped;
+}
+
+/* Waits for a free slot and queues the frame. Returns false if the stages are stopped. */
+static bool push_frame(struct transcode_state *transcode_state, struct transcode_queue *queue, struct sail_image *image) {
+
+    (void)threading_lock_mutex(&transcode_state->mutex);
+
+    while (queue->count == SAIL_TRANSCODE_QUEUE_SIZE && !transcoding_stopped(transcode_state)) {
+        (void)threading_wait_cond(&transcode_state->cond, &transcode_state->mutex);
+    }
+
+    const bool pushed = !transcoding_stopped(transcode_state);
+
+    if (pushed) {
+        queue->frames[(queue->head + queue->count) % SAIL_TRANSCODE_QUEUE_SIZE] = image;
+        queue->count++;
+
+        (void)threading_broadcast_cond(&transcode_state->cond);
+    }
+
+    threading_unlock_mutex(&transcode_state->mutex);
+
+    return pushed;
+}
+
+/* Waits for the next frame. Returns false when the queue is closed and empty or the stages are stopped. */
+static bool pop_frame(struct transcode_state *transcode_state, struct transcode_queue *queue, struct sail_image **image) {
+
+    (void)threading_lock_mutex(&transcode_state->mutex);
+
+    while (queue->count == 0 && !queue->closed && !transcoding_stopped(transcode_state)) {
+        (void)threading_wait_cond(&transcode_state->cond, &transcode_state->mutex);
+    }
+
+    const bool popped = queue->count > 0 && !transcoding_stopped(transcode_state);
+
+    if (popped) {
+        *image = queue->frames[queue->head];
+        queue->head = (queue->head + 1) % SAIL_TRANSCODE_QUEUE_SIZE;
+        queue->count--;
+
+        (void)threading_broadcast_cond(&transcode_state->cond);
+    }
+
+    threading_unlock_mutex(&transcode_state->mutex);
+
+    return popped;
+}
+
+static void close_queue(struct transcode_state *transcode_state, struct transcode_queue *queue) {
+
+    (void)threading_lock_mutex(&transcode_state->mutex);
+
+    queue->closed = true;
+
+    (void)threading_broadcast_cond(&transcode_state->cond);
+    threading_unlock_mutex(&transcode_state->mutex);
+}
+
+static void destroy_queue(struct transcode_queue *queue) {
+
+    for (unsigned i = 0; i < queue->count; i++) {
+        sail_destroy_image(queue->frames[(queue->head + i) % SAIL_TRANSCODE_QUEUE_SIZE]);
+    }
+
+    queue->count = 0;
+}
+
+static void load_routine(void *arg) {
+
+    struct transcode_state *transcode_state = arg;
+
+    void *state;
+    sail_status_t status = sail_start_loading_from_io_with_options(transcode_state->io_input,
+                                                                  transcode_state->codec_info_input,
+                                                                  transcode_state->load_options, &state);
+
+    if (status == SAIL_OK) {
+        struct sail_image *image;
+
+        while ((status = sail_load_next_frame(state, &image)) == SAIL_OK) {
+            if (!push_frame(transcode_state, &transcode_state->loaded, image)) {
+                sail_destroy_image(image);
+                break;
+            }
+        }
+
+        if (status == SAIL_ERROR_NO_MORE_FRAMES) {
+            status = SAIL_OK;
+        }
+
+        const sail_status_t stop_status = sail_stop_loading(state);
+
+        if (status == SAIL_OK) {
+            status = stop_status;
+        }
+    }
+
+    if (status != SAIL_OK) {
+        fail_transcoding(transcode_state, status);
+    }
+
+    close_queue(transcode_state, &transcode_state->loaded);
+}
+
+static void convert_routine(void *arg) {
+
+    struct transcode_state *transcode_state = arg;
+
+    struct sail_image *image;
+
+    while (pop_frame(transcode_state, &transcode_state->loaded, &image)) {
+        struct sail_image *image_output;
+        const sail_status_t status = convert_frame(transcode_state, image, &image_output);
+
+        if (status != SAIL_OK) {
+            fail_transcoding(transcode_state, status);
+            break;
+        }
+
+        if (!push_frame(transcode_state, &transcode_state->converted, image_output)) {
+            sail_destroy_image(image_output);
+            break;
+        }
+    }
+
+    close_queue(transcode_state, &transcode_state->converted);
+}
+
+/* The saving stage runs in the calling thread. */
+static void save_routine(struct transcode_state *transcode_state) {
+
+    void *state;
+    sail_status_t status = sail_start_saving_into_io_with_options(transcode_state->io_output,
+                                                                 transcode_state->codec_info_output,
+                                                                 transcode_state->save_options, &state);
+
+    if (status == SAIL_OK) {
+        struct sail_image *image;
+
+        while (pop_frame(transcode_state, &transcode_state->converted, &image)) {
+            status = sail_write_next_frame(state, image);
+            sail_destroy_image(image);
+
+            if (status != SAIL_OK) {
+                break;
+            }
+
+            if (single_frame_output(transcode_state)) {
+                stop_transcoding(transcode_state);
+                break;
+            }
+        }
+
+        const sail_status_t stop_status = sail_stop_saving(state);
+
+        if (status == SAIL_OK) {
+            status = stop_status;
+        }
+    }
+
+    if (status != SAIL_OK) {
+        fail_transcoding(transcode_state, status);
+    }
+}
+
+static sail_status_t transcode_pipelined(struct transcode_state *transcode_state) {
+
+    SAIL_TRY(threading_init_mutex(&transcode_state->mutex));
+    SAIL_TRY_OR_CLEANUP(threading_init_cond(&transcode_state->cond),
+                        /* cleanup */ threading_destroy_mutex(&transcode_state->mutex));
+
+    sail_thread_t load_thread;
+    SAIL_TRY_OR_CLEANUP(threading_create_thread(&load_thread, load_routine, transcode_state),
+                        /* cleanup */ threading_destroy_cond(&transcode_state->cond),
+                                      threading_destroy_mutex(&transcode_state->mutex));
+
+    sail_thread_t convert_thread;
+    const sail_status_t status = threading_create_thread(&convert_thread, convert_routine, transcode_state);
+
+    if (status == SAIL_OK) {
+        save_routine(transcode_state);
+
+        (void)threading_join_thread(&convert_thread);
+    } else {
+        fail_transcoding(transcode_state, status);
+    }
+
+    (void)threading_join_thread(&load_thread);
+
+    threading_destroy_cond(&transcode_state->cond);
+    threading_destroy_mutex(&transcode_state->mutex);
+
+    /* Frames left by the failed stages. */
+    destroy_queue(&transcode_state->loaded);
+    destroy_queue(&transcode_state->converted);
+
+    return transcode_state->status;
+}
+#else
+/* Runs the stages one frame at a time in the calling thread. */
+static sail_status_t transcode_sequentially(struct transcode_state *transcode_state) {
+
+    void *load_state;
+    SAIL_TRY(sail_start_loading_from_io_with_options(transcode_state->io_input, transcode_state->codec_info_input,
+                                                     transcode_state->load_options, &load_state));
+
+    void *save_state;
+    SAIL_TRY_OR_CLEANUP(sail_start_saving_into_io_with_options(transcode_state->io_output,
+                                                               transcode_state->codec_info_output,
+                                                               transcode_state->save_options, &save_state),
+                        /* cleanup */ sail_stop_loading(load_state));
+
+    sail_status_t status;
+    struct sail_image *image;
+
+    while ((status = sail_load_next_frame(load_state, &image)) == SAIL_OK) {
+        struct sail_image *image_output;
+        status = convert_frame(transcode_state, image, &image_output);
+
+        if (status != SAIL_OK) {
+            break;
+        }
+
+        status = sail_write_next_frame(save_state, image_output);
+        sail_destroy_image(image_output);
+
+        if (status != SAIL_OK || single_frame_output(transcode_state)) {
+            break;
+        }
+    }
+
+    if (status == SAIL_ERROR_NO_MORE_FRAMES) {
+        status = SAIL_OK;
+    }
+
+    SAIL_TRY_OR_CLEANUP(status,
+                        /* cleanup */ sail_stop_saving(save_state),
+                                      sail_stop_loading(load_state));
+
+    SAIL_TRY_OR_CLEANUP(sail_stop_saving(save_state),
+                        /* cleanup */ sail_stop_loading(load_state));
+    SAIL_TRY(sail_stop_loading(load_state));
+
+    return SAIL_OK;
+}
+#endif
+
+/*
+ * Public functions.
+ */
+
+sail_status_t sail_transcode(struct sail_io *io_input, const struct sail_codec_info *codec_info_input,
+                             struct sail_io *io_output, const struct sail_codec_info *codec_info_output,
+                             const struct sail_load_options *load_options,
+                             const struct sail_save_options *save_options,
+                             sail_transcode_convert_t convert, void *user_data) {
+
+    SAIL_TRY(sail_check_io_valid(io_input));
+    SAIL_TRY(sail_check_io_valid(io_output));
+    SAIL_CHECK_PTR(codec_info_output);
+
+    /* Initialize the context here instead of racing for it in the stages. */
+    SAIL_TRY(sail_init());
+
+    if (codec_info_input == NULL) {
+        SAIL_TRY(sail_codec_info_by_magic_number_from_io(io_input, &codec_info_input));
+    }
+
+    struct transcode_state transcode_state = {
+        .io_input          = io_input,
+        .io_output         = io_output,
+        .codec_info_input  = codec_info_input,
+        .codec_info_output = codec_info_output,
+        .load_options      = load_options,
+        .save_options      = save_options,
+        .convert           = convert,
+        .user_data         = user_data,
+        .status            = SAIL_OK,
+        .stopped           = false,
+    };
+
+    if (passthrough(&transcode_state)) {
+        SAIL_TRY(passthrough_private_copy(io_input, codec_info_input, io_output,
+                                          save_options->options & SAIL_OPTION_META_DATA,
+                                          save_options->options & SAIL_OPTION_ICCP));
+        return SAIL_OK;
+    }
+
+#ifdef SAIL_THREAD_SAFE
+    SAIL_TRY(transcode_pipelined(&transcode_state));
+#else
+    SAIL_TRY(transcode_sequentially(&transcode_state));
+#endif
+
+    return SAIL_OK;
+}
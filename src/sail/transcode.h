@@ -0,0 +1,89 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#ifndef SAIL_TRANSCODE_H
+#define SAIL_TRANSCODE_H
+
+#include <sail-common/export.h>
+#include <sail-common/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct sail_codec_info;
+struct sail_image;
+struct sail_io;
+struct sail_load_options;
+struct sail_save_options;
+
+/* Maximum number of frames waiting between two stages of sail_transcode(). */
+#define SAIL_TRANSCODE_QUEUE_SIZE 2
+
+/*
+ * Conversion stage of sail_transcode(). Converts the loaded frame into a new image suitable
+ * for saving, for example, with sail_convert_image_for_saving() from sail-manip. Sets 'image_output'
+ * to 'image' to save the loaded frame as is. Must not destroy the loaded frame.
+ */
+typedef sail_status_t (*sail_transcode_convert_t)(struct sail_image *image, struct sail_image **image_output,
+                                                  void *user_data);
+
+/*
+ * Loads all the frames from the input I/O stream and saves them into the output I/O stream
+ * with the specified codec. Loading, converting and saving run as three pipeline stages
+ * on their own threads connected with queues of SAIL_TRANSCODE_QUEUE_SIZE frames, so the next
+ * frame is loaded while the previous one is saved. If the output codec supports neither
+ * SAIL_CODEC_FEATURE_ANIMATED nor SAIL_CODEC_FEATURE_MULTI_PAGED, only the first frame is saved.
+ *
+ * If the input codec info is NULL, the codec is detected by the magic number. If you don't need specific load or save options,
+ * just pass NULL. Codec-specific defaults will be used in this case. If the conversion callback is NULL,
+ * the frames are saved as is. When SAIL is compiled with SAIL_THREAD_SAFE disabled, the stages run
+ * one frame at a time in the calling thread.
+ *
+ * If the save options specify SAIL_OPTION_PASSTHROUGH, the input and output codecs are the same,
+ * the conversion callback is NULL, and the load options don't change frames, the source bitstream
+ * is copied into the output I/O stream with the meta data stripped at the container level.
+ * No frames are decoded or encoded then.
+ *
+ * Typical usage: sail_alloc_io_read_file()        ->
+ *                sail_alloc_io_read_write_file()  ->
+ *                sail_codec_info_from_extension() ->
+ *                sail_transcode()                 ->
+ *                sail_destroy_io().
+ *
+ * Returns SAIL_OK on success or the error code of the first stage that failed.
+ */
+SAIL_EXPORT sail_status_t sail_transcode(struct sail_io *io_input, const struct sail_codec_info *codec_info_input,
+                                         struct sail_io *io_output, const struct sail_codec_info *codec_info_output,
+                                         const struct sail_load_options *load_options,
+                                         const struct sail_save_options *save_options,
+                                         sail_transcode_convert_t convert, void *user_data);
+
+/* extern "C" */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,150 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include <sail-c++/sail-c++.h>
+
+#include "munit.h"
+
+/* Creates a 17x5 RGB image with distinct pixels. */
+static sail::image create_image() {
+
+    sail::image image(SAIL_PIXEL_FORMAT_BPP24_RGB, 17, 5);
+
+    unsigned char *pixels = static_cast<unsigned char *>(image.pixels());
+
+    for (std::size_t i = 0; i < image.pixels_size(); i++) {
+        pixels[i] = static_cast<unsigned char>(i * 7);
+    }
+
+    return image;
+}
+
+static MunitResult test_future(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const sail::codec_info codec_info = sail::codec_info::from_extension("png");
+    munit_assert(codec_info.is_valid());
+
+    const sail::image image = create_image();
+    munit_assert(image.is_valid());
+
+    sail::arbitrary_data arbitrary_data;
+
+    {
+        sail::image_output output(&arbitrary_data, codec_info);
+        std::future<sail_status_t> saved = output.save_async(image);
+        munit_assert(saved.get() == SAIL_OK);
+    }
+
+    munit_assert_false(arbitrary_data.empty());
+
+    sail::image_input input(arbitrary_data);
+    std::future<sail::image> loaded = input.load_async();
+    const sail::image loaded_image = loaded.get();
+
+    munit_assert(loaded_image.is_valid());
+    munit_assert(loaded_image.pixel_format() == image.pixel_format());
+    munit_assert_uint(loaded_image.width(), ==, image.width());
+    munit_assert_uint(loaded_image.height(), ==, image.height());
+    munit_assert_memory_equal(image.pixels_size(), loaded_image.pixels(), image.pixels());
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_callback(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const sail::codec_info codec_info = sail::codec_info::from_extension("png");
+    const sail::image image = create_image();
+
+    sail::arbitrary_data arbitrary_data;
+    std::atomic<int> saved_status(-1);
+
+    {
+        sail::image_output output(&arbitrary_data, codec_info);
+        munit_assert(output.save_async(image, [&saved_status](sail_status_t status) { saved_status = status; }) == SAIL_OK);
+
+        while (saved_status < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    munit_assert_int(saved_status, ==, SAIL_OK);
+
+    /* Requested pixel formats are applied like in next_frame(). */
+    sail::load_options load_options;
+    munit_assert(sail::codec_info::from_extension("png").load_features().to_options(&load_options) == SAIL_OK);
+    load_options.set_output_pixel_format(SAIL_PIXEL_FORMAT_BPP32_BGRA);
+
+    sail::image_input input(arbitrary_data);
+    input.with(load_options);
+
+    std::promise<sail::image> promise;
+    std::future<sail::image> loaded = promise.get_future();
+
+    munit_assert(input.load_async([&promise](sail_status_t status, sail::image loaded_image) {
+        promise.set_value((status == SAIL_OK) ? std::move(loaded_image) : sail::image{});
+    }) == SAIL_OK);
+
+    const sail::image loaded_image = loaded.get();
+    munit_assert(loaded_image.is_valid());
+    munit_assert(loaded_image.pixel_format() == SAIL_PIXEL_FORMAT_BPP32_BGRA);
+
+    /* Not while loading frames synchronously. */
+    sail::image_input busy_input(arbitrary_data);
+    munit_assert(busy_input.next_frame().is_valid());
+    munit_assert(busy_input.load_async([](sail_status_t, sail::image) {}) == SAIL_ERROR_CONFLICTING_OPERATION);
+    munit_assert_false(busy_input.load_async().get().is_valid());
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/future",   test_future,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/callback", test_callback, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/bindings/c++/async",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
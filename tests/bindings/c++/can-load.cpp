@@ -23,6 +23,11 @@
     SOFTWARE.
 */
 
+#include <cstring>
+#include <vector>
+
+#include <sail-common/thread_pool.h>
+
 #include <sail-c++/suppress_begin.h>
 #include <sail-c++/suppress_c4251.h>
 
@@ -205,20 +210,269 @@ static MunitResult test_can_load_io_memory5(const MunitParameter params[], void
     return MUNIT_OK;
 }
 
+static MunitResult test_can_load_shared_memory(const MunitParameter params[], void *user_data) {
+
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    std::shared_ptr<sail::arbitrary_data> arbitrary_data(new sail::arbitrary_data);
+    munit_assert(sail::read_file_contents(path, arbitrary_data.get()) == SAIL_OK);
+
+    const sail::codec_info codec_info = sail::codec_info::from_path(path);
+    munit_assert(codec_info.is_valid());
+
+    /* The input keeps the buffers alive. */
+    sail::image_input input1(arbitrary_data);
+    sail::image_input input2(std::shared_ptr<const void>(arbitrary_data, arbitrary_data->data()), arbitrary_data->size());
+    arbitrary_data.reset();
+
+    sail::image image;
+
+    munit_assert(input1.with(codec_info).next_frame(&image) == SAIL_OK);
+    munit_assert(image.is_valid());
+
+    munit_assert(input2.with(codec_info).next_frame(&image) == SAIL_OK);
+    munit_assert(image.is_valid());
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_can_load_frames(const MunitParameter params[], void *user_data) {
+
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    sail::image_input input(path);
+    sail::frame_range frames = input.frames();
+    unsigned frame_count = 0;
+
+    for (sail::image &frame : frames) {
+        munit_assert(frame.is_valid());
+        frame_count++;
+    }
+
+    munit_assert(frames.status() == SAIL_OK);
+    munit_assert_uint(frame_count, >, 0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_can_load_prefetched_frames(const MunitParameter params[], void *user_data) {
+
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    std::vector<sail::image> expected_frames;
+
+    {
+        sail::image_input input(path);
+
+        for (sail::image &frame : input.frames()) {
+            expected_frames.push_back(frame);
+        }
+    }
+
+    const unsigned thread_counts[] = { 1, 0 };
+
+    for (unsigned threads : thread_counts) {
+        sail_set_thread_pool_size(threads);
+
+        sail::image_input input(path);
+        sail::prefetch_frame_range frames = input.prefetched_frames();
+        std::size_t frame_index = 0;
+
+        for (sail::image &frame : frames) {
+            munit_assert(frame.is_valid());
+            munit_assert_size(frame_index, <, expected_frames.size());
+
+            const sail::image &expected_frame = expected_frames[frame_index++];
+            munit_assert(frame.pixel_format() == expected_frame.pixel_format());
+            munit_assert_uint(frame.width(), ==, expected_frame.width());
+            munit_assert_uint(frame.height(), ==, expected_frame.height());
+            munit_assert_memory_equal(frame.pixels_size(), frame.pixels(), expected_frame.pixels());
+        }
+
+        munit_assert(frames.status() == SAIL_OK);
+        munit_assert_size(frame_index, ==, expected_frames.size());
+    }
+
+    /* Destroying a started range waits for the frame being decoded. */
+    {
+        sail::image_input input(path);
+        sail::prefetch_frame_range frames = input.prefetched_frames();
+        munit_assert(frames.begin() != frames.end());
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_can_load_frames_recycled(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const char *path = nullptr;
+
+    for (const char * const *test_path = SAIL_TEST_IMAGES; *test_path != NULL; test_path++) {
+        if (std::strstr(*test_path, "/ico/bpp24-bgr.ico") != nullptr) {
+            path = *test_path;
+        }
+    }
+
+    if (path == nullptr) {
+        return MUNIT_SKIP;
+    }
+
+    sail::arbitrary_data single_frame;
+    munit_assert(sail::read_file_contents(path, &single_frame) == SAIL_OK);
+    munit_assert_size(single_frame.size(), >, 22);
+
+    /* Build an icon of three identical frames pointing to the same image data. */
+    const std::size_t header_size = 6;
+    const std::size_t entry_size  = 16;
+    const unsigned frame_count    = 3;
+
+    sail::arbitrary_data arbitrary_data(single_frame.begin(), single_frame.begin() + header_size);
+    arbitrary_data[4] = frame_count;
+
+    for (unsigned i = 0; i < frame_count; i++) {
+        arbitrary_data.insert(arbitrary_data.end(), single_frame.begin() + header_size, single_frame.begin() + header_size + entry_size);
+
+        /* The image data offset is stored in the last 4 bytes of the entry. */
+        const std::size_t offset_pos = arbitrary_data.size() - 4;
+        const unsigned offset = (entry_size * (frame_count - 1)) + (arbitrary_data[offset_pos]
+                                    | (arbitrary_data[offset_pos + 1] << 8)
+                                    | (arbitrary_data[offset_pos + 2] << 16)
+                                    | (arbitrary_data[offset_pos + 3] << 24));
+
+        arbitrary_data[offset_pos]     = offset & 0xFF;
+        arbitrary_data[offset_pos + 1] = (offset >> 8) & 0xFF;
+        arbitrary_data[offset_pos + 2] = (offset >> 16) & 0xFF;
+        arbitrary_data[offset_pos + 3] = (offset >> 24) & 0xFF;
+    }
+
+    arbitrary_data.insert(arbitrary_data.end(), single_frame.begin() + header_size + entry_size, single_frame.end());
+
+    sail::image_input input(arbitrary_data);
+    input.with(sail::codec_info::from_path(path));
+
+    sail::frame_range frames = input.frames();
+    std::vector<const void *> pixels;
+    sail::image kept_frame;
+
+    for (sail::image &frame : frames) {
+        munit_assert(frame.is_valid());
+        pixels.push_back(frame.pixels());
+
+        /* A copy shares the pixels, so they're not recycled. */
+        if (pixels.size() == 1) {
+            kept_frame = frame;
+        }
+    }
+
+    munit_assert(frames.status() == SAIL_OK);
+    munit_assert_size(pixels.size(), ==, frame_count);
+
+    /* The second frame is allocated as the first one is kept, the third one reuses the second's pixels. */
+    munit_assert(kept_frame.pixels() == pixels[0]);
+    munit_assert(pixels[1] != pixels[0]);
+    munit_assert(pixels[2] == pixels[1]);
+
+    return MUNIT_OK;
+}
+
+/* Non-mapped custom stream that counts the calls of its virtual read methods. */
+class counting_io : public sail::io_memory
+{
+public:
+    explicit counting_io(sail::arbitrary_data &arbitrary_data)
+        : sail::io_memory(arbitrary_data, sail::io_memory::Operation::Read)
+        , tolerant_reads(0)
+        , strict_reads(0)
+    {
+    }
+
+    int features() const override
+    {
+        return sail::io_memory::features() & ~SAIL_IO_FEATURE_MAPPED;
+    }
+
+    sail_status_t tolerant_read(void *buf, std::size_t size_to_read, std::size_t *read_size) override
+    {
+        tolerant_reads++;
+        return sail::io_memory::tolerant_read(buf, size_to_read, read_size);
+    }
+
+    sail_status_t strict_read(void *buf, std::size_t size_to_read) override
+    {
+        strict_reads++;
+        return sail::io_memory::strict_read(buf, size_to_read);
+    }
+
+    unsigned tolerant_reads;
+    unsigned strict_reads;
+};
+
+static MunitResult test_can_load_custom_io(const MunitParameter params[], void *user_data) {
+
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    sail::arbitrary_data arbitrary_data;
+    munit_assert(sail::read_file_contents(path, &arbitrary_data) == SAIL_OK);
+
+    const sail::codec_info codec_info = sail::codec_info::from_path(path);
+    munit_assert(codec_info.is_valid());
+
+    const sail::image reference(path);
+    munit_assert(reference.is_valid());
+
+    counting_io io(arbitrary_data);
+    sail::image image;
+
+    {
+        sail::image_input input(io);
+        input.with(codec_info);
+
+        munit_assert(input.next_frame(&image) == SAIL_OK);
+        munit_assert(image.is_valid());
+    }
+
+    munit_assert_uint(image.width(), ==, reference.width());
+    munit_assert_uint(image.height(), ==, reference.height());
+    munit_assert_memory_equal(reference.pixels_size(), image.pixels(), reference.pixels());
+
+    /* Reads are served from the block buffer that is refilled with tolerant reads. */
+    munit_assert_uint(io.strict_reads, ==, 0);
+    munit_assert_uint(io.tolerant_reads, >, 0);
+
+    return MUNIT_OK;
+}
+
 static MunitParameterEnum test_params[] = {
     { (char *)"path", (char **)SAIL_TEST_IMAGES },
     { NULL, NULL },
 };
 
 static MunitTest test_suite_tests[] = {
-    { (char *)"/can-load-path",       test_can_load_path,       NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
-    { (char *)"/can-load-memory",     test_can_load_memory,     NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
-    { (char *)"/can-load-io-file",    test_can_load_io_file,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
-    { (char *)"/can-load-io-memory1", test_can_load_io_memory1, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
-    { (char *)"/can-load-io-memory2", test_can_load_io_memory2, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
-    { (char *)"/can-load-io-memory3", test_can_load_io_memory3, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
-    { (char *)"/can-load-io-memory4", test_can_load_io_memory4, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
-    { (char *)"/can-load-io-memory5", test_can_load_io_memory5, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-path",          test_can_load_path,          NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-memory",        test_can_load_memory,        NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-io-file",       test_can_load_io_file,       NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-io-memory1",    test_can_load_io_memory1,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-io-memory2",    test_can_load_io_memory2,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-io-memory3",    test_can_load_io_memory3,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-io-memory4",    test_can_load_io_memory4,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-io-memory5",    test_can_load_io_memory5,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-shared-memory", test_can_load_shared_memory, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-custom-io",     test_can_load_custom_io,     NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-frames",        test_can_load_frames,        NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/can-load-prefetched-frames", test_can_load_prefetched_frames, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { (char *)"/can-load-frames-recycled", test_can_load_frames_recycled, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
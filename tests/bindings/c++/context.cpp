@@ -0,0 +1,148 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <sail-c++/suppress_begin.h>
+#include <sail-c++/suppress_c4251.h>
+
+#include <sail-c++/codec_info.h>
+#include <sail-c++/context.h>
+
+#include <sail-c++/suppress_end.h>
+
+#include "munit.h"
+
+static MunitResult test_preload(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    std::vector<std::string> names;
+
+    for (const sail::codec_info &codec_info : sail::codec_info::list()) {
+        names.push_back(codec_info.name());
+    }
+
+    munit_assert(!names.empty());
+
+    std::vector<std::uint64_t> load_times;
+    munit_assert(sail::context::preload(names, &load_times) == SAIL_OK);
+    munit_assert(load_times.size() == names.size());
+
+    /* Already loaded. */
+    munit_assert(sail::context::preload(names) == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_preload_case_insensitive(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const std::vector<sail::codec_info> codec_infos = sail::codec_info::list();
+    munit_assert(!codec_infos.empty());
+
+    std::string name = codec_infos.front().name();
+
+    for (char &c : name) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    munit_assert(sail::context::preload({ name }) == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_preload_not_found(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const std::vector<sail::codec_info> codec_infos = sail::codec_info::list();
+    munit_assert(!codec_infos.empty());
+
+    std::vector<std::uint64_t> load_times;
+    munit_assert(sail::context::preload({ "NOT-EXISTING", codec_infos.front().name() }, &load_times) == SAIL_ERROR_CODEC_NOT_FOUND);
+    munit_assert(load_times.size() == 2);
+    munit_assert(load_times[0] == 0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_shared_codec_info(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const std::vector<sail::codec_info> codec_infos = sail::codec_info::list();
+    munit_assert(!codec_infos.empty());
+
+    const std::string extension = codec_infos.front().extensions().front();
+
+    /* Lookups of the same codec share the same data. */
+    const sail::codec_info codec_info1 = sail::codec_info::from_extension(extension);
+    const sail::codec_info codec_info2 = sail::codec_info::from_extension(extension);
+
+    munit_assert(codec_info1.is_valid());
+    munit_assert_ptr_equal(&codec_info1.name(), &codec_info2.name());
+    munit_assert_ptr_equal(&codec_info1.name(), &codec_infos.front().name());
+
+    /* Handles outlive the context. */
+    sail::context::finish();
+
+    munit_assert(!codec_info1.name().empty());
+
+    const sail::codec_info codec_info3 = sail::codec_info::from_extension(extension);
+    munit_assert(codec_info3.is_valid());
+    munit_assert_string_equal(codec_info3.name().c_str(), codec_info1.name().c_str());
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/preload",                  test_preload,                  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/preload-case-insensitive", test_preload_case_insensitive, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/preload-not-found",        test_preload_not_found,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/shared-codec-info",        test_shared_codec_info,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/bindings/c++/context",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -23,6 +23,8 @@
     SOFTWARE.
 */
 
+#include <cstring>
+#include <type_traits>
 #include <utility> /* move */
 
 #include <sail-c++/sail-c++.h>
@@ -119,6 +121,44 @@ static MunitResult test_image_copy(const MunitParameter params[], void *user_dat
     return MUNIT_OK;
 }
 
+static MunitResult test_image_copy_on_write(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail::image image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 16, 16);
+    memset(image.pixels(), 1, image.pixels_size());
+
+    const sail::image image_copy = image;
+    const sail::image &image_ref = image;
+
+    /* Shared until written. */
+    munit_assert_ptr_equal(image_copy.pixels(), image_ref.pixels());
+
+    unsigned char *pixels = static_cast<unsigned char *>(image.pixels());
+    munit_assert_ptr_not_equal(image_copy.pixels(), pixels);
+
+    pixels[0] = 2;
+    munit_assert_uint8(static_cast<const unsigned char *>(image_copy.pixels())[0], ==, 1);
+    munit_assert_uint8(static_cast<const unsigned char *>(image_copy.pixels())[1], ==, 1);
+
+    /* The last owner writes in place. */
+    munit_assert_ptr_equal(image.pixels(), pixels);
+
+    return MUNIT_OK;
+}
+
+/* Containers of these types move their elements on reallocation instead of copying them. */
+static_assert(std::is_nothrow_move_constructible<sail::image>::value,        "sail::image must have a noexcept move");
+static_assert(std::is_nothrow_move_constructible<sail::image_input>::value,  "sail::image_input must have a noexcept move");
+static_assert(std::is_nothrow_move_constructible<sail::image_output>::value, "sail::image_output must have a noexcept move");
+static_assert(std::is_nothrow_move_constructible<sail::codec_info>::value,   "sail::codec_info must have a noexcept move");
+static_assert(std::is_nothrow_move_constructible<sail::load_options>::value, "sail::load_options must have a noexcept move");
+static_assert(std::is_nothrow_move_constructible<sail::save_options>::value, "sail::save_options must have a noexcept move");
+static_assert(std::is_nothrow_move_constructible<sail::meta_data>::value,    "sail::meta_data must have a noexcept move");
+static_assert(std::is_nothrow_move_constructible<sail::variant>::value,      "sail::variant must have a noexcept move");
+static_assert(std::is_nothrow_move_constructible<sail::iccp>::value,         "sail::iccp must have a noexcept move");
+static_assert(std::is_nothrow_move_constructible<sail::palette>::value,      "sail::palette must have a noexcept move");
+
 static MunitResult test_image_move(const MunitParameter params[], void *user_data) {
     (void)params;
     (void)user_data;
@@ -152,10 +192,274 @@ static MunitResult test_image_move(const MunitParameter params[], void *user_dat
     return MUNIT_OK;
 }
 
+static MunitResult test_image_convert_in_place(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    {
+        sail::image image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 16, 16);
+        unsigned char *pixels = static_cast<unsigned char *>(image.pixels());
+
+        for (std::size_t i = 0; i < image.pixels_size(); i++) {
+            pixels[i] = static_cast<unsigned char>(i);
+        }
+
+        /* Owned pixels are reused and packed with the new bytes per line. */
+        munit_assert(image.convert(SAIL_PIXEL_FORMAT_BPP24_RGB) == SAIL_OK);
+        munit_assert(image.pixel_format() == SAIL_PIXEL_FORMAT_BPP24_RGB);
+        munit_assert_uint(image.bytes_per_line(), ==, 16 * 3);
+
+        const sail::image &image_ref = image;
+        munit_assert_ptr_equal(image_ref.pixels(), pixels);
+
+        for (unsigned i = 0; i < 16 * 16; i++) {
+            munit_assert_uint8(pixels[i * 3 + 0], ==, static_cast<unsigned char>(i * 4 + 0));
+            munit_assert_uint8(pixels[i * 3 + 1], ==, static_cast<unsigned char>(i * 4 + 1));
+            munit_assert_uint8(pixels[i * 3 + 2], ==, static_cast<unsigned char>(i * 4 + 2));
+        }
+    }
+
+    {
+        sail::image image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 16, 16);
+        memset(image.pixels(), 1, image.pixels_size());
+
+        /* Pixels shared with a copy are detached first. */
+        const sail::image image_copy = image;
+        munit_assert(image.convert(SAIL_PIXEL_FORMAT_BPP24_RGB) == SAIL_OK);
+
+        munit_assert(image_copy.pixel_format() == SAIL_PIXEL_FORMAT_BPP32_RGBA);
+        munit_assert_uint(image_copy.bytes_per_line(), ==, 16 * 4);
+        munit_assert_uint8(static_cast<const unsigned char *>(image_copy.pixels())[3], ==, 1);
+    }
+
+    {
+        unsigned char pixels[16*16*4] = { 0 };
+        sail::image image(pixels, SAIL_PIXEL_FORMAT_BPP32_RGBA, 16, 16);
+
+        /* Shallow pixels are never modified. */
+        munit_assert(image.convert(SAIL_PIXEL_FORMAT_BPP24_RGB) == SAIL_OK);
+        munit_assert(image.pixel_format() == SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+        const sail::image &image_ref = image;
+        munit_assert_ptr_not_equal(image_ref.pixels(), pixels);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_image_convert_to(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail::image image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 8, 8);
+    memset(image.pixels(), 0x20, image.pixels_size());
+
+    const unsigned char iccp_data[] = { 1, 2, 3, 4 };
+
+    image.set_resolution(sail::resolution(SAIL_RESOLUTION_UNIT_INCH, 72, 96));
+    image.set_iccp(sail::iccp(iccp_data, sizeof(iccp_data)));
+    image.set_meta_data({ sail::meta_data(SAIL_META_DATA_COMMENT, sail::variant(std::string("Comment"))),
+                          sail::meta_data(std::string("Custom"), sail::variant(42)) });
+
+    /* Meta data, resolution, and ICC profile survive the conversion. */
+    const sail::image image_converted = image.convert_to(SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+    munit_assert(image_converted.is_valid());
+    munit_assert(image_converted.pixel_format() == SAIL_PIXEL_FORMAT_BPP24_RGB);
+    munit_assert(image_converted.resolution().unit() == SAIL_RESOLUTION_UNIT_INCH);
+    munit_assert_double(image_converted.resolution().y(), ==, 96);
+    munit_assert_size(image_converted.iccp().data().size(), ==, sizeof(iccp_data));
+    munit_assert_memory_equal(sizeof(iccp_data), image_converted.iccp().data().data(), iccp_data);
+
+    munit_assert_size(image_converted.meta_data().size(), ==, 2);
+    munit_assert(image_converted.meta_data()[0].key() == SAIL_META_DATA_COMMENT);
+    munit_assert_string_equal(image_converted.meta_data()[0].value().value<std::string>().c_str(), "Comment");
+    munit_assert(image_converted.meta_data()[1].key() == SAIL_META_DATA_UNKNOWN);
+    munit_assert_string_equal(image_converted.meta_data()[1].key_unknown().c_str(), "Custom");
+    munit_assert_int(image_converted.meta_data()[1].value().value<int>(), ==, 42);
+
+    /* The source image is untouched. */
+    munit_assert(image.pixel_format() == SAIL_PIXEL_FORMAT_BPP32_RGBA);
+    munit_assert_size(image.meta_data().size(), ==, 2);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_image_scale(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail::image image(SAIL_PIXEL_FORMAT_BPP24_RGB, 32, 16);
+    memset(image.pixels(), 0x40, image.pixels_size());
+
+    {
+        const sail::image image_scaled = image.scale_to(8, 24, SAIL_SCALE_FILTER_BICUBIC);
+
+        munit_assert(image_scaled.is_valid());
+        munit_assert_uint(image_scaled.width(), ==, 8);
+        munit_assert_uint(image_scaled.height(), ==, 24);
+        munit_assert_uint(image_scaled.bytes_per_line(), ==, 8 * 3);
+        munit_assert_uint8(static_cast<const unsigned char *>(image_scaled.pixels())[0], ==, 0x40);
+
+        munit_assert_uint(image.width(), ==, 32);
+    }
+
+    {
+        munit_assert(image.scale(4, 2, SAIL_SCALE_FILTER_AREA) == SAIL_OK);
+
+        munit_assert_uint(image.width(), ==, 4);
+        munit_assert_uint(image.height(), ==, 2);
+        munit_assert_uint8(static_cast<const unsigned char *>(image.pixels())[4 * 2 * 3 - 1], ==, 0x40);
+    }
+
+    {
+        munit_assert(image.scale(0, 2, SAIL_SCALE_FILTER_AREA) == SAIL_ERROR_INVALID_ARGUMENT);
+        munit_assert_uint(image.width(), ==, 4);
+
+        munit_assert(!sail::image().scale_to(4, 4, SAIL_SCALE_FILTER_BOX).is_valid());
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_image_quantize(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail::image image(SAIL_PIXEL_FORMAT_BPP24_RGB, 16, 16);
+    unsigned char *pixels = static_cast<unsigned char *>(image.pixels());
+
+    for (std::size_t i = 0; i < image.pixels_size(); i++) {
+        pixels[i] = static_cast<unsigned char>((i / 3) % 2 == 0 ? 0 : 200);
+    }
+
+    {
+        const sail::image image_quantized = image.quantize_to(256, SAIL_DITHER_NONE);
+
+        munit_assert(image_quantized.is_valid());
+        munit_assert(image_quantized.pixel_format() == SAIL_PIXEL_FORMAT_BPP8_INDEXED);
+        munit_assert(image_quantized.palette().is_valid());
+        munit_assert_uint(image_quantized.palette().color_count(), ==, 2);
+
+        munit_assert(image.pixel_format() == SAIL_PIXEL_FORMAT_BPP24_RGB);
+    }
+
+    {
+        munit_assert(image.quantize(2, SAIL_DITHER_FLOYD_STEINBERG) == SAIL_OK);
+        munit_assert(image.pixel_format() == SAIL_PIXEL_FORMAT_BPP8_INDEXED);
+        munit_assert_uint(image.bytes_per_line(), ==, 16);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_image_view(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail::image image(SAIL_PIXEL_FORMAT_BPP24_RGB, 16, 8);
+
+    for (unsigned y = 0; y < image.height(); y++) {
+        memset(image.scan_line(y), static_cast<int>(y), image.bytes_per_line());
+    }
+
+    const sail::image image_copy = image;
+
+    sail::image view = image.view(4, 2, 8, 3);
+    munit_assert(view.is_valid());
+    munit_assert_uint(view.width(), ==, 8);
+    munit_assert_uint(view.height(), ==, 3);
+    munit_assert_uint(view.bytes_per_line(), ==, image.bytes_per_line());
+    munit_assert_size(view.pixels_size(), ==, 2 * image.bytes_per_line() + 8 * 3);
+
+    /* Shared pixels are detached before making a view. */
+    const sail::image &image_ref = image;
+    munit_assert_ptr_not_equal(image_copy.pixels(), image_ref.pixels());
+    munit_assert_ptr_equal(view.pixels(), static_cast<const char *>(image_ref.scan_line(2)) + 4 * 3);
+
+    static_cast<unsigned char *>(view.scan_line(1))[0] = 100;
+    munit_assert_uint8(static_cast<const unsigned char *>(image_ref.scan_line(3))[4 * 3], ==, 100);
+    munit_assert_uint8(static_cast<const unsigned char *>(image_copy.scan_line(3))[4 * 3], ==, 3);
+
+    /* Copies of views own their pixels and keep the stride. */
+    const sail::image view_copy = view;
+    munit_assert_ptr_not_equal(view_copy.pixels(), view.pixels());
+    munit_assert_uint8(static_cast<const unsigned char *>(view_copy.scan_line(1))[0], ==, 100);
+    munit_assert_uint8(static_cast<const unsigned char *>(view_copy.scan_line(2))[0], ==, 4);
+
+    munit_assert(!image.view(9, 0, 8, 1).is_valid());
+    munit_assert(!image.view(0, 0, 0, 1).is_valid());
+    munit_assert(!sail::image().view(0, 0, 1, 1).is_valid());
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_image_pixel_view(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail::image image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 8, 4);
+
+    {
+        sail::pixel_view<sail_rgba32_t> view = image.view<sail_rgba32_t>();
+        munit_assert(view.is_valid());
+        munit_assert_uint(view.width(), ==, 8);
+        munit_assert_uint(view.height(), ==, 4);
+        munit_assert_size(view.bytes_per_line(), ==, image.bytes_per_line());
+
+        unsigned y = 0;
+
+        for (sail::pixel_view<sail_rgba32_t>::row row : view) {
+            munit_assert_uint(row.size(), ==, 8);
+
+            for (sail_rgba32_t &pixel : row) {
+                pixel.component1 = static_cast<uint8_t>(y);
+                pixel.component4 = 255;
+            }
+
+            y++;
+        }
+
+        munit_assert_uint(y, ==, 4);
+    }
+
+    {
+        const sail::image &image_ref = image;
+        const sail::pixel_view<const sail_rgba32_t> view = image_ref.view<sail_rgba32_t>();
+
+        munit_assert_ptr_equal(view[2].data(), image_ref.scan_line(2));
+        munit_assert_uint8(view.at(5, 3).component1, ==, 3);
+        munit_assert_uint8(view.at(5, 3).component4, ==, 255);
+
+        /* Subviews share the pixels and the bytes per line. */
+        const sail::pixel_view<const sail_rgba32_t> subview = view.subview(2, 1, 3, 2);
+        munit_assert(subview.is_valid());
+        munit_assert_uint(subview.width(), ==, 3);
+        munit_assert_ptr_equal(subview[0].data(), &view.at(2, 1));
+        munit_assert_size(subview.bytes_per_line(), ==, view.bytes_per_line());
+
+        munit_assert(!view.subview(6, 0, 3, 1).is_valid());
+        munit_assert(!view.subview(0, 0, 0, 1).is_valid());
+    }
+
+    /* The pixel type must match the pixel format. */
+    munit_assert(!image.view<sail_rgb24_t>().is_valid());
+    munit_assert(!sail::image().view<sail_rgba32_t>().is_valid());
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
-    { (char *)"/create", test_image_create, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/copy",   test_image_copy,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/move",   test_image_move,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/create",           test_image_create,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/copy",             test_image_copy,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/copy-on-write",    test_image_copy_on_write,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/move",             test_image_move,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/convert-in-place", test_image_convert_in_place, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/convert-to",       test_image_convert_to,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/scale",            test_image_scale,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/quantize",         test_image_quantize,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/view",             test_image_view,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/pixel-view",       test_image_pixel_view,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
@@ -0,0 +1,219 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sail-c++/suppress_begin.h>
+#include <sail-c++/suppress_c4251.h>
+
+#include <sail-c++/image.h>
+#include <sail-c++/image_cache.h>
+
+#include <sail-c++/suppress_end.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+/* Creates a 16x16 BPP8 image of 256 bytes. */
+static sail_status_t create_image(sail::image *image) {
+
+    *image = sail::image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 16, 16);
+
+    return image->is_valid() ? SAIL_OK : SAIL_ERROR_MEMORY_ALLOCATION;
+}
+
+static MunitResult test_hit_miss(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    sail::image_cache cache(1024 * 1024);
+    unsigned loads = 0;
+
+    const sail::image_cache::loader_t loader = [&loads](sail::image *image) {
+        loads++;
+        return create_image(image);
+    };
+
+    const std::shared_ptr<const sail::image> image1 = cache.load("key", loader);
+    munit_assert_not_null(image1.get());
+
+    const std::shared_ptr<const sail::image> image2 = cache.load("key", loader);
+    munit_assert(image1 == image2);
+    munit_assert_uint(loads, ==, 1);
+
+    munit_assert_null(cache.find("missing").get());
+
+    /* Failed loads are not cached. */
+    const sail::image_cache::loader_t failing_loader = [](sail::image *) {
+        return SAIL_ERROR_NOT_IMPLEMENTED;
+    };
+    munit_assert_null(cache.load("failing", failing_loader).get());
+
+    const sail::image_cache::statistics stats = cache.stats();
+    munit_assert_uint64(stats.hits,   ==, 1);
+    munit_assert_uint64(stats.misses, ==, 3);
+    munit_assert_size(stats.images,   ==, 1);
+    munit_assert_size(stats.bytes,    ==, image1->pixels_size());
+
+    cache.erase("key");
+    munit_assert_null(cache.find("key").get());
+    munit_assert_size(cache.stats().bytes, ==, 0);
+
+    /* Images stay valid after removing them from the cache. */
+    munit_assert(image1->is_valid());
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_eviction(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Room for two 256-byte images. The budget is shared by the shards, so it's the same with many shards. */
+    for (unsigned shards : { 1u, 4u }) {
+        sail::image_cache cache(600, shards);
+
+        munit_assert_not_null(cache.load("1", create_image).get());
+        munit_assert_not_null(cache.load("2", create_image).get());
+
+        /* Touch the first key to evict the second one. */
+        munit_assert_not_null(cache.find("1").get());
+        munit_assert_not_null(cache.load("3", create_image).get());
+
+        munit_assert_not_null(cache.find("1").get());
+        munit_assert_null(cache.find("2").get());
+        munit_assert_not_null(cache.find("3").get());
+
+        const sail::image_cache::statistics stats = cache.stats();
+        munit_assert_uint64(stats.evictions, ==, 1);
+        munit_assert_size(stats.images,      ==, 2);
+        munit_assert_size(stats.bytes,       <=, cache.byte_budget());
+
+        cache.clear();
+        munit_assert_size(cache.stats().images, ==, 0);
+        munit_assert_size(cache.stats().bytes,  ==, 0);
+    }
+
+    /* Too large to cache. */
+    sail::image_cache small_cache(100, 1);
+    munit_assert_not_null(small_cache.load("1", create_image).get());
+    munit_assert_size(small_cache.stats().images, ==, 0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_single_flight(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    sail::image_cache cache(1024 * 1024);
+    std::atomic<unsigned> loads(0);
+
+    const sail::image_cache::loader_t loader = [&loads](sail::image *image) {
+        loads++;
+        /* Keep the key loading while the other threads look it up. */
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return create_image(image);
+    };
+
+    const unsigned threads_count = 4;
+    std::vector<std::shared_ptr<const sail::image>> images(threads_count);
+    std::vector<std::thread> threads;
+
+    for (unsigned i = 0; i < threads_count; i++) {
+        threads.emplace_back([&cache, &loader, &images, i] {
+            images[i] = cache.load("key", loader);
+        });
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    munit_assert_uint(loads, ==, 1);
+
+    for (unsigned i = 0; i < threads_count; i++) {
+        munit_assert_not_null(images[i].get());
+        munit_assert(images[i] == images[0]);
+    }
+
+    const sail::image_cache::statistics stats = cache.stats();
+    munit_assert_uint64(stats.misses, ==, 1);
+    munit_assert_uint64(stats.hits + stats.shared_loads, ==, threads_count - 1);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_path(const MunitParameter params[], void *user_data) {
+
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    sail::image_cache cache(64 * 1024 * 1024);
+
+    const std::shared_ptr<const sail::image> image1 = cache.load(std::string(path));
+    munit_assert_not_null(image1.get());
+    munit_assert(image1->is_valid());
+
+    munit_assert(cache.load(std::string(path)) == image1);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/hit-miss",      test_hit_miss,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/eviction",      test_eviction,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/single-flight", test_single_flight, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/load-path",     test_load_path,     NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/bindings/c++/image-cache",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,107 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <algorithm>
+
+#include <sail-c++/sail-c++.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_image_output_arbitrary_data(const MunitParameter params[], void *user_data) {
+
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const sail::codec_info codec_info = sail::codec_info::from_path(path);
+    munit_assert(codec_info.is_valid());
+
+    const sail::image image(path);
+    munit_assert(image.is_valid());
+
+    const std::vector<SailPixelFormat> &pixel_formats = codec_info.save_features().pixel_formats();
+
+    if (std::find(pixel_formats.begin(), pixel_formats.end(), image.pixel_format()) == pixel_formats.end()) {
+        return MUNIT_SKIP;
+    }
+
+    /* Garbage from the previous contents must not leak into the output. */
+    sail::arbitrary_data arbitrary_data(1024 * 1024, 0xFF);
+
+    {
+        sail::image_output output(&arbitrary_data, codec_info);
+        munit_assert(output.next_frame(image) == SAIL_OK);
+        munit_assert(output.finish() == SAIL_OK);
+    }
+
+    munit_assert_false(arbitrary_data.empty());
+
+    /* Compare with the fixed memory buffer output. */
+    sail::arbitrary_data fixed_buffer(arbitrary_data.size() * 2 + 1024);
+
+    {
+        sail::image_output output(fixed_buffer.data(), fixed_buffer.size(), codec_info);
+        munit_assert(output.next_frame(image) == SAIL_OK);
+        munit_assert(output.finish() == SAIL_OK);
+    }
+
+    munit_assert_memory_equal(arbitrary_data.size(), arbitrary_data.data(), fixed_buffer.data());
+
+    /* Load it back. */
+    sail::image_input input(arbitrary_data);
+    input.with(codec_info);
+    sail::image loaded_image;
+
+    munit_assert(input.next_frame(&loaded_image) == SAIL_OK);
+    munit_assert_uint(loaded_image.width(), ==, image.width());
+    munit_assert_uint(loaded_image.height(), ==, image.height());
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/arbitrary-data", test_image_output_arbitrary_data, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/bindings/c++/image-output",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -46,6 +46,10 @@ static MunitResult test_load_options_construct(const MunitParameter params[], vo
 
         munit_assert(load_options.options() == 0);
         munit_assert(load_options.tuning().empty());
+        munit_assert(load_options.row_alignment() == 0);
+        munit_assert(load_options.pixels_alignment() == 0);
+        munit_assert(load_options.meta_data_keys() == 0);
+        munit_assert(load_options.output_pixel_format() == SAIL_PIXEL_FORMAT_UNKNOWN);
     }
 
     {
@@ -86,6 +90,27 @@ static MunitResult test_load_options_copy(const MunitParameter params[], void *u
         munit_assert(load_options.tuning()  == load_options2.tuning());
     }
 
+    {
+        sail::load_options load_options;
+        load_options.set_row_alignment(32);
+        load_options.set_pixels_alignment(64);
+        load_options.set_output_pixel_format(SAIL_PIXEL_FORMAT_BPP32_BGRA);
+        load_options.set_meta_data_keys(SAIL_META_DATA_KEY_BIT(SAIL_META_DATA_EXIF));
+
+        const sail::load_options load_options2 = load_options;
+        munit_assert(load_options2.row_alignment() == 32);
+        munit_assert(load_options2.meta_data_keys() == SAIL_META_DATA_KEY_BIT(SAIL_META_DATA_EXIF));
+        munit_assert(load_options2.pixels_alignment() == 64);
+        munit_assert(load_options2.output_pixel_format() == SAIL_PIXEL_FORMAT_BPP32_BGRA);
+
+        /* Copies share the options until modified. */
+        sail::load_options load_options3 = load_options;
+        load_options3.set_row_alignment(16);
+        munit_assert(load_options3.row_alignment() == 16);
+        munit_assert(load_options.row_alignment() == 32);
+        munit_assert(load_options2.row_alignment() == 32);
+    }
+
     return MUNIT_OK;
 }
 
@@ -0,0 +1,146 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <cstring>
+#include <vector>
+
+#include <sail-c++/sail-c++.h>
+
+#include "munit.h"
+
+namespace
+{
+
+constexpr unsigned width  = 37;
+constexpr unsigned height = 5;
+
+/* Converts the same pixels at compile time and at runtime and compares the results. */
+template<SailPixelFormat From, SailPixelFormat To>
+void check_convert()
+{
+    sail::image input(From, width, height);
+    unsigned char *input_pixels = static_cast<unsigned char *>(input.pixels());
+
+    for (std::size_t i = 0; i < input.pixels_size(); i++) {
+        input_pixels[i] = static_cast<unsigned char>(i * 31 + 7);
+    }
+
+    sail::image output(To, width, height);
+    sail::image output_runtime(To, width, height);
+
+    using input_type  = typename sail::pixel_format_traits<From>::type;
+    using output_type = typename sail::pixel_format_traits<To>::type;
+
+    const sail::image &input_ref = input;
+
+    munit_assert((sail::convert<From, To>(input_ref.view<input_type>(), output.view<output_type>()) == SAIL_OK));
+    munit_assert(sail::convert(input_ref.view<input_type>(), From, output_runtime.view<output_type>(), To) == SAIL_OK);
+
+    for (unsigned y = 0; y < height; y++) {
+        munit_assert_memory_equal(sail::image::bytes_per_line(width, To), output.scan_line(y), output_runtime.scan_line(y));
+    }
+}
+
+}
+
+static MunitResult test_compile_time(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    check_convert<SAIL_PIXEL_FORMAT_BPP24_RGB,  SAIL_PIXEL_FORMAT_BPP24_BGR>();
+    check_convert<SAIL_PIXEL_FORMAT_BPP24_RGB,  SAIL_PIXEL_FORMAT_BPP32_RGBA>();
+    check_convert<SAIL_PIXEL_FORMAT_BPP32_BGRA, SAIL_PIXEL_FORMAT_BPP24_RGB>();
+    check_convert<SAIL_PIXEL_FORMAT_BPP32_BGRA, SAIL_PIXEL_FORMAT_BPP32_RGBA>();
+    check_convert<SAIL_PIXEL_FORMAT_BPP32_ARGB, SAIL_PIXEL_FORMAT_BPP32_ABGR>();
+    check_convert<SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP64_BGRA>();
+    check_convert<SAIL_PIXEL_FORMAT_BPP48_RGB,  SAIL_PIXEL_FORMAT_BPP24_RGB>();
+    check_convert<SAIL_PIXEL_FORMAT_BPP64_RGBA, SAIL_PIXEL_FORMAT_BPP32_BGRA>();
+    check_convert<SAIL_PIXEL_FORMAT_BPP64_ABGR, SAIL_PIXEL_FORMAT_BPP48_BGR>();
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_x_channel(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail::image input(SAIL_PIXEL_FORMAT_BPP24_RGB, width, height);
+    memset(input.pixels(), 0x10, input.pixels_size());
+
+    sail::image output(SAIL_PIXEL_FORMAT_BPP32_XRGB, width, height);
+
+    const sail::image &input_ref = input;
+    munit_assert((sail::convert<SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP32_XRGB>(input_ref.view<sail_rgb24_t>(),
+                                                                                            output.view<sail_xrgb32_t>()) == SAIL_OK));
+
+    /* X channels are filled with the maximum value. */
+    const sail_xrgb32_t pixel = output.view<sail_xrgb32_t>().at(width - 1, height - 1);
+    munit_assert_uint8(pixel.component1, ==, 255);
+    munit_assert_uint8(pixel.component2, ==, 0x10);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_invalid(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail::image input(SAIL_PIXEL_FORMAT_BPP24_RGB, width, height);
+    sail::image output(SAIL_PIXEL_FORMAT_BPP24_BGR, width, height + 1);
+
+    const sail::image &input_ref = input;
+
+    /* Dimensions must match. */
+    munit_assert((sail::convert<SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP24_BGR>(input_ref.view<sail_rgb24_t>(),
+                                                                                           output.view<sail_bgr24_t>()) == SAIL_ERROR_INVALID_ARGUMENT));
+    munit_assert(sail::convert(input_ref.view<sail_rgb24_t>(), SAIL_PIXEL_FORMAT_BPP24_RGB,
+                               output.view<sail_bgr24_t>(), SAIL_PIXEL_FORMAT_BPP24_BGR) == SAIL_ERROR_INVALID_ARGUMENT);
+
+    /* Invalid views. */
+    munit_assert((sail::convert<SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP24_BGR>(sail::pixel_view<const sail_rgb24_t>(),
+                                                                                           output.view<sail_bgr24_t>()) == SAIL_ERROR_INVALID_ARGUMENT));
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/compile-time", test_compile_time, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/x-channel",    test_x_channel,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/invalid",      test_invalid,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/bindings/c++/pixel-convert",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
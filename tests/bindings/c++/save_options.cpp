@@ -81,6 +81,12 @@ static MunitResult test_save_options_copy(const MunitParameter params[], void *u
         munit_assert(save_options.compression()       == save_options2.compression());
         munit_assert(save_options.compression_level() == save_options2.compression_level());
         munit_assert(save_options.tuning()            == save_options2.tuning());
+
+        /* Copies share the options until modified. */
+        sail::save_options save_options3 = save_options;
+        save_options3.set_options(save_options.options() ^ SAIL_OPTION_META_DATA);
+        munit_assert(save_options3.options() != save_options.options());
+        munit_assert(save_options2.options() == save_options.options());
     }
 
     return MUNIT_OK;
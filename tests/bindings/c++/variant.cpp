@@ -134,6 +134,23 @@ static MunitResult test_move(const MunitParameter params[], void *user_data) {
     munit_assert(variant2.has_value<short>());
     munit_assert(variant2.value<short>() == reference_value);
 
+    /* Strings and data are moved in without copying their buffers. */
+    {
+        std::string str(1000, 'a');
+        const char *str_data = str.data();
+
+        const sail::variant variant3(std::move(str));
+        munit_assert(variant3.has_value<std::string>());
+        munit_assert_ptr_equal(variant3.value<std::string>().data(), str_data);
+
+        sail::arbitrary_data data(1000, 1);
+        const unsigned char *data_data = data.data();
+
+        variant2.set_value(std::move(data));
+        munit_assert(variant2.has_value<sail::arbitrary_data>());
+        munit_assert_ptr_equal(variant2.value<sail::arbitrary_data>().data(), data_data);
+    }
+
     return MUNIT_OK;
 }
 
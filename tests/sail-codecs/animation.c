@@ -0,0 +1,565 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "common/animation/animation.h"
+
+#include "munit.h"
+
+/*
+ * Blending kernels.
+ */
+
+struct blend_format {
+
+    const char *name;
+    enum SailPixelFormat pixel_format;
+    unsigned components;
+    unsigned bytes_per_component;
+    unsigned alpha_index;
+};
+
+static const struct blend_format blend_formats[] = {
+    { "BPP16-GRAYSCALE-ALPHA",    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA,    2, 1, 1 },
+    { "BPP32-GRAYSCALE-ALPHA",    SAIL_PIXEL_FORMAT_BPP32_GRAYSCALE_ALPHA,    2, 2, 1 },
+    { "BPP32-RGBA",               SAIL_PIXEL_FORMAT_BPP32_RGBA,               4, 1, 3 },
+    { "BPP32-ARGB",               SAIL_PIXEL_FORMAT_BPP32_ARGB,               4, 1, 0 },
+    { "BPP64-RGBA",               SAIL_PIXEL_FORMAT_BPP64_RGBA,               4, 2, 3 },
+    { "BPP64-ARGB",               SAIL_PIXEL_FORMAT_BPP64_ARGB,               4, 2, 0 },
+    { "BPP32-RGBA-PREMULTIPLIED", SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, 4, 1, 3 },
+    { "BPP64-RGBA-PREMULTIPLIED", SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED, 4, 2, 3 },
+};
+
+static char *blend_format_names[] = {
+    (char *)"BPP16-GRAYSCALE-ALPHA",
+    (char *)"BPP32-GRAYSCALE-ALPHA",
+    (char *)"BPP32-RGBA",
+    (char *)"BPP32-ARGB",
+    (char *)"BPP64-RGBA",
+    (char *)"BPP64-ARGB",
+    (char *)"BPP32-RGBA-PREMULTIPLIED",
+    (char *)"BPP64-RGBA-PREMULTIPLIED",
+    NULL
+};
+
+#define MAX_BLEND_WIDTH 67
+
+/*
+ * Fills a row with random pixels. Alpha is the same in groups of 4 pixels, and is random,
+ * fully transparent, or fully opaque, so the SIMD kernels take all their paths.
+ */
+static void fill_blend_row(const struct blend_format *format, uint8_t *row, unsigned width) {
+
+    const unsigned bytes_per_pixel = format->components * format->bytes_per_component;
+
+    munit_rand_memory((size_t)width * bytes_per_pixel, row);
+
+    for (unsigned column = 0; column < width; column += 4) {
+        const uint32_t mode = munit_rand_int_range(0, 2);
+
+        for (unsigned i = column; i < column + 4 && i < width; i++) {
+            uint8_t *alpha = row + (size_t)i * bytes_per_pixel + format->alpha_index * format->bytes_per_component;
+
+            if (mode < 2) {
+                memset(alpha, (mode == 0) ? 0 : 0xFF, format->bytes_per_component);
+            }
+        }
+    }
+}
+
+static MunitResult test_blend_kernels(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *name = munit_parameters_get(params, "pixel-format");
+    const struct blend_format *format = NULL;
+
+    for (size_t i = 0; i < sizeof(blend_formats) / sizeof(blend_formats[0]); i++) {
+        if (strcmp(blend_formats[i].name, name) == 0) {
+            format = &blend_formats[i];
+        }
+    }
+
+    munit_assert_not_null(format);
+    munit_assert(sail_pixel_format_from_string(name) == format->pixel_format);
+
+    const animation_blend_row_t blend_row          = animation_private_blend_row(format->pixel_format, false);
+    const animation_blend_row_t blend_row_portable = animation_private_blend_row(format->pixel_format, true);
+    munit_assert_not_null(blend_row);
+    munit_assert_not_null(blend_row_portable);
+
+    const unsigned bytes_per_pixel = format->components * format->bytes_per_component;
+
+    uint8_t src[MAX_BLEND_WIDTH * 8];
+    uint8_t dst[MAX_BLEND_WIDTH * 8];
+    uint8_t dst_portable[MAX_BLEND_WIDTH * 8];
+
+    /* Every width to cover the SIMD bodies and their tails. */
+    for (unsigned width = 1; width <= MAX_BLEND_WIDTH; width++) {
+        fill_blend_row(format, src, width);
+        fill_blend_row(format, dst, width);
+        memcpy(dst_portable, dst, (size_t)width * bytes_per_pixel);
+
+        blend_row(dst, src, width);
+        blend_row_portable(dst_portable, src, width);
+
+        munit_assert_memory_equal((size_t)width * bytes_per_pixel, dst, dst_portable);
+    }
+
+    /* Pixel formats without alpha are not blended. */
+    munit_assert_null(animation_private_blend_row(SAIL_PIXEL_FORMAT_BPP24_RGB, false));
+    munit_assert_null(animation_private_blend_row(SAIL_PIXEL_FORMAT_BPP24_RGB, true));
+
+    return MUNIT_OK;
+}
+
+/*
+ * Dispose operations.
+ */
+
+#define CANVAS_SIZE 4
+
+static const uint8_t background_pixel[4] = { 10, 20, 30, 40 };
+static const uint8_t red_pixel[4]        = { 255, 0, 0, 255 };
+static const uint8_t green_pixel[4]      = { 0, 255, 0, 255 };
+static const uint8_t blue_pixel[4]       = { 0, 0, 255, 255 };
+
+/* Starts the frame and fills it with the pixel. */
+static void composite_frame(struct animation_canvas *canvas, const struct animation_frame *frame, const uint8_t pixel[4]) {
+
+    munit_assert(animation_private_start_frame(canvas, frame) == SAIL_OK);
+
+    void *pixels;
+    unsigned bytes_per_line;
+    munit_assert(animation_private_frame_pixels(canvas, &pixels, &bytes_per_line) == SAIL_OK);
+
+    for (unsigned row = 0; row < frame->rect.height; row++) {
+        for (unsigned column = 0; column < frame->rect.width; column++) {
+            memcpy((uint8_t *)pixels + (size_t)row * bytes_per_line + column * 4, pixel, 4);
+        }
+    }
+
+    animation_private_finish_frame(canvas);
+}
+
+/* Copies the canvas or the dirty rectangle into a new image. */
+static struct sail_image* canvas_image(const struct animation_canvas *canvas, bool dirty_only) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    munit_assert(sail_alloc_source_image(&image->source_image) == SAIL_OK);
+    munit_assert(animation_private_setup_image(canvas, dirty_only, image) == SAIL_OK);
+    munit_assert(sail_malloc((size_t)image->height * image->bytes_per_line, &image->pixels) == SAIL_OK);
+
+    animation_private_copy_to_image(canvas, dirty_only, image);
+
+    return image;
+}
+
+static unsigned special_property(const struct sail_image *image, const char *key) {
+
+    const struct sail_variant *variant = sail_hash_map_value(image->source_image->special_properties, key);
+    munit_assert_not_null(variant);
+    munit_assert(variant->type == SAIL_VARIANT_TYPE_UNSIGNED_INT);
+
+    return sail_variant_to_unsigned_int(variant);
+}
+
+static void assert_pixel(const struct sail_image *image, unsigned x, unsigned y, const uint8_t pixel[4]) {
+
+    munit_assert_memory_equal(4, (const uint8_t *)sail_scan_line(image, y) + x * 4, pixel);
+}
+
+static void assert_dirty_rect(const struct animation_canvas *canvas, unsigned x, unsigned y, unsigned width, unsigned height) {
+
+    struct sail_image *image = canvas_image(canvas, true);
+
+    munit_assert_uint(special_property(image, "animation-frame-x"),       ==, x);
+    munit_assert_uint(special_property(image, "animation-frame-y"),       ==, y);
+    munit_assert_uint(special_property(image, "animation-canvas-width"),  ==, CANVAS_SIZE);
+    munit_assert_uint(special_property(image, "animation-canvas-height"), ==, CANVAS_SIZE);
+    munit_assert_uint(image->width,  ==, width);
+    munit_assert_uint(image->height, ==, height);
+
+    struct sail_image *whole_canvas = canvas_image(canvas, false);
+
+    for (unsigned row = 0; row < height; row++) {
+        munit_assert_memory_equal((size_t)width * 4, sail_scan_line(image, row),
+                                  (const uint8_t *)sail_scan_line(whole_canvas, y + row) + x * 4);
+    }
+
+    sail_destroy_image(whole_canvas);
+    sail_destroy_image(image);
+}
+
+static MunitResult test_dispose(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *dispose_name = munit_parameters_get(params, "dispose");
+    enum SailAnimationDispose dispose;
+
+    if (strcmp(dispose_name, "none") == 0) {
+        dispose = SAIL_ANIMATION_DISPOSE_NONE;
+    } else if (strcmp(dispose_name, "background") == 0) {
+        dispose = SAIL_ANIMATION_DISPOSE_BACKGROUND;
+    } else {
+        dispose = SAIL_ANIMATION_DISPOSE_PREVIOUS;
+    }
+
+    struct animation_canvas *canvas;
+    munit_assert(animation_private_alloc_canvas(CANVAS_SIZE, CANVAS_SIZE, SAIL_PIXEL_FORMAT_BPP32_RGBA,
+                                                background_pixel, false, &canvas) == SAIL_OK);
+
+    const struct animation_frame frame1 = { { 0, 0, CANVAS_SIZE, CANVAS_SIZE }, SAIL_ANIMATION_DISPOSE_NONE, SAIL_ANIMATION_BLEND_SOURCE };
+    const struct animation_frame frame2 = { { 1, 1, 2, 2 }, dispose, SAIL_ANIMATION_BLEND_OVER };
+    const struct animation_frame frame3 = { { 3, 3, 1, 1 }, SAIL_ANIMATION_DISPOSE_NONE, SAIL_ANIMATION_BLEND_SOURCE };
+
+    /* The first frame is the whole canvas. */
+    composite_frame(canvas, &frame1, red_pixel);
+    assert_dirty_rect(canvas, 0, 0, CANVAS_SIZE, CANVAS_SIZE);
+
+    composite_frame(canvas, &frame2, green_pixel);
+    assert_dirty_rect(canvas, 1, 1, 2, 2);
+
+    struct sail_image *image = canvas_image(canvas, false);
+    assert_pixel(image, 0, 0, red_pixel);
+    assert_pixel(image, 1, 1, green_pixel);
+    assert_pixel(image, 2, 2, green_pixel);
+    sail_destroy_image(image);
+
+    /* The disposed area of the second frame and the third frame. */
+    composite_frame(canvas, &frame3, blue_pixel);
+
+    if (dispose == SAIL_ANIMATION_DISPOSE_NONE) {
+        assert_dirty_rect(canvas, 3, 3, 1, 1);
+    } else {
+        assert_dirty_rect(canvas, 1, 1, 3, 3);
+    }
+
+    const uint8_t *disposed_pixel = (dispose == SAIL_ANIMATION_DISPOSE_NONE) ? green_pixel :
+                                        ((dispose == SAIL_ANIMATION_DISPOSE_BACKGROUND) ? background_pixel : red_pixel);
+
+    image = canvas_image(canvas, false);
+    assert_pixel(image, 0, 0, red_pixel);
+    assert_pixel(image, 1, 1, disposed_pixel);
+    assert_pixel(image, 2, 2, disposed_pixel);
+    assert_pixel(image, 3, 3, blue_pixel);
+    sail_destroy_image(image);
+
+    animation_private_destroy_canvas(canvas);
+
+    return MUNIT_OK;
+}
+
+/*
+ * Dirty rectangles of an APNG generated in memory.
+ */
+
+#define APNG_SIZE 8
+
+struct apng_buffer {
+
+    uint8_t data[4096];
+    size_t size;
+};
+
+struct apng_frame {
+
+    unsigned x;
+    unsigned y;
+    unsigned width;
+    unsigned height;
+    uint8_t dispose_op;
+    uint8_t blend_op;
+    uint8_t pixel[4];
+};
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t size) {
+
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+
+    return crc;
+}
+
+static void append(struct apng_buffer *buffer, const void *data, size_t size) {
+
+    munit_assert_size(buffer->size + size, <=, sizeof(buffer->data));
+
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+
+static void append_be32(struct apng_buffer *buffer, uint32_t value) {
+
+    const uint8_t bytes[] = { (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value };
+    append(buffer, bytes, sizeof(bytes));
+}
+
+static void append_be16(struct apng_buffer *buffer, uint16_t value) {
+
+    const uint8_t bytes[] = { (uint8_t)(value >> 8), (uint8_t)value };
+    append(buffer, bytes, sizeof(bytes));
+}
+
+static void append_chunk(struct apng_buffer *buffer, const char *type, const struct apng_buffer *chunk_data) {
+
+    append_be32(buffer, (uint32_t)chunk_data->size);
+
+    const size_t crc_start = buffer->size;
+    append(buffer, type, 4);
+    append(buffer, chunk_data->data, chunk_data->size);
+
+    append_be32(buffer, ~crc32_update(0xFFFFFFFFu, buffer->data + crc_start, buffer->size - crc_start));
+}
+
+/* Appends the frame pixels as a zlib stream of a single stored deflate block. */
+static void append_frame_pixels(struct apng_buffer *buffer, const struct apng_frame *frame) {
+
+    struct apng_buffer raw = { { 0 }, 0 };
+
+    for (unsigned row = 0; row < frame->height; row++) {
+        const uint8_t filter = 0;
+        append(&raw, &filter, 1);
+
+        for (unsigned column = 0; column < frame->width; column++) {
+            append(&raw, frame->pixel, 4);
+        }
+    }
+
+    const uint8_t header[] = { 0x78, 0x01, 0x01 };
+    append(buffer, header, sizeof(header));
+
+    const uint8_t lengths[] = { (uint8_t)raw.size, (uint8_t)(raw.size >> 8), (uint8_t)~raw.size, (uint8_t)(~raw.size >> 8) };
+    append(buffer, lengths, sizeof(lengths));
+    append(buffer, raw.data, raw.size);
+
+    uint32_t a = 1;
+    uint32_t b = 0;
+
+    for (size_t i = 0; i < raw.size; i++) {
+        a = (a + raw.data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+
+    append_be32(buffer, (b << 16) | a);
+}
+
+static void generate_apng(const struct apng_frame *frames, unsigned frames_count, struct apng_buffer *buffer) {
+
+    static const uint8_t signature[] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+    append(buffer, signature, sizeof(signature));
+
+    struct apng_buffer chunk = { { 0 }, 0 };
+    append_be32(&chunk, APNG_SIZE);
+    append_be32(&chunk, APNG_SIZE);
+    const uint8_t ihdr[] = { 8 /* bit depth */, 6 /* RGBA */, 0, 0, 0 };
+    append(&chunk, ihdr, sizeof(ihdr));
+    append_chunk(buffer, "IHDR", &chunk);
+
+    chunk.size = 0;
+    append_be32(&chunk, frames_count);
+    append_be32(&chunk, 0);
+    append_chunk(buffer, "acTL", &chunk);
+
+    uint32_t sequence = 0;
+
+    for (unsigned i = 0; i < frames_count; i++) {
+        chunk.size = 0;
+        append_be32(&chunk, sequence++);
+        append_be32(&chunk, frames[i].width);
+        append_be32(&chunk, frames[i].height);
+        append_be32(&chunk, frames[i].x);
+        append_be32(&chunk, frames[i].y);
+        append_be16(&chunk, 1);
+        append_be16(&chunk, 10);
+        append(&chunk, &frames[i].dispose_op, 1);
+        append(&chunk, &frames[i].blend_op, 1);
+        append_chunk(buffer, "fcTL", &chunk);
+
+        chunk.size = 0;
+
+        if (i > 0) {
+            append_be32(&chunk, sequence++);
+        }
+
+        append_frame_pixels(&chunk, &frames[i]);
+        append_chunk(buffer, (i == 0) ? "IDAT" : "fdAT", &chunk);
+    }
+
+    chunk.size = 0;
+    append_chunk(buffer, "IEND", &chunk);
+}
+
+static MunitResult test_apng_dirty_rectangles(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    /* Dispose: 0 none, 1 background, 2 previous. Blend: 0 source, 1 over. */
+    static const struct apng_frame frames[] = {
+        { 0, 0, APNG_SIZE, APNG_SIZE, 0, 0, { 255, 0,   0,   255 } },
+        { 2, 2, 3,         3,         1, 0, { 0,   255, 0,   255 } },
+        { 5, 5, 2,         2,         2, 1, { 0,   0,   255, 128 } },
+        { 0, 0, 1,         1,         0, 0, { 255, 255, 255, 255 } },
+    };
+
+    static const struct animation_rect dirty_rects[] = {
+        { 0, 0, APNG_SIZE, APNG_SIZE },
+        { 2, 2, 3, 3 },
+        { 2, 2, 5, 5 },
+        { 0, 0, 7, 7 },
+    };
+
+    const unsigned frames_count = sizeof(frames) / sizeof(frames[0]);
+
+    struct apng_buffer buffer = { { 0 }, 0 };
+    generate_apng(frames, frames_count, &buffer);
+
+    /* Without APNG support, the default image is the first frame. */
+    if (!(codec_info->load_features->features & SAIL_CODEC_FEATURE_ANIMATED)) {
+        struct sail_image *image;
+        munit_assert(sail_load_from_memory(buffer.data, buffer.size, &image) == SAIL_OK);
+        munit_assert_uint(image->width,  ==, APNG_SIZE);
+        munit_assert_uint(image->height, ==, APNG_SIZE);
+        munit_assert(image->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA);
+        assert_pixel(image, APNG_SIZE - 1, APNG_SIZE - 1, red_pixel);
+        sail_destroy_image(image);
+
+        return MUNIT_SKIP;
+    }
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->options |= SAIL_OPTION_SOURCE_IMAGE;
+
+    void *state = NULL;
+    void *dirty_state = NULL;
+    munit_assert(sail_start_loading_from_memory_with_options(buffer.data, buffer.size, codec_info, load_options, &state) == SAIL_OK);
+
+    load_options->options |= SAIL_OPTION_DIRTY_RECTANGLES;
+    munit_assert(sail_start_loading_from_memory_with_options(buffer.data, buffer.size, codec_info, load_options, &dirty_state) == SAIL_OK);
+
+    struct sail_image *first_canvas = NULL;
+
+    for (unsigned i = 0; i < frames_count; i++) {
+        struct sail_image *canvas;
+        struct sail_image *dirty;
+        munit_assert(sail_load_next_frame(state, &canvas) == SAIL_OK);
+        munit_assert(sail_load_next_frame(dirty_state, &dirty) == SAIL_OK);
+
+        const struct animation_rect *rect = &dirty_rects[i];
+
+        munit_assert_uint(special_property(dirty, "animation-frame-x"),       ==, rect->x);
+        munit_assert_uint(special_property(dirty, "animation-frame-y"),       ==, rect->y);
+        munit_assert_uint(special_property(dirty, "animation-canvas-width"),  ==, APNG_SIZE);
+        munit_assert_uint(special_property(dirty, "animation-canvas-height"), ==, APNG_SIZE);
+        munit_assert_uint(dirty->width,  ==, rect->width);
+        munit_assert_uint(dirty->height, ==, rect->height);
+        munit_assert(dirty->pixel_format == canvas->pixel_format);
+
+        /* Dirty rectangles are the same as the areas of the whole canvas. */
+        const unsigned bytes_per_pixel = sail_bits_per_pixel(canvas->pixel_format) / 8;
+
+        for (unsigned row = 0; row < rect->height; row++) {
+            munit_assert_memory_equal((size_t)rect->width * bytes_per_pixel, sail_scan_line(dirty, row),
+                                      (const uint8_t *)sail_scan_line(canvas, rect->y + row) + rect->x * bytes_per_pixel);
+        }
+
+        const size_t pixel_offset = 5 * canvas->bytes_per_line + 5 * bytes_per_pixel;
+
+        if (i == 0) {
+            first_canvas = canvas;
+            canvas = NULL;
+        } else if (i == 2) {
+            /* The second frame was disposed to transparent black. */
+            const uint8_t transparent[8] = { 0 };
+            munit_assert_memory_equal(bytes_per_pixel, (const uint8_t *)sail_scan_line(canvas, 2) + 2 * bytes_per_pixel, transparent);
+            munit_assert_memory_not_equal(bytes_per_pixel, (const uint8_t *)canvas->pixels + pixel_offset,
+                                          (const uint8_t *)first_canvas->pixels + pixel_offset);
+        } else if (i == 3) {
+            /* The third frame was disposed to the previous canvas. */
+            munit_assert_memory_equal(bytes_per_pixel, (const uint8_t *)canvas->pixels + pixel_offset,
+                                      (const uint8_t *)first_canvas->pixels + pixel_offset);
+        }
+
+        sail_destroy_image(canvas);
+        sail_destroy_image(dirty);
+    }
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+    munit_assert(sail_stop_loading(dirty_state) == SAIL_OK);
+
+    sail_destroy_image(first_canvas);
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static char *dispose_names[] = { (char *)"none", (char *)"background", (char *)"previous", NULL };
+
+static MunitParameterEnum blend_params[] = {
+    { (char *)"pixel-format", blend_format_names },
+    { NULL, NULL },
+};
+
+static MunitParameterEnum dispose_params[] = {
+    { (char *)"dispose", dispose_names },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/blend-kernels",         test_blend_kernels,         NULL, NULL, MUNIT_TEST_OPTION_NONE, blend_params },
+    { (char *)"/dispose",               test_dispose,               NULL, NULL, MUNIT_TEST_OPTION_NONE, dispose_params },
+    { (char *)"/apng-dirty-rectangles", test_apng_dirty_rectangles, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/animation",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
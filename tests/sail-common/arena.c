@@ -0,0 +1,145 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "munit.h"
+
+static MunitResult test_side_structures(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_arena *arena = NULL;
+    munit_assert(sail_alloc_arena(&arena) == SAIL_OK);
+    munit_assert_not_null(arena);
+
+    munit_assert_null(sail_set_thread_arena(arena));
+
+    struct sail_palette *palette = NULL;
+    munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 256, &palette) == SAIL_OK);
+    memset(palette->data, 0xAA, 256 * 3);
+
+    struct sail_meta_data_node *meta_data_node = NULL;
+    munit_assert(sail_alloc_meta_data_node(&meta_data_node) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_and_value_from_known_key(SAIL_META_DATA_COMMENT, &meta_data_node->meta_data) == SAIL_OK);
+    munit_assert(sail_set_variant_string(meta_data_node->meta_data->value, "Arena comment") == SAIL_OK);
+
+    struct sail_hash_map *hash_map = NULL;
+    munit_assert(sail_alloc_hash_map(&hash_map) == SAIL_OK);
+
+    struct sail_variant *variant = NULL;
+    munit_assert(sail_alloc_variant(&variant) == SAIL_OK);
+
+    for (int i = 0; i < 100; i++) {
+        munit_assert(sail_set_variant_int(variant, i) == SAIL_OK);
+
+        char key[64];
+        snprintf(key, sizeof(key), "a-long-key-that-does-not-fit-inline-%d", i);
+        munit_assert(sail_put_hash_map(hash_map, key, variant) == SAIL_OK);
+    }
+
+    munit_assert(sail_set_thread_arena(NULL) == arena);
+
+    /* Copies outside of the arena survive it. */
+    struct sail_palette *palette_copy = NULL;
+    munit_assert(sail_copy_palette(palette, &palette_copy) == SAIL_OK);
+
+    struct sail_hash_map *hash_map_copy = NULL;
+    munit_assert(sail_copy_hash_map(hash_map, &hash_map_copy) == SAIL_OK);
+
+    /* Arena memory is destroyed as usual. */
+    sail_destroy_palette(palette);
+    sail_destroy_meta_data_node(meta_data_node);
+    sail_destroy_hash_map(hash_map);
+    sail_destroy_variant(variant);
+
+    sail_destroy_arena(arena);
+
+    munit_assert_uint8(((unsigned char *)palette_copy->data)[255 * 3], ==, 0xAA);
+    munit_assert_uint(sail_hash_map_size(hash_map_copy), ==, 100);
+    munit_assert(sail_variant_to_int(sail_hash_map_value(hash_map_copy, "a-long-key-that-does-not-fit-inline-99")) == 99);
+
+    sail_destroy_palette(palette_copy);
+    sail_destroy_hash_map(hash_map_copy);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_free_and_realloc(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_variant *variant = NULL;
+    munit_assert(sail_alloc_variant(&variant) == SAIL_OK);
+
+    struct sail_arena *arena = NULL;
+    munit_assert(sail_alloc_arena(&arena) == SAIL_OK);
+
+    struct sail_arena *previous_arena = sail_set_thread_arena(arena);
+
+    munit_assert(sail_set_variant_string(variant, "A string that does not fit into the inline value") == SAIL_OK);
+
+    /* Growing the value moves it out of the arena. */
+    char long_string[3000];
+    memset(long_string, 'x', sizeof(long_string) - 1);
+    long_string[sizeof(long_string) - 1] = '\0';
+    munit_assert(sail_set_variant_string(variant, long_string) == SAIL_OK);
+
+    sail_set_thread_arena(previous_arena);
+    sail_destroy_arena(arena);
+
+    munit_assert_string_equal(sail_variant_to_string(variant), long_string);
+    munit_assert(sail_set_variant_string(variant, "Short") == SAIL_OK);
+    munit_assert_string_equal(sail_variant_to_string(variant), "Short");
+
+    sail_destroy_variant(variant);
+
+    /* NULL is ignored. */
+    sail_destroy_arena(NULL);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/side-structures",  test_side_structures,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/free-and-realloc", test_free_and_realloc, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/arena",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
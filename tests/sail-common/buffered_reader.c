@@ -0,0 +1,167 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+static unsigned char test_data[1000];
+
+/* Allocates a memory I/O object with or without the mapped data access. */
+static struct sail_io *alloc_io(const MunitParameter params[]) {
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_memory(test_data, sizeof(test_data), &io) == SAIL_OK);
+
+    if (strcmp(munit_parameters_get(params, "mapped"), "false") == 0) {
+        io->features &= ~SAIL_IO_FEATURE_MAPPED;
+        io->map       = NULL;
+    }
+
+    return io;
+}
+
+static MunitResult test_read(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    sail_test_fill_data(test_data, sizeof(test_data));
+    struct sail_io *io = alloc_io(params);
+
+    /* Small blocks to cross their boundaries. */
+    struct sail_buffered_reader reader;
+    munit_assert(sail_init_buffered_reader(io, 7, &reader) == SAIL_OK);
+
+    size_t pos = 0;
+
+    for (; pos < 10; pos++) {
+        uint8_t byte;
+        munit_assert(sail_buffered_reader_read_byte(&reader, &byte) == SAIL_OK);
+        munit_assert_uint8(byte, ==, test_data[pos]);
+    }
+
+    unsigned char buf[100];
+    munit_assert(sail_buffered_reader_strict_read(&reader, buf, sizeof(buf)) == SAIL_OK);
+    munit_assert_memory_equal(sizeof(buf), buf, test_data + pos);
+    pos += sizeof(buf);
+
+    /* Peek doesn't consume. */
+    munit_assert(sail_buffered_reader_peek(&reader, buf, 5) == SAIL_OK);
+    munit_assert_memory_equal(5, buf, test_data + pos);
+    munit_assert(sail_buffered_reader_strict_read(&reader, buf, 5) == SAIL_OK);
+    munit_assert_memory_equal(5, buf, test_data + pos);
+    pos += 5;
+
+    /* Buffered data is served in place and consumed with skip. */
+    const unsigned char *buffered;
+    const size_t buffered_size = sail_buffered_reader_buffered(&reader, &buffered);
+    munit_assert_size(buffered_size, >, 0);
+    munit_assert_memory_equal(buffered_size, buffered, test_data + pos);
+    munit_assert(sail_buffered_reader_skip(&reader, 1) == SAIL_OK);
+    pos++;
+    munit_assert_size(sail_buffered_reader_buffered(&reader, &buffered), ==, buffered_size - 1);
+
+    /* Skip past the buffered data. */
+    munit_assert(sail_buffered_reader_skip(&reader, 500) == SAIL_OK);
+    pos += 500;
+
+    uint8_t byte;
+    munit_assert(sail_buffered_reader_read_byte(&reader, &byte) == SAIL_OK);
+    munit_assert_uint8(byte, ==, test_data[pos]);
+    pos++;
+
+    /* The underlying I/O object continues with the first unread byte. */
+    munit_assert(sail_finish_buffered_reader(&reader) == SAIL_OK);
+
+    size_t offset;
+    munit_assert(io->tell(io->stream, &offset) == SAIL_OK);
+    munit_assert_size(offset, ==, pos);
+
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_eof(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    sail_test_fill_data(test_data, sizeof(test_data));
+    struct sail_io *io = alloc_io(params);
+
+    struct sail_buffered_reader reader;
+    munit_assert(sail_init_buffered_reader(io, 0, &reader) == SAIL_OK);
+
+    bool eof;
+    munit_assert(sail_buffered_reader_eof(&reader, &eof) == SAIL_OK);
+    munit_assert_false(eof);
+
+    unsigned char buf[sizeof(test_data)];
+    munit_assert(sail_buffered_reader_strict_read(&reader, buf, sizeof(buf)) == SAIL_OK);
+    munit_assert_memory_equal(sizeof(buf), buf, test_data);
+
+    munit_assert(sail_buffered_reader_eof(&reader, &eof) == SAIL_OK);
+    munit_assert_true(eof);
+
+    uint8_t byte;
+    munit_assert(sail_buffered_reader_read_byte(&reader, &byte) == SAIL_ERROR_READ_IO);
+    munit_assert(sail_buffered_reader_strict_read(&reader, buf, 2) == SAIL_ERROR_READ_IO);
+
+    munit_assert(sail_finish_buffered_reader(&reader) == SAIL_OK);
+    /* Finishing twice is allowed. */
+    munit_assert(sail_finish_buffered_reader(&reader) == SAIL_OK);
+
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+static char *mapped_params[] = { (char *)"true", (char *)"false", NULL };
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"mapped", mapped_params },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/read", test_read, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/eof",  test_eof,  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/buffered-reader",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,151 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+static unsigned char test_data[1000];
+
+/* Allocates a growable memory I/O object with or without vectored writes. */
+static struct sail_io *alloc_io(const MunitParameter params[]) {
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_write_growable_memory(&io) == SAIL_OK);
+    munit_assert(io->features & SAIL_IO_FEATURE_VECTORED);
+
+    if (strcmp(munit_parameters_get(params, "vectored"), "false") == 0) {
+        io->features              &= ~SAIL_IO_FEATURE_VECTORED;
+        io->strict_write_vectored  = NULL;
+    }
+
+    return io;
+}
+
+static MunitResult test_write(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    sail_test_fill_data(test_data, sizeof(test_data));
+    struct sail_io *io = alloc_io(params);
+
+    /* Small buffer to cross its boundaries. */
+    struct sail_buffered_writer writer;
+    munit_assert(sail_init_buffered_writer(io, 16, &writer) == SAIL_OK);
+
+    size_t pos = 0;
+
+    for (; pos < 10; pos++) {
+        munit_assert(sail_buffered_writer_strict_write(&writer, test_data + pos, 1) == SAIL_OK);
+    }
+
+    /* Nothing is written until the buffer is full. */
+    size_t offset;
+    munit_assert(io->tell(io->stream, &offset) == SAIL_OK);
+    munit_assert_size(offset, ==, 0);
+
+    munit_assert(sail_buffered_writer_strict_write(&writer, test_data + pos, 12) == SAIL_OK);
+    pos += 12;
+
+    /* Larger than the buffer. */
+    munit_assert(sail_buffered_writer_strict_write(&writer, test_data + pos, 500) == SAIL_OK);
+    pos += 500;
+
+    munit_assert(sail_buffered_writer_flush(&writer) == SAIL_OK);
+    munit_assert(io->tell(io->stream, &offset) == SAIL_OK);
+    munit_assert_size(offset, ==, pos);
+
+    munit_assert(sail_buffered_writer_strict_write(&writer, test_data + pos, sizeof(test_data) - pos) == SAIL_OK);
+
+    munit_assert(sail_finish_buffered_writer(&writer) == SAIL_OK);
+    /* Finishing twice is allowed. */
+    munit_assert(sail_finish_buffered_writer(&writer) == SAIL_OK);
+
+    void *buffer;
+    size_t buffer_size;
+    munit_assert(sail_take_io_growable_memory_buffer(io, &buffer, &buffer_size) == SAIL_OK);
+    munit_assert_size(buffer_size, ==, sizeof(test_data));
+    munit_assert_memory_equal(sizeof(test_data), buffer, test_data);
+
+    sail_free(buffer);
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_io_write_vectored(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    sail_test_fill_data(test_data, sizeof(test_data));
+    struct sail_io *io = alloc_io(params);
+
+    const struct sail_io_vector vectors[] = {
+        { test_data,       100                     },
+        { test_data + 100, 0                       },
+        { test_data + 100, sizeof(test_data) - 100 },
+    };
+
+    munit_assert(sail_io_strict_write_vectored(io, vectors, sizeof(vectors) / sizeof(vectors[0])) == SAIL_OK);
+
+    void *buffer;
+    size_t buffer_size;
+    munit_assert(sail_take_io_growable_memory_buffer(io, &buffer, &buffer_size) == SAIL_OK);
+    munit_assert_size(buffer_size, ==, sizeof(test_data));
+    munit_assert_memory_equal(sizeof(test_data), buffer, test_data);
+
+    sail_free(buffer);
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+static char *vectored_params[] = { (char *)"true", (char *)"false", NULL };
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"vectored", vectored_params },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/write",             test_write,             NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/io-write-vectored", test_io_write_vectored, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/buffered-writer",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
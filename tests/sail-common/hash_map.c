@@ -24,6 +24,7 @@
 */
 
 #include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -355,13 +356,80 @@ static MunitResult test_clear(const MunitParameter params[], void *user_data) {
     return MUNIT_OK;
 }
 
+static MunitResult test_long_keys_and_values(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_hash_map *hash_map1;
+    munit_assert(sail_alloc_hash_map(&hash_map1) == SAIL_OK);
+
+    struct sail_variant *value;
+    munit_assert(sail_alloc_variant(&value) == SAIL_OK);
+
+    /* Short and long keys and values, and enough keys to grow the hash map. */
+    char key[64];
+    char string[64];
+
+    for (int i = 0; i < 100; i++) {
+        snprintf(key, sizeof(key), (i % 2 == 0) ? "k%d" : "a-long-key-that-does-not-fit-into-a-slot-%d", i);
+        snprintf(string, sizeof(string), (i % 3 == 0) ? "%d" : "a-long-value-that-does-not-fit-into-a-slot-%d", i);
+
+        munit_assert(sail_set_variant_string(value, string) == SAIL_OK);
+        munit_assert(sail_put_hash_map(hash_map1, key, value) == SAIL_OK);
+    }
+
+    /* Erase every fifth key. */
+    for (int i = 0; i < 100; i += 5) {
+        snprintf(key, sizeof(key), (i % 2 == 0) ? "k%d" : "a-long-key-that-does-not-fit-into-a-slot-%d", i);
+        sail_erase_hash_map_key(hash_map1, key);
+    }
+
+    munit_assert(sail_hash_map_size(hash_map1) == 80);
+
+    struct sail_hash_map *hash_map2;
+    munit_assert(sail_copy_hash_map(hash_map1, &hash_map2) == SAIL_OK);
+    munit_assert(sail_test_compare_hash_maps(hash_map1, hash_map2) == SAIL_OK);
+
+    /* Overwrite short values with long ones and vice versa in the copy only. */
+    munit_assert(sail_set_variant_string(value, "a-long-value-that-does-not-fit-into-a-slot") == SAIL_OK);
+    munit_assert(sail_put_hash_map(hash_map2, "k6", value) == SAIL_OK);
+    munit_assert(sail_set_variant_string(value, "short") == SAIL_OK);
+    munit_assert(sail_put_hash_map(hash_map2, "k2", value) == SAIL_OK);
+
+    for (int i = 0; i < 100; i++) {
+        snprintf(key, sizeof(key), (i % 2 == 0) ? "k%d" : "a-long-key-that-does-not-fit-into-a-slot-%d", i);
+        snprintf(string, sizeof(string), (i % 3 == 0) ? "%d" : "a-long-value-that-does-not-fit-into-a-slot-%d", i);
+
+        const struct sail_variant *value_in_map = sail_hash_map_value(hash_map1, key);
+
+        if (i % 5 == 0) {
+            munit_assert_null(value_in_map);
+        } else {
+            munit_assert_not_null(value_in_map);
+            munit_assert_string_equal(sail_variant_to_string(value_in_map), string);
+        }
+    }
+
+    munit_assert_string_equal(sail_variant_to_string(sail_hash_map_value(hash_map2, "k6")), "a-long-value-that-does-not-fit-into-a-slot");
+    munit_assert_string_equal(sail_variant_to_string(sail_hash_map_value(hash_map2, "k2")), "short");
+
+    /* Cleanup. */
+    sail_destroy_variant(value);
+    sail_destroy_hash_map(hash_map2);
+    sail_destroy_hash_map(hash_map1);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
-    { (char *)"/put",            test_put,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/put-erase-many", test_put_erase_many, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/copy",           test_copy,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/overwrite",      test_overwrite,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/erase",          test_erase,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/clear",          test_clear,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/put",                  test_put,                   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/put-erase-many",       test_put_erase_many,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/copy",                 test_copy,                  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/overwrite",            test_overwrite,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/erase",                test_erase,                 NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/clear",                test_clear,                 NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/long-keys-and-values", test_long_keys_and_values,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
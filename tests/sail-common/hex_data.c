@@ -86,6 +86,34 @@ static MunitResult test_hex_string_to_data(const MunitParameter params[], void *
         sail_free(data);
     }
 
+    {
+        /* Lower case digits. */
+        const char *str = "0a4B6c";
+        munit_assert(sail_hex_string_to_data(str, &data, &data_size) == SAIL_OK);
+        munit_assert(data_size == 3);
+        munit_assert_memory_equal(data_size, data, "\nKl");
+        sail_free(data);
+    }
+
+    {
+        /* Decoding stops at the first invalid character, also inside long runs of digits. */
+        const char *str = "6162636465666768696A6B6C6D6E6F70G1626364";
+        munit_assert(sail_hex_string_to_data(str, &data, &data_size) == SAIL_OK);
+        munit_assert(data_size == 16);
+        munit_assert_memory_equal(data_size, data, "abcdefghijklmnop");
+        sail_free(data);
+    }
+
+    {
+        /* Line breaks inside long runs of digits like in PNG raw profiles. */
+        const char *str = "6162636465666768696A6B6C6D6E6F707172737475767778797A414243444546474849\n"
+                          "4A4B4C4D4E4F505152535455565758595A\n";
+        munit_assert(sail_hex_string_to_data(str, &data, &data_size) == SAIL_OK);
+        munit_assert(data_size == 52);
+        munit_assert_memory_equal(data_size, data, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
+        sail_free(data);
+    }
+
     {
         /* NULL strings must fail. */
         data = NULL;
@@ -143,6 +171,29 @@ static MunitResult test_data_to_hex_string(const MunitParameter params[], void *
         sail_free(str);
     }
 
+    {
+        /* Round trip of all byte values with lengths around 16-digit blocks. */
+        unsigned char bytes[256];
+        for (unsigned i = 0; i < 256; i++) {
+            bytes[i] = (unsigned char)(255 - i);
+        }
+
+        for (size_t length = 1; length <= 256; length += 5) {
+            str = NULL;
+            munit_assert(sail_data_to_hex_string(bytes, length, &str) == SAIL_OK);
+            munit_assert(strlen(str) == length * 2);
+
+            void *data;
+            size_t data_size;
+            munit_assert(sail_hex_string_to_data(str, &data, &data_size) == SAIL_OK);
+            munit_assert(data_size == length);
+            munit_assert_memory_equal(length, data, bytes);
+
+            sail_free(data);
+            sail_free(str);
+        }
+    }
+
     {
         /* NULL data must fail. */
         str = NULL;
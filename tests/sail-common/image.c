@@ -0,0 +1,360 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "munit.h"
+
+static const enum SailPixelFormat PIXEL_FORMATS[] = {
+    SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+    SAIL_PIXEL_FORMAT_BPP24_RGB,
+    SAIL_PIXEL_FORMAT_BPP32_RGBA,
+    SAIL_PIXEL_FORMAT_BPP48_RGB,
+    SAIL_PIXEL_FORMAT_BPP64_RGBA,
+};
+
+static uint8_t pixel_byte(unsigned x, unsigned y, unsigned byte) {
+
+    return (uint8_t)(x * 7 + y * 13 + byte * 29);
+}
+
+/* Allocates an image with padded rows and pixels depending on their coordinates. */
+static struct sail_image* alloc_test_image(enum SailPixelFormat pixel_format, unsigned width, unsigned height) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->pixel_format   = pixel_format;
+    image->width          = width;
+    image->height         = height;
+    image->bytes_per_line = sail_bytes_per_line(width, pixel_format) + 5;
+
+    munit_assert(sail_malloc((size_t)image->height * image->bytes_per_line, &image->pixels) == SAIL_OK);
+    munit_assert(sail_alloc_resolution_from_data(SAIL_RESOLUTION_UNIT_INCH, 72, 96, &image->resolution) == SAIL_OK);
+
+    const unsigned bytes_per_pixel = sail_bits_per_pixel(pixel_format) / 8;
+
+    for (unsigned y = 0; y < height; y++) {
+        uint8_t *scan = sail_scan_line(image, y);
+
+        for (unsigned x = 0; x < width; x++) {
+            for (unsigned byte = 0; byte < bytes_per_pixel; byte++) {
+                scan[x * bytes_per_pixel + byte] = pixel_byte(x, y, byte);
+            }
+        }
+    }
+
+    return image;
+}
+
+/* Checks that every pixel of the image is the source pixel at the coordinates returned by 'source'. */
+static void assert_pixels(const struct sail_image *image, void (*source)(unsigned x, unsigned y, const struct sail_image *image,
+                                                                        unsigned *source_x, unsigned *source_y)) {
+
+    const unsigned bytes_per_pixel = sail_bits_per_pixel(image->pixel_format) / 8;
+
+    for (unsigned y = 0; y < image->height; y++) {
+        const uint8_t *scan = sail_scan_line(image, y);
+
+        for (unsigned x = 0; x < image->width; x++) {
+            unsigned source_x;
+            unsigned source_y;
+            source(x, y, image, &source_x, &source_y);
+
+            for (unsigned byte = 0; byte < bytes_per_pixel; byte++) {
+                munit_assert_uint8(scan[x * bytes_per_pixel + byte], ==, pixel_byte(source_x, source_y, byte));
+            }
+        }
+    }
+}
+
+static void source_mirrored_vertically(unsigned x, unsigned y, const struct sail_image *image, unsigned *source_x, unsigned *source_y) {
+    *source_x = x;
+    *source_y = image->height - 1 - y;
+}
+
+static void source_mirrored_horizontally(unsigned x, unsigned y, const struct sail_image *image, unsigned *source_x, unsigned *source_y) {
+    *source_x = image->width - 1 - x;
+    *source_y = y;
+}
+
+static void source_rotated_90(unsigned x, unsigned y, const struct sail_image *image, unsigned *source_x, unsigned *source_y) {
+    *source_x = y;
+    *source_y = image->width - 1 - x;
+}
+
+static void source_rotated_180(unsigned x, unsigned y, const struct sail_image *image, unsigned *source_x, unsigned *source_y) {
+    *source_x = image->width - 1 - x;
+    *source_y = image->height - 1 - y;
+}
+
+static void source_rotated_270(unsigned x, unsigned y, const struct sail_image *image, unsigned *source_x, unsigned *source_y) {
+    *source_x = image->height - 1 - y;
+    *source_y = x;
+}
+
+static MunitResult test_mirror(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+        /* Odd and even dimensions. */
+        for (unsigned size = 6; size <= 7; size++) {
+            struct sail_image *image = alloc_test_image(PIXEL_FORMATS[i], size + 300, size);
+
+            munit_assert(sail_mirror(image, SAIL_ORIENTATION_MIRRORED_VERTICALLY) == SAIL_OK);
+            assert_pixels(image, source_mirrored_vertically);
+            munit_assert(sail_mirror(image, SAIL_ORIENTATION_MIRRORED_VERTICALLY) == SAIL_OK);
+
+            munit_assert(sail_mirror(image, SAIL_ORIENTATION_MIRRORED_HORIZONTALLY) == SAIL_OK);
+            assert_pixels(image, source_mirrored_horizontally);
+
+            munit_assert(sail_mirror(image, SAIL_ORIENTATION_ROTATED_90) == SAIL_ERROR_INVALID_ARGUMENT);
+
+            sail_destroy_image(image);
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_rotate(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+        for (unsigned size = 6; size <= 7; size++) {
+            const unsigned width  = size + 10;
+            const unsigned height = size;
+
+            struct sail_image *image = alloc_test_image(PIXEL_FORMATS[i], width, height);
+            munit_assert(sail_rotate(image, SAIL_ORIENTATION_ROTATED_180) == SAIL_OK);
+            munit_assert_uint(image->width, ==, width);
+            munit_assert_uint(image->height, ==, height);
+            assert_pixels(image, source_rotated_180);
+            sail_destroy_image(image);
+
+            image = alloc_test_image(PIXEL_FORMATS[i], width, height);
+            munit_assert(sail_rotate(image, SAIL_ORIENTATION_ROTATED_90) == SAIL_OK);
+            munit_assert_uint(image->width, ==, height);
+            munit_assert_uint(image->height, ==, width);
+            munit_assert_uint(image->bytes_per_line, ==, sail_bytes_per_line(height, image->pixel_format));
+            munit_assert_double(image->resolution->x, ==, 96);
+            munit_assert_double(image->resolution->y, ==, 72);
+            assert_pixels(image, source_rotated_90);
+            sail_destroy_image(image);
+
+            image = alloc_test_image(PIXEL_FORMATS[i], width, height);
+            munit_assert(sail_rotate(image, SAIL_ORIENTATION_ROTATED_270) == SAIL_OK);
+            munit_assert_uint(image->width, ==, height);
+            munit_assert_uint(image->height, ==, width);
+            assert_pixels(image, source_rotated_270);
+
+            munit_assert(sail_rotate(image, SAIL_ORIENTATION_MIRRORED_VERTICALLY) == SAIL_ERROR_INVALID_ARGUMENT);
+            sail_destroy_image(image);
+        }
+    }
+
+    /* Pixels smaller than a byte. */
+    struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 8, 8);
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE;
+    munit_assert(sail_rotate(image, SAIL_ORIENTATION_ROTATED_90) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_view(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    for (size_t i = 0; i < sizeof(PIXEL_FORMATS) / sizeof(PIXEL_FORMATS[0]); i++) {
+        struct sail_image *image = alloc_test_image(PIXEL_FORMATS[i], 17, 9);
+        const unsigned bytes_per_pixel = sail_bits_per_pixel(image->pixel_format) / 8;
+
+        struct sail_image *view;
+        munit_assert(sail_image_view(image, 3, 2, 11, 6, &view) == SAIL_OK);
+        munit_assert_uint(view->width, ==, 11);
+        munit_assert_uint(view->height, ==, 6);
+        munit_assert_uint(view->bytes_per_line, ==, image->bytes_per_line);
+        munit_assert_double(view->resolution->x, ==, 72);
+        munit_assert_true(view->pixels_borrowed);
+
+        for (unsigned y = 0; y < view->height; y++) {
+            const uint8_t *scan = sail_scan_line(view, y);
+
+            for (unsigned x = 0; x < view->width; x++) {
+                for (unsigned byte = 0; byte < bytes_per_pixel; byte++) {
+                    munit_assert_uint8(scan[x * bytes_per_pixel + byte], ==, pixel_byte(x + 3, y + 2, byte));
+                }
+            }
+        }
+
+        /* The view shares pixels with the source image. */
+        munit_assert(sail_mirror(view, SAIL_ORIENTATION_MIRRORED_HORIZONTALLY) == SAIL_OK);
+        munit_assert_uint8(((const uint8_t *)sail_scan_line(image, 2))[3 * bytes_per_pixel], ==, pixel_byte(13, 2, 0));
+        munit_assert_uint8(((const uint8_t *)sail_scan_line(image, 2))[2 * bytes_per_pixel], ==, pixel_byte(2, 2, 0));
+        munit_assert(sail_mirror(view, SAIL_ORIENTATION_MIRRORED_HORIZONTALLY) == SAIL_OK);
+
+        /* Copies are tightly packed. */
+        struct sail_image *copy;
+        munit_assert(sail_copy_image(view, &copy) == SAIL_OK);
+        munit_assert_uint(copy->bytes_per_line, ==, sail_bytes_per_line(11, copy->pixel_format));
+        munit_assert_false(copy->pixels_borrowed);
+
+        for (unsigned y = 0; y < copy->height; y++) {
+            munit_assert_memory_equal(copy->bytes_per_line, sail_scan_line(copy, y), sail_scan_line(view, y));
+        }
+
+        sail_destroy_image(copy);
+
+        /* Views of views and views of the whole image. */
+        struct sail_image *view_of_view;
+        munit_assert(sail_image_view(view, 10, 5, 1, 1, &view_of_view) == SAIL_OK);
+        munit_assert_ptr_equal(view_of_view->pixels, (uint8_t *)sail_scan_line(image, 7) + 13 * bytes_per_pixel);
+        sail_destroy_image(view_of_view);
+
+        munit_assert(sail_image_view(image, 0, 0, 17, 9, &view_of_view) == SAIL_OK);
+        munit_assert_ptr_equal(view_of_view->pixels, image->pixels);
+        sail_destroy_image(view_of_view);
+
+        /* Out of bounds. */
+        munit_assert(sail_image_view(image, 7, 0, 11, 1, &view_of_view) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+        munit_assert(sail_image_view(image, 0, 9, 1, 1, &view_of_view) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+        munit_assert(sail_image_view(image, 0, 0, 0, 1, &view_of_view) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+        munit_assert(sail_image_view(image, 0, 3, 1, UINT32_MAX, &view_of_view) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+
+        /* Borrowed pixels are not freed. */
+        sail_destroy_image(view);
+        sail_destroy_image(image);
+    }
+
+    /* Pixels smaller than a byte. */
+    struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 16, 4);
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE;
+
+    struct sail_image *view;
+    munit_assert(sail_image_view(image, 3, 0, 8, 1, &view) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert(sail_image_view(image, 8, 1, 8, 2, &view) == SAIL_OK);
+    munit_assert_ptr_equal(view->pixels, (uint8_t *)sail_scan_line(image, 1) + 1);
+    sail_destroy_image(view);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_planes(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *planes[4];
+    unsigned strides[4];
+    unsigned planes_count;
+
+    /* Packed images have a single plane. */
+    struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 6, 4);
+    munit_assert(sail_image_planes(image, planes, strides, &planes_count) == SAIL_OK);
+    munit_assert_uint(planes_count, ==, 1);
+    munit_assert_ptr_equal(planes[0], image->pixels);
+    munit_assert_uint(strides[0], ==, image->bytes_per_line);
+    munit_assert_null(planes[1]);
+    munit_assert_uint(strides[1], ==, 0);
+    sail_destroy_image(image);
+
+    struct {
+        enum SailPixelFormat pixel_format;
+        unsigned planes_count;
+        size_t offsets[3];
+        unsigned strides[3];
+    } const tests[] = {
+        { SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420, 3, { 0, 24, 30 }, { 6, 3, 3 } },
+        { SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12, 2, { 0, 24, 0 },  { 6, 6, 0 } },
+        { SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444, 3, { 0, 24, 48 }, { 6, 6, 6 } },
+    };
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+        image->pixel_format   = tests[i].pixel_format;
+        image->width          = 6;
+        image->height         = 4;
+        image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+        munit_assert(sail_alloc_image_pixels(image, false) == SAIL_OK);
+
+        munit_assert(sail_image_planes(image, planes, strides, &planes_count) == SAIL_OK);
+        munit_assert_uint(planes_count, ==, tests[i].planes_count);
+
+        for (unsigned plane = 0; plane < planes_count; plane++) {
+            munit_assert_ptr_equal(planes[plane], (uint8_t *)image->pixels + tests[i].offsets[plane]);
+            munit_assert_uint(strides[plane], ==, tests[i].strides[plane]);
+        }
+
+        /* Rows of planar images are not pixels. */
+        munit_assert(sail_mirror(image, SAIL_ORIENTATION_MIRRORED_VERTICALLY) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+        munit_assert(sail_rotate(image, SAIL_ORIENTATION_ROTATED_180) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+        struct sail_image *view;
+        munit_assert(sail_image_view(image, 0, 0, 2, 2, &view) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+        /* Planes are never padded. */
+        image->bytes_per_line++;
+        munit_assert(sail_check_image_valid(image) == SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+        image->bytes_per_line--;
+
+        /* 4:2:0 needs even dimensions. */
+        image->height = 3;
+        munit_assert(sail_check_image_valid(image) == (tests[i].pixel_format == SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444
+                                                        ? SAIL_OK : SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS));
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/mirror", test_mirror, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/rotate", test_rotate, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/view",   test_view,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/planes", test_planes, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/image",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -159,6 +159,26 @@ static MunitResult test_pixel_format_to_string(const MunitParameter params[], vo
     munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP48_YUVA), "BPP48-YUVA");
     munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP64_YUVA), "BPP64-YUVA");
 
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED), "BPP32-RGBA-PREMULTIPLIED");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED), "BPP32-BGRA-PREMULTIPLIED");
+
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED), "BPP64-RGBA-PREMULTIPLIED");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED), "BPP64-BGRA-PREMULTIPLIED");
+
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420), "BPP12-YCBCR-I420");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12), "BPP12-YCBCR-NV12");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444), "BPP24-YCBCR-I444");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP48_RGB_HALF),    "BPP48-RGB-HALF");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF),   "BPP64-RGBA-HALF");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT), "BPP128-RGBA-FLOAT");
+
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP4_BC1), "BPP4-BC1");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP8_BC2), "BPP8-BC2");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP8_BC3), "BPP8-BC3");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP4_BC4), "BPP4-BC4");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP8_BC5), "BPP8-BC5");
+    munit_assert_string_equal(sail_pixel_format_to_string(SAIL_PIXEL_FORMAT_BPP8_BC7), "BPP8-BC7");
+
     return MUNIT_OK;
 }
 
@@ -256,6 +276,26 @@ static MunitResult test_pixel_format_from_string(const MunitParameter params[],
     munit_assert(sail_pixel_format_from_string("BPP48-YUVA") == SAIL_PIXEL_FORMAT_BPP48_YUVA);
     munit_assert(sail_pixel_format_from_string("BPP64-YUVA") == SAIL_PIXEL_FORMAT_BPP64_YUVA);
 
+    munit_assert(sail_pixel_format_from_string("BPP32-RGBA-PREMULTIPLIED") == SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED);
+    munit_assert(sail_pixel_format_from_string("BPP32-BGRA-PREMULTIPLIED") == SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED);
+
+    munit_assert(sail_pixel_format_from_string("BPP64-RGBA-PREMULTIPLIED") == SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED);
+    munit_assert(sail_pixel_format_from_string("BPP64-BGRA-PREMULTIPLIED") == SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED);
+
+    munit_assert(sail_pixel_format_from_string("BPP12-YCBCR-I420") == SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420);
+    munit_assert(sail_pixel_format_from_string("BPP12-YCBCR-NV12") == SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12);
+    munit_assert(sail_pixel_format_from_string("BPP24-YCBCR-I444") == SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444);
+    munit_assert(sail_pixel_format_from_string("BPP48-RGB-HALF") == SAIL_PIXEL_FORMAT_BPP48_RGB_HALF);
+    munit_assert(sail_pixel_format_from_string("BPP64-RGBA-HALF") == SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF);
+    munit_assert(sail_pixel_format_from_string("BPP128-RGBA-FLOAT") == SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT);
+
+    munit_assert(sail_pixel_format_from_string("BPP4-BC1") == SAIL_PIXEL_FORMAT_BPP4_BC1);
+    munit_assert(sail_pixel_format_from_string("BPP8-BC2") == SAIL_PIXEL_FORMAT_BPP8_BC2);
+    munit_assert(sail_pixel_format_from_string("BPP8-BC3") == SAIL_PIXEL_FORMAT_BPP8_BC3);
+    munit_assert(sail_pixel_format_from_string("BPP4-BC4") == SAIL_PIXEL_FORMAT_BPP4_BC4);
+    munit_assert(sail_pixel_format_from_string("BPP8-BC5") == SAIL_PIXEL_FORMAT_BPP8_BC5);
+    munit_assert(sail_pixel_format_from_string("BPP8-BC7") == SAIL_PIXEL_FORMAT_BPP8_BC7);
+
     return MUNIT_OK;
 }
 
@@ -561,6 +601,14 @@ static MunitResult test_codec_feature_to_string(const MunitParameter params[], v
     munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_INTERLACED),   "INTERLACED");
     munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_ICCP),         "ICCP");
     munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_SOURCE_IMAGE), "SOURCE-IMAGE");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_ROI),          "ROI");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_SCALING),      "SCALING");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_ROWS),         "ROWS");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_PASSES),       "PASSES");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_SEEK),         "SEEK");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_RESET),        "RESET");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_PARALLEL),     "PARALLEL");
+    munit_assert_string_equal(sail_codec_feature_to_string(SAIL_CODEC_FEATURE_PUSH),         "PUSH");
 
     return MUNIT_OK;
 }
@@ -580,6 +628,37 @@ static MunitResult test_codec_feature_from_string(const MunitParameter params[],
     munit_assert(sail_codec_feature_from_string("INTERLACED")   == SAIL_CODEC_FEATURE_INTERLACED);
     munit_assert(sail_codec_feature_from_string("ICCP")         == SAIL_CODEC_FEATURE_ICCP);
     munit_assert(sail_codec_feature_from_string("SOURCE-IMAGE") == SAIL_CODEC_FEATURE_SOURCE_IMAGE);
+    munit_assert(sail_codec_feature_from_string("ROI")          == SAIL_CODEC_FEATURE_ROI);
+    munit_assert(sail_codec_feature_from_string("SCALING")      == SAIL_CODEC_FEATURE_SCALING);
+    munit_assert(sail_codec_feature_from_string("ROWS")         == SAIL_CODEC_FEATURE_ROWS);
+    munit_assert(sail_codec_feature_from_string("PASSES")       == SAIL_CODEC_FEATURE_PASSES);
+    munit_assert(sail_codec_feature_from_string("SEEK")         == SAIL_CODEC_FEATURE_SEEK);
+    munit_assert(sail_codec_feature_from_string("RESET")        == SAIL_CODEC_FEATURE_RESET);
+    munit_assert(sail_codec_feature_from_string("PARALLEL")     == SAIL_CODEC_FEATURE_PARALLEL);
+    munit_assert(sail_codec_feature_from_string("PUSH")         == SAIL_CODEC_FEATURE_PUSH);
+
+    return MUNIT_OK;
+}
+
+/*
+ * Hash collisions.
+ */
+static MunitResult test_from_string_collisions(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    /* These strings have the same hashes as the names, but must not be converted. */
+    munit_assert(sail_string_hash("BPOR") == sail_string_hash("BPP1"));
+    munit_assert(sail_pixel_format_from_string("BPOR") == SAIL_PIXEL_FORMAT_UNKNOWN);
+
+    munit_assert(sail_string_hash("ZJ/") == sail_string_hash("ZIP"));
+    munit_assert(sail_compression_from_string("ZJ/") == SAIL_COMPRESSION_UNKNOWN);
+
+    munit_assert(sail_string_hash("XN/") == sail_string_hash("XMP"));
+    munit_assert(sail_meta_data_from_string("XN/") == SAIL_META_DATA_UNKNOWN);
+
+    munit_assert(sail_string_hash("RP(") == sail_string_hash("ROI"));
+    munit_assert(sail_codec_feature_from_string("RP(") == SAIL_CODEC_FEATURE_UNKNOWN);
 
     return MUNIT_OK;
 }
@@ -608,6 +687,8 @@ static MunitTest test_suite_tests[] = {
     { (char *)"/codec-feature-to-string",   test_codec_feature_to_string,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/codec-feature-from-string", test_codec_feature_from_string, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
+    { (char *)"/from-string-collisions", test_from_string_collisions, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
 
@@ -23,6 +23,8 @@
     SOFTWARE.
 */
 
+#include <string.h>
+
 #include <sail-common/sail-common.h>
 
 #include "munit.h"
@@ -36,6 +38,8 @@ static MunitResult test_alloc_options(const MunitParameter params[], void *user_
     munit_assert_not_null(load_options);
     munit_assert(load_options->options == 0);
     munit_assert_null(load_options->tuning);
+    munit_assert(!sail_roi_is_set(&load_options->roi));
+    munit_assert(load_options->output_pixel_format == SAIL_PIXEL_FORMAT_UNKNOWN);
 
     sail_destroy_load_options(load_options);
 
@@ -49,13 +53,17 @@ static MunitResult test_copy_options(const MunitParameter params[], void *user_d
     struct sail_load_options *load_options = NULL;
     munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
 
-    load_options->options = SAIL_OPTION_ICCP;
+    load_options->options             = SAIL_OPTION_ICCP;
+    load_options->roi                 = (struct sail_roi) { 1, 2, 3, 4 };
+    load_options->output_pixel_format = SAIL_PIXEL_FORMAT_BPP32_BGRA;
 
     struct sail_load_options *load_options_copy = NULL;
     munit_assert(sail_copy_load_options(load_options, &load_options_copy) == SAIL_OK);
     munit_assert_not_null(load_options_copy);
 
     munit_assert(load_options_copy->options == load_options->options);
+    munit_assert(memcmp(&load_options_copy->roi, &load_options->roi, sizeof(struct sail_roi)) == 0);
+    munit_assert(load_options_copy->output_pixel_format == load_options->output_pixel_format);
     munit_assert_null(load_options_copy->tuning);
 
     sail_destroy_load_options(load_options_copy);
@@ -64,6 +72,40 @@ static MunitResult test_copy_options(const MunitParameter params[], void *user_d
     return MUNIT_OK;
 }
 
+static MunitResult test_share_options(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_load_options *load_options = NULL;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+    load_options->options = SAIL_OPTION_ICCP;
+
+    /* Sharing doesn't copy. */
+    struct sail_load_options *load_options_shared = NULL;
+    munit_assert(sail_share_load_options(load_options, &load_options_shared) == SAIL_OK);
+    munit_assert_ptr_equal(load_options_shared, load_options);
+
+    /* Detaching a shared object copies it. */
+    munit_assert(sail_detach_load_options(&load_options_shared) == SAIL_OK);
+    munit_assert_ptr_not_equal(load_options_shared, load_options);
+    munit_assert(load_options_shared->options == SAIL_OPTION_ICCP);
+
+    /* Detaching a private object does nothing. */
+    struct sail_load_options *load_options_private = load_options_shared;
+    munit_assert(sail_detach_load_options(&load_options_shared) == SAIL_OK);
+    munit_assert_ptr_equal(load_options_shared, load_options_private);
+
+    sail_destroy_load_options(load_options_shared);
+
+    /* The last reference destroys the object. */
+    munit_assert(sail_share_load_options(load_options, &load_options_shared) == SAIL_OK);
+    sail_destroy_load_options(load_options);
+    munit_assert(load_options_shared->options == SAIL_OPTION_ICCP);
+    sail_destroy_load_options(load_options_shared);
+
+    return MUNIT_OK;
+}
+
 static MunitResult test_options_from_features(const MunitParameter params[], void *user_data) {
     (void)params;
     (void)user_data;
@@ -81,10 +123,31 @@ static MunitResult test_options_from_features(const MunitParameter params[], voi
     return MUNIT_OK;
 }
 
+static MunitResult test_clip_roi(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_roi roi = { 10, 20, 100, 5 };
+    struct sail_roi clipped_roi;
+
+    munit_assert(sail_clip_roi(&roi, 50, 50, &clipped_roi) == SAIL_OK);
+    munit_assert_uint(clipped_roi.x,      ==, 10);
+    munit_assert_uint(clipped_roi.y,      ==, 20);
+    munit_assert_uint(clipped_roi.width,  ==, 40);
+    munit_assert_uint(clipped_roi.height, ==, 5);
+
+    munit_assert(sail_clip_roi(&roi, 10, 50, &clipped_roi) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert(sail_clip_roi(&roi, 50, 20, &clipped_roi) == SAIL_ERROR_INVALID_ARGUMENT);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
     { (char *)"/alloc", test_alloc_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/copy", test_copy_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/share", test_share_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/from-features", test_options_from_features, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/clip-roi", test_clip_roi, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
@@ -0,0 +1,196 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "munit.h"
+
+static MunitResult test_log_is_enabled(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail_set_log_barrier(SAIL_LOG_LEVEL_WARNING);
+
+    munit_assert_true(sail_log_is_enabled(SAIL_LOG_LEVEL_ERROR));
+    munit_assert_true(sail_log_is_enabled(SAIL_LOG_LEVEL_WARNING));
+    munit_assert_false(sail_log_is_enabled(SAIL_LOG_LEVEL_INFO));
+    munit_assert_false(sail_log_is_enabled(SAIL_LOG_LEVEL_DEBUG));
+    munit_assert_false(sail_log_is_enabled(SAIL_LOG_LEVEL_TRACE));
+
+    sail_set_log_barrier(SAIL_LOG_LEVEL_SILENCE);
+
+    munit_assert_false(sail_log_is_enabled(SAIL_LOG_LEVEL_ERROR));
+
+    sail_set_log_barrier(SAIL_LOG_LEVEL_TRACE);
+
+    munit_assert_true(sail_log_is_enabled(SAIL_LOG_LEVEL_TRACE));
+
+    return MUNIT_OK;
+}
+
+/*
+ * sail_log() is called directly as the log macros may be compiled out with SAIL_MIN_COMPILED_LOG_LEVEL.
+ */
+
+/* Messages passed into the external logger. */
+static char logged_messages[300][64];
+static enum SailLogLevel logged_levels[300];
+static unsigned logged_count;
+
+static void logger(enum SailLogLevel level, const char *file, int line, const char *format, va_list args) {
+    (void)file;
+    (void)line;
+
+    if (logged_count < sizeof(logged_messages) / sizeof(logged_messages[0])) {
+        logged_levels[logged_count] = level;
+        vsnprintf(logged_messages[logged_count], sizeof(logged_messages[0]), format, args);
+    }
+
+    logged_count++;
+}
+
+static MunitResult test_log_deferred(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail_set_log_barrier(SAIL_LOG_LEVEL_TRACE);
+    sail_set_logger(logger);
+    sail_set_log_deferred(true);
+
+    logged_count = 0;
+
+    for (int i = 0; i < 10; i++) {
+        sail_log(SAIL_LOG_LEVEL_DEBUG, __FILE__, __LINE__, "Message %d", i);
+    }
+
+    /* Nothing is written until flushing. */
+    munit_assert_uint(logged_count, ==, 0);
+
+    sail_flush_log();
+
+    munit_assert_uint(logged_count, ==, 10);
+
+    for (int i = 0; i < 10; i++) {
+        char expected[64];
+        snprintf(expected, sizeof(expected), "Message %d", i);
+
+        munit_assert_int(logged_levels[i], ==, SAIL_LOG_LEVEL_DEBUG);
+        munit_assert_string_equal(logged_messages[i], expected);
+    }
+
+    /* Messages that don't fit into the queue are dropped and reported. */
+    logged_count = 0;
+
+    for (int i = 0; i < 200; i++) {
+        sail_log(SAIL_LOG_LEVEL_INFO, __FILE__, __LINE__, "Message %d", i);
+    }
+
+    sail_flush_log();
+
+    munit_assert_uint(logged_count, >, 1);
+    munit_assert_uint(logged_count, <, 200);
+    munit_assert_string_equal(logged_messages[0], "Message 0");
+    munit_assert_int(logged_levels[logged_count - 1], ==, SAIL_LOG_LEVEL_WARNING);
+
+    /* Disabling the deferred mode flushes the queue. */
+    logged_count = 0;
+
+    sail_log(SAIL_LOG_LEVEL_ERROR, __FILE__, __LINE__, "Last deferred message");
+    sail_set_log_deferred(false);
+    munit_assert_uint(logged_count, ==, 1);
+
+    sail_log(SAIL_LOG_LEVEL_ERROR, __FILE__, __LINE__, "Immediate message");
+    munit_assert_uint(logged_count, ==, 2);
+    munit_assert_string_equal(logged_messages[1], "Immediate message");
+
+    sail_set_logger(NULL);
+
+    return MUNIT_OK;
+}
+
+static void log_task(void *user_data, unsigned task, unsigned thread) {
+    (void)user_data;
+    (void)thread;
+
+    for (unsigned i = 0; i < 10; i++) {
+        sail_log(SAIL_LOG_LEVEL_DEBUG, __FILE__, __LINE__, "Task %u message %u", task, i);
+    }
+}
+
+static MunitResult test_log_deferred_threads(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail_set_log_barrier(SAIL_LOG_LEVEL_TRACE);
+    sail_set_logger(logger);
+    sail_set_log_deferred(true);
+
+    logged_count = 0;
+
+    sail_set_thread_pool_size(4);
+    sail_thread_pool_run(8, log_task, NULL);
+    sail_finish_thread_pool();
+
+    sail_flush_log();
+
+    /* The thread pool logs its own messages too. */
+    unsigned task_messages = 0;
+
+    for (unsigned i = 0; i < logged_count; i++) {
+        if (strncmp(logged_messages[i], "Task ", 5) == 0) {
+            task_messages++;
+        }
+    }
+
+    munit_assert_uint(task_messages, ==, 80);
+
+    sail_set_log_deferred(false);
+    sail_set_logger(NULL);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/is-enabled",       test_log_is_enabled,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/deferred",         test_log_deferred,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/deferred-threads", test_log_deferred_threads, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/log",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -23,6 +23,8 @@
     SOFTWARE.
 */
 
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <sail-common/sail-common.h>
@@ -93,10 +95,192 @@ static MunitResult test_realloc(const MunitParameter params[], void *user_data)
     return MUNIT_OK;
 }
 
+static MunitResult test_aligned_malloc(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const size_t alignments[] = { 1, 16, 64, 4096 };
+
+    for (size_t i = 0; i < sizeof(alignments) / sizeof(alignments[0]); i++) {
+        void *ptr = NULL;
+        munit_assert(sail_aligned_malloc(alignments[i], 1000, &ptr) == SAIL_OK);
+        munit_assert_not_null(ptr);
+        munit_assert((uintptr_t)ptr % alignments[i] == 0);
+
+        memset(ptr, 0, 1000);
+        sail_aligned_free(ptr);
+    }
+
+    void *ptr = NULL;
+    munit_assert(sail_aligned_malloc(3, 1000, &ptr) == SAIL_ERROR_INVALID_ARGUMENT);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_file_backed_memory(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const size_t size = 3 * 1024 * 1024 + 1;
+
+    unsigned char *ptr = NULL;
+    munit_assert(sail_alloc_file_backed_memory(size, (void **)&ptr) == SAIL_OK);
+    munit_assert_not_null(ptr);
+    munit_assert((uintptr_t)ptr % 4096 == 0);
+
+    /* The memory is zeroed and writable. */
+    munit_assert_uint8(ptr[0], ==, 0);
+    munit_assert_uint8(ptr[size - 1], ==, 0);
+
+    memset(ptr, 0xAB, size);
+    munit_assert_uint8(ptr[size / 2], ==, 0xAB);
+
+    sail_free_file_backed_memory(ptr, size);
+    sail_free_file_backed_memory(NULL, size);
+
+    munit_assert(sail_alloc_file_backed_memory(0, (void **)&ptr) == SAIL_ERROR_INVALID_ARGUMENT);
+
+    return MUNIT_OK;
+}
+
+struct counting_allocator {
+    int allocations;
+    int frees;
+};
+
+static void* counting_malloc(void *user_data, size_t size) {
+
+    ((struct counting_allocator *)user_data)->allocations++;
+
+    return malloc(size);
+}
+
+static void* counting_realloc(void *user_data, void *ptr, size_t size) {
+
+    if (ptr == NULL) {
+        ((struct counting_allocator *)user_data)->allocations++;
+    }
+
+    return realloc(ptr, size);
+}
+
+static void counting_free(void *user_data, void *ptr) {
+
+    if (ptr != NULL) {
+        ((struct counting_allocator *)user_data)->frees++;
+    }
+
+    free(ptr);
+}
+
+static MunitResult test_memory_allocator(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct counting_allocator counting_allocator = { 0, 0 };
+
+    struct sail_allocator allocator = {
+        &counting_allocator, counting_malloc, counting_realloc, counting_free, NULL, NULL
+    };
+
+    munit_assert(sail_set_memory_allocator(&allocator) == SAIL_OK);
+
+    void *ptr1 = NULL;
+    munit_assert(sail_malloc(100, &ptr1) == SAIL_OK);
+    munit_assert(sail_realloc(200, &ptr1) == SAIL_OK);
+
+    void *ptr2 = NULL;
+    munit_assert(sail_calloc(10, 10, &ptr2) == SAIL_OK);
+    munit_assert(((unsigned char *)ptr2)[99] == 0);
+
+    void *ptr3 = NULL;
+    munit_assert(sail_aligned_malloc(64, 100, &ptr3) == SAIL_OK);
+    munit_assert((uintptr_t)ptr3 % 64 == 0);
+
+    sail_free(ptr1);
+    sail_free(ptr2);
+    sail_aligned_free(ptr3);
+
+    munit_assert_int(counting_allocator.allocations, ==, 3);
+    munit_assert_int(counting_allocator.frees, ==, 3);
+
+    /* Aligned callbacks must be set in pairs. */
+    allocator.aligned_free = counting_free;
+    munit_assert(sail_set_memory_allocator(&allocator) == SAIL_ERROR_INVALID_ARGUMENT);
+
+    munit_assert(sail_set_memory_allocator(NULL) == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_memory_tracking(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    munit_assert(sail_set_memory_tracking(true) == SAIL_OK);
+
+    const char *previous_tag = sail_set_memory_tag("test");
+    munit_assert_null(previous_tag);
+
+    void *ptr1 = NULL;
+    munit_assert(sail_malloc(10, &ptr1) == SAIL_OK);
+
+    void *ptr2 = NULL;
+    munit_assert(sail_calloc(100, 100, &ptr2) == SAIL_OK);
+    munit_assert(((unsigned char *)ptr2)[9999] == 0);
+
+    void *ptr3 = NULL;
+    munit_assert(sail_aligned_malloc(64, 100, &ptr3) == SAIL_OK);
+    munit_assert((uintptr_t)ptr3 % 64 == 0);
+
+    struct sail_memory_stats stats;
+    munit_assert(sail_memory_stats(&stats) == SAIL_OK);
+    munit_assert_uint64(stats.allocations, ==, 3);
+    munit_assert_uint64(stats.frees, ==, 0);
+    munit_assert_uint64(stats.current_bytes, >=, 10 + 10000 + 100);
+    munit_assert_uint64(stats.size_class_allocations[0], ==, 1);
+    munit_assert_uint64(stats.size_class_allocations[2], ==, 1);
+
+    /* Growing a block replaces its size. */
+    const uint64_t bytes_before_realloc = stats.current_bytes;
+    munit_assert(sail_realloc(1000, &ptr1) == SAIL_OK);
+    memset(ptr1, 0, 1000);
+    munit_assert(sail_memory_stats(&stats) == SAIL_OK);
+    munit_assert_uint64(stats.current_bytes, ==, bytes_before_realloc + 990);
+
+    /* Tracked memory can't be abandoned. */
+    munit_assert(sail_set_memory_tracking(false) == SAIL_ERROR_CONFLICTING_OPERATION);
+    munit_assert_size(sail_log_memory_leaks(), ==, 3);
+
+    sail_free(ptr1);
+    sail_free(ptr2);
+    sail_aligned_free(ptr3);
+
+    munit_assert(sail_memory_stats(&stats) == SAIL_OK);
+    munit_assert_uint64(stats.current_bytes, ==, 0);
+    munit_assert_uint64(stats.peak_bytes, ==, bytes_before_realloc + 990);
+    munit_assert_uint64(stats.frees, ==, 3);
+    munit_assert_size(sail_log_memory_leaks(), ==, 0);
+
+    /* The peak restarts from the current usage. */
+    sail_reset_memory_peak();
+    munit_assert(sail_memory_stats(&stats) == SAIL_OK);
+    munit_assert_uint64(stats.peak_bytes, ==, 0);
+
+    sail_set_memory_tag(NULL);
+    munit_assert(sail_set_memory_tracking(false) == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
-    { (char *)"/malloc",  test_malloc,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/calloc",  test_calloc,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/realloc", test_realloc, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/malloc",           test_malloc,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/calloc",           test_calloc,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/realloc",          test_realloc,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/aligned-malloc",   test_aligned_malloc,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/file-backed",      test_file_backed_memory, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/memory-allocator", test_memory_allocator,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/memory-tracking",  test_memory_tracking,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
@@ -69,6 +69,40 @@ static MunitResult test_copy_options(const MunitParameter params[], void *user_d
     return MUNIT_OK;
 }
 
+static MunitResult test_share_options(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_save_options *save_options = NULL;
+    munit_assert(sail_alloc_save_options(&save_options) == SAIL_OK);
+    save_options->options = SAIL_OPTION_ICCP;
+
+    /* Sharing doesn't copy. */
+    struct sail_save_options *save_options_shared = NULL;
+    munit_assert(sail_share_save_options(save_options, &save_options_shared) == SAIL_OK);
+    munit_assert_ptr_equal(save_options_shared, save_options);
+
+    /* Detaching a shared object copies it. */
+    munit_assert(sail_detach_save_options(&save_options_shared) == SAIL_OK);
+    munit_assert_ptr_not_equal(save_options_shared, save_options);
+    munit_assert(save_options_shared->options == SAIL_OPTION_ICCP);
+
+    /* Detaching a private object does nothing. */
+    struct sail_save_options *save_options_private = save_options_shared;
+    munit_assert(sail_detach_save_options(&save_options_shared) == SAIL_OK);
+    munit_assert_ptr_equal(save_options_shared, save_options_private);
+
+    sail_destroy_save_options(save_options_shared);
+
+    /* The last reference destroys the object. */
+    munit_assert(sail_share_save_options(save_options, &save_options_shared) == SAIL_OK);
+    sail_destroy_save_options(save_options);
+    munit_assert(save_options_shared->options == SAIL_OPTION_ICCP);
+    sail_destroy_save_options(save_options_shared);
+
+    return MUNIT_OK;
+}
+
 static MunitResult test_options_from_features(const MunitParameter params[], void *user_data) {
     (void)params;
     (void)user_data;
@@ -101,6 +135,7 @@ static MunitResult test_options_from_features(const MunitParameter params[], voi
 static MunitTest test_suite_tests[] = {
     { (char *)"/alloc", test_alloc_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/copy", test_copy_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/share", test_share_options, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/from-features", test_options_from_features, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
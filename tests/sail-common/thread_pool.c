@@ -0,0 +1,261 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+
+#include "munit.h"
+
+#define TASKS_COUNT 1000
+
+struct counters {
+    unsigned runs[TASKS_COUNT];
+    bool thread_out_of_range;
+};
+
+static void count_task(void *user_data, unsigned task, unsigned thread) {
+
+    struct counters *counters = user_data;
+
+    /* Every task is run exactly once, so no two threads write the same counter. */
+    counters->runs[task]++;
+
+    if (thread >= sail_thread_pool_size()) {
+        counters->thread_out_of_range = true;
+    }
+}
+
+static void nested_task(void *user_data, unsigned task, unsigned thread) {
+
+    (void)thread;
+
+    struct counters *counters = user_data;
+    sail_thread_pool_run(10, count_task, &counters[task]);
+}
+
+static MunitResult test_run(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const unsigned sizes[] = { 1, 2, 4, 0 };
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        sail_set_thread_pool_size(sizes[i]);
+        munit_assert_uint(sail_thread_pool_size(), >=, 1);
+
+        struct counters counters = { { 0 }, false };
+        sail_thread_pool_run(TASKS_COUNT, count_task, &counters);
+
+        for (unsigned task = 0; task < TASKS_COUNT; task++) {
+            munit_assert_uint(counters.runs[task], ==, 1);
+        }
+
+        munit_assert_false(counters.thread_out_of_range);
+    }
+
+    /* Nothing to run. */
+    sail_thread_pool_run(0, count_task, NULL);
+
+    sail_finish_thread_pool();
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_nested(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    sail_set_thread_pool_size(3);
+
+    static struct counters counters[8];
+    sail_thread_pool_run(8, nested_task, counters);
+
+    for (unsigned i = 0; i < 8; i++) {
+        for (unsigned task = 0; task < TASKS_COUNT; task++) {
+            munit_assert_uint(counters[i].runs[task], ==, (task < 10) ? 1 : 0);
+        }
+    }
+
+    sail_set_thread_pool_size(0);
+    sail_finish_thread_pool();
+
+    return MUNIT_OK;
+}
+
+static void serial_executor(void *executor_data, unsigned tasks_count, sail_thread_pool_task_t task, void *user_data) {
+
+    unsigned *calls = executor_data;
+    (*calls)++;
+
+    for (unsigned i = 0; i < tasks_count; i++) {
+        task(user_data, i, 0);
+    }
+}
+
+static MunitResult test_executor(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    unsigned calls = 0;
+    sail_set_thread_pool_executor(serial_executor, &calls);
+
+    struct counters counters = { { 0 }, false };
+    sail_thread_pool_run(TASKS_COUNT, count_task, &counters);
+
+    munit_assert_uint(calls, ==, 1);
+
+    for (unsigned task = 0; task < TASKS_COUNT; task++) {
+        munit_assert_uint(counters.runs[task], ==, 1);
+    }
+
+    sail_set_thread_pool_executor(NULL, NULL);
+
+    sail_thread_pool_run(TASKS_COUNT, count_task, &counters);
+    munit_assert_uint(calls, ==, 1);
+    munit_assert_uint(counters.runs[0], ==, 2);
+
+    sail_finish_thread_pool();
+
+    return MUNIT_OK;
+}
+
+struct submitted {
+    sail_thread_pool_task_t task;
+    void *user_data;
+    unsigned calls;
+};
+
+static void deferred_submitter(void *submitter_data, sail_thread_pool_task_t task, void *user_data) {
+
+    struct submitted *submitted = submitter_data;
+
+    submitted->task      = task;
+    submitted->user_data = user_data;
+    submitted->calls++;
+}
+
+static MunitResult test_submit(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    munit_assert(sail_thread_pool_submit(NULL, NULL) == SAIL_ERROR_NULL_PTR);
+
+    /* The executor blocks, so detached tasks run on the internal threads. */
+    sail_set_thread_pool_size(2);
+
+    unsigned calls = 0;
+    sail_set_thread_pool_executor(serial_executor, &calls);
+
+    struct counters counters = { { 0 }, false };
+    munit_assert(sail_thread_pool_submit(count_task, &counters) == SAIL_OK);
+
+    sail_finish_thread_pool();
+
+    munit_assert_uint(calls, ==, 0);
+    munit_assert_uint(counters.runs[0], ==, 1);
+
+    /* The submitter returns before the task runs. */
+    struct submitted submitted = { NULL, NULL, 0 };
+    sail_set_thread_pool_submitter(deferred_submitter, &submitted);
+
+    munit_assert(sail_thread_pool_submit(count_task, &counters) == SAIL_OK);
+
+    munit_assert_uint(submitted.calls, ==, 1);
+    munit_assert_uint(counters.runs[0], ==, 1);
+
+    submitted.task(submitted.user_data, 0, 0);
+    munit_assert_uint(counters.runs[0], ==, 2);
+
+    sail_set_thread_pool_submitter(NULL, NULL);
+    sail_set_thread_pool_executor(NULL, NULL);
+    sail_set_thread_pool_size(0);
+    sail_finish_thread_pool();
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_numa(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    munit_assert_uint(sail_thread_pool_numa_nodes(), ==, 1);
+
+    /* Single-node systems and other platforms fall back to unbound threads. */
+    sail_set_thread_pool_numa(true);
+    munit_assert_uint(sail_thread_pool_numa_nodes(), >=, 1);
+
+    const unsigned sizes[] = { 2, 5, 0 };
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        sail_set_thread_pool_size(sizes[i]);
+
+        struct counters counters = { { 0 }, false };
+        sail_thread_pool_run(TASKS_COUNT, count_task, &counters);
+
+        for (unsigned task = 0; task < TASKS_COUNT; task++) {
+            munit_assert_uint(counters.runs[task], ==, 1);
+        }
+
+        munit_assert_false(counters.thread_out_of_range);
+    }
+
+    unsigned char buffer[1001];
+    memset(buffer, 0xFF, sizeof(buffer));
+    sail_thread_pool_first_touch(buffer, sizeof(buffer));
+
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        munit_assert_uint8(buffer[i], ==, (sail_thread_pool_numa_nodes() > 1) ? 0 : 0xFF);
+    }
+
+    sail_set_thread_pool_numa(false);
+    munit_assert_uint(sail_thread_pool_numa_nodes(), ==, 1);
+
+    sail_finish_thread_pool();
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/run",      test_run,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/nested",   test_nested,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/executor", test_executor, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/submit",   test_submit,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/numa",     test_numa,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/thread-pool",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
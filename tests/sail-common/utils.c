@@ -23,6 +23,8 @@
     SOFTWARE.
 */
 
+#include <string.h>
+
 #include <sail-common/sail-common.h>
 
 #include "munit.h"
@@ -63,10 +65,92 @@ static MunitResult test_reverse_uint64(const MunitParameter params[], void *user
     return MUNIT_OK;
 }
 
+static MunitResult test_be16_to_host(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    /* Not a multiple of the vector width to cover the scalar tail. */
+    enum { COUNT = 29 };
+
+    uint8_t input[COUNT * 2];
+    uint16_t output[COUNT];
+
+    for (unsigned i = 0; i < COUNT; i++) {
+        input[i * 2]     = (uint8_t)(i * 7);
+        input[i * 2 + 1] = (uint8_t)(i * 13 + 1);
+    }
+
+    sail_be16_to_host(input, output, COUNT, 0);
+
+    for (unsigned i = 0; i < COUNT; i++) {
+        munit_assert_uint16(output[i], ==, (uint16_t)((input[i * 2] << 8) | input[i * 2 + 1]));
+    }
+
+    /* 65535 is the full range already. */
+    sail_be16_to_host(input, output, COUNT, 65535);
+
+    for (unsigned i = 0; i < COUNT; i++) {
+        munit_assert_uint16(output[i], ==, (uint16_t)((input[i * 2] << 8) | input[i * 2 + 1]));
+    }
+
+    /* Rescaling matches the exact integer division for every sample, and clamps values above the maximum. */
+    const unsigned max_values[] = { 1, 3, 255, 1023, 4095, 65000, 65534 };
+
+    for (unsigned m = 0; m < sizeof(max_values) / sizeof(max_values[0]); m++) {
+        const unsigned max_value = max_values[m];
+
+        for (unsigned first = 0; first <= 65535; first += COUNT) {
+            for (unsigned i = 0; i < COUNT; i++) {
+                const unsigned v = (first + i) & 0xFFFF;
+                input[i * 2]     = (uint8_t)(v >> 8);
+                input[i * 2 + 1] = (uint8_t)(v & 0xFF);
+            }
+
+            sail_be16_to_host(input, input, COUNT, max_value);
+
+            for (unsigned i = 0; i < COUNT; i++) {
+                const unsigned v = (first + i) & 0xFFFF;
+                const unsigned expected = (unsigned)(((unsigned long long)(v < max_value ? v : max_value) * 65535) / max_value);
+                uint16_t actual;
+                memcpy(&actual, input + i * 2, sizeof(actual));
+
+                munit_assert_uint16(actual, ==, expected);
+            }
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_data_hash(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    unsigned char data[100];
+
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = (unsigned char)i;
+    }
+
+    /* XXH64 reference values. */
+    munit_assert_uint64(sail_data_hash(NULL, 0),  ==, 0ull);
+    munit_assert_uint64(sail_data_hash("abc", 3), ==, 0x44BC2CF5AD770999ull);
+    munit_assert_uint64(sail_data_hash(data, sizeof(data)), ==, 0x6AC1E58032166597ull);
+
+    /* Independent of the alignment. */
+    unsigned char unaligned[sizeof(data) + 1];
+    memcpy(unaligned + 1, data, sizeof(data));
+    munit_assert_uint64(sail_data_hash(unaligned + 1, sizeof(data)), ==, sail_data_hash(data, sizeof(data)));
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
     { (char *)"/reverse-uint16", test_reverse_uint16, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/reverse-uint32", test_reverse_uint32, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
     { (char *)"/reverse-uint64", test_reverse_uint64, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/be16-to-host",   test_be16_to_host,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/data-hash",      test_data_hash,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
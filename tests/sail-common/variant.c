@@ -262,14 +262,60 @@ static MunitResult test_snprintf(const MunitParameter params[], void *user_data)
     return MUNIT_OK;
 }
 
+static MunitResult test_inline_and_allocated(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const char *short_string = "short";
+    const char *long_string  = "a string that does not fit into the inline storage";
+
+    struct sail_variant *variant;
+    munit_assert(sail_alloc_variant(&variant) == SAIL_OK);
+
+    /* Switch between inline and allocated values. */
+    munit_assert(sail_set_variant_double(variant, 2.5) == SAIL_OK);
+    munit_assert_double(sail_variant_to_double(variant), ==, 2.5);
+
+    munit_assert(sail_set_variant_string(variant, long_string) == SAIL_OK);
+    munit_assert_string_equal(sail_variant_to_string(variant), long_string);
+
+    munit_assert(sail_set_variant_string(variant, short_string) == SAIL_OK);
+    munit_assert_string_equal(sail_variant_to_string(variant), short_string);
+    munit_assert(variant->size == strlen(short_string) + 1);
+
+    /* Copies don't share the storage. */
+    struct sail_variant *variant_copy;
+    munit_assert(sail_copy_variant(variant, &variant_copy) == SAIL_OK);
+    munit_assert(sail_equal_variants(variant, variant_copy));
+    munit_assert_ptr_not_equal(sail_variant_to_string(variant), sail_variant_to_string(variant_copy));
+    munit_assert(sail_set_variant_int(variant_copy, 7) == SAIL_OK);
+    munit_assert_string_equal(sail_variant_to_string(variant), short_string);
+
+    /* Shallow values replace inline ones. */
+    void *ptr;
+    munit_assert(sail_malloc(strlen(long_string) + 1, &ptr) == SAIL_OK);
+    strcpy(ptr, long_string);
+    munit_assert(sail_set_variant_shallow_string(variant, ptr) == SAIL_OK);
+    munit_assert_ptr_equal(sail_variant_to_string(variant), ptr);
+
+    munit_assert(sail_set_variant_substring(variant, long_string, 4) == SAIL_OK);
+    munit_assert_string_equal(sail_variant_to_string(variant), "a st");
+
+    sail_destroy_variant(variant_copy);
+    sail_destroy_variant(variant);
+
+    return MUNIT_OK;
+}
+
 static MunitTest test_suite_tests[] = {
-    { (char *)"/alloc",       test_alloc,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/copy",        test_copy,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/from-value",  test_from_value,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/from-string", test_from_string, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/from-data",   test_from_data,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/set",         test_set,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
-    { (char *)"/snprintf",    test_snprintf,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/alloc",               test_alloc,                NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/copy",                test_copy,                 NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/from-value",          test_from_value,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/from-string",         test_from_string,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/from-data",           test_from_data,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/set",                 test_set,                  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/snprintf",            test_snprintf,             NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/inline-and-allocated", test_inline_and_allocated, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
@@ -245,3 +245,27 @@ sail_status_t sail_test_compare_images(const struct sail_image *image1, const st
 
     return SAIL_OK;
 }
+
+struct sail_image* sail_test_alloc_image(enum SailPixelFormat pixel_format, unsigned width, unsigned height) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = width;
+    image->height         = height;
+    image->pixel_format   = pixel_format;
+    image->bytes_per_line = sail_bytes_per_line(width, pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * height, &image->pixels) == SAIL_OK);
+
+    return image;
+}
+
+void sail_test_fill_data(void *data, size_t size) {
+
+    unsigned char *bytes = data;
+
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (unsigned char)(i * 7);
+    }
+}
@@ -26,6 +26,9 @@
 #ifndef SAIL_COMPARATORS_H
 #define SAIL_COMPARATORS_H
 
+#include <stddef.h>
+
+#include <sail-common/common.h>
 #include <sail-common/export.h>
 #include <sail-common/status.h>
 
@@ -49,4 +52,15 @@ SAIL_EXPORT sail_status_t sail_test_compare_source_images(const struct sail_sour
 
 SAIL_EXPORT sail_status_t sail_test_compare_images(const struct sail_image *image1, const struct sail_image *image2);
 
+/*
+ * Allocates an image of the specified pixel format and dimensions with uninitialized pixels.
+ * Fails the test on error.
+ */
+SAIL_EXPORT struct sail_image* sail_test_alloc_image(enum SailPixelFormat pixel_format, unsigned width, unsigned height);
+
+/*
+ * Fills the specified buffer with a pattern of bytes that depend on their offsets.
+ */
+SAIL_EXPORT void sail_test_fill_data(void *data, size_t size);
+
 #endif
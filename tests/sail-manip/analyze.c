@@ -0,0 +1,312 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+/* Large enough to be analyzed in multiple threads. Three gray stripes with different alpha values. */
+static struct sail_image* alloc_stripes(uint8_t alpha) {
+
+    struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 300, 300);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            const uint8_t value = (uint8_t)(10 + column / 100 * 20);
+
+            scan[column * 4 + 0] = value;
+            scan[column * 4 + 1] = value;
+            scan[column * 4 + 2] = value;
+            scan[column * 4 + 3] = (column < 100) ? alpha : 255;
+        }
+    }
+
+    return image;
+}
+
+/* Smooth RGB gradient with varying alpha. */
+static struct sail_image* alloc_gradient(void) {
+
+    struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 256, 64);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            scan[column * 4 + 0] = (uint8_t)column;
+            scan[column * 4 + 1] = (uint8_t)(row * 4);
+            scan[column * 4 + 2] = (uint8_t)(255 - column);
+            scan[column * 4 + 3] = (uint8_t)(128 + row);
+        }
+    }
+
+    return image;
+}
+
+static MunitResult test_analyze_stripes(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = alloc_stripes(255);
+
+    struct sail_image_analysis analysis;
+    munit_assert(sail_analyze_image(image, &analysis) == SAIL_OK);
+
+    munit_assert_uint(analysis.bits_per_component, ==, 8);
+    munit_assert_true(analysis.opaque);
+    munit_assert_true(analysis.grayscale);
+    munit_assert_true(analysis.fits_8_bits);
+    munit_assert_uint(analysis.colors_count, ==, 3);
+
+    for (unsigned i = 0; i < 3; i++) {
+        munit_assert_uint(analysis.colors[i].component1, ==, 10 + i * 20);
+        munit_assert_uint(analysis.colors[i].component2, ==, 10 + i * 20);
+        munit_assert_uint(analysis.colors[i].component3, ==, 10 + i * 20);
+        munit_assert_uint(analysis.colors[i].component4, ==, 255);
+    }
+
+    munit_assert_uint(analysis.min.component1, ==, 10);
+    munit_assert_uint(analysis.max.component1, ==, 50);
+    munit_assert_uint(analysis.min.component4, ==, 255);
+
+    sail_destroy_image(image);
+
+    /* Translucent stripe. */
+    image = alloc_stripes(100);
+
+    munit_assert(sail_analyze_image(image, &analysis) == SAIL_OK);
+    munit_assert_false(analysis.opaque);
+    munit_assert_true(analysis.grayscale);
+    munit_assert_uint(analysis.colors_count, ==, 3);
+    munit_assert_uint(analysis.colors[0].component4, ==, 100);
+    munit_assert_uint(analysis.min.component4, ==, 100);
+    munit_assert_uint(analysis.max.component4, ==, 255);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_analyze_gradient(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = alloc_gradient();
+
+    struct sail_image_analysis analysis;
+    munit_assert(sail_analyze_image(image, &analysis) == SAIL_OK);
+
+    munit_assert_false(analysis.opaque);
+    munit_assert_false(analysis.grayscale);
+    munit_assert_uint(analysis.colors_count, ==, SAIL_ANALYSIS_MAX_COLORS + 1);
+    munit_assert_uint(analysis.min.component1, ==, 0);
+    munit_assert_uint(analysis.max.component1, ==, 255);
+    munit_assert_uint(analysis.max.component2, ==, 252);
+    munit_assert_uint(analysis.min.component4, ==, 128);
+    munit_assert_uint(analysis.max.component4, ==, 191);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_analyze_16_bit(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP48_RGB, 16, 16);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        uint16_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width * 3; column++) {
+            scan[column] = (uint16_t)((column % 3) * 100 * 257);
+        }
+    }
+
+    struct sail_image_analysis analysis;
+    munit_assert(sail_analyze_image(image, &analysis) == SAIL_OK);
+
+    munit_assert_uint(analysis.bits_per_component, ==, 16);
+    munit_assert_true(analysis.opaque);
+    munit_assert_false(analysis.grayscale);
+    munit_assert_true(analysis.fits_8_bits);
+    munit_assert_uint(analysis.colors_count, ==, 1);
+    munit_assert_uint(analysis.colors[0].component3, ==, 200 * 257);
+    munit_assert_uint(analysis.colors[0].component4, ==, 65535);
+
+    /* A value that is not an 8-bit value. */
+    ((uint16_t *)image->pixels)[0] = 1000;
+
+    munit_assert(sail_analyze_image(image, &analysis) == SAIL_OK);
+    munit_assert_false(analysis.fits_8_bits);
+    munit_assert_uint(analysis.colors_count, ==, 2);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_analyze_indexed(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    /* Indexed images are converted to RGBA first. */
+    struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP8_INDEXED, 8, 8);
+
+    const uint8_t palette[] = { 0, 0, 0, 255, 0, 0, 255, 255, 255, 90, 90, 90 };
+    munit_assert(sail_alloc_palette_from_data(SAIL_PIXEL_FORMAT_BPP24_RGB, palette, 4, &image->palette) == SAIL_OK);
+
+    for (unsigned i = 0; i < 64; i++) {
+        ((uint8_t *)image->pixels)[i] = (uint8_t)(i % 3);
+    }
+
+    struct sail_image_analysis analysis;
+    munit_assert(sail_analyze_image(image, &analysis) == SAIL_OK);
+
+    munit_assert_true(analysis.opaque);
+    munit_assert_false(analysis.grayscale);
+    munit_assert_uint(analysis.colors_count, ==, 3);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+/* Saves the image for the codec with SAIL_CONVERSION_OPTION_DOWNGRADE and checks the pixels are the same. */
+static void assert_downgrade(const struct sail_image *image, const char *extension, enum SailPixelFormat expected_pixel_format) {
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension(extension, &codec_info) == SAIL_OK);
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->options = SAIL_CONVERSION_OPTION_DOWNGRADE | SAIL_CONVERSION_OPTION_DITHER;
+
+    struct sail_image *image_output;
+    munit_assert(sail_convert_image_for_saving_with_options(image, codec_info->save_features, options, &image_output) == SAIL_OK);
+    munit_assert(image_output->pixel_format == expected_pixel_format);
+
+    struct sail_image *image_back;
+    munit_assert(sail_convert_image(image_output, image->pixel_format, &image_back) == SAIL_OK);
+    munit_assert_true(sail_equal_image_pixels(image, image_back));
+
+    sail_destroy_image(image_back);
+    sail_destroy_image(image_output);
+    sail_destroy_conversion_options(options);
+}
+
+static MunitResult test_downgrade(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = alloc_stripes(255);
+
+    assert_downgrade(image, "png", SAIL_PIXEL_FORMAT_BPP2_INDEXED);
+    assert_downgrade(image, "qoi", SAIL_PIXEL_FORMAT_BPP24_RGB);
+    assert_downgrade(image, "bmp", SAIL_PIXEL_FORMAT_BPP4_INDEXED);
+
+    /* Without the option, the lattice is used. */
+    struct sail_image *image_output;
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("png", &codec_info) == SAIL_OK);
+    munit_assert(sail_convert_image_for_saving(image, codec_info->save_features, &image_output) == SAIL_OK);
+    munit_assert(image_output->pixel_format == SAIL_PIXEL_FORMAT_BPP32_RGBA);
+    sail_destroy_image(image_output);
+
+    sail_destroy_image(image);
+
+    /* Translucent pixels are not palettized. */
+    image = alloc_stripes(100);
+    assert_downgrade(image, "png", SAIL_PIXEL_FORMAT_BPP32_RGBA);
+    assert_downgrade(image, "bmp", SAIL_PIXEL_FORMAT_BPP32_BGRA);
+    sail_destroy_image(image);
+
+    /* Gray-looking 16-bit image with 8-bit values. */
+    image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP48_RGB, 300, 2);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        uint16_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width * 3; column++) {
+            scan[column] = (uint16_t)((column / 3 % 256) * 257);
+        }
+    }
+
+    assert_downgrade(image, "png", SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+    sail_destroy_image(image);
+
+    /* Many colors with alpha stay as is. */
+    image = alloc_gradient();
+    assert_downgrade(image, "png", SAIL_PIXEL_FORMAT_BPP32_RGBA);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_analyze_invalid(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image_analysis analysis;
+    munit_assert(sail_analyze_image(NULL, &analysis) != SAIL_OK);
+
+    struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 4, 4);
+    munit_assert(sail_analyze_image(image, NULL) == SAIL_ERROR_NULL_PTR);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/stripes",   test_analyze_stripes,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/gradient",  test_analyze_gradient, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/16-bit",    test_analyze_16_bit,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/indexed",   test_analyze_indexed,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/downgrade", test_downgrade,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/invalid",   test_analyze_invalid,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/analyze",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
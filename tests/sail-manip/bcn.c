@@ -0,0 +1,273 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+/* Large enough to be encoded in multiple threads. Smooth gradients compress well in all modes. */
+static struct sail_image* alloc_gradient(bool opaque) {
+
+    struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 256, 256);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            scan[column * 4 + 0] = (uint8_t)column;
+            scan[column * 4 + 1] = (uint8_t)row;
+            scan[column * 4 + 2] = (uint8_t)(255 - column);
+            scan[column * 4 + 3] = opaque ? 255 : (uint8_t)(255 - row);
+        }
+    }
+
+    return image;
+}
+
+/* Returns the largest difference of the specified channels. */
+static unsigned max_difference(const struct sail_image *image1, const struct sail_image *image2, unsigned channels_mask) {
+
+    unsigned result = 0;
+
+    for (unsigned row = 0; row < image1->height; row++) {
+        const uint8_t *scan1 = sail_scan_line(image1, row);
+        const uint8_t *scan2 = sail_scan_line(image2, row);
+
+        for (unsigned i = 0; i < image1->width * 4; i++) {
+            if (channels_mask & (1u << (i % 4))) {
+                const unsigned difference = (unsigned)abs((int)scan1[i] - (int)scan2[i]);
+                result = (difference > result) ? difference : result;
+            }
+        }
+    }
+
+    return result;
+}
+
+static MunitResult test_round_trip(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Formats, the decoded channels to compare, and the tolerance. */
+    static const struct {
+        enum SailPixelFormat pixel_format;
+        unsigned channels_mask;
+        unsigned tolerance;
+    } formats[] = {
+        { SAIL_PIXEL_FORMAT_BPP4_BC1, 0x7, 16 },
+        { SAIL_PIXEL_FORMAT_BPP8_BC2, 0xF, 16 },
+        { SAIL_PIXEL_FORMAT_BPP8_BC3, 0xF, 16 },
+        { SAIL_PIXEL_FORMAT_BPP4_BC4, 0x1, 4  },
+        { SAIL_PIXEL_FORMAT_BPP8_BC5, 0x3, 4  },
+    };
+
+    /* BC1 makes pixels with low alpha transparent black. */
+    struct sail_image *image        = alloc_gradient(false);
+    struct sail_image *image_opaque = alloc_gradient(true);
+
+    for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+        munit_assert(sail_can_convert(SAIL_PIXEL_FORMAT_BPP32_RGBA, formats[i].pixel_format));
+        munit_assert(sail_can_convert(formats[i].pixel_format, SAIL_PIXEL_FORMAT_BPP32_RGBA));
+
+        struct sail_image *image_compressed;
+        const struct sail_image *image_source = (formats[i].pixel_format == SAIL_PIXEL_FORMAT_BPP4_BC1) ? image_opaque : image;
+        munit_assert(sail_convert_image(image_source, formats[i].pixel_format, &image_compressed) == SAIL_OK);
+
+        munit_assert_int(image_compressed->pixel_format, ==, formats[i].pixel_format);
+        munit_assert_uint(image_compressed->bytes_per_line, ==, sail_bytes_per_line(image->width, formats[i].pixel_format));
+
+        struct sail_image *image_decoded;
+        munit_assert(sail_convert_image(image_compressed, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_decoded) == SAIL_OK);
+
+        munit_assert_uint(max_difference(image_source, image_decoded, formats[i].channels_mask), <=, formats[i].tolerance);
+
+        sail_destroy_image(image_decoded);
+        sail_destroy_image(image_compressed);
+    }
+
+    sail_destroy_image(image_opaque);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_bc1_alpha(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = alloc_gradient(false);
+
+    struct sail_image *image_compressed;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP4_BC1, &image_compressed) == SAIL_OK);
+
+    struct sail_image *image_decoded;
+    munit_assert(sail_convert_image(image_compressed, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_decoded) == SAIL_OK);
+
+    /* BC1 has 1-bit alpha. */
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan = sail_scan_line(image, row);
+        const uint8_t *scan_decoded = sail_scan_line(image_decoded, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            munit_assert_uint8(scan_decoded[column * 4 + 3], ==, (scan[column * 4 + 3] < 128) ? 0 : 255);
+        }
+    }
+
+    sail_destroy_image(image_decoded);
+    sail_destroy_image(image_compressed);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static unsigned read_bits(const uint8_t *block, unsigned *offset, unsigned count) {
+
+    unsigned result = 0;
+
+    for (unsigned i = 0; i < count; i++, (*offset)++) {
+        result |= (unsigned)((block[*offset / 8] >> (*offset % 8)) & 1) << i;
+    }
+
+    return result;
+}
+
+/* Reference decoder of BC7 mode 6 blocks. */
+static void decode_bc7_mode6(const uint8_t *block, uint8_t pixels[16][4]) {
+
+    static const unsigned weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    unsigned offset = 7;
+    unsigned endpoints[2][4];
+
+    for (unsigned channel = 0; channel < 4; channel++) {
+        endpoints[0][channel] = read_bits(block, &offset, 7);
+        endpoints[1][channel] = read_bits(block, &offset, 7);
+    }
+
+    const unsigned p0 = read_bits(block, &offset, 1);
+    const unsigned p1 = read_bits(block, &offset, 1);
+
+    for (unsigned channel = 0; channel < 4; channel++) {
+        endpoints[0][channel] = endpoints[0][channel] << 1 | p0;
+        endpoints[1][channel] = endpoints[1][channel] << 1 | p1;
+    }
+
+    for (unsigned i = 0; i < 16; i++) {
+        const unsigned weight = weights[read_bits(block, &offset, (i == 0) ? 3 : 4)];
+
+        for (unsigned channel = 0; channel < 4; channel++) {
+            pixels[i][channel] = (uint8_t)(((64 - weight) * endpoints[0][channel] + weight * endpoints[1][channel] + 32) >> 6);
+        }
+    }
+}
+
+static MunitResult test_bc7(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    munit_assert(sail_can_convert(SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP8_BC7));
+    munit_assert(!sail_can_convert(SAIL_PIXEL_FORMAT_BPP8_BC7, SAIL_PIXEL_FORMAT_BPP32_RGBA));
+
+    struct sail_image *image = alloc_gradient(false);
+
+    struct sail_image *image_compressed;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP8_BC7, &image_compressed) == SAIL_OK);
+
+    /* Every 16-byte block is encoded in mode 6. */
+    for (unsigned row = 0; row < image->height / 4; row++) {
+        const uint8_t *scan = sail_scan_line(image_compressed, row * 4);
+
+        for (unsigned block = 0; block < image->width / 4; block++) {
+            munit_assert_uint8(scan[block * 16] & 0x7F, ==, 0x40);
+
+            uint8_t pixels[16][4];
+            decode_bc7_mode6(scan + block * 16, pixels);
+
+            for (unsigned i = 0; i < 16; i++) {
+                const uint8_t *pixel = (const uint8_t *)sail_scan_line(image, row * 4 + i / 4) + (block * 4 + i % 4) * 4;
+
+                for (unsigned channel = 0; channel < 4; channel++) {
+                    munit_assert_int(abs((int)pixels[i][channel] - (int)pixel[channel]), <=, 4);
+                }
+            }
+        }
+    }
+
+    struct sail_image *image_decoded;
+    munit_assert(sail_convert_image(image_compressed, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_decoded) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+    sail_destroy_image(image_compressed);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_invalid_dimensions(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 6, 8);
+    memset(image->pixels, 0, (size_t)image->bytes_per_line * image->height);
+
+    struct sail_image *image_compressed;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP4_BC1, &image_compressed) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/round-trip",         test_round_trip,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/bc1-alpha",          test_bc1_alpha,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/bc7",                test_bc7,                NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/invalid-dimensions", test_invalid_dimensions, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/bcn",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -114,6 +114,15 @@ static MunitResult test_best_conversion_rgb(const MunitParameter params[], void
         munit_assert_int(sail_closest_pixel_format(SAIL_PIXEL_FORMAT_BPP24_RGB, pixel_formats, pixel_formats_length), ==, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
     }
 
+    /* The input pixel format wins over the higher priority candidates. */
+    {
+        const enum SailPixelFormat pixel_formats[] = { SAIL_PIXEL_FORMAT_BPP24_YCBCR, SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP32_BGRA };
+        const size_t pixel_formats_length = sizeof(pixel_formats) / sizeof(pixel_formats[0]);
+
+        munit_assert_int(sail_closest_pixel_format(SAIL_PIXEL_FORMAT_BPP32_BGRA, pixel_formats, pixel_formats_length), ==, SAIL_PIXEL_FORMAT_BPP32_BGRA);
+        munit_assert_int(sail_closest_pixel_format(SAIL_PIXEL_FORMAT_BPP32_RGBA, pixel_formats, pixel_formats_length), ==, SAIL_PIXEL_FORMAT_BPP24_YCBCR);
+    }
+
     return MUNIT_OK;
 }
 
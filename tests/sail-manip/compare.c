@@ -0,0 +1,236 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+/* RGB pattern with diagonal stripes and a bright square. */
+static struct sail_image* alloc_pattern(unsigned width, unsigned height) {
+
+    struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, width, height);
+
+    for (unsigned row = 0; row < height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < width; column++) {
+            const bool square = column > width / 4 && column < width / 2 && row > height / 3 && row < height * 2 / 3;
+
+            scan[column * 3 + 0] = square ? 250 : (uint8_t)(column * 250 / width);
+            scan[column * 3 + 1] = square ? 240 : (uint8_t)((((column + row) / 8) % 2) * 160);
+            scan[column * 3 + 2] = square ? 230 : (uint8_t)(row * 250 / height);
+        }
+    }
+
+    return image;
+}
+
+static struct sail_image* copy_image(const struct sail_image *image) {
+
+    struct sail_image *image_copy;
+    munit_assert(sail_copy_image(image, &image_copy) == SAIL_OK);
+
+    return image_copy;
+}
+
+static MunitResult test_equal(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image1 = alloc_pattern(33, 17);
+    struct sail_image *image2 = copy_image(image1);
+
+    munit_assert_true(sail_equal_image_pixels(image1, image2));
+
+    ((uint8_t *)sail_scan_line(image2, 16))[98] ^= 1;
+    munit_assert_false(sail_equal_image_pixels(image1, image2));
+
+    struct sail_image *image_rgba;
+    munit_assert(sail_convert_image(image1, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_rgba) == SAIL_OK);
+    munit_assert_false(sail_equal_image_pixels(image1, image_rgba));
+
+    munit_assert_false(sail_equal_image_pixels(image1, NULL));
+
+    sail_destroy_image(image_rgba);
+    sail_destroy_image(image2);
+    sail_destroy_image(image1);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_psnr(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    /* Odd widths exercise the kernel tails, the large image is compared in multiple threads. */
+    static const unsigned WIDTHS[] = { 1, 7, 33, 301 };
+
+    for (size_t i = 0; i < sizeof(WIDTHS) / sizeof(WIDTHS[0]); i++) {
+        struct sail_image *image1 = alloc_pattern(WIDTHS[i], 300);
+        struct sail_image *image2 = copy_image(image1);
+
+        double psnr;
+        munit_assert(sail_image_psnr(image1, image2, &psnr) == SAIL_OK);
+        munit_assert_true(isinf(psnr));
+
+        /* Every component differs by 5 in both directions, so the MSE is 25. */
+        for (unsigned row = 0; row < image2->height; row++) {
+            uint8_t *scan1 = sail_scan_line(image1, row);
+            uint8_t *scan2 = sail_scan_line(image2, row);
+
+            for (unsigned byte = 0; byte < image2->width * 3; byte++) {
+                if ((row + byte) % 2 == 0) {
+                    scan2[byte] = (uint8_t)(scan1[byte] + 5);
+                } else {
+                    scan1[byte] = (uint8_t)(scan2[byte] + 5);
+                }
+            }
+        }
+
+        const double expected = 34.151403521958725;
+
+        munit_assert(sail_image_psnr(image1, image2, &psnr) == SAIL_OK);
+        munit_assert_double_equal(psnr, expected, 9);
+
+        sail_destroy_image(image2);
+        sail_destroy_image(image1);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_ssim(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image1 = alloc_pattern(64, 48);
+    struct sail_image *image2 = copy_image(image1);
+
+    double ssim;
+    munit_assert(sail_image_ssim(image1, image2, &ssim) == SAIL_OK);
+    munit_assert_double_equal(ssim, 1.0, 9);
+
+    /* Noise lowers the similarity. */
+    for (unsigned row = 0; row < image2->height; row += 2) {
+        uint8_t *scan = sail_scan_line(image2, row);
+
+        for (unsigned byte = 0; byte < image2->width * 3; byte += 5) {
+            scan[byte] = (uint8_t)(255 - scan[byte]);
+        }
+    }
+
+    munit_assert(sail_image_ssim(image1, image2, &ssim) == SAIL_OK);
+    munit_assert_double(ssim, <, 0.95);
+    munit_assert_double(ssim, >, -1.0);
+
+    /* Images smaller than the window. */
+    struct sail_image *image_small = alloc_pattern(3, 2);
+    munit_assert(sail_image_ssim(image_small, image_small, &ssim) == SAIL_OK);
+    munit_assert_double_equal(ssim, 1.0, 9);
+
+    munit_assert(sail_image_ssim(image1, image_small, &ssim) == SAIL_ERROR_INVALID_ARGUMENT);
+
+    sail_destroy_image(image_small);
+    sail_destroy_image(image2);
+    sail_destroy_image(image1);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_hashes(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = alloc_pattern(256, 192);
+
+    struct sail_image *image_scaled;
+    munit_assert(sail_scale_image(image, 128, 96, SAIL_SCALE_FILTER_AREA, &image_scaled) == SAIL_OK);
+
+    struct sail_image *image_mirrored = copy_image(image);
+
+    /* The mirrored image has different hashes. */
+    for (unsigned row = 0; row < image->height; row++) {
+        const uint8_t *scan = sail_scan_line(image, row);
+        uint8_t *scan_mirrored = sail_scan_line(image_mirrored, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            memcpy(scan_mirrored + column * 3, scan + (image->width - 1 - column) * 3, 3);
+        }
+    }
+
+    uint64_t dhash, dhash_scaled, dhash_mirrored;
+    munit_assert(sail_image_dhash(image, &dhash) == SAIL_OK);
+    munit_assert(sail_image_dhash(image_scaled, &dhash_scaled) == SAIL_OK);
+    munit_assert(sail_image_dhash(image_mirrored, &dhash_mirrored) == SAIL_OK);
+
+    munit_assert_uint(sail_hash_distance(dhash, dhash_scaled), <=, 4);
+    munit_assert_uint(sail_hash_distance(dhash, dhash_mirrored), >, 10);
+
+    uint64_t phash, phash_scaled, phash_mirrored;
+    munit_assert(sail_image_phash(image, &phash) == SAIL_OK);
+    munit_assert(sail_image_phash(image_scaled, &phash_scaled) == SAIL_OK);
+    munit_assert(sail_image_phash(image_mirrored, &phash_mirrored) == SAIL_OK);
+
+    munit_assert_uint(sail_hash_distance(phash, phash_scaled), <=, 4);
+    munit_assert_uint(sail_hash_distance(phash, phash_mirrored), >, 10);
+
+    munit_assert_uint(sail_hash_distance(0, UINT64_MAX), ==, 64);
+    munit_assert_uint(sail_hash_distance(0x5, 0x3), ==, 2);
+
+    sail_destroy_image(image_mirrored);
+    sail_destroy_image(image_scaled);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/equal",  test_equal,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/psnr",   test_psnr,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/ssim",   test_ssim,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/hashes", test_hashes, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/compare",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,1380 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* setenv(). */
+#if !defined _WIN32 && !defined _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail-common/sail-common.h>
+#include <sail-manip/sail-manip.h>
+
+#include "munit.h"
+
+/* Conversions implemented with row kernels. */
+static const struct {
+    enum SailPixelFormat input;
+    enum SailPixelFormat output;
+} CONVERSIONS[] = {
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,       SAIL_PIXEL_FORMAT_BPP24_BGR  },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,       SAIL_PIXEL_FORMAT_BPP24_RGB  },
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,       SAIL_PIXEL_FORMAT_BPP32_RGBA },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,       SAIL_PIXEL_FORMAT_BPP32_BGRA },
+    { SAIL_PIXEL_FORMAT_BPP24_RGB,       SAIL_PIXEL_FORMAT_BPP32_BGRA },
+    { SAIL_PIXEL_FORMAT_BPP24_BGR,       SAIL_PIXEL_FORMAT_BPP32_RGBA },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,      SAIL_PIXEL_FORMAT_BPP32_BGRA },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,      SAIL_PIXEL_FORMAT_BPP32_RGBA },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,      SAIL_PIXEL_FORMAT_BPP24_RGB  },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,      SAIL_PIXEL_FORMAT_BPP24_BGR  },
+    { SAIL_PIXEL_FORMAT_BPP32_BGRA,      SAIL_PIXEL_FORMAT_BPP24_RGB  },
+    { SAIL_PIXEL_FORMAT_BPP32_RGBA,      SAIL_PIXEL_FORMAT_BPP24_BGR  },
+    { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  SAIL_PIXEL_FORMAT_BPP24_RGB  },
+    { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  SAIL_PIXEL_FORMAT_BPP24_BGR  },
+    { SAIL_PIXEL_FORMAT_BPP64_RGBA,      SAIL_PIXEL_FORMAT_BPP32_RGBA },
+    { SAIL_PIXEL_FORMAT_BPP64_BGRA,      SAIL_PIXEL_FORMAT_BPP32_BGRA },
+    { SAIL_PIXEL_FORMAT_BPP24_YCBCR,     SAIL_PIXEL_FORMAT_BPP24_RGB  },
+    { SAIL_PIXEL_FORMAT_BPP24_YCBCR,     SAIL_PIXEL_FORMAT_BPP32_RGBA },
+    { SAIL_PIXEL_FORMAT_BPP32_CMYK,      SAIL_PIXEL_FORMAT_BPP24_RGB  },
+    { SAIL_PIXEL_FORMAT_BPP32_CMYK,      SAIL_PIXEL_FORMAT_BPP32_RGBA },
+    { SAIL_PIXEL_FORMAT_BPP32_YCCK,      SAIL_PIXEL_FORMAT_BPP24_RGB  },
+    { SAIL_PIXEL_FORMAT_BPP32_YCCK,      SAIL_PIXEL_FORMAT_BPP32_RGBA },
+};
+
+static const size_t CONVERSIONS_LENGTH = sizeof(CONVERSIONS) / sizeof(CONVERSIONS[0]);
+
+/* Instruction sets the row kernels are limited to. NULL selects the fastest ones supported by the CPU. */
+static const char * const INSTRUCTION_SETS[] = { "generic", "ssse3", "avx2", NULL };
+
+static void limit_instruction_set(const char *instruction_set) {
+
+#ifdef _WIN32
+    _putenv_s("SAIL_ROW_KERNELS_INSTRUCTION_SET", instruction_set == NULL ? "" : instruction_set);
+#else
+    if (instruction_set == NULL) {
+        unsetenv("SAIL_ROW_KERNELS_INSTRUCTION_SET");
+    } else {
+        setenv("SAIL_ROW_KERNELS_INSTRUCTION_SET", instruction_set, 1);
+    }
+#endif
+}
+
+static void assert_same_pixels(const struct sail_image *image, const struct sail_image *reference) {
+
+    munit_assert_int(image->pixel_format, ==, reference->pixel_format);
+    munit_assert_uint(image->width, ==, reference->width);
+    munit_assert_uint(image->height, ==, reference->height);
+
+    const unsigned bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    for (unsigned y = 0; y < image->height; y++) {
+        munit_assert_memory_equal(bytes_per_line, sail_scan_line(image, y), sail_scan_line(reference, y));
+    }
+}
+
+/* Allocates an image with padded rows and pixels depending on their coordinates. */
+static struct sail_image* alloc_test_image(enum SailPixelFormat pixel_format, unsigned width, unsigned height) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->pixel_format   = pixel_format;
+    image->width          = width;
+    image->height         = height;
+    image->bytes_per_line = sail_bytes_per_line(width, pixel_format) + 3;
+
+    munit_assert(sail_malloc((size_t)image->height * image->bytes_per_line, &image->pixels) == SAIL_OK);
+
+    for (unsigned y = 0; y < height; y++) {
+        uint8_t *scan = sail_scan_line(image, y);
+
+        for (unsigned i = 0; i < image->bytes_per_line; i++) {
+            scan[i] = (uint8_t)(i * 37 + y * 11);
+        }
+    }
+
+    return image;
+}
+
+/*
+ * Checks the converted image against the reference image converted into BPP32-ARGB or BPP32-XRGB
+ * with the generic code path.
+ */
+static void assert_converted(const struct sail_image *image, const struct sail_image *reference) {
+
+    munit_assert_uint(image->width, ==, reference->width);
+    munit_assert_uint(image->height, ==, reference->height);
+
+    /* Indexes of R, G, B, and A in the output pixel. A is -1 for 24-bit formats. */
+    int ri, gi, bi, ai;
+    unsigned bytes_per_pixel;
+
+    switch (image->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP24_RGB:  { ri = 0; gi = 1; bi = 2; ai = -1; bytes_per_pixel = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP24_BGR:  { ri = 2; gi = 1; bi = 0; ai = -1; bytes_per_pixel = 3; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: { ri = 0; gi = 1; bi = 2; ai = 3;  bytes_per_pixel = 4; break; }
+        case SAIL_PIXEL_FORMAT_BPP32_BGRA: { ri = 2; gi = 1; bi = 0; ai = 3;  bytes_per_pixel = 4; break; }
+        default: {
+            munit_error("Unexpected output pixel format");
+        }
+    }
+
+    for (unsigned y = 0; y < image->height; y++) {
+        const uint8_t *scan           = sail_scan_line(image, y);
+        const uint8_t *scan_reference = sail_scan_line(reference, y);
+
+        for (unsigned x = 0; x < image->width; x++) {
+            const uint8_t *pixel           = scan + x * bytes_per_pixel;
+            const uint8_t *pixel_reference = scan_reference + x * 4;
+
+            munit_assert_uint8(pixel[ri], ==, pixel_reference[1]);
+            munit_assert_uint8(pixel[gi], ==, pixel_reference[2]);
+            munit_assert_uint8(pixel[bi], ==, pixel_reference[3]);
+
+            if (ai >= 0) {
+                munit_assert_uint8(pixel[ai], ==, pixel_reference[0]);
+            }
+        }
+    }
+}
+
+static MunitResult test_convert_row_kernels(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Cover both the SIMD bodies and the tails of the kernels. */
+    static const unsigned WIDTHS[] = { 1, 5, 9, 17, 67 };
+
+    for (size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); w++) {
+        for (size_t i = 0; i < CONVERSIONS_LENGTH; i++) {
+            struct sail_image *image = alloc_test_image(CONVERSIONS[i].input, WIDTHS[w], 5);
+
+            /* Every instruction set matches the portable kernels. */
+            limit_instruction_set("generic");
+
+            struct sail_image *image_reference;
+            munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_ARGB, &image_reference) == SAIL_OK);
+
+            struct sail_image *image_portable;
+            munit_assert(sail_convert_image(image, CONVERSIONS[i].output, &image_portable) == SAIL_OK);
+            assert_converted(image_portable, image_reference);
+
+            for (size_t j = 0; j < sizeof(INSTRUCTION_SETS) / sizeof(INSTRUCTION_SETS[0]); j++) {
+                limit_instruction_set(INSTRUCTION_SETS[j]);
+
+                struct sail_image *image_converted;
+                munit_assert(sail_convert_image(image, CONVERSIONS[i].output, &image_converted) == SAIL_OK);
+                munit_assert_int(image_converted->pixel_format, ==, CONVERSIONS[i].output);
+                assert_same_pixels(image_converted, image_portable);
+                sail_destroy_image(image_converted);
+
+                /* In place. */
+                if (sail_greater_equal_bits_per_pixel(CONVERSIONS[i].input, CONVERSIONS[i].output)) {
+                    struct sail_image *image_updated;
+                    munit_assert(sail_copy_image(image, &image_updated) == SAIL_OK);
+                    munit_assert(sail_update_image(image_updated, CONVERSIONS[i].output) == SAIL_OK);
+                    munit_assert_int(image_updated->pixel_format, ==, CONVERSIONS[i].output);
+                    assert_same_pixels(image_updated, image_portable);
+                    sail_destroy_image(image_updated);
+                }
+            }
+
+            limit_instruction_set(NULL);
+
+            sail_destroy_image(image_portable);
+            sail_destroy_image(image_reference);
+            sail_destroy_image(image);
+        }
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_blend_alpha(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->options      = SAIL_CONVERSION_OPTION_BLEND_ALPHA;
+    options->background24 = (sail_rgb24_t){ 10, 20, 30 };
+
+    /* (a * c + (255 - a) * background + 127) / 255. */
+    {
+        struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 2, 1);
+        uint8_t *pixels = image->pixels;
+        pixels[0] = 200; pixels[1] = 100; pixels[2] = 0; pixels[3] = 0;
+        pixels[4] = 200; pixels[5] = 100; pixels[6] = 0; pixels[7] = 128;
+
+        struct sail_image *image_converted;
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP24_RGB, options, &image_converted) == SAIL_OK);
+
+        const uint8_t *pixels_converted = image_converted->pixels;
+        munit_assert_uint8(pixels_converted[0], ==, 10);
+        munit_assert_uint8(pixels_converted[1], ==, 20);
+        munit_assert_uint8(pixels_converted[2], ==, 30);
+        munit_assert_uint8(pixels_converted[3], ==, 105);
+        munit_assert_uint8(pixels_converted[4], ==, 60);
+        munit_assert_uint8(pixels_converted[5], ==, 15);
+
+        sail_destroy_image(image_converted);
+        sail_destroy_image(image);
+    }
+
+    /* Blending row kernels match the generic path blending into BPP32-XRGB. */
+    {
+        const enum SailPixelFormat input_pixel_formats[]  = { SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP32_BGRA };
+        const enum SailPixelFormat output_pixel_formats[] = { SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP24_BGR };
+
+        for (size_t i = 0; i < 2; i++) {
+            struct sail_image *image = alloc_test_image(input_pixel_formats[i], 67, 5);
+
+            struct sail_image *image_reference;
+            munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP32_XRGB, options, &image_reference) == SAIL_OK);
+
+            for (size_t j = 0; j < 2; j++) {
+                struct sail_image *image_converted;
+                munit_assert(sail_convert_image_with_options(image, output_pixel_formats[j], options, &image_converted) == SAIL_OK);
+                assert_converted(image_converted, image_reference);
+                sail_destroy_image(image_converted);
+            }
+
+            sail_destroy_image(image_reference);
+            sail_destroy_image(image);
+        }
+    }
+
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_luma(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    munit_assert_int(options->luma_coefficients, ==, SAIL_LUMA_COEFFICIENTS_BT601);
+
+    /* Pure colors. */
+    {
+        struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 2, 1);
+        uint8_t *pixels = image->pixels;
+        pixels[0] = 255; pixels[1] = 255; pixels[2] = 255;
+        pixels[3] = 255; pixels[4] = 0;   pixels[5] = 0;
+
+        const enum SailLumaCoefficients luma_coefficients[] = { SAIL_LUMA_COEFFICIENTS_BT601, SAIL_LUMA_COEFFICIENTS_BT709, SAIL_LUMA_COEFFICIENTS_BT2020 };
+        const uint8_t red_luma[] = { 76, 54, 67 };
+
+        for (size_t i = 0; i < 3; i++) {
+            options->luma_coefficients = luma_coefficients[i];
+
+            struct sail_image *image_converted;
+            munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, options, &image_converted) == SAIL_OK);
+
+            const uint8_t *pixels_converted = image_converted->pixels;
+            munit_assert_uint8(pixels_converted[0], ==, 255);
+            munit_assert_uint8(pixels_converted[1], ==, red_luma[i]);
+
+            sail_destroy_image(image_converted);
+        }
+
+        sail_destroy_image(image);
+    }
+
+    /* Luma row kernels match the generic path converting from BPP32-XRGB and BPP64-XRGB. */
+    {
+        static const struct {
+            enum SailPixelFormat input;
+            enum SailPixelFormat intermediate;
+            enum SailPixelFormat output;
+        } LUMA_CONVERSIONS[] = {
+            { SAIL_PIXEL_FORMAT_BPP24_RGB,  SAIL_PIXEL_FORMAT_BPP32_XRGB, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE  },
+            { SAIL_PIXEL_FORMAT_BPP24_BGR,  SAIL_PIXEL_FORMAT_BPP32_XRGB, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE  },
+            { SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP32_XRGB, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE  },
+            { SAIL_PIXEL_FORMAT_BPP32_BGRA, SAIL_PIXEL_FORMAT_BPP32_XRGB, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE  },
+            { SAIL_PIXEL_FORMAT_BPP48_RGB,  SAIL_PIXEL_FORMAT_BPP64_XRGB, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE },
+            { SAIL_PIXEL_FORMAT_BPP48_BGR,  SAIL_PIXEL_FORMAT_BPP64_XRGB, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE },
+            { SAIL_PIXEL_FORMAT_BPP64_RGBA, SAIL_PIXEL_FORMAT_BPP64_XRGB, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE },
+            { SAIL_PIXEL_FORMAT_BPP64_BGRA, SAIL_PIXEL_FORMAT_BPP64_XRGB, SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE },
+        };
+
+        options->luma_coefficients = SAIL_LUMA_COEFFICIENTS_BT709;
+
+        for (size_t i = 0; i < sizeof(LUMA_CONVERSIONS) / sizeof(LUMA_CONVERSIONS[0]); i++) {
+            struct sail_image *image = alloc_test_image(LUMA_CONVERSIONS[i].input, 67, 5);
+
+            struct sail_image *image_intermediate;
+            munit_assert(sail_convert_image(image, LUMA_CONVERSIONS[i].intermediate, &image_intermediate) == SAIL_OK);
+
+            struct sail_image *image_reference;
+            munit_assert(sail_convert_image_with_options(image_intermediate, LUMA_CONVERSIONS[i].output, options, &image_reference) == SAIL_OK);
+
+            struct sail_image *image_converted;
+            munit_assert(sail_convert_image_with_options(image, LUMA_CONVERSIONS[i].output, options, &image_converted) == SAIL_OK);
+
+            const unsigned bytes = sail_bytes_per_line(image->width, LUMA_CONVERSIONS[i].output);
+
+            for (unsigned row = 0; row < image->height; row++) {
+                munit_assert_memory_equal(bytes, sail_scan_line(image_converted, row), sail_scan_line(image_reference, row));
+            }
+
+            /* In place. */
+            munit_assert(sail_update_image_with_options(image, LUMA_CONVERSIONS[i].output, options) == SAIL_OK);
+
+            for (unsigned row = 0; row < image->height; row++) {
+                munit_assert_memory_equal(bytes, sail_scan_line(image, row), sail_scan_line(image_reference, row));
+            }
+
+            sail_destroy_image(image_converted);
+            sail_destroy_image(image_reference);
+            sail_destroy_image(image_intermediate);
+            sail_destroy_image(image);
+        }
+    }
+
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_parallelism(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    munit_assert_uint(options->parallel_pixels_threshold, ==, 0);
+    munit_assert_uint(options->parallel_chunk_size, ==, 0);
+
+    /* Serial conversion, one row per chunk, and a chunk larger than the image give the same result. */
+    const unsigned pixels_thresholds[] = { UINT_MAX, 1, 1 };
+    const unsigned chunk_sizes[]       = { 0,        1, UINT_MAX };
+
+    /* The generic path and a row kernel. */
+    const enum SailPixelFormat output_pixel_formats[] = { SAIL_PIXEL_FORMAT_BPP32_ARGB, SAIL_PIXEL_FORMAT_BPP32_BGRA };
+
+    for (size_t f = 0; f < 2; f++) {
+        struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 67, 37);
+
+        struct sail_image *image_reference;
+        munit_assert(sail_convert_image(image, output_pixel_formats[f], &image_reference) == SAIL_OK);
+
+        for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++) {
+            options->parallel_pixels_threshold = pixels_thresholds[i];
+            options->parallel_chunk_size       = chunk_sizes[i];
+
+            struct sail_image *image_converted;
+            munit_assert(sail_convert_image_with_options(image, output_pixel_formats[f], options, &image_converted) == SAIL_OK);
+            munit_assert_memory_equal((size_t)image_reference->height * image_reference->bytes_per_line,
+                                      image_converted->pixels, image_reference->pixels);
+            sail_destroy_image(image_converted);
+        }
+
+        sail_destroy_image(image_reference);
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_update(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* A row kernel and the generic path. */
+    const enum SailPixelFormat output_pixel_formats[] = { SAIL_PIXEL_FORMAT_BPP32_RGBA, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE };
+
+    for (size_t i = 0; i < 2; i++) {
+        struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP64_RGBA, 67, 5);
+        void *pixels = image->pixels;
+
+        struct sail_image *image_reference;
+        munit_assert(sail_convert_image(image, output_pixel_formats[i], &image_reference) == SAIL_OK);
+
+        /* Pixels are not reallocated and rows are packed. */
+        munit_assert(sail_update_image(image, output_pixel_formats[i]) == SAIL_OK);
+        munit_assert_ptr_equal(image->pixels, pixels);
+        munit_assert_uint(image->bytes_per_line, ==, image_reference->bytes_per_line);
+        munit_assert_memory_equal((size_t)image->height * image->bytes_per_line, image->pixels, image_reference->pixels);
+
+        sail_destroy_image(image_reference);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_indexed(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const enum SailPixelFormat pixel_formats[] = {
+        SAIL_PIXEL_FORMAT_BPP1_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP2_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP4_INDEXED,
+        SAIL_PIXEL_FORMAT_BPP8_INDEXED,
+    };
+
+    for (size_t p = 0; p < sizeof(pixel_formats) / sizeof(pixel_formats[0]); p++) {
+        const unsigned bits = sail_bits_per_pixel(pixel_formats[p]);
+
+        /* Odd width leaves a partial byte at the end of every row. */
+        struct sail_image *image = alloc_test_image(pixel_formats[p], 37, 3);
+
+        /* 8-bit indexes above 200 are out of range. */
+        const unsigned color_count = (bits == 8) ? 200 : 1U << bits;
+
+        munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP32_RGBA, color_count, &image->palette) == SAIL_OK);
+
+        for (unsigned i = 0; i < color_count; i++) {
+            uint8_t *entry = (uint8_t *)image->palette->data + i * 4;
+
+            entry[0] = (uint8_t)(i * 3);
+            entry[1] = (uint8_t)(i * 5);
+            entry[2] = (uint8_t)(i * 7);
+            entry[3] = (uint8_t)(255 - i);
+        }
+
+        struct sail_image *image_rgba;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_rgba) == SAIL_OK);
+        struct sail_image *image_bgr;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_BGR, &image_bgr) == SAIL_OK);
+        struct sail_image *image_rgba64;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP64_RGBA, &image_rgba64) == SAIL_OK);
+
+        for (unsigned y = 0; y < image->height; y++) {
+            const uint8_t *scan         = sail_scan_line(image, y);
+            const uint8_t *scan_rgba    = sail_scan_line(image_rgba, y);
+            const uint8_t *scan_bgr     = sail_scan_line(image_bgr, y);
+            const uint16_t *scan_rgba64 = sail_scan_line(image_rgba64, y);
+
+            for (unsigned x = 0; x < image->width; x++) {
+                const unsigned bit_offset = x * bits;
+                const unsigned index = (scan[bit_offset / 8] >> (8 - bits - bit_offset % 8)) & ((1U << bits) - 1);
+
+                uint8_t expected[4] = { 0, 0, 0, 255 };
+
+                if (index < color_count) {
+                    memcpy(expected, (const uint8_t *)image->palette->data + index * 4, 4);
+                }
+
+                munit_assert_memory_equal(4, scan_rgba + x * 4, expected);
+
+                munit_assert_uint8(scan_bgr[x * 3 + 0], ==, expected[2]);
+                munit_assert_uint8(scan_bgr[x * 3 + 1], ==, expected[1]);
+                munit_assert_uint8(scan_bgr[x * 3 + 2], ==, expected[0]);
+
+                for (unsigned c = 0; c < 4; c++) {
+                    munit_assert_uint16(scan_rgba64[x * 4 + c], ==, expected[c] * 257);
+                }
+            }
+        }
+
+        sail_destroy_image(image_rgba64);
+        sail_destroy_image(image_bgr);
+        sail_destroy_image(image_rgba);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_grayscale(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const enum SailPixelFormat pixel_formats[] = {
+        SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP2_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+    };
+
+    for (size_t p = 0; p < sizeof(pixel_formats) / sizeof(pixel_formats[0]); p++) {
+        const unsigned bits = sail_bits_per_pixel(pixel_formats[p]);
+        const unsigned max_value = (1U << bits) - 1;
+
+        struct sail_image *image = alloc_test_image(pixel_formats[p], 45, 3);
+
+        struct sail_image *image_gray;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, &image_gray) == SAIL_OK);
+        struct sail_image *image_rgba;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_rgba) == SAIL_OK);
+
+        for (unsigned y = 0; y < image->height; y++) {
+            const uint8_t *scan      = sail_scan_line(image, y);
+            const uint8_t *scan_gray = sail_scan_line(image_gray, y);
+            const uint8_t *scan_rgba = sail_scan_line(image_rgba, y);
+
+            for (unsigned x = 0; x < image->width; x++) {
+                const unsigned bit_offset = x * bits;
+                const unsigned value = (scan[bit_offset / 8] >> (8 - bits - bit_offset % 8)) & max_value;
+                const uint8_t expected = (uint8_t)(value * 255 / max_value);
+
+                munit_assert_uint8(scan_gray[x], ==, expected);
+
+                munit_assert_uint8(scan_rgba[x * 4 + 0], ==, expected);
+                munit_assert_uint8(scan_rgba[x * 4 + 1], ==, expected);
+                munit_assert_uint8(scan_rgba[x * 4 + 2], ==, expected);
+                munit_assert_uint8(scan_rgba[x * 4 + 3], ==, 255);
+            }
+        }
+
+        sail_destroy_image(image_rgba);
+        sail_destroy_image(image_gray);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_can_convert(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* sail_can_convert() agrees with the actual conversion for every pair of pixel formats. */
+    for (int input = SAIL_PIXEL_FORMAT_UNKNOWN; input <= SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED; input++) {
+        const enum SailPixelFormat input_pixel_format = (enum SailPixelFormat)input;
+
+        if (sail_bits_per_pixel(input_pixel_format) == 0) {
+            continue;
+        }
+
+        struct sail_image *image = alloc_test_image(input_pixel_format, 5, 2);
+
+        if (sail_is_indexed(input_pixel_format)) {
+            munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 256, &image->palette) == SAIL_OK);
+        }
+
+        for (int output = SAIL_PIXEL_FORMAT_UNKNOWN; output <= SAIL_PIXEL_FORMAT_BPP64_BGRA_PREMULTIPLIED; output++) {
+            const enum SailPixelFormat output_pixel_format = (enum SailPixelFormat)output;
+
+            struct sail_image *image_output = NULL;
+            const sail_status_t status = sail_convert_image(image, output_pixel_format, &image_output);
+
+            munit_assert_int(sail_can_convert(input_pixel_format, output_pixel_format), ==, status == SAIL_OK);
+
+            sail_destroy_image(image_output);
+        }
+
+        sail_destroy_image(image);
+    }
+
+    munit_assert_false(sail_can_convert((enum SailPixelFormat)1000, SAIL_PIXEL_FORMAT_BPP24_RGB));
+    munit_assert_false(sail_can_convert(SAIL_PIXEL_FORMAT_BPP24_RGB, (enum SailPixelFormat)-1));
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_iccp(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 5, 2);
+
+    /* No profile, nothing to apply. */
+    munit_assert(sail_apply_iccp(image) == SAIL_OK);
+
+    const unsigned char profile[] = { 1, 2, 3, 4 };
+    munit_assert(sail_alloc_iccp_from_data(profile, sizeof(profile), &image->iccp) == SAIL_OK);
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->options = SAIL_CONVERSION_OPTION_APPLY_ICCP;
+
+    /* Alpha cannot be created by the color transform, so this conversion falls back to the plain one. */
+    struct sail_image *image_reference;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_reference) == SAIL_OK);
+
+    struct sail_image *image_output;
+    munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, options, &image_output) == SAIL_OK);
+    munit_assert_not_null(image_output->iccp);
+    munit_assert_memory_equal((size_t)image_output->height * image_output->bytes_per_line, image_output->pixels, image_reference->pixels);
+
+    sail_destroy_image(image_output);
+    sail_destroy_image(image_reference);
+    sail_destroy_conversion_options(options);
+
+    /* The profile is broken or SAIL is compiled without color management. */
+    munit_assert(sail_apply_iccp(image) != SAIL_OK);
+    munit_assert_not_null(image->iccp);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+/* Allocates a BPP32-RGBA-like image with all combinations of 8-bit color components and alpha. */
+static struct sail_image* alloc_alpha_combinations_image(enum SailPixelFormat pixel_format) {
+
+    /* Odd width covers the tails of the kernels. */
+    struct sail_image *image = alloc_test_image(pixel_format, 259, 256);
+
+    for (unsigned y = 0; y < image->height; y++) {
+        uint8_t *scan = sail_scan_line(image, y);
+
+        for (unsigned x = 0; x < image->width; x++) {
+            scan[x * 4 + 0] = (uint8_t)x;
+            scan[x * 4 + 1] = (uint8_t)(255 - x);
+            scan[x * 4 + 2] = (uint8_t)(x * 7);
+            scan[x * 4 + 3] = (uint8_t)y;
+        }
+    }
+
+    return image;
+}
+
+/* Checks that every pixel of the converted image is the function of the same pixel of the input image. */
+static void assert_alpha_converted(const struct sail_image *image, const struct sail_image *image_converted,
+                                   bool swapped, unsigned (*function)(unsigned c, unsigned a)) {
+
+    for (unsigned y = 0; y < image->height; y++) {
+        const uint8_t *scan           = sail_scan_line(image, y);
+        const uint8_t *scan_converted = sail_scan_line(image_converted, y);
+
+        for (unsigned x = 0; x < image->width; x++) {
+            const uint8_t *pixel           = scan + x * 4;
+            const uint8_t *pixel_converted = scan_converted + x * 4;
+
+            munit_assert_uint8(pixel_converted[swapped ? 2 : 0], ==, function(pixel[0], pixel[3]));
+            munit_assert_uint8(pixel_converted[1],               ==, function(pixel[1], pixel[3]));
+            munit_assert_uint8(pixel_converted[swapped ? 0 : 2], ==, function(pixel[2], pixel[3]));
+            munit_assert_uint8(pixel_converted[3],               ==, pixel[3]);
+        }
+    }
+}
+
+static unsigned premultiply(unsigned c, unsigned a) {
+
+    return (c * a + 127) / 255;
+}
+
+static unsigned unpremultiply(unsigned c, unsigned a) {
+
+    if (a == 0) {
+        return 0;
+    }
+
+    const unsigned value = (c * 255 + a / 2) / a;
+
+    return value > 255 ? 255 : value;
+}
+
+static MunitResult test_convert_premultiplied(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Row kernels. */
+    struct sail_image *image = alloc_alpha_combinations_image(SAIL_PIXEL_FORMAT_BPP32_RGBA);
+
+    struct sail_image *image_converted;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED, &image_converted) == SAIL_OK);
+    assert_alpha_converted(image, image_converted, false, premultiply);
+    sail_destroy_image(image_converted);
+
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED, &image_converted) == SAIL_OK);
+    assert_alpha_converted(image, image_converted, true, premultiply);
+    sail_destroy_image(image_converted);
+
+    /* Invalid pixels with color components greater than alpha are clamped. */
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA_PREMULTIPLIED;
+
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_converted) == SAIL_OK);
+    assert_alpha_converted(image, image_converted, false, unpremultiply);
+    sail_destroy_image(image_converted);
+
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_BGRA, &image_converted) == SAIL_OK);
+    assert_alpha_converted(image, image_converted, true, unpremultiply);
+    sail_destroy_image(image_converted);
+
+    /* The generic path produces the same results. */
+    struct sail_image *image_reference;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP64_RGBA, &image_converted) == SAIL_OK);
+    munit_assert(sail_convert_image(image_converted, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_reference) == SAIL_OK);
+    assert_alpha_converted(image, image_reference, false, unpremultiply);
+    sail_destroy_image(image_reference);
+    sail_destroy_image(image_converted);
+
+    image->pixel_format = SAIL_PIXEL_FORMAT_BPP32_RGBA;
+
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP64_RGBA_PREMULTIPLIED, &image_converted) == SAIL_OK);
+    munit_assert(sail_convert_image(image_converted, SAIL_PIXEL_FORMAT_BPP64_RGBA, &image_reference) == SAIL_OK);
+    sail_destroy_image(image_converted);
+
+    /* Premultiplying 16-bit components loses a little precision. Transparent pixels become black. */
+    for (unsigned y = 0; y < image->height; y++) {
+        const uint8_t  *scan           = sail_scan_line(image, y);
+        const uint16_t *scan_reference = sail_scan_line(image_reference, y);
+
+        for (unsigned i = 0; i < image->width * 4; i++) {
+            const bool transparent_color = i % 4 != 3 && scan[i - i % 4 + 3] == 0;
+            const int expected = transparent_color ? 0 : scan[i] * 257;
+
+            munit_assert_int(abs((int)scan_reference[i] - expected), <=, 257);
+        }
+    }
+
+    sail_destroy_image(image_reference);
+
+    /* In place. */
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED, &image_reference) == SAIL_OK);
+    munit_assert(sail_update_image(image, SAIL_PIXEL_FORMAT_BPP32_BGRA_PREMULTIPLIED) == SAIL_OK);
+    munit_assert_memory_equal((size_t)image->height * image->bytes_per_line, image->pixels, image_reference->pixels);
+
+    sail_destroy_image(image_reference);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_narrow(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* All 16-bit values are rounded to the nearest 8-bit values. */
+    struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, 256, 256);
+
+    for (unsigned y = 0; y < image->height; y++) {
+        uint16_t *scan = sail_scan_line(image, y);
+
+        for (unsigned x = 0; x < image->width; x++) {
+            scan[x] = (uint16_t)(y * 256 + x);
+        }
+    }
+
+    struct sail_image *image_output;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, &image_output) == SAIL_OK);
+
+    for (unsigned y = 0; y < image->height; y++) {
+        const uint16_t *scan       = sail_scan_line(image, y);
+        const uint8_t *scan_output = sail_scan_line(image_output, y);
+
+        for (unsigned x = 0; x < image->width; x++) {
+            munit_assert_uint8(scan_output[x], ==, (uint8_t)((scan[x] * 255U + 32895) >> 16));
+        }
+    }
+
+    sail_destroy_image(image_output);
+    sail_destroy_image(image);
+
+    /* Dithering keeps the average value of every 8x8 block and doesn't touch alpha. */
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->options = SAIL_CONVERSION_OPTION_DITHER;
+
+    static const uint16_t VALUES[] = { 0, 1, 128, 1000, 32767, 40000, 65407, 65535 };
+
+    for (size_t i = 0; i < sizeof(VALUES) / sizeof(VALUES[0]); i++) {
+        /* Odd width covers the tails of the kernels. */
+        image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP64_RGBA, 67, 16);
+
+        for (unsigned y = 0; y < image->height; y++) {
+            uint16_t *scan = sail_scan_line(image, y);
+
+            for (unsigned x = 0; x < image->width * 4; x++) {
+                scan[x] = VALUES[i];
+            }
+        }
+
+        munit_assert(sail_convert_image_with_options(image, SAIL_PIXEL_FORMAT_BPP32_RGBA, options, &image_output) == SAIL_OK);
+
+        const unsigned lower = VALUES[i] / 257;
+
+        for (unsigned block_x = 0; block_x + 8 <= image->width; block_x += 8) {
+            for (unsigned c = 0; c < 3; c++) {
+                unsigned sum = 0;
+
+                for (unsigned y = 0; y < 8; y++) {
+                    const uint8_t *scan_output = sail_scan_line(image_output, y);
+
+                    for (unsigned x = block_x; x < block_x + 8; x++) {
+                        const uint8_t value = scan_output[x * 4 + c];
+
+                        munit_assert_true(value == lower || value == lower + 1);
+                        sum += value;
+                    }
+                }
+
+                munit_assert_double(fabs(sum - VALUES[i] * 64 / 257.0), <=, 1);
+            }
+        }
+
+        for (unsigned y = 0; y < image->height; y++) {
+            const uint8_t *scan_output = sail_scan_line(image_output, y);
+
+            for (unsigned x = 0; x < image->width; x++) {
+                munit_assert_uint8(scan_output[x * 4 + 3], ==, (uint8_t)((VALUES[i] * 255U + 32895) >> 16));
+            }
+        }
+
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_conversion_plan(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Every conversion kind: luma, narrowing with dithering, row kernel, blending, sub-byte indexes, and pixel consumers. */
+    const struct {
+        enum SailPixelFormat input_pixel_format;
+        enum SailPixelFormat output_pixel_format;
+        int options;
+    } conversions[] = {
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,     SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE, 0 },
+        { SAIL_PIXEL_FORMAT_BPP64_RGBA,    SAIL_PIXEL_FORMAT_BPP32_RGBA,     SAIL_CONVERSION_OPTION_DITHER },
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,     SAIL_PIXEL_FORMAT_BPP32_BGRA,     0 },
+        { SAIL_PIXEL_FORMAT_BPP32_RGBA,    SAIL_PIXEL_FORMAT_BPP24_RGB,      SAIL_CONVERSION_OPTION_BLEND_ALPHA },
+        { SAIL_PIXEL_FORMAT_BPP4_INDEXED,  SAIL_PIXEL_FORMAT_BPP24_BGR,      0 },
+        { SAIL_PIXEL_FORMAT_BPP16_RGB565,  SAIL_PIXEL_FORMAT_BPP64_RGBA,     0 },
+    };
+
+    struct sail_conversion_options *options;
+    munit_assert(sail_alloc_conversion_options(&options) == SAIL_OK);
+    options->background24.component1 = 10;
+    options->background24.component2 = 20;
+    options->background24.component3 = 30;
+
+    for (size_t i = 0; i < sizeof(conversions) / sizeof(conversions[0]); i++) {
+        options->options = conversions[i].options;
+
+        struct sail_conversion_plan *plan;
+        munit_assert(sail_create_conversion_plan(conversions[i].input_pixel_format, conversions[i].output_pixel_format,
+                                                 options, &plan) == SAIL_OK);
+
+        /* The plan owns a copy of the options. */
+        options->options = 0;
+
+        struct sail_image *image_output = NULL;
+
+        /* Frames with different pixels are converted into the same output image. */
+        for (unsigned frame = 0; frame < 2; frame++) {
+            struct sail_image *image = alloc_test_image(conversions[i].input_pixel_format, 37, 5);
+
+            for (unsigned y = 0; y < image->height; y++) {
+                uint8_t *scan = sail_scan_line(image, y);
+
+                for (unsigned x = 0; x < image->bytes_per_line; x++) {
+                    scan[x] = (uint8_t)(scan[x] + frame * 101);
+                }
+            }
+
+            if (sail_is_indexed(image->pixel_format)) {
+                munit_assert(sail_alloc_palette_for_data(SAIL_PIXEL_FORMAT_BPP24_RGB, 16, &image->palette) == SAIL_OK);
+
+                for (unsigned c = 0; c < 16 * 3; c++) {
+                    ((uint8_t *)image->palette->data)[c] = (uint8_t)(c * 5 + frame);
+                }
+            }
+
+            options->options = conversions[i].options;
+            struct sail_image *image_reference;
+            munit_assert(sail_convert_image_with_options(image, conversions[i].output_pixel_format, options, &image_reference) == SAIL_OK);
+            options->options = 0;
+
+            if (image_output == NULL) {
+                munit_assert(sail_convert_image(image, conversions[i].output_pixel_format, &image_output) == SAIL_OK);
+            }
+
+            munit_assert(sail_execute_conversion_plan(plan, image, image_output) == SAIL_OK);
+
+            for (unsigned y = 0; y < image->height; y++) {
+                munit_assert_memory_equal(sail_bytes_per_line(image->width, image_output->pixel_format),
+                                          sail_scan_line(image_output, y), sail_scan_line(image_reference, y));
+            }
+
+            /* Mismatching images. */
+            munit_assert(sail_execute_conversion_plan(plan, image_output, image_output) == SAIL_ERROR_INVALID_PIXEL_FORMAT);
+
+            image_output->height--;
+            munit_assert(sail_execute_conversion_plan(plan, image, image_output) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+            image_output->height++;
+
+            sail_destroy_image(image_reference);
+            sail_destroy_image(image);
+        }
+
+        sail_destroy_image(image_output);
+        sail_destroy_conversion_plan(plan);
+    }
+
+    struct sail_conversion_plan *plan;
+    munit_assert(sail_create_conversion_plan(SAIL_PIXEL_FORMAT_BPP24_RGB, SAIL_PIXEL_FORMAT_BPP1_INDEXED, NULL, &plan) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    munit_assert(sail_create_conversion_plan(SAIL_PIXEL_FORMAT_BPP24_CIE_LAB, SAIL_PIXEL_FORMAT_BPP24_RGB, NULL, &plan) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+    sail_destroy_conversion_plan(NULL);
+    sail_destroy_conversion_options(options);
+
+    return MUNIT_OK;
+}
+
+static const struct sail_conversion_stats* find_conversion_stats(const struct sail_conversion_stats *stats, size_t count,
+                                                                 enum SailPixelFormat input_pixel_format,
+                                                                 enum SailPixelFormat output_pixel_format) {
+
+    for (size_t i = 0; i < count; i++) {
+        if (stats[i].input_pixel_format == input_pixel_format && stats[i].output_pixel_format == output_pixel_format) {
+            return &stats[i];
+        }
+    }
+
+    return NULL;
+}
+
+static MunitResult test_convert_stats(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    static const struct {
+        enum SailPixelFormat input;
+        enum SailPixelFormat output;
+        enum SailConversionKernel kernel;
+    } STATS_CONVERSIONS[] = {
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,    SAIL_PIXEL_FORMAT_BPP24_BGR,       SAIL_CONVERSION_KERNEL_ROW    },
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,    SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  SAIL_CONVERSION_KERNEL_LUMA   },
+        { SAIL_PIXEL_FORMAT_BPP64_RGBA,   SAIL_PIXEL_FORMAT_BPP32_RGBA,      SAIL_CONVERSION_KERNEL_NARROW },
+        { SAIL_PIXEL_FORMAT_BPP16_RGB565, SAIL_PIXEL_FORMAT_BPP32_RGBA,      SAIL_CONVERSION_KERNEL_PIXEL  },
+    };
+    static const size_t STATS_CONVERSIONS_LENGTH = sizeof(STATS_CONVERSIONS) / sizeof(STATS_CONVERSIONS[0]);
+
+    size_t count;
+
+    /* Disabled stats count nothing. */
+    munit_assert_false(sail_is_conversion_stats_enabled());
+
+    {
+        struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 67, 5);
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_BGR, &image_output) == SAIL_OK);
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+    }
+
+    munit_assert(sail_conversion_stats(NULL, 0, &count) == SAIL_OK);
+    munit_assert_size(count, ==, 0);
+
+    sail_set_conversion_stats_enabled(true);
+    munit_assert_true(sail_is_conversion_stats_enabled());
+
+    for (size_t i = 0; i < STATS_CONVERSIONS_LENGTH; i++) {
+        struct sail_image *image = alloc_test_image(STATS_CONVERSIONS[i].input, 67, 5);
+
+        /* Converted twice with a new image and with a plan. */
+        struct sail_image *image_output;
+        munit_assert(sail_convert_image(image, STATS_CONVERSIONS[i].output, &image_output) == SAIL_OK);
+
+        struct sail_conversion_plan *plan;
+        munit_assert(sail_create_conversion_plan(STATS_CONVERSIONS[i].input, STATS_CONVERSIONS[i].output, NULL, &plan) == SAIL_OK);
+        munit_assert(sail_execute_conversion_plan(plan, image, image_output) == SAIL_OK);
+
+        sail_destroy_conversion_plan(plan);
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+    }
+
+    struct sail_conversion_stats stats[8];
+    munit_assert(sail_conversion_stats(stats, sizeof(stats) / sizeof(stats[0]), &count) == SAIL_OK);
+    munit_assert_size(count, ==, STATS_CONVERSIONS_LENGTH);
+
+    for (size_t i = 0; i < STATS_CONVERSIONS_LENGTH; i++) {
+        const struct sail_conversion_stats *conversion_stats = find_conversion_stats(stats, count, STATS_CONVERSIONS[i].input,
+                                                                                     STATS_CONVERSIONS[i].output);
+        munit_assert_not_null(conversion_stats);
+
+        munit_assert_int(conversion_stats->kernel, ==, STATS_CONVERSIONS[i].kernel);
+        munit_assert_uint64(conversion_stats->calls, ==, 2);
+        munit_assert_uint64(conversion_stats->pixels, ==, 2 * 67 * 5);
+        munit_assert_not_null(sail_conversion_kernel_to_string(conversion_stats->kernel));
+        munit_assert_not_null(sail_instruction_set_to_string(conversion_stats->instruction_set));
+
+        if (conversion_stats->kernel == SAIL_CONVERSION_KERNEL_PIXEL) {
+            munit_assert_int(conversion_stats->instruction_set, ==, SAIL_INSTRUCTION_SET_GENERIC);
+        }
+    }
+
+    /* The total number is saved even if fewer counters are copied. */
+    munit_assert(sail_conversion_stats(stats, 1, &count) == SAIL_OK);
+    munit_assert_size(count, ==, STATS_CONVERSIONS_LENGTH);
+    munit_assert(sail_conversion_stats(NULL, 1, &count) == SAIL_ERROR_NULL_PTR);
+
+    sail_reset_conversion_stats();
+    munit_assert(sail_conversion_stats(NULL, 0, &count) == SAIL_OK);
+    munit_assert_size(count, ==, 0);
+
+    /* Limited row kernels report the portable instruction set. */
+    {
+        limit_instruction_set("generic");
+
+        struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 67, 5);
+        struct sail_image *image_converted;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_BGR, &image_converted) == SAIL_OK);
+        sail_destroy_image(image_converted);
+        sail_destroy_image(image);
+
+        limit_instruction_set(NULL);
+
+        munit_assert(sail_conversion_stats(stats, 1, &count) == SAIL_OK);
+        munit_assert_size(count, ==, 1);
+        munit_assert_int(stats[0].kernel, ==, SAIL_CONVERSION_KERNEL_ROW);
+        munit_assert_int(stats[0].instruction_set, ==, SAIL_INSTRUCTION_SET_GENERIC);
+
+        sail_reset_conversion_stats();
+    }
+
+    sail_set_conversion_stats_enabled(false);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_planar(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP24_YCBCR, 8, 6);
+
+    void *planes[4];
+    unsigned strides[4];
+    unsigned planes_count;
+
+    /* 4:4:4 holds the same values. */
+    struct sail_image *image_i444;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444, &image_i444) == SAIL_OK);
+    munit_assert_uint(image_i444->bytes_per_line, ==, 24);
+    munit_assert(sail_image_planes(image_i444, planes, strides, &planes_count) == SAIL_OK);
+
+    for (unsigned y = 0; y < image->height; y++) {
+        const uint8_t *scan = sail_scan_line(image, y);
+
+        for (unsigned x = 0; x < image->width; x++) {
+            for (unsigned plane = 0; plane < 3; plane++) {
+                munit_assert_uint8(((const uint8_t *)planes[plane])[y * strides[plane] + x], ==, scan[x * 3 + plane]);
+            }
+        }
+    }
+
+    struct sail_image *image_converted;
+    munit_assert(sail_convert_image(image_i444, SAIL_PIXEL_FORMAT_BPP24_YCBCR, &image_converted) == SAIL_OK);
+
+    for (unsigned y = 0; y < image->height; y++) {
+        munit_assert_memory_equal(image->width * 3, sail_scan_line(image_converted, y), sail_scan_line(image, y));
+    }
+
+    sail_destroy_image(image_converted);
+
+    /* Planar images convert into RGB like the packed ones. */
+    struct sail_image *image_reference;
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_RGB, &image_reference) == SAIL_OK);
+    munit_assert(sail_convert_image(image_i444, SAIL_PIXEL_FORMAT_BPP24_RGB, &image_converted) == SAIL_OK);
+
+    for (unsigned y = 0; y < image->height; y++) {
+        munit_assert_memory_equal(image->width * 3, sail_scan_line(image_converted, y), sail_scan_line(image_reference, y));
+    }
+
+    sail_destroy_image(image_converted);
+    sail_destroy_image(image_reference);
+
+    /* 4:2:0 chroma is averaged over 2x2 blocks. */
+    struct sail_image *image_i420;
+    munit_assert(sail_convert_image(image_i444, SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420, &image_i420) == SAIL_OK);
+    munit_assert_uint(image_i420->bytes_per_line, ==, 12);
+    munit_assert(sail_image_planes(image_i420, planes, strides, &planes_count) == SAIL_OK);
+
+    for (unsigned y = 0; y < image->height; y++) {
+        const uint8_t *scan1 = sail_scan_line(image, y / 2 * 2);
+        const uint8_t *scan2 = sail_scan_line(image, y / 2 * 2 + 1);
+
+        for (unsigned x = 0; x < image->width; x++) {
+            munit_assert_uint8(((const uint8_t *)planes[0])[y * strides[0] + x], ==, ((const uint8_t *)sail_scan_line(image, y))[x * 3]);
+
+            if (x % 2 == 0 && y % 2 == 0) {
+                for (unsigned plane = 1; plane < 3; plane++) {
+                    const unsigned sum = scan1[x * 3 + plane] + scan1[x * 3 + 3 + plane] + scan2[x * 3 + plane] + scan2[x * 3 + 3 + plane];
+                    munit_assert_uint8(((const uint8_t *)planes[plane])[y / 2 * strides[plane] + x / 2], ==, (sum + 2) / 4);
+                }
+            }
+        }
+    }
+
+    /* NV12 interleaves the same chroma, and replicated chroma is averaged back exactly. */
+    struct sail_image *image_nv12;
+    munit_assert(sail_convert_image(image_i420, SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12, &image_nv12) == SAIL_OK);
+
+    void *nv12_planes[4];
+    unsigned nv12_strides[4];
+    munit_assert(sail_image_planes(image_nv12, nv12_planes, nv12_strides, &planes_count) == SAIL_OK);
+    munit_assert_uint(planes_count, ==, 2);
+    munit_assert_memory_equal((size_t)image->width * image->height, nv12_planes[0], planes[0]);
+
+    for (unsigned y = 0; y < image->height / 2; y++) {
+        for (unsigned x = 0; x < image->width / 2; x++) {
+            munit_assert_uint8(((const uint8_t *)nv12_planes[1])[y * nv12_strides[1] + x * 2],     ==, ((const uint8_t *)planes[1])[y * strides[1] + x]);
+            munit_assert_uint8(((const uint8_t *)nv12_planes[1])[y * nv12_strides[1] + x * 2 + 1], ==, ((const uint8_t *)planes[2])[y * strides[2] + x]);
+        }
+    }
+
+    munit_assert(sail_convert_image(image_nv12, SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420, &image_converted) == SAIL_OK);
+    munit_assert_memory_equal((size_t)image->height * image_i420->bytes_per_line, image_converted->pixels, image_i420->pixels);
+    sail_destroy_image(image_converted);
+
+    munit_assert(sail_convert_image(image_nv12, SAIL_PIXEL_FORMAT_BPP32_RGBA, &image_converted) == SAIL_OK);
+    sail_destroy_image(image_converted);
+
+    sail_destroy_image(image_nv12);
+    sail_destroy_image(image_i420);
+    sail_destroy_image(image_i444);
+    sail_destroy_image(image);
+
+    /* 4:2:0 needs even dimensions. */
+    image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 7, 4);
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420, &image_converted) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444, &image_converted) == SAIL_OK);
+
+    /* Planar images are converted as a whole. */
+    struct sail_conversion_plan *plan;
+    munit_assert(sail_create_conversion_plan(SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444, SAIL_PIXEL_FORMAT_BPP24_RGB, NULL, &plan) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+    munit_assert(sail_update_image(image_converted, SAIL_PIXEL_FORMAT_BPP24_RGB) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+    munit_assert_true(sail_can_convert(SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12, SAIL_PIXEL_FORMAT_BPP24_RGB));
+    munit_assert_true(sail_can_convert(SAIL_PIXEL_FORMAT_BPP32_CMYK, SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420));
+    munit_assert_false(sail_can_convert(SAIL_PIXEL_FORMAT_BPP24_CIE_LAB, SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420));
+    munit_assert_false(sail_can_convert(SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420, SAIL_PIXEL_FORMAT_BPP32_CMYK));
+
+    sail_destroy_image(image_converted);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_convert_half_float(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image;
+    struct sail_image *image_converted;
+
+    /* Known values. HDR values are clamped, negative values and NaNs become 0. */
+    {
+        image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP64_RGBA, 1, 1);
+        const uint16_t pixel[4] = { 65535, 0, 32768, 65535 };
+        memcpy(image->pixels, pixel, sizeof(pixel));
+
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF, &image_converted) == SAIL_OK);
+        const uint16_t *half = image_converted->pixels;
+        munit_assert_uint16(half[0], ==, 0x3C00);
+        munit_assert_uint16(half[1], ==, 0x0000);
+        munit_assert_uint16(half[2], ==, 0x3800);
+        munit_assert_uint16(half[3], ==, 0x3C00);
+        sail_destroy_image(image_converted);
+        sail_destroy_image(image);
+
+        image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF, 1, 1);
+        const uint16_t pixel_half[4] = { 0x4000, 0xBC00, 0x7E00, 0x3800 };
+        memcpy(image->pixels, pixel_half, sizeof(pixel_half));
+
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP64_RGBA, &image_converted) == SAIL_OK);
+        const uint16_t *rgba64 = image_converted->pixels;
+        munit_assert_uint16(rgba64[0], ==, 65535);
+        munit_assert_uint16(rgba64[1], ==, 0);
+        munit_assert_uint16(rgba64[2], ==, 0);
+        munit_assert_uint16(rgba64[3], ==, 32768);
+        sail_destroy_image(image_converted);
+
+        /* HDR values survive the conversion into floating point. */
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, &image_converted) == SAIL_OK);
+        float values[4];
+        memcpy(values, image_converted->pixels, sizeof(values));
+        munit_assert_float(values[0], ==, 2.0f);
+        munit_assert_float(values[1], ==, -1.0f);
+        munit_assert_true(isnan(values[2]));
+        munit_assert_float(values[3], ==, 0.5f);
+        sail_destroy_image(image_converted);
+        sail_destroy_image(image);
+    }
+
+    /*
+     * Every half precision value: HALF -> FLOAT -> HALF is lossless, and the HALF -> RGBA64 kernel
+     * matches the generic path.
+     */
+    {
+        image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF, 65536 / 4, 1);
+        uint16_t *half = image->pixels;
+
+        for (unsigned i = 0; i < 65536; i++) {
+            const bool nan = (i & 0x7C00) == 0x7C00 && (i & 0x3FF) != 0;
+            half[i] = nan ? 0 : (uint16_t)i;
+        }
+
+        struct sail_image *image_float;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, &image_float) == SAIL_OK);
+        munit_assert(sail_convert_image(image_float, SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF, &image_converted) == SAIL_OK);
+        munit_assert_memory_equal(65536 * 2, image_converted->pixels, image->pixels);
+        sail_destroy_image(image_converted);
+        sail_destroy_image(image_float);
+
+        struct sail_image *image_reference;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP48_RGB, &image_reference) == SAIL_OK);
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP64_RGBA, &image_converted) == SAIL_OK);
+
+        const uint16_t *scan           = image_converted->pixels;
+        const uint16_t *scan_reference = image_reference->pixels;
+
+        for (unsigned x = 0; x < image->width; x++) {
+            munit_assert_memory_equal(3 * 2, scan + x * 4, scan_reference + x * 3);
+        }
+
+        sail_destroy_image(image_converted);
+        sail_destroy_image(image_reference);
+        sail_destroy_image(image);
+    }
+
+    /* Cover both the SIMD bodies and the tails of the kernels. */
+    static const unsigned WIDTHS[] = { 1, 5, 9, 17, 67 };
+
+    for (size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); w++) {
+        /* RGBA64 -> FLOAT -> RGBA64 is lossless. */
+        image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP64_RGBA, WIDTHS[w], 5);
+
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, &image_converted) == SAIL_OK);
+        munit_assert(sail_update_image(image_converted, SAIL_PIXEL_FORMAT_BPP64_RGBA) == SAIL_OK);
+
+        for (unsigned y = 0; y < image->height; y++) {
+            munit_assert_memory_equal(WIDTHS[w] * 8, sail_scan_line(image_converted, y), sail_scan_line(image, y));
+        }
+
+        sail_destroy_image(image_converted);
+        sail_destroy_image(image);
+
+        /* Arbitrary floats including NaNs and HDR values: the FLOAT -> RGBA64 kernel matches the generic path. */
+        image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, WIDTHS[w], 5);
+
+        struct sail_image *image_reference;
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP48_RGB, &image_reference) == SAIL_OK);
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP64_RGBA, &image_converted) == SAIL_OK);
+
+        for (unsigned y = 0; y < image->height; y++) {
+            const uint16_t *scan           = sail_scan_line(image_converted, y);
+            const uint16_t *scan_reference = sail_scan_line(image_reference, y);
+
+            for (unsigned x = 0; x < image->width; x++) {
+                munit_assert_memory_equal(3 * 2, scan + x * 4, scan_reference + x * 3);
+            }
+        }
+
+        sail_destroy_image(image_converted);
+
+        /* In place FLOAT -> HALF matches FLOAT -> HALF into a new image. */
+        munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF, &image_converted) == SAIL_OK);
+        munit_assert(sail_update_image(image, SAIL_PIXEL_FORMAT_BPP64_RGBA_HALF) == SAIL_OK);
+
+        for (unsigned y = 0; y < image->height; y++) {
+            munit_assert_memory_equal(WIDTHS[w] * 8, sail_scan_line(image, y), sail_scan_line(image_converted, y));
+        }
+
+        sail_destroy_image(image_converted);
+        sail_destroy_image(image_reference);
+        sail_destroy_image(image);
+    }
+
+    /* 8-bit components survive half precision. */
+    image = alloc_test_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 67, 5);
+
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP48_RGB_HALF, &image_converted) == SAIL_OK);
+    munit_assert(sail_update_image(image_converted, SAIL_PIXEL_FORMAT_BPP24_RGB) == SAIL_OK);
+
+    for (unsigned y = 0; y < image->height; y++) {
+        munit_assert_memory_equal(67 * 3, sail_scan_line(image_converted, y), sail_scan_line(image, y));
+    }
+
+    sail_destroy_image(image_converted);
+    sail_destroy_image(image);
+
+    munit_assert_true(sail_can_convert(SAIL_PIXEL_FORMAT_BPP48_RGB_HALF, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE));
+    munit_assert_true(sail_can_convert(SAIL_PIXEL_FORMAT_BPP8_INDEXED, SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT));
+    munit_assert_true(sail_can_convert(SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT, SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420));
+    munit_assert_false(sail_can_convert(SAIL_PIXEL_FORMAT_BPP96, SAIL_PIXEL_FORMAT_BPP128_RGBA_FLOAT));
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/row-kernels",     test_convert_row_kernels,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/blend-alpha",     test_convert_blend_alpha,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/luma",            test_convert_luma,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/parallelism",     test_convert_parallelism,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/update",          test_convert_update,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/indexed",         test_convert_indexed,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/grayscale",       test_convert_grayscale,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/can-convert",     test_convert_can_convert,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/iccp",            test_convert_iccp,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/premultiplied",   test_convert_premultiplied,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/narrow",          test_convert_narrow,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/conversion-plan", test_convert_conversion_plan, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/stats",           test_convert_stats,           NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/planar",          test_convert_planar,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/half-float",      test_convert_half_float,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/convert",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,427 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "munit.h"
+
+static const enum SailOrientation ORIENTATIONS[] = {
+    SAIL_ORIENTATION_NORMAL,
+    SAIL_ORIENTATION_ROTATED_90,
+    SAIL_ORIENTATION_ROTATED_180,
+    SAIL_ORIENTATION_ROTATED_270,
+    SAIL_ORIENTATION_MIRRORED_HORIZONTALLY,
+    SAIL_ORIENTATION_MIRRORED_VERTICALLY,
+    SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90,
+    SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270,
+};
+
+static void save_jpeg(unsigned width, unsigned height, void **buffer, size_t *buffer_size) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = width;
+    image->height         = height;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = sail_bytes_per_line(width, image->pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * height, &image->pixels) == SAIL_OK);
+
+    /* Asymmetric content, so every orientation produces different pixels. */
+    for (unsigned row = 0; row < height; row++) {
+        unsigned char *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < width; column++) {
+            scan[column * 3 + 0] = (unsigned char)(column * 255 / width);
+            scan[column * 3 + 1] = (unsigned char)(row * 255 / height);
+            scan[column * 3 + 2] = (unsigned char)((column < width / 3 && row < height / 4) ? 255 : 0);
+        }
+    }
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("jpg", &codec_info) == SAIL_OK);
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory(codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_saving_into_growable_memory(state, buffer, buffer_size) == SAIL_OK);
+
+    sail_destroy_image(image);
+}
+
+static sail_status_t transcode(const void *buffer, size_t buffer_size, enum SailOrientation orientation, int options,
+                                void **output_buffer, size_t *output_buffer_size) {
+
+    struct sail_io *input;
+    struct sail_io *output;
+    munit_assert(sail_alloc_io_read_memory(buffer, buffer_size, &input) == SAIL_OK);
+    munit_assert(sail_alloc_io_write_growable_memory(&output) == SAIL_OK);
+
+    const sail_status_t status = sail_transcode_jpeg(input, output, orientation, options);
+
+    munit_assert(sail_take_io_growable_memory_buffer(output, output_buffer, output_buffer_size) == SAIL_OK);
+
+    sail_destroy_io(output);
+    sail_destroy_io(input);
+
+    return status;
+}
+
+static struct sail_image* load_jpeg(const void *buffer, size_t buffer_size) {
+
+    struct sail_image *image;
+    munit_assert(sail_load_from_memory(buffer, buffer_size, &image) == SAIL_OK);
+
+    return image;
+}
+
+static unsigned max_difference(const struct sail_image *image1, const struct sail_image *image2) {
+
+    munit_assert_uint(image1->width, ==, image2->width);
+    munit_assert_uint(image1->height, ==, image2->height);
+    munit_assert_int(image1->pixel_format, ==, image2->pixel_format);
+
+    const unsigned row_length = sail_bytes_per_line(image1->width, image1->pixel_format);
+    unsigned result = 0;
+
+    for (unsigned row = 0; row < image1->height; row++) {
+        const unsigned char *scan1 = sail_scan_line(image1, row);
+        const unsigned char *scan2 = sail_scan_line(image2, row);
+
+        for (unsigned i = 0; i < row_length; i++) {
+            const unsigned difference = (unsigned)abs(scan1[i] - scan2[i]);
+            result = difference > result ? difference : result;
+        }
+    }
+
+    return result;
+}
+
+static MunitResult test_transcode_identity(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    void *buffer;
+    size_t buffer_size;
+    save_jpeg(48, 32, &buffer, &buffer_size);
+
+    const int options[] = {
+        0,
+        SAIL_JPEG_TRANSCODE_OPTION_PROGRESSIVE,
+        SAIL_JPEG_TRANSCODE_OPTION_OPTIMIZE_CODING | SAIL_JPEG_TRANSCODE_OPTION_STRIP_META_DATA,
+    };
+
+    struct sail_image *image = load_jpeg(buffer, buffer_size);
+
+    for (size_t i = 0; i < sizeof(options) / sizeof(options[0]); i++) {
+        void *output_buffer;
+        size_t output_buffer_size;
+        const sail_status_t status = transcode(buffer, buffer_size, SAIL_ORIENTATION_NORMAL, options[i],
+                                                &output_buffer, &output_buffer_size);
+
+        if (status == SAIL_ERROR_NOT_IMPLEMENTED) {
+            sail_destroy_image(image);
+            sail_free(buffer);
+            return MUNIT_SKIP;
+        }
+
+        munit_assert(status == SAIL_OK);
+
+        /* The same coefficients decode into the same pixels. */
+        struct sail_image *output_image = load_jpeg(output_buffer, output_buffer_size);
+        munit_assert_uint(max_difference(image, output_image), ==, 0);
+
+        sail_destroy_image(output_image);
+        sail_free(output_buffer);
+    }
+
+    sail_destroy_image(image);
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_transcode_orientations(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Dimensions are multiples of iMCUs, so nothing is trimmed. */
+    void *buffer;
+    size_t buffer_size;
+    save_jpeg(48, 32, &buffer, &buffer_size);
+
+    struct sail_image *image = load_jpeg(buffer, buffer_size);
+
+    for (size_t i = 0; i < sizeof(ORIENTATIONS) / sizeof(ORIENTATIONS[0]); i++) {
+        void *output_buffer;
+        size_t output_buffer_size;
+        const sail_status_t status = transcode(buffer, buffer_size, ORIENTATIONS[i], 0, &output_buffer, &output_buffer_size);
+
+        if (status == SAIL_ERROR_NOT_IMPLEMENTED) {
+            sail_destroy_image(image);
+            sail_free(buffer);
+            return MUNIT_SKIP;
+        }
+
+        munit_assert(status == SAIL_OK);
+
+        struct sail_image *expected_image;
+        munit_assert(sail_copy_image(image, &expected_image) == SAIL_OK);
+
+        switch (ORIENTATIONS[i]) {
+            case SAIL_ORIENTATION_NORMAL: {
+                break;
+            }
+            case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY:
+            case SAIL_ORIENTATION_MIRRORED_VERTICALLY: {
+                munit_assert(sail_mirror(expected_image, ORIENTATIONS[i]) == SAIL_OK);
+                break;
+            }
+            case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90: {
+                munit_assert(sail_mirror(expected_image, SAIL_ORIENTATION_MIRRORED_HORIZONTALLY) == SAIL_OK);
+                munit_assert(sail_rotate(expected_image, SAIL_ORIENTATION_ROTATED_90) == SAIL_OK);
+                break;
+            }
+            case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270: {
+                munit_assert(sail_mirror(expected_image, SAIL_ORIENTATION_MIRRORED_HORIZONTALLY) == SAIL_OK);
+                munit_assert(sail_rotate(expected_image, SAIL_ORIENTATION_ROTATED_270) == SAIL_OK);
+                break;
+            }
+            default: {
+                munit_assert(sail_rotate(expected_image, ORIENTATIONS[i]) == SAIL_OK);
+                break;
+            }
+        }
+
+        /* The IDCT rounds rows and columns differently, so transposed blocks decode slightly differently. */
+        struct sail_image *output_image = load_jpeg(output_buffer, output_buffer_size);
+        munit_assert_uint(max_difference(expected_image, output_image), <=, 4);
+
+        sail_destroy_image(output_image);
+        sail_destroy_image(expected_image);
+        sail_free(output_buffer);
+    }
+
+    sail_destroy_image(image);
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_transcode_trim(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    void *buffer;
+    size_t buffer_size;
+    save_jpeg(45, 29, &buffer, &buffer_size);
+
+    for (size_t i = 0; i < sizeof(ORIENTATIONS) / sizeof(ORIENTATIONS[0]); i++) {
+        void *output_buffer;
+        size_t output_buffer_size;
+        const sail_status_t status = transcode(buffer, buffer_size, ORIENTATIONS[i], 0, &output_buffer, &output_buffer_size);
+
+        if (status == SAIL_ERROR_NOT_IMPLEMENTED) {
+            sail_free(buffer);
+            return MUNIT_SKIP;
+        }
+
+        munit_assert(status == SAIL_OK);
+
+        struct sail_image *output_image = load_jpeg(output_buffer, output_buffer_size);
+
+        const bool transposed = ORIENTATIONS[i] == SAIL_ORIENTATION_ROTATED_90
+                                || ORIENTATIONS[i] == SAIL_ORIENTATION_ROTATED_270
+                                || ORIENTATIONS[i] == SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90
+                                || ORIENTATIONS[i] == SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270;
+        const unsigned width  = transposed ? 29 : 45;
+        const unsigned height = transposed ? 45 : 29;
+
+        /* Flipped dimensions are trimmed to iMCUs of 8 or 16 pixels. */
+        munit_assert_uint(output_image->width, <=, width);
+        munit_assert_uint(output_image->width, >, width - 16);
+        munit_assert_uint(output_image->height, <=, height);
+        munit_assert_uint(output_image->height, >, height - 16);
+
+        if (output_image->width != width) {
+            munit_assert_uint(output_image->width % 8, ==, 0);
+        }
+        if (output_image->height != height) {
+            munit_assert_uint(output_image->height % 8, ==, 0);
+        }
+
+        if (ORIENTATIONS[i] == SAIL_ORIENTATION_NORMAL || ORIENTATIONS[i] == SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270) {
+            munit_assert_uint(output_image->width, ==, width);
+            munit_assert_uint(output_image->height, ==, height);
+        }
+
+        sail_destroy_image(output_image);
+        sail_free(output_buffer);
+    }
+
+    sail_free(buffer);
+
+    /* Flipping images smaller than an iMCU leaves nothing. */
+    save_jpeg(5, 5, &buffer, &buffer_size);
+
+    void *output_buffer;
+    size_t output_buffer_size;
+    munit_assert(transcode(buffer, buffer_size, SAIL_ORIENTATION_ROTATED_180, 0, &output_buffer, &output_buffer_size)
+                    == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    sail_free(output_buffer);
+
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+/* Inserts an EXIF marker with the specified orientation after SOI. */
+static void insert_exif_orientation(const void *buffer, size_t buffer_size, unsigned char orientation,
+                                    void **output_buffer, size_t *output_buffer_size) {
+
+    const unsigned char exif[] = {
+        0xFF, 0xE1, 0x00, 0x22,
+        'E', 'x', 'i', 'f', 0x00, 0x00,
+        'M', 'M', 0x00, 0x2A, 0x00, 0x00, 0x00, 0x08,
+        0x00, 0x01,
+        0x01, 0x12, 0x00, 0x03, 0x00, 0x00, 0x00, 0x01, 0x00, orientation, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+    };
+
+    *output_buffer_size = buffer_size + sizeof(exif);
+    munit_assert(sail_malloc(*output_buffer_size, output_buffer) == SAIL_OK);
+
+    unsigned char *output = *output_buffer;
+    memcpy(output, buffer, 2);
+    memcpy(output + 2, exif, sizeof(exif));
+    memcpy(output + 2 + sizeof(exif), (const unsigned char *)buffer + 2, buffer_size - 2);
+}
+
+static MunitResult test_transcode_auto_orient(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    void *buffer;
+    size_t buffer_size;
+    save_jpeg(48, 32, &buffer, &buffer_size);
+
+    void *exif_buffer;
+    size_t exif_buffer_size;
+    insert_exif_orientation(buffer, buffer_size, 6, &exif_buffer, &exif_buffer_size);
+
+    void *rotated_buffer;
+    size_t rotated_buffer_size;
+    const sail_status_t status = transcode(buffer, buffer_size, SAIL_ORIENTATION_ROTATED_90, 0, &rotated_buffer, &rotated_buffer_size);
+
+    if (status == SAIL_ERROR_NOT_IMPLEMENTED) {
+        sail_free(exif_buffer);
+        sail_free(buffer);
+        return MUNIT_SKIP;
+    }
+
+    munit_assert(status == SAIL_OK);
+
+    /* EXIF orientation 6 means the image must be rotated by 90 degrees clockwise. */
+    void *oriented_buffer;
+    size_t oriented_buffer_size;
+    munit_assert(transcode(exif_buffer, exif_buffer_size, SAIL_ORIENTATION_NORMAL, SAIL_JPEG_TRANSCODE_OPTION_AUTO_ORIENT,
+                            &oriented_buffer, &oriented_buffer_size) == SAIL_OK);
+
+    struct sail_image *rotated_image  = load_jpeg(rotated_buffer, rotated_buffer_size);
+    struct sail_image *oriented_image = load_jpeg(oriented_buffer, oriented_buffer_size);
+    munit_assert_uint(max_difference(rotated_image, oriented_image), ==, 0);
+
+    /* The EXIF orientation is reset to normal. */
+    const unsigned char orientation_entry[] = { 0x01, 0x12, 0x00, 0x03, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01 };
+    bool found = false;
+
+    for (size_t i = 0; i + sizeof(orientation_entry) <= oriented_buffer_size; i++) {
+        if (memcmp((const unsigned char *)oriented_buffer + i, orientation_entry, sizeof(orientation_entry)) == 0) {
+            found = true;
+            break;
+        }
+    }
+
+    munit_assert_true(found);
+
+    sail_destroy_image(oriented_image);
+    sail_destroy_image(rotated_image);
+    sail_free(oriented_buffer);
+    sail_free(rotated_buffer);
+    sail_free(exif_buffer);
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_transcode_errors(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_write_growable_memory(&io) == SAIL_OK);
+
+    munit_assert(sail_transcode_jpeg(NULL, io, SAIL_ORIENTATION_NORMAL, 0) == SAIL_ERROR_NULL_PTR);
+    munit_assert(sail_transcode_jpeg(io, NULL, SAIL_ORIENTATION_NORMAL, 0) == SAIL_ERROR_NULL_PTR);
+
+    const sail_status_t status = sail_transcode_jpeg(io, io, (enum SailOrientation)100, 0);
+    munit_assert(status == SAIL_ERROR_INVALID_ARGUMENT || status == SAIL_ERROR_NOT_IMPLEMENTED);
+
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/identity",     test_transcode_identity,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/orientations", test_transcode_orientations, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/trim",         test_transcode_trim,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/auto-orient",  test_transcode_auto_orient,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/errors",       test_transcode_errors,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/jpeg-transcode",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
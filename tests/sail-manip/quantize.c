@@ -0,0 +1,232 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+static const enum SailDither DITHERS[] = {
+    SAIL_DITHER_NONE,
+    SAIL_DITHER_FLOYD_STEINBERG,
+    SAIL_DITHER_ORDERED,
+};
+
+/* Smooth RGB gradient. */
+static struct sail_image* alloc_gradient(unsigned width, unsigned height) {
+
+    struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, width, height);
+
+    for (unsigned row = 0; row < height; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < width; column++) {
+            scan[column * 4 + 0] = (uint8_t)(column * 255 / (width - 1));
+            scan[column * 4 + 1] = (uint8_t)(row * 255 / (height - 1));
+            scan[column * 4 + 2] = (uint8_t)((column + row) * 255 / (width + height - 2));
+            scan[column * 4 + 3] = 255;
+        }
+    }
+
+    return image;
+}
+
+static const uint8_t* palette_color(const struct sail_image *image, unsigned row, unsigned column) {
+
+    const unsigned index = ((const uint8_t *)sail_scan_line(image, row))[column];
+    const unsigned entry_size = (image->palette->pixel_format == SAIL_PIXEL_FORMAT_BPP24_RGB) ? 3 : 4;
+
+    munit_assert_uint(index, <, image->palette->color_count);
+
+    return (const uint8_t *)image->palette->data + index * entry_size;
+}
+
+static MunitResult test_quantize_exact(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* Fewer colors than the palette size are reproduced exactly without ordered dithering. */
+    static const uint8_t COLORS[][3] = { { 255, 0, 0 }, { 0, 128, 0 }, { 10, 20, 200 }, { 250, 250, 250 } };
+    static const enum SailDither EXACT_DITHERS[] = { SAIL_DITHER_NONE, SAIL_DITHER_FLOYD_STEINBERG };
+
+    for (size_t d = 0; d < sizeof(EXACT_DITHERS) / sizeof(EXACT_DITHERS[0]); d++) {
+        struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_BGR, 19, 7);
+
+        for (unsigned row = 0; row < image->height; row++) {
+            uint8_t *scan = sail_scan_line(image, row);
+
+            for (unsigned column = 0; column < image->width; column++) {
+                const uint8_t *color = COLORS[(row + column) % 4];
+
+                scan[column * 3 + 0] = color[2];
+                scan[column * 3 + 1] = color[1];
+                scan[column * 3 + 2] = color[0];
+            }
+        }
+
+        struct sail_image *image_output;
+        munit_assert(sail_quantize_image(image, 16, EXACT_DITHERS[d], &image_output) == SAIL_OK);
+
+        munit_assert_int(image_output->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP8_INDEXED);
+        munit_assert_uint(image_output->bytes_per_line, ==, 19);
+        munit_assert_not_null(image_output->palette);
+        munit_assert_int(image_output->palette->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP24_RGB);
+        munit_assert_uint(image_output->palette->color_count, ==, 4);
+
+        for (unsigned row = 0; row < image->height; row++) {
+            for (unsigned column = 0; column < image->width; column++) {
+                munit_assert_memory_equal(3, palette_color(image_output, row, column), COLORS[(row + column) % 4]);
+            }
+        }
+
+        sail_destroy_image(image_output);
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_quantize_alpha(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 8, 8);
+
+    for (unsigned i = 0; i < 64; i++) {
+        const uint8_t pixel[4] = { 100, 150, 200, (i % 2 == 0) ? 255 : 0 };
+        memcpy((uint8_t *)image->pixels + i * 4, pixel, 4);
+    }
+
+    struct sail_image *image_output;
+    munit_assert(sail_quantize_image(image, 256, SAIL_DITHER_NONE, &image_output) == SAIL_OK);
+
+    munit_assert_int(image_output->palette->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP32_RGBA);
+    munit_assert_uint(image_output->palette->color_count, ==, 2);
+
+    for (unsigned i = 0; i < 64; i++) {
+        munit_assert_uint8(palette_color(image_output, i / 8, i % 8)[3], ==, (i % 2 == 0) ? 255 : 0);
+    }
+
+    sail_destroy_image(image_output);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_quantize_gradient(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    /* The small image is mapped serially, the large one in parallel. */
+    const unsigned sizes[][2] = { { 64, 48 }, { 300, 256 } };
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        struct sail_image *image = alloc_gradient(sizes[s][0], sizes[s][1]);
+
+        for (size_t d = 0; d < sizeof(DITHERS) / sizeof(DITHERS[0]); d++) {
+            struct sail_image *image_output;
+            munit_assert(sail_quantize_image(image, 16, DITHERS[d], &image_output) == SAIL_OK);
+
+            munit_assert_uint(image_output->palette->color_count, ==, 16);
+
+            /* Average colors are preserved. */
+            uint64_t sums[3] = { 0, 0, 0 };
+            uint64_t sums_output[3] = { 0, 0, 0 };
+
+            for (unsigned row = 0; row < image->height; row++) {
+                const uint8_t *scan = sail_scan_line(image, row);
+
+                for (unsigned column = 0; column < image->width; column++) {
+                    const uint8_t *color = palette_color(image_output, row, column);
+
+                    for (unsigned c = 0; c < 3; c++) {
+                        sums[c] += scan[column * 4 + c];
+                        sums_output[c] += color[c];
+                    }
+                }
+            }
+
+            const uint64_t pixels = (uint64_t)image->width * image->height;
+
+            for (unsigned c = 0; c < 3; c++) {
+                munit_assert_int(abs((int)(sums[c] / pixels) - (int)(sums_output[c] / pixels)), <=, 8);
+            }
+
+            sail_destroy_image(image_output);
+        }
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_quantize_errors(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = alloc_gradient(8, 8);
+    struct sail_image *image_output;
+
+    munit_assert(sail_quantize_image(image, 0, SAIL_DITHER_NONE, &image_output) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert(sail_quantize_image(image, 257, SAIL_DITHER_NONE, &image_output) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert(sail_quantize_image(image, 16, (enum SailDither)100, &image_output) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert(sail_quantize_image(image, 16, SAIL_DITHER_NONE, NULL) == SAIL_ERROR_NULL_PTR);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/exact",    test_quantize_exact,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/alpha",    test_quantize_alpha,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/gradient", test_quantize_gradient, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/errors",   test_quantize_errors,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/quantize",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,255 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+#include <sail-manip/sail-manip.h>
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+static const enum SailScaleFilter FILTERS[] = {
+    SAIL_SCALE_FILTER_BOX,
+    SAIL_SCALE_FILTER_BILINEAR,
+    SAIL_SCALE_FILTER_BICUBIC,
+    SAIL_SCALE_FILTER_LANCZOS3,
+    SAIL_SCALE_FILTER_AREA,
+};
+
+static MunitResult test_scale_flat(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const enum SailPixelFormat pixel_formats[] = {
+        SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE_ALPHA,
+        SAIL_PIXEL_FORMAT_BPP24_RGB,
+        SAIL_PIXEL_FORMAT_BPP32_RGBA,
+        SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP48_RGB,
+        SAIL_PIXEL_FORMAT_BPP64_RGBA,
+    };
+
+    /* Odd sizes exercise the tails of SIMD loops. */
+    const unsigned sizes[][2] = { { 1, 1 }, { 7, 3 }, { 13, 21 }, { 37, 37 }, { 61, 5 }, { 100, 2 } };
+
+    for (size_t p = 0; p < sizeof(pixel_formats) / sizeof(pixel_formats[0]); p++) {
+        struct sail_image *image = sail_test_alloc_image(pixel_formats[p], 29, 23);
+
+        /* Weights sum to 1.0 exactly, so flat images stay flat with every filter. */
+        memset(image->pixels, 0xA7, (size_t)image->bytes_per_line * image->height);
+
+        for (size_t f = 0; f < sizeof(FILTERS) / sizeof(FILTERS[0]); f++) {
+            for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+                struct sail_image *image_output;
+                munit_assert(sail_scale_image(image, sizes[s][0], sizes[s][1], FILTERS[f], &image_output) == SAIL_OK);
+
+                munit_assert_uint(image_output->width, ==, sizes[s][0]);
+                munit_assert_uint(image_output->height, ==, sizes[s][1]);
+                munit_assert_int(image_output->pixel_format, ==, pixel_formats[p]);
+                munit_assert_uint(image_output->bytes_per_line, ==, sail_bytes_per_line(sizes[s][0], pixel_formats[p]));
+
+                for (unsigned row = 0; row < image_output->height; row++) {
+                    const uint8_t *scan = sail_scan_line(image_output, row);
+
+                    for (unsigned i = 0; i < image_output->bytes_per_line; i++) {
+                        munit_assert_uint8(scan[i], ==, 0xA7);
+                    }
+                }
+
+                sail_destroy_image(image_output);
+            }
+        }
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_scale_box_halves(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const enum SailPixelFormat pixel_formats[] = {
+        SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,
+        SAIL_PIXEL_FORMAT_BPP24_RGB,
+        SAIL_PIXEL_FORMAT_BPP32_BGRA,
+    };
+
+    for (size_t p = 0; p < sizeof(pixel_formats) / sizeof(pixel_formats[0]); p++) {
+        const unsigned components = sail_bits_per_pixel(pixel_formats[p]) / 8;
+        struct sail_image *image = sail_test_alloc_image(pixel_formats[p], 46, 10);
+
+        /* Pixels 2N and 2N+1 are 4N and 4N+2 horizontally, rows add 0 or 2. */
+        for (unsigned row = 0; row < image->height; row++) {
+            uint8_t *scan = sail_scan_line(image, row);
+
+            for (unsigned column = 0; column < image->width; column++) {
+                for (unsigned c = 0; c < components; c++) {
+                    scan[column * components + c] = (uint8_t)(column * 2 + (row % 2) * 2 + c);
+                }
+            }
+        }
+
+        for (size_t f = 0; f < 2; f++) {
+            const enum SailScaleFilter filter = (f == 0) ? SAIL_SCALE_FILTER_BOX : SAIL_SCALE_FILTER_AREA;
+
+            struct sail_image *image_output;
+            munit_assert(sail_scale_image(image, 23, 5, filter, &image_output) == SAIL_OK);
+
+            for (unsigned row = 0; row < image_output->height; row++) {
+                const uint8_t *scan = sail_scan_line(image_output, row);
+
+                for (unsigned column = 0; column < image_output->width; column++) {
+                    for (unsigned c = 0; c < components; c++) {
+                        munit_assert_uint8(scan[column * components + c], ==, (uint8_t)(column * 4 + 2 + c));
+                    }
+                }
+            }
+
+            sail_destroy_image(image_output);
+        }
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_scale_same_size(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 9, 4);
+
+    for (size_t i = 0; i < (size_t)image->bytes_per_line * image->height; i++) {
+        ((uint8_t *)image->pixels)[i] = (uint8_t)(i * 7);
+    }
+
+    struct sail_image *image_output;
+    munit_assert(sail_scale_image(image, 9, 4, SAIL_SCALE_FILTER_LANCZOS3, &image_output) == SAIL_OK);
+    munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image_output->pixels, image->pixels);
+
+    sail_destroy_image(image_output);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_scale_file_backed(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image_heap = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 40, 30);
+
+    for (size_t i = 0; i < (size_t)image_heap->bytes_per_line * image_heap->height; i++) {
+        ((uint8_t *)image_heap->pixels)[i] = (uint8_t)(i * 7);
+    }
+
+    struct sail_image *image;
+    munit_assert(sail_copy_image_skeleton(image_heap, &image) == SAIL_OK);
+    munit_assert(sail_alloc_image_pixels(image, true) == SAIL_OK);
+    munit_assert_size(image->pixels_file_backed_size, ==, (size_t)image->bytes_per_line * image->height);
+    memcpy(image->pixels, image_heap->pixels, image->pixels_file_backed_size);
+
+    /* Results of file-backed images are file-backed and equal to the results of heap images. */
+    struct sail_image *image_output;
+    struct sail_image *image_output_heap;
+    munit_assert(sail_scale_image(image, 17, 11, SAIL_SCALE_FILTER_BILINEAR, &image_output) == SAIL_OK);
+    munit_assert(sail_scale_image(image_heap, 17, 11, SAIL_SCALE_FILTER_BILINEAR, &image_output_heap) == SAIL_OK);
+    munit_assert_size(image_output->pixels_file_backed_size, >, 0);
+    munit_assert_size(image_output_heap->pixels_file_backed_size, ==, 0);
+    munit_assert_memory_equal((size_t)image_output->bytes_per_line * image_output->height, image_output->pixels, image_output_heap->pixels);
+    sail_destroy_image(image_output_heap);
+    sail_destroy_image(image_output);
+
+    munit_assert(sail_convert_image(image, SAIL_PIXEL_FORMAT_BPP24_RGB, &image_output) == SAIL_OK);
+    munit_assert_size(image_output->pixels_file_backed_size, >, 0);
+    sail_destroy_image(image_output);
+
+    sail_destroy_image(image);
+    sail_destroy_image(image_heap);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_scale_errors(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    struct sail_image *image_output;
+
+    {
+        struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 8, 8);
+
+        munit_assert(sail_scale_image(image, 0, 8, SAIL_SCALE_FILTER_BOX, &image_output) == SAIL_ERROR_INVALID_ARGUMENT);
+        munit_assert(sail_scale_image(image, 8, 0, SAIL_SCALE_FILTER_BOX, &image_output) == SAIL_ERROR_INVALID_ARGUMENT);
+        munit_assert(sail_scale_image(image, 4, 4, (enum SailScaleFilter)100, &image_output) == SAIL_ERROR_INVALID_ARGUMENT);
+        munit_assert(sail_scale_image(image, 4, 4, SAIL_SCALE_FILTER_BOX, NULL) == SAIL_ERROR_NULL_PTR);
+
+        sail_destroy_image(image);
+    }
+
+    {
+        struct sail_image *image = sail_test_alloc_image(SAIL_PIXEL_FORMAT_BPP16_RGB565, 8, 8);
+
+        munit_assert(sail_scale_image(image, 4, 4, SAIL_SCALE_FILTER_BOX, &image_output) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/flat",        test_scale_flat,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/box-halves",  test_scale_box_halves,  NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/same-size",   test_scale_same_size,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/file-backed", test_scale_file_backed, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/errors",      test_scale_errors,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/scale",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,218 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+struct load_result {
+    sail_status_t status;
+    struct sail_image *image;
+    unsigned calls;
+};
+
+static void load_callback(sail_status_t status, struct sail_image *image, void *user_data) {
+
+    struct load_result *load_result = user_data;
+
+    load_result->status = status;
+    load_result->image  = image;
+    load_result->calls++;
+}
+
+struct save_result {
+    sail_status_t status;
+    unsigned calls;
+};
+
+static void save_callback(sail_status_t status, void *user_data) {
+
+    struct save_result *save_result = user_data;
+
+    save_result->status = status;
+    save_result->calls++;
+}
+
+static size_t test_images_count(void) {
+
+    size_t count = 0;
+
+    while (SAIL_TEST_IMAGES[count] != NULL) {
+        count++;
+    }
+
+    return count;
+}
+
+static void assert_images_equal(const struct sail_image *image1, const struct sail_image *image2) {
+
+    munit_assert_uint(image1->width, ==, image2->width);
+    munit_assert_uint(image1->height, ==, image2->height);
+    munit_assert(image1->pixel_format == image2->pixel_format);
+    munit_assert_uint(image1->bytes_per_line, ==, image2->bytes_per_line);
+    munit_assert_memory_equal((size_t)image1->bytes_per_line * image1->height, image1->pixels, image2->pixels);
+}
+
+static MunitResult test_load(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const size_t count = test_images_count();
+
+    if (count == 0) {
+        return MUNIT_SKIP;
+    }
+
+    sail_set_thread_pool_size((unsigned)atoi(munit_parameters_get(params, "threads")));
+
+    struct sail_io **ios = munit_newa(struct sail_io *, count);
+    struct load_result *load_results = munit_newa(struct load_result, count);
+
+    for (size_t i = 0; i < count; i++) {
+        load_results[i] = (struct load_result) { SAIL_ERROR_NOT_IMPLEMENTED, NULL, 0 };
+
+        const struct sail_codec_info *codec_info;
+        munit_assert(sail_codec_info_from_path(SAIL_TEST_IMAGES[i], &codec_info) == SAIL_OK);
+
+        munit_assert(sail_alloc_io_read_file(SAIL_TEST_IMAGES[i], &ios[i]) == SAIL_OK);
+        munit_assert(sail_load_async(ios[i], codec_info, NULL, load_callback, &load_results[i]) == SAIL_OK);
+    }
+
+    /* Runs the queued operations and waits for the running ones. */
+    sail_finish_thread_pool();
+
+    for (size_t i = 0; i < count; i++) {
+        munit_assert_uint(load_results[i].calls, ==, 1);
+        munit_assert(load_results[i].status == SAIL_OK);
+
+        struct sail_image *image;
+        munit_assert(sail_load_from_file(SAIL_TEST_IMAGES[i], &image) == SAIL_OK);
+
+        assert_images_equal(load_results[i].image, image);
+
+        sail_destroy_image(image);
+        sail_destroy_image(load_results[i].image);
+        sail_destroy_io(ios[i]);
+    }
+
+    free(load_results);
+    free(ios);
+
+    sail_set_thread_pool_size(0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_save(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    sail_set_thread_pool_size((unsigned)atoi(munit_parameters_get(params, "threads")));
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = 16;
+    image->height         = 16;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    for (size_t i = 0; i < (size_t)image->bytes_per_line * image->height; i++) {
+        ((unsigned char *)image->pixels)[i] = (unsigned char)(i * 3);
+    }
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_write_growable_memory(&io) == SAIL_OK);
+
+    struct save_result save_result = { SAIL_ERROR_NOT_IMPLEMENTED, 0 };
+    munit_assert(sail_save_async(io, codec_info, NULL, image, save_callback, &save_result) == SAIL_OK);
+
+    sail_finish_thread_pool();
+
+    munit_assert_uint(save_result.calls, ==, 1);
+    munit_assert(save_result.status == SAIL_OK);
+
+    void *buffer;
+    size_t buffer_size;
+    munit_assert(sail_take_io_growable_memory_buffer(io, &buffer, &buffer_size) == SAIL_OK);
+    sail_destroy_io(io);
+
+    /* Load the saved image back asynchronously detecting the codec by the magic number. */
+    munit_assert(sail_alloc_io_read_memory(buffer, buffer_size, &io) == SAIL_OK);
+
+    struct load_result load_result = { SAIL_ERROR_NOT_IMPLEMENTED, NULL, 0 };
+    munit_assert(sail_load_async(io, NULL, NULL, load_callback, &load_result) == SAIL_OK);
+
+    sail_finish_thread_pool();
+
+    munit_assert_uint(load_result.calls, ==, 1);
+    munit_assert(load_result.status == SAIL_OK);
+    assert_images_equal(load_result.image, image);
+
+    sail_destroy_image(load_result.image);
+    sail_destroy_io(io);
+    sail_free(buffer);
+    sail_destroy_image(image);
+
+    sail_set_thread_pool_size(0);
+
+    return MUNIT_OK;
+}
+
+static char *threads_params[] = { (char *)"1", (char *)"4", NULL };
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"threads", threads_params },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/load", test_load, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/save", test_save, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/async",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
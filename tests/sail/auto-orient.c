@@ -0,0 +1,324 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+/* SailOrientation of every EXIF orientation value. */
+static const enum SailOrientation EXIF_ORIENTATIONS[] = {
+    SAIL_ORIENTATION_NORMAL,
+    SAIL_ORIENTATION_NORMAL,
+    SAIL_ORIENTATION_MIRRORED_HORIZONTALLY,
+    SAIL_ORIENTATION_ROTATED_180,
+    SAIL_ORIENTATION_MIRRORED_VERTICALLY,
+    SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270,
+    SAIL_ORIENTATION_ROTATED_90,
+    SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90,
+    SAIL_ORIENTATION_ROTATED_270,
+};
+
+/* Saves a JPEG with the specified EXIF orientation value. */
+static void save_jpeg(enum SailPixelFormat pixel_format, unsigned char orientation, void **buffer, size_t *buffer_size) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = 48;
+    image->height         = 24;
+    image->pixel_format   = pixel_format;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    /* Asymmetric content, so every orientation produces different pixels. */
+    const unsigned bytes_per_pixel = image->bytes_per_line / image->width;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        unsigned char *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            for (unsigned i = 0; i < bytes_per_pixel; i++) {
+                scan[column * bytes_per_pixel + i] = (unsigned char)((column * 5 + row * 3 * (i + 1)) & 0xFF);
+            }
+        }
+    }
+
+    const unsigned char exif[] = {
+        'E', 'x', 'i', 'f', 0x00, 0x00,
+        'I', 'I', 0x2A, 0x00, 0x08, 0x00, 0x00, 0x00,
+        0x01, 0x00,
+        0x12, 0x01, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, orientation, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+    };
+
+    munit_assert(sail_alloc_meta_data_node(&image->meta_data_node) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_and_value_from_known_key(SAIL_META_DATA_EXIF, &image->meta_data_node->meta_data) == SAIL_OK);
+    munit_assert(sail_set_variant_data(image->meta_data_node->meta_data->value, exif, sizeof(exif)) == SAIL_OK);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("jpg", &codec_info) == SAIL_OK);
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory(codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_saving_into_growable_memory(state, buffer, buffer_size) == SAIL_OK);
+
+    sail_destroy_image(image);
+}
+
+static struct sail_image* load_jpeg(const void *buffer, size_t buffer_size, const struct sail_load_options *load_options) {
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("jpg", &codec_info) == SAIL_OK);
+
+    void *state;
+    munit_assert(sail_start_loading_from_memory_with_options(buffer, buffer_size, codec_info, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    return image;
+}
+
+static struct sail_load_options* alloc_load_options(int options) {
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+    load_options->options = options;
+
+    return load_options;
+}
+
+/* Orients the image with sail-common the same way the codec should. */
+static void orient(struct sail_image *image, enum SailOrientation orientation) {
+
+    switch (orientation) {
+        case SAIL_ORIENTATION_NORMAL: {
+            break;
+        }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY:
+        case SAIL_ORIENTATION_MIRRORED_VERTICALLY: {
+            munit_assert(sail_mirror(image, orientation) == SAIL_OK);
+            break;
+        }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_90: {
+            munit_assert(sail_mirror(image, SAIL_ORIENTATION_MIRRORED_HORIZONTALLY) == SAIL_OK);
+            munit_assert(sail_rotate(image, SAIL_ORIENTATION_ROTATED_90) == SAIL_OK);
+            break;
+        }
+        case SAIL_ORIENTATION_MIRRORED_HORIZONTALLY_ROTATED_270: {
+            munit_assert(sail_mirror(image, SAIL_ORIENTATION_MIRRORED_HORIZONTALLY) == SAIL_OK);
+            munit_assert(sail_rotate(image, SAIL_ORIENTATION_ROTATED_270) == SAIL_OK);
+            break;
+        }
+        default: {
+            munit_assert(sail_rotate(image, orientation) == SAIL_OK);
+            break;
+        }
+    }
+}
+
+static void assert_images_equal(const struct sail_image *image1, const struct sail_image *image2) {
+
+    munit_assert_uint(image1->width, ==, image2->width);
+    munit_assert_uint(image1->height, ==, image2->height);
+    munit_assert_int(image1->pixel_format, ==, image2->pixel_format);
+
+    const unsigned row_length = sail_bytes_per_line(image1->width, image1->pixel_format);
+
+    for (unsigned row = 0; row < image1->height; row++) {
+        munit_assert_memory_equal(row_length, sail_scan_line(image1, row), sail_scan_line(image2, row));
+    }
+}
+
+static enum SailPixelFormat pixel_format_from_params(const MunitParameter params[]) {
+
+    return strcmp(munit_parameters_get(params, "pixel-format"), "gray") == 0
+            ? SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE
+            : SAIL_PIXEL_FORMAT_BPP24_RGB;
+}
+
+static MunitResult test_auto_orient(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const enum SailPixelFormat pixel_format = pixel_format_from_params(params);
+
+    struct sail_load_options *load_options = alloc_load_options(SAIL_OPTION_SOURCE_IMAGE);
+    struct sail_load_options *auto_orient_load_options = alloc_load_options(SAIL_OPTION_SOURCE_IMAGE | SAIL_OPTION_AUTO_ORIENT);
+
+    for (unsigned char value = 1; value <= 8; value++) {
+        void *buffer;
+        size_t buffer_size;
+        save_jpeg(pixel_format, value, &buffer, &buffer_size);
+
+        /* The orientation is reported when it's not applied. */
+        struct sail_image *expected_image = load_jpeg(buffer, buffer_size, load_options);
+        munit_assert_int(expected_image->source_image->orientation, ==, EXIF_ORIENTATIONS[value]);
+        orient(expected_image, EXIF_ORIENTATIONS[value]);
+
+        struct sail_image *image = load_jpeg(buffer, buffer_size, auto_orient_load_options);
+        munit_assert_int(image->source_image->orientation, ==, SAIL_ORIENTATION_NORMAL);
+        assert_images_equal(expected_image, image);
+
+        sail_destroy_image(image);
+        sail_destroy_image(expected_image);
+        sail_free(buffer);
+    }
+
+    sail_destroy_load_options(auto_orient_load_options);
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_auto_orient_roi(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const enum SailPixelFormat pixel_format = pixel_format_from_params(params);
+
+    struct sail_load_options *load_options = alloc_load_options(SAIL_OPTION_AUTO_ORIENT);
+    struct sail_load_options *roi_load_options = alloc_load_options(SAIL_OPTION_AUTO_ORIENT);
+
+    /* The region is in oriented coordinates. */
+    roi_load_options->roi = (struct sail_roi) { 3, 5, 11, 17 };
+
+    for (unsigned char value = 1; value <= 8; value++) {
+        void *buffer;
+        size_t buffer_size;
+        save_jpeg(pixel_format, value, &buffer, &buffer_size);
+
+        struct sail_image *full_image = load_jpeg(buffer, buffer_size, load_options);
+        struct sail_image *image = load_jpeg(buffer, buffer_size, roi_load_options);
+
+        munit_assert_uint(image->width, ==, 11);
+        munit_assert_uint(image->height, ==, 17);
+        munit_assert_int(image->pixel_format, ==, full_image->pixel_format);
+
+        const unsigned bytes_per_pixel = full_image->bytes_per_line / full_image->width;
+
+        for (unsigned row = 0; row < image->height; row++) {
+            munit_assert_memory_equal(image->width * bytes_per_pixel,
+                                        sail_scan_line(image, row),
+                                        (const unsigned char *)sail_scan_line(full_image, row + 5) + 3 * bytes_per_pixel);
+        }
+
+        sail_destroy_image(image);
+        sail_destroy_image(full_image);
+        sail_free(buffer);
+    }
+
+    sail_destroy_load_options(roi_load_options);
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+struct rows {
+    unsigned char *pixels;
+    size_t bytes_per_line;
+};
+
+static sail_status_t copy_row(const struct sail_image *image, unsigned row, const void *scan_line, void *user_data) {
+
+    struct rows *rows = user_data;
+
+    memcpy(rows->pixels + row * rows->bytes_per_line, scan_line, sail_bytes_per_line(image->width, image->pixel_format));
+
+    return SAIL_OK;
+}
+
+static MunitResult test_auto_orient_row_callback(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const enum SailPixelFormat pixel_format = pixel_format_from_params(params);
+
+    struct sail_load_options *load_options = alloc_load_options(SAIL_OPTION_AUTO_ORIENT);
+    struct sail_load_options *row_load_options = alloc_load_options(SAIL_OPTION_AUTO_ORIENT);
+
+    struct rows rows;
+    row_load_options->row_callback           = copy_row;
+    row_load_options->row_callback_user_data = &rows;
+
+    for (unsigned char value = 1; value <= 8; value++) {
+        void *buffer;
+        size_t buffer_size;
+        save_jpeg(pixel_format, value, &buffer, &buffer_size);
+
+        struct sail_image *expected_image = load_jpeg(buffer, buffer_size, load_options);
+
+        rows.bytes_per_line = expected_image->bytes_per_line;
+        void *ptr;
+        munit_assert(sail_malloc(rows.bytes_per_line * expected_image->height, &ptr) == SAIL_OK);
+        rows.pixels = ptr;
+
+        /* Rows are passed in the oriented order. */
+        struct sail_image *image = load_jpeg(buffer, buffer_size, row_load_options);
+        munit_assert_null(image->pixels);
+        munit_assert_uint(image->width, ==, expected_image->width);
+        munit_assert_uint(image->height, ==, expected_image->height);
+        munit_assert_memory_equal(rows.bytes_per_line * expected_image->height, rows.pixels, expected_image->pixels);
+
+        sail_free(rows.pixels);
+        sail_destroy_image(image);
+        sail_destroy_image(expected_image);
+        sail_free(buffer);
+    }
+
+    sail_destroy_load_options(row_load_options);
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static char *pixel_format_params[] = { (char *)"gray", (char *)"rgb", NULL };
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"pixel-format", pixel_format_params },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/auto-orient",              test_auto_orient,              NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/auto-orient-roi",          test_auto_orient_roi,          NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/auto-orient-row-callback", test_auto_orient_row_callback, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/auto-orient",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
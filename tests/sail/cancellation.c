@@ -0,0 +1,198 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+/* Cancels the token passed in user data after the first row. */
+static sail_status_t cancel_load_after_first_row(const struct sail_image *image, unsigned row, const void *scan_line, void *user_data) {
+
+    (void)image;
+    (void)row;
+    (void)scan_line;
+
+    sail_cancel(user_data);
+
+    return SAIL_OK;
+}
+
+static sail_status_t cancel_save_after_first_row(const struct sail_image *image, unsigned row, void *scan_line, void *user_data) {
+
+    const struct sail_image *source_image = ((void **)user_data)[0];
+
+    munit_assert_uint(image->bytes_per_line, ==, source_image->bytes_per_line);
+    memcpy(scan_line, sail_scan_line(source_image, row), source_image->bytes_per_line);
+
+    sail_cancel(((void **)user_data)[1]);
+
+    return SAIL_OK;
+}
+
+static MunitResult test_load(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    struct sail_cancellation cancellation = { 0 };
+    load_options->cancellation = &cancellation;
+
+    /* A token that is not cancelled doesn't affect loading. */
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    const unsigned height = image->height;
+    sail_destroy_image(image);
+
+    /* A cancelled token stops loading before the codec is called. */
+    sail_cancel(&cancellation);
+
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+    image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_ERROR_CANCELLED);
+    munit_assert_null(image);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    /* So does a passed deadline. */
+    cancellation = (struct sail_cancellation) { 0 };
+    cancellation.deadline = 1;
+
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_ERROR_CANCELLED);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    /* Loading stops in the middle of the frame. */
+    if (height > 1) {
+        cancellation = (struct sail_cancellation) { 0 };
+
+        load_options->row_callback           = cancel_load_after_first_row;
+        load_options->row_callback_user_data = &cancellation;
+
+        munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+        munit_assert(sail_load_next_frame(state, &image) == SAIL_ERROR_CANCELLED);
+        munit_assert(sail_stop_loading(state) == SAIL_OK);
+    }
+
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_save(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    bool can_save = false;
+
+    for (unsigned i = 0; i < codec_info->save_features->pixel_formats_length; i++) {
+        if (codec_info->save_features->pixel_formats[i] == image->pixel_format) {
+            can_save = true;
+            break;
+        }
+    }
+
+    if (!can_save) {
+        sail_destroy_image(image);
+        return MUNIT_SKIP;
+    }
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+
+    struct sail_cancellation cancellation = { 0 };
+    save_options->cancellation = &cancellation;
+    sail_cancel(&cancellation);
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory_with_options(codec_info, save_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_ERROR_CANCELLED);
+    sail_stop_saving(state);
+
+    /* Saving stops in the middle of the frame. */
+    if (image->height > 1) {
+        cancellation = (struct sail_cancellation) { 0 };
+
+        void *context[] = { image, &cancellation };
+
+        struct sail_image image_rows = *image;
+        image_rows.pixels = NULL;
+
+        save_options->row_callback           = cancel_save_after_first_row;
+        save_options->row_callback_user_data = context;
+
+        munit_assert(sail_start_saving_into_growable_memory_with_options(codec_info, save_options, &state) == SAIL_OK);
+        munit_assert(sail_write_next_frame(state, &image_rows) == SAIL_ERROR_CANCELLED);
+        sail_stop_saving(state);
+    }
+
+    sail_destroy_save_options(save_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/load", test_load, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/save", test_save, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/cancellation",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
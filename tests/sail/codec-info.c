@@ -0,0 +1,181 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <ctype.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_magic_number_matches_extension(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info_by_path;
+    munit_assert(sail_codec_info_from_path(path, &codec_info_by_path) == SAIL_OK);
+
+    /* Some codecs have no magic numbers at all. */
+    if (codec_info_by_path->magic_number_node == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    const struct sail_codec_info *codec_info_by_magic;
+    munit_assert(sail_codec_info_by_magic_number_from_path(path, &codec_info_by_magic) == SAIL_OK);
+
+    munit_assert_ptr_equal(codec_info_by_magic, codec_info_by_path);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_magic_number_not_found(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    unsigned char buffer[SAIL_MAGIC_BUFFER_SIZE];
+    memset(buffer, 0, sizeof(buffer));
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_by_magic_number_from_memory(buffer, sizeof(buffer), &codec_info) == SAIL_ERROR_CODEC_NOT_FOUND);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_sniff(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info_by_path;
+    munit_assert(sail_codec_info_from_path(path, &codec_info_by_path) == SAIL_OK);
+
+    if (codec_info_by_path->magic_number_node == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &data, &data_size) == SAIL_OK);
+
+    const struct sail_codec_info *codec_info_by_sniff;
+    unsigned confidence;
+    munit_assert(sail_codec_info_sniff_from_memory(data, data_size, &codec_info_by_sniff, &confidence) == SAIL_OK);
+    munit_assert_ptr_equal(codec_info_by_sniff, codec_info_by_path);
+    munit_assert_uint(confidence, >, 0);
+
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_sniff_not_found(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    unsigned char buffer[SAIL_MAGIC_BUFFER_SIZE];
+    memset(buffer, 0, sizeof(buffer));
+
+    const struct sail_codec_info *codec_info;
+    unsigned confidence;
+    munit_assert(sail_codec_info_sniff_from_memory(buffer, sizeof(buffer), &codec_info, &confidence) == SAIL_ERROR_CODEC_NOT_FOUND);
+    munit_assert(sail_codec_info_sniff_from_memory(buffer, 0, &codec_info, NULL) == SAIL_ERROR_CODEC_NOT_FOUND);
+
+    /* Short prefixes still match. */
+    const unsigned char png_prefix[] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+    if (sail_codec_info_from_extension("png", &codec_info) == SAIL_OK) {
+        const struct sail_codec_info *codec_info_by_sniff;
+        munit_assert(sail_codec_info_sniff_from_memory(png_prefix, sizeof(png_prefix), &codec_info_by_sniff, &confidence) == SAIL_OK);
+        munit_assert_ptr_equal(codec_info_by_sniff, codec_info);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_extension_and_mime_type(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    for (const struct sail_codec_bundle_node *codec_bundle_node = sail_codec_bundle_list(); codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
+        const struct sail_codec_info *codec_info = codec_bundle_node->codec_bundle->codec_info;
+
+        for (const struct sail_string_node *node = codec_info->extension_node; node != NULL; node = node->next) {
+            const struct sail_codec_info *found_codec_info;
+            munit_assert(sail_codec_info_from_extension(node->string, &found_codec_info) == SAIL_OK);
+            munit_assert_string_equal(found_codec_info->name, codec_info->name);
+
+            /* Case-insensitive. */
+            char upper[64];
+            munit_assert(strlen(node->string) < sizeof(upper));
+            for (size_t i = 0; i <= strlen(node->string); i++) {
+                upper[i] = (char)toupper((unsigned char)node->string[i]);
+            }
+
+            munit_assert(sail_codec_info_from_extension(upper, &found_codec_info) == SAIL_OK);
+            munit_assert_string_equal(found_codec_info->name, codec_info->name);
+        }
+
+        for (const struct sail_string_node *node = codec_info->mime_type_node; node != NULL; node = node->next) {
+            const struct sail_codec_info *found_codec_info;
+            munit_assert(sail_codec_info_from_mime_type(node->string, &found_codec_info) == SAIL_OK);
+            munit_assert_string_equal(found_codec_info->name, codec_info->name);
+        }
+    }
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("not-existing-extension", &codec_info) == SAIL_ERROR_CODEC_NOT_FOUND);
+    munit_assert(sail_codec_info_from_mime_type("image/not-existing", &codec_info) == SAIL_ERROR_CODEC_NOT_FOUND);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/extension-and-mime-type",        test_extension_and_mime_type,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/magic-number-matches-extension", test_magic_number_matches_extension, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/magic-number-not-found",         test_magic_number_not_found,         NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/sniff",                          test_sniff,                          NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/sniff-not-found",                test_sniff_not_found,                NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/codec-info",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
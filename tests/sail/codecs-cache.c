@@ -0,0 +1,141 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+/* setenv(). */
+#if !defined _WIN32 && !defined _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+static const char * const CACHE_PATH = "codecs-cache.bin";
+
+/* Serializes the names and extensions of the enumerated codecs. */
+static void codecs_to_string(char *str, size_t str_size) {
+
+    str[0] = '\0';
+
+    for (const struct sail_codec_bundle_node *codec_bundle_node = sail_codec_bundle_list(); codec_bundle_node != NULL; codec_bundle_node = codec_bundle_node->next) {
+        const struct sail_codec_info *codec_info = codec_bundle_node->codec_bundle->codec_info;
+
+        munit_assert(strlen(str) + strlen(codec_info->name) + 2 < str_size);
+        strcat(str, codec_info->name);
+        strcat(str, ":");
+
+        for (const struct sail_string_node *node = codec_info->extension_node; node != NULL; node = node->next) {
+            munit_assert(strlen(str) + strlen(node->string) + 2 < str_size);
+            strcat(str, node->string);
+            strcat(str, ",");
+        }
+    }
+}
+
+static MunitResult test_reload_from_cache(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    char expected[8192];
+    char actual[8192];
+
+    remove(CACHE_PATH);
+
+    /* Enumerate and save the cache. */
+    munit_assert(sail_init_with_flags(0) == SAIL_OK);
+    codecs_to_string(expected, sizeof(expected));
+    sail_finish();
+
+    /* Load from the cache if it was saved. */
+    munit_assert(sail_init_with_flags(0) == SAIL_OK);
+    codecs_to_string(actual, sizeof(actual));
+    sail_finish();
+
+    munit_assert_string_equal(actual, expected);
+
+    remove(CACHE_PATH);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_corrupted_cache(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    char expected[8192];
+    char actual[8192];
+
+    remove(CACHE_PATH);
+
+    munit_assert(sail_init_with_flags(0) == SAIL_OK);
+    codecs_to_string(expected, sizeof(expected));
+    sail_finish();
+
+    FILE *f = fopen(CACHE_PATH, "wb");
+    munit_assert_not_null(f);
+    munit_assert(fputs("SAILCCH garbage", f) >= 0);
+    fclose(f);
+
+    /* The corrupted cache must be ignored. */
+    munit_assert(sail_init_with_flags(0) == SAIL_OK);
+    codecs_to_string(actual, sizeof(actual));
+    sail_finish();
+
+    munit_assert_string_equal(actual, expected);
+
+    remove(CACHE_PATH);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/corrupted-cache",   test_corrupted_cache,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/reload-from-cache", test_reload_from_cache, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/codecs-cache",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+
+#ifdef _WIN32
+    _putenv_s("SAIL_CODECS_CACHE_FILE", CACHE_PATH);
+#else
+    setenv("SAIL_CODECS_CACHE_FILE", CACHE_PATH, 1);
+#endif
+
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,128 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_independent_contexts(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_context *context1;
+    struct sail_context *context2;
+    munit_assert(sail_alloc_context(0, &context1) == SAIL_OK);
+    munit_assert(sail_alloc_context(0, &context2) == SAIL_OK);
+
+    const struct sail_codec_bundle_node *codec_bundle_node1 = sail_codec_bundle_list_in_context(context1);
+    const struct sail_codec_bundle_node *codec_bundle_node2 = sail_codec_bundle_list_in_context(context2);
+    munit_assert_not_null(codec_bundle_node1);
+    munit_assert_not_null(codec_bundle_node2);
+    munit_assert_ptr_not_equal(codec_bundle_node1, codec_bundle_node2);
+    munit_assert_ptr_not_equal(codec_bundle_node1, sail_codec_bundle_list());
+
+    /* The same codecs in the same order. */
+    for (; codec_bundle_node1 != NULL && codec_bundle_node2 != NULL;
+            codec_bundle_node1 = codec_bundle_node1->next, codec_bundle_node2 = codec_bundle_node2->next) {
+        munit_assert_string_equal(codec_bundle_node1->codec_bundle->codec_info->name,
+                                  codec_bundle_node2->codec_bundle->codec_info->name);
+    }
+
+    munit_assert_null(codec_bundle_node1);
+    munit_assert_null(codec_bundle_node2);
+
+    sail_destroy_context(context2);
+    sail_destroy_context(context1);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_in_context(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_context *context;
+    munit_assert(sail_alloc_context(0, &context) == SAIL_OK);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path_in_context(context, path, &codec_info) == SAIL_OK);
+
+    /* Codec info objects are bound to their contexts. */
+    const struct sail_codec_info *global_codec_info;
+    munit_assert(sail_codec_info_from_path(path, &global_codec_info) == SAIL_OK);
+    munit_assert_ptr_not_equal(codec_info, global_codec_info);
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_file(path, &io) == SAIL_OK);
+
+    void *state;
+    munit_assert(sail_start_loading_from_io_in_context(context, io, codec_info, NULL, &state) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert(image->width > 0);
+    munit_assert(image->height > 0);
+
+    sail_destroy_image(image);
+    sail_destroy_io(io);
+
+    /* The codec info of the global context doesn't belong to this context. */
+    munit_assert(sail_alloc_io_read_file(path, &io) == SAIL_OK);
+    munit_assert(sail_start_loading_from_io_in_context(context, io, global_codec_info, NULL, &state) == SAIL_ERROR_CODEC_NOT_FOUND);
+    sail_destroy_io(io);
+
+    sail_destroy_context(context);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/independent-contexts", test_independent_contexts, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/load-in-context",      test_load_in_context,      NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/context",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,319 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+/* Loads the first frame of the file with the specified options. Returns NULL if the codec cannot load it. */
+static struct sail_image *load_with_options(const char *path, const struct sail_load_options *load_options) {
+
+    void *state;
+    munit_assert(sail_start_loading_from_file_with_options(path, NULL, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    return image;
+}
+
+static const struct sail_variant *diagnostic(const struct sail_image *image, const char *key) {
+
+    if (image->source_image == NULL || image->source_image->special_properties == NULL) {
+        return NULL;
+    }
+
+    return sail_hash_map_value(image->source_image->special_properties, key);
+}
+
+static MunitResult test_load(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    if (!(codec_info->load_features->features & SAIL_CODEC_FEATURE_SOURCE_IMAGE)) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    /* No diagnostics by default. */
+    struct sail_image *image = load_with_options(path, load_options);
+    munit_assert_null(diagnostic(image, "bytes-read"));
+    sail_destroy_image(image);
+
+    load_options->options |= SAIL_OPTION_DIAGNOSTICS;
+
+    image = load_with_options(path, load_options);
+
+    /* Some codecs provide source images only with meta data. */
+    if (image->source_image == NULL) {
+        sail_destroy_image(image);
+        sail_destroy_load_options(load_options);
+        return MUNIT_SKIP;
+    }
+
+    const struct sail_variant *bytes_read = diagnostic(image, "bytes-read");
+    munit_assert_not_null(bytes_read);
+    munit_assert(bytes_read->type == SAIL_VARIANT_TYPE_UNSIGNED_LONG);
+    munit_assert_ulong(sail_variant_to_unsigned_long(bytes_read), >, 0);
+
+    /* The SAIL fallbacks are reported only when requested. */
+    munit_assert_null(diagnostic(image, "crop-fallback"));
+    munit_assert_null(diagnostic(image, "rows-fallback"));
+
+    sail_destroy_image(image);
+
+    /* Crop the top left pixel. */
+    load_options->roi = (struct sail_roi) { 0, 0, 1, 1 };
+
+    image = load_with_options(path, load_options);
+
+    const struct sail_variant *crop_fallback = diagnostic(image, "crop-fallback");
+    munit_assert_not_null(crop_fallback);
+    munit_assert(sail_variant_to_bool(crop_fallback) == !(codec_info->load_features->features & SAIL_CODEC_FEATURE_ROI));
+
+    sail_destroy_image(image);
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+/* Returns the first test image of the codec with the specified extension, or NULL. */
+static const char *test_image(const char *extension) {
+
+    const struct sail_codec_info *codec_info;
+
+    if (sail_codec_info_from_extension(extension, &codec_info) != SAIL_OK) {
+        return NULL;
+    }
+
+    for (const char * const *path = SAIL_TEST_IMAGES; *path != NULL; path++) {
+        const struct sail_codec_info *path_codec_info;
+
+        if (sail_codec_info_from_path(*path, &path_codec_info) == SAIL_OK && path_codec_info == codec_info) {
+            return *path;
+        }
+    }
+
+    return NULL;
+}
+
+static MunitResult test_jpeg(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const char *path = test_image("jpeg");
+
+    if (path == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+    load_options->options          |= SAIL_OPTION_SOURCE_IMAGE | SAIL_OPTION_DIAGNOSTICS;
+    load_options->scale_denominator = 2;
+
+    struct sail_image *image = load_with_options(path, load_options);
+
+    const struct sail_variant *scale_denom = diagnostic(image, "jpeg-scale-denom");
+    munit_assert_not_null(scale_denom);
+    munit_assert_ulong(sail_variant_to_unsigned_long(scale_denom), ==, 2);
+
+    const struct sail_variant *dct_method = diagnostic(image, "jpeg-dct-method");
+    munit_assert_not_null(dct_method);
+    munit_assert_string_equal(sail_variant_to_string(dct_method), "slow");
+
+    munit_assert_not_null(diagnostic(image, "jpeg-progressive"));
+
+    sail_destroy_image(image);
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_png(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const char *path = test_image("png");
+
+    if (path == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+    load_options->options |= SAIL_OPTION_SOURCE_IMAGE | SAIL_OPTION_DIAGNOSTICS;
+
+    struct sail_image *image = load_with_options(path, load_options);
+
+    const struct sail_variant *passes = diagnostic(image, "png-interlace-passes");
+    munit_assert_not_null(passes);
+    munit_assert_ulong(sail_variant_to_unsigned_long(passes), ==, image->source_image->interlaced ? 7 : 1);
+
+    sail_destroy_image(image);
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+struct rows_context {
+
+    const struct sail_image *expected_image;
+    unsigned next_row;
+};
+
+static sail_status_t compare_row(const struct sail_image *image, unsigned row, const void *scan_line, void *user_data) {
+
+    struct rows_context *rows_context = user_data;
+
+    munit_assert_uint(row, ==, rows_context->next_row++);
+    munit_assert_memory_equal(image->bytes_per_line, scan_line, sail_scan_line(rows_context->expected_image, row));
+
+    return SAIL_OK;
+}
+
+/* Loads the rows of the BMP data from memory I/O. Returns the "rows-fallback" diagnostic. */
+static bool load_bmp_rows(const void *data, size_t data_size, bool seekable, const struct sail_image *expected_image) {
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("bmp", &codec_info) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    struct rows_context rows_context = { expected_image, 0 };
+
+    load_options->options               |= SAIL_OPTION_DIAGNOSTICS;
+    load_options->row_callback           = compare_row;
+    load_options->row_callback_user_data = &rows_context;
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_memory(data, data_size, &io) == SAIL_OK);
+
+    if (!seekable) {
+        io->features &= ~SAIL_IO_FEATURE_SEEKABLE;
+    }
+
+    void *state;
+    munit_assert(sail_start_loading_from_io_with_options(io, codec_info, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert_null(image->pixels);
+    munit_assert_uint(rows_context.next_row, ==, expected_image->height);
+
+    const struct sail_variant *rows_fallback = diagnostic(image, "rows-fallback");
+    munit_assert_not_null(rows_fallback);
+    const bool result = sail_variant_to_bool(rows_fallback);
+
+    sail_destroy_image(image);
+    sail_destroy_io(io);
+    sail_destroy_load_options(load_options);
+
+    return result;
+}
+
+static MunitResult test_bmp_rows(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+
+    if (sail_codec_info_from_extension("bmp", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    for (const char * const *path = SAIL_TEST_IMAGES; *path != NULL; path++) {
+        const struct sail_codec_info *path_codec_info;
+
+        if (sail_codec_info_from_path(*path, &path_codec_info) != SAIL_OK || path_codec_info != codec_info) {
+            continue;
+        }
+
+        struct sail_load_options *load_options;
+        munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+        load_options->options |= SAIL_OPTION_SOURCE_IMAGE;
+
+        struct sail_image *expected_image = load_with_options(*path, load_options);
+        munit_assert_not_null(expected_image->source_image);
+
+        const bool flipped = expected_image->source_image->orientation == SAIL_ORIENTATION_MIRRORED_VERTICALLY;
+        const bool rle     = expected_image->source_image->compression == SAIL_COMPRESSION_RLE;
+
+        void *data;
+        size_t data_size;
+        munit_assert(sail_alloc_data_from_file_contents(*path, &data, &data_size) == SAIL_OK);
+
+        /* Bottom-up rows are read row by row only by seeking to them. */
+        munit_assert(load_bmp_rows(data, data_size, true, expected_image) == (flipped && rle));
+        munit_assert(load_bmp_rows(data, data_size, false, expected_image) == flipped);
+
+        sail_free(data);
+        sail_destroy_image(expected_image);
+        sail_destroy_load_options(load_options);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/load",     test_load,     NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/jpeg",     test_jpeg,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/png",      test_png,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/bmp-rows", test_bmp_rows, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/diagnostics",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
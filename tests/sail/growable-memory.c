@@ -0,0 +1,552 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_growable_memory_io(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_write_growable_memory(&io) == SAIL_OK);
+
+    /* Nothing written. */
+    void *buffer;
+    size_t buffer_size;
+    munit_assert(sail_take_io_growable_memory_buffer(io, &buffer, &buffer_size) == SAIL_OK);
+    munit_assert_null(buffer);
+    munit_assert_size(buffer_size, ==, 0);
+
+    /* Write more than the initial capacity to force reallocations. */
+    unsigned char chunk[1000];
+    for (size_t i = 0; i < sizeof(chunk); i++) {
+        chunk[i] = (unsigned char)i;
+    }
+
+    for (int i = 0; i < 10; i++) {
+        munit_assert(io->strict_write(io->stream, chunk, sizeof(chunk)) == SAIL_OK);
+    }
+
+    /* Overwrite the beginning. */
+    munit_assert(io->seek(io->stream, 0, SEEK_SET) == SAIL_OK);
+    munit_assert(io->strict_write(io->stream, "SAIL", 4) == SAIL_OK);
+
+    /* Read back. */
+    unsigned char read_chunk[sizeof(chunk)];
+    munit_assert(io->strict_read(io->stream, read_chunk, sizeof(read_chunk)) == SAIL_OK);
+    munit_assert_memory_equal(sizeof(chunk) - 4, read_chunk, chunk + 4);
+
+    /* Seek past the end and write, the gap is zero-filled. */
+    munit_assert(io->seek(io->stream, 16, SEEK_END) == SAIL_OK);
+    munit_assert(io->strict_write(io->stream, "END", 3) == SAIL_OK);
+
+    bool eof;
+    munit_assert(io->eof(io->stream, &eof) == SAIL_OK);
+    munit_assert_true(eof);
+
+    munit_assert(sail_take_io_growable_memory_buffer(io, &buffer, &buffer_size) == SAIL_OK);
+    munit_assert_not_null(buffer);
+    munit_assert_size(buffer_size, ==, 10 * sizeof(chunk) + 16 + 3);
+
+    const unsigned char *bytes = buffer;
+    munit_assert_memory_equal(4, bytes, "SAIL");
+    munit_assert_memory_equal(sizeof(chunk) - 4, bytes + 4, chunk + 4);
+    munit_assert_memory_equal(sizeof(chunk), bytes + 9 * sizeof(chunk), chunk);
+
+    for (size_t i = 10 * sizeof(chunk); i < 10 * sizeof(chunk) + 16; i++) {
+        munit_assert_uint8(bytes[i], ==, 0);
+    }
+
+    munit_assert_memory_equal(3, bytes + 10 * sizeof(chunk) + 16, "END");
+
+    sail_free(buffer);
+    sail_destroy_io(io);
+
+    /* Other I/O objects are rejected. */
+    munit_assert(sail_alloc_io_read_memory(chunk, sizeof(chunk), &io) == SAIL_OK);
+    munit_assert(sail_take_io_growable_memory_buffer(io, &buffer, &buffer_size) == SAIL_ERROR_INVALID_IO);
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_save_into_growable_memory(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    bool can_save = false;
+
+    for (unsigned i = 0; i < codec_info->save_features->pixel_formats_length; i++) {
+        if (codec_info->save_features->pixel_formats[i] == image->pixel_format) {
+            can_save = true;
+            break;
+        }
+    }
+
+    if (!can_save) {
+        sail_destroy_image(image);
+        return MUNIT_SKIP;
+    }
+
+    /* Save into a worst case fixed buffer. */
+    const size_t fixed_buffer_size = (size_t)image->height * image->bytes_per_line * 2 + 64 * 1024;
+    void *fixed_buffer = munit_malloc(fixed_buffer_size);
+
+    void *state;
+    munit_assert(sail_start_saving_into_memory(fixed_buffer, fixed_buffer_size, codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    size_t written;
+    munit_assert(sail_stop_saving_with_written(state, &written) == SAIL_OK);
+
+    /* Custom I/O without features is sought to the end too. */
+    {
+        struct sail_io *io;
+        munit_assert(sail_alloc_io_read_write_memory(fixed_buffer, fixed_buffer_size, &io) == SAIL_OK);
+        io->features = 0;
+
+        munit_assert(sail_start_saving_into_io(io, codec_info, &state) == SAIL_OK);
+        munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+        size_t written_custom;
+        munit_assert(sail_stop_saving_with_written(state, &written_custom) == SAIL_OK);
+        munit_assert_size(written_custom, ==, written);
+
+        sail_destroy_io(io);
+    }
+
+    /* Save into a growable buffer. */
+    munit_assert(sail_start_saving_into_growable_memory(codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    void *buffer;
+    size_t buffer_size;
+    munit_assert(sail_stop_saving_into_growable_memory(state, &buffer, &buffer_size) == SAIL_OK);
+
+    /* Fixed memory buffers report their whole size as written. */
+    munit_assert_not_null(buffer);
+    munit_assert_size(buffer_size, >, 0);
+    munit_assert_size(buffer_size, <=, written);
+    munit_assert_memory_equal(buffer_size, buffer, fixed_buffer);
+
+    sail_free(buffer);
+    free(fixed_buffer);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static sail_status_t copy_row(const struct sail_image *image, unsigned row, void *scan_line, void *user_data) {
+
+    const struct sail_image *source_image = user_data;
+
+    munit_assert_uint(image->bytes_per_line, ==, source_image->bytes_per_line);
+
+    memcpy(scan_line, sail_scan_line(source_image, row), source_image->bytes_per_line);
+
+    return SAIL_OK;
+}
+
+static void save_with_options(const struct sail_codec_info *codec_info, const struct sail_save_options *save_options,
+                                const struct sail_image *image, void **buffer, size_t *buffer_size) {
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory_with_options(codec_info, save_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_saving_into_growable_memory(state, buffer, buffer_size) == SAIL_OK);
+}
+
+static MunitResult test_save_rows(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    bool can_save = false;
+
+    for (unsigned i = 0; i < codec_info->save_features->pixel_formats_length; i++) {
+        if (codec_info->save_features->pixel_formats[i] == image->pixel_format) {
+            can_save = true;
+            break;
+        }
+    }
+
+    if (!can_save) {
+        sail_destroy_image(image);
+        return MUNIT_SKIP;
+    }
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+
+    /* Interlaced and progressive. */
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) {
+            save_options->options &= ~SAIL_OPTION_INTERLACED;
+        }
+
+        save_options->row_callback = NULL;
+
+        void *expected_buffer;
+        size_t expected_buffer_size;
+        save_with_options(codec_info, save_options, image, &expected_buffer, &expected_buffer_size);
+
+        /* The pixels are requested from the callback. */
+        struct sail_image image_rows = *image;
+        image_rows.pixels = NULL;
+
+        save_options->row_callback           = copy_row;
+        save_options->row_callback_user_data = image;
+
+        void *buffer;
+        size_t buffer_size;
+        save_with_options(codec_info, save_options, &image_rows, &buffer, &buffer_size);
+
+        munit_assert_size(buffer_size, ==, expected_buffer_size);
+        munit_assert_memory_equal(buffer_size, buffer, expected_buffer);
+
+        sail_free(buffer);
+        sail_free(expected_buffer);
+    }
+
+    sail_destroy_save_options(save_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static struct sail_image* alloc_pattern_image(enum SailPixelFormat pixel_format, unsigned r, unsigned g, unsigned b, unsigned a) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = 16;
+    image->height         = 16;
+    image->pixel_format   = pixel_format;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    const unsigned bytes_per_pixel = sail_bits_per_pixel(pixel_format) / 8;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        unsigned char *scan_line = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            unsigned char *pixel = scan_line + column * bytes_per_pixel;
+
+            pixel[r] = (unsigned char)(row * 16);
+            pixel[g] = (unsigned char)(column * 16);
+            pixel[b] = (unsigned char)(row * column);
+
+            if (a < bytes_per_pixel) {
+                pixel[a] = 0x80;
+            }
+        }
+    }
+
+    return image;
+}
+
+static MunitResult test_save_pixel_layouts(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpeg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    bool can_save = false;
+
+    for (unsigned i = 0; i < codec_info->save_features->pixel_formats_length; i++) {
+        if (codec_info->save_features->pixel_formats[i] == SAIL_PIXEL_FORMAT_BPP32_BGRA) {
+            can_save = true;
+            break;
+        }
+    }
+
+    if (!can_save) {
+        return MUNIT_SKIP;
+    }
+
+    /* Every RGB layout with the same colors is encoded into the same JPEG. */
+    struct sail_image *expected_image = alloc_pattern_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 0, 1, 2, 3);
+
+    void *expected_buffer;
+    size_t expected_buffer_size;
+    save_with_options(codec_info, NULL, expected_image, &expected_buffer, &expected_buffer_size);
+
+    struct sail_image *images[] = {
+        alloc_pattern_image(SAIL_PIXEL_FORMAT_BPP24_BGR,  2, 1, 0, 3),
+        alloc_pattern_image(SAIL_PIXEL_FORMAT_BPP32_BGRA, 2, 1, 0, 3),
+        alloc_pattern_image(SAIL_PIXEL_FORMAT_BPP32_ARGB, 1, 2, 3, 0),
+    };
+
+    for (size_t i = 0; i < sizeof(images) / sizeof(images[0]); i++) {
+        void *buffer;
+        size_t buffer_size;
+        save_with_options(codec_info, NULL, images[i], &buffer, &buffer_size);
+
+        munit_assert_size(buffer_size, ==, expected_buffer_size);
+        munit_assert_memory_equal(buffer_size, buffer, expected_buffer);
+
+        sail_free(buffer);
+        sail_destroy_image(images[i]);
+    }
+
+    sail_free(expected_buffer);
+    sail_destroy_image(expected_image);
+
+    return MUNIT_OK;
+}
+
+static void load_from_buffer(const struct sail_codec_info *codec_info, const void *buffer, size_t buffer_size, struct sail_image **image) {
+
+    void *state;
+    munit_assert(sail_start_loading_from_memory(buffer, buffer_size, codec_info, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+}
+
+static MunitResult test_save_png_threads(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+    save_options->options &= ~SAIL_OPTION_INTERLACED;
+
+    munit_assert(sail_alloc_hash_map(&save_options->tuning) == SAIL_OK);
+
+    struct sail_variant *value;
+    munit_assert(sail_alloc_variant(&value) == SAIL_OK);
+    sail_set_variant_unsigned_int(value, 3);
+    munit_assert(sail_put_hash_map(save_options->tuning, "png-threads", value) == SAIL_OK);
+    sail_destroy_variant(value);
+
+    /* Images encoded in parallel must decode into the same pixels. */
+    struct sail_image *images[] = {
+        alloc_pattern_image(SAIL_PIXEL_FORMAT_BPP24_RGB,  0, 1, 2, 3),
+        alloc_pattern_image(SAIL_PIXEL_FORMAT_BPP24_BGR,  2, 1, 0, 3),
+        alloc_pattern_image(SAIL_PIXEL_FORMAT_BPP32_RGBA, 0, 1, 2, 3),
+        alloc_pattern_image(SAIL_PIXEL_FORMAT_BPP32_ABGR, 3, 2, 1, 0),
+    };
+
+    for (size_t i = 0; i < sizeof(images) / sizeof(images[0]); i++) {
+        void *expected_buffer;
+        size_t expected_buffer_size;
+        save_with_options(codec_info, NULL, images[i], &expected_buffer, &expected_buffer_size);
+
+        void *buffer;
+        size_t buffer_size;
+        save_with_options(codec_info, save_options, images[i], &buffer, &buffer_size);
+
+        struct sail_image *expected_image = NULL;
+        load_from_buffer(codec_info, expected_buffer, expected_buffer_size, &expected_image);
+
+        struct sail_image *image = NULL;
+        load_from_buffer(codec_info, buffer, buffer_size, &image);
+
+        munit_assert(image->pixel_format == expected_image->pixel_format);
+        munit_assert_uint(image->bytes_per_line, ==, expected_image->bytes_per_line);
+        munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image->pixels, expected_image->pixels);
+
+        sail_destroy_image(image);
+        sail_destroy_image(expected_image);
+        sail_free(buffer);
+        sail_free(expected_buffer);
+        sail_destroy_image(images[i]);
+    }
+
+    sail_destroy_save_options(save_options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_save_png_presets(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = alloc_pattern_image(SAIL_PIXEL_FORMAT_BPP24_RGB, 0, 1, 2, 3);
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+    save_options->options &= ~SAIL_OPTION_INTERLACED;
+
+    munit_assert(sail_alloc_hash_map(&save_options->tuning) == SAIL_OK);
+
+    struct sail_variant *value;
+    munit_assert(sail_alloc_variant(&value) == SAIL_OK);
+
+    static const char * const presets[] = { "fast", "balanced", "max" };
+
+    /* Every preset is lossless in the sequential and the parallel encoders. */
+    for (unsigned threads = 1; threads <= 3; threads += 2) {
+        sail_set_variant_unsigned_int(value, threads);
+        munit_assert(sail_put_hash_map(save_options->tuning, "png-threads", value) == SAIL_OK);
+
+        for (size_t i = 0; i < sizeof(presets) / sizeof(presets[0]); i++) {
+            sail_set_variant_string(value, presets[i]);
+            munit_assert(sail_put_hash_map(save_options->tuning, "png-preset", value) == SAIL_OK);
+
+            void *buffer;
+            size_t buffer_size;
+            save_with_options(codec_info, save_options, image, &buffer, &buffer_size);
+
+            struct sail_image *loaded_image = NULL;
+            load_from_buffer(codec_info, buffer, buffer_size, &loaded_image);
+
+            munit_assert(loaded_image->pixel_format == image->pixel_format);
+            munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, loaded_image->pixels, image->pixels);
+
+            sail_destroy_image(loaded_image);
+            sail_free(buffer);
+        }
+    }
+
+    sail_destroy_variant(value);
+    sail_destroy_save_options(save_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_save_png_interlaced(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("png", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+    save_options->options |= SAIL_OPTION_INTERLACED;
+
+    /* Sizes with empty and partial Adam7 passes. Sub-byte rows have no padding bits to compare. */
+    static const struct {
+        enum SailPixelFormat pixel_format;
+        unsigned width;
+        unsigned height;
+    } layouts[] = {
+        { SAIL_PIXEL_FORMAT_BPP1_GRAYSCALE,  24, 13 },
+        { SAIL_PIXEL_FORMAT_BPP4_GRAYSCALE,  18, 13 },
+        { SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE,  17, 11 },
+        { SAIL_PIXEL_FORMAT_BPP16_GRAYSCALE, 1,  1  },
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,       3,  9  },
+        { SAIL_PIXEL_FORMAT_BPP24_RGB,       17, 11 },
+        { SAIL_PIXEL_FORMAT_BPP64_RGBA,      5,  3  },
+    };
+
+    for (size_t i = 0; i < sizeof(layouts) / sizeof(layouts[0]); i++) {
+        struct sail_image *image;
+        munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+        image->width          = layouts[i].width;
+        image->height         = layouts[i].height;
+        image->pixel_format   = layouts[i].pixel_format;
+        image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+        const size_t pixels_size = (size_t)image->bytes_per_line * image->height;
+        munit_assert(sail_malloc(pixels_size, &image->pixels) == SAIL_OK);
+        munit_rand_memory(pixels_size, image->pixels);
+
+        void *buffer;
+        size_t buffer_size;
+        save_with_options(codec_info, save_options, image, &buffer, &buffer_size);
+
+        struct sail_image *loaded_image = NULL;
+        load_from_buffer(codec_info, buffer, buffer_size, &loaded_image);
+
+        munit_assert(loaded_image->pixel_format == image->pixel_format);
+        munit_assert_uint(loaded_image->bytes_per_line, ==, image->bytes_per_line);
+        munit_assert_memory_equal(pixels_size, loaded_image->pixels, image->pixels);
+
+        sail_destroy_image(loaded_image);
+        sail_free(buffer);
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_save_options(save_options);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/io",                 test_growable_memory_io,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/save",               test_save_into_growable_memory, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/save-pixel-layouts", test_save_pixel_layouts,        NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/save-png-interlaced", test_save_png_interlaced,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/save-png-presets",   test_save_png_presets,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/save-png-threads",   test_save_png_threads,          NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/save-rows",          test_save_rows,                 NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/growable-memory",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
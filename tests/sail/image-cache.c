@@ -0,0 +1,182 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <sail/sail.h>
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_hit(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_reference = NULL;
+    if (sail_load_from_file(path, &image_reference) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image_cache *image_cache;
+    munit_assert(sail_alloc_image_cache(64 * 1024 * 1024, &image_cache) == SAIL_OK);
+
+    const struct sail_image *image1 = NULL;
+    munit_assert(sail_image_cache_load_from_file(image_cache, path, NULL, &image1) == SAIL_OK);
+    munit_assert(sail_test_compare_images(image1, image_reference) == SAIL_OK);
+
+    /* The same image is shared. */
+    const struct sail_image *image2 = NULL;
+    munit_assert(sail_image_cache_load_from_file(image_cache, path, NULL, &image2) == SAIL_OK);
+    munit_assert_ptr_equal(image1, image2);
+
+    /* Different load options make a different image. */
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+    load_options->row_alignment = 64;
+
+    const struct sail_image *image3 = NULL;
+    munit_assert(sail_image_cache_load_from_file(image_cache, path, load_options, &image3) == SAIL_OK);
+    munit_assert_ptr_not_equal(image1, image3);
+    munit_assert_uint(image3->bytes_per_line % 64, ==, 0);
+
+    sail_destroy_load_options(load_options);
+
+    sail_image_cache_release(image_cache, image3);
+    sail_image_cache_release(image_cache, image2);
+    sail_image_cache_release(image_cache, image1);
+
+    sail_destroy_image_cache(image_cache);
+    sail_destroy_image(image_reference);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_eviction(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_reference = NULL;
+    if (sail_load_from_file(path, &image_reference) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    /* Fits a single image. */
+    const size_t image_size = (size_t)image_reference->bytes_per_line * image_reference->height;
+
+    struct sail_image_cache *image_cache;
+    munit_assert(sail_alloc_image_cache(image_size + image_size / 2, &image_cache) == SAIL_OK);
+
+    const struct sail_image *image1 = NULL;
+    munit_assert(sail_image_cache_load_from_file(image_cache, path, NULL, &image1) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+
+    /* Evicts the first image, which stays valid until it's released. */
+    const struct sail_image *image2 = NULL;
+    munit_assert(sail_image_cache_load_from_file(image_cache, path, load_options, &image2) == SAIL_OK);
+    munit_assert(sail_test_compare_images(image1, image_reference) == SAIL_OK);
+
+    /* The evicted image is loaded again. */
+    const struct sail_image *image3 = NULL;
+    munit_assert(sail_image_cache_load_from_file(image_cache, path, NULL, &image3) == SAIL_OK);
+    munit_assert_ptr_not_equal(image1, image3);
+    munit_assert(sail_test_compare_images(image3, image_reference) == SAIL_OK);
+
+    sail_image_cache_release(image_cache, image1);
+    sail_image_cache_release(image_cache, image2);
+    sail_image_cache_release(image_cache, image3);
+
+    sail_destroy_load_options(load_options);
+    sail_destroy_image_cache(image_cache);
+    sail_destroy_image(image_reference);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_not_cached(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const char *path = SAIL_TEST_IMAGES[0];
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &data, &data_size) == SAIL_OK);
+
+    /* Nothing fits. */
+    struct sail_image_cache *image_cache;
+    munit_assert(sail_alloc_image_cache(0, &image_cache) == SAIL_OK);
+
+    const struct sail_image *image1 = NULL;
+    munit_assert(sail_image_cache_load_from_memory(image_cache, data, data_size, NULL, &image1) == SAIL_OK);
+
+    const struct sail_image *image2 = NULL;
+    munit_assert(sail_image_cache_load_from_memory(image_cache, data, data_size, NULL, &image2) == SAIL_OK);
+    munit_assert_ptr_not_equal(image1, image2);
+    munit_assert(sail_test_compare_images(image1, image2) == SAIL_OK);
+
+    sail_image_cache_release(image_cache, image1);
+    sail_image_cache_release(image_cache, image2);
+
+    /* Errors are not cached. */
+    static const unsigned char garbage[16] = { 0 };
+    const struct sail_image *image3 = NULL;
+    munit_assert(sail_image_cache_load_from_memory(image_cache, garbage, sizeof(garbage), NULL, &image3) != SAIL_OK);
+    munit_assert_null(image3);
+
+    sail_destroy_image_cache(image_cache);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/hit",        test_hit,        NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/eviction",   test_eviction,   NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/not-cached", test_not_cached, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/image-cache",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
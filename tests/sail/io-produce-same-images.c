@@ -23,7 +23,9 @@
     SOFTWARE.
 */
 
+#include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <sail/sail.h>
 
@@ -33,6 +35,65 @@
 
 #include "test-images.h"
 
+static MunitResult test_file_io_eof(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_file(path, &io) == SAIL_OK);
+
+    bool eof;
+    munit_assert(io->eof(io->stream, &eof) == SAIL_OK);
+    munit_assert_false(eof);
+
+    /* The file size is fetched from the open file. */
+    munit_assert(io->seek(io->stream, 0, SEEK_END) == SAIL_OK);
+    munit_assert(io->eof(io->stream, &eof) == SAIL_OK);
+    munit_assert_true(eof);
+
+    munit_assert(io->seek(io->stream, -1, SEEK_END) == SAIL_OK);
+    munit_assert(io->eof(io->stream, &eof) == SAIL_OK);
+    munit_assert_false(eof);
+
+    sail_destroy_io(io);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_file_io_with_flags_produces_same_images(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_file_with_flags(path, SAIL_IO_FILE_FLAG_SEQUENTIAL | SAIL_IO_FILE_FLAG_NO_CACHE, &io) == SAIL_OK);
+
+    void *state;
+    munit_assert(sail_start_loading_from_io(io, codec_info, &state) == SAIL_OK);
+
+    struct sail_image *image_with_flags = NULL;
+    munit_assert(sail_load_next_frame(state, &image_with_flags) == SAIL_OK);
+    munit_assert_not_null(image_with_flags);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert(sail_test_compare_images(image_file, image_with_flags) == SAIL_OK);
+
+    sail_destroy_io(io);
+    sail_destroy_image(image_with_flags);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
 static MunitResult test_io_produce_same_images(const MunitParameter params[], void *user_data) {
     (void)user_data;
 
@@ -70,13 +131,296 @@ static MunitResult test_io_produce_same_images(const MunitParameter params[], vo
     return MUNIT_OK;
 }
 
+static MunitResult test_mmap_io_produces_same_images(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_mmap_file(path, &io) == SAIL_OK);
+    munit_assert(io->features & SAIL_IO_FEATURE_MAPPED);
+
+    void *state;
+    munit_assert(sail_start_loading_from_io(io, codec_info, &state) == SAIL_OK);
+
+    struct sail_image *image_mmap = NULL;
+    munit_assert(sail_load_next_frame(state, &image_mmap) == SAIL_OK);
+    munit_assert_not_null(image_mmap);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert(sail_test_compare_images(image_file, image_mmap) == SAIL_OK);
+
+    sail_destroy_io(io);
+    sail_destroy_image(image_mmap);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_read_ahead_io_produces_same_images(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_io *file_io;
+    munit_assert(sail_alloc_io_read_file(path, &file_io) == SAIL_OK);
+
+    /* Small blocks to wrap the ring and to seek outside of it. */
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_ahead(file_io, 1000, 3, &io) == SAIL_OK);
+
+    void *state;
+    munit_assert(sail_start_loading_from_io(io, codec_info, &state) == SAIL_OK);
+
+    struct sail_image *image_read_ahead = NULL;
+    munit_assert(sail_load_next_frame(state, &image_read_ahead) == SAIL_OK);
+    munit_assert_not_null(image_read_ahead);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert(sail_test_compare_images(image_file, image_read_ahead) == SAIL_OK);
+
+    sail_destroy_io(io);
+    sail_destroy_image(image_read_ahead);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
+static bool is_forward_only_format(const char *path) {
+
+    const char *extension = strrchr(path, '.');
+
+    if (extension == NULL) {
+        return false;
+    }
+
+    return strcmp(extension, ".png") == 0 || strcmp(extension, ".jpeg") == 0 || strcmp(extension, ".qoi") == 0;
+}
+
+static MunitResult test_stream_io_produces_same_images(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    if (!is_forward_only_format(path)) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &data, &data_size) == SAIL_OK);
+
+    /* Emulate a pipe. */
+    struct sail_io *memory_io;
+    munit_assert(sail_alloc_io_read_memory(data, data_size, &memory_io) == SAIL_OK);
+    memory_io->features = 0;
+    memory_io->seek     = sail_io_noop_seek;
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_stream(memory_io, &io) == SAIL_OK);
+    munit_assert(!(io->features & SAIL_IO_FEATURE_SEEKABLE));
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_by_magic_number_from_io(io, &codec_info) == SAIL_OK);
+
+    void *state;
+    munit_assert(sail_start_loading_from_io(io, codec_info, &state) == SAIL_OK);
+
+    struct sail_image *image_stream = NULL;
+    munit_assert(sail_load_next_frame(state, &image_stream) == SAIL_OK);
+    munit_assert_not_null(image_stream);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert(sail_test_compare_images(image_file, image_stream) == SAIL_OK);
+
+    /* Seeking back past the prefix must fail. */
+    if (data_size > SAIL_IO_STREAM_PREFIX_SIZE) {
+        munit_assert(io->seek(io->stream, 0, SEEK_SET) != SAIL_OK);
+    }
+
+    sail_destroy_io(io);
+    sail_free(data);
+    sail_destroy_image(image_stream);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
+/* Read hints received by the I/O object with expensive seeking. */
+static size_t will_need_count;
+static size_t will_need_max_end;
+
+static sail_status_t record_will_need(void *stream, size_t offset, size_t length) {
+
+    (void)stream;
+
+    will_need_count++;
+
+    if (offset + length > will_need_max_end) {
+        will_need_max_end = offset + length;
+    }
+
+    return SAIL_OK;
+}
+
+static MunitResult test_expensive_seek_io_produces_same_images(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_file(path, &io) == SAIL_OK);
+
+    io->features  |= SAIL_IO_FEATURE_EXPENSIVE_SEEK;
+    io->will_need  = record_will_need;
+
+    will_need_count   = 0;
+    will_need_max_end = 0;
+
+    /* Probing hints the magic number range. Some formats have no magic numbers, so ignore the result. */
+    const struct sail_codec_info *codec_info;
+    (void)sail_codec_info_by_magic_number_from_io(io, &codec_info);
+    munit_assert_size(will_need_count, ==, 1);
+
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    will_need_max_end = 0;
+
+    void *state;
+    munit_assert(sail_start_loading_from_io(io, codec_info, &state) == SAIL_OK);
+
+    struct sail_image *image_expensive_seek = NULL;
+    munit_assert(sail_load_next_frame(state, &image_expensive_seek) == SAIL_OK);
+    munit_assert_not_null(image_expensive_seek);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert(sail_test_compare_images(image_file, image_expensive_seek) == SAIL_OK);
+
+    /* Codec hints never point past the end. */
+    size_t io_size;
+    munit_assert(io->seek(io->stream, 0, SEEK_SET) == SAIL_OK);
+    munit_assert(sail_io_size(io, &io_size) == SAIL_OK);
+    munit_assert_size(will_need_max_end, <=, io_size);
+
+    sail_destroy_io(io);
+    sail_destroy_image(image_expensive_seek);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_mmap_io_borrow(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &data, &data_size) == SAIL_OK);
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_mmap_file(path, &io) == SAIL_OK);
+
+    /* Borrow from the middle. */
+    const long offset = (long)(data_size / 2);
+    munit_assert(io->seek(io->stream, offset, SEEK_SET) == SAIL_OK);
+
+    const void *borrowed_data;
+    size_t borrowed_data_size;
+    void *allocated_data;
+    munit_assert(sail_borrow_or_alloc_data_from_io_contents(io, &borrowed_data, &borrowed_data_size, &allocated_data) == SAIL_OK);
+
+    munit_assert_null(allocated_data);
+    munit_assert_size(borrowed_data_size, ==, data_size - (size_t)offset);
+    munit_assert_memory_equal(borrowed_data_size, borrowed_data, (const char *)data + offset);
+
+    bool eof;
+    munit_assert(io->eof(io->stream, &eof) == SAIL_OK);
+    munit_assert_true(eof);
+
+    sail_destroy_io(io);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_memory_io_borrow(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &data, &data_size) == SAIL_OK);
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_memory(data, data_size, &io) == SAIL_OK);
+    munit_assert(io->features & SAIL_IO_FEATURE_MAPPED);
+
+    /* Borrow from the middle. */
+    const long offset = (long)(data_size / 2);
+    munit_assert(io->seek(io->stream, offset, SEEK_SET) == SAIL_OK);
+
+    const void *borrowed_data;
+    size_t borrowed_data_size;
+    void *allocated_data;
+    munit_assert(sail_borrow_or_alloc_data_from_io_contents(io, &borrowed_data, &borrowed_data_size, &allocated_data) == SAIL_OK);
+
+    munit_assert_null(allocated_data);
+    munit_assert_ptr_equal(borrowed_data, (const char *)data + offset);
+    munit_assert_size(borrowed_data_size, ==, data_size - (size_t)offset);
+
+    bool eof;
+    munit_assert(io->eof(io->stream, &eof) == SAIL_OK);
+    munit_assert_true(eof);
+
+    sail_destroy_io(io);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
 static MunitParameterEnum test_params[] = {
     { (char *)"path", (char **)SAIL_TEST_IMAGES },
     { NULL, NULL },
 };
 
 static MunitTest test_suite_tests[] = {
-    { (char *)"/io-produce-same-images", test_io_produce_same_images, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/expensive-seek-io-produces-same-images",  test_expensive_seek_io_produces_same_images,  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/file-io-eof",                             test_file_io_eof,                             NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/file-io-with-flags-produces-same-images", test_file_io_with_flags_produces_same_images, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/io-produce-same-images",                  test_io_produce_same_images,                  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/memory-io-borrow",                        test_memory_io_borrow,                        NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/mmap-io-borrow",                          test_mmap_io_borrow,                          NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/mmap-io-produces-same-images",            test_mmap_io_produces_same_images,            NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/read-ahead-io-produces-same-images",      test_read_ahead_io_produces_same_images,      NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/stream-io-produces-same-images",          test_stream_io_produces_same_images,          NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
 
     { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
 };
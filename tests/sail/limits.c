@@ -0,0 +1,181 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static sail_status_t load_with_options(const char *path, const struct sail_codec_info *codec_info,
+                                        const struct sail_load_options *load_options) {
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    const sail_status_t status = sail_load_next_frame(state, &image);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    if (status != SAIL_OK) {
+        munit_assert_null(image);
+    }
+
+    sail_destroy_image(image);
+
+    return status;
+}
+
+static MunitResult test_pixels(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_probe_file(path, &image, NULL) == SAIL_OK);
+
+    const uint64_t pixels = (uint64_t)image->width * image->height;
+    const size_t bytes    = (size_t)image->height * image->bytes_per_line;
+
+    sail_destroy_image(image);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    /* Exact limits are allowed. */
+    load_options->limits.max_pixels = pixels;
+    load_options->limits.max_bytes  = bytes;
+    munit_assert(load_with_options(path, codec_info, load_options) == SAIL_OK);
+
+    load_options->limits.max_pixels = pixels - 1;
+    load_options->limits.max_bytes  = 0;
+    munit_assert(load_with_options(path, codec_info, load_options) == SAIL_ERROR_LIMIT_EXCEEDED);
+
+    load_options->limits.max_pixels = 0;
+    load_options->limits.max_bytes  = bytes - 1;
+    munit_assert(load_with_options(path, codec_info, load_options) == SAIL_ERROR_LIMIT_EXCEEDED);
+
+    /* Probing allocates no pixels. */
+    load_options->limits.max_pixels = 1;
+    load_options->limits.max_bytes  = 1;
+    load_options->options |= SAIL_OPTION_PROBE;
+    munit_assert(load_with_options(path, codec_info, load_options) == SAIL_OK);
+
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_frames(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+    load_options->limits.max_frames = 1;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, NULL, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    sail_destroy_image(image);
+
+    image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_ERROR_LIMIT_EXCEEDED);
+    munit_assert_null(image);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_meta_data(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    const bool has_meta_data = image->meta_data_node != NULL || image->iccp != NULL;
+    sail_destroy_image(image);
+
+    if (!has_meta_data) {
+        sail_destroy_load_options(load_options);
+        return MUNIT_SKIP;
+    }
+
+    load_options->limits.max_meta_data_bytes = 1;
+    munit_assert(load_with_options(path, codec_info, load_options) == SAIL_ERROR_LIMIT_EXCEEDED);
+
+    /* Meta data are not loaded without the option. */
+    load_options->options &= ~(SAIL_OPTION_META_DATA | SAIL_OPTION_ICCP);
+    munit_assert(load_with_options(path, codec_info, load_options) == SAIL_OK);
+
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/frames",    test_frames,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/meta-data", test_meta_data, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/pixels",    test_pixels,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/limits",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,135 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <sail/sail.h>
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+/* Loads all the frames with or without the frame arena. */
+static struct sail_image** load_frames(const char *path, const struct sail_codec_info *codec_info, int options, size_t *frames_count) {
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->options |= SAIL_OPTION_META_DATA | SAIL_OPTION_SOURCE_IMAGE | options;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+    sail_destroy_load_options(load_options);
+
+    struct sail_image **frames = NULL;
+    *frames_count = 0;
+
+    struct sail_image *image;
+    sail_status_t status;
+
+    while ((status = sail_load_next_frame(state, &image)) == SAIL_OK) {
+        void *ptr = frames;
+        munit_assert(sail_realloc((*frames_count + 1) * sizeof(struct sail_image *), &ptr) == SAIL_OK);
+        frames = ptr;
+        frames[(*frames_count)++] = image;
+    }
+
+    munit_assert(status == SAIL_ERROR_NO_MORE_FRAMES);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    return frames;
+}
+
+static void destroy_frames(struct sail_image **frames, size_t frames_count) {
+
+    for (size_t i = 0; i < frames_count; i++) {
+        sail_destroy_image(frames[i]);
+    }
+
+    sail_free(frames);
+}
+
+static MunitResult test_arena(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_path(path, &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    size_t expected_frames_count;
+    struct sail_image **expected_frames = load_frames(path, codec_info, 0, &expected_frames_count);
+
+    size_t frames_count;
+    struct sail_image **frames = load_frames(path, codec_info, SAIL_OPTION_ARENA, &frames_count);
+
+    munit_assert_size(frames_count, ==, expected_frames_count);
+
+    for (size_t i = 0; i < frames_count; i++) {
+        munit_assert_null(expected_frames[i]->arena);
+        munit_assert_not_null(frames[i]->arena);
+
+        munit_assert(sail_test_compare_images(expected_frames[i], frames[i]) == SAIL_OK);
+
+        /* Copies don't depend on the arena of the original image. */
+        struct sail_image *image_copy;
+        munit_assert(sail_copy_image(frames[i], &image_copy) == SAIL_OK);
+        munit_assert_null(image_copy->arena);
+
+        sail_destroy_image(frames[i]);
+        frames[i] = image_copy;
+
+        munit_assert(sail_test_compare_images(expected_frames[i], frames[i]) == SAIL_OK);
+    }
+
+    destroy_frames(frames, frames_count);
+    destroy_frames(expected_frames, expected_frames_count);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/arena", test_arena, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/load-arena",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,239 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+/* Every test image with a magic number twice, so batch tasks reuse their loading states. */
+struct test_batch {
+    const char **paths;
+    const void **buffers;
+    size_t *buffer_sizes;
+    size_t length;
+};
+
+static void alloc_test_batch(struct test_batch *test_batch) {
+
+    size_t count = 0;
+
+    while (SAIL_TEST_IMAGES[count] != NULL) {
+        count++;
+    }
+
+    test_batch->paths        = munit_newa(const char *, count * 2);
+    test_batch->buffers      = munit_newa(const void *, count * 2);
+    test_batch->buffer_sizes = munit_newa(size_t, count * 2);
+    test_batch->length       = 0;
+
+    for (unsigned pass = 0; pass < 2; pass++) {
+        for (size_t i = 0; i < count; i++) {
+            void *buffer;
+            size_t buffer_size;
+            munit_assert(sail_alloc_data_from_file_contents(SAIL_TEST_IMAGES[i], &buffer, &buffer_size) == SAIL_OK);
+
+            const struct sail_codec_info *codec_info;
+
+            if (sail_codec_info_sniff_from_memory(buffer, buffer_size, &codec_info, NULL) != SAIL_OK) {
+                sail_free(buffer);
+                continue;
+            }
+
+            test_batch->paths[test_batch->length]        = SAIL_TEST_IMAGES[i];
+            test_batch->buffers[test_batch->length]      = buffer;
+            test_batch->buffer_sizes[test_batch->length] = buffer_size;
+            test_batch->length++;
+        }
+    }
+}
+
+static void destroy_test_batch(struct test_batch *test_batch) {
+
+    for (size_t i = 0; i < test_batch->length; i++) {
+        sail_free((void *)test_batch->buffers[i]);
+    }
+
+    free(test_batch->buffer_sizes);
+    free(test_batch->buffers);
+    free(test_batch->paths);
+}
+
+static void assert_same_image(const struct sail_image *image, const void *buffer, size_t buffer_size) {
+
+    struct sail_image *image_expected;
+    munit_assert(sail_load_from_memory(buffer, buffer_size, &image_expected) == SAIL_OK);
+
+    munit_assert_not_null(image);
+    munit_assert_uint(image->width,  ==, image_expected->width);
+    munit_assert_uint(image->height, ==, image_expected->height);
+    munit_assert(image->pixel_format == image_expected->pixel_format);
+
+    const unsigned packed_bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        munit_assert_memory_equal(packed_bytes_per_line, sail_scan_line(image, row), sail_scan_line(image_expected, row));
+    }
+
+    sail_destroy_image(image_expected);
+}
+
+static MunitResult test_load_batch(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const unsigned threads = (unsigned)atoi(munit_parameters_get(params, "threads"));
+
+    struct test_batch test_batch;
+    alloc_test_batch(&test_batch);
+
+    if (test_batch.length == 0) {
+        destroy_test_batch(&test_batch);
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image **images = munit_newa(struct sail_image *, test_batch.length);
+
+    munit_assert(sail_load_batch_from_memory(test_batch.buffers, test_batch.buffer_sizes, test_batch.length,
+                                             NULL, images, threads) == SAIL_OK);
+
+    for (size_t i = 0; i < test_batch.length; i++) {
+        munit_assert_not_null(images[i]->pixels);
+        assert_same_image(images[i], test_batch.buffers[i], test_batch.buffer_sizes[i]);
+        sail_destroy_image(images[i]);
+    }
+
+    free(images);
+    destroy_test_batch(&test_batch);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_batch_into(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const unsigned threads = (unsigned)atoi(munit_parameters_get(params, "threads"));
+
+    struct test_batch test_batch;
+    alloc_test_batch(&test_batch);
+
+    if (test_batch.length == 0) {
+        destroy_test_batch(&test_batch);
+        return MUNIT_SKIP;
+    }
+
+    /* The largest image defines the stride. */
+    size_t pixels_stride = 0;
+
+    for (size_t i = 0; i < test_batch.length; i++) {
+        struct sail_image *image;
+        munit_assert(sail_probe_memory(test_batch.buffers[i], test_batch.buffer_sizes[i], &image, NULL) == SAIL_OK);
+
+        const size_t pixels_size = (size_t)sail_bytes_per_line(image->width, image->pixel_format) * image->height;
+        pixels_stride = (pixels_size > pixels_stride) ? pixels_size : pixels_stride;
+
+        sail_destroy_image(image);
+    }
+
+    unsigned char *pixels = munit_malloc(pixels_stride * test_batch.length);
+    struct sail_image **images = munit_newa(struct sail_image *, test_batch.length);
+
+    munit_assert(sail_load_batch_from_memory_into(test_batch.buffers, test_batch.buffer_sizes, test_batch.length,
+                                                  NULL, pixels, pixels_stride, images, threads) == SAIL_OK);
+
+    for (size_t i = 0; i < test_batch.length; i++) {
+        munit_assert_ptr_equal(images[i]->pixels, pixels + i * pixels_stride);
+        assert_same_image(images[i], test_batch.buffers[i], test_batch.buffer_sizes[i]);
+
+        images[i]->pixels = NULL;
+        sail_destroy_image(images[i]);
+    }
+
+    free(images);
+    free(pixels);
+    destroy_test_batch(&test_batch);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_batch_failure(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct test_batch test_batch;
+    alloc_test_batch(&test_batch);
+
+    if (test_batch.length == 0) {
+        destroy_test_batch(&test_batch);
+        return MUNIT_SKIP;
+    }
+
+    static const unsigned char garbage[16] = { 0 };
+
+    const void *buffers[] = { garbage, test_batch.buffers[0] };
+    const size_t buffer_sizes[] = { sizeof(garbage), test_batch.buffer_sizes[0] };
+    struct sail_image *images[2];
+
+    munit_assert(sail_load_batch_from_memory(buffers, buffer_sizes, 2, NULL, images, 2) != SAIL_OK);
+
+    /* Failed buffers don't prevent loading the rest. */
+    munit_assert_null(images[0]);
+    munit_assert_not_null(images[1]);
+
+    sail_destroy_image(images[1]);
+    destroy_test_batch(&test_batch);
+
+    return MUNIT_OK;
+}
+
+static char *threads_params[] = { (char *)"0", (char *)"1", (char *)"4", NULL };
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"threads", threads_params },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/load-batch",         test_load_batch,         NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-batch-failure", test_load_batch_failure, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/load-batch-into",    test_load_batch_into,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/load-batch",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
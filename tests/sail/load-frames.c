@@ -0,0 +1,211 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdlib.h>
+
+#include <sail/sail.h>
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static MunitResult test_load_frames(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+    const unsigned threads = (unsigned)atoi(munit_parameters_get(params, "threads"));
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_path(path, &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image **frames;
+    size_t frames_count;
+    munit_assert(sail_load_frames_from_file(path, NULL, &frames, &frames_count, threads) == SAIL_OK);
+    munit_assert_size(frames_count, >, 0);
+
+    /* The same frames in the same order as with sequential loading. */
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file(path, codec_info, &state) == SAIL_OK);
+
+    for (size_t i = 0; i < frames_count; i++) {
+        struct sail_image *image = NULL;
+        munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+        munit_assert(sail_test_compare_images(frames[i], image) == SAIL_OK);
+        sail_destroy_image(image);
+    }
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_ERROR_NO_MORE_FRAMES);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    for (size_t i = 0; i < frames_count; i++) {
+        sail_destroy_image(frames[i]);
+    }
+
+    sail_free(frames);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_first_frame_only(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_path(path, &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->options |= SAIL_OPTION_FIRST_FRAME_ONLY;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+
+    struct sail_image *first_frame = NULL;
+    munit_assert(sail_load_next_frame(state, &first_frame) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_ERROR_NO_MORE_FRAMES);
+    munit_assert_null(image);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    /* The same first frame as with sequential loading of all frames. */
+    munit_assert(sail_start_loading_from_file(path, codec_info, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+    munit_assert(sail_test_compare_images(first_frame, image) == SAIL_OK);
+    sail_destroy_image(image);
+
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+    munit_assert(sail_test_compare_images(first_frame, image) == SAIL_OK);
+    sail_destroy_image(image);
+
+    sail_destroy_image(first_frame);
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_caller_options(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_path(path, &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    struct sail_image *reference = NULL;
+    munit_assert(sail_load_from_file(path, &reference) == SAIL_OK);
+
+    /* Options not allocated by SAIL are deep copied, so they can change after loading has started. */
+    struct sail_load_options load_options_on_stack = *load_options;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, &load_options_on_stack, &state) == SAIL_OK);
+    load_options_on_stack.options |= SAIL_OPTION_PROBE;
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+    munit_assert(sail_test_compare_images(reference, image) == SAIL_OK);
+    sail_destroy_image(image);
+
+    /* Shared options. */
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_file(path, &io) == SAIL_OK);
+    munit_assert(sail_start_loading_from_io_with_shared_options(io, codec_info, load_options, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+    munit_assert(sail_test_compare_images(reference, image) == SAIL_OK);
+    sail_destroy_image(image);
+    sail_destroy_io(io);
+
+    sail_destroy_image(reference);
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_frames_invalid(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    static const unsigned char garbage[16] = { 0 };
+
+    struct sail_image **frames = NULL;
+    size_t frames_count = 0;
+
+    munit_assert(sail_load_frames_from_memory(garbage, sizeof(garbage), NULL, &frames, &frames_count, 4) != SAIL_OK);
+    munit_assert_null(frames);
+    munit_assert_size(frames_count, ==, 0);
+
+    return MUNIT_OK;
+}
+
+static char *threads_params[] = { (char *)"1", (char *)"4", NULL };
+
+static MunitParameterEnum path_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path",    (char **)SAIL_TEST_IMAGES },
+    { (char *)"threads", threads_params },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/load-frames",         test_load_frames,         NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/first-frame-only",    test_first_frame_only,    NULL, NULL, MUNIT_TEST_OPTION_NONE, path_params },
+    { (char *)"/caller-options",      test_caller_options,      NULL, NULL, MUNIT_TEST_OPTION_NONE, path_params },
+    { (char *)"/load-frames-invalid", test_load_frames_invalid, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/load-frames",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
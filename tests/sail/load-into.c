@@ -0,0 +1,879 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static void load_into_and_compare(const char *path, unsigned padding) {
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+
+    const unsigned bytes_per_line = image_file->bytes_per_line + padding;
+    const size_t pixels_size = (size_t)bytes_per_line * image_file->height;
+
+    void *pixels = NULL;
+    munit_assert(sail_malloc(pixels_size, &pixels) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    image->pixels         = pixels;
+    image->bytes_per_line = (padding == 0) ? 0 : bytes_per_line;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file(path, NULL, &state) == SAIL_OK);
+
+    /* Too small buffer. */
+    munit_assert(sail_load_next_frame_into(state, image, pixels_size - 1) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert(sail_start_loading_from_file(path, NULL, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame_into(state, image, pixels_size) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert(image->pixels == pixels);
+    munit_assert(image->bytes_per_line == bytes_per_line);
+    munit_assert(image->width == image_file->width);
+    munit_assert(image->height == image_file->height);
+    munit_assert(image->pixel_format == image_file->pixel_format);
+    munit_assert((image->palette == NULL) == (image_file->palette == NULL));
+
+    for (unsigned row = 0; row < image->height; row++) {
+        munit_assert_memory_equal(image_file->bytes_per_line,
+                                  (const unsigned char *)image->pixels + (size_t)row * bytes_per_line,
+                                  sail_scan_line(image_file, row));
+    }
+
+    image->pixels = NULL;
+    sail_destroy_image(image);
+    sail_free(pixels);
+    sail_destroy_image(image_file);
+}
+
+static MunitResult test_load_into(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    load_into_and_compare(munit_parameters_get(params, "path"), 0);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_into_with_stride(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    load_into_and_compare(munit_parameters_get(params, "path"), 13);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_into_small_stride(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    unsigned char pixels[16];
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+    image->pixels         = pixels;
+    image->bytes_per_line = 1;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file(path, NULL, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame_into(state, image, sizeof(pixels)) == SAIL_ERROR_INCORRECT_BYTES_PER_LINE);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    image->pixels = NULL;
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_with_alignment(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->row_alignment    = 64;
+    load_options->pixels_alignment = 64;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert((uintptr_t)image->pixels % 64 == 0);
+    munit_assert(image->bytes_per_line % 64 == 0);
+    munit_assert(image->bytes_per_line >= image_file->bytes_per_line);
+    munit_assert(image->pixels_alignment == 64);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        munit_assert_memory_equal(image_file->bytes_per_line, sail_scan_line(image, row), sail_scan_line(image_file, row));
+    }
+
+    /* Copies keep the alignment. */
+    struct sail_image *image_copy = NULL;
+    munit_assert(sail_copy_image(image, &image_copy) == SAIL_OK);
+    munit_assert((uintptr_t)image_copy->pixels % 64 == 0);
+
+    sail_destroy_image(image_copy);
+    sail_destroy_image(image);
+    sail_destroy_load_options(load_options);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_file_backed(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+    munit_assert_size(image_file->pixels_file_backed_size, ==, 0);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->file_backed_pixels_threshold = 1;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+
+    const size_t pixels_size = (size_t)image->height * image->bytes_per_line;
+    munit_assert_size(image->pixels_file_backed_size, ==, pixels_size);
+    munit_assert_memory_equal(pixels_size, image->pixels, image_file->pixels);
+
+    /* File-backed pixels are not recycled. */
+    munit_assert(sail_recycle_image(state, image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    /* Frames below the threshold use the heap. */
+    load_options->file_backed_pixels_threshold = pixels_size + 1;
+
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+    munit_assert_size(image->pixels_file_backed_size, ==, 0);
+    sail_destroy_image(image);
+
+    /* Copies stay file-backed. */
+    load_options->file_backed_pixels_threshold = 1;
+
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    struct sail_image *image_copy = NULL;
+    munit_assert(sail_copy_image(image, &image_copy) == SAIL_OK);
+    munit_assert_size(image_copy->pixels_file_backed_size, ==, pixels_size);
+    munit_assert_memory_equal(pixels_size, image_copy->pixels, image_file->pixels);
+
+    sail_destroy_image(image_copy);
+    sail_destroy_image(image);
+    sail_destroy_load_options(load_options);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_recycle_image(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    void *state = NULL;
+    void *reference_state = NULL;
+    munit_assert(sail_start_loading_from_file(path, NULL, &state) == SAIL_OK);
+    munit_assert(sail_start_loading_from_file(path, NULL, &reference_state) == SAIL_OK);
+
+    void *prev_pixels = NULL;
+    size_t prev_pixels_size = 0;
+
+    struct sail_image *image;
+    struct sail_image *reference_image;
+    sail_status_t status;
+
+    while ((status = sail_load_next_frame(state, &image)) == SAIL_OK) {
+        munit_assert(sail_load_next_frame(reference_state, &reference_image) == SAIL_OK);
+
+        const size_t pixels_size = (size_t)image->height * image->bytes_per_line;
+
+        /* Frames of the same size reuse the recycled pixels. */
+        if (pixels_size == prev_pixels_size) {
+            munit_assert(image->pixels == prev_pixels);
+        }
+
+        munit_assert_memory_equal(pixels_size, image->pixels, reference_image->pixels);
+
+        prev_pixels      = image->pixels;
+        prev_pixels_size = pixels_size;
+
+        munit_assert(sail_recycle_image(state, image) == SAIL_OK);
+        sail_destroy_image(reference_image);
+    }
+
+    munit_assert(status == SAIL_ERROR_NO_MORE_FRAMES);
+
+    munit_assert(sail_recycle_image(state, NULL) == SAIL_OK);
+
+    munit_assert(sail_stop_loading(reference_state) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_roi(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    /* Starts on a byte boundary for any pixel format and exceeds the frame to test clipping. */
+    load_options->roi.x      = (image_file->width > 8) ? 8 : 0;
+    load_options->roi.y      = image_file->height / 3;
+    load_options->roi.width  = image_file->width;
+    load_options->roi.height = image_file->height / 2 + 1;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert_uint(image->width, ==, image_file->width - load_options->roi.x);
+    munit_assert_uint(image->height, ==, load_options->roi.height);
+    munit_assert(image->pixel_format == image_file->pixel_format);
+
+    const size_t offset = (size_t)load_options->roi.x * sail_bits_per_pixel(image->pixel_format) / 8;
+    const unsigned bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        munit_assert_memory_equal(bytes_per_line,
+                                  sail_scan_line(image, row),
+                                  (const unsigned char *)sail_scan_line(image_file, load_options->roi.y + row) + offset);
+    }
+
+    /* Outside of the frame. */
+    load_options->roi.x = image_file->width;
+
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+    struct sail_image *image_outside = NULL;
+    munit_assert(sail_load_next_frame(state, &image_outside) == SAIL_ERROR_INVALID_ARGUMENT);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    sail_destroy_image(image);
+    sail_destroy_load_options(load_options);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_scaled(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+    munit_assert_not_null(image_file);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->scale_denominator = 2;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    if (codec_info->load_features->features & SAIL_CODEC_FEATURE_SCALING) {
+        munit_assert_uint(image->width, ==, (image_file->width + 1) / 2);
+        munit_assert_uint(image->height, ==, (image_file->height + 1) / 2);
+    } else {
+        munit_assert_uint(image->width, ==, image_file->width);
+        munit_assert_uint(image->height, ==, image_file->height);
+    }
+
+    munit_assert(image->pixel_format == image_file->pixel_format);
+
+    sail_destroy_image(image);
+    sail_destroy_load_options(load_options);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
+struct rows_context {
+
+    const struct sail_image *expected_image;
+    unsigned next_row;
+};
+
+static sail_status_t compare_row(const struct sail_image *image, unsigned row, const void *scan_line, void *user_data) {
+
+    struct rows_context *rows_context = user_data;
+    const struct sail_image *expected_image = rows_context->expected_image;
+
+    munit_assert_uint(row, ==, rows_context->next_row++);
+    munit_assert_uint(image->width, ==, expected_image->width);
+    munit_assert_uint(image->height, ==, expected_image->height);
+    munit_assert_uint(image->bytes_per_line, ==, sail_bytes_per_line(expected_image->width, expected_image->pixel_format));
+
+    munit_assert_memory_equal(image->bytes_per_line, scan_line, sail_scan_line(expected_image, row));
+
+    return SAIL_OK;
+}
+
+static sail_status_t stop_at_second_row(const struct sail_image *image, unsigned row, const void *scan_line, void *user_data) {
+
+    (void)image;
+    (void)scan_line;
+    (void)user_data;
+
+    return (row == 1) ? SAIL_ERROR_CONFLICTING_OPERATION : SAIL_OK;
+}
+
+static void load_rows_and_compare(const char *path, const struct sail_codec_info *codec_info, struct sail_load_options *load_options) {
+
+    /* Load the expected frame without the row callback. */
+    load_options->row_callback = NULL;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+    struct sail_image *expected_image = NULL;
+    munit_assert(sail_load_next_frame(state, &expected_image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    struct rows_context rows_context = { expected_image, 0 };
+
+    load_options->row_callback           = compare_row;
+    load_options->row_callback_user_data = &rows_context;
+
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert_null(image->pixels);
+    munit_assert_uint(image->width, ==, expected_image->width);
+    munit_assert_uint(image->height, ==, expected_image->height);
+    munit_assert_uint(rows_context.next_row, ==, expected_image->height);
+
+    sail_destroy_image(image);
+    sail_destroy_image(expected_image);
+}
+
+static MunitResult test_load_rows(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    /* Whole frame. */
+    load_rows_and_compare(path, codec_info, load_options);
+
+    /* Region of interest. */
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_probe_file(path, &image_file, NULL) == SAIL_OK);
+
+    load_options->roi.x      = (image_file->width > 8) ? 8 : 0;
+    load_options->roi.y      = image_file->height / 3;
+    load_options->roi.width  = image_file->width;
+    load_options->roi.height = image_file->height / 2 + 1;
+
+    load_rows_and_compare(path, codec_info, load_options);
+
+    /* The status of the row callback stops loading. */
+    load_options->roi          = (struct sail_roi) { 0, 0, 0, 0 };
+    load_options->row_callback = stop_at_second_row;
+
+    if (image_file->height > 1) {
+        void *state = NULL;
+        munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+        struct sail_image *image = NULL;
+        munit_assert(sail_load_next_frame(state, &image) == SAIL_ERROR_CONFLICTING_OPERATION);
+        munit_assert(sail_stop_loading(state) == SAIL_OK);
+    }
+
+    sail_destroy_image(image_file);
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+struct passes_context {
+
+    const struct sail_image *expected_image;
+    unsigned passes;
+    unsigned stop_at_pass;
+};
+
+static sail_status_t count_pass(const struct sail_image *image, unsigned pass, bool *stop, void *user_data) {
+
+    struct passes_context *passes_context = user_data;
+    const struct sail_image *expected_image = passes_context->expected_image;
+
+    munit_assert_uint(pass, ==, ++passes_context->passes);
+    munit_assert_uint(image->width, ==, expected_image->width);
+    munit_assert_uint(image->height, ==, expected_image->height);
+    munit_assert_not_null(image->pixels);
+
+    *stop = (pass == passes_context->stop_at_pass);
+
+    return SAIL_OK;
+}
+
+static MunitResult test_load_passes(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    struct passes_context passes_context = { image_file, 0, 0 };
+
+    load_options->pass_callback           = count_pass;
+    load_options->pass_callback_user_data = &passes_context;
+
+    /* The last pass produces the same image. */
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert_uint(image->width, ==, image_file->width);
+    munit_assert_uint(image->height, ==, image_file->height);
+    munit_assert_uint(image->bytes_per_line, ==, image_file->bytes_per_line);
+    munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image->pixels, image_file->pixels);
+
+    if (!(codec_info->load_features->features & SAIL_CODEC_FEATURE_PASSES)) {
+        munit_assert_uint(passes_context.passes, ==, 0);
+    }
+
+    sail_destroy_image(image);
+
+    /* Stop at the first pass. */
+    if (passes_context.passes > 0) {
+        passes_context.passes       = 0;
+        passes_context.stop_at_pass = 1;
+
+        munit_assert(sail_start_loading_from_file_with_options(path, codec_info, load_options, &state) == SAIL_OK);
+        munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+        munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+        munit_assert_uint(passes_context.passes, ==, 1);
+        munit_assert_uint(image->width, ==, image_file->width);
+        munit_assert_uint(image->height, ==, image_file->height);
+
+        sail_destroy_image(image);
+    }
+
+    sail_destroy_load_options(load_options);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
+/* Returns false if the pixel format of the image is not supported by the test. */
+static bool pixel_to_rgba(const struct sail_image *image, unsigned x, unsigned y, uint8_t rgba[4]) {
+
+    const uint8_t *scan_line = sail_scan_line(image, y);
+    unsigned index;
+
+    switch (image->pixel_format) {
+        case SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE: {
+            rgba[0] = rgba[1] = rgba[2] = scan_line[x];
+            rgba[3] = 255;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP24_RGB: {
+            memcpy(rgba, scan_line + x * 3, 3);
+            rgba[3] = 255;
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP32_RGBA: {
+            memcpy(rgba, scan_line + x * 4, 4);
+            return true;
+        }
+        case SAIL_PIXEL_FORMAT_BPP1_INDEXED: {
+            index = (scan_line[x / 8] >> (7 - x % 8)) & 0x1;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP2_INDEXED: {
+            index = (scan_line[x / 4] >> (6 - x % 4 * 2)) & 0x3;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP4_INDEXED: {
+            index = (scan_line[x / 2] >> (4 - x % 2 * 4)) & 0xF;
+            break;
+        }
+        case SAIL_PIXEL_FORMAT_BPP8_INDEXED: {
+            index = scan_line[x];
+            break;
+        }
+        default: {
+            return false;
+        }
+    }
+
+    if (image->palette == NULL || image->palette->pixel_format != SAIL_PIXEL_FORMAT_BPP24_RGB || index >= image->palette->color_count) {
+        return false;
+    }
+
+    memcpy(rgba, (const uint8_t *)image->palette->data + index * 3, 3);
+    rgba[3] = 255;
+
+    return true;
+}
+
+static MunitResult test_load_output_pixel_format(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image_file = NULL;
+    munit_assert(sail_load_from_file(path, &image_file) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+    load_options->output_pixel_format = SAIL_PIXEL_FORMAT_BPP32_BGRA;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file_with_options(path, NULL, load_options, &state) == SAIL_OK);
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert_uint(image->width, ==, image_file->width);
+    munit_assert_uint(image->height, ==, image_file->height);
+
+    /* Codecs that cannot decode into the requested pixel format return the native one. */
+    if (image->pixel_format != SAIL_PIXEL_FORMAT_BPP32_BGRA) {
+        munit_assert(image->pixel_format == image_file->pixel_format);
+    } else {
+        munit_assert_uint(image->bytes_per_line, ==, sail_bytes_per_line(image->width, image->pixel_format));
+        munit_assert_null(image->palette);
+
+        for (unsigned y = 0; y < image->height; y++) {
+            const uint8_t *scan_line = sail_scan_line(image, y);
+
+            for (unsigned x = 0; x < image->width; x++) {
+                uint8_t rgba[4];
+
+                if (!pixel_to_rgba(image_file, x, y, rgba)) {
+                    continue;
+                }
+
+                const uint8_t *bgra = scan_line + x * 4;
+                munit_assert_uint8(bgra[0], ==, rgba[2]);
+                munit_assert_uint8(bgra[1], ==, rgba[1]);
+                munit_assert_uint8(bgra[2], ==, rgba[0]);
+                munit_assert_uint8(bgra[3], ==, rgba[3]);
+            }
+        }
+    }
+
+    sail_destroy_image(image);
+    sail_destroy_load_options(load_options);
+    sail_destroy_image(image_file);
+
+    return MUNIT_OK;
+}
+
+/* Loads up to 'max_frames' frames in order. */
+static unsigned load_all_frames(void *state, struct sail_image **frames, unsigned max_frames) {
+
+    unsigned count = 0;
+
+    for (; count < max_frames; count++) {
+        const sail_status_t status = sail_load_next_frame(state, &frames[count]);
+
+        if (status == SAIL_ERROR_NO_MORE_FRAMES) {
+            break;
+        }
+
+        munit_assert(status == SAIL_OK);
+    }
+
+    return count;
+}
+
+static void assert_same_frame(const struct sail_image *image, const struct sail_image *reference) {
+
+    munit_assert(image->width == reference->width);
+    munit_assert(image->height == reference->height);
+    munit_assert(image->pixel_format == reference->pixel_format);
+    munit_assert(image->bytes_per_line == reference->bytes_per_line);
+    munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image->pixels, reference->pixels);
+}
+
+static MunitResult test_load_frame_at(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_image *frames[8];
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file(path, codec_info, &state) == SAIL_OK);
+    const unsigned frames_count = load_all_frames(state, frames, 8);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert(frames_count > 0);
+
+    munit_assert(sail_start_loading_from_file(path, codec_info, &state) == SAIL_OK);
+
+    struct sail_image *image;
+
+    if ((codec_info->load_features->features & SAIL_CODEC_FEATURE_SEEK) == 0) {
+        munit_assert(sail_load_frame_at(state, 0, &image) == SAIL_ERROR_NOT_IMPLEMENTED);
+    } else {
+        /* Backwards. */
+        for (unsigned i = frames_count; i > 0; i--) {
+            munit_assert(sail_load_frame_at(state, i - 1, &image) == SAIL_OK);
+            assert_same_frame(image, frames[i - 1]);
+            sail_destroy_image(image);
+        }
+
+        /* Loading continues after the sought frame. */
+        if (frames_count > 1) {
+            munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+            assert_same_frame(image, frames[1]);
+            sail_destroy_image(image);
+        }
+
+        if (frames_count < 8) {
+            munit_assert(sail_load_frame_at(state, frames_count, &image) == SAIL_ERROR_NO_MORE_FRAMES);
+        }
+    }
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    for (unsigned i = 0; i < frames_count; i++) {
+        sail_destroy_image(frames[i]);
+    }
+
+    return MUNIT_OK;
+}
+
+static void append_data(unsigned char **buffer, size_t *size, const void *data, size_t data_size) {
+
+    void *ptr = *buffer;
+    munit_assert(sail_realloc(*size + data_size, &ptr) == SAIL_OK);
+    *buffer = ptr;
+
+    memcpy(*buffer + *size, data, data_size);
+    *size += data_size;
+}
+
+static MunitResult test_load_frame_at_multi_paged(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("ico", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    /* Take single-frame icons and join them into a single multi-paged icon of A, B, A. */
+    const char *paths[2] = { NULL, NULL };
+    unsigned found = 0;
+
+    for (const char * const *path = SAIL_TEST_IMAGES; *path != NULL && found < 2; path++) {
+        const size_t length = strlen(*path);
+
+        if (length > 4 && strcmp(*path + length - 4, ".ico") == 0) {
+            paths[found++] = *path;
+        }
+    }
+
+    if (found < 2) {
+        return MUNIT_SKIP;
+    }
+
+    void *sources[2];
+    size_t sources_size[2];
+
+    for (unsigned i = 0; i < 2; i++) {
+        munit_assert(sail_alloc_data_from_file_contents(paths[i], &sources[i], &sources_size[i]) == SAIL_OK);
+    }
+
+    const unsigned order[3] = { 0, 1, 0 };
+    const unsigned header_size = 6;
+    const unsigned entry_size = 16;
+
+    unsigned char *ico = NULL;
+    size_t ico_size = 0;
+
+    const unsigned char header[6] = { 0, 0, 1, 0, 3, 0 };
+    append_data(&ico, &ico_size, header, sizeof(header));
+
+    uint32_t offset = header_size + 3 * entry_size;
+
+    for (unsigned i = 0; i < 3; i++) {
+        const unsigned char *source = sources[order[i]];
+        unsigned char entry[16];
+        memcpy(entry, source + header_size, sizeof(entry));
+
+        const uint32_t image_size = (uint32_t)(sources_size[order[i]] - header_size - entry_size);
+
+        for (unsigned b = 0; b < 4; b++) {
+            entry[8 + b]  = (unsigned char)(image_size >> (8 * b));
+            entry[12 + b] = (unsigned char)(offset >> (8 * b));
+        }
+
+        append_data(&ico, &ico_size, entry, sizeof(entry));
+        offset += image_size;
+    }
+
+    for (unsigned i = 0; i < 3; i++) {
+        append_data(&ico, &ico_size, (const unsigned char *)sources[order[i]] + header_size + entry_size,
+                    sources_size[order[i]] - header_size - entry_size);
+    }
+
+    struct sail_image *references[2];
+    for (unsigned i = 0; i < 2; i++) {
+        munit_assert(sail_load_from_memory(sources[i], sources_size[i], &references[i]) == SAIL_OK);
+    }
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_memory(ico, ico_size, codec_info, &state) == SAIL_OK);
+
+    struct sail_image *image;
+
+    for (unsigned i = 3; i > 0; i--) {
+        munit_assert(sail_load_frame_at(state, i - 1, &image) == SAIL_OK);
+        assert_same_frame(image, references[order[i - 1]]);
+        sail_destroy_image(image);
+    }
+
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    assert_same_frame(image, references[order[1]]);
+    sail_destroy_image(image);
+
+    munit_assert(sail_load_frame_at(state, 3, &image) == SAIL_ERROR_NO_MORE_FRAMES);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    for (unsigned i = 0; i < 2; i++) {
+        sail_destroy_image(references[i]);
+        sail_free(sources[i]);
+    }
+    sail_free(ico);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/load-file-backed",          test_load_file_backed,          NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-frame-at",             test_load_frame_at,             NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-frame-at-multi-paged", test_load_frame_at_multi_paged, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/load-into",                 test_load_into,                 NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-into-small-stride",    test_load_into_small_stride,    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-into-with-stride",     test_load_into_with_stride,     NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-output-pixel-format",  test_load_output_pixel_format,  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-passes",               test_load_passes,               NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-roi",                  test_load_roi,                  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-rows",                 test_load_rows,                 NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-scaled",               test_load_scaled,               NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-with-alignment",       test_load_with_alignment,       NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/recycle-image",             test_recycle_image,             NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/load-into",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,186 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+static void append_meta_data(struct sail_meta_data_node ***last_meta_data_node, enum SailMetaData key, const char *value) {
+
+    struct sail_meta_data_node *meta_data_node;
+    munit_assert(sail_alloc_meta_data_node(&meta_data_node) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_and_value_from_known_key(key, &meta_data_node->meta_data) == SAIL_OK);
+
+    if (key == SAIL_META_DATA_EXIF) {
+        munit_assert(sail_set_variant_data(meta_data_node->meta_data->value, value, strlen(value)) == SAIL_OK);
+    } else {
+        munit_assert(sail_set_variant_string(meta_data_node->meta_data->value, value) == SAIL_OK);
+    }
+
+    **last_meta_data_node = meta_data_node;
+    *last_meta_data_node  = &meta_data_node->next;
+}
+
+/* Saves an image with a comment, EXIF, and XMP with the specified codec. */
+static void save_image(const struct sail_codec_info *codec_info, void **buffer, size_t *buffer_size) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = 16;
+    image->height         = 8;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+    memset(image->pixels, 0x80, (size_t)image->bytes_per_line * image->height);
+
+    struct sail_meta_data_node **last_meta_data_node = &image->meta_data_node;
+    append_meta_data(&last_meta_data_node, SAIL_META_DATA_COMMENT, "Comment");
+    append_meta_data(&last_meta_data_node, SAIL_META_DATA_EXIF,    "II*\0");
+    append_meta_data(&last_meta_data_node, SAIL_META_DATA_XMP,     "<x:xmpmeta xmlns:x=\"adobe:ns:meta/\"/>");
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory(codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_saving_into_growable_memory(state, buffer, buffer_size) == SAIL_OK);
+
+    sail_destroy_image(image);
+}
+
+/* Returns the or-ed SAIL_META_DATA_KEY_BIT() bits of the loaded meta data keys. */
+static uint64_t load_meta_data_keys(const void *buffer, size_t buffer_size, const struct sail_codec_info *codec_info, uint64_t meta_data_keys) {
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->meta_data_keys = meta_data_keys;
+
+    void *state;
+    munit_assert(sail_start_loading_from_memory_with_options(buffer, buffer_size, codec_info, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    uint64_t loaded_meta_data_keys = 0;
+
+    for (const struct sail_meta_data_node *node = image->meta_data_node; node != NULL; node = node->next) {
+        loaded_meta_data_keys |= SAIL_META_DATA_KEY_BIT(node->meta_data->key);
+    }
+
+    sail_destroy_image(image);
+    sail_destroy_load_options(load_options);
+
+    return loaded_meta_data_keys;
+}
+
+static MunitResult test_meta_data_keys(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension(munit_parameters_get(params, "extension"), &codec_info) == SAIL_OK);
+
+    void *buffer;
+    size_t buffer_size;
+    save_image(codec_info, &buffer, &buffer_size);
+
+    const uint64_t comment = SAIL_META_DATA_KEY_BIT(SAIL_META_DATA_COMMENT);
+    const uint64_t exif    = SAIL_META_DATA_KEY_BIT(SAIL_META_DATA_EXIF);
+    const uint64_t xmp     = SAIL_META_DATA_KEY_BIT(SAIL_META_DATA_XMP);
+
+    /* 0 selects all keys. */
+    munit_assert_uint64(load_meta_data_keys(buffer, buffer_size, codec_info, 0), ==, comment | exif | xmp);
+
+    munit_assert_uint64(load_meta_data_keys(buffer, buffer_size, codec_info, comment), ==, comment);
+    munit_assert_uint64(load_meta_data_keys(buffer, buffer_size, codec_info, exif), ==, exif);
+    munit_assert_uint64(load_meta_data_keys(buffer, buffer_size, codec_info, xmp), ==, xmp);
+    munit_assert_uint64(load_meta_data_keys(buffer, buffer_size, codec_info, comment | xmp), ==, comment | xmp);
+
+    /* Keys that are not stored select nothing. */
+    munit_assert_uint64(load_meta_data_keys(buffer, buffer_size, codec_info, SAIL_META_DATA_KEY_BIT(SAIL_META_DATA_ARTIST)), ==, 0);
+
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_load_meta_data_key(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+
+    /* Nothing without SAIL_OPTION_META_DATA. */
+    munit_assert_false(sail_load_meta_data_key(load_options, SAIL_META_DATA_EXIF));
+    munit_assert_false(sail_load_meta_data_key(NULL, SAIL_META_DATA_EXIF));
+
+    load_options->options = SAIL_OPTION_META_DATA;
+    munit_assert_true(sail_load_meta_data_key(load_options, SAIL_META_DATA_EXIF));
+    munit_assert_true(sail_load_meta_data_key(load_options, SAIL_META_DATA_UNKNOWN));
+
+    load_options->meta_data_keys = SAIL_META_DATA_KEY_BIT(SAIL_META_DATA_EXIF);
+    munit_assert_true(sail_load_meta_data_key(load_options, SAIL_META_DATA_EXIF));
+    munit_assert_false(sail_load_meta_data_key(load_options, SAIL_META_DATA_XMP));
+    munit_assert_false(sail_load_meta_data_key(load_options, SAIL_META_DATA_UNKNOWN));
+
+    /* Copies keep the keys. */
+    struct sail_load_options *load_options_copy;
+    munit_assert(sail_copy_load_options(load_options, &load_options_copy) == SAIL_OK);
+    munit_assert_uint64(load_options_copy->meta_data_keys, ==, SAIL_META_DATA_KEY_BIT(SAIL_META_DATA_EXIF));
+
+    sail_destroy_load_options(load_options_copy);
+    sail_destroy_load_options(load_options);
+
+    return MUNIT_OK;
+}
+
+static char *extension_params[] = { (char *)"png", (char *)"jpg", (char *)"sraw", NULL };
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"extension", extension_params },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/meta-data-keys",     test_meta_data_keys,     NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/load-meta-data-key", test_load_meta_data_key, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/meta-data-keys",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,475 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+/*
+ * Corpus of adversarial but valid inputs that stress the worst paths of the decoders.
+ * The inputs are generated in memory, so the corpus is deterministic and needs no
+ * binary files. Every input carries a time budget per processed byte, which is an input byte
+ * or a byte of the decoded pixels, and a memory budget relative to the decoded pixels
+ * to catch superlinear decoding costs.
+ */
+
+struct corpus_buffer {
+
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+};
+
+static void buffer_append(struct corpus_buffer *buffer, const void *data, size_t size) {
+
+    if (buffer->size + size > buffer->capacity) {
+        size_t capacity = (buffer->capacity == 0) ? 4096 : buffer->capacity;
+
+        while (capacity < buffer->size + size) {
+            capacity *= 2;
+        }
+
+        void *ptr = buffer->data;
+        munit_assert(sail_realloc(capacity, &ptr) == SAIL_OK);
+
+        buffer->data     = ptr;
+        buffer->capacity = capacity;
+    }
+
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+
+static void buffer_append_byte(struct corpus_buffer *buffer, uint8_t value) {
+
+    buffer_append(buffer, &value, 1);
+}
+
+static void buffer_append_le16(struct corpus_buffer *buffer, uint16_t value) {
+
+    const uint8_t bytes[] = { (uint8_t)value, (uint8_t)(value >> 8) };
+    buffer_append(buffer, bytes, sizeof(bytes));
+}
+
+static void buffer_append_le32(struct corpus_buffer *buffer, uint32_t value) {
+
+    const uint8_t bytes[] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    buffer_append(buffer, bytes, sizeof(bytes));
+}
+
+static void buffer_append_be16(struct corpus_buffer *buffer, uint16_t value) {
+
+    const uint8_t bytes[] = { (uint8_t)(value >> 8), (uint8_t)value };
+    buffer_append(buffer, bytes, sizeof(bytes));
+}
+
+static void buffer_append_be32(struct corpus_buffer *buffer, uint32_t value) {
+
+    const uint8_t bytes[] = { (uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value };
+    buffer_append(buffer, bytes, sizeof(bytes));
+}
+
+static void buffer_append_zeros(struct corpus_buffer *buffer, size_t size) {
+
+    for (size_t i = 0; i < size; i++) {
+        buffer_append_byte(buffer, 0);
+    }
+}
+
+/*
+ * Generators.
+ */
+
+/* BMP with RLE8 runs of a single pixel, so every pixel costs a run. */
+static void generate_bmp_rle8_single_runs(struct corpus_buffer *buffer) {
+
+    const unsigned width = 1024;
+    const unsigned height = 256;
+    const uint32_t palette_size = 256 * 4;
+    const uint32_t data_size = height * (width * 2 + 2) + 2;
+
+    /* File header. */
+    buffer_append(buffer, "BM", 2);
+    buffer_append_le32(buffer, 14 + 40 + palette_size + data_size);
+    buffer_append_le32(buffer, 0);
+    buffer_append_le32(buffer, 14 + 40 + palette_size);
+
+    /* BITMAPINFOHEADER. */
+    buffer_append_le32(buffer, 40);
+    buffer_append_le32(buffer, width);
+    buffer_append_le32(buffer, height);
+    buffer_append_le16(buffer, 1);
+    buffer_append_le16(buffer, 8);
+    buffer_append_le32(buffer, 1); /* BI_RLE8. */
+    buffer_append_le32(buffer, data_size);
+    buffer_append_le32(buffer, 2835);
+    buffer_append_le32(buffer, 2835);
+    buffer_append_le32(buffer, 256);
+    buffer_append_le32(buffer, 0);
+
+    for (unsigned i = 0; i < 256; i++) {
+        const uint8_t entry[] = { (uint8_t)i, (uint8_t)i, (uint8_t)i, 0 };
+        buffer_append(buffer, entry, sizeof(entry));
+    }
+
+    for (unsigned row = 0; row < height; row++) {
+        for (unsigned column = 0; column < width; column++) {
+            buffer_append_byte(buffer, 1);
+            buffer_append_byte(buffer, (uint8_t)(row + column));
+        }
+
+        /* End of line. */
+        buffer_append_byte(buffer, 0);
+        buffer_append_byte(buffer, 0);
+    }
+
+    /* End of bitmap. */
+    buffer_append_byte(buffer, 0);
+    buffer_append_byte(buffer, 1);
+}
+
+/* RGB PCX with every byte escaped as a run of one. */
+static void generate_pcx_single_runs(struct corpus_buffer *buffer) {
+
+    const unsigned width = 1024;
+    const unsigned height = 128;
+
+    buffer_append_byte(buffer, 0x0A);
+    buffer_append_byte(buffer, 5);
+    buffer_append_byte(buffer, 1);
+    buffer_append_byte(buffer, 8);
+    buffer_append_le16(buffer, 0);
+    buffer_append_le16(buffer, 0);
+    buffer_append_le16(buffer, (uint16_t)(width - 1));
+    buffer_append_le16(buffer, (uint16_t)(height - 1));
+    buffer_append_le16(buffer, 72);
+    buffer_append_le16(buffer, 72);
+    buffer_append_zeros(buffer, 48);
+    buffer_append_byte(buffer, 0);
+    buffer_append_byte(buffer, 3);
+    buffer_append_le16(buffer, (uint16_t)width);
+    buffer_append_le16(buffer, 1);
+    buffer_append_le16(buffer, 0);
+    buffer_append_le16(buffer, 0);
+    buffer_append_zeros(buffer, 54);
+
+    for (size_t i = 0; i < (size_t)width * height * 3; i++) {
+        buffer_append_byte(buffer, 0xC1);
+        buffer_append_byte(buffer, 0xFF);
+    }
+}
+
+/* Interlaced PNG of one column, so every row of every pass is a separate tiny row. */
+static void generate_png_interlaced_column(struct corpus_buffer *buffer) {
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("png", &codec_info) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = 1;
+    image->height         = 131072;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE;
+    image->bytes_per_line = 1;
+
+    munit_assert(sail_alloc_image_pixels(image, false) == SAIL_OK);
+
+    unsigned char *pixels = image->pixels;
+
+    for (unsigned row = 0; row < image->height; row++) {
+        pixels[row] = (unsigned char)(row * 31);
+    }
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+    save_options->options |= SAIL_OPTION_INTERLACED;
+
+    void *state = NULL;
+    munit_assert(sail_start_saving_into_growable_memory_with_options(codec_info, save_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_stop_saving_into_growable_memory(state, &data, &data_size) == SAIL_OK);
+
+    buffer_append(buffer, data, data_size);
+
+    sail_free(data);
+    sail_destroy_save_options(save_options);
+    sail_destroy_image(image);
+}
+
+/* PSD with the maximum number of channels. Only the composite channels must be decoded. */
+static void generate_psd_many_channels(struct corpus_buffer *buffer) {
+
+    const unsigned width = 512;
+    const unsigned height = 512;
+    const unsigned channels = 56;
+    const unsigned packets = width / 128;
+
+    buffer_append(buffer, "8BPS", 4);
+    buffer_append_be16(buffer, 1);
+    buffer_append_zeros(buffer, 6);
+    buffer_append_be16(buffer, (uint16_t)channels);
+    buffer_append_be32(buffer, height);
+    buffer_append_be32(buffer, width);
+    buffer_append_be16(buffer, 8);
+    buffer_append_be16(buffer, 3); /* RGB. */
+
+    /* Color mode data, image resources, layer and mask information. */
+    buffer_append_be32(buffer, 0);
+    buffer_append_be32(buffer, 0);
+    buffer_append_be32(buffer, 0);
+
+    /* RLE. */
+    buffer_append_be16(buffer, 1);
+
+    for (unsigned i = 0; i < channels * height; i++) {
+        buffer_append_be16(buffer, (uint16_t)(packets * 2));
+    }
+
+    for (unsigned i = 0; i < channels * height; i++) {
+        for (unsigned packet = 0; packet < packets; packet++) {
+            /* 128 repeated bytes. */
+            buffer_append_byte(buffer, 0x81);
+            buffer_append_byte(buffer, (uint8_t)i);
+        }
+    }
+}
+
+/* RLE TGA with raw packets of a single pixel, so every pixel costs a packet. */
+static void generate_tga_single_packets(struct corpus_buffer *buffer) {
+
+    const unsigned width = 1024;
+    const unsigned height = 256;
+
+    buffer_append_byte(buffer, 0);
+    buffer_append_byte(buffer, 0);
+    buffer_append_byte(buffer, 10); /* RLE true color. */
+    buffer_append_zeros(buffer, 5);
+    buffer_append_le16(buffer, 0);
+    buffer_append_le16(buffer, 0);
+    buffer_append_le16(buffer, (uint16_t)width);
+    buffer_append_le16(buffer, (uint16_t)height);
+    buffer_append_byte(buffer, 24);
+    buffer_append_byte(buffer, 0x20); /* Top-left origin. */
+
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        const uint8_t packet[] = { 0, (uint8_t)i, (uint8_t)(i >> 8), (uint8_t)(i >> 16) };
+        buffer_append(buffer, packet, sizeof(packet));
+    }
+}
+
+/* XBM with a megabyte-long literal stream. */
+static void generate_xbm_long_literals(struct corpus_buffer *buffer) {
+
+    const unsigned width = 2048;
+    const unsigned height = 512;
+    const size_t bytes = (size_t)width / 8 * height;
+
+    char line[64];
+    snprintf(line, sizeof(line), "#define long_width %u\n#define long_height %u\n", width, height);
+    buffer_append(buffer, line, strlen(line));
+
+    const char *declaration = "static unsigned char long_bits[] = {\n";
+    buffer_append(buffer, declaration, strlen(declaration));
+
+    for (size_t i = 0; i < bytes; i++) {
+        snprintf(line, sizeof(line), "0x%02x%s", (unsigned)(i * 7) & 0xFF,
+                    (i + 1 == bytes) ? "};\n" : ((i % 12 == 11) ? ",\n" : ", "));
+        buffer_append(buffer, line, strlen(line));
+    }
+}
+
+/*
+ * Corpus.
+ */
+
+struct corpus_entry {
+
+    const char *name;
+    const char *extension;
+    void (*generate)(struct corpus_buffer *buffer);
+    /* Maximum decoding time per input and pixel byte. Generous to stay stable on slow and instrumented builds. */
+    unsigned max_ns_per_byte;
+    /* Maximum bytes allocated while decoding per byte of the decoded pixels. */
+    unsigned max_allocations_factor;
+};
+
+static const struct corpus_entry corpus[] = {
+    { "bmp-rle8-single-runs",    "bmp", generate_bmp_rle8_single_runs,  200,  2 },
+    { "pcx-single-runs",         "pcx", generate_pcx_single_runs,       200,  2 },
+    { "png-interlaced-column",   "png", generate_png_interlaced_column, 2000, 2 },
+    { "psd-many-channels",       "psd", generate_psd_many_channels,     200,  2 },
+    { "tga-single-packets",      "tga", generate_tga_single_packets,    200,  2 },
+    { "xbm-long-literals",       "xbm", generate_xbm_long_literals,     200,  2 },
+};
+
+static char *corpus_names[] = {
+    (char *)"bmp-rle8-single-runs",
+    (char *)"pcx-single-runs",
+    (char *)"png-interlaced-column",
+    (char *)"psd-many-channels",
+    (char *)"tga-single-packets",
+    (char *)"xbm-long-literals",
+    NULL
+};
+
+static const struct corpus_entry* find_entry(const char *name) {
+
+    for (size_t i = 0; i < sizeof(corpus) / sizeof(corpus[0]); i++) {
+        if (strcmp(corpus[i].name, name) == 0) {
+            return &corpus[i];
+        }
+    }
+
+    return NULL;
+}
+
+static MunitResult test_budget(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const struct corpus_entry *entry = find_entry(munit_parameters_get(params, "input"));
+    munit_assert_not_null(entry);
+
+    const struct sail_codec_info *codec_info;
+
+    if (sail_codec_info_from_extension(entry->extension, &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct corpus_buffer buffer = { NULL, 0, 0 };
+    entry->generate(&buffer);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    /* The best of several runs to filter out the scheduling noise. */
+    uint64_t best_ns = UINT64_MAX;
+    struct sail_stats stats;
+    size_t pixels_size = 0;
+
+    for (unsigned i = 0; i < 3; i++) {
+        stats = (struct sail_stats) { 0 };
+        load_options->stats = &stats;
+
+        const uint64_t start_ns = sail_now_ns();
+
+        void *state = NULL;
+        munit_assert(sail_start_loading_from_memory_with_options(buffer.data, buffer.size, codec_info, load_options, &state) == SAIL_OK);
+
+        struct sail_image *image;
+        munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+        munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+        const uint64_t elapsed_ns = sail_now_ns() - start_ns;
+        best_ns = (elapsed_ns < best_ns) ? elapsed_ns : best_ns;
+
+        pixels_size = (size_t)image->height * image->bytes_per_line;
+        sail_destroy_image(image);
+    }
+
+    const size_t processed_size = buffer.size + pixels_size;
+
+    munit_logf(MUNIT_LOG_INFO, "%s: %zu input bytes, %.1f ns/byte, %llu bytes allocated for %zu bytes of pixels",
+                entry->name, buffer.size, (double)best_ns / processed_size,
+                (unsigned long long)stats.allocated_bytes, pixels_size);
+
+    munit_assert_uint64(best_ns, <=, (uint64_t)entry->max_ns_per_byte * processed_size);
+    munit_assert_uint64(stats.allocated_bytes, <=, (uint64_t)entry->max_allocations_factor * pixels_size);
+
+    sail_destroy_load_options(load_options);
+    sail_free(buffer.data);
+
+    return MUNIT_OK;
+}
+
+/* A streamed WebP header must not make the decoder allocate the size it claims. */
+static MunitResult test_oversized_header(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+
+    if (sail_codec_info_from_extension("webp", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct corpus_buffer buffer = { NULL, 0, 0 };
+    buffer_append(&buffer, "RIFF", 4);
+    buffer_append_le32(&buffer, 0xFFFFFFF0);
+    buffer_append(&buffer, "WEBPVP8 ", 8);
+    buffer_append_zeros(&buffer, 64);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+
+    struct sail_stats stats = { 0 };
+    load_options->stats = &stats;
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_memory(buffer.data, buffer.size, &io) == SAIL_OK);
+    io->features &= ~SAIL_IO_FEATURE_MAPPED;
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_io_with_options(io, codec_info, load_options, &state) != SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert_uint64(stats.allocated_bytes, <, 1024 * 1024);
+
+    sail_destroy_io(io);
+    sail_destroy_load_options(load_options);
+    sail_free(buffer.data);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"input", corpus_names },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/budget",          test_budget,          NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/oversized-header", test_oversized_header, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/pathological",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,229 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+/* Saves a 4:2:0 JPEG, the default sampling of libjpeg for YCbCr. */
+static void save_jpeg(void **buffer, size_t *buffer_size) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = 48;
+    image->height         = 24;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_YCBCR;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * image->height, &image->pixels) == SAIL_OK);
+
+    for (unsigned row = 0; row < image->height; row++) {
+        unsigned char *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < image->width; column++) {
+            scan[column * 3 + 0] = (unsigned char)(column * 5);
+            scan[column * 3 + 1] = (unsigned char)(row * 9);
+            scan[column * 3 + 2] = (unsigned char)((column + row) * 3);
+        }
+    }
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("jpg", &codec_info) == SAIL_OK);
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory(codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_saving_into_growable_memory(state, buffer, buffer_size) == SAIL_OK);
+
+    sail_destroy_image(image);
+}
+
+static struct sail_image* load_jpeg(const void *buffer, size_t buffer_size, enum SailPixelFormat output_pixel_format) {
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("jpg", &codec_info) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options(&load_options) == SAIL_OK);
+    load_options->output_pixel_format = output_pixel_format;
+
+    void *state;
+    munit_assert(sail_start_loading_from_memory_with_options(buffer, buffer_size, codec_info, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    sail_destroy_load_options(load_options);
+
+    return image;
+}
+
+/* Asserts the luma plane matches the luma channel of the packed YCbCr image. */
+static void assert_luma_equal(const struct sail_image *planar_image, const struct sail_image *ycbcr_image) {
+
+    munit_assert_uint(planar_image->width, ==, ycbcr_image->width);
+    munit_assert_uint(planar_image->height, ==, ycbcr_image->height);
+
+    void *planes[4];
+    unsigned strides[4];
+    unsigned planes_count;
+    munit_assert(sail_image_planes(planar_image, planes, strides, &planes_count) == SAIL_OK);
+
+    for (unsigned row = 0; row < planar_image->height; row++) {
+        const unsigned char *luma = (const unsigned char *)planes[0] + (size_t)row * strides[0];
+        const unsigned char *scan = sail_scan_line(ycbcr_image, row);
+
+        for (unsigned column = 0; column < planar_image->width; column++) {
+            munit_assert_uint8(luma[column], ==, scan[column * 3]);
+        }
+    }
+}
+
+static MunitResult test_jpeg_420(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    void *buffer;
+    size_t buffer_size;
+    save_jpeg(&buffer, &buffer_size);
+
+    struct sail_image *ycbcr_image = load_jpeg(buffer, buffer_size, SAIL_PIXEL_FORMAT_BPP24_YCBCR);
+    munit_assert_int(ycbcr_image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP24_YCBCR);
+
+    struct sail_image *i420_image = load_jpeg(buffer, buffer_size, SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420);
+    munit_assert_int(i420_image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP12_YCBCR_I420);
+    munit_assert_uint(i420_image->bytes_per_line, ==, sail_bytes_per_line(i420_image->width, i420_image->pixel_format));
+    assert_luma_equal(i420_image, ycbcr_image);
+
+    struct sail_image *nv12_image = load_jpeg(buffer, buffer_size, SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12);
+    munit_assert_int(nv12_image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP12_YCBCR_NV12);
+    assert_luma_equal(nv12_image, ycbcr_image);
+
+    /* NV12 interleaves the same chroma samples. */
+    void *i420_planes[4];
+    void *nv12_planes[4];
+    unsigned strides[4];
+    unsigned planes_count;
+    munit_assert(sail_image_planes(i420_image, i420_planes, strides, &planes_count) == SAIL_OK);
+    munit_assert(sail_image_planes(nv12_image, nv12_planes, strides, &planes_count) == SAIL_OK);
+
+    const size_t chroma_size = (size_t)(i420_image->width / 2) * (i420_image->height / 2);
+
+    for (size_t i = 0; i < chroma_size; i++) {
+        munit_assert_uint8(((const unsigned char *)nv12_planes[1])[i * 2],     ==, ((const unsigned char *)i420_planes[1])[i]);
+        munit_assert_uint8(((const unsigned char *)nv12_planes[1])[i * 2 + 1], ==, ((const unsigned char *)i420_planes[2])[i]);
+    }
+
+    /* 4:2:0 samples cannot be output as 4:4:4 without upsampling. */
+    struct sail_image *fallback_image = load_jpeg(buffer, buffer_size, SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444);
+    munit_assert(!sail_is_planar(fallback_image->pixel_format));
+
+    sail_destroy_image(fallback_image);
+    sail_destroy_image(nv12_image);
+    sail_destroy_image(i420_image);
+    sail_destroy_image(ycbcr_image);
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_jpeg_444(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const char *path = NULL;
+
+    for (const char * const *test_path = SAIL_TEST_IMAGES; *test_path != NULL; test_path++) {
+        if (strstr(*test_path, "bpp24-ycbcr") != NULL) {
+            path = *test_path;
+            break;
+        }
+    }
+
+    if (path == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    void *buffer;
+    size_t buffer_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &buffer, &buffer_size) == SAIL_OK);
+
+    struct sail_image *ycbcr_image = load_jpeg(buffer, buffer_size, SAIL_PIXEL_FORMAT_BPP24_YCBCR);
+    struct sail_image *i444_image  = load_jpeg(buffer, buffer_size, SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444);
+    munit_assert_int(i444_image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP24_YCBCR_I444);
+
+    /* Without subsampling the planes hold exactly the packed samples. */
+    void *planes[4];
+    unsigned strides[4];
+    unsigned planes_count;
+    munit_assert(sail_image_planes(i444_image, planes, strides, &planes_count) == SAIL_OK);
+    munit_assert_uint(planes_count, ==, 3);
+
+    for (unsigned row = 0; row < i444_image->height; row++) {
+        const unsigned char *scan = sail_scan_line(ycbcr_image, row);
+
+        for (unsigned column = 0; column < i444_image->width; column++) {
+            for (unsigned i = 0; i < 3; i++) {
+                munit_assert_uint8(((const unsigned char *)planes[i])[(size_t)row * strides[i] + column], ==, scan[column * 3 + i]);
+            }
+        }
+    }
+
+    sail_destroy_image(i444_image);
+    sail_destroy_image(ycbcr_image);
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/jpeg-420", test_jpeg_420, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/jpeg-444", test_jpeg_444, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/planar",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
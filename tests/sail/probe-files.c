@@ -0,0 +1,128 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdlib.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static size_t test_images_count(void) {
+
+    size_t count = 0;
+
+    while (SAIL_TEST_IMAGES[count] != NULL) {
+        count++;
+    }
+
+    return count;
+}
+
+static MunitResult test_probe_files(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const unsigned threads = (unsigned)atoi(munit_parameters_get(params, "threads"));
+    const size_t count = test_images_count();
+
+    if (count == 0) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image **images = munit_newa(struct sail_image *, count);
+    const struct sail_codec_info **codec_infos = munit_newa(const struct sail_codec_info *, count);
+
+    munit_assert(sail_probe_files(SAIL_TEST_IMAGES, count, images, codec_infos, threads) == SAIL_OK);
+
+    for (size_t i = 0; i < count; i++) {
+        struct sail_image *image;
+        const struct sail_codec_info *codec_info;
+        munit_assert(sail_probe_file(SAIL_TEST_IMAGES[i], &image, &codec_info) == SAIL_OK);
+
+        munit_assert_not_null(images[i]);
+        munit_assert_null(images[i]->pixels);
+        munit_assert_uint(images[i]->width, ==, image->width);
+        munit_assert_uint(images[i]->height, ==, image->height);
+        munit_assert(images[i]->pixel_format == image->pixel_format);
+        munit_assert_ptr_equal(codec_infos[i], codec_info);
+
+        sail_destroy_image(image);
+        sail_destroy_image(images[i]);
+    }
+
+    free(codec_infos);
+    free(images);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_probe_files_failure(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    if (SAIL_TEST_IMAGES[0] == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    const char * const paths[] = { "not-existing.png", SAIL_TEST_IMAGES[0] };
+    struct sail_image *images[2];
+
+    munit_assert(sail_probe_files(paths, 2, images, NULL, 2) != SAIL_OK);
+
+    /* Failed files don't prevent probing the rest. */
+    munit_assert_null(images[0]);
+    munit_assert_not_null(images[1]);
+
+    sail_destroy_image(images[1]);
+
+    return MUNIT_OK;
+}
+
+static char *threads_params[] = { (char *)"0", (char *)"1", (char *)"4", NULL };
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"threads", threads_params },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/probe-files",         test_probe_files,         NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/probe-files-failure", test_probe_files_failure, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/probe-files",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,158 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+/* Counts the bytes read through the wrapped file I/O object. */
+static sail_io_tolerant_read_t original_tolerant_read;
+static sail_io_strict_read_t original_strict_read;
+static size_t bytes_read;
+
+static sail_status_t counting_tolerant_read(void *stream, void *buf, size_t size_to_read, size_t *read_size) {
+
+    SAIL_TRY(original_tolerant_read(stream, buf, size_to_read, read_size));
+
+    bytes_read += *read_size;
+
+    return SAIL_OK;
+}
+
+static sail_status_t counting_strict_read(void *stream, void *buf, size_t size_to_read) {
+
+    SAIL_TRY(original_strict_read(stream, buf, size_to_read));
+
+    bytes_read += size_to_read;
+
+    return SAIL_OK;
+}
+
+/*
+ * These codecs or their underlying libraries read the whole file or large
+ * chunks of it ahead, so small test images may be read entirely even when probing.
+ */
+static bool reads_whole_file(const char *codec_name) {
+
+    static const char * const names[] = { "AVIF", "JPEG", "JPEG2000", "JPEGXL", "SVG", "WEBP" };
+
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(codec_name, names[i]) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static size_t load_first_frame_and_count(const char *path, int options, struct sail_image **image) {
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->options |= options;
+
+    struct sail_io *io;
+    munit_assert(sail_alloc_io_read_file(path, &io) == SAIL_OK);
+
+    original_tolerant_read = io->tolerant_read;
+    original_strict_read   = io->strict_read;
+    io->tolerant_read      = counting_tolerant_read;
+    io->strict_read        = counting_strict_read;
+    bytes_read             = 0;
+
+    void *state;
+    munit_assert(sail_start_loading_from_io_with_options(io, codec_info, load_options, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    sail_destroy_io(io);
+    sail_destroy_load_options(load_options);
+
+    return bytes_read;
+}
+
+static MunitResult test_header_only(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    const size_t full_bytes_read = load_first_frame_and_count(path, 0, &image);
+
+    struct sail_image *probed_image;
+    const size_t probe_bytes_read = load_first_frame_and_count(path, SAIL_OPTION_PROBE, &probed_image);
+
+    munit_assert_null(probed_image->pixels);
+    munit_assert_null(probed_image->meta_data_node);
+    munit_assert_null(probed_image->iccp);
+    munit_assert_uint(probed_image->width, ==, image->width);
+    munit_assert_uint(probed_image->height, ==, image->height);
+    munit_assert(probed_image->pixel_format == image->pixel_format);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    if (reads_whole_file(codec_info->name)) {
+        munit_assert_size(probe_bytes_read, <=, full_bytes_read);
+    } else {
+        munit_assert_size(probe_bytes_read, <, full_bytes_read);
+    }
+
+    sail_destroy_image(probed_image);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/header-only", test_header_only, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/probe",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,408 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "sail-comparators.h"
+
+#include "munit.h"
+
+#include "test-images.h"
+
+/* Loads all the frames with the pull API. */
+static unsigned load_reference_frames(const char *path, const struct sail_codec_info *codec_info,
+                                      struct sail_image *frames[], unsigned max_frames) {
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file(path, codec_info, &state) == SAIL_OK);
+
+    unsigned count = 0;
+    struct sail_image *image;
+
+    while (count < max_frames && sail_load_next_frame(state, &image) == SAIL_OK) {
+        frames[count++] = image;
+    }
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    return count;
+}
+
+static void push_in_chunks(const char *path, const struct sail_codec_info *codec_info, size_t chunk_size) {
+
+    struct sail_image *frames[8];
+    const unsigned frames_count = load_reference_frames(path, codec_info, frames, 8);
+    munit_assert_uint(frames_count, >, 0);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &data, &data_size) == SAIL_OK);
+
+    struct sail_push_decoder *push_decoder;
+    munit_assert(sail_alloc_push_decoder(codec_info, NULL, &push_decoder) == SAIL_OK);
+
+    unsigned pushed_count = 0;
+    struct sail_image *image;
+
+    for (size_t offset = 0; offset < data_size; offset += chunk_size) {
+        const size_t size = (data_size - offset < chunk_size) ? data_size - offset : chunk_size;
+        sail_status_t status = sail_push_decoder_feed(push_decoder, (const char *)data + offset, size, &image);
+
+        /* Frames available so far. */
+        while (status == SAIL_OK) {
+            munit_assert_uint(pushed_count, <, frames_count);
+            munit_assert(sail_test_compare_images(frames[pushed_count++], image) == SAIL_OK);
+            sail_destroy_image(image);
+
+            status = sail_push_decoder_feed(push_decoder, NULL, 0, &image);
+        }
+
+        munit_assert(status == SAIL_ERROR_NEED_MORE_DATA || status == SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    sail_status_t status;
+
+    while ((status = sail_push_decoder_finish(push_decoder, &image)) == SAIL_OK && pushed_count < frames_count) {
+        munit_assert(sail_test_compare_images(frames[pushed_count++], image) == SAIL_OK);
+        sail_destroy_image(image);
+    }
+
+    if (status == SAIL_OK) {
+        sail_destroy_image(image);
+    } else {
+        munit_assert(status == SAIL_ERROR_NO_MORE_FRAMES);
+    }
+
+    munit_assert_uint(pushed_count, ==, frames_count);
+
+    /* No feeding after finishing. */
+    munit_assert(sail_push_decoder_feed(push_decoder, data, 1, &image) == SAIL_ERROR_CONFLICTING_OPERATION);
+
+    sail_destroy_push_decoder(push_decoder);
+    sail_free(data);
+
+    for (unsigned i = 0; i < frames_count; i++) {
+        sail_destroy_image(frames[i]);
+    }
+}
+
+static MunitResult test_push(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    push_in_chunks(path, codec_info, 1);
+    push_in_chunks(path, codec_info, 1000);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_push_detect_codec(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    /* Skip codecs without magic numbers. */
+    if (codec_info->magic_number_node == NULL) {
+        return MUNIT_SKIP;
+    }
+
+    push_in_chunks(path, NULL, 3);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_push_truncated(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &data, &data_size) == SAIL_OK);
+    munit_assert_size(data_size, >, 16);
+
+    struct sail_push_decoder *push_decoder;
+    munit_assert(sail_alloc_push_decoder(codec_info, NULL, &push_decoder) == SAIL_OK);
+
+    /* Headers are never enough for the first frame. */
+    struct sail_image *image;
+    munit_assert(sail_push_decoder_feed(push_decoder, data, 16, &image) == SAIL_ERROR_NEED_MORE_DATA);
+
+    sail_destroy_push_decoder(push_decoder);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+/* Saves a noisy RGB frame into memory, so it compresses into many chunks. */
+static void save_frame(const struct sail_codec_info *codec_info, bool interlaced, void **data, size_t *data_size) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = 64;
+    image->height         = 256;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = sail_bytes_per_line(image->width, image->pixel_format);
+
+    munit_assert(sail_alloc_image_pixels(image, false) == SAIL_OK);
+
+    unsigned char *pixels = image->pixels;
+
+    for (size_t i = 0; i < (size_t)image->height * image->bytes_per_line; i++) {
+        pixels[i] = (unsigned char)((i * 2654435761u) >> 13);
+    }
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+
+    if (interlaced) {
+        save_options->options |= SAIL_OPTION_INTERLACED;
+    } else {
+        save_options->options &= ~SAIL_OPTION_INTERLACED;
+    }
+
+    void *state = NULL;
+    munit_assert(sail_start_saving_into_growable_memory_with_options(codec_info, save_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_saving_into_growable_memory(state, data, data_size) == SAIL_OK);
+
+    sail_destroy_save_options(save_options);
+    sail_destroy_image(image);
+}
+
+/*
+ * Feeds the data in small chunks, and checks the rows reported while the frame is decoded.
+ * Returns true if any rows were reported before the frame was complete.
+ */
+static bool push_rows(const void *data, size_t data_size, const struct sail_load_options *load_options, bool interlaced) {
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_memory_with_options(data, data_size, NULL, load_options, &state) == SAIL_OK);
+
+    struct sail_image *reference;
+    munit_assert(sail_load_next_frame(state, &reference) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    struct sail_push_decoder *push_decoder;
+    munit_assert(sail_alloc_push_decoder(NULL, load_options, &push_decoder) == SAIL_OK);
+
+    bool partial = false;
+    unsigned next_row = 0;
+    struct sail_image *image = NULL;
+
+    for (size_t offset = 0; offset < data_size && image == NULL; offset += 64) {
+        const size_t size = (data_size - offset < 64) ? data_size - offset : 64;
+        const sail_status_t status = sail_push_decoder_feed(push_decoder, (const char *)data + offset, size, &image);
+
+        const struct sail_image *frame;
+        unsigned first_row;
+        unsigned rows_count;
+        munit_assert(sail_push_decoder_rows(push_decoder, &frame, &first_row, &rows_count) == SAIL_OK);
+
+        if (status == SAIL_OK) {
+            munit_assert_null(frame);
+            munit_assert_uint(rows_count, ==, 0);
+            break;
+        }
+
+        munit_assert(status == SAIL_ERROR_NEED_MORE_DATA);
+
+        if (frame == NULL) {
+            munit_assert_uint(rows_count, ==, 0);
+            continue;
+        }
+
+        munit_assert_uint(frame->width, ==, reference->width);
+        munit_assert_uint(frame->height, ==, reference->height);
+        munit_assert_uint(first_row + rows_count, <=, frame->height);
+
+        if (rows_count == 0) {
+            continue;
+        }
+
+        partial = true;
+
+        /* Interlaced rows are complete only after the last pass. */
+        if (!interlaced) {
+            munit_assert_uint(first_row, ==, next_row);
+            next_row += rows_count;
+
+            for (unsigned row = first_row; row < first_row + rows_count; row++) {
+                munit_assert_memory_equal(frame->bytes_per_line, sail_scan_line(frame, row), sail_scan_line(reference, row));
+            }
+        }
+    }
+
+    if (image == NULL) {
+        munit_assert(sail_push_decoder_finish(push_decoder, &image) == SAIL_OK);
+    }
+
+    munit_assert(sail_test_compare_images(reference, image) == SAIL_OK);
+    sail_destroy_image(image);
+
+    munit_assert(sail_push_decoder_finish(push_decoder, &image) == SAIL_ERROR_NO_MORE_FRAMES);
+
+    sail_destroy_push_decoder(push_decoder);
+    sail_destroy_image(reference);
+
+    return partial;
+}
+
+static MunitResult test_push_rows(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *extension = munit_parameters_get(params, "extension");
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension(extension, &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    munit_assert(codec_info->load_features->features & SAIL_CODEC_FEATURE_PUSH);
+
+    for (int interlaced = 0; interlaced <= 1; interlaced++) {
+        if (interlaced && !(codec_info->save_features->features & SAIL_CODEC_FEATURE_INTERLACED)) {
+            continue;
+        }
+
+        void *data;
+        size_t data_size;
+        save_frame(codec_info, interlaced, &data, &data_size);
+
+        munit_assert(push_rows(data, data_size, NULL, interlaced));
+
+        sail_free(data);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_push_rows_fallback(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *extension = munit_parameters_get(params, "extension");
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension(extension, &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    void *data;
+    size_t data_size;
+    save_frame(codec_info, false, &data, &data_size);
+
+    /* Aligned rows need the whole frame, so the decoder restarts and reports no rows. */
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->row_alignment = 64;
+
+    munit_assert(!push_rows(data, data_size, load_options, false));
+
+    sail_destroy_load_options(load_options);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_push_invalid(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct sail_push_decoder *push_decoder;
+    munit_assert(sail_alloc_push_decoder(NULL, NULL, NULL) == SAIL_ERROR_NULL_PTR);
+    munit_assert(sail_alloc_push_decoder(NULL, NULL, &push_decoder) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_push_decoder_feed(push_decoder, NULL, 1, &image) == SAIL_ERROR_NULL_PTR);
+    munit_assert(sail_push_decoder_feed(push_decoder, "", 0, NULL) == SAIL_ERROR_NULL_PTR);
+
+    const struct sail_image *frame;
+    unsigned first_row;
+    unsigned rows_count;
+    munit_assert(sail_push_decoder_rows(NULL, &frame, &first_row, &rows_count) == SAIL_ERROR_NULL_PTR);
+    munit_assert(sail_push_decoder_rows(push_decoder, NULL, &first_row, &rows_count) == SAIL_ERROR_NULL_PTR);
+    munit_assert(sail_push_decoder_rows(push_decoder, &frame, &first_row, &rows_count) == SAIL_OK);
+    munit_assert_null(frame);
+    munit_assert_uint(rows_count, ==, 0);
+
+    /* Nothing is fed to detect the codec. */
+    munit_assert(sail_push_decoder_feed(push_decoder, NULL, 0, &image) == SAIL_ERROR_NEED_MORE_DATA);
+    munit_assert(sail_push_decoder_finish(push_decoder, &image) == SAIL_ERROR_CODEC_NOT_FOUND);
+
+    sail_destroy_push_decoder(push_decoder);
+    sail_destroy_push_decoder(NULL);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static char *push_extensions[] = { (char *)"png", (char *)"jpeg", NULL };
+
+static MunitParameterEnum test_push_params[] = {
+    { (char *)"extension", push_extensions },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/push",               test_push,               NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/push-detect-codec",  test_push_detect_codec,  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/push-truncated",     test_push_truncated,     NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/push-rows",          test_push_rows,          NULL, NULL, MUNIT_TEST_OPTION_NONE, test_push_params },
+    { (char *)"/push-rows-fallback", test_push_rows_fallback, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_push_params },
+    { (char *)"/push-invalid",       test_push_invalid,       NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/push-decoder",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,138 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static void assert_same_frame(const struct sail_image *image1, const struct sail_image *image2) {
+
+    munit_assert_uint(image1->width,          ==, image2->width);
+    munit_assert_uint(image1->height,         ==, image2->height);
+    munit_assert_uint(image1->bytes_per_line, ==, image2->bytes_per_line);
+    munit_assert(image1->pixel_format == image2->pixel_format);
+    munit_assert_memory_equal((size_t)image1->height * image1->bytes_per_line, image1->pixels, image2->pixels);
+}
+
+static MunitResult test_restart(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &data, &data_size) == SAIL_OK);
+
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file(path, NULL, &state) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+
+    /* The same image again, from a file and then from memory, with the same decoder if the codec supports that. */
+    for (int i = 0; i < 2; i++) {
+        if (i == 0) {
+            munit_assert(sail_restart_loading_from_file(state, path) == SAIL_OK);
+        } else {
+            munit_assert(sail_restart_loading_from_memory(state, data, data_size) == SAIL_OK);
+        }
+
+        struct sail_image *image_again = NULL;
+        munit_assert(sail_load_next_frame(state, &image_again) == SAIL_OK);
+
+        assert_same_frame(image, image_again);
+        sail_destroy_image(image_again);
+    }
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    sail_destroy_image(image);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_restart_after_partial_load(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    /* Restart before the first frame is loaded. */
+    void *state = NULL;
+    munit_assert(sail_start_loading_from_file(path, NULL, &state) == SAIL_OK);
+    munit_assert(sail_restart_loading_from_file(state, path) == SAIL_OK);
+
+    struct sail_image *image_again = NULL;
+    munit_assert(sail_load_next_frame(state, &image_again) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    assert_same_frame(image, image_again);
+
+    sail_destroy_image(image_again);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_restart_invalid(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    munit_assert(sail_restart_loading_from_file(NULL, SAIL_TEST_IMAGES[0]) == SAIL_ERROR_NULL_PTR);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/restart",                    test_restart,                    NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/restart-after-partial-load", test_restart_after_partial_load, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/restart-invalid",            test_restart_invalid,            NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/restart",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
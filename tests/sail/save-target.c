@@ -0,0 +1,273 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+enum {
+    WIDTH  = 96,
+    HEIGHT = 80,
+};
+
+/* Gradient with noise, so the encoded size depends on the quality. */
+static struct sail_image* alloc_textured_image(enum SailPixelFormat pixel_format) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = WIDTH;
+    image->height         = HEIGHT;
+    image->pixel_format   = pixel_format;
+    image->bytes_per_line = sail_bytes_per_line(WIDTH, pixel_format);
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * HEIGHT, &image->pixels) == SAIL_OK);
+
+    uint32_t seed = 12345;
+    const unsigned bytes_per_pixel = sail_bits_per_pixel(pixel_format) / 8;
+
+    for (unsigned row = 0; row < HEIGHT; row++) {
+        uint8_t *scan = sail_scan_line(image, row);
+
+        for (unsigned column = 0; column < WIDTH * bytes_per_pixel; column++) {
+            seed = seed * 1103515245 + 12345;
+            scan[column] = (uint8_t)(row * 2 + column + ((seed >> 16) & 0x3F));
+        }
+    }
+
+    return image;
+}
+
+static size_t save_with_targets(const struct sail_codec_info *codec_info, const struct sail_image *image,
+                                size_t target_size, double target_quality, void **buffer) {
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+    save_options->options        = 0;
+    save_options->target_size    = target_size;
+    save_options->target_quality = target_quality;
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory_with_options(codec_info, save_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+
+    size_t buffer_size;
+    munit_assert(sail_stop_saving_into_growable_memory(state, buffer, &buffer_size) == SAIL_OK);
+
+    sail_destroy_save_options(save_options);
+
+    return buffer_size;
+}
+
+/* Mean squared error of the decoded grayscale pixels. */
+static double grayscale_mse(const struct sail_image *image, const void *buffer, size_t buffer_size) {
+
+    struct sail_image *decoded;
+    munit_assert(sail_load_from_memory(buffer, buffer_size, &decoded) == SAIL_OK);
+    munit_assert_int(decoded->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+
+    double squared_error = 0;
+
+    for (unsigned row = 0; row < HEIGHT; row++) {
+        const uint8_t *original = sail_scan_line(image, row);
+        const uint8_t *scan     = sail_scan_line(decoded, row);
+
+        for (unsigned column = 0; column < WIDTH; column++) {
+            const double difference = (double)original[column] - (double)scan[column];
+            squared_error += difference * difference;
+        }
+    }
+
+    sail_destroy_image(decoded);
+
+    return squared_error / (WIDTH * HEIGHT);
+}
+
+static MunitResult test_jpeg_target_size(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = alloc_textured_image(SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+    size_t previous_size = 0;
+    const size_t target_sizes[] = { 3000, 6000, 12000 };
+
+    for (unsigned i = 0; i < sizeof(target_sizes) / sizeof(target_sizes[0]); i++) {
+        void *buffer;
+        const size_t buffer_size = save_with_targets(codec_info, image, target_sizes[i], 0, &buffer);
+
+        munit_assert_size(buffer_size, <=, target_sizes[i]);
+        munit_assert_size(buffer_size, >, previous_size);
+        previous_size = buffer_size;
+
+        /* The trial is a valid JPEG. */
+        struct sail_image *decoded;
+        munit_assert(sail_load_from_memory(buffer, buffer_size, &decoded) == SAIL_OK);
+        munit_assert_uint(decoded->width, ==, WIDTH);
+        munit_assert_uint(decoded->height, ==, HEIGHT);
+        sail_destroy_image(decoded);
+
+        sail_free(buffer);
+    }
+
+    /* Unreachable size saves the lowest quality. */
+    void *buffer;
+    const size_t buffer_size = save_with_targets(codec_info, image, 10, 0, &buffer);
+    munit_assert_size(buffer_size, >, 10);
+    sail_free(buffer);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_jpeg_target_quality(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    /* Grayscale samples are not converted, so the PSNR of the codec matches the decoded pixels. */
+    struct sail_image *image = alloc_textured_image(SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+
+    size_t previous_size = 0;
+
+    /* PSNR targets and the maximum MSE reaching them, 255^2 / 10^(PSNR/10). */
+    const double target_qualities[][2] = { { 30, 65.03 }, { 36, 16.33 }, { 42, 4.11 } };
+
+    for (unsigned i = 0; i < sizeof(target_qualities) / sizeof(target_qualities[0]); i++) {
+        void *buffer;
+        const size_t buffer_size = save_with_targets(codec_info, image, 0, target_qualities[i][0], &buffer);
+
+        munit_assert_double(grayscale_mse(image, buffer, buffer_size), <=, target_qualities[i][1]);
+        munit_assert_size(buffer_size, >, previous_size);
+        previous_size = buffer_size;
+
+        sail_free(buffer);
+    }
+
+    /* The size caps the quality. */
+    void *buffer;
+    const size_t buffer_size = save_with_targets(codec_info, image, 2000, 60, &buffer);
+    munit_assert_size(buffer_size, <=, 2000);
+    sail_free(buffer);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_jpeg_unsupported(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("jpg", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = alloc_textured_image(SAIL_PIXEL_FORMAT_BPP32_CMYK);
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+    save_options->target_size = 4000;
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory_with_options(codec_info, save_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+    void *buffer;
+    size_t buffer_size;
+    sail_stop_saving_into_growable_memory(state, &buffer, &buffer_size);
+    sail_free(buffer);
+
+    sail_destroy_save_options(save_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_webp_target_size(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_extension("webp", &codec_info) != SAIL_OK) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image = alloc_textured_image(SAIL_PIXEL_FORMAT_BPP24_RGB);
+
+    void *small_buffer;
+    const size_t small_size = save_with_targets(codec_info, image, 2000, 0, &small_buffer);
+
+    void *large_buffer;
+    const size_t large_size = save_with_targets(codec_info, image, 8000, 0, &large_buffer);
+
+    /* libwebp approaches the size in a few passes, so it may overshoot slightly. */
+    munit_assert_size(small_size, <, large_size);
+
+    sail_free(small_buffer);
+    sail_free(large_buffer);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/jpeg-target-size",    test_jpeg_target_size,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/jpeg-target-quality", test_jpeg_target_quality, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/jpeg-unsupported",    test_jpeg_unsupported,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/webp-target-size",    test_webp_target_size,    NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/save-target",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
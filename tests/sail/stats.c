@@ -0,0 +1,159 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static void load_with_stats(const char *path, struct sail_stats *stats) {
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->stats = stats;
+
+    void *state;
+    munit_assert(sail_start_loading_from_file_with_options(path, NULL, load_options, &state) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+    sail_destroy_image(image);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    sail_destroy_load_options(load_options);
+}
+
+static MunitResult test_load(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_stats stats = { 0 };
+    load_with_stats(path, &stats);
+
+    munit_assert_uint64(stats.frames, ==, 1);
+    munit_assert_uint64(stats.read_calls, >, 0);
+    munit_assert_uint64(stats.bytes_read, >, 0);
+    munit_assert_uint64(stats.bytes_written, ==, 0);
+    munit_assert_uint64(stats.allocations, >, 0);
+    munit_assert_uint64(stats.allocated_bytes, >, 0);
+
+    /* Stats are accumulated. */
+    const struct sail_stats first_stats = stats;
+    load_with_stats(path, &stats);
+
+    munit_assert_uint64(stats.frames, ==, 2);
+    munit_assert_uint64(stats.bytes_read, ==, first_stats.bytes_read * 2);
+
+    struct sail_stats total = { 0 };
+    sail_add_stats(&total, &first_stats);
+    sail_add_stats(&total, &first_stats);
+    munit_assert_uint64(total.frames, ==, 2);
+    munit_assert_uint64(total.bytes_read, ==, stats.bytes_read);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_save(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_path(path, &codec_info) == SAIL_OK);
+
+    struct sail_image *image = NULL;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    bool can_save = false;
+
+    for (unsigned i = 0; i < codec_info->save_features->pixel_formats_length; i++) {
+        if (codec_info->save_features->pixel_formats[i] == image->pixel_format) {
+            can_save = true;
+            break;
+        }
+    }
+
+    if (!can_save) {
+        sail_destroy_image(image);
+        return MUNIT_SKIP;
+    }
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+
+    struct sail_stats stats = { 0 };
+    save_options->stats = &stats;
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory_with_options(codec_info, save_options, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+
+    void *buffer;
+    size_t buffer_size;
+    munit_assert(sail_stop_saving_into_growable_memory(state, &buffer, &buffer_size) == SAIL_OK);
+
+    munit_assert_uint64(stats.frames, ==, 1);
+    munit_assert_uint64(stats.write_calls, >, 0);
+    munit_assert_uint64(stats.bytes_written, ==, buffer_size);
+    munit_assert_uint64(stats.bytes_read, ==, 0);
+
+    sail_free(buffer);
+    sail_destroy_save_options(save_options);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/load", test_load, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/save", test_save, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/stats",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
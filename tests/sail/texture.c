@@ -0,0 +1,221 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+/* Base level of the mip chains. Levels are halved down to 1x1. */
+enum {
+    WIDTH  = 16,
+    HEIGHT = 8,
+};
+
+static unsigned level_dimension(unsigned dimension, unsigned level) {
+
+    return (dimension >> level > 0) ? dimension >> level : 1;
+}
+
+static struct sail_image* alloc_level(enum SailPixelFormat pixel_format, unsigned width, unsigned height, unsigned level) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = width;
+    image->height         = height;
+    image->pixel_format   = pixel_format;
+    image->bytes_per_line = sail_bytes_per_line(width, pixel_format);
+
+    const size_t size = (size_t)image->bytes_per_line * height;
+    munit_assert(sail_malloc(size, &image->pixels) == SAIL_OK);
+
+    /* Block-compressed levels are opaque bytes for the codecs, so any values are valid. */
+    uint8_t *pixels = image->pixels;
+
+    for (size_t i = 0; i < size; i++) {
+        pixels[i] = (uint8_t)(i * 7 + level * 31);
+    }
+
+    return image;
+}
+
+static size_t save_mip_chain(const struct sail_codec_info *codec_info, enum SailPixelFormat pixel_format,
+                                unsigned levels, void *buffer, size_t buffer_size) {
+
+    void *state;
+    munit_assert(sail_start_saving_into_memory(buffer, buffer_size, codec_info, &state) == SAIL_OK);
+
+    for (unsigned level = 0; level < levels; level++) {
+        struct sail_image *image = alloc_level(pixel_format, level_dimension(WIDTH, level), level_dimension(HEIGHT, level), level);
+        munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+        sail_destroy_image(image);
+    }
+
+    size_t written;
+    munit_assert(sail_stop_saving_with_written(state, &written) == SAIL_OK);
+
+    return written;
+}
+
+/* Loads all the frames and compares them with the saved levels. */
+static void check_mip_chain(const void *buffer, size_t buffer_size, const char *codec_name,
+                            enum SailPixelFormat pixel_format, unsigned levels) {
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_by_magic_number_from_memory(buffer, buffer_size, &codec_info) == SAIL_OK);
+    munit_assert_string_equal(codec_info->name, codec_name);
+
+    void *state;
+    munit_assert(sail_start_loading_from_memory(buffer, buffer_size, codec_info, &state) == SAIL_OK);
+
+    for (unsigned level = 0; level < levels; level++) {
+        struct sail_image *image;
+        munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+
+        struct sail_image *expected = alloc_level(pixel_format, level_dimension(WIDTH, level), level_dimension(HEIGHT, level), level);
+
+        munit_assert_int(image->pixel_format, ==, pixel_format);
+        munit_assert_uint(image->width, ==, expected->width);
+        munit_assert_uint(image->height, ==, expected->height);
+        munit_assert_memory_equal((size_t)expected->bytes_per_line * expected->height, image->pixels, expected->pixels);
+
+        sail_destroy_image(expected);
+        sail_destroy_image(image);
+    }
+
+    struct sail_image *image;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_ERROR_NO_MORE_FRAMES);
+
+    /* Seek back to a smaller level. */
+    if (levels > 1) {
+        munit_assert(sail_load_frame_at(state, 1, &image) == SAIL_OK);
+        munit_assert_uint(image->width, ==, WIDTH / 2);
+        munit_assert_uint(image->height, ==, HEIGHT / 2);
+        sail_destroy_image(image);
+    }
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+}
+
+static MunitResult test_mip_chain(const MunitParameter params[], void *user_data) {
+
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension(munit_parameters_get(params, "extension"), &codec_info) == SAIL_OK);
+
+    /* 16x8 down to 1x1. */
+    const unsigned levels = 5;
+
+    uint8_t buffer[4096];
+    const size_t written = save_mip_chain(codec_info, SAIL_PIXEL_FORMAT_BPP32_RGBA, levels, buffer, sizeof(buffer));
+
+    check_mip_chain(buffer, written, codec_info->name, SAIL_PIXEL_FORMAT_BPP32_RGBA, levels);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_block_compressed(const MunitParameter params[], void *user_data) {
+
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension(munit_parameters_get(params, "extension"), &codec_info) == SAIL_OK);
+
+    static const enum SailPixelFormat pixel_formats[] = {
+        SAIL_PIXEL_FORMAT_BPP4_BC1,
+        SAIL_PIXEL_FORMAT_BPP8_BC2,
+        SAIL_PIXEL_FORMAT_BPP8_BC3,
+        SAIL_PIXEL_FORMAT_BPP4_BC4,
+        SAIL_PIXEL_FORMAT_BPP8_BC5,
+        SAIL_PIXEL_FORMAT_BPP8_BC7,
+    };
+
+    for (size_t i = 0; i < sizeof(pixel_formats) / sizeof(pixel_formats[0]); i++) {
+        /* Levels smaller than a block cannot be represented, so stop at 8x4. */
+        const unsigned levels = 2;
+
+        uint8_t buffer[4096];
+        const size_t written = save_mip_chain(codec_info, pixel_formats[i], levels, buffer, sizeof(buffer));
+
+        check_mip_chain(buffer, written, codec_info->name, pixel_formats[i], levels);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_invalid_mip_level(const MunitParameter params[], void *user_data) {
+
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension(munit_parameters_get(params, "extension"), &codec_info) == SAIL_OK);
+
+    uint8_t buffer[4096];
+
+    void *state;
+    munit_assert(sail_start_saving_into_memory(buffer, sizeof(buffer), codec_info, &state) == SAIL_OK);
+
+    struct sail_image *image = alloc_level(SAIL_PIXEL_FORMAT_BPP32_RGBA, WIDTH, HEIGHT, 0);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+
+    /* Mip levels must be half the size of the previous level. */
+    munit_assert(sail_write_next_frame(state, image) == SAIL_ERROR_INCORRECT_IMAGE_DIMENSIONS);
+    sail_destroy_image(image);
+
+    munit_assert(sail_stop_saving(state) == SAIL_OK);
+
+    return MUNIT_OK;
+}
+
+static char *extension_params[] = { (char *)"dds", (char *)"ktx2", NULL };
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"extension", extension_params },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/mip-chain",         test_mip_chain,         NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/block-compressed",  test_block_compressed,  NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/invalid-mip-level", test_invalid_mip_level, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/texture",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,178 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+/* Odd dimensions, so mirrored rows and columns never map onto themselves. */
+enum {
+    WIDTH  = 7,
+    HEIGHT = 5,
+};
+
+/* Value of the pixel in the final top-left orientation. */
+static uint8_t pixel_value(unsigned column, unsigned row) {
+
+    return (uint8_t)(row * WIDTH + column + 1);
+}
+
+/*
+ * Builds an 8-bit grayscale TGA with the specified origin. RLE images are encoded with packets
+ * of 3 pixels, so packets span rows, and raw and RLE packets alternate.
+ */
+static size_t build_tga(bool rle, bool flipped_v, bool flipped_h, uint8_t *buffer) {
+
+    size_t size = 0;
+
+    const uint8_t header[18] = {
+        0, 0, rle ? 11 : 3, 0, 0, 0, 0, 0,
+        0, 0, 0, 0,
+        WIDTH, 0, HEIGHT, 0,
+        8,
+        (uint8_t)((flipped_v ? 0 : 0x20) | (flipped_h ? 0x10 : 0))
+    };
+    memcpy(buffer, header, sizeof(header));
+    size += sizeof(header);
+
+    /* Pixels in the file order. */
+    uint8_t pixels[WIDTH * HEIGHT];
+
+    for (unsigned row = 0; row < HEIGHT; row++) {
+        for (unsigned column = 0; column < WIDTH; column++) {
+            pixels[row * WIDTH + column] = pixel_value(flipped_h ? WIDTH - 1 - column : column,
+                                                       flipped_v ? HEIGHT - 1 - row : row);
+        }
+    }
+
+    if (!rle) {
+        memcpy(buffer + size, pixels, sizeof(pixels));
+        return size + sizeof(pixels);
+    }
+
+    for (unsigned i = 0, packet = 0; i < WIDTH * HEIGHT; packet++) {
+        const unsigned count = (WIDTH * HEIGHT - i < 3) ? WIDTH * HEIGHT - i : 3;
+
+        /* Runs of a single value replace the pixels they cover in the expected image. */
+        if (packet % 2 == 1) {
+            buffer[size++] = (uint8_t)(0x80 | (count - 1));
+            buffer[size++] = pixels[i];
+
+            for (unsigned k = 1; k < count; k++) {
+                pixels[i + k] = pixels[i];
+            }
+        } else {
+            buffer[size++] = (uint8_t)(count - 1);
+            memcpy(buffer + size, pixels + i, count);
+            size += count;
+        }
+
+        i += count;
+    }
+
+    return size;
+}
+
+/* Returns the expected value of the pixel of the decoded RLE image, where runs repeat their first pixel. */
+static uint8_t expected_rle_value(bool flipped_v, bool flipped_h, unsigned column, unsigned row) {
+
+    const unsigned file_row    = flipped_v ? HEIGHT - 1 - row : row;
+    const unsigned file_column = flipped_h ? WIDTH - 1 - column : column;
+    const unsigned index       = file_row * WIDTH + file_column;
+
+    /* Odd packets of 3 pixels are runs. */
+    const unsigned first = (index / 3 % 2 == 1) ? index / 3 * 3 : index;
+
+    const unsigned first_row    = first / WIDTH;
+    const unsigned first_column = first % WIDTH;
+
+    return pixel_value(flipped_h ? WIDTH - 1 - first_column : first_column,
+                       flipped_v ? HEIGHT - 1 - first_row : first_row);
+}
+
+static MunitResult test_orientation(const MunitParameter params[], void *user_data) {
+
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("tga", &codec_info) == SAIL_OK);
+
+    for (unsigned variant = 0; variant < 8; variant++) {
+        const bool rle       = (variant & 1) != 0;
+        const bool flipped_v = (variant & 2) != 0;
+        const bool flipped_h = (variant & 4) != 0;
+
+        uint8_t buffer[256];
+        const size_t buffer_size = build_tga(rle, flipped_v, flipped_h, buffer);
+
+        /* TGA has no magic number. */
+        void *state;
+        munit_assert(sail_start_loading_from_memory(buffer, buffer_size, codec_info, &state) == SAIL_OK);
+
+        struct sail_image *image;
+        munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+        munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+        munit_assert_int(image->pixel_format, ==, SAIL_PIXEL_FORMAT_BPP8_GRAYSCALE);
+        munit_assert_uint(image->width, ==, WIDTH);
+        munit_assert_uint(image->height, ==, HEIGHT);
+
+        for (unsigned row = 0; row < HEIGHT; row++) {
+            const uint8_t *scan = sail_scan_line(image, row);
+
+            for (unsigned column = 0; column < WIDTH; column++) {
+                const uint8_t expected = rle ? expected_rle_value(flipped_v, flipped_h, column, row) : pixel_value(column, row);
+                munit_assert_uint8(scan[column], ==, expected);
+            }
+        }
+
+        sail_destroy_image(image);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/orientation", test_orientation, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/tga",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,215 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static void write_uint16(unsigned char *data, unsigned value) {
+
+    data[0] = (unsigned char)(value & 0xff);
+    data[1] = (unsigned char)(value >> 8);
+}
+
+static void write_uint32(unsigned char *data, unsigned long value) {
+
+    write_uint16(data, (unsigned)(value & 0xffff));
+    write_uint16(data + 2, (unsigned)(value >> 16));
+}
+
+static void write_ifd_entry(unsigned char *entry, unsigned tag, unsigned type, unsigned long value) {
+
+    write_uint16(entry, tag);
+    write_uint16(entry + 2, type);
+    write_uint32(entry + 4, 1);
+    write_uint32(entry + 8, value);
+}
+
+/* Builds little-endian EXIF data with an empty IFD0 and the JPEG thumbnail in IFD1. */
+static struct sail_meta_data_node* exif_with_thumbnail(const void *thumbnail, size_t thumbnail_size) {
+
+    const size_t ifd1_offset      = 8 + 2 + 4;
+    const size_t thumbnail_offset = ifd1_offset + 2 + 3 * 12 + 4;
+
+    const size_t exif_size = thumbnail_offset + thumbnail_size;
+
+    void *ptr;
+    munit_assert(sail_malloc(exif_size, &ptr) == SAIL_OK);
+    unsigned char *exif = ptr;
+    memset(exif, 0, thumbnail_offset);
+
+    memcpy(exif, "II", 2);
+    write_uint16(exif + 2, 42);
+    write_uint32(exif + 4, 8);
+
+    /* IFD0 */
+    write_uint16(exif + 8, 0);
+    write_uint32(exif + 10, ifd1_offset);
+
+    /* IFD1 */
+    write_uint16(exif + ifd1_offset, 3);
+    write_ifd_entry(exif + ifd1_offset + 2 + 0 * 12, 0x0103, 3, 6);
+    write_ifd_entry(exif + ifd1_offset + 2 + 1 * 12, 0x0201, 4, thumbnail_offset);
+    write_ifd_entry(exif + ifd1_offset + 2 + 2 * 12, 0x0202, 4, thumbnail_size);
+
+    memcpy(exif + thumbnail_offset, thumbnail, thumbnail_size);
+
+    struct sail_meta_data_node *meta_data_node;
+    munit_assert(sail_alloc_meta_data_node(&meta_data_node) == SAIL_OK);
+    munit_assert(sail_alloc_meta_data_and_value_from_known_key(SAIL_META_DATA_EXIF, &meta_data_node->meta_data) == SAIL_OK);
+    munit_assert(sail_set_variant_data(meta_data_node->meta_data->value, exif, exif_size) == SAIL_OK);
+
+    sail_free(exif);
+
+    return meta_data_node;
+}
+
+static void save_jpeg(unsigned width, unsigned height, struct sail_meta_data_node *meta_data_node,
+                        void **buffer, size_t *buffer_size) {
+
+    struct sail_image *image;
+    munit_assert(sail_alloc_image(&image) == SAIL_OK);
+
+    image->width          = width;
+    image->height         = height;
+    image->pixel_format   = SAIL_PIXEL_FORMAT_BPP24_RGB;
+    image->bytes_per_line = sail_bytes_per_line(width, image->pixel_format);
+    image->meta_data_node = meta_data_node;
+
+    munit_assert(sail_malloc((size_t)image->bytes_per_line * height, &image->pixels) == SAIL_OK);
+    memset(image->pixels, 0x80, (size_t)image->bytes_per_line * height);
+
+    const struct sail_codec_info *codec_info;
+    munit_assert(sail_codec_info_from_extension("jpg", &codec_info) == SAIL_OK);
+
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory(codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+    munit_assert(sail_stop_saving_into_growable_memory(state, buffer, buffer_size) == SAIL_OK);
+
+    sail_destroy_image(image);
+}
+
+static MunitResult test_exif(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *thumbnail;
+    size_t thumbnail_size;
+    save_jpeg(16, 8, NULL, &thumbnail, &thumbnail_size);
+
+    void *buffer;
+    size_t buffer_size;
+    save_jpeg(256, 128, exif_with_thumbnail(thumbnail, thumbnail_size), &buffer, &buffer_size);
+
+    /* The EXIF data survives saving. */
+    struct sail_image *image;
+    munit_assert(sail_load_from_memory(buffer, buffer_size, &image) == SAIL_OK);
+    munit_assert_not_null(image->meta_data_node);
+    munit_assert(image->meta_data_node->meta_data->key == SAIL_META_DATA_EXIF);
+    munit_assert(image->meta_data_node->meta_data->value->type == SAIL_VARIANT_TYPE_DATA);
+    sail_destroy_image(image);
+
+    munit_assert(sail_load_thumbnail_from_memory(buffer, buffer_size, &image) == SAIL_OK);
+    munit_assert_uint(image->width,  ==, 16);
+    munit_assert_uint(image->height, ==, 8);
+    munit_assert_not_null(image->pixels);
+    sail_destroy_image(image);
+
+    sail_free(buffer);
+    sail_free(thumbnail);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_scaled(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    void *buffer;
+    size_t buffer_size;
+    save_jpeg(256, 128, NULL, &buffer, &buffer_size);
+
+    /* No thumbnail, so the image is scaled by the decoder. */
+    struct sail_image *image;
+    munit_assert(sail_load_thumbnail_from_memory(buffer, buffer_size, &image) == SAIL_OK);
+    munit_assert_uint(image->width,  ==, 256 / 8);
+    munit_assert_uint(image->height, ==, 128 / 8);
+    munit_assert_not_null(image->pixels);
+    sail_destroy_image(image);
+
+    sail_free(buffer);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_fallback(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct sail_image *image;
+    munit_assert(sail_probe_file(path, &image, NULL) == SAIL_OK);
+
+    struct sail_image *thumbnail;
+    munit_assert(sail_load_thumbnail_from_file(path, &thumbnail) == SAIL_OK);
+    munit_assert_not_null(thumbnail->pixels);
+    munit_assert_uint(thumbnail->width,  <=, image->width);
+    munit_assert_uint(thumbnail->height, <=, image->height);
+
+    sail_destroy_image(thumbnail);
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/exif",     test_exif,     NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/fallback", test_fallback, NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/scaled",   test_scaled,   NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/thumbnail",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
@@ -0,0 +1,195 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+#define MAX_SPANS 256
+
+struct span {
+
+    const char *name;
+    bool ended;
+    sail_status_t status;
+    struct sail_trace_attributes end_attributes;
+};
+
+struct tracer {
+
+    struct span spans[MAX_SPANS];
+    unsigned spans_count;
+    /* Number of spans started but not ended yet. */
+    unsigned open_spans;
+};
+
+static void *begin_span(const char *name, const struct sail_trace_attributes *attributes, void *user_data) {
+
+    (void)attributes;
+
+    struct tracer *tracer = user_data;
+
+    munit_assert_uint(tracer->spans_count, <, MAX_SPANS);
+
+    struct span *span = &tracer->spans[tracer->spans_count++];
+    span->name  = name;
+    span->ended = false;
+
+    tracer->open_spans++;
+
+    return span;
+}
+
+static void end_span(void *span, const struct sail_trace_attributes *attributes, sail_status_t status, void *user_data) {
+
+    struct tracer *tracer = user_data;
+    struct span *span_local = span;
+
+    munit_assert_false(span_local->ended);
+
+    span_local->ended          = true;
+    span_local->status         = status;
+    span_local->end_attributes = *attributes;
+
+    tracer->open_spans--;
+}
+
+static const struct span *find_span(const struct tracer *tracer, const char *name) {
+
+    for (unsigned i = 0; i < tracer->spans_count; i++) {
+        if (strcmp(tracer->spans[i].name, name) == 0) {
+            return &tracer->spans[i];
+        }
+    }
+
+    return NULL;
+}
+
+static MunitResult test_load(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    struct tracer tracer = { 0 };
+    sail_set_tracer(begin_span, end_span, &tracer);
+    munit_assert_true(sail_is_tracing_enabled());
+
+    void *state;
+    munit_assert(sail_start_loading_from_file(path, NULL, &state) == SAIL_OK);
+
+    struct sail_image *image;
+    munit_assert(sail_load_next_frame(state, &image) == SAIL_OK);
+
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    sail_set_tracer(NULL, NULL, NULL);
+    munit_assert_false(sail_is_tracing_enabled());
+
+    munit_assert_uint(tracer.open_spans, ==, 0);
+
+    munit_assert_not_null(find_span(&tracer, "detect_codec"));
+    munit_assert_not_null(find_span(&tracer, "load_init"));
+    munit_assert_not_null(find_span(&tracer, "load_seek_next_frame"));
+    munit_assert_not_null(find_span(&tracer, "load_finish"));
+
+    const struct span *span = find_span(&tracer, "load_frame");
+    munit_assert_not_null(span);
+    munit_assert(span->status == SAIL_OK);
+    munit_assert_not_null(span->end_attributes.codec);
+    munit_assert_uint(span->end_attributes.width, ==, image->width);
+    munit_assert_uint(span->end_attributes.height, ==, image->height);
+    munit_assert(span->end_attributes.pixel_format == image->pixel_format);
+
+    sail_destroy_image(image);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_init(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    struct tracer tracer = { 0 };
+    sail_set_tracer(begin_span, end_span, &tracer);
+
+    munit_assert(sail_init_with_flags(SAIL_FLAG_PRELOAD_CODECS) == SAIL_OK);
+
+    sail_set_tracer(NULL, NULL, NULL);
+
+    munit_assert_uint(tracer.open_spans, ==, 0);
+
+    const struct span *span = find_span(&tracer, "init_context");
+    munit_assert_not_null(span);
+    munit_assert(span->status == SAIL_OK);
+
+    munit_assert_not_null(find_span(&tracer, "enumerate_codecs"));
+    munit_assert_not_null(find_span(&tracer, "preload_codecs"));
+
+    sail_finish();
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_no_tracer(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    /* Incomplete tracers are not set. */
+    sail_set_tracer(begin_span, NULL, NULL);
+    munit_assert_false(sail_is_tracing_enabled());
+    munit_assert_null(sail_begin_trace_span("test", NULL));
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/load",      test_load,      NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/init",      test_init,      NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+    { (char *)"/no-tracer", test_no_tracer, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/trace",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}
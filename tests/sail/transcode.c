@@ -0,0 +1,252 @@
+/*  This file is part of SAIL (https://github.com/HappySeaFox/sail)
+
+    Copyright (c) 2026 Dmitry Baryshev
+
+    The MIT License
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
+
+#include <string.h>
+
+#include <sail/sail.h>
+
+#include "munit.h"
+
+#include "test-images.h"
+
+static bool save_supported(const struct sail_codec_info *codec_info, enum SailPixelFormat pixel_format) {
+
+    for (unsigned i = 0; i < codec_info->save_features->pixel_formats_length; i++) {
+        if (codec_info->save_features->pixel_formats[i] == pixel_format) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static sail_status_t count_frames(struct sail_image *image, struct sail_image **image_output, void *user_data) {
+
+    unsigned *frames = user_data;
+    (*frames)++;
+
+    *image_output = image;
+
+    return SAIL_OK;
+}
+
+static sail_status_t fail_conversion(struct sail_image *image, struct sail_image **image_output, void *user_data) {
+
+    (void)image;
+    (void)image_output;
+    (void)user_data;
+
+    return SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT;
+}
+
+static MunitResult test_transcode(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_path(path, &codec_info) != SAIL_OK
+            || (codec_info->save_features->features & SAIL_CODEC_FEATURE_STATIC) == 0) {
+        return MUNIT_SKIP;
+    }
+
+    struct sail_image *image;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    if (!save_supported(codec_info, image->pixel_format)) {
+        sail_destroy_image(image);
+        return MUNIT_SKIP;
+    }
+
+    /* Save the first frame sequentially. */
+    void *state;
+    munit_assert(sail_start_saving_into_growable_memory(codec_info, &state) == SAIL_OK);
+    munit_assert(sail_write_next_frame(state, image) == SAIL_OK);
+
+    void *buffer_expected;
+    size_t buffer_expected_size;
+    munit_assert(sail_stop_saving_into_growable_memory(state, &buffer_expected, &buffer_expected_size) == SAIL_OK);
+
+    sail_destroy_image(image);
+
+    /* The pipeline produces the same data. */
+    struct sail_io *io_input;
+    munit_assert(sail_alloc_io_read_file(path, &io_input) == SAIL_OK);
+
+    struct sail_io *io_output;
+    munit_assert(sail_alloc_io_write_growable_memory(&io_output) == SAIL_OK);
+
+    unsigned frames = 0;
+    munit_assert(sail_transcode(io_input, codec_info, io_output, codec_info, NULL, NULL, count_frames, &frames) == SAIL_OK);
+    munit_assert_uint(frames, >, 0);
+
+    void *buffer;
+    size_t buffer_size;
+    munit_assert(sail_take_io_growable_memory_buffer(io_output, &buffer, &buffer_size) == SAIL_OK);
+    munit_assert_size(buffer_size, ==, buffer_expected_size);
+    munit_assert_memory_equal(buffer_size, buffer, buffer_expected);
+
+    sail_free(buffer);
+    sail_free(buffer_expected);
+    sail_destroy_io(io_output);
+    sail_destroy_io(io_input);
+
+    return MUNIT_OK;
+}
+
+/* Transcodes the file into memory with SAIL_OPTION_PASSTHROUGH and the specified save options. */
+static void transcode_passthrough(const char *path, const struct sail_codec_info *codec_info, int options,
+                                  void **buffer, size_t *buffer_size) {
+
+    struct sail_save_options *save_options;
+    munit_assert(sail_alloc_save_options_from_features(codec_info->save_features, &save_options) == SAIL_OK);
+    save_options->options = SAIL_OPTION_PASSTHROUGH | options;
+
+    struct sail_io *io_input;
+    munit_assert(sail_alloc_io_read_file(path, &io_input) == SAIL_OK);
+
+    struct sail_io *io_output;
+    munit_assert(sail_alloc_io_write_growable_memory(&io_output) == SAIL_OK);
+
+    munit_assert(sail_transcode(io_input, codec_info, io_output, codec_info, NULL, save_options, NULL, NULL) == SAIL_OK);
+    munit_assert(sail_take_io_growable_memory_buffer(io_output, buffer, buffer_size) == SAIL_OK);
+
+    sail_destroy_io(io_output);
+    sail_destroy_io(io_input);
+    sail_destroy_save_options(save_options);
+}
+
+static MunitResult test_passthrough(const MunitParameter params[], void *user_data) {
+    (void)user_data;
+
+    const char *path = munit_parameters_get(params, "path");
+
+    const struct sail_codec_info *codec_info;
+    if (sail_codec_info_from_path(path, &codec_info) != SAIL_OK ||
+            (strcmp(codec_info->name, "JPEG") != 0 && strcmp(codec_info->name, "PNG") != 0 && strcmp(codec_info->name, "WEBP") != 0)) {
+        return MUNIT_SKIP;
+    }
+
+    void *data;
+    size_t data_size;
+    munit_assert(sail_alloc_data_from_file_contents(path, &data, &data_size) == SAIL_OK);
+
+    /* Keeping everything copies the file byte by byte. */
+    void *buffer;
+    size_t buffer_size;
+    transcode_passthrough(path, codec_info, SAIL_OPTION_META_DATA | SAIL_OPTION_ICCP, &buffer, &buffer_size);
+    munit_assert_size(buffer_size, ==, data_size);
+    munit_assert_memory_equal(buffer_size, buffer, data);
+    sail_free(buffer);
+
+    /* Stripping drops the meta data and the ICC profile, but keeps the pixels. */
+    transcode_passthrough(path, codec_info, 0, &buffer, &buffer_size);
+    munit_assert_size(buffer_size, <=, data_size);
+
+    struct sail_load_options *load_options;
+    munit_assert(sail_alloc_load_options_from_features(codec_info->load_features, &load_options) == SAIL_OK);
+    load_options->options |= SAIL_OPTION_META_DATA | SAIL_OPTION_ICCP;
+
+    void *state;
+    struct sail_image *image_stripped;
+    munit_assert(sail_start_loading_from_memory_with_options(buffer, buffer_size, codec_info, load_options, &state) == SAIL_OK);
+    munit_assert(sail_load_next_frame(state, &image_stripped) == SAIL_OK);
+    munit_assert(sail_stop_loading(state) == SAIL_OK);
+
+    munit_assert_null(image_stripped->meta_data_node);
+    munit_assert_null(image_stripped->iccp);
+
+    struct sail_image *image;
+    munit_assert(sail_load_from_file(path, &image) == SAIL_OK);
+
+    munit_assert_uint(image_stripped->width, ==, image->width);
+    munit_assert_uint(image_stripped->height, ==, image->height);
+    munit_assert(image_stripped->pixel_format == image->pixel_format);
+    munit_assert_memory_equal((size_t)image->bytes_per_line * image->height, image_stripped->pixels, image->pixels);
+
+    sail_destroy_image(image);
+    sail_destroy_image(image_stripped);
+    sail_destroy_load_options(load_options);
+    sail_free(buffer);
+    sail_free(data);
+
+    return MUNIT_OK;
+}
+
+static MunitResult test_transcode_failure(const MunitParameter params[], void *user_data) {
+    (void)params;
+    (void)user_data;
+
+    const struct sail_codec_info *codec_info_output;
+    munit_assert(sail_codec_info_from_extension("bmp", &codec_info_output) == SAIL_OK);
+
+    for (unsigned i = 0; SAIL_TEST_IMAGES[i] != NULL; i++) {
+        const struct sail_codec_info *codec_info;
+
+        if (sail_codec_info_from_path(SAIL_TEST_IMAGES[i], &codec_info) != SAIL_OK) {
+            continue;
+        }
+
+        struct sail_io *io_input;
+        munit_assert(sail_alloc_io_read_file(SAIL_TEST_IMAGES[i], &io_input) == SAIL_OK);
+
+        struct sail_io *io_output;
+        munit_assert(sail_alloc_io_write_growable_memory(&io_output) == SAIL_OK);
+
+        /* The failed conversion stops the other stages. */
+        munit_assert(sail_transcode(io_input, codec_info, io_output, codec_info_output, NULL, NULL, fail_conversion, NULL)
+                        == SAIL_ERROR_UNSUPPORTED_PIXEL_FORMAT);
+
+        sail_destroy_io(io_output);
+        sail_destroy_io(io_input);
+    }
+
+    return MUNIT_OK;
+}
+
+static MunitParameterEnum test_params[] = {
+    { (char *)"path", (char **)SAIL_TEST_IMAGES },
+    { NULL, NULL },
+};
+
+static MunitTest test_suite_tests[] = {
+    { (char *)"/transcode",         test_transcode,         NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/passthrough",       test_passthrough,       NULL, NULL, MUNIT_TEST_OPTION_NONE, test_params },
+    { (char *)"/transcode-failure", test_transcode_failure, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL },
+
+    { NULL, NULL, NULL, NULL, MUNIT_TEST_OPTION_NONE, NULL }
+};
+
+static const MunitSuite test_suite = {
+    (char *)"/transcode",
+    test_suite_tests,
+    NULL,
+    1,
+    MUNIT_SUITE_OPTION_NONE
+};
+
+int main(int argc, char *argv[MUNIT_ARRAY_PARAM(argc + 1)]) {
+    return munit_suite_main(&test_suite, NULL, argc, argv);
+}